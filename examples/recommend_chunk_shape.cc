@@ -0,0 +1,119 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Recommends read and write chunk shapes for an array from a recorded access
+// trace, and prints the schema with the recommended chunk layout added.
+//
+// The trace is a JSON array of accesses, e.g.:
+//
+//     [{"origin": [0, 0], "shape": [1, 1024], "weight": 100},
+//      {"origin": [0, 0], "shape": [512, 1024], "write": true}]
+//
+// Example:
+//
+//     recommend_chunk_shape \
+//         --schema='{"domain": {"shape": [1024, 1024]}, "dtype": "uint16"}' \
+//         --trace=trace.json \
+//         --storage='{"request_latency": 0.05, "read_bandwidth": 1e8}'
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/index_space/index_domain.h"
+#include "tensorstore/schema.h"
+#include "tensorstore/internal/chunk_shape_recommender.h"
+#include "tensorstore/util/json_absl_flag.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::Schema>, schema, {},
+          "Schema of the array, which must specify the domain");
+ABSL_FLAG(std::string, trace, "", "Path to the JSON access trace");
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::internal::StorageCostModel>,
+          storage, {}, "Storage latency and bandwidth characteristics");
+ABSL_FLAG(double, compression_ratio, 1,
+          "Expected ratio of the decoded to the stored size of the chunks");
+ABSL_FLAG(bool, allow_sharding, true,
+          "Permit write chunks larger than the read chunks");
+
+namespace {
+
+using ::tensorstore::internal::ArrayAccess;
+
+tensorstore::Result<std::vector<ArrayAccess>> ReadTrace(
+    const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return absl::NotFoundError(
+        tensorstore::StrCat("Failed to open trace: ", path));
+  }
+  auto j = ::nlohmann::json::parse(file, nullptr, /*allow_exceptions=*/false);
+  if (!j.is_array()) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Expected JSON array in trace: ", path));
+  }
+  std::vector<ArrayAccess> accesses;
+  for (auto& access_json : j) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto access,
+                                 ArrayAccess::FromJson(std::move(access_json)));
+    accesses.push_back(std::move(access));
+  }
+  return accesses;
+}
+
+absl::Status Run() {
+  auto schema = absl::GetFlag(FLAGS_schema).value;
+  const auto domain = schema.domain();
+  if (!domain.valid()) {
+    return absl::InvalidArgumentError("--schema must specify a domain");
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto accesses,
+                               ReadTrace(absl::GetFlag(FLAGS_trace)));
+  tensorstore::internal::ChunkShapeRecommenderOptions options;
+  options.storage = absl::GetFlag(FLAGS_storage).value;
+  options.bytes_per_element =
+      (schema.dtype().valid() ? schema.dtype().size() : 1) /
+      absl::GetFlag(FLAGS_compression_ratio);
+  options.allow_sharding = absl::GetFlag(FLAGS_allow_sharding);
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto recommendation, tensorstore::internal::RecommendChunkShapes(
+                               domain.box(), accesses, options));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto chunk_schema, recommendation.ToSchema());
+  TENSORSTORE_RETURN_IF_ERROR(schema.Set(std::move(chunk_schema)));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto schema_json, schema.ToJson());
+  std::cout << "Estimated cost: " << recommendation.cost << "s" << std::endl;
+  std::cout << schema_json.dump(2) << std::endl;
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  auto status = Run();
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -328,6 +328,31 @@ invalid:
   throw py::type_error("`order` must be specified as 'C' or 'F'");
 }
 
+namespace {
+
+/// Returns a NumPy array that refers to the memory of `src` if `src` is a
+/// DLPack producer that is not already a NumPy array, or `nullptr` otherwise.
+///
+/// DLPack producers such as PyTorch and JAX arrays may not support the buffer
+/// protocol, and `PyArray_FromAny` otherwise falls back to `__array__`, which
+/// may copy.  `numpy.from_dlpack` does not copy, and supports host memory as
+/// well as pinned host memory of CUDA and ROCm devices.  Conversion failures,
+/// for example for device memory, are ignored so that the caller falls back
+/// to the normal conversion, which reports a suitable error.
+pybind11::object ArrayFromDlpack(pybind11::handle src) {
+  if (PyArray_Check(src.ptr()) ||
+      !PyObject_HasAttrString(src.ptr(), "__dlpack__")) {
+    return {};
+  }
+  try {
+    return pybind11::module_::import("numpy").attr("from_dlpack")(src);
+  } catch (pybind11::error_already_set&) {
+    return {};
+  }
+}
+
+}  // namespace
+
 bool ConvertToArrayImpl(pybind11::handle src,
                         SharedArray<void, dynamic_rank>& out,
                         bool& out_array_is_writable,
@@ -350,8 +375,10 @@ bool ConvertToArrayImpl(pybind11::handle src,
   }
 
   // Convert `src` to a NumPy array.
+  pybind11::object dlpack_array = ArrayFromDlpack(src);
   auto obj = pybind11::reinterpret_steal<pybind11::array>(PyArray_FromAny(
-      src.ptr(), reinterpret_cast<PyArray_Descr*>(dtype_handle.release().ptr()),
+      dlpack_array ? dlpack_array.ptr() : src.ptr(),
+      reinterpret_cast<PyArray_Descr*>(dtype_handle.release().ptr()),
       min_rank == dynamic_rank ? 0 : min_rank,
       max_rank == dynamic_rank ? 0 : max_rank, flags, nullptr));
   const auto try_convert = [&] {
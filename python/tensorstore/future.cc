@@ -26,10 +26,14 @@
 #include <cassert>
 #include <cerrno>
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "python/tensorstore/define_heap_type.h"
@@ -37,6 +41,7 @@
 #include "python/tensorstore/gil_safe.h"
 #include "python/tensorstore/python_imports.h"
 #include "python/tensorstore/python_value_or_exception.h"
+#include "python/tensorstore/status.h"
 #include "python/tensorstore/tensorstore_module_components.h"
 #include "python/tensorstore/type_name_override.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
@@ -53,6 +58,11 @@
 #include <semaphore.h>
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace tensorstore {
 namespace internal_python {
 namespace py = ::pybind11;
@@ -220,6 +230,210 @@ class ScopedFutureCallbackRegistration {
  private:
   FutureCallbackRegistration registration_;
 };
+
+/// Marks `awaitable_future`, an `asyncio.Future`, done with the result of
+/// `source_future`, a `PythonFutureObject`.
+///
+/// Must be called from the event loop thread of `awaitable_future`.
+void SetAwaitableFromSourceFuture(py::handle source_future,
+                                  py::handle awaitable_future) {
+  if (awaitable_future.attr("done")().ptr() == Py_True) {
+    return;
+  }
+  if (source_future.attr("cancelled")().ptr() == Py_True) {
+    awaitable_future.attr("cancel")();
+    return;
+  }
+  auto exc = source_future.attr("exception")();
+  if (!exc.is_none()) {
+    awaitable_future.attr("set_exception")(std::move(exc));
+  } else {
+    awaitable_future.attr("set_result")(source_future.attr("result")());
+  }
+}
+
+/// Delivers completions of awaited futures to an asyncio event loop in
+/// batches.
+///
+/// Scheduling each completion with `loop.call_soon_threadsafe` wakes the event
+/// loop, and allocates a handle, once per future, which dominates the cost of
+/// awaiting large numbers of concurrent operations.  Instead, completions are
+/// appended to a queue, and only the first completion enqueued since the queue
+/// was last drained wakes the event loop, by writing to a pipe registered with
+/// `loop.add_reader`.
+///
+/// There is one queue per event loop, which is destroyed along with the loop.
+///
+/// Since completions are enqueued from arbitrary threads, which in
+/// free-threaded builds of Python are not serialized by the GIL, the pending
+/// completions and the map of queues are guarded by mutexes.  No Python code
+/// runs while holding either mutex.
+class AsyncioCompletionQueue {
+ public:
+  /// Returns the queue for `loop`, creating it if necessary.
+  ///
+  /// Must be called from the thread running `loop`.  Returns `nullptr` if
+  /// `loop` does not support `add_reader` (e.g. the proactor event loop on
+  /// Windows) or weak references, in which case the caller must fall back to
+  /// `call_soon_threadsafe`.
+  static AsyncioCompletionQueue* Get(py::handle loop) {
+#ifdef _WIN32
+    return nullptr;
+#else
+    {
+      absl::MutexLock lock(&queues_mutex);
+      auto& queues = GetQueues();
+      if (auto it = queues.find(loop.ptr()); it != queues.end()) {
+        return it->second.get();
+      }
+    }
+    // Only the thread running `loop` creates its queue, and therefore the
+    // queue cannot be created concurrently.
+    auto queue = std::make_unique<AsyncioCompletionQueue>();
+    if (!queue->Initialize(loop)) {
+      PyErr_Clear();
+      return nullptr;
+    }
+    absl::MutexLock lock(&queues_mutex);
+    return GetQueues()
+        .emplace(loop.ptr(), std::move(queue))
+        .first->second.get();
+#endif
+  }
+
+  AsyncioCompletionQueue() = default;
+  AsyncioCompletionQueue(const AsyncioCompletionQueue&) = delete;
+
+  ~AsyncioCompletionQueue() {
+#ifndef _WIN32
+    if (read_fd_ != -1) ::close(read_fd_);
+    if (write_fd_ != -1) ::close(write_fd_);
+#endif
+  }
+
+  /// Schedules `awaitable_future` to be marked done with the result of
+  /// `source_future` from the event loop thread.
+  ///
+  /// May be called from any thread holding the GIL.
+  void Enqueue(py::object source_future, py::object awaitable_future) {
+    {
+      absl::MutexLock lock(&mutex_);
+      pending_.emplace_back(std::move(source_future),
+                            std::move(awaitable_future));
+      if (pending_.size() != 1) return;
+    }
+#ifndef _WIN32
+    // A failed write, which can only occur if the pipe is full, is harmless
+    // since the event loop is already due to wake up.
+    const char byte = 0;
+    [[maybe_unused]] auto n = ::write(write_fd_, &byte, 1);
+#endif
+  }
+
+ private:
+  using Queues =
+      absl::flat_hash_map<PyObject*, std::unique_ptr<AsyncioCompletionQueue>>;
+
+  /// Guards the map returned by `GetQueues`.
+  static absl::Mutex queues_mutex;
+
+  /// Returns the queue for each live event loop.  Never destroyed, since
+  /// queues may outlive module finalization.
+  static Queues& GetQueues() ABSL_EXCLUSIVE_LOCKS_REQUIRED(queues_mutex) {
+    static Queues* queues = new Queues;
+    return *queues;
+  }
+
+  /// Removes the queue for the event loop `key`.
+  static void Remove(PyObject* key) {
+    std::unique_ptr<AsyncioCompletionQueue> queue;
+    {
+      absl::MutexLock lock(&queues_mutex);
+      auto& queues = GetQueues();
+      auto it = queues.find(key);
+      if (it == queues.end()) return;
+      queue = std::move(it->second);
+      queues.erase(it);
+    }
+    // Destroy `queue`, which releases Python references, without holding
+    // `queues_mutex`.
+  }
+
+  /// Creates the pipe and registers it with `loop`.
+  ///
+  /// \returns `false` with the Python error indicator set on failure.
+  bool Initialize(py::handle loop) {
+#ifdef _WIN32
+    return false;
+#else
+    int fds[2];
+    if (::pipe(fds) != 0) {
+      PyErr_SetFromErrno(PyExc_OSError);
+      return false;
+    }
+    read_fd_ = fds[0];
+    write_fd_ = fds[1];
+    for (int fd : fds) {
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+      ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    }
+
+    // Remove the queue once `loop` is destroyed.  The lifetime of the queue
+    // therefore exceeds that of any awaitable future associated with `loop`,
+    // and of any completion callback referring to the queue.
+    PyObject* key = loop.ptr();
+    auto on_loop_destroyed = py::cpp_function(
+        [key](py::handle weakref) { Remove(key); });
+    loop_weakref_ = py::reinterpret_steal<py::object>(
+        PyWeakref_NewRef(loop.ptr(), on_loop_destroyed.ptr()));
+    if (!loop_weakref_) return false;
+
+    auto drain = py::cpp_function([this] { Drain(); });
+    try {
+      loop.attr("add_reader")(read_fd_, drain);
+    } catch (py::error_already_set& e) {
+      e.restore();
+      return false;
+    }
+    return true;
+#endif
+  }
+
+  /// Invoked on the event loop thread when the pipe becomes readable.
+  void Drain() {
+#ifndef _WIN32
+    char buf[64];
+    while (::read(read_fd_, buf, sizeof(buf)) > 0) {
+    }
+#endif
+    // Swap out `pending_`, since marking a future done may run arbitrary
+    // Python code that enqueues additional completions.
+    std::vector<std::pair<py::object, py::object>> pending;
+    {
+      absl::MutexLock lock(&mutex_);
+      pending.swap(pending_);
+    }
+    for (auto& [source_future, awaitable_future] : pending) {
+      if (CallAndSetErrorIndicator([&] {
+            SetAwaitableFromSourceFuture(source_future, awaitable_future);
+          })) {
+        PyErr_WriteUnraisable(nullptr);
+        PyErr_Clear();
+      }
+    }
+  }
+
+  int read_fd_ = -1;
+  int write_fd_ = -1;
+  py::object loop_weakref_;
+  absl::Mutex mutex_;
+  std::vector<std::pair<py::object, py::object>> pending_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+ABSL_CONST_INIT absl::Mutex AsyncioCompletionQueue::queues_mutex{
+    absl::kConstInit};
+
 }  // namespace
 
 [[noreturn]] void ThrowCancelledError() {
@@ -281,19 +495,32 @@ void InterruptibleWaitImpl(internal_future::FutureStateBase& future,
 }
 
 bool PythonFutureObject::Cancel() {
-  if (done()) return false;
-  cpp_data.state = {};
-  cpp_data.registration.Unregister();
+  FutureCallbackRegistration registration;
+  {
+    PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    if (DoneLocked()) return false;
+    cpp_data.state = {};
+    registration = std::move(cpp_data.registration);
+  }
+  // Unregister without holding `lock`, since the callback, if already running
+  // concurrently, acquires it before observing that `state` has been cleared.
+  registration.Unregister();
   RunCancelCallbacks();
   RunCallbacks();
   return true;
 }
 
+internal_future::FutureStatePointer PythonFutureObject::GetState() const {
+  PythonObjectCriticalSection lock(
+      reinterpret_cast<PyObject*>(const_cast<PythonFutureObject*>(this)));
+  return cpp_data.state;
+}
+
 void PythonFutureObject::Force() {
-  if (done()) return;
   // Use copy of `state`, since `state` may be modified by another thread
   // calling `Cancel` once GIL is released.
-  auto state = cpp_data.state;
+  auto state = GetState();
+  if (!state || state->ready()) return;
   GilScopedRelease gil_release;
   state->Force();
 }
@@ -303,30 +530,25 @@ pybind11::object PythonFutureObject::GetAwaitable() {
   // lambda captures don't interoperate with Python garbage collection.
   // Instead, we create it as a capture-less function and then use a
   // `PyMethod` object to capture `awaitable_future` as the `self` argument.
-  auto done_callback = py::cpp_function([](py::handle awaitable_future,
-                                           py::handle source_future) {
-    awaitable_future.attr("get_loop")().attr("call_soon_threadsafe")(
-        py::cpp_function([](py::handle source_future,
-                            py::object awaitable_future) {
-          if (awaitable_future.attr("done")().ptr() == Py_True) {
-            return;
-          }
-          if (source_future.attr("cancelled")().ptr() == Py_True) {
-            awaitable_future.attr("cancel")();
-            return;
-          }
-          auto exc = source_future.attr("exception")();
-          if (!exc.is_none()) {
-            awaitable_future.attr("set_exception")(std::move(exc));
-          } else {
-            awaitable_future.attr("set_result")(source_future.attr("result")());
-          }
-        }),
-        source_future, awaitable_future);
-  });
-
-  py::object awaitable_future =
-      python_imports.asyncio_get_event_loop_function().attr("create_future")();
+  py::object loop = python_imports.asyncio_get_event_loop_function();
+  py::object awaitable_future = loop.attr("create_future")();
+
+  // Completions are delivered in batches through the completion queue of
+  // `loop` when supported, and otherwise individually.  The queue outlives
+  // `awaitable_future`, which references `loop`.
+  auto* completion_queue = AsyncioCompletionQueue::Get(loop);
+  auto done_callback = py::cpp_function(
+      [completion_queue](py::object awaitable_future,
+                         py::object source_future) {
+        if (completion_queue) {
+          completion_queue->Enqueue(std::move(source_future),
+                                    std::move(awaitable_future));
+          return;
+        }
+        awaitable_future.attr("get_loop")().attr("call_soon_threadsafe")(
+            py::cpp_function(&SetAwaitableFromSourceFuture), source_future,
+            awaitable_future);
+      });
 
   // Ensure the PythonFutureObject is cancelled if the awaitable future is
   // cancelled.
@@ -353,36 +575,48 @@ pybind11::object PythonFutureObject::GetAwaitable() {
 
 internal_future::FutureStatePointer WaitForResult(PythonFutureObject& obj,
                                                   absl::Time deadline) {
-  auto state = obj.cpp_data.state;
+  auto state = obj.GetState();
+  if (!state) ThrowCancelledError();
   internal_python::InterruptibleWaitImpl(*state, deadline, &obj);
   return state;
 }
 
 pybind11::object PythonFutureObject::GetResult(absl::Time deadline) {
-  if (!cpp_data.state) ThrowCancelledError();
   auto state = WaitForResult(*this, deadline);
   return cpp_data.vtable->get_result(*state);
 }
 
 pybind11::object PythonFutureObject::GetException(absl::Time deadline) {
-  if (!cpp_data.state) ThrowCancelledError();
   auto state = WaitForResult(*this, deadline);
   return cpp_data.vtable->get_exception(*state);
 }
 
 void PythonFutureObject::AddDoneCallback(pybind11::handle callback) {
-  if (done()) {
+  bool added = false;
+  bool first_callback = false;
+  {
+    PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    // Checking whether the future is done and adding the callback must be
+    // atomic with respect to `RunCallbacks`.
+    if (!DoneLocked()) {
+      cpp_data.callbacks.push_back(
+          py::reinterpret_borrow<py::object>(callback));
+      added = true;
+      if (cpp_data.callbacks.size() == 1) {
+        Py_INCREF(reinterpret_cast<PyObject*>(this));
+        first_callback = true;
+      }
+    }
+  }
+  if (!added) {
     callback(py::handle(reinterpret_cast<PyObject*>(this)));
     return;
   }
-  cpp_data.callbacks.push_back(py::reinterpret_borrow<py::object>(callback));
-  if (cpp_data.callbacks.size() == 1) {
-    Py_INCREF(reinterpret_cast<PyObject*>(this));
-    Force();
-  }
+  if (first_callback) Force();
 }
 
 size_t PythonFutureObject::RemoveDoneCallback(pybind11::handle callback) {
+  PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(this));
   auto& callbacks = cpp_data.callbacks;
   // Since caller owns a reference to `callback`, we can be sure that removing
   // `callback` from `callbacks` does not result in any reference counts
@@ -399,8 +633,9 @@ size_t PythonFutureObject::RemoveDoneCallback(pybind11::handle callback) {
 }
 
 Future<GilSafePythonHandle> PythonFutureObject::GetPythonValueFuture() {
-  if (!cpp_data.state) return absl::CancelledError("");
-  return cpp_data.vtable->get_python_value_future(*cpp_data.state);
+  auto state = GetState();
+  if (!state) return absl::CancelledError("");
+  return cpp_data.vtable->get_python_value_future(*state);
 }
 
 int PythonFutureObject::TraversePythonReferences(visitproc visit, void* arg) {
@@ -426,6 +661,9 @@ int PythonFutureObject::ClearPythonReferences() {
 }
 
 void PythonFutureObject::RunCancelCallbacks() {
+  // The cancel callbacks only notify waiting threads, and therefore may be
+  // invoked while holding `lock`.
+  PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(this));
   for (CancelCallbackBase* callback = cpp_data.cancel_callbacks.next;
        callback != &cpp_data.cancel_callbacks;) {
     auto* next = callback->next;
@@ -435,7 +673,12 @@ void PythonFutureObject::RunCancelCallbacks() {
 }
 
 void PythonFutureObject::RunCallbacks() {
-  auto callbacks = std::move(cpp_data.callbacks);
+  std::vector<pybind11::object> callbacks;
+  {
+    PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(this));
+    callbacks = std::move(cpp_data.callbacks);
+    cpp_data.callbacks.clear();
+  }
   if (callbacks.empty()) return;
   // If this object has already been finalized, then it is not safe to call
   // callbacks, because they may now be in an invalid state due to garbage
@@ -545,6 +788,11 @@ pybind11::object TryConvertToFuture(pybind11::handle src,
 
 namespace {
 using FutureCls = py::class_<PythonFutureObject>;
+
+/// Guards the links between `PythonFutureObject` and `PythonPromiseObject`,
+/// which are cleared when either is destroyed.  A global mutex is used rather
+/// than the per-object lock, since the objects may be destroyed concurrently.
+ABSL_CONST_INIT absl::Mutex promise_future_link_mutex{absl::kConstInit};
 using PromiseCls = py::class_<PythonPromiseObject>;
 
 PyObject* FutureAlloc(PyTypeObject* type, Py_ssize_t nitems) {
@@ -580,15 +828,21 @@ void FutureDealloc(PyObject* self) {
 
   // Clear `state`: this ensures that the callback corresponding to
   // `registration` does not run with the reference count equal to 0.
-  cpp_data.state = {};
+  {
+    PythonObjectCriticalSection lock(self);
+    cpp_data.state = {};
+  }
   {
     GilScopedRelease gil_release;
     cpp_data.registration.Unregister();
   }
 
-  if (cpp_data.python_promise_object) {
-    cpp_data.python_promise_object->cpp_data.python_future_object = nullptr;
-    cpp_data.python_promise_object = nullptr;
+  {
+    absl::MutexLock lock(&promise_future_link_mutex);
+    if (cpp_data.python_promise_object) {
+      cpp_data.python_promise_object->cpp_data.python_future_object = nullptr;
+      cpp_data.python_promise_object = nullptr;
+    }
   }
 
   cpp_data.~CppData();
@@ -958,9 +1212,12 @@ void PromiseDealloc(PyObject* self) {
 
   if (obj.weakrefs) PyObject_ClearWeakRefs(self);
 
-  if (cpp_data.python_future_object) {
-    cpp_data.python_future_object->cpp_data.python_promise_object = nullptr;
-    cpp_data.python_future_object = nullptr;
+  {
+    absl::MutexLock lock(&promise_future_link_mutex);
+    if (cpp_data.python_future_object) {
+      cpp_data.python_future_object->cpp_data.python_promise_object = nullptr;
+      cpp_data.python_future_object = nullptr;
+    }
   }
 
   cpp_data.~CppData();
@@ -1042,10 +1299,15 @@ void DefinePromiseAttributes(PromiseCls& cls) {
   cls.def(
       "set_result",
       [](Self& self, py::object result) {
+        std::optional<PythonValueOrExceptionWeakRef> value;
+        {
+          // Protects `reference_manager`.
+          PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(&self));
+          value.emplace(self.cpp_data.reference_manager,
+                        PythonValueOrException{std::move(result)});
+        }
         self.cpp_data.promise.SetResult(
-            GilSafePythonValueOrExceptionWeakRef{PythonValueOrExceptionWeakRef(
-                self.cpp_data.reference_manager,
-                PythonValueOrException{std::move(result)})});
+            GilSafePythonValueOrExceptionWeakRef{std::move(*value)});
       },
       py::arg("result"), R"(
 Marks the linked future as successfully completed with the specified result.
@@ -1067,10 +1329,15 @@ Example:
       [](Self& self, py::object exception) {
         PyErr_SetObject(reinterpret_cast<PyObject*>(exception.ptr()->ob_type),
                         exception.ptr());
+        std::optional<PythonValueOrExceptionWeakRef> value;
+        {
+          // Protects `reference_manager`.
+          PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(&self));
+          value.emplace(self.cpp_data.reference_manager,
+                        PythonValueOrException::FromErrorIndicator());
+        }
         self.cpp_data.promise.SetResult(
-            GilSafePythonValueOrExceptionWeakRef{PythonValueOrExceptionWeakRef(
-                self.cpp_data.reference_manager,
-                PythonValueOrException::FromErrorIndicator())});
+            GilSafePythonValueOrExceptionWeakRef{std::move(*value)});
       },
       py::arg("exception"), R"(
 Marks the linked future as unsuccessfully completed with the specified error.
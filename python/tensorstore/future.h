@@ -209,35 +209,38 @@ struct PythonFutureObject {
         internal::intrusive_linked_list::MemberAccessor<CancelCallbackBase>;
     explicit CancelCallback(PythonFutureObject* base,
                             absl::FunctionRef<void()> callback)
-        : callback(callback) {
+        : callback(callback), base(base) {
+      PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(base));
       internal::intrusive_linked_list::InsertBefore(
           Accessor{}, &base->cpp_data.cancel_callbacks, this);
     }
     ~CancelCallback() {
+      PythonObjectCriticalSection lock(reinterpret_cast<PyObject*>(base));
       internal::intrusive_linked_list::Remove(Accessor{}, this);
     }
     absl::FunctionRef<void()> callback;
+    PythonFutureObject* base;
   };
 
   struct CppData {
     /// Operations specified to the value type.
     const Vtable* vtable;
 
+    /// Guarded by the GIL, or by `PythonObjectCriticalSection` in free-threaded
+    /// builds of Python.  The same applies to the members below.
     internal_future::FutureStatePointer state;
-    /// Callbacks to be invoked when the future becomes ready.  Guarded by the
-    /// GIL.  When non-empty, the Python reference count of the
-    /// `PythonFutureObject` is incremented.  If there is an associated
-    /// `PythonPromiseObject`, the additional reference count is considered to
-    /// be logically owned by it, and will participate in cyclic garbage
-    /// collection.  Otherwise, it is considered to be owned by the associated
-    /// C++ future state, and will *not* participate in cyclic garbage
-    /// collection.
+    /// Callbacks to be invoked when the future becomes ready.  When non-empty,
+    /// the Python reference count of the `PythonFutureObject` is incremented.
+    /// If there is an associated `PythonPromiseObject`, the additional
+    /// reference count is considered to be logically owned by it, and will
+    /// participate in cyclic garbage collection.  Otherwise, it is considered
+    /// to be owned by the associated C++ future state, and will *not*
+    /// participate in cyclic garbage collection.
     std::vector<pybind11::object> callbacks;
     /// Registration of `ExecuteWhenReady` callback used when `callbacks_` is
-    /// non-empty.  Guarded by the GIL.
+    /// non-empty.
     FutureCallbackRegistration registration;
-    /// Linked list of callbacks to be invoked when cancelled.  Guarded by the
-    /// GIL.
+    /// Linked list of callbacks to be invoked when cancelled.
     CancelCallbackBase cancel_callbacks;
     /// Holds strong references to objects weakly referenced by either the value
     /// that has been set (if done), or by the asynchronous operation
@@ -270,6 +273,9 @@ struct PythonFutureObject {
   /// Calls `Force` on the underlying `Future`.
   void Force();
 
+  /// Returns the underlying future state, or `nullptr` if cancelled.
+  internal_future::FutureStatePointer GetState() const;
+
   /// Returns a corresponding `asyncio`-compatible future object.
   pybind11::object GetAwaitable();
 
@@ -295,11 +301,20 @@ struct PythonFutureObject {
   pybind11::object GetException(absl::Time deadline);
 
   /// Returns `true` if the Future was cancelled.
-  bool cancelled() { return !cpp_data.state; }
+  bool cancelled() const { return !GetState(); }
 
   /// Returns `true` if the underlying Future is ready (either with a value or
   /// an error) or already cancelled.
-  bool done() const { return !cpp_data.state || cpp_data.state->ready(); }
+  bool done() const {
+    auto state = GetState();
+    return !state || state->ready();
+  }
+
+  /// Same as `done()`, but requires that the caller hold a
+  /// `PythonObjectCriticalSection` for this object.
+  bool DoneLocked() const {
+    return !cpp_data.state || cpp_data.state->ready();
+  }
 
   /// Returns a Future that resolves directly to the Python value.
   Future<GilSafePythonHandle> GetPythonValueFuture();
@@ -394,6 +409,7 @@ struct PythonFutureObject {
     pybind11::object self = pybind11::reinterpret_steal<pybind11::object>(
         python_type->tp_alloc(python_type, 0));
     if (!self) throw pybind11::error_already_set();
+    EnableTryIncref(self.ptr());
     auto& obj = *reinterpret_cast<PythonFutureObject*>(self.ptr());
     auto& cpp_data = obj.cpp_data;
     cpp_data.vtable = &vtable;
@@ -403,14 +419,20 @@ struct PythonFutureObject {
         [&obj](ReadyFuture<const T> future) mutable {
           ExitSafeGilScopedAcquire gil;
           if (!gil.acquired()) return;
-          if (!obj.cpp_data.state) return;
-          assert(Py_REFCNT(reinterpret_cast<PyObject*>(&obj)) > 0);
-          auto keep_alive = pybind11::reinterpret_borrow<pybind11::object>(
-              reinterpret_cast<PyObject*>(&obj));
-          auto& r = future.result();
-          if constexpr (!std::is_void_v<T>) {
-            if (r.ok()) {
-              obj.cpp_data.reference_manager.Update(*r);
+          auto* obj_ptr = reinterpret_cast<PyObject*>(&obj);
+          pybind11::object keep_alive;
+          {
+            PythonObjectCriticalSection lock(obj_ptr);
+            // In free-threaded builds, `obj` may be concurrently reaching a
+            // reference count of zero, in which case `FutureDealloc` clears
+            // `state` once `lock` is released.
+            if (!obj.cpp_data.state || !TryIncref(obj_ptr)) return;
+            keep_alive = pybind11::reinterpret_steal<pybind11::object>(obj_ptr);
+            auto& r = future.result();
+            if constexpr (!std::is_void_v<T>) {
+              if (r.ok()) {
+                obj.cpp_data.reference_manager.Update(*r);
+              }
             }
           }
           obj.RunCallbacks();
@@ -60,7 +60,10 @@ namespace internal_python {
 /// Holds strong references to a collection of Python objects weakly referenced
 /// by another object.
 ///
-/// \threadsafety Must only be used with the GIL held.
+/// \threadsafety Must only be used with the GIL held.  In free-threaded builds
+///     of Python, concurrent uses of the same manager must additionally be
+///     serialized, e.g. by a `PythonObjectCriticalSection` for the owning
+///     object.
 class PythonObjectReferenceManager {
  public:
   PythonObjectReferenceManager();
@@ -102,6 +102,25 @@ ExitSafeGilScopedAcquire::~ExitSafeGilScopedAcquire() {
   }
 }
 
+void EnableTryIncref(PyObject* obj) {
+#if defined(Py_GIL_DISABLED) && PY_VERSION_HEX >= 0x030E0000
+  PyUnstable_EnableTryIncRef(obj);
+#endif
+}
+
+bool TryIncref(PyObject* obj) {
+#if defined(Py_GIL_DISABLED) && PY_VERSION_HEX >= 0x030E0000
+  return PyUnstable_TryIncRef(obj);
+#else
+  // With the GIL, the reference count cannot concurrently reach zero.  In
+  // free-threaded builds of Python 3.13, which lack `PyUnstable_TryIncRef`,
+  // this is a best-effort check.
+  if (Py_REFCNT(obj) == 0) return false;
+  Py_INCREF(obj);
+  return true;
+#endif
+}
+
 absl::Status PythonExitingError() {
   return absl::CancelledError("Python interpreter is exiting");
 }
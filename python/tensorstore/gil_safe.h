@@ -59,6 +59,50 @@ class GilScopedRelease {
   PyThreadState* save_;
 };
 
+/// RAII type that locks the per-object mutex of a Python object, in order to
+/// protect state of the object that would otherwise be protected by the GIL.
+///
+/// In free-threaded builds of Python (PEP 703), this is a critical section as
+/// defined by `PyCriticalSection_Begin`.  In builds with the GIL, this is a
+/// no-op, since the GIL is held whenever the object is accessed.
+///
+/// As with the GIL, the lock is temporarily released while the current thread
+/// is detached from the interpreter, e.g. by `GilScopedRelease`, and may be
+/// released while acquiring the lock of another object.  Therefore, it only
+/// protects state that is not accessed across such calls.
+class PythonObjectCriticalSection {
+ public:
+  explicit PythonObjectCriticalSection(PyObject* obj) {
+#ifdef Py_GIL_DISABLED
+    PyCriticalSection_Begin(&section_, obj);
+#endif
+  }
+  ~PythonObjectCriticalSection() {
+#ifdef Py_GIL_DISABLED
+    PyCriticalSection_End(&section_);
+#endif
+  }
+  PythonObjectCriticalSection(const PythonObjectCriticalSection&) = delete;
+
+ private:
+#ifdef Py_GIL_DISABLED
+  PyCriticalSection section_;
+#endif
+};
+
+/// Enables `TryIncref` to be used with `obj`.
+///
+/// Must be called when `obj` is created, before it is shared with other
+/// threads.
+void EnableTryIncref(PyObject* obj);
+
+/// Attempts to acquire a new strong reference to `obj`, which may be
+/// referenced only by a borrowed pointer that does not prevent it from being
+/// destroyed concurrently by another thread.
+///
+/// \returns `false` if the reference count of `obj` has already reached zero.
+bool TryIncref(PyObject* obj);
+
 /// Attempts to acquire a block on the Python interpreter exiting.
 ///
 /// If successful, Python will not proceed to finalization until
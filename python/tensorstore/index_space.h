@@ -399,6 +399,12 @@ void DefineIndexTransformOperations(
                    1, py::detail::function_signature_t<decltype(assign)>>::type
                    source) {
       IndexTransform<> transform = get_transform(self);
+      if (auto simple_transform = TryApplySimpleIndexingSpec(
+              transform, spec_placeholder.value)) {
+        return assign(apply_transform(std::forward<Self>(self),
+                                      *std::move(simple_transform)),
+                      source);
+      }
       transform = ValueOrThrow(
           [&]() -> Result<IndexTransform<>> {
             auto spec =
@@ -421,6 +427,13 @@ void DefineIndexTransformOperations(
       [get_transform, apply_transform](
           Self self, NumpyIndexingSpecPlaceholder spec_placeholder) {
         IndexTransform<> transform = get_transform(self);
+        // Expressions consisting only of integers and slices are common in
+        // loops and are applied directly, without the general conversion.
+        if (auto simple_transform = TryApplySimpleIndexingSpec(
+                transform, spec_placeholder.value)) {
+          return apply_transform(std::forward<Self>(self),
+                                 *std::move(simple_transform));
+        }
         transform = ValueOrThrow(
             [&]() -> Result<IndexTransform<>> {
               auto spec =
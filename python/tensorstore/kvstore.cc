@@ -327,13 +327,21 @@ Example:
     >>> store = await ts.KvStore.open({'driver': 'file', 'path': 'tmp/data'})
     >>> store + '/abc'
     KvStore({
-      'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+      'context': {
+        'file_io_concurrency': {},
+        'file_io_engine': 'blocking',
+        'file_io_sync': True,
+      },
       'driver': 'file',
       'path': 'tmp/data/abc',
     })
     >>> store + 'abc'
     KvStore({
-      'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+      'context': {
+        'file_io_concurrency': {},
+        'file_io_engine': 'blocking',
+        'file_io_sync': True,
+      },
       'driver': 'file',
       'path': 'tmp/dataabc',
     })
@@ -357,13 +365,21 @@ Example:
     >>> store = await ts.KvStore.open({'driver': 'file', 'path': 'tmp/data'})
     >>> store / 'abc'
     KvStore({
-      'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+      'context': {
+        'file_io_concurrency': {},
+        'file_io_engine': 'blocking',
+        'file_io_sync': True,
+      },
       'driver': 'file',
       'path': 'tmp/data/abc',
     })
     >>> store / '/abc'
     KvStore({
-      'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+      'context': {
+        'file_io_concurrency': {},
+        'file_io_engine': 'blocking',
+        'file_io_sync': True,
+      },
       'driver': 'file',
       'path': 'tmp/data/abc',
     })
@@ -1099,7 +1115,11 @@ Example:
     ... })
     >>> kvstore
     KvStore({
-      'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+      'context': {
+        'file_io_concurrency': {},
+        'file_io_engine': 'blocking',
+        'file_io_sync': True,
+      },
       'driver': 'file',
       'path': 'tmp/data/',
     })
@@ -1116,13 +1136,21 @@ Example:
   >>> a.path = 'tmp/data/abc/'
   >>> a
   KvStore({
-    'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+    'context': {
+      'file_io_concurrency': {},
+      'file_io_engine': 'blocking',
+      'file_io_sync': True,
+    },
     'driver': 'file',
     'path': 'tmp/data/abc/',
   })
   >>> b
   KvStore({
-    'context': {'file_io_concurrency': {}, 'file_io_sync': True},
+    'context': {
+      'file_io_concurrency': {},
+      'file_io_engine': 'blocking',
+      'file_io_sync': True,
+    },
     'driver': 'file',
     'path': 'tmp/data/',
   })
@@ -1328,9 +1356,12 @@ Example:
   {'driver': 'file', 'path': 'tmp/dataset/abc/'}
   >>> spec.to_json(include_defaults=True)
   {'context': {},
+   'direct_io': False,
    'driver': 'file',
    'file_io_concurrency': 'file_io_concurrency',
+   'file_io_engine': 'file_io_engine',
    'file_io_sync': 'file_io_sync',
+   'mmap': False,
    'path': 'tmp/dataset/abc/'}
 
 Group:
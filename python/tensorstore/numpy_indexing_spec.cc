@@ -25,6 +25,7 @@
 // Other headers
 #include <algorithm>
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -42,7 +43,12 @@
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dimension_index_buffer.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/internal/interval_slice_op.h"
 #include "tensorstore/index_space/internal/numpy_indexing_spec.h"
+#include "tensorstore/index_space/internal/single_index_slice_op.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/static_cast.h"
 #include "tensorstore/util/byte_strided_pointer.h"
@@ -69,8 +75,83 @@ T CastOrTypeError(py::handle handle, const char* msg) {
   }
 }
 
+/// Converts a term or slice bound of a simple indexing expression, as
+/// accepted by `TryApplySimpleIndexingSpec`, to an `Index`.
+///
+/// \returns `false` if `obj` is not an integer or its value is out of range.
+bool GetSimpleIndex(PyObject* obj, Index& value) {
+  if (!PyLong_CheckExact(obj) &&
+      (!PyIndex_Check(obj) || PyBool_Check(obj) || PyArray_Check(obj))) {
+    return false;
+  }
+  value = PyNumber_AsSsize_t(obj, PyExc_IndexError);
+  if (value == -1 && PyErr_Occurred()) {
+    PyErr_Clear();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace
 
+std::optional<IndexTransform<>> TryApplySimpleIndexingSpec(
+    IndexTransform<> transform, pybind11::handle obj) {
+  const bool is_tuple = PyTuple_Check(obj.ptr());
+  const Py_ssize_t num_terms = is_tuple ? PyTuple_GET_SIZE(obj.ptr()) : 1;
+  if (num_terms > transform.input_rank()) return std::nullopt;
+
+  DimensionIndexBuffer slice_dims, index_dims;
+  Index starts[kMaxRank], stops[kMaxRank], steps[kMaxRank], indices[kMaxRank];
+  for (DimensionIndex i = 0; i < num_terms; ++i) {
+    PyObject* term = is_tuple ? PyTuple_GET_ITEM(obj.ptr(), i) : obj.ptr();
+    if (!PySlice_Check(term)) {
+      // Bool scalars are treated as rank-0 boolean arrays by
+      // `ParseIndexingSpec`, and are excluded by `GetSimpleIndex`.
+      if (!GetSimpleIndex(term, indices[index_dims.size()])) {
+        return std::nullopt;
+      }
+      index_dims.push_back(i);
+      continue;
+    }
+    auto* slice_obj = reinterpret_cast<PySliceObject*>(term);
+    const size_t j = slice_dims.size();
+    const auto get_bound = [](PyObject* bound, Index& value) {
+      if (bound == Py_None) {
+        value = kImplicit;
+        return true;
+      }
+      return GetSimpleIndex(bound, value);
+    };
+    if (!get_bound(slice_obj->start, starts[j]) ||
+        !get_bound(slice_obj->stop, stops[j]) ||
+        !get_bound(slice_obj->step, steps[j])) {
+      return std::nullopt;
+    }
+    if (steps[j] == kImplicit) steps[j] = 1;
+    slice_dims.push_back(i);
+  }
+
+  if (!slice_dims.empty()) {
+    const span<const Index> slice_starts(starts, slice_dims.size());
+    const span<const Index> slice_stops(stops, slice_dims.size());
+    const span<const Index> slice_steps(steps, slice_dims.size());
+    auto result = internal_index_space::ApplyIntervalSliceOp(
+        std::move(transform), &slice_dims, IntervalForm::half_open,
+        /*translate=*/false, slice_starts, slice_stops, slice_steps);
+    if (!result.ok()) return std::nullopt;
+    transform = *std::move(result);
+  }
+  if (!index_dims.empty()) {
+    const span<const Index> index_values(indices, index_dims.size());
+    auto result = internal_index_space::ApplySingleIndexSlice(
+        std::move(transform), &index_dims, index_values,
+        /*domain_only=*/false);
+    if (!result.ok()) return std::nullopt;
+    transform = *std::move(result);
+  }
+  return transform;
+}
+
 std::string_view GetIndexingModePrefix(NumpyIndexingSpec::Mode mode) {
   switch (mode) {
     case NumpyIndexingSpec::Mode::kDefault:
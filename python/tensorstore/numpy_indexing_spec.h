@@ -21,6 +21,7 @@
 // Other headers must be included after pybind11 to ensure header-order
 // inclusion constraints are satisfied.
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -62,6 +63,23 @@ NumpyIndexingSpec ParseIndexingSpec(pybind11::handle obj,
 /// This is used to generate the `__repr__` of dim expressions.
 std::string_view GetIndexingModePrefix(NumpyIndexingSpec::Mode mode);
 
+/// Attempts to apply the NumPy-style indexing expression `obj` to `transform`
+/// without constructing a `NumpyIndexingSpec`.
+///
+/// This handles expressions consisting only of integers and of slices with
+/// integer or `None` bounds, such as :python:`x[5, 10:20]`, which are common in
+/// loops that index with varying offsets.  Such expressions are applied
+/// directly as interval and index slice operations, which is equivalent to,
+/// but avoids the allocations of, converting a parsed `NumpyIndexingSpec` to
+/// an index transform and composing it with `transform`.  The result does not
+/// depend on the indexing mode.
+///
+/// \returns The new transform, or `std::nullopt` if `obj` is not such an
+///     expression or applying it fails.  In that case, the general path, which
+///     produces the appropriate error, must be used instead.
+std::optional<IndexTransform<>> TryApplySimpleIndexingSpec(
+    IndexTransform<> transform, pybind11::handle obj);
+
 /// Wraps an unvalidated `py::object` but displays as `NumpyIndexingSpec` in
 /// pybind11 function signatures.
 ///
@@ -799,8 +799,10 @@ Example:
   >>> spec
   Spec({
     'cache_pool': ['cache_pool'],
+    'codec_accelerator': ['codec_accelerator'],
     'context': {
       'cache_pool': {},
+      'codec_accelerator': {},
       'data_copy_concurrency': {},
       'memory_key_value_store': {},
     },
@@ -21,13 +21,18 @@
 #include "python/tensorstore/tensorstore_class.h"
 
 // Other headers
+#include <algorithm>
+#include <deque>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "python/tensorstore/array_type_caster.h"
 #include "python/tensorstore/batch.h"
 #include "python/tensorstore/context.h"
@@ -42,21 +47,26 @@
 #include "python/tensorstore/sequence_parameter.h"
 #include "python/tensorstore/serialization.h"
 #include "python/tensorstore/spec.h"
+#include "python/tensorstore/status.h"
 #include "python/tensorstore/tensorstore_class.h"
 #include "python/tensorstore/tensorstore_module_components.h"
 #include "python/tensorstore/write_futures.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/box.h"
 #include "tensorstore/cast.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/context.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/array/array.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json/pprint_python.h"
@@ -77,8 +87,14 @@
 #include "tensorstore/tensorstore.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 #include "tensorstore/util/unit.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
 
 // specializations
 #include "python/tensorstore/gil_safe.h"
@@ -94,6 +110,273 @@ namespace py = ::pybind11;
 
 namespace {
 
+/// Converts `out` to an array that refers directly to its memory, for use as
+/// the target of a read from a TensorStore with the specified `dtype` and
+/// `rank`.
+///
+/// \throws If `out` is not writable or does not have a data type of `dtype`.
+SharedArray<void> ConvertToReadTarget(pybind11::handle out, DataType dtype,
+                                      DimensionIndex rank) {
+  SharedArray<void> target;
+  ConvertToArray<void, dynamic_rank, /*nothrow=*/false, /*AllowCopy=*/false>(
+      out, &target, dtype, rank, rank);
+  return target;
+}
+
+/// Returns a future that resolves to `target` once `read` completes.
+Future<const SharedArray<void>> ReadIntoTarget(Future<void> read,
+                                               SharedArray<void> target) {
+  return MapFutureValue(
+      InlineExecutor{},
+      [target = std::move(target)]() -> SharedArray<void> { return target; },
+      std::move(read));
+}
+
+/// Returns `true` if `transform` is the identity transform over `domain`.
+bool IsIdentityTransformOver(IndexTransformView<> transform, BoxView<> domain) {
+  const DimensionIndex rank = domain.rank();
+  if (transform.input_rank() != rank || transform.output_rank() != rank ||
+      transform.domain().box() != domain) {
+    return false;
+  }
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const auto map = transform.output_index_maps()[i];
+    if (map.method() != OutputIndexMethod::single_input_dimension ||
+        map.input_dimension() != i || map.offset() != 0 || map.stride() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Returns a read-only array with the contents of `chunks`, which partition
+/// `domain`.
+///
+/// If there is a single chunk that references cached data laid out
+/// contiguously in `order`, the returned array aliases the cached data and
+/// retains the chunk, and thereby the cache entry, for as long as the array is
+/// referenced.  Otherwise, the chunks are copied to a newly-allocated array.
+Result<SharedArray<const void>> MakeArrayFromReadChunks(
+    span<ReadChunkView> chunks, BoxView<> domain, DataType dtype,
+    ContiguousLayoutOrder order) {
+  if (chunks.size() == 1 &&
+      IsIdentityTransformOver(chunks[0].transform(), domain)) {
+    struct AliasedChunk {
+      ReadChunkView chunk;
+      TransformedSharedArray<const void> source;
+      SharedArray<const void, dynamic_rank, zero_origin> materialized;
+    };
+    auto aliased = std::make_shared<AliasedChunk>();
+    aliased->chunk = std::move(chunks[0]);
+    TENSORSTORE_ASSIGN_OR_RETURN(aliased->source, aliased->chunk.array());
+    TENSORSTORE_ASSIGN_OR_RETURN(aliased->materialized,
+                                 aliased->source.Materialize<zero_origin>());
+    if (IsContiguousLayout(aliased->materialized.layout(), order,
+                           dtype.size())) {
+      const void* data = aliased->materialized.data();
+      auto layout = aliased->materialized.layout();
+      return SharedArray<const void>(
+          SharedElementPointer<const void>(
+              std::shared_ptr<const void>(std::move(aliased), data), dtype),
+          std::move(layout));
+    }
+    return MakeCopy(aliased->materialized, order);
+  }
+  auto target = AllocateArray(domain, order, default_init, dtype);
+  for (auto& chunk : chunks) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto source, chunk.array());
+    TENSORSTORE_RETURN_IF_ERROR(CopyTransformedArray(
+        source, MakeTransformedArray(target, chunk.transform())));
+  }
+  return ArrayOriginCast<zero_origin, container>(std::move(target));
+}
+
+/// Reads the data within the domain of `store` without copying it, if
+/// possible.
+///
+/// \returns A future that resolves to a read-only array as returned by
+///     `MakeArrayFromReadChunks`.
+Future<const SharedArray<const void>> ReadWithoutCopy(
+    const TensorStore<>& store, ContiguousLayoutOrder order, Batch batch) {
+  return MapFutureValue(
+      InlineExecutor{},
+      [domain = store.domain(), dtype = store.dtype(),
+       order](std::vector<ReadChunkView>& chunks)
+          -> Result<SharedArray<const void>> {
+        return MakeArrayFromReadChunks(chunks, domain.box(), dtype, order);
+      },
+      CollectFlowSenderIntoFuture<std::vector<ReadChunkView>>(
+          tensorstore::ReadChunks(store, std::move(batch))));
+}
+
+/// Reads `num_regions` regions of `store`, where `get_region(i)` returns the
+/// `i`-th region as an `IndexDomain` or `Box` to apply to `store`.
+///
+/// Does not require the GIL, which allows all reads to be issued without the
+/// per-call overhead of parsing Python index expressions.
+///
+/// \returns A future that resolves to the arrays read for each region, in the
+///     order of the regions.
+template <typename GetRegion>
+Result<Future<const std::vector<SharedArray<void>>>> ReadRegions(
+    const TensorStore<>& store, Index num_regions, GetRegion get_region,
+    ContiguousLayoutOrder order, const Batch& batch) {
+  std::vector<Future<SharedArray<void>>> reads(num_regions);
+  for (Index i = 0; i < num_regions; ++i) {
+    auto region_store = store | get_region(i);
+    if (!region_store.ok()) {
+      return tensorstore::MaybeAnnotateStatus(
+          region_store.status(), absl::StrFormat("Invalid region %d", i));
+    }
+    reads[i] = tensorstore::Read<zero_origin>(*region_store, order, batch);
+  }
+  auto all_reads = WaitAllFuture(span(reads));
+  return MapFutureValue(
+      InlineExecutor{},
+      [reads = std::move(reads)]() {
+        std::vector<SharedArray<void>> arrays(reads.size());
+        for (size_t i = 0; i < reads.size(); ++i) {
+          arrays[i] = reads[i].value();
+        }
+        return arrays;
+      },
+      std::move(all_reads));
+}
+
+/// Iterates over the blocks of a TensorStore domain that are aligned to its
+/// read chunk grid, keeping up to `read_ahead` reads in flight.
+///
+/// Blocks are visited in lexicographic order of their grid cell indices, with
+/// the last dimension varying fastest for `c_order` and the first dimension
+/// varying fastest for `fortran_order`.  Consequently, at most `read_ahead`
+/// blocks are held in memory, in addition to any block still referenced by the
+/// caller.
+///
+/// \threadsafety `Next` may be called concurrently from multiple threads, as
+///     is possible in free-threaded builds of Python.
+class ChunkIterator {
+ public:
+  explicit ChunkIterator(PythonTensorStoreObject& store,
+                         ContiguousLayoutOrder order, Index read_ahead)
+      : store_(store.value),
+        reference_manager_(store.reference_manager()),
+        order_(order),
+        read_ahead_(read_ahead) {
+    if (read_ahead < 1) {
+      throw py::value_error("read_ahead must be positive");
+    }
+    const auto domain = store_.domain();
+    const DimensionIndex rank = domain.rank();
+    const auto layout = ValueOrThrow(store_.chunk_layout());
+    const auto chunk_shape = layout.read_chunk_shape();
+    const auto grid_origin = layout.grid_origin();
+    domain_ = domain.box();
+    grid_origin_.resize(rank);
+    cell_shape_.resize(rank);
+    cell_.resize(rank);
+    first_cell_.resize(rank);
+    last_cell_.resize(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      if (!IsFinite(domain[i])) {
+        throw py::value_error(absl::StrFormat(
+            "Cannot iterate over chunks of unbounded domain %s",
+            tensorstore::StrCat(domain)));
+      }
+      if (domain.shape()[i] == 0) done_ = true;
+      const Index origin = static_cast<size_t>(i) < grid_origin.size()
+                               ? grid_origin[i]
+                               : kImplicit;
+      const Index shape = static_cast<size_t>(i) < chunk_shape.size()
+                              ? chunk_shape[i]
+                              : 0;
+      grid_origin_[i] = origin == kImplicit ? domain.origin()[i] : origin;
+      cell_shape_[i] =
+          shape > 0 ? shape : std::max(Index(1), domain.shape()[i]);
+      first_cell_[i] = FloorOfRatio(domain.origin()[i] - grid_origin_[i],
+                                    cell_shape_[i]);
+      last_cell_[i] = FloorOfRatio(domain[i].inclusive_max() - grid_origin_[i],
+                                   cell_shape_[i]);
+      cell_[i] = first_cell_[i];
+    }
+  }
+
+  /// Returns the next block, or `std::nullopt` once all blocks have been
+  /// returned.
+  std::optional<std::pair<IndexDomain<>, SharedArray<void>>> Next() {
+    std::pair<IndexDomain<>, Future<SharedArray<void>>> next;
+    {
+      // `mutex_` must not be acquired while holding the GIL, and is not held
+      // while waiting for the read.
+      GilScopedRelease gil_release;
+      absl::MutexLock lock(&mutex_);
+      IssueReads();
+      if (pending_.empty()) return std::nullopt;
+      next = std::move(pending_.front());
+      pending_.pop_front();
+      // Keep `read_ahead` reads in flight while waiting for this one.
+      IssueReads();
+    }
+    auto array = ValueOrThrow(InterruptibleWait(next.second));
+    return std::make_pair(std::move(next.first), std::move(array));
+  }
+
+ private:
+  /// Issues reads of the next blocks until `read_ahead_` are in flight, using
+  /// a common batch.
+  void IssueReads() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (done_ || static_cast<Index>(pending_.size()) >= read_ahead_) return;
+    Batch batch = Batch::New();
+    const DimensionIndex rank = domain_.rank();
+    Box<> block(rank);
+    while (!done_ && static_cast<Index>(pending_.size()) < read_ahead_) {
+      for (DimensionIndex i = 0; i < rank; ++i) {
+        const Index cell_min = grid_origin_[i] + cell_[i] * cell_shape_[i];
+        block[i] = Intersect(IndexInterval::UncheckedSized(cell_min,
+                                                           cell_shape_[i]),
+                             domain_[i]);
+      }
+      AdvanceCell();
+      auto block_store = store_ | block;
+      if (!block_store.ok()) {
+        pending_.emplace_back(IndexDomain<>(block),
+                              MakeReadyFuture<SharedArray<void>>(
+                                  std::move(block_store).status()));
+        continue;
+      }
+      pending_.emplace_back(
+          block_store->domain(),
+          tensorstore::Read<zero_origin>(*block_store, order_, batch));
+    }
+  }
+
+  /// Advances `cell_` to the next grid cell in `order_`, and sets `done_` once
+  /// all cells have been visited.
+  void AdvanceCell() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    const DimensionIndex rank = domain_.rank();
+    for (DimensionIndex j = 0; j < rank; ++j) {
+      const DimensionIndex i = order_ == c_order ? rank - 1 - j : j;
+      if (cell_[i] < last_cell_[i]) {
+        ++cell_[i];
+        return;
+      }
+      cell_[i] = first_cell_[i];
+    }
+    done_ = true;
+  }
+
+  TensorStore<> store_;
+  PythonObjectReferenceManager reference_manager_;
+  ContiguousLayoutOrder order_;
+  Index read_ahead_;
+  Box<> domain_;
+  std::vector<Index> grid_origin_, cell_shape_, first_cell_, last_cell_;
+  absl::Mutex mutex_;
+  std::vector<Index> cell_ ABSL_GUARDED_BY(mutex_);
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  std::deque<std::pair<IndexDomain<>, Future<SharedArray<void>>>> pending_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 template <typename... ParamDef>
 WriteFutures IssueCopyOrWrite(
     const TensorStore<>& self,
@@ -467,12 +750,36 @@ Group:
 
   cls.def(
       "read",
-      [](Self& self, ContiguousLayoutOrder order,
-         std::optional<Batch> batch) -> PythonFutureWrapper<SharedArray<void>> {
+      [](Self& self, ContiguousLayoutOrder order, std::optional<Batch> batch,
+         std::optional<ArrayArgumentPlaceholder> out, bool copy)
+          -> PythonFutureWrapper<SharedArray<void>> {
+        if (!copy) {
+          if (out) {
+            throw py::value_error(
+                "copy=False cannot be specified in combination with out");
+          }
+          return PythonFutureWrapper<SharedArray<void>>(
+              PythonFutureObject::Make(
+                  ReadWithoutCopy(self.value, order,
+                                  internal_python::ValidateOptionalBatch(
+                                      std::move(batch))),
+                  self.reference_manager()));
+        }
+        if (!out) {
+          return PythonFutureWrapper<SharedArray<void>>(
+              tensorstore::Read<zero_origin>(
+                  self.value, order,
+                  internal_python::ValidateOptionalBatch(std::move(batch))),
+              self.reference_manager());
+        }
+        SharedArray<void> target = ConvertToReadTarget(
+            out->value, self.value.dtype(), self.value.rank());
         return PythonFutureWrapper<SharedArray<void>>(
-            tensorstore::Read<zero_origin>(
-                self.value, order,
-                internal_python::ValidateOptionalBatch(std::move(batch))),
+            ReadIntoTarget(
+                tensorstore::Read(
+                    self.value, target,
+                    internal_python::ValidateOptionalBatch(std::move(batch))),
+                std::move(target)),
             self.reference_manager());
       },
       R"(
@@ -526,8 +833,39 @@ Args:
        ready until the batch is submitted.  Therefore, immediately awaiting the
        returned future will lead to deadlock.
 
+  out: Existing writable array into which to read, instead of allocating a new
+    array.  May be any object that supports the buffer protocol or the NumPy
+    array interface, such as a :py:obj:`numpy.ndarray` or pinned host memory
+    exposed through :python:`__array_interface__`.  Its data type must equal
+    :py:obj:`.dtype`, which must be a numeric type, and its shape must equal
+    the shape of the :py:obj:`.domain`.  The data is read directly into
+    :python:`out`, which must not be modified until the returned future
+    becomes ready.  If specified, :python:`order` is ignored.
+
+    >>> out = np.zeros([5, 4], dtype=np.uint32)
+    >>> await dataset[5:10, 8:12].read(out=out)
+    array([[0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0],
+           [0, 0, 0, 0]], dtype=uint32)
+
+  copy: If :python:`False`, the result is a read-only array that, where
+    possible, refers directly to the decoded chunk held in the cache rather
+    than a copy.  This is possible when the domain corresponds exactly to a
+    single chunk whose layout matches :python:`order`; otherwise, the data is
+    copied.  The cache entry is retained for as long as the returned array (or
+    any view of it) is referenced.  Cannot be combined with :python:`out`.
+
+    >>> view = await dataset.read(copy=False)
+    >>> view.flags.writeable
+    False
+
 Returns:
-  A future representing the asynchronous read result.
+  A future representing the asynchronous read result.  If :python:`out` is
+  specified, the result is an array that refers to the memory of
+  :python:`out`.  If :python:`copy=False` is specified, the result is a
+  read-only array.
 
 .. tip::
 
@@ -544,12 +882,214 @@ Returns:
 See also:
 
   - :py:obj:`.__array__`
+  - :py:obj:`tensorstore.read_into`
 
 Group:
   I/O
 
 )",
-      py::kw_only(), py::arg("order") = "C", py::arg("batch") = std::nullopt);
+      py::kw_only(), py::arg("order") = "C", py::arg("batch") = std::nullopt,
+      py::arg("out") = std::nullopt, py::arg("copy") = true);
+
+  cls.def(
+      "read_many",
+      [](Self& self, SequenceParameter<IndexDomain<>> regions,
+         ContiguousLayoutOrder order, std::optional<Batch> batch)
+          -> PythonFutureWrapper<std::vector<SharedArray<void>>> {
+        Batch read_batch = batch ? ValidateOptionalBatch(std::move(batch))
+                                 : Batch::New();
+        Result<Future<const std::vector<SharedArray<void>>>> reads;
+        {
+          GilScopedRelease gil_release;
+          reads = ReadRegions(
+              self.value, static_cast<Index>(regions.size()),
+              [&](Index i) -> const IndexDomain<>& { return regions[i]; },
+              order, read_batch);
+        }
+        return PythonFutureWrapper<std::vector<SharedArray<void>>>(
+            ValueOrThrow(std::move(reads), StatusExceptionPolicy::kIndexError),
+            self.reference_manager());
+      },
+      R"(
+Reads the data within each of several regions of the current domain.
+
+Equivalent to :python:`[self[region].read() for region in regions]`, but all
+reads are issued from C++ without holding the GIL, which avoids the per-call
+overhead of indexing and future creation in Python.  The reads are issued using
+a common :py:obj:`Batch`, which allows reads of the same chunks or nearby byte
+ranges to be coalesced.
+
+Example:
+
+    >>> store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+    >>> await store.read_many([
+    ...     ts.IndexDomain(inclusive_min=[0, 1], shape=[2, 2]),
+    ...     ts.IndexDomain(inclusive_min=[2, 0], shape=[1, 3]),
+    ... ])
+    [array([[1, 2],
+           [5, 6]], dtype=int32), array([[ 8,  9, 10]], dtype=int32)]
+
+Args:
+  regions: Domains to read, each of which is applied to this TensorStore as if
+    by :python:`self[region]`.
+  order: Contiguous layout order of the returned arrays.
+  batch: Batch to use for the reads.  If not specified, a new batch is used,
+    which is submitted before returning.
+
+    .. warning::
+
+       If specified, the returned :py:obj:`Future` will not, in general, become
+       ready until the batch is submitted.  Therefore, immediately awaiting the
+       returned future will lead to deadlock.
+
+Returns:
+  A future that becomes ready once all reads have completed, and resolves to
+  the list of arrays read for each region, in the order of :python:`regions`.
+
+Overload:
+  domains
+
+See also:
+
+  - :py:obj:`.read`
+  - :py:obj:`tensorstore.read_into`
+
+Group:
+  I/O
+
+)",
+      py::arg("regions"), py::kw_only(), py::arg("order") = "C",
+      py::arg("batch") = std::nullopt);
+
+  cls.def(
+      "read_many",
+      [](Self& self, SharedArray<const Index, 2> origins,
+         SharedArray<const Index, 2> shapes, ContiguousLayoutOrder order,
+         std::optional<Batch> batch)
+          -> PythonFutureWrapper<std::vector<SharedArray<void>>> {
+        const DimensionIndex rank = self.value.rank();
+        if (origins.shape() != shapes.shape() || origins.shape()[1] != rank) {
+          throw py::value_error(absl::StrFormat(
+              "Expected inclusive_min and shape to have equal shapes of "
+              "[n, %d]",
+              rank));
+        }
+        Batch read_batch = batch ? ValidateOptionalBatch(std::move(batch))
+                                 : Batch::New();
+        Result<Future<const std::vector<SharedArray<void>>>> reads;
+        {
+          GilScopedRelease gil_release;
+          reads = ReadRegions(
+              self.value, origins.shape()[0],
+              [&](Index i) {
+                Box<> box(rank);
+                for (DimensionIndex j = 0; j < rank; ++j) {
+                  box.origin()[j] = origins(i, j);
+                  box.shape()[j] = shapes(i, j);
+                }
+                return box;
+              },
+              order, read_batch);
+        }
+        return PythonFutureWrapper<std::vector<SharedArray<void>>>(
+            ValueOrThrow(std::move(reads), StatusExceptionPolicy::kIndexError),
+            self.reference_manager());
+      },
+      R"(
+Reads the data within each of several boxes of the current domain.
+
+Equivalent to :py:obj:`.read_many(domains)` with
+:python:`ts.IndexDomain(inclusive_min=inclusive_min[i], shape=shape[i])` as the
+:python:`i`-th region, but avoids constructing a Python object per region.
+
+Example:
+
+    >>> store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+    >>> await store.read_many(inclusive_min=[[0, 1], [2, 0]],
+    ...                       shape=[[2, 2], [1, 3]])
+    [array([[1, 2],
+           [5, 6]], dtype=int32), array([[ 8,  9, 10]], dtype=int32)]
+
+Args:
+  inclusive_min: Array of shape :python:`[n, self.rank]` specifying the
+    inclusive lower bounds of each region.
+  shape: Array of shape :python:`[n, self.rank]` specifying the shape of each
+    region.
+  order: Contiguous layout order of the returned arrays.
+  batch: Batch to use for the reads.  If not specified, a new batch is used,
+    which is submitted before returning.
+
+Returns:
+  A future that becomes ready once all reads have completed, and resolves to
+  the list of arrays read for each region.
+
+Overload:
+  boxes
+
+Group:
+  I/O
+
+)",
+      py::kw_only(), py::arg("inclusive_min"), py::arg("shape"),
+      py::arg("order") = "C", py::arg("batch") = std::nullopt);
+
+  cls.def(
+      "iter_chunks",
+      [](Self& self, Index read_ahead, ContiguousLayoutOrder order) {
+        return std::make_unique<ChunkIterator>(self, order, read_ahead);
+      },
+      R"(
+Iterates over the blocks of the current domain aligned to the read chunk grid.
+
+Each block is the intersection of the current domain with a cell of the read
+chunk grid specified by :py:obj:`.chunk_layout`; dimensions without a read
+chunk shape are not subdivided.  Up to :py:param:`.read_ahead` blocks are read
+concurrently, using a common :py:obj:`Batch`, while the caller processes
+previously-returned blocks.  This bounds memory usage to approximately
+:python:`read_ahead` chunks.
+
+Example:
+
+    >>> store = await ts.open(
+    ...     {
+    ...         'driver': 'zarr',
+    ...         'kvstore': {
+    ...             'driver': 'memory'
+    ...         }
+    ...     },
+    ...     dtype=ts.uint32,
+    ...     shape=[4, 5],
+    ...     chunk_layout=ts.ChunkLayout(read_chunk_shape=[2, 3]),
+    ...     create=True)
+    >>> await store.write(np.arange(20, dtype=np.uint32).reshape(4, 5))
+    >>> for domain, block in store.iter_chunks(read_ahead=2):
+    ...     print(domain, block.tolist())
+    { [0, 2), [0, 3) } [[0, 1, 2], [5, 6, 7]]
+    { [0, 2), [3, 5) } [[3, 4], [8, 9]]
+    { [2, 4), [0, 3) } [[10, 11, 12], [15, 16, 17]]
+    { [2, 4), [3, 5) } [[13, 14], [18, 19]]
+
+Args:
+  read_ahead: Maximum number of blocks to read concurrently.
+  order: Order in which blocks are visited, in terms of their grid cell
+    indices, and contiguous layout order of the returned arrays.
+
+Returns:
+  Iterator over :python:`(domain, array)` pairs, where :python:`array` holds
+  the contents of :python:`self[domain]`.
+
+Raises:
+  ValueError: If the current domain is unbounded.
+
+See also:
+
+  - :py:obj:`.read_many`
+
+Group:
+  I/O
+
+)",
+      py::kw_only(), py::arg("read_ahead") = 4, py::arg("order") = "C");
 
   ForwardWriteSetters([&](auto... param_def) {
     std::string doc = R"(
@@ -907,6 +1447,72 @@ Group:
 )",
       py::arg("dtype") = std::nullopt, py::arg("context") = std::nullopt);
 
+  cls.def(
+      "__dlpack__",
+      [](Self& self, py::kwargs kwargs) {
+        py::object array = py::cast(ValueOrThrow(
+            internal_python::InterruptibleWait(
+                tensorstore::Read<zero_origin>(self.value))));
+        return array.attr("__dlpack__")(**kwargs);
+      },
+      R"(
+Exports the contents as a DLPack capsule for interoperability with other array
+libraries.
+
+*Synchronously* reads from the current domain into a host array, and exports it
+without any further copying.  This allows frameworks that support the
+`DLPack protocol <https://dmlc.github.io/dlpack/latest/python_spec.html>`__,
+such as JAX and PyTorch, to consume a TensorStore directly:
+
+    >>> dataset = await ts.open(
+    ...     {
+    ...         'driver': 'zarr',
+    ...         'kvstore': {
+    ...             'driver': 'memory'
+    ...         }
+    ...     },
+    ...     dtype=ts.uint32,
+    ...     shape=[2, 3],
+    ...     create=True)
+    >>> np.from_dlpack(dataset)
+    array([[0, 0, 0],
+           [0, 0, 0]], dtype=uint32)
+
+Keyword arguments, such as :python:`stream` and :python:`max_version`, are
+forwarded to :py:obj:`numpy.ndarray.__dlpack__`.
+
+.. warning::
+
+   This reads the entire domain into memory and blocks the current thread while
+   reading.
+
+See also:
+
+   - :py:obj:`.__array__`
+   - :py:obj:`.__dlpack_device__`
+
+Group:
+  I/O
+
+)");
+
+  cls.def(
+      "__dlpack_device__",
+      [](Self& self) {
+        // Exported arrays always reside in host memory (`kDLCPU`).
+        return py::make_tuple(1, 0);
+      },
+      R"(
+Returns the DLPack device type and id of arrays exported by
+:py:obj:`.__dlpack__`.
+
+Exported arrays always reside in host memory, indicated by :python:`(1, 0)`.
+
+Group:
+  I/O
+
+)");
+
   cls.def(
       "resolve",
       [](Self& self, bool fix_resizable_bounds,
@@ -2314,6 +2920,88 @@ Group:
       py::arg("context") = nullptr, py::arg("copy") = std::nullopt,
       py::arg("write") = std::nullopt);
 
+  m.def(
+      "read_into",
+      [](SequenceParameter<PythonTensorStoreObject*> sources,
+         ArrayArgumentPlaceholder out,
+         std::optional<Batch> batch) -> PythonFutureWrapper<SharedArray<void>> {
+        const Index num_sources = static_cast<Index>(sources.size());
+        std::vector<TensorStore<>> stores(num_sources);
+        for (Index i = 0; i < num_sources; ++i) {
+          stores[i] = sources[i]->value;
+        }
+        const DimensionIndex rank =
+            stores.empty() ? dynamic_rank : stores[0].rank() + 1;
+        SharedArray<void> target = ConvertToReadTarget(
+            out.value, stores.empty() ? DataType() : stores[0].dtype(), rank);
+        if (target.rank() == 0 || target.shape()[0] != num_sources) {
+          throw py::value_error(
+              absl::StrFormat("Expected out to have an outer dimension of "
+                              "size %d",
+                              num_sources));
+        }
+        // Reads issued with a common batch may be coalesced.
+        Batch read_batch = batch ? ValidateOptionalBatch(std::move(batch))
+                                 : Batch::New();
+        std::vector<Future<void>> reads(num_sources);
+        for (Index i = 0; i < num_sources; ++i) {
+          reads[i] = tensorstore::Read(
+              stores[i], SharedSubArray<container>(target, {i}), read_batch);
+        }
+        PythonObjectReferenceManager manager;
+        manager.Update(stores);
+        return PythonFutureWrapper<SharedArray<void>>(
+            ReadIntoTarget(WaitAllFuture(span(reads)), std::move(target)),
+            std::move(manager));
+      },
+      R"(
+Reads each of several TensorStores into a slice of a single existing array.
+
+Reads :python:`sources[i]` into :python:`out[i]`, as if by
+:python:`sources[i].read(out=out[i])`, for example to assemble a batch of
+training examples directly in a pinned staging buffer.  The reads are issued
+using a common :py:obj:`Batch`, which allows reads of the same chunks or
+nearby byte ranges to be coalesced.
+
+Example:
+
+    >>> store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+    >>> out = np.zeros([2, 4], dtype=np.int32)
+    >>> await ts.read_into([store[0], store[2]], out)
+    array([[ 0,  1,  2,  3],
+           [ 8,  9, 10, 11]], dtype=int32)
+
+Args:
+  sources: TensorStores to read, which must all have the same data type and
+    shapes equal to :python:`out.shape[1:]`.
+  out: Existing writable array into which to read, with an outer dimension of
+    size :python:`len(sources)`.  May be any object that supports the buffer
+    protocol or the NumPy array interface.  Its data type must equal the data
+    type of the sources, which must be a numeric type.  It must not be
+    modified until the returned future becomes ready.
+  batch: Batch to use for the reads.  If not specified, a new batch is used,
+    which is submitted before returning.
+
+    .. warning::
+
+       If specified, the returned :py:obj:`Future` will not, in general, become
+       ready until the batch is submitted.  Therefore, immediately awaiting the
+       returned future will lead to deadlock.
+
+Returns:
+  A future that becomes ready once all reads have completed, and resolves to an
+  array that refers to the memory of :python:`out`.
+
+See also:
+
+  - :py:obj:`TensorStore.read`
+
+Group:
+  I/O
+)",
+      py::arg("sources"), py::arg("out"), py::kw_only(),
+      py::arg("batch") = std::nullopt);
+
   ForwardOpenSetters([&](auto... param_def) {
     std::string doc = R"(
 Opens or creates a :py:class:`TensorStore` from a :py:class:`Spec`.
@@ -2397,6 +3085,7 @@ like the data type, domain, and chunk layout, may be omitted:
         'cache_pool': {},
         'data_copy_concurrency': {},
         'gcs_request_concurrency': {},
+        'gcs_request_hedging': {},
         'gcs_request_retries': {},
         'gcs_user_project': {},
       },
@@ -2749,6 +3438,30 @@ Group:
   });
 }
 
+using ChunkIteratorCls = py::class_<ChunkIterator>;
+
+ChunkIteratorCls DefineChunkIteratorClass(py::handle m) {
+  return ChunkIteratorCls(m, "ChunkIterator", R"(
+Iterator over the chunk-aligned blocks of a :py:class:`TensorStore`.
+
+.. seealso::
+
+   :py:obj:`tensorstore.TensorStore.iter_chunks`
+
+Group:
+  I/O
+)");
+}
+
+void DefineChunkIteratorAttributes(ChunkIteratorCls& cls) {
+  cls.def("__iter__", [](py::object self) { return self; });
+  cls.def("__next__", [](ChunkIterator& self) {
+    auto block = self.Next();
+    if (!block) throw py::stop_iteration();
+    return *std::move(block);
+  });
+}
+
 using ArrayStorageStatisticsCls = py::class_<ArrayStorageStatistics>;
 
 ArrayStorageStatisticsCls DefineArrayStorageStatisticsClass(py::handle m) {
@@ -2874,6 +3587,9 @@ void RegisterTensorStoreBindings(pybind11::module m, Executor defer) {
   defer([cls = DefineArrayStorageStatisticsClass(tensorstore_cls)]() mutable {
     DefineArrayStorageStatisticsAttributes(cls);
   });
+  defer([cls = DefineChunkIteratorClass(tensorstore_cls)]() mutable {
+    DefineChunkIteratorAttributes(cls);
+  });
 }
 
 TENSORSTORE_GLOBAL_INITIALIZER {
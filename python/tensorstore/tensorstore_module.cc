@@ -56,6 +56,14 @@ class ScopedModuleNameOverride {
 };
 
 PYBIND11_MODULE(_tensorstore, m) {
+#if defined(Py_GIL_DISABLED) && PYBIND11_VERSION_HEX >= 0x020D0000
+  // The module does not rely on the GIL (PEP 703): state that is otherwise
+  // protected by the GIL is protected by `PythonObjectCriticalSection` or
+  // mutexes.  Earlier versions of pybind11 are not thread safe without the GIL,
+  // in which case Python re-enables the GIL on import.
+  PyUnstable_Module_SetGIL(m.ptr(), Py_MOD_GIL_NOT_USED);
+#endif
+
   absl::InitializeLog();
 
   internal_python::InitializeNumpy();
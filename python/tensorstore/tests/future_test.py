@@ -42,6 +42,45 @@ def test_promise_result_release_gil():
   t.join()
 
 
+def test_concurrent_callbacks():
+  # Callbacks are added, removed, and invoked concurrently from multiple
+  # threads, which in free-threaded builds of Python are not serialized by the
+  # GIL.
+  num_threads = 8
+  num_futures = 200
+  pairs = [ts.Promise.new() for _ in range(num_futures)]
+  counts = [0] * num_threads
+  barrier = threading.Barrier(num_threads + 1)
+
+  def add_callbacks(thread_index):
+    def callback(f):
+      counts[thread_index] += 1
+
+    def unused_callback(f):
+      pass
+
+    barrier.wait()
+    for _, future in pairs:
+      future.add_done_callback(callback)
+      future.add_done_callback(unused_callback)
+      future.remove_done_callback(unused_callback)
+
+  threads = [
+      threading.Thread(target=add_callbacks, args=(i,))
+      for i in range(num_threads)
+  ]
+  for t in threads:
+    t.start()
+  barrier.wait()
+  for i, (promise, _) in enumerate(pairs):
+    promise.set_result(i)
+  for t in threads:
+    t.join()
+  assert counts == [num_futures] * num_threads
+  for i, (_, future) in enumerate(pairs):
+    assert future.result() == i
+
+
 def test_promise_set_exception():
   promise, future = ts.Promise.new()
   assert future.done() == False
@@ -137,6 +176,33 @@ async def test_coroutine_explicit_loop():
   t.join()
 
 
+async def test_await_many():
+  promises = []
+  futures = []
+  for _ in range(10000):
+    promise, future = ts.Promise.new()
+    promises.append(promise)
+    futures.append(future)
+
+  def complete():
+    for i, promise in enumerate(promises):
+      if i % 3 == 0:
+        promise.set_exception(ValueError(str(i)))
+      else:
+        promise.set_result(i)
+
+  t = threading.Thread(target=complete)
+  t.start()
+  results = await asyncio.gather(*futures, return_exceptions=True)
+  t.join()
+  for i, result in enumerate(results):
+    if i % 3 == 0:
+      assert isinstance(result, ValueError)
+      assert str(result) == str(i)
+    else:
+      assert result == i
+
+
 @pytest.mark.filterwarnings(
     'ignore:coroutine .* was never awaited:RuntimeWarning'
 )
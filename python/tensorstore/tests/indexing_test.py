@@ -211,3 +211,43 @@ def test_slice():
   with pytest.raises(
       IndexError, match="Computing interval slice for dimension 0: .*"):
     y[1:6]
+
+
+def test_integer_and_slice_match_general_path():
+  x = ts.IndexTransform(
+      domain=[
+          ts.Dim(inclusive_min=-3, size=20, label="a"),
+          ts.Dim(size=15, implicit_upper=True, label="b"),
+          ts.Dim(inclusive_min=4, size=8, label="c"),
+      ],
+      output=[
+          ts.OutputIndexMap(offset=5, stride=2, input_dimension=2),
+          ts.OutputIndexMap(input_dimension=0),
+          ts.OutputIndexMap(input_dimension=1),
+      ],
+  )
+  # Expressions of integers and slices are applied directly, while the
+  # trailing `...` forces the general path.
+  for expr in [
+      1,
+      np.int64(1),
+      (slice(None, None, 3),),
+      (slice(10, -2, -3), 20),
+      (2, slice(None), 5),
+      (slice(-3, None), slice(None, 30), slice(5, 9, 2)),
+      (),
+  ]:
+    terms = expr if isinstance(expr, tuple) else (expr,)
+    assert x[expr] == x[terms + (...,)], expr
+
+  a = ts.array(np.arange(12).reshape(3, 4))
+  np.testing.assert_equal(np.array(a[1:, ::-2]), [[7, 5], [11, 9]])
+  a[2, 1:3] = [100, 101]
+  np.testing.assert_equal(np.array(a[2]), [8, 100, 101, 11])
+
+  with pytest.raises(IndexError, match="Computing interval slice"):
+    x[100:]
+  with pytest.raises(IndexError, match="Indexing expression requires 4"):
+    x[1, 2, 3, 4]
+  with pytest.raises(IndexError):
+    x[-10]
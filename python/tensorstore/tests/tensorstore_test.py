@@ -17,6 +17,7 @@ import copy
 import pickle
 import re
 import tempfile
+import threading
 import time
 
 import numpy as np
@@ -543,6 +544,195 @@ async def test_zero_copy(writable: bool):
   np.testing.assert_equal(43, await store.read())
 
 
+async def test_read_out():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  out = np.zeros([2, 4], dtype=np.int32)
+  result = await store[1:].read(out=out)
+  np.testing.assert_equal(out, [[4, 5, 6, 7], [8, 9, 10, 11]])
+  assert np.shares_memory(result, out)
+
+
+async def test_read_out_errors():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  with pytest.raises(ValueError):
+    store.read(out=np.zeros([3, 4], dtype=np.float32))
+  read_only = np.zeros([3, 4], dtype=np.int32)
+  read_only.setflags(write=False)
+  with pytest.raises(ValueError):
+    store.read(out=read_only)
+  with pytest.raises(ValueError, match="Error aligning dimensions"):
+    await store.read(out=np.zeros([3, 5], dtype=np.int32))
+
+
+async def test_read_no_copy():
+  store = await ts.open(
+      {
+          'driver': 'zarr',
+          'kvstore': {'driver': 'memory'},
+          'context': {'cache_pool': {'total_bytes_limit': 1000000}},
+      },
+      dtype=ts.int32,
+      shape=[4, 6],
+      chunk_layout=ts.ChunkLayout(chunk_shape=[2, 3]),
+      create=True,
+  )
+  expected = np.arange(24, dtype=np.int32).reshape(4, 6)
+  await store.write(expected)
+
+  # Single aligned chunk.
+  view = await store[2:4, 3:6].read(copy=False)
+  np.testing.assert_equal(view, expected[2:4, 3:6])
+  assert not view.flags.writeable
+  assert view.flags.c_contiguous
+
+  # Unaligned region and multiple chunks are copied.
+  for region in [store[1:3, 1:2], store[1:4, 2:6], store]:
+    view = await region.read(copy=False)
+    np.testing.assert_equal(view, expected[region.domain.index_exp])
+    assert not view.flags.writeable
+
+  view = await store[0:2, 0:3].read(copy=False, order='F')
+  np.testing.assert_equal(view, expected[0:2, 0:3])
+  assert view.flags.f_contiguous
+
+
+async def test_read_no_copy_with_out():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  with pytest.raises(ValueError, match='copy=False'):
+    store.read(copy=False, out=np.zeros([3, 4], dtype=np.int32))
+
+
+async def test_read_into():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  out = np.zeros([3, 2], dtype=np.int32)
+  result = await ts.read_into([store[2, :2], store[0, 2:], store[1, 1:3]], out)
+  np.testing.assert_equal(out, [[8, 9], [2, 3], [5, 6]])
+  assert np.shares_memory(result, out)
+  with pytest.raises(ValueError, match="outer dimension of size 2"):
+    ts.read_into([store[0], store[1]], np.zeros([3, 4], dtype=np.int32))
+
+
+async def test_read_many():
+  store = ts.array(np.arange(12, dtype=np.int32).reshape(3, 4))
+  results = await store.read_many([
+      ts.IndexDomain(inclusive_min=[0, 1], shape=[2, 2]),
+      ts.IndexDomain(inclusive_min=[2, 0], shape=[1, 3]),
+  ])
+  assert len(results) == 2
+  np.testing.assert_equal(results[0], [[1, 2], [5, 6]])
+  np.testing.assert_equal(results[1], [[8, 9, 10]])
+
+  results = await store.read_many(
+      inclusive_min=[[0, 1], [2, 0]], shape=[[2, 2], [1, 3]], order="F"
+  )
+  np.testing.assert_equal(results[0], [[1, 2], [5, 6]])
+  assert results[0].flags.f_contiguous
+  np.testing.assert_equal(results[1], [[8, 9, 10]])
+
+  assert await store.read_many([]) == []
+  with pytest.raises(IndexError, match="Invalid region 1"):
+    store.read_many([
+        ts.IndexDomain(shape=[1, 1]),
+        ts.IndexDomain(shape=[4, 1]),
+    ])
+  with pytest.raises(ValueError, match="equal shapes"):
+    store.read_many(inclusive_min=[[0, 0]], shape=[[1, 1, 1]])
+
+
+async def test_iter_chunks():
+  store = await ts.open(
+      {"driver": "zarr", "kvstore": "memory://"},
+      dtype=ts.uint32,
+      shape=[4, 5],
+      chunk_layout=ts.ChunkLayout(read_chunk_shape=[2, 3]),
+      create=True,
+  )
+  data = np.arange(20, dtype=np.uint32).reshape(4, 5)
+  await store.write(data)
+
+  for order, expected_origins in [
+      ("C", [(0, 0), (0, 3), (2, 0), (2, 3)]),
+      ("F", [(0, 0), (2, 0), (0, 3), (2, 3)]),
+  ]:
+    blocks = list(store.iter_chunks(read_ahead=2, order=order))
+    assert [d.inclusive_min for d, _ in blocks] == expected_origins
+    for domain, block in blocks:
+      np.testing.assert_equal(block, data[domain.index_exp])
+
+  blocks = list(store[1:3, 1:].iter_chunks(read_ahead=1))
+  assert [d.inclusive_min for d, _ in blocks] == [
+      (1, 1), (1, 3), (2, 1), (2, 3)
+  ]
+  assert list(store[:0].iter_chunks()) == []
+
+  with pytest.raises(ValueError, match="read_ahead"):
+    store.iter_chunks(read_ahead=0)
+  with pytest.raises(ValueError, match="unbounded"):
+    ts.virtual_chunked(
+        lambda *args: None, rank=1, dtype=ts.uint8
+    ).iter_chunks()
+
+
+async def test_iter_chunks_concurrent():
+  store = await ts.open(
+      {"driver": "zarr", "kvstore": "memory://"},
+      dtype=ts.uint32,
+      shape=[64, 5],
+      chunk_layout=ts.ChunkLayout(read_chunk_shape=[2, 5]),
+      create=True,
+  )
+  data = np.arange(64 * 5, dtype=np.uint32).reshape(64, 5)
+  await store.write(data)
+
+  # Each block is returned to exactly one of the threads.
+  it = store.iter_chunks(read_ahead=4)
+  results = [[] for _ in range(8)]
+
+  def consume(thread_results):
+    for domain, block in it:
+      thread_results.append((domain.inclusive_min, block))
+
+  threads = [threading.Thread(target=consume, args=(r,)) for r in results]
+  for t in threads:
+    t.start()
+  for t in threads:
+    t.join()
+  blocks = sorted((b for r in results for b in r), key=lambda b: b[0])
+  assert [origin for origin, _ in blocks] == [(i, 0) for i in range(0, 64, 2)]
+  for (i, _), block in blocks:
+    np.testing.assert_equal(block, data[i : i + 2])
+
+
+class _DlpackOnly:
+  """Array wrapper that only supports the DLPack protocol."""
+
+  def __init__(self, array):
+    self._array = array
+
+  def __dlpack__(self, **kwargs):
+    return self._array.__dlpack__(**kwargs)
+
+  def __dlpack_device__(self):
+    return self._array.__dlpack_device__()
+
+
+async def test_dlpack_import():
+  data = np.arange(6, dtype=np.int32).reshape(2, 3)
+  t = ts.array(_DlpackOnly(data), copy=False)
+  data[0, 0] = 42
+  np.testing.assert_equal(await t.read(), data)
+
+  store = ts.array(np.zeros([2, 3], dtype=np.int32))
+  await store.write(_DlpackOnly(data))
+  np.testing.assert_equal(await store.read(), data)
+
+
+def test_dlpack_export():
+  store = ts.array(np.arange(6, dtype=np.int32).reshape(2, 3))
+  assert store.__dlpack_device__() == (1, 0)
+  np.testing.assert_equal(np.from_dlpack(store[1:]), [[3, 4, 5]])
+
+
 def test_issue_168():
   t = ts.array(np.zeros((0,)))
   assert t.spec().to_json(include_defaults=False) == {
@@ -150,6 +150,100 @@ async def test_read_adapt():
   )
 
 
+def test_batch_read():
+  """Tests reading with a `batch_read_function`."""
+  array = np.arange(20, dtype=np.int32).reshape(4, 5)
+  chunks_read = []
+
+  def do_batch_read(domains, arrays, read_params):
+    assert len(domains) == len(arrays) == len(read_params)
+    for domain, chunk in zip(domains, arrays):
+      chunks_read.append(domain)
+      chunk[...] = array[domain.index_exp]
+
+  t = ts.virtual_chunked(
+      batch_read_function=do_batch_read,
+      dtype=array.dtype,
+      shape=array.shape,
+      chunk_layout=ts.ChunkLayout(read_chunk_shape=(2, 3)),
+  )
+  np.testing.assert_array_equal(t.read().result(), array)
+  assert len(chunks_read) == 4
+
+  t2 = cloudpickle.loads(cloudpickle.dumps(t))
+  np.testing.assert_array_equal(t2[1:3].read().result(), array[1:3])
+
+
+def test_cache_key():
+  """Tests that views with the same `cache_key` share cached chunks."""
+  context = ts.Context({'cache_pool': {'total_bytes_limit': 1000000}})
+  num_reads = [0]
+
+  def do_read(domain, array, read_params):
+    del domain, read_params
+    num_reads[0] += 1
+    array[...] = 42
+
+  def open_view():
+    return ts.virtual_chunked(
+        do_read,
+        dtype=ts.int32,
+        shape=[2],
+        context=context,
+        cache_key='answer',
+    )
+
+  t1 = open_view()
+  t2 = open_view()
+  np.testing.assert_array_equal(t1.read().result(), [42, 42])
+  np.testing.assert_array_equal(t2.read().result(), [42, 42])
+  assert num_reads[0] == 1
+
+
+async def test_batch_read_async_string():
+  """Tests an async `batch_read_function` with a dtype of ustring."""
+
+  async def do_batch_read(domains, arrays, read_params):
+    del read_params
+    for domain, chunk in zip(domains, arrays):
+      for i, x in enumerate(domain[0]):
+        chunk[i] = str(x)
+    return [None] * len(domains)
+
+  t = ts.virtual_chunked(
+      batch_read_function=do_batch_read,
+      dtype=ts.ustring,
+      shape=[3],
+      chunk_layout=ts.ChunkLayout(read_chunk_shape=[2]),
+  )
+  np.testing.assert_array_equal(
+      await t.read(), np.array(['0', '1', '2'], dtype=object)
+  )
+
+
+def test_batch_read_wrong_number_of_generations():
+
+  def do_batch_read(domains, arrays, read_params):
+    del domains, arrays, read_params
+    return []
+
+  t = ts.virtual_chunked(
+      batch_read_function=do_batch_read, dtype=ts.int32, shape=[2]
+  )
+  with pytest.raises(ValueError, match='returned 0 generations for 1 chunks'):
+    t.read().result()
+
+
+def test_batch_read_and_read_function():
+  with pytest.raises(ValueError):
+    ts.virtual_chunked(
+        lambda *args: None,
+        batch_read_function=lambda *args: None,
+        dtype=ts.int32,
+        shape=[2],
+    )
+
+
 async def test_string_read():
   """Tests that reading works with a dtype of ustring.
 
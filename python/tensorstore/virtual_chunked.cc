@@ -17,14 +17,20 @@
 // Other headers must be included after pybind11 to ensure header-order
 // inclusion constraints are satisfied.
 
+#include <stddef.h>
+
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "python/tensorstore/array_type_caster.h"
 #include "python/tensorstore/context.h"
@@ -41,6 +47,7 @@
 #include "python/tensorstore/time.h"
 #include "python/tensorstore/type_name_override.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/container_kind.h"
 #include "tensorstore/context.h"
 #include "tensorstore/index_space/index_domain.h"
@@ -54,6 +61,7 @@
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
 #include "tensorstore/virtual_chunked.h"
 
 // specializations
@@ -180,6 +188,20 @@ TimestampedStorageGeneration NormalizeOptionalTimestampedStorageGeneration(
       absl::InfiniteFuture());
 }
 
+/// Returns the domain passed to the Python function for a chunk with the
+/// specified `bounds`, using the labels of `orig_domain`.
+Result<IndexDomain<>> GetChunkDomain(BoxView<> bounds,
+                                     const IndexDomain<>& orig_domain) {
+  IndexDomainBuilder domain_builder(bounds.rank());
+  domain_builder.bounds(bounds);
+  // Check `orig_domain.rank()` in case it was deserialized from a corrupt
+  // representation.
+  if (orig_domain.valid() && orig_domain.rank() == bounds.rank()) {
+    domain_builder.labels(orig_domain.labels());
+  }
+  return domain_builder.Finalize();
+}
+
 /// Adapts a Python `read_function` or `write_function` into a serializable
 /// `ReadFunction` or `WriteFunction` as expected by the C++
 /// `tensorstore::VirtualChunked` interface.
@@ -219,14 +241,8 @@ struct FunctionAdapterBase {
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto zero_origin_array,
         (ArrayOriginCast<zero_origin, container>(offset_array)));
-    IndexDomainBuilder domain_builder(offset_array.rank());
-    domain_builder.bounds(offset_array.domain());
-    // Check `orig_domain.rank()` in case it was deserialized from a corrupt
-    // representation.
-    if (orig_domain.valid() && orig_domain.rank() == offset_array.rank()) {
-      domain_builder.labels(orig_domain.labels());
-    }
-    TENSORSTORE_ASSIGN_OR_RETURN(auto domain, domain_builder.Finalize());
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto domain, GetChunkDomain(offset_array.domain(), orig_domain));
     py::object future_like;
     py::object python_array;
     if (CallAndSetErrorIndicator([&] {
@@ -292,6 +308,172 @@ struct WriteFunctionAdapter : public FunctionAdapterBase<false> {
       "0python:tensorstore.virtual_chunked.write";
 };
 
+/// Chunk read waiting to be passed to a `batch_read_function`.
+struct PendingBatchRead {
+  Array<void, dynamic_rank, offset_origin> array;
+  virtual_chunked::ReadParameters params;
+  Promise<TimestampedStorageGeneration> promise;
+};
+
+/// Chunk reads issued by a `BatchReadFunctionAdapter`.
+struct BatchReadQueue {
+  absl::Mutex mutex;
+  std::vector<PendingBatchRead> pending ABSL_GUARDED_BY(mutex);
+};
+
+/// Result of a `batch_read_function`: either `None` or one generation per
+/// chunk.
+using BatchReadStamps =
+    std::optional<std::vector<std::optional<TimestampedStorageGeneration>>>;
+
+/// Completes the reads in a batch once the `batch_read_function` is done.
+struct BatchReadCompletion {
+  std::vector<PendingBatchRead> reads;
+  // Zero-origin views of `reads[i].array`.
+  std::vector<Array<void>> arrays;
+  // List of NumPy arrays passed to the `batch_read_function`.
+  GilSafeHolder<py::object> python_arrays;
+  // Indicates that the NumPy arrays do not share memory with `arrays`.
+  bool copy_back;
+
+  void Complete(const Result<BatchReadStamps>& result) {
+    absl::Status status = result.status();
+    if (status.ok() && *result && (*result)->size() != reads.size()) {
+      status = absl::InvalidArgumentError(tensorstore::StrCat(
+          "batch_read_function returned ", (*result)->size(),
+          " generations for ", reads.size(), " chunks"));
+    }
+    if (!status.ok()) {
+      for (auto& read : reads) read.promise.SetResult(status);
+      return;
+    }
+    std::optional<ExitSafeGilScopedAcquire> gil;
+    if (copy_back) {
+      gil.emplace();
+      if (!gil->acquired()) {
+        for (auto& read : reads) read.promise.SetResult(PythonExitingError());
+        return;
+      }
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+      auto& read = reads[i];
+      if (copy_back && CallAndSetErrorIndicator([&] {
+            CopyFromNumpyArray(PyList_GET_ITEM(python_arrays->ptr(), i),
+                               arrays[i]);
+          })) {
+        read.promise.SetResult(GetStatusFromPythonException());
+        continue;
+      }
+      read.promise.SetResult(NormalizeOptionalTimestampedStorageGeneration(
+          *result ? (**result)[i] : std::nullopt));
+    }
+  }
+};
+
+/// Adapts a Python `batch_read_function`, which computes the content of
+/// multiple chunks in a single call, into a serializable `ReadFunction`.
+///
+/// Each chunk read is added to a queue, and then the GIL is acquired.  The
+/// first thread to acquire the GIL passes all queued reads to the Python
+/// function.  While that function runs, reads issued by other threads
+/// accumulate in the queue and form the next batch.
+struct BatchReadFunctionAdapter {
+  constexpr static const char id[] =
+      "0python:tensorstore.virtual_chunked.batch_read";
+
+  GilSafeHolder<FunctionAdapterBase<true>::State> state;
+  IndexDomain<> orig_domain;
+  // Not serialized.
+  std::shared_ptr<BatchReadQueue> queue = std::make_shared<BatchReadQueue>();
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.state, x.orig_domain);
+  };
+
+  Future<TimestampedStorageGeneration> operator()(
+      Array<void, dynamic_rank, offset_origin> offset_array,
+      virtual_chunked::ReadParameters params) const {
+    auto [promise, future] =
+        PromiseFuturePair<TimestampedStorageGeneration>::Make();
+    {
+      absl::MutexLock lock(&queue->mutex);
+      queue->pending.push_back(
+          {std::move(offset_array), std::move(params), std::move(promise)});
+    }
+    ExitSafeGilScopedAcquire gil;
+    std::vector<PendingBatchRead> batch;
+    {
+      absl::MutexLock lock(&queue->mutex);
+      std::swap(batch, queue->pending);
+    }
+    // The read may already have been handled by another thread.
+    if (batch.empty()) return future;
+    if (!gil.acquired()) {
+      for (auto& read : batch) read.promise.SetResult(PythonExitingError());
+      return future;
+    }
+    InvokeBatch(std::move(batch));
+    return future;
+  }
+
+  // Calls the Python function for `batch`.  The GIL must be held.
+  void InvokeBatch(std::vector<PendingBatchRead> batch) const {
+    auto completion = std::make_shared<BatchReadCompletion>();
+    std::vector<IndexDomain<>> domains;
+    for (auto& read : batch) {
+      auto domain = GetChunkDomain(read.array.domain(), orig_domain);
+      auto array = ArrayOriginCast<zero_origin, container>(read.array);
+      if (!domain.ok() || !array.ok()) {
+        read.promise.SetResult(!domain.ok() ? domain.status()
+                                            : array.status());
+        continue;
+      }
+      domains.push_back(*std::move(domain));
+      completion->arrays.push_back(*std::move(array));
+      completion->reads.push_back(std::move(read));
+    }
+    auto& reads = completion->reads;
+    if (reads.empty()) return;
+    py::object future_like;
+    if (CallAndSetErrorIndicator([&] {
+          py::list python_domains, python_arrays, python_params;
+          for (size_t i = 0; i < reads.size(); ++i) {
+            python_domains.append(py::cast(domains[i]));
+            python_arrays.append(
+                GetNumpyArray(UnownedToShared(completion->arrays[i])));
+            python_params.append(py::cast(reads[i].params));
+          }
+          future_like =
+              py::reinterpret_steal<py::object>(PyObject_CallFunctionObjArgs(
+                  py::reinterpret_borrow<py::object>(
+                      state->python_function.get_value_or_throw())
+                      .ptr(),
+                  python_domains.ptr(), python_arrays.ptr(),
+                  python_params.ptr(), nullptr));
+          *completion->python_arrays = std::move(python_arrays);
+        })) {
+      auto status = GetStatusFromPythonException();
+      for (auto& read : reads) read.promise.SetResult(status);
+      return;
+    }
+    completion->copy_back = !internal_python::CanDataTypeShareMemoryWithNumpy(
+        completion->arrays[0].dtype());
+    auto executor = reads[0].params.executor();
+    internal_python::ConvertToFuture<BatchReadStamps>(
+        future_like, state->loop.obj.get_value_or_none())
+        .ExecuteWhenReady([executor = std::move(executor),
+                           completion = std::move(completion)](
+                              ReadyFuture<BatchReadStamps> future) mutable {
+          // Copying back from the NumPy arrays requires the GIL, and is done
+          // using the executor of the reads.
+          executor([completion = std::move(completion),
+                    future = std::move(future)] {
+            completion->Complete(future.result());
+          });
+        });
+  }
+};
+
 void RegisterVirtualChunkedBindings(pybind11::module m, Executor defer) {
   defer([cls = MakeVirtualChunkedReadParametersClass(m)]() mutable {
     DefineVirtualChunkedReadParametersAttributes(cls);
@@ -387,6 +569,28 @@ Args:
     :py:param:`.read_function` or :py:param:`.write_function` to return a
     coroutine.
 
+  batch_read_function: Alternative to :py:param:`.read_function` that
+    computes the content of multiple chunks in a single call, in order to
+    amortize the cost of acquiring the GIL and allow vectorized NumPy
+    computations.  Called with a list of domains, a list of arrays, and a list
+    of read parameters, one for each chunk.
+
+    Returns either :py:obj:`None`, indicating that the content of every chunk
+    may be cached indefinitely, or a list with one
+    :py:obj:`~tensorstore.KvStore.TimestampedStorageGeneration` (or
+    :py:obj:`None`) for each chunk.  May also return a
+    :ref:`coroutine<python:async>`.
+
+    Chunks requested while a previous call is in progress, for example by the
+    threads of the :json:schema:`Context.data_copy_concurrency` executor,
+    are passed together to the next call.  If the function releases the GIL,
+    e.g. by performing NumPy computations on large arrays, calls for
+    successive batches may run concurrently.
+
+  cache_key: Identifies the computed content in order to share cached chunks
+    with other virtual views, as described under :ref:`Caching
+    <virtual-chunked-caching>`.
+
 )";
           AppendKeywordArgumentDocs(doc, param_def...);
           doc += R"(
@@ -406,6 +610,8 @@ Warning:
 Group:
   Virtual views
 
+.. _virtual-chunked-caching:
+
 Caching
 -------
 
@@ -430,6 +636,14 @@ recomputed on every read.  To enable caching:
   :py:obj:`~tensorstore.KvStore.TimestampedStorageGeneration.generation` left
   unspecified.
 
+Each virtual view normally has its own cache, even if it is obtained by
+unpickling the same view.  Views created with the same
+:py:param:`.cache_key`, data type, domain and chunk layout, and that use the
+same cache pool, share cached chunks, and concurrent reads of the same chunk
+through any of them result in a single call to the read function.  The read
+and write functions of such views must be interchangeable; those of the first
+view created are used for all of them.
+
 Pickle support
 --------------
 
@@ -490,6 +704,11 @@ different than binding the transaction to an existing virtual chunked view.
                        IndexDomain<>, SharedArray<void>,
                        virtual_chunked::ReadParameters>;
 
+          using VirtualChunkedBatchReadFunction = Callable<
+              FutureLike<BatchReadStamps>, std::vector<IndexDomain<>>,
+              std::vector<SharedArray<void>>,
+              std::vector<virtual_chunked::ReadParameters>>;
+
           using VirtualChunkedWriteFunction =
               Callable<FutureLike<std::optional<TimestampedStorageGeneration>>,
                        IndexDomain<>, SharedArray<const void>,
@@ -500,11 +719,15 @@ different than binding the transaction to an existing virtual chunked view.
               [](std::optional<VirtualChunkedReadFunction> read_function,
                  std::optional<VirtualChunkedWriteFunction> write_function,
                  std::optional<AbstractEventLoopParameter> loop,
+                 std::optional<VirtualChunkedBatchReadFunction>
+                     batch_read_function,
+                 std::optional<std::string> cache_key,
                  KeywordArgument<decltype(param_def)>... kwarg)
                   -> PythonTensorStore {
                 virtual_chunked::OpenOptions options;
                 ApplyKeywordArguments<decltype(param_def)...>(options,
                                                               kwarg...);
+                if (cache_key) options.cache_key = *std::move(cache_key);
                 if (!loop) {
                   loop.emplace().value =
                       internal_python::GetCurrentThreadAsyncioEventLoop();
@@ -517,6 +740,15 @@ different than binding the transaction to an existing virtual chunked view.
                   read_function_adapter.state->loop.obj = loop->value;
                   return read_function_adapter;
                 };
+                const auto get_batch_read_function = [&] {
+                  BatchReadFunctionAdapter read_function_adapter;
+                  read_function_adapter.orig_domain = options.domain();
+                  read_function_adapter.state->python_function =
+                      py::reinterpret_borrow<py::object>(
+                          batch_read_function->value);
+                  read_function_adapter.state->loop.obj = loop->value;
+                  return read_function_adapter;
+                };
                 const auto get_write_function = [&] {
                   WriteFunctionAdapter write_function_adapter;
                   write_function_adapter.orig_domain = options.domain();
@@ -525,6 +757,20 @@ different than binding the transaction to an existing virtual chunked view.
                   write_function_adapter.state->loop.obj = loop->value;
                   return write_function_adapter;
                 };
+                if (batch_read_function) {
+                  if (read_function) {
+                    throw py::value_error(
+                        "Cannot specify both `read_function` and "
+                        "`batch_read_function`");
+                  }
+                  if (write_function) {
+                    return TensorStore<>(ValueOrThrow(VirtualChunked(
+                        get_batch_read_function(), get_write_function(),
+                        std::move(options))));
+                  }
+                  return TensorStore<>(ValueOrThrow(VirtualChunked(
+                      get_batch_read_function(), std::move(options))));
+                }
                 if (read_function && !write_function) {
                   return TensorStore<>(ValueOrThrow(
                       VirtualChunked(get_read_function(), std::move(options))));
@@ -545,6 +791,8 @@ different than binding the transaction to an existing virtual chunked view.
               doc.c_str(), py::arg("read_function") = std::nullopt,
               py::arg("write_function") = std::nullopt, py::kw_only(),
               py::arg("loop") = std::nullopt,
+              py::arg("batch_read_function") = std::nullopt,
+              py::arg("cache_key") = std::nullopt,
               MakeKeywordArgumentPyArg(param_def)...);
         });
   });
@@ -0,0 +1,296 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/append.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/write.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/progress.h"
+#include "tensorstore/resize_options.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_append {
+
+struct AppendState : public internal::AtomicReferenceCount<AppendState> {
+  TensorStore<> store;
+  DimensionIndex dimension;
+  AppendOptions options;
+
+  mutable absl::Mutex mutex;
+
+  /// Inclusive lower bound of the first reservation.
+  Index start;
+
+  /// Exclusive upper bound of the reserved intervals.
+  Index reserved_extent ABSL_GUARDED_BY(mutex);
+
+  /// Exclusive upper bound up to which all reserved intervals have been
+  /// written.
+  Index written_extent ABSL_GUARDED_BY(mutex);
+
+  /// Intervals beyond `written_extent` that have been written, keyed by their
+  /// inclusive lower bound.
+  absl::btree_map<Index, Index> written_intervals ABSL_GUARDED_BY(mutex);
+
+  /// Exclusive upper bound last committed to the metadata.
+  Index metadata_extent ABSL_GUARDED_BY(mutex);
+
+  /// Indicates that a metadata update is in progress.
+  bool resize_in_progress ABSL_GUARDED_BY(mutex) = false;
+
+  /// Pending `Flush` requests, each paired with the extent that must be
+  /// committed for it to complete.
+  std::vector<std::pair<Index, Promise<void>>> flush_promises
+      ABSL_GUARDED_BY(mutex);
+
+  /// Records that `interval` has been written, and returns the extent to
+  /// which the metadata should be resized, if any.
+  std::optional<Index> MarkWritten(IndexInterval interval) {
+    absl::MutexLock lock(&mutex);
+    written_intervals.emplace(interval.inclusive_min(),
+                              interval.exclusive_max());
+    for (auto it = written_intervals.begin();
+         it != written_intervals.end() && it->first == written_extent;
+         it = written_intervals.erase(it)) {
+      written_extent = it->second;
+    }
+    return StartResizeIfNeeded();
+  }
+
+  std::optional<Index> StartResizeIfNeeded()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (resize_in_progress || written_extent <= metadata_extent) {
+      return std::nullopt;
+    }
+    if (written_extent - metadata_extent < options.metadata_update_threshold &&
+        flush_promises.empty()) {
+      return std::nullopt;
+    }
+    resize_in_progress = true;
+    return written_extent;
+  }
+
+  /// Resizes the metadata to `new_extent`, and then to the written extent
+  /// reached in the meantime, until no update is needed.
+  void Resize(std::optional<Index> new_extent) {
+    if (!new_extent) return;
+    const DimensionIndex rank = store.rank();
+    std::vector<Index> inclusive_min(rank, kImplicit);
+    std::vector<Index> exclusive_max(rank, kImplicit);
+    exclusive_max[dimension] = *new_extent;
+    auto future =
+        tensorstore::Resize(store, span<const Index>(inclusive_min),
+                            span<const Index>(exclusive_max), expand_only);
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<AppendState>(this),
+         new_extent = *new_extent](ReadyFuture<TensorStore<>> future) {
+          self->Resize(self->ResizeDone(new_extent, future.status()));
+        });
+  }
+
+  std::optional<Index> ResizeDone(Index new_extent, absl::Status status) {
+    std::vector<Promise<void>> done;
+    std::optional<Index> next_extent;
+    {
+      absl::MutexLock lock(&mutex);
+      resize_in_progress = false;
+      if (status.ok()) metadata_extent = new_extent;
+      auto& promises = flush_promises;
+      for (size_t i = 0; i < promises.size();) {
+        if (!status.ok() || promises[i].first <= metadata_extent) {
+          done.push_back(std::move(promises[i].second));
+          promises[i] = std::move(promises.back());
+          promises.pop_back();
+        } else {
+          ++i;
+        }
+      }
+      // After a failure, further updates are only attempted upon a subsequent
+      // append or `Flush`.
+      if (status.ok()) next_extent = StartResizeIfNeeded();
+    }
+    for (auto& promise : done) promise.SetResult(status);
+    return next_extent;
+  }
+};
+
+void intrusive_ptr_increment(AppendState* p) {
+  intrusive_ptr_increment(
+      static_cast<internal::AtomicReferenceCount<AppendState>*>(p));
+}
+
+void intrusive_ptr_decrement(AppendState* p) {
+  intrusive_ptr_decrement(
+      static_cast<internal::AtomicReferenceCount<AppendState>*>(p));
+}
+
+}  // namespace internal_append
+
+using internal_append::AppendState;
+
+Result<Appender> Appender::Make(TensorStore<> store,
+                                DimensionIndex append_dimension,
+                                AppendOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsWrite(store.read_write_mode()));
+  if (store.transaction() != no_transaction) {
+    return absl::InvalidArgumentError(
+        "Appending within a transaction is not supported");
+  }
+  if (append_dimension < 0 || append_dimension >= store.rank()) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Append dimension ", append_dimension,
+                            " is not valid for rank ", store.rank()));
+  }
+  const auto interval = store.domain()[append_dimension];
+  if (!interval.implicit_upper() ||
+      interval.exclusive_max() == kInfIndex + 1) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Append dimension ", append_dimension,
+        " does not have a resizable upper bound: ", interval));
+  }
+  internal::IntrusivePtr<AppendState> state(new AppendState);
+  state->dimension = append_dimension;
+  state->options = options;
+  state->start = interval.exclusive_max();
+  state->reserved_extent = state->start;
+  state->written_extent = state->start;
+  state->metadata_extent = state->start;
+  state->store = std::move(store);
+  return Appender(std::move(state));
+}
+
+DimensionIndex Appender::append_dimension() const { return state_->dimension; }
+
+Result<IndexInterval> Appender::Reserve(Index count) {
+  if (count < 0) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Invalid append count: ", count));
+  }
+  absl::MutexLock lock(&state_->mutex);
+  const Index start = state_->reserved_extent;
+  if (count > kMaxFiniteIndex - start) {
+    return absl::OutOfRangeError(tensorstore::StrCat(
+        "Appending ", count, " positions at ", start,
+        " would exceed the maximum index"));
+  }
+  state_->reserved_extent = start + count;
+  return IndexInterval::UncheckedHalfOpen(start, start + count);
+}
+
+WriteFutures Appender::Write(IndexInterval reserved,
+                             SharedOffsetArrayView<const void> source) {
+  {
+    absl::MutexLock lock(&state_->mutex);
+    if (reserved.inclusive_min() < state_->start ||
+        reserved.exclusive_max() > state_->reserved_extent) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Interval ", reserved, " has not been reserved"));
+    }
+  }
+  internal::DriverHandle handle =
+      internal::TensorStoreAccess::handle(state_->store);
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      handle.transform,
+      std::move(handle.transform) |
+          Dims(state_->dimension)
+              .HalfOpenInterval(reserved.inclusive_min(),
+                                reserved.exclusive_max()));
+  internal::DriverWriteOptions options;
+  // The chunks are written before the metadata is resized to include them.
+  options.resolve_bounds_mode = {};
+  auto executor = handle.driver->data_copy_executor();
+  auto futures = internal::DriverWrite(std::move(executor), std::move(source),
+                                       std::move(handle), std::move(options));
+  // The interval is recorded as written even if the write fails, since
+  // otherwise the metadata could never grow past it; as for any failed
+  // write, the interval may be left partially written.
+  futures.commit_future = MapFuture(
+      InlineExecutor{},
+      [state = state_, reserved](const Result<void>& result) -> Result<void> {
+        state->Resize(state->MarkWritten(reserved));
+        return result;
+      },
+      std::move(futures.commit_future));
+  return futures;
+}
+
+WriteFutures Appender::Append(SharedOffsetArrayView<const void> source) {
+  if (source.rank() != state_->store.rank()) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Cannot append array of rank ", source.rank(),
+                            " to TensorStore of rank ", state_->store.rank()));
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto reserved,
+                               Reserve(source.shape()[state_->dimension]));
+  return Write(reserved, std::move(source));
+}
+
+Future<const void> Appender::Flush() {
+  std::optional<Index> new_extent;
+  Future<const void> future;
+  {
+    absl::MutexLock lock(&state_->mutex);
+    const Index target = state_->written_extent;
+    if (target <= state_->metadata_extent) return MakeReadyFuture();
+    auto pair = PromiseFuturePair<void>::Make(MakeResult());
+    state_->flush_promises.emplace_back(target, std::move(pair.promise));
+    future = std::move(pair.future);
+    new_extent = state_->StartResizeIfNeeded();
+  }
+  state_->Resize(new_extent);
+  return future;
+}
+
+Index Appender::reserved_extent() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->reserved_extent;
+}
+
+Index Appender::written_extent() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->written_extent;
+}
+
+Index Appender::metadata_extent() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->metadata_extent;
+}
+
+const TensorStore<>& Appender::store() const { return state_->store; }
+
+}  // namespace tensorstore
@@ -0,0 +1,178 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_APPEND_H_
+#define TENSORSTORE_APPEND_H_
+
+/// \file
+///
+/// Appending along a growing dimension of a `TensorStore`.
+///
+/// Appending by calling `Resize` followed by `Write` serializes every append
+/// on a read-modify-write of the metadata.  An `Appender` instead reserves
+/// index ranges in memory, writes the chunks of each append directly beyond
+/// the current (implicit) upper bound, and grows the metadata lazily, with a
+/// single resize covering all appends completed since the previous one.
+
+#include <utility>
+
+#include "tensorstore/array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/progress.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+
+/// Options for `Appender::Make`.
+///
+/// \relates Appender
+struct AppendOptions {
+  /// Minimum growth, in number of positions along the append dimension, of
+  /// the written extent beyond the metadata extent that triggers a metadata
+  /// update.  With the default of `0`, a metadata update is started whenever
+  /// the written extent grows and no other update is in progress, so that
+  /// concurrent appends are coalesced into a single update.  Growth below the
+  /// threshold is committed by `Appender::Flush`.
+  Index metadata_update_threshold = 0;
+};
+
+namespace internal_append {
+struct AppendState;
+void intrusive_ptr_increment(AppendState* p);
+void intrusive_ptr_decrement(AppendState* p);
+}  // namespace internal_append
+
+/// Appends to a `TensorStore` along a single resizable dimension.
+///
+/// Appends proceed in three steps:
+///
+/// 1. `Reserve` atomically reserves the next interval of the append
+///    dimension, without any I/O.
+///
+/// 2. `Write` writes the data for a reserved interval.  The chunks are
+///    written beyond the upper bound recorded in the metadata, and so are not
+///    yet visible to readers.
+///
+/// 3. Once all intervals up to some position have been written, the metadata
+///    is resized to that position.  Metadata updates are batched: at most one
+///    is in progress at a time, and each covers all appends completed since
+///    the previous one.
+///
+/// Readers observe the extent recorded in the metadata, which therefore
+/// never includes an interval that has not been completely written (or whose
+/// write failed, in which case it may be partially written as for a failed
+/// `tensorstore::Write`).
+///
+/// All appenders to a given array must share a single `Appender` (copies
+/// refer to the same state); independent appenders, e.g. in other processes,
+/// would reserve overlapping intervals.  Every reserved interval must be
+/// passed to `Write`, since the metadata extent cannot grow past an interval
+/// that is never written.
+///
+/// Example::
+///
+///     TENSORSTORE_ASSIGN_OR_RETURN(
+///         auto appender, Appender::Make(store, /*append_dimension=*/0));
+///     TENSORSTORE_RETURN_IF_ERROR(
+///         appender.Append(frame).commit_future.result());
+///     TENSORSTORE_RETURN_IF_ERROR(appender.Flush().result());
+///
+/// \threadsafety Thread safe.
+/// \ingroup core
+class Appender {
+ public:
+  /// Constructs a null appender.
+  Appender() = default;
+
+  /// Returns an appender to `store` along `append_dimension`.
+  ///
+  /// Appending starts at the current upper bound of `append_dimension`
+  /// within the domain of `store`.  Non-contiguous appends are not
+  /// supported; the caller must not otherwise resize `store` concurrently.
+  ///
+  /// \error `absl::StatusCode::kInvalidArgument` if `append_dimension` is not
+  ///     a valid dimension of `store`, or its upper bound is not implicit.
+  /// \error `absl::StatusCode::kInvalidArgument` if `store` does not support
+  ///     writing or is bound to a transaction.
+  static Result<Appender> Make(TensorStore<> store,
+                               DimensionIndex append_dimension,
+                               AppendOptions options = {});
+
+  /// Returns the dimension along which data is appended.
+  DimensionIndex append_dimension() const;
+
+  /// Atomically reserves the next `count` positions along the append
+  /// dimension.
+  ///
+  /// \error `absl::StatusCode::kInvalidArgument` if `count` is negative.
+  /// \error `absl::StatusCode::kOutOfRange` if the reservation would exceed
+  ///     `kMaxFiniteIndex`.
+  Result<IndexInterval> Reserve(Index count);
+
+  /// Writes `source` to the previously-reserved interval `reserved`.
+  ///
+  /// The domain of `source` is aligned to the domain of the store with the
+  /// append dimension restricted to `reserved`, as for `tensorstore::Write`.
+  ///
+  /// The returned `commit_future` becomes ready once the chunks have been
+  /// written; the metadata may not yet reflect the new extent.
+  ///
+  /// \error `absl::StatusCode::kInvalidArgument` if `reserved` was not
+  ///     returned by `Reserve`.
+  WriteFutures Write(IndexInterval reserved,
+                     SharedOffsetArrayView<const void> source);
+
+  /// Reserves an interval of size `source.shape()[append_dimension()]` and
+  /// writes `source` to it.
+  WriteFutures Append(SharedOffsetArrayView<const void> source);
+
+  /// Commits the extent of all appends whose `commit_future` has already
+  /// completed to the metadata.
+  ///
+  /// The returned future becomes ready once the metadata extent covers those
+  /// appends, or with an error if the metadata update fails.
+  Future<const void> Flush();
+
+  /// Returns the exclusive upper bound of the reserved intervals.
+  Index reserved_extent() const;
+
+  /// Returns the exclusive upper bound up to which all reserved intervals
+  /// have been written.
+  Index written_extent() const;
+
+  /// Returns the exclusive upper bound last committed to the metadata.
+  Index metadata_extent() const;
+
+  /// Returns the underlying store.
+  ///
+  /// Its domain reflects the metadata as of `Make`; re-resolve its bounds
+  /// with `ResolveBounds` to observe the appended data.
+  const TensorStore<>& store() const;
+
+  bool valid() const { return static_cast<bool>(state_); }
+
+ private:
+  explicit Appender(internal::IntrusivePtr<internal_append::AppendState> state)
+      : state_(std::move(state)) {}
+
+  internal::IntrusivePtr<internal_append::AppendState> state_;
+};
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_APPEND_H_
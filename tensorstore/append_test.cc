@@ -0,0 +1,173 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/append.h"
+
+#include <stdint.h>
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Appender;
+using ::tensorstore::AppendOptions;
+using ::tensorstore::Index;
+using ::tensorstore::IndexInterval;
+using ::tensorstore::MatchesStatus;
+
+tensorstore::TensorStore<int32_t, 2> OpenStore(
+    const tensorstore::Context& context,
+    tensorstore::OpenMode mode = tensorstore::OpenMode::create) {
+  return tensorstore::Open<int32_t, 2>(
+             {{"driver", "zarr"},
+              {"kvstore", {{"driver", "memory"}}},
+              {"metadata",
+               {{"dtype", "<i4"}, {"shape", {0, 4}}, {"chunks", {2, 4}}}}},
+             context, mode)
+      .value();
+}
+
+Index ResolvedExtent(const tensorstore::TensorStore<int32_t, 2>& store) {
+  return tensorstore::ResolveBounds(store).value().domain()[0].exclusive_max();
+}
+
+TEST(AppenderTest, InvalidArguments) {
+  auto context = tensorstore::Context::Default();
+  auto store = OpenStore(context);
+  EXPECT_THAT(Appender::Make(store, 2),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Append dimension 2 is not valid for rank 2"));
+  EXPECT_THAT(
+      Appender::Make(store, 1),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Append dimension 1 does not have a resizable .*"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto sliced, store | tensorstore::Dims(0).SizedInterval(0, 0));
+  EXPECT_THAT(Appender::Make(sliced, 0),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto appender, Appender::Make(store, 0));
+  EXPECT_THAT(appender.Reserve(-1),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(appender.Write(IndexInterval::UncheckedSized(0, 1),
+                             tensorstore::MakeArray<int32_t>({{1, 2, 3, 4}}))
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Interval \\[0, 1\\) has not been reserved"));
+}
+
+TEST(AppenderTest, WritesChunksBeforeMetadata) {
+  auto context = tensorstore::Context::Default();
+  auto store = OpenStore(context);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto appender,
+      Appender::Make(store, 0,
+                     AppendOptions{/*.metadata_update_threshold=*/100}));
+  TENSORSTORE_ASSERT_OK(
+      appender.Append(tensorstore::MakeArray<int32_t>({{1, 2, 3, 4}}))
+          .commit_future.result());
+  TENSORSTORE_ASSERT_OK(
+      appender
+          .Append(tensorstore::MakeArray<int32_t>(
+              {{5, 6, 7, 8}, {9, 10, 11, 12}}))
+          .commit_future.result());
+  EXPECT_EQ(3, appender.reserved_extent());
+  EXPECT_EQ(3, appender.written_extent());
+  // The metadata update threshold has not been reached.
+  EXPECT_EQ(0, appender.metadata_extent());
+  EXPECT_EQ(0, ResolvedExtent(OpenStore(context, tensorstore::OpenMode::open)));
+
+  TENSORSTORE_ASSERT_OK(appender.Flush().result());
+  EXPECT_EQ(3, appender.metadata_extent());
+  auto reopened = OpenStore(context, tensorstore::OpenMode::open);
+  EXPECT_EQ(3, ResolvedExtent(reopened));
+  EXPECT_THAT(tensorstore::Read(reopened).result(),
+              ::testing::Optional(tensorstore::MakeArray<int32_t>(
+                  {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}})));
+}
+
+TEST(AppenderTest, OutOfOrderCompletion) {
+  auto context = tensorstore::Context::Default();
+  auto store = OpenStore(context);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto appender, Appender::Make(store, 0));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto first, appender.Reserve(1));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto second, appender.Reserve(2));
+  EXPECT_EQ(IndexInterval::UncheckedSized(0, 1), first);
+  EXPECT_EQ(IndexInterval::UncheckedSized(1, 2), second);
+
+  TENSORSTORE_ASSERT_OK(
+      appender
+          .Write(second, tensorstore::MakeArray<int32_t>(
+                             {{5, 6, 7, 8}, {9, 10, 11, 12}}))
+          .commit_future.result());
+  // The first interval has not been written, so the metadata cannot grow.
+  EXPECT_EQ(0, appender.written_extent());
+  TENSORSTORE_ASSERT_OK(appender.Flush().result());
+  EXPECT_EQ(0, appender.metadata_extent());
+
+  TENSORSTORE_ASSERT_OK(
+      appender.Write(first, tensorstore::MakeArray<int32_t>({{1, 2, 3, 4}}))
+          .commit_future.result());
+  EXPECT_EQ(3, appender.written_extent());
+  TENSORSTORE_ASSERT_OK(appender.Flush().result());
+  EXPECT_EQ(3, ResolvedExtent(OpenStore(context, tensorstore::OpenMode::open)));
+}
+
+TEST(AppenderTest, ConcurrentAppends) {
+  auto context = tensorstore::Context::Default();
+  auto store = OpenStore(context);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto appender, Appender::Make(store, 0));
+  constexpr int kNumThreads = 4;
+  constexpr int kAppendsPerThread = 10;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&appender] {
+      for (int i = 0; i < kAppendsPerThread; ++i) {
+        auto row = tensorstore::AllocateArray<int32_t>({1, 4});
+        TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto reserved, appender.Reserve(1));
+        for (Index j = 0; j < 4; ++j) {
+          row(0, j) = static_cast<int32_t>(reserved.inclusive_min());
+        }
+        TENSORSTORE_EXPECT_OK(appender.Write(reserved, row).result());
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  TENSORSTORE_ASSERT_OK(appender.Flush().result());
+  constexpr Index kTotal = kNumThreads * kAppendsPerThread;
+  EXPECT_EQ(kTotal, appender.metadata_extent());
+  auto reopened = OpenStore(context, tensorstore::OpenMode::open);
+  EXPECT_EQ(kTotal, ResolvedExtent(reopened));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto data,
+                                   tensorstore::Read(reopened).result());
+  for (Index i = 0; i < kTotal; ++i) {
+    EXPECT_EQ(i, data(i, 3)) << i;
+  }
+}
+
+}  // namespace
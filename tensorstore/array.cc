@@ -19,12 +19,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "riegeli/varint/varint_reading.h"
 #include "riegeli/varint/varint_writing.h"
 #include "tensorstore/box.h"
@@ -34,6 +38,7 @@
 #include "tensorstore/index.h"
 #include "tensorstore/internal/element_copy_function.h"
 #include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/transpose_copy.h"
 #include "tensorstore/internal/unaligned_data_type_functions.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/serialization/serialization.h"
@@ -94,10 +99,28 @@ bool CompareArraysEqual(
   return CompareArraysEqualImpl<offset_origin>(a, b, comparison_kind);
 }
 
+namespace {
+// Copies `source` to `dest` using a cache-blocked traversal if they have the
+// same trivial data type and are transposed relative to each other.
+bool TryCopyTransposedArray(
+    const ArrayView<const void, dynamic_rank, offset_origin>& source,
+    const ArrayView<void, dynamic_rank, offset_origin>& dest) {
+  return source.dtype() == dest.dtype() &&
+         internal::IsTrivialDataType(source.dtype()) &&
+         std::equal(source.shape().begin(), source.shape().end(),
+                    dest.shape().begin(), dest.shape().end()) &&
+         internal::TryCopyTransposed(
+             source.dtype().size(), source.shape(),
+             source.byte_strided_origin_pointer().get(), source.byte_strides(),
+             dest.byte_strided_origin_pointer().get(), dest.byte_strides());
+}
+}  // namespace
+
 void CopyArrayImplementation(
     const ArrayView<const void, dynamic_rank, offset_origin>& source,
     const ArrayView<void, dynamic_rank, offset_origin>& dest) {
   ABSL_CHECK_EQ(source.dtype(), dest.dtype());
+  if (TryCopyTransposedArray(source, dest)) return;
   internal::IterateOverArrays({&source.dtype()->copy_assign, nullptr},
                               /*arg=*/nullptr,
                               /*constraints=*/skip_repeated_elements, source,
@@ -107,6 +130,7 @@ void CopyArrayImplementation(
 absl::Status CopyConvertedArrayImplementation(
     const ArrayView<const void, dynamic_rank, offset_origin>& source,
     const ArrayView<void, dynamic_rank, offset_origin>& dest) {
+  if (TryCopyTransposedArray(source, dest)) return absl::OkStatus();
   TENSORSTORE_ASSIGN_OR_RETURN(auto r, internal::GetDataTypeConverterOrError(
                                            source.dtype(), dest.dtype()));
   absl::Status status;
@@ -350,9 +374,46 @@ SharedArray<const void> UnbroadcastArray(
 
 namespace internal_array {
 
-bool EncodeArray(serialization::EncodeSink& sink,
-                 OffsetArrayView<const void> array,
-                 ArrayOriginKind origin_kind) {
+namespace {
+
+/// Minimum size of encoded array elements for which `EncodeSharedArray` and
+/// `DecodeArray` share the encoded data rather than copying it.
+constexpr Index kMinSharedElementBytes = 4096;
+
+/// Returns `true` if the encoded representation of elements of `dtype` is
+/// simply their in-memory representation, such that the encoded data may be
+/// shared.
+bool CanShareEncodedElements(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::custom:
+    case DataTypeId::bool_t:
+    case DataTypeId::int4_t:
+    case DataTypeId::string_t:
+    case DataTypeId::ustring_t:
+    case DataTypeId::json_t:
+      return false;
+    default:
+      return true;
+  }
+}
+
+/// Returns the size in bytes of the encoded elements of `array`, if the
+/// elements are stored contiguously in the encoded order, or `-1` otherwise.
+Index GetContiguousEncodedElementBytes(OffsetArrayView<const void> array) {
+  Index num_bytes = array.dtype().size();
+  for (DimensionIndex i = array.rank() - 1; i >= 0; --i) {
+    const Index size = array.shape()[i];
+    if (size == 0) return 0;
+    if (size == 1 || array.byte_strides()[i] == 0) continue;
+    if (array.byte_strides()[i] != num_bytes) return -1;
+    num_bytes *= size;
+  }
+  return num_bytes;
+}
+
+bool EncodeArrayHeader(serialization::EncodeSink& sink,
+                       OffsetArrayView<const void> array,
+                       ArrayOriginKind origin_kind) {
   if (!array.dtype().valid()) {
     sink.Fail(absl::InvalidArgumentError(
         "Cannot serialize array with unspecified data type"));
@@ -371,9 +432,15 @@ bool EncodeArray(serialization::EncodeSink& sink,
     zero_byte_strides[i] =
         (array.byte_strides()[i] == 0 && array.shape()[i] != 1);
   }
-  if (!riegeli::WriteVarint32(zero_byte_strides.to_uint(), sink.writer()))
-    return false;
+  return riegeli::WriteVarint32(zero_byte_strides.to_uint(), sink.writer());
+}
+
+}  // namespace
 
+bool EncodeArray(serialization::EncodeSink& sink,
+                 OffsetArrayView<const void> array,
+                 ArrayOriginKind origin_kind) {
+  if (!EncodeArrayHeader(sink, array, origin_kind)) return false;
   return internal::IterateOverArrays(
       {&internal::kUnalignedDataTypeFunctions[static_cast<size_t>(
                                                   array.dtype().id())]
@@ -382,11 +449,31 @@ bool EncodeArray(serialization::EncodeSink& sink,
       /*arg=*/nullptr, {c_order, skip_repeated_elements}, array);
 }
 
+bool EncodeSharedArray(serialization::EncodeSink& sink,
+                       SharedOffsetArrayView<const void> array,
+                       ArrayOriginKind origin_kind) {
+  const Index num_bytes = CanShareEncodedElements(array.dtype())
+                              ? GetContiguousEncodedElementBytes(array)
+                              : -1;
+  if (num_bytes < kMinSharedElementBytes) {
+    return EncodeArray(sink, array, origin_kind);
+  }
+  if (!EncodeArrayHeader(sink, array, origin_kind)) return false;
+  // The elements are written as an external `absl::Cord` that references
+  // `array`, which `riegeli::CordWriter` appends without copying.
+  return sink.writer().Write(absl::MakeCordFromExternal(
+      std::string_view(static_cast<const char*>(static_cast<const void*>(
+                           array.byte_strided_origin_pointer().get())),
+                       num_bytes),
+      [pointer = array.pointer()] {}));
+}
+
 template <ArrayOriginKind OriginKind>
 bool DecodeArray<OriginKind>::Decode(
     serialization::DecodeSource& source,
     SharedArray<void, dynamic_rank, OriginKind>& array,
-    DataType data_type_constraint, DimensionIndex rank_constraint) {
+    DataType data_type_constraint, DimensionIndex rank_constraint,
+    bool share_encoded_elements) {
   DataType dtype;
   if (!serialization::Decode(source, dtype)) return false;
   if (!dtype.valid()) {
@@ -429,6 +516,41 @@ bool DecodeArray<OriginKind>::Decode(
       }
     }
   }
+  if (share_encoded_elements && CanShareEncodedElements(dtype) &&
+      num_bytes >= kMinSharedElementBytes) {
+    // Read the elements as an `absl::Cord`, which shares the underlying data
+    // if supported by `source.reader()` (e.g. `riegeli::CordReader`), and use
+    // it directly as the array data if it is flat and suitably aligned.
+    auto cord = std::make_shared<absl::Cord>();
+    if (!source.reader().Read(num_bytes, *cord)) return false;
+    std::shared_ptr<char> data;
+    if (auto flat = cord->TryFlat();
+        flat && reinterpret_cast<uintptr_t>(flat->data()) % dtype.alignment() ==
+                    0) {
+      data = std::shared_ptr<char>(std::move(cord),
+                                   const_cast<char*>(flat->data()));
+    } else {
+      data = std::static_pointer_cast<char>(
+          internal::AllocateAndConstructSharedElements(
+              num_bytes / dtype.size(), default_init, dtype)
+              .pointer());
+      char* out = data.get();
+      for (std::string_view chunk : cord->Chunks()) {
+        std::memcpy(out, chunk.data(), chunk.size());
+        out += chunk.size();
+      }
+    }
+    Index byte_stride = dtype.size();
+    for (DimensionIndex i = rank - 1; i >= 0; --i) {
+      if (zero_byte_strides[i]) continue;
+      array.byte_strides()[i] = byte_stride;
+      byte_stride *= array.shape()[i];
+    }
+    char* origin = data.get() - array.layout().origin_byte_offset();
+    array.element_pointer() = SharedElementPointer<void>(
+        std::shared_ptr<void>(std::move(data), origin), dtype);
+    return true;
+  }
   array.element_pointer() = tensorstore::AllocateArrayElementsLike<void>(
       array.layout(), array.byte_strides().data(),
       {c_order, skip_repeated_elements}, default_init, dtype);
@@ -2109,6 +2109,15 @@ namespace internal_array {
                                OffsetArrayView<const void> array,
                                ArrayOriginKind origin_kind);
 
+/// Same as `EncodeArray`, but for large arrays with contiguous elements, the
+/// encoded elements reference the data of `array` rather than a copy, if
+/// supported by `sink.writer()` (e.g. `riegeli::CordWriter`).
+///
+/// The encoded representation is identical to that of `EncodeArray`.
+[[nodiscard]] bool EncodeSharedArray(serialization::EncodeSink& sink,
+                                     SharedOffsetArrayView<const void> array,
+                                     ArrayOriginKind origin_kind);
+
 /// Decodes an array from `source`.
 ///
 /// \tparam OriginKind Origin kind, must match `origin_kind` passed to
@@ -2119,12 +2128,17 @@ namespace internal_array {
 ///     fail if the data type does not match.
 /// \param rank_constraint If a value other than `dynamic_rank` is specified ,
 ///     decoding will fail if the rank does not match.
+/// \param share_encoded_elements If `true`, the decoded array may reference
+///     the encoded data directly rather than a copy, if supported by
+///     `source.reader()` (e.g. `riegeli::CordReader`).  The decoded array must
+///     then not be modified.
 template <ArrayOriginKind OriginKind>
 struct DecodeArray {
   [[nodiscard]] static bool Decode(
       serialization::DecodeSource& source,
       SharedArray<void, dynamic_rank, OriginKind>& array,
-      DataType data_type_constraint, DimensionIndex rank_constraint);
+      DataType data_type_constraint, DimensionIndex rank_constraint,
+      bool share_encoded_elements = false);
 };
 
 extern template struct DecodeArray<zero_origin>;
@@ -2138,7 +2152,13 @@ struct Serializer<Array<Shared<Element>, Rank, OriginKind, container>> {
   [[nodiscard]] static bool Encode(
       EncodeSink& sink,
       const Array<Shared<Element>, Rank, OriginKind, container>& value) {
-    return internal_array::EncodeArray(sink, value, OriginKind);
+    // Arrays of const elements are never modified through `value`, and
+    // therefore the encoded and decoded arrays may share data.
+    if constexpr (std::is_const_v<Element>) {
+      return internal_array::EncodeSharedArray(sink, value, OriginKind);
+    } else {
+      return internal_array::EncodeArray(sink, value, OriginKind);
+    }
   }
   [[nodiscard]] static bool Decode(
       DecodeSource& source,
@@ -2146,7 +2166,8 @@ struct Serializer<Array<Shared<Element>, Rank, OriginKind, container>> {
     SharedArray<void, dynamic_rank, OriginKind> array;
     if (!internal_array::DecodeArray<OriginKind>::Decode(
             source, array, dtype_v<Element>,
-            RankConstraint::FromInlineRank(Rank))) {
+            RankConstraint::FromInlineRank(Rank),
+            /*share_encoded_elements=*/std::is_const_v<Element>)) {
       return false;
     }
     value = tensorstore::StaticCast<SharedArray<Element, Rank, OriginKind>,
@@ -2160,7 +2181,11 @@ struct Serializer<Array<Shared<Element>, Rank, OriginKind, view>> {
   [[nodiscard]] static bool Encode(
       EncodeSink& sink,
       const Array<Shared<Element>, Rank, OriginKind, view>& value) {
-    return internal_array::EncodeArray(sink, value, OriginKind);
+    if constexpr (std::is_const_v<Element>) {
+      return internal_array::EncodeSharedArray(sink, value, OriginKind);
+    } else {
+      return internal_array::EncodeArray(sink, value, OriginKind);
+    }
   }
 };
 
@@ -112,7 +112,9 @@ using ::tensorstore::ValidateShapeBroadcast;
 using ::tensorstore::view;
 using ::tensorstore::zero_origin;
 using ::tensorstore::serialization::DecodeBatch;
+using ::tensorstore::serialization::DecodeBatchFromCord;
 using ::tensorstore::serialization::EncodeBatch;
+using ::tensorstore::serialization::EncodeBatchToCord;
 using ::tensorstore::serialization::SerializationRoundTrip;
 using ::tensorstore::serialization::TestSerializationRoundTrip;
 using ::testing::ElementsAre;
@@ -1941,6 +1943,51 @@ TEST(ArraySerializationTest, RankMismatch) {
                             "Expected rank of 2 but received: 1; .*"));
 }
 
+tensorstore::SharedOffsetArray<const int> MakeLargeArray() {
+  auto array = tensorstore::AllocateArray<int>(
+      BoxView<>({3, -4}, {64, 128}), c_order, tensorstore::default_init);
+  int value = 0;
+  tensorstore::IterateOverArrays([&](int* x) { *x = value++; }, c_order,
+                                 array);
+  return array;
+}
+
+// Tests that large arrays of const elements, which are encoded by reference,
+// have the same encoded representation as arrays of non-const elements.
+TEST(ArraySerializationTest, SharedEncodingMatches) {
+  auto array = MakeLargeArray();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded_shared, EncodeBatch(array));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded_copy,
+      EncodeBatch(tensorstore::ConstDataTypeCast<int>(array)));
+  EXPECT_EQ(encoded_shared, encoded_copy);
+  TestSerializationRoundTrip(array);
+}
+
+TEST(ArraySerializationTest, SharedEncodingCord) {
+  auto array = MakeLargeArray();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeBatchToCord(array));
+  tensorstore::SharedOffsetArray<const int> decoded;
+  TENSORSTORE_ASSERT_OK(DecodeBatchFromCord(encoded, decoded));
+  EXPECT_EQ(array, decoded);
+  EXPECT_EQ(array.domain(), decoded.domain());
+}
+
+TEST(ArraySerializationTest, SharedEncodingNonContiguous) {
+  auto array = MakeLargeArray();
+  tensorstore::SharedOffsetArray<const int> transposed(
+      array.element_pointer(),
+      StridedLayout<dynamic_rank, offset_origin>(
+          {-4, 3}, {128, 64}, {array.byte_strides()[1],
+                               array.byte_strides()[0]}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeBatchToCord(transposed));
+  tensorstore::SharedOffsetArray<const int> decoded;
+  TENSORSTORE_ASSERT_OK(DecodeBatchFromCord(encoded, decoded));
+  EXPECT_EQ(transposed, decoded);
+}
+
 class RandomDataSerializationTest
     : public ::testing::TestWithParam<tensorstore::DataType> {};
 
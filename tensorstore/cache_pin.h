@@ -0,0 +1,71 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_CACHE_PIN_H_
+#define TENSORSTORE_CACHE_PIN_H_
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "tensorstore/internal/cache/cache_pin.h"
+
+namespace tensorstore {
+
+/// Handle to cached data pinned by `tensorstore::Pin`.
+///
+/// While a pin is held, the pinned chunks are retained in memory and are not
+/// evicted, such that reads of the pinned region do not incur storage I/O
+/// (apart from revalidation, depending on the staleness bound).  Pinned data
+/// is accounted against `Context.cache_pool.pinned_bytes_limit` rather than
+/// `Context.cache_pool.total_bytes_limit`.
+///
+/// Copies of a `CachePin` refer to the same pinned chunks, which are unpinned
+/// once all copies are destroyed or `Unpin` is called on each of them.
+///
+/// Example::
+///
+///     TENSORSTORE_ASSIGN_OR_RETURN(
+///         auto pin,
+///         tensorstore::Pin(store | AllDims().SizedInterval({0, 0}, {64, 64}))
+///             .result());
+///     // ... latency-critical reads of the pinned region ...
+///     pin.Unpin();
+///
+/// \ingroup core
+class CachePin {
+ public:
+  /// Constructs a null pin, which pins nothing.
+  CachePin() = default;
+
+  /// Returns `true` if this is not a null pin.
+  explicit operator bool() const { return static_cast<bool>(pin_set_); }
+
+  /// Releases the reference of this handle to the pinned chunks.
+  void Unpin() { pin_set_.reset(); }
+
+  /// Returns the number of chunks pinned by this handle.
+  size_t num_chunks() const { return pin_set_ ? pin_set_->size() : 0; }
+
+  // Treat as private:
+  explicit CachePin(internal::CachePinSetPtr pin_set)
+      : pin_set_(std::move(pin_set)) {}
+
+ private:
+  internal::CachePinSetPtr pin_set_;
+};
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_CACHE_PIN_H_
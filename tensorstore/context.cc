@@ -26,6 +26,7 @@
 
 #include "absl/base/no_destructor.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -55,9 +56,39 @@
 namespace tensorstore {
 namespace internal_context {
 
+namespace {
+
+/// Registry of live resources created by decoded contexts for providers with
+/// `shared_when_decoded == true`, keyed by provider id and JSON spec.
+///
+/// Entries do not hold references; they are removed when the resource is
+/// destroyed.
+struct SharedDecodedResources {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, ResourceImplBase*> resources
+      ABSL_GUARDED_BY(mutex);
+};
+
+SharedDecodedResources& GetSharedDecodedResources() {
+  static absl::NoDestructor<SharedDecodedResources> registry;
+  return *registry;
+}
+
+}  // namespace
+
 ResourceProviderImplBase::~ResourceProviderImplBase() = default;
 ResourceOrSpecBase::~ResourceOrSpecBase() = default;
-ResourceImplBase::~ResourceImplBase() = default;
+ResourceImplBase::~ResourceImplBase() {
+  if (shared_decode_key_.empty()) return;
+  auto& registry = GetSharedDecodedResources();
+  absl::MutexLock lock(&registry.mutex);
+  // The entry may already have been replaced by a new resource if it was
+  // looked up after the reference count reached zero.
+  auto it = registry.resources.find(shared_decode_key_);
+  if (it != registry.resources.end() && it->second == this) {
+    registry.resources.erase(it);
+  }
+}
 ResourceSpecImplBase::~ResourceSpecImplBase() = default;
 
 ContextImplPtr GetCreator(ResourceImplBase& resource) {
@@ -225,6 +256,10 @@ void WaitForCompletion(absl::Mutex* mutex, ResourceContainer* container,
   }
 }
 
+Result<ResourceImplStrongPtr> CreateOrShareResource(
+    ContextImpl& context, ResourceSpecImplBase& spec,
+    const internal::ContextResourceCreationContext& creation_context);
+
 Result<ResourceImplStrongPtr> CreateResource(ContextImpl& context,
                                              ResourceSpecImplBase& spec,
                                              ResourceContainer* trigger) {
@@ -239,7 +274,7 @@ Result<ResourceImplStrongPtr> CreateResource(ContextImpl& context,
   Result<ResourceImplStrongPtr> result{};
   {
     internal::ScopedWriterUnlock unlock(context.root_->mutex_);
-    result = spec.CreateResource({&context, container_ptr});
+    result = CreateOrShareResource(context, spec, {&context, container_ptr});
     if (result.ok()) {
       auto& resource = **result;
       // Set `weak_creator_` if `resource` was created directly from `spec` by
@@ -288,7 +323,7 @@ Result<ResourceImplStrongPtr> GetOrCreateResourceStrongPtr(
       assert(!trigger->creation_blocked_on_);
       trigger->creation_blocked_on_ = &container;
     }
-    auto result = spec.CreateResource({&context, &container});
+    auto result = CreateOrShareResource(context, spec, {&context, &container});
     if (trigger) {
       absl::MutexLock lock(&context.root_->mutex_);
       trigger->creation_blocked_on_ = nullptr;
@@ -395,6 +430,43 @@ class ResourceReference : public ResourceSpecImplBase {
   std::string referent_;
 };
 
+namespace {
+
+Result<ResourceImplStrongPtr> CreateOrShareResource(
+    ContextImpl& context, ResourceSpecImplBase& spec,
+    const internal::ContextResourceCreationContext& creation_context) {
+  if (!context.decoded_ || !spec.provider_->shared_when_decoded_ ||
+      dynamic_cast<ResourceReference*>(&spec) ||
+      dynamic_cast<BuilderResourceSpec*>(&spec)) {
+    return spec.CreateResource(creation_context);
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto json, spec.ToJson({}));
+  std::string key = tensorstore::StrCat(spec.provider_->id_, ":",
+                                        json.dump());
+  auto& registry = GetSharedDecodedResources();
+  {
+    absl::MutexLock lock(&registry.mutex);
+    if (auto it = registry.resources.find(key);
+        it != registry.resources.end() &&
+        IncrementReferenceCountIfNonZero(
+            static_cast<ResourceOrSpecBase&>(*it->second))) {
+      ResourceImplStrongPtr resource(it->second, internal::adopt_object_ref);
+      resource->spec_->provider_->AcquireContextReference(*resource);
+      return resource;
+    }
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto resource,
+                               spec.CreateResource(creation_context));
+  absl::MutexLock lock(&registry.mutex);
+  if (resource->shared_decode_key_.empty()) {
+    resource->shared_decode_key_ = key;
+    registry.resources[std::move(key)] = resource.get();
+  }
+  return resource;
+}
+
+}  // namespace
+
 void RegisterContextResourceProvider(
     std::unique_ptr<const ResourceProviderImplBase> provider) {
   auto& registry = GetRegistry();
@@ -1110,6 +1182,7 @@ bool DecodeContextSpecBuilder(serialization::DecodeSource& source,
       new internal_context::ContextImpl);
   context_impl->spec_.reset(new internal_context::ContextSpecImpl);
   context_impl->root_ = context_impl.get();
+  context_impl->decoded_ = true;
   while (count--) {
     if (!DecodeContextResourceInContextSpecBuilder(source, *context_impl)) {
       return false;
@@ -1212,6 +1285,7 @@ bool ContextImplPtrNonNullDirectSerializer::Decode(
   if (!serialization::DecodeTuple(source, spec, parent)) return false;
   Context context(std::move(spec), std::move(parent));
   value = std::move(internal_context::Access::impl(context));
+  value->decoded_ = true;
   return true;
 }
 
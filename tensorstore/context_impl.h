@@ -95,6 +95,12 @@ class ContextImpl : public internal::AtomicReferenceCount<ContextImpl> {
   /// `BuilderResourceSpec`) should be bound.  Other context resource specs
   /// should remain unbound.
   bool bind_partial_ = false;
+
+  /// Indicates that this context was obtained by deserialization.  Resources
+  /// created by a decoded context for providers with
+  /// `shared_when_decoded == true` are shared with other decoded contexts that
+  /// specify an equal resource.
+  bool decoded_ = false;
 };
 
 /// Derived implementation of `ResourceSpecImplBase` used by
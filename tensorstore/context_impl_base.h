@@ -207,6 +207,9 @@ class ResourceProviderImplBase {
 
   bool config_only_;
 
+  /// Indicates that equal resources decoded in the same process may be shared.
+  bool shared_when_decoded_;
+
   /// Returns a non-null pointer to a new spec that may be used to construct a
   /// resource for this provider in its default state.
   virtual ResourceSpecImplPtr Default() const = 0;
@@ -343,6 +346,10 @@ class ResourceImplBase : public ResourceOrSpecBase {
   // resource identity is consistent when a Context object is "shared" between
   // the controller and a worker.
   ContextImpl* weak_creator_ = nullptr;
+  // Key under which this resource is registered for sharing by decoding, or
+  // empty if not registered.  Set before the resource is registered, and not
+  // modified afterwards.
+  std::string shared_decode_key_;
 };
 
 /// For each resource provider type, `ResourceImpl<Provider>` is the
@@ -375,6 +382,7 @@ class ResourceProviderImpl : public ResourceProviderImplBase {
   ResourceProviderImpl(U&&... arg) : traits_(std::forward<U>(arg)...) {
     id_ = Provider::id;
     config_only_ = Traits::config_only;
+    shared_when_decoded_ = Traits::shared_when_decoded;
   }
   using Spec = typename Traits::Spec;
   using Resource = typename Provider::Resource;
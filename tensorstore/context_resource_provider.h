@@ -55,6 +55,7 @@ class ContextResourceTraits {
   using FromJsonOptions = Context::FromJsonOptions;
 
   constexpr static bool config_only = false;
+  constexpr static bool shared_when_decoded = false;
 
   template <typename Resource>
   static void AcquireContextReference(Resource& obj) {}
@@ -133,6 +134,20 @@ class ContextResourceTraitsConcept : public ContextResourceTraits<Provider> {
   /// relationship is not preserved.
   constexpr static bool config_only = false;
 
+  /// Indicates if resources decoded from equal specs may be shared.
+  ///
+  /// Normally, each deserialized context resource that was not bound to a
+  /// context in the current process is created anew, even if an identical
+  /// resource was previously deserialized.  If `true`, deserializing a resource
+  /// whose spec equals that of a live resource previously deserialized in the
+  /// same process instead returns the existing resource.  This is appropriate
+  /// for resources such as cache pools and concurrency limits, where sharing
+  /// affects only performance, and allows e.g. many tasks received by a single
+  /// worker process to share cached metadata and data.  It must not be used
+  /// for resources with observable state, such as an in-memory key-value
+  /// store, or for resources whose spec depends on other context resources.
+  constexpr static bool shared_when_decoded = false;
+
   /// Required. Specifies the type used for the validated representation of a
   /// resource specification created from a JSON object.
   ///
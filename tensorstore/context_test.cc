@@ -94,6 +94,22 @@ struct IntResource : public ContextResourceTraits<IntResource> {
   }
 };
 
+struct SharedIntResource : public ContextResourceTraits<SharedIntResource> {
+  constexpr static bool shared_when_decoded = true;
+  using Spec = IntResource::Spec;
+  using Resource = std::int64_t;
+  static constexpr char id[] = "shared_int_resource";
+  static Spec Default() { return {42}; }
+  static constexpr auto JsonBinder() { return IntResource::JsonBinder(); }
+  static Result<Resource> Create(Spec v,
+                                 ContextResourceCreationContext context) {
+    return v.value;
+  }
+  static Spec GetSpec(Resource v, const ContextSpecBuilder& builder) {
+    return {v};
+  }
+};
+
 struct IntConfigResource : public ContextResourceTraits<IntConfigResource> {
   constexpr static bool config_only = true;
   struct Spec {
@@ -170,6 +186,8 @@ struct OptionalResource : public ContextResourceTraits<OptionalResource> {
 };
 
 const ContextResourceRegistration<IntResource> int_resource_registration;
+const ContextResourceRegistration<SharedIntResource>
+    shared_int_resource_registration;
 const ContextResourceRegistration<IntConfigResource>
     int_config_resource_registration;
 const ContextResourceRegistration<StrongRefResource>
@@ -918,6 +936,41 @@ TEST(ContextSerializationTest, Shared) {
               ::testing::Optional(copy_res_c_parent));
 }
 
+TEST(ContextSerializationTest, SharedWhenDecoded) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto spec, Context::Spec::FromJson({
+                     {"int_resource", {{"value", 5}}},
+                     {"shared_int_resource", {{"value", 5}}},
+                     {"shared_int_resource#a", {{"value", 6}}},
+                 }));
+  Context context(spec);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto copy1, SerializationRoundTrip(context));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto copy2, SerializationRoundTrip(context));
+  EXPECT_NE(copy1, copy2);
+
+  // Resources for providers without `shared_when_decoded` are not shared.
+  EXPECT_NE(copy1.GetResource<IntResource>().value(),
+            copy2.GetResource<IntResource>().value());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto res1,
+                                   copy1.GetResource<SharedIntResource>());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto res2,
+                                   copy2.GetResource<SharedIntResource>());
+  EXPECT_EQ(res1, res2);
+  EXPECT_EQ(5, *res1);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto res1_a,
+      copy1.GetResource<SharedIntResource>("shared_int_resource#a"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto res2_a,
+      copy2.GetResource<SharedIntResource>("shared_int_resource#a"));
+  EXPECT_EQ(res1_a, res2_a);
+  EXPECT_NE(res1, res1_a);
+
+  // Contexts that were not decoded do not share resources.
+  EXPECT_NE(context.GetResource<SharedIntResource>().value(), res1);
+}
+
 TEST(ContextTest, ConcurrentCreateSingleResource) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto spec, Context::Spec::FromJson({{"int_resource", {{"value", 5}}}}));
@@ -21,6 +21,8 @@
 #include <type_traits>
 
 #include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/convert_contiguous.h"
 #include "tensorstore/internal/elementwise_function.h"
 #include "tensorstore/util/result.h"
 
@@ -31,6 +33,13 @@ struct ConvertDataType {
   void operator()(const From* from, To* to, void* arg) const {
     *to = static_cast<To>(*from);
   }
+
+  // Converts contiguous buffers with a loop that can be vectorized, rather than
+  // element by element.
+  Index ApplyContiguous(Index count, const From* from, To* to, void*) const {
+    internal::ConvertContiguous(count, from, to);
+    return count;
+  }
 };
 
 template <typename From, typename To>
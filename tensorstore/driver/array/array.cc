@@ -283,6 +283,12 @@ void ArrayDriver::Read(
                                        Arena* arena) {
       return GetTransformedArrayNDIterable(self->data_, chunk_transform, arena);
     }
+
+    Result<TransformedSharedArray<const void>> operator()(
+        ReadChunk::GetArray, IndexTransform<> chunk_transform) {
+      // `data_` may be modified concurrently by writes.
+      return absl::UnimplementedError("");
+    }
   };
   // Cancellation does not make sense since there is only a single call to
   // `set_value` which occurs immediately after `set_starting`.
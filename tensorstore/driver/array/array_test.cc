@@ -47,6 +47,7 @@
 #include "tensorstore/spec.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/tensorstore.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
@@ -120,6 +121,28 @@ TEST(FromArrayTest, Read) {
   EXPECT_THAT(read_progress, ::testing::ElementsAre(ReadProgress{6, 6}));
 }
 
+TEST(FromArrayTest, ReadChunks) {
+  auto array =
+      tensorstore::MakeOffsetArray<int>({1, 2}, {{1, 2, 3}, {4, 5, 6}});
+  auto store = tensorstore::FromArray(array).value();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto chunks,
+      tensorstore::CollectFlowSenderIntoFuture<
+          std::vector<tensorstore::ReadChunkView>>(
+          tensorstore::ReadChunks(store | tensorstore::Dims(1).SizedInterval(
+                                              3, 2)))
+          .result());
+  ASSERT_EQ(1, chunks.size());
+  EXPECT_EQ(tensorstore::dtype_v<int>, chunks[0].dtype());
+  EXPECT_EQ(tensorstore::Box<>({1, 3}, {2, 2}), chunks[0].domain().box());
+  // The data of the array driver may be modified concurrently, and is
+  // therefore copied.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto chunk_array, chunks[0].array());
+  EXPECT_THAT(tensorstore::MakeCopy(chunk_array),
+              ::testing::Optional(tensorstore::MakeOffsetArray<int>(
+                  {1, 3}, {{2, 3}, {5, 6}})));
+}
+
 TEST(FromArrayTest, ReadBroadcast) {
   auto array =
       tensorstore::MakeOffsetArray<int>({1, 2}, {{1, 2, 3}, {4, 5, 6}});
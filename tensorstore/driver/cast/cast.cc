@@ -316,6 +316,12 @@ struct ReadChunkImpl {
     return GetConvertedInputNDIterable(std::move(iterable), self->target_dtype_,
                                        self->input_conversion_);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) {
+    // The data type conversion requires a copy.
+    return absl::UnimplementedError("");
+  }
 };
 
 // Implementation of `tensorstore::internal::WriteChunk::Impl` Poly
@@ -45,6 +45,7 @@ namespace internal {
 
 struct ReadChunk {
   struct BeginRead {};
+  struct GetArray {};
   using Impl = poly::Poly<
       sizeof(void*) * 2,
       /*Copyable=*/true,  //
@@ -70,7 +71,23 @@ struct ReadChunk {
       /// \returns An NDIterable with a shape of
       ///     `chunk_transform.input_shape()`.
       Result<NDIterable::Ptr>(BeginRead, IndexTransform<> chunk_transform,
-                              Arena* arena)>;
+                              Arena* arena),
+
+      /// Returns a read-only view of the data that references it directly,
+      /// if it is held in memory in immutable form.
+      ///
+      /// Unlike the `BeginRead` overload, this does not require any locks to
+      /// be held, and the returned array remains valid after this chunk is
+      /// destroyed.
+      ///
+      /// \param chunk_transform Transform with a range that is a subset of
+      ///     `transform`.
+      /// \returns An array with a domain of `chunk_transform.domain()`.
+      /// \error `absl::StatusCode::kUnimplemented` if the data cannot be
+      ///     viewed without copying it, in which case the `BeginRead` overload
+      ///     must be used instead.
+      Result<TransformedSharedArray<const void>>(
+          GetArray, IndexTransform<> chunk_transform)>;
 
   /// Type-erased chunk implementation.  In the case of the chunks produced by
   /// `ChunkCache::Read`, for example, the contained object holds a
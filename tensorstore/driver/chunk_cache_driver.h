@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include <cassert>
+#include <memory>
 #include <utility>
 
 #include "absl/status/status.h"
@@ -28,6 +29,7 @@
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_read_ahead.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/transaction.h"
@@ -41,20 +43,27 @@ namespace internal {
 /// a `ChunkCache`.
 ///
 /// \tparam Derived Derived `Driver` type, that must define
-///     `size_t component_index()`, `const ChunkCache *cache()`, and
-///     `const StalenessBound &data_staleness_bound()`.  The `Derived` type can
-///     inherit from `ChunkGridSpecificationDriver` to define those methods.
+///     `size_t component_index()`, `const ChunkCache *cache()`,
+///     `const StalenessBound &data_staleness_bound()`,
+///     `absl::Duration stale_while_revalidate()`, and
+///     `ChunkReadAhead *read_ahead()`.  The `Derived` type can inherit from
+///     `ChunkGridSpecificationDriver` to define those methods.
 template <typename Derived, typename Parent>
 class ChunkCacheReadWriteDriverMixin : public Parent {
  public:
-  /// Simply forwards to `ChunkCache::Read`.
+  /// Forwards to `ChunkCache::Read`, after notifying the read-ahead policy, if
+  /// any.
   void Read(Driver::ReadRequest request,
             AnyFlowReceiver<absl::Status, ReadChunk, IndexTransform<>> receiver)
       override {
-    static_cast<Derived*>(this)->cache()->Read(
-        {std::move(request), static_cast<Derived*>(this)->component_index(),
-         static_cast<Derived*>(this)->data_staleness_bound().time},
-        std::move(receiver));
+    auto& self = *static_cast<Derived*>(this);
+    ChunkCache::ReadRequest cache_request{
+        std::move(request), self.component_index(),
+        self.data_staleness_bound().time, self.stale_while_revalidate()};
+    if (auto* read_ahead = self.read_ahead()) {
+      read_ahead->OnRead(*self.cache(), cache_request);
+    }
+    self.cache()->Read(std::move(cache_request), std::move(receiver));
   }
 
   /// Simply forwards to `ChunkCache::Write`.
@@ -74,6 +83,13 @@ struct ChunkCacheDriverInitializer {
   CachePtr<CacheType> cache;
   size_t component_index;
   StalenessBound data_staleness_bound;
+
+  /// Specifies `ChunkCache::ReadRequest::stale_while_revalidate` for reads
+  /// through the driver.
+  absl::Duration stale_while_revalidate = absl::ZeroDuration();
+
+  /// Read-ahead policy for reads through the driver.  Disabled by default.
+  ChunkReadAheadOptions read_ahead = {};
 };
 
 /// TensorStore Driver mixin that stores a `CachePtr<ChunkCacheType>`, a
@@ -102,7 +118,11 @@ class ChunkGridSpecificationDriver : public Parent {
       : cache_(
             static_pointer_cast<ChunkCacheType>(std::move(initializer.cache))),
         component_index_(initializer.component_index),
-        data_staleness_bound_(initializer.data_staleness_bound) {
+        data_staleness_bound_(initializer.data_staleness_bound),
+        stale_while_revalidate_(initializer.stale_while_revalidate) {
+    if (initializer.read_ahead.enabled()) {
+      read_ahead_ = std::make_unique<ChunkReadAhead>(initializer.read_ahead);
+    }
     assert(cache_);
     assert(component_index_ < cache()->grid().components.size());
   }
@@ -134,10 +154,27 @@ class ChunkGridSpecificationDriver : public Parent {
     return data_staleness_bound_;
   }
 
+  // NOLINTNEXTLINE(readability/inheritance)
+  virtual absl::Duration stale_while_revalidate() const final {
+    return stale_while_revalidate_;
+  }
+
+  /// Returns the read-ahead state of this driver, or `nullptr` if read-ahead
+  /// is disabled.
+  ChunkReadAhead* read_ahead() const { return read_ahead_.get(); }
+
+  /// Returns the read-ahead options specified when the driver was created.
+  // NOLINTNEXTLINE(readability/inheritance)
+  virtual ChunkReadAheadOptions read_ahead_options() const final {
+    return read_ahead_ ? read_ahead_->options() : ChunkReadAheadOptions{};
+  }
+
  private:
   CachePtr<ChunkCacheType> cache_;
   size_t component_index_;
   StalenessBound data_staleness_bound_;
+  absl::Duration stale_while_revalidate_;
+  std::unique_ptr<ChunkReadAhead> read_ahead_;
 };
 
 /// Combines `ChunkGridSpecificationDriver` and
@@ -0,0 +1,66 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/codec_metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/metadata.h"
+
+using ::tensorstore::internal_metrics::MetricMetadata;
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+auto& codec_encode_bytes = internal_metrics::Counter<int64_t, std::string>::New(
+    "/tensorstore/codec/encode_bytes", "codec",
+    MetricMetadata("Bytes of array data encoded, by chunk codec",
+                   internal_metrics::Units::kBytes));
+
+auto& codec_encode_ns = internal_metrics::Counter<int64_t, std::string>::New(
+    "/tensorstore/codec/encode_ns", "codec",
+    MetricMetadata("Time spent encoding array data (ns), by chunk codec"));
+
+auto& codec_decode_bytes = internal_metrics::Counter<int64_t, std::string>::New(
+    "/tensorstore/codec/decode_bytes", "codec",
+    MetricMetadata("Bytes of array data decoded, by chunk codec",
+                   internal_metrics::Units::kBytes));
+
+auto& codec_decode_ns = internal_metrics::Counter<int64_t, std::string>::New(
+    "/tensorstore/codec/decode_ns", "codec",
+    MetricMetadata("Time spent decoding array data (ns), by chunk codec"));
+
+}  // namespace
+
+void RecordCodecEncodeMetric(std::string_view codec, size_t decoded_bytes,
+                             absl::Duration elapsed) {
+  codec_encode_bytes.IncrementBy(decoded_bytes, codec);
+  codec_encode_ns.IncrementBy(absl::ToInt64Nanoseconds(elapsed), codec);
+}
+
+void RecordCodecDecodeMetric(std::string_view codec, size_t decoded_bytes,
+                             absl::Duration elapsed) {
+  codec_decode_bytes.IncrementBy(decoded_bytes, codec);
+  codec_decode_ns.IncrementBy(absl::ToInt64Nanoseconds(elapsed), codec);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
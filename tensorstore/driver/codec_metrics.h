@@ -0,0 +1,53 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_CODEC_METRICS_H_
+#define TENSORSTORE_DRIVER_CODEC_METRICS_H_
+
+/// \file
+///
+/// Metrics for chunk encoding and decoding.
+///
+/// For each chunk format, reported in the `codec` field, the following
+/// counters are exported:
+///
+/// - `/tensorstore/codec/encode_bytes` and `/tensorstore/codec/encode_ns`
+/// - `/tensorstore/codec/decode_bytes` and `/tensorstore/codec/decode_ns`
+///
+/// Bytes are counted in the decoded representation, so that `*_ns / *_bytes`
+/// gives the cost per byte of array data.
+
+#include <stddef.h>
+
+#include <string_view>
+
+#include "absl/time/time.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Records that `decoded_bytes` of array data were encoded by `codec` in
+/// `elapsed` time.
+void RecordCodecEncodeMetric(std::string_view codec, size_t decoded_bytes,
+                             absl::Duration elapsed);
+
+/// Records that `decoded_bytes` of array data were decoded by `codec` in
+/// `elapsed` time.
+void RecordCodecDecodeMetric(std::string_view codec, size_t decoded_bytes,
+                             absl::Duration elapsed);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_CODEC_METRICS_H_
@@ -14,20 +14,31 @@
 
 #include "tensorstore/driver/copy.h"
 
+#include <stddef.h>
+
 #include <atomic>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/data_type_conversion.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/output_index_method.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable.h"
@@ -36,15 +47,22 @@
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/internal/tagged_ptr.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/progress.h"
 #include "tensorstore/read_write_options.h"
 #include "tensorstore/resize_options.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/sender.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/iterate_over_index_range.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
@@ -67,6 +85,17 @@ namespace {
 ///    `source_transform` bounds.  `CopyReadChunkReceiver` ensures that the read
 ///    is canceled if `copy_promise.result_needed()` becomes `false`.
 ///
+///    If the source and target store interchangeable encoded chunks (see
+///    `Driver::GetEncodedChunkStorage`), the grid cells that are entirely
+///    covered by the copy are instead copied by `EncodedChunkCopyInitiateOp`
+///    as encoded chunks, and only the remaining portions of the domain are
+///    read.
+///
+///    If a `CopyMemoryLimit` is specified, the domain is instead partitioned
+///    into the cells of the target write chunk grid, which are copied in grid
+///    order by `ChunkedCopyState`, each using a separate `CopyState`, subject
+///    to the memory limit.
+///
 /// 4. For each `ReadChunk` received, `CopyReadChunkReceiver` invokes
 ///    `CopyInitiateWriteOp` using `executor`: `CopyInitiateWriteOp` calls
 ///    `Driver::Write` on `target_driver` with a `CopyWriteChunkReceiver` to
@@ -138,6 +167,12 @@ struct CopyState : public internal::AtomicReferenceCount<CopyState> {
   internal::OpenTransactionPtr target_transaction;
   IndexTransform<> target_transform;
   DomainAlignmentOptions alignment_options;
+  /// Bound on the decoded bytes in flight, or `0` if unbounded.
+  size_t total_bytes_limit = 0;
+  /// Storage of the encoded chunks of the source and target drivers.  Null if
+  /// encoded chunks cannot be copied directly, e.g. due to a transaction.
+  Future<Driver::EncodedChunkStorage> source_chunk_storage;
+  Future<Driver::EncodedChunkStorage> target_chunk_storage;
   Promise<void> copy_promise;
   Promise<void> commit_promise;
   IntrusivePtr<CommitState> commit_state{new CommitState};
@@ -147,6 +182,17 @@ struct CopyState : public internal::AtomicReferenceCount<CopyState> {
   }
 };
 
+/// Callback linked to `CopyState::commit_promise` that updates the commit
+/// progress once a chunk has been committed.
+struct CommitCallback {
+  IntrusivePtr<CopyState::CommitState> state;
+  Index num_elements;
+  template <typename T>
+  void operator()(Promise<void>, ReadyFuture<T>) const {
+    state->UpdateCommitProgress(num_elements);
+  }
+};
+
 /// Callback invoked by `CopyWriteChunkReceiver` (using the executor) to copy
 /// data from the relevant portion of a single `ReadChunk` to a `WriteChunk`.
 struct CopyChunkOp {
@@ -199,13 +245,6 @@ struct CopyChunkOp {
     if (copy_status.ok()) {
       const Index num_elements = write_chunk.transform.domain().num_elements();
       state->commit_state->UpdateCopyProgress(num_elements);
-      struct CommitCallback {
-        IntrusivePtr<CopyState::CommitState> state;
-        Index num_elements;
-        void operator()(Promise<void>, Future<const void>) const {
-          state->UpdateCommitProgress(num_elements);
-        }
-      };
       if (!state->commit_promise.null() && !commit_future.null()) {
         // For transactional writes, `state->commit_promise` is null.
         LinkValue(CommitCallback{state->commit_state, num_elements},
@@ -303,6 +342,452 @@ struct CopyReadChunkReceiver {
   }
 };
 
+/// Initiates reads of the source driver over the input domains of
+/// `source_transforms`, which must be disjoint.
+void InitiateSourceReads(IntrusivePtr<CopyState> state,
+                         std::vector<IndexTransform<>> source_transforms) {
+  auto source_driver = std::move(state->source_driver);
+  auto source_transaction = std::move(state->source_transaction);
+  auto source_batch = std::move(state->source_batch);
+  for (auto& source_transform : source_transforms) {
+    Driver::ReadRequest request;
+    request.transaction = source_transaction;
+    request.batch = source_batch;
+    request.transform = std::move(source_transform);
+    source_driver->Read(std::move(request), CopyReadChunkReceiver{state});
+  }
+}
+
+/// Grid cells that are copied as encoded chunks.
+struct EncodedChunkCopyPlan {
+  /// Range of target grid cells.
+  Box<> target_cells;
+
+  /// Offset of the source grid cell indices relative to `target_cells`.
+  std::vector<Index> source_cell_offset;
+
+  /// Input dimension of the copy domain, and offset of the target index
+  /// relative to the input index, for each dimension of the target.
+  std::vector<DimensionIndex> domain_dims;
+  std::vector<Index> target_offsets;
+
+  /// Portion of the copy domain covered by `target_cells`.
+  Box<> covered_domain;
+};
+
+/// Determines the grid cells that may be copied as encoded chunks.
+///
+/// This requires that `source` and `target` have the same format and chunk
+/// shape, and that `source_transform` and `target_transform` map the copy
+/// domain to the respective index spaces by translations that differ by a
+/// multiple of the chunk shape.  A grid cell is covered if all elements of both
+/// the source and target cell within the bounds of the respective driver are
+/// copied.
+///
+/// \returns `false` if no grid cells may be copied as encoded chunks.
+bool PlanEncodedChunkCopy(const Driver::EncodedChunkStorage& source,
+                          const Driver::EncodedChunkStorage& target,
+                          IndexTransformView<> source_transform,
+                          IndexTransformView<> target_transform,
+                          EncodedChunkCopyPlan& plan) {
+  const DimensionIndex rank = target_transform.output_rank();
+  if (source.format != target.format ||
+      source.chunk_shape != target.chunk_shape ||
+      static_cast<DimensionIndex>(target.chunk_shape.size()) != rank ||
+      source.bounds.rank() != rank || target.bounds.rank() != rank ||
+      source_transform.output_rank() != rank ||
+      target_transform.input_rank() != rank) {
+    return false;
+  }
+  const auto contains = [](IndexInterval outer, IndexInterval inner) {
+    return inner.empty() || Contains(outer, inner);
+  };
+  plan.target_cells = Box<>(rank);
+  plan.source_cell_offset.resize(rank);
+  plan.domain_dims.resize(rank);
+  plan.target_offsets.resize(rank);
+  plan.covered_domain = Box<>(target_transform.domain().box());
+  DimensionSet domain_dims_seen;
+  for (DimensionIndex dim = 0; dim < rank; ++dim) {
+    const auto source_map = source_transform.output_index_maps()[dim];
+    const auto target_map = target_transform.output_index_maps()[dim];
+    if (source_map.method() != OutputIndexMethod::single_input_dimension ||
+        target_map.method() != OutputIndexMethod::single_input_dimension ||
+        source_map.stride() != 1 || target_map.stride() != 1 ||
+        source_map.input_dimension() != target_map.input_dimension()) {
+      return false;
+    }
+    const DimensionIndex domain_dim = target_map.input_dimension();
+    if (domain_dims_seen[domain_dim]) return false;
+    domain_dims_seen[domain_dim] = true;
+    const Index chunk_size = target.chunk_shape[dim];
+    const Index delta = source_map.offset() - target_map.offset();
+    if (chunk_size <= 0 || delta % chunk_size != 0) return false;
+
+    // Copied region and source bounds, in the target index space.
+    const IndexInterval domain = target_transform.domain()[domain_dim];
+    const IndexInterval region = IndexInterval::UncheckedSized(
+        domain.inclusive_min() + target_map.offset(), domain.size());
+    if (region.empty()) return false;
+    const IndexInterval source_bounds = IndexInterval::UncheckedSized(
+        source.bounds[dim].inclusive_min() - delta, source.bounds[dim].size());
+    const auto is_covered = [&](Index cell) {
+      const auto cell_interval =
+          IndexInterval::UncheckedSized(cell * chunk_size, chunk_size);
+      return contains(region, Intersect(cell_interval, target.bounds[dim])) &&
+             contains(region, Intersect(cell_interval, source_bounds));
+    };
+    // Only the first and last cells that intersect `region` may be partially
+    // covered.
+    Index cell_min = FloorOfRatio(region.inclusive_min(), chunk_size);
+    Index cell_max = FloorOfRatio(region.inclusive_max(), chunk_size) + 1;
+    if (!is_covered(cell_min)) ++cell_min;
+    if (cell_max > cell_min && !is_covered(cell_max - 1)) --cell_max;
+    if (cell_min >= cell_max) return false;
+
+    plan.target_cells[dim] =
+        IndexInterval::UncheckedHalfOpen(cell_min, cell_max);
+    plan.source_cell_offset[dim] = delta / chunk_size;
+    plan.domain_dims[dim] = domain_dim;
+    plan.target_offsets[dim] = target_map.offset();
+    plan.covered_domain[domain_dim] = Intersect(
+        domain, IndexInterval::UncheckedHalfOpen(
+                    cell_min * chunk_size - target_map.offset(),
+                    cell_max * chunk_size - target_map.offset()));
+  }
+  return true;
+}
+
+/// Appends to `parts` disjoint boxes that, together with `inner`, partition
+/// `outer`.
+///
+/// \pre `Contains(outer, inner)`
+void PartitionBoxDifference(BoxView<> outer, BoxView<> inner,
+                            std::vector<Box<>>& parts) {
+  Box<> remaining(outer);
+  for (DimensionIndex i = 0; i < outer.rank(); ++i) {
+    const IndexInterval remaining_interval = remaining[i];
+    if (inner[i].inclusive_min() > remaining_interval.inclusive_min()) {
+      Box<> part(remaining);
+      part[i] = IndexInterval::UncheckedHalfOpen(
+          remaining_interval.inclusive_min(), inner[i].inclusive_min());
+      parts.push_back(std::move(part));
+    }
+    if (inner[i].exclusive_max() < remaining_interval.exclusive_max()) {
+      Box<> part(remaining);
+      part[i] = IndexInterval::UncheckedHalfOpen(
+          inner[i].exclusive_max(), remaining_interval.exclusive_max());
+      parts.push_back(std::move(part));
+    }
+    remaining[i] = inner[i];
+  }
+}
+
+/// Callback invoked once the encoded source chunk of a single grid cell has
+/// been read, which writes it to the corresponding target key.
+struct EncodedChunkWriteOp {
+  IntrusivePtr<CopyState> state;
+  kvstore::DriverPtr target_kvstore;
+  std::string target_key;
+  Index num_elements;
+  void operator()(ReadyFuture<kvstore::ReadResult> future) {
+    auto& read_result = future.result();
+    if (!read_result.ok()) {
+      state->SetError(std::move(read_result).status());
+      return;
+    }
+    if (!state->copy_promise.result_needed()) return;
+    state->commit_state->UpdateReadProgress(num_elements);
+    // A missing source chunk implies the fill value, which is represented by a
+    // missing target chunk.
+    std::optional<absl::Cord> value;
+    if (read_result->has_value()) value = std::move(read_result->value);
+    auto commit_future =
+        target_kvstore->Write(std::move(target_key), std::move(value));
+    state->commit_state->UpdateCopyProgress(num_elements);
+    LinkValue(CommitCallback{state->commit_state, num_elements},
+              state->commit_promise, std::move(commit_future));
+  }
+};
+
+/// Callback used by `DriverCopyInitiateOp` to copy the grid cells entirely
+/// covered by the copy as encoded chunks, once the encoded chunk storage of the
+/// source and target drivers is available, and to read the remaining portions
+/// of the source.
+struct EncodedChunkCopyInitiateOp {
+  IntrusivePtr<CopyState> state;
+  IndexTransform<> source_transform;
+  void operator()(
+      Promise<void> promise,
+      ReadyFuture<Driver::EncodedChunkStorage> source_storage_future,
+      ReadyFuture<Driver::EncodedChunkStorage> target_storage_future) {
+    EncodedChunkCopyPlan plan;
+    if (!source_storage_future.result().ok() ||
+        !target_storage_future.result().ok() ||
+        !PlanEncodedChunkCopy(source_storage_future.value(),
+                              target_storage_future.value(), source_transform,
+                              state->target_transform, plan)) {
+      std::vector<IndexTransform<>> source_transforms;
+      source_transforms.push_back(std::move(source_transform));
+      InitiateSourceReads(std::move(state), std::move(source_transforms));
+      return;
+    }
+    const auto& source_storage = source_storage_future.value();
+    const auto& target_storage = target_storage_future.value();
+    const DimensionIndex rank = plan.target_cells.rank();
+    kvstore::ReadOptions read_options;
+    read_options.staleness_bound = source_storage.staleness_bound;
+    std::vector<Index> source_cell(rank);
+    const auto copy_cell = [&](span<const Index> target_cell) {
+      // Number of elements of the copy domain within the cell.
+      Index num_elements = 1;
+      for (DimensionIndex dim = 0; dim < rank; ++dim) {
+        source_cell[dim] = target_cell[dim] + plan.source_cell_offset[dim];
+        const Index chunk_size = target_storage.chunk_shape[dim];
+        const auto cell_domain = IndexInterval::UncheckedSized(
+            target_cell[dim] * chunk_size - plan.target_offsets[dim],
+            chunk_size);
+        num_elements *=
+            Intersect(cell_domain, plan.covered_domain[plan.domain_dims[dim]])
+                .size();
+      }
+      source_storage.kvstore
+          ->Read(source_storage.get_chunk_key(source_cell), read_options)
+          .ExecuteWhenReady(EncodedChunkWriteOp{
+              state, target_storage.kvstore,
+              target_storage.get_chunk_key(target_cell), num_elements});
+    };
+    IterateOverIndexRange(plan.target_cells, copy_cell);
+
+    std::vector<Box<>> parts;
+    PartitionBoxDifference(state->target_transform.domain().box(),
+                           plan.covered_domain, parts);
+    std::vector<IndexTransform<>> source_transforms;
+    for (const auto& part : parts) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto part_transform,
+          ComposeTransforms(source_transform, IdentityTransform(part)),
+          state->SetError(_));
+      source_transforms.push_back(std::move(part_transform));
+    }
+    InitiateSourceReads(std::move(state), std::move(source_transforms));
+  }
+};
+
+/// Initiates the copy of `source_transform` to `state->target_transform`,
+/// which must have the same domain.
+void StartCopy(IntrusivePtr<CopyState> state,
+               IndexTransform<> source_transform) {
+  if (!state->source_chunk_storage.null()) {
+    auto source_chunk_storage = std::move(state->source_chunk_storage);
+    auto target_chunk_storage = std::move(state->target_chunk_storage);
+    auto copy_promise = state->copy_promise;
+    auto executor = state->executor;
+    Link(WithExecutor(std::move(executor),
+                      EncodedChunkCopyInitiateOp{std::move(state),
+                                                 std::move(source_transform)}),
+         std::move(copy_promise), std::move(source_chunk_storage),
+         std::move(target_chunk_storage));
+    return;
+  }
+
+  // Initiate the read operation on the source driver.
+  std::vector<IndexTransform<>> source_transforms;
+  source_transforms.push_back(std::move(source_transform));
+  InitiateSourceReads(std::move(state), std::move(source_transforms));
+}
+
+/// Advances `cell` to the next position within `cells` in C order.
+///
+/// \returns `false` if `cell` was the last position.
+bool AdvanceGridCell(BoxView<> cells, span<Index> cell) {
+  for (DimensionIndex dim = cells.rank(); dim--;) {
+    if (++cell[dim] <= cells[dim].inclusive_max()) return true;
+    cell[dim] = cells.origin()[dim];
+  }
+  return false;
+}
+
+/// State of a copy performed one target write chunk at a time, used when a
+/// `CopyMemoryLimit` is specified.
+///
+/// Each cell of the target write chunk grid that intersects the copy domain is
+/// copied as a separate region, with its own `CopyState`, in C order of the
+/// grid cells.  A region is started only while the estimated size of the
+/// decoded source and target data of the regions in flight remains within the
+/// limit.  A region remains in flight until it has been written back or, if
+/// the target is transactional, until its data has been copied.
+///
+/// The regions share the `CommitState` of `state`, and `state`, which holds
+/// the overall `copy_promise` and `commit_promise`, is released once all
+/// regions have completed.
+struct ChunkedCopyState
+    : public internal::AtomicReferenceCount<ChunkedCopyState> {
+  IntrusivePtr<CopyState> state;
+  IndexTransform<> source_transform;
+  Box<> domain;
+  std::vector<Index> grid_origin;
+  std::vector<Index> chunk_shape;
+  /// Range of grid cells that intersect `domain`.
+  Box<> cells;
+  size_t bytes_per_element;
+
+  absl::Mutex mutex;
+  size_t in_flight_bytes ABSL_GUARDED_BY(mutex) = 0;
+  std::vector<Index> next_cell ABSL_GUARDED_BY(mutex);
+  bool done ABSL_GUARDED_BY(mutex) = false;
+
+  /// Returns the portion of `domain` within the specified grid cell.
+  Box<> GetRegion(span<const Index> cell) const {
+    Box<> region(domain.rank());
+    for (DimensionIndex dim = 0; dim < domain.rank(); ++dim) {
+      const Index size = chunk_shape[dim];
+      region[dim] = Intersect(
+          IndexInterval::UncheckedSized(grid_origin[dim] + cell[dim] * size,
+                                        size),
+          domain[dim]);
+    }
+    return region;
+  }
+};
+
+void StartChunkedCopyRegions(IntrusivePtr<ChunkedCopyState> self);
+
+/// Called once a region started by `StartChunkedCopyRegion` has completed.
+void ChunkedCopyRegionDone(IntrusivePtr<ChunkedCopyState> self,
+                           absl::Status status, size_t bytes) {
+  {
+    absl::MutexLock lock(&self->mutex);
+    self->in_flight_bytes -= bytes;
+    if (!status.ok()) {
+      self->done = true;
+      self->state->SetError(std::move(status));
+    }
+  }
+  StartChunkedCopyRegions(std::move(self));
+}
+
+/// Initiates the copy of a single `region` of the domain.
+void StartChunkedCopyRegion(IntrusivePtr<ChunkedCopyState> self,
+                            BoxView<> region, size_t bytes) {
+  const CopyState& parent = *self->state;
+  auto source_transform =
+      ComposeTransforms(self->source_transform, IdentityTransform(region));
+  auto target_transform =
+      ComposeTransforms(parent.target_transform, IdentityTransform(region));
+  if (!source_transform.ok() || !target_transform.ok()) {
+    ChunkedCopyRegionDone(std::move(self),
+                          !source_transform.ok() ? source_transform.status()
+                                                 : target_transform.status(),
+                          bytes);
+    return;
+  }
+  IntrusivePtr<CopyState> state(new CopyState);
+  state->executor = parent.executor;
+  state->source_driver = parent.source_driver;
+  state->source_transaction = parent.source_transaction;
+  state->data_type_conversion = parent.data_type_conversion;
+  state->target_driver = parent.target_driver;
+  state->target_transaction = parent.target_transaction;
+  state->target_transform = *std::move(target_transform);
+  state->source_chunk_storage = parent.source_chunk_storage;
+  state->target_chunk_storage = parent.target_chunk_storage;
+  state->commit_state = parent.commit_state;
+  auto copy_pair = PromiseFuturePair<void>::Make(MakeResult());
+  state->copy_promise = std::move(copy_pair.promise);
+  Future<const void> region_future;
+  if (!parent.commit_promise.null()) {
+    auto commit_pair =
+        PromiseFuturePair<void>::LinkError(MakeResult(), copy_pair.future);
+    state->commit_promise = std::move(commit_pair.promise);
+    region_future = std::move(commit_pair.future);
+  } else {
+    region_future = std::move(copy_pair.future);
+  }
+  StartCopy(std::move(state), *std::move(source_transform));
+  region_future.ExecuteWhenReady(
+      [self = std::move(self), bytes](ReadyFuture<const void> future) mutable {
+        ChunkedCopyRegionDone(std::move(self), future.status(), bytes);
+      });
+}
+
+/// Starts as many further regions as the memory limit permits.  At least one
+/// region is always in flight until all regions have been started.
+void StartChunkedCopyRegions(IntrusivePtr<ChunkedCopyState> self) {
+  std::vector<std::pair<Box<>, size_t>> regions;
+  {
+    absl::MutexLock lock(&self->mutex);
+    while (!self->done) {
+      if (!self->state->copy_promise.result_needed()) {
+        self->done = true;
+        break;
+      }
+      Box<> region = self->GetRegion(self->next_cell);
+      const size_t bytes = region.num_elements() * self->bytes_per_element;
+      if (self->in_flight_bytes != 0 &&
+          self->in_flight_bytes + bytes > self->state->total_bytes_limit) {
+        break;
+      }
+      self->in_flight_bytes += bytes;
+      regions.emplace_back(std::move(region), bytes);
+      self->done = !AdvanceGridCell(self->cells, self->next_cell);
+    }
+  }
+  for (auto& [region, bytes] : regions) {
+    StartChunkedCopyRegion(self, region, bytes);
+  }
+}
+
+/// Initiates a copy subject to `state->total_bytes_limit`.
+void StartChunkedCopy(IntrusivePtr<CopyState> state,
+                      IndexTransform<> source_transform) {
+  BoxView<> domain = state->target_transform.domain().box();
+  if (!IsFinite(domain) || domain.is_empty()) {
+    StartCopy(std::move(state), std::move(source_transform));
+    return;
+  }
+  const DimensionIndex rank = domain.rank();
+  IntrusivePtr<ChunkedCopyState> self(new ChunkedCopyState);
+  self->domain = domain;
+  self->grid_origin.resize(rank);
+  self->chunk_shape.resize(rank);
+  self->cells.set_rank(rank);
+  // Dimensions for which the target does not specify a write chunk size are
+  // not partitioned.
+  auto layout = state->target_driver->GetChunkLayout(state->target_transform);
+  for (DimensionIndex dim = 0; dim < rank; ++dim) {
+    const IndexInterval interval = domain[dim];
+    Index origin = kImplicit;
+    Index size = 0;
+    if (layout.ok() && layout->rank() == rank) {
+      if (!layout->grid_origin().empty()) origin = layout->grid_origin()[dim];
+      if (!layout->write_chunk_shape().empty()) {
+        size = layout->write_chunk_shape()[dim];
+      }
+    }
+    if (size <= 0) {
+      origin = interval.inclusive_min();
+      size = interval.size();
+    } else if (origin == kImplicit) {
+      origin = 0;
+    }
+    self->grid_origin[dim] = origin;
+    self->chunk_shape[dim] = size;
+    self->cells[dim] = IndexInterval::UncheckedClosed(
+        FloorOfRatio(interval.inclusive_min() - origin, size),
+        FloorOfRatio(interval.inclusive_max() - origin, size));
+  }
+  self->next_cell.assign(self->cells.origin().begin(),
+                         self->cells.origin().end());
+  self->bytes_per_element =
+      state->source_driver->dtype()->size + state->target_driver->dtype()->size;
+  // Reads are issued incrementally, and therefore cannot be part of a batch.
+  state->source_batch = no_batch;
+  self->source_transform = std::move(source_transform);
+  self->state = std::move(state);
+  StartChunkedCopyRegions(std::move(self));
+}
+
 /// Callback used by `DriverCopy` to initiate the copy operation once the bounds
 /// for the source and target transforms have been resolved.
 struct DriverCopyInitiateOp {
@@ -325,15 +810,11 @@ struct DriverCopyInitiateOp {
         target_transform.input_domain().num_elements();
     state->copy_promise = std::move(promise);
     state->target_transform = std::move(target_transform);
-
-    // Initiate the read operation on the source driver.
-    auto source_driver = std::move(state->source_driver);
-    Driver::ReadRequest request;
-    request.transaction = std::move(state->source_transaction);
-    request.batch = std::move(state->source_batch);
-    request.transform = std::move(source_transform);
-    source_driver->Read(std::move(request),
-                        CopyReadChunkReceiver{std::move(state)});
+    if (state->total_bytes_limit != 0) {
+      StartChunkedCopy(std::move(state), std::move(source_transform));
+      return;
+    }
+    StartCopy(std::move(state), std::move(source_transform));
   }
 };
 
@@ -360,8 +841,16 @@ WriteFutures DriverCopy(Executor executor, DriverHandle source,
   state->target_driver = std::move(target.driver);
   TENSORSTORE_ASSIGN_OR_RETURN(
       state->target_transaction,
-      internal::AcquireOpenTransactionPtrOrError(target.transaction));
+      internal::AcquireOpenTransactionPtrForWriteOrError(target.transaction));
   state->alignment_options = options.alignment_options;
+  state->total_bytes_limit = options.memory_limit.total_bytes_limit;
+  if (!state->source_transaction && !state->target_transaction &&
+      state->source_driver->dtype() == state->target_driver->dtype()) {
+    state->source_chunk_storage =
+        state->source_driver->GetEncodedChunkStorage();
+    state->target_chunk_storage =
+        state->target_driver->GetEncodedChunkStorage();
+  }
   state->commit_state->progress_function = std::move(options.progress_function);
   auto copy_pair = PromiseFuturePair<void>::Make(MakeResult());
   PromiseFuturePair<void> commit_pair;
@@ -0,0 +1,87 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/downsample/base_chunk_cache.h"
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+SharedOffsetArray<const void> BaseChunkCache::Get(span<const Index> cell,
+                                                  BoxView<> consumed) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(Key(cell.begin(), cell.end()));
+  if (it == entries_.end()) return {};
+  auto& entry = it->second;
+  SharedOffsetArray<const void> data = entry.data;
+  entry.remaining_elements -= consumed.num_elements();
+  if (entry.remaining_elements <= 0) {
+    EraseLocked(it);
+  } else {
+    lru_.splice(lru_.end(), lru_, entry.lru_position);
+  }
+  return data;
+}
+
+void BaseChunkCache::Put(span<const Index> cell,
+                         SharedOffsetArray<const void> data,
+                         BoxView<> consumed) {
+  const Index remaining_elements =
+      data.num_elements() - consumed.num_elements();
+  const size_t num_bytes = data.num_elements() * data.dtype()->size;
+  if (remaining_elements <= 0 || num_bytes > max_bytes_) return;
+  Key key(cell.begin(), cell.end());
+  absl::MutexLock lock(&mutex_);
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    // Read concurrently by another request.
+    EraseLocked(it);
+  }
+  while (total_bytes_ + num_bytes > max_bytes_) {
+    EraseLocked(entries_.find(lru_.front()));
+  }
+  auto lru_position = lru_.insert(lru_.end(), key);
+  entries_.emplace(std::move(key), Entry{std::move(data), remaining_elements,
+                                         num_bytes, lru_position});
+  total_bytes_ += num_bytes;
+}
+
+void BaseChunkCache::EraseLocked(
+    absl::flat_hash_map<Key, Entry>::iterator it) {
+  total_bytes_ -= it->second.num_bytes;
+  lru_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+size_t BaseChunkCache::total_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return total_bytes_;
+}
+
+size_t BaseChunkCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
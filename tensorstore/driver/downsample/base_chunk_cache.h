@@ -0,0 +1,107 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_BASE_CHUNK_CACHE_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_BASE_CHUNK_CACHE_H_
+
+/// \file
+///
+/// Cache of partially-consumed base chunks used by the downsample driver in
+/// chunk-aligned read mode.
+///
+/// When the base region required by a downsampled read straddles base chunks,
+/// adjacent downsampled reads each require a portion of the same base chunks.
+/// In chunk-aligned mode, base chunks are read in their entirety, and the data
+/// not yet consumed by a downsampled read is retained in a `BaseChunkCache` for
+/// the neighbouring reads, such that each base chunk is read only once.
+
+#include <stddef.h>
+
+#include <list>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+/// Cache of base chunk data, keyed by grid cell indices.
+///
+/// Each entry tracks the number of its elements that have not yet been
+/// consumed.  Entries are evicted once all of their elements have been
+/// consumed, or in least-recently-used order once the total size exceeds the
+/// limit.  Consumed regions are assumed not to overlap; overlapping reads only
+/// cause an entry to be evicted earlier than necessary.
+class BaseChunkCache {
+ public:
+  /// Constructs an empty cache.
+  ///
+  /// \param max_bytes Maximum total size of the cached chunk data.
+  explicit BaseChunkCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /// Returns the cached data for the base chunk with the specified grid cell
+  /// indices, and records that the `consumed` sub-region has been consumed.
+  ///
+  /// \returns The cached data, or a null array if the chunk is not cached.
+  SharedOffsetArray<const void> Get(span<const Index> cell,
+                                    BoxView<> consumed);
+
+  /// Adds the data of a base chunk that was just read, of which the
+  /// `consumed` sub-region has already been consumed.
+  ///
+  /// The data is not retained if it has been consumed entirely or is larger
+  /// than the cache limit.
+  void Put(span<const Index> cell, SharedOffsetArray<const void> data,
+           BoxView<> consumed);
+
+  /// Returns the total size of the cached chunk data.
+  size_t total_bytes() const;
+
+  /// Returns the number of cached chunks.
+  size_t size() const;
+
+ private:
+  using Key = std::vector<Index>;
+
+  struct Entry {
+    SharedOffsetArray<const void> data;
+    Index remaining_elements;
+    size_t num_bytes;
+    std::list<Key>::iterator lru_position;
+  };
+
+  void EraseLocked(absl::flat_hash_map<Key, Entry>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  size_t max_bytes_;
+  mutable absl::Mutex mutex_;
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  /// Keys in least-recently-used order, where the front is the least recently
+  /// used.
+  std::list<Key> lru_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_BASE_CHUNK_CACHE_H_
@@ -0,0 +1,85 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/downsample/base_chunk_cache.h"
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::BoxView;
+using ::tensorstore::Index;
+using ::tensorstore::span;
+using ::tensorstore::internal_downsample::BaseChunkCache;
+
+TEST(BaseChunkCacheTest, EvictsWhenConsumed) {
+  BaseChunkCache cache(1024);
+  auto data = tensorstore::AllocateArray<uint8_t>(BoxView<>({4, 0}, {4, 4}));
+  cache.Put(span<const Index>({1, 0}), data, BoxView<>({4, 0}, {2, 4}));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(16, cache.total_bytes());
+  EXPECT_FALSE(
+      cache.Get(span<const Index>({0, 0}), BoxView<>({4, 0}, {2, 4})).valid());
+  auto result =
+      cache.Get(span<const Index>({1, 0}), BoxView<>({6, 0}, {1, 4}));
+  EXPECT_EQ(data.data(), result.data());
+  EXPECT_EQ(1, cache.size());
+  result = cache.Get(span<const Index>({1, 0}), BoxView<>({7, 0}, {1, 4}));
+  EXPECT_EQ(data.data(), result.data());
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.total_bytes());
+}
+
+TEST(BaseChunkCacheTest, FullyConsumedNotRetained) {
+  BaseChunkCache cache(1024);
+  auto data = tensorstore::AllocateArray<uint8_t>({4, 4});
+  cache.Put(span<const Index>({0, 0}), data, BoxView<>({4, 4}));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST(BaseChunkCacheTest, LeastRecentlyUsedEviction) {
+  BaseChunkCache cache(32);
+  auto data = tensorstore::AllocateArray<uint8_t>({4, 4});
+  cache.Put(span<const Index>({0, 0}), data, BoxView<>({1, 1}));
+  cache.Put(span<const Index>({0, 1}), data, BoxView<>({1, 1}));
+  // Makes cell {0, 0} the most recently used.
+  EXPECT_TRUE(
+      cache.Get(span<const Index>({0, 0}), BoxView<>({1, 1})).valid());
+  cache.Put(span<const Index>({0, 2}), data, BoxView<>({1, 1}));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(32, cache.total_bytes());
+  EXPECT_FALSE(
+      cache.Get(span<const Index>({0, 1}), BoxView<>({1, 1})).valid());
+  EXPECT_TRUE(
+      cache.Get(span<const Index>({0, 0}), BoxView<>({1, 1})).valid());
+  EXPECT_TRUE(
+      cache.Get(span<const Index>({0, 2}), BoxView<>({1, 1})).valid());
+}
+
+TEST(BaseChunkCacheTest, LargerThanLimitNotRetained) {
+  BaseChunkCache cache(8);
+  auto data = tensorstore::AllocateArray<uint8_t>({4, 4});
+  cache.Put(span<const Index>({0, 0}), data, BoxView<>({1, 1}));
+  EXPECT_EQ(0, cache.size());
+}
+
+}  // namespace
@@ -18,7 +18,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -26,8 +28,11 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
@@ -36,10 +41,12 @@
 #include "tensorstore/data_type.h"
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/downsample/base_chunk_cache.h"
 #include "tensorstore/driver/downsample/downsample_array.h"
 #include "tensorstore/driver/downsample/downsample_method_json_binder.h"  // IWYU pragma: keep
 #include "tensorstore/driver/downsample/downsample_nditerable.h"
 #include "tensorstore/driver/downsample/downsample_util.h"
+#include "tensorstore/driver/downsample/downsampled_chunk_cache.h"
 #include "tensorstore/driver/downsample/grid_occupancy_map.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
@@ -55,13 +62,21 @@
 #include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/arena.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/json_serialization_options.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
@@ -71,6 +86,7 @@
 #include "tensorstore/serialization/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/spec.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/execution/sender_util.h"
@@ -163,9 +179,20 @@ class DownsampleDriverSpec
   std::vector<Index> downsample_factors;
   DownsampleMethod downsample_method;
 
+  /// Enables chunk-aligned reads if non-zero.  See
+  /// `DownsampleDriver::base_chunk_cache_`.
+  size_t base_chunk_cache_bytes = 0;
+
+  /// Enables caching of computed downsampled chunks in `cache_pool`.  See
+  /// `DownsampleDriver::downsampled_chunk_cache_`.
+  bool cache_downsampled_chunks = false;
+  Context::Resource<internal::CachePoolResource> cache_pool;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x), x.base,
-             x.downsample_factors, x.downsample_method);
+             x.downsample_factors, x.downsample_method,
+             x.base_chunk_cache_bytes, x.cache_downsampled_chunks,
+             x.cache_pool);
   };
 
   absl::Status InitializeFromBase() {
@@ -240,6 +267,15 @@ class DownsampleDriverSpec
                 return obj->ValidateDownsampleMethod();
               },
               jb::Projection<&DownsampleDriverSpec::downsample_method>())),
+      jb::Member("base_chunk_cache_bytes",
+                 jb::Projection<&DownsampleDriverSpec::base_chunk_cache_bytes>(
+                     jb::DefaultInitializedValue())),
+      jb::Member(
+          "cache_downsampled_chunks",
+          jb::Projection<&DownsampleDriverSpec::cache_downsampled_chunks>(
+              jb::DefaultInitializedValue())),
+      jb::Member(internal::CachePoolResource::id,
+                 jb::Projection<&DownsampleDriverSpec::cache_pool>()),
       jb::Initialize([](auto* obj) {
         SpecOptions base_options;
         static_cast<Schema&>(base_options) = std::exchange(obj->schema, {});
@@ -325,8 +361,12 @@ class DownsampleDriverSpec
             -> Result<internal::Driver::Handle> {
           TENSORSTORE_ASSIGN_OR_RETURN(
               auto downsampled_handle,
-              MakeDownsampleDriver(std::move(handle), spec->downsample_factors,
-                                   spec->downsample_method));
+              MakeDownsampleDriver(
+                  std::move(handle), spec->downsample_factors,
+                  spec->downsample_method, spec->base_chunk_cache_bytes,
+                  spec->cache_downsampled_chunks
+                      ? spec->cache_pool
+                      : Context::Resource<internal::CachePoolResource>()));
           // Validate the domain constraint specified by the schema, if any.
           // All other schema constraints are propagated to the base driver, and
           // therefore aren't checked here.
@@ -357,6 +397,11 @@ class DownsampleDriver
         base_driver_->GetBoundSpec(std::move(transaction), base_transform_));
     driver_spec->downsample_factors = downsample_factors_;
     driver_spec->downsample_method = downsample_method_;
+    driver_spec->base_chunk_cache_bytes = base_chunk_cache_bytes_;
+    if (downsampled_chunk_cache_) {
+      driver_spec->cache_downsampled_chunks = true;
+      driver_spec->cache_pool = cache_pool_;
+    }
     TENSORSTORE_RETURN_IF_ERROR(driver_spec->InitializeFromBase());
     TransformedDriverSpec spec;
     spec.transform = transform;
@@ -432,12 +477,31 @@ class DownsampleDriver
 
   explicit DownsampleDriver(DriverPtr base, IndexTransform<> base_transform,
                             span<const Index> downsample_factors,
-                            DownsampleMethod downsample_method)
+                            DownsampleMethod downsample_method,
+                            size_t base_chunk_cache_bytes,
+                            Context::Resource<internal::CachePoolResource>
+                                cache_pool)
       : base_driver_(std::move(base)),
         base_transform_(std::move(base_transform)),
         downsample_factors_(downsample_factors.begin(),
                             downsample_factors.end()),
-        downsample_method_(downsample_method) {}
+        downsample_method_(downsample_method),
+        base_chunk_cache_bytes_(base_chunk_cache_bytes),
+        cache_pool_(std::move(cache_pool)) {
+    if (base_chunk_cache_bytes_ != 0) {
+      base_chunk_cache_ =
+          std::make_shared<BaseChunkCache>(base_chunk_cache_bytes_);
+    }
+    if (cache_pool_.has_resource()) {
+      // The cache is specific to this driver, since its entries are only
+      // meaningful for `base_driver_`, `downsample_factors_`, and
+      // `downsample_method_`, but its memory is accounted to `cache_pool_`.
+      downsampled_chunk_cache_ =
+          internal::GetCache<DownsampledChunkCache>(
+              cache_pool_->get(), "",
+              [] { return std::make_unique<DownsampledChunkCache>(); });
+    }
+  }
 
   DataType dtype() override { return base_driver_->dtype(); }
   DimensionIndex rank() override { return base_transform_.input_rank(); }
@@ -465,6 +529,33 @@ class DownsampleDriver
   IndexTransform<> base_transform_;
   std::vector<Index> downsample_factors_;
   DownsampleMethod downsample_method_;
+  size_t base_chunk_cache_bytes_;
+
+  /// Partially-consumed base chunks retained for neighbouring reads in
+  /// chunk-aligned read mode, or `nullptr` if chunk-aligned reads are
+  /// disabled.
+  ///
+  /// In chunk-aligned mode, reads of a box-shaped downsampled region outside
+  /// of a transaction are expanded to whole base chunks, such that adjacent
+  /// downsampled reads that straddle the same base chunk read and decode it
+  /// only once.  The cached data is not invalidated by subsequent writes to
+  /// the base TensorStore, so this mode is only suitable for base data that
+  /// is not modified while the downsampled view is in use.
+  std::shared_ptr<BaseChunkCache> base_chunk_cache_;
+
+  Context::Resource<internal::CachePoolResource> cache_pool_;
+
+  /// Computed downsampled chunks, or `nullptr` if caching of downsampled
+  /// chunks is disabled.
+  ///
+  /// When enabled, reads outside of a transaction of a base TensorStore that
+  /// supports `Driver::GetEncodedChunkStorage`, through an identity
+  /// `base_transform_`, are partitioned over a regular grid of downsampled
+  /// cells, each corresponding to a whole number of base chunks where
+  /// possible.  A cached cell is reused if the storage generations of the base
+  /// chunks from which it was computed are unchanged; otherwise it is
+  /// recomputed from the base TensorStore.
+  internal::CachePtr<DownsampledChunkCache> downsampled_chunk_cache_;
 };
 
 Future<IndexTransform<>> DownsampleDriver::ResolveBounds(
@@ -696,6 +787,12 @@ struct BufferedReadChunkImpl {
         propagated.input_downsample_factors, state_->self_->downsample_method_,
         chunk_transform.input_rank(), arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      internal::ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    // The downsampled data is computed on demand.
+    return absl::UnimplementedError("");
+  }
 };
 
 /// Returns an identity transform from `base_domain.rank()` to `request_rank`,
@@ -812,6 +909,11 @@ struct IndependentReadChunkImpl {
         propagated.input_downsample_factors, state_->self_->downsample_method_,
         chunk_transform.input_rank(), arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      internal::ReadChunk::GetArray, IndexTransform<> chunk_transform) {
+    return absl::UnimplementedError("");
+  }
 };
 
 /// Attempts to emit a `ReadChunk` from the base driver independently.
@@ -962,6 +1064,481 @@ struct ReadReceiverImpl {
   }
 };
 
+/// Returns `true` if `transform` is an identity transform over its domain.
+bool IsIdentityOverDomain(IndexTransformView<> transform) {
+  if (transform.input_rank() != transform.output_rank()) return false;
+  for (DimensionIndex i = 0; i < transform.output_rank(); ++i) {
+    const auto map = transform.output_index_maps()[i];
+    if (map.method() != OutputIndexMethod::single_input_dimension ||
+        map.input_dimension() != i || map.stride() != 1 ||
+        map.offset() != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Base chunk required by a chunk-aligned read.
+struct ChunkAlignedReadCell {
+  /// Grid cell indices of the base chunk.
+  std::vector<Index> cell;
+
+  /// Portion of the base chunk required by the read.
+  Box<> consumed;
+
+  /// Data for the entire base chunk.  Null until the read completes, unless
+  /// the data was cached.
+  SharedOffsetArray<const void> data;
+};
+
+/// Completes a chunk-aligned read once the data for all `cells` is available,
+/// by assembling the required region into `state.data_buffer_` and emitting it
+/// as a single chunk.
+void CompleteChunkAlignedRead(ReadState& state,
+                              span<const ChunkAlignedReadCell> cells) {
+  {
+    std::lock_guard<ReadState> guard(state);
+    if (state.canceled_) return;
+    ++state.chunks_in_progress_;
+  }
+  auto data_buffer =
+      AllocateArray(state.base_transform_domain_.box(), c_order, default_init,
+                    state.self_->base_driver_->dtype());
+  for (const auto& cell : cells) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        CopyTransformedArray(
+            cell.data | tensorstore::AllDims().BoxSlice(cell.consumed),
+            data_buffer | tensorstore::AllDims().BoxSlice(cell.consumed)),
+        state.SetError(_, 1));
+  }
+  {
+    absl::MutexLock lock(&state.mutex_);
+    state.data_buffer_ = std::move(data_buffer);
+  }
+  state.EmitBufferedChunkForBox(state.base_transform_domain_.box());
+  std::lock_guard<ReadState> guard(state);
+  --state.chunks_in_progress_;
+  state.done_signal_received_ = true;
+}
+
+/// Attempts to perform a read in chunk-aligned mode, as described for
+/// `DownsampleDriver::base_chunk_cache_`.
+///
+/// This only applies to reads of a box-shaped region of the downsampled domain
+/// outside of a transaction.  Returns `false` if not applicable, in which case
+/// the caller must perform a regular read instead.
+bool MaybeStartChunkAlignedRead(internal::IntrusivePtr<ReadState>& state,
+                                internal::Driver::ReadRequest& request,
+                                IndexTransformView<> base_transform) {
+  auto& self = *state->self_;
+  if (!self.base_chunk_cache_ || request.transaction) return false;
+  PropagatedIndexTransformDownsampling propagated;
+  if (!internal_downsample::PropagateIndexTransformDownsampling(
+           request.transform, base_transform.domain().box(),
+           self.downsample_factors_, propagated)
+           .ok() ||
+      !IsIdentityOverDomain(propagated.transform)) {
+    return false;
+  }
+  const BoxView<> request_domain = propagated.transform.domain().box();
+  const BoxView<> base_domain = base_transform.domain().box();
+  if (request_domain.is_empty()) return false;
+  auto chunk_layout = self.base_driver_->GetChunkLayout(base_transform);
+  if (!chunk_layout.ok()) return false;
+  const DimensionIndex rank = request_domain.rank();
+  auto read_chunk_shape = chunk_layout->read_chunk_shape();
+  auto grid_origin = chunk_layout->grid_origin();
+  if (read_chunk_shape.size() != rank) return false;
+
+  // Compute the bounds of the grid cells intersecting `request_domain`.
+  // Dimensions without a chunk shape are treated as a single cell.
+  std::vector<Index> origin(rank), cell_shape(rank), cell_min(rank),
+      cell_max(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    cell_shape[i] = read_chunk_shape[i];
+    if (cell_shape[i] <= 0) {
+      if (!IsFinite(base_domain[i])) return false;
+      origin[i] = base_domain[i].inclusive_min();
+      cell_shape[i] = base_domain[i].size();
+    } else {
+      origin[i] = grid_origin.size() == rank && grid_origin[i] != kImplicit
+                      ? grid_origin[i]
+                      : 0;
+    }
+    cell_min[i] = FloorOfRatio(request_domain[i].inclusive_min() - origin[i],
+                               cell_shape[i]);
+    cell_max[i] = FloorOfRatio(request_domain[i].inclusive_max() - origin[i],
+                               cell_shape[i]) +
+                  1;
+  }
+
+  internal::Driver::Handle base_handle;
+  base_handle.driver = self.base_driver_;
+  base_handle.driver.set_read_write_mode(ReadWriteMode::read);
+
+  std::vector<ChunkAlignedReadCell> cells;
+  std::vector<Future<SharedOffsetArray<void>>> pending_reads;
+  std::vector<size_t> pending_cells;
+  std::vector<Index> cell = cell_min;
+  do {
+    Box<> cell_domain(rank);
+    ChunkAlignedReadCell read_cell{cell, Box<>(rank), {}};
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      cell_domain[i] = Intersect(
+          IndexInterval::UncheckedSized(origin[i] + cell[i] * cell_shape[i],
+                                        cell_shape[i]),
+          base_domain[i]);
+      read_cell.consumed[i] = Intersect(cell_domain[i], request_domain[i]);
+    }
+    read_cell.data = self.base_chunk_cache_->Get(cell, read_cell.consumed);
+    if (!read_cell.data.valid()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          base_handle.transform,
+          base_transform | tensorstore::AllDims().BoxSlice(cell_domain),
+          false);
+      pending_cells.push_back(cells.size());
+      ReadIntoNewArrayOptions read_options;
+      read_options.batch = request.batch;
+      pending_reads.push_back(internal::DriverReadIntoNewArray(
+          base_handle, std::move(read_options)));
+    }
+    cells.push_back(std::move(read_cell));
+  } while (internal::AdvanceIndices(rank, cell.data(), cell_min.data(),
+                                    cell_max.data()));
+
+  state->remaining_elements_ = 0;
+  state->downsample_factors_ = std::move(propagated.input_downsample_factors);
+  state->base_transform_domain_ = propagated.transform.domain();
+  WaitAllFuture(span(pending_reads))
+      .ExecuteWhenReady([state = std::move(state), cells = std::move(cells),
+                         pending_cells = std::move(pending_cells),
+                         pending_reads = std::move(pending_reads)](
+                            ReadyFuture<void> future) mutable {
+        if (!future.result().ok()) {
+          state->SetError(future.result().status());
+          return;
+        }
+        auto& cache = *state->self_->base_chunk_cache_;
+        for (size_t i = 0; i < pending_cells.size(); ++i) {
+          auto& read_cell = cells[pending_cells[i]];
+          read_cell.data = pending_reads[i].value();
+          cache.Put(read_cell.cell, read_cell.data, read_cell.consumed);
+        }
+        auto* state_ptr = state.get();
+        state_ptr->self_->data_copy_executor()(
+            [state = std::move(state), cells = std::move(cells)] {
+              CompleteChunkAlignedRead(*state, cells);
+            });
+      });
+  return true;
+}
+
+/// Starts a read that is not satisfied from
+/// `DownsampleDriver::downsampled_chunk_cache_`.
+void StartUncachedRead(internal::IntrusivePtr<ReadState> state,
+                       internal::Driver::ReadRequest request,
+                       IndexTransformView<> base_transform) {
+  if (MaybeStartChunkAlignedRead(state, request, base_transform)) {
+    return;
+  }
+  PropagatedIndexTransformDownsampling propagated;
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_downsample::PropagateAndComposeIndexTransformDownsampling(
+          request.transform, base_transform, state->self_->downsample_factors_,
+          propagated),
+      state->SetError(_));
+  // The domain of `propagated.transform`, when downsampled by
+  // `propagated.input_downsample_factors`, matches `transform.domain()`.
+
+  // Compute the read request for `base_driver_`.
+  state->remaining_elements_ = propagated.transform.domain().num_elements();
+  state->downsample_factors_ = std::move(propagated.input_downsample_factors);
+  state->base_transform_domain_ = propagated.transform.domain();
+  auto* state_ptr = state.get();
+  request.transform = std::move(propagated.transform);
+  state_ptr->self_->base_driver_->Read(std::move(request),
+                                       ReadReceiverImpl{std::move(state)});
+}
+
+/// Implementation of the `internal::ReadChunk::Impl` Poly interface that
+/// provides a view of a cached downsampled chunk.
+struct CachedReadChunkImpl {
+  SharedOffsetArray<const void> data_;
+
+  absl::Status operator()(LockCollection& lock_collection) const {
+    // No locks required, since cached chunks are immutable.
+    return absl::OkStatus();
+  }
+
+  Result<NDIterable::Ptr> operator()(internal::ReadChunk::BeginRead,
+                                     IndexTransform<> chunk_transform,
+                                     internal::Arena* arena) const {
+    return internal::GetTransformedArrayNDIterable(data_, chunk_transform,
+                                                   arena);
+  }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      internal::ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    return MakeTransformedArray(data_, std::move(chunk_transform));
+  }
+};
+
+/// Returns the downsampled data for the grid cell of `entry` with the
+/// specified `bounds` in the downsampled domain, reusing the cached data if the
+/// base chunks from which it was computed are unchanged.
+///
+/// \param base_transform Identity transform over the resolved base domain.
+Future<SharedOffsetArray<const void>> GetDownsampledCell(
+    IntrusivePtr<DownsampleDriver> self,
+    const internal::Driver::EncodedChunkStorage& storage,
+    IndexTransformView<> base_transform,
+    internal::PinnedCacheEntry<DownsampledChunkCache> entry, BoxView<> bounds,
+    const Batch& batch) {
+  using ChunkState = DownsampledChunkCache::ChunkState;
+  auto cached = entry->GetState();
+  if (cached && cached->data.domain() != bounds) cached = nullptr;
+  if (cached && cached->time >= storage.staleness_bound) {
+    return cached->data;
+  }
+
+  // Determine the base chunks from which the cell is computed.
+  const DimensionIndex rank = bounds.rank();
+  const BoxView<> base_domain = base_transform.domain().box();
+  Box<> base_box(rank);
+  std::vector<Index> chunk_min(rank), chunk_max(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const Index factor = self->downsample_factors_[i];
+    base_box[i] = Intersect(
+        IndexInterval::UncheckedHalfOpen(bounds[i].inclusive_min() * factor,
+                                         bounds[i].exclusive_max() * factor),
+        base_domain[i]);
+    chunk_min[i] =
+        FloorOfRatio(base_box[i].inclusive_min(), storage.chunk_shape[i]);
+    chunk_max[i] =
+        FloorOfRatio(base_box[i].inclusive_max(), storage.chunk_shape[i]) + 1;
+  }
+  std::vector<std::string> base_keys;
+  std::vector<Index> chunk = chunk_min;
+  do {
+    base_keys.push_back(storage.get_chunk_key(chunk));
+  } while (internal::AdvanceIndices(rank, chunk.data(), chunk_min.data(),
+                                    chunk_max.data()));
+  if (cached && cached->base_keys != base_keys) cached = nullptr;
+
+  // Read the current generation of each base chunk, without its value.  If
+  // `cached` is still valid, the reads are conditioned on the generations
+  // having changed.
+  const absl::Time time = absl::Now();
+  std::vector<Future<kvstore::ReadResult>> generation_reads;
+  for (size_t i = 0; i < base_keys.size(); ++i) {
+    kvstore::ReadOptions options;
+    options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+    options.staleness_bound = storage.staleness_bound;
+    options.batch = batch;
+    if (cached) {
+      options.generation_conditions.if_not_equal = cached->base_generations[i];
+    }
+    generation_reads.push_back(
+        storage.kvstore->Read(base_keys[i], std::move(options)));
+  }
+  auto all_generations_read = WaitAllFuture(span(generation_reads));
+
+  // Note that `batch` must not be retained by the callbacks, since the
+  // generation reads may not be issued until it is released.
+  auto [promise, future] =
+      PromiseFuturePair<SharedOffsetArray<const void>>::Make();
+  LinkValue(
+      [self = std::move(self),
+       base_transform = IndexTransform<>(base_transform),
+       entry = std::move(entry), cached = std::move(cached),
+       base_keys = std::move(base_keys),
+       generation_reads = std::move(generation_reads), base_box, time](
+          Promise<SharedOffsetArray<const void>> promise,
+          ReadyFuture<void> future) mutable {
+        auto new_state = std::make_shared<ChunkState>();
+        new_state->time = time;
+        new_state->base_generations.resize(base_keys.size());
+        bool unchanged = static_cast<bool>(cached);
+        for (size_t i = 0; i < base_keys.size(); ++i) {
+          auto& read_result = generation_reads[i].value();
+          if (read_result.aborted()) {
+            new_state->base_generations[i] = cached->base_generations[i];
+          } else {
+            unchanged = false;
+            new_state->base_generations[i] =
+                std::move(read_result.stamp.generation);
+          }
+        }
+        new_state->base_keys = std::move(base_keys);
+        if (unchanged) {
+          new_state->data = cached->data;
+          promise.SetResult(new_state->data);
+          entry->SetState(std::move(new_state));
+          return;
+        }
+
+        // Recompute the cell from the base TensorStore.  The base data is
+        // read after the generations, such that it is at least as new.
+        internal::Driver::Handle base_handle;
+        base_handle.driver = self->base_driver_;
+        base_handle.driver.set_read_write_mode(ReadWriteMode::read);
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            base_handle.transform,
+            base_transform | tensorstore::AllDims().BoxSlice(base_box),
+            static_cast<void>(promise.SetResult(_)));
+        auto base_read = internal::DriverReadIntoNewArray(base_handle, {});
+        auto executor = self->data_copy_executor();
+        LinkValue(
+            WithExecutor(
+                std::move(executor),
+                [self = std::move(self), entry = std::move(entry),
+                 new_state = std::move(new_state)](
+                    Promise<SharedOffsetArray<const void>> promise,
+                    ReadyFuture<SharedOffsetArray<void>> future) mutable {
+                  TENSORSTORE_ASSIGN_OR_RETURN(
+                      auto downsampled,
+                      internal_downsample::DownsampleArray(
+                          future.value(), self->downsample_factors_,
+                          self->downsample_method_),
+                      static_cast<void>(promise.SetResult(_)));
+                  new_state->data = std::move(downsampled);
+                  promise.SetResult(new_state->data);
+                  entry->SetState(std::move(new_state));
+                }),
+            std::move(promise), std::move(base_read));
+      },
+      std::move(promise), std::move(all_generations_read));
+  return std::move(future);
+}
+
+/// Grid cell of `DownsampleDriver::downsampled_chunk_cache_` required by a
+/// cached read.
+struct CachedReadCell {
+  /// Transform from the cell domain to the domain of the read request, as
+  /// computed by `PartitionIndexTransformOverRegularGrid`.
+  IndexTransform<> cell_transform;
+
+  Future<SharedOffsetArray<const void>> data;
+};
+
+/// Performs a read using `DownsampleDriver::downsampled_chunk_cache_`, once the
+/// `storage` of the base chunks has been determined.
+void StartCachedRead(internal::IntrusivePtr<ReadState> state,
+                     internal::Driver::ReadRequest request,
+                     IndexTransformView<> base_transform,
+                     const internal::Driver::EncodedChunkStorage& storage) {
+  auto& self = *state->self_;
+  const DimensionIndex rank = base_transform.input_rank();
+  Box<> downsampled_bounds(rank);
+  internal_downsample::DownsampleBounds(base_transform.domain().box(),
+                                        downsampled_bounds,
+                                        self.downsample_factors_,
+                                        self.downsample_method_);
+
+  // Each downsampled cell corresponds to a whole number of base chunks, if the
+  // chunk shape is divisible by the downsample factors.
+  std::vector<DimensionIndex> grid_dims(rank);
+  std::vector<Index> cell_shape(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    grid_dims[i] = i;
+    cell_shape[i] = std::max(
+        Index(1), storage.chunk_shape[i] / self.downsample_factors_[i]);
+  }
+  std::vector<CachedReadCell> cells;
+  Box<> cell_bounds(rank);
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::PartitionIndexTransformOverRegularGrid(
+          grid_dims, cell_shape, request.transform,
+          [&](span<const Index> grid_cell_indices,
+              IndexTransformView<> cell_transform) {
+            for (DimensionIndex i = 0; i < rank; ++i) {
+              cell_bounds[i] = Intersect(
+                  IndexInterval::UncheckedSized(
+                      grid_cell_indices[i] * cell_shape[i], cell_shape[i]),
+                  downsampled_bounds[i]);
+            }
+            cells.push_back(CachedReadCell{
+                IndexTransform<>(cell_transform),
+                GetDownsampledCell(
+                    state->self_, storage, base_transform,
+                    internal::GetEntryForGridCell(
+                        *self.downsampled_chunk_cache_, grid_cell_indices),
+                    cell_bounds, request.batch)});
+            return absl::OkStatus();
+          }),
+      state->SetError(_));
+  std::vector<Future<SharedOffsetArray<const void>>> cell_futures;
+  for (const auto& cell : cells) cell_futures.push_back(cell.data);
+  WaitAllFuture(span(cell_futures))
+      .ExecuteWhenReady([state = std::move(state), cells = std::move(cells),
+                         transform = std::move(request.transform)](
+                            ReadyFuture<void> future) {
+        if (!future.result().ok()) {
+          state->SetError(future.result().status());
+          return;
+        }
+        {
+          std::lock_guard<ReadState> guard(*state);
+          if (state->canceled_) {
+            state->done_signal_received_ = true;
+            return;
+          }
+          ++state->chunks_in_progress_;
+        }
+        for (const auto& cell : cells) {
+          ReadChunk chunk;
+          chunk.impl = CachedReadChunkImpl{cell.data.value()};
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              chunk.transform,
+              ComposeTransforms(transform, cell.cell_transform),
+              state->SetError(_, 1));
+          execution::set_value(state->receiver_, std::move(chunk),
+                               cell.cell_transform);
+        }
+        std::lock_guard<ReadState> guard(*state);
+        --state->chunks_in_progress_;
+        state->done_signal_received_ = true;
+      });
+}
+
+/// Attempts to perform a read using
+/// `DownsampleDriver::downsampled_chunk_cache_`.
+///
+/// Returns `false` if not applicable, in which case the caller must perform an
+/// uncached read instead.  If the base driver does not support
+/// `GetEncodedChunkStorage`, falls back to an uncached read asynchronously.
+bool MaybeStartCachedRead(internal::IntrusivePtr<ReadState>& state,
+                          internal::Driver::ReadRequest& request,
+                          IndexTransformView<> base_transform) {
+  auto& self = *state->self_;
+  if (!self.downsampled_chunk_cache_ || request.transaction ||
+      !IsIdentityOverDomain(base_transform)) {
+    return false;
+  }
+  const BoxView<> base_domain = base_transform.domain().box();
+  for (DimensionIndex i = 0; i < base_domain.rank(); ++i) {
+    if (!IsFinite(base_domain[i])) return false;
+  }
+  self.base_driver_->GetEncodedChunkStorage().ExecuteWhenReady(
+      [state = std::move(state), request = std::move(request),
+       base_transform = IndexTransform<>(base_transform)](
+          ReadyFuture<internal::Driver::EncodedChunkStorage> future) mutable {
+        auto& r = future.result();
+        if (!r.ok() ||
+            r->chunk_shape.size() != base_transform.input_rank() ||
+            std::any_of(r->chunk_shape.begin(), r->chunk_shape.end(),
+                        [](Index size) { return size <= 0; }) ||
+            !Contains(r->bounds, base_transform.domain().box())) {
+          StartUncachedRead(std::move(state), std::move(request),
+                            base_transform);
+          return;
+        }
+        StartCachedRead(std::move(state), std::move(request), base_transform,
+                        *r);
+      });
+  return true;
+}
+
 void DownsampleDriver::Read(
     ReadRequest request,
     AnyFlowReceiver<absl::Status, ReadChunk, IndexTransform<>> receiver) {
@@ -992,26 +1569,11 @@ void DownsampleDriver::Read(
           return;
         }
         IndexTransform<> base_transform = std::move(*r);
-        PropagatedIndexTransformDownsampling propagated;
-        TENSORSTORE_RETURN_IF_ERROR(
-            internal_downsample::PropagateAndComposeIndexTransformDownsampling(
-                request.transform, base_transform,
-                state->self_->downsample_factors_, propagated),
-            state->SetError(_));
-        // The domain of `propagated.transform`, when downsampled by
-        // `propagated.input_downsample_factors`, matches
-        // `transform.domain()`.
-
-        // Compute the read request for `base_driver_`.
-        state->remaining_elements_ =
-            propagated.transform.domain().num_elements();
-        state->downsample_factors_ =
-            std::move(propagated.input_downsample_factors);
-        state->base_transform_domain_ = propagated.transform.domain();
-        auto* state_ptr = state.get();
-        request.transform = std::move(propagated.transform);
-        state_ptr->self_->base_driver_->Read(
-            std::move(request), ReadReceiverImpl{std::move(state)});
+        if (MaybeStartCachedRead(state, request, base_transform)) {
+          return;
+        }
+        StartUncachedRead(std::move(state), std::move(request),
+                          base_transform);
       });
 }
 
@@ -1065,7 +1627,8 @@ namespace internal {
 
 Result<Driver::Handle> MakeDownsampleDriver(
     Driver::Handle base, span<const Index> downsample_factors,
-    DownsampleMethod downsample_method) {
+    DownsampleMethod downsample_method, size_t base_chunk_cache_bytes,
+    Context::Resource<CachePoolResource> downsampled_chunk_cache_pool) {
   if (downsample_factors.size() != base.transform.input_rank()) {
     return absl::InvalidArgumentError(tensorstore::StrCat(
         "Number of downsample factors (", downsample_factors.size(),
@@ -1089,7 +1652,8 @@ Result<Driver::Handle> MakeDownsampleDriver(
   base.driver =
       internal::MakeReadWritePtr<internal_downsample::DownsampleDriver>(
           ReadWriteMode::read, std::move(base.driver),
-          std::move(base.transform), downsample_factors, downsample_method);
+          std::move(base.transform), downsample_factors, downsample_method,
+          base_chunk_cache_bytes, std::move(downsampled_chunk_cache_pool));
   base.transform = std::move(downsampled_domain);
   return base;
 }
@@ -15,17 +15,29 @@
 #ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_H_
 #define TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLE_H_
 
+#include <stddef.h>
+
+#include "tensorstore/context.h"
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/driver/driver.h"
+#include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
 
+/// Returns a read-only downsampled view of `base`.
+///
+/// \param base_chunk_cache_bytes If non-zero, enables chunk-aligned reads of
+///     `base`, retaining up to the specified number of bytes of
+///     partially-consumed base chunks for use by neighbouring reads.
+/// \param downsampled_chunk_cache_pool If it has a resource, enables caching
+///     of computed downsampled chunks in the specified cache pool.
 Result<Driver::Handle> MakeDownsampleDriver(
     Driver::Handle base, span<const Index> downsample_factors,
-    DownsampleMethod downsample_method);
+    DownsampleMethod downsample_method, size_t base_chunk_cache_bytes = 0,
+    Context::Resource<CachePoolResource> downsampled_chunk_cache_pool = {});
 
 }  // namespace internal
 }  // namespace tensorstore
@@ -16,17 +16,21 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
 #include "tensorstore/array_testutil.h"
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/downsample_method.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace {
 
@@ -340,6 +344,36 @@ TEST(DownsampleArrayTest, ModeRank1Partial) {
               Optional(MakeArray<float>({99, 3})));
 }
 
+TEST(DownsampleArrayTest, ModeUint64TieBreak) {
+  // Ties are broken in favor of the smallest value.
+  EXPECT_THAT(
+      DownsampleArray(MakeArray<uint64_t>({7, 5, 7, 5, 9, 9, 9, 1, 4, 4, 4, 4}),
+                      span<const Index>({4}), DownsampleMethod::kMode),
+      Optional(MakeArray<uint64_t>({5, 9, 4})));
+}
+
+TEST(DownsampleArrayTest, ModeUint64Rank3) {
+  EXPECT_THAT(DownsampleArray(MakeArray<uint64_t>({{{3, 3}, {8, 3}},  //
+                                                   {{8, 8}, {2, 8}}}),
+                              span<const Index>({2, 2, 2}),
+                              DownsampleMethod::kMode),
+              Optional(MakeArray<uint64_t>({{{8}}})));
+}
+
+// Tests blocks larger than those handled by the small block algorithms.
+TEST(DownsampleArrayTest, MedianAndModeLargeBlock) {
+  auto source_array = tensorstore::AllocateArray<int>({40});
+  for (int i = 0; i < 40; ++i) {
+    source_array(i) = (i % 3 == 0) ? 1000 : 39 - i;
+  }
+  EXPECT_THAT(DownsampleArray(source_array, span<const Index>({40}),
+                              DownsampleMethod::kMedian),
+              Optional(MakeArray<int>({29})));
+  EXPECT_THAT(DownsampleArray(source_array, span<const Index>({40}),
+                              DownsampleMethod::kMode),
+              Optional(MakeArray<int>({1000})));
+}
+
 TEST(DownsampleArrayTest, ModeBool) {
   EXPECT_THAT(DownsampleArray(MakeArray<bool>({0, 0, 1, 1}),
                               span<const Index>({4}), DownsampleMethod::kMode),
@@ -407,4 +441,49 @@ TEST(DownsampleArrayTest, MultipleBlocks) {
               Optional(tensorstore::MatchesArray(expected_downsampled)));
 }
 
+// Tests that the contiguous fast path used for inner downsample factors of 1
+// and 2 matches the generic path used for a strided inner dimension, including
+// partial blocks at both ends.
+template <typename T>
+void TestContiguousMatchesStrided(DownsampleMethod method,
+                                  span<const Index> downsample_factors) {
+  SCOPED_TRACE(tensorstore::StrCat("dtype=", tensorstore::dtype_v<T>,
+                                   ", method=", method, ", downsample_factors=",
+                                   downsample_factors));
+  auto source = tensorstore::AllocateArray<T>(
+      tensorstore::BoxView<>({1, 0, 1}, {3, 5, 9}));
+  auto wide = tensorstore::AllocateArray<T>({3, 5, 18});
+  for (Index i = 0; i < 3; ++i) {
+    for (Index j = 0; j < 5; ++j) {
+      for (Index k = 0; k < 9; ++k) {
+        const T value = static_cast<T>((i * 37 + j * 11 + k * 5) % 251);
+        source(i + 1, j, k + 1) = value;
+        wide(i, j, 2 * k) = value;
+      }
+    }
+  }
+  auto strided_source =
+      wide | Dims(2).Stride(2) | tensorstore::AllDims().TranslateTo({1, 0, 1});
+  ASSERT_TRUE(strided_source.ok()) << strided_source.status();
+  auto expected =
+      DownsampleTransformedArray(*strided_source, downsample_factors, method);
+  ASSERT_TRUE(expected.ok()) << expected.status();
+  EXPECT_THAT(DownsampleArray(source, downsample_factors, method),
+              Optional(tensorstore::MatchesArray(*expected)));
+}
+
+TEST(DownsampleArrayTest, ContiguousMatchesStrided) {
+  for (const DownsampleMethod method :
+       {DownsampleMethod::kMean, DownsampleMethod::kMin,
+        DownsampleMethod::kMax}) {
+    for (const auto& downsample_factors :
+         {std::vector<Index>{2, 2, 1}, std::vector<Index>{2, 2, 2},
+          std::vector<Index>{1, 1, 2}}) {
+      TestContiguousMatchesStrided<uint8_t>(method, downsample_factors);
+      TestContiguousMatchesStrided<uint16_t>(method, downsample_factors);
+      TestContiguousMatchesStrided<float>(method, downsample_factors);
+    }
+  }
+}
+
 }  // namespace
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdint.h>
+
 #include <vector>
 
 #include <benchmark/benchmark.h>
@@ -26,6 +28,7 @@
 #include "tensorstore/index.h"
 #include "tensorstore/internal/data_type_random_generator.h"
 #include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/strided_layout.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace {
@@ -36,6 +39,7 @@ using ::tensorstore::DataType;
 using ::tensorstore::DimensionIndex;
 using ::tensorstore::DownsampleMethod;
 using ::tensorstore::Index;
+using ::tensorstore::span;
 using ::tensorstore::internal_downsample::DownsampleArray;
 using ::tensorstore::internal_downsample::DownsampleBounds;
 
@@ -66,6 +70,74 @@ void BenchmarkDownsample(::benchmark::State& state, DataType dtype,
   state.SetItemsProcessed(total_elements);
 }
 
+// Benchmarks the common image pyramid case of a large block with per-dimension
+// `downsample_factors`.  If `strided_source` is `true`, the source array has a
+// non-contiguous inner dimension, which forces the generic (non-vectorized)
+// accumulation loop and serves as a baseline for the contiguous case.
+void BenchmarkDownsampleFactors(::benchmark::State& state, DataType dtype,
+                                DownsampleMethod downsample_method,
+                                span<const Index> downsample_factors,
+                                Index block_size, bool strided_source) {
+  const DimensionIndex rank = downsample_factors.size();
+  std::vector<Index> block_shape(rank, block_size);
+  std::vector<Index> allocated_shape = block_shape;
+  if (strided_source) allocated_shape[rank - 1] *= 2;
+  absl::BitGen gen;
+  auto allocated_array = tensorstore::internal::MakeRandomArray(
+      gen, BoxView<>(allocated_shape), dtype);
+  std::vector<Index> byte_strides(allocated_array.byte_strides().begin(),
+                                  allocated_array.byte_strides().end());
+  if (strided_source) byte_strides[rank - 1] *= 2;
+  tensorstore::SharedArray<const void> base_array(
+      allocated_array.element_pointer(),
+      tensorstore::StridedLayout<>(block_shape, byte_strides));
+  BoxView<> base_domain(block_shape);
+  Box<> downsampled_domain(rank);
+  DownsampleBounds(base_domain, downsampled_domain, downsample_factors,
+                   downsample_method);
+  auto downsampled_array =
+      tensorstore::AllocateArray(downsampled_domain, tensorstore::c_order,
+                                 tensorstore::default_init, dtype);
+  const Index num_elements = base_domain.num_elements();
+  Index total_elements = 0;
+  while (state.KeepRunningBatch(num_elements)) {
+    ABSL_CHECK(DownsampleArray(base_array, downsampled_array,
+                               downsample_factors, downsample_method)
+                   .ok());
+    total_elements += num_elements;
+  }
+  state.SetItemsProcessed(total_elements);
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  const DataType dtypes[] = {tensorstore::dtype_v<uint8_t>,
+                             tensorstore::dtype_v<uint16_t>,
+                             tensorstore::dtype_v<float>};
+  for (const DataType dtype : dtypes) {
+    for (const DownsampleMethod downsample_method :
+         {DownsampleMethod::kMean, DownsampleMethod::kMin,
+          DownsampleMethod::kMax}) {
+      for (const auto& downsample_factors :
+           {std::vector<Index>{1, 2, 2}, std::vector<Index>{2, 2, 2}}) {
+        for (const bool strided_source : {false, true}) {
+          ::benchmark::RegisterBenchmark(
+              tensorstore::StrCat(
+                  "DownsampleArrayFactors_", dtype, "_", downsample_method,
+                  "_Factors", downsample_factors[0], "x", downsample_factors[1],
+                  "x", downsample_factors[2],
+                  strided_source ? "_Strided" : "_Contiguous")
+                  .c_str(),
+              [=](auto& state) {
+                BenchmarkDownsampleFactors(state, dtype, downsample_method,
+                                           downsample_factors,
+                                           /*block_size=*/128, strided_source);
+              });
+        }
+      }
+    }
+  }
+}
+
 TENSORSTORE_GLOBAL_INITIALIZER {
   for (const DataType dtype : tensorstore::kDataTypes) {
     for (const DownsampleMethod downsample_method :
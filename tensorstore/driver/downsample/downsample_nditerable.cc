@@ -423,11 +423,54 @@ struct StoreReductionTraitsBase {
   }
 };
 
+/// Maximum number of input elements per output element for which the median
+/// and mode are computed by the quadratic-time counting algorithms below rather
+/// than by `std::nth_element` or `std::sort`.
+///
+/// This covers the common 2x2x2 (8 elements) and 3x3x3 (27 elements) downsample
+/// blocks.  For such small blocks, the branch-free inner counting loops, which
+/// the compiler can vectorize, are faster than the data-dependent branching of
+/// the general algorithms.
+constexpr ptrdiff_t kSmallBlockMaxElements = 32;
+
+/// Selects the element of `input` with rank `k` (i.e. the element that would
+/// be at position `k` after sorting) by counting, for each candidate, the
+/// number of smaller and equal elements.
+///
+/// \returns `true` on success, or `false` if the ordering over `input` is not
+///     a strict weak ordering (i.e. `input` contains NaN values), in which case
+///     `output` is not modified.
+template <typename Element>
+bool SelectSmallBlockByCounting(Element& output, span<const Element> input,
+                                ptrdiff_t k) {
+  const ptrdiff_t n = input.size();
+  for (ptrdiff_t i = 0; i < n; ++i) {
+    const Element value = input[i];
+    ptrdiff_t num_less = 0, num_less_equal = 0;
+    for (ptrdiff_t j = 0; j < n; ++j) {
+      num_less += (input[j] < value);
+      num_less_equal += (input[j] <= value);
+    }
+    if (num_less <= k && k < num_less_equal) {
+      output = value;
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename Element>
 struct ReductionTraits<DownsampleMethod::kMedian, Element,
                        std::enable_if_t<IsOrderingSupported<Element>::value>>
     : public StoreReductionTraitsBase<DownsampleMethod::kMedian, Element> {
   static void ComputeOutput(Element& output, span<Element> input) {
+    if constexpr (std::is_arithmetic_v<Element>) {
+      if (input.size() <= kSmallBlockMaxElements &&
+          SelectSmallBlockByCounting<Element>(output, input,
+                                              (input.size() - 1) / 2)) {
+        return;
+      }
+    }
     auto median_it = input.begin() + (input.size() - 1) / 2;
     std::nth_element(input.begin(), median_it, input.end());
     output = *median_it;
@@ -449,10 +492,43 @@ struct CompareForMode<std::complex<T>> {
   }
 };
 
+/// Computes the mode of a small block of integer values without sorting or
+/// hashing, by counting the occurrences of each candidate value.
+///
+/// As with the sort-based algorithm, ties are broken in favor of the smallest
+/// value.  A value that occurs in more than half of the positions is
+/// necessarily the mode, which allows uniform blocks (common for segmentation
+/// labels) to be handled in a single pass.
+template <typename Element>
+Element ComputeSmallBlockIntegerMode(span<const Element> input) {
+  const ptrdiff_t n = input.size();
+  Element mode = input[0];
+  ptrdiff_t mode_count = 0;
+  for (ptrdiff_t i = 0; i < n; ++i) {
+    const Element value = input[i];
+    ptrdiff_t count = 0;
+    for (ptrdiff_t j = 0; j < n; ++j) {
+      count += (input[j] == value);
+    }
+    if (count * 2 > n) return value;
+    if (count > mode_count || (count == mode_count && value < mode)) {
+      mode = value;
+      mode_count = count;
+    }
+  }
+  return mode;
+}
+
 template <typename Element>
 struct ReductionTraits<DownsampleMethod::kMode, Element>
     : public StoreReductionTraitsBase<DownsampleMethod::kMode, Element> {
   static void ComputeOutput(Element& output, span<Element> input) {
+    if constexpr (std::is_integral_v<Element>) {
+      if (input.size() <= kSmallBlockMaxElements) {
+        output = ComputeSmallBlockIntegerMode<Element>(input);
+        return;
+      }
+    }
     // Sort in order to determine the number of times each distinct value is
     // repeated.
     std::sort(input.begin(), input.end(), CompareForMode<Element>{});
@@ -487,6 +563,54 @@ template <>
 struct ReductionTraits<DownsampleMethod::kMode, bool>
     : public ReductionTraits<DownsampleMethod::kMean, bool> {};
 
+/// Accumulates a single contiguous row of input elements into the
+/// corresponding row of the accumulation buffer, for an inner downsample
+/// factor of `InnerFactor` (either 1 or 2).
+///
+/// This is equivalent to the generic per-element loop in
+/// `DownsampleImpl::ProcessInput`, but avoids the per-element index
+/// computations and callbacks, which allows the compiler to vectorize it for
+/// the common integer and floating-point types.  Each accumulator element
+/// receives its inputs in the same order as in the generic loop, which ensures
+/// the results are identical.
+///
+/// \param acc Pointer to the accumulation buffer element corresponding to
+///     `input[0]`.
+/// \param input Pointer to the first input element of the row.
+/// \param input_size Number of input elements in the row.
+/// \param input_offset Offset of `input[0]` within its downsample block, in
+///     the range `[0, InnerFactor)`.
+template <typename Traits, Index InnerFactor, typename AccumulateElement,
+          typename Element>
+void AccumulateContiguousRow(AccumulateElement* acc, const Element* input,
+                             Index input_size, Index input_offset) {
+  if constexpr (InnerFactor == 1) {
+    for (Index i = 0; i < input_size; ++i) {
+      Traits::Accumulate(acc[i], input[i]);
+    }
+  } else {
+    static_assert(InnerFactor == 2);
+    if (input_offset != 0 && input_size > 0) {
+      // The first input element is the last element of a partial block.
+      Traits::Accumulate(acc[0], input[0]);
+      ++acc;
+      ++input;
+      --input_size;
+    }
+    const Index num_pairs = input_size / 2;
+    for (Index i = 0; i < num_pairs; ++i) {
+      AccumulateElement value = acc[i];
+      Traits::Accumulate(value, input[2 * i]);
+      Traits::Accumulate(value, input[2 * i + 1]);
+      acc[i] = value;
+    }
+    if (input_size % 2) {
+      // The last input element is the first element of a partial block.
+      Traits::Accumulate(acc[num_pairs], input[input_size - 1]);
+    }
+  }
+}
+
 /// Template class that generates the type-specific and method-specific
 /// implementation for performing the downsample computation.
 ///
@@ -592,6 +716,38 @@ struct DownsampleImpl {
                       element_i * num_outer_elements);
             });
       };
+#if !TENSORSTORE_INTERNAL_DOWNSAMPLE_DEBUG
+      if constexpr (!Traits::kStoreAllElements &&
+                    ArrayAccessor::buffer_kind ==
+                        IterationBufferKind::kContiguous) {
+        // Fast path for the common case of a contiguous inner dimension that
+        // is either not downsampled or downsampled by a factor of 2.  The
+        // accumulate-based methods do not depend on the position of an input
+        // element within its downsample block, so each row can be processed
+        // by a single tight loop.
+        const Index inner_factor = downsample_factor[1];
+        if (inner_factor == 1 || inner_factor == 2) {
+          for_each_source_index(
+              std::integral_constant<Index, 0>{},
+              [&](Index output_outer_i, Index source_outer_i, Index element_i,
+                  Index num_source_elements) {
+                auto* acc_row = acc + output_outer_i * output_block_shape[1];
+                const Element* input_row =
+                    ArrayAccessor::template GetPointerAtPosition<Element>(
+                        source_pointer, source_outer_i, 0);
+                if (inner_factor == 1) {
+                  AccumulateContiguousRow<Traits, 1>(
+                      acc_row, input_row, base_block_shape[1], 0);
+                } else {
+                  AccumulateContiguousRow<Traits, 2>(acc_row, input_row,
+                                                     base_block_shape[1],
+                                                     base_block_offset[1]);
+                }
+              });
+          return true;
+        }
+      }
+#endif  // !TENSORSTORE_INTERNAL_DOWNSAMPLE_DEBUG
       for_each_source_index(
           std::integral_constant<Index, 0>{},
           [&](Index output_outer_i, Index source_outer_i, Index element_i,
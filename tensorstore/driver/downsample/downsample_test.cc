@@ -38,6 +38,8 @@
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
 #include "tensorstore/open.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/schema.h"
@@ -152,6 +154,154 @@ TEST(DownsampleTest, Rank1MeanChunked) {
               Optional(MakeArray<uint8_t>({1, 6, 3, 5, 2, 5})));
 }
 
+TEST(DownsampleTest, Rank1MeanChunkAlignedWithBaseChunkCache) {
+  ::nlohmann::json base_spec{{"driver", "n5"},
+                             {"kvstore", {{"driver", "memory"}}},
+                             {"metadata",
+                              {{"dataType", "uint8"},
+                               {"dimensions", {11}},
+                               {"blockSize", {3}},
+                               {"compression", {{"type", "raw"}}}}}};
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::Open(base_spec, context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint8_t>({0, 2, 3, 9, 1, 5, 7, 3, 4, 0, 5}), base_store));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store,
+      tensorstore::Open({{"driver", "downsample"},
+                         {"base", base_spec},
+                         {"downsample_factors", {2}},
+                         {"downsample_method", "mean"},
+                         {"base_chunk_cache_bytes", 1024}},
+                        context)
+          .result());
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({1, 6, 3, 5, 2, 5})));
+
+  // Adjacent reads that share base chunks produce the same result as a
+  // single read.
+  EXPECT_THAT(tensorstore::Read(downsampled_store |
+                                tensorstore::Dims(0).HalfOpenInterval(0, 2))
+                  .result(),
+              Optional(MakeArray<uint8_t>({1, 6})));
+  EXPECT_THAT(tensorstore::Read(downsampled_store |
+                                tensorstore::Dims(0).HalfOpenInterval(2, 4))
+                  .result(),
+              Optional(MakeOffsetArray<uint8_t>({2}, {3, 5})));
+  EXPECT_THAT(tensorstore::Read(downsampled_store |
+                                tensorstore::Dims(0).HalfOpenInterval(4, 6))
+                  .result(),
+              Optional(MakeOffsetArray<uint8_t>({4}, {2, 5})));
+
+  // Non-box-shaped requests fall back to regular reads.
+  EXPECT_THAT(
+      tensorstore::Read(downsampled_store | tensorstore::Dims(0).Stride(2))
+          .result(),
+      Optional(MakeArray<uint8_t>({1, 3, 2})));
+}
+
+::nlohmann::json GetZarr3BaseSpec() {
+  return {{"driver", "zarr3"},
+          {"kvstore", {{"driver", "memory"}}},
+          {"metadata",
+           {{"shape", {8}},
+            {"data_type", "uint8"},
+            {"chunk_grid",
+             {{"name", "regular"},
+              {"configuration", {{"chunk_shape", {4}}}}}}}}};
+}
+
+TEST(DownsampleTest, Rank1MeanCachedDownsampledChunks) {
+  auto context = Context::FromJson({{"cache_pool", {{"total_bytes_limit",
+                                                     1000000}}}})
+                     .value();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store, tensorstore::Open(GetZarr3BaseSpec(), context,
+                                         tensorstore::OpenMode::create)
+                           .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint8_t>({0, 2, 3, 9, 1, 5, 7, 3}), base_store));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store,
+      tensorstore::Open({{"driver", "downsample"},
+                         {"base", GetZarr3BaseSpec()},
+                         {"downsample_factors", {2}},
+                         {"downsample_method", "mean"},
+                         {"cache_downsampled_chunks", true}},
+                        context)
+          .result());
+  // Each downsampled chunk is computed from a single base chunk.
+  EXPECT_THAT(ReadAsIndividualChunks(downsampled_store).result(),
+              Optional(::testing::UnorderedElementsAre(
+                  Pair(MakeOffsetArray<uint8_t>({0}, {1, 6}),
+                       IdentityTransform(BoxView({0}, {2}))),
+                  Pair(MakeOffsetArray<uint8_t>({2}, {3, 5}),
+                       IdentityTransform(BoxView({2}, {2}))))));
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({1, 6, 3, 5})));
+  EXPECT_THAT(tensorstore::Read(downsampled_store |
+                                tensorstore::Dims(0).IndexArraySlice(
+                                    MakeArray<Index>({3, 0})))
+                  .result(),
+              Optional(MakeArray<uint8_t>({5, 1})));
+
+  // Modifying the base invalidates the cached chunk computed from it.
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint8_t>({9, 9}),
+      base_store | tensorstore::Dims(0).HalfOpenInterval(6, 8)));
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({1, 6, 3, 9})));
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint8_t>({4, 6}),
+      base_store | tensorstore::Dims(0).HalfOpenInterval(0, 2)));
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({5, 6, 3, 9})));
+}
+
+TEST(DownsampleTest, CachedDownsampledChunksReused) {
+  auto context =
+      Context::FromJson(
+          {{"cache_pool#downsampled", {{"total_bytes_limit", 1000000}}}})
+          .value();
+  auto base_spec = GetZarr3BaseSpec();
+  base_spec["recheck_cached_data"] = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::Open(base_spec, context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      MakeArray<uint8_t>({0, 2, 3, 9, 1, 5, 7, 3}), base_store));
+  ::nlohmann::json downsampled_spec{{"driver", "downsample"},
+                                    {"base", base_spec},
+                                    {"downsample_factors", {2}},
+                                    {"downsample_method", "mean"},
+                                    {"cache_downsampled_chunks", true},
+                                    {"cache_pool", "cache_pool#downsampled"}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto downsampled_store,
+      tensorstore::Open(downsampled_spec, context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec, downsampled_store.spec());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec_json, spec.ToJson());
+  EXPECT_EQ(true, spec_json["cache_downsampled_chunks"]);
+  EXPECT_EQ("cache_pool#downsampled", spec_json["cache_pool"]);
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({1, 6, 3, 5})));
+
+  // With `recheck_cached_data: false`, the cached downsampled chunks are used
+  // without revalidating the base chunks, which are not themselves cached.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto kvstore,
+      tensorstore::kvstore::Open({{"driver", "memory"}}, context).result());
+  TENSORSTORE_ASSERT_OK(tensorstore::kvstore::Delete(kvstore, "c/0").result());
+  EXPECT_THAT(tensorstore::Read(base_store).result(),
+              Optional(MakeArray<uint8_t>({0, 0, 0, 0, 1, 5, 7, 3})));
+  EXPECT_THAT(tensorstore::Read(downsampled_store).result(),
+              Optional(MakeArray<uint8_t>({1, 6, 3, 5})));
+}
+
 TEST(DownsampleTest, Rank1MeanChunkedTranslated) {
   ::nlohmann::json base_spec{{"driver", "n5"},
                              {"kvstore", {{"driver", "memory"}}},
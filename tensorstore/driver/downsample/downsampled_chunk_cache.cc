@@ -0,0 +1,62 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/downsample/downsampled_chunk_cache.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/mutex.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+std::shared_ptr<const DownsampledChunkCache::ChunkState>
+DownsampledChunkCache::Entry::GetState() {
+  absl::MutexLock lock(&mutex());
+  return state_;
+}
+
+void DownsampledChunkCache::Entry::SetState(
+    std::shared_ptr<const ChunkState> state) {
+  UniqueWriterLock lock(*this);
+  state_ = std::move(state);
+  NotifySizeChanged();
+}
+
+// The cache framework calls this while holding the entry's mutex, if the entry
+// is accessible to other threads.
+size_t DownsampledChunkCache::DoGetSizeInBytes(
+    internal::Cache::Entry* base_entry) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto* entry = static_cast<Entry*>(base_entry);
+  size_t size = internal::Cache::DoGetSizeInBytes(entry);
+  if (const auto* state = entry->state_.get()) {
+    size += sizeof(ChunkState) +
+            state->data.num_elements() * state->data.dtype().size();
+    for (const auto& key : state->base_keys) size += key.size();
+    for (const auto& generation : state->base_generations) {
+      size += generation.value.size();
+    }
+  }
+  return size;
+}
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
@@ -0,0 +1,87 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLED_CHUNK_CACHE_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLED_CHUNK_CACHE_H_
+
+/// \file
+///
+/// Cache of computed downsampled chunks used by the downsample driver when
+/// `cache_downsampled_chunks` is enabled.
+///
+/// Each entry corresponds to a cell of a regular grid over the downsampled
+/// domain, keyed as by `internal::GetEntryForGridCell`, and records the storage
+/// generations of the base chunks from which it was computed.  A cached chunk
+/// remains valid as long as none of those generations has changed.
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/time/time.h"
+#include "tensorstore/array.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/generation.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+class DownsampledChunkCache : public internal::Cache {
+ public:
+  /// Immutable state of an entry.
+  struct ChunkState {
+    /// Downsampled chunk data, over the intersection of the grid cell with the
+    /// downsampled domain.
+    SharedOffsetArray<const void> data;
+
+    /// Keys in the base kvstore of the base chunks from which `data` was
+    /// computed.
+    std::vector<std::string> base_keys;
+
+    /// Storage generation of each of `base_keys`.  A missing stored chunk
+    /// corresponds to `StorageGeneration::NoValue()`.
+    std::vector<StorageGeneration> base_generations;
+
+    /// Time as of which `base_generations` are known to be current.
+    absl::Time time = absl::InfinitePast();
+  };
+
+  class Entry : public internal::Cache::Entry {
+   public:
+    using OwningCache = DownsampledChunkCache;
+
+    /// Returns the current state, or `nullptr` if no chunk has been computed.
+    std::shared_ptr<const ChunkState> GetState();
+
+    /// Replaces the current state.
+    void SetState(std::shared_ptr<const ChunkState> state);
+
+   private:
+    friend class DownsampledChunkCache;
+    std::shared_ptr<const ChunkState> state_ ABSL_GUARDED_BY(mutex());
+  };
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  size_t DoGetSizeInBytes(internal::Cache::Entry* base_entry) final;
+};
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_DOWNSAMPLED_CHUNK_CACHE_H_
@@ -0,0 +1,278 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/downsample/pyramid.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/iterate.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+namespace {
+
+/// Tile extent used for dimensions without a read chunk shape.
+constexpr Index kDefaultTileExtent = 64;
+
+/// Shared state of a `WriteDownsamplePyramid` operation.
+///
+/// The operation completes with success once the last reference is released,
+/// which releases `promise`.
+struct PyramidWriteState
+    : public internal::AtomicReferenceCount<PyramidWriteState> {
+  TensorStore<> base;
+  std::vector<DownsamplePyramidLevel> levels;
+  DownsampleMethod method;
+  Promise<void> promise;
+  Box<> base_domain;
+  std::vector<Index> tile_shape;
+
+  /// Bounds of the grid of tiles that intersect `base_domain`.
+  std::vector<Index> tile_grid_min;
+  std::vector<Index> tile_grid_max;
+  size_t max_concurrent_tiles;
+
+  absl::Mutex mutex;
+
+  /// Grid position of the next tile to start.
+  std::vector<Index> next_tile ABSL_GUARDED_BY(mutex);
+  bool tiles_remaining ABSL_GUARDED_BY(mutex) = true;
+  size_t num_active_tiles ABSL_GUARDED_BY(mutex) = 0;
+};
+
+using PyramidWriteStatePtr = internal::IntrusivePtr<PyramidWriteState>;
+
+void StartTiles(PyramidWriteStatePtr state);
+
+void TileDone(PyramidWriteStatePtr state) {
+  {
+    absl::MutexLock lock(&state->mutex);
+    --state->num_active_tiles;
+  }
+  StartTiles(std::move(state));
+}
+
+/// Computes all levels of a single tile from the base level data and writes
+/// them to their targets.
+void WriteTileLevels(PyramidWriteStatePtr state,
+                     SharedOffsetArray<const void> base_tile) {
+  std::vector<AnyFuture> commit_futures;
+  commit_futures.reserve(state->levels.size());
+  SharedOffsetArray<const void> prev_tile = std::move(base_tile);
+  for (const auto& level : state->levels) {
+    auto level_tile =
+        DownsampleArray(prev_tile, level.downsample_factors, state->method);
+    if (!level_tile.ok()) {
+      state->promise.SetResult(level_tile.status());
+      break;
+    }
+    commit_futures.push_back(
+        tensorstore::Write(*level_tile,
+                           level.store | tensorstore::AllDims().BoxSlice(
+                                             level_tile->domain()))
+            .commit_future);
+    prev_tile = *std::move(level_tile);
+  }
+  // Release the tile data before waiting for the writes, which retain
+  // references to the data they still require.
+  prev_tile = {};
+  WaitAllFuture(commit_futures)
+      .ExecuteWhenReady(
+          [state = std::move(state)](ReadyFuture<void> future) mutable {
+            if (!future.result().ok()) {
+              state->promise.SetResult(future.result().status());
+            }
+            TileDone(std::move(state));
+          });
+}
+
+void StartTile(PyramidWriteStatePtr state, Box<> tile) {
+  auto read_future = tensorstore::Read(
+      state->base | tensorstore::AllDims().BoxSlice(tile));
+  std::move(read_future)
+      .ExecuteWhenReady(
+          [state = std::move(state)](
+              ReadyFuture<SharedOffsetArray<void>> future) mutable {
+            auto& result = future.result();
+            if (!result.ok()) {
+              state->promise.SetResult(result.status());
+              TileDone(std::move(state));
+              return;
+            }
+            WriteTileLevels(std::move(state), *std::move(result));
+          });
+}
+
+/// Starts tiles until `max_concurrent_tiles` are active or all tiles have
+/// been started.
+void StartTiles(PyramidWriteStatePtr state) {
+  const DimensionIndex rank = state->base_domain.rank();
+  std::vector<Box<>> tiles;
+  {
+    absl::MutexLock lock(&state->mutex);
+    while (state->tiles_remaining &&
+           state->num_active_tiles < state->max_concurrent_tiles &&
+           state->promise.result_needed()) {
+      Box<> tile(rank);
+      for (DimensionIndex i = 0; i < rank; ++i) {
+        const IndexInterval bounds = state->base_domain[i];
+        const Index tile_min = state->next_tile[i] * state->tile_shape[i];
+        const Index inclusive_min = std::max(tile_min, bounds.inclusive_min());
+        const Index size = std::min(state->tile_shape[i],
+                                    bounds.exclusive_max() - tile_min) -
+                           (inclusive_min - tile_min);
+        tile[i] = IndexInterval::UncheckedSized(inclusive_min, size);
+      }
+      tiles.push_back(std::move(tile));
+      ++state->num_active_tiles;
+      state->tiles_remaining = internal::AdvanceIndices(
+          rank, state->next_tile.data(), state->tile_grid_min.data(),
+          state->tile_grid_max.data());
+    }
+  }
+  for (auto& tile : tiles) {
+    StartTile(state, std::move(tile));
+  }
+}
+
+}  // namespace
+
+std::vector<Index> GetDownsamplePyramidTileShape(
+    span<const Index> cumulative_downsample_factors,
+    span<const Index> tile_shape, span<const Index> chunk_shape) {
+  const DimensionIndex rank = cumulative_downsample_factors.size();
+  std::vector<Index> result(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    const Index factor = cumulative_downsample_factors[i];
+    if (!tile_shape.empty()) {
+      result[i] = CeilOfRatio(std::max(tile_shape[i], Index(1)), factor) *
+                  factor;
+      continue;
+    }
+    const Index chunk_extent =
+        i < chunk_shape.size() && chunk_shape[i] > 0 ? chunk_shape[i]
+                                                     : kDefaultTileExtent;
+    // Tiles that are a multiple of both the chunk shape and the downsample
+    // factor are both chunk-aligned (for a zero grid origin) and aligned to
+    // the downsample blocks of every level.
+    result[i] = std::lcm(chunk_extent, factor);
+  }
+  return result;
+}
+
+Future<void> WriteDownsamplePyramid(TensorStore<> base,
+                                    std::vector<DownsamplePyramidLevel> levels,
+                                    DownsampleMethod method,
+                                    WriteDownsamplePyramidOptions options) {
+  const DimensionIndex rank = base.rank();
+  if (!options.tile_shape.empty() && options.tile_shape.size() != rank) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Tile shape ", span<const Index>(options.tile_shape),
+        " does not match rank of base (", rank, ")"));
+  }
+  std::vector<Index> cumulative_downsample_factors(rank, 1);
+  for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+    const auto& level = levels[level_i];
+    if (level.downsample_factors.size() != rank ||
+        level.store.rank() != rank) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Pyramid level ", level_i, " with downsample factors ",
+          span<const Index>(level.downsample_factors), " and rank ",
+          level.store.rank(), " does not match rank of base (", rank, ")"));
+    }
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      const Index factor = level.downsample_factors[i];
+      if (factor <= 0) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Pyramid level ", level_i, " has invalid downsample factors ",
+            span<const Index>(level.downsample_factors)));
+      }
+      if (internal::MulOverflow(cumulative_downsample_factors[i], factor,
+                                &cumulative_downsample_factors[i])) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Overflow computing cumulative downsample factors of pyramid "
+            "level ",
+            level_i));
+      }
+    }
+  }
+  Box<> base_domain(base.domain().box());
+  if (!IsFinite(base_domain)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot write downsample pyramid of unbounded domain ", base_domain));
+  }
+  if (levels.empty() || base_domain.is_empty()) {
+    return MakeReadyFuture<void>(absl::OkStatus());
+  }
+
+  std::vector<Index> chunk_shape;
+  if (options.tile_shape.empty()) {
+    if (auto chunk_layout = base.chunk_layout(); chunk_layout.ok()) {
+      auto read_chunk_shape = chunk_layout->read_chunk_shape();
+      chunk_shape.assign(read_chunk_shape.begin(), read_chunk_shape.end());
+    }
+  }
+
+  auto state = internal::MakeIntrusivePtr<PyramidWriteState>();
+  state->tile_shape = GetDownsamplePyramidTileShape(
+      cumulative_downsample_factors, options.tile_shape, chunk_shape);
+  state->tile_grid_min.resize(rank);
+  state->tile_grid_max.resize(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    state->tile_grid_min[i] =
+        FloorOfRatio(base_domain[i].inclusive_min(), state->tile_shape[i]);
+    state->tile_grid_max[i] =
+        FloorOfRatio(base_domain[i].inclusive_max(), state->tile_shape[i]) +
+        1;
+  }
+  state->next_tile = state->tile_grid_min;
+  state->base = std::move(base);
+  state->levels = std::move(levels);
+  state->method = method;
+  state->base_domain = std::move(base_domain);
+  state->max_concurrent_tiles = std::max(options.max_concurrent_tiles,
+                                         size_t(1));
+  auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
+  state->promise = std::move(promise);
+  StartTiles(std::move(state));
+  return std::move(future);
+}
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
@@ -0,0 +1,103 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
+#define TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
+
+/// \file
+///
+/// Writes a multi-resolution pyramid from a single pass over the base level.
+///
+/// Computing each pyramid level with a separate `downsample` driver pass
+/// requires re-reading the previous level from storage for every level.
+/// `WriteDownsamplePyramid` instead reads the base level once, in tiles aligned
+/// to the downsample blocks of every level, computes all levels of each tile in
+/// memory by downsampling the previous level, and writes each level to its own
+/// target.  Multiple tiles are processed concurrently, such that the reads of
+/// later tiles overlap with the writes of earlier tiles.
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/index.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_downsample {
+
+/// Specifies a single level of a pyramid written by `WriteDownsamplePyramid`.
+struct DownsamplePyramidLevel {
+  /// Target to which the level is written.  Must support writing and have the
+  /// same rank and data type as the base level, and its domain must contain
+  /// the downsampled domain of the level.
+  TensorStore<> store;
+
+  /// Downsample factors for each dimension, relative to the previous level
+  /// (or the base level, for the first level).
+  std::vector<Index> downsample_factors;
+};
+
+/// Options for `WriteDownsamplePyramid`.
+struct WriteDownsamplePyramidOptions {
+  /// Shape of the tiles in which the base level is read.  Each dimension is
+  /// rounded up to a multiple of the cumulative downsample factor of the last
+  /// level, which ensures that tiles never split a downsample block of any
+  /// level.  If empty, the shape is determined from the read chunk shape of
+  /// the base level.
+  std::vector<Index> tile_shape;
+
+  /// Maximum number of tiles that are read, downsampled or written
+  /// concurrently.  Bounds the memory used by the operation.
+  size_t max_concurrent_tiles = 4;
+};
+
+/// Computes the tile shape used by `WriteDownsamplePyramid`, as documented for
+/// `WriteDownsamplePyramidOptions::tile_shape`.
+///
+/// \param cumulative_downsample_factors Product of the downsample factors of
+///     all levels, for each dimension.
+/// \param tile_shape Requested tile shape, or empty to use `chunk_shape`.
+/// \param chunk_shape Read chunk shape of the base level, where `0` indicates
+///     an unconstrained dimension.
+std::vector<Index> GetDownsamplePyramidTileShape(
+    span<const Index> cumulative_downsample_factors,
+    span<const Index> tile_shape, span<const Index> chunk_shape);
+
+/// Writes all `levels` of a downsampling pyramid of `base`.
+///
+/// The result of each level is the same as downsampling the previous level by
+/// `levels[i].downsample_factors` using `method`, but `base` is only read
+/// once.
+///
+/// \param base Base level, must support reading and have a bounded domain.
+/// \param levels Pyramid levels, from the highest to the lowest resolution.
+/// \param method Downsample method.
+/// \param options Additional options.
+/// \returns A future that becomes ready once all levels have been written.
+/// \error `absl::StatusCode::kInvalidArgument` if the ranks of `base` and
+///     `levels` are inconsistent, a downsample factor is not positive, or
+///     the domain of `base` is unbounded.
+Future<void> WriteDownsamplePyramid(
+    TensorStore<> base, std::vector<DownsamplePyramidLevel> levels,
+    DownsampleMethod method, WriteDownsamplePyramidOptions options = {});
+
+}  // namespace internal_downsample
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_DOWNSAMPLE_PYRAMID_H_
@@ -0,0 +1,138 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/driver/downsample/pyramid.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/array_testutil.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/downsample_method.h"
+#include "tensorstore/driver/array/array.h"
+#include "tensorstore/driver/downsample/downsample_array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::DownsampleMethod;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::span;
+using ::tensorstore::internal_downsample::DownsampleArray;
+using ::tensorstore::internal_downsample::DownsamplePyramidLevel;
+using ::tensorstore::internal_downsample::GetDownsamplePyramidTileShape;
+using ::tensorstore::internal_downsample::WriteDownsamplePyramid;
+using ::tensorstore::internal_downsample::WriteDownsamplePyramidOptions;
+using ::testing::ElementsAre;
+
+TEST(GetDownsamplePyramidTileShapeTest, Basic) {
+  // Explicit tile shape is rounded up to a multiple of the factors.
+  EXPECT_THAT(GetDownsamplePyramidTileShape(span<const Index>({4, 6}),
+                                            span<const Index>({5, 6}), {}),
+              ElementsAre(8, 6));
+  // Chunk shape is combined with the factors.
+  EXPECT_THAT(GetDownsamplePyramidTileShape(span<const Index>({4, 6}), {},
+                                            span<const Index>({64, 0})),
+              ElementsAre(64, 192));
+}
+
+// Tests that each level matches the result of downsampling the previous level
+// separately, for a base domain that is not aligned to the tiles.
+TEST(WriteDownsamplePyramidTest, MatchesCascadedDownsample) {
+  for (const DownsampleMethod method :
+       {DownsampleMethod::kMean, DownsampleMethod::kMedian,
+        DownsampleMethod::kMode, DownsampleMethod::kMax,
+        DownsampleMethod::kStride}) {
+    SCOPED_TRACE(tensorstore::StrCat("method=", method));
+    auto base_array = tensorstore::AllocateArray<uint8_t>(
+        tensorstore::BoxView<>({1, -3}, {19, 23}));
+    for (Index i = 0; i < 19; ++i) {
+      for (Index j = 0; j < 23; ++j) {
+        base_array(i + 1, j - 3) = static_cast<uint8_t>((i * 7 + j * 13) % 11);
+      }
+    }
+    const std::vector<std::vector<Index>> level_factors{{2, 2}, {2, 3}};
+    std::vector<tensorstore::SharedOffsetArray<const void>> expected_levels;
+    std::vector<tensorstore::SharedOffsetArray<void>> level_arrays;
+    std::vector<DownsamplePyramidLevel> levels;
+    tensorstore::SharedOffsetArray<const void> prev = base_array;
+    for (const auto& factors : level_factors) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto expected,
+                                       DownsampleArray(prev, factors, method));
+      auto level_array = tensorstore::AllocateArray(
+          expected.domain(), tensorstore::c_order, tensorstore::value_init,
+          expected.dtype());
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto level_store,
+                                       tensorstore::FromArray(level_array));
+      levels.push_back({level_store, factors});
+      level_arrays.push_back(level_array);
+      expected_levels.push_back(expected);
+      prev = expected;
+    }
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto base_store,
+                                     tensorstore::FromArray(base_array));
+    WriteDownsamplePyramidOptions options;
+    options.tile_shape = {5, 5};
+    options.max_concurrent_tiles = 2;
+    TENSORSTORE_EXPECT_OK(
+        WriteDownsamplePyramid(base_store, levels, method, options).result());
+    for (size_t i = 0; i < levels.size(); ++i) {
+      EXPECT_THAT(level_arrays[i],
+                  tensorstore::MatchesArray(expected_levels[i]))
+          << "level=" << i;
+    }
+  }
+}
+
+TEST(WriteDownsamplePyramidTest, RankMismatch) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::FromArray(tensorstore::AllocateArray<uint8_t>({4, 4})));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto level_store,
+      tensorstore::FromArray(tensorstore::AllocateArray<uint8_t>({2, 2})));
+  EXPECT_THAT(WriteDownsamplePyramid(base_store, {{level_store, {2}}},
+                                     DownsampleMethod::kMean)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Pyramid level 0 .* does not match rank .*"));
+}
+
+TEST(WriteDownsamplePyramidTest, InvalidFactor) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store,
+      tensorstore::FromArray(tensorstore::AllocateArray<uint8_t>({4, 4})));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto level_store,
+      tensorstore::FromArray(tensorstore::AllocateArray<uint8_t>({2, 2})));
+  EXPECT_THAT(WriteDownsamplePyramid(base_store, {{level_store, {2, 0}}},
+                                     DownsampleMethod::kMean)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Pyramid level 0 has invalid downsample .*"));
+}
+
+}  // namespace
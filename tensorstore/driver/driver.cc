@@ -195,6 +195,10 @@ Future<ArrayStorageStatistics> Driver::GetStorageStatistics(
   return absl::UnimplementedError("Storage statistics not supported");
 }
 
+Future<Driver::EncodedChunkStorage> Driver::GetEncodedChunkStorage() {
+  return absl::UnimplementedError("Encoded chunk storage not supported");
+}
+
 Result<ChunkLayout> GetChunkLayout(const Driver::Handle& handle) {
   assert(handle.driver);
   return handle.driver->GetChunkLayout(handle.transform);
@@ -40,12 +40,17 @@
 /// `Driver` types will normally contain a `kvstore::Spec`,
 /// `kvstore::DriverPtr`, respectively.
 
+#include <functional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
 #include "tensorstore/array_storage_statistics.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/data_type.h"
@@ -59,6 +64,7 @@
 #include "tensorstore/index_space/index_transform.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
@@ -276,6 +282,43 @@ class Driver : public AtomicReferenceCount<Driver> {
   virtual Future<ArrayStorageStatistics> GetStorageStatistics(
       GetStorageStatisticsRequest request);
 
+  /// Describes how the chunks of a driver are stored in a kvstore, such that
+  /// they may be copied between drivers without being decoded.
+  struct EncodedChunkStorage {
+    /// Identifies the encoded representation of a chunk.  The stored chunks of
+    /// two drivers with equal `format` strings are interchangeable.
+    std::string format;
+
+    /// Kvstore in which the encoded chunks are stored.
+    kvstore::DriverPtr kvstore;
+
+    /// Staleness bound for reading encoded chunks from `kvstore`.
+    absl::Time staleness_bound;
+
+    /// Current bounds of the index space of the driver.
+    Box<> bounds;
+
+    /// Shape of each chunk.  The grid cell with indices `cell_indices`
+    /// corresponds to the half-open interval
+    /// `[cell_indices[i] * chunk_shape[i], (cell_indices[i] + 1) *
+    /// chunk_shape[i])` of each dimension `i` of the index space of the driver.
+    std::vector<Index> chunk_shape;
+
+    /// Returns the key in `kvstore` of the specified grid cell.  A missing key
+    /// indicates that all elements of the cell are equal to the fill value.
+    std::function<std::string(span<const Index> cell_indices)> get_chunk_key;
+  };
+
+  /// Returns the storage of the encoded chunks, which `DriverCopy` uses to
+  /// copy chunks that are entirely covered by a non-transactional copy without
+  /// decoding and re-encoding them.
+  ///
+  /// Drivers should only support this if the kvstore holds all committed data,
+  /// i.e. no writes are deferred in a cache.
+  ///
+  /// Default implementation fails with `kUnimplemented`.
+  virtual Future<EncodedChunkStorage> GetEncodedChunkStorage();
+
   virtual ~Driver();
 };
 
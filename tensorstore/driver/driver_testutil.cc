@@ -1192,6 +1192,12 @@ ReadChunk MakeArrayBackedReadChunk(TransformedArray<Shared<const void>> data) {
                                        Arena* arena) {
       return GetTransformedArrayNDIterable({data, chunk_transform}, arena);
     }
+
+    Result<TransformedSharedArray<const void>> operator()(
+        ReadChunk::GetArray, IndexTransform<> chunk_transform) {
+      return TransformedSharedArray<const void>(data,
+                                                std::move(chunk_transform));
+    }
   };
   ReadChunk chunk;
   chunk.impl = ReadChunkImpl{data.element_pointer()};
@@ -529,6 +529,14 @@ struct ReadChunkImpl {
     return internal::GetTransformedArrayNDIterable(*lock.data(),
                                                    chunk_transform, arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      internal::ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    LockType lock{*entry};
+    assert(lock.data());
+    SharedArray<const void> data = *lock.data();
+    return MakeTransformedArray(std::move(data), std::move(chunk_transform));
+  }
 };
 
 template <typename Specialization>
@@ -46,7 +46,7 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
-#include "tensorstore/internal/json/same.h"
+#include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/staleness_bound.h"
 #include "tensorstore/internal/json_pointer.h"
@@ -54,6 +54,7 @@
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/nditerable.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/internal/unowned_to_shared.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
@@ -86,9 +87,9 @@ Result<::nlohmann::json> DecodeJson(const std::optional<absl::Cord>& data) {
   if (!data) {
     return ::nlohmann::json(::nlohmann::json::value_t::discarded);
   }
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
   nlohmann::json raw_data =
-      nlohmann::json::parse(absl::Cord(*data).Flatten(), nullptr,
-                            /*allow_exceptions=*/false);
+      internal_json::ParseJson(absl::Cord(*data).Flatten());
   if (raw_data.is_discarded()) {
     return absl::FailedPreconditionError("Invalid JSON");
   }
@@ -165,28 +166,26 @@ class JsonCache
             if (!unmodified) {
               auto* existing_json =
                   static_cast<const ::nlohmann::json*>(read_state.data.get());
-              ::nlohmann::json new_json;
-              // Apply changes.  If `existing_state` is non-null (equivalent to
-              // `unconditional == false`), provide it to `Apply`.  Otherwise,
-              // pass in a placeholder value (which won't be used).
-              auto result = changes_.Apply(
-                  existing_json
-                      ? *existing_json
-                      : ::nlohmann::json(::nlohmann::json::value_t::discarded));
-              if (result.ok()) {
-                new_json = std::move(*result);
-              } else {
-                execution::set_error(receiver, std::move(result).status());
-                return;
-              }
               // For conditional states, only mark dirty if it differs from the
               // existing state, since otherwise the writeback can be skipped
-              // (and instead the state can just be verified).
-              if (!existing_json ||
-                  !internal_json::JsonSame(new_json, *existing_json)) {
+              // (and instead the state can just be verified).  This compares
+              // just the changed sub-values, which avoids copying and
+              // comparing a large document for a redundant update.
+              if (!existing_json || !changes_.LeavesUnchanged(*existing_json)) {
+                // Apply changes.  If `existing_state` is non-null (equivalent
+                // to `unconditional == false`), provide it to `Apply`.
+                // Otherwise, pass in a placeholder value (which won't be used).
+                auto result = changes_.Apply(
+                    existing_json ? *existing_json
+                                  : ::nlohmann::json(
+                                        ::nlohmann::json::value_t::discarded));
+                if (!result.ok()) {
+                  execution::set_error(receiver, std::move(result).status());
+                  return;
+                }
                 read_state.stamp.generation.MarkDirty();
                 read_state.data =
-                    std::make_shared<::nlohmann::json>(std::move(new_json));
+                    std::make_shared<::nlohmann::json>(std::move(*result));
               }
             }
             execution::set_value(receiver, std::move(read_state));
@@ -444,6 +443,20 @@ struct ReadChunkImpl {
                                                 sub_value),
         std::move(chunk_transform), arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    std::shared_ptr<const ::nlohmann::json> read_value =
+        AsyncCache::ReadLock<JsonCache::ReadData>(*entry).shared_data();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto* sub_value,
+        json_pointer::Dereference(*read_value, driver->json_pointer_),
+        entry->AnnotateError(_, /*reading=*/true));
+    return TransformedSharedArray<const void>(
+        std::shared_ptr<const ::nlohmann::json>(std::move(read_value),
+                                                sub_value),
+        std::move(chunk_transform));
+  }
 };
 
 /// TensorStore Driver ReadChunk implementation for the case of a transactional
@@ -494,6 +507,12 @@ struct ReadChunkTransactionImpl {
     return GetTransformedArrayNDIterable(std::move(value), chunk_transform,
                                          arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) {
+    // The value is computed on demand from the uncommitted changes.
+    return absl::UnimplementedError("");
+  }
 };
 
 void JsonDriver::Read(
@@ -20,6 +20,7 @@
 
 #include "absl/container/btree_map.h"
 #include <nlohmann/json.hpp>
+#include "tensorstore/internal/json/same.h"
 #include "tensorstore/internal/json_pointer.h"
 #include "tensorstore/util/status.h"
 
@@ -126,6 +127,21 @@ bool JsonChangeMap::CanApplyUnconditionally(
   return false;
 }
 
+bool JsonChangeMap::LeavesUnchanged(const ::nlohmann::json& existing) const {
+  for (const auto& [pointer, new_value] : map_) {
+    auto existing_value = json_pointer::Dereference(
+        existing, pointer, json_pointer::kSimulateCreate);
+    if (!existing_value.ok()) return false;
+    if (*existing_value == nullptr) {
+      // Deleting a missing member has no effect.
+      if (!new_value.is_discarded()) return false;
+      continue;
+    }
+    if (!internal_json::JsonSame(**existing_value, new_value)) return false;
+  }
+  return true;
+}
+
 absl::Status JsonChangeMap::AddChange(std::string_view sub_value_pointer,
                                       ::nlohmann::json sub_value) {
   auto it = map_.lower_bound(sub_value_pointer);
@@ -76,6 +76,15 @@ class JsonChangeMap {
   /// (e.g. `discarded`) as `existing`.
   bool CanApplyUnconditionally(std::string_view sub_value_pointer) const;
 
+  /// Determines whether `Apply(existing)` is known to return a value that is
+  /// identical to `existing`, according to `internal_json::JsonSame`.
+  ///
+  /// Only the sub-values of `existing` referenced by the changes are compared,
+  /// so the cost is independent of the size of the unchanged portion of
+  /// `existing`.  Returns `false` if some change is incompatible with
+  /// `existing`, in which case `Apply` reports the error.
+  bool LeavesUnchanged(const ::nlohmann::json& existing) const;
+
   /// Adds a change to the map.
   ///
   /// \param sub_value_pointer JSON Pointer specifying path to modify.
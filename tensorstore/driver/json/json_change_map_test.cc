@@ -199,4 +199,34 @@ TEST(JsonChangeMapTest, CanApplyUnconditionally) {
   EXPECT_TRUE(changes.CanApplyUnconditionally("/a"));
 }
 
+TEST(JsonChangeMapTest, LeavesUnchanged) {
+  const ::nlohmann::json existing{{"a", {{"b", 1}, {"c", {1, 2}}}}, {"d", 3}};
+  JsonChangeMap changes;
+  EXPECT_TRUE(changes.LeavesUnchanged(existing));
+  TENSORSTORE_EXPECT_OK(changes.AddChange("/a/b", 1));
+  TENSORSTORE_EXPECT_OK(changes.AddChange("/a/c", {1, 2}));
+  // Deleting a missing member has no effect.
+  TENSORSTORE_EXPECT_OK(changes.AddChange(
+      "/e", ::nlohmann::json(::nlohmann::json::value_t::discarded)));
+  EXPECT_TRUE(changes.LeavesUnchanged(existing));
+
+  TENSORSTORE_EXPECT_OK(changes.AddChange("/a/c/1", 3));
+  EXPECT_FALSE(changes.LeavesUnchanged(existing));
+  TENSORSTORE_EXPECT_OK(changes.AddChange("/a/c/1", 2));
+  EXPECT_TRUE(changes.LeavesUnchanged(existing));
+
+  // Deleting an existing member.
+  TENSORSTORE_EXPECT_OK(changes.AddChange(
+      "/d", ::nlohmann::json(::nlohmann::json::value_t::discarded)));
+  EXPECT_FALSE(changes.LeavesUnchanged(existing));
+}
+
+TEST(JsonChangeMapTest, LeavesUnchangedIncompatible) {
+  JsonChangeMap changes;
+  TENSORSTORE_EXPECT_OK(changes.AddChange("/a/b", 1));
+  EXPECT_FALSE(changes.LeavesUnchanged(::nlohmann::json{{"a", 5}}));
+  EXPECT_TRUE(changes.LeavesUnchanged(::nlohmann::json{{"a", {{"b", 1}}}}));
+  EXPECT_FALSE(changes.LeavesUnchanged(::nlohmann::json{{"a", {{"b", 2}}}}));
+}
+
 }  // namespace
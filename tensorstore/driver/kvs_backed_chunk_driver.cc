@@ -43,12 +43,15 @@
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/compression/codec_accelerator_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
+#include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/staleness_bound.h"  // IWYU: pragma keep
@@ -125,7 +128,8 @@ AtomicUpdateConstraint MetadataOpenState::GetCreateConstraint() {
 MetadataCache::MetadataCache(Initializer initializer)
     : Base(kvstore::DriverPtr()),
       data_copy_concurrency_(std::move(initializer.data_copy_concurrency)),
-      cache_pool_(std::move(initializer.cache_pool)) {}
+      cache_pool_(std::move(initializer.cache_pool)),
+      codec_accelerator_(std::move(initializer.codec_accelerator)) {}
 
 DataCacheBase::DataCacheBase(Initializer&& initializer)
     : metadata_cache_entry_(std::move(initializer.metadata_cache_entry)),
@@ -135,7 +139,12 @@ DataCache::DataCache(Initializer&& initializer,
                      internal::ChunkGridSpecification&& grid)
     : KvsBackedChunkCache(std::move(initializer.store)),
       ChunkedDataCacheBase(std::move(initializer)),
-      grid_(std::move(grid)) {}
+      grid_(std::move(grid)) {
+  SetEncodedCacheBytes(initializer.encoded_cache_bytes);
+  SetWritebackDelay(initializer.writeback_delay);
+  SetChunkPresenceSummary(initializer.chunk_presence_cache);
+  SetCodecAccelerator(metadata_cache()->codec_accelerator());
+}
 
 namespace {
 
@@ -430,7 +439,9 @@ Future<MetadataPtr> KvsMetadataDriverBase::ResolveMetadata(
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto node,
         GetTransactionNode(*cache->metadata_cache_entry_, transaction));
-    auto read_future = node->Read({metadata_staleness_bound});
+    auto read_future =
+        node->Read({metadata_staleness_bound, /*batch=*/{},
+                    metadata_coalescing_window_, stale_while_revalidate()});
     return MapFuture(
         cache->executor(),
         [cache = DataCacheBase::Ptr(cache), node = std::move(node)](
@@ -456,7 +467,9 @@ Future<MetadataPtr> KvsMetadataDriverBase::ResolveMetadata(
             ValidateNewMetadata(cache.get(), new_metadata.get()));
         return new_metadata;
       },
-      cache->metadata_cache_entry_->Read({metadata_staleness_bound}));
+      cache->metadata_cache_entry_->Read(
+          {metadata_staleness_bound, /*batch=*/{}, metadata_coalescing_window_,
+           stale_while_revalidate()}));
 }
 
 Future<IndexTransform<>> KvsMetadataDriverBase::ResolveBounds(
@@ -721,12 +734,19 @@ Result<IndexTransform<>> KvsMetadataDriverBase::GetBoundSpecData(
   spec.store.path = cache->GetBaseKvstorePath();
   spec.data_copy_concurrency = metadata_cache->data_copy_concurrency_;
   spec.cache_pool = metadata_cache->cache_pool_;
+  spec.codec_accelerator = metadata_cache->codec_accelerator_;
   spec.delete_existing = false;
   spec.open = true;
   spec.create = false;
   spec.assume_metadata = assumed_metadata_time_ == absl::InfiniteFuture();
   spec.staleness.metadata = this->metadata_staleness_bound();
   spec.staleness.data = this->data_staleness_bound();
+  spec.read_ahead = this->read_ahead_options();
+  spec.encoded_cache_bytes = cache->encoded_cache_bytes();
+  spec.writeback_delay = cache->writeback_delay();
+  spec.chunk_presence_cache = cache->chunk_presence_summary() != nullptr;
+  spec.metadata_coalescing_window = metadata_coalescing_window_;
+  spec.stale_while_revalidate = this->stale_while_revalidate();
   spec.schema.Set(RankConstraint{this->rank()}).IgnoreError();
   spec.schema.Set(this->dtype()).IgnoreError();
 
@@ -822,6 +842,23 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
     if (!data_cache_key.empty()) {
       internal::EncodeCacheKey(&chunk_cache_identifier, data_cache_key,
                                base.metadata_cache_key_);
+      if (base.spec_->encoded_cache_bytes != 0) {
+        // Caches with different limits are not shared.
+        internal::EncodeCacheKey(&chunk_cache_identifier,
+                                 base.spec_->encoded_cache_bytes);
+      }
+      if (const auto& writeback_delay = base.spec_->writeback_delay;
+          writeback_delay.enabled()) {
+        internal::EncodeCacheKey(&chunk_cache_identifier,
+                                 writeback_delay.max_delay,
+                                 writeback_delay.max_bytes,
+                                 writeback_delay.max_concurrency,
+                                 writeback_delay.max_bytes_per_second);
+      }
+      if (base.spec_->chunk_presence_cache) {
+        internal::EncodeCacheKey(&chunk_cache_identifier,
+                                 base.spec_->chunk_presence_cache);
+      }
     }
   }
   absl::Status data_key_value_store_status;
@@ -840,6 +877,9 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
         initializer.store = std::move(*store_result);
         initializer.metadata_cache_entry = base.metadata_cache_entry_;
         initializer.metadata = metadata;
+        initializer.encoded_cache_bytes = base.spec_->encoded_cache_bytes;
+        initializer.writeback_delay = base.spec_->writeback_delay;
+        initializer.chunk_presence_cache = base.spec_->chunk_presence_cache;
         return state->GetDataCache(std::move(initializer));
       });
   TENSORSTORE_RETURN_IF_ERROR(data_key_value_store_status);
@@ -877,10 +917,13 @@ Result<internal::Driver::Handle> CreateTensorStoreFromMetadata(
   initializer.component_index = component_index;
   initializer.data_staleness_bound =
       base.spec_->staleness.data.BoundAtOpen(base.request_time_);
+  initializer.read_ahead = base.spec_->read_ahead;
+  initializer.stale_while_revalidate = base.spec_->stale_while_revalidate;
   internal::ReadWritePtr<KvsMetadataDriverBase> driver(
       state->AllocateDriver(std::move(initializer)), read_write_mode);
   driver->metadata_staleness_bound_ =
       base.spec_->staleness.metadata.BoundAtOpen(base.request_time_);
+  driver->metadata_coalescing_window_ = base.spec_->metadata_coalescing_window;
   if (base.spec_->assume_metadata || base.spec_->assume_cached_metadata) {
     driver->assumed_metadata_ = metadata;
     driver->assumed_metadata_time_ = base.spec_->assume_cached_metadata
@@ -998,7 +1041,8 @@ struct GetMetadataForOpen {
           base.metadata_cache_entry_->Read(
               {base.spec_->staleness.metadata.BoundAtOpen(base.request_time_)
                    .time,
-               batch}));
+               batch, base.spec_->metadata_coalescing_window,
+               base.spec_->stale_while_revalidate}));
       return;
     }
     // `tensorstore::Open` ensures that at least one of `OpenMode::create` and
@@ -1231,7 +1275,8 @@ internal::CachePtr<MetadataCache> GetOrCreateMetadataCache(
         ABSL_LOG_IF(INFO, TENSORSTORE_KVS_DRIVER_DEBUG)
             << "Creating metadata cache: open_state=" << state;
         return state->GetMetadataCache(
-            {base.spec_->data_copy_concurrency, base.spec_->cache_pool});
+            {base.spec_->data_copy_concurrency, base.spec_->cache_pool,
+             base.spec_->codec_accelerator});
       },
       [&](Promise<void> initialized,
           internal::CachePtr<MetadataCache> metadata_cache) {
@@ -1438,6 +1483,8 @@ void KvsMetadataDriverBase::GarbageCollectionBase::Visit(
 }
 
 namespace jb = tensorstore::internal_json_binding;
+using internal::ChunkReadAheadOptions;
+using internal::WritebackDelayOptions;
 TENSORSTORE_DEFINE_JSON_BINDER(
     SpecJsonBinder,
     jb::Sequence(
@@ -1445,6 +1492,8 @@ TENSORSTORE_DEFINE_JSON_BINDER(
                    jb::Projection<&KvsDriverSpec::data_copy_concurrency>()),
         jb::Member(internal::CachePoolResource::id,
                    jb::Projection<&KvsDriverSpec::cache_pool>()),
+        jb::Member(internal::CodecAcceleratorResource::id,
+                   jb::Projection<&KvsDriverSpec::codec_accelerator>()),
         jb::Projection<&KvsDriverSpec::store>(jb::KvStoreSpecAndPathJsonBinder),
         jb::Initialize([](auto* obj) {
           internal::EnsureDirectoryPath(obj->store.path);
@@ -1459,6 +1508,66 @@ TENSORSTORE_DEFINE_JSON_BINDER(
             jb::Member("recheck_cached_data",
                        jb::Projection(&StalenessBounds::data,
                                       jb::DefaultInitializedValue())))),
+        jb::Member("read_ahead",
+                   jb::Projection<&KvsDriverSpec::read_ahead>(
+                       jb::DefaultInitializedValue(jb::Object(
+                           jb::Member("max_chunks",
+                                      jb::Projection<
+                                          &ChunkReadAheadOptions::max_chunks>(
+                                          jb::DefaultInitializedValue())),
+                           jb::Member("max_bytes",
+                                      jb::Projection<
+                                          &ChunkReadAheadOptions::max_bytes>(
+                                          jb::DefaultInitializedValue())))))),
+        jb::Member("encoded_cache_bytes",
+                   jb::Projection<&KvsDriverSpec::encoded_cache_bytes>(
+                       jb::DefaultInitializedValue())),
+        jb::Member("writeback_delay",
+                   jb::Projection<&KvsDriverSpec::writeback_delay>(
+                       jb::DefaultInitializedValue(jb::Object(
+                           jb::Member("max_delay",
+                                      jb::Projection<
+                                          &WritebackDelayOptions::max_delay>(
+                                          jb::DefaultInitializedValue())),
+                           jb::Member("max_bytes",
+                                      jb::Projection<
+                                          &WritebackDelayOptions::max_bytes>(
+                                          jb::DefaultInitializedValue())),
+                           jb::Member("max_concurrency",
+                                      jb::Projection<&WritebackDelayOptions::
+                                                         max_concurrency>(
+                                          jb::DefaultInitializedValue())),
+                           jb::Member("max_bytes_per_second",
+                                      jb::Projection<&WritebackDelayOptions::
+                                                         max_bytes_per_second>(
+                                          jb::DefaultInitializedValue())))))),
+        jb::Member("chunk_presence_cache",
+                   jb::Projection<&KvsDriverSpec::chunk_presence_cache>(
+                       jb::DefaultInitializedValue())),
+        jb::Member("metadata_coalescing_window",
+                   jb::Projection<&KvsDriverSpec::metadata_coalescing_window>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = absl::ZeroDuration(); },
+                           jb::Validate([](const auto& options,
+                                           const absl::Duration* obj) {
+                             if (*obj < absl::ZeroDuration()) {
+                               return absl::InvalidArgumentError(
+                                   "Expected non-negative duration");
+                             }
+                             return absl::OkStatus();
+                           })))),
+        jb::Member("stale_while_revalidate",
+                   jb::Projection<&KvsDriverSpec::stale_while_revalidate>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                           [](auto* obj) { *obj = absl::ZeroDuration(); },
+                           jb::Validate([](const auto& options,
+                                           const absl::Duration* obj) {
+                             if (*obj < absl::ZeroDuration()) {
+                               return absl::InvalidArgumentError(
+                                   "Expected non-negative duration");
+                             }
+                             return absl::OkStatus();
+                           })))),
         internal::OpenModeSpecJsonBinder));
 
 }  // namespace internal_kvs_backed_chunk_driver
@@ -25,6 +25,7 @@
 #include <string_view>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/box.h"
 #include "tensorstore/driver/chunk_cache_driver.h"
 #include "tensorstore/driver/driver.h"
@@ -35,7 +36,10 @@
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/async_initialized_cache_mixin.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/compression/codec_accelerator_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+#include "tensorstore/internal/cache/chunk_read_ahead.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
@@ -66,12 +70,34 @@ struct KvsDriverSpec : public internal::DriverSpec,
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
   Context::Resource<internal::CachePoolResource> cache_pool;
+  Context::Resource<internal::CodecAcceleratorResource> codec_accelerator;
   StalenessBounds staleness;
+  internal::ChunkReadAheadOptions read_ahead;
+  size_t encoded_cache_bytes = 0;
+  internal::WritebackDelayOptions writeback_delay;
+
+  /// Maintain an in-memory summary of the stored chunks, from which storage
+  /// statistics are computed.
+  bool chunk_presence_cache = false;
+
+  /// Metadata reads in progress that were issued no earlier than this
+  /// duration before the metadata staleness bound are shared rather than
+  /// repeated, and metadata found to be absent no earlier than this duration
+  /// before the staleness bound is assumed to still be absent.
+  absl::Duration metadata_coalescing_window = absl::ZeroDuration();
+
+  /// Cached metadata and data that is older than the staleness bound by no
+  /// more than this duration is returned without waiting, and revalidated in
+  /// the background.
+  absl::Duration stale_while_revalidate = absl::ZeroDuration();
 
   static constexpr auto ApplyMembers = [](auto& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x),
              internal::BaseCast<internal::OpenModeSpec>(x), x.store,
-             x.data_copy_concurrency, x.cache_pool, x.staleness);
+             x.data_copy_concurrency, x.cache_pool, x.codec_accelerator,
+             x.staleness, x.read_ahead, x.encoded_cache_bytes,
+             x.writeback_delay, x.chunk_presence_cache,
+             x.metadata_coalescing_window, x.stale_while_revalidate);
   };
 
   kvstore::Spec GetKvstore() const override;
@@ -139,6 +165,7 @@ class MetadataCache
     Context::Resource<internal::DataCopyConcurrencyResource>
         data_copy_concurrency;
     Context::Resource<internal::CachePoolResource> cache_pool;
+    Context::Resource<internal::CodecAcceleratorResource> codec_accelerator;
   };
 
   explicit MetadataCache(Initializer initializer);
@@ -261,6 +288,12 @@ class MetadataCache
 
   const Executor& executor() { return data_copy_concurrency_->executor; }
 
+  /// Returns the accelerator with which data chunks are encoded and decoded,
+  /// or `nullptr` to use the accelerator installed process-wide.
+  const std::shared_ptr<internal::CodecAccelerator>& codec_accelerator() {
+    return codec_accelerator_->accelerator;
+  }
+
   /// Key-value store from which `kvstore_driver()` was derived.  Used only by
   /// `GetBoundSpecData`.  A driver implementation may apply some type of
   /// adapter to the `kvstore_driver()` in order to retrieve metadata by
@@ -270,6 +303,7 @@ class MetadataCache
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
+  Context::Resource<internal::CodecAcceleratorResource> codec_accelerator_;
 };
 
 /// Abstract base class for `Cache` types that are used with
@@ -372,6 +406,21 @@ class DataCacheBase {
   /// Returns the kvstore path to include in the spec.
   virtual std::string GetBaseKvstorePath() = 0;
 
+  /// Returns the limit on the total size of retained encoded chunks, or `0` if
+  /// encoded chunks are not retained.
+  virtual size_t encoded_cache_bytes() const { return 0; }
+
+  /// Returns the options for delayed writeback of non-transactional writes.
+  virtual internal::WritebackDelayOptions writeback_delay() const {
+    return {};
+  }
+
+  /// Returns the summary of the stored chunks, or `nullptr` if not maintained.
+  virtual std::shared_ptr<internal::ChunkPresenceSummary>
+  chunk_presence_summary() const {
+    return nullptr;
+  }
+
   MetadataCache* metadata_cache() const {
     return &GetOwningCache(*metadata_cache_entry_);
   }
@@ -466,6 +515,18 @@ class ChunkedDataCacheBase : public DataCacheBase {
 
 struct DataCacheInitializer : public ChunkedDataCacheBase::Initializer {
   kvstore::DriverPtr store;
+
+  /// Limit on the total size of retained encoded chunks, see
+  /// `KvsBackedChunkCache::SetEncodedCacheBytes`.
+  size_t encoded_cache_bytes = 0;
+
+  /// Options for delayed writeback of non-transactional writes, see
+  /// `ChunkCache::SetWritebackDelay`.
+  internal::WritebackDelayOptions writeback_delay;
+
+  /// Whether to maintain a summary of the stored chunks, see
+  /// `KvsBackedChunkCache::SetChunkPresenceSummary`.
+  bool chunk_presence_cache = false;
 };
 
 /// Combines `KvsBackedChunkCache` with `ChunkedDataCacheBase`.
@@ -487,6 +548,19 @@ class DataCache : public internal::KvsBackedChunkCache,
 
   const internal::ChunkGridSpecification& grid() const final { return grid_; }
 
+  size_t encoded_cache_bytes() const final {
+    return KvsBackedChunkCache::encoded_cache_bytes();
+  }
+
+  internal::WritebackDelayOptions writeback_delay() const final {
+    return KvsBackedChunkCache::writeback_delay();
+  }
+
+  std::shared_ptr<internal::ChunkPresenceSummary> chunk_presence_summary()
+      const final {
+    return KvsBackedChunkCache::chunk_presence_summary();
+  }
+
   Future<const void> DeleteCell(span<const Index> grid_cell_indices,
                                 internal::OpenTransactionPtr transaction) final;
 
@@ -560,10 +634,20 @@ class KvsMetadataDriverBase : public internal::Driver {
 
   virtual const StalenessBound& data_staleness_bound() const = 0;
 
+  /// Returns the read-ahead options with which the driver was opened.
+  virtual internal::ChunkReadAheadOptions read_ahead_options() const = 0;
+
+  /// Returns the `stale_while_revalidate` duration used for both metadata and
+  /// data reads.
+  virtual absl::Duration stale_while_revalidate() const = 0;
+
   // Treat as private:
 
   StalenessBound metadata_staleness_bound_;
 
+  /// Specifies `AsyncCacheReadRequest::coalescing_window` for metadata reads.
+  absl::Duration metadata_coalescing_window_ = absl::ZeroDuration();
+
   /// If `OpenMode::assume_metadata` or `OpenMode::assume_cached_metadata` was
   /// specified, set to the assumed metadata.  Otherwise, set to `nullptr`.
   std::shared_ptr<const void> assumed_metadata_;
@@ -50,7 +50,9 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/grid_storage_statistics.h"
+#include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/open_mode.h"
@@ -159,8 +161,8 @@ class N5DriverSpec
 
 Result<std::shared_ptr<const N5Metadata>> ParseEncodedMetadata(
     std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
+  nlohmann::json raw_data = internal_json::ParseJson(encoded_value);
   if (raw_data.is_discarded()) {
     return absl::FailedPreconditionError("Invalid JSON");
   }
@@ -387,6 +389,11 @@ class N5Driver : public N5DriverBase {
                   static_cast<const N5Metadata*>(future.value().get());
               auto& grid = cache->grid();
               auto& component = grid.components[0];
+              // The summary does not reflect uncommitted writes.
+              std::shared_ptr<internal::ChunkPresenceSummary> chunk_presence;
+              if (!request.transaction) {
+                chunk_presence = cache->chunk_presence_summary();
+              }
               LinkResult(
                   std::move(promise),
                   internal::GetStorageStatisticsForRegularGridWithBase10Keys(
@@ -399,7 +406,7 @@ class N5Driver : public N5DriverBase {
                       /*chunk_shape=*/grid.chunk_shape,
                       /*shape=*/metadata->shape,
                       /*dimension_separator=*/'/', staleness_bound,
-                      request.options));
+                      request.options, std::move(chunk_presence)));
             }),
         std::move(promise),
         ResolveMetadata(std::move(transaction),
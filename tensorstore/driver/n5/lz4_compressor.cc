@@ -0,0 +1,56 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \file
+///
+/// Defines the "lz4" compressor for n5.  Linking in this library
+/// automatically registers it.
+///
+/// The encoded format is that of `net.jpountz.lz4.LZ4BlockOutputStream`, as
+/// used by the Java `Lz4Compression`.
+
+#include "tensorstore/internal/compression/lz4_compressor.h"
+
+#include <stddef.h>
+
+#include "tensorstore/driver/n5/compressor_registry.h"
+#include "tensorstore/internal/compression/lz4.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+
+namespace tensorstore {
+namespace internal_n5 {
+namespace {
+
+using ::tensorstore::internal::Lz4BlockStreamCompressor;
+namespace jb = ::tensorstore::internal_json_binding;
+
+struct Registration {
+  Registration() {
+    RegisterCompressor<Lz4BlockStreamCompressor>(
+        "lz4",
+        jb::Object(jb::Member(
+            "blockSize",
+            jb::Projection(
+                &Lz4BlockStreamCompressor::block_size,
+                jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                    [](auto* v) { *v = lz4::kDefaultBlockSize; },
+                    jb::Integer<size_t>(lz4::kMinBlockSize,
+                                        lz4::kMaxBlockSize))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_n5
+}  // namespace tensorstore
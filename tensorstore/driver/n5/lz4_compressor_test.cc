@@ -0,0 +1,79 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/n5/compressor.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_n5::Compressor;
+
+// Tests that an input spanning multiple blocks round trips.
+TEST(Lz4CompressorTest, MultiBlockRoundtrip) {
+  auto compressor =
+      Compressor::FromJson({{"type", "lz4"}, {"blockSize", 64}}).value();
+  absl::Cord input;
+  for (int i = 0; i < 10; ++i) {
+    input.Append("The quick brown fox jumped over the lazy dog.");
+  }
+  absl::Cord encode_result, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encode_result, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+}
+
+// Tests that the encoded output matches `LZ4BlockOutputStream`.
+TEST(Lz4CompressorTest, Golden) {
+  auto compressor = Compressor::FromJson({{"type", "lz4"}}).value();
+  const absl::Cord input("abc");
+  absl::Cord encode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  // The default block size of 65536 corresponds to a compression level of 6.
+  EXPECT_EQ(absl::Cord(std::string_view("LZ4Block\x16"
+                                        "\x03\x00\x00\x00"
+                                        "\x03\x00\x00\x00"
+                                        "\x22\xb2\x4c\x0d"
+                                        "abc"
+                                        "LZ4Block\x16"
+                                        "\x00\x00\x00\x00"
+                                        "\x00\x00\x00\x00"
+                                        "\x00\x00\x00\x00",
+                                        24 + 21)),
+            encode_result);
+}
+
+// Tests that an invalid parameter gives an error.
+TEST(Lz4CompressorTest, InvalidParameter) {
+  EXPECT_THAT(Compressor::FromJson({{"type", "lz4"}, {"blockSize", 32}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"blockSize\": .*"));
+  EXPECT_THAT(Compressor::FromJson({{"type", "lz4"}, {"foo", 10}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Object includes extra members: \"foo\""));
+}
+
+TEST(Lz4CompressorTest, ToJson) {
+  auto compressor = Compressor::FromJson({{"type", "lz4"}}).value();
+  EXPECT_EQ(nlohmann::json({{"type", "lz4"}, {"blockSize", 65536}}),
+            compressor.ToJson());
+}
+
+}  // namespace
@@ -30,6 +30,8 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
@@ -44,6 +46,7 @@
 #include "tensorstore/codec_spec_registry.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/codec_metrics.h"
 #include "tensorstore/driver/n5/compressor.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dimension_units.h"
@@ -57,6 +60,7 @@
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/json_metadata_matching.h"
 #include "tensorstore/internal/riegeli/array_endian_codec.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/schema.h"
@@ -219,8 +223,9 @@ size_t GetChunkHeaderSize(const N5Metadata& metadata) {
       sizeof(uint32_t) * metadata.rank;  // dimensions
 }
 
-Result<SharedArray<const void>> DecodeChunk(const N5Metadata& metadata,
-                                            absl::Cord buffer) {
+namespace {
+Result<SharedArray<const void>> DecodeChunkImpl(const N5Metadata& metadata,
+                                                absl::Cord buffer) {
   // TODO(jbms): Currently, we do not check that `buffer.size()` is less than
   // the 2GiB limit, although we do implicitly check that the decoded array data
   // within the chunk is within the 2GiB limit due to the checks on the block
@@ -270,12 +275,23 @@ Result<SharedArray<const void>> DecodeChunk(const N5Metadata& metadata,
                               tensorstore::span(metadata.chunk_shape)));
     }
   }
+  const bool is_full_chunk = absl::c_equal(encoded_shape, metadata.chunk_shape);
+  if (metadata.compressor && is_full_chunk) {
+    // Decompress directly into the output array.
+    const absl::Cord encoded = buffer.Subcord(header_size, buffer.size());
+    return internal::DecodeArrayEndian(
+        [&](span<char> decoded) {
+          return metadata.compressor->DecodeInto(encoded, decoded,
+                                                 metadata.dtype.size());
+        },
+        metadata.dtype, metadata.chunk_shape, endian::big, fortran_order);
+  }
   if (metadata.compressor) {
     reader = metadata.compressor->GetReader(std::move(reader),
                                             metadata.dtype.size());
   }
   SharedArray<const void> decoded_array;
-  if (absl::c_equal(encoded_shape, metadata.chunk_shape)) {
+  if (is_full_chunk) {
     // Decode full array.
     TENSORSTORE_ASSIGN_OR_RETURN(
         decoded_array, internal::DecodeArrayEndian(*reader, metadata.dtype,
@@ -296,9 +312,24 @@ Result<SharedArray<const void>> DecodeChunk(const N5Metadata& metadata,
   }
   return decoded_array;
 }
+}  // namespace
 
-Result<absl::Cord> EncodeChunk(const N5Metadata& metadata,
-                               SharedArrayView<const void> array) {
+Result<SharedArray<const void>> DecodeChunk(const N5Metadata& metadata,
+                                            absl::Cord buffer) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
+  const absl::Time start_time = absl::Now();
+  auto result = DecodeChunkImpl(metadata, std::move(buffer));
+  if (result.ok()) {
+    internal::RecordCodecDecodeMetric(
+        "n5", result->num_elements() * result->dtype().size(),
+        absl::Now() - start_time);
+  }
+  return result;
+}
+
+namespace {
+Result<absl::Cord> EncodeChunkImpl(const N5Metadata& metadata,
+                                   SharedArrayView<const void> array) {
   assert(absl::c_equal(metadata.chunk_shape, array.shape()));
   absl::Cord encoded;
   std::unique_ptr<riegeli::Writer> writer =
@@ -328,6 +359,20 @@ Result<absl::Cord> EncodeChunk(const N5Metadata& metadata,
   if (!writer->Close()) return writer->status();
   return encoded;
 }
+}  // namespace
+
+Result<absl::Cord> EncodeChunk(const N5Metadata& metadata,
+                               SharedArrayView<const void> array) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kEncode);
+  const absl::Time start_time = absl::Now();
+  const size_t decoded_bytes = array.num_elements() * array.dtype().size();
+  auto result = EncodeChunkImpl(metadata, std::move(array));
+  if (result.ok()) {
+    internal::RecordCodecEncodeMetric("n5", decoded_bytes,
+                                      absl::Now() - start_time);
+  }
+  return result;
+}
 
 absl::Status ValidateMetadata(const N5Metadata& metadata,
                               const N5MetadataConstraints& constraints) {
@@ -42,6 +42,7 @@
 #include "tensorstore/internal/image/png_reader.h"
 #include "tensorstore/internal/image/png_writer.h"
 #include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/util/endian.h"
 #include "tensorstore/util/extents.h"
@@ -236,6 +237,7 @@ Result<SharedArray<const void>> DecodeChunk(span<const Index> chunk_indices,
                                             size_t scale_index,
                                             StridedLayoutView<4> chunk_layout,
                                             absl::Cord buffer) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
   const auto& scale_metadata = metadata.scales[scale_index];
   std::array<Index, 4> chunk_shape;
   GetChunkShape(chunk_indices, metadata, scale_index, chunk_layout.shape(),
@@ -350,6 +352,7 @@ Result<absl::Cord> EncodeChunk(span<const Index> chunk_indices,
                                const MultiscaleMetadata& metadata,
                                size_t scale_index,
                                const SharedArrayView<const void>& array) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kEncode);
   const auto& scale_metadata = metadata.scales[scale_index];
   std::array<Index, 4> partial_chunk_shape;
   GetChunkShape(chunk_indices, metadata, scale_index,
@@ -31,6 +31,7 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -67,11 +68,14 @@
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
 #include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/grid_storage_statistics.h"
+#include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/neuroglancer_uint64_sharded/neuroglancer_uint64_sharded.h"
+#include "tensorstore/kvstore/neuroglancer_uint64_sharded/uint64_sharded.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
@@ -174,8 +178,8 @@ class NeuroglancerPrecomputedDriverSpec
 
 Result<std::shared_ptr<const MultiscaleMetadata>> ParseEncodedMetadata(
     std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
+  nlohmann::json raw_data = internal_json::ParseJson(encoded_value);
   if (raw_data.is_discarded()) {
     return absl::FailedPreconditionError("Invalid JSON");
   }
@@ -560,6 +564,9 @@ class UnshardedDataCache : public DataCacheBase {
     if (!path.empty()) {
       path += '/';
     }
+    // The summary does not reflect uncommitted writes.
+    std::shared_ptr<internal::ChunkPresenceSummary> chunk_presence;
+    if (!request.transaction) chunk_presence = this->chunk_presence_summary();
     return internal::
         GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
             KvStore{kvstore::DriverPtr(this->kvstore_driver()), std::move(path),
@@ -569,7 +576,7 @@ class UnshardedDataCache : public DataCacheBase {
             component.chunked_to_cell_dimensions,
             /*chunk_shape=*/grid.chunk_shape, grid_bounds,
             std::make_unique<KeyFormatter>(*this), staleness_bound,
-            request.options);
+            request.options, std::move(chunk_presence));
   }
 
  private:
@@ -625,6 +632,75 @@ class ShardedDataCache : public DataCacheBase {
     return absl::UnimplementedError("");
   }
 
+  /// Reads all chunks within a single batch, unless `request.batch` is
+  /// specified.
+  ///
+  /// This allows the shard index entries, minishard indices, and chunk data
+  /// needed for the chunks of each shard to each be fetched with a single
+  /// batched request, rather than separately for each chunk.
+  void Read(ReadRequest request,
+            AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>
+                receiver) override {
+    if (!request.batch) request.batch = Batch::New();
+    return DataCacheBase::Read(std::move(request), std::move(receiver));
+  }
+
+  /// Writes each chunk within a single implicit transaction per shard, unless
+  /// `request.transaction` is specified.
+  ///
+  /// Otherwise, each chunk would be written back in a separate implicit
+  /// transaction, and each of those would separately rewrite the entire shard
+  /// containing it, with concurrent rewrites of the same shard conflicting.
+  /// Grouping by shard ensures the chunks of a shard covered by a single write
+  /// request are merged into one shard rewrite.
+  void Write(
+      WriteRequest request,
+      AnyFlowReceiver<absl::Status, internal::WriteChunk, IndexTransform<>>
+          receiver) override {
+    if (request.transaction) {
+      return DataCacheBase::Write(std::move(request), std::move(receiver));
+    }
+    const auto& scale = metadata().scales[scale_index_];
+    const auto& sharding_spec = std::get<ShardingSpec>(scale.sharding);
+    const auto chunk_size = chunk_size_xyz();
+    const DimensionIndex chunked_to_cell_dimensions[] = {3, 2, 1};
+    using State = internal::ChunkOperationState<internal::WriteChunk>;
+    using ForwardingReceiver =
+        internal::ForwardingChunkOperationReceiver<State>;
+    auto state = internal::MakeIntrusivePtr<State>(std::move(receiver));
+    absl::flat_hash_map<uint64_t, internal::OpenTransactionPtr>
+        shard_transactions;
+    auto status = internal::PartitionIndexTransformOverRegularGrid(
+        chunked_to_cell_dimensions, chunk_size, request.transform,
+        [&](span<const Index> grid_cell_indices,
+            IndexTransformView<> cell_transform) -> absl::Status {
+          if (state->cancelled()) {
+            return absl::CancelledError("");
+          }
+          const uint64_t chunk_id = EncodeCompressedZIndex(
+              {grid_cell_indices.data(), 3}, compressed_z_index_bits_);
+          const uint64_t shard =
+              neuroglancer_uint64_sharded::GetSplitShardInfo(
+                  sharding_spec, neuroglancer_uint64_sharded::GetChunkShardInfo(
+                                     sharding_spec, {chunk_id}))
+                  .shard;
+          auto& shard_transaction = shard_transactions[shard];
+          if (!shard_transaction) {
+            shard_transaction = internal::TransactionState::MakeImplicit();
+            shard_transaction->RequestCommit();
+          }
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              auto cell_to_source,
+              ComposeTransforms(request.transform, cell_transform));
+          DataCacheBase::Write(
+              {{shard_transaction, std::move(cell_to_source)},
+               request.component_index},
+              ForwardingReceiver{state, cell_transform});
+          return absl::OkStatus();
+        });
+    if (!status.ok()) state->SetError(std::move(status));
+  }
+
   std::array<int, 3> compressed_z_index_bits_;
 };
 
@@ -677,7 +753,7 @@ class RegularlyShardedDataCache : public ShardedDataCache {
           if (!shard_batch) shard_batch = Batch::New();
           return ShardedDataCache::Read(
               {{request.transaction, std::move(transform),
-                std::move(shard_batch)},
+                std::move(shard_batch), request.io_stats},
                request.component_index,
                request.staleness_bound},
               std::move(receiver));
@@ -700,7 +776,8 @@ class RegularlyShardedDataCache : public ShardedDataCache {
             shard_transaction->RequestCommit();
           }
           return ShardedDataCache::Write(
-              {{std::move(shard_transaction), std::move(transform)},
+              {{std::move(shard_transaction), std::move(transform),
+                request.io_stats},
                request.component_index},
               std::move(receiver));
         });
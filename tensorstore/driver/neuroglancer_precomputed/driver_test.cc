@@ -47,6 +47,7 @@
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/internal/parse_json_matches.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/memory/memory_key_value_store.h"
@@ -1505,6 +1506,68 @@ TEST(ShardedWriteTest, Basic) {
   EXPECT_THAT(tensorstore::Read(store).result(), ::testing::Optional(array));
 }
 
+TEST(ShardedReadTest, IoStats) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({
+                            {"driver", "neuroglancer_precomputed"},
+                            {"kvstore", {{"driver", "memory"}}},
+                            {"cache_pool", {{"total_bytes_limit", 1000000}}},
+                            {"recheck_cached_data", false},
+                            {"multiscale_metadata",
+                             {
+                                 {"data_type", "uint16"},
+                                 {"num_channels", 2},
+                                 {"type", "image"},
+                             }},
+                            {"scale_metadata",
+                             {
+                                 {"resolution", {1, 1, 1}},
+                                 {"encoding", "raw"},
+                                 {"chunk_size", {3, 4, 5}},
+                                 {"size", {4, 5, 1}},
+                                 {"voxel_offset", {0, 0, 0}},
+                                 {"sharding",
+                                  {{"@type", "neuroglancer_uint64_sharded_v1"},
+                                   {"preshift_bits", 1},
+                                   {"minishard_bits", 2},
+                                   {"shard_bits", 3},
+                                   {"hash", "identity"}}},
+                             }},
+                            {"create", true},
+                        })
+          .result());
+
+  // The first read misses the cache and reads all 4 (missing) chunks.
+  auto read_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(tensorstore::Read(store, read_stats).result());
+  auto counters = read_stats.Get();
+  EXPECT_EQ(4, counters.kvstore_reads);
+  EXPECT_EQ(0, counters.bytes_read);
+  EXPECT_EQ(4, counters.cache_misses);
+  EXPECT_EQ(0, counters.cache_hits);
+
+  // The second read is satisfied by the cache.
+  auto reread_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(tensorstore::Read(store, reread_stats).result());
+  counters = reread_stats.Get();
+  EXPECT_EQ(0, counters.kvstore_reads);
+  EXPECT_EQ(4, counters.cache_hits);
+  EXPECT_EQ(0, counters.cache_misses);
+
+  // Writeback of each modified chunk is attributed to the write.
+  auto write_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint16_t>(42), store,
+                         write_stats)
+          .commit_future.result());
+  counters = write_stats.Get();
+  EXPECT_EQ(4, counters.kvstore_writes);
+  EXPECT_LT(0, counters.bytes_written);
+  EXPECT_EQ(counters.bytes_written, counters.bytes_encoded);
+  EXPECT_EQ(0, read_stats.Get().kvstore_writes);
+}
+
 TEST(FullShardWriteTest, WithTransaction) {
   auto context = Context::Default();
 
@@ -1690,6 +1753,156 @@ TEST(FullShardWriteTest, WithoutTransaction) {
   TENSORSTORE_ASSERT_OK(future);
 }
 
+// Tests that a non-transactional write to multiple chunks of a
+// non-rectangular shard results in a single shard writeback.
+TEST(ShardedWriteTest, NonRectangularShardWrittenOnce) {
+  auto context = Context::Default();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_key_value_store = *mock_key_value_store_resource;
+
+  ::nlohmann::json json_spec{
+      {"driver", "neuroglancer_precomputed"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"create", true},
+      {"multiscale_metadata",
+       {
+           {"data_type", "uint16"},
+           {"num_channels", 1},
+           {"type", "image"},
+       }},
+      {"scale_metadata",
+       {
+           {"key", "1_1_1"},
+           {"resolution", {1, 1, 1}},
+           {"encoding", "raw"},
+           {"chunk_size", {2, 2, 2}},
+           {"size", {4, 6, 10}},
+           {"voxel_offset", {0, 0, 0}},
+           {"sharding",
+            {{"@type", "neuroglancer_uint64_sharded_v1"},
+             {"preshift_bits", 1},
+             {"minishard_bits", 2},
+             {"shard_bits", 0},
+             {"data_encoding", "raw"},
+             {"minishard_index_encoding", "raw"},
+             {"hash", "murmurhash3_x86_128"}}},
+       }},
+  };
+
+  auto store_future = tensorstore::Open(json_spec, context);
+  store_future.Force();
+
+  {
+    auto req = mock_key_value_store->read_requests.pop();
+    EXPECT_EQ("prefix/info", req.key);
+    req.promise.SetResult(kvstore::ReadResult::Missing(absl::Now()));
+  }
+
+  {
+    auto req = mock_key_value_store->write_requests.pop();
+    EXPECT_EQ("prefix/info", req.key);
+    req.promise.SetResult(TimestampedStorageGeneration{
+        StorageGeneration::FromString("g0"), absl::Now()});
+  }
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, store_future.result());
+
+  // Writes 4 chunks, all of which are in shard 0.
+  auto future = tensorstore::Write(
+      tensorstore::MakeScalarArray<uint16_t>(42),
+      store | tensorstore::Dims(0, 1, 2).SizedInterval({0, 0, 0}, {4, 4, 2}));
+
+  future.Force();
+
+  {
+    auto req = mock_key_value_store->read_requests.pop();
+    EXPECT_EQ("prefix/1_1_1/0.shard", req.key);
+    req.promise.SetResult(kvstore::ReadResult::Missing(absl::Now()));
+  }
+
+  {
+    auto req = mock_key_value_store->write_requests.pop();
+    EXPECT_EQ("prefix/1_1_1/0.shard", req.key);
+    EXPECT_EQ(StorageGeneration::NoValue(),
+              req.options.generation_conditions.if_equal);
+    req.promise.SetResult(TimestampedStorageGeneration{
+        StorageGeneration::FromString("g1"), absl::Now()});
+  }
+
+  TENSORSTORE_ASSERT_OK(future);
+  EXPECT_TRUE(mock_key_value_store->read_requests.empty());
+  EXPECT_TRUE(mock_key_value_store->write_requests.empty());
+}
+
+// Tests that reading multiple chunks of a non-rectangular shard without an
+// explicit batch still batches the shard index, minishard index, and data
+// requests.
+TEST(ShardedReadTest, NonRectangularShardBatched) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_key_value_store = *mock_key_value_store_resource;
+  mock_key_value_store->forward_to = tensorstore::GetMemoryKeyValueStore();
+  mock_key_value_store->log_requests = true;
+  mock_key_value_store->handle_batch_requests = true;
+
+  ::nlohmann::json json_spec{
+      {"driver", "neuroglancer_precomputed"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"multiscale_metadata",
+       {
+           {"data_type", "uint16"},
+           {"num_channels", 1},
+           {"type", "image"},
+       }},
+      {"scale_metadata",
+       {
+           {"key", "1_1_1"},
+           {"resolution", {1, 1, 1}},
+           {"encoding", "raw"},
+           {"chunk_size", {2, 2, 2}},
+           {"size", {4, 6, 10}},
+           {"voxel_offset", {0, 0, 0}},
+           {"sharding",
+            {{"@type", "neuroglancer_uint64_sharded_v1"},
+             {"preshift_bits", 1},
+             {"minishard_bits", 2},
+             {"shard_bits", 0},
+             {"data_encoding", "raw"},
+             {"minishard_index_encoding", "raw"},
+             {"hash", "murmurhash3_x86_128"}}},
+       }},
+  };
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(json_spec, context, tensorstore::OpenMode::create)
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint16_t>(42), store));
+  mock_key_value_store->request_log.pop_all();
+
+  TENSORSTORE_ASSERT_OK(tensorstore::Read(store));
+
+  // Expected to result in a single request for the shard index entries,
+  // followed by a single request for the minishard indices, followed by a
+  // single request for the chunk data.
+  EXPECT_THAT(mock_key_value_store->request_log.pop_all(),
+              ::testing::SizeIs(3));
+}
+
 // Tests that an empty path is handled correctly.
 TEST(DriverTest, NoPrefix) {
   auto context = Context::Default();
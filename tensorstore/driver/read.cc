@@ -14,15 +14,23 @@
 
 #include "tensorstore/driver/read.h"
 
+#include <stddef.h>
+
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/array.h"
 #include "tensorstore/batch.h"
 #include "tensorstore/box.h"
+#include "tensorstore/cache_pin.h"
+#include "tensorstore/chunk_layout.h"
 #include "tensorstore/container_kind.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
@@ -31,9 +39,13 @@
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/driver/driver_handle.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/alignment.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/output_index_method.h"
 #include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/cache/cache_pin.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lock_collection.h"
 #include "tensorstore/internal/nditerable.h"
@@ -42,20 +54,30 @@
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/internal/tracing/tracing.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/progress.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/read_write_options.h"
 #include "tensorstore/resize_options.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/element_pointer.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/any_sender.h"
+#include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/execution/sender.h"
+#include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/extents.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal {
@@ -101,6 +123,7 @@ struct ReadState
   DriverPtr source_driver;
   internal::OpenTransactionPtr source_transaction;
   Batch source_batch{no_batch};
+  IoStats io_stats;
   DataTypeConversionLookupResult data_type_conversion;
   TransformedArray<Shared<void>> target;
   DomainAlignmentOptions alignment_options;
@@ -134,9 +157,9 @@ struct ReadChunkOp {
         auto target,
         ApplyIndexTransform(std::move(cell_transform), state->target),
         state->SetError(_));
-    absl::Status copy_status =
-        internal::CopyReadChunk(chunk.impl, std::move(chunk.transform),
-                                state->data_type_conversion, target);
+    absl::Status copy_status = internal::CopyReadChunk(
+        chunk.impl, std::move(chunk.transform), state->data_type_conversion,
+        target, state->executor);
     if (copy_status.ok()) {
       state->UpdateProgress(ProductOfExtents(target.shape()));
     } else {
@@ -189,6 +212,7 @@ struct DriverReadIntoExistingInitiateOp {
     Driver::ReadRequest request;
     request.transaction = std::move(state->source_transaction);
     request.batch = std::move(state->source_batch);
+    request.io_stats = state->io_stats;
     request.transform = std::move(source_transform);
     source_driver->Read(std::move(request),
                         ReadChunkReceiver<void>{std::move(state)});
@@ -225,6 +249,7 @@ struct DriverReadIntoNewInitiateOp {
     Driver::ReadRequest request;
     request.transaction = std::move(state->source_transaction);
     request.batch = std::move(state->source_batch);
+    request.io_stats = state->io_stats;
     request.transform = std::move(source_transform);
     source_driver->Read(
         std::move(request),
@@ -232,6 +257,325 @@ struct DriverReadIntoNewInitiateOp {
   }
 };
 
+/// FlowReceiver used by `DriverPrefetch`, which discards all chunks.
+struct PrefetchChunkReceiver {
+  Promise<void> promise;
+  FutureCallbackRegistration cancel_registration;
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration = promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+  void set_stopping() { cancel_registration(); }
+  void set_done() {}
+  void set_error(absl::Status error) {
+    SetDeferredResult(promise, std::move(error));
+  }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {}
+};
+
+/// Callback used by `DriverPrefetch` to initiate the read once the source
+/// transform bounds have been resolved.
+struct DriverPrefetchInitiateOp {
+  DriverPtr source_driver;
+  internal::OpenTransactionPtr source_transaction;
+  Batch source_batch{no_batch};
+  void operator()(Promise<void> promise,
+                  ReadyFuture<IndexTransform<>> source_transform_future) {
+    Driver::ReadRequest request;
+    request.transaction = std::move(source_transaction);
+    request.batch = std::move(source_batch);
+    request.transform = std::move(source_transform_future.value());
+    auto driver = std::move(source_driver);
+    driver->Read(std::move(request), PrefetchChunkReceiver{std::move(promise)});
+  }
+};
+
+/// FlowReceiver used by `DriverPin`, which discards all chunks.  The cache
+/// entries are pinned by the chunk cache.
+struct PinChunkReceiver {
+  Promise<CachePin> promise;
+  FutureCallbackRegistration cancel_registration;
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration = promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+  void set_stopping() { cancel_registration(); }
+  void set_done() {}
+  void set_error(absl::Status error) {
+    SetDeferredResult(promise, std::move(error));
+  }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {}
+};
+
+/// Callback used by `DriverPin` to initiate the read once the source transform
+/// bounds have been resolved.
+struct DriverPinInitiateOp {
+  DriverPtr source_driver;
+  CachePinSetPtr pin_set;
+  Batch source_batch{no_batch};
+  void operator()(Promise<CachePin> promise,
+                  ReadyFuture<IndexTransform<>> source_transform_future) {
+    Driver::ReadRequest request;
+    request.batch = std::move(source_batch);
+    request.transform = std::move(source_transform_future.value());
+    request.pin_set = std::move(pin_set);
+    auto driver = std::move(source_driver);
+    driver->Read(std::move(request), PinChunkReceiver{std::move(promise)});
+  }
+};
+
+/// FlowReceiver used by `DriverReadChunks`, which wraps each chunk in a
+/// `ReadChunkView`.
+struct ReadChunkViewReceiver {
+  DataType dtype;
+  AnyFlowReceiver<absl::Status, ReadChunkView> receiver;
+  void set_starting(AnyCancelReceiver cancel) {
+    execution::set_starting(receiver, std::move(cancel));
+  }
+  void set_stopping() { execution::set_stopping(receiver); }
+  void set_done() { execution::set_done(receiver); }
+  void set_error(absl::Status error) {
+    execution::set_error(receiver, std::move(error));
+  }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {
+    execution::set_value(receiver, ReadChunkView(dtype, std::move(chunk),
+                                                 std::move(cell_transform)));
+  }
+};
+
+/// FlowSender returned by `DriverReadChunks`.
+struct DriverReadChunksSender {
+  DriverPtr source_driver;
+  IndexTransform<> source_transform;
+  internal::OpenTransactionPtr source_transaction;
+  Batch source_batch{no_batch};
+
+  void submit(AnyFlowReceiver<absl::Status, ReadChunkView> receiver) {
+    // Resolve the bounds for `source_transform`.
+    Driver::ResolveBoundsRequest request;
+    request.transaction = source_transaction;
+    request.transform = source_transform;
+    request.options = fix_resizable_bounds;
+    auto transform_future = source_driver->ResolveBounds(std::move(request));
+
+    // Initiate the read once the bounds have been resolved.
+    auto executor = source_driver->data_copy_executor();
+    std::move(transform_future)
+        .ExecuteWhenReady(WithExecutor(
+            std::move(executor),
+            [driver = source_driver, transaction = source_transaction,
+             batch = source_batch, receiver = std::move(receiver)](
+                ReadyFuture<IndexTransform<>> future) mutable {
+              auto& result = future.result();
+              if (!result.ok()) {
+                execution::submit(
+                    FlowSingleSender{ErrorSender{result.status()}},
+                    std::move(receiver));
+                return;
+              }
+              Driver::ReadRequest request;
+              request.transaction = std::move(transaction);
+              request.batch = std::move(batch);
+              request.transform = *std::move(result);
+              auto dtype = driver->dtype();
+              driver->Read(std::move(request),
+                           ReadChunkViewReceiver{dtype, std::move(receiver)});
+            }));
+  }
+};
+
+/// State of a `DriverForEachChunk` operation.
+///
+/// Each cell of the read chunk grid that intersects `domain` is read as a
+/// separate region, in C order of the grid cells.  Regions are identified by
+/// their linear index in `cells`.
+struct ForEachChunkState
+    : public internal::AtomicReferenceCount<ForEachChunkState> {
+  Executor executor;
+  DriverPtr driver;
+  internal::OpenTransactionPtr transaction;
+  IndexTransform<> transform;
+  ForEachChunkCallback callback;
+  size_t total_bytes_limit;
+  Promise<void> promise;
+  Box<> domain;
+  std::vector<Index> grid_origin;
+  std::vector<Index> chunk_shape;
+  /// Range of grid cells that intersect `domain`.
+  Box<> cells;
+
+  absl::Mutex mutex;
+  size_t in_flight_bytes ABSL_GUARDED_BY(mutex) = 0;
+  Index next_region ABSL_GUARDED_BY(mutex) = 0;
+  bool done ABSL_GUARDED_BY(mutex) = false;
+
+  void SetError(absl::Status error) {
+    {
+      absl::MutexLock lock(&mutex);
+      done = true;
+    }
+    SetDeferredResult(promise, std::move(error));
+  }
+
+  /// Returns the portion of `domain` within the grid cell with the specified
+  /// linear index.
+  Box<> GetRegion(Index region_index) const {
+    Box<> region(domain.rank());
+    for (DimensionIndex dim = domain.rank(); dim--;) {
+      const Index num_cells = cells.shape()[dim];
+      const Index cell = cells.origin()[dim] + region_index % num_cells;
+      region_index /= num_cells;
+      const Index size = chunk_shape[dim];
+      region[dim] = Intersect(
+          IndexInterval::UncheckedSized(grid_origin[dim] + cell * size, size),
+          domain[dim]);
+    }
+    return region;
+  }
+};
+
+void StartForEachChunkRegions(IntrusivePtr<ForEachChunkState> state);
+
+/// Holds a reference to a single region of a `DriverForEachChunk` operation
+/// for as long as the region is being read or any of its chunks is being
+/// processed.
+struct ForEachChunkRegion
+    : public internal::AtomicReferenceCount<ForEachChunkRegion> {
+  IntrusivePtr<ForEachChunkState> state;
+  size_t bytes;
+  ~ForEachChunkRegion() {
+    {
+      absl::MutexLock lock(&state->mutex);
+      state->in_flight_bytes -= bytes;
+    }
+    StartForEachChunkRegions(std::move(state));
+  }
+};
+
+/// FlowReceiver used by `DriverForEachChunk` to invoke the callback for each
+/// chunk of a region.
+struct ForEachChunkReceiver {
+  IntrusivePtr<ForEachChunkRegion> region;
+  FutureCallbackRegistration cancel_registration;
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration =
+        region->state->promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+  void set_stopping() { cancel_registration(); }
+  void set_done() {}
+  void set_error(absl::Status error) {
+    region->state->SetError(std::move(error));
+  }
+  void set_value(ReadChunk chunk, IndexTransform<> cell_transform) {
+    auto& state = *region->state;
+    ReadChunkView view(state.driver->dtype(), std::move(chunk),
+                       std::move(cell_transform));
+    // Defer all work to the executor, because we don't know on which thread
+    // this may be called.
+    state.executor([region = region, view = std::move(view)]() mutable {
+      auto& state = *region->state;
+      if (!state.promise.result_needed()) return;
+      auto status = state.callback(std::move(view));
+      if (!status.ok()) state.SetError(std::move(status));
+    });
+  }
+};
+
+/// Starts as many further regions as `total_bytes_limit` permits.  At least
+/// one region is always in flight until all regions have been started.
+void StartForEachChunkRegions(IntrusivePtr<ForEachChunkState> state) {
+  std::vector<std::pair<Box<>, size_t>> regions;
+  {
+    absl::MutexLock lock(&state->mutex);
+    const Index num_regions = state->cells.num_elements();
+    while (!state->done) {
+      if (!state->promise.result_needed() ||
+          state->next_region == num_regions) {
+        state->done = true;
+        break;
+      }
+      Box<> region = state->GetRegion(state->next_region);
+      const size_t bytes = region.num_elements() * state->driver->dtype()->size;
+      if (state->in_flight_bytes != 0 &&
+          state->in_flight_bytes + bytes > state->total_bytes_limit) {
+        break;
+      }
+      state->in_flight_bytes += bytes;
+      ++state->next_region;
+      regions.emplace_back(std::move(region), bytes);
+    }
+  }
+  for (auto& [region, bytes] : regions) {
+    IntrusivePtr<ForEachChunkRegion> region_state(new ForEachChunkRegion);
+    region_state->state = state;
+    region_state->bytes = bytes;
+    auto transform =
+        ComposeTransforms(state->transform, IdentityTransform(region));
+    if (!transform.ok()) {
+      state->SetError(std::move(transform).status());
+      continue;
+    }
+    Driver::ReadRequest request;
+    request.transaction = state->transaction;
+    request.transform = *std::move(transform);
+    // Chunks of the same region are read as part of a single batch.
+    request.batch = Batch::New();
+    state->driver->Read(std::move(request),
+                        ForEachChunkReceiver{std::move(region_state)});
+  }
+}
+
+/// Callback used by `DriverForEachChunk` to partition the domain once the
+/// bounds have been resolved.
+struct DriverForEachChunkInitiateOp {
+  IntrusivePtr<ForEachChunkState> state;
+  void operator()(Promise<void> promise,
+                  ReadyFuture<IndexTransform<>> transform_future) {
+    state->promise = std::move(promise);
+    state->transform = std::move(transform_future.value());
+    BoxView<> domain = state->transform.domain().box();
+    if (!IsFinite(domain)) {
+      state->SetError(absl::InvalidArgumentError(tensorstore::StrCat(
+          "Reading chunks requires a finite domain, got ",
+          state->transform.domain())));
+      return;
+    }
+    const DimensionIndex rank = domain.rank();
+    state->domain = domain;
+    state->grid_origin.resize(rank);
+    state->chunk_shape.resize(rank);
+    state->cells.set_rank(rank);
+    // Dimensions for which the driver does not specify a read chunk size, as
+    // well as all dimensions if no limit is specified, are not partitioned.
+    auto layout = state->driver->GetChunkLayout(state->transform);
+    for (DimensionIndex dim = 0; dim < rank; ++dim) {
+      const IndexInterval interval = domain[dim];
+      Index origin = kImplicit;
+      Index size = 0;
+      if (state->total_bytes_limit != 0 && layout.ok() &&
+          layout->rank() == rank) {
+        if (!layout->grid_origin().empty()) {
+          origin = layout->grid_origin()[dim];
+        }
+        if (!layout->read_chunk_shape().empty()) {
+          size = layout->read_chunk_shape()[dim];
+        }
+      }
+      if (size <= 0) {
+        origin = interval.inclusive_min();
+        size = std::max(Index(1), interval.size());
+      } else if (origin == kImplicit) {
+        origin = 0;
+      }
+      state->grid_origin[dim] = origin;
+      state->chunk_shape[dim] = size;
+      state->cells[dim] = IndexInterval::UncheckedClosed(
+          FloorOfRatio(interval.inclusive_min() - origin, size),
+          FloorOfRatio(interval.inclusive_max() - origin, size));
+    }
+    if (domain.is_empty()) return;
+    StartForEachChunkRegions(std::move(state));
+  }
+};
+
 }  // namespace
 
 Future<void> DriverRead(Executor executor, DriverHandle source,
@@ -251,10 +595,13 @@ Future<void> DriverRead(Executor executor, DriverHandle source,
       state->source_transaction,
       internal::AcquireOpenTransactionPtrOrError(source.transaction));
   state->source_batch = std::move(options.batch);
+  state->io_stats = std::move(options.io_stats);
   state->target = std::move(target);
   state->alignment_options = options.alignment_options;
   state->read_progress_function = std::move(options.progress_function);
   auto pair = PromiseFuturePair<void>::Make(MakeResult());
+  internal_tracing::Span span("tensorstore.Read");
+  internal_tracing::SpanScope scope(span);
 
   // Resolve the bounds for `source.transform`.
   Driver::ResolveBoundsRequest request;
@@ -268,7 +615,8 @@ Future<void> DriverRead(Executor executor, DriverHandle source,
   LinkValue(WithExecutor(std::move(executor),
                          DriverReadIntoExistingInitiateOp{std::move(state)}),
             std::move(pair.promise), std::move(transform_future));
-  return std::move(pair.future);
+  return internal_tracing::EndSpanWhenReady(std::move(span),
+                                            std::move(pair.future));
 }
 
 Future<void> DriverRead(DriverHandle source,
@@ -295,8 +643,11 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
       state->source_transaction,
       internal::AcquireOpenTransactionPtrOrError(source.transaction));
   state->source_batch = std::move(options.batch);
+  state->io_stats = std::move(options.io_stats);
   state->read_progress_function = std::move(options.progress_function);
   auto pair = PromiseFuturePair<SharedOffsetArray<void>>::Make();
+  internal_tracing::Span span("tensorstore.Read");
+  internal_tracing::SpanScope scope(span);
 
   // Resolve the bounds for `source.transform`.
   Driver::ResolveBoundsRequest request;
@@ -313,7 +664,8 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
                                                      options.target_dtype,
                                                      options.layout_order}),
             std::move(pair.promise), std::move(transform_future));
-  return std::move(pair.future);
+  return internal_tracing::EndSpanWhenReady(std::move(span),
+                                            std::move(pair.future));
 }
 
 Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
@@ -324,10 +676,162 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
       std::move(executor), std::move(source), {std::move(options), dtype});
 }
 
-absl::Status CopyReadChunk(
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()));
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto transaction,
+      internal::AcquireOpenTransactionPtrOrError(source.transaction));
+  auto executor = source.driver->data_copy_executor();
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+  internal_tracing::Span span("tensorstore.Read");
+  internal_tracing::SpanScope scope(span);
+
+  // Resolve the bounds for `source.transform`.
+  Driver::ResolveBoundsRequest request;
+  request.transaction = transaction;
+  request.transform = std::move(source.transform);
+  request.options = fix_resizable_bounds;
+  auto transform_future = source.driver->ResolveBounds(std::move(request));
+
+  // Initiate the read once the bounds have been resolved.
+  LinkValue(WithExecutor(std::move(executor),
+                         DriverPrefetchInitiateOp{std::move(source.driver),
+                                                  std::move(transaction),
+                                                  std::move(options.batch)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+Future<CachePin> DriverPin(DriverHandle source, PinOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()));
+  if (source.transaction != no_transaction) {
+    return absl::InvalidArgumentError(
+        "Cannot pin data through a transaction");
+  }
+  auto executor = source.driver->data_copy_executor();
+  auto pin_set = MakeIntrusivePtr<CachePinSet>();
+  auto pair = PromiseFuturePair<CachePin>::Make(CachePin(pin_set));
+  internal_tracing::Span span("tensorstore.Read");
+  internal_tracing::SpanScope scope(span);
+
+  // Resolve the bounds for `source.transform`.
+  Driver::ResolveBoundsRequest request;
+  request.transform = std::move(source.transform);
+  request.options = fix_resizable_bounds;
+  auto transform_future = source.driver->ResolveBounds(std::move(request));
+
+  // Initiate the read once the bounds have been resolved.
+  LinkValue(WithExecutor(std::move(executor),
+                         DriverPinInitiateOp{std::move(source.driver),
+                                             std::move(pin_set),
+                                             std::move(options.batch)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+ReadChunksSender DriverReadChunks(DriverHandle source,
+                                  ReadChunksOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()),
+      FlowSingleSender{ErrorSender{_}});
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto transaction,
+      internal::AcquireOpenTransactionPtrOrError(source.transaction),
+      FlowSingleSender{ErrorSender{_}});
+  return DriverReadChunksSender{std::move(source.driver),
+                                std::move(source.transform),
+                                std::move(transaction),
+                                std::move(options.batch)};
+}
+
+Future<void> DriverForEachChunk(DriverHandle source,
+                                ForEachChunkCallback callback,
+                                DriverForEachChunkOptions options) {
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal::ValidateSupportsRead(source.driver.read_write_mode()));
+  IntrusivePtr<ForEachChunkState> state(new ForEachChunkState);
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      state->transaction,
+      internal::AcquireOpenTransactionPtrOrError(source.transaction));
+  auto executor = source.driver->data_copy_executor();
+  state->executor = executor;
+  state->driver = std::move(source.driver);
+  state->callback = std::move(callback);
+  state->total_bytes_limit = options.total_bytes_limit;
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+
+  // Resolve the bounds for `source.transform`.
+  Driver::ResolveBoundsRequest request;
+  request.transaction = state->transaction;
+  request.transform = std::move(source.transform);
+  request.options = fix_resizable_bounds;
+  auto transform_future = state->driver->ResolveBounds(std::move(request));
+
+  // Partition the domain once the bounds have been resolved.
+  LinkValue(WithExecutor(std::move(executor),
+                         DriverForEachChunkInitiateOp{std::move(state)}),
+            std::move(pair.promise), std::move(transform_future));
+  return std::move(pair.future);
+}
+
+namespace {
+
+/// Returns `true` if every position of `array` refers to the same element, as
+/// for the broadcast fill value by which missing chunks are represented.
+bool IsBroadcastArray(const TransformedSharedArray<const void>& array) {
+  IndexTransformView<> transform = array.transform();
+  for (DimensionIndex output_dim = 0; output_dim < transform.output_rank();
+       ++output_dim) {
+    auto map = transform.output_index_map(output_dim);
+    switch (map.method()) {
+      case OutputIndexMethod::constant:
+        break;
+      case OutputIndexMethod::single_input_dimension:
+        if (map.stride() != 0 &&
+            transform.input_shape()[map.input_dimension()] != 1) {
+          return false;
+        }
+        break;
+      case OutputIndexMethod::array:
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Returns `true` if the single element referenced by the broadcast `array`
+/// is identical to a value-initialized element, such that it can be written
+/// using `DataTypeOperations::initialize` (i.e. `memset` for trivial types).
+bool IsValueInitializedBroadcastArray(
+    const TransformedSharedArray<const void>& array) {
+  IndexTransformView<> transform = array.transform();
+  Index byte_offset = 0;
+  for (DimensionIndex output_dim = 0; output_dim < transform.output_rank();
+       ++output_dim) {
+    auto map = transform.output_index_map(output_dim);
+    byte_offset = internal::wrap_on_overflow::Add(byte_offset, map.offset());
+    if (map.method() == OutputIndexMethod::single_input_dimension) {
+      byte_offset = internal::wrap_on_overflow::Add(
+          byte_offset,
+          internal::wrap_on_overflow::Multiply(
+              map.stride(), transform.input_origin()[map.input_dimension()]));
+    }
+  }
+  ArrayView<const void, 0> element(
+      AddByteOffset(ElementPointer<const void>(array.element_pointer()),
+                    byte_offset));
+  auto zero = AllocateArray(span<const Index, 0>(), c_order, value_init,
+                            array.dtype());
+  return AreArraysIdenticallyEqual(element, zero);
+}
+
+absl::Status CopyReadChunkImpl(
     ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
     const DataTypeConversionLookupResult& chunk_conversion,
-    TransformedArray<void, dynamic_rank, view> target) {
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor* executor) {
   DefaultNDIterableArena arena;
 
   TENSORSTORE_ASSIGN_OR_RETURN(
@@ -337,9 +841,36 @@ absl::Status CopyReadChunk(
   LockCollection lock_collection;
   TENSORSTORE_ASSIGN_OR_RETURN(auto guard, LockChunks(lock_collection, chunk));
 
-  TENSORSTORE_ASSIGN_OR_RETURN(
-      auto source_iterable,
-      chunk(ReadChunk::BeginRead{}, std::move(chunk_transform), arena));
+  NDIterable::Ptr source_iterable;
+  auto source_array = chunk(ReadChunk::GetArray{}, chunk_transform);
+  if (source_array.ok()) {
+    // Missing chunks are represented by a broadcast of the fill value.  If it
+    // is zero, the target is initialized directly rather than copied
+    // element-wise.
+    if ((chunk_conversion.flags & DataTypeConversionFlags::kIdentity) !=
+            DataTypeConversionFlags{} &&
+        IsBroadcastArray(*source_array) &&
+        IsValueInitializedBroadcastArray(*source_array)) {
+      const TransformedArrayView<const void> target_view(target);
+      return internal::IterateOverTransformedArrays<1>(
+                 {&target.dtype()->initialize, nullptr},
+                 /*arg=*/nullptr, skip_repeated_elements,
+                 span<const TransformedArrayView<const void>, 1>(
+                     &target_view, 1))
+          .status();
+    }
+    // The chunk data is referenced directly, which is equivalent to
+    // `BeginRead`.
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        source_iterable,
+        GetTransformedArrayNDIterable(*std::move(source_array), arena));
+  } else if (absl::IsUnimplemented(source_array.status())) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        source_iterable,
+        chunk(ReadChunk::BeginRead{}, std::move(chunk_transform), arena));
+  } else {
+    return source_array.status();
+  }
 
   source_iterable = GetConvertedInputNDIterable(
       std::move(source_iterable), target_iterable->dtype(), chunk_conversion);
@@ -347,7 +878,25 @@ absl::Status CopyReadChunk(
   // Copy the chunk to the relevant portion of the target array.
   NDIterableCopier copier(*source_iterable, *target_iterable, target.shape(),
                           arena);
-  return copier.Copy();
+  return executor ? copier.Copy(*executor) : copier.Copy();
+}
+}  // namespace
+
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target) {
+  return CopyReadChunkImpl(chunk, std::move(chunk_transform), chunk_conversion,
+                           std::move(target), /*executor=*/nullptr);
+}
+
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor& executor) {
+  return CopyReadChunkImpl(chunk, std::move(chunk_transform), chunk_conversion,
+                           std::move(target), &executor);
 }
 
 absl::Status CopyReadChunk(ReadChunk::Impl& chunk,
@@ -360,4 +909,19 @@ absl::Status CopyReadChunk(ReadChunk::Impl& chunk,
 }
 
 }  // namespace internal
+
+Result<TransformedSharedArray<const void>> ReadChunkView::array() const {
+  internal::ReadChunk chunk = chunk_;
+  auto array = chunk.impl(internal::ReadChunk::GetArray{}, chunk.transform);
+  if (!absl::IsUnimplemented(array.status())) return array;
+
+  // The chunk data cannot be referenced directly, and must be copied.
+  TransformedSharedArray<void> target =
+      AllocateArray(chunk.transform.domain().box(), c_order, default_init,
+                    dtype_);
+  TENSORSTORE_RETURN_IF_ERROR(internal::CopyReadChunk(
+      chunk.impl, std::move(chunk.transform), target));
+  return TransformedSharedArray<const void>(std::move(target));
+}
+
 }  // namespace tensorstore
@@ -15,8 +15,13 @@
 #ifndef TENSORSTORE_DRIVER_READ_H_
 #define TENSORSTORE_DRIVER_READ_H_
 
+#include <stddef.h>
+
+#include <functional>
+
 #include "absl/status/status.h"
 #include "tensorstore/array.h"
+#include "tensorstore/cache_pin.h"
 #include "tensorstore/container_kind.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
@@ -28,10 +33,55 @@
 #include "tensorstore/progress.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/read_write_options.h"
+#include "tensorstore/util/execution/any_sender.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
 
 namespace tensorstore {
+
+/// Read-only view of a single chunk of a `TensorStore`, as produced by
+/// `tensorstore::ReadChunks`.
+///
+/// Holds a reference to the underlying chunk data, such as a pinned cache
+/// entry, which is released when the view is destroyed.
+///
+/// \relates TensorStore
+class ReadChunkView {
+ public:
+  ReadChunkView() = default;
+  ReadChunkView(DataType dtype, internal::ReadChunk chunk,
+                IndexTransform<> transform)
+      : dtype_(dtype),
+        chunk_(std::move(chunk)),
+        transform_(std::move(transform)) {}
+
+  /// Data type of the chunk.
+  DataType dtype() const { return dtype_; }
+
+  /// Transform from `domain()` to the domain of the `TensorStore` from which
+  /// the chunk was read.
+  const IndexTransform<>& transform() const { return transform_; }
+
+  /// Domain of the chunk.
+  IndexDomainView<> domain() const { return transform_.domain(); }
+
+  /// Returns a read-only view of the data of the chunk, with a domain of
+  /// `domain()`.
+  ///
+  /// If the chunk data is held in memory in immutable form, such as a decoded
+  /// chunk in the cache, the returned array references it directly.
+  /// Otherwise, the data is copied to a newly-allocated array.
+  Result<TransformedSharedArray<const void>> array() const;
+
+ private:
+  DataType dtype_;
+  internal::ReadChunk chunk_;
+  IndexTransform<> transform_;
+};
+
+using ReadChunksSender = AnyFlowSender<absl::Status, ReadChunkView>;
+
 namespace internal {
 
 /// Options for DriverRead.
@@ -85,6 +135,65 @@ Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
 Future<SharedOffsetArray<void>> DriverReadIntoNewArray(
     DriverHandle source, ReadIntoNewArrayOptions options);
 
+/// Reads the data of `source` into any caches used by the driver, without
+/// copying it to an array.
+///
+/// Each chunk is simply discarded once it has been received, since drivers
+/// backed by a `ChunkCache` emit a chunk only after the corresponding cache
+/// entry has been read.
+///
+/// \param source Source TensorStore.
+/// \param options Specifies options.
+/// \returns A future that becomes ready when all chunks have been received or
+///     an error occurs.
+Future<void> DriverPrefetch(DriverHandle source, PrefetchOptions options);
+
+/// Reads the data of `source` into the caches used by the driver, and pins the
+/// cache entries that were read.
+///
+/// Only chunks read through a `ChunkCache` are pinned.
+///
+/// \param source Source TensorStore.  Must not be bound to a transaction.
+/// \param options Specifies options.
+/// \returns A future that becomes ready with the pin once all chunks have been
+///     read and pinned, or an error occurs.
+Future<CachePin> DriverPin(DriverHandle source, PinOptions options);
+
+/// Returns a sender of read-only views of the chunks of `source`.
+///
+/// The bounds of `source.transform` are resolved when the sender is
+/// submitted.  Each value is a `ReadChunkView` covering a portion of the
+/// resolved domain.
+ReadChunksSender DriverReadChunks(DriverHandle source,
+                                  ReadChunksOptions options);
+
+/// Options for `DriverForEachChunk`.
+struct DriverForEachChunkOptions {
+  /// Maximum estimated size in bytes of the decoded data of the regions being
+  /// read concurrently.  If `0`, the entire domain is read at once.
+  size_t total_bytes_limit = 0;
+};
+
+/// Callback invoked by `DriverForEachChunk` for each chunk.
+///
+/// May be invoked concurrently from multiple threads.
+using ForEachChunkCallback = std::function<absl::Status(ReadChunkView chunk)>;
+
+/// Invokes `callback` using `source.driver->data_copy_executor()` for each
+/// chunk of `source`, with bounded memory.
+///
+/// The resolved domain of `source` is partitioned along the read chunk grid
+/// into regions that are read in C order.  Further regions are read, ahead of
+/// the processing of earlier regions, only while the estimated size of the
+/// regions in flight remains within `options.total_bytes_limit`.  A region
+/// remains in flight until the `callback` has returned for all of its chunks.
+///
+/// \returns A future that becomes ready once `callback` has returned for all
+///     chunks, or with the first error returned by the driver or `callback`.
+Future<void> DriverForEachChunk(DriverHandle source,
+                                ForEachChunkCallback callback,
+                                DriverForEachChunkOptions options);
+
 /// Copies `chunk` transformed by `chunk_transform` to `target`.
 absl::Status CopyReadChunk(
     ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
@@ -95,6 +204,15 @@ absl::Status CopyReadChunk(ReadChunk::Impl& chunk,
                            IndexTransform<> chunk_transform,
                            TransformedArray<void, dynamic_rank, view> target);
 
+/// Same as above, but a large copy is partitioned across `executor`.
+///
+/// This requires that `target` is not accessed concurrently by other threads.
+absl::Status CopyReadChunk(
+    ReadChunk::Impl& chunk, IndexTransform<> chunk_transform,
+    const DataTypeConversionLookupResult& chunk_conversion,
+    TransformedArray<void, dynamic_rank, view> target,
+    const Executor& executor);
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -17,6 +17,8 @@
 
 #include "tensorstore/batch.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/cache/cache_pin.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/transaction.h"
 
 namespace tensorstore {
@@ -27,6 +29,11 @@ struct DriverReadRequest {
   internal::OpenTransactionPtr transaction;
   IndexTransform<> transform;
   Batch batch{no_batch};
+  IoStats io_stats;
+
+  /// If non-null, the cache entries from which the chunks are read are added
+  /// to this set once loaded.  Used by `tensorstore::Pin`.
+  CachePinSetPtr pin_set;
 };
 
 }  // namespace internal
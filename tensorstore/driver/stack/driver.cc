@@ -18,18 +18,21 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <cmath>
+#include <list>
 #include <numeric>
 #include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
-#include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/box.h"
 #include "tensorstore/context.h"
 #include "tensorstore/data_type.h"
@@ -188,6 +191,159 @@ struct CellEq {
   }
 };
 
+/// Irregular grid over a subset of the layers, along with the layer which
+/// backs each grid cell.  When layers overlap, the cell maps to the last one.
+struct LayerGrid {
+  IrregularGrid grid;
+  absl::flat_hash_map<Cell, size_t, CellHash, CellEq> cell_to_layer;
+};
+
+/// Static packed R-tree over the layer domains, used to find the layers which
+/// intersect a request without visiting every layer.
+///
+/// The layers are ordered using Sort-Tile-Recursive packing, grouped into
+/// leaves of `kNodeSize` consecutive layers, and each subsequent level groups
+/// `kNodeSize` consecutive nodes of the level below.
+class LayerIndex {
+ public:
+  static constexpr size_t kNodeSize = 16;
+
+  LayerIndex() = default;
+  explicit LayerIndex(span<const IndexDomain<>> domains);
+
+  /// Appends to `layers` the index of every layer whose domain intersects
+  /// `box`, in increasing order.
+  void Query(BoxView<> box, std::vector<size_t>& layers) const;
+
+ private:
+  // Entries at one level of the tree.  The bounds of entry `i` are stored as
+  // `rank_` inclusive min values followed by `rank_` inclusive max values.
+  struct Level {
+    size_t size = 0;
+    std::vector<Index> bounds;
+  };
+
+  span<const Index> bounds(size_t level, size_t i) const {
+    return span<const Index>(levels_[level].bounds)
+        .subspan(i * 2 * rank_, 2 * rank_);
+  }
+
+  bool Intersects(size_t level, size_t i, BoxView<> box) const;
+
+  DimensionIndex rank_ = 0;
+  // Layer indices in packed order; entry `i` of level 0 is `order_[i]`.
+  std::vector<size_t> order_;
+  // Levels of the tree, from the leaves up to the single root node.
+  std::vector<Level> levels_;
+};
+
+LayerIndex::LayerIndex(span<const IndexDomain<>> domains) {
+  if (domains.empty()) return;
+  rank_ = domains[0].rank();
+  const size_t n = domains.size();
+  order_.resize(n);
+  std::iota(order_.begin(), order_.end(), size_t{0});
+
+  // Sort-Tile-Recursive: sort by center along `dim`, split into slabs which
+  // each fill a whole number of leaves, and recurse into the next dimension.
+  const auto center = [&](size_t layer_i, DimensionIndex dim) {
+    auto interval = domains[layer_i][dim].interval();
+    return interval.inclusive_min() / 2 + interval.inclusive_max() / 2;
+  };
+  const auto pack = [&](auto& self, size_t begin, size_t end,
+                        DimensionIndex dim) -> void {
+    if (dim == rank_) return;
+    std::sort(order_.begin() + begin, order_.begin() + end,
+              [&](size_t a, size_t b) {
+                return center(a, dim) < center(b, dim);
+              });
+    const size_t count = end - begin;
+    if (count <= kNodeSize) return;
+    const size_t num_leaves = (count + kNodeSize - 1) / kNodeSize;
+    const size_t num_slabs = static_cast<size_t>(std::ceil(
+        std::pow(static_cast<double>(num_leaves), 1.0 / (rank_ - dim))));
+    const size_t slab_size =
+        ((num_leaves + num_slabs - 1) / num_slabs) * kNodeSize;
+    for (size_t i = begin; i < end; i += slab_size) {
+      self(self, i, std::min(end, i + slab_size), dim + 1);
+    }
+  };
+  pack(pack, 0, n, 0);
+
+  auto& leaves = levels_.emplace_back();
+  leaves.size = n;
+  leaves.bounds.reserve(n * 2 * rank_);
+  for (size_t layer_i : order_) {
+    auto box = domains[layer_i].box();
+    for (DimensionIndex dim = 0; dim < rank_; ++dim) {
+      leaves.bounds.push_back(box[dim].inclusive_min());
+    }
+    for (DimensionIndex dim = 0; dim < rank_; ++dim) {
+      leaves.bounds.push_back(box[dim].inclusive_max());
+    }
+  }
+  for (size_t count = n; count > 1;) {
+    const size_t level = levels_.size() - 1;
+    const size_t num_nodes = (count + kNodeSize - 1) / kNodeSize;
+    Level nodes;
+    nodes.size = num_nodes;
+    nodes.bounds.reserve(num_nodes * 2 * rank_);
+    for (size_t node_i = 0; node_i < num_nodes; ++node_i) {
+      const size_t child_end = std::min(count, (node_i + 1) * kNodeSize);
+      auto first = bounds(level, node_i * kNodeSize);
+      nodes.bounds.insert(nodes.bounds.end(), first.begin(), first.end());
+      Index* node = nodes.bounds.data() + node_i * 2 * rank_;
+      for (size_t child = node_i * kNodeSize + 1; child < child_end; ++child) {
+        auto b = bounds(level, child);
+        for (DimensionIndex dim = 0; dim < rank_; ++dim) {
+          node[dim] = std::min(node[dim], b[dim]);
+          node[rank_ + dim] = std::max(node[rank_ + dim], b[rank_ + dim]);
+        }
+      }
+    }
+    levels_.push_back(std::move(nodes));
+    count = num_nodes;
+  }
+}
+
+bool LayerIndex::Intersects(size_t level, size_t i, BoxView<> box) const {
+  auto b = bounds(level, i);
+  for (DimensionIndex dim = 0; dim < rank_; ++dim) {
+    if (b[dim] > box[dim].inclusive_max() ||
+        b[rank_ + dim] < box[dim].inclusive_min()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LayerIndex::Query(BoxView<> box, std::vector<size_t>& layers) const {
+  assert(order_.empty() || box.rank() == rank_);
+  if (order_.empty()) return;
+  const size_t begin = layers.size();
+  // Depth-first traversal from the root, which is entry 0 of the last level.
+  std::vector<std::pair<size_t, size_t>> stack;
+  if (Intersects(levels_.size() - 1, 0, box)) {
+    stack.emplace_back(levels_.size() - 1, 0);
+  }
+  while (!stack.empty()) {
+    auto [level, i] = stack.back();
+    stack.pop_back();
+    if (level == 0) {
+      layers.push_back(order_[i]);
+      continue;
+    }
+    const size_t child_end =
+        std::min(levels_[level - 1].size, (i + 1) * kNodeSize);
+    for (size_t child = i * kNodeSize; child < child_end; ++child) {
+      if (Intersects(level - 1, child, box)) {
+        stack.emplace_back(level - 1, child);
+      }
+    }
+  }
+  std::sort(layers.begin() + begin, layers.end());
+}
+
 // Certain operations are applied to either a sequence of
 // `internal::TransformedDriverSpec` used by the `StackDriverSpec` to represent
 // layers, or to a sequence of `StackLayer` used by the open `StackDriver` to
@@ -492,7 +648,21 @@ class StackDriver
 
   void Write(WriteRequest request, WriteChunkReceiver receiver) override;
 
-  absl::Status InitializeGridIndices(span<const IndexDomain<>> domains);
+  void InitializeLayerIndex(std::vector<IndexDomain<>> domains);
+
+  /// Returns the grid over the layers which intersect `request_transform`.
+  Result<LayerGrid> GetLayerGrid(IndexTransformView<> request_transform) const;
+
+  /// Opens layer `layer_i`, which is not already open, with `mode`.
+  ///
+  /// Outside of a transaction, opened layers are shared by all operations on
+  /// this driver: concurrent first uses of a layer share a single open, and
+  /// the `kMaxCachedLayers` most recently used layers are retained.
+  Future<internal::Driver::Handle> OpenLayer(
+      size_t layer_i, ReadWriteMode mode,
+      const OpenTransactionPtr& transaction);
+
+  constexpr static size_t kMaxCachedLayers = 1024;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     // Exclude `context_binding_state_` because it is handled specially.
@@ -505,20 +675,31 @@ class StackDriver
   std::vector<StackLayer> layers_;
   DimensionUnitsVector dimension_units_;
   IndexDomain<> layer_domain_;
-  IrregularGrid grid_;
+  std::vector<IndexDomain<>> layer_domains_;
+  LayerIndex layer_index_;
 
-  absl::flat_hash_map<Cell, size_t, CellHash, CellEq> grid_to_layer_;
+  using CachedLayerKey = std::pair<size_t, ReadWriteMode>;
+  struct CachedLayer {
+    Future<internal::Driver::Handle> future;
+    std::list<CachedLayerKey>::iterator lru_position;
+  };
+  absl::Mutex cached_layers_mutex_;
+  // Keys of `cached_layers_`, most recently used first.
+  std::list<CachedLayerKey> cached_layers_lru_
+      ABSL_GUARDED_BY(cached_layers_mutex_);
+  absl::flat_hash_map<CachedLayerKey, CachedLayer> cached_layers_
+      ABSL_GUARDED_BY(cached_layers_mutex_);
 };
 
 Result<internal::Driver::Handle> MakeStackDriverHandle(
     internal::ReadWritePtr<StackDriver> driver,
-    span<const IndexDomain<>> layer_domains, Transaction transaction,
+    std::vector<IndexDomain<>> layer_domains, Transaction transaction,
     const Schema& schema) {
   driver->dtype_ = schema.dtype();
   TENSORSTORE_ASSIGN_OR_RETURN(
       driver->layer_domain_,
       internal_stack::GetCombinedDomain(schema, layer_domains));
-  TENSORSTORE_RETURN_IF_ERROR(driver->InitializeGridIndices(layer_domains));
+  driver->InitializeLayerIndex(std::move(layer_domains));
   auto transform = IdentityTransform(driver->layer_domain_);
   driver->dimension_units_ =
       internal_stack::GetDimensionUnits<StackLayer>(schema, driver->layers_)
@@ -551,51 +732,99 @@ Future<internal::Driver::Handle> StackDriverSpec::Open(
       internal_stack::GetEffectiveDomainsForLayers<StackLayer>(
           driver->layers_));
   return internal_stack::MakeStackDriverHandle(
-      std::move(driver), layer_domains,
+      std::move(driver), std::move(layer_domains),
       internal::TransactionState::ToTransaction(std::move(request.transaction)),
       schema);
 }
 
-/// The mechanism used here is to construct an irregular grid based on
-/// each layer's effective transform, and then, for each of those grid
-/// points, store the layer associated with the bounding rectangle.
-///
-/// If this becomes a problem, we may want to consider constructing
-/// an R-tree variant using the layer MBRs to restrict the query space,
-/// then applying a similar gridding decomposition to the read transforms.
-absl::Status StackDriver::InitializeGridIndices(
-    span<const IndexDomain<>> domains) {
+void StackDriver::InitializeLayerIndex(std::vector<IndexDomain<>> domains) {
   assert(domains.size() == layers_.size());
-  grid_ = IrregularGrid::Make(layers_.empty() ? span(&layer_domain_, 1)
-                                              : span(domains));
+  layer_index_ = LayerIndex(domains);
+  layer_domains_ = std::move(domains);
+}
+
+/// The mechanism used here is to find the layers which intersect the bounding
+/// box of the request using `layer_index_`, construct an irregular grid based
+/// on the effective domains of just those layers, and then, for each of those
+/// grid cells, store the layer associated with the bounding rectangle.
+///
+/// Restricting the grid to the intersecting layers keeps its size
+/// proportional to the part of the stack touched by the request, rather than
+/// to the total number of layers.
+Result<LayerGrid> StackDriver::GetLayerGrid(
+    IndexTransformView<> request_transform) const {
+  const DimensionIndex rank = layer_domain_.rank();
+  Box<> request_bounds(rank);
+  TENSORSTORE_RETURN_IF_ERROR(
+      GetOutputRange(request_transform, request_bounds));
+
+  std::vector<size_t> layers;
+  layer_index_.Query(request_bounds, layers);
+
+  std::vector<IndexDomainView<>> domains;
+  domains.reserve(layers.size());
+  for (size_t layer_i : layers) {
+    domains.push_back(layer_domains_[layer_i]);
+  }
+  if (domains.empty()) {
+    domains.push_back(layer_domain_);
+  }
+
+  LayerGrid result;
+  result.grid = IrregularGrid::Make(domains);
 
   Index start[kMaxRank];
   Index shape[kMaxRank];
-  const DimensionIndex rank = grid_.rank();
-  for (size_t layer_i = 0; layer_i < domains.size(); layer_i++) {
-    auto& d = domains[layer_i];
+  for (size_t layer_i : layers) {
+    auto& d = layer_domains_[layer_i];
     for (DimensionIndex dim = 0; dim < rank; dim++) {
-      start[dim] = grid_(dim, d[dim].inclusive_min(), nullptr);
-      shape[dim] = 1 + grid_(dim, d[dim].inclusive_max(), nullptr) - start[dim];
+      start[dim] = result.grid(dim, d[dim].inclusive_min(), nullptr);
+      shape[dim] =
+          1 + result.grid(dim, d[dim].inclusive_max(), nullptr) - start[dim];
     }
     // Set the mapping for all irregular grid cell covered by this layer
     // to point to this layer.
     IterateOverIndexRange<>(BoxView<>(rank, start, shape),
-                            [layer_i, this](span<const Index> key) {
-                              grid_to_layer_[key] = layer_i;
+                            [&](span<const Index> key) {
+                              result.cell_to_layer[key] = layer_i;
                             });
   }
+  return result;
+}
 
-#if !defined(NDEBUG)
-  // Log the missing cells.
-  IterateOverIndexRange<>(grid_.shape(), [this](span<const Index> key) {
-    if (auto it = grid_to_layer_.find(key); it == grid_to_layer_.end()) {
-      ABSL_LOG(INFO) << "\"stack\" driver missing grid cell: " << key;
+Future<internal::Driver::Handle> StackDriver::OpenLayer(
+    size_t layer_i, ReadWriteMode mode,
+    const OpenTransactionPtr& transaction) {
+  const auto open = [&] {
+    internal::DriverOpenRequest request;
+    request.transaction = transaction;
+    request.read_write_mode = mode;
+    return internal::OpenDriver(layers_[layer_i].GetTransformedDriverSpec(),
+                                std::move(request));
+  };
+  if (transaction) return open();
+
+  absl::MutexLock lock(&cached_layers_mutex_);
+  const CachedLayerKey key{layer_i, mode};
+  if (auto it = cached_layers_.find(key); it != cached_layers_.end()) {
+    auto& future = it->second.future;
+    if (!future.ready() || future.result().ok()) {
+      cached_layers_lru_.splice(cached_layers_lru_.begin(), cached_layers_lru_,
+                                it->second.lru_position);
+      return future;
     }
-  });
-#endif
-
-  return absl::OkStatus();
+    // Retry layers which previously failed to open.
+    cached_layers_lru_.erase(it->second.lru_position);
+    cached_layers_.erase(it);
+  }
+  auto future = open();
+  cached_layers_lru_.push_front(key);
+  cached_layers_.emplace(key, CachedLayer{future, cached_layers_lru_.begin()});
+  if (cached_layers_.size() > kMaxCachedLayers) {
+    cached_layers_.erase(cached_layers_lru_.back());
+    cached_layers_lru_.pop_back();
+  }
+  return future;
 }
 
 Result<TransformedDriverSpec> StackDriver::GetBoundSpec(
@@ -709,21 +938,27 @@ struct OpenLayerOp {
 
   void operator()() {
     auto* self = state->self.get();
+    auto layer_grid = self->GetLayerGrid(state->request.transform);
+    if (!layer_grid.ok()) {
+      state->SetError(std::move(layer_grid).status());
+      return;
+    }
+
     // Partition the initial transform over irregular grid space,
     // which results in a set of transforms for each layer, and collate them
     // by layer.
-    std::vector<DimensionIndex> dimension_order(self->grid_.rank());
+    std::vector<DimensionIndex> dimension_order(layer_grid->grid.rank());
     std::iota(dimension_order.begin(), dimension_order.end(),
               DimensionIndex{0});
 
-    UnmappedOpType unmapped{self};
+    UnmappedOpType unmapped{&layer_grid->grid};
     absl::flat_hash_map<size_t, std::vector<IndexTransform<>>> layers_to_load;
     auto status = tensorstore::internal::PartitionIndexTransformOverGrid(
-        dimension_order, self->grid_, state->request.transform,
+        dimension_order, layer_grid->grid, state->request.transform,
         [&](span<const Index> grid_cell_indices,
             IndexTransformView<> cell_transform) {
-          auto it = self->grid_to_layer_.find(grid_cell_indices);
-          if (it != self->grid_to_layer_.end()) {
+          auto it = layer_grid->cell_to_layer.find(grid_cell_indices);
+          if (it != layer_grid->cell_to_layer.end()) {
             const size_t layer_i = it->second;
             const auto& layer = self->layers_[layer_i];
             if (layer.driver) {
@@ -754,25 +989,21 @@ struct OpenLayerOp {
     // transforms.
     for (auto& kv : layers_to_load) {
       const size_t layer_i = kv.first;
-      const auto& layer = self->layers_[layer_i];
-      internal::DriverOpenRequest request;
-      request.transaction = state->request.transaction;
-      request.read_write_mode = StateType::kMode;
       Link(WithExecutor(
                self->data_copy_executor(),
                AfterOpenOp<StateType>{state, layer_i, std::move(kv.second)}),
            state->promise,
-           internal::OpenDriver(layer.GetTransformedDriverSpec(),
-                                std::move(request)));
+           self->OpenLayer(layer_i, StateType::kMode,
+                           state->request.transaction));
     }
   }
 };
 
 struct UnmappedOp {
-  StackDriver* self;
+  const IrregularGrid* grid;
   absl::Status operator()(span<const Index> grid_cell_indices,
                           IndexTransformView<> cell_transform) {
-    auto origin = self->grid_.cell_origin(grid_cell_indices);
+    auto origin = grid->cell_origin(grid_cell_indices);
     return absl::InvalidArgumentError(
         tensorstore::StrCat("Cell with origin=", span(origin),
                             " missing layer mapping in \"stack\" driver"));
@@ -952,7 +1183,8 @@ Result<internal::DriverHandle> FinalizeStackHandle(
       internal_stack::GetEffectiveDomainsForLayers<StackLayer>(
           driver->layers_));
   return internal_stack::MakeStackDriverHandle(
-      std::move(driver), layer_domains, std::move(options.transaction), schema);
+      std::move(driver), std::move(layer_domains),
+      std::move(options.transaction), schema);
 }
 
 }  // namespace
@@ -19,6 +19,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -30,6 +31,7 @@
 #include "tensorstore/box.h"
 #include "tensorstore/context.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/array/array.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/index_domain.h"
@@ -376,6 +378,39 @@ TEST(StackDriverTest, ReadWriteNonExistingLayers) {
                             ".*Error opening \"n5\" driver: .*"));
 }
 
+TEST(StackDriverTest, ReadRetriesFailedLayerOpen) {
+  auto context = tensorstore::Context::Default();
+  ::nlohmann::json json_spec{
+      {"driver", "stack"},
+      {"layers", ::nlohmann::json::array_t({GetRank1Length4N5Driver(0),
+                                            GetRank1Length4N5Driver(3, 6)})},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(json_spec, context).result());
+
+  EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+              MatchesStatus(absl::StatusCode::kNotFound,
+                            ".*Error opening \"n5\" driver: .*"));
+
+  // Create the layers; the failed opens are not cached by the stack driver.
+  for (auto layer_json : json_spec["layers"]) {
+    layer_json.erase("transform");
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto layer,
+        tensorstore::Open(layer_json, context, OpenMode::create).result());
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::Write(tensorstore::MakeArray<int32_t>({1, 2, 3, 4}), layer)
+            .result());
+  }
+
+  // Reading twice uses the opened layers retained by the stack driver.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(tensorstore::Read<tensorstore::zero_origin>(store).result(),
+                ::testing::Optional(
+                    MatchesArray<int32_t>({1, 2, 3, 1, 2, 3})));
+  }
+}
+
 TEST(StackDriverTest, Schema_MismatchedDtype) {
   auto a = GetRank1Length4N5Driver(0);
   a["dtype"] = "int64";
@@ -1001,6 +1036,57 @@ TEST(OverlayTest, Transaction) {
                             "Transaction mismatch"));
 }
 
+TEST(OverlayTest, ManyUnalignedLayers) {
+  // Tiles on a staggered, overlapping grid so that the layer boundaries do not
+  // align, above a background layer covering the entire domain.
+  constexpr Index kNumTiles = 30;
+  constexpr Index kTileSize = 4;
+  constexpr Index kExtent = 3 * kNumTiles + kTileSize;
+  auto expected = tensorstore::AllocateArray<int32_t>({kExtent, kExtent},
+                                                      tensorstore::c_order,
+                                                      tensorstore::value_init);
+  std::vector<tensorstore::TensorStore<int32_t, 2>> layers;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto background,
+      tensorstore::FromArray(tensorstore::AllocateArray<int32_t>(
+          {kExtent, kExtent}, tensorstore::c_order, tensorstore::value_init)));
+  layers.push_back(background);
+  for (Index i = 0; i < kNumTiles; ++i) {
+    for (Index j = 0; j < kNumTiles; ++j) {
+      const Index y = 3 * i + (j % 2), x = 3 * j + (i % 3);
+      const int32_t value = static_cast<int32_t>(layers.size());
+      auto tile = tensorstore::AllocateArray<int32_t>(
+          tensorstore::BoxView<2>({y, x}, {kTileSize, kTileSize}));
+      for (Index ty = y; ty < y + kTileSize; ++ty) {
+        for (Index tx = x; tx < x + kTileSize; ++tx) {
+          tile(ty, tx) = value;
+          expected(ty, tx) = value;
+        }
+      }
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto layer,
+                                       tensorstore::FromArray(tile));
+      layers.push_back(layer);
+    }
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, tensorstore::Overlay(layers));
+  EXPECT_EQ(tensorstore::IndexDomain({kExtent, kExtent}), store.domain());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto full,
+                                   tensorstore::Read(store).result());
+  EXPECT_EQ(expected, full);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto part,
+      tensorstore::Read(store | tensorstore::Dims(0, 1).SizedInterval(
+                                    {10, 20}, {30, 25}))
+          .result());
+  for (Index y = 10; y < 40; ++y) {
+    for (Index x = 20; x < 45; ++x) {
+      EXPECT_EQ(expected(y, x), part(y, x)) << y << ", " << x;
+    }
+  }
+}
+
 TEST(OverlayTest, NoLayers) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, tensorstore::Overlay({}, tensorstore::dtype_v<int32_t>,
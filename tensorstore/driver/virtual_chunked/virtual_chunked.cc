@@ -23,13 +23,18 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/array.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/batch_impl.h"
 #include "tensorstore/box.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
@@ -53,9 +58,12 @@
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/memory.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/open_mode.h"
@@ -87,11 +95,69 @@ class VirtualChunkedCache : public internal::ConcreteChunkCache {
  public:
   using Base::Base;
 
+  class TransactionNode;
+
+  /// Chunk writes of the transaction nodes that are committed together, which
+  /// are passed to a single call to `batch_write_function_`.
+  struct BatchWrite : public internal::AtomicReferenceCount<BatchWrite> {
+    struct Request {
+      TransactionNode* node;
+      ReadState update;
+      SharedArray<const void> full_array;
+      WriteChunk chunk;
+    };
+
+    // Transaction for which this is the current batch in `batch_writes_`, or
+    // `nullptr` for a batch of retried writes.
+    internal::TransactionState* transaction = nullptr;
+
+    // Number of nodes that have not yet added their request.  Protected by
+    // `batch_writes_mutex_`.
+    size_t pending = 0;
+
+    std::vector<Request> requests;
+
+    // Chunks passed to `batch_write_function_`, which must remain valid until
+    // the returned future becomes ready.
+    std::vector<WriteChunk> chunks;
+  };
+
   /// Common implementation used by `Entry::DoRead` and
   /// `TransactionNode::DoRead`.
   template <typename EntryOrNode>
   void DoRead(EntryOrNode& node, AsyncCacheReadRequest request);
 
+  /// Allocates the chunk to be read for `node`, and sets `read_data` and
+  /// `chunk` accordingly.
+  ///
+  /// \returns `false` if the chunk is outside the domain, in which case the
+  ///     read has already completed.
+  template <typename EntryOrNode>
+  static bool StartChunkRead(EntryOrNode& node, absl::Time staleness_bound,
+                             std::shared_ptr<ReadData>& read_data,
+                             ReadChunk& chunk);
+
+  /// Completes the read of `node` started by `StartChunkRead`.
+  template <typename EntryOrNode>
+  static void ChunkReadDone(EntryOrNode& node,
+                            std::shared_ptr<ReadData> read_data,
+                            Result<TimestampedStorageGeneration> result);
+
+  /// Adds `node`, which is about to be committed, to the batch write for its
+  /// transaction.
+  void RegisterBatchWrite(TransactionNode& node);
+
+  /// Marks a node registered with `batch_write` as done, and submits the batch
+  /// once all registered nodes are done.
+  ///
+  /// \param request Chunk to be written for the node, or `std::nullopt` if the
+  ///     node does not need to be written.
+  void ReleaseBatchWrite(internal::IntrusivePtr<BatchWrite> batch_write,
+                         std::optional<BatchWrite::Request> request);
+
+  /// Calls `batch_write_function_` with all requests of `batch_write`.
+  static void SubmitBatchWrite(internal::IntrusivePtr<BatchWrite> batch_write);
+
   class Entry : public internal::ChunkCache::Entry {
    public:
     using OwningCache = VirtualChunkedCache;
@@ -128,8 +194,19 @@ class VirtualChunkedCache : public internal::ConcreteChunkCache {
       GetOwningCache(*this).DoRead(*this, std::move(request));
     }
 
+    /// Registers this node with the batch write of its transaction, if a
+    /// `batch_write_function_` is used.
+    ///
+    /// Since `PrepareForCommit` is called on all nodes in the phase before
+    /// `Commit` is called on any of them, the batch write is not submitted
+    /// until all of the nodes committed together have added their chunk.
+    void PrepareForCommit() override;
+
     void Commit() override;
 
+    /// Batch write to which this node adds its chunk once writeback is ready.
+    internal::IntrusivePtr<BatchWrite> batch_write_;
+
     /// Attempts or re-attempts writeback.
     ///
     /// Integrates changes with existing data that is no older than
@@ -169,9 +246,23 @@ class VirtualChunkedCache : public internal::ConcreteChunkCache {
 
   WriteFunction write_function_;
 
+  // Used instead of `read_function_` and `write_function_` if specified.
+  BatchReadFunction batch_read_function_;
+  BatchWriteFunction batch_write_function_;
+
+  absl::Mutex batch_writes_mutex_;
+
+  // Batch write being assembled for each committing transaction.
+  absl::flat_hash_map<internal::TransactionState*,
+                      internal::IntrusivePtr<BatchWrite>>
+      batch_writes_ ABSL_GUARDED_BY(batch_writes_mutex_);
+
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency_;
   Context::Resource<internal::CachePoolResource> cache_pool_;
+
+  // User-specified `CacheKey`, or empty if the cache is not shared.
+  std::string cache_key_;
 };
 
 /// Sets `partial_array` to refer to the portion of `full_array` (translated to
@@ -224,10 +315,188 @@ bool GetPermutedPartialArray(
   return true;
 }
 
+template <typename EntryOrNode>
+bool VirtualChunkedCache::StartChunkRead(EntryOrNode& node,
+                                         absl::Time staleness_bound,
+                                         std::shared_ptr<ReadData>& read_data,
+                                         ReadChunk& chunk) {
+  auto& entry = GetOwningEntry(node);
+  auto& cache = GetOwningCache(entry);
+  const auto& component_spec = cache.grid().components.front();
+  span<const Index> cell_shape = component_spec.shape();
+  // Always allocate the full chunk size, since that is what `ChunkCache`
+  // requires.
+  auto full_array = AllocateArray(cell_shape, c_order, default_init,
+                                  component_spec.dtype());
+  // Sub-region of `full_array` that intersects the domain.  The user-specified
+  // read function is called with `partial_array`.  The portion of `full_array`
+  // that is outside the domain remains uninitialized and is never read.
+  Array<const void, dynamic_rank, offset_origin> partial_array;
+  read_data = tensorstore::internal::make_shared_for_overwrite<ReadData[]>(1);
+  if (!GetPermutedPartialArray(entry, full_array, partial_array)) {
+    node.ReadSuccess({std::move(read_data),
+                      {StorageGeneration::NoValue(), absl::InfiniteFuture()}});
+    return false;
+  }
+  read_data.get()[0] = full_array;
+  chunk.output = ConstDataTypeCast<void>(std::move(partial_array));
+  chunk.read_params.executor_ = cache.executor();
+  {
+    ReadLock<ReadData> lock{node};
+    chunk.read_params.if_not_equal_ = lock.stamp().generation;
+  }
+  chunk.read_params.staleness_bound_ = staleness_bound;
+  return true;
+}
+
+template <typename EntryOrNode>
+void VirtualChunkedCache::ChunkReadDone(
+    EntryOrNode& node, std::shared_ptr<ReadData> read_data,
+    Result<TimestampedStorageGeneration> result) {
+  if (!result.ok()) {
+    node.ReadError(std::move(result).status());
+    return;
+  }
+  if (StorageGeneration::IsUnknown(result->generation)) {
+    // Ignore read_data
+    ReadState read_state;
+    {
+      ReadLock<ReadData> lock{node};
+      read_state = lock.read_state();
+    }
+    read_state.stamp.time = result->time;
+    node.ReadSuccess(std::move(read_state));
+    return;
+  }
+  node.ReadSuccess({std::move(read_data), std::move(*result)});
+}
+
+/// Batch entry that collects the chunk reads of a `VirtualChunkedCache` that
+/// are requested using the same `Batch`, in order to pass them to a single call
+/// to the `batch_read_function`.
+class BatchReadEntry : public Batch::Impl::Entry {
+ public:
+  using KeyParam = VirtualChunkedCache*;
+  using Node = std::variant<VirtualChunkedCache::Entry*,
+                            VirtualChunkedCache::TransactionNode*>;
+
+  // The entry is added by `VirtualChunkedCache::DoRead` when the
+  // `AsyncCache` batch entries, which have a nesting depth of 1, are
+  // submitted.
+  explicit BatchReadEntry(VirtualChunkedCache& cache)
+      : Batch::Impl::Entry(/*nesting_depth=*/0), cache_(&cache) {}
+
+  KeyParam key() const { return cache_; }
+
+  /// Adds a read of `node` to the entry for `batch`, or reads it immediately
+  /// if no `batch` is specified.
+  static void MakeRequest(VirtualChunkedCache& cache, Batch::View batch,
+                          Node node, absl::Time staleness_bound) {
+    if (!batch) {
+      auto entry = std::make_unique<BatchReadEntry>(cache);
+      entry->AddRequest(node, staleness_bound);
+      entry.release()->Submit({});
+      return;
+    }
+    Batch::Impl::From(batch)
+        ->GetEntry<BatchReadEntry>(
+            &cache, [&] { return std::make_unique<BatchReadEntry>(cache); })
+        .AddRequest(node, staleness_bound);
+  }
+
+ private:
+  struct Request {
+    Node node;
+    absl::Time staleness_bound;
+    std::shared_ptr<internal::ChunkCache::ReadData> read_data;
+  };
+
+  void AddRequest(Node node, absl::Time staleness_bound) {
+    absl::MutexLock lock(&mutex_);
+    requests_.push_back({node, staleness_bound, {}});
+  }
+
+  void Submit(Batch::View batch) override {
+    cache_->executor()([this] { StartRead(); });
+  }
+
+  void StartRead();
+  void ReadDone(Result<std::vector<TimestampedStorageGeneration>> result);
+
+  VirtualChunkedCache* cache_;
+  absl::Mutex mutex_;
+  std::vector<Request> requests_;
+
+  // Chunks passed to the `batch_read_function`, which must remain valid until
+  // the returned future becomes ready.
+  std::vector<ReadChunk> chunks_;
+};
+
+void BatchReadEntry::StartRead() {
+  std::unique_ptr<BatchReadEntry> self(this);
+  // The entries and transaction nodes remain valid until `ReadSuccess` or
+  // `ReadError` is called, and keep `cache_` alive.
+  auto& cache = *cache_;
+  size_t num_chunks = 0;
+  for (auto& request : requests_) {
+    ReadChunk chunk;
+    if (!std::visit(
+            [&](auto* node) {
+              return VirtualChunkedCache::StartChunkRead(
+                  *node, request.staleness_bound, request.read_data, chunk);
+            },
+            request.node)) {
+      continue;
+    }
+    chunks_.push_back(std::move(chunk));
+    if (&requests_[num_chunks] != &request) {
+      requests_[num_chunks] = std::move(request);
+    }
+    ++num_chunks;
+  }
+  requests_.erase(requests_.begin() + num_chunks, requests_.end());
+  if (chunks_.empty()) return;
+  auto read_future = cache.batch_read_function_(chunks_);
+  read_future.Force();
+  read_future.ExecuteWhenReady(
+      [self = std::move(self)](
+          ReadyFuture<std::vector<TimestampedStorageGeneration>> future) {
+        self->ReadDone(std::move(future.result()));
+      });
+}
+
+void BatchReadEntry::ReadDone(
+    Result<std::vector<TimestampedStorageGeneration>> result) {
+  if (result.ok() && result->size() != requests_.size()) {
+    result = absl::InvalidArgumentError(tensorstore::StrCat(
+        "batch_read_function returned ", result->size(),
+        " generations for ", requests_.size(), " chunks"));
+  }
+  for (size_t i = 0; i < requests_.size(); ++i) {
+    auto& request = requests_[i];
+    Result<TimestampedStorageGeneration> chunk_result =
+        result.ok() ? Result<TimestampedStorageGeneration>(
+                          std::move((*result)[i]))
+                    : Result<TimestampedStorageGeneration>(result.status());
+    std::visit(
+        [&](auto* node) {
+          VirtualChunkedCache::ChunkReadDone(*node,
+                                             std::move(request.read_data),
+                                             std::move(chunk_result));
+        },
+        request.node);
+  }
+}
+
 template <typename EntryOrNode>
 void VirtualChunkedCache::DoRead(EntryOrNode& node,
                                  AsyncCacheReadRequest request) {
   auto& cache = GetOwningCache(node);
+  if (cache.batch_read_function_) {
+    BatchReadEntry::MakeRequest(cache, request.batch, &node,
+                                request.staleness_bound);
+    return;
+  }
   if (!cache.read_function_) {
     // Normally happens only in the case of a partial chunk write.
     node.ReadError(absl::InvalidArgumentError(
@@ -238,60 +507,17 @@ void VirtualChunkedCache::DoRead(EntryOrNode& node,
   // `node` is guaranteed to remain valid until `ReadSuccess` or `ReadError`
   // is called.  Therefore we don't need to separately hold a reference.
   executor([&node, staleness_bound = request.staleness_bound] {
-    auto& entry = GetOwningEntry(node);
-    auto& cache = GetOwningCache(entry);
-    const auto& component_spec = cache.grid().components.front();
-    span<const Index> cell_shape = component_spec.shape();
-    // Always allocate the full chunk size, since that is what `ChunkCache`
-    // requires.
-    auto full_array = AllocateArray(cell_shape, c_order, default_init,
-                                    component_spec.dtype());
-    // Sub-region of `full_array` that intersects the domain.  The
-    // user-specified `read_function` is called with `partial_array`.  The
-    // portion of `full_array` that is outside the domain remains
-    // uninitialized and is never read.
-    Array<const void, dynamic_rank, offset_origin> partial_array;
-    auto read_data =
-        tensorstore::internal::make_shared_for_overwrite<ReadData[]>(1);
-    if (!GetPermutedPartialArray(entry, full_array, partial_array)) {
-      node.ReadSuccess(
-          {std::move(read_data),
-           {StorageGeneration::NoValue(), absl::InfiniteFuture()}});
-      return;
-    }
-    read_data.get()[0] = full_array;
-    ReadParameters read_params;
-    read_params.executor_ = cache.executor();
-    {
-      ReadLock<ReadData> lock{node};
-      read_params.if_not_equal_ = lock.stamp().generation;
-    }
-    read_params.staleness_bound_ = staleness_bound;
-    auto read_future =
-        cache.read_function_(ConstDataTypeCast<void>(std::move(partial_array)),
-                             std::move(read_params));
+    std::shared_ptr<ReadData> read_data;
+    ReadChunk chunk;
+    if (!StartChunkRead(node, staleness_bound, read_data, chunk)) return;
+    auto read_future = GetOwningCache(node).read_function_(
+        std::move(chunk.output), std::move(chunk.read_params));
     read_future.Force();
     read_future.ExecuteWhenReady(
         [&node, read_data = std::move(read_data)](
             ReadyFuture<TimestampedStorageGeneration> future) mutable {
-          auto& r = future.result();
-          if (!r.ok()) {
-            node.ReadError(std::move(r).status());
-            return;
-          }
-          if (StorageGeneration::IsUnknown(r->generation)) {
-            // Ignore read_data
-            ReadState read_state;
-            {
-              ReadLock<ReadData> lock{node};
-              read_state = lock.read_state();
-            }
-            read_state.stamp.time = r->time;
-            node.ReadSuccess(std::move(read_state));
-            return;
-          }
-          node.ReadSuccess({std::move(read_data), std::move(*r)});
-          return;
+          ChunkReadDone(node, std::move(read_data),
+                        std::move(future.result()));
         });
   });
 }
@@ -304,8 +530,17 @@ std::string VirtualChunkedCache::TransactionNode::Describe() {
   return tensorstore::StrCat("write to virtual chunk ", domain);
 }
 
+void VirtualChunkedCache::TransactionNode::PrepareForCommit() {
+  auto& cache = GetOwningCache(*this);
+  if (cache.batch_write_function_) {
+    cache.RegisterBatchWrite(*this);
+  }
+  internal::ChunkCache::TransactionNode::PrepareForCommit();
+}
+
 void VirtualChunkedCache::TransactionNode::Commit() {
-  if (!GetOwningCache(*this).write_function_) {
+  auto& cache = GetOwningCache(*this);
+  if (!cache.write_function_ && !cache.batch_write_function_) {
     // Should have been prevented by ReadWriteMode.
     SetError(absl::InternalError(
         "No write function specified to virtual_chunked driver"));
@@ -338,6 +573,10 @@ void VirtualChunkedCache::TransactionNode::InitiateWriteback(
 
             Array<const void, dynamic_rank, offset_origin> partial_array;
             if (!GetPermutedPartialArray(entry, full_array, partial_array)) {
+              if (node->batch_write_) {
+                cache.ReleaseBatchWrite(std::move(node->batch_write_),
+                                        std::nullopt);
+              }
               node->WritebackSuccess(
                   {std::move(update.data),
                    {StorageGeneration::NoValue(), absl::InfiniteFuture()}});
@@ -347,6 +586,15 @@ void VirtualChunkedCache::TransactionNode::InitiateWriteback(
             write_params.if_equal_ =
                 StorageGeneration::Clean(update.stamp.generation);
             write_params.executor_ = cache.executor();
+            if (node->batch_write_) {
+              cache.ReleaseBatchWrite(
+                  std::move(node->batch_write_),
+                  BatchWrite::Request{node, std::move(update),
+                                      std::move(full_array),
+                                      {std::move(partial_array),
+                                       std::move(write_params)}});
+              return;
+            }
             auto write_future = cache.write_function_(std::move(partial_array),
                                                       std::move(write_params));
             write_future.Force();
@@ -371,6 +619,10 @@ void VirtualChunkedCache::TransactionNode::InitiateWriteback(
           });
     }
     void set_error(absl::Status error) {
+      if (self.batch_write_) {
+        GetOwningCache(self).ReleaseBatchWrite(std::move(self.batch_write_),
+                                               std::nullopt);
+      }
       self.SetError(std::move(error));
       self.WritebackError();
     }
@@ -381,6 +633,95 @@ void VirtualChunkedCache::TransactionNode::InitiateWriteback(
   this->DoApply(std::move(apply_options), ApplyReceiver{*this});
 }
 
+void VirtualChunkedCache::RegisterBatchWrite(TransactionNode& node) {
+  absl::MutexLock lock(&batch_writes_mutex_);
+  auto& batch_write = batch_writes_[node.transaction()];
+  if (!batch_write) {
+    batch_write = internal::MakeIntrusivePtr<BatchWrite>();
+    batch_write->transaction = node.transaction();
+  }
+  ++batch_write->pending;
+  node.batch_write_ = batch_write;
+}
+
+void VirtualChunkedCache::ReleaseBatchWrite(
+    internal::IntrusivePtr<BatchWrite> batch_write,
+    std::optional<BatchWrite::Request> request) {
+  {
+    absl::MutexLock lock(&batch_writes_mutex_);
+    if (request) {
+      batch_write->requests.push_back(std::move(*request));
+    }
+    if (--batch_write->pending != 0) return;
+    if (batch_write->transaction) {
+      auto it = batch_writes_.find(batch_write->transaction);
+      if (it != batch_writes_.end() && it->second == batch_write) {
+        batch_writes_.erase(it);
+      }
+    }
+  }
+  if (batch_write->requests.empty()) return;
+  executor()([batch_write = std::move(batch_write)]() mutable {
+    SubmitBatchWrite(std::move(batch_write));
+  });
+}
+
+void VirtualChunkedCache::SubmitBatchWrite(
+    internal::IntrusivePtr<BatchWrite> batch_write) {
+  // The transaction nodes remain valid until `WritebackSuccess` or
+  // `WritebackError` is called, and keep the cache alive.
+  auto& cache = GetOwningCache(*batch_write->requests.front().node);
+  batch_write->chunks.reserve(batch_write->requests.size());
+  for (const auto& request : batch_write->requests) {
+    batch_write->chunks.push_back(request.chunk);
+  }
+  auto write_future = cache.batch_write_function_(batch_write->chunks);
+  write_future.Force();
+  write_future.ExecuteWhenReady(
+      [batch_write = std::move(batch_write)](
+          ReadyFuture<std::vector<TimestampedStorageGeneration>> future) {
+        auto& requests = batch_write->requests;
+        Result<std::vector<TimestampedStorageGeneration>> result =
+            std::move(future.result());
+        if (result.ok() && result->size() != requests.size()) {
+          result = absl::InvalidArgumentError(tensorstore::StrCat(
+              "batch_write_function returned ", result->size(),
+              " generations for ", requests.size(), " chunks"));
+        }
+        if (!result.ok()) {
+          for (auto& request : requests) {
+            request.node->SetError(result.status());
+            request.node->WritebackError();
+          }
+          return;
+        }
+        // Nodes for which the generation did not match, along with the time
+        // as of which the mismatch was determined.
+        std::vector<std::pair<TransactionNode*, absl::Time>> retry_nodes;
+        for (size_t i = 0; i < requests.size(); ++i) {
+          auto& request = requests[i];
+          auto& stamp = (*result)[i];
+          if (StorageGeneration::IsUnknown(stamp.generation)) {
+            retry_nodes.emplace_back(request.node, stamp.time);
+            continue;
+          }
+          request.update.stamp = std::move(stamp);
+          request.node->WritebackSuccess(std::move(request.update));
+        }
+        if (retry_nodes.empty()) return;
+        // Retry all of the mismatched writes as a single batch.  All nodes are
+        // registered before any of them is re-initiated.
+        auto retry = internal::MakeIntrusivePtr<BatchWrite>();
+        retry->pending = retry_nodes.size();
+        for (auto& [node, time] : retry_nodes) {
+          node->batch_write_ = retry;
+        }
+        for (auto& [node, time] : retry_nodes) {
+          node->InitiateWriteback(time);
+        }
+      });
+}
+
 class VirtualChunkedDriverSpec
     : public internal::RegisteredDriverSpec<VirtualChunkedDriverSpec,
                                             internal::DriverSpec> {
@@ -389,17 +730,29 @@ class VirtualChunkedDriverSpec
 
   std::optional<ReadFunction> read_function;
   std::optional<WriteFunction> write_function;
+  std::optional<BatchReadFunction> batch_read_function;
+  std::optional<BatchWriteFunction> batch_write_function;
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
   Context::Resource<internal::CachePoolResource> cache_pool;
   StalenessBound data_staleness;
+  std::string cache_key;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(internal::BaseCast<internal::DriverSpec>(x), x.read_function,
-             x.write_function, x.data_copy_concurrency, x.cache_pool,
-             x.data_staleness);
+             x.write_function, x.batch_read_function, x.batch_write_function,
+             x.data_copy_concurrency, x.cache_pool, x.data_staleness,
+             x.cache_key);
   };
 
+  bool supports_read() const {
+    return read_function.has_value() || batch_read_function.has_value();
+  }
+
+  bool supports_write() const {
+    return write_function.has_value() || batch_write_function.has_value();
+  }
+
   OpenMode open_mode() const override {
     // Since opening has no side effects, we return `open` even though `create`
     // might also be considered correct.
@@ -476,8 +829,15 @@ Result<internal::TransformedDriverSpec> VirtualChunkedDriver::GetBoundSpec(
   if (cache.write_function_) {
     driver_spec->write_function = cache.write_function_;
   }
+  if (cache.batch_read_function_) {
+    driver_spec->batch_read_function = cache.batch_read_function_;
+  }
+  if (cache.batch_write_function_) {
+    driver_spec->batch_write_function = cache.batch_write_function_;
+  }
   driver_spec->data_copy_concurrency = cache.data_copy_concurrency_;
   driver_spec->cache_pool = cache.cache_pool_;
+  driver_spec->cache_key = cache.cache_key_;
   driver_spec->data_staleness = this->data_staleness_bound();
   const DimensionIndex rank = this->rank();
   TENSORSTORE_RETURN_IF_ERROR(driver_spec->schema.Set(RankConstraint{rank}));
@@ -546,17 +906,17 @@ Result<internal::Driver::Handle> VirtualChunkedDriver::OpenFromSpecData(
     Transaction transaction, const VirtualChunkedDriverSpec& spec,
     ReadWriteMode read_write_mode) {
   if ((read_write_mode & ReadWriteMode::read) == ReadWriteMode::read &&
-      !spec.read_function) {
+      !spec.supports_read()) {
     return absl::InvalidArgumentError("Reading not supported");
   }
   if ((read_write_mode & ReadWriteMode::write) == ReadWriteMode::write &&
-      !spec.write_function) {
+      !spec.supports_write()) {
     return absl::InvalidArgumentError("Writing not supported");
   }
   if (read_write_mode == ReadWriteMode::dynamic) {
     read_write_mode =
-        (spec.read_function ? ReadWriteMode::read : ReadWriteMode{}) |
-        (spec.write_function ? ReadWriteMode::write : ReadWriteMode{});
+        (spec.supports_read() ? ReadWriteMode::read : ReadWriteMode{}) |
+        (spec.supports_write() ? ReadWriteMode::write : ReadWriteMode{});
   }
 
   const DimensionIndex rank = spec.schema.rank();
@@ -643,8 +1003,25 @@ Result<internal::Driver::Handle> VirtualChunkedDriver::OpenFromSpecData(
   }
 
   // Cache key of "" means a distinct cache on each call to `GetCache`.
-  auto cache =
-      internal::GetCache<VirtualChunkedCache>(spec.cache_pool->get(), "", [&] {
+  std::string cache_identifier;
+  if (!spec.cache_key.empty()) {
+    std::vector<Index> chunk_origin(chunk_template.origin().begin(),
+                                    chunk_template.origin().end());
+    std::vector<Index> chunk_shape(chunk_template.shape().begin(),
+                                   chunk_template.shape().end());
+    std::vector<Index> domain_origin(domain.origin().begin(),
+                                     domain.origin().end());
+    std::vector<Index> domain_shape(domain.shape().begin(),
+                                    domain.shape().end());
+    internal::EncodeCacheKey(
+        &cache_identifier, spec.cache_key, spec.schema.dtype().name(),
+        domain_origin, domain_shape, chunk_origin, chunk_shape, inner_order,
+        spec.data_copy_concurrency, spec.read_function.has_value(),
+        spec.write_function.has_value(), spec.batch_read_function.has_value(),
+        spec.batch_write_function.has_value());
+  }
+  auto cache = internal::GetCache<VirtualChunkedCache>(
+      spec.cache_pool->get(), cache_identifier, [&] {
         // Create the fill value array, which is just a single value-initialized
         // element broadcast to have a shape equal to the component chunk shape.
         // The fill value is not user-configurable and doesn't have any
@@ -676,11 +1053,21 @@ Result<internal::Driver::Handle> VirtualChunkedDriver::OpenFromSpecData(
         if (spec.write_function) {
           cache->write_function_ = *spec.write_function;
         }
+        if (spec.batch_read_function) {
+          cache->batch_read_function_ = *spec.batch_read_function;
+          // The `AsyncCache` batch entries must be submitted before the
+          // `BatchReadEntry`, which has a nesting depth of 0.
+          cache->SetBatchNestingDepth(1);
+        }
+        if (spec.batch_write_function) {
+          cache->batch_write_function_ = *spec.batch_write_function;
+        }
         cache->inner_order_ = std::move(inner_order);
         cache->grid_origin_for_read_function_.assign(
             chunk_template.origin().begin(), chunk_template.origin().end());
         cache->cache_pool_ = spec.cache_pool;
         cache->data_copy_concurrency_ = spec.data_copy_concurrency;
+        cache->cache_key_ = spec.cache_key;
         return cache;
       });
   handle.driver = internal::MakeReadWritePtr<VirtualChunkedDriver>(
@@ -701,16 +1088,9 @@ Future<internal::Driver::Handle> VirtualChunkedDriverSpec::Open(
 }  // namespace
 
 namespace internal_virtual_chunked {
-Result<internal::Driver::Handle> MakeDriver(
-    virtual_chunked::ReadFunction read_function,
-    virtual_chunked::WriteFunction write_function, OpenOptions&& options) {
-  VirtualChunkedDriverSpec spec;
-  if (read_function) {
-    spec.read_function = std::move(read_function);
-  }
-  if (write_function) {
-    spec.write_function = std::move(write_function);
-  }
+namespace {
+Result<internal::Driver::Handle> MakeDriverFromSpec(
+    VirtualChunkedDriverSpec& spec, OpenOptions&& options) {
   spec.schema = static_cast<Schema&&>(options);
 
   if (!options.context) {
@@ -729,9 +1109,39 @@ Result<internal::Driver::Handle> MakeDriver(
     spec.data_staleness = StalenessBound(options.recheck_cached_data);
   }
 
+  spec.cache_key = std::move(options.cache_key);
+
   return VirtualChunkedDriver::OpenFromSpecData(std::move(options.transaction),
                                                 spec);
 }
+}  // namespace
+
+Result<internal::Driver::Handle> MakeDriver(
+    virtual_chunked::ReadFunction read_function,
+    virtual_chunked::WriteFunction write_function, OpenOptions&& options) {
+  VirtualChunkedDriverSpec spec;
+  if (read_function) {
+    spec.read_function = std::move(read_function);
+  }
+  if (write_function) {
+    spec.write_function = std::move(write_function);
+  }
+  return MakeDriverFromSpec(spec, std::move(options));
+}
+
+Result<internal::Driver::Handle> MakeBatchedDriver(
+    virtual_chunked::BatchReadFunction batch_read_function,
+    virtual_chunked::BatchWriteFunction batch_write_function,
+    OpenOptions&& options) {
+  VirtualChunkedDriverSpec spec;
+  if (batch_read_function) {
+    spec.batch_read_function = std::move(batch_read_function);
+  }
+  if (batch_write_function) {
+    spec.batch_write_function = std::move(batch_write_function);
+  }
+  return MakeDriverFromSpec(spec, std::move(options));
+}
 }  // namespace internal_virtual_chunked
 }  // namespace virtual_chunked
 
@@ -744,6 +1154,10 @@ struct GarbageCollection<virtual_chunked::VirtualChunkedDriver> {
                                                value.cache()->read_function_);
     garbage_collection::GarbageCollectionVisit(visitor,
                                                value.cache()->write_function_);
+    garbage_collection::GarbageCollectionVisit(
+        visitor, value.cache()->batch_read_function_);
+    garbage_collection::GarbageCollectionVisit(
+        visitor, value.cache()->batch_write_function_);
   }
 };
 }  // namespace garbage_collection
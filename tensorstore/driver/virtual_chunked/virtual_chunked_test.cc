@@ -63,6 +63,8 @@ using ::tensorstore::TimestampedStorageGeneration;
 using ::tensorstore::internal::ConcurrentQueue;
 using ::tensorstore::internal::UniqueNow;
 using ::tensorstore::serialization::SerializationRoundTrip;
+using ::tensorstore::virtual_chunked::ReadChunk;
+using ::tensorstore::virtual_chunked::WriteChunk;
 
 template <typename... Option>
 Result<tensorstore::TensorStore<Index, dynamic_rank,
@@ -374,6 +376,46 @@ TEST(VirtualChunkedTest, RecheckCacheImmutable) {
               ::testing::Optional(tensorstore::MakeScalarArray<int>(42)));
 }
 
+// Tests that views with the same `CacheKey` share cached chunks.
+TEST(VirtualChunkedTest, SharedCacheKey) {
+  ConcurrentQueue<ReadRequest<int, 0>> requests1;
+  ConcurrentQueue<ReadRequest<int, 0>> requests2;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context, tensorstore::Context::FromJson(
+                        {{"cache_pool", {{"total_bytes_limit", 10000000}}}}));
+  auto mock_view1 = MockView<int, 0>(
+      requests1, tensorstore::virtual_chunked::CacheKey{"x"}, context);
+  auto mock_view2 = MockView<int, 0>(
+      requests2, tensorstore::virtual_chunked::CacheKey{"x"}, context);
+  auto read_future1 = tensorstore::Read(mock_view1);
+  auto read_future2 = tensorstore::Read(mock_view2);
+  {
+    auto request = requests1.pop();
+    request.array() = 42;
+    request.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString(""), absl::InfiniteFuture()));
+  }
+  EXPECT_THAT(read_future1.result(),
+              ::testing::Optional(tensorstore::MakeScalarArray<int>(42)));
+  EXPECT_THAT(read_future2.result(),
+              ::testing::Optional(tensorstore::MakeScalarArray<int>(42)));
+  EXPECT_TRUE(requests1.empty());
+  EXPECT_TRUE(requests2.empty());
+
+  // A view without a cache key uses a separate cache.
+  ConcurrentQueue<ReadRequest<int, 0>> requests3;
+  auto mock_view3 = MockView<int, 0>(requests3, context);
+  auto read_future3 = tensorstore::Read(mock_view3);
+  {
+    auto request = requests3.pop();
+    request.array() = 43;
+    request.promise.SetResult(TimestampedStorageGeneration(
+        StorageGeneration::FromString(""), absl::InfiniteFuture()));
+  }
+  EXPECT_THAT(read_future3.result(),
+              ::testing::Optional(tensorstore::MakeScalarArray<int>(43)));
+}
+
 TEST(VirtualChunkedTest, ReadWrite) {
   ConcurrentQueue<ReadRequest<int, 1>> read_requests;
   ConcurrentQueue<WriteRequest<int, 1>> write_requests;
@@ -582,4 +624,144 @@ TEST(VirtualChunkedTest, NonAtomicSingleChunk) {
   TENSORSTORE_ASSERT_OK(future);
 }
 
+// Records the chunks passed to each call to a batch read or write function.
+struct BatchLog {
+  absl::Mutex mutex;
+  std::vector<std::vector<tensorstore::SharedOffsetArray<const void>>> batches;
+
+  // If `true`, a generation mismatch is returned for the first chunk of the
+  // first batch.
+  bool mismatch_first_chunk = false;
+
+  // If `true`, the functions return no generations.
+  bool omit_generations = false;
+};
+
+auto CoordinatesBatchReadFunction(BatchLog& log) {
+  return tensorstore::NonSerializable{
+      [&log](span<const ReadChunk> chunks)
+          -> Future<std::vector<TimestampedStorageGeneration>> {
+        absl::MutexLock lock(&log.mutex);
+        std::vector<tensorstore::SharedOffsetArray<const void>> outputs;
+        std::vector<TimestampedStorageGeneration> stamps;
+        for (const auto& chunk : chunks) {
+          auto output = tensorstore::StaticCast<
+              tensorstore::Array<Index, dynamic_rank,
+                                 tensorstore::offset_origin>,
+              tensorstore::unchecked>(chunk.output);
+          tensorstore::IterateOverIndexRange(
+              output.domain(),
+              [&](span<const Index> indices) { output(indices) = indices[0]; });
+          outputs.push_back(tensorstore::MakeCopy(output));
+          stamps.emplace_back(StorageGeneration::FromString(""),
+                              absl::InfiniteFuture());
+        }
+        log.batches.push_back(std::move(outputs));
+        if (log.omit_generations) stamps.clear();
+        return stamps;
+      }};
+}
+
+auto LoggingBatchWriteFunction(BatchLog& log) {
+  return tensorstore::NonSerializable{
+      [&log](span<const WriteChunk> chunks)
+          -> Future<std::vector<TimestampedStorageGeneration>> {
+        absl::MutexLock lock(&log.mutex);
+        std::vector<tensorstore::SharedOffsetArray<const void>> inputs;
+        std::vector<TimestampedStorageGeneration> stamps;
+        for (const auto& chunk : chunks) {
+          inputs.push_back(tensorstore::MakeCopy(chunk.input));
+          stamps.emplace_back(StorageGeneration::FromString(""), absl::Now());
+        }
+        if (log.mismatch_first_chunk && log.batches.empty()) {
+          stamps[0].generation = StorageGeneration::Unknown();
+        }
+        log.batches.push_back(std::move(inputs));
+        if (log.omit_generations) stamps.clear();
+        return stamps;
+      }};
+}
+
+TEST(VirtualChunkedTest, BatchedRead) {
+  BatchLog log;
+  auto store = tensorstore::VirtualChunkedBatched<Index, 1>(
+      CoordinatesBatchReadFunction(log), tensorstore::Schema::Shape({5}),
+      tensorstore::ChunkLayout::ChunkShape({2}));
+  TENSORSTORE_ASSERT_OK(store);
+  EXPECT_THAT(tensorstore::Read(*store).result(),
+              ::testing::Optional(
+                  tensorstore::MakeArray<Index>({0, 1, 2, 3, 4})));
+  absl::MutexLock lock(&log.mutex);
+  ASSERT_EQ(1, log.batches.size());
+  EXPECT_THAT(log.batches[0],
+              ::testing::UnorderedElementsAre(
+                  tensorstore::MakeOffsetArray<Index>({0}, {0, 1}),
+                  tensorstore::MakeOffsetArray<Index>({2}, {2, 3}),
+                  tensorstore::MakeOffsetArray<Index>({4}, {4})));
+}
+
+TEST(VirtualChunkedTest, BatchedReadWrongNumberOfGenerations) {
+  BatchLog log;
+  log.omit_generations = true;
+  auto store = tensorstore::VirtualChunkedBatched<Index, 1>(
+      CoordinatesBatchReadFunction(log), tensorstore::Schema::Shape({5}),
+      tensorstore::ChunkLayout::ChunkShape({2}));
+  TENSORSTORE_ASSERT_OK(store);
+  EXPECT_THAT(tensorstore::Read(*store).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "batch_read_function returned 0 generations for "
+                            "3 chunks"));
+}
+
+TEST(VirtualChunkedTest, BatchedTransactionalWrite) {
+  BatchLog log;
+  tensorstore::Transaction transaction(tensorstore::isolated);
+  auto store = tensorstore::VirtualChunkedBatchedWriteOnly<int, 1>(
+      LoggingBatchWriteFunction(log), tensorstore::Schema::Shape({5}),
+      tensorstore::ChunkLayout::ChunkShape({2}), transaction);
+  TENSORSTORE_ASSERT_OK(store);
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int>(42), *store));
+  TENSORSTORE_ASSERT_OK(transaction.CommitAsync());
+  absl::MutexLock lock(&log.mutex);
+  ASSERT_EQ(1, log.batches.size());
+  EXPECT_THAT(log.batches[0],
+              ::testing::UnorderedElementsAre(
+                  tensorstore::MakeOffsetArray<int>({0}, {42, 42}),
+                  tensorstore::MakeOffsetArray<int>({2}, {42, 42}),
+                  tensorstore::MakeOffsetArray<int>({4}, {42})));
+}
+
+TEST(VirtualChunkedTest, BatchedWriteRetry) {
+  BatchLog log;
+  log.mismatch_first_chunk = true;
+  tensorstore::Transaction transaction(tensorstore::isolated);
+  auto store = tensorstore::VirtualChunkedBatchedWriteOnly<int, 1>(
+      LoggingBatchWriteFunction(log), tensorstore::Schema::Shape({4}),
+      tensorstore::ChunkLayout::ChunkShape({2}), transaction);
+  TENSORSTORE_ASSERT_OK(store);
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int>(42), *store));
+  TENSORSTORE_ASSERT_OK(transaction.CommitAsync());
+  absl::MutexLock lock(&log.mutex);
+  ASSERT_EQ(2, log.batches.size());
+  ASSERT_EQ(2, log.batches[0].size());
+  // Only the mismatched chunk is retried.
+  EXPECT_THAT(log.batches[1], ::testing::ElementsAre(log.batches[0][0]));
+}
+
+TEST(VirtualChunkedTest, BatchedWriteWrongNumberOfGenerations) {
+  BatchLog log;
+  log.omit_generations = true;
+  auto store = tensorstore::VirtualChunkedBatchedWriteOnly<int, 1>(
+      LoggingBatchWriteFunction(log), tensorstore::Schema::Shape({2}));
+  TENSORSTORE_ASSERT_OK(store);
+  EXPECT_THAT(
+      tensorstore::Write(tensorstore::MakeScalarArray<int>(42), *store)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*batch_write_function returned 0 generations for 1 "
+                    "chunks"));
+}
+
 }  // namespace
@@ -36,7 +36,10 @@
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/internal/tracing/tracing.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/progress.h"
 #include "tensorstore/read_write_options.h"
@@ -121,6 +124,7 @@ struct WriteState : public internal::AtomicReferenceCount<WriteState> {
   DataTypeConversionLookupResult data_type_conversion;
   DriverPtr target_driver;
   internal::OpenTransactionPtr target_transaction;
+  IoStats io_stats;
   DomainAlignmentOptions alignment_options;
   Promise<void> copy_promise;
   Promise<void> commit_promise;
@@ -268,6 +272,7 @@ struct DriverWriteInitiateOp {
     Driver::WriteRequest request;
     request.transaction = std::move(state->target_transaction);
     request.transform = std::move(target_transform);
+    request.io_stats = state->io_stats;
     target_driver->Write(std::move(request),
                          WriteChunkReceiver{std::move(state)});
   }
@@ -289,11 +294,12 @@ WriteFutures DriverWrite(Executor executor,
   state->target_driver = std::move(target.driver);
   TENSORSTORE_ASSIGN_OR_RETURN(
       state->target_transaction,
-      internal::AcquireOpenTransactionPtrOrError(target.transaction));
+      internal::AcquireOpenTransactionPtrForWriteOrError(target.transaction));
   state->source = std::move(source);
   state->source_data_reference_restriction =
       options.source_data_reference_restriction;
   state->alignment_options = options.alignment_options;
+  state->io_stats = std::move(options.io_stats);
   state->commit_state->write_progress_function =
       std::move(options.progress_function);
   auto copy_pair = PromiseFuturePair<void>::Make(MakeResult());
@@ -305,12 +311,14 @@ WriteFutures DriverWrite(Executor executor,
   } else {
     commit_pair.future = copy_pair.future;
   }
+  internal_tracing::Span span("tensorstore.Write");
+  internal_tracing::SpanScope scope(span);
 
   // Resolve the bounds for `target.transform`.
   Driver::ResolveBoundsRequest request;
   request.transaction = state->target_transaction;
   request.transform = std::move(target.transform);
-  request.options = fix_resizable_bounds;
+  request.options = options.resolve_bounds_mode;
   auto transform_future =
       state->target_driver->ResolveBounds(std::move(request));
 
@@ -318,7 +326,11 @@ WriteFutures DriverWrite(Executor executor,
   LinkValue(WithExecutor(std::move(executor),
                          DriverWriteInitiateOp{std::move(state)}),
             std::move(copy_pair.promise), std::move(transform_future));
-  return {std::move(copy_pair.future), std::move(commit_pair.future)};
+  // The span covers the write through to commit, since for a
+  // non-transactional write that is when the data reaches storage.
+  return {std::move(copy_pair.future),
+          internal_tracing::EndSpanWhenReady(std::move(span),
+                                             std::move(commit_pair.future))};
 }
 
 WriteFutures DriverWrite(TransformedSharedArray<const void> source,
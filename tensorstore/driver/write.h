@@ -21,6 +21,7 @@
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/progress.h"
 #include "tensorstore/read_write_options.h"
+#include "tensorstore/resize_options.h"
 #include "tensorstore/util/executor.h"
 
 namespace tensorstore {
@@ -30,6 +31,11 @@ namespace internal {
 struct DriverWriteOptions : public WriteOptions {
   DataTypeConversionFlags data_type_conversion_flags =
       DataTypeConversionFlags::kSafeAndImplicit;
+
+  /// Options used to resolve the bounds of the target.  Omitting
+  /// `fix_resizable_bounds` permits writing beyond implicit (resizable)
+  /// bounds, e.g. to write chunks before the metadata is resized.
+  ResolveBoundsMode resolve_bounds_mode = fix_resizable_bounds;
 };
 
 /// Copies data from an array to a TensorStore driver.
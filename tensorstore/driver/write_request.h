@@ -16,6 +16,7 @@
 #define TENSORSTORE_DRIVER_WRITE_REQUEST_H_
 
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/transaction.h"
 
 namespace tensorstore {
@@ -25,6 +26,7 @@ namespace internal {
 struct DriverWriteRequest {
   internal::OpenTransactionPtr transaction;
   IndexTransform<> transform;
+  IoStats io_stats;
 };
 
 }  // namespace internal
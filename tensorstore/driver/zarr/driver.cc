@@ -53,8 +53,10 @@
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/grid_storage_statistics.h"
+#include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/spec.h"
@@ -98,8 +100,8 @@ DimensionSeparator GetDimensionSeparator(
 }
 
 Result<ZarrMetadataPtr> ParseEncodedMetadata(std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
+  nlohmann::json raw_data = internal_json::ParseJson(encoded_value);
   if (raw_data.is_discarded()) {
     return absl::FailedPreconditionError("Invalid JSON");
   }
@@ -421,6 +423,11 @@ Future<ArrayStorageStatistics> ZarrDriver::GetStorageStatistics(
                 static_cast<const ZarrMetadata*>(future.value().get());
             auto& grid = cache->grid();
             auto& component = grid.components[component_index];
+            // The summary does not reflect uncommitted writes.
+            std::shared_ptr<internal::ChunkPresenceSummary> chunk_presence;
+            if (!request.transaction) {
+              chunk_presence = cache->chunk_presence_summary();
+            }
             LinkResult(
                 std::move(promise),
                 internal::GetStorageStatisticsForRegularGridWithBase10Keys(
@@ -434,7 +441,8 @@ Future<ArrayStorageStatistics> ZarrDriver::GetStorageStatistics(
                     /*shape=*/metadata->shape,
                     /*dimension_separator=*/
                     GetDimensionSeparatorChar(cache->dimension_separator_),
-                    staleness_bound, request.options));
+                    staleness_bound, request.options,
+                    std::move(chunk_presence)));
           }),
       std::move(promise), std::move(metadata_future));
   return std::move(future);
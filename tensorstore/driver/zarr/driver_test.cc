@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -71,6 +72,7 @@
 #include "tensorstore/tensorstore.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/execution/future_collecting_receiver.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status_testutil.h"
@@ -746,6 +748,99 @@ TEST_F(MockKeyValueStoreTest, CreateWithTransactionAlreadyExists) {
                             "Error writing \"prefix/.zarray\""));
 }
 
+// Tests that non-transactional writes to the same chunk are written back
+// together when writeback is delayed.
+TEST_F(MockKeyValueStoreTest, WritebackDelayCoalescesWrites) {
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {100, 100}},
+           {"chunks", {3, 2}},
+       }},
+      {"create", true},
+      {"writeback_delay", {{"max_delay", "1h"}}},
+  };
+  auto store_future = tensorstore::Open(json_spec, context);
+  store_future.Force();
+  mock_key_value_store->read_requests.pop()(memory_store);
+  mock_key_value_store->write_requests.pop()(memory_store);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, store_future.result());
+
+  auto write_future1 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(1),
+      store | tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 1}));
+  TENSORSTORE_ASSERT_OK(write_future1.copy_future.result());
+  auto write_future2 = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(2),
+      store | tensorstore::Dims(0, 1).SizedInterval({0, 1}, {3, 1}));
+  TENSORSTORE_ASSERT_OK(write_future2.copy_future.result());
+
+  // The chunk is now fully overwritten, and is written back without being
+  // read.
+  {
+    auto req = mock_key_value_store->write_requests.pop();
+    EXPECT_EQ("prefix/0.0", req.key);
+    req(memory_store);
+  }
+  TENSORSTORE_EXPECT_OK(write_future1.commit_future.result());
+  TENSORSTORE_EXPECT_OK(write_future2.commit_future.result());
+  EXPECT_TRUE(mock_key_value_store->read_requests.empty());
+  EXPECT_TRUE(mock_key_value_store->write_requests.empty());
+}
+
+// Tests that at most `max_concurrency` delayed writebacks are in progress.
+TEST_F(MockKeyValueStoreTest, WritebackDelayMaxConcurrency) {
+  ::nlohmann::json json_spec{
+      {"driver", "zarr"},
+      {"kvstore",
+       {
+           {"driver", "mock_key_value_store"},
+           {"path", "prefix/"},
+       }},
+      {"metadata",
+       {
+           {"compressor", nullptr},
+           {"dtype", "<i2"},
+           {"shape", {100, 100}},
+           {"chunks", {3, 2}},
+       }},
+      {"create", true},
+      {"writeback_delay", {{"max_delay", "1h"}, {"max_concurrency", 1}}},
+  };
+  auto store_future = tensorstore::Open(json_spec, context);
+  store_future.Force();
+  mock_key_value_store->read_requests.pop()(memory_store);
+  mock_key_value_store->write_requests.pop()(memory_store);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, store_future.result());
+
+  // Fully overwrite two chunks.
+  auto write_future = tensorstore::Write(
+      tensorstore::MakeScalarArray<int16_t>(1),
+      store | tensorstore::Dims(0, 1).SizedInterval({0, 0}, {6, 2}));
+  TENSORSTORE_ASSERT_OK(write_future.copy_future.result());
+
+  // The writeback of the second chunk starts only once the writeback of the
+  // first chunk completes.
+  std::vector<std::string> keys;
+  for (int i = 0; i < 2; ++i) {
+    auto req = mock_key_value_store->write_requests.pop();
+    EXPECT_TRUE(mock_key_value_store->write_requests.empty());
+    keys.push_back(req.key);
+    req(memory_store);
+  }
+  EXPECT_THAT(keys,
+              ::testing::UnorderedElementsAre("prefix/0.0", "prefix/1.0"));
+  TENSORSTORE_EXPECT_OK(write_future.commit_future.result());
+}
+
 void TestCreateWriteRead(Context context, ::nlohmann::json json_spec) {
   // Create the store.
   {
@@ -2108,6 +2203,208 @@ TEST_P(RecheckCachedTest, RecheckCachedData) {
   }
 }
 
+TEST(PrefetchTest, PopulatesCache) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec,
+      Context::Spec::FromJson(
+          {{"cache_pool", {{"total_bytes_limit", 10000000}}}}));
+  Context writer_context(context_spec);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto writer, tensorstore::Open(GetJsonSpec(), writer_context,
+                                     tensorstore::OpenMode::create)
+                       .result());
+  auto region = tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 2});
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                         writer | region)
+          .result());
+
+  // Open using a separate cache pool that shares the same
+  // `memory_key_value_store`.
+  auto reader_spec = GetJsonSpec();
+  reader_spec["recheck_cached_data"] = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto reader,
+      tensorstore::Open(reader_spec, Context(context_spec, writer_context))
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Prefetch(reader | region).result());
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(2),
+                         writer | region)
+          .result());
+
+  // The prefetched value is returned from the cache.
+  EXPECT_THAT(tensorstore::Read(reader | region).result(),
+              ::testing::Optional(tensorstore::MakeArray<int16_t>(
+                  {{1, 1}, {1, 1}, {1, 1}})));
+}
+
+TEST(PinTest, RetainsPinnedData) {
+  // The cache pool retains almost nothing that is not pinned.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec,
+      Context::Spec::FromJson({{"cache_pool", {{"total_bytes_limit", 1}}}}));
+  Context writer_context(context_spec);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto writer, tensorstore::Open(GetJsonSpec(), writer_context,
+                                     tensorstore::OpenMode::create)
+                       .result());
+  auto region = tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 2});
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                         writer | region)
+          .result());
+
+  auto reader_spec = GetJsonSpec();
+  reader_spec["recheck_cached_data"] = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto reader,
+      tensorstore::Open(reader_spec, Context(context_spec, writer_context))
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto pin,
+                                   tensorstore::Pin(reader | region).result());
+  EXPECT_EQ(1, pin.num_chunks());
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(2),
+                         writer | region)
+          .result());
+
+  // The pinned value is returned from the cache.
+  EXPECT_THAT(tensorstore::Read(reader | region).result(),
+              ::testing::Optional(tensorstore::MakeArray<int16_t>(
+                  {{1, 1}, {1, 1}, {1, 1}})));
+
+  // Once unpinned, the chunk is evicted and the new value is read.
+  pin.Unpin();
+  EXPECT_THAT(tensorstore::Read(reader | region).result(),
+              ::testing::Optional(tensorstore::MakeArray<int16_t>(
+                  {{2, 2}, {2, 2}, {2, 2}})));
+}
+
+TEST(PinTest, PinnedBytesLimit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec,
+      Context::Spec::FromJson(
+          {{"cache_pool",
+            {{"total_bytes_limit", 10000000}, {"pinned_bytes_limit", 1}}}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(GetJsonSpec(), Context(context_spec),
+                                    tensorstore::OpenMode::create)
+                      .result());
+  auto region = tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 2});
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                         store | region)
+          .result());
+  EXPECT_THAT(tensorstore::Pin(store | region).result(),
+              MatchesStatus(absl::StatusCode::kResourceExhausted));
+}
+
+TEST(ReadChunksTest, ReferencesCachedData) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec,
+      Context::Spec::FromJson(
+          {{"cache_pool", {{"total_bytes_limit", 10000000}}}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::Open(GetJsonSpec(), Context(context_spec),
+                                    tensorstore::OpenMode::create)
+                      .result());
+  auto region = tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 4});
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                         store | region)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto chunks,
+      tensorstore::CollectFlowSenderIntoFuture<
+          std::vector<tensorstore::ReadChunkView>>(
+          tensorstore::ReadChunks(store | region))
+          .result());
+  // The region spans two chunks of shape `{3, 2}`.
+  ASSERT_EQ(2, chunks.size());
+  for (const auto& chunk : chunks) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto array1, chunk.array());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto array2, chunk.array());
+    // Each view references the decoded chunk in the cache, rather than a copy.
+    EXPECT_EQ(array1.element_pointer().data(),
+              array2.element_pointer().data());
+    EXPECT_EQ(chunk.domain(), array1.domain());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto copy, tensorstore::MakeCopy(array1));
+    EXPECT_EQ(6, copy.num_elements());
+    EXPECT_THAT(tensorstore::BroadcastArray(
+                    tensorstore::MakeScalarArray<int16_t>(1), copy.domain()),
+                ::testing::Optional(copy));
+  }
+}
+
+TEST(ReadTest, MissingChunksFillExistingArray) {
+  for (auto fill_value : {::nlohmann::json(nullptr), ::nlohmann::json(5)}) {
+    SCOPED_TRACE(fill_value.dump());
+    auto json_spec = GetJsonSpec();
+    json_spec["metadata"]["fill_value"] = fill_value;
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store,
+        tensorstore::Open(json_spec, tensorstore::OpenMode::create).result());
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                           store | tensorstore::Dims(0, 1).SizedInterval(
+                                       {0, 0}, {3, 2}))
+            .result());
+    // Missing chunks must overwrite the existing contents of the target with
+    // the fill value, whether or not it is zero.
+    auto array = tensorstore::AllocateArray<int16_t>({6, 4});
+    std::fill_n(array.data(), array.num_elements(), 7);
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::Read(
+            store | tensorstore::Dims(0, 1).SizedInterval({0, 0}, {6, 4}),
+            array)
+            .result());
+    const int16_t f = fill_value.is_null() ? 0 : 5;
+    EXPECT_EQ(tensorstore::MakeArray<int16_t>({{1, 1, f, f},
+                                               {1, 1, f, f},
+                                               {1, 1, f, f},
+                                               {f, f, f, f},
+                                               {f, f, f, f},
+                                               {f, f, f, f}}),
+              array);
+  }
+}
+
+TEST(EncodedCacheTest, ServesEvictedChunks) {
+  // The default `cache_pool` does not retain any decoded chunks.
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto writer, tensorstore::Open(GetJsonSpec(), context,
+                                     tensorstore::OpenMode::create)
+                       .result());
+  auto region = tensorstore::Dims(0, 1).SizedInterval({0, 0}, {3, 2});
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(1),
+                         writer | region)
+          .result());
+
+  auto reader_spec = GetJsonSpec();
+  reader_spec["recheck_cached_data"] = false;
+  reader_spec["encoded_cache_bytes"] = 1000000;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto reader, tensorstore::Open(reader_spec, context).result());
+  const auto expected =
+      tensorstore::MakeArray<int16_t>({{1, 1}, {1, 1}, {1, 1}});
+  EXPECT_THAT(tensorstore::Read(reader | region).result(),
+              ::testing::Optional(expected));
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<int16_t>(2),
+                         writer | region)
+          .result());
+
+  // The encoded chunk retained by `reader` is decoded again.
+  EXPECT_THAT(tensorstore::Read(reader | region).result(),
+              ::testing::Optional(expected));
+}
+
 /// Performs a sequence of metadata reads (`Open` or `ResolveBounds`) and
 /// modifications (`Resize`) to test the behavior of the
 /// `recheck_cached_metadata` policy specified by `recheck_option`.
@@ -0,0 +1,61 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// \file
+///
+/// Defines the "lz4" compressor for zarr.  Linking in this library
+/// automatically registers it.
+
+#include "tensorstore/internal/compression/lz4_compressor.h"
+
+#include "tensorstore/driver/zarr/compressor.h"
+#include "tensorstore/driver/zarr/compressor_registry.h"
+#include "tensorstore/internal/compression/lz4.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+
+namespace tensorstore {
+namespace internal_zarr {
+namespace {
+
+using ::tensorstore::internal::Lz4Compressor;
+namespace jb = ::tensorstore::internal_json_binding;
+
+struct Registration {
+  Registration() {
+    RegisterCompressor<Lz4Compressor>(
+        "lz4",
+        jb::Object(
+            jb::Member("acceleration",
+                       jb::Projection(
+                           &Lz4Compressor::acceleration,
+                           jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                               [](auto* v) { *v = 1; },
+                               jb::Integer<int>(1)))),
+            // Not supported by numcodecs, which only uses the fast
+            // compressor; omitted when `0` to keep the metadata readable by
+            // other implementations.
+            jb::Member("level",
+                       jb::Projection(
+                           &Lz4Compressor::level,
+                           jb::DefaultValue<jb::kNeverIncludeDefaults>(
+                               [](auto* v) { *v = 0; },
+                               jb::Integer<int>(lz4::kMinLevel,
+                                                lz4::kMaxLevel))))));
+  }
+} registration;
+
+}  // namespace
+}  // namespace internal_zarr
+}  // namespace tensorstore
@@ -0,0 +1,86 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "tensorstore/driver/zarr/compressor.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr::Compressor;
+
+// Tests that a small input round trips.
+TEST(Lz4CompressorTest, SmallRoundtrip) {
+  auto compressor =
+      Compressor::FromJson({{"id", "lz4"}, {"acceleration", 2}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+  absl::Cord encode_result, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encode_result, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+}
+
+// Tests that the high-compression mode round trips.
+TEST(Lz4CompressorTest, HighCompressionRoundtrip) {
+  auto compressor =
+      Compressor::FromJson({{"id", "lz4"}, {"level", 9}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+  absl::Cord encode_result, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encode_result, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+}
+
+// Tests that the encoded output matches the numcodecs framing.
+TEST(Lz4CompressorTest, Golden) {
+  auto compressor = Compressor::FromJson({{"id", "lz4"}}).value();
+  const absl::Cord input("abc");
+  absl::Cord encode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  EXPECT_EQ(absl::Cord(std::string_view("\x03\x00\x00\x00\x30"
+                                        "abc",
+                                        8)),
+            encode_result);
+}
+
+// Tests that an invalid parameter gives an error.
+TEST(Lz4CompressorTest, InvalidParameter) {
+  EXPECT_THAT(
+      Compressor::FromJson({{"id", "lz4"}, {"acceleration", 0}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Error parsing object member \"acceleration\": .*"));
+  EXPECT_THAT(Compressor::FromJson({{"id", "lz4"}, {"level", 13}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"level\": .*"));
+  EXPECT_THAT(Compressor::FromJson({{"id", "lz4"}, {"foo", 10}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Object includes extra members: \"foo\""));
+}
+
+TEST(Lz4CompressorTest, ToJson) {
+  EXPECT_EQ(nlohmann::json({{"id", "lz4"}, {"acceleration", 1}}),
+            Compressor::FromJson({{"id", "lz4"}}).value().ToJson());
+  EXPECT_EQ(nlohmann::json({{"id", "lz4"}, {"acceleration", 1}, {"level", 9}}),
+            Compressor::FromJson({{"id", "lz4"}, {"level", 9}})
+                .value()
+                .ToJson());
+}
+
+}  // namespace
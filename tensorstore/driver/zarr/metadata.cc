@@ -36,15 +36,14 @@
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
-#include "riegeli/bytes/cord_writer.h"
-#include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
-#include "riegeli/bytes/write.h"
-#include "riegeli/bytes/writer.h"
 #include "tensorstore/array.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
+#include "tensorstore/driver/codec_metrics.h"
 #include "tensorstore/driver/zarr/dtype.h"
 #include "tensorstore/driver/zarr3/default_nan.h"
 #include "tensorstore/index.h"
@@ -59,6 +58,7 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/riegeli/array_endian_codec.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/internal/type_traits.h"
 #include "tensorstore/json_serialization_options_base.h"
 #include "tensorstore/rank.h"
@@ -444,7 +444,8 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(ZarrPartialMetadata,
 // Two decoding strategies:  raw decoder and custom decoder.  Initially we will
 // only support raw decoder.
 
-Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
+namespace {
+Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunkImpl(
     const ZarrMetadata& metadata, absl::Cord buffer) {
   const size_t num_fields = metadata.dtype.fields.size();
   absl::InlinedVector<SharedArray<const void>, 1> field_arrays(num_fields);
@@ -472,16 +473,25 @@ Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
       std::reverse(c_order_shape, c_order_shape + metadata.rank);
       c_order_shape_span = span(&c_order_shape[0], full_chunk_shape.size());
     }
-    std::unique_ptr<riegeli::Reader> reader =
-        std::make_unique<riegeli::CordReader<absl::Cord>>(std::move(buffer));
+    SharedArray<const void> array;
     if (metadata.compressor) {
-      reader = metadata.compressor->GetReader(
-          std::move(reader), metadata.dtype.bytes_per_outer_element);
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          array, internal::DecodeArrayEndian(
+                     [&](span<char> decoded) {
+                       return metadata.compressor->DecodeInto(
+                           buffer, decoded,
+                           metadata.dtype.bytes_per_outer_element);
+                     },
+                     dtype_field.dtype, c_order_shape_span,
+                     dtype_field.endian, c_order));
+    } else {
+      std::unique_ptr<riegeli::Reader> reader =
+          std::make_unique<riegeli::CordReader<absl::Cord>>(std::move(buffer));
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          array, internal::DecodeArrayEndian(*reader, dtype_field.dtype,
+                                             c_order_shape_span,
+                                             dtype_field.endian, c_order));
     }
-    TENSORSTORE_ASSIGN_OR_RETURN(
-        auto array, internal::DecodeArrayEndian(*reader, dtype_field.dtype,
-                                                c_order_shape_span,
-                                                dtype_field.endian, c_order));
     if (metadata.order == fortran_order) {
       std::reverse(array.shape().begin(),
                    array.shape().begin() + metadata.rank);
@@ -492,11 +502,10 @@ Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
     return field_arrays;
   }
   if (metadata.compressor) {
-    std::unique_ptr<riegeli::Reader> reader =
-        std::make_unique<riegeli::CordReader<absl::Cord>>(std::move(buffer));
-    reader = metadata.compressor->GetReader(
-        std::move(reader), metadata.dtype.bytes_per_outer_element);
-    TENSORSTORE_RETURN_IF_ERROR(riegeli::ReadAll(std::move(reader), buffer));
+    absl::Cord decoded;
+    TENSORSTORE_RETURN_IF_ERROR(metadata.compressor->Decode(
+        buffer, &decoded, metadata.dtype.bytes_per_outer_element));
+    buffer = std::move(decoded);
   }
   if (static_cast<Index>(buffer.size()) !=
       metadata.chunk_layout.bytes_per_chunk) {
@@ -534,6 +543,20 @@ Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
   }
   return field_arrays;
 }
+}  // namespace
+
+Result<absl::InlinedVector<SharedArray<const void>, 1>> DecodeChunk(
+    const ZarrMetadata& metadata, absl::Cord buffer) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
+  const absl::Time start_time = absl::Now();
+  auto result = DecodeChunkImpl(metadata, std::move(buffer));
+  if (result.ok()) {
+    internal::RecordCodecDecodeMetric("zarr",
+                                      metadata.chunk_layout.bytes_per_chunk,
+                                      absl::Now() - start_time);
+  }
+  return result;
+}
 
 namespace {
 bool SingleArrayMatchesEncodedRepresentation(
@@ -569,8 +592,10 @@ absl::Cord CopyComponentsToEncodedLayout(
 }
 }  // namespace
 
-Result<absl::Cord> EncodeChunk(const ZarrMetadata& metadata,
-                               span<const SharedArray<const void>> components) {
+namespace {
+Result<absl::Cord> EncodeChunkImpl(
+    const ZarrMetadata& metadata,
+    span<const SharedArray<const void>> components) {
   absl::Cord output;
   if (components.size() == 1 &&
       SingleArrayMatchesEncodedRepresentation(metadata, components[0])) {
@@ -580,16 +605,26 @@ Result<absl::Cord> EncodeChunk(const ZarrMetadata& metadata,
   }
   if (metadata.compressor) {
     absl::Cord encoded;
-    std::unique_ptr<riegeli::Writer> writer =
-        std::make_unique<riegeli::CordWriter<absl::Cord*>>(&encoded);
-    writer = metadata.compressor->GetWriter(
-        std::move(writer), metadata.dtype.bytes_per_outer_element);
-    TENSORSTORE_RETURN_IF_ERROR(
-        riegeli::Write(std::move(output), std::move(writer)));
+    TENSORSTORE_RETURN_IF_ERROR(metadata.compressor->Encode(
+        output, &encoded, metadata.dtype.bytes_per_outer_element));
     return encoded;
   }
   return output;
 }
+}  // namespace
+
+Result<absl::Cord> EncodeChunk(const ZarrMetadata& metadata,
+                               span<const SharedArray<const void>> components) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kEncode);
+  const absl::Time start_time = absl::Now();
+  auto result = EncodeChunkImpl(metadata, components);
+  if (result.ok()) {
+    internal::RecordCodecEncodeMetric("zarr",
+                                      metadata.chunk_layout.bytes_per_chunk,
+                                      absl::Now() - start_time);
+  }
+  return result;
+}
 
 bool IsMetadataCompatible(const ZarrMetadata& a, const ZarrMetadata& b) {
   // Rank must be the same.
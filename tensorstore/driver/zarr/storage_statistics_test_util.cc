@@ -69,7 +69,8 @@ TEST_P(ZarrLikeStorageStatisticsTest, FullyLexicographicOrder) {
     mock_kvstore->request_log.pop_all();
 
     // Query not_stored after writing: not_stored=false because it is now fully
-    // stored.
+    // stored.  The first present chunk determines the result, so no further
+    // chunks are checked.
     EXPECT_THAT(tensorstore::GetStorageStatistics(
                     transformed, ArrayStorageStatistics::query_not_stored)
                     .result(),
@@ -77,14 +78,10 @@ TEST_P(ZarrLikeStorageStatisticsTest, FullyLexicographicOrder) {
                     /*.mask=*/ArrayStorageStatistics::query_not_stored,
                     /*.not_stored=*/false}));
     EXPECT_THAT(mock_kvstore->request_log.pop_all(),
-                ::testing::UnorderedElementsAreArray({
+                ::testing::ElementsAre(
                     MatchesJson({{"type", "read"},
                                  {"key", StrCat("0", sep, "0", sep, "0")},
-                                 {"byte_range_exclusive_max", 0}}),
-                    MatchesJson({{"type", "read"},
-                                 {"key", StrCat("1", sep, "0", sep, "0")},
-                                 {"byte_range_exclusive_max", 0}}),
-                }));
+                                 {"byte_range_exclusive_max", 0}})));
 
     // Query not_stored and fully_stored.
     EXPECT_THAT(tensorstore::GetStorageStatistics(
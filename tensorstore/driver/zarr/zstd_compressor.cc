@@ -19,9 +19,13 @@
 
 #include "tensorstore/internal/compression/zstd_compressor.h"
 
+#include <string>
+#include <utility>
+
 #include "riegeli/zstd/zstd_writer.h"
 #include "tensorstore/driver/zarr/compressor.h"
 #include "tensorstore/driver/zarr/compressor_registry.h"
+#include "tensorstore/internal/compression/zstd_dictionary.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 
 namespace tensorstore {
@@ -36,15 +40,24 @@ struct Registration {
   Registration() {
     RegisterCompressor<ZstdCompressor>(
         "zstd",
-        jb::Object(jb::Member(
-            "level",
-            jb::Projection(
-                &ZstdCompressor::level,
-                jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
-                    [](auto* v) { *v = 1; },
-                    jb::Integer<int>(
-                        ZstdWriterBase::Options::kMinCompressionLevel,
-                        ZstdWriterBase::Options::kMaxCompressionLevel))))));
+        jb::Object(
+            jb::Member(
+                "level",
+                jb::Projection(
+                    &ZstdCompressor::level,
+                    jb::DefaultValue<jb::kAlwaysIncludeDefaults>(
+                        [](auto* v) { *v = 1; },
+                        jb::Integer<int>(
+                            ZstdWriterBase::Options::kMinCompressionLevel,
+                            ZstdWriterBase::Options::kMaxCompressionLevel)))),
+            jb::Member(
+                "dictionary",
+                jb::GetterSetter<std::string>(
+                    [](const ZstdCompressor& c) { return c.dictionary(); },
+                    [](ZstdCompressor& c, std::string dictionary) {
+                      c.set_dictionary(std::move(dictionary));
+                    },
+                    internal::ZstdDictionaryJsonBinder))));
   }
 } registration;
 
@@ -12,8 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/write.h"
 #include "tensorstore/driver/zarr/compressor.h"
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/util/status.h"
@@ -76,6 +84,94 @@ TEST(ZstdCompressorTest, InvalidParameter) {
                             "Object includes extra members: \"foo\""));
 }
 
+// Tests that a dictionary round trips and improves the compression ratio when
+// the input resembles the dictionary content.
+TEST(ZstdCompressorTest, Dictionary) {
+  // Base64 encoding of a raw content dictionary equal to `input`.
+  const std::string dictionary =
+      "VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wZWQg"
+      "b3ZlciB0aGUgbGF6eSBkb2cu";
+  auto compressor =
+      Compressor::FromJson({{"id", "zstd"}, {"dictionary", dictionary}})
+          .value();
+  EXPECT_EQ(nlohmann::json(
+                {{"id", "zstd"}, {"level", 1}, {"dictionary", dictionary}}),
+            compressor.ToJson());
+  auto compressor_without_dictionary =
+      Compressor::FromJson({{"id", "zstd"}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+  absl::Cord encode_result, encode_result_without_dictionary, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(compressor_without_dictionary->Encode(
+      input, &encode_result_without_dictionary, 1));
+  EXPECT_LT(encode_result.size(), encode_result_without_dictionary.size());
+  TENSORSTORE_ASSERT_OK(compressor->Decode(encode_result, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+}
+
+TEST(ZstdCompressorTest, InvalidDictionary) {
+  EXPECT_THAT(Compressor::FromJson({{"id", "zstd"}, {"dictionary", "!"}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"dictionary\": "
+                            "Expected base64-encoded string.*"));
+}
+
+// Tests that repeated use of the per-thread contexts with varying levels and
+// sizes round trips.
+TEST(ZstdCompressorTest, ReusedContextRoundtrip) {
+  std::string text;
+  for (int i = 0; i < 10000; ++i) text += std::to_string(i % 97);
+  for (int level : {1, 9, -5, 3}) {
+    auto compressor =
+        Compressor::FromJson({{"id", "zstd"}, {"level", level}}).value();
+    for (size_t size : {0, 1, 100, 20000}) {
+      const absl::Cord input(text.substr(0, size));
+      absl::Cord encode_result, decode_result;
+      TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+      TENSORSTORE_ASSERT_OK(
+          compressor->Decode(encode_result, &decode_result, 1));
+      EXPECT_EQ(input, decode_result);
+    }
+  }
+}
+
+// Tests that `Encode` and `Decode` interoperate with the streaming interface,
+// which does not record the decoded size in the frame.
+TEST(ZstdCompressorTest, StreamingInterop) {
+  auto compressor = Compressor::FromJson({{"id", "zstd"}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+
+  absl::Cord streamed;
+  TENSORSTORE_ASSERT_OK(riegeli::Write(
+      input, compressor->GetWriter(
+                 std::make_unique<riegeli::CordWriter<absl::Cord*>>(&streamed),
+                 1)));
+  absl::Cord decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Decode(streamed, &decode_result, 1));
+  EXPECT_EQ(input, decode_result);
+
+  absl::Cord encode_result, read_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  TENSORSTORE_ASSERT_OK(riegeli::ReadAll(
+      compressor->GetReader(
+          std::make_unique<riegeli::CordReader<absl::Cord>>(encode_result), 1),
+      read_result));
+  EXPECT_EQ(input, read_result);
+}
+
+TEST(ZstdCompressorTest, DecodeCorrupt) {
+  auto compressor = Compressor::FromJson({{"id", "zstd"}}).value();
+  const absl::Cord input("The quick brown fox jumped over the lazy dog.");
+  absl::Cord encode_result, decode_result;
+  TENSORSTORE_ASSERT_OK(compressor->Encode(input, &encode_result, 1));
+  EXPECT_THAT(
+      compressor->Decode(encode_result.Subcord(0, encode_result.size() - 1),
+                         &decode_result, 1),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(compressor->Decode(absl::Cord("garbage"), &decode_result, 1),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(ZstdCompressorTest, ToJson) {
   auto compressor =
       Compressor::FromJson({{"id", "zstd"}, {"level", 5}}).value();
@@ -20,6 +20,7 @@
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -50,6 +51,7 @@
 #include "tensorstore/internal/regular_grid.h"
 #include "tensorstore/internal/storage_statistics.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -59,6 +61,7 @@
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/division.h"
 #include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/extents.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -77,7 +80,8 @@ void ZarrLeafChunkCache::Read(ZarrChunkCache::ReadRequest request,
                                               IndexTransform<>>&& receiver) {
   return internal::ChunkCache::Read(
       {static_cast<internal::DriverReadRequest&&>(request),
-       /*component_index=*/0, request.staleness_bound},
+       /*component_index=*/0, request.staleness_bound,
+       request.stale_while_revalidate},
       std::move(receiver));
 }
 
@@ -132,6 +136,10 @@ void ZarrLeafChunkCache::GetStorageStatistics(
     ZarrChunkCache::GetStorageStatisticsRequest request) {
   auto handler =
       internal::MakeIntrusivePtr<GridStorageStatisticsChunkHandlerBase>();
+  if (!request.transaction) {
+    // The summary does not reflect uncommitted writes.
+    handler->chunk_presence = chunk_presence_summary();
+  }
   GridStorageStatisticsChunkHandlerBase::Start(
       std::move(handler), *this, std::move(state), std::move(request));
 }
@@ -159,6 +167,27 @@ Result<absl::Cord> ZarrLeafChunkCache::EncodeChunk(
   return codec_state_->EncodeArray(component_arrays[0]);
 }
 
+std::optional<OptionalByteRangeRequest>
+ZarrLeafChunkCache::GetChunkRegionByteRange(span<const Index> chunk_indices,
+                                            BoxView<> region) {
+  // Reading part of a chunk is only worthwhile if most of the chunk is not
+  // needed.
+  constexpr Index kMinChunkToRegionRatio = 4;
+  if (!codec_state_->supports_region_decode()) return std::nullopt;
+  const auto chunk_shape = grid().components[0].shape();
+  if (region.num_elements() * kMinChunkToRegionRatio >
+      ProductOfExtents(chunk_shape)) {
+    return std::nullopt;
+  }
+  return codec_state_->GetEncodedByteRange(chunk_shape, region);
+}
+
+Result<SharedArray<const void>> ZarrLeafChunkCache::DecodeChunkRegion(
+    span<const Index> chunk_indices, BoxView<> region, absl::Cord data) {
+  return codec_state_->DecodeArrayRegion(grid().components[0].shape(), region,
+                                         std::move(data));
+}
+
 kvstore::Driver* ZarrLeafChunkCache::GetKvStoreDriver() {
   return this->internal::KvsBackedChunkCache::kvstore_driver();
 }
@@ -307,21 +336,23 @@ void ZarrShardedChunkCache::Read(
   ShardedReadOrWrite<internal::ReadChunk,
                      &ZarrArrayToArrayCodec::PreparedState::Read>(
       *this, std::move(request.transform), std::move(receiver),
+      // A single batch is shared by all shards, such that the shard indices of
+      // all shards intersecting the request are read concurrently.
       [transaction = std::move(request.transaction),
-       batch = std::move(request.batch),
-       staleness_bound = request.staleness_bound](auto entry) {
-        Batch shard_batch = batch;
-        if (!shard_batch) {
-          shard_batch = Batch::New();
-        }
+       shard_batch = request.batch ? std::move(request.batch) : Batch::New(),
+       io_stats = std::move(request.io_stats),
+       pin_set = std::move(request.pin_set),
+       staleness_bound = request.staleness_bound,
+       stale_while_revalidate = request.stale_while_revalidate](auto entry) {
         return
-            [=, shard_batch = std::move(shard_batch), entry = std::move(entry)](
+            [=, entry = std::move(entry)](
                 span<const Index> decoded_shape, IndexTransform<> transform,
                 AnyFlowReceiver<absl::Status, internal::ReadChunk,
                                 IndexTransform<>>&& receiver) {
               entry->sub_chunk_cache.get()->Read(
-                  {{transaction, std::move(transform), shard_batch},
-                   staleness_bound},
+                  {{transaction, std::move(transform), shard_batch, io_stats,
+                    pin_set},
+                   staleness_bound, stale_while_revalidate},
                   std::move(receiver));
             };
       });
@@ -334,7 +365,8 @@ void ZarrShardedChunkCache::Write(
   ShardedReadOrWrite<internal::WriteChunk,
                      &ZarrArrayToArrayCodec::PreparedState::Write>(
       *this, std::move(request.transform), std::move(receiver),
-      [transaction = std::move(request.transaction)](auto entry) {
+      [transaction = std::move(request.transaction),
+       io_stats = std::move(request.io_stats)](auto entry) {
         internal::OpenTransactionPtr shard_transaction = transaction;
         if (!shard_transaction) {
           shard_transaction = internal::TransactionState::MakeImplicit();
@@ -345,7 +377,8 @@ void ZarrShardedChunkCache::Write(
                    AnyFlowReceiver<absl::Status, internal::WriteChunk,
                                    IndexTransform<>>&& receiver) {
           entry->sub_chunk_cache.get()->Write(
-              {shard_transaction, std::move(transform)}, std::move(receiver));
+              {shard_transaction, std::move(transform), io_stats},
+              std::move(receiver));
         };
       });
 }
@@ -457,6 +490,7 @@ void ZarrShardedChunkCache::Entry::DoInitialize() {
   sub_chunk_cache =
       ZarrChunkCache::Ptr(zarr_chunk_cache, internal::adopt_object_ref);
   sub_chunk_cache->parent_chunk_ = this;
+  sub_chunk_cache->SetCodecAccelerator(cache.codec_accelerator_);
 }
 
 kvstore::Driver* ZarrShardedChunkCache::GetKvStoreDriver() {
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -28,6 +29,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/read_request.h"
 #include "tensorstore/driver/write_request.h"
@@ -38,9 +40,11 @@
 #include "tensorstore/internal/cache/chunk_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/transaction.h"
@@ -68,6 +72,7 @@ class ZarrChunkCache {
 
   struct ReadRequest : internal::DriverReadRequest {
     absl::Time staleness_bound;
+    absl::Duration stale_while_revalidate = absl::ZeroDuration();
   };
 
   virtual void Read(ReadRequest request,
@@ -97,6 +102,13 @@ class ZarrChunkCache {
 
   virtual kvstore::Driver* GetKvStoreDriver() = 0;
 
+  /// Specifies the accelerator with which chunks, including the sub-chunks of
+  /// shards, are encoded and decoded.
+  ///
+  /// See `internal::KvsBackedChunkCache::SetCodecAccelerator`.
+  virtual void SetCodecAccelerator(
+      std::shared_ptr<internal::CodecAccelerator> accelerator) = 0;
+
   virtual ~ZarrChunkCache();
 
   // If this is a nested chunk cache corresponding to a shard, points to parent
@@ -169,8 +181,20 @@ class ZarrLeafChunkCache : public internal::KvsBackedChunkCache,
       span<const Index> chunk_indices,
       span<const SharedArray<const void>> component_arrays) override;
 
+  std::optional<OptionalByteRangeRequest> GetChunkRegionByteRange(
+      span<const Index> chunk_indices, BoxView<> region) override;
+
+  Result<SharedArray<const void>> DecodeChunkRegion(
+      span<const Index> chunk_indices, BoxView<> region,
+      absl::Cord data) override;
+
   kvstore::Driver* GetKvStoreDriver() override;
 
+  void SetCodecAccelerator(
+      std::shared_ptr<internal::CodecAccelerator> accelerator) override {
+    Base::SetCodecAccelerator(std::move(accelerator));
+  }
+
   ZarrCodecChain::PreparedState::Ptr codec_state_;
 };
 
@@ -227,12 +251,25 @@ class ZarrShardedChunkCache : public internal::Cache, public ZarrChunkCache {
 
   kvstore::Driver* GetKvStoreDriver() override;
 
+  /// Applies `accelerator` to the sub-chunk caches of shards subsequently
+  /// opened.
+  void SetCodecAccelerator(
+      std::shared_ptr<internal::CodecAccelerator> accelerator) override {
+    codec_accelerator_ = std::move(accelerator);
+  }
+
   kvstore::DriverPtr base_kvstore_;
   ZarrCodecChain::PreparedState::Ptr codec_state_;
+  std::shared_ptr<internal::CodecAccelerator> codec_accelerator_;
 };
 
 /// Chunk cache mixin for a chunk cache where the entire chunk cache corresponds
 /// to a single shard.
+///
+/// Each sub-chunk is a separate cache entry that is decoded and encoded on
+/// `executor`, which is the ``data_copy_concurrency`` executor of the parent
+/// cache.  Sub-chunks of a single shard are therefore processed concurrently,
+/// e.g. when the entire shard is read or written at once.
 template <typename ChunkCacheImpl>
 class ZarrShardSubChunkCache : public ChunkCacheImpl {
  public:
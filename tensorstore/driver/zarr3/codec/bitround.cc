@@ -0,0 +1,169 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/bitround.h"
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/filter.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+// Rounds the `maskbits` low bits of the mantissa of each element, with ties
+// rounded to even, as done by the numcodecs `BitRound` codec.
+template <typename T>
+void Bitround(const T* src, T* dest, Index n, int maskbits) {
+  const T mask = static_cast<T>(~T(0) << maskbits);
+  const T half_quantum1 = static_cast<T>((T(1) << (maskbits - 1)) - 1);
+  for (Index i = 0; i < n; ++i) {
+    const T b = src[i];
+    dest[i] = static_cast<T>((b + ((b >> maskbits) & 1) + half_quantum1) &
+                             mask);
+  }
+}
+
+int GetMantissaBits(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::float32_t:
+      return 23;
+    case DataTypeId::float64_t:
+      return 52;
+    default:
+      return -1;
+  }
+}
+
+class BitroundCodec : public ZarrArrayFilterCodec {
+ public:
+  explicit BitroundCodec(int maskbits) : maskbits_(maskbits) {}
+
+  class State : public ZarrArrayFilterCodec::PreparedState {
+   public:
+    Result<SharedArray<const void>> EncodeArray(
+        SharedArrayView<const void> decoded) const final {
+      const int maskbits = codec_->maskbits_;
+      if (maskbits == 0) return SharedArray<const void>(std::move(decoded));
+      auto src = MakeContiguousArray(std::move(decoded));
+      auto dest =
+          AllocateArray(src.shape(), c_order, default_init, src.dtype());
+      if (src.dtype().size() == 4) {
+        Bitround(static_cast<const uint32_t*>(src.data()),
+                 static_cast<uint32_t*>(dest.data()), src.num_elements(),
+                 maskbits);
+      } else {
+        Bitround(static_cast<const uint64_t*>(src.data()),
+                 static_cast<uint64_t*>(dest.data()), src.num_elements(),
+                 maskbits);
+      }
+      return dest;
+    }
+
+    Result<SharedArray<const void>> DecodeArray(
+        SharedArrayView<const void> encoded,
+        span<const Index> decoded_shape) const final {
+      return SharedArray<const void>(std::move(encoded));
+    }
+
+    const BitroundCodec* codec_;
+  };
+
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
+    state->shape_.assign(decoded_shape.begin(), decoded_shape.end());
+    return state;
+  }
+
+ private:
+  int maskbits_;
+};
+
+}  // namespace
+
+absl::Status BitroundCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                          bool strict) {
+  using Self = BitroundCodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  return MergeConstraint<&Options::keepbits>("keepbits", options,
+                                             other_options);
+}
+
+ZarrCodecSpec::Ptr BitroundCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<BitroundCodecSpec>(*this);
+}
+
+DataType BitroundCodecSpec::GetEncodedDataType(DataType dtype) const {
+  return dtype;
+}
+
+Result<ZarrArrayToArrayCodec::Ptr> BitroundCodecSpec::Resolve(
+    ArrayCodecResolveParameters&& decoded, ArrayCodecResolveParameters& encoded,
+    ZarrArrayToArrayCodecSpec::Ptr* resolved_spec) const {
+  const int mantissa_bits = GetMantissaBits(decoded.dtype);
+  if (mantissa_bits == -1) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Bitround codec requires a float32 or float64 data type, but "
+        "received: ",
+        decoded.dtype));
+  }
+  if (!options.keepbits) {
+    return absl::InvalidArgumentError("\"keepbits\" must be specified");
+  }
+  if (*options.keepbits > mantissa_bits) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "\"keepbits\" must be at most ", mantissa_bits, " for data type ",
+        decoded.dtype, ", but received: ", *options.keepbits));
+  }
+  PropagateResolveParameters(decoded, encoded);
+  encoded.dtype = decoded.dtype;
+  encoded.fill_value = std::move(decoded.fill_value);
+  if (resolved_spec) {
+    resolved_spec->reset(this);
+  }
+  return internal::MakeIntrusivePtr<BitroundCodec>(mantissa_bits -
+                                                   *options.keepbits);
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = BitroundCodecSpec;
+  using Options = Self::Options;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>(
+      "bitround",
+      jb::Projection<&Self::options>(jb::Sequence(jb::Member(
+          "keepbits", jb::Projection<&Options::keepbits>(
+                          OptionalIfConstraintsBinder(jb::Integer<int>(0)))))));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
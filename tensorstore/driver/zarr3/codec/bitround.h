@@ -0,0 +1,57 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_BITROUND_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_BITROUND_H_
+
+#include <optional>
+
+#include "absl/status/status.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/filter.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+// Lossy filter codec that rounds the mantissa of floating-point elements to
+// `keepbits` bits, so that the remaining bits are zero and compress well.
+// Decoding is the identity.
+class BitroundCodecSpec : public ZarrArrayFilterCodecSpec {
+ public:
+  struct Options {
+    std::optional<int> keepbits;
+  };
+  BitroundCodecSpec() = default;
+  explicit BitroundCodecSpec(const Options& options) : options(options) {}
+
+  absl::Status MergeFrom(const ZarrCodecSpec& other, bool strict) override;
+  ZarrCodecSpec::Ptr Clone() const override;
+
+  DataType GetEncodedDataType(DataType dtype) const override;
+
+  Result<ZarrArrayToArrayCodec::Ptr> Resolve(
+      ArrayCodecResolveParameters&& decoded,
+      ArrayCodecResolveParameters& encoded,
+      ZarrArrayToArrayCodecSpec::Ptr* resolved_spec) const override;
+
+  Options options;
+};
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_BITROUND_H_
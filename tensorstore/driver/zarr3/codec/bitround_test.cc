@@ -0,0 +1,129 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+Result<SharedArray<const void>> EncodeDecode(::nlohmann::json json_spec,
+                                             SharedArray<const void> array) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto spec,
+                               ZarrCodecChainSpec::FromJson(json_spec));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.dtype = array.dtype();
+  decoded_params.rank = array.rank();
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto chain, spec.Resolve(std::move(decoded_params), encoded_params));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto state, chain->Prepare(array.shape()));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto encoded, state->EncodeArray(array));
+  return state->DecodeArray(array.shape(), std::move(encoded));
+}
+
+::nlohmann::json BitroundSpec(int keepbits) {
+  return {{{"name", "bitround"}, {"configuration", {{"keepbits", keepbits}}}}};
+}
+
+TEST(BitroundTest, Basic) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = BitroundSpec(10);
+  p.resolve_params.dtype = dtype_v<float>;
+  p.expected_spec = {
+      {{"name", "bitround"}, {"configuration", {{"keepbits", 10}}}},
+      GetDefaultBytesCodecJson(),
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BitroundTest, Float32) {
+  EXPECT_THAT(
+      EncodeDecode(BitroundSpec(2),
+                   tensorstore::MakeArray<float>({1.0f, 1.1f, 1.2f, 1.375f,
+                                                  -1.9f, 7.0f, 7.9f, 0.0f})),
+      ::testing::Optional(tensorstore::MakeArray<float>(
+          {1.0f, 1.0f, 1.25f, 1.5f, -2.0f, 7.0f, 8.0f, 0.0f})));
+}
+
+TEST(BitroundTest, Float64) {
+  EXPECT_THAT(EncodeDecode(BitroundSpec(1), tensorstore::MakeArray<double>(
+                                                {1.25, 1.75, 2.6, -0.3})),
+              ::testing::Optional(
+                  tensorstore::MakeArray<double>({1.0, 2.0, 3.0, -0.25})));
+}
+
+TEST(BitroundTest, KeepAllBits) {
+  auto array = tensorstore::MakeArray<float>({1.1f, 2.2f, 3.3f});
+  EXPECT_THAT(EncodeDecode(BitroundSpec(23), array),
+              ::testing::Optional(array));
+}
+
+TEST(BitroundTest, InvalidDataType) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<int32_t>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve(BitroundSpec(10), p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Bitround codec requires a float32 or float64 .*"));
+}
+
+TEST(BitroundTest, InvalidKeepbits) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve(BitroundSpec(24), p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "\"keepbits\" must be at most 23 .*"));
+  EXPECT_THAT(
+      ZarrCodecChainSpec::FromJson(
+          {{{"name", "bitround"}, {"configuration", {{"keepbits", -1}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BitroundTest, MissingKeepbits) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve({"bitround"}, p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "\"keepbits\" must be specified"));
+}
+
+}  // namespace
@@ -0,0 +1,241 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/bitshuffle.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "riegeli/base/chain.h"
+#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/write.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace internal_bitshuffle {
+namespace {
+
+// Transposes the 8x8 bit matrix in which row `r` is byte `r` of `x` and
+// column `c` is bit `c`, using 3 rounds of swaps of increasingly large blocks
+// on the full 64-bit word.
+inline uint64_t TransposeBits8x8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+  x ^= t ^ (t << 28);
+  return x;
+}
+
+}  // namespace
+
+void Bitshuffle(const char* input, char* output, size_t size,
+                size_t element_size) {
+  const size_t num_elements = size / element_size;
+  const size_t num_groups = num_elements / 8;
+  const size_t shuffled_size = num_groups * 8 * element_size;
+  for (size_t b = 0; b < element_size; ++b) {
+    char* rows = output + b * 8 * num_groups;
+    for (size_t k = 0; k < num_groups; ++k) {
+      const unsigned char* group = reinterpret_cast<const unsigned char*>(
+          input + (8 * k) * element_size + b);
+      uint64_t x = 0;
+      for (size_t i = 0; i < 8; ++i) {
+        x |= static_cast<uint64_t>(group[i * element_size]) << (8 * i);
+      }
+      x = TransposeBits8x8(x);
+      for (size_t j = 0; j < 8; ++j) {
+        rows[j * num_groups + k] = static_cast<char>(x >> (8 * j));
+      }
+    }
+  }
+  std::memcpy(output + shuffled_size, input + shuffled_size,
+              size - shuffled_size);
+}
+
+void Bitunshuffle(const char* input, char* output, size_t size,
+                  size_t element_size) {
+  const size_t num_elements = size / element_size;
+  const size_t num_groups = num_elements / 8;
+  const size_t shuffled_size = num_groups * 8 * element_size;
+  for (size_t b = 0; b < element_size; ++b) {
+    const unsigned char* rows =
+        reinterpret_cast<const unsigned char*>(input + b * 8 * num_groups);
+    for (size_t k = 0; k < num_groups; ++k) {
+      uint64_t x = 0;
+      for (size_t j = 0; j < 8; ++j) {
+        x |= static_cast<uint64_t>(rows[j * num_groups + k]) << (8 * j);
+      }
+      x = TransposeBits8x8(x);
+      char* group = output + (8 * k) * element_size + b;
+      for (size_t i = 0; i < 8; ++i) {
+        group[i * element_size] = static_cast<char>(x >> (8 * i));
+      }
+    }
+  }
+  std::memcpy(output + shuffled_size, input + shuffled_size,
+              size - shuffled_size);
+}
+
+}  // namespace internal_bitshuffle
+
+namespace {
+
+// Buffers writes to a `Cord`, and then in `Done`, bit-shuffles the result and
+// forwards it to another `Writer`.
+class BitshuffleDeferredWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  explicit BitshuffleDeferredWriter(size_t element_size,
+                                    riegeli::Writer& base_writer)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        element_size_(element_size),
+        base_writer_(base_writer) {}
+
+  void Done() override {
+    CordWriter::Done();
+    absl::string_view input = dest().Flatten();
+    std::string output(input.size(), '\0');
+    internal_bitshuffle::Bitshuffle(input.data(), output.data(), input.size(),
+                                    element_size_);
+    auto status = riegeli::Write(std::move(output), base_writer_);
+    if (!status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+  }
+
+ private:
+  size_t element_size_;
+  riegeli::Writer& base_writer_;
+};
+
+class BitshuffleCodec : public ZarrBytesToBytesCodec {
+ public:
+  explicit BitshuffleCodec(size_t element_size)
+      : element_size_(element_size) {}
+
+  class State : public ZarrBytesToBytesCodec::PreparedState {
+   public:
+    Result<std::unique_ptr<riegeli::Writer>> GetEncodeWriter(
+        riegeli::Writer& encoded_writer) const final {
+      return std::make_unique<BitshuffleDeferredWriter>(codec_->element_size_,
+                                                        encoded_writer);
+    }
+
+    Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
+        riegeli::Reader& encoded_reader) const final {
+      const size_t element_size = codec_->element_size_;
+      auto output = riegeli::ReadAll(
+          encoded_reader,
+          [&](absl::string_view input) -> absl::StatusOr<std::string> {
+            std::string output(input.size(), '\0');
+            internal_bitshuffle::Bitunshuffle(input.data(), output.data(),
+                                              input.size(), element_size);
+            return output;
+          });
+      auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
+          output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+      if (!output.ok()) {
+        reader->Fail(std::move(output).status());
+      }
+      return reader;
+    }
+
+    const BitshuffleCodec* codec_;
+  };
+
+  Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
+    return state;
+  }
+
+ private:
+  size_t element_size_;
+};
+
+}  // namespace
+
+absl::Status BitshuffleCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                            bool strict) {
+  using Self = BitshuffleCodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  return MergeConstraint<&Options::elementsize>("elementsize", options,
+                                                other_options);
+}
+
+ZarrCodecSpec::Ptr BitshuffleCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<BitshuffleCodecSpec>(*this);
+}
+
+Result<ZarrBytesToBytesCodec::Ptr> BitshuffleCodecSpec::Resolve(
+    BytesCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const {
+  int element_size;
+  if (options.elementsize) {
+    element_size = *options.elementsize;
+  } else if (decoded.item_bits > 0 && decoded.item_bits % 8 == 0) {
+    element_size = static_cast<int>(decoded.item_bits / 8);
+  } else {
+    element_size = 1;
+  }
+  if (resolved_spec) {
+    if (options.elementsize) {
+      resolved_spec->reset(this);
+    } else {
+      resolved_spec->reset(new BitshuffleCodecSpec(Options{element_size}));
+    }
+  }
+  return internal::MakeIntrusivePtr<BitshuffleCodec>(element_size);
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = BitshuffleCodecSpec;
+  using Options = Self::Options;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>(
+      "bitshuffle",
+      jb::Projection<&Self::options>(jb::Sequence(
+          jb::Member("elementsize",
+                     jb::Projection<&Options::elementsize>(
+                         OptionalIfConstraintsBinder(jb::Integer<int>(1)))))));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
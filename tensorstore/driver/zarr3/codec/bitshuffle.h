@@ -0,0 +1,66 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_BITSHUFFLE_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_BITSHUFFLE_H_
+
+#include <optional>
+
+#include "absl/status/status.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+class BitshuffleCodecSpec : public ZarrBytesToBytesCodecSpec {
+ public:
+  struct Options {
+    std::optional<int> elementsize;
+  };
+  BitshuffleCodecSpec() = default;
+  explicit BitshuffleCodecSpec(const Options& options) : options(options) {}
+  absl::Status MergeFrom(const ZarrCodecSpec& other, bool strict) override;
+  ZarrCodecSpec::Ptr Clone() const override;
+  Result<ZarrBytesToBytesCodec::Ptr> Resolve(
+      BytesCodecResolveParameters&& decoded,
+      BytesCodecResolveParameters& encoded,
+      ZarrBytesToBytesCodecSpec::Ptr* resolved_spec) const final;
+
+  Options options;
+};
+
+namespace internal_bitshuffle {
+
+// Bit-transposes the `input.size() / element_size` elements of `input`.
+//
+// The encoded representation consists of `8 * element_size` rows, one for each
+// bit of each byte of an element, of `n / 8` bytes each, where `n` is the
+// number of elements rounded down to a multiple of 8.  Bit `i` of byte `k` of
+// the row for bit `j` of byte `b` is equal to bit `j` of byte `b` of element
+// `8 * k + i`.  The bytes of any remaining elements, and any remaining bytes
+// that do not form a complete element, are copied unchanged.
+void Bitshuffle(const char* input, char* output, size_t size,
+                size_t element_size);
+
+// Inverse of `Bitshuffle`.
+void Bitunshuffle(const char* input, char* output, size_t size,
+                  size_t element_size);
+
+}  // namespace internal_bitshuffle
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_BITSHUFFLE_H_
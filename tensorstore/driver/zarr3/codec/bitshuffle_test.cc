@@ -0,0 +1,123 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/bitshuffle.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+using ::tensorstore::internal_zarr3::internal_bitshuffle::Bitshuffle;
+using ::tensorstore::internal_zarr3::internal_bitshuffle::Bitunshuffle;
+
+TEST(BitshuffleTest, ElementSizeInferred) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {"bitshuffle"};
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "bitshuffle"}, {"configuration", {{"elementsize", 2}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BitshuffleTest, ElementSizeExplicit) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "bitshuffle"}, {"configuration", {{"elementsize", 4}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "bitshuffle"}, {"configuration", {{"elementsize", 4}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(BitshuffleTest, InvalidElementSize) {
+  EXPECT_THAT(
+      ZarrCodecChainSpec::FromJson(
+          {{{"name", "bitshuffle"}, {"configuration", {{"elementsize", 0}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BitshuffleTest, Layout) {
+  // 8 elements of 2 bytes: only byte 0 of element 1 and byte 1 of element 7
+  // are non-zero.
+  std::string input(16, '\0');
+  input[2] = '\x05';   // bits 0 and 2 of byte 0 of element 1
+  input[15] = '\x80';  // bit 7 of byte 1 of element 7
+  std::string output(16, '\0');
+  Bitshuffle(input.data(), output.data(), input.size(), 2);
+  std::string expected(16, '\0');
+  expected[0] = '\x02';   // row for bit 0 of byte 0, element 1
+  expected[2] = '\x02';   // row for bit 2 of byte 0, element 1
+  expected[15] = '\x80';  // row for bit 7 of byte 1, element 7
+  EXPECT_EQ(expected, output);
+  std::string decoded(16, '\0');
+  Bitunshuffle(output.data(), decoded.data(), output.size(), 2);
+  EXPECT_EQ(input, decoded);
+}
+
+TEST(BitshuffleTest, Remainder) {
+  // 10 elements of 3 bytes, plus 1 byte: the last 2 elements and the last byte
+  // are copied unchanged.
+  std::string input;
+  for (int i = 0; i < 31; ++i) input += static_cast<char>(i * 37);
+  std::string output(input.size(), '\0');
+  Bitshuffle(input.data(), output.data(), input.size(), 3);
+  EXPECT_EQ(input.substr(24), output.substr(24));
+  std::string decoded(input.size(), '\0');
+  Bitunshuffle(output.data(), decoded.data(), output.size(), 3);
+  EXPECT_EQ(input, decoded);
+}
+
+TEST(BitshuffleTest, RoundTrip) {
+  for (auto dtype : {tensorstore::DataType(dtype_v<uint8_t>),
+                     tensorstore::DataType(dtype_v<uint16_t>),
+                     tensorstore::DataType(dtype_v<float>),
+                     tensorstore::DataType(dtype_v<uint64_t>)}) {
+    SCOPED_TRACE(tensorstore::StrCat("dtype=", dtype));
+    CodecRoundTripTestParams p;
+    p.spec = {"bitshuffle"};
+    p.dtype = dtype;
+    p.shape = {3, 5, 7};
+    TestCodecRoundTrip(p);
+  }
+}
+
+TEST(BitshuffleTest, RoundTripWithCompression) {
+  CodecRoundTripTestParams p;
+  p.spec = {"delta", "bitshuffle", "zstd"};
+  TestCodecRoundTrip(p);
+}
+
+}  // namespace
@@ -21,6 +21,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/status/status.h"
@@ -46,6 +47,7 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -112,6 +114,13 @@ class BloscCodec : public ZarrBytesToBytesCodec {
       return reader;
     }
 
+    bool supports_decode_range() const final { return true; }
+
+    absl::Status DecodeRange(std::string_view encoded, int64_t offset,
+                             span<char> output) const final {
+      return blosc::DecodeRange(encoded, offset, output);
+    }
+
     const BloscCodec* codec_;
   };
 
@@ -17,6 +17,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
@@ -25,13 +26,16 @@
 
 namespace {
 
+using ::tensorstore::Box;
 using ::tensorstore::dtype_v;
 using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr3::CodecRegionDecodeTestParams;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::TestCodecMerge;
+using ::tensorstore::internal_zarr3::TestCodecRegionDecode;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
 using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
@@ -99,6 +103,18 @@ TEST(BloscTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+TEST(BloscTest, RegionDecode) {
+  CodecRegionDecodeTestParams p;
+  p.spec = {"bytes",
+            {{"name", "blosc"}, {"configuration", {{"blocksize", 256}}}}};
+  for (const auto& region :
+       {Box<>({0, 0, 0}, {1, 1, 1}), Box<>({3, 5, 7}, {2, 3, 4}),
+        Box<>({29, 0, 0}, {1, 40, 50})}) {
+    p.region = region;
+    TestCodecRegionDecode(p);
+  }
+}
+
 TEST(BloscTest, MergeCnameMismatch) {
   EXPECT_THAT(
       TestCodecMerge({{{"name", "blosc"},
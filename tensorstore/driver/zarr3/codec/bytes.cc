@@ -179,6 +179,8 @@ class BytesCodecPreparedState : public ZarrArrayToBytesCodec::PreparedState {
  public:
   int64_t encoded_size() const final { return encoded_size_; }
 
+  int64_t encoded_element_size() const final { return dtype_.size(); }
+
   absl::Status EncodeArray(SharedArrayView<const void> decoded,
                            riegeli::Writer& writer) const final {
     if (internal::EncodeArrayEndian(std::move(decoded), endianness_, c_order,
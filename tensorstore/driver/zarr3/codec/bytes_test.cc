@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include <nlohmann/json.hpp>
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
@@ -27,13 +28,16 @@
 
 namespace {
 
+using ::tensorstore::Box;
 using ::tensorstore::dtype_v;
 using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRegionDecodeTestParams;
 using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
 using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecRegionDecode;
 using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
 using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
 using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
@@ -61,6 +65,19 @@ TEST(BytesTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+TEST(BytesTest, RegionDecode) {
+  CodecRegionDecodeTestParams p;
+  for (const char* endian : {"little", "big"}) {
+    p.spec = {{{"name", "bytes"}, {"configuration", {{"endian", endian}}}}};
+    for (const auto& region :
+         {Box<>({0, 0, 0}, {1, 1, 1}), Box<>({3, 5, 7}, {2, 3, 4}),
+          Box<>({29, 0, 0}, {1, 40, 50})}) {
+      p.region = region;
+      TestCodecRegionDecode(p);
+    }
+  }
+}
+
 TEST(BytesTest, AutomaticTranspose) {
   ArrayCodecResolveParameters p;
   p.dtype = dtype_v<uint16_t>;
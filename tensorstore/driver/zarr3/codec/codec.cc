@@ -17,21 +17,33 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <cassert>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/driver/codec_metrics.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/tracing/stage.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/rank.h"
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal_zarr3 {
@@ -48,14 +60,30 @@ int64_t ZarrArrayToBytesCodec::PreparedState::encoded_size() const {
   return -1;
 }
 
+int64_t ZarrArrayToBytesCodec::PreparedState::encoded_element_size() const {
+  return -1;
+}
+
 int64_t ZarrBytesToBytesCodec::PreparedState::encoded_size() const {
   return -1;
 }
 
+bool ZarrBytesToBytesCodec::PreparedState::supports_decode_range() const {
+  return false;
+}
+
+absl::Status ZarrBytesToBytesCodec::PreparedState::DecodeRange(
+    std::string_view encoded, int64_t offset, span<char> output) const {
+  return absl::UnimplementedError("Range decoding not supported");
+}
+
 bool ZarrShardingCodec::is_sharding_codec() const { return true; }
 
 absl::Status ZarrCodecChain::PreparedState::EncodeArray(
     SharedArrayView<const void> decoded, riegeli::Writer& writer) const {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kEncode);
+  const absl::Time start_time = absl::Now();
+  const size_t decoded_bytes = decoded.num_elements() * decoded.dtype().size();
   StridedLayout<> encoded_layout_storage;
   // Compute the transformed array.
   for (const auto& codec : array_to_array) {
@@ -98,11 +126,15 @@ absl::Status ZarrCodecChain::PreparedState::EncodeArray(
   if (!writer.Close()) {
     return writer.status();
   }
+  internal::RecordCodecEncodeMetric("zarr3", decoded_bytes,
+                                    absl::Now() - start_time);
   return absl::OkStatus();
 }
 
 Result<SharedArray<const void>> ZarrCodecChain::PreparedState::DecodeArray(
     span<const Index> decoded_shape, riegeli::Reader& reader) const {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
+  const absl::Time start_time = absl::Now();
   constexpr size_t kNumInlineCodecs = 8;
   // Compose the bytes -> bytes readers.
   absl::InlinedVector<std::unique_ptr<riegeli::Reader>, kNumInlineCodecs>
@@ -145,6 +177,94 @@ Result<SharedArray<const void>> ZarrCodecChain::PreparedState::DecodeArray(
             std::move(array),
             i == 0 ? decoded_shape : array_to_array[i - 1]->encoded_shape()));
   }
+  internal::RecordCodecDecodeMetric(
+      "zarr3", array.num_elements() * array.dtype().size(),
+      absl::Now() - start_time);
+  return array;
+}
+
+namespace {
+// Returns the range `[begin, end)` of C-order element positions, within an
+// array of shape `shape`, that spans all positions in `region`.
+std::pair<int64_t, int64_t> GetSpanningElementRange(span<const Index> shape,
+                                                    BoxView<> region) {
+  int64_t begin = 0, last = 0;
+  for (DimensionIndex i = 0; i < shape.size(); ++i) {
+    begin = begin * shape[i] + region.origin()[i];
+    last = last * shape[i] + region.origin()[i] + region.shape()[i] - 1;
+  }
+  return {begin, last + 1};
+}
+}  // namespace
+
+bool ZarrCodecChain::PreparedState::supports_region_decode() const {
+  return array_to_array.empty() &&
+         array_to_bytes->encoded_element_size() > 0 &&
+         (bytes_to_bytes.empty() ||
+          (bytes_to_bytes.size() == 1 &&
+           bytes_to_bytes[0]->supports_decode_range()));
+}
+
+OptionalByteRangeRequest ZarrCodecChain::PreparedState::GetEncodedByteRange(
+    span<const Index> decoded_shape, BoxView<> region) const {
+  assert(supports_region_decode());
+  if (!bytes_to_bytes.empty()) return {};
+  const int64_t element_size = array_to_bytes->encoded_element_size();
+  auto [begin, end] = GetSpanningElementRange(decoded_shape, region);
+  return OptionalByteRangeRequest::Range(begin * element_size,
+                                         end * element_size);
+}
+
+Result<SharedArray<const void>>
+ZarrCodecChain::PreparedState::DecodeArrayRegion(
+    span<const Index> decoded_shape, BoxView<> region,
+    absl::Cord encoded) const {
+  assert(supports_region_decode());
+  assert(region.rank() == decoded_shape.size());
+  internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
+  const absl::Time start_time = absl::Now();
+  const int64_t element_size = array_to_bytes->encoded_element_size();
+  auto [begin, end] = GetSpanningElementRange(decoded_shape, region);
+  const Index num_spanning_elements = end - begin;
+
+  // Obtain the encoded representation of the spanning elements.
+  absl::Cord spanning;
+  if (bytes_to_bytes.empty()) {
+    spanning = std::move(encoded);
+  } else {
+    std::string decoded(num_spanning_elements * element_size, '\0');
+    TENSORSTORE_RETURN_IF_ERROR(bytes_to_bytes[0]->DecodeRange(
+        encoded.Flatten(), begin * element_size,
+        span<char>(decoded.data(), decoded.size())));
+    spanning = absl::Cord(std::move(decoded));
+  }
+  if (spanning.size() != num_spanning_elements * element_size) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Expected ", num_spanning_elements * element_size,
+                            " encoded bytes but received ", spanning.size()));
+  }
+  riegeli::CordReader reader{&spanning};
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto elements,
+      array_to_bytes->DecodeArray(span<const Index>(&num_spanning_elements, 1),
+                                  reader));
+
+  // Select the elements of `region`, which are strided within the spanning
+  // range according to the C-order layout of the full array.
+  DimensionIndex rank = decoded_shape.size();
+  Index byte_strides[kMaxRank];
+  Index stride = elements.dtype().size();
+  for (DimensionIndex i = rank; i--;) {
+    byte_strides[i] = stride;
+    stride *= decoded_shape[i];
+  }
+  ArrayView<const void> region_view(
+      ElementPointer<const void>(elements.data(), elements.dtype()),
+      StridedLayoutView<>(rank, region.shape().data(), byte_strides));
+  auto array = tensorstore::MakeCopy(region_view, c_order);
+  internal::RecordCodecDecodeMetric(
+      "zarr3", array.num_elements() * array.dtype().size(),
+      absl::Now() - start_time);
   return array;
 }
 
@@ -47,6 +47,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -54,6 +55,7 @@
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_transform.h"
@@ -62,6 +64,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/executor.h"
@@ -164,6 +167,11 @@ class ZarrArrayToArrayCodec
 
   virtual ~ZarrArrayToArrayCodec();
 
+  // Indicates if the `Read`, `Write`, and `GetStorageStatistics` methods of
+  // the prepared state are supported, as required if this codec is followed
+  // by a sharding codec.
+  virtual bool supports_partial_io() const { return true; }
+
   // Returns a prepared state that may be used to decode arrays of the specified
   // shape.
   virtual Result<PreparedState::Ptr> Prepare(
@@ -187,6 +195,16 @@ class ZarrArrayToBytesCodec
     // The default implementation returns `-1`.
     virtual int64_t encoded_size() const;
 
+    // Returns the size in bytes of each encoded element if the encoded
+    // representation is the sequence of elements in C order, each occupying a
+    // fixed number of bytes, or `-1` otherwise.
+    //
+    // In that case, any C-order range of elements may be decoded by passing
+    // just the corresponding bytes to `DecodeArray`.
+    //
+    // The default implementation returns `-1`.
+    virtual int64_t encoded_element_size() const;
+
     // Encodes a complete array.
     //
     // This is not called for sharding codecs.
@@ -249,6 +267,20 @@ class ZarrBytesToBytesCodec
     virtual Result<std::unique_ptr<riegeli::Reader>> GetDecodeReader(
         riegeli::Reader& encoded_reader) const = 0;
 
+    // Indicates if `DecodeRange` is supported.
+    //
+    // The default implementation returns `false`.
+    virtual bool supports_decode_range() const;
+
+    // Decodes bytes `[offset, offset + output.size())` of the decoded
+    // representation from the complete encoded representation, without
+    // necessarily decoding the remainder.
+    //
+    // The default implementation returns an `absl::StatusCode::kUnimplemented`
+    // error.
+    virtual absl::Status DecodeRange(std::string_view encoded, int64_t offset,
+                                     span<char> output) const;
+
     virtual ~PreparedState();
   };
 
@@ -295,6 +327,35 @@ class ZarrCodecChain : public internal::AtomicReferenceCount<ZarrCodecChain> {
     Result<SharedArray<const void>> DecodeArray(
         span<const Index> decoded_shape, riegeli::Reader& reader) const final;
 
+    // Indicates if `DecodeArrayRegion` is supported, which requires that there
+    // are no "array -> array" codecs, that the "array -> bytes" codec encodes
+    // elements in C order with a fixed size, and that there is at most one
+    // "bytes -> bytes" codec, which supports `DecodeRange`.
+    bool supports_region_decode() const;
+
+    // Returns the byte range of the encoded representation required by
+    // `DecodeArrayRegion` to decode `region`.
+    //
+    // If there are no "bytes -> bytes" codecs, this is the range of encoded
+    // elements spanning `region`; otherwise, it is the full range.
+    //
+    // \pre `supports_region_decode()`
+    // \pre `region` is a non-empty subregion of `[0, decoded_shape)`.
+    OptionalByteRangeRequest GetEncodedByteRange(
+        span<const Index> decoded_shape, BoxView<> region) const;
+
+    // Decodes `region` of an array with the specified shape, given the
+    // byte range of the encoded representation specified by
+    // `GetEncodedByteRange`.
+    //
+    // Returns a zero-origin array with a shape of `region.shape()`.
+    //
+    // \pre `supports_region_decode()`
+    // \pre `region` is a non-empty subregion of `[0, decoded_shape)`.
+    Result<SharedArray<const void>> DecodeArrayRegion(
+        span<const Index> decoded_shape, BoxView<> region,
+        absl::Cord encoded) const;
+
     std::vector<ZarrArrayToArrayCodec::PreparedState::Ptr> array_to_array;
     ZarrArrayToBytesCodec::PreparedState::Ptr array_to_bytes;
     std::vector<ZarrBytesToBytesCodec::PreparedState::Ptr> bytes_to_bytes;
@@ -309,6 +309,20 @@ ZarrCodecChainSpec::Resolve(ArrayCodecResolveParameters&& decoded,
           resolved_spec ? &resolved_spec->array_to_bytes : nullptr),
       CodecResolveError(*array_to_bytes, "resolving codec spec", _));
 
+  if (chain->array_to_bytes->is_sharding_codec()) {
+    for (size_t i = 0; i < array_to_array.size(); ++i) {
+      if (chain->array_to_array[i]->supports_partial_io()) continue;
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Array -> array codec %s is not compatible with subsequent sharding "
+          "codec %s.  Instead, it may be specified as an inner codec that "
+          "applies to each sub-chunk individually.",
+          jb::ToJson(array_to_array[i], ZarrCodecJsonBinder).value().dump(),
+          jb::ToJson(array_to_bytes_codec_ptr, ZarrCodecJsonBinder)
+              .value()
+              .dump()));
+    }
+  }
+
   if (chain->array_to_bytes->is_sharding_codec() && !bytes_to_bytes.empty()) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Sharding codec %s is not compatible with subsequent bytes -> "
@@ -22,13 +22,17 @@
 #include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
 #include "tensorstore/array_testutil.h"
+#include "tensorstore/box.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/data_type_random_generator.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/util/endian.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -117,6 +121,42 @@ void TestCodecRoundTrip(const CodecRoundTripTestParams& params) {
       << "data=" << data;
 }
 
+void TestCodecRegionDecode(const CodecRegionDecodeTestParams& params) {
+  ZarrCodecChainSpec::FromJsonOptions from_json_options{/*.constraints=*/true};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain_spec,
+      ZarrCodecChainSpec::FromJson(params.spec, from_json_options));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.rank = params.shape.size();
+  decoded_params.dtype = params.dtype;
+  decoded_params.fill_value = AllocateArray(span<const Index>{}, c_order,
+                                            value_init, decoded_params.dtype);
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto codec_chain,
+      codec_chain_spec.Resolve(std::move(decoded_params), encoded_params));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto prepared_state,
+                                   codec_chain->Prepare(params.shape));
+  ASSERT_TRUE(prepared_state->supports_region_decode());
+  absl::BitGen gen;
+  auto data =
+      internal::MakeRandomArray(gen, params.shape, params.dtype, c_order);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   prepared_state->EncodeArray(data));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto byte_range,
+      prepared_state->GetEncodedByteRange(params.shape, params.region)
+          .Validate(encoded.size()));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto expected,
+      data | AllDims().TranslateBoxSlice(params.region) | Materialize());
+  EXPECT_THAT(prepared_state->DecodeArrayRegion(
+                  params.shape, params.region,
+                  internal::GetSubCord(encoded, byte_range)),
+              ::testing::Optional(expected))
+      << "region=" << params.region;
+}
+
 Result<::nlohmann::json> TestCodecMerge(::nlohmann::json a, ::nlohmann::json b,
                                         bool strict) {
   ZarrCodecChainSpec::FromJsonOptions from_json_options{/*.constraints=*/true};
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include <nlohmann/json.hpp>
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
@@ -54,6 +55,19 @@ struct CodecRoundTripTestParams {
 
 void TestCodecRoundTrip(const CodecRoundTripTestParams& params);
 
+struct CodecRegionDecodeTestParams {
+  ::nlohmann::json spec;
+  std::vector<Index> shape{30, 40, 50};
+  DataType dtype = dtype_v<uint16_t>;
+  // Non-empty region contained within `[0, shape)`.
+  Box<> region;
+};
+
+// Tests that `ZarrCodecChain::PreparedState::DecodeArrayRegion`, given just
+// the byte range returned by `GetEncodedByteRange`, returns the specified
+// region of the encoded array.
+void TestCodecRegionDecode(const CodecRegionDecodeTestParams& params);
+
 Result<::nlohmann::json> TestCodecMerge(::nlohmann::json a, ::nlohmann::json b,
                                         bool strict);
 
@@ -0,0 +1,174 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/delta.h"
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/filter.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+// Integer elements are encoded and decoded using unsigned arithmetic, which
+// wraps around.  The loop in `DeltaEncode` has no loop-carried dependency and
+// is vectorized by the compiler.
+template <typename T>
+void DeltaEncode(const T* src, T* dest, Index n) {
+  if (n == 0) return;
+  dest[0] = src[0];
+  for (Index i = 1; i < n; ++i) {
+    dest[i] = static_cast<T>(src[i] - src[i - 1]);
+  }
+}
+
+template <typename T>
+void DeltaDecode(const T* src, T* dest, Index n) {
+  T sum = 0;
+  for (Index i = 0; i < n; ++i) {
+    sum = static_cast<T>(sum + src[i]);
+    dest[i] = sum;
+  }
+}
+
+template <typename T>
+void DeltaApply(bool encode, const void* src, void* dest, Index n) {
+  if (encode) {
+    DeltaEncode(static_cast<const T*>(src), static_cast<T*>(dest), n);
+  } else {
+    DeltaDecode(static_cast<const T*>(src), static_cast<T*>(dest), n);
+  }
+}
+
+bool IsSupportedDataType(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::int8_t:
+    case DataTypeId::uint8_t:
+    case DataTypeId::int16_t:
+    case DataTypeId::uint16_t:
+    case DataTypeId::int32_t:
+    case DataTypeId::uint32_t:
+    case DataTypeId::int64_t:
+    case DataTypeId::uint64_t:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns a C-order array with the encoded or decoded representation of
+// `input`.
+SharedArray<const void> DeltaTransform(bool encode,
+                                       SharedArrayView<const void> input) {
+  auto src = MakeContiguousArray(std::move(input));
+  auto dest = AllocateArray(src.shape(), c_order, default_init, src.dtype());
+  const Index n = src.num_elements();
+  switch (src.dtype().size()) {
+    case 1:
+      DeltaApply<uint8_t>(encode, src.data(), dest.data(), n);
+      break;
+    case 2:
+      DeltaApply<uint16_t>(encode, src.data(), dest.data(), n);
+      break;
+    case 4:
+      DeltaApply<uint32_t>(encode, src.data(), dest.data(), n);
+      break;
+    case 8:
+      DeltaApply<uint64_t>(encode, src.data(), dest.data(), n);
+      break;
+  }
+  return dest;
+}
+
+class DeltaCodec : public ZarrArrayFilterCodec {
+ public:
+  class State : public ZarrArrayFilterCodec::PreparedState {
+   public:
+    Result<SharedArray<const void>> EncodeArray(
+        SharedArrayView<const void> decoded) const final {
+      return DeltaTransform(/*encode=*/true, std::move(decoded));
+    }
+
+    Result<SharedArray<const void>> DecodeArray(
+        SharedArrayView<const void> encoded,
+        span<const Index> decoded_shape) const final {
+      return DeltaTransform(/*encode=*/false, std::move(encoded));
+    }
+  };
+
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->shape_.assign(decoded_shape.begin(), decoded_shape.end());
+    return state;
+  }
+};
+
+}  // namespace
+
+absl::Status DeltaCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                       bool strict) {
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr DeltaCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<DeltaCodecSpec>(*this);
+}
+
+DataType DeltaCodecSpec::GetEncodedDataType(DataType dtype) const {
+  return dtype;
+}
+
+Result<ZarrArrayToArrayCodec::Ptr> DeltaCodecSpec::Resolve(
+    ArrayCodecResolveParameters&& decoded, ArrayCodecResolveParameters& encoded,
+    ZarrArrayToArrayCodecSpec::Ptr* resolved_spec) const {
+  if (!IsSupportedDataType(decoded.dtype)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Delta codec requires an integer data type, but received: ",
+        decoded.dtype));
+  }
+  PropagateResolveParameters(decoded, encoded);
+  encoded.dtype = decoded.dtype;
+  encoded.fill_value = std::move(decoded.fill_value);
+  if (resolved_spec) {
+    resolved_spec->reset(this);
+  }
+  return internal::MakeIntrusivePtr<DeltaCodec>();
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = DeltaCodecSpec;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>("delta", jb::Sequence());
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
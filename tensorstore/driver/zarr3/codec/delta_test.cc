@@ -0,0 +1,124 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+TEST(DeltaTest, Basic) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {"delta"};
+  p.expected_spec = {
+      {{"name", "delta"}},
+      GetDefaultBytesCodecJson(),
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(DeltaTest, RoundTrip) {
+  for (auto dtype : {tensorstore::DataType(dtype_v<int8_t>),
+                     tensorstore::DataType(dtype_v<uint16_t>),
+                     tensorstore::DataType(dtype_v<int32_t>),
+                     tensorstore::DataType(dtype_v<uint64_t>)}) {
+    SCOPED_TRACE(tensorstore::StrCat("dtype=", dtype));
+    CodecRoundTripTestParams p;
+    p.spec = {"delta"};
+    p.dtype = dtype;
+    TestCodecRoundTrip(p);
+  }
+}
+
+TEST(DeltaTest, RoundTripWithTranspose) {
+  CodecRoundTripTestParams p;
+  p.spec = {
+      {{"name", "transpose"}, {"configuration", {{"order", {2, 1, 0}}}}},
+      "delta",
+  };
+  TestCodecRoundTrip(p);
+}
+
+TEST(DeltaTest, InvalidDataType) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 2;
+  EXPECT_THAT(TestCodecSpecResolve({"delta"}, p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Delta codec requires an integer data type.*"));
+}
+
+TEST(DeltaTest, InvalidBeforeSharding) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto spec, ZarrCodecChainSpec::FromJson({
+                     "delta",
+                     {{"name", "sharding_indexed"},
+                      {"configuration",
+                       {
+                           {"chunk_shape", {2, 3}},
+                           {"codecs", {"bytes"}},
+                           {"index_codecs", {"bytes"}},
+                       }}},
+                 }));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.dtype = dtype_v<uint32_t>;
+  decoded_params.rank = 2;
+  decoded_params.fill_value = tensorstore::MakeScalarArray<uint32_t>(42);
+  BytesCodecResolveParameters encoded_params;
+  EXPECT_THAT(
+      spec.Resolve(std::move(decoded_params), encoded_params, nullptr),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Array -> array codec .* is not compatible with subsequent "
+                    "sharding codec .*"));
+}
+
+TEST(DeltaTest, RoundTripInsideSharding) {
+  CodecRoundTripTestParams p;
+  p.shape = {30, 40};
+  p.spec = {
+      {{"name", "sharding_indexed"},
+       {"configuration",
+        {
+            {"chunk_shape", {10, 20}},
+            {"codecs", {"delta", "bytes"}},
+            {"index_codecs", {"bytes"}},
+        }}},
+  };
+  TestCodecRoundTrip(p);
+}
+
+}  // namespace
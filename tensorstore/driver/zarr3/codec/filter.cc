@@ -0,0 +1,105 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/filter.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+namespace {
+absl::Status PartialIoNotSupportedError() {
+  return absl::UnimplementedError(
+      "Filter codecs do not support partial reads and writes");
+}
+}  // namespace
+
+absl::Status ZarrArrayFilterCodecSpec::PropagateDataTypeAndShape(
+    const ArrayDataTypeAndShapeInfo& decoded,
+    ArrayDataTypeAndShapeInfo& encoded) const {
+  encoded.dtype = GetEncodedDataType(decoded.dtype);
+  encoded.rank = decoded.rank;
+  encoded.shape = decoded.shape;
+  return absl::OkStatus();
+}
+
+absl::Status ZarrArrayFilterCodecSpec::GetDecodedChunkLayout(
+    const ArrayDataTypeAndShapeInfo& encoded_info,
+    const ArrayCodecChunkLayoutInfo& encoded,
+    const ArrayDataTypeAndShapeInfo& decoded_info,
+    ArrayCodecChunkLayoutInfo& decoded) const {
+  decoded = encoded;
+  return absl::OkStatus();
+}
+
+void ZarrArrayFilterCodecSpec::PropagateResolveParameters(
+    const ArrayCodecResolveParameters& decoded,
+    ArrayCodecResolveParameters& encoded) {
+  encoded.rank = decoded.rank;
+  encoded.read_chunk_shape = decoded.read_chunk_shape;
+  encoded.codec_chunk_shape = decoded.codec_chunk_shape;
+  encoded.inner_order = decoded.inner_order;
+}
+
+bool ZarrArrayFilterCodec::supports_partial_io() const { return false; }
+
+void ZarrArrayFilterCodec::PreparedState::Read(
+    const NextReader& next, span<const Index> decoded_shape,
+    IndexTransform<> transform,
+    AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>&&
+        receiver) const {
+  execution::set_error(receiver, PartialIoNotSupportedError());
+}
+
+void ZarrArrayFilterCodec::PreparedState::Write(
+    const NextWriter& next, span<const Index> decoded_shape,
+    IndexTransform<> transform,
+    AnyFlowReceiver<absl::Status, internal::WriteChunk, IndexTransform<>>&&
+        receiver) const {
+  execution::set_error(receiver, PartialIoNotSupportedError());
+}
+
+void ZarrArrayFilterCodec::PreparedState::GetStorageStatistics(
+    const NextGetStorageStatistics& next, span<const Index> decoded_shape,
+    IndexTransform<> transform,
+    internal::IntrusivePtr<internal::GetStorageStatisticsAsyncOperationState>
+        state) const {
+  state->SetError(PartialIoNotSupportedError());
+}
+
+SharedArray<const void> MakeContiguousArray(
+    SharedArrayView<const void> array) {
+  if (IsContiguousLayout(array, c_order)) {
+    return SharedArray<const void>(std::move(array.element_pointer()),
+                                   array.layout());
+  }
+  return MakeCopy(array, {c_order, include_repeated_elements});
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
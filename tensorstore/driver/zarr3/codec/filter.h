@@ -0,0 +1,105 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_FILTER_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_FILTER_H_
+
+// Defines base classes for "array -> array" filter codecs, which transform the
+// element values of a chunk, and possibly its data type, but not its shape.
+//
+// Since the encoded value of an element may depend on other elements, filter
+// codecs only support encoding and decoding complete chunks.  Therefore, they
+// cannot be followed by a sharding codec, but may be specified as inner codecs
+// of the sharding codec instead.
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/chunk.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+class ZarrArrayFilterCodecSpec : public ZarrArrayToArrayCodecSpec {
+ public:
+  // Returns the encoded data type for the decoded data type `dtype`, which may
+  // be invalid if not known.
+  virtual DataType GetEncodedDataType(DataType dtype) const = 0;
+
+  absl::Status PropagateDataTypeAndShape(
+      const ArrayDataTypeAndShapeInfo& decoded,
+      ArrayDataTypeAndShapeInfo& encoded) const final;
+
+  absl::Status GetDecodedChunkLayout(
+      const ArrayDataTypeAndShapeInfo& encoded_info,
+      const ArrayCodecChunkLayoutInfo& encoded,
+      const ArrayDataTypeAndShapeInfo& decoded_info,
+      ArrayCodecChunkLayoutInfo& decoded) const final;
+
+ protected:
+  // Sets the members of `encoded`, other than `dtype` and `fill_value`, from
+  // `decoded`.
+  static void PropagateResolveParameters(
+      const ArrayCodecResolveParameters& decoded,
+      ArrayCodecResolveParameters& encoded);
+};
+
+class ZarrArrayFilterCodec : public ZarrArrayToArrayCodec {
+ public:
+  bool supports_partial_io() const final;
+
+  class PreparedState : public ZarrArrayToArrayCodec::PreparedState {
+   public:
+    span<const Index> encoded_shape() const final { return shape_; }
+
+    void Read(const NextReader& next, span<const Index> decoded_shape,
+              IndexTransform<> transform,
+              AnyFlowReceiver<absl::Status, internal::ReadChunk,
+                              IndexTransform<>>&& receiver) const final;
+
+    void Write(const NextWriter& next, span<const Index> decoded_shape,
+               IndexTransform<> transform,
+               AnyFlowReceiver<absl::Status, internal::WriteChunk,
+                               IndexTransform<>>&& receiver) const final;
+
+    void GetStorageStatistics(
+        const NextGetStorageStatistics& next, span<const Index> decoded_shape,
+        IndexTransform<> transform,
+        internal::IntrusivePtr<
+            internal::GetStorageStatisticsAsyncOperationState>
+            state) const final;
+
+    // Shape of the decoded and encoded arrays.
+    std::vector<Index> shape_;
+  };
+};
+
+// Returns `array` if it has a C-order contiguous layout, and otherwise a
+// C-order contiguous copy.
+SharedArray<const void> MakeContiguousArray(SharedArrayView<const void> array);
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_FILTER_H_
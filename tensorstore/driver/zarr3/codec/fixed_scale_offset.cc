@@ -0,0 +1,267 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/fixed_scale_offset.h"
+
+#include <stdint.h>
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/filter.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/data_type.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace {
+
+struct ScaleOffset {
+  double offset;
+  double scale;
+};
+
+// Values are rounded to the nearest integer, with ties rounded to even as by
+// `numpy.around`, and then clamped to the range of `I`.  NaN is encoded as the
+// minimum value of `I`.
+template <typename F, typename I>
+void FixedScaleOffsetEncode(const F* src, I* dest, Index n, ScaleOffset p) {
+  constexpr double kMin = std::numeric_limits<I>::min();
+  constexpr double kMax = std::numeric_limits<I>::max();
+  for (Index i = 0; i < n; ++i) {
+    const double v =
+        std::nearbyint((static_cast<double>(src[i]) - p.offset) * p.scale);
+    dest[i] = static_cast<I>(!(v >= kMin) ? kMin : (v > kMax ? kMax : v));
+  }
+}
+
+template <typename F, typename I>
+void FixedScaleOffsetDecode(const I* src, F* dest, Index n, ScaleOffset p) {
+  for (Index i = 0; i < n; ++i) {
+    dest[i] = static_cast<F>(static_cast<double>(src[i]) / p.scale + p.offset);
+  }
+}
+
+// Invokes `func(F{}, I{})`, where `F` is the floating-point type corresponding
+// to `decoded_dtype` and `I` is the integer type corresponding to
+// `encoded_dtype`.
+template <typename I, typename Func>
+void DispatchFloatType(DataType decoded_dtype, Func func) {
+  if (decoded_dtype.id() == DataTypeId::float32_t) {
+    func(float{}, I{});
+  } else {
+    func(double{}, I{});
+  }
+}
+
+template <typename Func>
+void Dispatch(DataType decoded_dtype, DataType encoded_dtype, Func func) {
+  switch (encoded_dtype.id()) {
+    case DataTypeId::int8_t:
+      return DispatchFloatType<int8_t>(decoded_dtype, func);
+    case DataTypeId::uint8_t:
+      return DispatchFloatType<uint8_t>(decoded_dtype, func);
+    case DataTypeId::int16_t:
+      return DispatchFloatType<int16_t>(decoded_dtype, func);
+    case DataTypeId::uint16_t:
+      return DispatchFloatType<uint16_t>(decoded_dtype, func);
+    case DataTypeId::int32_t:
+      return DispatchFloatType<int32_t>(decoded_dtype, func);
+    case DataTypeId::uint32_t:
+      return DispatchFloatType<uint32_t>(decoded_dtype, func);
+    default:
+      break;
+  }
+}
+
+bool IsSupportedDecodedDataType(DataType dtype) {
+  return dtype.id() == DataTypeId::float32_t ||
+         dtype.id() == DataTypeId::float64_t;
+}
+
+bool IsSupportedEncodedDataType(DataType dtype) {
+  switch (dtype.id()) {
+    case DataTypeId::int8_t:
+    case DataTypeId::uint8_t:
+    case DataTypeId::int16_t:
+    case DataTypeId::uint16_t:
+    case DataTypeId::int32_t:
+    case DataTypeId::uint32_t:
+      return true;
+    default:
+      return false;
+  }
+}
+
+class FixedScaleOffsetCodec : public ZarrArrayFilterCodec {
+ public:
+  explicit FixedScaleOffsetCodec(DataType decoded_dtype, DataType encoded_dtype,
+                                 ScaleOffset params)
+      : decoded_dtype_(decoded_dtype),
+        encoded_dtype_(encoded_dtype),
+        params_(params) {}
+
+  SharedArray<const void> Encode(SharedArrayView<const void> decoded) const {
+    auto src = MakeContiguousArray(std::move(decoded));
+    auto dest =
+        AllocateArray(src.shape(), c_order, default_init, encoded_dtype_);
+    Dispatch(decoded_dtype_, encoded_dtype_, [&](auto f, auto i) {
+      using F = decltype(f);
+      using I = decltype(i);
+      FixedScaleOffsetEncode(static_cast<const F*>(src.data()),
+                             static_cast<I*>(dest.data()), src.num_elements(),
+                             params_);
+    });
+    return dest;
+  }
+
+  SharedArray<const void> Decode(SharedArrayView<const void> encoded) const {
+    auto src = MakeContiguousArray(std::move(encoded));
+    auto dest =
+        AllocateArray(src.shape(), c_order, default_init, decoded_dtype_);
+    Dispatch(decoded_dtype_, encoded_dtype_, [&](auto f, auto i) {
+      using F = decltype(f);
+      using I = decltype(i);
+      FixedScaleOffsetDecode(static_cast<const I*>(src.data()),
+                             static_cast<F*>(dest.data()), src.num_elements(),
+                             params_);
+    });
+    return dest;
+  }
+
+  class State : public ZarrArrayFilterCodec::PreparedState {
+   public:
+    Result<SharedArray<const void>> EncodeArray(
+        SharedArrayView<const void> decoded) const final {
+      return codec_->Encode(std::move(decoded));
+    }
+
+    Result<SharedArray<const void>> DecodeArray(
+        SharedArrayView<const void> encoded,
+        span<const Index> decoded_shape) const final {
+      return codec_->Decode(std::move(encoded));
+    }
+
+    const FixedScaleOffsetCodec* codec_;
+  };
+
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape) const final {
+    auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
+    state->shape_.assign(decoded_shape.begin(), decoded_shape.end());
+    return state;
+  }
+
+ private:
+  DataType decoded_dtype_;
+  DataType encoded_dtype_;
+  ScaleOffset params_;
+};
+
+}  // namespace
+
+absl::Status FixedScaleOffsetCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                                  bool strict) {
+  using Self = FixedScaleOffsetCodecSpec;
+  namespace jb = ::tensorstore::internal_json_binding;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  TENSORSTORE_RETURN_IF_ERROR(
+      MergeConstraint<&Options::offset>("offset", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(
+      MergeConstraint<&Options::scale>("scale", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::astype>(
+      "astype", options, other_options, jb::DataTypeJsonBinder));
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr FixedScaleOffsetCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<FixedScaleOffsetCodecSpec>(*this);
+}
+
+DataType FixedScaleOffsetCodecSpec::GetEncodedDataType(DataType dtype) const {
+  return options.astype.value_or(DataType());
+}
+
+Result<ZarrArrayToArrayCodec::Ptr> FixedScaleOffsetCodecSpec::Resolve(
+    ArrayCodecResolveParameters&& decoded, ArrayCodecResolveParameters& encoded,
+    ZarrArrayToArrayCodecSpec::Ptr* resolved_spec) const {
+  if (!IsSupportedDecodedDataType(decoded.dtype)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Fixedscaleoffset codec requires a float32 or float64 data type, but "
+        "received: ",
+        decoded.dtype));
+  }
+  if (!options.offset || !options.scale || !options.astype) {
+    return absl::InvalidArgumentError(
+        "\"offset\", \"scale\", and \"astype\" must be specified");
+  }
+  if (!IsSupportedEncodedDataType(*options.astype)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "\"astype\" must be an integer data type of at most 32 bits, but "
+        "received: ",
+        *options.astype));
+  }
+  if (!std::isfinite(*options.scale) || *options.scale == 0) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "\"scale\" must be finite and non-zero, but received: ",
+        *options.scale));
+  }
+  auto codec = internal::MakeIntrusivePtr<FixedScaleOffsetCodec>(
+      decoded.dtype, *options.astype,
+      ScaleOffset{*options.offset, *options.scale});
+  PropagateResolveParameters(decoded, encoded);
+  encoded.dtype = *options.astype;
+  if (decoded.fill_value.valid()) {
+    encoded.fill_value = codec->Encode(decoded.fill_value);
+  }
+  if (resolved_spec) {
+    resolved_spec->reset(this);
+  }
+  return codec;
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = FixedScaleOffsetCodecSpec;
+  using Options = Self::Options;
+  namespace jb = ::tensorstore::internal_json_binding;
+  RegisterCodec<Self>(
+      "fixedscaleoffset",
+      jb::Projection<&Self::options>(jb::Sequence(
+          jb::Member("offset", jb::Projection<&Options::offset>(
+                                   OptionalIfConstraintsBinder())),
+          jb::Member("scale", jb::Projection<&Options::scale>(
+                                  OptionalIfConstraintsBinder())),
+          jb::Member("astype",
+                     jb::Projection<&Options::astype>(
+                         OptionalIfConstraintsBinder(jb::DataTypeJsonBinder)))
+          /**/)));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
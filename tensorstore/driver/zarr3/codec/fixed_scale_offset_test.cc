@@ -0,0 +1,142 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <limits>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::dtype_v;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+
+::nlohmann::json FixedScaleOffsetSpec(double offset, double scale,
+                                      const char* astype) {
+  return {{{"name", "fixedscaleoffset"},
+           {"configuration",
+            {{"offset", offset}, {"scale", scale}, {"astype", astype}}}}};
+}
+
+Result<SharedArray<const void>> EncodeDecode(::nlohmann::json json_spec,
+                                             SharedArray<const void> array) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto spec,
+                               ZarrCodecChainSpec::FromJson(json_spec));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.dtype = array.dtype();
+  decoded_params.rank = array.rank();
+  decoded_params.fill_value = tensorstore::AllocateArray(
+      tensorstore::span<const tensorstore::Index>{}, tensorstore::c_order,
+      tensorstore::value_init, array.dtype());
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto chain, spec.Resolve(std::move(decoded_params), encoded_params));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto state, chain->Prepare(array.shape()));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto encoded, state->EncodeArray(array));
+  return state->DecodeArray(array.shape(), std::move(encoded));
+}
+
+TEST(FixedScaleOffsetTest, Basic) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = FixedScaleOffsetSpec(1000, 10, "uint16");
+  p.resolve_params.dtype = dtype_v<float>;
+  p.expected_spec = {
+      {{"name", "fixedscaleoffset"},
+       {"configuration",
+        {{"offset", 1000.0}, {"scale", 10.0}, {"astype", "uint16"}}}},
+      GetDefaultBytesCodecJson(),
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(FixedScaleOffsetTest, EncodeDecode) {
+  EXPECT_THAT(
+      EncodeDecode(FixedScaleOffsetSpec(1000, 4, "uint16"),
+                   tensorstore::MakeArray<double>(
+                       {1000, 1000.1, 1000.125, 1000.3, 1000.375, 1234.5})),
+      ::testing::Optional(tensorstore::MakeArray<double>(
+          {1000, 1000, 1000, 1000.25, 1000.5, 1234.5})));
+}
+
+TEST(FixedScaleOffsetTest, Clamp) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  EXPECT_THAT(
+      EncodeDecode(FixedScaleOffsetSpec(0, 1, "int8"),
+                   tensorstore::MakeArray<float>({-1000, -5, 5, 1000, nan})),
+      ::testing::Optional(
+          tensorstore::MakeArray<float>({-128, -5, 5, 127, -128})));
+}
+
+TEST(FixedScaleOffsetTest, InvalidDataType) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<int32_t>;
+  p.rank = 1;
+  EXPECT_THAT(
+      TestCodecSpecResolve(FixedScaleOffsetSpec(0, 1, "int16"), p),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Fixedscaleoffset codec requires a float32 or float64 .*"));
+}
+
+TEST(FixedScaleOffsetTest, InvalidAstype) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve(FixedScaleOffsetSpec(0, 1, "int64"), p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "\"astype\" must be an integer data type .*"));
+}
+
+TEST(FixedScaleOffsetTest, InvalidScale) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve(FixedScaleOffsetSpec(0, 0, "int16"), p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "\"scale\" must be finite and non-zero.*"));
+}
+
+TEST(FixedScaleOffsetTest, MissingOptions) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<float>;
+  p.rank = 1;
+  EXPECT_THAT(TestCodecSpecResolve({"fixedscaleoffset"}, p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".* must be specified"));
+}
+
+}  // namespace
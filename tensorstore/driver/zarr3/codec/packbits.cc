@@ -0,0 +1,354 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/packbits.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/filter.h"
+#include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dimension_permutation.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/enum.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+namespace internal_packbits {
+
+int GetPackedBits(DataType dtype) {
+  if (!dtype.valid()) return 0;
+  switch (dtype.id()) {
+    case DataTypeId::bool_t:
+      return 1;
+    case DataTypeId::int4_t:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+void PackBits(const unsigned char* decoded, size_t num_elements, int bits,
+              unsigned char* encoded) {
+  size_t i = 0;
+  if (bits == 1) {
+    // Gathers the low bit of each of 8 bytes into the high byte of the
+    // product; the partial products do not overlap since each byte is 0 or 1.
+    for (; i + 8 <= num_elements; i += 8) {
+      const uint64_t x = absl::little_endian::Load64(decoded + i) &
+                         0x0101010101010101ull;
+      encoded[i / 8] =
+          static_cast<unsigned char>((x * 0x0102040810204080ull) >> 56);
+    }
+    if (i == num_elements) return;
+    unsigned char b = 0;
+    for (size_t j = 0; i < num_elements; ++i, ++j) {
+      b |= (decoded[i] & 1) << j;
+    }
+    encoded[num_elements / 8] = b;
+    return;
+  }
+  assert(bits == 4);
+  for (; i + 2 <= num_elements; i += 2) {
+    encoded[i / 2] = static_cast<unsigned char>((decoded[i] & 0xf) |
+                                                (decoded[i + 1] << 4));
+  }
+  if (i != num_elements) {
+    encoded[i / 2] = decoded[i] & 0xf;
+  }
+}
+
+void UnpackBits(const unsigned char* encoded, size_t num_elements, int bits,
+                unsigned char* decoded) {
+  size_t i = 0;
+  if (bits == 1) {
+    // Broadcasts the byte to all 8 bytes, selects bit `j` in byte `j`, and then
+    // normalizes each non-zero byte to 1.
+    for (; i + 8 <= num_elements; i += 8) {
+      uint64_t x = (encoded[i / 8] * 0x0101010101010101ull) &
+                   0x8040201008040201ull;
+      x = ((x + 0x7f7f7f7f7f7f7f7full) >> 7) & 0x0101010101010101ull;
+      absl::little_endian::Store64(decoded + i, x);
+    }
+    for (; i < num_elements; ++i) {
+      decoded[i] = (encoded[i / 8] >> (i % 8)) & 1;
+    }
+    return;
+  }
+  assert(bits == 4);
+  for (; i + 2 <= num_elements; i += 2) {
+    const unsigned char b = encoded[i / 2];
+    decoded[i] = static_cast<unsigned char>(static_cast<int8_t>(b << 4) >> 4);
+    decoded[i + 1] = static_cast<unsigned char>(static_cast<int8_t>(b) >> 4);
+  }
+  if (i != num_elements) {
+    decoded[i] = static_cast<unsigned char>(
+        static_cast<int8_t>(encoded[i / 2] << 4) >> 4);
+  }
+}
+
+}  // namespace internal_packbits
+
+namespace {
+
+using PaddingEncoding = PackbitsCodecSpec::PaddingEncoding;
+
+absl::Status InvalidDataTypeError(DataType dtype) {
+  return absl::InvalidArgumentError(tensorstore::StrCat(
+      "Data type ", dtype, " not compatible with \"packbits\" codec"));
+}
+
+class PackbitsCodec : public ZarrArrayToBytesCodec {
+ public:
+  explicit PackbitsCodec(DataType decoded_dtype, int bits,
+                         PaddingEncoding padding_encoding)
+      : dtype_(decoded_dtype),
+        bits_(bits),
+        padding_encoding_(padding_encoding) {}
+
+  Result<PreparedState::Ptr> Prepare(
+      span<const Index> decoded_shape) const final;
+
+ private:
+  DataType dtype_;
+  int bits_;
+  PaddingEncoding padding_encoding_;
+};
+}  // namespace
+
+absl::Status PackbitsCodecSpec::GetDecodedChunkLayout(
+    const ArrayDataTypeAndShapeInfo& array_info,
+    ArrayCodecChunkLayoutInfo& decoded) const {
+  if (array_info.dtype.valid() &&
+      !internal_packbits::GetPackedBits(array_info.dtype)) {
+    return InvalidDataTypeError(array_info.dtype);
+  }
+  const DimensionIndex rank = array_info.rank;
+  if (rank != dynamic_rank) {
+    auto& inner_order = decoded.inner_order.emplace();
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      inner_order[i] = i;
+    }
+  }
+
+  if (array_info.shape) {
+    auto& shape = *array_info.shape;
+    auto& read_chunk_shape = decoded.read_chunk_shape.emplace();
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      read_chunk_shape[i] = shape[i];
+    }
+  }
+  return absl::OkStatus();
+}
+
+bool PackbitsCodecSpec::SupportsInnerOrder(
+    const ArrayCodecResolveParameters& decoded,
+    span<DimensionIndex> preferred_inner_order) const {
+  if (!decoded.inner_order) return true;
+  if (PermutationMatchesOrder(span(decoded.inner_order->data(), decoded.rank),
+                              c_order)) {
+    return true;
+  }
+  SetPermutation(c_order, preferred_inner_order);
+  return false;
+}
+
+Result<ZarrArrayToBytesCodec::Ptr> PackbitsCodecSpec::Resolve(
+    ArrayCodecResolveParameters&& decoded, BytesCodecResolveParameters& encoded,
+    ZarrArrayToBytesCodecSpec::Ptr* resolved_spec) const {
+  assert(decoded.dtype.valid());
+  const int bits = internal_packbits::GetPackedBits(decoded.dtype);
+  if (!bits) {
+    return InvalidDataTypeError(decoded.dtype);
+  }
+  encoded.item_bits = bits;
+  DimensionIndex rank = decoded.rank;
+  if (decoded.codec_chunk_shape) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "\"packbits\" codec does not support codec_chunk_shape (",
+        span<const Index>(decoded.codec_chunk_shape->data(), rank),
+        " was specified"));
+  }
+  if (decoded.inner_order) {
+    auto& decoded_inner_order = *decoded.inner_order;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      if (decoded_inner_order[i] != i) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "\"packbits\" codec does not support inner_order of ",
+            span<const DimensionIndex>(decoded_inner_order.data(), rank)));
+      }
+    }
+  }
+  const PaddingEncoding padding_encoding =
+      options.padding_encoding.value_or(PaddingEncoding::kNone);
+  if (resolved_spec) {
+    resolved_spec->reset(new PackbitsCodecSpec(Options{padding_encoding}));
+  }
+  return internal::MakeIntrusivePtr<PackbitsCodec>(decoded.dtype, bits,
+                                                   padding_encoding);
+}
+
+namespace {
+namespace jb = ::tensorstore::internal_json_binding;
+constexpr auto PaddingEncodingBinder() {
+  return jb::Enum<PaddingEncoding, std::string_view>({
+      {PaddingEncoding::kNone, "none"},
+      {PaddingEncoding::kStartByte, "start_byte"},
+      {PaddingEncoding::kEndByte, "end_byte"},
+  });
+}
+}  // namespace
+
+absl::Status PackbitsCodecSpec::MergeFrom(const ZarrCodecSpec& other,
+                                          bool strict) {
+  using Self = PackbitsCodecSpec;
+  const auto& other_options = static_cast<const Self&>(other).options;
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::padding_encoding>(
+      "padding_encoding", options, other_options, PaddingEncodingBinder()));
+  return absl::OkStatus();
+}
+
+ZarrCodecSpec::Ptr PackbitsCodecSpec::Clone() const {
+  return internal::MakeIntrusivePtr<PackbitsCodecSpec>(*this);
+}
+
+namespace {
+class PackbitsCodecPreparedState
+    : public ZarrArrayToBytesCodec::PreparedState {
+ public:
+  int64_t encoded_size() const final { return encoded_size_; }
+
+  absl::Status EncodeArray(SharedArrayView<const void> decoded,
+                           riegeli::Writer& writer) const final {
+    auto contiguous = MakeContiguousArray(std::move(decoded));
+    const size_t size = static_cast<size_t>(encoded_size_);
+    if (!writer.Push(size)) {
+      assert(!writer.ok());
+      return writer.status();
+    }
+    auto* cursor = reinterpret_cast<unsigned char*>(writer.cursor());
+    unsigned char* packed = cursor;
+    if (padding_encoding_ == PaddingEncoding::kStartByte) {
+      *packed++ = padding_bits_;
+    } else if (padding_encoding_ == PaddingEncoding::kEndByte) {
+      cursor[size - 1] = padding_bits_;
+    }
+    internal_packbits::PackBits(
+        static_cast<const unsigned char*>(contiguous.data()),
+        static_cast<size_t>(num_elements_), bits_, packed);
+    writer.move_cursor(size);
+    return absl::OkStatus();
+  }
+
+  Result<SharedArray<const void>> DecodeArray(
+      span<const Index> decoded_shape, riegeli::Reader& reader) const final {
+    const size_t size = static_cast<size_t>(encoded_size_);
+    if (!reader.Pull(size)) {
+      if (!reader.ok()) return reader.status();
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Expected ", size, " bytes but received ", reader.available()));
+    }
+    const auto* cursor =
+        reinterpret_cast<const unsigned char*>(reader.cursor());
+    const unsigned char* packed = cursor;
+    if (padding_encoding_ != PaddingEncoding::kNone) {
+      unsigned char padding_bits;
+      if (padding_encoding_ == PaddingEncoding::kStartByte) {
+        padding_bits = *packed++;
+      } else {
+        padding_bits = cursor[size - 1];
+      }
+      if (padding_bits != padding_bits_) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Expected ", static_cast<int>(padding_bits_),
+            " padding bits but received ", static_cast<int>(padding_bits)));
+      }
+    }
+    auto array = AllocateArray(decoded_shape, c_order, default_init, dtype_);
+    internal_packbits::UnpackBits(
+        packed, static_cast<size_t>(num_elements_), bits_,
+        static_cast<unsigned char*>(array.data()));
+    reader.move_cursor(size);
+    if (!reader.VerifyEnd()) return reader.status();
+    return array;
+  }
+
+  DataType dtype_;
+  int bits_;
+  PaddingEncoding padding_encoding_;
+  unsigned char padding_bits_;
+  Index num_elements_;
+  int64_t encoded_size_;
+};
+}  // namespace
+
+Result<ZarrArrayToBytesCodec::PreparedState::Ptr> PackbitsCodec::Prepare(
+    span<const Index> decoded_shape) const {
+  Index num_bits = bits_;
+  for (auto size : decoded_shape) {
+    if (internal::MulOverflow(size, num_bits, &num_bits)) {
+      return absl::OutOfRangeError(tensorstore::StrCat(
+          "Integer overflow computing encoded size of array of shape ",
+          decoded_shape));
+    }
+  }
+  auto state = internal::MakeIntrusivePtr<PackbitsCodecPreparedState>();
+  state->dtype_ = dtype_;
+  state->bits_ = bits_;
+  state->padding_encoding_ = padding_encoding_;
+  state->num_elements_ = num_bits / bits_;
+  state->padding_bits_ = static_cast<unsigned char>((8 - num_bits % 8) % 8);
+  state->encoded_size_ = num_bits / 8 + (num_bits % 8 != 0) +
+                         (padding_encoding_ != PaddingEncoding::kNone);
+  return state;
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  using Self = PackbitsCodecSpec;
+  using Options = Self::Options;
+  RegisterCodec<Self>(
+      "packbits",
+      jb::Projection<&Self::options>(jb::Sequence(  //
+          jb::Member("padding_encoding",
+                     jb::Projection<&Options::padding_encoding>(
+                         jb::Optional(PaddingEncodingBinder())))  //
+          )));
+}
+
+}  // namespace internal_zarr3
+}  // namespace tensorstore
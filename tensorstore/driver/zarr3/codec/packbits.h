@@ -0,0 +1,98 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
+#define TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
+
+#include <stddef.h>
+
+#include <optional>
+
+#include "absl/status/status.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_zarr3 {
+
+// "array -> bytes" codec that stores sub-byte data types, `bool` and `int4`,
+// with 1 and 4 bits per element, respectively, rather than one byte per
+// element as the "bytes" codec does.
+class PackbitsCodecSpec : public ZarrArrayToBytesCodecSpec {
+ public:
+  enum class PaddingEncoding {
+    // The number of padding bits is implied by the chunk shape.
+    kNone,
+    // An additional byte before the packed elements specifies the number of
+    // padding bits in the last byte.
+    kStartByte,
+    // Same as `kStartByte`, but the additional byte follows the packed
+    // elements.
+    kEndByte,
+  };
+
+  struct Options {
+    std::optional<PaddingEncoding> padding_encoding;
+  };
+  PackbitsCodecSpec() = default;
+  explicit PackbitsCodecSpec(const Options& options) : options(options) {}
+
+  absl::Status MergeFrom(const ZarrCodecSpec& other, bool strict) override;
+  ZarrCodecSpec::Ptr Clone() const override;
+
+  absl::Status GetDecodedChunkLayout(
+      const ArrayDataTypeAndShapeInfo& array_info,
+      ArrayCodecChunkLayoutInfo& decoded) const override;
+
+  bool SupportsInnerOrder(
+      const ArrayCodecResolveParameters& decoded,
+      span<DimensionIndex> preferred_inner_order) const override;
+
+  Result<ZarrArrayToBytesCodec::Ptr> Resolve(
+      ArrayCodecResolveParameters&& decoded,
+      BytesCodecResolveParameters& encoded,
+      ZarrArrayToBytesCodecSpec::Ptr* resolved_spec) const override;
+
+  Options options;
+};
+
+namespace internal_packbits {
+
+// Returns the number of bits per element of `dtype` in the packed
+// representation, or `0` if `dtype` is not supported.
+int GetPackedBits(DataType dtype);
+
+// Packs the low `bits` bits, where `bits` is 1 or 4, of each of the
+// `num_elements` bytes of `decoded` into `(num_elements * bits + 7) / 8` bytes
+// of `encoded`.
+//
+// Element `i` is stored in bits `[i * bits, (i + 1) * bits)` of the output,
+// where bit `j` of the output is bit `j % 8` of byte `j / 8`.  Padding bits in
+// the last byte are zero.
+void PackBits(const unsigned char* decoded, size_t num_elements, int bits,
+              unsigned char* encoded);
+
+// Inverse of `PackBits`.  With `bits == 4`, the elements are sign extended as
+// required for `int4`.
+void UnpackBits(const unsigned char* encoded, size_t num_elements, int bits,
+                unsigned char* decoded);
+
+}  // namespace internal_packbits
+}  // namespace internal_zarr3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_DRIVER_ZARR3_CODEC_PACKBITS_H_
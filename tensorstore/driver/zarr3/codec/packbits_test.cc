@@ -0,0 +1,231 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/driver/zarr3/codec/packbits.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/zarr3/codec/codec.h"
+#include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_spec.h"
+#include "tensorstore/driver/zarr3/codec/codec_test_util.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::DataType;
+using ::tensorstore::dtype_v;
+using ::tensorstore::Index;
+using ::tensorstore::MakeArray;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::Result;
+using ::tensorstore::SharedArray;
+using ::tensorstore::dtypes::int4_t;
+using ::tensorstore::internal_zarr3::ArrayCodecResolveParameters;
+using ::tensorstore::internal_zarr3::BytesCodecResolveParameters;
+using ::tensorstore::internal_zarr3::CodecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::CodecSpecRoundTripTestParams;
+using ::tensorstore::internal_zarr3::TestCodecRoundTrip;
+using ::tensorstore::internal_zarr3::TestCodecSpecResolve;
+using ::tensorstore::internal_zarr3::TestCodecSpecRoundTrip;
+using ::tensorstore::internal_zarr3::ZarrCodecChain;
+using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
+using ::tensorstore::internal_zarr3::internal_packbits::PackBits;
+using ::tensorstore::internal_zarr3::internal_packbits::UnpackBits;
+
+// Returns the prepared codec chain for `json_spec` and an array of `dtype` and
+// `shape`.
+Result<ZarrCodecChain::PreparedState::Ptr> Prepare(::nlohmann::json json_spec,
+                                                   DataType dtype,
+                                                   std::vector<Index> shape) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto spec,
+                               ZarrCodecChainSpec::FromJson(json_spec));
+  ArrayCodecResolveParameters decoded_params;
+  decoded_params.dtype = dtype;
+  decoded_params.rank = shape.size();
+  decoded_params.fill_value = tensorstore::AllocateArray(
+      tensorstore::span<const Index>{}, tensorstore::c_order,
+      tensorstore::value_init, dtype);
+  BytesCodecResolveParameters encoded_params;
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto chain, spec.Resolve(std::move(decoded_params), encoded_params));
+  return chain->Prepare(shape);
+}
+
+TEST(PackbitsTest, SpecRoundTrip) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {"packbits"};
+  p.resolve_params.dtype = dtype_v<bool>;
+  p.expected_spec = {
+      {{"name", "packbits"}, {"configuration", {{"padding_encoding", "none"}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(PackbitsTest, SpecRoundTripPaddingEncoding) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {{{"name", "packbits"},
+                  {"configuration", {{"padding_encoding", "end_byte"}}}}};
+  p.resolve_params.dtype = dtype_v<int4_t>;
+  p.expected_spec = p.orig_spec;
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(PackbitsTest, InvalidPaddingEncoding) {
+  EXPECT_THAT(
+      ZarrCodecChainSpec::FromJson(
+          {{{"name", "packbits"},
+            {"configuration", {{"padding_encoding", "middle"}}}}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*\"padding_encoding\".*"));
+}
+
+TEST(PackbitsTest, InvalidDataType) {
+  ArrayCodecResolveParameters p;
+  p.dtype = dtype_v<uint8_t>;
+  p.rank = 2;
+  EXPECT_THAT(TestCodecSpecResolve({"packbits"}, p),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Data type uint8 not compatible with "
+                            "\"packbits\" codec"));
+}
+
+TEST(PackbitsTest, EncodeInt4) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto state,
+                                   Prepare({"packbits"}, dtype_v<int4_t>, {5}));
+  EXPECT_EQ(3, state->encoded_size());
+  auto array = MakeArray<int4_t>(
+      {int4_t(1), int4_t(-2), int4_t(7), int4_t(-8), int4_t(-1)});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, state->EncodeArray(array));
+  EXPECT_EQ(std::string("\xe1\x87\x0f", 3), std::string(encoded));
+  EXPECT_THAT(state->DecodeArray(array.shape(), encoded),
+              ::testing::Optional(array));
+}
+
+TEST(PackbitsTest, EncodeBool) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto state, Prepare({"packbits"}, dtype_v<bool>, {2, 5}));
+  EXPECT_EQ(2, state->encoded_size());
+  auto array = MakeArray<bool>({{true, false, false, true, true},
+                                {false, true, false, false, true}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, state->EncodeArray(array));
+  EXPECT_EQ(std::string("\x59\x02", 2), std::string(encoded));
+  EXPECT_THAT(state->DecodeArray(array.shape(), encoded),
+              ::testing::Optional(array));
+}
+
+TEST(PackbitsTest, PaddingEncoding) {
+  auto array = MakeArray<bool>({true, true, true});
+  for (const auto& [padding_encoding, expected] :
+       std::vector<std::pair<std::string, std::string>>{
+           {"start_byte", std::string("\x05\x07", 2)},
+           {"end_byte", std::string("\x07\x05", 2)},
+       }) {
+    SCOPED_TRACE(tensorstore::StrCat("padding_encoding=", padding_encoding));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto state,
+        Prepare({{{"name", "packbits"},
+                  {"configuration", {{"padding_encoding", padding_encoding}}}}},
+                dtype_v<bool>, {3}));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, state->EncodeArray(array));
+    EXPECT_EQ(expected, std::string(encoded));
+    EXPECT_THAT(state->DecodeArray(array.shape(), encoded),
+                ::testing::Optional(array));
+    // The padding byte is validated.
+    EXPECT_THAT(state->DecodeArray(array.shape(), absl::Cord("\x04\x04")),
+                MatchesStatus(absl::StatusCode::kInvalidArgument,
+                              ".*Expected 5 padding bits but received 4.*"));
+  }
+}
+
+TEST(PackbitsTest, DecodeTruncated) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto state,
+                                   Prepare({"packbits"}, dtype_v<bool>, {20}));
+  EXPECT_THAT(state->DecodeArray({20}, absl::Cord("\x01\x02")),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PackbitsTest, RoundTrip) {
+  for (auto dtype : {DataType(dtype_v<bool>), DataType(dtype_v<int4_t>)}) {
+    SCOPED_TRACE(tensorstore::StrCat("dtype=", dtype));
+    CodecRoundTripTestParams p;
+    p.spec = {"packbits"};
+    p.dtype = dtype;
+    p.shape = {30, 40, 51};
+    TestCodecRoundTrip(p);
+  }
+}
+
+TEST(PackbitsTest, RoundTripInsideSharding) {
+  CodecRoundTripTestParams p;
+  p.shape = {30, 40};
+  p.dtype = dtype_v<bool>;
+  p.spec = {
+      {{"name", "sharding_indexed"},
+       {"configuration",
+        {
+            {"chunk_shape", {10, 7}},
+            {"codecs", {"packbits"}},
+            {"index_codecs", {"bytes"}},
+        }}},
+  };
+  TestCodecRoundTrip(p);
+}
+
+// Compares the 8-at-a-time bool kernels and the scalar tails against a
+// bit-by-bit reference for all lengths up to a few words.
+TEST(PackbitsKernelTest, Bool) {
+  for (size_t n = 0; n < 70; ++n) {
+    SCOPED_TRACE(tensorstore::StrCat("n=", n));
+    std::vector<unsigned char> decoded(n);
+    for (size_t i = 0; i < n; ++i) decoded[i] = (i * 7 + n) % 3 == 0;
+    std::vector<unsigned char> expected((n + 7) / 8);
+    for (size_t i = 0; i < n; ++i) expected[i / 8] |= decoded[i] << (i % 8);
+    std::vector<unsigned char> encoded((n + 7) / 8, 0xff);
+    PackBits(decoded.data(), n, 1, encoded.data());
+    EXPECT_EQ(expected, encoded);
+    std::vector<unsigned char> unpacked(n, 0xff);
+    UnpackBits(encoded.data(), n, 1, unpacked.data());
+    EXPECT_EQ(decoded, unpacked);
+  }
+}
+
+TEST(PackbitsKernelTest, Int4) {
+  std::vector<unsigned char> decoded;
+  for (int i = -8; i < 8; ++i) decoded.push_back(static_cast<int8_t>(i));
+  decoded.push_back(3);
+  std::vector<unsigned char> encoded(9, 0xff);
+  PackBits(decoded.data(), decoded.size(), 4, encoded.data());
+  EXPECT_EQ(0x98, encoded[0]);
+  EXPECT_EQ(0x03, encoded[8]);
+  std::vector<unsigned char> unpacked(decoded.size());
+  UnpackBits(encoded.data(), decoded.size(), 4, unpacked.data());
+  EXPECT_EQ(decoded, unpacked);
+}
+
+}  // namespace
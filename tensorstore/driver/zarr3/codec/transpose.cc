@@ -39,6 +39,8 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_variant.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/internal/transpose_copy.h"
+#include "tensorstore/internal/unaligned_data_type_functions.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/result.h"
@@ -140,6 +142,19 @@ class TransposeCodec : public ZarrArrayToArrayCodec {
         encoded.byte_strides()[encoded_dim] =
             decoded.byte_strides()[decoded_dim];
       }
+      if (!IsContiguousLayout(encoded, c_order) &&
+          internal::IsTrivialDataType(encoded.dtype())) {
+        // Subsequent codecs would otherwise copy `encoded` with a strided
+        // traversal; transpose it into a contiguous array instead.
+        auto contiguous = AllocateArray(encoded.shape(), c_order, default_init,
+                                        encoded.dtype());
+        if (internal::TryCopyTransposed(
+                encoded.dtype().size(), encoded.shape(), encoded.data(),
+                encoded.byte_strides(), contiguous.data(),
+                contiguous.byte_strides())) {
+          return contiguous;
+        }
+      }
       return encoded;
     }
 
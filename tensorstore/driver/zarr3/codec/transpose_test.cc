@@ -23,6 +23,7 @@
 #include "tensorstore/driver/zarr3/codec/codec_test_util.h"
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace {
 
@@ -92,6 +93,24 @@ TEST(TransposeTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+TEST(TransposeTest, RoundTripPartialPermutation) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "transpose"}, {"configuration", {{"order", {1, 2, 0}}}}}};
+  TestCodecRoundTrip(p);
+}
+
+TEST(TransposeTest, RoundTripElementSizes) {
+  for (auto dtype : {tensorstore::DataType(dtype_v<uint8_t>),
+                     tensorstore::DataType(dtype_v<uint32_t>),
+                     tensorstore::DataType(dtype_v<uint64_t>)}) {
+    SCOPED_TRACE(tensorstore::StrCat("dtype=", dtype));
+    CodecRoundTripTestParams p;
+    p.spec = {{{"name", "transpose"}, {"configuration", {{"order", {2, 1, 0}}}}}};
+    p.dtype = dtype;
+    TestCodecRoundTrip(p);
+  }
+}
+
 TEST(TransposeTest, RankMismatch) {
   ArrayCodecResolveParameters p;
   p.dtype = dtype_v<uint16_t>;
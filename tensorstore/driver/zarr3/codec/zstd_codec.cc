@@ -17,15 +17,19 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
+#include "riegeli/zstd/zstd_dictionary.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
 #include "tensorstore/driver/zarr3/codec/codec_spec.h"
 #include "tensorstore/driver/zarr3/codec/registry.h"
+#include "tensorstore/internal/compression/zstd_dictionary.h"
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
@@ -40,8 +44,12 @@ using ::riegeli::ZstdWriterBase;
 
 class ZstdCodec : public ZarrBytesToBytesCodec {
  public:
-  explicit ZstdCodec(int level, bool checksum)
-      : level_(level), checksum_(checksum) {}
+  explicit ZstdCodec(int level, bool checksum, const std::string& dictionary)
+      : level_(level),
+        checksum_(checksum),
+        has_dictionary_(!dictionary.empty()) {
+    if (has_dictionary_) dictionary_.set_automatic(dictionary);
+  }
 
   class State : public ZarrBytesToBytesCodec::PreparedState {
    public:
@@ -51,6 +59,9 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
       Writer::Options options;
       options.set_compression_level(level_);
       options.set_store_checksum(checksum_);
+      if (codec_->has_dictionary_) {
+        options.set_dictionary(codec_->dictionary_);
+      }
       if (decoded_size_ != -1) {
         options.set_pledged_size(decoded_size_);
       }
@@ -61,9 +72,13 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
         riegeli::Reader& encoded_reader) const final {
       using Reader = riegeli::ZstdReader<riegeli::Reader*>;
       Reader::Options options;
+      if (codec_->has_dictionary_) {
+        options.set_dictionary(codec_->dictionary_);
+      }
       return std::make_unique<Reader>(&encoded_reader, options);
     }
 
+    const ZstdCodec* codec_;
     int level_;
     bool checksum_;
     int64_t decoded_size_;
@@ -71,6 +86,7 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
 
   Result<PreparedState::Ptr> Prepare(int64_t decoded_size) const final {
     auto state = internal::MakeIntrusivePtr<State>();
+    state->codec_ = this;
     state->level_ = level_;
     state->checksum_ = checksum_;
     state->decoded_size_ = decoded_size;
@@ -80,6 +96,10 @@ class ZstdCodec : public ZarrBytesToBytesCodec {
  private:
   int level_;
   bool checksum_;
+  bool has_dictionary_;
+  // Shares the digested dictionary across all chunks encoded or decoded with
+  // this codec.
+  riegeli::ZstdDictionary dictionary_;
 };
 
 }  // namespace
@@ -91,6 +111,9 @@ absl::Status ZstdCodecSpec::MergeFrom(const ZarrCodecSpec& other, bool strict) {
       MergeConstraint<&Options::level>("level", options, other_options));
   TENSORSTORE_RETURN_IF_ERROR(
       MergeConstraint<&Options::checksum>("checksum", options, other_options));
+  TENSORSTORE_RETURN_IF_ERROR(MergeConstraint<&Options::dictionary>(
+      "dictionary", options, other_options,
+      internal::ZstdDictionaryJsonBinder));
   return absl::OkStatus();
 }
 
@@ -104,16 +127,17 @@ Result<ZarrBytesToBytesCodec::Ptr> ZstdCodecSpec::Resolve(
   auto resolved_level =
       options.level.value_or(ZstdWriterBase::Options::kDefaultCompressionLevel);
   auto resolved_checksum = options.checksum.value_or(false);
+  auto resolved_dictionary = options.dictionary.value_or(std::string());
   if (resolved_spec) {
-    if (options.level && options.checksum) {
+    if (options.level && options.checksum && options.dictionary) {
       resolved_spec->reset(this);
     } else {
-      resolved_spec->reset(
-          new ZstdCodecSpec(Options{resolved_level, resolved_checksum}));
+      resolved_spec->reset(new ZstdCodecSpec(
+          Options{resolved_level, resolved_checksum, resolved_dictionary}));
     }
   }
-  return internal::MakeIntrusivePtr<ZstdCodec>(resolved_level,
-                                               resolved_checksum);
+  return internal::MakeIntrusivePtr<ZstdCodec>(
+      resolved_level, resolved_checksum, resolved_dictionary);
 }
 
 TENSORSTORE_GLOBAL_INITIALIZER {
@@ -130,7 +154,11 @@ TENSORSTORE_GLOBAL_INITIALIZER {
                              ZstdWriterBase::Options::kMaxCompressionLevel)))),
           jb::Member("checksum",
                      jb::Projection<&Options::checksum>(
-                         OptionalIfConstraintsBinder())))  //
+                         OptionalIfConstraintsBinder())),
+          jb::Member("dictionary",
+                     jb::Projection<&Options::dictionary>(
+                         OptionalIfConstraintsBinder(
+                             internal::ZstdDictionaryJsonBinder))))  //
                                      ));
 }
 
@@ -16,6 +16,7 @@
 #define TENSORSTORE_DRIVER_ZARR3_CODEC_ZSTD_CODEC_H_
 
 #include <optional>
+#include <string>
 
 #include "absl/status/status.h"
 #include "tensorstore/driver/zarr3/codec/codec.h"
@@ -30,6 +31,9 @@ class ZstdCodecSpec : public ZarrBytesToBytesCodecSpec {
   struct Options {
     std::optional<int> level;
     std::optional<bool> checksum;
+    /// Dictionary in the zstd dictionary format or as raw content.  An empty
+    /// string indicates that no dictionary is used.
+    std::optional<std::string> dictionary;
   };
   ZstdCodecSpec() = default;
   explicit ZstdCodecSpec(const Options& options) : options(options) {}
@@ -67,4 +67,30 @@ TEST(ZstdTest, RoundTrip) {
   TestCodecRoundTrip(p);
 }
 
+// Base64 encoding of a raw content dictionary.
+constexpr char kTestDictionary[] =
+    "cmF3IGRpY3Rpb25hcnkgY29udGVudCBmb3IgenN0ZCBjb2RlYyB0ZXN0cw==";
+
+TEST(ZstdTest, Dictionary) {
+  CodecSpecRoundTripTestParams p;
+  p.orig_spec = {
+      {{"name", "zstd"},
+       {"configuration", {{"level", 7}, {"dictionary", kTestDictionary}}}},
+  };
+  p.expected_spec = {
+      GetDefaultBytesCodecJson(),
+      {{"name", "zstd"},
+       {"configuration",
+        {{"level", 7}, {"checksum", false}, {"dictionary", kTestDictionary}}}},
+  };
+  TestCodecSpecRoundTrip(p);
+}
+
+TEST(ZstdTest, RoundTripDictionary) {
+  CodecRoundTripTestParams p;
+  p.spec = {{{"name", "zstd"},
+             {"configuration", {{"dictionary", kTestDictionary}}}}};
+  TestCodecRoundTrip(p);
+}
+
 }  // namespace
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include "absl/status/status.h"
@@ -51,13 +52,17 @@
 #include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+#include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/lexicographical_grid_index_key.h"
 #include "tensorstore/internal/storage_statistics.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/open_mode.h"
 #include "tensorstore/open_options.h"
 #include "tensorstore/rank.h"
@@ -170,8 +175,8 @@ class ZarrDriverSpec
 
 Result<std::shared_ptr<const ZarrMetadata>> ParseEncodedMetadata(
     std::string_view encoded_value) {
-  nlohmann::json raw_data = nlohmann::json::parse(encoded_value, nullptr,
-                                                  /*allow_exceptions=*/false);
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
+  nlohmann::json raw_data = internal_json::ParseJson(encoded_value);
   if (raw_data.is_discarded()) {
     return absl::DataLossError("Invalid JSON");
   }
@@ -412,7 +417,25 @@ class ZarrDataCache : public ChunkCacheImpl, public DataCacheBase {
                          std::string key_prefix, U&&... arg)
       : ChunkCacheImpl(std::move(initializer.store), std::forward<U>(arg)...),
         DataCacheBase(std::move(initializer), std::move(key_prefix)),
-        grid_(DataCacheBase::GetChunkGridSpecification(metadata())) {}
+        grid_(DataCacheBase::GetChunkGridSpecification(metadata())) {
+    ChunkCacheImpl::SetCodecAccelerator(
+        DataCacheBase::metadata_cache()->codec_accelerator());
+    if constexpr (std::is_base_of_v<internal::KvsBackedChunkCache,
+                                    ChunkCacheImpl>) {
+      ChunkCacheImpl::SetChunkPresenceSummary(
+          initializer.chunk_presence_cache);
+    }
+  }
+
+  std::shared_ptr<internal::ChunkPresenceSummary> chunk_presence_summary()
+      const final {
+    if constexpr (std::is_base_of_v<internal::KvsBackedChunkCache,
+                                    ChunkCacheImpl>) {
+      return ChunkCacheImpl::chunk_presence_summary();
+    } else {
+      return nullptr;
+    }
+  }
 
   const internal::LexicographicalGridIndexKeyParser& GetChunkStorageKeyParser()
       final {
@@ -464,6 +487,8 @@ class ZarrDriver : public ZarrDriverBase {
   Future<ArrayStorageStatistics> GetStorageStatistics(
       GetStorageStatisticsRequest request) override;
 
+  Future<EncodedChunkStorage> GetEncodedChunkStorage() override;
+
   Result<CodecSpec> GetCodec() override {
     return GetCodecFromMetadata(metadata());
   }
@@ -478,7 +503,8 @@ class ZarrDriver : public ZarrDriverBase {
             AnyFlowReceiver<absl::Status, internal::ReadChunk, IndexTransform<>>
                 receiver) override {
     return cache()->zarr_chunk_cache().Read(
-        {std::move(request), GetCurrentDataStalenessBound()},
+        {std::move(request), GetCurrentDataStalenessBound(),
+         stale_while_revalidate()},
         std::move(receiver));
   }
 
@@ -532,6 +558,36 @@ Future<ArrayStorageStatistics> ZarrDriver::GetStorageStatistics(
   return future;
 }
 
+Future<internal::Driver::EncodedChunkStorage>
+ZarrDriver::GetEncodedChunkStorage() {
+  if (cache()->writeback_delay().enabled()) {
+    // Chunks with delayed writeback are not yet stored in the kvstore.
+    return absl::UnimplementedError(
+        "Encoded chunk storage not supported with delayed writeback");
+  }
+  return MapFutureValue(
+      InlineExecutor{},
+      [driver = internal::IntrusivePtr<ZarrDriver>(this),
+       staleness_bound = this->GetCurrentDataStalenessBound()](
+          const MetadataCache::MetadataPtr& metadata_ptr) {
+        const auto& metadata =
+            *static_cast<const ZarrMetadata*>(metadata_ptr.get());
+        EncodedChunkStorage storage;
+        storage.format =
+            tensorstore::StrCat("zarr3:", metadata.GetChunkEncodingKey());
+        storage.kvstore = kvstore::DriverPtr(
+            driver->cache()->zarr_chunk_cache().GetKvStoreDriver());
+        storage.staleness_bound = staleness_bound;
+        storage.bounds = Box<>(metadata.shape);
+        storage.chunk_shape = metadata.chunk_shape;
+        storage.get_chunk_key = [driver](span<const Index> cell_indices) {
+          return driver->cache()->GetChunkStorageKey(cell_indices);
+        };
+        return storage;
+      },
+      ResolveMetadata({}, metadata_staleness_bound_.time));
+}
+
 class ZarrDriver::OpenState : public ZarrDriver::OpenStateBase {
  public:
   using ZarrDriver::OpenStateBase::OpenStateBase;
@@ -26,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/array.h"
@@ -44,6 +45,7 @@
 #include "tensorstore/internal/global_initializer.h"
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/memory/memory_key_value_store.h"
@@ -51,11 +53,13 @@
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/open.h"
 #include "tensorstore/open_mode.h"
+#include "tensorstore/progress.h"
 #include "tensorstore/read_write_options.h"
 #include "tensorstore/schema.h"
 #include "tensorstore/spec.h"
 #include "tensorstore/staleness_bound.h"
 #include "tensorstore/tensorstore.h"
+#include "tensorstore/transaction.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
@@ -108,6 +112,56 @@ TEST(ZarrDriverTest, OpenNonExisting) {
                     "Metadata at \"prefix/zarr\\.json\" does not exist"));
 }
 
+TEST(ZarrDriverTest, IoStats) {
+  ::nlohmann::json json_spec{
+      {"driver", "zarr3"},
+      {"kvstore", {{"driver", "memory"}}},
+      {"cache_pool", {{"total_bytes_limit", 1000000}}},
+      {"recheck_cached_data", false},
+      {"metadata",
+       {
+           {"data_type", "uint16"},
+           {"shape", {4, 4}},
+           {"chunk_grid",
+            {{"name", "regular"},
+             {"configuration", {{"chunk_shape", {2, 4}}}}}},
+       }},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(json_spec, tensorstore::OpenMode::create).result());
+
+  // The first read misses the cache and reads both (missing) chunks.
+  auto read_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(tensorstore::Read(store, read_stats).result());
+  auto counters = read_stats.Get();
+  EXPECT_EQ(2, counters.kvstore_reads);
+  EXPECT_EQ(0, counters.bytes_read);
+  EXPECT_EQ(2, counters.cache_misses);
+  EXPECT_EQ(0, counters.cache_hits);
+
+  // The second read is satisfied by the cache.
+  auto reread_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(tensorstore::Read(store, reread_stats).result());
+  counters = reread_stats.Get();
+  EXPECT_EQ(0, counters.kvstore_reads);
+  EXPECT_EQ(2, counters.cache_hits);
+  EXPECT_EQ(0, counters.cache_misses);
+
+  // Writeback of each modified chunk is attributed to the write.
+  auto write_stats = tensorstore::IoStats::New();
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint16_t>(42), store,
+                         write_stats)
+          .commit_future.result());
+  counters = write_stats.Get();
+  EXPECT_EQ(2, counters.kvstore_writes);
+  // Two uncompressed 2x4 chunks of `uint16`.
+  EXPECT_EQ(32, counters.bytes_written);
+  EXPECT_EQ(counters.bytes_written, counters.bytes_encoded);
+  EXPECT_EQ(0, read_stats.Get().kvstore_writes);
+}
+
 TEST(ZarrDriverTest, ShardedTranspose) {
   std::vector<Index> shape{10, 11};
   auto array = tensorstore::AllocateArray<uint16_t>(shape);
@@ -1205,6 +1259,95 @@ TEST(ZarrDriverTest, ShardingBatchRead) {
   EXPECT_THAT(mock_kvstore->request_log.pop_all(), ::testing::SizeIs(4));
 }
 
+TEST(ZarrDriverTest, PartialChunkReadUsesByteRange) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_kvstore_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_kvstore = *mock_kvstore_resource;
+  mock_kvstore->forward_to = tensorstore::GetMemoryKeyValueStore();
+  mock_kvstore->log_requests = true;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(
+          {{"driver", "zarr3"},
+           {"kvstore", {{"driver", "mock_key_value_store"}}},
+           {"metadata",
+            {{"codecs",
+              {{{"name", "bytes"}, {"configuration", {{"endian", "little"}}}}}},
+             {"fill_value", 7}}}},
+          tensorstore::OpenMode::create, context, dtype_v<uint16_t>,
+          Schema::Shape({16, 32}), ChunkLayout::ReadChunkShape({16, 16}))
+          .result());
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      tensorstore::MakeScalarArray<uint16_t>(42),
+      store | tensorstore::Dims(1).HalfOpenInterval(0, 16)));
+  mock_kvstore->request_log.pop_all();
+
+  // Elements `[4 * 16 + 4, 5 * 16 + 6)` of the chunk span the region.
+  EXPECT_THAT(
+      tensorstore::Read(store |
+                        tensorstore::Dims(0, 1).SizedInterval({4, 4}, {2, 2}))
+          .result(),
+      ::testing::Optional(tensorstore::MakeArray<uint16_t>({{42, 42},
+                                                            {42, 42}})));
+  auto log = mock_kvstore->request_log.pop_all();
+  ASSERT_THAT(log, ::testing::SizeIs(1));
+  EXPECT_EQ("c/0/0", log[0].value("key", ""));
+  EXPECT_EQ(136, log[0].value("byte_range_inclusive_min", 0));
+  EXPECT_EQ(172, log[0].value("byte_range_exclusive_max", 0));
+
+  // Missing chunks are filled with the fill value.
+  EXPECT_THAT(
+      tensorstore::Read(store |
+                        tensorstore::Dims(0, 1).SizedInterval({4, 20}, {1, 2}))
+          .result(),
+      ::testing::Optional(tensorstore::MakeArray<uint16_t>({{7, 7}})));
+}
+
+TEST(ZarrDriverTest, OpenAllBatchesMetadataReads) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_kvstore_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto mock_kvstore = *mock_kvstore_resource;
+  mock_kvstore->forward_to = tensorstore::GetMemoryKeyValueStore();
+  mock_kvstore->log_requests = true;
+  mock_kvstore->handle_batch_requests = true;
+
+  std::vector<tensorstore::Spec> specs;
+  for (int i = 0; i < 3; ++i) {
+    ::nlohmann::json json_spec{
+        {"driver", "zarr3"},
+        {"kvstore",
+         {{"driver", "mock_key_value_store"},
+          {"path", absl::StrFormat("array%d/", i)}}}};
+    TENSORSTORE_ASSERT_OK(tensorstore::Open(json_spec,
+                                            tensorstore::OpenMode::create,
+                                            context, dtype_v<uint16_t>,
+                                            Schema::Shape({i + 1, 4}))
+                              .result());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto spec,
+                                     tensorstore::Spec::FromJson(json_spec));
+    specs.push_back(std::move(spec));
+  }
+  mock_kvstore->request_log.pop_all();
+
+  auto futures =
+      tensorstore::OpenAll(specs, context, tensorstore::OpenMode::open);
+  ASSERT_EQ(3, futures.size());
+  for (int i = 0; i < 3; ++i) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, futures[i].result());
+    EXPECT_THAT(store.domain().shape(), ::testing::ElementsAre(i + 1, 4));
+  }
+
+  auto log = mock_kvstore->request_log.pop_all();
+  ASSERT_THAT(log, ::testing::SizeIs(3));
+  for (const auto& entry : log) {
+    EXPECT_EQ("batch_read", entry.value("type", ""));
+  }
+}
+
 TEST(ZarrDriverTest, CodecLifetime) {
   tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
   tensorstore::Future<const void> future;
@@ -1260,6 +1403,64 @@ TEST(ZarrDriverTest, CanReferenceSourceDataIndefinitely) {
   }
 }
 
+TEST(ZarrDriverTest, CanTakeOwnershipOfSourceData) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr3"}, {"kvstore", "memory://"}},
+                        dtype_v<uint32_t>, Schema::Shape({128}),
+                        ChunkLayout::ChunkShape({64}),
+                        tensorstore::OpenMode::create)
+          .result());
+  auto array = tensorstore::AllocateArray<uint32_t>({128});
+  std::fill_n(array.data(), 128, 1);
+  const char* data = reinterpret_cast<const char*>(array.data());
+  // Each chunk adopts the corresponding sub-region of the source array.
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(
+      std::move(array), store, tensorstore::can_take_ownership_of_source_data));
+  for (int i = 0; i < 2; ++i) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto read_result,
+        tensorstore::kvstore::Read(store.kvstore(), absl::StrFormat("c/%d", i))
+            .result());
+    EXPECT_EQ(data + i * 64 * sizeof(uint32_t),
+              read_result.value.Flatten().data());
+  }
+}
+
+TEST(ZarrDriverTest, CanTakeOwnershipOfBroadcastSourceData) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open({{"driver", "zarr3"}, {"kvstore", "memory://"}},
+                        dtype_v<uint32_t>, Schema::Shape({128}),
+                        ChunkLayout::ChunkShape({64}),
+                        tensorstore::OpenMode::create)
+          .result());
+  // Every position of the broadcast source refers to the same element, which
+  // must not be modified in place by the subsequent partial write.
+  const Index shape[] = {128};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto source, tensorstore::BroadcastArray(
+                       tensorstore::MakeScalarArray<uint32_t>(1), shape));
+  auto transaction = tensorstore::Transaction(tensorstore::isolated);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto transactional_store,
+                                   store | transaction);
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(source, transactional_store,
+                         tensorstore::can_take_ownership_of_source_data)
+          .copy_future);
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(
+          tensorstore::MakeScalarArray<uint32_t>(2),
+          transactional_store | tensorstore::Dims(0).HalfOpenInterval(0, 10))
+          .copy_future);
+  TENSORSTORE_ASSERT_OK(transaction.CommitAsync().result());
+  auto expected = tensorstore::AllocateArray<uint32_t>({128});
+  std::fill_n(expected.data(), 128, 1);
+  std::fill_n(expected.data(), 10, 2);
+  EXPECT_THAT(tensorstore::Read(store).result(),
+              ::testing::Optional(expected));
+}
+
 TEST(ZarrDriverTest, CanReferenceSourceDataIndefinitelyWithCast) {
   // Dimension 0 is chunked with a size of 64.  Need chunk to be at least 256
   // bytes due to riegeli size limits for non copying cords.
@@ -1292,6 +1493,120 @@ TEST(ZarrDriverTest, CanReferenceSourceDataIndefinitelyWithCast) {
   }
 }
 
+TEST(ZarrDriverTest, CopyEncodedChunks) {
+  auto context = Context::Default();
+  auto open = [&](std::string path) {
+    return tensorstore::Open(
+               {{"driver", "zarr3"},
+                {"kvstore", {{"driver", "memory"}, {"path", path}}},
+                {"metadata",
+                 {
+                     {"data_type", "uint8"},
+                     {"shape", {10}},
+                     {"chunk_grid",
+                      {{"name", "regular"},
+                       {"configuration", {{"chunk_shape", {4}}}}}},
+                 }}},
+               context, tensorstore::OpenMode::create)
+        .result();
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto source, open("source/"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto target, open("target/"));
+
+  // Chunk 1 of the source is missing.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeArray<uint8_t>({1, 2, 3, 4}),
+                         source | tensorstore::Dims(0).SizedInterval(0, 4))
+          .result());
+  // Chunk 2 is stored with padding that differs from the fill value, which is
+  // only preserved if the encoded chunk is copied directly.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::kvstore::Write(source.kvstore(), "c/2",
+                                  absl::Cord("\x09\x0a\x63\x63"))
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Write(tensorstore::MakeScalarArray<uint8_t>(50), target)
+          .result());
+
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Copy(source | tensorstore::Dims(0).HalfOpenInterval(1, 10),
+                        target | tensorstore::Dims(0).HalfOpenInterval(1, 10))
+          .result());
+  EXPECT_THAT(tensorstore::Read(target).result(),
+              ::testing::Optional(tensorstore::MakeArray<uint8_t>(
+                  {50, 2, 3, 4, 0, 0, 0, 0, 9, 10})));
+
+  // Chunk 0 is only partially covered by the copy, and is re-encoded.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read_result,
+      tensorstore::kvstore::Read(target.kvstore(), "c/0").result());
+  EXPECT_EQ(absl::Cord("\x32\x02\x03\x04"), read_result.value);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      read_result,
+      tensorstore::kvstore::Read(target.kvstore(), "c/1").result());
+  EXPECT_TRUE(read_result.not_found());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      read_result,
+      tensorstore::kvstore::Read(target.kvstore(), "c/2").result());
+  EXPECT_EQ(absl::Cord("\x09\x0a\x63\x63"), read_result.value);
+}
+
+TEST(ZarrDriverTest, CopyWithMemoryLimit) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto source,
+      tensorstore::Open({{"driver", "zarr3"},
+                         {"kvstore", {{"driver", "memory"}, {"path", "a/"}}},
+                         {"schema",
+                          {{"chunk_layout", {{"chunk", {{"shape", {3, 3}}}}}},
+                           {"domain", {{"shape", {10, 6}}}},
+                           {"dtype", "uint8"}}}},
+                        context, tensorstore::OpenMode::create)
+          .result());
+  // Each write chunk (shard) of the target covers 4x6 elements.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto target,
+      tensorstore::Open({{"driver", "zarr3"},
+                         {"kvstore", {{"driver", "memory"}, {"path", "b/"}}},
+                         {"schema",
+                          {{"chunk_layout",
+                            {{"read_chunk", {{"shape", {2, 3}}}},
+                             {"write_chunk", {{"shape", {4, 6}}}}}},
+                           {"domain", {{"shape", {10, 6}}}},
+                           {"dtype", "uint16"}}}},
+                        context, tensorstore::OpenMode::create)
+          .result());
+  auto array = tensorstore::AllocateArray<uint8_t>({10, 6});
+  auto expected = tensorstore::AllocateArray<uint16_t>({10, 6});
+  for (Index i = 0; i < array.num_elements(); ++i) {
+    array.data()[i] = static_cast<uint8_t>(i);
+    expected.data()[i] = static_cast<uint16_t>(i);
+  }
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(array, source).result());
+
+  absl::Mutex mutex;
+  Index max_in_flight = 0;
+  Index committed = 0;
+  tensorstore::CopyProgressFunction progress_function{
+      [&](tensorstore::CopyProgress progress) {
+        absl::MutexLock lock(&mutex);
+        max_in_flight =
+            std::max(max_in_flight,
+                     progress.read_elements - progress.committed_elements);
+        committed = progress.committed_elements;
+      }};
+  // The limit only admits a single write chunk at a time.
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::Copy(source, target, tensorstore::CopyMemoryLimit{1},
+                        std::move(progress_function))
+          .commit_future.result());
+  EXPECT_THAT(tensorstore::Read(target).result(),
+              ::testing::Optional(expected));
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ(60, committed);
+  EXPECT_LE(max_in_flight, 24);
+}
+
 TEST(FullShardWriteTest, WithoutTransaction) {
   auto context = Context::Default();
 
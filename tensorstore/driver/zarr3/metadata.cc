@@ -475,6 +475,16 @@ std::string ZarrMetadata::GetCompatibilityKey() const {
       .dump();
 }
 
+std::string ZarrMetadata::GetChunkEncodingKey() const {
+  auto json = jb::ToJson(*this).value();
+  ::nlohmann::json::object_t key;
+  for (const char* member : {"data_type", "fill_value", "chunk_grid",
+                             "codecs"}) {
+    key[member] = std::move(json[member]);
+  }
+  return ::nlohmann::json(std::move(key)).dump();
+}
+
 absl::Status ValidateMetadata(ZarrMetadata& metadata) {
   if (!metadata.codecs) {
     ArrayCodecResolveParameters decoded;
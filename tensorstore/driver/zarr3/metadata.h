@@ -106,6 +106,11 @@ struct ZarrMetadata {
 
   std::string GetCompatibilityKey() const;
 
+  /// Returns a key that identifies the encoded representation of the chunks,
+  /// which depends only on the data type, fill value, chunk grid, and codecs.
+  /// Stored chunks of arrays with equal keys are interchangeable.
+  std::string GetChunkEncodingKey() const;
+
   ZarrCodecChain::Ptr codecs;
   ZarrCodecChain::PreparedState::Ptr codec_state;
 
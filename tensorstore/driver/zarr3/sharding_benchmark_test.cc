@@ -14,10 +14,10 @@
 
 // This benchmarks reading and writing 3-d volumes with the zarr3 driver.
 //
-// Both read and write benchmarks have 4 parameters:
+// Both read and write benchmarks have 5 parameters:
 //
-// BM_Read/<cache_pool_size>/<write_chunk_size>/<read_chunk_size>/<parallelism>
-// BM_Write/<cache_pool_size>/<write_chunk_size>/<read_chunk_size>/<parallelism>
+// BM_Read/<cache_pool_size>/<write_chunk_size>/<read_chunk_size>/<parallelism>/<data_copy_concurrency>
+// BM_Write/<cache_pool_size>/<write_chunk_size>/<read_chunk_size>/<parallelism>/<data_copy_concurrency>
 //
 // cache_pool_size:
 //
@@ -41,6 +41,13 @@
 //   Indicates that the first dimension of the array should be evenly split into
 //   `parallelism` partitions, and parallel read or write operations are issued
 //   separately for each partition.
+//
+// data_copy_concurrency:
+//
+//   Limit of the context "data_copy_concurrency" resource, or `0` to use the
+//   default shared limit.  Sub-chunks within a shard are encoded and decoded
+//   concurrently, subject to this limit, so varying it with a `parallelism` of
+//   1 and a single shard measures the intra-shard scaling.
 
 #include <stdint.h>
 
@@ -79,7 +86,8 @@ static constexpr Index kTotalSize = 1024;
 
 struct BenchmarkHelper {
   explicit BenchmarkHelper(int64_t cache_pool_size, Index total_size,
-                           Index write_chunk_size, Index read_chunk_size)
+                           Index write_chunk_size, Index read_chunk_size,
+                           int64_t data_copy_concurrency)
       : shape(3, total_size) {
     ::nlohmann::json json_spec{
         {"driver", "zarr3"},
@@ -88,6 +96,9 @@ struct BenchmarkHelper {
     if (cache_pool_size > 0) {
       json_spec["cache_pool"] = {{"total_bytes_limit", cache_pool_size}};
     }
+    if (data_copy_concurrency > 0) {
+      json_spec["data_copy_concurrency"] = {{"limit", data_copy_concurrency}};
+    }
 
     TENSORSTORE_CHECK_OK_AND_ASSIGN(spec, Spec::FromJson(json_spec));
     TENSORSTORE_CHECK_OK(
@@ -122,7 +133,7 @@ struct BenchmarkHelper {
 
 void BM_Write(benchmark::State& state) {
   BenchmarkHelper helper{state.range(0), kTotalSize, state.range(1),
-                         state.range(2)};
+                         state.range(2), state.range(4)};
   const int top_level_parallelism = state.range(3);
   for (auto s : state) {
     TENSORSTORE_CHECK_OK_AND_ASSIGN(auto store,
@@ -142,7 +153,7 @@ void BM_Write(benchmark::State& state) {
 
 void BM_Read(benchmark::State& state) {
   BenchmarkHelper helper{state.range(0), kTotalSize, state.range(1),
-                         state.range(2)};
+                         state.range(2), state.range(4)};
   const int top_level_parallelism = state.range(3);
   TENSORSTORE_CHECK_OK_AND_ASSIGN(auto store,
                                   tensorstore::Open(helper.spec).result());
@@ -165,15 +176,30 @@ void DefineArgs(Bench* bench) {
   for (int cache_pool_size : {0, 64 * 1024 * 1024}) {
     for (auto chunk_size : {16, 32, 64, 128}) {
       for (auto parallelism : {1, 8, 32}) {
-        bench->Args({cache_pool_size, chunk_size, chunk_size, parallelism});
-        bench->Args({cache_pool_size, 1024, chunk_size, parallelism});
+        bench->Args({cache_pool_size, chunk_size, chunk_size, parallelism, 0});
+        bench->Args({cache_pool_size, 1024, chunk_size, parallelism, 0});
       }
     }
   }
   bench->UseRealTime();
 }
 
+// Single shard containing the entire volume, accessed with a single
+// operation, such that all parallelism is within the shard.
+template <typename Bench>
+void DefineShardScalingArgs(Bench* bench) {
+  for (auto chunk_size : {32, 64, 128}) {
+    for (int data_copy_concurrency : {1, 2, 4, 8, 16}) {
+      bench->Args(
+          {64 * 1024 * 1024, 1024, chunk_size, 1, data_copy_concurrency});
+    }
+  }
+  bench->UseRealTime();
+}
+
 BENCHMARK(BM_Write)->Apply(DefineArgs);
 BENCHMARK(BM_Read)->Apply(DefineArgs);
+BENCHMARK(BM_Write)->Apply(DefineShardScalingArgs);
+BENCHMARK(BM_Read)->Apply(DefineShardScalingArgs);
 
 }  // namespace
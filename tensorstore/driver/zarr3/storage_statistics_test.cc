@@ -101,15 +101,12 @@ TEST_F(StorageStatisticsTest, FullyLexicographicOrder) {
                 ::testing::Optional(ArrayStorageStatistics{
                     /*.mask=*/ArrayStorageStatistics::query_not_stored,
                     /*.not_stored=*/false}));
+    // The first present chunk determines the result.
     EXPECT_THAT(mock_kvstore->request_log.pop_all(),
-                ::testing::UnorderedElementsAreArray({
+                ::testing::ElementsAre(
                     JsonSubValuesMatch({{"/type", "read"},
                                         {"/key", "c/0/0/0"},
-                                        {"/byte_range_exclusive_max", 0}}),
-                    JsonSubValuesMatch({{"/type", "read"},
-                                        {"/key", "c/1/0/0"},
-                                        {"/byte_range_exclusive_max", 0}}),
-                }));
+                                        {"/byte_range_exclusive_max", 0}})));
     EXPECT_THAT(tensorstore::GetStorageStatistics(
                     transformed, ArrayStorageStatistics::query_not_stored,
                     ArrayStorageStatistics::query_fully_stored)
@@ -14,6 +14,8 @@
 
 #include "tensorstore/index_space/index_transform.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
@@ -24,17 +26,21 @@
 #include <utility>
 
 #include "absl/status/status.h"
+#include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/container_kind.h"
+#include "tensorstore/contiguous_layout.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/dimension_identifier.h"
 #include "tensorstore/index_space/index_domain.h"
+#include "tensorstore/index_space/index_domain_builder.h"
+#include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/index_space/internal/transform_rep.h"
 #include "tensorstore/index_space/json.h"
 #include "tensorstore/index_space/output_index_method.h"
+#include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/rank.h"
-#include "tensorstore/serialization/json.h"
 #include "tensorstore/serialization/serialization.h"
 #include "tensorstore/util/dimension_set.h"
 #include "tensorstore/util/result.h"
@@ -652,21 +658,270 @@ Result<IndexTransform<>> ComposeOptionalTransforms(IndexTransform<> b_to_c,
 
 namespace internal_index_space {
 
+namespace {
+
+/// Version of the binary representation of non-null `IndexTransform` and
+/// `IndexDomain` values, encoded as the first byte.
+///
+/// Version 1 encodes all bounds, offsets, strides, and index array elements as
+/// variable-length integers.
+constexpr uint8_t kIndexTransformSerializationVersion = 1;
+
+using IndexVarintSerializer = serialization::VarintSerializer<Index>;
+using SizeVarintSerializer = serialization::VarintSerializer<uint64_t>;
+
+bool EncodeVersion(serialization::EncodeSink& sink) {
+  return sink.writer().WriteByte(kIndexTransformSerializationVersion);
+}
+
+bool DecodeVersion(serialization::DecodeSource& source) {
+  uint8_t version;
+  if (!source.reader().ReadByte(version)) return false;
+  if (version != kIndexTransformSerializationVersion) {
+    source.Fail(serialization::DecodeError(tensorstore::StrCat(
+        "Unsupported index transform serialization version: ",
+        static_cast<int>(version))));
+    return false;
+  }
+  return true;
+}
+
+bool DecodeRank(serialization::DecodeSource& source,
+                DimensionIndex rank_constraint, const char* kind,
+                DimensionIndex& rank) {
+  if (!serialization::RankSerializer::Decode(source, rank)) return false;
+  if (rank_constraint != dynamic_rank && rank != rank_constraint) {
+    source.Fail(serialization::DecodeError(tensorstore::StrCat(
+        "Expected ", kind, " rank of ", rank_constraint,
+        " but received: ", rank)));
+    return false;
+  }
+  return true;
+}
+
+bool EncodeDimensionSet(serialization::EncodeSink& sink, DimensionSet set) {
+  return SizeVarintSerializer::Encode(sink, set.to_uint());
+}
+
+bool DecodeDimensionSet(serialization::DecodeSource& source,
+                        DimensionIndex rank, DimensionSet& set) {
+  uint64_t bits;
+  if (!SizeVarintSerializer::Decode(source, bits)) return false;
+  if (rank < 64 && (bits >> rank) != 0) {
+    source.Fail(serialization::DecodeError(
+        tensorstore::StrCat("Invalid dimension set: ", bits)));
+    return false;
+  }
+  set = DimensionSet::FromUint(static_cast<DimensionSet::Uint>(bits));
+  return true;
+}
+
+// Encodes an interval as its inclusive lower bound and its size, which may be
+// infinite.
+bool EncodeInterval(serialization::EncodeSink& sink, IndexInterval interval) {
+  return IndexVarintSerializer::Encode(sink, interval.inclusive_min()) &&
+         SizeVarintSerializer::Encode(sink, interval.size());
+}
+
+bool DecodeInterval(serialization::DecodeSource& source, Index& origin,
+                    Index& size) {
+  uint64_t size_value;
+  if (!IndexVarintSerializer::Decode(source, origin) ||
+      !SizeVarintSerializer::Decode(source, size_value)) {
+    return false;
+  }
+  if (size_value > static_cast<uint64_t>(kInfSize)) {
+    source.Fail(serialization::DecodeError(
+        tensorstore::StrCat("Invalid interval size: ", size_value)));
+    return false;
+  }
+  size = static_cast<Index>(size_value);
+  return true;
+}
+
+// Encodes the domain, excluding the rank.
+bool EncodeDomain(serialization::EncodeSink& sink, IndexDomainView<> domain) {
+  const DimensionIndex rank = domain.rank();
+  DimensionSet labeled;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    labeled[i] = !domain.labels()[i].empty();
+  }
+  if (!EncodeDimensionSet(sink, domain.implicit_lower_bounds()) ||
+      !EncodeDimensionSet(sink, domain.implicit_upper_bounds()) ||
+      !EncodeDimensionSet(sink, labeled)) {
+    return false;
+  }
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (!EncodeInterval(sink, domain[i].interval())) return false;
+    if (labeled[i] && !serialization::Encode(sink, domain.labels()[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DecodeDomain(serialization::DecodeSource& source, span<Index> origin,
+                  span<Index> shape, span<std::string> labels,
+                  DimensionSet& implicit_lower_bounds,
+                  DimensionSet& implicit_upper_bounds) {
+  const DimensionIndex rank = origin.size();
+  DimensionSet labeled;
+  if (!DecodeDimensionSet(source, rank, implicit_lower_bounds) ||
+      !DecodeDimensionSet(source, rank, implicit_upper_bounds) ||
+      !DecodeDimensionSet(source, rank, labeled)) {
+    return false;
+  }
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (!DecodeInterval(source, origin[i], shape[i])) return false;
+    if (labeled[i] && !serialization::Decode(source, labels[i])) return false;
+  }
+  return true;
+}
+
+// Encodes the elements of an index array, excluding those repeated along
+// dimensions with a byte stride of 0.
+bool EncodeIndexArray(serialization::EncodeSink& sink,
+                      ArrayView<const Index, dynamic_rank, offset_origin> array,
+                      IndexInterval index_range) {
+  DimensionSet varying;
+  for (DimensionIndex i = 0; i < array.rank(); ++i) {
+    varying[i] = array.byte_strides()[i] != 0;
+  }
+  if (!EncodeInterval(sink, index_range) ||
+      !EncodeDimensionSet(sink, varying)) {
+    return false;
+  }
+  return IterateOverArrays(
+      [&](const Index* x) { return IndexVarintSerializer::Encode(sink, *x); },
+      {c_order, skip_repeated_elements}, array);
+}
+
+// Decodes an index array encoded by `EncodeIndexArray` over a domain with the
+// specified `input_shape`.
+bool DecodeIndexArray(serialization::DecodeSource& source,
+                      span<const Index> input_shape,
+                      SharedArray<const Index>& array,
+                      Result<IndexInterval>& index_range) {
+  const DimensionIndex rank = input_shape.size();
+  Index range_origin, range_size;
+  DimensionSet varying;
+  if (!DecodeInterval(source, range_origin, range_size) ||
+      !DecodeDimensionSet(source, rank, varying)) {
+    return false;
+  }
+  index_range = IndexInterval::Sized(range_origin, range_size);
+  Index shape[kMaxRank];
+  Index num_elements = 1;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    shape[i] = varying[i] ? input_shape[i] : 1;
+    if (internal::MulOverflow(num_elements, shape[i], &num_elements)) {
+      source.Fail(serialization::DecodeError("Invalid index array shape"));
+      return false;
+    }
+  }
+  auto decoded = AllocateArray<Index>(span<const Index>(shape, rank), c_order,
+                                      default_init);
+  Index* data = decoded.data();
+  for (Index i = 0; i < num_elements; ++i) {
+    if (!IndexVarintSerializer::Decode(source, data[i])) return false;
+  }
+  array = std::move(decoded);
+  return true;
+}
+
+}  // namespace
+
 bool IndexTransformNonNullSerializer::Encode(serialization::EncodeSink& sink,
                                              IndexTransformView<> value) {
-  return serialization::Encode(sink, ::nlohmann::json(value));
+  const DimensionIndex input_rank = value.input_rank();
+  const DimensionIndex output_rank = value.output_rank();
+  if (!EncodeVersion(sink) ||
+      !serialization::RankSerializer::Encode(sink, input_rank) ||
+      !serialization::RankSerializer::Encode(sink, output_rank) ||
+      !EncodeDomain(sink, value.domain())) {
+    return false;
+  }
+  for (DimensionIndex output_dim = 0; output_dim < output_rank; ++output_dim) {
+    const auto map = value.output_index_maps()[output_dim];
+    const auto method = map.method();
+    if (!sink.writer().WriteByte(static_cast<uint8_t>(method)) ||
+        !IndexVarintSerializer::Encode(sink, map.offset())) {
+      return false;
+    }
+    if (method == OutputIndexMethod::constant) continue;
+    if (!IndexVarintSerializer::Encode(sink, map.stride())) return false;
+    if (method == OutputIndexMethod::single_input_dimension) {
+      if (!serialization::RankSerializer::Encode(sink,
+                                                 map.input_dimension())) {
+        return false;
+      }
+    } else {
+      const auto index_array = map.index_array();
+      if (!EncodeIndexArray(sink, index_array.array_ref(),
+                            index_array.index_range())) {
+        return false;
+      }
+    }
+  }
+  return true;
 }
 
 bool IndexTransformNonNullSerializer::Decode(
     serialization::DecodeSource& source,
     internal_index_space::TransformRep::Ptr<>& value) const {
-  ::nlohmann::json json;
-  if (!serialization::Decode(source, json)) return false;
-  TENSORSTORE_ASSIGN_OR_RETURN(
-      value,
-      internal_index_space::ParseIndexTransformFromJson(
-          json, input_rank_constraint, output_rank_constraint),
-      (source.Fail(_), false));
+  DimensionIndex input_rank, output_rank;
+  if (!DecodeVersion(source) ||
+      !DecodeRank(source, input_rank_constraint, "input", input_rank) ||
+      !DecodeRank(source, output_rank_constraint, "output", output_rank)) {
+    return false;
+  }
+  IndexTransformBuilder<> builder(input_rank, output_rank);
+  if (!DecodeDomain(source, builder.input_origin(), builder.input_shape(),
+                    builder.input_labels(), builder.implicit_lower_bounds(),
+                    builder.implicit_upper_bounds())) {
+    return false;
+  }
+  for (DimensionIndex output_dim = 0; output_dim < output_rank; ++output_dim) {
+    uint8_t method;
+    Index offset, stride;
+    if (!source.reader().ReadByte(method) ||
+        !IndexVarintSerializer::Decode(source, offset)) {
+      return false;
+    }
+    switch (static_cast<OutputIndexMethod>(method)) {
+      case OutputIndexMethod::constant:
+        builder.output_constant(output_dim, offset);
+        continue;
+      case OutputIndexMethod::single_input_dimension: {
+        DimensionIndex input_dim;
+        if (!IndexVarintSerializer::Decode(source, stride) ||
+            !serialization::RankSerializer::Decode(source, input_dim)) {
+          return false;
+        }
+        builder.output_single_input_dimension(output_dim, offset, stride,
+                                              input_dim);
+        continue;
+      }
+      case OutputIndexMethod::array: {
+        SharedArray<const Index> index_array;
+        Result<IndexInterval> index_range;
+        if (!IndexVarintSerializer::Decode(source, stride) ||
+            !DecodeIndexArray(source, builder.input_shape(), index_array,
+                              index_range)) {
+          return false;
+        }
+        builder.output_index_array(output_dim, offset, stride, index_array,
+                                   std::move(index_range));
+        continue;
+      }
+    }
+    source.Fail(serialization::DecodeError(tensorstore::StrCat(
+        "Invalid output index method: ", static_cast<int>(method))));
+    return false;
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto transform, builder.Finalize(),
+                               (source.Fail(_), false));
+  value = TransformAccess::rep_ptr<container>(std::move(transform));
   return true;
 }
 
@@ -691,18 +946,28 @@ bool IndexTransformSerializer::Decode(
 
 bool IndexDomainNonNullSerializer::Encode(serialization::EncodeSink& sink,
                                           IndexDomainView<> value) {
-  return serialization::Encode(sink, ::nlohmann::json(value));
+  return EncodeVersion(sink) &&
+         serialization::RankSerializer::Encode(sink, value.rank()) &&
+         EncodeDomain(sink, value);
 }
 
 bool IndexDomainNonNullSerializer::Decode(
     serialization::DecodeSource& source,
     internal_index_space::TransformRep::Ptr<>& value) const {
-  ::nlohmann::json json;
-  if (!serialization::Decode(source, json)) return false;
-  TENSORSTORE_ASSIGN_OR_RETURN(
-      value,
-      internal_index_space::ParseIndexDomainFromJson(json, rank_constraint),
-      (source.Fail(_), false));
+  DimensionIndex rank;
+  if (!DecodeVersion(source) ||
+      !DecodeRank(source, rank_constraint, "domain", rank)) {
+    return false;
+  }
+  IndexDomainBuilder<> builder(rank);
+  if (!DecodeDomain(source, builder.origin(), builder.shape(),
+                    builder.labels(), builder.implicit_lower_bounds(),
+                    builder.implicit_upper_bounds())) {
+    return false;
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(auto domain, builder.Finalize(),
+                               (source.Fail(_), false));
+  value = TransformAccess::rep_ptr<container>(std::move(domain));
   return true;
 }
 
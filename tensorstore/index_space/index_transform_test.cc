@@ -33,6 +33,7 @@
 #include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/index_space/internal/transform_rep.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/serialization/batch.h"
 #include "tensorstore/serialization/serialization.h"
 #include "tensorstore/serialization/test_util.h"
 #include "tensorstore/static_cast.h"
@@ -73,6 +74,8 @@ using ::tensorstore::view;
 using ::tensorstore::internal::ComputeInputDimensionReferenceCounts;
 using ::tensorstore::internal::GetInputDimensionsForOutputDimension;
 using ::tensorstore::internal_index_space::TransformAccess;
+using ::tensorstore::serialization::DecodeBatch;
+using ::tensorstore::serialization::EncodeBatch;
 using ::tensorstore::serialization::TestSerializationRoundTrip;
 
 TEST(IndexTransformTest, Equality) {
@@ -1118,6 +1121,52 @@ TEST(IndexTransformSerializationTest, Basic) {
   TestSerializationRoundTrip(tensorstore::IdentityTransform(5));
 }
 
+TEST(IndexTransformSerializationTest, AllOutputIndexMethods) {
+  auto index_array =
+      MakeArray<Index>({{{1, -2, 3}, {4, 5, 6}, {7, 8, 9}, {10, 11, 12}}});
+  // Broadcast along the last input dimension.
+  auto broadcast_index_array = MakeArray<Index>({{{1}, {2}, {3}, {4}}});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto transform,
+      IndexTransformBuilder<>(3, 4)
+          .input_origin({-3, 2, -5})
+          .input_shape({10, 4, 3})
+          .implicit_lower_bounds({1, 0, 0})
+          .implicit_upper_bounds({0, 1, 0})
+          .input_labels({"x", "", "z"})
+          .output_constant(0, -100)
+          .output_single_input_dimension(1, 5, -2, 1)
+          .output_index_array(2, 3, 4, index_array,
+                              IndexInterval::Closed(-2, 12))
+          .output_index_array(3, 0, 1, broadcast_index_array)
+          .Finalize());
+  TestSerializationRoundTrip(transform);
+  TestSerializationRoundTrip(IndexDomain<>(transform.domain()));
+}
+
+TEST(IndexTransformSerializationTest, RankConstraint) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, EncodeBatch(IndexTransform<>(IdentityTransform(2))));
+  IndexTransform<3> transform;
+  EXPECT_THAT(DecodeBatch(encoded, transform),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Expected input rank of 3 but received: 2; .*"));
+}
+
+TEST(IndexTransformSerializationTest, UnsupportedVersion) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeBatch(IdentityTransform(2)));
+  // The first byte indicates that the transform is valid, and the second byte
+  // specifies the version.
+  ASSERT_GE(encoded.size(), 2);
+  encoded[1] = 2;
+  IndexTransform<> transform;
+  EXPECT_THAT(DecodeBatch(encoded, transform),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Unsupported index transform serialization "
+                            "version: 2; .*"));
+}
+
 TEST(IndexDomainSerializationTest, Basic) {
   TestSerializationRoundTrip(tensorstore::IndexDomain<>());
   TestSerializationRoundTrip(
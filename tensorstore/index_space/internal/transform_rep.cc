@@ -14,10 +14,13 @@
 
 #include "tensorstore/index_space/internal/transform_rep.h"
 
+#include <stdint.h>
+
 #include <memory>
 #include <new>
 #include <utility>
 
+#include "absl/base/config.h"
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
@@ -34,6 +37,94 @@ namespace tensorstore {
 namespace internal_index_space {
 
 namespace {
+
+#if !defined(ABSL_HAVE_ADDRESS_SANITIZER) && \
+    !defined(ABSL_HAVE_MEMORY_SANITIZER)
+#define TENSORSTORE_INTERNAL_POOL_TRANSFORM_REPS
+#endif
+
+#ifdef TENSORSTORE_INTERNAL_POOL_TRANSFORM_REPS
+
+// Freed `TransformRep` allocations are cached per thread, by input and output
+// rank capacity, to avoid a heap allocation for each index transform
+// operation.  Only small ranks, which account for nearly all transforms, are
+// cached.  The cache is disabled under sanitizers so that they continue to
+// detect use after free.
+constexpr DimensionIndex kMaxPooledRank = 8;
+constexpr int kMaxPooledBlocksPerSize = 4;
+
+struct PooledBlock {
+  PooledBlock* next;
+};
+
+// Trivially destructible, so that it remains usable by the destructors of
+// thread-local objects that run after `TransformRepPoolDrainer`.
+struct TransformRepPool {
+  PooledBlock* head[kMaxPooledRank + 1][kMaxPooledRank + 1];
+  int8_t count[kMaxPooledRank + 1][kMaxPooledRank + 1];
+  bool drained;
+};
+
+thread_local TransformRepPool transform_rep_pool;
+
+// Frees the blocks cached by the current thread when it exits.
+struct TransformRepPoolDrainer {
+  ~TransformRepPoolDrainer() {
+    auto& pool = transform_rep_pool;
+    pool.drained = true;
+    for (auto& heads : pool.head) {
+      for (PooledBlock*& head : heads) {
+        while (PooledBlock* block = head) {
+          head = block->next;
+          ::operator delete(static_cast<void*>(block));
+        }
+      }
+    }
+  }
+};
+
+thread_local TransformRepPoolDrainer transform_rep_pool_drainer;
+
+#endif  // TENSORSTORE_INTERNAL_POOL_TRANSFORM_REPS
+
+void* AllocateTransformRepBlock(DimensionIndex input_rank_capacity,
+                                DimensionIndex output_rank_capacity,
+                                size_t size) {
+#ifdef TENSORSTORE_INTERNAL_POOL_TRANSFORM_REPS
+  if (input_rank_capacity <= kMaxPooledRank &&
+      output_rank_capacity <= kMaxPooledRank) {
+    auto& pool = transform_rep_pool;
+    PooledBlock*& head = pool.head[input_rank_capacity][output_rank_capacity];
+    if (PooledBlock* block = head) {
+      head = block->next;
+      --pool.count[input_rank_capacity][output_rank_capacity];
+      return block;
+    }
+  }
+#endif
+  return ::operator new(size);
+}
+
+void FreeTransformRepBlock(void* ptr, DimensionIndex input_rank_capacity,
+                           DimensionIndex output_rank_capacity) {
+#ifdef TENSORSTORE_INTERNAL_POOL_TRANSFORM_REPS
+  if (input_rank_capacity <= kMaxPooledRank &&
+      output_rank_capacity <= kMaxPooledRank) {
+    auto& pool = transform_rep_pool;
+    auto& count = pool.count[input_rank_capacity][output_rank_capacity];
+    if (!pool.drained && count < kMaxPooledBlocksPerSize) {
+      // Ensures the cached blocks are freed when the thread exits.
+      [[maybe_unused]] auto& drainer = transform_rep_pool_drainer;
+      PooledBlock*& head = pool.head[input_rank_capacity][output_rank_capacity];
+      head = new (ptr) PooledBlock{head};
+      ++count;
+      return;
+    }
+  }
+#endif
+  ::operator delete(ptr);
+}
+
 void FreeIndexArrayData(IndexArrayData* data) {
   std::destroy_at(data);
   std::free(data);
@@ -148,7 +239,8 @@ TransformRep::Ptr<> TransformRep::Allocate(
       sizeof(OutputIndexMap) * output_rank_capacity +
       // size of input_origin, input_shape, and input_labels arrays
       input_rank_capacity * (sizeof(Index) * 2 + sizeof(std::string));
-  char* base_ptr = static_cast<char*>(::operator new(total_size));
+  char* base_ptr = static_cast<char*>(AllocateTransformRepBlock(
+      input_rank_capacity, output_rank_capacity, total_size));
   TransformRep* ptr =  // NOLINT
       new (base_ptr + sizeof(OutputIndexMap) * output_rank_capacity)
           TransformRep;
@@ -170,7 +262,8 @@ void TransformRep::Free(TransformRep* ptr) {
   assert(ptr->reference_count == 0);
   DestroyLabelFields(ptr);
   std::destroy_n(ptr->output_index_maps().begin(), ptr->output_rank_capacity);
-  ::operator delete(static_cast<void*>(ptr->output_index_maps().data()));
+  FreeTransformRepBlock(static_cast<void*>(ptr->output_index_maps().data()),
+                        ptr->input_rank_capacity, ptr->output_rank_capacity);
 }
 
 void CopyTransformRep(TransformRep* source, TransformRep* dest) {
@@ -0,0 +1,189 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// Benchmarks of index transform construction, composition, inversion and
+/// bounds propagation, which are performed for every read and write.
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/status.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::DimensionIndex;
+using ::tensorstore::DimensionSet;
+using ::tensorstore::Dims;
+using ::tensorstore::Index;
+using ::tensorstore::IndexTransform;
+using ::tensorstore::IndexTransformBuilder;
+
+constexpr Index kExtent = 100;
+
+// Returns a strided, translated transform of the specified `rank` with
+// dimensions in reverse order.
+IndexTransform<> MakeStridedTransform(DimensionIndex rank) {
+  IndexTransformBuilder<> builder(rank, rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    builder.input_origin()[i] = i;
+    builder.input_shape()[i] = kExtent;
+    builder.output_single_input_dimension(i, 3 * i, 2, rank - 1 - i);
+  }
+  return builder.Finalize().value();
+}
+
+// Returns a transform of the specified `rank` where output dimension 0 is
+// mapped using an index array over input dimension 0, and the remaining
+// output dimensions are mapped to the corresponding input dimensions.
+IndexTransform<> MakeIndexArrayTransform(DimensionIndex rank) {
+  std::vector<Index> index_array_shape(rank, 1);
+  index_array_shape[0] = kExtent;
+  auto index_array = tensorstore::AllocateArray<Index>(index_array_shape);
+  for (Index i = 0; i < kExtent; ++i) {
+    index_array.data()[i] = (i * 7) % kExtent;
+  }
+  IndexTransformBuilder<> builder(rank, rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    builder.input_origin()[i] = 0;
+    builder.input_shape()[i] = kExtent;
+    if (i == 0) {
+      builder.output_index_array(0, 0, 1, index_array);
+    } else {
+      builder.output_single_input_dimension(i, i);
+    }
+  }
+  return builder.Finalize().value();
+}
+
+void BM_IdentityTransform(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(tensorstore::IdentityTransform(rank));
+  }
+}
+
+void BM_BuildTransform(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(MakeStridedTransform(rank));
+  }
+}
+
+void BM_ComposeTransforms(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto a_to_b = MakeStridedTransform(rank);
+  auto b_to_c = MakeStridedTransform(rank);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        tensorstore::ComposeTransforms(b_to_c, a_to_b).value());
+  }
+}
+
+void BM_ComposeTransformsIndexArray(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto a_to_b = MakeIndexArrayTransform(rank);
+  auto b_to_c = MakeIndexArrayTransform(rank);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        tensorstore::ComposeTransforms(b_to_c, a_to_b).value());
+  }
+}
+
+void BM_InverseTransform(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  // Only transforms with unit strides are invertible.
+  IndexTransformBuilder<> builder(rank, rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    builder.input_origin()[i] = i;
+    builder.input_shape()[i] = kExtent;
+    builder.output_single_input_dimension(i, 3 * i, 1, rank - 1 - i);
+  }
+  auto transform = builder.Finalize().value();
+  for (auto s : state) {
+    benchmark::DoNotOptimize(tensorstore::InverseTransform(transform).value());
+  }
+}
+
+void BM_PropagateBounds(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto transform = MakeStridedTransform(rank);
+  Box<> b_domain(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    b_domain[i] = tensorstore::IndexInterval::UncheckedSized(0, 4 * kExtent);
+  }
+  Box<> a_domain(rank);
+  for (auto s : state) {
+    TENSORSTORE_CHECK_OK(tensorstore::PropagateBounds(
+        b_domain, DimensionSet(), DimensionSet(), transform, a_domain));
+    benchmark::DoNotOptimize(a_domain.origin().data());
+  }
+}
+
+void BM_PropagateBoundsToTransform(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto transform = MakeStridedTransform(rank);
+  Box<> b_domain(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    b_domain[i] = tensorstore::IndexInterval::UncheckedSized(0, 4 * kExtent);
+  }
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        tensorstore::PropagateBoundsToTransform(b_domain, DimensionSet(),
+                                                DimensionSet(), transform)
+            .value());
+  }
+}
+
+// Applies a translate, interval slice and transpose to a shared transform,
+// which requires a copy for each operation.
+void BM_DimExpression(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto transform = MakeStridedTransform(rank);
+  for (auto s : state) {
+    benchmark::DoNotOptimize((transform | Dims(0).TranslateBy(5) |
+                              Dims(0).HalfOpenInterval(10, 50) |
+                              Dims(0).MoveToBack())
+                                 .value());
+  }
+}
+
+void BM_IndexArraySlice(benchmark::State& state) {
+  const DimensionIndex rank = state.range(0);
+  auto transform = MakeStridedTransform(rank);
+  auto index_array = tensorstore::MakeArray<Index>({1, 5, 9, 13, 17});
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        Dims(0).OuterIndexArraySlice(index_array)(transform).value());
+  }
+}
+
+BENCHMARK(BM_IdentityTransform)->DenseRange(1, 8);
+BENCHMARK(BM_BuildTransform)->DenseRange(1, 8);
+BENCHMARK(BM_ComposeTransforms)->DenseRange(1, 8);
+BENCHMARK(BM_ComposeTransformsIndexArray)->DenseRange(1, 8);
+BENCHMARK(BM_InverseTransform)->DenseRange(1, 8);
+BENCHMARK(BM_PropagateBounds)->DenseRange(1, 8);
+BENCHMARK(BM_PropagateBoundsToTransform)->DenseRange(1, 8);
+BENCHMARK(BM_DimExpression)->DenseRange(1, 8);
+BENCHMARK(BM_IndexArraySlice)->DenseRange(1, 8);
+
+}  // namespace
@@ -188,6 +188,20 @@ TEST(Allocate, Basic) {
   EXPECT_TRUE(ptr->input_labels()[2].empty());
 }
 
+TEST(Allocate, ReusesFreedAllocation) {
+  {
+    auto ptr = TransformRep::Allocate(3, 2);
+    ptr->input_labels()[0] = "x";
+    ptr->output_index_maps()[0].SetSingleInputDimension(0);
+  }
+  // A freed allocation may be reused, but is reinitialized.
+  auto ptr = TransformRep::Allocate(3, 2);
+  EXPECT_EQ(3, ptr->input_rank_capacity);
+  EXPECT_EQ(2, ptr->output_rank_capacity);
+  EXPECT_EQ(OutputIndexMethod::constant, ptr->output_index_maps()[0].method());
+  EXPECT_TRUE(ptr->input_labels()[0].empty());
+}
+
 TEST(CopyTransformRep, Basic) {
   auto source = TransformRep::Allocate(1, 2);
   source->input_rank = 1;
@@ -76,9 +76,10 @@ SharedArrayView<const void> AsyncWriteArray::Spec::GetFillValueForDomain(
                           overall_fill_value.byte_strides().data()));
 }
 
-Result<NDIterable::Ptr> AsyncWriteArray::Spec::GetReadNDIterable(
+Result<TransformedSharedArray<const void>>
+AsyncWriteArray::Spec::GetReadTransformedArray(
     SharedArrayView<const void> array, BoxView<> domain,
-    IndexTransform<> chunk_transform, Arena* arena) const {
+    IndexTransform<> chunk_transform) const {
   if (!array.valid()) array = GetFillValueForDomain(domain);
   assert(internal::RangesEqual(array.shape(), domain.shape()));
   StridedLayoutView<dynamic_rank, offset_origin> data_layout(
@@ -86,11 +87,20 @@ Result<NDIterable::Ptr> AsyncWriteArray::Spec::GetReadNDIterable(
   TENSORSTORE_ASSIGN_OR_RETURN(
       chunk_transform,
       ComposeLayoutAndTransform(data_layout, std::move(chunk_transform)));
-  return GetTransformedArrayNDIterable(
-      {AddByteOffset(std::move(array.element_pointer()),
-                     -data_layout.origin_byte_offset()),
-       std::move(chunk_transform)},
-      arena);
+  return TransformedSharedArray<const void>(
+      AddByteOffset(std::move(array.element_pointer()),
+                    -data_layout.origin_byte_offset()),
+      std::move(chunk_transform));
+}
+
+Result<NDIterable::Ptr> AsyncWriteArray::Spec::GetReadNDIterable(
+    SharedArrayView<const void> array, BoxView<> domain,
+    IndexTransform<> chunk_transform, Arena* arena) const {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto transformed_array,
+      GetReadTransformedArray(std::move(array), domain,
+                              std::move(chunk_transform)));
+  return GetTransformedArrayNDIterable(std::move(transformed_array), arena);
 }
 
 AsyncWriteArray::MaskedArray::MaskedArray(DimensionIndex rank) : mask(rank) {}
@@ -326,6 +336,43 @@ Result<NDIterable::Ptr> AsyncWriteArray::GetReadNDIterable(
 }
 
 namespace {
+// Returns `true` if no two positions of an array with the specified `shape`
+// and `byte_strides` refer to overlapping elements of size `element_size`.
+//
+// This is a conservative check: it requires that the dimensions, ordered by
+// the magnitude of their byte strides, are nested without interleaving.
+bool HasNonOverlappingElements(span<const Index> shape,
+                               span<const Index> byte_strides,
+                               Index element_size) {
+  DimensionIndex dims[kMaxRank];
+  DimensionIndex num_dims = 0;
+  for (DimensionIndex i = 0; i < shape.size(); ++i) {
+    if (shape[i] == 0) return true;
+    if (shape[i] == 1) continue;
+    if (byte_strides[i] == 0) return false;
+    dims[num_dims++] = i;
+  }
+  const auto abs_stride = [&](DimensionIndex i) {
+    return byte_strides[i] < 0 ? -byte_strides[i] : byte_strides[i];
+  };
+  std::sort(dims, dims + num_dims, [&](DimensionIndex a, DimensionIndex b) {
+    return abs_stride(a) < abs_stride(b);
+  });
+  // Number of bytes spanned by the dimensions considered so far.
+  Index extent = element_size;
+  for (DimensionIndex j = 0; j < num_dims; ++j) {
+    const DimensionIndex i = dims[j];
+    const Index stride = abs_stride(i);
+    if (stride < extent) return false;
+    Index dim_extent;
+    if (internal::MulOverflow(stride, shape[i] - 1, &dim_extent) ||
+        internal::AddOverflow(extent, dim_extent, &extent)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Zero-copies `source_array` into
 // `write_state transformed by `chunk_transform`.
 //
@@ -458,7 +505,13 @@ bool ZeroCopyToWriteArray(
     case WriteArraySourceCapabilities::kCannotRetain:
       ABSL_UNREACHABLE();
     case WriteArraySourceCapabilities::kMutable:
-      write_state.array_capabilities = MaskedArray::kMutableArray;
+      // A source whose positions alias, as with a broadcast array, must not be
+      // modified in place by a subsequent partial write.
+      write_state.array_capabilities =
+          HasNonOverlappingElements(new_array.shape(), new_array.byte_strides(),
+                                    spec.dtype()->size)
+              ? MaskedArray::kMutableArray
+              : MaskedArray::kImmutableAndCanRetainUntilCommit;
       break;
     case WriteArraySourceCapabilities::kImmutableAndCanRetainIndefinitely:
       write_state.array_capabilities =
@@ -473,6 +526,94 @@ bool ZeroCopyToWriteArray(
   return true;
 }
 
+// Returns `true` if every position of `source_array` refers to the same
+// element, as when writing a scalar or a broadcast array.
+bool IsConstantSourceArray(
+    const TransformedSharedArray<const void>& source_array) {
+  IndexTransformView<> source_transform = source_array.transform();
+  for (DimensionIndex output_dim = 0;
+       output_dim < source_transform.output_rank(); ++output_dim) {
+    auto map = source_transform.output_index_map(output_dim);
+    switch (map.method()) {
+      case OutputIndexMethod::constant:
+        break;
+      case OutputIndexMethod::single_input_dimension:
+        if (map.stride() != 0 &&
+            source_transform.input_shape()[map.input_dimension()] != 1) {
+          return false;
+        }
+        break;
+      case OutputIndexMethod::array:
+        return false;
+    }
+  }
+  return true;
+}
+
+// Writes the single element referenced by `source_array`, which must satisfy
+// `IsConstantSourceArray`, to every position of `write_state`.
+//
+// If the element equals the fill value, the array is marked as overwritten by
+// the fill value and no data is retained.  Otherwise, unless `source_array`
+// may be referenced directly, just the single element is copied and
+// represented as a broadcast array with zero byte strides.  The array is only
+// materialized densely if it is subsequently partially written
+// (`EnsureWritable`).
+//
+// Returns: `true` if `write_state` was updated, `false` if the source array
+// should instead be referenced via `ZeroCopyToWriteArray`.
+bool WriteConstantToWriteArray(
+    const AsyncWriteArray::Spec& spec, BoxView<> domain,
+    const TransformedSharedArray<const void>& source_array,
+    AsyncWriteArray::WriteArraySourceCapabilities source_capabilities,
+    AsyncWriteArray::MaskedArray& write_state) {
+  const DimensionIndex rank = domain.rank();
+  IndexTransformView<> source_transform = source_array.transform();
+  Index source_offset = 0;
+  for (DimensionIndex output_dim = 0;
+       output_dim < source_transform.output_rank(); ++output_dim) {
+    auto map = source_transform.output_index_map(output_dim);
+    source_offset =
+        internal::wrap_on_overflow::Add(source_offset, map.offset());
+    if (map.method() == OutputIndexMethod::single_input_dimension) {
+      source_offset = internal::wrap_on_overflow::Add(
+          source_offset,
+          internal::wrap_on_overflow::Multiply(
+              map.stride(),
+              source_transform.input_origin()[map.input_dimension()]));
+    }
+  }
+  const Index zero_byte_strides[kMaxRank] = {};
+  ArrayView<const void> broadcast_source(
+      AddByteOffset(ElementPointer<const void>(
+                        source_array.element_pointer().data(), spec.dtype()),
+                    source_offset),
+      StridedLayoutView<>(rank, domain.shape().data(), zero_byte_strides));
+  if (!spec.store_if_equal_to_fill_value &&
+      AreArraysEqual(broadcast_source, spec.GetFillValueForDomain(domain),
+                     spec.fill_value_comparison_kind)) {
+    write_state.WriteFillValue(spec, domain);
+    return true;
+  }
+  if (source_capabilities !=
+      AsyncWriteArray::WriteArraySourceCapabilities::kCannotRetain) {
+    return false;
+  }
+  auto element = tensorstore::AllocateArray(span<const Index>(), c_order,
+                                            default_init, spec.dtype());
+  CopyArray(ArrayView<const void>(broadcast_source.element_pointer()),
+            element);
+  write_state.array.element_pointer() = std::move(element.element_pointer());
+  write_state.array.layout() =
+      StridedLayoutView<>(rank, domain.shape().data(), zero_byte_strides);
+  write_state.array_capabilities =
+      AsyncWriteArray::MaskedArray::kImmutableAndCanRetainIndefinitely;
+  write_state.mask.Reset();
+  write_state.mask.num_masked_elements = domain.num_elements();
+  write_state.mask.region = domain;
+  return true;
+}
+
 }  // namespace
 
 absl::Status AsyncWriteArray::WriteArray(
@@ -498,6 +639,11 @@ absl::Status AsyncWriteArray::WriteArray(
   TENSORSTORE_ASSIGN_OR_RETURN(auto source_array_info, get_source_array());
 
   auto source_capabilities = std::get<1>(source_array_info);
+  if (IsConstantSourceArray(std::get<0>(source_array_info)) &&
+      WriteConstantToWriteArray(spec, domain, std::get<0>(source_array_info),
+                                source_capabilities, write_state)) {
+    return absl::OkStatus();
+  }
   if (source_capabilities == WriteArraySourceCapabilities::kCannotRetain) {
     TENSORSTORE_ASSIGN_OR_RETURN(
         auto dest_transformed_array,
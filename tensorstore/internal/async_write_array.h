@@ -115,6 +115,12 @@ struct AsyncWriteArray {
                                               IndexTransform<> chunk_transform,
                                               Arena* arena) const;
 
+    /// Same as `GetReadNDIterable`, but returns a view that references
+    /// `array` directly.
+    Result<TransformedSharedArray<const void>> GetReadTransformedArray(
+        SharedArrayView<const void> array, BoxView<> domain,
+        IndexTransform<> chunk_transform) const;
+
     size_t EstimateReadStateSizeInBytes(bool valid,
                                         span<const Index> shape) const {
       if (!valid) return 0;
@@ -339,6 +345,13 @@ struct AsyncWriteArray {
   /// Assigns this array from an existing source array, potentially without
   /// actually copying the data.
   ///
+  /// If every position of the source array refers to the same element (e.g.
+  /// when writing a scalar), only that single element is retained, as a
+  /// broadcast array with zero byte strides; a dense array is allocated only
+  /// if the array is later partially overwritten.  If the element is equal to
+  /// the fill value (and `spec.store_if_equal_to_fill_value == false`), this
+  /// is equivalent to `WriteFillValue` and no data is retained at all.
+  ///
   /// \param spec The associated `Spec`.
   /// \param domain The associated domain of the array.
   /// \param chunk_transform Transform to use for writing, the output rank
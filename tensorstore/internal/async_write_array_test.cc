@@ -35,6 +35,7 @@
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
 #include "tensorstore/index_space/index_transform_testutil.h"
 #include "tensorstore/index_space/transformed_array.h"
 #include "tensorstore/internal/arena.h"
@@ -763,6 +764,90 @@ TEST(WriteArrayIdentityTransformSuccessTest, kMutable) {
       /*zero_copy=*/true);
 }
 
+// Returns a source array in which every position refers to the same element.
+tensorstore::TransformedSharedArray<const void> MakeConstantSourceArray(
+    int32_t value, span<const Index> shape) {
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto transform,
+      tensorstore::IndexTransformBuilder<>(shape.size(), 0)
+          .input_shape(shape)
+          .Finalize());
+  return {MakeScalarArray<int32_t>(value).element_pointer(),
+          std::move(transform)};
+}
+
+TEST(WriteArrayConstantTest, StoresSingleElement) {
+  AsyncWriteArray async_write_array(2);
+  const Box<> domain({2, 3});
+  auto fill_value =
+      tensorstore::AllocateArray<int32_t>({2, 3}, tensorstore::c_order,
+                                          tensorstore::value_init);
+  Spec spec{fill_value, Box<>(2)};
+  auto chunk_transform = tensorstore::IdentityTransform(domain);
+  TENSORSTORE_ASSERT_OK(async_write_array.WriteArray(
+      spec, domain, chunk_transform, [&] {
+        return std::pair{MakeConstantSourceArray(5, domain.shape()),
+                         WriteArraySourceCapabilities::kCannotRetain};
+      }));
+  auto& write_state = async_write_array.write_state;
+  EXPECT_THAT(write_state.array.byte_strides(), ::testing::ElementsAre(0, 0));
+  EXPECT_EQ(sizeof(int32_t),
+            write_state.EstimateSizeInBytes(spec, domain.shape()));
+  EXPECT_TRUE(write_state.IsFullyOverwritten(spec, domain));
+  {
+    auto writeback_data = async_write_array.GetArrayForWriteback(
+        spec, domain, /*read_array=*/{},
+        /*read_generation=*/StorageGeneration::Invalid());
+    EXPECT_TRUE(writeback_data.must_store);
+    EXPECT_TRUE(writeback_data.may_retain_reference_to_array_indefinitely);
+    EXPECT_EQ(MakeArray<int32_t>({{5, 5, 5}, {5, 5, 5}}),
+              writeback_data.array);
+  }
+
+  // A subsequent partial write materializes the array.
+  TestWrite(&async_write_array, spec, domain,
+            MakeOffsetArray<int32_t>({0, 1}, {{7}}));
+  EXPECT_EQ(MaskedArray::kMutableArray, write_state.array_capabilities);
+  EXPECT_EQ(6 * sizeof(int32_t),
+            write_state.EstimateSizeInBytes(spec, domain.shape()));
+  {
+    auto writeback_data = async_write_array.GetArrayForWriteback(
+        spec, domain, /*read_array=*/{},
+        /*read_generation=*/StorageGeneration::Invalid());
+    EXPECT_TRUE(writeback_data.must_store);
+    EXPECT_EQ(MakeArray<int32_t>({{5, 7, 5}, {5, 5, 5}}),
+              writeback_data.array);
+  }
+}
+
+TEST(WriteArrayConstantTest, FillValueNotAllocated) {
+  AsyncWriteArray async_write_array(2);
+  const Box<> domain({2, 3});
+  auto fill_value =
+      tensorstore::AllocateArray<int32_t>({2, 3}, tensorstore::c_order,
+                                          tensorstore::value_init);
+  Spec spec{fill_value, Box<>(2)};
+  auto chunk_transform = tensorstore::IdentityTransform(domain);
+  for (auto source_capabilities :
+       {WriteArraySourceCapabilities::kCannotRetain,
+        WriteArraySourceCapabilities::kImmutableAndCanRetainIndefinitely}) {
+    TENSORSTORE_ASSERT_OK(async_write_array.WriteArray(
+        spec, domain, chunk_transform, [&] {
+          return std::pair{MakeConstantSourceArray(0, domain.shape()),
+                           source_capabilities};
+        }));
+    auto& write_state = async_write_array.write_state;
+    EXPECT_FALSE(write_state.array.valid());
+    EXPECT_TRUE(write_state.IsFullyOverwritten(spec, domain));
+    EXPECT_EQ(0, write_state.EstimateSizeInBytes(spec, domain.shape()));
+    auto writeback_data = async_write_array.GetArrayForWriteback(
+        spec, domain,
+        /*read_array=*/MakeArray<int32_t>({{1, 2, 3}, {4, 5, 6}}),
+        /*read_generation=*/StorageGeneration::FromString("g"));
+    EXPECT_FALSE(writeback_data.must_store);
+  }
+}
+
 TEST(WriteArrayNonIdentityTransformSuccess, kMutable) {
   std::minstd_rand gen{tensorstore::internal_testing::GetRandomSeedForTest(
       "TENSORSTORE_INTERNAL_ASYNC_WRITE_ARRAY")};
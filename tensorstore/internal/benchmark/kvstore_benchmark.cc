@@ -65,6 +65,7 @@ bazel run -c opt \
 #include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/functional/bind_front.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/random/random.h"
@@ -77,6 +78,7 @@ bazel run -c opt \
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "absl/flags/parse.h"
+#include "tensorstore/internal/benchmark/load_utils.h"
 #include "tensorstore/internal/benchmark/metric_utils.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/metrics/registry.h"
@@ -179,6 +181,13 @@ void PerOperationMetricCollection(::nlohmann::json* all_metrics,
   }
 }
 
+// Appends the latency percentiles of run `id` to `all_metrics`.
+void AppendLatencyMetrics(::nlohmann::json* all_metrics, std::string id,
+                          const internal::LatencyHistogram& latency) {
+  all_metrics->emplace_back(::nlohmann::json{
+      {"name", "/latency"}, {"values", {id, latency.ToJson()}}});
+}
+
 void MaybeCleanExisting(Context context, kvstore::Spec kvstore_spec) {
   // When set, delete the kvstore. For ocdbt, delete everything at "base".
   if (!absl::GetFlag(FLAGS_clean_before_write)) {
@@ -246,6 +255,8 @@ Prepared DoWriteBenchmark(Context context, kvstore::Spec kvstore_spec,
   std::cout << "Starting write benchmark. chunk_size=" << data.size()
             << ", keys=" << result.keys.size() << std::endl;
 
+  internal::LatencyHistogram write_latency;
+
   // Repeat the benchmark `--repeat_writes` time using the same source arrays.
   for (int64_t i = 0, num_repeats = absl::GetFlag(FLAGS_repeat_writes);
        i < num_repeats; ++i) {
@@ -258,14 +269,16 @@ Prepared DoWriteBenchmark(Context context, kvstore::Spec kvstore_spec,
     std::shuffle(result.keys.begin(), result.keys.end(), gen);
 
     // Perform the actual write.
+    write_latency.Reset();
     auto start_time = absl::Now();
     std::atomic<size_t> files_written = 0;
     std::atomic<size_t> bytes_written = 0;
 
     auto value_lambda =
         [&, sz = data.size()](
-            Promise<void> a_promise,
+            absl::Time issue_time, Promise<void> a_promise,
             ReadyFuture<TimestampedStorageGeneration> a_future) {
+          write_latency.Record(absl::Now() - issue_time);
           files_written.fetch_add(1);
           bytes_written.fetch_add(sz);
         };
@@ -274,7 +287,8 @@ Prepared DoWriteBenchmark(Context context, kvstore::Spec kvstore_spec,
     auto [promise, future] = PromiseFuturePair<void>::Make(absl::OkStatus());
     for (const auto& key : result.keys) {
       if (promise.ready()) break;
-      LinkValue(value_lambda, promise, kvstore::Write(kvstore, key, data, {}));
+      LinkValue(absl::bind_front(value_lambda, absl::Now()), promise,
+                kvstore::Write(kvstore, key, data, {}));
     }
 
     // Wait until all writes are complete.
@@ -292,7 +306,10 @@ Prepared DoWriteBenchmark(Context context, kvstore::Spec kvstore_spec,
                                  bytes_written.load(), elapsed_s * 1e3,
                                  throughput)
               << std::endl;
+    std::cout << "Write latency: " << write_latency.Summary() << std::endl;
 
+    AppendLatencyMetrics(all_metrics, absl::StrFormat("write_%03d", i),
+                         write_latency);
     PerOperationMetricCollection(all_metrics, absl::StrFormat("write_%03d", i));
   }
 
@@ -324,6 +341,7 @@ void DoReadBenchmark(Context context, kvstore::Spec kvstore_spec,
     }
   }
   absl::InsecureBitGen gen;
+  internal::LatencyHistogram read_latency;
 
   // Repeat the benchmark `--repeat_reads` times using the same source arrays.
   for (int64_t i = 0, num_repeats = absl::GetFlag(FLAGS_repeat_reads);
@@ -338,12 +356,14 @@ void DoReadBenchmark(Context context, kvstore::Spec kvstore_spec,
     std::shuffle(input.keys.begin(), input.keys.end(), gen);
 
     // Perform the actual read.
+    read_latency.Reset();
     auto start_time = absl::Now();
     std::atomic<size_t> bytes_read = 0;
     std::atomic<size_t> files_read = 0;
 
-    auto value_lambda = [&](Promise<void> a_promise,
+    auto value_lambda = [&](absl::Time issue_time, Promise<void> a_promise,
                             ReadyFuture<kvstore::ReadResult> a_future) {
+      read_latency.Record(absl::Now() - issue_time);
       files_read.fetch_add(1);
       if (a_future.result().ok()) {
         bytes_read.fetch_add(a_future.result()->value.size());
@@ -356,7 +376,8 @@ void DoReadBenchmark(Context context, kvstore::Spec kvstore_spec,
          j < std::max(size_t{1}, absl::GetFlag(FLAGS_read_blowup)); j++) {
       for (const auto& key : input.keys) {
         if (promise.ready()) break;
-        LinkValue(value_lambda, promise, kvstore::Read(kvstore, key));
+        LinkValue(absl::bind_front(value_lambda, absl::Now()), promise,
+                  kvstore::Read(kvstore, key));
       }
     }
 
@@ -373,9 +394,12 @@ void DoReadBenchmark(Context context, kvstore::Spec kvstore_spec,
               << absl::StrFormat("%d bytes in %.0f ms:  %.3f MB/second",
                                  bytes_read.load(), elapsed_s * 1e3, throughput)
               << std::endl;
+    std::cout << "Read latency: " << read_latency.Summary() << std::endl;
 
     read_throughput.Set(throughput);
 
+    AppendLatencyMetrics(all_metrics, absl::StrFormat("read_%03d", i),
+                         read_latency);
     PerOperationMetricCollection(all_metrics, absl::StrFormat("read_%03d", i));
   }
 }
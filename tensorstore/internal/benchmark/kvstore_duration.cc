@@ -15,11 +15,25 @@
 /// \file kvstore_duration attempts to run a kvstore with a number of parallel
 /// requests over a specific duration.
 ///
+/// By default the benchmark is closed-loop: `--parallelism` operations are
+/// kept in flight, and each completion issues the next operation.  When
+/// `--target_qps` is set, operations are instead issued at a constant arrival
+/// rate regardless of completions, and latency is measured from the scheduled
+/// issue time, so that a slow kvstore cannot hide queueing delay
+/// (coordinated omission).
+///
 /* Examples
 
 bazel run -c opt \
   //tensorstore/internal/benchmark:kvstore_duration -- \
   --kvstore_spec='"file:///tmp/kvstore"' --duration=1m
+
+# Open-loop, 500 ops/second, 10% writes, Zipf-distributed keys.
+
+bazel run -c opt \
+  //tensorstore/internal/benchmark:kvstore_duration -- \
+  --kvstore_spec='"file:///tmp/kvstore"' --duration=1m \
+  --target_qps=500 --write_fraction=0.1 --key_distribution=zipf
 */
 
 #include <stddef.h>
@@ -28,6 +42,7 @@ bazel run -c opt \
 #include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -39,6 +54,7 @@ bazel run -c opt \
 #include "absl/log/absl_log.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -47,11 +63,13 @@ bazel run -c opt \
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "absl/flags/parse.h"
+#include "tensorstore/internal/benchmark/load_utils.h"
 #include "tensorstore/internal/benchmark/metric_utils.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/metrics/value.h"
 #include "tensorstore/internal/path.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
@@ -74,8 +92,30 @@ ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::Context::Spec>, context_spec,
 
 ABSL_FLAG(absl::Duration, duration, absl::Seconds(20), "Duration of read loop");
 
-ABSL_FLAG(size_t, parallelism, 100, "Read parallelism");
-ABSL_FLAG(size_t, max_reads, 1000000, "Maximum read operations");
+ABSL_FLAG(size_t, parallelism, 100,
+          "Number of operations kept in flight when --target_qps is 0.");
+ABSL_FLAG(size_t, max_reads, 1000000, "Maximum read and write operations");
+
+ABSL_FLAG(double, target_qps, 0,
+          "When non-zero, issue operations at this constant rate (open-loop) "
+          "rather than keeping --parallelism operations in flight.");
+
+ABSL_FLAG(double, write_fraction, 0,
+          "Fraction of operations which overwrite an existing key with "
+          "--write_size random bytes.");
+
+ABSL_FLAG(size_t, write_size, 1024 * 1024, "Size of each written value.");
+
+ABSL_FLAG(std::string, key_distribution, "uniform",
+          "Key access pattern: sequential, uniform or zipf.");
+
+ABSL_FLAG(double, zipf_exponent, 1.2,
+          "Exponent of the zipf key distribution; must be greater than 1.");
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<tensorstore::kvstore::Spec>,
+          metric_kvstore_spec, {},
+          "KvStore spec for writing the latency and metric data in json.  When "
+          "unset, the json is written to stdout.");
 
 namespace tensorstore {
 namespace {
@@ -84,113 +124,232 @@ auto& read_throughput = internal_metrics::Value<double>::New(
     "/tensorstore/kvstore_benchmark/read_throughput",
     internal_metrics::MetricMetadata("the read throughput in this test"));
 
-struct ReadState : public internal::AtomicReferenceCount<ReadState> {
+auto& write_throughput = internal_metrics::Value<double>::New(
+    "/tensorstore/kvstore_benchmark/write_throughput",
+    internal_metrics::MetricMetadata("the write throughput in this test"));
+
+struct LoadState : public internal::AtomicReferenceCount<LoadState> {
   std::vector<std::string> keys;
   tensorstore::KvStore kvstore;
+  absl::Cord write_value;
+  double write_fraction = 0;
+  bool closed_loop = true;
+  std::unique_ptr<internal::KeyChooser> key_chooser;
   absl::Time start_time;
   absl::Time end_time;
   absl::InsecureBitGen gen;
   std::atomic<int64_t> bytes_read{0};
-  std::atomic<size_t> files_read{0};
+  std::atomic<int64_t> bytes_written{0};
+  std::atomic<size_t> ops_started{0};
+  internal::LatencyHistogram read_latency;
+  internal::LatencyHistogram write_latency;
   absl::Mutex mu;
 
-  // Record metrics from prior read.
-  void RecordMetrics(Result<kvstore::ReadResult> result);
+  // Returns true once the duration or operation limit has been reached.
+  bool Done() const;
 
-  // Start another read.
-  void StartNextRead(tensorstore::Promise<void> promise);
+  // Starts an operation which was scheduled to start at `scheduled_time`; in
+  // closed-loop mode, its completion starts the next operation.
+  void StartOperation(tensorstore::Promise<void> promise,
+                      absl::Time scheduled_time);
 
   // Output elapsed stats.
   void OutputElapsed();
+
+  ::nlohmann::json ToJson() const;
 };
 
-void ReadState::RecordMetrics(Result<kvstore::ReadResult> result) {
-  files_read.fetch_add(1);
-  if (!result.ok()) return;
-  bytes_read.fetch_add(result->value.size());
+bool LoadState::Done() const {
+  return absl::Now() > end_time ||
+         ops_started.load() >= absl::GetFlag(FLAGS_max_reads);
 }
 
-void ReadState::StartNextRead(tensorstore::Promise<void> promise) {
-  if (absl::Now() > end_time) return;
-  if (files_read.load() >= absl::GetFlag(FLAGS_max_reads)) return;
+void LoadState::StartOperation(tensorstore::Promise<void> promise,
+                               absl::Time scheduled_time) {
+  ops_started.fetch_add(1);
 
-  // Start next read. This maintains a consistent N reads in flight
-  // until the test has completed.
   std::string_view key;
+  bool is_write;
   {
     absl::MutexLock l(&mu);
-    key = keys[absl::Uniform(gen, 0u, keys.size())];
+    key = keys[key_chooser->Next(gen)];
+    is_write = write_fraction > 0 && absl::Bernoulli(gen, write_fraction);
+  }
+
+  auto on_done = [self = internal::IntrusivePtr<LoadState>{this}](
+                     tensorstore::Promise<void> promise) {
+    if (self->closed_loop && !self->Done()) {
+      self->StartOperation(std::move(promise), absl::Now());
+    }
+  };
+
+  if (is_write) {
+    LinkValue(
+        [self = internal::IntrusivePtr<LoadState>{this}, scheduled_time,
+         on_done](tensorstore::Promise<void> promise,
+                  tensorstore::Future<TimestampedStorageGeneration> future) {
+          self->write_latency.Record(absl::Now() - scheduled_time);
+          self->bytes_written.fetch_add(self->write_value.size());
+          on_done(std::move(promise));
+        },
+        std::move(promise), kvstore::Write(kvstore, key, write_value));
+    return;
   }
 
   LinkValue(
-      [self = internal::IntrusivePtr<ReadState>{this}](
-          tensorstore::Promise<void> promise,
-          tensorstore::Future<kvstore::ReadResult> future) {
-        self->RecordMetrics(future.result());
-        self->StartNextRead(std::move(promise));
+      [self = internal::IntrusivePtr<LoadState>{this}, scheduled_time,
+       on_done](tensorstore::Promise<void> promise,
+                tensorstore::Future<kvstore::ReadResult> future) {
+        self->read_latency.Record(absl::Now() - scheduled_time);
+        self->bytes_read.fetch_add(future.value().value.size());
+        on_done(std::move(promise));
       },
       std::move(promise), kvstore::Read(kvstore, key));
 }
 
-void ReadState::OutputElapsed() {
-  auto bytes = bytes_read.load();
-  auto files = files_read.load();
+void LoadState::OutputElapsed() {
   auto elapsed_s =
       absl::FDivDuration(absl::Now() - start_time, absl::Seconds(1));
-  double read_mb = static_cast<double>(bytes) / 1e6;
-
-  double throughput = read_mb / elapsed_s;
-  std::cout << "Read: "
-            << absl::StrFormat("%d bytes in %.0f ms:  %.3f MB/second (%d ops)",
-                               bytes, elapsed_s * 1e3, throughput, files)
-            << std::endl;
-  read_throughput.Set(throughput);
+  auto output = [&](std::string_view op, int64_t bytes,
+                    const internal::LatencyHistogram& latency,
+                    auto& throughput_metric) {
+    if (latency.count() == 0) return;
+    double throughput = static_cast<double>(bytes) / 1e6 / elapsed_s;
+    std::cout << op << ": "
+              << absl::StrFormat("%d bytes in %.0f ms:  %.3f MB/second (%s)",
+                                 bytes, elapsed_s * 1e3, throughput,
+                                 latency.Summary())
+              << std::endl;
+    throughput_metric.Set(throughput);
+  };
+  output("Read", bytes_read.load(), read_latency, read_throughput);
+  output("Write", bytes_written.load(), write_latency, write_throughput);
+}
+
+::nlohmann::json LoadState::ToJson() const {
+  ::nlohmann::json json_metrics = ::nlohmann::json::array();
+  json_metrics.emplace_back(
+      ::nlohmann::json{{"name", "/kvstore_spec"},
+                       {"values", {absl::GetFlag(FLAGS_kvstore_spec).value}}});
+  json_metrics.emplace_back(::nlohmann::json{
+      {"name", "/target_qps"}, {"values", {absl::GetFlag(FLAGS_target_qps)}}});
+  json_metrics.emplace_back(
+      ::nlohmann::json{{"name", "/parallelism"},
+                       {"values", {absl::GetFlag(FLAGS_parallelism)}}});
+  json_metrics.emplace_back(
+      ::nlohmann::json{{"name", "/write_fraction"},
+                       {"values", {absl::GetFlag(FLAGS_write_fraction)}}});
+  json_metrics.emplace_back(
+      ::nlohmann::json{{"name", "/key_distribution"},
+                       {"values", {absl::GetFlag(FLAGS_key_distribution)}}});
+  json_metrics.emplace_back(::nlohmann::json{
+      {"name", "/elapsed_s"},
+      {"values",
+       {absl::FDivDuration(absl::Now() - start_time, absl::Seconds(1))}}});
+  json_metrics.emplace_back(::nlohmann::json{
+      {"name", "/read_latency"}, {"values", {read_latency.ToJson()}}});
+  json_metrics.emplace_back(::nlohmann::json{
+      {"name", "/write_latency"}, {"values", {write_latency.ToJson()}}});
+  return json_metrics;
+}
+
+// Issues operations at `--target_qps` until the benchmark is done.  Latency is
+// measured from each operation's scheduled time rather than its actual issue
+// time, so delays in issuing operations are also accounted for.
+void RunOpenLoop(LoadState& state, tensorstore::Promise<void> promise) {
+  const absl::Duration interval =
+      absl::Seconds(1) / absl::GetFlag(FLAGS_target_qps);
+  for (int64_t i = 0;; ++i) {
+    absl::Time scheduled_time = state.start_time + i * interval;
+    if (scheduled_time > state.end_time || state.Done()) break;
+    absl::SleepFor(scheduled_time - absl::Now());
+    state.StartOperation(promise, scheduled_time);
+  }
 }
 
 void DoDurationBenchmark(Context context, kvstore::Spec kvstore_spec) {
-  std::cout << "Starting read duration benchmark for "
-            << absl::GetFlag(FLAGS_duration) << " with parallelism "
-            << absl::GetFlag(FLAGS_parallelism) << ", reading at most "
-            << absl::GetFlag(FLAGS_max_reads) << " reads" << std::endl;
+  const double target_qps = absl::GetFlag(FLAGS_target_qps);
+  if (target_qps > 0) {
+    std::cout << "Starting open-loop duration benchmark for "
+              << absl::GetFlag(FLAGS_duration) << " at " << target_qps
+              << " operations/second";
+  } else {
+    std::cout << "Starting duration benchmark for "
+              << absl::GetFlag(FLAGS_duration) << " with parallelism "
+              << absl::GetFlag(FLAGS_parallelism);
+  }
+  std::cout << ", performing at most " << absl::GetFlag(FLAGS_max_reads)
+            << " operations" << std::endl;
 
-  auto read_state = internal::MakeIntrusivePtr<ReadState>();
+  auto state = internal::MakeIntrusivePtr<LoadState>();
+  state->closed_loop = !(target_qps > 0);
+  state->write_fraction = absl::GetFlag(FLAGS_write_fraction);
 
   TENSORSTORE_CHECK_OK_AND_ASSIGN(
-      read_state->kvstore, kvstore::Open(kvstore_spec, context).result());
+      state->kvstore, kvstore::Open(kvstore_spec, context).result());
 
   TENSORSTORE_CHECK_OK_AND_ASSIGN(
-      auto entries, kvstore::ListFuture(read_state->kvstore).result());
+      auto entries, kvstore::ListFuture(state->kvstore).result());
   ABSL_LOG(INFO) << "Read " << entries.size() << " keys from kvstore";
   ABSL_CHECK(!entries.empty());
 
-  read_state->keys.reserve(entries.size());
+  state->keys.reserve(entries.size());
   for (auto& entry : entries) {
-    read_state->keys.push_back(std::move(entry.key));
+    state->keys.push_back(std::move(entry.key));
   }
 
-  auto pair = PromiseFuturePair<void>::Make(absl::OkStatus());
-  read_state->start_time = absl::Now();
-  read_state->end_time = read_state->start_time + absl::GetFlag(FLAGS_duration);
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto distribution,
+      internal::ParseKeyDistribution(absl::GetFlag(FLAGS_key_distribution)));
+  state->key_chooser = std::make_unique<internal::KeyChooser>(
+      state->keys.size(), distribution, absl::GetFlag(FLAGS_zipf_exponent));
+
+  if (state->write_fraction > 0) {
+    std::string value(absl::GetFlag(FLAGS_write_size), '\0');
+    for (size_t i = 0; i < value.size(); ++i) {
+      value[i] = absl::Uniform<unsigned char>(state->gen);
+    }
+    state->write_value = absl::Cord(std::move(value));
+  }
 
-  for (size_t i = 0; i < absl::GetFlag(FLAGS_parallelism); i++) {
-    read_state->StartNextRead(pair.promise);
+  auto pair = PromiseFuturePair<void>::Make(absl::OkStatus());
+  state->start_time = absl::Now();
+  state->end_time = state->start_time + absl::GetFlag(FLAGS_duration);
+
+  if (state->closed_loop) {
+    for (size_t i = 0; i < absl::GetFlag(FLAGS_parallelism); i++) {
+      state->StartOperation(pair.promise, absl::Now());
+    }
+  } else {
+    RunOpenLoop(*state, pair.promise);
   }
 
-  // Wait until all reads are complete.
+  // Wait until all operations are complete.
   pair.promise = {};
   pair.future.Force();
   while (!pair.future.WaitFor(absl::Seconds(10))) {
-    read_state->OutputElapsed();
+    state->OutputElapsed();
   }
   TENSORSTORE_CHECK_OK(pair.future.result());
   std::cout << "Done" << std::endl;
-  read_state->OutputElapsed();
+  state->OutputElapsed();
+
+  auto json_metrics = state->ToJson();
+  auto written = internal::WriteMetricCollectionToKvstore(
+      json_metrics, absl::GetFlag(FLAGS_metric_kvstore_spec).value);
+  if (!written.ok()) {
+    std::cout << json_metrics.dump() << std::endl;
+  }
 }
 
 void Run() {
   ABSL_CHECK(absl::GetFlag(FLAGS_duration) > absl::ZeroDuration());
   ABSL_CHECK(absl::GetFlag(FLAGS_duration) != absl::InfiniteDuration());
   ABSL_CHECK(absl::GetFlag(FLAGS_parallelism) > 0);
+  ABSL_CHECK(absl::GetFlag(FLAGS_target_qps) >= 0);
+  ABSL_CHECK(absl::GetFlag(FLAGS_write_fraction) >= 0 &&
+             absl::GetFlag(FLAGS_write_fraction) <= 1);
+  ABSL_CHECK(absl::GetFlag(FLAGS_zipf_exponent) > 1);
 
   auto kvstore_spec = absl::GetFlag(FLAGS_kvstore_spec).value;
   internal::EnsureDirectoryPath(kvstore_spec.path);
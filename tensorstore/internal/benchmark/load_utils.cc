@@ -0,0 +1,151 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/benchmark/load_utils.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <string_view>
+
+#include "absl/numeric/bits.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/random/distributions.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+size_t LatencyHistogram::BucketForValue(uint64_t value) {
+  if (value < 2 * kSubBuckets) return value;
+  int shift = absl::bit_width(value) - (kSubBucketBits + 1);
+  return (shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+  if (bucket < 2 * kSubBuckets) return bucket;
+  int shift = bucket / kSubBuckets - 1;
+  uint64_t mantissa = kSubBuckets + bucket % kSubBuckets;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(absl::Duration latency) {
+  int64_t ns = std::max<int64_t>(0, absl::ToInt64Nanoseconds(latency));
+  buckets_[BucketForValue(ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+  int64_t max = max_.load(std::memory_order_relaxed);
+  while (ns > max &&
+         !max_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+absl::Duration LatencyHistogram::Mean() const {
+  int64_t n = count();
+  if (n == 0) return absl::ZeroDuration();
+  return absl::Nanoseconds(sum_.load(std::memory_order_relaxed) / n);
+}
+
+absl::Duration LatencyHistogram::Max() const {
+  return absl::Nanoseconds(max_.load(std::memory_order_relaxed));
+}
+
+absl::Duration LatencyHistogram::Percentile(double fraction) const {
+  // Use the bucket counts, rather than `count_`, so that the result is
+  // consistent with the buckets even while values are being recorded.
+  int64_t total = 0;
+  for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+  if (total == 0) return absl::ZeroDuration();
+  int64_t target = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) *
+                                        static_cast<double>(total))));
+  int64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= target) {
+      return std::min(absl::Nanoseconds(BucketUpperBound(i)), Max());
+    }
+  }
+  return Max();
+}
+
+::nlohmann::json LatencyHistogram::ToJson() const {
+  auto us = [](absl::Duration d) { return absl::ToDoubleMicroseconds(d); };
+  return ::nlohmann::json{
+      {"count", count()},
+      {"mean_us", us(Mean())},
+      {"max_us", us(Max())},
+      {"p50_us", us(Percentile(0.5))},
+      {"p90_us", us(Percentile(0.9))},
+      {"p99_us", us(Percentile(0.99))},
+      {"p999_us", us(Percentile(0.999))},
+  };
+}
+
+std::string LatencyHistogram::Summary() const {
+  auto ms = [](absl::Duration d) { return absl::ToDoubleMilliseconds(d); };
+  return absl::StrFormat(
+      "%d ops, mean=%.3fms p50=%.3fms p90=%.3fms p99=%.3fms p99.9=%.3fms "
+      "max=%.3fms",
+      count(), ms(Mean()), ms(Percentile(0.5)), ms(Percentile(0.9)),
+      ms(Percentile(0.99)), ms(Percentile(0.999)), ms(Max()));
+}
+
+Result<KeyDistribution> ParseKeyDistribution(std::string_view name) {
+  if (name == "sequential") return KeyDistribution::kSequential;
+  if (name == "uniform") return KeyDistribution::kUniform;
+  if (name == "zipf") return KeyDistribution::kZipf;
+  return absl::InvalidArgumentError(
+      absl::StrCat("Invalid key distribution: ", name,
+                   "; expected \"sequential\", \"uniform\" or \"zipf\""));
+}
+
+KeyChooser::KeyChooser(size_t num_keys, KeyDistribution distribution,
+                       double zipf_exponent)
+    : num_keys_(std::max<size_t>(1, num_keys)),
+      distribution_(distribution),
+      zipf_exponent_(zipf_exponent) {}
+
+size_t KeyChooser::Next(absl::BitGenRef gen) {
+  if (num_keys_ == 1) return 0;
+  switch (distribution_) {
+    case KeyDistribution::kSequential:
+      return next_.fetch_add(1, std::memory_order_relaxed) % num_keys_;
+    case KeyDistribution::kUniform:
+      return absl::Uniform<size_t>(gen, 0, num_keys_);
+    case KeyDistribution::kZipf:
+      return absl::Zipf<size_t>(gen, num_keys_ - 1, zipf_exponent_);
+  }
+  return 0;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
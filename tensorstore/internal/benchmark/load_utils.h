@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_BENCHMARK_LOAD_UTILS_H_
+#define TENSORSTORE_INTERNAL_BENCHMARK_LOAD_UTILS_H_
+
+/// \file
+///
+/// Latency recording and key selection shared by the kvstore benchmarks.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "absl/random/bit_gen_ref.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Thread-safe latency histogram with log-linear (HDR-style) buckets.
+///
+/// Values are recorded in nanoseconds; each power-of-two range is divided into
+/// 128 linear sub-buckets, so reported percentiles are within 1% of the
+/// recorded value.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Record(absl::Duration latency);
+
+  /// Clears all recorded values.
+  void Reset();
+
+  int64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  absl::Duration Mean() const;
+  absl::Duration Max() const;
+
+  /// Returns the smallest bucket upper bound below which at least `fraction`
+  /// of the recorded values lie, or `absl::ZeroDuration()` if empty.
+  absl::Duration Percentile(double fraction) const;
+
+  /// Returns the count, mean, max and p50/p90/p99/p99.9 latencies, in
+  /// microseconds.
+  ::nlohmann::json ToJson() const;
+
+  /// Returns a single-line human-readable summary.
+  std::string Summary() const;
+
+ private:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  static constexpr size_t kNumBuckets = (64 - kSubBucketBits) * kSubBuckets;
+
+  static size_t BucketForValue(uint64_t value);
+  static uint64_t BucketUpperBound(size_t bucket);
+
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sum_{0};
+  std::atomic<int64_t> max_{0};
+  std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+};
+
+/// Order in which benchmark operations choose among `n` keys.
+enum class KeyDistribution {
+  /// Keys are visited in order, wrapping around.
+  kSequential,
+  /// Keys are chosen uniformly at random.
+  kUniform,
+  /// Keys are chosen from a Zipf distribution, so that low-numbered keys are
+  /// accessed far more frequently than others.
+  kZipf,
+};
+
+/// Parses "sequential", "uniform" or "zipf".
+Result<KeyDistribution> ParseKeyDistribution(std::string_view name);
+
+/// Chooses key indices in `[0, num_keys)` according to a `KeyDistribution`.
+class KeyChooser {
+ public:
+  /// \param zipf_exponent Exponent of the Zipf distribution; must be greater
+  ///     than 1.  Ignored for other distributions.
+  KeyChooser(size_t num_keys, KeyDistribution distribution,
+             double zipf_exponent = 1.2);
+
+  /// Returns the next key index.  Thread-safe if `gen` is not shared.
+  size_t Next(absl::BitGenRef gen);
+
+ private:
+  size_t num_keys_;
+  KeyDistribution distribution_;
+  double zipf_exponent_;
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_BENCHMARK_LOAD_UTILS_H_
@@ -0,0 +1,104 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/benchmark/load_utils.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/random/random.h"
+#include "absl/time/time.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::internal::KeyChooser;
+using ::tensorstore::internal::KeyDistribution;
+using ::tensorstore::internal::LatencyHistogram;
+using ::tensorstore::internal::ParseKeyDistribution;
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.count());
+  EXPECT_EQ(absl::ZeroDuration(), histogram.Mean());
+  EXPECT_EQ(absl::ZeroDuration(), histogram.Percentile(0.99));
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.Record(absl::Microseconds(i));
+  }
+  EXPECT_EQ(1000, histogram.count());
+  EXPECT_EQ(absl::Microseconds(1000), histogram.Max());
+  EXPECT_NEAR(500.5, absl::ToDoubleMicroseconds(histogram.Mean()), 0.01);
+  // Buckets have a relative width below 1%.
+  EXPECT_NEAR(500, absl::ToDoubleMicroseconds(histogram.Percentile(0.5)), 5);
+  EXPECT_NEAR(900, absl::ToDoubleMicroseconds(histogram.Percentile(0.9)), 9);
+  EXPECT_NEAR(990, absl::ToDoubleMicroseconds(histogram.Percentile(0.99)),
+              10);
+  EXPECT_EQ(absl::Microseconds(1000), histogram.Percentile(1));
+
+  auto json = histogram.ToJson();
+  EXPECT_EQ(1000, json["count"]);
+  EXPECT_TRUE(json.contains("p999_us"));
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.count());
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Nanoseconds(3));
+  histogram.Record(absl::Nanoseconds(-5));
+  EXPECT_EQ(absl::ZeroDuration(), histogram.Percentile(0.5));
+  EXPECT_EQ(absl::Nanoseconds(3), histogram.Percentile(1));
+}
+
+TEST(KeyChooserTest, ParseKeyDistribution) {
+  EXPECT_THAT(ParseKeyDistribution("zipf"),
+              ::testing::Optional(KeyDistribution::kZipf));
+  EXPECT_THAT(ParseKeyDistribution("uniform"),
+              ::testing::Optional(KeyDistribution::kUniform));
+  EXPECT_THAT(ParseKeyDistribution("sequential"),
+              ::testing::Optional(KeyDistribution::kSequential));
+  EXPECT_FALSE(ParseKeyDistribution("other").ok());
+}
+
+TEST(KeyChooserTest, Sequential) {
+  absl::InsecureBitGen gen;
+  KeyChooser chooser(3, KeyDistribution::kSequential);
+  std::vector<size_t> keys;
+  for (int i = 0; i < 5; ++i) keys.push_back(chooser.Next(gen));
+  EXPECT_THAT(keys, ::testing::ElementsAre(0, 1, 2, 0, 1));
+}
+
+TEST(KeyChooserTest, ZipfIsSkewed) {
+  absl::InsecureBitGen gen;
+  KeyChooser chooser(1000, KeyDistribution::kZipf, 1.5);
+  std::vector<int> counts(1000);
+  for (int i = 0; i < 10000; ++i) {
+    size_t key = chooser.Next(gen);
+    ASSERT_LT(key, 1000);
+    ++counts[key];
+  }
+  EXPECT_GT(counts[0], counts[999]);
+  EXPECT_GT(counts[0], 10000 / 10);
+}
+
+}  // namespace
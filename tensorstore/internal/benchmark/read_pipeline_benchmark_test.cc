@@ -0,0 +1,381 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmarks the complete read pipeline (kvstore read, chunk decode, and copy
+// into the output array) across drivers, compressors, kvstores and access
+// patterns:
+//
+// BM_ReadPipeline/driver:<d>/compression:<c>/kvstore:<k>/pattern:<p>
+//
+// driver:
+//
+//   0: zarr, 1: zarr3 with sharding, 2: n5, 3: neuroglancer_precomputed.
+//   The precomputed format supports only "raw" and, when sharded, "gzip".
+//
+// compression:
+//
+//   0: raw, 1: blosc, 2: zstd, 3: gzip.
+//
+// kvstore:
+//
+//   0: memory, 1: file (in a temporary directory), 2: ocdbt over memory.
+//
+// pattern:
+//
+//   0: full chunks, one read per chunk.
+//   1: sub-chunk, a 16^3 region within each chunk.
+//   2: strided, a single read of every 4th element along dimensions 1 and 2.
+//   3: cross-chunk slabs, offset by half a chunk along dimension 0.
+//
+// Throughput is reported as the number of bytes delivered to the caller.  The
+// cache pool is disabled, so each iteration reads and decodes every chunk
+// again.  The per-iteration time spent in each stage is reported from the
+// tensorstore metrics:
+//
+//   kvstore_read_ms:  summed latency of reads from the top-level kvstore.
+//   chunk_decode_ms:  time spent decoding chunks in the chunk cache.
+//   codec_decode_ms:  the part of `chunk_decode_ms` spent in the compressor.
+//
+// Baseline results can be stored with
+// `--benchmark_out=<file> --benchmark_out_format=json` and compared against a
+// later run using the `compare.py` tool distributed with Google Benchmark.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/metrics/collect.h"
+#include "tensorstore/internal/metrics/registry.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace {
+
+using ::tensorstore::Dims;
+using ::tensorstore::Future;
+using ::tensorstore::Index;
+using ::tensorstore::SharedArray;
+using ::tensorstore::internal_metrics::CollectedMetric;
+using ::tensorstore::internal_metrics::GetMetricRegistry;
+
+enum Driver { kZarr, kZarr3Sharded, kN5, kPrecomputed, kNumDrivers };
+enum Compression { kRaw, kBlosc, kZstd, kGzip, kNumCompressions };
+enum Kvstore { kMemory, kFile, kOcdbt, kNumKvstores };
+enum Pattern { kFullChunk, kSubChunk, kStrided, kCrossChunk, kNumPatterns };
+
+constexpr const char* kDriverNames[] = {"zarr", "zarr3_sharded", "n5",
+                                        "neuroglancer_precomputed"};
+constexpr const char* kCompressionNames[] = {"raw", "blosc", "zstd", "gzip"};
+constexpr const char* kKvstoreNames[] = {"memory", "file", "ocdbt"};
+constexpr const char* kPatternNames[] = {"full_chunk", "sub_chunk", "strided",
+                                         "cross_chunk"};
+
+// Volume of `kSize^3` uint16 elements, stored in chunks of `kChunkSize^3`.
+constexpr Index kSize = 256;
+constexpr Index kChunkSize = 64;
+// zarr3 shards contain `(kShardSize / kChunkSize)^3` chunks.
+constexpr Index kShardSize = 128;
+
+bool IsSupported(Driver driver, Compression compression) {
+  if (driver == kPrecomputed) {
+    return compression == kRaw || compression == kGzip;
+  }
+  return true;
+}
+
+::nlohmann::json GetCompressorJson(Driver driver, Compression compression) {
+  switch (driver) {
+    case kZarr:
+      switch (compression) {
+        case kRaw:
+          return nullptr;
+        case kBlosc:
+          return {{"id", "blosc"}};
+        case kZstd:
+          return {{"id", "zstd"}};
+        case kGzip:
+          return {{"id", "gzip"}};
+        default:
+          break;
+      }
+      break;
+    case kZarr3Sharded:
+      switch (compression) {
+        case kBlosc:
+          return {{"name", "blosc"}};
+        case kZstd:
+          return {{"name", "zstd"}};
+        case kGzip:
+          return {{"name", "gzip"}};
+        default:
+          return nullptr;
+      }
+    case kN5:
+      switch (compression) {
+        case kRaw:
+          return {{"type", "raw"}};
+        case kBlosc:
+          return {{"type", "blosc"},
+                  {"cname", "lz4"},
+                  {"clevel", 5},
+                  {"shuffle", 1}};
+        case kZstd:
+          return {{"type", "zstd"}};
+        case kGzip:
+          return {{"type", "gzip"}};
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+  return nullptr;
+}
+
+::nlohmann::json GetKvstoreJson(Kvstore kvstore, const std::string& dir) {
+  switch (kvstore) {
+    case kFile:
+      return {{"driver", "file"}, {"path", dir + "/"}};
+    case kOcdbt:
+      return {{"driver", "ocdbt"}, {"base", "memory://"}};
+    default:
+      return "memory://";
+  }
+}
+
+::nlohmann::json GetSpecJson(Driver driver, Compression compression,
+                             ::nlohmann::json kvstore) {
+  const ::nlohmann::json shape = {kSize, kSize, kSize};
+  const ::nlohmann::json chunk_shape = {kChunkSize, kChunkSize, kChunkSize};
+  ::nlohmann::json compressor = GetCompressorJson(driver, compression);
+  ::nlohmann::json spec{
+      {"driver", kDriverNames[driver]},
+      {"kvstore", std::move(kvstore)},
+      {"create", true},
+      {"delete_existing", true},
+  };
+  switch (driver) {
+    case kZarr:
+      spec["metadata"] = {{"dtype", "<u2"},
+                          {"shape", shape},
+                          {"chunks", chunk_shape},
+                          {"compressor", compressor}};
+      break;
+    case kZarr3Sharded: {
+      ::nlohmann::json codecs = ::nlohmann::json::array_t{
+          {{"name", "bytes"}, {"configuration", {{"endian", "little"}}}}};
+      if (!compressor.is_null()) codecs.push_back(compressor);
+      spec["metadata"] = {
+          {"data_type", "uint16"},
+          {"shape", shape},
+          {"chunk_grid",
+           {{"name", "regular"},
+            {"configuration",
+             {{"chunk_shape", {kShardSize, kShardSize, kShardSize}}}}}},
+          {"codecs",
+           {{{"name", "sharding_indexed"},
+             {"configuration",
+              {{"chunk_shape", chunk_shape}, {"codecs", codecs}}}}}},
+      };
+      break;
+    }
+    case kN5:
+      spec["metadata"] = {{"dataType", "uint16"},
+                          {"dimensions", shape},
+                          {"blockSize", chunk_shape},
+                          {"compression", compressor}};
+      break;
+    case kPrecomputed:
+      spec["multiscale_metadata"] = {
+          {"data_type", "uint16"}, {"num_channels", 1}, {"type", "image"}};
+      spec["scale_metadata"] = {
+          {"size", shape}, {"chunk_size", chunk_shape}, {"encoding", "raw"}};
+      if (compression == kGzip) {
+        spec["scale_metadata"]["sharding"] = {
+            {"@type", "neuroglancer_uint64_sharded_v1"},
+            {"preshift_bits", 3},
+            {"minishard_bits", 3},
+            {"shard_bits", 0},
+            {"hash", "identity"},
+            {"minishard_index_encoding", "gzip"},
+            {"data_encoding", "gzip"},
+        };
+      }
+      break;
+    default:
+      break;
+  }
+  return spec;
+}
+
+// Fills `array` with smoothly varying values plus a small amount of noise, so
+// that compressors have work to do but still achieve some compression.
+void FillSourceData(SharedArray<uint16_t> array) {
+  uint16_t* data = array.data();
+  for (Index i = 0, n = array.num_elements(); i < n; ++i) {
+    const Index noise = (i * 2654435761u) >> 13 & 7;
+    data[i] = static_cast<uint16_t>(i % kSize + noise);
+  }
+}
+
+// Issues the reads of `pattern`, returning the number of bytes delivered.
+int64_t ReadPattern(const tensorstore::TensorStore<>& store, Pattern pattern) {
+  std::vector<Future<tensorstore::SharedOffsetArray<void>>> futures;
+  auto read = [&](auto expr) {
+    futures.push_back(tensorstore::Read(store | expr));
+  };
+  switch (pattern) {
+    case kFullChunk:
+    case kSubChunk: {
+      const Index offset = pattern == kFullChunk ? 0 : kChunkSize * 3 / 8;
+      const Index size = pattern == kFullChunk ? kChunkSize : kChunkSize / 4;
+      for (Index x = 0; x < kSize; x += kChunkSize) {
+        for (Index y = 0; y < kSize; y += kChunkSize) {
+          for (Index z = 0; z < kSize; z += kChunkSize) {
+            read(Dims(0, 1, 2).SizedInterval(
+                {x + offset, y + offset, z + offset}, {size, size, size}));
+          }
+        }
+      }
+      break;
+    }
+    case kStrided:
+      read(Dims(1, 2).Stride(4));
+      break;
+    case kCrossChunk:
+      for (Index x = kChunkSize / 2; x + kChunkSize <= kSize;
+           x += kChunkSize) {
+        read(Dims(0).SizedInterval(x, kChunkSize));
+      }
+      break;
+    default:
+      break;
+  }
+  int64_t bytes = 0;
+  for (auto& future : futures) {
+    TENSORSTORE_CHECK_OK_AND_ASSIGN(auto array, future.result());
+    bytes += array.num_elements() * array.dtype().size();
+  }
+  return bytes;
+}
+
+// Sums the values of the counter `metric_name`, over all fields.
+int64_t SumCounter(const std::vector<CollectedMetric>& metrics,
+                   std::string_view metric_name) {
+  int64_t sum = 0;
+  for (const auto& metric : metrics) {
+    if (metric.metric_name != metric_name) continue;
+    for (const auto& value : metric.values) {
+      if (const auto* v = std::get_if<int64_t>(&value.value)) sum += *v;
+    }
+  }
+  return sum;
+}
+
+// Returns the total latency recorded by the histogram `metric_name`.
+double SumHistogram(const std::vector<CollectedMetric>& metrics,
+                    std::string_view metric_name) {
+  double sum = 0;
+  for (const auto& metric : metrics) {
+    if (metric.metric_name != metric_name) continue;
+    for (const auto& h : metric.histograms) sum += h.mean * h.count;
+  }
+  return sum;
+}
+
+void BM_ReadPipeline(benchmark::State& state) {
+  const auto driver = static_cast<Driver>(state.range(0));
+  const auto compression = static_cast<Compression>(state.range(1));
+  const auto kvstore = static_cast<Kvstore>(state.range(2));
+  const auto pattern = static_cast<Pattern>(state.range(3));
+  state.SetLabel(std::string(kDriverNames[driver]) + "/" +
+                 kCompressionNames[compression] + "/" + kKvstoreNames[kvstore] +
+                 "/" + kPatternNames[pattern]);
+
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::Open(GetSpecJson(driver, compression,
+                                    GetKvstoreJson(kvstore, tempdir.path())),
+                        tensorstore::dtype_v<uint16_t>)
+          .result());
+
+  // The precomputed driver adds a trailing channel dimension.
+  std::vector<Index> shape(store.rank(), 1);
+  shape[0] = shape[1] = shape[2] = kSize;
+  auto source_data =
+      tensorstore::AllocateArray<uint16_t>(shape, tensorstore::c_order);
+  FillSourceData(source_data);
+  TENSORSTORE_CHECK_OK(tensorstore::Write(source_data, store).result());
+
+  GetMetricRegistry().Reset();
+  int64_t bytes = 0;
+  for (auto s : state) {
+    bytes += ReadPattern(store, pattern);
+  }
+  state.SetBytesProcessed(bytes);
+
+  auto metrics = GetMetricRegistry().CollectWithPrefix("/tensorstore/");
+  const double iterations = static_cast<double>(state.iterations());
+  state.counters["kvstore_read_ms"] =
+      SumHistogram(metrics, std::string("/tensorstore/kvstore/") +
+                                kKvstoreNames[kvstore] + "/read_latency_ms") /
+      iterations;
+  state.counters["chunk_decode_ms"] =
+      SumCounter(metrics, "/tensorstore/cache/kvs_cache_decode_ns") / 1e6 /
+      iterations;
+  state.counters["codec_decode_ms"] =
+      SumCounter(metrics, "/tensorstore/codec/decode_ns") / 1e6 / iterations;
+}
+
+template <typename Bench>
+void DefineArgs(Bench* bench) {
+  bench->ArgNames({"driver", "compression", "kvstore", "pattern"});
+  for (int driver = 0; driver < kNumDrivers; ++driver) {
+    for (int compression = 0; compression < kNumCompressions; ++compression) {
+      if (!IsSupported(static_cast<Driver>(driver),
+                       static_cast<Compression>(compression))) {
+        continue;
+      }
+      for (int kvstore = 0; kvstore < kNumKvstores; ++kvstore) {
+        for (int pattern = 0; pattern < kNumPatterns; ++pattern) {
+          bench->Args({driver, compression, kvstore, pattern});
+        }
+      }
+    }
+  }
+  bench->UseRealTime()->MeasureProcessCPUTime();
+}
+
+BENCHMARK(BM_ReadPipeline)->Apply(DefineArgs);
+
+}  // namespace
@@ -127,6 +127,7 @@ void EntryOrNodeStartRead(EntryOrNode& entry_or_node,
     request_state.queued = Promise<void>();
     request_state.queued_request_is_deferred = true;
     request_state.queued_time = absl::InfinitePast();
+    request_state.queued_io_stats = IoStats();
     return;
   }
   assert(request_state.issued.null());
@@ -141,6 +142,7 @@ void EntryOrNodeStartRead(EntryOrNode& entry_or_node,
   AsyncCache::AsyncCacheReadRequest read_request;
   read_request.staleness_bound = staleness_bound;
   read_request.batch = batch;
+  read_request.io_stats = std::move(request_state.queued_io_stats);
   entry_or_node.DoRead(std::move(read_request));
 }
 
@@ -310,16 +312,32 @@ Future<const void> RequestRead(EntryOrNode& entry_or_node,
   UniqueWriterLock lock(entry);
 
   auto& effective_request_state = GetEffectiveReadRequestState(entry_or_node);
-  const auto existing_time = effective_request_state.read_state.stamp.time;
+  const auto& existing_stamp = effective_request_state.read_state.stamp;
+  const auto existing_time = existing_stamp.time;
+  const absl::Time coalescing_bound =
+      options.staleness_bound - options.coalescing_window;
+  // Set if the current data is returned immediately, while the read issued
+  // below revalidates it in the background.
+  bool revalidate_in_background = false;
   if (existing_time != absl::InfinitePast() &&
-      existing_time >= options.staleness_bound) {
+      (existing_time >= options.staleness_bound ||
+       (StorageGeneration::IsNoValue(existing_stamp.generation) &&
+        existing_time >= coalescing_bound))) {
     if (must_not_be_known_to_be_stale &&
         effective_request_state.known_to_be_stale) {
       options.staleness_bound = existing_time + kEpsilonDuration;
     } else {
       // `staleness_bound` satisfied by current data.
+      options.io_stats.RecordCacheHit();
       return MakeReadyFuture();
     }
+  } else if (existing_time != absl::InfinitePast() &&
+             options.stale_while_revalidate > absl::ZeroDuration() &&
+             existing_time >=
+                 options.staleness_bound - options.stale_while_revalidate &&
+             !(must_not_be_known_to_be_stale &&
+               effective_request_state.known_to_be_stale)) {
+    revalidate_in_background = true;
   }
 
   auto& request_state = entry_or_node.read_request_state_;
@@ -328,12 +346,23 @@ Future<const void> RequestRead(EntryOrNode& entry_or_node,
       std::max(request_state.queued_time,
                std::min(options.staleness_bound, absl::Now()));
   if (!request_state.issued.null() &&
-      request_state.issued_time >= options.staleness_bound) {
-    // Another read is in progress, and `staleness_bound` will be satisfied by
-    // it when it completes.
+      request_state.issued_time >= coalescing_bound) {
+    // Another read is in progress, and `staleness_bound` (relaxed by
+    // `coalescing_window`) will be satisfied by it when it completes.
+    options.io_stats.RecordCacheHit();
+    if (revalidate_in_background) return MakeReadyFuture();
     return GetFuture(request_state.issued);
   }
 
+  if (revalidate_in_background) {
+    // The cost of the revalidation is not attributed to this request.
+    options.io_stats.RecordCacheHit();
+  } else {
+    options.io_stats.RecordCacheMiss();
+    if (!request_state.queued_io_stats) {
+      request_state.queued_io_stats = std::move(options.io_stats);
+    }
+  }
   auto future = GetFuture(request_state.queued);
 
   if (options.batch.deferred() && request_state.queued_request_is_deferred) {
@@ -352,6 +381,12 @@ Future<const void> RequestRead(EntryOrNode& entry_or_node,
   }
 
   MaybeIssueRead(entry_or_node, std::move(lock), options.batch);
+  if (revalidate_in_background) {
+    // Keep a reference to `future` until the read completes, since otherwise
+    // the read is treated as cancelled.
+    future.ExecuteWhenReady([future](ReadyFuture<const void>) {});
+    return MakeReadyFuture();
+  }
   return future;
 }
 
@@ -367,6 +402,7 @@ class QueuedReadHandler {
       queued_ = std::move(request_state.queued);
       request_state.queued_time = absl::InfinitePast();
       request_state.queued_request_is_deferred = true;
+      request_state.queued_io_stats = IoStats();
     }
   }
 
@@ -593,6 +629,12 @@ void AsyncCache::TransactionNode::Abort() {
   AbortDone();
 }
 
+void AsyncCache::TransactionNode::AttributeIoStats(const IoStats& io_stats) {
+  if (!io_stats) return;
+  absl::MutexLock lock(&mutex_);
+  if (!io_stats_) io_stats_ = io_stats;
+}
+
 void AsyncCache::TransactionNode::WritebackSuccess(ReadState&& read_state) {
   ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
       << *this << "WritebackSuccess: " << read_state.stamp
@@ -38,6 +38,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/tagged_ptr.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
@@ -191,6 +192,10 @@ class AsyncCache : public Cache {
     /// Only meaningful if `queued.valid()`.
     absl::Time queued_time = absl::InfinitePast();
 
+    /// Collector to which the cost of the queued read is attributed, taken from
+    /// the first request that required it.
+    IoStats queued_io_stats;
+
     /// The most recently-cached read state.
     ReadState read_state;
 
@@ -332,6 +337,26 @@ class AsyncCache : public Cache {
 
     /// Batch to use.
     Batch::View batch;
+
+    /// Relaxes `staleness_bound` by up to this duration in order to avoid
+    /// redundant reads: a read in progress that was issued no earlier than
+    /// `staleness_bound - coalescing_window` is used rather than queuing
+    /// another read, and cached data indicating that the entry does not exist
+    /// (`StorageGeneration::NoValue()`) is used if it is no older than
+    /// `staleness_bound - coalescing_window`.
+    absl::Duration coalescing_window = absl::ZeroDuration();
+
+    /// Permits cached data that does not satisfy `staleness_bound` to be used
+    /// without waiting, provided that it is no older than `staleness_bound -
+    /// stale_while_revalidate`.  In that case the read completes immediately
+    /// and the entry is revalidated in the background, such that subsequent
+    /// reads observe the refreshed data.
+    absl::Duration stale_while_revalidate = absl::ZeroDuration();
+
+    /// Collector to which the cost of the read is attributed.  For each call
+    /// to `Read`, a cache hit or miss is recorded; the kvstore read and decode
+    /// of a miss are recorded by `DoRead`.
+    IoStats io_stats;
   };
 
   /// Base Entry class.  `Derived` classes must define a nested `Derived::Entry`
@@ -771,6 +796,16 @@ class AsyncCache : public Cache {
     /// from it.
     void Abort() override;
 
+    /// Attributes the cost of writing back this node to `io_stats`, unless a
+    /// previous write already specified a collector.
+    void AttributeIoStats(const IoStats& io_stats);
+
+    /// Returns the collector to which writeback of this node is attributed.
+    ///
+    /// May only be called while writeback is in progress, since no further
+    /// writes can modify the node at that point.
+    const IoStats& io_stats() const { return io_stats_; }
+
     // Treat as private:
 
     ReadState& LockReadState() ABSL_NO_THREAD_SAFETY_ANALYSIS {
@@ -847,6 +882,10 @@ class AsyncCache : public Cache {
     /// Cached write state size.  Protected by `mutex_`.
     size_t write_state_size_ = 0;
 
+    /// Collector to which the cost of writing back this node is attributed,
+    /// taken from the first write that modified it.  Protected by `mutex_`.
+    IoStats io_stats_;
+
     /// Set to indicate that a transactional read will have the same result as a
     /// non-transactional read directly on the owning entry; in that case, a
     /// non-transactional read will be used except when committing, as that
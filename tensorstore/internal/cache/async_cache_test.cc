@@ -63,6 +63,10 @@ struct RequestLog {
           {std::move(value),
            {tensorstore::StorageGeneration::FromString("g"), time}});
     }
+    void Missing(absl::Time time = absl::Now()) {
+      entry->ReadSuccess(
+          {nullptr, {tensorstore::StorageGeneration::NoValue(), time}});
+    }
     void Error(absl::Status error) { entry->ReadError(std::move(error)); }
   };
 
@@ -345,6 +349,107 @@ TEST(AsyncCacheTest, ReadBasic) {
   }
 }
 
+TEST(AsyncCacheTest, ReadCoalescingWindow) {
+  auto pool = CachePool::Make(CachePool::Limits{});
+  RequestLog log;
+  auto cache = GetCache<TestCache>(
+      pool.get(), "", [&] { return std::make_unique<TestCache>(&log); });
+  auto entry = GetCacheEntry(cache, "a");
+  const absl::Duration window = absl::Hours(1);
+
+  // A read issued within the window shares the read in progress.
+  auto read_future = entry->Read({absl::Now()});
+  const auto read_time = UniqueNow();
+  auto read_future1 = entry->Read({UniqueNow(), /*batch=*/{}, window});
+  EXPECT_TRUE(HaveSameSharedState(read_future, read_future1));
+  ASSERT_EQ(1, log.reads.size());
+
+  // Without a window, another read is queued.
+  auto read_future2 = entry->Read({UniqueNow()});
+  EXPECT_FALSE(HaveSameSharedState(read_future, read_future2));
+
+  log.reads.pop().Missing(read_time);
+  ASSERT_TRUE(read_future.ready());
+  ASSERT_FALSE(read_future2.ready());
+  ASSERT_EQ(1, log.reads.size());
+  log.reads.pop().Missing(UniqueNow());
+  ASSERT_TRUE(read_future2.ready());
+
+  // A cached missing value within the window is used without another read.
+  {
+    auto read_future3 =
+        entry->Read({absl::Now() + absl::Minutes(1), /*batch=*/{}, window});
+    ASSERT_TRUE(read_future3.ready());
+    TENSORSTORE_EXPECT_OK(read_future3);
+    EXPECT_TRUE(log.reads.empty());
+  }
+
+  // A cached value that is present must satisfy the unrelaxed bound.
+  {
+    auto read_future3 = entry->Read({absl::InfiniteFuture()});
+    ASSERT_EQ(1, log.reads.size());
+    log.reads.pop().Success(UniqueNow());
+    ASSERT_TRUE(read_future3.ready());
+  }
+  {
+    auto read_future4 =
+        entry->Read({absl::Now() + absl::Minutes(1), /*batch=*/{}, window});
+    EXPECT_FALSE(read_future4.ready());
+    ASSERT_EQ(1, log.reads.size());
+    log.reads.pop().Success(UniqueNow());
+  }
+}
+
+TEST(AsyncCacheTest, ReadStaleWhileRevalidate) {
+  auto pool = CachePool::Make(CachePool::Limits{});
+  RequestLog log;
+  auto cache = GetCache<TestCache>(
+      pool.get(), "", [&] { return std::make_unique<TestCache>(&log); });
+  auto entry = GetCacheEntry(cache, "a");
+  AsyncCache::AsyncCacheReadRequest request;
+  request.stale_while_revalidate = absl::Hours(1);
+
+  // Without cached data, the read must wait.
+  request.staleness_bound = absl::Now();
+  auto read_future = entry->Read(request);
+  ASSERT_FALSE(read_future.ready());
+  ASSERT_EQ(1, log.reads.size());
+  log.reads.pop().Success(UniqueNow());
+  ASSERT_TRUE(read_future.ready());
+
+  // Stale data within the window is used immediately, and a revalidating read
+  // is issued.
+  request.staleness_bound = UniqueNow();
+  auto read_future1 = entry->Read(request);
+  ASSERT_TRUE(read_future1.ready());
+  TENSORSTORE_EXPECT_OK(read_future1);
+  ASSERT_EQ(1, log.reads.size());
+
+  // Another stale read while the revalidation is in progress does not issue
+  // another read.
+  auto read_future2 = entry->Read(request);
+  ASSERT_TRUE(read_future2.ready());
+  const auto revalidate_time = UniqueNow();
+  ASSERT_EQ(1, log.reads.size());
+  log.reads.pop().Success(revalidate_time);
+  EXPECT_TRUE(log.reads.empty());
+
+  // The revalidated data satisfies subsequent reads.
+  {
+    auto read_future3 = entry->Read({revalidate_time});
+    ASSERT_TRUE(read_future3.ready());
+    EXPECT_TRUE(log.reads.empty());
+  }
+
+  // Data older than the window must be revalidated before it is used.
+  request.staleness_bound = absl::Now() + absl::Hours(2);
+  auto read_future4 = entry->Read(request);
+  EXPECT_FALSE(read_future4.ready());
+  ASSERT_EQ(1, log.reads.size());
+  log.reads.pop().Success(UniqueNow());
+  ASSERT_TRUE(read_future4.ready());
+}
+
 TEST(AsyncCacheTest, ReadFailed) {
   auto pool = CachePool::Make(kSmallCacheLimits);
   RequestLog log;
@@ -17,10 +17,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bitset>
 #include <cassert>
+#include <initializer_list>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -35,14 +37,21 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/function_ref.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/cache/frequency_sketch.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/gauge.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
 
 // A CacheEntry owns a strong reference to the Cache that contains it only
 // if its reference count is > 0.
@@ -62,6 +71,14 @@ auto& miss_count = internal_metrics::Counter<int64_t>::New(
 auto& evict_count = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/cache/evict_count",
     MetricMetadata("Number of evictions from the cache."));
+auto& evict_bytes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/evict_bytes",
+    MetricMetadata("Bytes evicted from the cache.",
+                   internal_metrics::Units::kBytes));
+auto& pinned_bytes_gauge = internal_metrics::Gauge<int64_t>::New(
+    "/tensorstore/cache/pinned_bytes",
+    MetricMetadata("Bytes of pinned cache entries.",
+                   internal_metrics::Units::kBytes));
 
 using ::tensorstore::internal::PinnedCacheEntry;
 
@@ -74,12 +91,47 @@ inline void DebugAssertMutexHeld(absl::Mutex* mutex) {}
 using LruListAccessor =
     internal::intrusive_linked_list::MemberAccessor<LruListNode>;
 
-CachePoolImpl::CachePoolImpl(const CachePool::Limits& limits)
+CachePoolImpl::CachePoolImpl(const CachePool::Limits& limits,
+                             span<const internal::CacheQuota> quotas)
     : limits_(limits),
       total_bytes_(0),
+      num_lru_shards_(std::max(size_t{1}, limits.lru_shards)),
+      lru_shards_(new LruShard[num_lru_shards_]),
+      // The protected segment holds up to 80% of the total bytes limit.
+      protected_bytes_limit_(limits.total_bytes_limit / 5 * 4 /
+                             num_lru_shards_),
+      num_quotas_(quotas.size()),
+      quotas_(new CacheQuotaState[num_quotas_]),
       strong_references_(1),
       weak_references_(1) {
-  Initialize(LruListAccessor{}, &eviction_queue_);
+  for (size_t i = 0; i < num_quotas_; ++i) {
+    quotas_[i].cache_type = quotas[i].cache_type;
+    quotas_[i].reserved_bytes = quotas[i].reserved_bytes;
+    quotas_[i].max_bytes = quotas[i].max_bytes;
+  }
+  const auto initialize_queue = [](LruQueue& queue) {
+    Initialize(LruListAccessor{}, &queue.eviction_queue);
+    Initialize(LruListAccessor{}, &queue.protected_queue);
+  };
+  for (size_t i = 0; i < num_lru_shards_; ++i) {
+    auto& lru_shard = lru_shards_[i];
+    initialize_queue(lru_shard);
+    lru_shard.quota_queues.reset(new LruQueue[num_quotas_]);
+    for (size_t j = 0; j < num_quotas_; ++j) {
+      initialize_queue(lru_shard.quota_queues[j]);
+    }
+  }
+  if (limits.eviction_policy == internal::CacheEvictionPolicy::kTinyLfu) {
+    frequency_sketch_ = std::make_unique<FrequencySketch>();
+  }
+}
+
+CacheQuotaState* CachePoolImpl::FindQuota(std::string_view cache_type) {
+  if (cache_type.empty()) return nullptr;
+  for (size_t i = 0; i < num_quotas_; ++i) {
+    if (quotas_[i].cache_type == cache_type) return &quotas_[i];
+  }
+  return nullptr;
 }
 
 namespace {
@@ -125,26 +177,167 @@ void UnlinkListNode(LruListNode* node) noexcept {
   Initialize(LruListAccessor{}, node);
 }
 
+// Removes `entry` from the eviction queue or protected segment of its queue in
+// `lru_shard`, if present.
+void UnlinkFromLruShard(CachePoolImpl::LruShard& lru_shard,
+                        CacheEntryImpl* entry) noexcept {
+  UnlinkListNode(entry);
+  if (entry->protected_) {
+    lru_shard.protected_bytes -= entry->protected_num_bytes_;
+    entry->protected_ = false;
+    entry->protected_num_bytes_ = 0;
+  }
+}
+
+// Invokes `f` with each queue of `lru_shard`.
+template <typename Func>
+void ForEachLruQueue(CachePoolImpl* pool, CachePoolImpl::LruShard& lru_shard,
+                     Func f) {
+  f(static_cast<CachePoolImpl::LruQueue&>(lru_shard));
+  for (size_t i = 0; i < pool->num_quotas_; ++i) {
+    f(lru_shard.quota_queues[i]);
+  }
+}
+
 void UnregisterEntryFromPool(CacheEntryImpl* entry,
                              CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-  UnlinkListNode(entry);
+  auto& lru_shard = pool->LruShardForEntry(entry);
+  DebugAssertMutexHeld(&lru_shard.mutex);
+  UnlinkFromLruShard(lru_shard, entry);
   pool->total_bytes_.fetch_sub(entry->num_bytes_, std::memory_order_relaxed);
+  internal::UpdateMemoryUsage(internal::MemoryCategory::kCache,
+                              -static_cast<int64_t>(entry->num_bytes_));
+  if (auto* quota = entry->cache_->quota_) {
+    quota->bytes.fetch_sub(entry->num_bytes_, std::memory_order_relaxed);
+  }
 }
 
 void AddToEvictionQueue(CachePoolImpl* pool, CacheEntryImpl* entry) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
-  auto* eviction_queue = &pool->eviction_queue_;
-  if (!OnlyContainsNode(LruListAccessor{}, entry)) {
-    Remove(LruListAccessor{}, entry);
+  auto& lru_shard = pool->LruShardForEntry(entry);
+  DebugAssertMutexHeld(&lru_shard.mutex);
+  auto& queue = pool->LruQueueForCache(lru_shard, entry->cache_);
+  auto* eviction_queue = &queue.eviction_queue;
+  const bool referenced =
+      entry->referenced_.exchange(false, std::memory_order_relaxed);
+  const bool was_protected = entry->protected_;
+  UnlinkFromLruShard(lru_shard, entry);
+  entry->lru_sequence_ = lru_shard.next_lru_sequence++;
+  if (pool->limits_.eviction_policy == internal::CacheEvictionPolicy::kLru ||
+      (!referenced && !was_protected)) {
+    InsertBefore(LruListAccessor{}, eviction_queue, entry);
+    return;
   }
-  InsertBefore(LruListAccessor{}, eviction_queue, entry);
+  // Promote to (or retain in) the protected segment.
+  entry->protected_ = true;
+  entry->protected_num_bytes_ = entry->num_bytes_;
+  lru_shard.protected_bytes += entry->num_bytes_;
+  auto* protected_queue = &queue.protected_queue;
+  InsertBefore(LruListAccessor{}, protected_queue, entry);
+  // Demote the least-recently used protected entries of `queue` to the back of
+  // its probationary segment while the protected segments of the shard exceed
+  // their limit.
+  while (lru_shard.protected_bytes > pool->protected_bytes_limit_ &&
+         protected_queue->next != protected_queue) {
+    auto* demoted = static_cast<CacheEntryImpl*>(protected_queue->next);
+    UnlinkFromLruShard(lru_shard, demoted);
+    demoted->lru_sequence_ = lru_shard.next_lru_sequence++;
+    InsertBefore(LruListAccessor{}, eviction_queue, demoted);
+  }
+}
+
+// Returns the hash of `key` used for frequency estimates.
+uint64_t GetFrequencyHash(const CacheImpl* cache, std::string_view key) {
+  return absl::HashOf(static_cast<const void*>(cache), key);
+}
+
+bool IsOverTotalBytesLimit(CachePoolImpl* pool) {
+  return pool->total_bytes_.load(std::memory_order_acquire) >
+         pool->limits_.total_bytes_limit +
+             pool->pinned_bytes_.load(std::memory_order_relaxed);
+}
+
+bool IsOverMaxBytes(const CacheQuotaState& quota) {
+  return quota.max_bytes != 0 &&
+         quota.bytes.load(std::memory_order_relaxed) > quota.max_bytes;
+}
+
+// Returns `true` if the pool exceeds its total limit or any quota exceeds its
+// maximum.
+bool NeedsEviction(CachePoolImpl* pool) {
+  if (IsOverTotalBytesLimit(pool)) return true;
+  for (size_t i = 0; i < pool->num_quotas_; ++i) {
+    if (IsOverMaxBytes(pool->quotas_[i])) return true;
+  }
+  return false;
+}
+
+// Returns `true` if `entry` should be evicted, given the quota of its cache and
+// whether the pool exceeds its total limit.
+bool ShouldEvict(CacheEntryImpl* entry, bool over_total_bytes_limit) {
+  auto* quota = entry->cache_->quota_;
+  if (!quota) return over_total_bytes_limit;
+  if (IsOverMaxBytes(*quota)) return true;
+  // Don't evict entries within the reserved amount.
+  return over_total_bytes_limit &&
+         quota->bytes.load(std::memory_order_relaxed) >=
+             quota->reserved_bytes + entry->num_bytes_;
+}
+
+// Returns the next entry of `lru_shard` that should be evicted, or returns
+// `nullptr` if there is none.
+//
+// Only the front of each queue is considered: probationary entries are evicted
+// before protected entries, and otherwise the least-recently used front is
+// chosen.  Since all entries of a queue are subject to the same quota, the
+// entries of a queue whose front is within the reserved amount are not
+// scanned.
+CacheEntryImpl* NextEvictionCandidate(CachePoolImpl* pool,
+                                      CachePoolImpl::LruShard& lru_shard,
+                                      bool over_total_bytes_limit) noexcept {
+  CachePoolImpl::LruQueue* victim_queue = nullptr;
+  CacheEntryImpl* victim = nullptr;
+  bool victim_protected = false;
+  ForEachLruQueue(pool, lru_shard, [&](CachePoolImpl::LruQueue& queue) {
+    const bool is_protected =
+        queue.eviction_queue.next == &queue.eviction_queue;
+    auto* head = is_protected ? &queue.protected_queue : &queue.eviction_queue;
+    if (head->next == head) return;
+    auto* entry = static_cast<CacheEntryImpl*>(head->next);
+    if (!ShouldEvict(entry, over_total_bytes_limit)) return;
+    if (victim && std::pair(victim_protected, victim->lru_sequence_) <
+                      std::pair(is_protected, entry->lru_sequence_)) {
+      return;
+    }
+    victim_queue = &queue;
+    victim = entry;
+    victim_protected = is_protected;
+  });
+  auto* sketch = pool->frequency_sketch_.get();
+  if (!victim || victim_protected || !sketch) return victim;
+  auto* probation_queue = &victim_queue->eviction_queue;
+  if (probation_queue->prev == victim) return victim;
+  // TinyLFU admission: the most-recently released probationary entry is
+  // evicted in place of the least-recently used one if it has been accessed
+  // less frequently.
+  auto* candidate = static_cast<CacheEntryImpl*>(probation_queue->prev);
+  if (ShouldEvict(candidate, over_total_bytes_limit) &&
+      sketch->Estimate(GetFrequencyHash(candidate->cache_, candidate->key_)) <
+          sketch->Estimate(GetFrequencyHash(victim->cache_, victim->key_))) {
+    return candidate;
+  }
+  return victim;
 }
 
 void DestroyCache(CachePoolImpl* pool, CacheImpl* cache);
 
-void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
-  DebugAssertMutexHeld(&pool->lru_mutex_);
+// Evicts entries from `lru_shard` while the pool exceeds its total limit or a
+// quota exceeds its maximum.
+//
+// Returns `true` if no further eviction is needed upon return, or `false` if
+// the eviction queue of `lru_shard` was exhausted.
+bool MaybeEvictEntries(CachePoolImpl* pool,
+                       CachePoolImpl::LruShard& lru_shard) noexcept {
+  DebugAssertMutexHeld(&lru_shard.mutex);
 
   constexpr size_t kBufferSize = 64;
   std::array<CacheEntryImpl*, kBufferSize> entries_to_delete;
@@ -154,7 +347,7 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
   size_t num_entries_to_delete = 0;
 
   const auto destroy_entries = [&] {
-    internal::ScopedWriterUnlock unlock(pool->lru_mutex_);
+    internal::ScopedWriterUnlock unlock(lru_shard.mutex);
     for (size_t i = 0; i < num_entries_to_delete; ++i) {
       auto* entry = entries_to_delete[i];
       if (should_delete_cache_for_entry[i]) {
@@ -166,14 +359,15 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
     }
   };
 
-  while (pool->total_bytes_.load(std::memory_order_acquire) >
-         pool->limits_.total_bytes_limit) {
-    auto* queue = &pool->eviction_queue_;
-    if (queue->next == queue) {
-      // Queue empty.
+  bool within_limit = true;
+  while (NeedsEviction(pool)) {
+    auto* entry =
+        NextEvictionCandidate(pool, lru_shard, IsOverTotalBytesLimit(pool));
+    if (!entry) {
+      // Queue exhausted.
+      within_limit = false;
       break;
     }
-    auto* entry = static_cast<CacheEntryImpl*>(queue->next);
     auto* cache = entry->cache_;
     bool evict = false;
     bool should_delete_cache = false;
@@ -196,17 +390,18 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
       // efficiency, entries aren't removed from the eviction list when the
       // reference count increases.  It will be put back on the eviction list
       // the next time the reference count becomes 0.  There is no race
-      // condition here because both `cache->entries_mutex_` and
-      // `pool->lru_mutex_` are held, and the reference count cannot increase
-      // from zero except while holding `cache->entries_mutex_`, and the
-      // reference count cannot decrease to zero except while holding
-      // `pool->lru_mutex_`.
-      UnlinkListNode(entry);
+      // condition here because both `cache->entries_mutex_` and the LRU shard
+      // mutex are held, and the reference count cannot increase from zero
+      // except while holding `cache->entries_mutex_`, and the reference count
+      // cannot decrease to zero except while holding the mutex of the LRU
+      // shard assigned to the entry.
+      UnlinkFromLruShard(lru_shard, entry);
       continue;
     }
     UnregisterEntryFromPool(entry, pool);
     evict_count.Increment();
-    // Enqueue entry to be destroyed with `pool->lru_mutex_` released.
+    evict_bytes.IncrementBy(entry->num_bytes_);
+    // Enqueue entry to be destroyed with `lru_shard.mutex` released.
     should_delete_cache_for_entry[num_entries_to_delete] = should_delete_cache;
     entries_to_delete[num_entries_to_delete++] = entry;
     if (num_entries_to_delete == entries_to_delete.size()) {
@@ -215,6 +410,35 @@ void MaybeEvictEntries(CachePoolImpl* pool) noexcept {
     }
   }
   destroy_entries();
+  return within_limit;
+}
+
+// Evicts entries from the LRU shards other than `skip_shard`, starting with
+// the shard after `skip_shard`, until the pool is within its limit.
+//
+// Must be called without holding any LRU shard mutex.
+void MaybeEvictEntriesFromOtherShards(CachePoolImpl* pool,
+                                      size_t skip_shard) noexcept {
+  for (size_t i = 1; i < pool->num_lru_shards_; ++i) {
+    auto& lru_shard =
+        pool->lru_shards_[(skip_shard + i) % pool->num_lru_shards_];
+    absl::MutexLock lock(&lru_shard.mutex);
+    if (MaybeEvictEntries(pool, lru_shard)) return;
+  }
+}
+
+// Adds `entry`, which must have a reference count of 0, to the eviction queue
+// and evicts entries as necessary.
+//
+// `lock` must be a lock on the LRU shard mutex for `entry`, and is released
+// upon return.
+void ReleaseEntryToEvictionQueue(CachePoolImpl* pool, CacheEntryImpl* entry,
+                                 UniqueWriterLock<absl::Mutex> lock) noexcept {
+  const size_t shard_index = pool->LruShardIndexForEntry(entry);
+  AddToEvictionQueue(pool, entry);
+  if (MaybeEvictEntries(pool, pool->lru_shards_[shard_index])) return;
+  lock = {};
+  MaybeEvictEntriesFromOtherShards(pool, shard_index);
 }
 
 void InitializeNewEntry(CacheEntryImpl* entry, CacheImpl* cache) noexcept {
@@ -239,7 +463,10 @@ void DestroyCache(CachePoolImpl* pool,
       }
     }
     if (HasLruCache(pool)) {
-      absl::MutexLock lru_lock(&pool->lru_mutex_);
+      // Lock all LRU shards, in order of increasing index.
+      for (size_t i = 0; i < pool->num_lru_shards_; ++i) {
+        pool->lru_shards_[i].mutex.WriterLock();
+      }
       for (auto& shard : cache->shards_) {
         absl::MutexLock lock(&shard.mutex);
         for (CacheEntryImpl* entry : shard.entries) {
@@ -251,6 +478,9 @@ void DestroyCache(CachePoolImpl* pool,
           UnregisterEntryFromPool(entry, pool);
         }
       }
+      for (size_t i = pool->num_lru_shards_; i-- > 0;) {
+        pool->lru_shards_[i].mutex.WriterUnlock();
+      }
       // At this point, no external references to any entry are possible, and
       // the entries can safely be destroyed without holding any locks.
     } else {
@@ -368,15 +598,16 @@ void StrongPtrTraitsCacheEntry::decrement(CacheEntry* p) noexcept
     } else {
       auto lock = DecrementReferenceCountWithLock(
           entry->reference_count_,
-          [pool_impl]() -> absl::Mutex& { return pool_impl->lru_mutex_; },
+          [pool_impl, entry]() -> absl::Mutex& {
+            return pool_impl->LruShardForEntry(entry).mutex;
+          },
           new_count,
           /*decrease_amount=*/2, /*lock_threshold=*/1);
       TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement", p,
                                                 new_count);
       if (!lock) return;
       if (new_count == 0) {
-        AddToEvictionQueue(pool_impl, entry);
-        MaybeEvictEntries(pool_impl);
+        ReleaseEntryToEvictionQueue(pool_impl, entry, std::move(lock));
       }
     }
     // `entry` may not be valid at this point.
@@ -443,6 +674,9 @@ CachePtr<Cache> GetCacheInternal(
   if (!new_cache) return CachePtr<Cache>();
   auto* cache_impl = Access::StaticCast<CacheImpl>(new_cache.get());
   cache_impl->pool_ = pool;
+  if (pool) {
+    cache_impl->quota_ = pool->FindQuota(new_cache->DoGetCacheTypeName());
+  }
   // An empty key indicates not to store the Cache in the map.
   if (!pool || cache_key.empty()) {
     if (pool) {
@@ -480,6 +714,41 @@ CachePtr<Cache> GetCacheInternal(
                          internal::adopt_object_ref);
 }
 
+namespace {
+
+/// Returns a new strong reference to the existing entry for `key` in `shard`,
+/// or `nullptr` if there is no such entry.
+///
+/// This only requires `shard.mutex` to be held in shared mode: the entry
+/// cannot be removed from `shard.entries` without holding `shard.mutex`
+/// exclusively, and the adjustment of the reference count is atomic.  When the
+/// reference count increases from zero, the entry may remain in the LRU
+/// eviction queue; `MaybeEvictEntries` re-checks the reference count while
+/// holding `shard.mutex` exclusively before evicting an entry.
+CacheEntryImpl* AcquireExistingEntry(Cache* cache, CacheImpl::Shard& shard,
+                                     std::string_view key)
+    ABSL_SHARED_LOCKS_REQUIRED(shard.mutex) {
+  auto it = shard.entries.find(key);
+  if (it == shard.entries.end()) return nullptr;
+  hit_count.Increment();
+  auto* entry_impl = *it;
+  entry_impl->referenced_.store(true, std::memory_order_relaxed);
+  auto old_count =
+      entry_impl->reference_count_.fetch_add(2, std::memory_order_acq_rel);
+  TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:increment", entry_impl,
+                                            old_count + 2);
+  if (old_count <= 1) {
+    // When the first strong reference to an entry is acquired, also acquire a
+    // strong reference to the cache to be held by the entry.  This ensures
+    // the Cache object is not destroyed while any of its entries are
+    // referenced.
+    StrongPtrTraitsCache::increment(cache);
+  }
+  return entry_impl;
+}
+
+}  // namespace
+
 PinnedCacheEntry<Cache> GetCacheEntryInternal(internal::Cache* cache,
                                               std::string_view key) {
   auto* cache_impl = Access::StaticCast<CacheImpl>(cache);
@@ -494,51 +763,55 @@ PinnedCacheEntry<Cache> GetCacheEntryInternal(internal::Cache* cache,
     returned_entry = PinnedCacheEntry<Cache>(
         Access::StaticCast<CacheEntry>(entry_impl), internal::adopt_object_ref);
   } else {
+    if (auto* sketch = cache_impl->pool_->frequency_sketch_.get()) {
+      sketch->Increment(GetFrequencyHash(cache_impl, key));
+    }
     auto& shard = cache_impl->ShardForKey(key);
-    absl::MutexLock lock(&shard.mutex);
-    auto it = shard.entries.find(key);
-    if (it != shard.entries.end()) {
-      hit_count.Increment();
-      auto* entry_impl = *it;
-      auto old_count =
-          entry_impl->reference_count_.fetch_add(2, std::memory_order_acq_rel);
-      TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:increment",
-                                                entry_impl, old_count + 2);
-      if (old_count <= 1) {
-        // When the first strong reference to an entry is acquired, also
-        // acquire a strong reference to the cache to be held by the entry.
-        // This ensures the Cache object is not destroyed while any of its
-        // entries are referenced.
+    // Look up existing entries with the shard mutex held in shared mode, so
+    // that concurrent hits do not serialize.
+    CacheEntryImpl* existing_entry;
+    {
+      absl::ReaderMutexLock lock(&shard.mutex);
+      existing_entry = AcquireExistingEntry(cache, shard, key);
+    }
+    if (!existing_entry) {
+      absl::MutexLock lock(&shard.mutex);
+      // The entry may have been inserted concurrently while `shard.mutex` was
+      // released.
+      existing_entry = AcquireExistingEntry(cache, shard, key);
+      if (!existing_entry) {
+        miss_count.Increment();
+        // May throw, done before allocating entry.
+        std::string temp_key(key);
+        auto* entry_impl =
+            Access::StaticCast<CacheEntryImpl>(cache->DoAllocateEntry());
+        entry_impl->key_ = std::move(temp_key);      // noexcept
+        InitializeNewEntry(entry_impl, cache_impl);  // noexcept
+        std::unique_ptr<CacheEntry> entry(
+            Access::StaticCast<CacheEntry>(entry_impl));
+        // Add to entries table. This may throw, in which case the entry will
+        // be deleted during unwind.
+        //
+        // Warning: This, like all other aspects of exception safety and
+        // `std::bad_alloc`-safety in particular, have not been tested in
+        // tensorstore and probably don't work.
+        [[maybe_unused]] auto inserted =
+            shard.entries.insert(entry_impl).second;
+        assert(inserted);
+        if (shard.entries.size() == 1) {
+          cache_impl->reference_count_.fetch_add(
+              CacheImpl::kNonEmptyShardIncrement, std::memory_order_relaxed);
+        }
         StrongPtrTraitsCache::increment(cache);
+        returned_entry = PinnedCacheEntry<Cache>(entry.release(),
+                                                 internal::adopt_object_ref);
       }
-      // Adopt reference added via `fetch_add` above.
-      returned_entry =
-          PinnedCacheEntry<Cache>(Access::StaticCast<Cache::Entry>(entry_impl),
-                                  internal::adopt_object_ref);
-    } else {
-      miss_count.Increment();
-      std::string temp_key(key);  // May throw, done before allocating entry.
-      auto* entry_impl =
-          Access::StaticCast<CacheEntryImpl>(cache->DoAllocateEntry());
-      entry_impl->key_ = std::move(temp_key);      // noexcept
-      InitializeNewEntry(entry_impl, cache_impl);  // noexcept
-      std::unique_ptr<CacheEntry> entry(
-          Access::StaticCast<CacheEntry>(entry_impl));
-      // Add to entries table. This may throw, in which case the entry will be
-      // deleted during unwind.
-      //
-      // Warning: This, like all other aspects of exception safety and
-      // `std::bad_alloc`-safety in particular, have not been tested in
-      // tensorstore and probably don't work.
-      [[maybe_unused]] auto inserted = shard.entries.insert(entry_impl).second;
-      assert(inserted);
-      if (shard.entries.size() == 1) {
-        cache_impl->reference_count_.fetch_add(
-            CacheImpl::kNonEmptyShardIncrement, std::memory_order_relaxed);
-      }
-      StrongPtrTraitsCache::increment(cache);
-      returned_entry =
-          PinnedCacheEntry<Cache>(entry.release(), internal::adopt_object_ref);
+    }
+    if (existing_entry) {
+      // Adopt reference acquired by `AcquireExistingEntry`.
+      returned_entry = PinnedCacheEntry<Cache>(
+          Access::StaticCast<Cache::Entry>(existing_entry),
+          internal::adopt_object_ref);
     }
   }
   auto* entry_impl = Access::StaticCast<CacheEntryImpl>(returned_entry.get());
@@ -547,7 +820,7 @@ PinnedCacheEntry<Cache> GetCacheEntryInternal(internal::Cache* cache,
     if (HasLruCache(cache_impl->pool_)) {
       size_t new_size = entry_impl->num_bytes_ =
           cache->DoGetSizeInBytes(returned_entry.get());
-      UpdateTotalBytes(*cache_impl->pool_, new_size);
+      UpdateTotalBytes(*cache_impl->pool_, cache_impl, new_size);
     }
   });
   return returned_entry;
@@ -672,7 +945,10 @@ void intrusive_ptr_decrement(CacheEntryWeakState* p)
   }
   auto pool_lock = DecrementReferenceCountWithLock(
       entry->reference_count_,
-      [pool]() -> absl::Mutex& { return pool->lru_mutex_; }, new_count,
+      [pool, entry]() -> absl::Mutex& {
+        return pool->LruShardForEntry(entry).mutex;
+      },
+      new_count,
       /*decrease_amount=*/1,
       /*lock_threshold=*/0);
   TENSORSTORE_INTERNAL_CACHE_DEBUG_REFCOUNT("CacheEntry:decrement", entry,
@@ -682,8 +958,7 @@ void intrusive_ptr_decrement(CacheEntryWeakState* p)
   // There are also no remaining strong references.  Update the entry's queue
   // state if applicable.
   weak_lock = {};
-  AddToEvictionQueue(pool, entry);
-  MaybeEvictEntries(pool);
+  ReleaseEntryToEvictionQueue(pool, entry, std::move(pool_lock));
 }
 
 internal::IntrusivePtr<CacheEntryWeakState> AcquireWeakCacheEntryReference(
@@ -723,15 +998,138 @@ internal::IntrusivePtr<CacheEntryWeakState> AcquireWeakCacheEntryReference(
       weak_state, internal::adopt_object_ref);
 }
 
-void UpdateTotalBytes(CachePoolImpl& pool, ptrdiff_t change) {
+void UpdateTotalBytes(CachePoolImpl& pool, CacheImpl* cache,
+                      ptrdiff_t change) {
   assert(HasLruCache(&pool));
-  if (pool.total_bytes_.fetch_add(change, std::memory_order_acq_rel) + change <=
-          pool.limits_.total_bytes_limit ||
-      change <= 0) {
+  internal::UpdateMemoryUsage(internal::MemoryCategory::kCache, change);
+  bool over_limit =
+      pool.total_bytes_.fetch_add(change, std::memory_order_acq_rel) + change >
+      pool.limits_.total_bytes_limit +
+          pool.pinned_bytes_.load(std::memory_order_relaxed);
+  if (auto* quota = cache->quota_) {
+    quota->bytes.fetch_add(change, std::memory_order_relaxed);
+    over_limit = over_limit || IsOverMaxBytes(*quota);
+  }
+  if (!over_limit || change <= 0) {
     return;
   }
-  absl::MutexLock lock(&pool.lru_mutex_);
-  MaybeEvictEntries(&pool);
+  const size_t start_shard =
+      pool.num_lru_shards_ == 1
+          ? 0
+          : pool.next_eviction_shard_.fetch_add(1, std::memory_order_relaxed) %
+                pool.num_lru_shards_;
+  {
+    absl::MutexLock lock(&pool.lru_shards_[start_shard].mutex);
+    if (MaybeEvictEntries(&pool, pool.lru_shards_[start_shard])) return;
+  }
+  MaybeEvictEntriesFromOtherShards(&pool, start_shard);
+}
+
+absl::Status PinEntry(CacheEntryImpl* entry) {
+  CachePoolImpl* pool = entry->cache_->pool_;
+  absl::MutexLock lock(&entry->mutex_);
+  if (entry->pin_count_++ != 0 || !HasLruCache(pool)) {
+    return absl::OkStatus();
+  }
+  const size_t num_bytes = entry->num_bytes_;
+  const size_t limit = pool->limits_.pinned_bytes_limit;
+  const size_t old_pinned_bytes =
+      pool->pinned_bytes_.fetch_add(num_bytes, std::memory_order_relaxed);
+  if (limit != 0 && old_pinned_bytes + num_bytes > limit) {
+    pool->pinned_bytes_.fetch_sub(num_bytes, std::memory_order_relaxed);
+    --entry->pin_count_;
+    return absl::ResourceExhaustedError(
+        tensorstore::StrCat("Pinning ", num_bytes,
+                            " bytes would exceed the pinned bytes limit of ",
+                            limit, " bytes"));
+  }
+  pinned_bytes_gauge.IncrementBy(num_bytes);
+  return absl::OkStatus();
+}
+
+void UnpinEntry(CacheEntryImpl* entry) {
+  CachePoolImpl* pool = entry->cache_->pool_;
+  absl::MutexLock lock(&entry->mutex_);
+  assert(entry->pin_count_ != 0);
+  if (--entry->pin_count_ != 0 || !HasLruCache(pool)) return;
+  pool->pinned_bytes_.fetch_sub(entry->num_bytes_, std::memory_order_relaxed);
+  pinned_bytes_gauge.DecrementBy(entry->num_bytes_);
+}
+
+std::vector<RecentlyUsedEntry> GetRecentlyUsedEntries(CachePoolImpl* pool,
+                                                      size_t max_bytes) {
+  std::vector<RecentlyUsedEntry> entries;
+  if (!HasLruCache(pool)) return entries;
+  // Entries of each shard, in order of decreasing priority.
+  std::vector<std::vector<RecentlyUsedEntry>> shard_entries(
+      pool->num_lru_shards_);
+  for (size_t i = 0; i < pool->num_lru_shards_; ++i) {
+    auto& lru_shard = pool->lru_shards_[i];
+    auto& result = shard_entries[i];
+    size_t shard_bytes = 0;
+    absl::MutexLock lock(&lru_shard.mutex);
+    // Entries cannot be destroyed without first being unlinked from the LRU
+    // shard, which requires `lru_shard.mutex`.
+    for (bool is_protected : {true, false}) {
+      // Head and next node to visit of the corresponding segment of each
+      // queue.  The segments are merged in order of decreasing
+      // `lru_sequence_`.
+      std::vector<std::pair<LruListNode*, LruListNode*>> positions;
+      ForEachLruQueue(pool, lru_shard, [&](CachePoolImpl::LruQueue& queue) {
+        auto* head =
+            is_protected ? &queue.protected_queue : &queue.eviction_queue;
+        positions.emplace_back(head, head->prev);
+      });
+      while (shard_bytes < max_bytes) {
+        CacheEntryImpl* entry = nullptr;
+        std::pair<LruListNode*, LruListNode*>* position = nullptr;
+        for (auto& p : positions) {
+          if (p.second == p.first) continue;
+          auto* e = static_cast<CacheEntryImpl*>(p.second);
+          if (!entry || e->lru_sequence_ > entry->lru_sequence_) {
+            entry = e;
+            position = &p;
+          }
+        }
+        if (!entry) break;
+        position->second = entry->prev;
+        auto* cache = entry->cache_;
+        if (cache->cache_identifier_.empty()) continue;
+        result.push_back(RecentlyUsedEntry{cache->cache_type_,
+                                           cache->cache_identifier_,
+                                           entry->key_, entry->num_bytes_});
+        shard_bytes += entry->num_bytes_;
+      }
+    }
+  }
+  // Interleave the shards, which each contain an approximately random subset
+  // of the entries.
+  size_t total_bytes = 0;
+  for (size_t i = 0; total_bytes < max_bytes; ++i) {
+    bool remaining = false;
+    for (auto& result : shard_entries) {
+      if (i >= result.size()) continue;
+      remaining = true;
+      total_bytes += result[i].num_bytes;
+      entries.push_back(std::move(result[i]));
+      if (total_bytes >= max_bytes) break;
+    }
+    if (!remaining) break;
+  }
+  return entries;
+}
+
+std::vector<CachePtr<Cache>> GetIdentifiedCaches(CachePoolImpl* pool) {
+  std::vector<CachePtr<Cache>> caches;
+  if (!pool) return caches;
+  absl::MutexLock lock(&pool->caches_mutex_);
+  caches.reserve(pool->caches_.size());
+  for (auto* cache : pool->caches_) {
+    if (!TryToAcquireCacheStrongReference(pool, cache)) continue;
+    caches.emplace_back(Access::StaticCast<Cache>(cache),
+                        internal::adopt_object_ref);
+  }
+  return caches;
 }
 
 }  // namespace internal_cache
@@ -746,6 +1144,8 @@ size_t Cache::DoGetSizeInBytes(Cache::Entry* entry) {
          this->DoGetSizeofEntry();
 }
 
+std::string_view Cache::DoGetCacheTypeName() { return {}; }
+
 CacheEntry::~CacheEntry() {
   auto* weak_state = this->weak_state_.load(std::memory_order_relaxed);
   if (!weak_state) return;
@@ -782,18 +1182,36 @@ void CacheEntry::WriterUnlock() {
 
   const size_t new_size = cache.DoGetSizeInBytes(this);
   ptrdiff_t change = new_size - std::exchange(num_bytes_, new_size);
+  if (pin_count_ != 0) {
+    pool_impl->pinned_bytes_.fetch_add(change, std::memory_order_relaxed);
+    internal_cache::pinned_bytes_gauge.IncrementBy(change);
+  }
   lock.unlock();
 
-  internal_cache::UpdateTotalBytes(*pool_impl, change);
+  internal_cache::UpdateTotalBytes(
+      *pool_impl,
+      internal_cache::Access::StaticCast<internal_cache::CacheImpl>(&cache),
+      change);
 }
 
-CachePool::StrongPtr CachePool::Make(const CachePool::Limits& cache_limits) {
+CachePool::StrongPtr CachePool::Make(const CachePool::Limits& cache_limits,
+                                     span<const CacheQuota> quotas) {
   CachePool::StrongPtr pool;
   internal_cache::Access::StaticCast<internal_cache::CachePoolStrongPtr>(&pool)
-      ->reset(new internal_cache::CachePool(cache_limits), adopt_object_ref);
+      ->reset(new internal_cache::CachePool(cache_limits, quotas),
+              adopt_object_ref);
   return pool;
 }
 
+std::vector<CacheQuota> CachePool::quotas() const {
+  std::vector<CacheQuota> quotas(num_quotas_);
+  for (size_t i = 0; i < num_quotas_; ++i) {
+    const auto& quota = quotas_[i];
+    quotas[i] = {quota.cache_type, quota.reserved_bytes, quota.max_bytes};
+  }
+  return quotas;
+}
+
 CachePool::StrongPtr::StrongPtr(const CachePool::WeakPtr& ptr)
     : Base(ptr.get(), adopt_object_ref) {
   if (!ptr) return;
@@ -70,6 +70,7 @@
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/functional/function_ref.h"
@@ -78,6 +79,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/poly/poly.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -109,6 +111,9 @@ class CachePool : private internal_cache::CachePoolImpl {
   /// Returns the limits of this cache pool.
   const Limits& limits() const { return limits_; }
 
+  /// Returns the quotas of this cache pool, in the order specified to `Make`.
+  std::vector<CacheQuota> quotas() const;
+
   class WeakPtr;
 
   /// Reference-counted pointer to a cache pool that keeps in-use and recently
@@ -153,8 +158,10 @@ class CachePool : private internal_cache::CachePoolImpl {
     friend class internal_cache::Access;
   };
 
-  /// Returns a handle to a new cache pool with the specified limits.
-  static StrongPtr Make(const Limits& limits);
+  /// Returns a handle to a new cache pool with the specified limits and
+  /// quotas.
+  static StrongPtr Make(const Limits& limits,
+                        span<const CacheQuota> quotas = {});
 
  private:
   using internal_cache::CachePoolImpl::CachePoolImpl;
@@ -372,6 +379,13 @@ class Cache : private internal_cache::CacheImpl {
   /// size_t DoGetSizeofEntry() final { return sizeof(Entry); }
   virtual size_t DoGetSizeofEntry() = 0;
 
+  /// Returns the name of the type of this cache, which determines the
+  /// quota specified to `CachePool::Make`, if any, that applies to it.
+  ///
+  /// Called once, when the cache is added to the pool.  The default
+  /// implementation returns an empty string, which matches no quota.
+  virtual std::string_view DoGetCacheTypeName();
+
  private:
   friend class internal_cache::Access;
 };
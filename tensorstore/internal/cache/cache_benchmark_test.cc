@@ -0,0 +1,93 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::StrCat;
+using ::tensorstore::internal::Cache;
+using ::tensorstore::internal::CachePool;
+using ::tensorstore::internal::CachePtr;
+using ::tensorstore::internal::GetCache;
+using ::tensorstore::internal::GetCacheEntry;
+using ::tensorstore::internal::PinnedCacheEntry;
+
+class BenchmarkCache : public Cache {
+ public:
+  class Entry : public Cache::Entry {
+   public:
+    using OwningCache = BenchmarkCache;
+  };
+
+  Entry* DoAllocateEntry() override { return new Entry; }
+  size_t DoGetSizeofEntry() override { return sizeof(Entry); }
+  size_t DoGetSizeInBytes(Cache::Entry* entry) override { return 100; }
+};
+
+constexpr size_t kNumKeys = 1024;
+
+struct SharedState {
+  SharedState(size_t total_bytes_limit, bool pin)
+      : pool(CachePool::Make(CachePool::Limits{total_bytes_limit})),
+        cache(GetCache<BenchmarkCache>(pool.get(), "", [] {
+          return std::make_unique<BenchmarkCache>();
+        })) {
+    for (size_t i = 0; i < kNumKeys; ++i) {
+      keys.push_back(StrCat("key", i));
+      auto entry = GetCacheEntry(cache, keys.back());
+      if (pin) pinned.push_back(std::move(entry));
+    }
+  }
+
+  CachePool::StrongPtr pool;
+  CachePtr<BenchmarkCache> cache;
+  std::vector<std::string> keys;
+  std::vector<PinnedCacheEntry<BenchmarkCache>> pinned;
+};
+
+// Looks up existing entries from `state.threads()` concurrent threads.
+//
+// With `state.range(0) == 1`, the entries are also pinned by another
+// reference, as for entries with outstanding reads, and with
+// `state.range(0) == 0` they are otherwise unused.
+void BM_GetCacheEntryHit(benchmark::State& state) {
+  static SharedState* shared_state;
+  if (state.thread_index() == 0) {
+    shared_state = new SharedState(/*total_bytes_limit=*/1 << 30,
+                                   /*pin=*/state.range(0) == 1);
+  }
+  // Threads are synchronized by the benchmark library upon entering the loop.
+  size_t i = state.thread_index() * 97;
+  for (auto s : state) {
+    auto entry = GetCacheEntry(shared_state->cache,
+                               shared_state->keys[i++ % kNumKeys]);
+    benchmark::DoNotOptimize(entry);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete shared_state;
+  }
+}
+BENCHMARK(BM_GetCacheEntryHit)->Arg(0)->Arg(1)->ThreadRange(1, 16);
+
+}  // namespace
@@ -0,0 +1,158 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/cache_hot_set.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/serialization/batch.h"
+#include "tensorstore/serialization/serialization.h"
+#include "tensorstore/serialization/std_vector.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// Asynchronous state of `WarmCachePool`.
+struct WarmCachePoolState
+    : public internal::AtomicReferenceCount<WarmCachePoolState> {
+  struct Read {
+    CachePtr<AsyncCache> cache;
+    std::string key;
+  };
+
+  // Reads in order of decreasing priority.
+  std::vector<Read> reads;
+  size_t next_read = 0;
+  size_t max_concurrent_reads;
+  Promise<void> promise;
+
+  // Issues the next batch of reads, or completes the operation.
+  static void IssueReads(internal::IntrusivePtr<WarmCachePoolState> self) {
+    if (self->next_read == self->reads.size() ||
+        !self->promise.result_needed()) {
+      self->promise.SetResult(absl::OkStatus());
+      return;
+    }
+    // Becomes ready once all reads in this batch have completed, regardless
+    // of whether they succeeded.
+    auto [batch_promise, batch_future] =
+        PromiseFuturePair<void>::Make(absl::OkStatus());
+    {
+      auto batch = Batch::New();
+      const size_t end = std::min(self->reads.size(),
+                                  self->next_read + self->max_concurrent_reads);
+      for (; self->next_read < end; ++self->next_read) {
+        auto& read = self->reads[self->next_read];
+        auto entry = GetCacheEntry(read.cache, read.key);
+        AsyncCache::AsyncCacheReadRequest request;
+        // Any cached data is sufficient.
+        request.staleness_bound = absl::InfinitePast();
+        request.batch = batch;
+        entry->Read(request).ExecuteWhenReady(
+            [entry, batch_promise = batch_promise](ReadyFuture<const void>) {});
+      }
+      // Destroying `batch` submits the reads.
+    }
+    batch_promise = {};
+    batch_future.ExecuteWhenReady(
+        [self = std::move(self)](ReadyFuture<const void>) mutable {
+          IssueReads(std::move(self));
+        });
+  }
+};
+
+}  // namespace
+
+CacheHotSet GetCacheHotSet(CachePool& pool, size_t max_bytes) {
+  CacheHotSet hot_set;
+  auto entries = internal_cache::GetRecentlyUsedEntries(
+      internal_cache::Access::StaticCast<internal_cache::CachePoolImpl>(&pool),
+      max_bytes);
+  hot_set.entries.reserve(entries.size());
+  for (auto& entry : entries) {
+    hot_set.entries.push_back(CacheHotSetEntry{
+        entry.cache_type->name(), std::move(entry.cache_identifier),
+        std::move(entry.key), entry.num_bytes});
+  }
+  return hot_set;
+}
+
+Result<std::string> EncodeCacheHotSet(const CacheHotSet& hot_set) {
+  return serialization::EncodeBatch(hot_set);
+}
+
+Result<CacheHotSet> DecodeCacheHotSet(std::string_view encoded) {
+  CacheHotSet hot_set;
+  TENSORSTORE_RETURN_IF_ERROR(serialization::DecodeBatch(encoded, hot_set));
+  return hot_set;
+}
+
+Future<const void> WarmCachePool(CachePool& pool, const CacheHotSet& hot_set,
+                                 const WarmCachePoolOptions& options) {
+  auto* pool_impl =
+      internal_cache::Access::StaticCast<internal_cache::CachePoolImpl>(&pool);
+  size_t max_bytes = options.max_bytes;
+  if (max_bytes == 0) max_bytes = pool.limits().total_bytes_limit / 2;
+
+  // Caches of `pool`, by type name and identifier.
+  absl::flat_hash_map<std::pair<std::string_view, std::string_view>,
+                      CachePtr<AsyncCache>>
+      caches;
+  for (auto& cache : internal_cache::GetIdentifiedCaches(pool_impl)) {
+    auto* async_cache = dynamic_cast<AsyncCache*>(cache.get());
+    if (!async_cache) continue;
+    const auto* cache_impl =
+        internal_cache::Access::StaticCast<internal_cache::CacheImpl>(
+            cache.get());
+    caches.emplace(std::pair(std::string_view(cache_impl->cache_type_->name()),
+                             cache->cache_identifier()),
+                   CachePtr<AsyncCache>(async_cache));
+  }
+
+  auto state = internal::MakeIntrusivePtr<WarmCachePoolState>();
+  state->max_concurrent_reads =
+      std::max(size_t(1), options.max_concurrent_reads);
+  size_t total_bytes = 0;
+  for (const auto& entry : hot_set.entries) {
+    if (total_bytes + entry.num_bytes > max_bytes) break;
+    auto it = caches.find(std::pair(std::string_view(entry.cache_type),
+                                    std::string_view(entry.cache_identifier)));
+    if (it == caches.end()) continue;
+    total_bytes += entry.num_bytes;
+    state->reads.push_back({it->second, entry.key});
+  }
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  state->promise = std::move(promise);
+  WarmCachePoolState::IssueReads(std::move(state));
+  return std::move(future);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
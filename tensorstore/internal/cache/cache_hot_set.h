@@ -0,0 +1,114 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_CACHE_HOT_SET_H_
+#define TENSORSTORE_INTERNAL_CACHE_CACHE_HOT_SET_H_
+
+/// \file
+///
+/// Snapshots of the most valuable entries of a `CachePool`, used to warm the
+/// cache of a new process.
+///
+/// A hot set records only the cache and key of each entry, not its data.  A
+/// process periodically records and persists the hot set of its cache pool,
+/// and after a restart, once the same caches have been re-created (e.g. by
+/// re-opening the same TensorStores), calls `WarmCachePool` to re-read the
+/// recorded entries in the background.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Cache entry recorded in a `CacheHotSet`.
+struct CacheHotSetEntry {
+  /// Name of the C++ type of the cache, `typeid(CacheType).name()`, as
+  /// specified to `GetCache`.
+  std::string cache_type;
+
+  /// Identifier of the cache, as specified to `GetCache`.
+  std::string cache_identifier;
+
+  /// Key of the entry.
+  std::string key;
+
+  /// Size of the entry, in bytes, when the hot set was recorded.
+  uint64_t num_bytes;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.cache_type, x.cache_identifier, x.key, x.num_bytes);
+  };
+};
+
+/// Recorded entries of a `CachePool`, in order of decreasing priority.
+struct CacheHotSet {
+  std::vector<CacheHotSetEntry> entries;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.entries);
+  };
+};
+
+/// Records the hot set of `pool`.
+///
+/// Only entries of caches with a non-empty identifier, which can be found
+/// again by `WarmCachePool`, are recorded.  Entries that are currently in use
+/// are not in the eviction queue and are also not recorded.
+///
+/// \param max_bytes Entries are recorded, in order of decreasing priority,
+///     until their total size reaches this limit.
+CacheHotSet GetCacheHotSet(CachePool& pool, size_t max_bytes);
+
+/// Encodes `hot_set` in a compact binary format, for persisting it.
+Result<std::string> EncodeCacheHotSet(const CacheHotSet& hot_set);
+
+/// Decodes a hot set encoded by `EncodeCacheHotSet`.
+Result<CacheHotSet> DecodeCacheHotSet(std::string_view encoded);
+
+/// Options for `WarmCachePool`.
+struct WarmCachePoolOptions {
+  /// Maximum total size, in bytes, of the recorded entries to read.  If
+  /// `0`, half of the `total_bytes_limit` of the pool is used, in order to
+  /// leave room for entries read by foreground requests.
+  size_t max_bytes = 0;
+
+  /// Maximum number of reads in progress at once.  The reads are issued in
+  /// successive batches of this size, in order of decreasing priority, which
+  /// bounds the load they add to that of foreground reads.
+  size_t max_concurrent_reads = 8;
+};
+
+/// Reads the entries of `hot_set` into `pool`, in the background.
+///
+/// Only entries of `AsyncCache` caches that currently exist in `pool` are
+/// read.  Entries already cached, or being read by a foreground request, are
+/// not read again.  Errors are ignored.
+///
+/// \returns A future that becomes ready once all reads have completed.
+Future<const void> WarmCachePool(CachePool& pool, const CacheHotSet& hot_set,
+                                 const WarmCachePoolOptions& options = {});
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_CACHE_HOT_SET_H_
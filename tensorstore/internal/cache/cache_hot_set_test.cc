@@ -0,0 +1,171 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/cache_hot_set.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::internal::AsyncCache;
+using ::tensorstore::internal::CacheHotSet;
+using ::tensorstore::internal::CachePool;
+using ::tensorstore::internal::CachePtr;
+using ::tensorstore::internal::DecodeCacheHotSet;
+using ::tensorstore::internal::EncodeCacheHotSet;
+using ::tensorstore::internal::GetCache;
+using ::tensorstore::internal::GetCacheHotSet;
+using ::tensorstore::internal::WarmCachePool;
+using ::tensorstore::internal::WarmCachePoolOptions;
+using ::testing::ElementsAre;
+
+// Cache that completes each read immediately and records the keys read.
+class TestCache : public AsyncCache {
+ public:
+  using ReadData = size_t;
+  class Entry : public AsyncCache::Entry {
+   public:
+    using OwningCache = TestCache;
+    void DoRead(AsyncCacheReadRequest request) override {
+      auto& cache = GetOwningCache(*this);
+      {
+        absl::MutexLock lock(&cache.mutex);
+        cache.keys_read.push_back(std::string(this->key()));
+      }
+      ReadSuccess({std::make_shared<size_t>(1000),
+                   {tensorstore::StorageGeneration::FromString("g"),
+                    absl::Now()}});
+    }
+    size_t ComputeReadDataSizeInBytes(const void* data) override {
+      return *static_cast<const size_t*>(data);
+    }
+  };
+  class TransactionNode : public AsyncCache::TransactionNode {
+   public:
+    using OwningCache = TestCache;
+    using AsyncCache::TransactionNode::TransactionNode;
+    void DoRead(AsyncCacheReadRequest request) override {}
+  };
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    return new TransactionNode(static_cast<Entry&>(entry));
+  }
+
+  std::vector<std::string> GetKeysRead() {
+    absl::MutexLock lock(&mutex);
+    return keys_read;
+  }
+
+  absl::Mutex mutex;
+  std::vector<std::string> keys_read;
+};
+
+CachePtr<TestCache> GetTestCache(CachePool* pool, std::string identifier) {
+  return GetCache<TestCache>(pool, identifier,
+                             [] { return std::make_unique<TestCache>(); });
+}
+
+void ReadEntries(const CachePtr<TestCache>& cache,
+                 const std::vector<std::string>& keys) {
+  for (const auto& key : keys) {
+    TENSORSTORE_ASSERT_OK(GetCacheEntry(cache, key)->Read({}).result());
+  }
+}
+
+std::vector<std::string> GetKeys(const CacheHotSet& hot_set) {
+  std::vector<std::string> keys;
+  for (const auto& entry : hot_set.entries) keys.push_back(entry.key);
+  return keys;
+}
+
+TEST(CacheHotSetTest, MostRecentlyUsedFirst) {
+  auto pool = CachePool::Make(CachePool::Limits{1000000});
+  auto cache = GetTestCache(pool.get(), "x");
+  // Entries of caches without an identifier are not recorded.
+  auto anonymous_cache = GetTestCache(pool.get(), "");
+  ReadEntries(cache, {"a", "b", "c", "a"});
+  ReadEntries(anonymous_cache, {"d"});
+
+  auto hot_set = GetCacheHotSet(*pool, 1000000);
+  EXPECT_THAT(GetKeys(hot_set), ElementsAre("a", "c", "b"));
+  for (const auto& entry : hot_set.entries) {
+    EXPECT_EQ("x", entry.cache_identifier);
+    EXPECT_EQ(typeid(TestCache).name(), entry.cache_type);
+    EXPECT_LE(1000, entry.num_bytes);
+  }
+
+  // Limited by `max_bytes`.
+  EXPECT_THAT(GetKeys(GetCacheHotSet(*pool, 1500)), ElementsAre("a", "c"));
+}
+
+TEST(CacheHotSetTest, EncodeDecode) {
+  CacheHotSet hot_set;
+  hot_set.entries.push_back({"type", "id", std::string("k\0ey", 4), 42});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeCacheHotSet(hot_set));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, DecodeCacheHotSet(encoded));
+  ASSERT_EQ(1, decoded.entries.size());
+  EXPECT_EQ("type", decoded.entries[0].cache_type);
+  EXPECT_EQ("id", decoded.entries[0].cache_identifier);
+  EXPECT_EQ(std::string("k\0ey", 4), decoded.entries[0].key);
+  EXPECT_EQ(42, decoded.entries[0].num_bytes);
+  EXPECT_FALSE(DecodeCacheHotSet("invalid").ok());
+}
+
+TEST(CacheHotSetTest, Warm) {
+  CacheHotSet hot_set;
+  {
+    auto pool = CachePool::Make(CachePool::Limits{1000000});
+    auto cache = GetTestCache(pool.get(), "x");
+    auto other_cache = GetTestCache(pool.get(), "y");
+    ReadEntries(cache, {"a", "b", "c", "d"});
+    ReadEntries(other_cache, {"e"});
+    hot_set = GetCacheHotSet(*pool, 1000000);
+  }
+  ASSERT_THAT(GetKeys(hot_set), ElementsAre("e", "d", "c", "b", "a"));
+
+  // New pool, in which only cache "x" has been re-created.
+  auto pool = CachePool::Make(CachePool::Limits{1000000});
+  auto cache = GetTestCache(pool.get(), "x");
+  // Already cached, and not read again.
+  ReadEntries(cache, {"c"});
+
+  // The budget includes "c", but not "e", which belongs to a cache that does
+  // not exist in the new pool.
+  WarmCachePoolOptions options;
+  options.max_bytes = 0;
+  for (size_t i = 1; i < 4; ++i) {
+    options.max_bytes += hot_set.entries[i].num_bytes;
+  }
+  options.max_concurrent_reads = 1;
+  TENSORSTORE_ASSERT_OK(WarmCachePool(*pool, hot_set, options).result());
+  EXPECT_THAT(cache->GetKeysRead(), ElementsAre("c", "d", "b"));
+}
+
+}  // namespace
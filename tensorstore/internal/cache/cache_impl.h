@@ -31,6 +31,7 @@
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/base/call_once.h"
 #include "absl/base/optimization.h"
@@ -38,10 +39,13 @@
 #include "absl/functional/function_ref.h"
 #include "absl/hash/hash.h"
 #include "absl/log/absl_log.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/cache/cache_pool_limits.h"
+#include "tensorstore/internal/cache/frequency_sketch.h"
 #include "tensorstore/internal/container/heterogeneous_container.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -70,6 +74,17 @@ struct LruListNode {
 
 class CacheEntryImpl;
 
+// Byte accounting for a `CacheQuota` of a cache pool.
+struct CacheQuotaState {
+  std::string cache_type;
+  size_t reserved_bytes;
+  size_t max_bytes;
+
+  // Sum of `num_bytes_` over the entries of all caches to which the quota
+  // applies.
+  std::atomic<size_t> bytes{0};
+};
+
 // Weak reference state for a cache entry.
 //
 // This is stored in a separate heap allocation from the entry itself, in order
@@ -143,11 +158,31 @@ class CacheEntryImpl : public internal_cache::LruListNode {
   // Set if the return value of `DoGetSizeInBytes` may have changed.
   constexpr static Flags kSizeChanged = 1;
 
+  // Set when a strong reference to an existing entry is acquired, and cleared
+  // when the entry is returned to the eviction queue.  Used by the segmented
+  // LRU eviction policies to promote entries that are used more than once.
+  std::atomic<bool> referenced_{false};
+
+  // Indicates whether the entry is in the protected segment of its LRU shard,
+  // and the number of bytes accounted to that segment.  Guarded by the LRU
+  // shard mutex.
+  bool protected_ = false;
+  size_t protected_num_bytes_ = 0;
+
+  // Position of the entry in the eviction order of its LRU shard, used to
+  // compare entries in different queues of the shard.  Guarded by the LRU
+  // shard mutex.
+  uint64_t lru_sequence_ = 0;
+
   // Initially set to `nullptr`.  Allocated when the first weak reference is
   // obtained, and remains until the entry is destroyed even if all weak
   // references are released.
   std::atomic<CacheEntryWeakState*> weak_state_{nullptr};
 
+  // Number of outstanding `PinEntry` calls.  While non-zero, `num_bytes_` is
+  // included in `CachePoolImpl::pinned_bytes_`.  Guarded by `mutex_`.
+  uint32_t pin_count_ = 0;
+
   virtual ~CacheEntryImpl() = default;
 };
 
@@ -176,6 +211,10 @@ class CacheImpl {
   /// into the `caches_` table.
   const std::type_info* cache_type_;
 
+  /// Quota state for this cache's type, or `nullptr` if no quota applies.
+  /// Set when this cache is added to the pool.
+  CacheQuotaState* quota_ = nullptr;
+
   /// If non-empty, this cache is stored in the `caches_` table of the cache
   /// pool, and should only be destroyed once:
   ///
@@ -218,7 +257,7 @@ class CacheImpl {
   /// If a thread causes the reference count to reach a ``ShouldDelete == true`
   /// state from a `ShouldDelete == false` state, then the thread must destroy
   /// the cache immediately. However, because of the use of multiple mutexes
-  /// (per shard mutexes on the cache entries hash table, `pool_->lru mutex_`,
+  /// (per shard mutexes on the cache entries hash table, `pool_->lru_shards_`,
   /// `pool_->caches_mutex_`), it is possible for another thread that is
   /// modifying `reference_count` to encounter a cache already in the
   /// `ShouldDelete == true`. In this case, the other thread is NOT responsible
@@ -266,21 +305,93 @@ class CacheImpl {
 
 class CachePoolImpl {
  public:
-  explicit CachePoolImpl(const CachePoolLimits& limits);
+  explicit CachePoolImpl(const CachePoolLimits& limits,
+                         span<const internal::CacheQuota> quotas);
 
   using CacheKey = CacheImpl::CacheKey;
 
   CachePoolLimits limits_;
   std::atomic<size_t> total_bytes_;
 
-  // Protects access to `eviction_queue_`.  If `lru_mutex_` is held at the same
-  // time as `caches_mutex_`, `caches_mutex_` must be acquired first.  If
-  // `lru_mutex_` is held at the same time as `entries_mutex_`, `lru_mutex_`
-  // must be acquired first.
-  absl::Mutex lru_mutex_;
+  // Sum of `num_bytes_` over the pinned entries.  These bytes are included in
+  // `total_bytes_`, but are excluded when comparing `total_bytes_` to
+  // `limits_.total_bytes_limit`.
+  std::atomic<size_t> pinned_bytes_{0};
+
+  struct LruQueue {
+    // next points to the front of the queue, which is the first to be evicted.
+    //
+    // With the segmented LRU eviction policies, this is the probationary
+    // segment.
+    LruListNode eviction_queue;
+
+    // Protected segment used by the segmented LRU eviction policies.  Entries
+    // are evicted from this queue only once `eviction_queue` is empty.
+    LruListNode protected_queue;
+  };
+
+  // The entries of caches to which no quota applies are in the base
+  // `LruQueue`.
+  struct ABSL_CACHELINE_ALIGNED LruShard : public LruQueue {
+    // Protects access to the queues.  If `mutex` is held at the same time as
+    // `caches_mutex_`, `caches_mutex_` must be acquired first.  If `mutex` is
+    // held at the same time as `entries_mutex_`, `mutex` must be acquired
+    // first.  If multiple shard mutexes are held at the same time, they must
+    // be acquired in order of increasing shard index.
+    absl::Mutex mutex;
+
+    // Queues for the entries of caches to which each quota applies, indexed
+    // like `quotas_`.  Keeping these separate allows eviction to skip the
+    // entries within a reserved amount without scanning them.
+    std::unique_ptr<LruQueue[]> quota_queues;
+
+    // Sum of `protected_num_bytes_` over the entries in the protected
+    // segments of all queues.
+    size_t protected_bytes = 0;
+
+    // Value of `CacheEntryImpl::lru_sequence_` for the next entry added to a
+    // queue.
+    uint64_t next_lru_sequence = 0;
+  };
+
+  // LRU eviction queues.  Each entry is assigned to a shard by the hash of its
+  // address.  Eviction starts from the shard of the entry that was released,
+  // and proceeds to the other shards while the pool remains over its limit.
+  const size_t num_lru_shards_;
+  std::unique_ptr<LruShard[]> lru_shards_;
 
-  // next points to the front of the queue, which is the first to be evicted.
-  LruListNode eviction_queue_;
+  // Shard from which to start eviction when the size of an entry increases.
+  std::atomic<size_t> next_eviction_shard_{0};
+
+  // Maximum value of `LruShard::protected_bytes` for each shard.
+  size_t protected_bytes_limit_;
+
+  // Access frequency estimates, used by the `kTinyLfu` eviction policy.  Null
+  // for other policies.
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
+
+  // State corresponding to each quota specified when the pool was created.
+  const size_t num_quotas_;
+  std::unique_ptr<CacheQuotaState[]> quotas_;
+
+  // Returns the quota state for caches of the specified type, or `nullptr` if
+  // no quota applies.
+  CacheQuotaState* FindQuota(std::string_view cache_type);
+
+  size_t LruShardIndexForEntry(const CacheEntryImpl* entry) const {
+    if (num_lru_shards_ == 1) return 0;
+    return absl::Hash<const void*>{}(entry) % num_lru_shards_;
+  }
+
+  LruShard& LruShardForEntry(const CacheEntryImpl* entry) {
+    return lru_shards_[LruShardIndexForEntry(entry)];
+  }
+
+  // Returns the queue of `lru_shard` that holds the entries of `cache`.
+  LruQueue& LruQueueForCache(LruShard& lru_shard, const CacheImpl* cache) {
+    if (!cache->quota_) return lru_shard;
+    return lru_shard.quota_queues[cache->quota_ - quotas_.get()];
+  }
 
   // Protects access to `caches_`.
   absl::Mutex caches_mutex_;
@@ -388,7 +499,42 @@ inline bool HasLruCache(CachePoolImpl* pool) {
   return pool && pool->limits_.total_bytes_limit != 0;
 }
 
-void UpdateTotalBytes(CachePoolImpl& pool, ptrdiff_t change);
+void UpdateTotalBytes(CachePoolImpl& pool, CacheImpl* cache, ptrdiff_t change);
+
+// Pins `entry`, such that its size is accounted against
+// `CachePoolLimits::pinned_bytes_limit` rather than `total_bytes_limit`.
+//
+// The caller must hold a strong reference to `entry` until the matching call
+// to `UnpinEntry`; the reference is what prevents eviction.
+//
+// \error `absl::StatusCode::kResourceExhausted` if the pinned bytes limit of
+//     the pool would be exceeded.
+absl::Status PinEntry(CacheEntryImpl* entry);
+
+// Releases a pin acquired by a successful call to `PinEntry`.
+void UnpinEntry(CacheEntryImpl* entry);
+
+// Entry of a cache pool returned by `GetRecentlyUsedEntries`.
+struct RecentlyUsedEntry {
+  const std::type_info* cache_type;
+  std::string cache_identifier;
+  std::string key;
+  size_t num_bytes;
+};
+
+// Returns the entries in the eviction queues of `pool` that belong to caches
+// with a non-empty identifier, in order of decreasing priority, until their
+// total size reaches `max_bytes`.
+//
+// Within each LRU shard, entries in the protected segment precede entries in
+// the probationary segment, and more recently used entries precede less
+// recently used entries.  The entries of the shards are interleaved.
+std::vector<RecentlyUsedEntry> GetRecentlyUsedEntries(CachePoolImpl* pool,
+                                                      size_t max_bytes);
+
+// Returns strong references to the caches of `pool` that have a non-empty
+// identifier.
+std::vector<CachePtr<Cache>> GetIdentifiedCaches(CachePoolImpl* pool);
 
 }  // namespace internal_cache
 }  // namespace tensorstore
@@ -0,0 +1,65 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/cache_pin.h"
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/cache/cache.h"
+
+namespace tensorstore {
+namespace internal {
+
+CachePinSet::~CachePinSet() { Clear(); }
+
+absl::Status CachePinSet::Add(CacheEntry& entry) {
+  absl::MutexLock lock(&mutex_);
+  if (entries_.contains(&entry)) return absl::OkStatus();
+  auto* entry_impl =
+      internal_cache::Access::StaticCast<internal_cache::CacheEntryImpl>(
+          &entry);
+  if (auto status = internal_cache::PinEntry(entry_impl); !status.ok()) {
+    return status;
+  }
+  entries_.emplace(&entry, PinnedCacheEntry<Cache>(&entry));
+  return absl::OkStatus();
+}
+
+void CachePinSet::Clear() {
+  absl::flat_hash_map<CacheEntry*, PinnedCacheEntry<Cache>> entries;
+  {
+    absl::MutexLock lock(&mutex_);
+    entries.swap(entries_);
+  }
+  for (auto& [entry, pinned_entry] : entries) {
+    internal_cache::UnpinEntry(
+        internal_cache::Access::StaticCast<internal_cache::CacheEntryImpl>(
+            entry));
+  }
+  // The strong references are released when `entries` is destroyed, which
+  // allows the entries to be evicted.
+}
+
+size_t CachePinSet::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace internal
+}  // namespace tensorstore
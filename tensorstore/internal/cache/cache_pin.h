@@ -0,0 +1,69 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_CACHE_PIN_H_
+#define TENSORSTORE_INTERNAL_CACHE_CACHE_PIN_H_
+
+#include <stddef.h>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Set of pinned cache entries.
+///
+/// Each entry added to the set is retained, and therefore not evicted, until
+/// the set is cleared or destroyed.  While pinned, the size of the entry counts
+/// towards `CachePoolLimits::pinned_bytes_limit` rather than
+/// `CachePoolLimits::total_bytes_limit`, so that pinned entries do not cause
+/// other entries of the pool to be evicted.
+///
+/// \threadsafety Thread safe.
+class CachePinSet : public AtomicReferenceCount<CachePinSet> {
+ public:
+  CachePinSet() = default;
+  CachePinSet(const CachePinSet&) = delete;
+  CachePinSet& operator=(const CachePinSet&) = delete;
+  ~CachePinSet();
+
+  /// Pins `entry`, unless it is already in this set.
+  ///
+  /// \error `absl::StatusCode::kResourceExhausted` if the pinned bytes limit
+  ///     of the cache pool would be exceeded.
+  absl::Status Add(CacheEntry& entry);
+
+  /// Unpins all entries in this set.
+  void Clear();
+
+  /// Returns the number of entries in this set.
+  size_t size() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<CacheEntry*, PinnedCacheEntry<Cache>> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+using CachePinSetPtr = IntrusivePtr<CachePinSet>;
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_CACHE_PIN_H_
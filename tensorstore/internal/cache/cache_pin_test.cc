@@ -0,0 +1,171 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/cache_pin.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/mutex.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::UniqueWriterLock;
+using ::tensorstore::internal::CachePinSet;
+using ::tensorstore::internal::CachePool;
+using ::tensorstore::internal::CachePtr;
+using ::tensorstore::internal::GetCache;
+using ::tensorstore::internal::GetCacheEntry;
+using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal::PinnedCacheEntry;
+
+class TestCache : public tensorstore::internal::Cache {
+ public:
+  class Entry : public Cache::Entry {
+   public:
+    using OwningCache = TestCache;
+
+    void ChangeSize(size_t new_size) {
+      UniqueWriterLock<Cache::Entry> lock(*this);
+      size = new_size;
+      NotifySizeChanged();
+    }
+
+    ~Entry() override { ++*num_destroyed; }
+
+    size_t size = 100;
+    size_t* num_destroyed;
+  };
+
+  Entry* DoAllocateEntry() override {
+    auto* entry = new Entry;
+    entry->num_destroyed = &num_destroyed;
+    return entry;
+  }
+  size_t DoGetSizeofEntry() override { return sizeof(Entry); }
+  size_t DoGetSizeInBytes(Cache::Entry* entry) override {
+    return static_cast<Entry*>(entry)->size;
+  }
+
+  size_t num_destroyed = 0;
+};
+
+CachePtr<TestCache> GetTestCache(CachePool* pool) {
+  return GetCache<TestCache>(pool, "", [] {
+    return std::make_unique<TestCache>();
+  });
+}
+
+TEST(CachePinSetTest, PinnedEntriesAreExcludedFromTotalBytesLimit) {
+  auto pool = CachePool::Make(CachePool::Limits{250});
+  auto cache = GetTestCache(pool.get());
+  auto pin_set = MakeIntrusivePtr<CachePinSet>();
+  for (const char* key : {"a", "b", "c"}) {
+    TENSORSTORE_EXPECT_OK(pin_set->Add(*GetCacheEntry(cache, key)));
+  }
+  EXPECT_EQ(3, pin_set->size());
+  // Unpinned entries that fit within `total_bytes_limit` are retained, even
+  // though the total size of all entries exceeds it.
+  GetCacheEntry(cache, "d");
+  GetCacheEntry(cache, "e");
+  EXPECT_EQ(0, cache->num_destroyed);
+  GetCacheEntry(cache, "f");
+  EXPECT_EQ(1, cache->num_destroyed);
+
+  // Adding an entry that is already pinned has no effect.
+  TENSORSTORE_EXPECT_OK(pin_set->Add(*GetCacheEntry(cache, "a")));
+  EXPECT_EQ(3, pin_set->size());
+
+  // Once unpinned, the entries are subject to `total_bytes_limit` again, and
+  // at most 2 of the 6 entries are retained.
+  pin_set->Clear();
+  EXPECT_EQ(0, pin_set->size());
+  EXPECT_GE(cache->num_destroyed, 4);
+}
+
+TEST(CachePinSetTest, PinnedBytesLimit) {
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 1000;
+  limits.pinned_bytes_limit = 150;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get());
+  auto pin_set = MakeIntrusivePtr<CachePinSet>();
+  TENSORSTORE_EXPECT_OK(pin_set->Add(*GetCacheEntry(cache, "a")));
+  EXPECT_THAT(pin_set->Add(*GetCacheEntry(cache, "b")),
+              MatchesStatus(absl::StatusCode::kResourceExhausted,
+                            "Pinning 100 bytes would exceed the pinned bytes "
+                            "limit of 150 bytes"));
+  EXPECT_EQ(1, pin_set->size());
+
+  // Pins held by another set count towards the same limit.
+  auto other_pin_set = MakeIntrusivePtr<CachePinSet>();
+  EXPECT_THAT(other_pin_set->Add(*GetCacheEntry(cache, "c")),
+              MatchesStatus(absl::StatusCode::kResourceExhausted));
+  pin_set = {};
+  TENSORSTORE_EXPECT_OK(other_pin_set->Add(*GetCacheEntry(cache, "c")));
+}
+
+TEST(CachePinSetTest, SizeChangeOfPinnedEntry) {
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 250;
+  limits.pinned_bytes_limit = 550;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get());
+  auto pin_set = MakeIntrusivePtr<CachePinSet>();
+  {
+    auto entry = GetCacheEntry(cache, "a");
+    TENSORSTORE_EXPECT_OK(pin_set->Add(*entry));
+    entry->ChangeSize(500);
+  }
+  // The growth of the pinned entry does not cause unpinned entries to be
+  // evicted.
+  GetCacheEntry(cache, "b");
+  GetCacheEntry(cache, "c");
+  EXPECT_EQ(0, cache->num_destroyed);
+  // The growth is accounted against the pinned bytes limit.
+  auto other_pin_set = MakeIntrusivePtr<CachePinSet>();
+  EXPECT_THAT(other_pin_set->Add(*GetCacheEntry(cache, "b")),
+              MatchesStatus(absl::StatusCode::kResourceExhausted));
+  // Once unpinned, the large entry is evicted along with the others.
+  pin_set = {};
+  EXPECT_EQ(3, cache->num_destroyed);
+}
+
+TEST(CachePinSetTest, NoLruCache) {
+  auto pool = CachePool::Make(CachePool::Limits{});
+  auto cache = GetTestCache(pool.get());
+  auto pin_set = MakeIntrusivePtr<CachePinSet>();
+  TENSORSTORE_EXPECT_OK(pin_set->Add(*GetCacheEntry(cache, "a")));
+  // Without an LRU cache, unreferenced entries are destroyed immediately, but
+  // pinned entries are retained.
+  GetCacheEntry(cache, "b");
+  EXPECT_EQ(1, cache->num_destroyed);
+  PinnedCacheEntry<TestCache> entry = GetCacheEntry(cache, "a");
+  EXPECT_EQ(1, cache->num_destroyed);
+  entry = {};
+  pin_set->Clear();
+  EXPECT_EQ(2, cache->num_destroyed);
+}
+
+}  // namespace
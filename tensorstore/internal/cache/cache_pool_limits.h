@@ -16,16 +16,76 @@
 #define TENSORSTORE_INTERNAL_CACHE_CACHE_POOL_LIMITS_H_
 
 #include <cstddef>
+#include <cstdint>
+#include <string>
 
 namespace tensorstore {
 namespace internal {
 
+/// Policy used by a cache pool to choose which unused entries to evict.
+enum class CacheEvictionPolicy : uint8_t {
+  /// Evicts the least-recently used entry.
+  kLru,
+
+  /// Segmented LRU: entries that are referenced again while in the cache are
+  /// promoted from a probationary segment to a protected segment, which holds
+  /// up to 80% of `total_bytes_limit`.  Entries are evicted from the
+  /// probationary segment first, so that entries referenced only once, as by
+  /// a sequential scan, do not displace entries that are repeatedly used.
+  kSegmentedLru,
+
+  /// Segmented LRU combined with TinyLFU admission: the access frequency of
+  /// every key is tracked approximately, and a newly-released probationary
+  /// entry is evicted in preference to the least-recently used probationary
+  /// entry if it has been accessed less frequently.
+  kTinyLfu,
+};
+
+/// Byte quota for the caches of a given type within a cache pool.
+///
+/// Quotas are specified separately from `CachePoolLimits`, when the pool is
+/// created by `CachePool::Make`, so that `CachePoolLimits` remains a literal
+/// type.
+struct CacheQuota {
+  /// Matched against the value returned by `Cache::DoGetCacheTypeName()`.
+  std::string cache_type;
+
+  /// Unused entries of matching caches are not evicted to satisfy
+  /// `CachePoolLimits::total_bytes_limit` while their total size does not
+  /// exceed this amount.
+  size_t reserved_bytes = 0;
+
+  /// If non-zero, unused entries of matching caches are evicted whenever their
+  /// total size exceeds this amount, even if the pool is within
+  /// `CachePoolLimits::total_bytes_limit`.
+  size_t max_bytes = 0;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.cache_type, x.reserved_bytes, x.max_bytes);
+  };
+};
+
 /// Memory limit parameters for a cache pool.
 struct CachePoolLimits {
   size_t total_bytes_limit = 0;
 
+  /// Limit on the total size of pinned entries, which are excluded from
+  /// `total_bytes_limit`.  If zero, the size of pinned entries is not limited.
+  size_t pinned_bytes_limit = 0;
+
+  /// Number of independently-locked LRU eviction queues.  With a single queue
+  /// (the default), entries are evicted in exact least-recently-used order.
+  /// With multiple queues, entries are assigned to a queue by hash, eviction
+  /// order is only approximately LRU, and releasing entries from many threads
+  /// concurrently does not serialize on a single mutex.
+  size_t lru_shards = 1;
+
+  /// Policy for choosing which unused entries to evict.
+  CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::kLru;
+
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.total_bytes_limit);
+    return f(x.total_bytes_limit, x.pinned_bytes_limit, x.lru_shards,
+             x.eviction_policy);
   };
 };
 
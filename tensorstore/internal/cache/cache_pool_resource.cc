@@ -14,13 +14,19 @@
 
 #include "tensorstore/internal/cache/cache_pool_resource.h"
 
+#include <string_view>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache_key/std_vector.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_array.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
@@ -29,23 +35,74 @@ namespace {
 
 struct CachePoolResourceTraits
     : public ContextResourceTraits<CachePoolResource> {
-  using Spec = CachePool::Limits;
+  // Sharing a cache pool between independently-decoded objects only affects
+  // which entries are cached.
+  constexpr static bool shared_when_decoded = true;
+  struct Spec {
+    CachePool::Limits limits;
+    std::vector<CacheQuota> quotas;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.limits, x.quotas);
+    };
+  };
   using Resource = typename CachePoolResource::Resource;
-  static constexpr Spec Default() { return {}; }
+  static Spec Default() { return {}; }
   static constexpr auto JsonBinder() {
     namespace jb = tensorstore::internal_json_binding;
+    using Limits = CachePool::Limits;
     return jb::Object(
-        jb::Member("total_bytes_limit",
-                   jb::Projection(&Spec::total_bytes_limit,
-                                  jb::DefaultValue([](auto* v) { *v = 0; }))));
+        jb::Projection<&Spec::limits>(jb::Sequence(
+            jb::Member(
+                "total_bytes_limit",
+                jb::Projection(&Limits::total_bytes_limit,
+                               jb::DefaultValue([](auto* v) { *v = 0; }))),
+            jb::Member(
+                "pinned_bytes_limit",
+                jb::Projection(&Limits::pinned_bytes_limit,
+                               jb::DefaultValue([](auto* v) { *v = 0; }))),
+            jb::Member(
+                "lru_shards",
+                jb::Projection(&Limits::lru_shards,
+                               jb::DefaultValue([](auto* v) { *v = 1; },
+                                                jb::Integer<size_t>(1)))),
+            jb::Member(
+                "eviction_policy",
+                jb::Projection(
+                    &Limits::eviction_policy,
+                    jb::DefaultValue(
+                        [](auto* v) { *v = CacheEvictionPolicy::kLru; },
+                        jb::Enum<CacheEvictionPolicy, std::string_view>({
+                            {CacheEvictionPolicy::kLru, "lru"},
+                            {CacheEvictionPolicy::kSegmentedLru,
+                             "segmented_lru"},
+                            {CacheEvictionPolicy::kTinyLfu, "tinylfu"},
+                        })))))),
+        jb::Member(
+            "quotas",
+            jb::Projection(
+                &Spec::quotas,
+                jb::DefaultInitializedValue(jb::Array(jb::Object(
+                    jb::Member("cache_type",
+                               jb::Projection(&CacheQuota::cache_type)),
+                    jb::Member("reserved_bytes",
+                               jb::Projection(&CacheQuota::reserved_bytes,
+                                              jb::DefaultValue([](auto* v) {
+                                                *v = 0;
+                                              }))),
+                    jb::Member("max_bytes",
+                               jb::Projection(&CacheQuota::max_bytes,
+                                              jb::DefaultValue([](auto* v) {
+                                                *v = 0;
+                                              })))))))));
   }
-  static Result<Resource> Create(const Spec& limits,
+  static Result<Resource> Create(const Spec& spec,
                                  ContextResourceCreationContext context) {
-    return CachePool::WeakPtr(CachePool::Make(limits));
+    return CachePool::WeakPtr(CachePool::Make(spec.limits, spec.quotas));
   }
 
   static Spec GetSpec(const Resource& pool, const ContextSpecBuilder& builder) {
-    return pool->limits();
+    return {pool->limits(), pool->quotas()};
   }
   static void AcquireStrongReference(const Resource& p) {
     internal_cache::StrongPtrTraitsCachePool::increment(p.get());
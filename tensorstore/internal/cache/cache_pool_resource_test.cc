@@ -20,6 +20,7 @@
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
@@ -27,7 +28,9 @@
 namespace {
 
 using ::tensorstore::Context;
+using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::CacheEvictionPolicy;
 using ::tensorstore::internal::CachePoolResource;
 
 TEST(CachePoolResourceTest, Default) {
@@ -50,6 +53,92 @@ TEST(CachePoolResourceTest, TotalBytesLimitOnly) {
                               {{"total_bytes_limit", 100}}));
   auto cache = Context::Default().GetResource(resource_spec).value();
   EXPECT_EQ(100u, (*cache)->limits().total_bytes_limit);
+  EXPECT_EQ(1u, (*cache)->limits().lru_shards);
+}
+
+TEST(CachePoolResourceTest, LruShards) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"lru_shards", 8}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(100u, (*cache)->limits().total_bytes_limit);
+  EXPECT_EQ(8u, (*cache)->limits().lru_shards);
+}
+
+TEST(CachePoolResourceTest, LruShardsInvalid) {
+  EXPECT_THAT(Context::Resource<CachePoolResource>::FromJson(
+                  {{"total_bytes_limit", 100}, {"lru_shards", 0}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"lru_shards\": .*"));
+}
+
+TEST(CachePoolResourceTest, PinnedBytesLimit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"pinned_bytes_limit", 50}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(50u, (*cache)->limits().pinned_bytes_limit);
+  EXPECT_THAT(resource_spec.ToJson(),
+              ::testing::Optional(MatchesJson(
+                  {{"total_bytes_limit", 100}, {"pinned_bytes_limit", 50}})));
+}
+
+TEST(CachePoolResourceTest, EvictionPolicy) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"eviction_policy", "tinylfu"}}));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(CacheEvictionPolicy::kTinyLfu,
+            (*cache)->limits().eviction_policy);
+  EXPECT_THAT(resource_spec.ToJson(),
+              ::testing::Optional(MatchesJson(
+                  {{"total_bytes_limit", 100}, {"eviction_policy", "tinylfu"}})));
+}
+
+TEST(CachePoolResourceTest, EvictionPolicyDefault) {
+  auto resource_spec = Context::Resource<CachePoolResource>::DefaultSpec();
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(CacheEvictionPolicy::kLru, (*cache)->limits().eviction_policy);
+}
+
+TEST(CachePoolResourceTest, Quotas) {
+  ::nlohmann::json json_spec{
+      {"total_bytes_limit", 1000},
+      {"quotas",
+       {{{"cache_type", "ocdbt_btree_node"}, {"reserved_bytes", 100}},
+        {{"cache_type", "chunk"}, {"max_bytes", 500}}}}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CachePoolResource>::FromJson(json_spec));
+  auto cache = Context::Default().GetResource(resource_spec).value();
+  auto quotas = (*cache)->quotas();
+  ASSERT_EQ(2u, quotas.size());
+  EXPECT_EQ("ocdbt_btree_node", quotas[0].cache_type);
+  EXPECT_EQ(100u, quotas[0].reserved_bytes);
+  EXPECT_EQ(0u, quotas[0].max_bytes);
+  EXPECT_EQ("chunk", quotas[1].cache_type);
+  EXPECT_EQ(0u, quotas[1].reserved_bytes);
+  EXPECT_EQ(500u, quotas[1].max_bytes);
+  EXPECT_THAT(resource_spec.ToJson(),
+              ::testing::Optional(MatchesJson(json_spec)));
+}
+
+TEST(CachePoolResourceTest, QuotaMissingCacheType) {
+  EXPECT_THAT(Context::Resource<CachePoolResource>::FromJson(
+                  {{"quotas", {{{"max_bytes", 500}}}}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Error parsing object member \"quotas\": .*"));
+}
+
+TEST(CachePoolResourceTest, EvictionPolicyInvalid) {
+  EXPECT_THAT(
+      Context::Resource<CachePoolResource>::FromJson(
+          {{"total_bytes_limit", 100}, {"eviction_policy", "fifo"}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Error parsing object member \"eviction_policy\": .*"));
 }
 
 }  // namespace
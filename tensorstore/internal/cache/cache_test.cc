@@ -22,6 +22,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -31,11 +32,14 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/testing/concurrent.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace {
 
 using ::tensorstore::UniqueWriterLock;
 using ::tensorstore::internal::Cache;
+using ::tensorstore::internal::CacheEvictionPolicy;
+using ::tensorstore::internal::CacheQuota;
 using ::tensorstore::internal::CachePool;
 using ::tensorstore::internal::CachePtr;
 using ::tensorstore::internal::GetCache;
@@ -51,7 +55,7 @@ using ::testing::ElementsAre;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
 
-constexpr CachePool::Limits kSmallCacheLimits{10000000};
+const CachePool::Limits kSmallCacheLimits{10000000};
 
 CachePoolImpl* GetPoolImpl(const CachePool::StrongPtr& ptr) {
   return Access::StaticCast<CachePoolImpl>(ptr.get());
@@ -143,31 +147,63 @@ class TestCacheWithCachePool : public TestCache {
   CachePool::WeakPtr cache_pool;
 };
 
+class MetadataTestCache : public TestCache {
+ public:
+  using TestCache::TestCache;
+
+  std::string_view DoGetCacheTypeName() override { return "metadata"; }
+};
+
+class BulkTestCache : public TestCache {
+ public:
+  using TestCache::TestCache;
+
+  std::string_view DoGetCacheTypeName() override { return "bulk"; }
+};
+
 using EntryIdentifier = std::pair<std::string, void*>;
 
 std::pair<std::string, void*> GetEntryIdentifier(CacheEntryImpl* entry) {
   return {entry->key_, entry};
 }
 
-absl::flat_hash_set<EntryIdentifier> GetEntrySet(LruListNode* head) {
-  absl::flat_hash_set<EntryIdentifier> entries;
-  for (LruListNode* node = head->next; node != head; node = node->next) {
-    entries.emplace(
-        GetEntryIdentifier(Access::StaticCast<CacheEntryImpl>(node)));
-  }
-  return entries;
-}
-
 // Check the invariants of pool, which should contain the specified caches.
 void AssertInvariants(const CachePool::StrongPtr& pool,
                       absl::flat_hash_set<Cache*> expected_caches)
     ABSL_NO_THREAD_SAFETY_ANALYSIS {
   auto* pool_impl = GetPoolImpl(pool);
-  auto eviction_queue_entries = GetEntrySet(&pool_impl->eviction_queue_);
+  absl::flat_hash_set<EntryIdentifier> eviction_queue_entries;
+  for (size_t i = 0; i < pool_impl->num_lru_shards_; ++i) {
+    auto& lru_shard = pool_impl->lru_shards_[i];
+    size_t protected_bytes = 0;
+    for (size_t j = 0; j <= pool_impl->num_quotas_; ++j) {
+      auto& queue = j == 0 ? static_cast<CachePoolImpl::LruQueue&>(lru_shard)
+                           : lru_shard.quota_queues[j - 1];
+      for (auto* segment : {&queue.eviction_queue, &queue.protected_queue}) {
+        uint64_t prev_lru_sequence = 0;
+        for (LruListNode* node = segment->next; node != segment;
+             node = node->next) {
+          auto* entry = Access::StaticCast<CacheEntryImpl>(node);
+          EXPECT_TRUE(eviction_queue_entries.insert(GetEntryIdentifier(entry))
+                          .second);
+          EXPECT_EQ(&lru_shard, &pool_impl->LruShardForEntry(entry));
+          EXPECT_EQ(&queue,
+                    &pool_impl->LruQueueForCache(lru_shard, entry->cache_));
+          EXPECT_EQ(segment == &queue.protected_queue, entry->protected_);
+          // Entries are ordered from least to most recently used.
+          EXPECT_LE(prev_lru_sequence, entry->lru_sequence_);
+          prev_lru_sequence = entry->lru_sequence_;
+          protected_bytes += entry->protected_num_bytes_;
+        }
+      }
+    }
+    EXPECT_EQ(protected_bytes, lru_shard.protected_bytes);
+  }
 
   absl::flat_hash_set<EntryIdentifier> expected_eviction_queue_entries;
 
   size_t expected_total_bytes = 0;
+  std::vector<size_t> expected_quota_bytes(pool_impl->num_quotas_);
 
   // Verify that every cache owned by the pool is in `expected_caches`.
   for (auto* cache : pool_impl->caches_) {
@@ -194,6 +230,10 @@ void AssertInvariants(const CachePool::StrongPtr& pool,
               entry->num_bytes_,
               cache->DoGetSizeInBytes(Access::StaticCast<Cache::Entry>(entry)));
           expected_total_bytes += entry->num_bytes_;
+          if (auto* quota = cache_impl->quota_) {
+            expected_quota_bytes[quota - pool_impl->quotas_.get()] +=
+                entry->num_bytes_;
+          }
           if (entry->reference_count_.load() == 0) {
             expected_eviction_queue_entries.emplace(GetEntryIdentifier(entry));
           }
@@ -203,6 +243,9 @@ void AssertInvariants(const CachePool::StrongPtr& pool,
   }
 
   EXPECT_EQ(expected_total_bytes, pool_impl->total_bytes_);
+  for (size_t i = 0; i < expected_quota_bytes.size(); ++i) {
+    EXPECT_EQ(expected_quota_bytes[i], pool_impl->quotas_[i].bytes);
+  }
 
   EXPECT_THAT(expected_eviction_queue_entries,
               ::testing::IsSubsetOf(eviction_queue_entries));
@@ -836,6 +879,203 @@ TEST(CacheTest, ConcurrentDestroyCacheEvictEntries) {
       concurrent_op, concurrent_op, concurrent_op);
 }
 
+TEST(CacheTest, ShardedLruEvictsToLimit) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  limits.lru_shards = 8;
+  auto pool = CachePool::Make(limits);
+  auto test_cache = GetTestCache(pool.get(), "cache", log);
+  for (int i = 0; i < 10; ++i) {
+    auto entry = GetCacheEntry(test_cache, tensorstore::StrCat(i));
+    entry->ChangeSize(5000);
+  }
+  // Exactly two entries fit within the limit, regardless of which shards the
+  // entries were assigned to.
+  EXPECT_EQ(8, log->entry_destroy_log.size());
+  EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), limits.total_bytes_limit);
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {test_cache.get()});
+}
+
+TEST(CacheTest, ShardedLruConcurrentGetReleaseCacheEntry) {
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 1;
+  limits.lru_shards = 4;
+  auto pool = CachePool::Make(limits);
+  auto cache = GetTestCache(pool.get(), "cache");
+  const auto concurrent_op = [&](std::string_view key) {
+    return [&, key] {
+      // Get then release cache entry, which immediately evicts it.
+      auto entry = GetCacheEntry(cache, key);
+    };
+  };
+  TestConcurrent(
+      kDefaultIterations,
+      /*initialize=*/
+      [&] {},
+      /*finalize=*/
+      [&] {
+        TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {cache.get()});
+      },
+      // Concurrent operations:
+      concurrent_op("a"), concurrent_op("b"), concurrent_op("c"),
+      concurrent_op("d"));
+}
+
+class EvictionPolicyTest
+    : public ::testing::TestWithParam<CacheEvictionPolicy> {};
+
+INSTANTIATE_TEST_SUITE_P(Instantiation, EvictionPolicyTest,
+                         ::testing::Values(CacheEvictionPolicy::kSegmentedLru,
+                                           CacheEvictionPolicy::kTinyLfu));
+
+// Tests that entries referenced only once, as by a sequential scan, do not
+// displace entries that are repeatedly used.
+TEST_P(EvictionPolicyTest, ScanResistant) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  limits.eviction_policy = GetParam();
+  auto pool = CachePool::Make(limits);
+  auto test_cache = GetTestCache(pool.get(), "cache", log);
+  for (const char* key : {"a", "b", "c"}) {
+    auto entry = GetCacheEntry(test_cache, key);
+    entry->data = key;
+    entry->ChangeSize(1000);
+  }
+  for (const char* key : {"a", "b", "c"}) {
+    EXPECT_EQ(key, GetCacheEntry(test_cache, key)->data);
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {test_cache.get()});
+  for (int i = 0; i < 100; ++i) {
+    auto entry = GetCacheEntry(test_cache, tensorstore::StrCat("scan", i));
+    entry->data = "scan";
+    entry->ChangeSize(1000);
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {test_cache.get()});
+  EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), limits.total_bytes_limit);
+  for (const char* key : {"a", "b", "c"}) {
+    EXPECT_EQ(key, GetCacheEntry(test_cache, key)->data);
+  }
+}
+
+// Tests that the protected segment is bounded, such that repeatedly used
+// entries are still evicted once they exceed it.
+TEST_P(EvictionPolicyTest, ProtectedSegmentLimit) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  limits.eviction_policy = GetParam();
+  auto pool = CachePool::Make(limits);
+  auto test_cache = GetTestCache(pool.get(), "cache", log);
+  for (int i = 0; i < 20; ++i) {
+    const auto key = tensorstore::StrCat(i);
+    {
+      auto entry = GetCacheEntry(test_cache, key);
+      entry->data = key;
+      entry->ChangeSize(1000);
+    }
+    GetCacheEntry(test_cache, key);
+    TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(pool, {test_cache.get()});
+  }
+  EXPECT_LE(GetPoolImpl(pool)->protected_bytes_limit_, 8000u);
+  EXPECT_LE(GetPoolImpl(pool)->lru_shards_[0].protected_bytes, 8000u);
+  EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), limits.total_bytes_limit);
+  // The most recently used entry is retained.
+  EXPECT_EQ("19", GetCacheEntry(test_cache, "19")->data);
+}
+
+TEST(CacheTest, LruNotScanResistant) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  auto pool = CachePool::Make(limits);
+  auto test_cache = GetTestCache(pool.get(), "cache", log);
+  {
+    auto entry = GetCacheEntry(test_cache, "a");
+    entry->data = "a";
+    entry->ChangeSize(1000);
+  }
+  EXPECT_EQ("a", GetCacheEntry(test_cache, "a")->data);
+  for (int i = 0; i < 100; ++i) {
+    GetCacheEntry(test_cache, tensorstore::StrCat("scan", i))->ChangeSize(1000);
+  }
+  EXPECT_EQ("", GetCacheEntry(test_cache, "a")->data);
+}
+
+TEST(CacheTest, QuotaReservedBytes) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 10000;
+  const CacheQuota quotas[] = {{"metadata", /*reserved_bytes=*/3000}};
+  auto pool = CachePool::Make(limits, quotas);
+  auto metadata_cache =
+      GetTestCache<MetadataTestCache>(pool.get(), "metadata", log);
+  auto bulk_cache = GetTestCache<BulkTestCache>(pool.get(), "bulk", log);
+  for (const char* key : {"a", "b", "c", "d"}) {
+    auto entry = GetCacheEntry(metadata_cache, key);
+    entry->data = key;
+    entry->ChangeSize(1000);
+  }
+  for (int i = 0; i < 100; ++i) {
+    GetCacheEntry(bulk_cache, tensorstore::StrCat(i))->ChangeSize(1000);
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(
+      pool, {metadata_cache.get(), bulk_cache.get()});
+  EXPECT_LE(GetPoolImpl(pool)->total_bytes_.load(), limits.total_bytes_limit);
+  // Only the reserved amount is retained.
+  EXPECT_EQ(3000u, GetPoolImpl(pool)->quotas_[0].bytes.load());
+  EXPECT_EQ("", GetCacheEntry(metadata_cache, "a")->data);
+  EXPECT_EQ("d", GetCacheEntry(metadata_cache, "d")->data);
+}
+
+TEST(CacheTest, QuotaMaxBytes) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 100000;
+  const CacheQuota quotas[] = {
+      {"bulk", /*reserved_bytes=*/0, /*max_bytes=*/5000}};
+  auto pool = CachePool::Make(limits, quotas);
+  auto metadata_cache =
+      GetTestCache<MetadataTestCache>(pool.get(), "metadata", log);
+  auto bulk_cache = GetTestCache<BulkTestCache>(pool.get(), "bulk", log);
+  for (int i = 0; i < 10; ++i) {
+    GetCacheEntry(metadata_cache, tensorstore::StrCat(i))->ChangeSize(1000);
+    GetCacheEntry(bulk_cache, tensorstore::StrCat(i))->ChangeSize(1000);
+  }
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(
+      pool, {metadata_cache.get(), bulk_cache.get()});
+  EXPECT_EQ(5000u, GetPoolImpl(pool)->quotas_[0].bytes.load());
+  EXPECT_EQ(15000u, GetPoolImpl(pool)->total_bytes_.load());
+  EXPECT_THAT(log->entry_destroy_log,
+              UnorderedElementsAre(Pair("bulk", "0"), Pair("bulk", "1"),
+                                   Pair("bulk", "2"), Pair("bulk", "3"),
+                                   Pair("bulk", "4")));
+}
+
+TEST(CacheTest, QuotaEvictionOrder) {
+  auto log = std::make_shared<TestCache::RequestLog>();
+  CachePool::Limits limits;
+  limits.total_bytes_limit = 3000;
+  // Entries of caches with a quota are kept in a separate queue, but are still
+  // evicted in least-recently used order along with other entries.
+  const CacheQuota quotas[] = {{"metadata"}};
+  auto pool = CachePool::Make(limits, quotas);
+  auto metadata_cache =
+      GetTestCache<MetadataTestCache>(pool.get(), "metadata", log);
+  auto bulk_cache = GetTestCache<BulkTestCache>(pool.get(), "bulk", log);
+  GetCacheEntry(metadata_cache, "a")->ChangeSize(1000);
+  GetCacheEntry(bulk_cache, "b")->ChangeSize(1000);
+  GetCacheEntry(metadata_cache, "c")->ChangeSize(1000);
+  GetCacheEntry(bulk_cache, "d")->ChangeSize(1000);
+  EXPECT_THAT(log->entry_destroy_log, ElementsAre(Pair("metadata", "a")));
+  GetCacheEntry(metadata_cache, "e")->ChangeSize(1000);
+  EXPECT_THAT(log->entry_destroy_log,
+              ElementsAre(Pair("metadata", "a"), Pair("bulk", "b")));
+  TENSORSTORE_INTERNAL_ASSERT_CACHE_INVARIANTS(
+      pool, {metadata_cache.get(), bulk_cache.get()});
+}
+
 TEST(CacheTest, EvictEntryDestroyCache) {
   auto log = std::make_shared<TestCache::RequestLog>();
   CachePool::Limits limits;
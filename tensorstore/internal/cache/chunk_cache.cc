@@ -26,6 +26,9 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
 #include "tensorstore/driver/chunk.h"
@@ -37,6 +40,8 @@
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pin.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
 #include "tensorstore/internal/elementwise_function.h"
 #include "tensorstore/internal/grid_partition.h"
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -45,12 +50,16 @@
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/internal/nditerable.h"
+#include "tensorstore/internal/thread/adaptive_executor.h"
+#include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/read_write_options.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/element_pointer.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/extents.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -89,6 +98,46 @@ bool IsFullyOverwritten(ChunkCache::TransactionNode& node) {
   return true;
 }
 
+/// Starts writeback of the implicit transaction of `node` if writeback of
+/// non-transactional writes is delayed, since once a chunk is fully
+/// overwritten, there is no benefit to delaying its writeback further.
+///
+/// \param node Non-null pointer to transaction node.
+void MaybeStartDelayedWriteback(ChunkCache::TransactionNode& node) {
+  GetOwningCache(GetOwningEntry(node)).StartFullyOverwrittenWriteback(node);
+}
+
+/// Returns the total decoded size of the components of a chunk.
+size_t GetDecodedChunkBytes(const ChunkGridSpecification& grid) {
+  size_t chunk_bytes = 0;
+  for (const auto& component_spec : grid.components) {
+    chunk_bytes += ProductOfExtents(span(component_spec.chunk_shape)) *
+                   component_spec.dtype()->size;
+  }
+  return chunk_bytes;
+}
+
+/// Submits the commit of a delayed writeback `transaction` to `scheduler`,
+/// unless it has already been submitted, as indicated by `scheduled`.
+void ScheduleDelayedWriteback(WritebackScheduler& scheduler,
+                              std::atomic<bool>& scheduled, Executor executor,
+                              TransactionState::CommitPtr transaction,
+                              size_t num_bytes, bool high_priority) {
+  if (scheduled.exchange(true)) return;
+  scheduler.Schedule(
+      num_bytes, high_priority,
+      [executor = std::move(executor),
+       transaction = std::move(transaction)]() mutable {
+        Future<const void> future = transaction->future();
+        // Writeback may involve encoding the chunk, which must not block the
+        // scheduler.
+        executor([transaction = std::move(transaction)] {
+          transaction->RequestCommit();
+        });
+        return future;
+      });
+}
+
 /// TensorStore Driver ReadChunk implementation for the chunk cache, for the
 /// case of a non-transactional read.
 ///
@@ -154,6 +203,57 @@ struct ReadChunkImpl {
     return grid.components[component_index].array_spec.GetReadNDIterable(
         std::move(read_array), domain, std::move(chunk_transform), arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    // The cached chunk data is immutable, and therefore may be referenced
+    // directly.
+    auto& grid = GetOwningCache(*entry).grid();
+    auto domain = grid.GetCellDomain(component_index, entry->cell_indices());
+    SharedArray<const void, dynamic_rank(kMaxRank)> read_array{
+        ChunkCache::GetReadComponent(
+            AsyncCache::ReadLock<ChunkCache::ReadData>(*entry).data(),
+            component_index)};
+    return grid.components[component_index].array_spec.GetReadTransformedArray(
+        std::move(read_array), domain, std::move(chunk_transform));
+  }
+};
+
+/// TensorStore Driver ReadChunk implementation for the chunk cache, for the
+/// case of a non-transactional read of part of a cell by
+/// `ChunkCache::ReadCellRegion`.
+///
+/// This implements the `tensorstore::internal::ReadChunk::Impl` Poly interface.
+///
+/// The decoded region is not stored in the cache entry, which is retained only
+/// to keep the cache alive.
+struct PartialReadChunkImpl {
+  size_t component_index;
+  PinnedCacheEntry<ChunkCache> entry;
+  // Region of the cell that was read.
+  Box<> region;
+  // Zero-origin array of shape `region.shape()`.
+  SharedArray<const void> array;
+
+  absl::Status operator()(internal::LockCollection& lock_collection) const {
+    // The array is immutable and not shared with the cache entry.
+    return absl::OkStatus();
+  }
+
+  Result<NDIterable::Ptr> operator()(ReadChunk::BeginRead,
+                                     IndexTransform<> chunk_transform,
+                                     Arena* arena) const {
+    auto& grid = GetOwningCache(*entry).grid();
+    return grid.components[component_index].array_spec.GetReadNDIterable(
+        array, region, std::move(chunk_transform), arena);
+  }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    auto& grid = GetOwningCache(*entry).grid();
+    return grid.components[component_index].array_spec.GetReadTransformedArray(
+        array, region, std::move(chunk_transform));
+  }
 };
 
 /// TensorStore Driver ReadChunk implementation for the chunk cache, for the
@@ -225,6 +325,12 @@ struct ReadChunkTransactionImpl {
                                        std::move(read_array), read_generation,
                                        std::move(chunk_transform), arena);
   }
+
+  Result<TransformedSharedArray<const void>> operator()(
+      ReadChunk::GetArray, IndexTransform<> chunk_transform) const {
+    // Uncommitted writes in the transaction are not immutable.
+    return absl::UnimplementedError("");
+  }
 };
 
 /// TensorStore Driver WriteChunk implementation for the chunk cache.
@@ -339,6 +445,7 @@ struct WriteChunkImpl {
     node->is_modified = true;
     if (IsFullyOverwritten(*node)) {
       node->SetUnconditional();
+      MaybeStartDelayedWriteback(*node);
     }
     return {node->OnModified(), node->transaction()->future()};
   }
@@ -370,6 +477,9 @@ struct WriteChunkImpl {
               source_capabilities = WriteArraySourceCapabilities::
                   kImmutableAndCanRetainIndefinitely;
               break;
+            case can_take_ownership_of_source_data:
+              source_capabilities = WriteArraySourceCapabilities::kMutable;
+              break;
           }
           return {std::in_place, std::move(std::get<0>(info)),
                   source_capabilities};
@@ -381,13 +491,45 @@ struct WriteChunkImpl {
     }
     node->is_modified = true;
     node->SetUnconditional();
+    MaybeStartDelayedWriteback(*node);
     end_write_result = {node->OnModified(), node->transaction()->future()};
     return true;
   }
 };
 
+// Determines if a non-transactional read of `cell_to_source` from `entry`
+// should use `ChunkCache::ReadCellRegion`, and if so sets `region` to the
+// part of the cell domain that is requested.
+//
+// This is the case only if the cache pool does not retain chunks, no data is
+// cached for `entry`, and just part of the cell is requested.
+bool GetPartialReadRegion(ChunkCache& cache, ChunkCache::Entry& entry,
+                          size_t component_index,
+                          IndexTransformView<> cell_to_source, Box<>& region) {
+  if (auto* pool = cache.pool(); pool && pool->limits().total_bytes_limit) {
+    return false;
+  }
+  if (AsyncCache::ReadLock<ChunkCache::ReadData>(entry).stamp().time !=
+      absl::InfinitePast()) {
+    return false;
+  }
+  auto domain =
+      cache.grid().GetCellDomain(component_index, entry.cell_indices());
+  region.set_rank(domain.rank());
+  if (!GetOutputRange(cell_to_source, region).ok()) return false;
+  for (DimensionIndex i = 0; i < domain.rank(); ++i) {
+    region[i] = Intersect(region[i], domain[i]);
+  }
+  return !region.is_empty() && region != domain;
+}
+
 }  // namespace
 
+Future<SharedArray<const void>> ChunkCache::ReadCellRegion(
+    const ReadRequest& request, Entry& entry, BoxView<> region) {
+  return {};
+}
+
 void ChunkCache::Read(
     ReadRequest request,
     AnyFlowReceiver<absl::Status, ReadChunk, IndexTransform<>> receiver) {
@@ -398,6 +540,9 @@ void ChunkCache::Read(
   using ReadOperationState = ChunkOperationState<ReadChunk>;
 
   auto state = MakeIntrusivePtr<ReadOperationState>(std::move(receiver));
+  // A single batch is shared by the reads of all grid cells, such that cached
+  // chunks may be revalidated together.
+  if (!request.batch) request.batch = Batch::New();
   auto status = PartitionIndexTransformOverRegularGrid(
       component_spec.chunked_to_cell_dimensions, grid().chunk_shape,
       request.transform,
@@ -417,10 +562,14 @@ void ChunkCache::Read(
         ReadChunk chunk;
         chunk.transform = std::move(cell_to_source);
         Future<const void> read_future;
+        // Entry to add to `request.pin_set` once it has been read.
+        PinnedCacheEntry<ChunkCache> pin_entry;
         const auto get_cache_read_request = [&] {
           AsyncCache::AsyncCacheReadRequest cache_request;
           cache_request.staleness_bound = request.staleness_bound;
+          cache_request.stale_while_revalidate = request.stale_while_revalidate;
           cache_request.batch = request.batch;
+          cache_request.io_stats = request.io_stats;
           return cache_request;
         };
         if (request.transaction) {
@@ -432,13 +581,48 @@ void ChunkCache::Read(
           chunk.impl = ReadChunkTransactionImpl{request.component_index,
                                                 std::move(node)};
         } else {
+          Box<> region;
+          Future<SharedArray<const void>> region_future;
+          // Pinned entries need the entire cell.
+          if (!request.pin_set &&
+              GetPartialReadRegion(*this, *entry, request.component_index,
+                                   chunk.transform, region)) {
+            region_future = ReadCellRegion(request, *entry, region);
+          }
+          if (!region_future.null()) {
+            LinkValue(
+                [state, chunk = std::move(chunk),
+                 cell_transform = IndexTransform<>(cell_transform),
+                 component_index = request.component_index,
+                 entry = std::move(entry), region = std::move(region)](
+                    Promise<void> promise,
+                    ReadyFuture<SharedArray<const void>> future) mutable {
+                  chunk.impl = PartialReadChunkImpl{
+                      component_index, std::move(entry), std::move(region),
+                      std::move(future.value())};
+                  execution::set_value(state->shared_receiver->receiver,
+                                       std::move(chunk),
+                                       std::move(cell_transform));
+                },
+                state->promise, std::move(region_future));
+            return absl::OkStatus();
+          }
           read_future = entry->Read(get_cache_read_request());
+          if (request.pin_set) pin_entry = entry;
           chunk.impl = ReadChunkImpl{request.component_index, std::move(entry)};
         }
         LinkValue(
             [state, chunk = std::move(chunk),
-             cell_transform = IndexTransform<>(cell_transform)](
+             cell_transform = IndexTransform<>(cell_transform),
+             pin_set = pin_entry ? request.pin_set : CachePinSetPtr{},
+             pin_entry = std::move(pin_entry)](
                 Promise<void> promise, ReadyFuture<const void> future) mutable {
+              if (pin_entry) {
+                if (auto status = pin_set->Add(*pin_entry); !status.ok()) {
+                  state->SetError(std::move(status));
+                  return;
+                }
+              }
               execution::set_value(state->shared_receiver->receiver,
                                    std::move(chunk), std::move(cell_transform));
             },
@@ -473,8 +657,12 @@ void ChunkCache::Write(
             ComposeTransforms(request.transform, cell_transform));
         auto entry = GetEntryForGridCell(*this, grid_cell_indices);
         auto transaction_copy = request.transaction;
+        if (!transaction_copy && writeback_delay_.enabled()) {
+          transaction_copy = GetDelayedWritebackTransaction(*entry);
+        }
         TENSORSTORE_ASSIGN_OR_RETURN(
             auto node, GetTransactionNode(*entry, transaction_copy));
+        node->AttributeIoStats(request.io_stats);
         execution::set_value(
             receiver,
             WriteChunk{WriteChunkImpl{request.component_index, std::move(node)},
@@ -524,6 +712,118 @@ Future<const void> ChunkCache::Entry::Delete(OpenTransactionPtr transaction) {
   return node->transaction()->future();
 }
 
+void ChunkCache::SetWritebackDelay(const WritebackDelayOptions& options) {
+  writeback_delay_ = options;
+  if (options.enabled() && options.max_bytes != 0) {
+    delayed_writeback_bytes_ = std::make_shared<std::atomic<size_t>>(0);
+  } else {
+    delayed_writeback_bytes_ = nullptr;
+  }
+  if (options.enabled() &&
+      (options.max_concurrency != 0 || options.max_bytes_per_second != 0)) {
+    WritebackScheduler::Options scheduler_options;
+    scheduler_options.max_concurrency = options.max_concurrency;
+    scheduler_options.max_bytes_per_second = options.max_bytes_per_second;
+    writeback_scheduler_ =
+        MakeIntrusivePtr<WritebackScheduler>(scheduler_options);
+  } else {
+    writeback_scheduler_.reset();
+  }
+}
+
+OpenTransactionPtr ChunkCache::GetDelayedWritebackTransaction(Entry& entry) {
+  absl::MutexLock lock(&entry.delayed_writeback_mutex_);
+  if (auto& existing = entry.delayed_writeback_transaction_) {
+    if (auto transaction = existing->AcquireImplicitOpenPtr()) {
+      return transaction;
+    }
+    // Commit of the previous transaction has already started.
+    existing.reset();
+  }
+  const size_t chunk_bytes =
+      (delayed_writeback_bytes_ || writeback_scheduler_)
+          ? GetDecodedChunkBytes(grid())
+          : 0;
+  absl::Duration delay = writeback_delay_.max_delay;
+  if (delayed_writeback_bytes_) {
+    auto& total_bytes = *delayed_writeback_bytes_;
+    const size_t max_bytes = writeback_delay_.max_bytes;
+    size_t prev_bytes = total_bytes.load(std::memory_order_relaxed);
+    do {
+      if (prev_bytes + chunk_bytes > max_bytes) {
+        // Over budget: commit this write immediately.
+        return {};
+      }
+    } while (!total_bytes.compare_exchange_weak(prev_bytes,
+                                                prev_bytes + chunk_bytes));
+    // Once more than half of the budget is in use, shorten the delay in
+    // proportion to the remaining budget, such that writeback ramps up before
+    // the budget is exhausted.
+    const size_t half_max_bytes = max_bytes / 2;
+    if (prev_bytes > half_max_bytes) {
+      delay *= static_cast<double>(max_bytes - prev_bytes) /
+               static_cast<double>(max_bytes - half_max_bytes);
+    }
+  }
+  auto transaction = TransactionState::MakeImplicit();
+  entry.delayed_writeback_transaction_.reset(transaction.get());
+  std::shared_ptr<std::atomic<bool>> scheduled;
+  if (writeback_scheduler_) {
+    scheduled = std::make_shared<std::atomic<bool>>(false);
+  }
+  entry.delayed_writeback_scheduled_ = scheduled;
+  if (delayed_writeback_bytes_) {
+    transaction->future().ExecuteWhenReady(
+        [total_bytes = delayed_writeback_bytes_,
+         chunk_bytes](ReadyFuture<const void>) {
+          total_bytes->fetch_sub(chunk_bytes, std::memory_order_relaxed);
+        });
+  }
+  // The commit pointer held by the scheduled task also prevents the
+  // transaction from being aborted once all `OpenPtr` references are released.
+  ScheduleAt(absl::Now() + delay,
+             [executor = executor(), scheduler = writeback_scheduler_,
+              scheduled = std::move(scheduled), chunk_bytes,
+              transaction =
+                  TransactionState::CommitPtr(transaction.get())]() mutable {
+               if (scheduler) {
+                 ScheduleDelayedWriteback(*scheduler, *scheduled,
+                                          std::move(executor),
+                                          std::move(transaction), chunk_bytes,
+                                          /*high_priority=*/false);
+                 return;
+               }
+               // Writeback may involve encoding the chunk, which must not
+               // block the timer thread.
+               executor([transaction = std::move(transaction)] {
+                 transaction->RequestCommit();
+               });
+             });
+  return transaction;
+}
+
+void ChunkCache::StartFullyOverwrittenWriteback(TransactionNode& node) {
+  if (!writeback_delay_.enabled()) return;
+  auto* transaction = node.transaction();
+  if (!transaction->implicit_transaction()) return;
+  std::shared_ptr<std::atomic<bool>> scheduled;
+  if (writeback_scheduler_) {
+    auto& entry = GetOwningEntry(node);
+    absl::MutexLock lock(&entry.delayed_writeback_mutex_);
+    if (entry.delayed_writeback_transaction_.get() == transaction) {
+      scheduled = entry.delayed_writeback_scheduled_;
+    }
+  }
+  if (!scheduled) {
+    transaction->RequestCommit();
+    return;
+  }
+  ScheduleDelayedWriteback(*writeback_scheduler_, *scheduled, executor(),
+                           TransactionState::CommitPtr(transaction),
+                           GetDecodedChunkBytes(grid()),
+                           /*high_priority=*/true);
+}
+
 size_t ChunkCache::TransactionNode::ComputeWriteStateSizeInBytes() {
   size_t total = 0;
   const auto component_specs = this->component_specs();
@@ -596,8 +896,12 @@ void ChunkCache::TransactionNode::DoApply(ApplyOptions options,
         receiver, ReadState{{}, TimestampedStorageGeneration::Unconditional()});
     return;
   }
+  // Unless the write state must be merged with the read state, which may
+  // involve copying the chunk, the continuation just forwards the read state
+  // and is run inline.
   auto continuation = WithExecutor(
-      GetOwningCache(*this).executor(),
+      AdaptiveExecutor{GetOwningCache(*this).executor(),
+                       this->is_modified ? TaskCost::kLarge : TaskCost::kSmall},
       [this, receiver = std::move(receiver),
        specify_unchanged =
            options.apply_mode == ApplyOptions::kSpecifyUnchanged](
@@ -52,9 +52,13 @@
 #include <string_view>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/driver/chunk.h"
 #include "tensorstore/driver/read_request.h"
@@ -64,6 +68,7 @@
 #include "tensorstore/internal/async_write_array.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/writeback_scheduler.h"
 #include "tensorstore/internal/chunk_grid_specification.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/staleness_bound.h"
@@ -77,6 +82,59 @@
 namespace tensorstore {
 namespace internal {
 
+/// Options that control delayed writeback of non-transactional writes.
+///
+/// By default, each non-transactional write to a chunk is committed
+/// immediately, such that a sequence of writes that each cover only part of the
+/// same chunk results in a separate read-modify-write of that chunk for each
+/// write.  When delayed writeback is enabled, non-transactional writes to the
+/// same chunk that occur within `max_delay` share a single implicit
+/// transaction, and are written back together.
+struct WritebackDelayOptions {
+  /// Maximum time after the first write to a chunk before its writeback
+  /// begins.  Writeback begins sooner if the chunk is fully overwritten or the
+  /// `commit_future` of a write is forced.  A value of
+  /// `absl::ZeroDuration()` disables delayed writeback.
+  absl::Duration max_delay = absl::ZeroDuration();
+
+  /// Maximum total size in bytes of chunks for which writeback is delayed.
+  /// Once exceeded, further writes are committed immediately.  A value of `0`
+  /// indicates no limit.
+  ///
+  /// Once more than half of this budget is in use, the delay of newly-written
+  /// chunks is reduced in proportion to the remaining budget, such that
+  /// writeback increases gradually rather than only once the budget is
+  /// exhausted.
+  size_t max_bytes = 0;
+
+  /// Maximum number of delayed writebacks in progress at once.  Chunks that
+  /// are fully overwritten are written back before other chunks.  A value of
+  /// `0` indicates no limit.
+  size_t max_concurrency = 0;
+
+  /// Maximum average rate, in decoded bytes per second, at which delayed
+  /// writebacks are started.  A value of `0` indicates no limit.
+  size_t max_bytes_per_second = 0;
+
+  bool enabled() const { return max_delay > absl::ZeroDuration(); }
+
+  static constexpr auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.max_delay, x.max_bytes, x.max_concurrency,
+             x.max_bytes_per_second);
+  };
+
+  friend bool operator==(const WritebackDelayOptions& a,
+                         const WritebackDelayOptions& b) {
+    return a.max_delay == b.max_delay && a.max_bytes == b.max_bytes &&
+           a.max_concurrency == b.max_concurrency &&
+           a.max_bytes_per_second == b.max_bytes_per_second;
+  }
+  friend bool operator!=(const WritebackDelayOptions& a,
+                         const WritebackDelayOptions& b) {
+    return !(a == b);
+  }
+};
+
 /// Cache for chunked multi-dimensional arrays.
 class ChunkCache : public AsyncCache {
  public:
@@ -107,6 +165,21 @@ class ChunkCache : public AsyncCache {
     Future<const void> Delete(internal::OpenTransactionPtr transaction);
 
     size_t ComputeReadDataSizeInBytes(const void* read_data) override;
+
+   private:
+    friend class ChunkCache;
+
+    // Implicit transaction shared by non-transactional writes to this entry
+    // while writeback is delayed.
+    absl::Mutex delayed_writeback_mutex_;
+    TransactionState::WeakPtr delayed_writeback_transaction_
+        ABSL_GUARDED_BY(delayed_writeback_mutex_);
+
+    // Set once writeback of `delayed_writeback_transaction_` has been
+    // submitted to `ChunkCache::writeback_scheduler_`.  Shared with the
+    // delayed commit task.
+    std::shared_ptr<std::atomic<bool>> delayed_writeback_scheduled_
+        ABSL_GUARDED_BY(delayed_writeback_mutex_);
   };
 
   class TransactionNode : public AsyncCache::TransactionNode {
@@ -205,6 +278,8 @@ class ChunkCache : public AsyncCache {
   /// Returns the data copy executor.
   virtual const Executor& executor() const = 0;
 
+  std::string_view DoGetCacheTypeName() override { return "chunk"; }
+
   struct ReadRequest : public internal::DriverReadRequest {
     /// Component array index in the range `[0, grid().components.size())`.
     size_t component_index;
@@ -212,6 +287,9 @@ class ChunkCache : public AsyncCache {
     /// Cached data older than `staleness_bound` will not be returned without
     /// being rechecked.
     absl::Time staleness_bound;
+
+    /// Specifies `AsyncCacheReadRequest::stale_while_revalidate`.
+    absl::Duration stale_while_revalidate = absl::ZeroDuration();
   };
 
   /// Implements the behavior of `Driver::Read` for a given component array.
@@ -223,6 +301,27 @@ class ChunkCache : public AsyncCache {
       ReadRequest request,
       AnyFlowReceiver<absl::Status, ReadChunk, IndexTransform<>> receiver);
 
+  /// Reads just `region` of a component of a grid cell, without reading the
+  /// entire cell into the cache.
+  ///
+  /// This is called by `Read` for non-transactional reads of cells for which
+  /// no data is cached, if the cache pool does not retain chunks, such that
+  /// the data read for only part of a cell would be discarded anyway.
+  ///
+  /// The default implementation returns a null future, which indicates that
+  /// partial reads are unsupported, and that the entire cell should be read
+  /// through the cache entry.
+  ///
+  /// \param request The read request, with `request.component_index`
+  ///     specifying the component.
+  /// \param entry The entry for the grid cell, which is not modified.
+  /// \param region Non-empty region in the coordinates of the component
+  ///     array, contained within the cell domain.
+  /// \returns A null future, or a future for a zero-origin array of shape
+  ///     `region.shape()`.
+  virtual Future<SharedArray<const void>> ReadCellRegion(
+      const ReadRequest& request, Entry& entry, BoxView<> region);
+
   struct WriteRequest : public internal::DriverWriteRequest {
     /// Component array index in the range `[0, grid().components.size())`.
     size_t component_index;
@@ -239,6 +338,38 @@ class ChunkCache : public AsyncCache {
 
   Future<const void> DeleteCell(span<const Index> grid_cell_indices,
                                 internal::OpenTransactionPtr transaction);
+
+  /// Enables or disables delayed writeback of non-transactional writes.
+  ///
+  /// Should be called before any writes are issued.
+  void SetWritebackDelay(const WritebackDelayOptions& options);
+
+  /// Returns the options specified by `SetWritebackDelay`.
+  const WritebackDelayOptions& writeback_delay() const {
+    return writeback_delay_;
+  }
+
+  /// Starts writeback of the implicit transaction of `node`, which has been
+  /// fully overwritten, if writeback of non-transactional writes is delayed.
+  void StartFullyOverwrittenWriteback(TransactionNode& node);
+
+ private:
+  // Returns the implicit transaction to use for a non-transactional write to
+  // `entry`, or `nullptr` if the write should be committed immediately.
+  OpenTransactionPtr GetDelayedWritebackTransaction(Entry& entry);
+
+  WritebackDelayOptions writeback_delay_;
+
+  // Total size of chunks for which writeback is currently delayed.  Only
+  // allocated if `writeback_delay_.max_bytes != 0`.  Shared with the
+  // completion callbacks of the delayed transactions, which may outlive the
+  // cache.
+  std::shared_ptr<std::atomic<size_t>> delayed_writeback_bytes_;
+
+  // Paces delayed writebacks.  Only allocated if
+  // `writeback_delay_.max_concurrency` or
+  // `writeback_delay_.max_bytes_per_second` is non-zero.
+  WritebackSchedulerPtr writeback_scheduler_;
 };
 
 class ConcreteChunkCache : public ChunkCache {
@@ -218,7 +218,9 @@ class TestDriver : public ChunkCacheDriver {
 
 class CopyBenchmarkRunner {
  public:
-  CopyBenchmarkRunner(const BenchmarkConfig& config) : config(config) {
+  CopyBenchmarkRunner(const BenchmarkConfig& config,
+                      const CachePool::Limits& limits = {})
+      : config(config) {
     tensorstore::Executor executor;
     if (config.threads == 0) {
       executor = tensorstore::InlineExecutor{};
@@ -226,7 +228,7 @@ class CopyBenchmarkRunner {
       executor = tensorstore::internal::DetachedThreadPool(config.threads);
     }
 
-    pool = CachePool::Make(CachePool::Limits{});
+    pool = CachePool::Make(limits);
     const DimensionIndex rank = config.copy_shape.size();
     assert(rank == static_cast<DimensionIndex>(config.stride.size()));
     assert(rank == static_cast<DimensionIndex>(config.indexed.size()));
@@ -318,6 +320,42 @@ void BenchmarkCopy(const BenchmarkConfig& config, ::benchmark::State& state) {
   state.SetBytesProcessed(total_bytes);
 }
 
+// Runner shared by all threads of `BenchmarkConcurrentCachedRead`.
+std::unique_ptr<CopyBenchmarkRunner> concurrent_read_runner;
+
+// Measures the scaling, with the number of benchmark threads, of repeatedly
+// reading the same chunks from a warm chunk cache.  Each read acquires and
+// releases a reference to every chunk entry, which returns it to the eviction
+// queue of the cache pool.
+void BenchmarkConcurrentCachedRead(const BenchmarkConfig& config,
+                                   size_t lru_shards,
+                                   ::benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    CachePool::Limits limits;
+    limits.total_bytes_limit = 1024 * 1024 * 1024;
+    limits.lru_shards = lru_shards;
+    concurrent_read_runner =
+        std::make_unique<CopyBenchmarkRunner>(config, limits);
+  }
+  // Each thread reads into its own array.
+  auto array = AllocateArray(config.copy_shape, tensorstore::c_order,
+                             tensorstore::value_init, config.dtype);
+  const Index num_bytes = array.num_elements() * config.dtype->size;
+  Index total_bytes = 0;
+  while (state.KeepRunningBatch(num_bytes)) {
+    auto& runner = *concurrent_read_runner;
+    tensorstore::internal::DriverRead(tensorstore::InlineExecutor{},
+                                      {runner.driver, runner.transform}, array,
+                                      {/*.progress_function=*/{}})
+        .result();
+    total_bytes += num_bytes;
+  }
+  state.SetBytesProcessed(total_bytes);
+  if (state.thread_index() == 0) {
+    concurrent_read_runner.reset();
+  }
+}
+
 struct RegisterBenchmarks {
   static void Register(const BenchmarkConfig& config) {
     ::benchmark::RegisterBenchmark(
@@ -325,7 +363,34 @@ struct RegisterBenchmarks {
         [config](auto& state) { BenchmarkCopy(config, state); });
   }
 
+  static void RegisterConcurrentCachedRead(size_t lru_shards) {
+    const BenchmarkConfig config{
+        /*dtype=*/tensorstore::dtype_v<int>,
+        /*copy_shape=*/{16, 16, 16},
+        /*stride=*/{1, 1, 1},
+        /*indexed=*/{false, false, false},
+        /*cell_shape=*/{8, 8, 8},
+        /*chunked=*/{true, true, true},
+        /*cached=*/true,
+        /*threads=*/0,
+        /*read=*/true,
+    };
+    ::benchmark::RegisterBenchmark(
+        tensorstore::StrCat("ConcurrentCachedRead: ", config,
+                            ", lru_shards=", lru_shards)
+            .c_str(),
+        [config, lru_shards](auto& state) {
+          BenchmarkConcurrentCachedRead(config, lru_shards, state);
+        })
+        ->ThreadRange(1, 64)
+        ->UseRealTime();
+  }
+
   RegisterBenchmarks() {
+    for (const size_t lru_shards : {1, 8, 32}) {
+      RegisterConcurrentCachedRead(lru_shards);
+    }
+
     for (const bool read : {true, false}) {
       for (const bool cached : {true, false}) {
         for (const int threads : {0, 1, 2, 4}) {
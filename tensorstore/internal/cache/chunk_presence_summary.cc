@@ -0,0 +1,188 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/iterate_over_index_range.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+std::vector<Index> GetBlock(span<const Index> cell) {
+  std::vector<Index> block(cell.size());
+  for (size_t i = 0; i < cell.size(); ++i) {
+    block[i] = FloorOfRatio(cell[i], ChunkPresenceSummary::kBlockSize);
+  }
+  return block;
+}
+
+// Returns `true` if `bounds` contains `grid_bounds`.
+bool Covers(BoxView<> bounds, BoxView<> grid_bounds) {
+  return bounds.rank() == grid_bounds.rank() && Contains(bounds, grid_bounds);
+}
+
+}  // namespace
+
+void ChunkPresenceSummary::Cells::Add(span<const Index> cell) {
+  if (!cells.emplace(cell.begin(), cell.end()).second) return;
+  ++block_counts[GetBlock(cell)];
+}
+
+void ChunkPresenceSummary::Cells::Remove(span<const Index> cell) {
+  if (!cells.erase(Cell(cell.begin(), cell.end()))) return;
+  auto it = block_counts.find(GetBlock(cell));
+  if (--it->second == 0) block_counts.erase(it);
+}
+
+void ChunkPresenceSummary::MarkPresent(span<const Index> cell) {
+  assert(cell.size() == rank_);
+  absl::MutexLock lock(&mutex_);
+  present_.Add(cell);
+  if (refresh_id_ != 0) refreshing_.Add(cell);
+}
+
+void ChunkPresenceSummary::MarkAbsent(span<const Index> cell) {
+  assert(cell.size() == rank_);
+  absl::MutexLock lock(&mutex_);
+  present_.Remove(cell);
+  if (refresh_id_ != 0) refreshing_.Remove(cell);
+}
+
+bool ChunkPresenceSummary::IsPresent(span<const Index> cell) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return present_.cells.contains(Cell(cell.begin(), cell.end()));
+}
+
+Index ChunkPresenceSummary::CountPresent(BoxView<> box) const {
+  assert(box.rank() == rank_);
+  if (box.is_empty()) return 0;
+  absl::ReaderMutexLock lock(&mutex_);
+  Index count = 0;
+  Cell cell_key(rank_);
+  const auto count_cells = [&](BoxView<> region) {
+    IterateOverIndexRange(region, [&](span<const Index> cell) {
+      std::copy(cell.begin(), cell.end(), cell_key.begin());
+      count += present_.cells.contains(cell_key);
+    });
+  };
+  if (static_cast<size_t>(box.num_elements()) <= present_.cells.size()) {
+    count_cells(box);
+    return count;
+  }
+  // Only the blocks that contain at least one present cell are examined.
+  Box<> block_box(rank_);
+  Box<> intersection(rank_);
+  for (const auto& [block, block_count] : present_.block_counts) {
+    for (DimensionIndex i = 0; i < rank_; ++i) {
+      block_box[i] = IndexInterval::UncheckedSized(block[i] * kBlockSize,
+                                                   kBlockSize);
+      intersection[i] = Intersect(block_box[i], box[i]);
+    }
+    if (intersection.is_empty()) continue;
+    if (intersection == block_box) {
+      count += block_count;
+    } else {
+      count_cells(intersection);
+    }
+  }
+  return count;
+}
+
+absl::Time ChunkPresenceSummary::refresh_time() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return refresh_time_;
+}
+
+Box<> ChunkPresenceSummary::refreshed_bounds() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return refreshed_bounds_;
+}
+
+Future<const void> ChunkPresenceSummary::Refresh(BoxView<> grid_bounds,
+                                                 absl::Time staleness_bound,
+                                                 uint64_t& refresh_id) {
+  assert(grid_bounds.rank() == rank_);
+  absl::MutexLock lock(&mutex_);
+  refresh_id = 0;
+  if (refresh_time_ >= staleness_bound &&
+      Covers(refreshed_bounds_, grid_bounds)) {
+    return MakeReadyFuture();
+  }
+  if (refresh_id_ != 0 && refresh_start_time_ >= staleness_bound &&
+      Covers(refreshing_bounds_, grid_bounds)) {
+    return refresh_future_;
+  }
+  auto [promise, future] = PromiseFuturePair<void>::Make(MakeResult());
+  if (refresh_id_ != 0) {
+    // Waiters for the superseded refresh wait for this one instead.  The
+    // future is linked as `Future<const void>` so that the result is copied
+    // rather than moved.
+    LinkResult(std::move(refresh_promise_), Future<const void>(future));
+  }
+  refresh_promise_ = std::move(promise);
+  refresh_future_ = future;
+  refreshing_ = Cells{};
+  refresh_start_time_ = absl::Now();
+  refreshing_bounds_ = grid_bounds;
+  refresh_id = refresh_id_ = next_refresh_id_++;
+  return future;
+}
+
+void ChunkPresenceSummary::RefreshPresent(uint64_t refresh_id,
+                                          span<const Index> cell) {
+  absl::MutexLock lock(&mutex_);
+  if (refresh_id != refresh_id_) return;
+  refreshing_.Add(cell);
+}
+
+void ChunkPresenceSummary::FinishRefresh(uint64_t refresh_id,
+                                         absl::Status status) {
+  Promise<void> promise;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (refresh_id != refresh_id_) return;
+    refresh_id_ = 0;
+    promise = std::move(refresh_promise_);
+    refresh_future_ = {};
+    if (status.ok()) {
+      present_ = std::move(refreshing_);
+      refresh_time_ = refresh_start_time_;
+      refreshed_bounds_ = std::move(refreshing_bounds_);
+    }
+    refreshing_ = Cells{};
+  }
+  promise.SetResult(std::move(status));
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,144 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_CHUNK_PRESENCE_SUMMARY_H_
+#define TENSORSTORE_INTERNAL_CACHE_CHUNK_PRESENCE_SUMMARY_H_
+
+/// \file
+///
+/// In-memory summary of which chunks of a chunked array are stored, used by
+/// `KvsBackedChunkCache` to answer storage statistics queries (see
+/// `GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys`) without
+/// listing the kvstore each time.
+///
+/// The summary is populated by listing the chunk keys of the entire grid once,
+/// and thereafter maintained by the cache as chunks are written back.  It is
+/// refreshed by listing again only once it is older than the staleness bound
+/// of a query, or does not cover its grid bounds.  Chunks written or deleted
+/// by other processes are therefore only observed upon a refresh, consistent
+/// with the staleness bound semantics of cached chunks.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Set of grid cells for which a chunk is stored.
+///
+/// Present cells are recorded in a two-level hierarchy: the individual cells,
+/// and the number of present cells within each block of `kBlockSize` cells
+/// along every dimension.  Queries over a region iterate over whichever of
+/// the region's cells or the occupied blocks is smaller, and only examine
+/// individual cells of blocks partially contained in the region.
+///
+/// \threadsafety Thread safe.
+class ChunkPresenceSummary {
+ public:
+  /// Base-2 logarithm of the extent of blocks along each dimension.
+  constexpr static int kBlockShift = 3;
+  constexpr static Index kBlockSize = Index(1) << kBlockShift;
+
+  explicit ChunkPresenceSummary(DimensionIndex rank) : rank_(rank) {}
+
+  DimensionIndex rank() const { return rank_; }
+
+  /// Records that the chunk for `cell` is stored.
+  void MarkPresent(span<const Index> cell);
+
+  /// Records that the chunk for `cell` is not stored.
+  void MarkAbsent(span<const Index> cell);
+
+  /// Returns `true` if the chunk for `cell` is known to be stored.
+  bool IsPresent(span<const Index> cell) const;
+
+  /// Returns the number of present cells within `box`.
+  Index CountPresent(BoxView<> box) const;
+
+  /// Returns the time as of which the summary reflects the stored chunks
+  /// within `refreshed_bounds()`, or `absl::InfinitePast()` if it has never
+  /// been refreshed.
+  absl::Time refresh_time() const;
+
+  /// Returns the grid bounds covered by the last refresh.
+  Box<> refreshed_bounds() const;
+
+  /// Returns a future that becomes ready once the summary reflects the chunks
+  /// stored within `grid_bounds` as of `staleness_bound`.
+  ///
+  /// If the caller must perform a refresh, sets `refresh_id` to a non-zero
+  /// value, in which case the caller must then list the chunks stored within
+  /// `grid_bounds`, report each by calling `RefreshPresent`, and finally call
+  /// `FinishRefresh`, passing `refresh_id` to both.  A refresh that is
+  /// superseded by a later one (e.g. because the grid bounds have grown) is
+  /// ignored, and its waiters instead wait for the later refresh.
+  ///
+  /// Otherwise sets `refresh_id` to `0`, and the returned future is either
+  /// already ready or becomes ready once the refresh in progress finishes.
+  Future<const void> Refresh(BoxView<> grid_bounds, absl::Time staleness_bound,
+                             uint64_t& refresh_id);
+
+  /// Reports a present cell found by the refresh `refresh_id`.
+  void RefreshPresent(uint64_t refresh_id, span<const Index> cell);
+
+  /// Completes the refresh `refresh_id`.
+  ///
+  /// If `status` is an error, the summary is left unchanged, and the error is
+  /// propagated to the futures returned by `Refresh`.
+  void FinishRefresh(uint64_t refresh_id, absl::Status status);
+
+ private:
+  using Cell = std::vector<Index>;
+
+  struct Cells {
+    absl::flat_hash_set<Cell> cells;
+    absl::flat_hash_map<Cell, Index> block_counts;
+
+    void Add(span<const Index> cell);
+    void Remove(span<const Index> cell);
+  };
+
+  DimensionIndex rank_;
+  mutable absl::Mutex mutex_;
+  Cells present_ ABSL_GUARDED_BY(mutex_);
+  absl::Time refresh_time_ ABSL_GUARDED_BY(mutex_) = absl::InfinitePast();
+  Box<> refreshed_bounds_ ABSL_GUARDED_BY(mutex_);
+
+  // State of the refresh in progress, if `refresh_id_ != 0`.
+  uint64_t refresh_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t next_refresh_id_ ABSL_GUARDED_BY(mutex_) = 1;
+  Promise<void> refresh_promise_ ABSL_GUARDED_BY(mutex_);
+  Future<const void> refresh_future_ ABSL_GUARDED_BY(mutex_);
+  Cells refreshing_ ABSL_GUARDED_BY(mutex_);
+  absl::Time refresh_start_time_ ABSL_GUARDED_BY(mutex_);
+  Box<> refreshing_bounds_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_CHUNK_PRESENCE_SUMMARY_H_
@@ -0,0 +1,134 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::span;
+using ::tensorstore::internal::ChunkPresenceSummary;
+
+TEST(ChunkPresenceSummaryTest, MarkPresentAndAbsent) {
+  ChunkPresenceSummary summary(2);
+  summary.MarkPresent(span<const Index>({1, 2}));
+  summary.MarkPresent(span<const Index>({1, 2}));
+  summary.MarkPresent(span<const Index>({-3, 20}));
+  EXPECT_TRUE(summary.IsPresent(span<const Index>({1, 2})));
+  EXPECT_FALSE(summary.IsPresent(span<const Index>({2, 1})));
+  EXPECT_EQ(2, summary.CountPresent(Box<>({-100, -100}, {200, 200})));
+  EXPECT_EQ(1, summary.CountPresent(Box<>({0, 0}, {2, 3})));
+  EXPECT_EQ(0, summary.CountPresent(Box<>({0, 0}, {2, 2})));
+  summary.MarkAbsent(span<const Index>({1, 2}));
+  summary.MarkAbsent(span<const Index>({5, 5}));
+  EXPECT_FALSE(summary.IsPresent(span<const Index>({1, 2})));
+  EXPECT_EQ(1, summary.CountPresent(Box<>({-100, -100}, {200, 200})));
+}
+
+TEST(ChunkPresenceSummaryTest, CountPresentMatchesCells) {
+  ChunkPresenceSummary summary(2);
+  for (Index i = 0; i < 40; ++i) {
+    for (Index j = 0; j < 40; ++j) {
+      if ((i * 7 + j * 3) % 5 == 0) {
+        summary.MarkPresent(span<const Index>({i, j}));
+      }
+    }
+  }
+  // Boxes both smaller and larger than the number of present cells, partially
+  // and fully overlapping blocks.
+  for (const Box<>& box :
+       {Box<>({3, 5}, {4, 7}), Box<>({0, 0}, {40, 40}), Box<>({1, 9}, {38, 17}),
+        Box<>({-10, -10}, {100, 100}), Box<>({8, 8}, {16, 16})}) {
+    Index expected = 0;
+    for (Index i = box.origin()[0]; i < box.origin()[0] + box.shape()[0];
+         ++i) {
+      for (Index j = box.origin()[1]; j < box.origin()[1] + box.shape()[1];
+           ++j) {
+        expected += summary.IsPresent(span<const Index>({i, j}));
+      }
+    }
+    EXPECT_EQ(expected, summary.CountPresent(box)) << box;
+  }
+}
+
+TEST(ChunkPresenceSummaryTest, Refresh) {
+  ChunkPresenceSummary summary(1);
+  const Box<> bounds({0}, {10});
+  const absl::Time start = absl::Now();
+  uint64_t refresh_id;
+  auto future = summary.Refresh(bounds, start, refresh_id);
+  ASSERT_NE(0, refresh_id);
+  EXPECT_FALSE(future.ready());
+
+  // Concurrent queries wait for the same refresh.
+  uint64_t other_id;
+  auto other_future = summary.Refresh(bounds, start, other_id);
+  EXPECT_EQ(0, other_id);
+  EXPECT_FALSE(other_future.ready());
+
+  summary.MarkPresent(span<const Index>({7}));
+  summary.RefreshPresent(refresh_id, span<const Index>({3}));
+  summary.FinishRefresh(refresh_id, absl::OkStatus());
+  TENSORSTORE_EXPECT_OK(future.result());
+  TENSORSTORE_EXPECT_OK(other_future.result());
+  EXPECT_GE(summary.refresh_time(), start);
+  EXPECT_EQ(bounds, summary.refreshed_bounds());
+  EXPECT_EQ(2, summary.CountPresent(bounds));
+
+  // A fresh summary needs no refresh.
+  EXPECT_TRUE(summary.Refresh(bounds, start, refresh_id).ready());
+  EXPECT_EQ(0, refresh_id);
+
+  // Larger bounds require a refresh.
+  EXPECT_FALSE(summary.Refresh(Box<>({0}, {20}), start, refresh_id).ready());
+  EXPECT_NE(0, refresh_id);
+}
+
+TEST(ChunkPresenceSummaryTest, RefreshSupersededAndFailed) {
+  ChunkPresenceSummary summary(1);
+  uint64_t first_id, second_id;
+  auto first = summary.Refresh(Box<>({0}, {10}), absl::Now(), first_id);
+  auto second = summary.Refresh(Box<>({0}, {20}), absl::Now(), second_id);
+  ASSERT_NE(0, first_id);
+  ASSERT_NE(0, second_id);
+  EXPECT_NE(first_id, second_id);
+
+  // The superseded refresh is ignored.
+  summary.RefreshPresent(first_id, span<const Index>({1}));
+  summary.FinishRefresh(first_id, absl::OkStatus());
+  EXPECT_FALSE(first.ready());
+
+  summary.FinishRefresh(second_id, absl::UnknownError("list failed"));
+  EXPECT_THAT(first.result(), MatchesStatus(absl::StatusCode::kUnknown));
+  EXPECT_THAT(second.result(),
+              MatchesStatus(absl::StatusCode::kUnknown, "list failed"));
+  EXPECT_EQ(absl::InfinitePast(), summary.refresh_time());
+  EXPECT_EQ(0, summary.CountPresent(Box<>({0}, {20})));
+}
+
+}  // namespace
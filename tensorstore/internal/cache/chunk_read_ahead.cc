@@ -0,0 +1,187 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/chunk_read_ahead.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/extents.h"
+#include "tensorstore/util/iterate_over_index_range.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+bool PredictReadAheadCells(BoxView<> previous_cells, span<const Index> stride,
+                           BoxView<> cells, BoxView<> valid_cells,
+                           size_t max_chunks,
+                           std::vector<Index>& predicted_cells) {
+  const DimensionIndex rank = cells.rank();
+  if (previous_cells.rank() != rank || stride.size() != rank ||
+      valid_cells.rank() != rank ||
+      !internal::RangesEqual(previous_cells.shape(), cells.shape())) {
+    return false;
+  }
+  bool moving = false;
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    if (cells.origin()[i] - previous_cells.origin()[i] != stride[i]) {
+      return false;
+    }
+    if (stride[i] != 0) moving = true;
+  }
+  if (!moving) return false;
+
+  const Index cells_per_read = cells.num_elements();
+  Box<> next(cells);
+  Box<> clipped(rank);
+  for (size_t num_predicted = 0;
+       num_predicted + cells_per_read <= max_chunks;) {
+    bool empty = false;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      auto translated =
+          IndexInterval::Sized(next.origin()[i] + stride[i], next.shape()[i]);
+      if (!translated.ok()) return true;
+      next[i] = *translated;
+      clipped[i] = Intersect(*translated, valid_cells[i]);
+      if (clipped[i].empty()) empty = true;
+    }
+    if (empty) break;
+    IterateOverIndexRange(clipped, [&](span<const Index> cell) {
+      predicted_cells.insert(predicted_cells.end(), cell.begin(), cell.end());
+    });
+    num_predicted += clipped.num_elements();
+  }
+  return true;
+}
+
+ChunkReadAhead::ChunkReadAhead(ChunkReadAheadOptions options)
+    : options_(options) {}
+
+size_t ChunkReadAhead::num_prefetched() const {
+  absl::MutexLock lock(&mutex_);
+  return prefetched_.size();
+}
+
+void ChunkReadAhead::OnRead(ChunkCache& cache,
+                            const ChunkCache::ReadRequest& request) {
+  if (!options_.enabled() || request.transaction) return;
+  const auto& grid = cache.grid();
+  const auto& component_spec = grid.components[request.component_index];
+  const DimensionIndex grid_rank = grid.grid_rank();
+  if (grid_rank == 0) return;
+
+  Box<> output_range(component_spec.rank());
+  const bool have_cells =
+      GetOutputRange(request.transform, output_range).ok();
+  Box<> cells(grid_rank), valid_cells(grid_rank);
+  for (DimensionIndex grid_dim = 0; have_cells && grid_dim < grid_rank;
+       ++grid_dim) {
+    const DimensionIndex cell_dim =
+        component_spec.chunked_to_cell_dimensions[grid_dim];
+    const Index chunk_size = grid.chunk_shape[grid_dim];
+    const IndexInterval range = output_range[cell_dim];
+    if (range.empty() || !IsFinite(range)) {
+      cells = Box<>(0);
+      break;
+    }
+    cells[grid_dim] = IndexInterval::UncheckedClosed(
+        FloorOfRatio(range.inclusive_min(), chunk_size),
+        FloorOfRatio(range.inclusive_max(), chunk_size));
+    const IndexInterval bounds =
+        component_spec.array_spec.valid_data_bounds[cell_dim];
+    valid_cells[grid_dim] = IndexInterval::UncheckedClosed(
+        bounds.inclusive_min() == -kInfIndex
+            ? -kInfIndex
+            : FloorOfRatio(bounds.inclusive_min(), chunk_size),
+        bounds.inclusive_max() == kInfIndex
+            ? kInfIndex
+            : FloorOfRatio(bounds.inclusive_max(), chunk_size));
+  }
+  if (!have_cells) cells = Box<>(0);
+
+  // Limit the number of prefetched cells by the estimated decoded size of all
+  // components of a cell.
+  size_t max_chunks = options_.max_chunks;
+  if (options_.max_bytes != 0) {
+    size_t bytes_per_cell = 0;
+    for (const auto& component : grid.components) {
+      bytes_per_cell += ProductOfExtents(component.shape()) *
+                        component.dtype()->size;
+    }
+    if (bytes_per_cell != 0) {
+      max_chunks = std::min(max_chunks, options_.max_bytes / bytes_per_cell);
+    }
+  }
+
+  std::vector<Index> predicted_cells;
+  absl::flat_hash_map<std::vector<Index>, PinnedCacheEntry<ChunkCache>>
+      prefetched;
+  std::vector<PinnedCacheEntry<ChunkCache>> new_entries;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (cells.rank() == grid_rank &&
+        PredictReadAheadCells(previous_cells_, stride_, cells, valid_cells,
+                              max_chunks, predicted_cells)) {
+      for (size_t i = 0; i < predicted_cells.size(); i += grid_rank) {
+        std::vector<Index> cell(predicted_cells.begin() + i,
+                                predicted_cells.begin() + i + grid_rank);
+        if (prefetched.contains(cell)) continue;
+        auto it = prefetched_.find(cell);
+        PinnedCacheEntry<ChunkCache> entry;
+        if (it != prefetched_.end()) {
+          entry = std::move(it->second);
+        } else {
+          entry = GetEntryForGridCell(cache, cell);
+          new_entries.push_back(entry);
+        }
+        prefetched.emplace(std::move(cell), std::move(entry));
+      }
+    }
+    // Entries outside the new window are released (after `mutex_` is
+    // unlocked) when `prefetched` is destroyed.
+    std::swap(prefetched, prefetched_);
+    if (cells.rank() == grid_rank && previous_cells_.rank() == grid_rank) {
+      stride_.resize(grid_rank);
+      for (DimensionIndex i = 0; i < grid_rank; ++i) {
+        stride_[i] = cells.origin()[i] - previous_cells_.origin()[i];
+      }
+    } else {
+      stride_.clear();
+    }
+    previous_cells_ = std::move(cells);
+  }
+  for (auto& entry : new_entries) {
+    AsyncCache::AsyncCacheReadRequest cache_request;
+    cache_request.staleness_bound = request.staleness_bound;
+    entry->Read(cache_request).IgnoreFuture();
+  }
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,124 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_CHUNK_READ_AHEAD_H_
+#define TENSORSTORE_INTERNAL_CACHE_CHUNK_READ_AHEAD_H_
+
+/// \file
+///
+/// Predictive read-ahead for sequential access to the grid cells of a
+/// `ChunkCache`.
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Options that control `ChunkReadAhead`.
+struct ChunkReadAheadOptions {
+  /// Maximum number of grid cells to prefetch beyond the most recent read.  A
+  /// value of `0` disables read-ahead.
+  size_t max_chunks = 0;
+
+  /// Maximum estimated number of bytes (as decoded in memory) of the grid cells
+  /// retained by read-ahead.  A value of `0` indicates no limit other than
+  /// `max_chunks`.
+  size_t max_bytes = 0;
+
+  bool enabled() const { return max_chunks != 0; }
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.max_chunks, x.max_bytes);
+  };
+
+  friend bool operator==(const ChunkReadAheadOptions& a,
+                         const ChunkReadAheadOptions& b) {
+    return a.max_chunks == b.max_chunks && a.max_bytes == b.max_bytes;
+  }
+  friend bool operator!=(const ChunkReadAheadOptions& a,
+                         const ChunkReadAheadOptions& b) {
+    return !(a == b);
+  }
+};
+
+/// Computes the grid cells that are expected to be read next.
+///
+/// If `cells` is equal to `previous_cells` translated by `stride`, the
+/// predicted reads are `cells` translated by `k * stride` for `k = 1, 2, ...`.
+/// The cells of each predicted read are appended to `predicted_cells` (each
+/// cell as `cells.rank()` consecutive indices), stopping before the total
+/// number of cells would exceed `max_chunks`, or once a predicted read lies
+/// entirely outside `valid_cells`.
+///
+/// \param previous_cells Grid cells covered by the previous read.
+/// \param stride Translation between the previous two reads.
+/// \param cells Grid cells covered by the current read.
+/// \param valid_cells Grid cells that may be prefetched.
+/// \param max_chunks Maximum number of cells to predict.
+/// \param predicted_cells[out] Appended to with the predicted cells.
+/// \returns `true` if the access pattern is sequential.
+bool PredictReadAheadCells(BoxView<> previous_cells, span<const Index> stride,
+                           BoxView<> cells, BoxView<> valid_cells,
+                           size_t max_chunks,
+                           std::vector<Index>& predicted_cells);
+
+/// Tracks the grid cells read through a single driver handle, and prefetches
+/// the cells of subsequent reads into the cache when consecutive reads follow
+/// a constant stride over the grid (e.g. a raster sweep).
+///
+/// The pattern is confirmed once two consecutive reads are translated by the
+/// same non-zero stride.  Prefetched entries are retained (pinned) until they
+/// fall outside the predicted window, which bounds the memory used to
+/// `ChunkReadAheadOptions::max_bytes` even if the cache pool has a small limit.
+/// Any read that does not follow the pattern releases all prefetched entries.
+///
+/// Thread-safe.
+class ChunkReadAhead {
+ public:
+  explicit ChunkReadAhead(ChunkReadAheadOptions options);
+
+  const ChunkReadAheadOptions& options() const { return options_; }
+
+  /// Records a read by `request` from `cache`, and issues any prefetch reads.
+  ///
+  /// Transactional reads are not tracked.
+  void OnRead(ChunkCache& cache, const ChunkCache::ReadRequest& request);
+
+  /// Returns the number of prefetched entries currently retained.
+  size_t num_prefetched() const;
+
+ private:
+  ChunkReadAheadOptions options_;
+  mutable absl::Mutex mutex_;
+  Box<> previous_cells_ ABSL_GUARDED_BY(mutex_);
+  std::vector<Index> stride_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::vector<Index>, PinnedCacheEntry<ChunkCache>>
+      prefetched_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_CHUNK_READ_AHEAD_H_
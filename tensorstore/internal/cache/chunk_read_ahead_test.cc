@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/cache/chunk_read_ahead.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::Index;
+using ::tensorstore::internal::PredictReadAheadCells;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(PredictReadAheadCellsTest, Sequential1d) {
+  std::vector<Index> cells;
+  const Index stride[] = {1};
+  EXPECT_TRUE(PredictReadAheadCells(Box({0}, {1}), stride, Box({1}, {1}),
+                                    Box({0}, {10}), 3, cells));
+  EXPECT_THAT(cells, ElementsAre(2, 3, 4));
+}
+
+TEST(PredictReadAheadCellsTest, SequentialMultipleCellsPerRead) {
+  std::vector<Index> cells;
+  const Index stride[] = {0, 2};
+  EXPECT_TRUE(PredictReadAheadCells(Box({0, 0}, {1, 2}), stride,
+                                    Box({0, 2}, {1, 2}), Box({0, 0}, {1, 10}),
+                                    5, cells));
+  // Only complete reads fit within the limit of 5 cells.
+  EXPECT_THAT(cells, ElementsAre(0, 4, 0, 5, 0, 6, 0, 7));
+}
+
+TEST(PredictReadAheadCellsTest, NegativeStride) {
+  std::vector<Index> cells;
+  const Index stride[] = {-1};
+  EXPECT_TRUE(PredictReadAheadCells(Box({5}, {1}), stride, Box({4}, {1}),
+                                    Box({0}, {10}), 2, cells));
+  EXPECT_THAT(cells, ElementsAre(3, 2));
+}
+
+TEST(PredictReadAheadCellsTest, StrideMismatch) {
+  std::vector<Index> cells;
+  const Index stride[] = {1};
+  EXPECT_FALSE(PredictReadAheadCells(Box({0}, {1}), stride, Box({2}, {1}),
+                                     Box({0}, {10}), 3, cells));
+  EXPECT_THAT(cells, IsEmpty());
+}
+
+TEST(PredictReadAheadCellsTest, ShapeMismatch) {
+  std::vector<Index> cells;
+  const Index stride[] = {1};
+  EXPECT_FALSE(PredictReadAheadCells(Box({0}, {1}), stride, Box({1}, {2}),
+                                     Box({0}, {10}), 3, cells));
+  EXPECT_THAT(cells, IsEmpty());
+}
+
+TEST(PredictReadAheadCellsTest, ZeroStride) {
+  std::vector<Index> cells;
+  const Index stride[] = {0};
+  EXPECT_FALSE(PredictReadAheadCells(Box({1}, {1}), stride, Box({1}, {1}),
+                                     Box({0}, {10}), 3, cells));
+  EXPECT_THAT(cells, IsEmpty());
+}
+
+TEST(PredictReadAheadCellsTest, ClippedToValidCells) {
+  std::vector<Index> cells;
+  const Index stride[] = {2};
+  EXPECT_TRUE(PredictReadAheadCells(Box({4}, {2}), stride, Box({6}, {2}),
+                                    Box({0}, {9}), 10, cells));
+  EXPECT_THAT(cells, ElementsAre(8));
+}
+
+}  // namespace
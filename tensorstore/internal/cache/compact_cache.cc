@@ -0,0 +1,286 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/compact_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorstore {
+namespace internal_cache {
+namespace {
+
+/// Header stored at the start of each slot.
+struct SlotHeader {
+  /// Low 32 bits of the hash of the key if `occupied`, or the index of the
+  /// next free slot if not.
+  uint32_t hash_or_next_free;
+  uint16_t key_size;
+  uint8_t occupied;
+
+  /// CLOCK reference bit, set on access and cleared by the clock hand.  May be
+  /// set concurrently by readers.
+  std::atomic<uint8_t> referenced;
+
+  union {
+    char inline_key[CompactCacheImpl::kInlineKeySize];
+    char* heap_key;
+  };
+
+  std::string_view key() const {
+    return std::string_view(
+        key_size <= CompactCacheImpl::kInlineKeySize ? inline_key : heap_key,
+        key_size);
+  }
+};
+
+static_assert(sizeof(SlotHeader) == CompactCacheImpl::kSlotHeaderSize);
+
+/// Approximate hash table memory per entry: one `uint32_t` slot index and
+/// one control byte.
+constexpr size_t kTableEntryBytes = sizeof(uint32_t) + 1;
+
+/// Number of slots allocated at once when a shard grows.
+constexpr uint32_t kSlotsPerBlock = 512;
+
+constexpr uint32_t kNoSlot = 0xffffffff;
+
+/// Key used for heterogeneous lookup in `Shard::table`.
+struct KeyRef {
+  std::string_view key;
+  uint32_t hash;
+};
+
+// Returns the shard index and the hash stored in the slot for `key`.
+std::pair<size_t, uint32_t> HashKey(std::string_view key) {
+  const uint64_t hash = absl::HashOf(key);
+  // Use the high bits to select the shard, so that they are independent of
+  // the bits used by the hash table.
+  return {static_cast<size_t>(hash >> 58) % CompactCacheImpl::kNumShards,
+          static_cast<uint32_t>(hash)};
+}
+
+size_t RoundUp(size_t x, size_t alignment) {
+  return (x + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+struct ABSL_CACHELINE_ALIGNED CompactCacheImpl::Shard {
+  struct SlotHash {
+    using is_transparent = void;
+    size_t operator()(uint32_t index) const {
+      return shard->slot(index)->hash_or_next_free;
+    }
+    size_t operator()(const KeyRef& ref) const { return ref.hash; }
+    const Shard* shard;
+  };
+
+  struct SlotEq {
+    using is_transparent = void;
+    bool operator()(uint32_t a, uint32_t b) const { return a == b; }
+    bool operator()(const KeyRef& ref, uint32_t index) const {
+      const SlotHeader* header = shard->slot(index);
+      return header->hash_or_next_free == ref.hash &&
+             header->key() == ref.key;
+    }
+    bool operator()(uint32_t index, const KeyRef& ref) const {
+      return (*this)(ref, index);
+    }
+    const Shard* shard;
+  };
+
+  Shard() : table(0, SlotHash{this}, SlotEq{this}) {}
+
+  ~Shard() {
+    for (uint32_t index : table) {
+      FreeKey(slot(index));
+    }
+  }
+
+  SlotHeader* slot(uint32_t index) const {
+    return reinterpret_cast<SlotHeader*>(blocks[index / kSlotsPerBlock].get() +
+                                         (index % kSlotsPerBlock) * slot_size);
+  }
+
+  static void FreeKey(SlotHeader* header) {
+    if (header->key_size > kInlineKeySize) delete[] header->heap_key;
+  }
+
+  size_t EntryBytes(size_t key_size) const {
+    return slot_size + kTableEntryBytes +
+           (key_size > kInlineKeySize ? key_size : 0);
+  }
+
+  uint32_t AllocateSlot() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (free_head != kNoSlot) {
+      const uint32_t index = free_head;
+      free_head = slot(index)->hash_or_next_free;
+      return index;
+    }
+    if (num_slots % kSlotsPerBlock == 0) {
+      blocks.emplace_back(new char[kSlotsPerBlock * slot_size]);
+    }
+    const uint32_t index = num_slots++;
+    new (slot(index)) SlotHeader;
+    return index;
+  }
+
+  void Remove(uint32_t index) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    SlotHeader* header = slot(index);
+    table.erase(index);
+    bytes -= EntryBytes(header->key_size);
+    --num_entries;
+    FreeKey(header);
+    header->occupied = 0;
+    header->hash_or_next_free = free_head;
+    free_head = index;
+  }
+
+  /// Evicts one entry according to the CLOCK policy.
+  void EvictOne() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    assert(num_entries > 0);
+    while (true) {
+      if (clock_hand >= num_slots) clock_hand = 0;
+      const uint32_t index = clock_hand++;
+      SlotHeader* header = slot(index);
+      if (!header->occupied) continue;
+      if (header->referenced.exchange(0, std::memory_order_relaxed)) continue;
+      Remove(index);
+      return;
+    }
+  }
+
+  size_t slot_size;
+  mutable absl::Mutex mutex;
+
+  // Slab blocks of `kSlotsPerBlock` slots.  Only modified while holding
+  // `mutex` exclusively.
+  std::vector<std::unique_ptr<char[]>> blocks;
+  uint32_t num_slots ABSL_GUARDED_BY(mutex) = 0;
+  uint32_t free_head ABSL_GUARDED_BY(mutex) = kNoSlot;
+  uint32_t clock_hand ABSL_GUARDED_BY(mutex) = 0;
+  size_t num_entries ABSL_GUARDED_BY(mutex) = 0;
+  size_t bytes ABSL_GUARDED_BY(mutex) = 0;
+
+  /// Indices of the occupied slots.
+  absl::flat_hash_set<uint32_t, SlotHash, SlotEq> table ABSL_GUARDED_BY(mutex);
+};
+
+CompactCacheImpl::CompactCacheImpl(size_t value_size, size_t value_alignment,
+                                   size_t total_bytes_limit)
+    : value_size_(value_size),
+      value_offset_(RoundUp(kSlotHeaderSize, value_alignment)),
+      slot_size_(RoundUp(value_offset_ + value_size,
+                         std::max(alignof(SlotHeader), value_alignment))),
+      shard_bytes_limit_(total_bytes_limit / kNumShards),
+      shards_(new Shard[kNumShards]) {
+  for (size_t i = 0; i < kNumShards; ++i) {
+    shards_[i].slot_size = slot_size_;
+  }
+}
+
+CompactCacheImpl::~CompactCacheImpl() = default;
+
+bool CompactCacheImpl::Get(std::string_view key, void* value) const {
+  auto [shard_index, hash] = HashKey(key);
+  Shard& shard = shards_[shard_index];
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.table.find(KeyRef{key, hash});
+  if (it == shard.table.end()) return false;
+  SlotHeader* header = shard.slot(*it);
+  if (!header->referenced.load(std::memory_order_relaxed)) {
+    header->referenced.store(1, std::memory_order_relaxed);
+  }
+  std::memcpy(value, reinterpret_cast<const char*>(header) + value_offset_,
+              value_size_);
+  return true;
+}
+
+bool CompactCacheImpl::Insert(std::string_view key, const void* value) {
+  if (key.size() > kMaxKeySize) return false;
+  auto [shard_index, hash] = HashKey(key);
+  Shard& shard = shards_[shard_index];
+  const size_t entry_bytes = shard.EntryBytes(key.size());
+  if (entry_bytes > shard_bytes_limit_) return false;
+  absl::MutexLock lock(&shard.mutex);
+  if (shard.table.contains(KeyRef{key, hash})) return false;
+  while (shard.bytes + entry_bytes > shard_bytes_limit_) {
+    shard.EvictOne();
+  }
+  const uint32_t index = shard.AllocateSlot();
+  SlotHeader* header = shard.slot(index);
+  header->hash_or_next_free = hash;
+  header->key_size = static_cast<uint16_t>(key.size());
+  header->occupied = 1;
+  header->referenced.store(0, std::memory_order_relaxed);
+  char* key_data = header->inline_key;
+  if (key.size() > kInlineKeySize) {
+    key_data = header->heap_key = new char[key.size()];
+  }
+  std::memcpy(key_data, key.data(), key.size());
+  std::memcpy(reinterpret_cast<char*>(header) + value_offset_, value,
+              value_size_);
+  shard.table.insert(index);
+  shard.bytes += entry_bytes;
+  ++shard.num_entries;
+  return true;
+}
+
+bool CompactCacheImpl::Erase(std::string_view key) {
+  auto [shard_index, hash] = HashKey(key);
+  Shard& shard = shards_[shard_index];
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.table.find(KeyRef{key, hash});
+  if (it == shard.table.end()) return false;
+  shard.Remove(*it);
+  return true;
+}
+
+size_t CompactCacheImpl::size() const {
+  size_t total = 0;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    absl::ReaderMutexLock lock(&shards_[i].mutex);
+    total += shards_[i].num_entries;
+  }
+  return total;
+}
+
+size_t CompactCacheImpl::total_bytes() const {
+  size_t total = 0;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    absl::ReaderMutexLock lock(&shards_[i].mutex);
+    total += shards_[i].bytes;
+  }
+  return total;
+}
+
+}  // namespace internal_cache
+}  // namespace tensorstore
@@ -0,0 +1,173 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_COMPACT_CACHE_H_
+#define TENSORSTORE_INTERNAL_CACHE_COMPACT_CACHE_H_
+
+/// \file
+///
+/// Memory-efficient cache of small, immutable values, intended for caches with
+/// tens of millions of entries, such as indices of sharded or chunked formats,
+/// for which the per-entry overhead of `internal::Cache` entries (a mutex, LRU
+/// links, reference counts, and a heap-allocated entry) would dominate.
+///
+/// Compared to `internal::Cache`:
+///
+/// - Entries are stored by value in per-shard slabs of fixed-size slots rather
+///   than allocated individually.
+///
+/// - Keys of up to `kInlineKeySize` bytes are stored inline in the slot.
+///
+/// - There is no per-entry mutex or reference count; each shard of the cache
+///   is protected by a single mutex, and values are returned by copy.
+///
+/// - Eviction uses the CLOCK approximation of LRU, which requires a single
+///   "referenced" bit per entry instead of a doubly-linked list.
+///
+/// The per-entry overhead, in addition to the size of the value, is
+/// `kSlotHeaderSize` bytes for keys of up to `kInlineKeySize` bytes (plus the
+/// size of the key for longer keys), and about 5 bytes for the hash table.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace tensorstore {
+namespace internal_cache {
+
+/// Type-erased implementation of `CompactCache`.
+class CompactCacheImpl {
+ public:
+  /// Maximum size of keys stored inline.
+  constexpr static size_t kInlineKeySize = 16;
+
+  /// Size of the part of each slot that precedes the value.
+  constexpr static size_t kSlotHeaderSize = 8 + kInlineKeySize;
+
+  /// Maximum size of keys.
+  constexpr static size_t kMaxKeySize = 0xffff;
+
+  /// Number of independently-locked shards.
+  constexpr static size_t kNumShards = 64;
+
+  /// Constructs an empty cache of values with the specified size and
+  /// alignment.
+  ///
+  /// \param total_bytes_limit Entries are evicted when the total memory used
+  ///     by the entries exceeds this limit.
+  CompactCacheImpl(size_t value_size, size_t value_alignment,
+                   size_t total_bytes_limit);
+  ~CompactCacheImpl();
+
+  CompactCacheImpl(const CompactCacheImpl&) = delete;
+  CompactCacheImpl& operator=(const CompactCacheImpl&) = delete;
+
+  /// Copies the value for `key` to `value`.
+  ///
+  /// \returns `false` if `key` is not present.
+  bool Get(std::string_view key, void* value) const;
+
+  /// Inserts a copy of `value` for `key`, unless `key` is already present.
+  ///
+  /// Keys longer than `kMaxKeySize` and entries larger than the limit of a
+  /// shard are not inserted.
+  ///
+  /// \returns `true` if the value was inserted.
+  bool Insert(std::string_view key, const void* value);
+
+  /// Removes the entry for `key`.
+  ///
+  /// \returns `true` if `key` was present.
+  bool Erase(std::string_view key);
+
+  /// Returns the number of entries.
+  size_t size() const;
+
+  /// Returns the total memory, in bytes, used by the entries.
+  size_t total_bytes() const;
+
+ private:
+  struct Shard;
+
+  size_t value_size_;
+  size_t value_offset_;
+  size_t slot_size_;
+  size_t shard_bytes_limit_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace internal_cache
+
+namespace internal {
+
+/// Cache of trivially-copyable `Value` objects keyed by strings.
+///
+/// See the file comment for details.
+///
+/// \threadsafety Thread safe.
+template <typename Value>
+class CompactCache {
+  static_assert(std::is_trivially_copyable_v<Value>,
+                "CompactCache values must be trivially copyable");
+  static_assert(alignof(Value) <= alignof(std::max_align_t));
+
+ public:
+  /// Constructs an empty cache.
+  ///
+  /// \param total_bytes_limit Entries are evicted, approximately in
+  ///     least-recently-used order, when the total memory used by the entries
+  ///     exceeds this limit.
+  explicit CompactCache(size_t total_bytes_limit)
+      : impl_(sizeof(Value), alignof(Value), total_bytes_limit) {}
+
+  /// Returns the value for `key`, or `std::nullopt` if not present.
+  std::optional<Value> Get(std::string_view key) const {
+    alignas(Value) unsigned char buffer[sizeof(Value)];
+    if (!impl_.Get(key, buffer)) return std::nullopt;
+    return *std::launder(reinterpret_cast<const Value*>(buffer));
+  }
+
+  /// Inserts `value` for `key`.  Since values are immutable, an existing value
+  /// for `key` is left unchanged.
+  ///
+  /// \returns `true` if the value was inserted.
+  bool Insert(std::string_view key, const Value& value) {
+    return impl_.Insert(key, &value);
+  }
+
+  /// Removes the entry for `key`.
+  ///
+  /// \returns `true` if `key` was present.
+  bool Erase(std::string_view key) { return impl_.Erase(key); }
+
+  /// Returns the number of entries.
+  size_t size() const { return impl_.size(); }
+
+  /// Returns the total memory, in bytes, used by the entries.
+  size_t total_bytes() const { return impl_.total_bytes(); }
+
+ private:
+  internal_cache::CompactCacheImpl impl_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_COMPACT_CACHE_H_
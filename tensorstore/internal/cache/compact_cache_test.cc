@@ -0,0 +1,113 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/compact_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+
+namespace {
+
+using ::tensorstore::internal::CompactCache;
+using ::tensorstore::internal_cache::CompactCacheImpl;
+
+struct ByteRange {
+  uint64_t offset;
+  uint64_t length;
+};
+
+TEST(CompactCacheTest, InsertGetErase) {
+  CompactCache<ByteRange> cache(1 << 20);
+  EXPECT_FALSE(cache.Get("a"));
+  EXPECT_TRUE(cache.Insert("a", {1, 2}));
+  // Values are immutable.
+  EXPECT_FALSE(cache.Insert("a", {3, 4}));
+  const std::string long_key(100, 'x');
+  EXPECT_TRUE(cache.Insert(long_key, {5, 6}));
+  EXPECT_EQ(2, cache.size());
+
+  auto a = cache.Get("a");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(1, a->offset);
+  EXPECT_EQ(2, a->length);
+  auto b = cache.Get(long_key);
+  ASSERT_TRUE(b);
+  EXPECT_EQ(5, b->offset);
+  EXPECT_FALSE(cache.Get(std::string(99, 'x')));
+
+  EXPECT_TRUE(cache.Erase("a"));
+  EXPECT_FALSE(cache.Erase("a"));
+  EXPECT_FALSE(cache.Get("a"));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_TRUE(cache.Erase(long_key));
+  EXPECT_EQ(0, cache.total_bytes());
+}
+
+TEST(CompactCacheTest, PerEntryOverhead) {
+  CompactCache<ByteRange> cache(size_t(1) << 30);
+  constexpr size_t kNumEntries = 10000;
+  for (size_t i = 0; i < kNumEntries; ++i) {
+    ASSERT_TRUE(cache.Insert(absl::StrCat("chunk/", i), {i, 1}));
+  }
+  EXPECT_EQ(kNumEntries, cache.size());
+  // Short keys are stored inline, and the overhead in addition to the value
+  // is a few tens of bytes.
+  EXPECT_LE(cache.total_bytes() / kNumEntries,
+            sizeof(ByteRange) + CompactCacheImpl::kSlotHeaderSize + 8);
+}
+
+TEST(CompactCacheTest, Eviction) {
+  constexpr size_t kNumEntries = 100000;
+  const size_t limit = 1000 * CompactCacheImpl::kNumShards * 64;
+  CompactCache<ByteRange> cache(limit);
+  for (size_t i = 0; i < kNumEntries; ++i) {
+    cache.Insert(absl::StrCat(i), {i, 0});
+    // Key "0" is repeatedly referenced and therefore never evicted.
+    ASSERT_TRUE(cache.Get("0")) << i;
+  }
+  EXPECT_LE(cache.total_bytes(), limit);
+  EXPECT_LT(cache.size(), kNumEntries);
+  auto value = cache.Get(absl::StrCat(kNumEntries - 1));
+  ASSERT_TRUE(value);
+  EXPECT_EQ(kNumEntries - 1, value->offset);
+}
+
+TEST(CompactCacheTest, Concurrent) {
+  CompactCache<ByteRange> cache(1 << 20);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t] {
+      for (uint64_t i = 0; i < 10000; ++i) {
+        const std::string key = absl::StrCat(i % 500);
+        cache.Insert(key, {i % 500, 0});
+        if (auto value = cache.Get(key)) {
+          EXPECT_EQ(i % 500, value->offset);
+        }
+        if (i % 7 == static_cast<uint64_t>(t)) cache.Erase(key);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_LE(cache.size(), 500);
+}
+
+}  // namespace
@@ -0,0 +1,101 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/cache/encoded_value_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+
+namespace tensorstore {
+namespace internal {
+
+uint64_t EncodedValueCache::epoch() const {
+  absl::MutexLock lock(&mutex_);
+  return epoch_;
+}
+
+std::optional<kvstore::ReadResult> EncodedValueCache::Get(
+    std::string_view key, const kvstore::ReadOptions& options) {
+  if (!options.byte_range.IsFull()) return std::nullopt;
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return std::nullopt;
+  auto& entry = it->second;
+  if (entry.stamp.time < options.staleness_bound) return std::nullopt;
+  lru_.splice(lru_.end(), lru_, entry.lru_position);
+  if (!options.generation_conditions.Matches(entry.stamp.generation)) {
+    return kvstore::ReadResult::Unspecified(entry.stamp);
+  }
+  return kvstore::ReadResult::Value(entry.value, entry.stamp);
+}
+
+void EncodedValueCache::Put(std::string_view key, const absl::Cord& value,
+                            const TimestampedStorageGeneration& stamp,
+                            uint64_t epoch) {
+  const size_t num_bytes = key.size() + value.size();
+  if (num_bytes > max_bytes_) return;
+  absl::MutexLock lock(&mutex_);
+  if (epoch != epoch_) return;
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    // Read concurrently by another request.
+    EraseLocked(it);
+  }
+  while (total_bytes_ + num_bytes > max_bytes_) {
+    EraseLocked(entries_.find(lru_.front()));
+  }
+  auto lru_position = lru_.insert(lru_.end(), std::string(key));
+  entries_.emplace(*lru_position,
+                   Entry{value, stamp, num_bytes, lru_position});
+  total_bytes_ += num_bytes;
+}
+
+void EncodedValueCache::Invalidate(std::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  ++epoch_;
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    EraseLocked(it);
+  }
+}
+
+void EncodedValueCache::EraseLocked(
+    absl::flat_hash_map<std::string, Entry>::iterator it) {
+  total_bytes_ -= it->second.num_bytes;
+  lru_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+size_t EncodedValueCache::total_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return total_bytes_;
+}
+
+size_t EncodedValueCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace internal
+}  // namespace tensorstore
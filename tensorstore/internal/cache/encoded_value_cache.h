@@ -0,0 +1,115 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_ENCODED_VALUE_CACHE_H_
+#define TENSORSTORE_INTERNAL_CACHE_ENCODED_VALUE_CACHE_H_
+
+/// \file
+///
+/// Cache of encoded kvstore values used by `KvsBackedChunkCache` as a second,
+/// compact level below the decoded chunks held by the cache pool.
+///
+/// Values read from the kvstore are retained in encoded (typically compressed)
+/// form, such that once the decoded cache entry has been evicted from the cache
+/// pool, a subsequent read of the same chunk only needs to decode the retained
+/// value rather than read it again from the kvstore.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Cache of encoded values, keyed by kvstore key.
+///
+/// Entries are evicted in least-recently-used order once the total size
+/// exceeds the limit.
+class EncodedValueCache {
+ public:
+  /// Constructs an empty cache.
+  ///
+  /// \param max_bytes Maximum total size of the cached values.
+  explicit EncodedValueCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  /// Returns the current invalidation epoch, which must be obtained before
+  /// issuing the kvstore read whose result is passed to `Put`.
+  uint64_t epoch() const;
+
+  /// Returns the result of a read of `key` with the specified `options`, or
+  /// `std::nullopt` if the read cannot be satisfied from the cache.
+  ///
+  /// Only reads of the full value are satisfied, and only if the cached value
+  /// is not older than `options.staleness_bound`.
+  std::optional<kvstore::ReadResult> Get(std::string_view key,
+                                         const kvstore::ReadOptions& options);
+
+  /// Adds the value read for `key`.
+  ///
+  /// The value is not retained if it is larger than the cache limit, or if
+  /// `Invalidate` has been called since `epoch` was obtained, since the value
+  /// may then be older than a write that has completed.
+  void Put(std::string_view key, const absl::Cord& value,
+           const TimestampedStorageGeneration& stamp, uint64_t epoch);
+
+  /// Removes any cached value for `key`, which is about to be written.
+  void Invalidate(std::string_view key);
+
+  /// Returns the total size of the cached values.
+  size_t total_bytes() const;
+
+  /// Returns the number of cached values.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    absl::Cord value;
+    TimestampedStorageGeneration stamp;
+    size_t num_bytes;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  void EraseLocked(absl::flat_hash_map<std::string, Entry>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  size_t max_bytes_;
+  mutable absl::Mutex mutex_;
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t epoch_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  /// Keys in least-recently-used order, where the front is the least recently
+  /// used.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_ENCODED_VALUE_CACHE_H_
@@ -0,0 +1,114 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/cache/encoded_value_cache.h"
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+
+namespace {
+
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal::EncodedValueCache;
+using ::tensorstore::kvstore::ReadOptions;
+
+TimestampedStorageGeneration MakeStamp(int64_t seconds) {
+  return {StorageGeneration::FromString("g"), absl::FromUnixSeconds(seconds)};
+}
+
+ReadOptions MakeOptions(int64_t staleness_bound_seconds) {
+  ReadOptions options;
+  options.staleness_bound = absl::FromUnixSeconds(staleness_bound_seconds);
+  return options;
+}
+
+TEST(EncodedValueCacheTest, GetAfterPut) {
+  EncodedValueCache cache(100);
+  EXPECT_FALSE(cache.Get("a", MakeOptions(0)));
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(4, cache.total_bytes());
+  auto read_result = cache.Get("a", MakeOptions(10));
+  ASSERT_TRUE(read_result);
+  ASSERT_TRUE(read_result->has_value());
+  EXPECT_EQ("abc", read_result->value);
+  EXPECT_EQ(MakeStamp(10), read_result->stamp);
+}
+
+TEST(EncodedValueCacheTest, StalenessBound) {
+  EncodedValueCache cache(100);
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  EXPECT_FALSE(cache.Get("a", MakeOptions(11)));
+}
+
+TEST(EncodedValueCacheTest, GenerationConditions) {
+  EncodedValueCache cache(100);
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  auto options = MakeOptions(0);
+  options.generation_conditions.if_not_equal =
+      StorageGeneration::FromString("g");
+  auto read_result = cache.Get("a", options);
+  ASSERT_TRUE(read_result);
+  EXPECT_TRUE(read_result->aborted());
+}
+
+TEST(EncodedValueCacheTest, ByteRangeNotSatisfied) {
+  EncodedValueCache cache(100);
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  auto options = MakeOptions(0);
+  options.byte_range.inclusive_min = 1;
+  EXPECT_FALSE(cache.Get("a", options));
+}
+
+TEST(EncodedValueCacheTest, Invalidate) {
+  EncodedValueCache cache(100);
+  const auto epoch = cache.epoch();
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), epoch);
+  cache.Invalidate("a");
+  EXPECT_FALSE(cache.Get("a", MakeOptions(0)));
+  EXPECT_EQ(0, cache.total_bytes());
+
+  // A read issued before the invalidation is not retained.
+  cache.Put("b", absl::Cord("abc"), MakeStamp(10), epoch);
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST(EncodedValueCacheTest, EvictsLeastRecentlyUsed) {
+  EncodedValueCache cache(8);
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  cache.Put("b", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  EXPECT_TRUE(cache.Get("a", MakeOptions(0)));
+  cache.Put("c", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  EXPECT_TRUE(cache.Get("a", MakeOptions(0)));
+  EXPECT_FALSE(cache.Get("b", MakeOptions(0)));
+  EXPECT_TRUE(cache.Get("c", MakeOptions(0)));
+  EXPECT_EQ(8, cache.total_bytes());
+}
+
+TEST(EncodedValueCacheTest, TooLarge) {
+  EncodedValueCache cache(3);
+  cache.Put("a", absl::Cord("abc"), MakeStamp(10), cache.epoch());
+  EXPECT_EQ(0, cache.size());
+}
+
+}  // namespace
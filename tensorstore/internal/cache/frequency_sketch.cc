@@ -0,0 +1,84 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/frequency_sketch.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace tensorstore {
+namespace internal_cache {
+namespace {
+// Odd multipliers used to derive an independent index for each row.
+constexpr uint64_t kRowSeeds[] = {
+    0x9e3779b97f4a7c15ull,
+    0xc2b2ae3d27d4eb4full,
+    0x165667b19e3779f9ull,
+    0xd6e8feb86659fd93ull,
+};
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t log2_width)
+    : log2_width_(std::clamp(log2_width, size_t{1}, size_t{30})),
+      // Age after an average of 10 accesses per counter of a row.
+      sample_size_(size_t{10} << log2_width_),
+      counters_(new std::atomic<uint8_t>[kDepth << log2_width_]) {
+  for (size_t i = 0, n = kDepth << log2_width_; i < n; ++i) {
+    counters_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t FrequencySketch::CounterIndex(uint64_t hash, size_t row) const {
+  assert(row < kDepth);
+  return (row << log2_width_) +
+         static_cast<size_t>((hash * kRowSeeds[row]) >> (64 - log2_width_));
+}
+
+void FrequencySketch::Increment(uint64_t hash) {
+  for (size_t row = 0; row < kDepth; ++row) {
+    auto& counter = counters_[CounterIndex(hash, row)];
+    if (counter.load(std::memory_order_relaxed) < kMaxCount) {
+      counter.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (num_increments_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+      sample_size_) {
+    Age();
+  }
+}
+
+uint8_t FrequencySketch::Estimate(uint64_t hash) const {
+  uint8_t estimate = kMaxCount;
+  for (size_t row = 0; row < kDepth; ++row) {
+    estimate = std::min(estimate, counters_[CounterIndex(hash, row)].load(
+                                      std::memory_order_relaxed));
+  }
+  return estimate;
+}
+
+void FrequencySketch::Age() {
+  for (size_t i = 0, n = kDepth << log2_width_; i < n; ++i) {
+    auto& counter = counters_[i];
+    counter.store(counter.load(std::memory_order_relaxed) / 2,
+                  std::memory_order_relaxed);
+  }
+  num_increments_.fetch_sub(sample_size_ / 2, std::memory_order_relaxed);
+}
+
+}  // namespace internal_cache
+}  // namespace tensorstore
@@ -0,0 +1,66 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_FREQUENCY_SKETCH_H_
+#define TENSORSTORE_INTERNAL_CACHE_FREQUENCY_SKETCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+namespace tensorstore {
+namespace internal_cache {
+
+/// Approximate, thread-safe access frequency counter used by the TinyLFU
+/// admission policy of `CachePool`.
+///
+/// This is a count-min sketch with small saturating counters.  To ensure
+/// that the estimates reflect recent history, all counters are halved each
+/// time the number of recorded accesses reaches the sample size.
+///
+/// Concurrent updates use relaxed atomic operations and may occasionally be
+/// lost; the estimates are only used as a heuristic.
+class FrequencySketch {
+ public:
+  /// Maximum value of a counter.
+  constexpr static uint8_t kMaxCount = 15;
+
+  /// Constructs a sketch with `2**log2_width` counters per row.
+  explicit FrequencySketch(size_t log2_width = 14);
+
+  /// Records an access to the item with the specified hash.
+  void Increment(uint64_t hash);
+
+  /// Returns the estimated number of accesses, in the range
+  /// `[0, kMaxCount]`, to the item with the specified hash.
+  uint8_t Estimate(uint64_t hash) const;
+
+ private:
+  constexpr static size_t kDepth = 4;
+
+  size_t CounterIndex(uint64_t hash, size_t row) const;
+  void Age();
+
+  size_t log2_width_;
+  size_t sample_size_;
+  std::atomic<size_t> num_increments_{0};
+  std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+};
+
+}  // namespace internal_cache
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_FREQUENCY_SKETCH_H_
@@ -0,0 +1,59 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/frequency_sketch.h"
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/hash/hash.h"
+
+namespace {
+
+using ::tensorstore::internal_cache::FrequencySketch;
+
+uint64_t HashOf(int i) { return absl::HashOf(i); }
+
+TEST(FrequencySketchTest, Basic) {
+  FrequencySketch sketch;
+  EXPECT_EQ(0, sketch.Estimate(HashOf(1)));
+  sketch.Increment(HashOf(1));
+  sketch.Increment(HashOf(1));
+  sketch.Increment(HashOf(2));
+  EXPECT_EQ(2, sketch.Estimate(HashOf(1)));
+  EXPECT_EQ(1, sketch.Estimate(HashOf(2)));
+  EXPECT_EQ(0, sketch.Estimate(HashOf(3)));
+}
+
+TEST(FrequencySketchTest, Saturates) {
+  FrequencySketch sketch;
+  for (int i = 0; i < 100; ++i) sketch.Increment(HashOf(1));
+  EXPECT_EQ(FrequencySketch::kMaxCount, sketch.Estimate(HashOf(1)));
+}
+
+TEST(FrequencySketchTest, Aging) {
+  FrequencySketch sketch(/*log2_width=*/4);
+  for (int i = 0; i < 8; ++i) sketch.Increment(HashOf(1));
+  EXPECT_EQ(8, sketch.Estimate(HashOf(1)));
+  // Record enough distinct accesses to reach the sample size of 160, which
+  // halves all counters.
+  for (int i = 0; i < 152; ++i) sketch.Increment(HashOf(1000 + i));
+  EXPECT_GE(FrequencySketch::kMaxCount / 2, sketch.Estimate(HashOf(1)));
+  EXPECT_LE(4, sketch.Estimate(HashOf(1)));
+  sketch.Increment(HashOf(1));
+  EXPECT_LE(5, sketch.Estimate(HashOf(1)));
+}
+
+}  // namespace
@@ -14,9 +14,12 @@
 
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
 
+#include <stddef.h>
+
 #include <cstdint>
 #include <string>
 
+#include "absl/time/time.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/metadata.h"
 
@@ -30,6 +33,27 @@ auto& kvs_cache_read = internal_metrics::Counter<int64_t, std::string>::New(
         "Count of kvs_backed_cache reads by category. A large number of "
         "'unchanged' reads indicates that the dataset is relatively "
         "quiescent."));
+
+auto& kvs_cache_decode_bytes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/kvs_cache_decode_bytes",
+    internal_metrics::MetricMetadata("Bytes decoded by kvs_backed_cache reads",
+                                     internal_metrics::Units::kBytes));
+
+auto& kvs_cache_decode_ns = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/kvs_cache_decode_ns",
+    internal_metrics::MetricMetadata(
+        "Time spent decoding kvs_backed_cache reads (ns)"));
+
+auto& kvs_cache_encode_bytes = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/kvs_cache_encode_bytes",
+    internal_metrics::MetricMetadata(
+        "Bytes encoded for kvs_backed_cache writeback",
+        internal_metrics::Units::kBytes));
+
+auto& kvs_cache_encode_ns = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/cache/kvs_cache_encode_ns",
+    internal_metrics::MetricMetadata(
+        "Time spent encoding kvs_backed_cache writeback (ns)"));
 }
 
 void KvsBackedCache_IncrementReadUnchangedMetric() {
@@ -47,5 +71,17 @@ void KvsBackedCache_IncrementReadErrorMetric() {
   cell.Increment();
 }
 
+void KvsBackedCache_RecordDecodeMetric(size_t encoded_bytes,
+                                       absl::Duration elapsed) {
+  kvs_cache_decode_bytes.IncrementBy(encoded_bytes);
+  kvs_cache_decode_ns.IncrementBy(absl::ToInt64Nanoseconds(elapsed));
+}
+
+void KvsBackedCache_RecordEncodeMetric(size_t encoded_bytes,
+                                       absl::Duration elapsed) {
+  kvs_cache_encode_bytes.IncrementBy(encoded_bytes);
+  kvs_cache_encode_ns.IncrementBy(absl::ToInt64Nanoseconds(elapsed));
+}
+
 }  // namespace internal
 }  // namespace tensorstore
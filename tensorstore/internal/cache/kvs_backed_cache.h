@@ -31,8 +31,14 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/internal/tracing/tracing.h"
+#include "tensorstore/io_stats.h"
+#include "tensorstore/kvstore/batch_revalidation.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/operations.h"
@@ -43,6 +49,7 @@
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/execution/future_sender.h"  // IWYU pragma: keep
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
@@ -53,6 +60,15 @@ void KvsBackedCache_IncrementReadUnchangedMetric();
 void KvsBackedCache_IncrementReadChangedMetric();
 void KvsBackedCache_IncrementReadErrorMetric();
 
+/// Records the time taken by `DoDecode` to decode `encoded_bytes` bytes.
+void KvsBackedCache_RecordDecodeMetric(size_t encoded_bytes,
+                                       absl::Duration elapsed);
+
+/// Records the time taken by `DoEncode` to produce `encoded_bytes` bytes for
+/// writeback.
+void KvsBackedCache_RecordEncodeMetric(size_t encoded_bytes,
+                                       absl::Duration elapsed);
+
 /// Base class that integrates an `AsyncCache` with a `kvstore::Driver`.
 ///
 /// Each cache entry is assumed to correspond one-to-one with a key in a
@@ -113,13 +129,23 @@ class KvsBackedCache : public Parent {
     struct DecodeReceiverImpl {
       EntryOrNode* self_;
       TimestampedStorageGeneration stamp_;
+      size_t encoded_bytes_;
+      absl::Time start_time_;
+      IoStats io_stats_;
+      // Accounts the encoded value as in-flight I/O until it is decoded.
+      MemoryReservation memory_;
       void set_error(absl::Status error) {
+        memory_.Release();
         self_->ReadError(
             GetOwningEntry(*self_).AnnotateError(error,
                                                  /*reading=*/true));
       }
       void set_cancel() { set_error(absl::CancelledError("")); }
       void set_value(std::shared_ptr<const void> data) {
+        memory_.Release();
+        KvsBackedCache_RecordDecodeMetric(encoded_bytes_,
+                                          absl::Now() - start_time_);
+        io_stats_.RecordDecode(encoded_bytes_);
         AsyncCache::ReadState read_state;
         read_state.stamp = std::move(stamp_);
         read_state.data = std::move(data);
@@ -131,12 +157,14 @@ class KvsBackedCache : public Parent {
     struct ReadReceiverImpl {
       EntryOrNode* entry_or_node_;
       std::shared_ptr<const void> existing_read_data_;
+      IoStats io_stats_;
       void set_value(kvstore::ReadResult read_result) {
         if (read_result.aborted()) {
           ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
               << *entry_or_node_
               << "Value has not changed, stamp=" << read_result.stamp;
           KvsBackedCache_IncrementReadUnchangedMetric();
+          io_stats_.RecordKvstoreRead(0);
           // Value has not changed.
           entry_or_node_->ReadSuccess(AsyncCache::ReadState{
               std::move(existing_read_data_), std::move(read_result.stamp)});
@@ -145,10 +173,16 @@ class KvsBackedCache : public Parent {
         ABSL_LOG_IF(INFO, TENSORSTORE_ASYNC_CACHE_DEBUG)
             << *entry_or_node_ << "DoDecode: " << read_result.stamp;
         KvsBackedCache_IncrementReadChangedMetric();
+        const size_t encoded_bytes =
+            read_result.has_value() ? read_result.value.size() : 0;
+        io_stats_.RecordKvstoreRead(encoded_bytes);
         GetOwningEntry(*entry_or_node_)
             .DoDecode(std::move(read_result).optional_value(),
                       DecodeReceiverImpl<EntryOrNode>{
-                          entry_or_node_, std::move(read_result.stamp)});
+                          entry_or_node_, std::move(read_result.stamp),
+                          encoded_bytes, absl::Now(), std::move(io_stats_),
+                          MemoryReservation(MemoryCategory::kInFlightIo,
+                                            encoded_bytes)});
       }
       void set_error(absl::Status error) {
         KvsBackedCache_IncrementReadErrorMetric();
@@ -164,19 +198,56 @@ class KvsBackedCache : public Parent {
     ///
     /// If an error occurs, calls `ReadError` directly without invoking
     /// `DoDecode`.
+    ///
+    /// If in-flight I/O exceeds its memory limit, the read is not issued until
+    /// usage drops below the limit.
     void DoRead(AsyncCache::AsyncCacheReadRequest request) final {
+      auto budget = WaitForMemoryBudget(MemoryCategory::kInFlightIo);
+      if (!budget.ready()) {
+        // The pending read request keeps this entry alive.
+        std::move(budget).ExecuteWhenReady(
+            [this, request = std::move(request)](
+                ReadyFuture<const void> future) mutable {
+              IssueKvsRead(std::move(request));
+            });
+        return;
+      }
+      IssueKvsRead(std::move(request));
+    }
+
+    /// Issues the kvstore read for `DoRead`.
+    void IssueKvsRead(AsyncCache::AsyncCacheReadRequest request) {
       kvstore::ReadOptions kvstore_options;
       kvstore_options.staleness_bound = request.staleness_bound;
       auto read_state = AsyncCache::ReadLock<void>(*this).read_state();
       kvstore_options.generation_conditions.if_not_equal =
           std::move(read_state.stamp.generation);
       kvstore_options.batch = request.batch;
-      auto& cache = GetOwningCache(*this);
-      auto future = cache.kvstore_driver_->Read(this->GetKeyValueStoreKey(),
-                                                std::move(kvstore_options));
+      internal_tracing::Span span("cache.Read");
+      if (span.active()) span.SetAttribute("key", GetKeyValueStoreKey());
+      internal_tracing::SpanScope scope(span);
+      auto future = internal_tracing::EndSpanWhenReady(
+          std::move(span), this->DoKvsRead(std::move(kvstore_options)));
       execution::submit(
           std::move(future),
-          ReadReceiverImpl<Entry>{this, std::move(read_state.data)});
+          ReadReceiverImpl<Entry>{this, std::move(read_state.data),
+                                  std::move(request.io_stats)});
+    }
+
+    /// Reads the value for `GetKeyValueStoreKey()` from the `kvstore::Driver`.
+    ///
+    /// Conditional reads that are part of a batch may be revalidated together
+    /// with the other reads in the batch (see
+    /// `internal_kvstore::ReadWithBatchedRevalidation`).
+    ///
+    /// Derived classes may override this to satisfy non-transactional reads
+    /// from another source, such as a cache of encoded values.
+    virtual Future<kvstore::ReadResult> DoKvsRead(
+        kvstore::ReadOptions options) {
+      auto& cache = GetOwningCache(*this);
+      return internal_kvstore::ReadWithBatchedRevalidation(
+          *cache.kvstore_driver_, this->GetKeyValueStoreKey(),
+          std::move(options));
     }
 
     using DecodeReceiver =
@@ -242,7 +313,7 @@ class KvsBackedCache : public Parent {
       target_->KvsRead(
           std::move(kvstore_options),
           typename Entry::template ReadReceiverImpl<TransactionNode>{
-              this, std::move(read_state.data)});
+              this, std::move(read_state.data), std::move(request.io_stats)});
     }
 
     using ReadModifyWriteSource = kvstore::ReadModifyWriteSource;
@@ -297,6 +368,7 @@ class KvsBackedCache : public Parent {
         TransactionNode* self_;
         TimestampedStorageGeneration update_stamp_;
         ReadModifyWriteSource::WritebackReceiver receiver_;
+        absl::Time start_time_;
         void set_error(absl::Status error) {
           error = GetOwningEntry(*self_).AnnotateError(std::move(error),
                                                        /*reading=*/false);
@@ -304,6 +376,11 @@ class KvsBackedCache : public Parent {
         }
         void set_cancel() { ABSL_UNREACHABLE(); }  // COV_NF_LINE
         void set_value(std::optional<absl::Cord> value) {
+          const size_t encoded_bytes = value ? value->size() : 0;
+          KvsBackedCache_RecordEncodeMetric(encoded_bytes,
+                                            absl::Now() - start_time_);
+          self_->io_stats().RecordEncode(encoded_bytes);
+          self_->io_stats().RecordKvstoreWrite(encoded_bytes);
           kvstore::ReadResult read_result =
               value ? kvstore::ReadResult::Value(std::move(*value),
                                                  std::move(update_stamp_))
@@ -374,7 +451,7 @@ class KvsBackedCache : public Parent {
           GetOwningEntry(*self_).DoEncode(
               std::move(update_data),
               EncodeReceiverImpl{self_, std::move(update.stamp),
-                                 std::move(receiver_)});
+                                 std::move(receiver_), absl::Now()});
         }
       };
       AsyncCache::TransactionNode::ApplyOptions apply_options;
@@ -454,7 +531,9 @@ class KvsBackedCache : public Parent {
   /// are no concurrent read or write operations.
   void SetKvStoreDriver(kvstore::DriverPtr driver) {
     if (driver) {
-      this->SetBatchNestingDepth(driver->BatchNestingDepth() + 1);
+      // Reads are submitted via the batch entry used by
+      // `ReadWithBatchedRevalidation`.
+      this->SetBatchNestingDepth(driver->BatchNestingDepth() + 2);
     }
     kvstore_driver_ = std::move(driver);
   }
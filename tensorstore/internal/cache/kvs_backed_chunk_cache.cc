@@ -14,56 +14,236 @@
 
 #include "tensorstore/internal/cache/kvs_backed_chunk_cache.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+#include "tensorstore/internal/cache/encoded_value_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/internal/chunk_grid_specification.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
+#include "tensorstore/internal/thread/adaptive_executor.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/extents.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
 
 namespace tensorstore {
 namespace internal {
+namespace {
+
+// Returns the size of a decoded chunk, which is accounted as codec scratch
+// memory while the chunk is encoded or decoded.
+int64_t GetDecodedChunkBytes(const ChunkGridSpecification& grid) {
+  int64_t bytes = 0;
+  for (const auto& component_spec : grid.components) {
+    bytes += ProductOfExtents(component_spec.shape()) *
+             component_spec.dtype()->size;
+  }
+  return bytes;
+}
+
+}  // namespace
+
+void KvsBackedChunkCache::SetEncodedCacheBytes(size_t max_bytes) {
+  if (max_bytes == 0) {
+    encoded_value_cache_ = nullptr;
+  } else {
+    encoded_value_cache_ = std::make_shared<EncodedValueCache>(max_bytes);
+  }
+}
+
+void KvsBackedChunkCache::SetChunkPresenceSummary(bool enabled) {
+  if (!enabled) {
+    chunk_presence_summary_ = nullptr;
+  } else if (!chunk_presence_summary_) {
+    chunk_presence_summary_ =
+        std::make_shared<ChunkPresenceSummary>(grid().chunk_shape.size());
+  }
+}
+
+void KvsBackedChunkCache::SetCodecAccelerator(
+    std::shared_ptr<CodecAccelerator> accelerator) {
+  codec_accelerator_ = std::move(accelerator);
+}
 
 std::string KvsBackedChunkCache::Entry::GetKeyValueStoreKey() {
   auto& cache = GetOwningCache(*this);
   return cache.GetChunkStorageKey(this->cell_indices());
 }
 
+Future<kvstore::ReadResult> KvsBackedChunkCache::Entry::DoKvsRead(
+    kvstore::ReadOptions options) {
+  auto& cache = GetOwningCache(*this);
+  auto encoded_value_cache = cache.encoded_value_cache_;
+  if (!encoded_value_cache) return Base::Entry::DoKvsRead(std::move(options));
+  auto key = this->GetKeyValueStoreKey();
+  if (auto read_result = encoded_value_cache->Get(key, options)) {
+    return MakeReadyFuture<kvstore::ReadResult>(std::move(*read_result));
+  }
+  const uint64_t epoch = encoded_value_cache->epoch();
+  auto future = cache.kvstore_driver()->Read(key, std::move(options));
+  future.ExecuteWhenReady(
+      [encoded_value_cache = std::move(encoded_value_cache),
+       key = std::move(key),
+       epoch](ReadyFuture<kvstore::ReadResult> future) {
+        auto& read_result = future.result();
+        if (!read_result.ok() || !read_result->has_value()) return;
+        encoded_value_cache->Put(key, read_result->value, read_result->stamp,
+                                 epoch);
+      });
+  return future;
+}
+
 void KvsBackedChunkCache::Entry::DoDecode(std::optional<absl::Cord> value,
                                           DecodeReceiver receiver) {
-  GetOwningCache(*this).executor()([this, value = std::move(value),
-                                    receiver = std::move(receiver)]() mutable {
-    if (!value) {
-      execution::set_value(receiver, nullptr);
-      return;
-    }
-    auto& cache = GetOwningCache(*this);
-    auto decoded_result =
-        cache.DecodeChunk(this->cell_indices(), std::move(*value));
-    if (!decoded_result.ok()) {
-      execution::set_error(receiver,
+  // A missing chunk requires no decoding.
+  const TaskCost cost = value ? TaskCost::kLarge : TaskCost::kSmall;
+  ExecuteWithCost(
+      GetOwningCache(*this).executor(), cost,
+      [this, value = std::move(value),
+       receiver = std::move(receiver)]() mutable {
+        if (!value) {
+          execution::set_value(receiver, nullptr);
+          return;
+        }
+        auto& cache = GetOwningCache(*this);
+        MemoryReservation scratch(MemoryCategory::kCodecScratch,
+                                  GetDecodedChunkBytes(cache.grid()));
+        ScopedCodecAccelerator accelerator(cache.codec_accelerator_.get());
+        auto decoded_result =
+            cache.DecodeChunk(this->cell_indices(), std::move(*value));
+        scratch.Release();
+        if (!decoded_result.ok()) {
+          execution::set_error(
+              receiver, internal::ConvertInvalidArgumentToFailedPrecondition(
+                            std::move(decoded_result).status()));
+          return;
+        }
+        const size_t num_components = this->component_specs().size();
+        auto new_read_data =
+            internal::make_shared_for_overwrite<ReadData[]>(num_components);
+        assert(decoded_result->size() == num_components);
+        std::copy_n(decoded_result->begin(), num_components,
+                    new_read_data.get());
+        execution::set_value(receiver, std::static_pointer_cast<ReadData>(
+                                           std::move(new_read_data)));
+      });
+}
+
+std::optional<OptionalByteRangeRequest>
+KvsBackedChunkCache::GetChunkRegionByteRange(span<const Index> chunk_indices,
+                                             BoxView<> region) {
+  return std::nullopt;
+}
+
+Result<SharedArray<const void>> KvsBackedChunkCache::DecodeChunkRegion(
+    span<const Index> chunk_indices, BoxView<> region, absl::Cord data) {
+  return absl::UnimplementedError("Partial chunk decoding not supported");
+}
+
+Future<SharedArray<const void>> KvsBackedChunkCache::ReadCellRegion(
+    const ReadRequest& request, ChunkCache::Entry& entry, BoxView<> region) {
+  // Retained encoded values must be complete.
+  if (encoded_value_cache_ || grid().components.size() != 1) return {};
+  const span<const Index> cell_indices = entry.cell_indices();
+  const auto domain = grid().GetCellDomain(0, cell_indices);
+  Box<> chunk_region(region);
+  for (DimensionIndex i = 0; i < chunk_region.rank(); ++i) {
+    chunk_region.origin()[i] -= domain.origin()[i];
+  }
+  auto byte_range = GetChunkRegionByteRange(cell_indices, chunk_region);
+  if (!byte_range) return {};
+  kvstore::ReadOptions options;
+  options.staleness_bound = request.staleness_bound;
+  options.byte_range = *byte_range;
+  options.batch = request.batch;
+  options.io_stats = request.io_stats;
+  auto read_future = kvstore_driver()->Read(GetChunkStorageKey(cell_indices),
+                                            std::move(options));
+  return PromiseFuturePair<SharedArray<const void>>::LinkValue(
+             [entry = PinnedCacheEntry<KvsBackedChunkCache>(
+                  static_cast<Entry*>(&entry)),
+              region = Box<>(region), chunk_region = std::move(chunk_region)](
+                 Promise<SharedArray<const void>> promise,
+                 ReadyFuture<kvstore::ReadResult> future) mutable {
+               auto& read_result = future.value();
+               auto& cache = GetOwningCache(*entry);
+               if (!read_result.has_value()) {
+                 const auto& array_spec =
+                     cache.grid().components[0].array_spec;
+                 promise.SetResult(SharedArray<const void>(
+                     array_spec.GetFillValueForDomain(region)));
+                 return;
+               }
+               ExecuteWithCost(
+                   cache.executor(), TaskCost::kLarge,
+                   [entry = std::move(entry),
+                    chunk_region = std::move(chunk_region),
+                    value = std::move(read_result.value),
+                    promise = std::move(promise)]() mutable {
+                     auto& cache = GetOwningCache(*entry);
+                     MemoryReservation scratch(
+                         MemoryCategory::kCodecScratch,
+                         chunk_region.num_elements() *
+                             cache.grid().components[0].dtype()->size);
+                     ScopedCodecAccelerator accelerator(
+                         cache.codec_accelerator_.get());
+                     auto decoded = cache.DecodeChunkRegion(
+                         entry->cell_indices(), chunk_region, std::move(value));
+                     if (!decoded.ok()) {
+                       promise.SetResult(
                            internal::ConvertInvalidArgumentToFailedPrecondition(
-                               std::move(decoded_result).status()));
-      return;
+                               std::move(decoded).status()));
+                       return;
+                     }
+                     promise.SetResult(std::move(*decoded));
+                   });
+             },
+             std::move(read_future))
+      .future;
+}
+
+void KvsBackedChunkCache::TransactionNode::WritebackSuccess(
+    ReadState&& read_state) {
+  if (auto* summary = GetOwningCache(*this).chunk_presence_summary_.get()) {
+    // An unknown generation indicates the chunk was not modified.
+    const auto& generation = read_state.stamp.generation;
+    const span<const Index> cell_indices = GetOwningEntry(*this).cell_indices();
+    if (StorageGeneration::IsNoValue(generation)) {
+      summary->MarkAbsent(cell_indices);
+    } else if (!StorageGeneration::IsUnknown(generation)) {
+      summary->MarkPresent(cell_indices);
     }
-    const size_t num_components = this->component_specs().size();
-    auto new_read_data =
-        internal::make_shared_for_overwrite<ReadData[]>(num_components);
-    assert(decoded_result->size() == num_components);
-    std::copy_n(decoded_result->begin(), num_components, new_read_data.get());
-    execution::set_value(
-        receiver, std::static_pointer_cast<ReadData>(std::move(new_read_data)));
-  });
+  }
+  Base::TransactionNode::WritebackSuccess(std::move(read_state));
 }
 
 void KvsBackedChunkCache::Entry::DoEncode(std::shared_ptr<const ReadData> data,
                                           EncodeReceiver receiver) {
+  if (auto* encoded_value_cache =
+          GetOwningCache(*this).encoded_value_cache_.get()) {
+    // Any cached value is about to be superseded.
+    encoded_value_cache->Invalidate(this->GetKeyValueStoreKey());
+  }
   if (!data) {
     execution::set_value(receiver, std::nullopt);
     return;
@@ -87,7 +267,13 @@ void KvsBackedChunkCache::Entry::DoEncode(std::shared_ptr<const ReadData> data,
           component_spec.array_spec.GetFillValueForDomain(domain);
     }
   }
-  auto encoded_result = cache.EncodeChunk(cell_indices, component_arrays);
+  MemoryReservation scratch(MemoryCategory::kCodecScratch,
+                            GetDecodedChunkBytes(grid));
+  auto encoded_result = [&] {
+    ScopedCodecAccelerator accelerator(cache.codec_accelerator_.get());
+    return cache.EncodeChunk(cell_indices, component_arrays);
+  }();
+  scratch.Release();
   if (!encoded_result.ok()) {
     execution::set_error(receiver, std::move(encoded_result).status());
     return;
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_INTERNAL_CACHE_KVS_BACKED_CHUNK_CACHE_H_
 #define TENSORSTORE_INTERNAL_CACHE_KVS_BACKED_CHUNK_CACHE_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,9 +24,17 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/array.h"
+#include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/cache/chunk_cache.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
+#include "tensorstore/internal/cache/encoded_value_cache.h"
 #include "tensorstore/internal/cache/kvs_backed_cache.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
@@ -34,6 +44,19 @@ namespace internal {
 /// Integrates `ChunkCache` with `KvsBackedCache`.
 ///
 /// Derived classes must implement `DecodeChunk` and `EncodeChunk`.
+///
+/// Derived classes may additionally implement `GetChunkRegionByteRange` and
+/// `DecodeChunkRegion` to support reading just part of a chunk (see
+/// `ChunkCache::ReadCellRegion`), which is only supported for a single
+/// component.
+///
+/// Optionally, the encoded values read from the kvstore may additionally be
+/// retained in an `EncodedValueCache` (see `SetEncodedCacheBytes`).  Decoded
+/// chunks are held by the cache pool as usual; once a decoded chunk has been
+/// evicted, its encoded value remains available such that the next read only
+/// needs to decode it again.  Since encoded values are typically much smaller
+/// than decoded chunks, this increases the hit rate for a given amount of
+/// memory.
 class KvsBackedChunkCache
     : public internal::KvsBackedCache<KvsBackedChunkCache,
                                       internal::ChunkCache> {
@@ -64,6 +87,34 @@ class KvsBackedChunkCache
       span<const Index> chunk_indices,
       span<const SharedArray<const void>> component_arrays) = 0;
 
+  /// Returns the byte range of the encoded chunk required to decode `region`
+  /// by `DecodeChunkRegion`, or `std::nullopt` if the entire chunk should be
+  /// read and decoded by `DecodeChunk` instead.
+  ///
+  /// \param region Non-empty region of the chunk, relative to the chunk
+  ///     origin, i.e. contained within `[0, grid.components[0].cell_shape())`.
+  ///
+  /// The default implementation returns `std::nullopt`.
+  virtual std::optional<OptionalByteRangeRequest> GetChunkRegionByteRange(
+      span<const Index> chunk_indices, BoxView<> region);
+
+  /// Decodes `region` of a data chunk.
+  ///
+  /// \param region Same region specified to `GetChunkRegionByteRange`.
+  /// \param data The byte range of the encoded chunk specified by
+  ///     `GetChunkRegionByteRange`.
+  /// \returns On success, returns a zero-origin array of shape
+  ///     `region.shape()`.
+  ///
+  /// The default implementation returns an error, and is never called unless
+  /// `GetChunkRegionByteRange` is overridden.
+  virtual Result<SharedArray<const void>> DecodeChunkRegion(
+      span<const Index> chunk_indices, BoxView<> region, absl::Cord data);
+
+  Future<SharedArray<const void>> ReadCellRegion(
+      const ReadRequest& request, ChunkCache::Entry& entry,
+      BoxView<> region) override;
+
   // The members below are implementation details not relevant to derived class
   // driver implementations.
 
@@ -75,6 +126,53 @@ class KvsBackedChunkCache
     void DoEncode(std::shared_ptr<const ReadData> data,
                   EncodeReceiver receiver) override;
     std::string GetKeyValueStoreKey() override;
+    Future<kvstore::ReadResult> DoKvsRead(
+        kvstore::ReadOptions options) override;
+  };
+
+  /// Enables retaining up to `max_bytes` of encoded values, or disables it if
+  /// `max_bytes == 0`.
+  ///
+  /// The caller is responsible for ensuring there are no concurrent read or
+  /// write operations.
+  void SetEncodedCacheBytes(size_t max_bytes);
+
+  /// Returns the limit specified by `SetEncodedCacheBytes`.
+  size_t encoded_cache_bytes() const {
+    return encoded_value_cache_ ? encoded_value_cache_->max_bytes() : 0;
+  }
+
+  /// Returns the cache of encoded values, or `nullptr` if disabled.
+  EncodedValueCache* encoded_value_cache() const {
+    return encoded_value_cache_.get();
+  }
+
+  /// Enables or disables maintaining a summary of the stored chunks, which is
+  /// updated as chunks are written back, and may be used to compute storage
+  /// statistics without listing the kvstore.
+  ///
+  /// The caller is responsible for ensuring there are no concurrent read or
+  /// write operations.
+  void SetChunkPresenceSummary(bool enabled);
+
+  /// Returns the summary of the stored chunks, or `nullptr` if disabled.
+  const std::shared_ptr<ChunkPresenceSummary>& chunk_presence_summary() const {
+    return chunk_presence_summary_;
+  }
+
+  /// Specifies the accelerator with which `DecodeChunk`, `DecodeChunkRegion`
+  /// and `EncodeChunk` are invoked (see `ScopedCodecAccelerator`), or
+  /// `nullptr` to use the accelerator installed process-wide.
+  ///
+  /// The caller is responsible for ensuring there are no concurrent read or
+  /// write operations.
+  void SetCodecAccelerator(std::shared_ptr<CodecAccelerator> accelerator);
+
+  class TransactionNode : public Base::TransactionNode {
+   public:
+    using OwningCache = KvsBackedChunkCache;
+    using Base::TransactionNode::TransactionNode;
+    void WritebackSuccess(ReadState&& read_state) override;
   };
 
   Entry* DoAllocateEntry() override { return new Entry; }
@@ -83,6 +181,12 @@ class KvsBackedChunkCache
       AsyncCache::Entry& entry) override {
     return new TransactionNode(static_cast<Entry&>(entry));
   }
+
+ private:
+  // Shared with any outstanding reads.
+  std::shared_ptr<EncodedValueCache> encoded_value_cache_;
+  std::shared_ptr<CodecAccelerator> codec_accelerator_;
+  std::shared_ptr<ChunkPresenceSummary> chunk_presence_summary_;
 };
 
 }  // namespace internal
@@ -0,0 +1,108 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/writeback_scheduler.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+
+WritebackScheduler::WritebackScheduler(Options options) : options_(options) {}
+
+void WritebackScheduler::Schedule(size_t num_bytes, bool high_priority,
+                                  StartFunction start) {
+  {
+    absl::MutexLock lock(&mutex_);
+    (high_priority ? high_priority_queue_ : queue_)
+        .push_back(Operation{num_bytes, std::move(start)});
+  }
+  MaybeStartOperations();
+}
+
+void WritebackScheduler::MaybeStartOperations() {
+  std::vector<StartFunction> to_start;
+  {
+    absl::MutexLock lock(&mutex_);
+    const absl::Time now = absl::Now();
+    while (options_.max_concurrency == 0 ||
+           in_flight_ < options_.max_concurrency) {
+      auto& queue =
+          high_priority_queue_.empty() ? queue_ : high_priority_queue_;
+      if (queue.empty()) break;
+      if (options_.max_bytes_per_second != 0) {
+        if (next_start_time_ > now) {
+          if (!timer_scheduled_) {
+            timer_scheduled_ = true;
+            ScheduleAt(next_start_time_,
+                       [self = WritebackSchedulerPtr(this)] {
+                         {
+                           absl::MutexLock lock(&self->mutex_);
+                           self->timer_scheduled_ = false;
+                         }
+                         self->MaybeStartOperations();
+                       });
+          }
+          break;
+        }
+        next_start_time_ =
+            std::max(next_start_time_, now) +
+            absl::Seconds(static_cast<double>(queue.front().num_bytes) /
+                          options_.max_bytes_per_second);
+      }
+      to_start.push_back(std::move(queue.front().start));
+      queue.pop_front();
+      ++in_flight_;
+    }
+  }
+  for (auto& start : to_start) {
+    std::move(start)().ExecuteWhenReady(
+        [self = WritebackSchedulerPtr(this)](ReadyFuture<const void>) {
+          self->Finish();
+        });
+  }
+}
+
+void WritebackScheduler::Finish() {
+  {
+    absl::MutexLock lock(&mutex_);
+    --in_flight_;
+  }
+  MaybeStartOperations();
+}
+
+size_t WritebackScheduler::in_flight() const {
+  absl::MutexLock lock(&mutex_);
+  return in_flight_;
+}
+
+size_t WritebackScheduler::queued() const {
+  absl::MutexLock lock(&mutex_);
+  return high_priority_queue_.size() + queue_.size();
+}
+
+}  // namespace internal
+}  // namespace tensorstore
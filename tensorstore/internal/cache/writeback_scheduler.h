@@ -0,0 +1,103 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
+#define TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Paces the start of background writeback operations.
+///
+/// Operations are started in order of submission, except that high-priority
+/// operations are started before all normal-priority operations, subject to:
+///
+/// - at most `Options::max_concurrency` operations in progress at once, and
+///
+/// - a start rate such that the total size of the started operations does not
+///   exceed `Options::max_bytes_per_second`, averaged over time.
+///
+/// \threadsafety Thread safe.
+class WritebackScheduler : public AtomicReferenceCount<WritebackScheduler> {
+ public:
+  struct Options {
+    /// Maximum number of operations in progress.  `0` indicates no limit.
+    size_t max_concurrency = 0;
+
+    /// Maximum average number of bytes started per second.  `0` indicates no
+    /// limit.
+    size_t max_bytes_per_second = 0;
+  };
+
+  /// Starts the operation and returns a non-null future that becomes ready
+  /// once it completes.
+  ///
+  /// Start functions are invoked from the thread that calls `Schedule`, that
+  /// completes a previous operation, or from a timer thread, and therefore
+  /// must not block.
+  using StartFunction = absl::AnyInvocable<Future<const void>() &&>;
+
+  explicit WritebackScheduler(Options options);
+
+  /// Schedules an operation that writes approximately `num_bytes` bytes.
+  void Schedule(size_t num_bytes, bool high_priority, StartFunction start);
+
+  /// Returns the number of operations in progress.
+  size_t in_flight() const;
+
+  /// Returns the number of operations that have not yet been started.
+  size_t queued() const;
+
+ private:
+  struct Operation {
+    size_t num_bytes;
+    StartFunction start;
+  };
+
+  // Starts queued operations up to the concurrency and rate limits.
+  void MaybeStartOperations();
+  void Finish();
+
+  const Options options_;
+  mutable absl::Mutex mutex_;
+  std::deque<Operation> high_priority_queue_ ABSL_GUARDED_BY(mutex_);
+  std::deque<Operation> queue_ ABSL_GUARDED_BY(mutex_);
+  size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Earliest time at which the next operation may start, given
+  // `Options::max_bytes_per_second`.
+  absl::Time next_start_time_ ABSL_GUARDED_BY(mutex_) = absl::InfinitePast();
+
+  // Indicates that `MaybeStartOperations` is scheduled to run at
+  // `next_start_time_`.
+  bool timer_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+using WritebackSchedulerPtr = IntrusivePtr<WritebackScheduler>;
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_WRITEBACK_SCHEDULER_H_
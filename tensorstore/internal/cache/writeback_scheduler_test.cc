@@ -0,0 +1,107 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache/writeback_scheduler.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::Promise;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal::WritebackScheduler;
+
+TEST(WritebackSchedulerTest, Unlimited) {
+  auto scheduler =
+      MakeIntrusivePtr<WritebackScheduler>(WritebackScheduler::Options{});
+  std::vector<Promise<void>> promises;
+  for (int i = 0; i < 10; ++i) {
+    scheduler->Schedule(100, /*high_priority=*/false, [&] {
+      auto [promise, future] = PromiseFuturePair<void>::Make();
+      promises.push_back(std::move(promise));
+      return Future<const void>(std::move(future));
+    });
+  }
+  EXPECT_EQ(10, promises.size());
+  EXPECT_EQ(10, scheduler->in_flight());
+  promises.clear();
+  EXPECT_EQ(0, scheduler->in_flight());
+}
+
+TEST(WritebackSchedulerTest, MaxConcurrencyAndPriority) {
+  WritebackScheduler::Options options;
+  options.max_concurrency = 2;
+  auto scheduler = MakeIntrusivePtr<WritebackScheduler>(options);
+  std::vector<int> started;
+  std::vector<Promise<void>> promises;
+  auto schedule = [&](int id, bool high_priority) {
+    scheduler->Schedule(100, high_priority, [&, id] {
+      started.push_back(id);
+      auto [promise, future] = PromiseFuturePair<void>::Make();
+      promises.push_back(std::move(promise));
+      return Future<const void>(std::move(future));
+    });
+  };
+  schedule(0, false);
+  schedule(1, false);
+  schedule(2, false);
+  schedule(3, true);
+  EXPECT_THAT(started, ::testing::ElementsAre(0, 1));
+  EXPECT_EQ(2, scheduler->queued());
+
+  // The high-priority operation is started first.
+  promises[0].SetResult(absl::OkStatus());
+  EXPECT_THAT(started, ::testing::ElementsAre(0, 1, 3));
+  promises[1].SetResult(absl::OkStatus());
+  EXPECT_THAT(started, ::testing::ElementsAre(0, 1, 3, 2));
+  EXPECT_EQ(0, scheduler->queued());
+  EXPECT_EQ(2, scheduler->in_flight());
+}
+
+TEST(WritebackSchedulerTest, MaxBytesPerSecond) {
+  WritebackScheduler::Options options;
+  options.max_bytes_per_second = 1000;
+  auto scheduler = MakeIntrusivePtr<WritebackScheduler>(options);
+  absl::Notification done;
+  const absl::Time start_time = absl::Now();
+  absl::Time end_time;
+  for (int i = 0; i < 3; ++i) {
+    scheduler->Schedule(100, /*high_priority=*/false, [&, i] {
+      if (i == 2) {
+        end_time = absl::Now();
+        done.Notify();
+      }
+      return MakeReadyFuture();
+    });
+  }
+  // The first operation starts immediately, and each of the others after
+  // 100 bytes / (1000 bytes/s) = 100ms.
+  done.WaitForNotification();
+  EXPECT_GE(end_time - start_time, absl::Milliseconds(190));
+}
+
+}  // namespace
@@ -0,0 +1,35 @@
+// Copyright 2020 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache_key/fingerprint.h"
+
+#include <string_view>
+
+#include <blake3.h>
+
+namespace tensorstore {
+namespace internal {
+
+CacheKeyFingerprint CacheKeyFingerprint::Compute(
+    std::string_view encoded_key) {
+  blake3_hasher hasher;
+  blake3_hasher_init(&hasher);
+  blake3_hasher_update(&hasher, encoded_key.data(), encoded_key.size());
+  CacheKeyFingerprint fingerprint;
+  blake3_hasher_finalize(&hasher, fingerprint.value.data(), kSize);
+  return fingerprint;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
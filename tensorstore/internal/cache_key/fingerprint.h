@@ -0,0 +1,69 @@
+// Copyright 2020 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CACHE_KEY_FINGERPRINT_H_
+#define TENSORSTORE_INTERNAL_CACHE_KEY_FINGERPRINT_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace tensorstore {
+namespace internal {
+
+/// Fixed-size fingerprint of an encoded cache key.
+///
+/// Cache keys that encode a spec, particularly of a key-value store layered
+/// over other key-value stores, may be kilobytes long.  Where such a key is
+/// itself included in other cache keys, its fingerprint may be encoded
+/// instead.
+///
+/// The fingerprint is the 128-bit BLAKE3 hash of the encoded key, for which
+/// the probability of collisions is negligible.
+struct CacheKeyFingerprint {
+  constexpr static size_t kSize = 16;
+
+  /// Computes the fingerprint of `encoded_key`.
+  static CacheKeyFingerprint Compute(std::string_view encoded_key);
+
+  std::array<unsigned char, kSize> value;
+
+  friend bool operator==(const CacheKeyFingerprint& a,
+                         const CacheKeyFingerprint& b) {
+    return a.value == b.value;
+  }
+  friend bool operator!=(const CacheKeyFingerprint& a,
+                         const CacheKeyFingerprint& b) {
+    return !(a == b);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const CacheKeyFingerprint& x) {
+    return H::combine_contiguous(std::move(h), x.value.data(), kSize);
+  }
+
+  // For compatibility with `EncodeCacheKey`.
+  friend void EncodeCacheKeyAdl(std::string* out,
+                                const CacheKeyFingerprint& x) {
+    out->append(reinterpret_cast<const char*>(x.value.data()), kSize);
+  }
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CACHE_KEY_FINGERPRINT_H_
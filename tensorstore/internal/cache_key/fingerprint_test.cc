@@ -0,0 +1,57 @@
+// Copyright 2020 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/cache_key/fingerprint.h"
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/hash/hash_testing.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+
+namespace {
+
+using ::tensorstore::internal::CacheKeyFingerprint;
+
+TEST(CacheKeyFingerprintTest, Compute) {
+  const std::string long_key(10000, 'x');
+  auto a = CacheKeyFingerprint::Compute("abc");
+  EXPECT_EQ(a, CacheKeyFingerprint::Compute("abc"));
+  EXPECT_NE(a, CacheKeyFingerprint::Compute("abd"));
+  EXPECT_NE(a, CacheKeyFingerprint::Compute(""));
+  EXPECT_EQ(CacheKeyFingerprint::Compute(long_key),
+            CacheKeyFingerprint::Compute(long_key));
+  EXPECT_NE(CacheKeyFingerprint::Compute(long_key),
+            CacheKeyFingerprint::Compute(long_key + "x"));
+  EXPECT_TRUE(absl::VerifyTypeImplementsAbslHashCorrectly({
+      CacheKeyFingerprint::Compute(""),
+      a,
+      CacheKeyFingerprint::Compute(long_key),
+  }));
+}
+
+TEST(CacheKeyFingerprintTest, EncodeCacheKey) {
+  const std::string long_key(10000, 'x');
+  std::string key;
+  tensorstore::internal::EncodeCacheKey(
+      &key, 1, CacheKeyFingerprint::Compute(long_key));
+  EXPECT_EQ(sizeof(int) + CacheKeyFingerprint::kSize, key.size());
+  std::string key2;
+  tensorstore::internal::EncodeCacheKey(
+      &key2, 1, CacheKeyFingerprint::Compute(long_key + "x"));
+  EXPECT_NE(key, key2);
+}
+
+}  // namespace
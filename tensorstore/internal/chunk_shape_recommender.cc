@@ -0,0 +1,540 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_shape_recommender.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/internal/integer_overflow.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_array.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/schema.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+
+namespace jb = ::tensorstore::internal_json_binding;
+
+TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
+    ArrayAccess,
+    jb::Object(
+        jb::Member("origin", jb::Projection<&ArrayAccess::origin>()),
+        jb::Member("shape", jb::Projection<&ArrayAccess::shape>()),
+        jb::OptionalMember("write", jb::Projection<&ArrayAccess::write>()),
+        jb::OptionalMember("weight", jb::Projection<&ArrayAccess::weight>())))
+
+TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
+    StorageCostModel,
+    jb::Object(
+        jb::OptionalMember(
+            "request_latency",
+            jb::Projection<&StorageCostModel::request_latency>()),
+        jb::OptionalMember("read_bandwidth",
+                           jb::Projection<&StorageCostModel::read_bandwidth>()),
+        jb::OptionalMember(
+            "write_bandwidth",
+            jb::Projection<&StorageCostModel::write_bandwidth>()),
+        jb::OptionalMember("max_concurrency",
+                           jb::Projection<&StorageCostModel::max_concurrency>(
+                               jb::Integer<int64_t>(1)))))
+
+void ArrayAccessRecorder::Record(BoxView<> region, bool write) {
+  absl::MutexLock lock(&mutex_);
+  for (auto& access : accesses_) {
+    if (access.write == write &&
+        std::equal(access.origin.begin(), access.origin.end(),
+                   region.origin().begin(), region.origin().end()) &&
+        std::equal(access.shape.begin(), access.shape.end(),
+                   region.shape().begin(), region.shape().end())) {
+      access.weight += 1;
+      return;
+    }
+  }
+  auto& access = accesses_.emplace_back();
+  access.origin.assign(region.origin().begin(), region.origin().end());
+  access.shape.assign(region.shape().begin(), region.shape().end());
+  access.write = write;
+}
+
+std::vector<ArrayAccess> ArrayAccessRecorder::accesses() const {
+  absl::MutexLock lock(&mutex_);
+  return accesses_;
+}
+
+Result<Schema> ChunkShapeRecommendation::ToSchema() const {
+  Schema schema;
+  const DimensionIndex rank = grid_origin.size();
+  TENSORSTORE_RETURN_IF_ERROR(schema.Set(RankConstraint(rank)));
+  TENSORSTORE_RETURN_IF_ERROR(schema.Set(ChunkLayout::GridOrigin(grid_origin)));
+  TENSORSTORE_RETURN_IF_ERROR(
+      schema.Set(ChunkLayout::ReadChunkShape(read_chunk_shape)));
+  TENSORSTORE_RETURN_IF_ERROR(
+      schema.Set(ChunkLayout::WriteChunkShape(write_chunk_shape)));
+  return schema;
+}
+
+namespace {
+
+// Maximum chunk size considered in a dimension of unbounded size.
+constexpr Index kMaxChunkSize = Index(1) << 40;
+
+// Returns the origin of the chunk grid in each dimension of `domain`.
+std::vector<Index> GetGridOrigin(BoxView<> domain) {
+  std::vector<Index> grid_origin(domain.rank());
+  for (DimensionIndex i = 0; i < domain.rank(); ++i) {
+    const Index origin = domain[i].inclusive_min();
+    grid_origin[i] = origin == -kInfIndex ? 0 : origin;
+  }
+  return grid_origin;
+}
+
+// Intersects `accesses` with `domain`, and combines identical accesses.
+Result<std::vector<ArrayAccess>> NormalizeAccesses(
+    BoxView<> domain, span<const ArrayAccess> accesses) {
+  const DimensionIndex rank = domain.rank();
+  std::vector<ArrayAccess> normalized;
+  Box<> region(rank);
+  for (const auto& access : accesses) {
+    if (access.origin.size() != static_cast<size_t>(rank) ||
+        access.shape.size() != static_cast<size_t>(rank)) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Rank of access ", span(access.origin), " ", span(access.shape),
+          " does not match rank of domain ", domain));
+    }
+    if (!(access.weight > 0)) continue;
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto interval,
+          IndexInterval::Sized(access.origin[i], access.shape[i]),
+          tensorstore::MaybeAnnotateStatus(_, "Invalid access"));
+      region[i] = Intersect(interval, domain[i]);
+    }
+    if (region.is_empty()) continue;
+    auto it = std::find_if(
+        normalized.begin(), normalized.end(), [&](const ArrayAccess& x) {
+          return x.write == access.write &&
+                 std::equal(x.origin.begin(), x.origin.end(),
+                            region.origin().begin()) &&
+                 std::equal(x.shape.begin(), x.shape.end(),
+                            region.shape().begin());
+        });
+    if (it != normalized.end()) {
+      it->weight += access.weight;
+      continue;
+    }
+    auto& x = normalized.emplace_back();
+    x.origin.assign(region.origin().begin(), region.origin().end());
+    x.shape.assign(region.shape().begin(), region.shape().end());
+    x.write = access.write;
+    x.weight = access.weight;
+  }
+  return normalized;
+}
+
+class CostEvaluator {
+ public:
+  CostEvaluator(BoxView<> domain, span<const ArrayAccess> accesses,
+                const ChunkShapeRecommenderOptions& options)
+      : domain_(domain),
+        grid_origin_(GetGridOrigin(domain)),
+        accesses_(accesses),
+        options_(options) {}
+
+  double ChunkBytes(span<const Index> chunk_shape) const {
+    double bytes = options_.bytes_per_element;
+    for (Index size : chunk_shape) bytes *= static_cast<double>(size);
+    return bytes;
+  }
+
+  // Returns the total time of the accesses, including writes only if
+  // `include_writes` is `true`.
+  double Cost(span<const Index> read_chunk_shape,
+              span<const Index> write_chunk_shape,
+              bool include_writes = true) const {
+    const double read_chunk_bytes = ChunkBytes(read_chunk_shape);
+    const double write_chunk_bytes = ChunkBytes(write_chunk_shape);
+    const auto& storage = options_.storage;
+    double total = 0;
+    for (const auto& access : accesses_) {
+      if (!access.write) {
+        double num_chunks = 1;
+        for (DimensionIndex i = 0; i < domain_.rank(); ++i) {
+          num_chunks *= CountChunks(i, access, read_chunk_shape[i]).first;
+        }
+        total += access.weight * RequestTime(num_chunks,
+                                             num_chunks * read_chunk_bytes,
+                                             storage.read_bandwidth);
+      } else if (include_writes) {
+        double num_chunks = 1, num_full_chunks = 1;
+        for (DimensionIndex i = 0; i < domain_.rank(); ++i) {
+          auto [touched, full] = CountChunks(i, access, write_chunk_shape[i]);
+          num_chunks *= touched;
+          num_full_chunks *= full;
+        }
+        const double num_partial_chunks = num_chunks - num_full_chunks;
+        total += access.weight *
+                 (RequestTime(num_partial_chunks,
+                              num_partial_chunks * write_chunk_bytes,
+                              storage.read_bandwidth) +
+                  RequestTime(num_chunks, num_chunks * write_chunk_bytes,
+                              storage.write_bandwidth));
+      }
+    }
+    return total;
+  }
+
+ private:
+  double RequestTime(double num_requests, double bytes,
+                     double bandwidth) const {
+    if (num_requests == 0) return 0;
+    const auto& storage = options_.storage;
+    return std::ceil(num_requests /
+                     static_cast<double>(storage.max_concurrency)) *
+               storage.request_latency +
+           bytes / bandwidth;
+  }
+
+  // Returns the number of chunks of size `chunk_size` in dimension `dim`
+  // intersected by `access`, and the number of those that `access` covers
+  // completely (within the domain).
+  std::pair<double, double> CountChunks(DimensionIndex dim,
+                                        const ArrayAccess& access,
+                                        Index chunk_size) const {
+    const Index origin = grid_origin_[dim];
+    const Index domain_min = domain_[dim].inclusive_min();
+    const Index domain_max = domain_[dim].exclusive_max();
+    const Index access_min = access.origin[dim];
+    const Index access_max = access_min + access.shape[dim];
+    const Index first = FloorOfRatio(access_min - origin, chunk_size);
+    const Index last = FloorOfRatio(access_max - 1 - origin, chunk_size);
+    const auto is_full = [&](Index chunk) {
+      const Index chunk_min = origin + chunk * chunk_size;
+      const Index chunk_max = AddSaturate(chunk_min, chunk_size);
+      return std::max(chunk_min, domain_min) >= access_min &&
+             std::min(chunk_max, domain_max) <= access_max;
+    };
+    const Index touched = last - first + 1;
+    Index full = touched;
+    if (!is_full(first)) --full;
+    if (last != first && !is_full(last)) --full;
+    return {static_cast<double>(touched), static_cast<double>(full)};
+  }
+
+  BoxView<> domain_;
+  std::vector<Index> grid_origin_;
+  span<const ArrayAccess> accesses_;
+  const ChunkShapeRecommenderOptions& options_;
+};
+
+// Minimizes `cost` by a local search over `state`, where `state[i]` is an
+// index into `candidates[i]`.  Moves change one dimension by one step, or two
+// dimensions by one step in opposite directions, which preserves the
+// approximate chunk size.
+//
+// `cost` must return infinity for infeasible states.
+template <typename Cost>
+double LocalSearch(span<const std::vector<Index>> candidates,
+                   std::vector<size_t>& state, Cost cost) {
+  const size_t rank = state.size();
+  double best_cost = cost(state);
+  std::vector<size_t> neighbor;
+  for (int iteration = 0; iteration < 10000; ++iteration) {
+    double best_neighbor_cost = best_cost;
+    std::vector<size_t> best_neighbor;
+    const auto consider = [&] {
+      const double neighbor_cost = cost(neighbor);
+      if (neighbor_cost < best_neighbor_cost) {
+        best_neighbor_cost = neighbor_cost;
+        best_neighbor = neighbor;
+      }
+    };
+    for (size_t i = 0; i < rank; ++i) {
+      for (int di : {-1, 1}) {
+        neighbor = state;
+        if (di < 0 ? state[i] == 0 : state[i] + 1 == candidates[i].size()) {
+          continue;
+        }
+        neighbor[i] += di;
+        consider();
+        for (size_t j = 0; j < rank; ++j) {
+          if (j == i) continue;
+          if (di > 0 ? neighbor[j] == 0
+                     : neighbor[j] + 1 == candidates[j].size()) {
+            continue;
+          }
+          neighbor[j] -= di;
+          consider();
+          neighbor[j] += di;
+        }
+      }
+    }
+    // Require a relative improvement to guarantee termination despite
+    // rounding.
+    if (best_neighbor.empty() ||
+        !(best_neighbor_cost < best_cost * (1 - 1e-9))) {
+      break;
+    }
+    state = std::move(best_neighbor);
+    best_cost = best_neighbor_cost;
+  }
+  return best_cost;
+}
+
+std::vector<Index> GetShape(span<const std::vector<Index>> candidates,
+                            span<const size_t> state) {
+  std::vector<Index> shape(state.size());
+  for (size_t i = 0; i < state.size(); ++i) {
+    shape[i] = candidates[i][state[i]];
+  }
+  return shape;
+}
+
+// Returns the index of the largest element of `sizes` that is not greater
+// than `size`, or `0`.
+size_t FindCandidate(span<const Index> sizes, Index size) {
+  size_t i = 0;
+  while (i + 1 < static_cast<size_t>(sizes.size()) && sizes[i + 1] <= size) {
+    ++i;
+  }
+  return i;
+}
+
+class Recommender {
+ public:
+  Recommender(BoxView<> domain, span<const ArrayAccess> accesses,
+              const ChunkShapeRecommenderOptions& options)
+      : domain_(domain), evaluator_(domain, accesses, options),
+        options_(options) {
+    // Read chunk sizes are powers of two, or the full extent.
+    read_candidates_.resize(domain.rank());
+    for (DimensionIndex i = 0; i < domain.rank(); ++i) {
+      const Index extent = std::min(domain[i].size(), kMaxChunkSize);
+      auto& sizes = read_candidates_[i];
+      for (Index size = 1; size < extent; size *= 2) sizes.push_back(size);
+      sizes.push_back(std::max(extent, Index(1)));
+    }
+    std::vector<Index> full_shape(domain.rank());
+    for (DimensionIndex i = 0; i < domain.rank(); ++i) {
+      full_shape[i] = read_candidates_[i].back();
+    }
+    min_read_chunk_bytes_ =
+        std::min(static_cast<double>(options.min_read_chunk_bytes),
+                 evaluator_.ChunkBytes(full_shape));
+  }
+
+  bool IsFeasibleReadChunk(span<const Index> shape) const {
+    const double bytes = evaluator_.ChunkBytes(shape);
+    return bytes >= min_read_chunk_bytes_ &&
+           bytes <= static_cast<double>(options_.max_read_chunk_bytes);
+  }
+
+  // Adjusts `state` to satisfy the bounds on the read chunk size, by
+  // repeatedly shrinking the largest or growing the smallest dimension.
+  void MakeFeasible(std::vector<size_t>& state) const {
+    const size_t rank = state.size();
+    for (size_t iteration = 0; iteration < 64 * rank; ++iteration) {
+      auto shape = GetShape(read_candidates_, state);
+      const double bytes = evaluator_.ChunkBytes(shape);
+      std::optional<size_t> best;
+      if (bytes > static_cast<double>(options_.max_read_chunk_bytes)) {
+        for (size_t i = 0; i < rank; ++i) {
+          if (state[i] == 0) continue;
+          if (!best || shape[i] > shape[*best]) best = i;
+        }
+        if (!best) return;
+        --state[*best];
+      } else if (bytes < min_read_chunk_bytes_) {
+        for (size_t i = 0; i < rank; ++i) {
+          if (state[i] + 1 == read_candidates_[i].size()) continue;
+          if (!best || shape[i] < shape[*best]) best = i;
+        }
+        if (!best) return;
+        ++state[*best];
+      } else {
+        return;
+      }
+    }
+  }
+
+  // Returns starting points for the search of read chunk shapes.
+  std::vector<std::vector<size_t>> GetSeeds(
+      span<const ArrayAccess> accesses) const {
+    const DimensionIndex rank = domain_.rank();
+    std::vector<std::vector<size_t>> seeds;
+    std::vector<Index> shape(rank);
+    if (ChooseChunkShape(ChunkLayout::GridView(), domain_, shape).ok()) {
+      auto& seed = seeds.emplace_back(rank);
+      for (DimensionIndex i = 0; i < rank; ++i) {
+        seed[i] = FindCandidate(read_candidates_[i], shape[i]);
+      }
+    }
+    if (!accesses.empty()) {
+      // Weighted median of the extent of the accesses in each dimension.
+      auto& seed = seeds.emplace_back(rank);
+      std::vector<std::pair<Index, double>> extents;
+      for (DimensionIndex i = 0; i < rank; ++i) {
+        extents.clear();
+        double total_weight = 0;
+        for (const auto& access : accesses) {
+          extents.emplace_back(access.shape[i], access.weight);
+          total_weight += access.weight;
+        }
+        std::sort(extents.begin(), extents.end());
+        double cumulative_weight = 0;
+        Index median = extents.back().first;
+        for (const auto& [extent, weight] : extents) {
+          cumulative_weight += weight;
+          if (cumulative_weight * 2 >= total_weight) {
+            median = extent;
+            break;
+          }
+        }
+        seed[i] = FindCandidate(read_candidates_[i], median);
+      }
+    }
+    for (auto& seed : seeds) MakeFeasible(seed);
+    return seeds;
+  }
+
+  // Returns the read chunk shape that minimizes the cost without sharding,
+  // including writes only if `include_writes` is `true`.
+  std::vector<Index> SearchReadChunkShape(span<const ArrayAccess> accesses,
+                                          bool include_writes) const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<Index> best_shape;
+    double best_cost = infinity;
+    for (auto& seed : GetSeeds(accesses)) {
+      const double cost = LocalSearch(
+          read_candidates_, seed, [&](span<const size_t> state) {
+            auto shape = GetShape(read_candidates_, state);
+            if (!IsFeasibleReadChunk(shape)) return infinity;
+            return evaluator_.Cost(shape, shape, include_writes);
+          });
+      if (best_shape.empty() || cost < best_cost) {
+        best_cost = cost;
+        best_shape = GetShape(read_candidates_, seed);
+      }
+    }
+    return best_shape;
+  }
+
+  // Returns the write chunk shape, a multiple of `read_chunk_shape`, that
+  // minimizes the cost.
+  std::vector<Index> SearchWriteChunkShape(
+      span<const Index> read_chunk_shape) const {
+    const DimensionIndex rank = domain_.rank();
+    std::vector<std::vector<Index>> candidates(rank);
+    for (DimensionIndex i = 0; i < rank; ++i) {
+      const Index extent = domain_[i].size();
+      auto& sizes = candidates[i];
+      // Multiply by powers of two until the chunk covers the full extent.
+      for (Index size = read_chunk_shape[i];; size *= 2) {
+        sizes.push_back(size);
+        if (size >= extent || size > kMaxChunkSize / 2) break;
+      }
+    }
+    std::vector<size_t> state(rank, 0);
+    if (options_.allow_sharding) {
+      const double infinity = std::numeric_limits<double>::infinity();
+      LocalSearch(candidates, state, [&](span<const size_t> state) {
+        auto shape = GetShape(candidates, state);
+        if (evaluator_.ChunkBytes(shape) >
+            static_cast<double>(options_.max_write_chunk_bytes)) {
+          return infinity;
+        }
+        return evaluator_.Cost(read_chunk_shape, shape);
+      });
+    }
+    return GetShape(candidates, state);
+  }
+
+  const CostEvaluator& evaluator() const { return evaluator_; }
+
+ private:
+  BoxView<> domain_;
+  CostEvaluator evaluator_;
+  const ChunkShapeRecommenderOptions& options_;
+  std::vector<std::vector<Index>> read_candidates_;
+  double min_read_chunk_bytes_;
+};
+
+}  // namespace
+
+Result<double> EstimateAccessCost(BoxView<> domain,
+                                  span<const Index> read_chunk_shape,
+                                  span<const Index> write_chunk_shape,
+                                  span<const ArrayAccess> accesses,
+                                  const ChunkShapeRecommenderOptions& options) {
+  assert(read_chunk_shape.size() == domain.rank());
+  assert(write_chunk_shape.size() == domain.rank());
+  TENSORSTORE_ASSIGN_OR_RETURN(auto normalized,
+                               NormalizeAccesses(domain, accesses));
+  return CostEvaluator(domain, normalized, options)
+      .Cost(read_chunk_shape, write_chunk_shape);
+}
+
+Result<ChunkShapeRecommendation> RecommendChunkShapes(
+    BoxView<> domain, span<const ArrayAccess> accesses,
+    const ChunkShapeRecommenderOptions& options) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto normalized,
+                               NormalizeAccesses(domain, accesses));
+  Recommender recommender(domain, normalized, options);
+  ChunkShapeRecommendation recommendation;
+  recommendation.grid_origin = GetGridOrigin(domain);
+  bool found = false;
+  // Without sharding, the read chunk shape must balance the cost of reads
+  // and of writes.  With sharding, the read chunk shape may instead be
+  // optimized for reads alone, and the write chunk shape for writes.
+  for (bool include_writes : {true, false}) {
+    if (!include_writes && !options.allow_sharding) break;
+    auto read_chunk_shape =
+        recommender.SearchReadChunkShape(normalized, include_writes);
+    auto write_chunk_shape =
+        recommender.SearchWriteChunkShape(read_chunk_shape);
+    const double cost =
+        recommender.evaluator().Cost(read_chunk_shape, write_chunk_shape);
+    if (!found || cost < recommendation.cost) {
+      found = true;
+      recommendation.cost = cost;
+      recommendation.read_chunk_shape = std::move(read_chunk_shape);
+      recommendation.write_chunk_shape = std::move(write_chunk_shape);
+    }
+  }
+  return recommendation;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
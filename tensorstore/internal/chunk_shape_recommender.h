@@ -0,0 +1,173 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_CHUNK_SHAPE_RECOMMENDER_H_
+#define TENSORSTORE_INTERNAL_CHUNK_SHAPE_RECOMMENDER_H_
+
+/// \file
+///
+/// Recommends read and write chunk shapes for an array from a recorded trace
+/// of the regions that a workload accesses, and a simple model of the latency
+/// and bandwidth of the underlying storage.
+///
+/// In contrast to `ChooseChunkShape`, which only considers the total number of
+/// elements and the aspect ratio, the recommended shapes minimize the
+/// estimated cost of the recorded accesses, which accounts for read
+/// amplification (whole chunks are read even if only part is accessed),
+/// read-modify-write of partially-written write chunks, and the per-request
+/// latency.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/box.h"
+#include "tensorstore/index.h"
+#include "tensorstore/json_serialization_options.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/schema.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Region of an array accessed by a single read or write request.
+struct ArrayAccess {
+  std::vector<Index> origin;
+  std::vector<Index> shape;
+
+  /// Indicates a write rather than a read.
+  bool write = false;
+
+  /// Number of times the access occurs.
+  double weight = 1;
+
+  TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(ArrayAccess, JsonSerializationOptions,
+                                          JsonSerializationOptions);
+};
+
+/// Records the accesses made by a workload, e.g. from the domains of the
+/// transforms passed to `tensorstore::Read` and `tensorstore::Write`.
+///
+/// Identical accesses are combined by incrementing `ArrayAccess::weight`.
+///
+/// \threadsafety Thread safe.
+class ArrayAccessRecorder {
+ public:
+  void RecordRead(BoxView<> region) { Record(region, /*write=*/false); }
+  void RecordWrite(BoxView<> region) { Record(region, /*write=*/true); }
+  void Record(BoxView<> region, bool write);
+
+  /// Returns the accesses recorded so far.
+  std::vector<ArrayAccess> accesses() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::vector<ArrayAccess> accesses_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Latency and bandwidth characteristics of a storage system.
+struct StorageCostModel {
+  /// Time, in seconds, to first byte of each request.
+  double request_latency = 0.02;
+
+  /// Throughput, in bytes per second, of reads and writes, respectively.
+  double read_bandwidth = 200e6;
+  double write_bandwidth = 100e6;
+
+  /// Maximum number of requests issued concurrently for a single access.
+  int64_t max_concurrency = 32;
+
+  TENSORSTORE_DECLARE_JSON_DEFAULT_BINDER(StorageCostModel,
+                                          JsonSerializationOptions,
+                                          JsonSerializationOptions);
+};
+
+struct ChunkShapeRecommenderOptions {
+  StorageCostModel storage;
+
+  /// Average number of stored (i.e. encoded) bytes per element.  This is the
+  /// data type size divided by the expected compression ratio.
+  double bytes_per_element = 1;
+
+  /// Bounds on the number of stored bytes of each read chunk.
+  int64_t min_read_chunk_bytes = 16 * 1024;
+  int64_t max_read_chunk_bytes = 64 * 1024 * 1024;
+
+  /// Permit write chunks (shards) larger than the read chunks.
+  bool allow_sharding = true;
+
+  /// Upper bound on the number of stored bytes of each write chunk.
+  int64_t max_write_chunk_bytes = int64_t(2) * 1024 * 1024 * 1024;
+};
+
+struct ChunkShapeRecommendation {
+  /// Origin of the chunk grid, equal to the origin of the domain.
+  std::vector<Index> grid_origin;
+
+  /// Recommended read chunk shape, which evenly divides `write_chunk_shape`.
+  std::vector<Index> read_chunk_shape;
+
+  /// Recommended write chunk shape.  Equal to `read_chunk_shape` if sharding is
+  /// not beneficial.
+  std::vector<Index> write_chunk_shape;
+
+  /// Estimated total time, in seconds, of the accesses using the recommended
+  /// chunk shapes.
+  double cost;
+
+  /// Returns a schema with the recommended chunk layout, as hard constraints.
+  Result<Schema> ToSchema() const;
+};
+
+/// Returns the estimated total time, in seconds, of `accesses` with the
+/// specified chunk shapes.
+///
+/// Reads are assumed to retrieve each read chunk that intersects the accessed
+/// region with a separate request.  Writes are assumed to write each write
+/// chunk that intersects the accessed region with a separate request, and
+/// write chunks that are only partially covered by the region are first read
+/// in their entirety.
+///
+/// \dchecks `write_chunk_shape` is a multiple of `read_chunk_shape`.
+/// \error `absl::StatusCode::kInvalidArgument` if the rank of an access does
+///     not match `domain.rank()`.
+Result<double> EstimateAccessCost(BoxView<> domain,
+                                  span<const Index> read_chunk_shape,
+                                  span<const Index> write_chunk_shape,
+                                  span<const ArrayAccess> accesses,
+                                  const ChunkShapeRecommenderOptions& options);
+
+/// Recommends chunk shapes for `domain` that minimize the estimated cost of
+/// `accesses`.
+///
+/// The chunk shapes are chosen by a local search over power-of-two sizes
+/// (and the full extent) in each dimension, starting from the shape chosen by
+/// `ChooseChunkShape` and from a shape derived from the typical extents of the
+/// accesses.  The result is therefore not necessarily optimal, but is never
+/// worse than these starting points.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if the rank of an access does
+///     not match `domain.rank()`.
+Result<ChunkShapeRecommendation> RecommendChunkShapes(
+    BoxView<> domain, span<const ArrayAccess> accesses,
+    const ChunkShapeRecommenderOptions& options = {});
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CHUNK_SHAPE_RECOMMENDER_H_
@@ -0,0 +1,267 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/chunk_shape_recommender.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/box.h"
+#include "tensorstore/chunk_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Box;
+using ::tensorstore::Index;
+using ::tensorstore::MatchesJson;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::ArrayAccess;
+using ::tensorstore::internal::ArrayAccessRecorder;
+using ::tensorstore::internal::ChunkShapeRecommenderOptions;
+using ::tensorstore::internal::EstimateAccessCost;
+using ::tensorstore::internal::RecommendChunkShapes;
+using ::tensorstore::internal::StorageCostModel;
+using ::testing::ElementsAre;
+
+// Options for which the cost is simply the number of requests plus the number
+// of bytes transferred.
+ChunkShapeRecommenderOptions UnitCostOptions() {
+  ChunkShapeRecommenderOptions options;
+  options.storage.request_latency = 1;
+  options.storage.read_bandwidth = 1;
+  options.storage.write_bandwidth = 1;
+  options.storage.max_concurrency = 1;
+  return options;
+}
+
+ArrayAccess Read(std::vector<Index> origin, std::vector<Index> shape) {
+  ArrayAccess access;
+  access.origin = std::move(origin);
+  access.shape = std::move(shape);
+  return access;
+}
+
+ArrayAccess Write(std::vector<Index> origin, std::vector<Index> shape) {
+  ArrayAccess access = Read(std::move(origin), std::move(shape));
+  access.write = true;
+  return access;
+}
+
+TEST(EstimateAccessCostTest, Read) {
+  const Box<> domain({0}, {100});
+  const std::vector<ArrayAccess> accesses{Read({10}, {20})};
+  // Chunks [10, 20) and [20, 30).
+  EXPECT_THAT(EstimateAccessCost(domain, {{10}}, {{10}}, accesses,
+                                 UnitCostOptions()),
+              ::testing::Optional(2 + 20));
+  // Chunks [0, 16) and [16, 32).
+  EXPECT_THAT(EstimateAccessCost(domain, {{16}}, {{16}}, accesses,
+                                 UnitCostOptions()),
+              ::testing::Optional(2 + 32));
+}
+
+TEST(EstimateAccessCostTest, Weight) {
+  const Box<> domain({0}, {100});
+  auto access = Read({10}, {20});
+  access.weight = 3;
+  EXPECT_THAT(EstimateAccessCost(domain, {{10}}, {{10}}, {{access}},
+                                 UnitCostOptions()),
+              ::testing::Optional(3 * (2 + 20)));
+}
+
+TEST(EstimateAccessCostTest, Concurrency) {
+  const Box<> domain({0}, {100});
+  auto options = UnitCostOptions();
+  options.storage.max_concurrency = 4;
+  // 10 requests are issued in 3 rounds.
+  EXPECT_THAT(EstimateAccessCost(domain, {{10}}, {{10}}, {{Read({0}, {100})}},
+                                 options),
+              ::testing::Optional(3 + 100));
+}
+
+TEST(EstimateAccessCostTest, PartialWrite) {
+  const Box<> domain({0}, {100});
+  const std::vector<ArrayAccess> accesses{Write({10}, {20})};
+  // Both chunks are fully overwritten.
+  EXPECT_THAT(EstimateAccessCost(domain, {{10}}, {{10}}, accesses,
+                                 UnitCostOptions()),
+              ::testing::Optional(2 + 20));
+  // Both chunks must also be read.
+  EXPECT_THAT(EstimateAccessCost(domain, {{16}}, {{16}}, accesses,
+                                 UnitCostOptions()),
+              ::testing::Optional(2 * (2 + 32)));
+}
+
+TEST(EstimateAccessCostTest, WriteAtDomainBoundary) {
+  // The last chunk, `[16, 25)` within the domain, is fully overwritten.
+  EXPECT_THAT(EstimateAccessCost(Box<>({0}, {25}), {{16}}, {{16}},
+                                 {{Write({16}, {9})}}, UnitCostOptions()),
+              ::testing::Optional(1 + 16));
+}
+
+TEST(EstimateAccessCostTest, Sharded) {
+  const Box<> domain({0, 0}, {100, 100});
+  const std::vector<ArrayAccess> accesses{Read({0, 0}, {10, 10}),
+                                          Write({0, 0}, {50, 100})};
+  // Read: 1 read chunk of 100 bytes.  Write: 1 write chunk of 5000 bytes.
+  EXPECT_THAT(EstimateAccessCost(domain, {{10, 10}}, {{50, 100}}, accesses,
+                                 UnitCostOptions()),
+              ::testing::Optional((1 + 100) + (1 + 5000)));
+}
+
+TEST(EstimateAccessCostTest, AccessClippedToDomain) {
+  EXPECT_THAT(EstimateAccessCost(Box<>({0}, {100}), {{10}}, {{10}},
+                                 {{Read({90}, {50}), Read({200}, {10})}},
+                                 UnitCostOptions()),
+              ::testing::Optional(1 + 10));
+}
+
+TEST(EstimateAccessCostTest, RankMismatch) {
+  EXPECT_THAT(EstimateAccessCost(Box<>({0}, {100}), {{10}}, {{10}},
+                                 {{Read({0, 0}, {1, 1})}}, UnitCostOptions()),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Rank of access .* does not match rank of "
+                            "domain .*"));
+}
+
+TEST(RecommendChunkShapesTest, RowReads) {
+  const Box<> domain({0, 0}, {1024, 1024});
+  std::vector<ArrayAccess> accesses;
+  for (Index i = 0; i < 1024; i += 7) {
+    accesses.push_back(Read({i, 0}, {1, 1024}));
+  }
+  ChunkShapeRecommenderOptions options;
+  options.min_read_chunk_bytes = 1024;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto recommendation, RecommendChunkShapes(domain, accesses, options));
+  EXPECT_THAT(recommendation.read_chunk_shape, ElementsAre(1, 1024));
+  EXPECT_EQ(recommendation.read_chunk_shape,
+            recommendation.write_chunk_shape);
+  EXPECT_THAT(recommendation.grid_origin, ElementsAre(0, 0));
+
+  // The recommendation is better than the default chunk shape.
+  std::vector<Index> default_shape(2);
+  TENSORSTORE_ASSERT_OK(tensorstore::internal::ChooseChunkShape(
+      tensorstore::ChunkLayout::GridView(), domain, default_shape));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto default_cost, EstimateAccessCost(domain, default_shape,
+                                            default_shape, accesses, options));
+  EXPECT_LT(recommendation.cost, default_cost);
+}
+
+TEST(RecommendChunkShapesTest, Sharding) {
+  // Small random reads, and large sequential writes.
+  const Box<> domain({0, 0}, {4096, 4096});
+  std::vector<ArrayAccess> accesses;
+  for (Index i = 0; i < 64; ++i) {
+    accesses.push_back(
+        Read({(i * 37 % 64) * 64, (i * 23 % 64) * 64}, {64, 64}));
+  }
+  for (Index i = 0; i < 4096; i += 512) {
+    accesses.push_back(Write({i, 0}, {512, 4096}));
+  }
+  ChunkShapeRecommenderOptions options;
+  options.min_read_chunk_bytes = 1024;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto recommendation, RecommendChunkShapes(domain, accesses, options));
+  EXPECT_THAT(recommendation.read_chunk_shape, ElementsAre(64, 64));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(0, recommendation.write_chunk_shape[i] %
+                     recommendation.read_chunk_shape[i]);
+  }
+  EXPECT_GT(recommendation.write_chunk_shape[0] *
+                recommendation.write_chunk_shape[1],
+            64 * 64);
+
+  options.allow_sharding = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto unsharded, RecommendChunkShapes(domain, accesses, options));
+  EXPECT_EQ(unsharded.read_chunk_shape, unsharded.write_chunk_shape);
+  EXPECT_LT(recommendation.cost, unsharded.cost);
+}
+
+TEST(RecommendChunkShapesTest, NoAccesses) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto recommendation,
+      RecommendChunkShapes(Box<>({0, 0, 0}, {1000, 2000, 3000}), {}));
+  EXPECT_EQ(0, recommendation.cost);
+  EXPECT_EQ(3, recommendation.read_chunk_shape.size());
+}
+
+TEST(RecommendChunkShapesTest, ToSchema) {
+  tensorstore::internal::ChunkShapeRecommendation recommendation;
+  recommendation.grid_origin = {1, 2};
+  recommendation.read_chunk_shape = {4, 8};
+  recommendation.write_chunk_shape = {16, 32};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto schema, recommendation.ToSchema());
+  EXPECT_THAT(schema.ToJson(),
+              ::testing::Optional(MatchesJson({
+                  {"rank", 2},
+                  {"chunk_layout",
+                   {
+                       {"grid_origin", {1, 2}},
+                       {"read_chunk", {{"shape", {4, 8}}}},
+                       {"write_chunk", {{"shape", {16, 32}}}},
+                   }},
+              })));
+}
+
+TEST(ArrayAccessRecorderTest, Basic) {
+  ArrayAccessRecorder recorder;
+  recorder.RecordRead(Box<>({1, 2}, {3, 4}));
+  recorder.RecordWrite(Box<>({1, 2}, {3, 4}));
+  recorder.RecordRead(Box<>({1, 2}, {3, 4}));
+  auto accesses = recorder.accesses();
+  ASSERT_EQ(2, accesses.size());
+  EXPECT_FALSE(accesses[0].write);
+  EXPECT_EQ(2, accesses[0].weight);
+  EXPECT_THAT(accesses[0].origin, ElementsAre(1, 2));
+  EXPECT_THAT(accesses[0].shape, ElementsAre(3, 4));
+  EXPECT_TRUE(accesses[1].write);
+  EXPECT_EQ(1, accesses[1].weight);
+}
+
+TEST(ArrayAccessTest, Json) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto access, ArrayAccess::FromJson({{"origin", {1, 2}},
+                                          {"shape", {3, 4}}}));
+  EXPECT_FALSE(access.write);
+  EXPECT_EQ(1, access.weight);
+  access.write = true;
+  EXPECT_THAT(access.ToJson(), ::testing::Optional(MatchesJson({
+                                   {"origin", {1, 2}},
+                                   {"shape", {3, 4}},
+                                   {"write", true},
+                                   {"weight", 1.0},
+                               })));
+}
+
+TEST(StorageCostModelTest, Json) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto model, StorageCostModel::FromJson({{"request_latency", 0.5}}));
+  EXPECT_EQ(0.5, model.request_latency);
+  EXPECT_EQ(StorageCostModel{}.read_bandwidth, model.read_bandwidth);
+  EXPECT_THAT(StorageCostModel::FromJson({{"max_concurrency", 0}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
@@ -14,17 +14,39 @@
 
 #include "tensorstore/internal/compression/blosc.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <string>
 #include <string_view>
+#include <thread>  // NOLINT
 
 #include "absl/status/status.h"
 #include <blosc.h>
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace blosc {
+namespace {
+
+// Blosc splits its input into blocks that are compressed independently, and
+// can process them in parallel.  Since blosc starts new threads for each call,
+// that is only worthwhile for inputs of several megabytes, which are common
+// for large zarr and N5 chunks.
+constexpr size_t kMinBytesPerThread = 4 * 1024 * 1024;
+constexpr size_t kMaxThreads = 8;
+
+int GetNumThreads(size_t nbytes) {
+  const size_t max_threads = std::min<size_t>(
+      kMaxThreads, std::max(1u, std::thread::hardware_concurrency()));
+  return static_cast<int>(
+      std::clamp<size_t>(nbytes / kMinBytesPerThread, 1, max_threads));
+}
+
+}  // namespace
 
 Result<std::string> Encode(std::string_view input, const Options& options) {
   if (input.size() > BLOSC_MAX_BUFFERSIZE) {
@@ -40,7 +62,7 @@ Result<std::string> Encode(std::string_view input, const Options& options) {
   const int n = blosc_compress_ctx(
       options.clevel, shuffle, options.element_size, input.size(), input.data(),
       output.data(), output.size(), options.compressor, options.blocksize,
-      /*numinternalthreads=*/1);
+      /*numinternalthreads=*/GetNumThreads(input.size()));
   if (n < 0) {
     return absl::InternalError(
         tensorstore::StrCat("Internal blosc error: ", n));
@@ -58,7 +80,7 @@ Result<std::string> Decode(std::string_view input) {
   if (nbytes > 0) {
     const int n =
         blosc_decompress_ctx(input.data(), output.data(), output.size(),
-                             /*numinternalthreads=*/1);
+                             /*numinternalthreads=*/GetNumThreads(nbytes));
     if (n <= 0) {
       return absl::InvalidArgumentError(
           tensorstore::StrCat("Blosc error: ", n));
@@ -67,5 +89,74 @@ Result<std::string> Decode(std::string_view input) {
   return output;
 }
 
+absl::Status Decode(std::string_view input, span<char> output) {
+  size_t nbytes;
+  if (blosc_cbuffer_validate(input.data(), input.size(), &nbytes) != 0) {
+    return absl::InvalidArgumentError("Invalid blosc-compressed data");
+  }
+  if (nbytes != output.size()) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Blosc-compressed data decodes to ", nbytes, " bytes, but expected ",
+        output.size(), " bytes"));
+  }
+  if (nbytes > 0) {
+    const int n =
+        blosc_decompress_ctx(input.data(), output.data(), output.size(),
+                             /*numinternalthreads=*/GetNumThreads(nbytes));
+    if (n <= 0) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Blosc error: ", n));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DecodeRange(std::string_view input, size_t offset,
+                         span<char> output) {
+  size_t nbytes;
+  if (blosc_cbuffer_validate(input.data(), input.size(), &nbytes) != 0) {
+    return absl::InvalidArgumentError("Invalid blosc-compressed data");
+  }
+  if (offset > nbytes || static_cast<size_t>(output.size()) > nbytes - offset) {
+    return absl::OutOfRangeError(tensorstore::StrCat(
+        "Requested byte range [", offset, ", ", offset + output.size(),
+        ") exceeds decompressed size of ", nbytes, " bytes"));
+  }
+  if (output.empty()) return absl::OkStatus();
+  size_t typesize;
+  int flags;
+  blosc_cbuffer_metainfo(input.data(), &typesize, &flags);
+  typesize = std::max<size_t>(typesize, 1);
+  // `blosc_getitem` operates on whole items of `typesize` bytes.
+  const size_t start = offset / typesize;
+  const size_t stop = (offset + output.size() + typesize - 1) / typesize;
+  if (stop * typesize > nbytes) {
+    // The range includes trailing bytes that do not form a complete item.
+    std::string decoded(nbytes, '\0');
+    TENSORSTORE_RETURN_IF_ERROR(
+        Decode(input, span<char>(decoded.data(), decoded.size())));
+    std::memcpy(output.data(), decoded.data() + offset, output.size());
+    return absl::OkStatus();
+  }
+  const bool aligned =
+      start * typesize == offset && stop * typesize == offset + output.size();
+  std::string buffer;
+  char* dest = output.data();
+  if (!aligned) {
+    buffer.resize((stop - start) * typesize);
+    dest = buffer.data();
+  }
+  const int n = blosc_getitem(input.data(), static_cast<int>(start),
+                              static_cast<int>(stop - start), dest);
+  if (n < 0) {
+    return absl::InvalidArgumentError(tensorstore::StrCat("Blosc error: ", n));
+  }
+  if (!aligned) {
+    std::memcpy(output.data(), buffer.data() + (offset - start * typesize),
+                output.size());
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace blosc
 }  // namespace tensorstore
@@ -19,7 +19,9 @@
 #include <string>
 #include <string_view>
 
+#include "absl/status/status.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 /// Convenience interface to the blosc library.
 
@@ -59,6 +61,8 @@ struct Options {
 
 /// Compresses `input`.
 ///
+/// Inputs of several megabytes are compressed using multiple threads.
+///
 /// \param input The input data to compress.
 /// \param options Specifies compression options.
 /// \error `absl::StatusCode::kInvalidArgument` if `input.size()` exceeds
@@ -67,10 +71,35 @@ Result<std::string> Encode(std::string_view input, const Options& options);
 
 /// Decompresses `input`.
 ///
+/// Outputs of several megabytes are decompressed using multiple threads.
+///
 /// \param input The input data to decompress.
 /// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
 Result<std::string> Decode(std::string_view input);
 
+/// Decompresses `input` directly into `output`.
+///
+/// \param input The input data to decompress.
+/// \param output[out] Buffer to fill, must be exactly the decompressed size.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt or does
+///     not decompress to `output.size()` bytes.
+absl::Status Decode(std::string_view input, span<char> output);
+
+/// Decompresses the `output.size()` bytes starting at byte `offset` of the
+/// decompressed representation of `input` into `output`.
+///
+/// Only the blocks that overlap the requested range are decompressed, which
+/// makes this much cheaper than `Decode` for small ranges of large inputs.
+///
+/// \param input The input data to decompress.
+/// \param offset Byte offset into the decompressed representation.
+/// \param output[out] Buffer to fill.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+/// \error `absl::StatusCode::kOutOfRange` if the requested range exceeds the
+///     decompressed size.
+absl::Status DecodeRange(std::string_view input, size_t offset,
+                         span<char> output);
+
 }  // namespace blosc
 }  // namespace tensorstore
 
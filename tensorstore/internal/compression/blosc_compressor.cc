@@ -32,6 +32,7 @@
 #include "riegeli/bytes/write.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/internal/compression/blosc.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -93,5 +94,12 @@ std::unique_ptr<riegeli::Reader> BloscCompressor::GetReader(
   return reader;
 }
 
+absl::Status BloscCompressor::DecodeInto(const absl::Cord& input,
+                                         span<char> output,
+                                         size_t element_bytes) const {
+  absl::Cord flat_input = input;
+  return blosc::Decode(flat_input.Flatten(), output);
+}
+
 }  // namespace internal
 }  // namespace tensorstore
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include <blosc.h>
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
@@ -29,6 +30,7 @@
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/json_serialization_options_base.h"
 #include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
@@ -44,6 +46,10 @@ class BloscCompressor : public JsonSpecifiedCompressor {
       std::unique_ptr<riegeli::Reader> base_reader,
       size_t element_bytes) const override;
 
+  /// Decompresses directly into `output` without buffering the decoded data.
+  absl::Status DecodeInto(const absl::Cord& input, span<char> output,
+                          size_t element_bytes) const override;
+
   static constexpr auto CodecBinder() {
     namespace jb = tensorstore::internal_json_binding;
     return jb::Validate([](const auto& options, std::string* cname) {
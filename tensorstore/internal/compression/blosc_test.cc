@@ -24,7 +24,9 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include <blosc.h>
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace {
 
@@ -87,6 +89,71 @@ TEST(BloscTest, EncodeDecode) {
   }
 }
 
+// Tests encoding and decoding of inputs large enough to use multiple threads.
+TEST(BloscTest, EncodeDecodeLarge) {
+  std::string array(20 * 1024 * 1024, '\0');
+  for (size_t i = 0; i < array.size(); ++i) {
+    array[i] = static_cast<char>((i / 4) * 7 + (i % 4));
+  }
+  for (const char* compressor : {"lz4", "zstd"}) {
+    blosc::Options options{/*.compressor=*/compressor, /*.clevel=*/5,
+                           /*.shuffle=*/-1, /*.blocksize=*/0,
+                           /*.element_size=*/4};
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                     blosc::Encode(array, options));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, blosc::Decode(encoded));
+    EXPECT_EQ(array, decoded);
+  }
+}
+
+// Tests decoding byte ranges, which need not be aligned to elements.
+TEST(BloscTest, DecodeRange) {
+  std::string array(100003, '\0');
+  for (size_t i = 0; i < array.size(); ++i) {
+    array[i] = static_cast<char>(i * 13);
+  }
+  for (const size_t element_size : {1, 4, 10}) {
+    blosc::Options options{/*.compressor=*/"lz4", /*.clevel=*/5,
+                           /*.shuffle=*/-1, /*.blocksize=*/4096,
+                           /*.element_size=*/element_size};
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                     blosc::Encode(array, options));
+    for (const auto& [offset, length] :
+         std::vector<std::pair<size_t, size_t>>{{0, 0},
+                                                {0, 1},
+                                                {0, 40},
+                                                {5, 1000},
+                                                {4095, 2},
+                                                {50000, 30000},
+                                                {100000, 3},
+                                                {0, 100003}}) {
+      SCOPED_TRACE(tensorstore::StrCat("element_size=", element_size,
+                                       ", offset=", offset,
+                                       ", length=", length));
+      std::string output(length, '\0');
+      TENSORSTORE_ASSERT_OK(blosc::DecodeRange(
+          encoded, offset, tensorstore::span<char>(output.data(), length)));
+      EXPECT_EQ(array.substr(offset, length), output);
+    }
+  }
+}
+
+TEST(BloscTest, DecodeRangeOutOfRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded,
+      blosc::Encode("The quick brown fox jumped over the lazy dog.",
+                    blosc::Options{/*.compressor=*/"lz4", /*.clevel=*/1,
+                                   /*.shuffle=*/-1, /*.blocksize=*/0,
+                                   /*element_size=*/1}));
+  char output[10];
+  EXPECT_THAT(blosc::DecodeRange(encoded, 40, output),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(blosc::DecodeRange(encoded, 100, tensorstore::span<char>()),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(blosc::DecodeRange("abc", 0, output),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests that the compressed data has the expected blosc complib.
 TEST(BloscTest, CheckComplib) {
   const std::string_view array =
@@ -0,0 +1,225 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/codec_accelerator.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+struct InstalledAccelerator {
+  absl::Mutex mutex;
+  std::shared_ptr<CodecAccelerator> accelerator ABSL_GUARDED_BY(mutex);
+  // Allows `AcceleratedDecodeInto` to return without locking `mutex` in the
+  // common case that no accelerator is installed.
+  std::atomic<bool> installed{false};
+};
+
+InstalledAccelerator& GetInstalledAccelerator() {
+  static absl::NoDestructor<InstalledAccelerator> installed;
+  return *installed;
+}
+
+struct AcceleratorRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, CodecAcceleratorFactory> factories
+      ABSL_GUARDED_BY(mutex);
+};
+
+AcceleratorRegistry& GetAcceleratorRegistry() {
+  static absl::NoDestructor<AcceleratorRegistry> registry;
+  return *registry;
+}
+
+// Accelerator specified by the innermost `ScopedCodecAccelerator`.
+thread_local CodecAccelerator* scoped_accelerator = nullptr;
+
+// Returns the accelerator to use for the current thread.  The returned pointer
+// remains valid as long as `installed` is not destroyed.
+CodecAccelerator* GetCurrentAccelerator(
+    std::shared_ptr<CodecAccelerator>& installed) {
+  if (scoped_accelerator) return scoped_accelerator;
+  installed = GetCodecAccelerator();
+  return installed.get();
+}
+
+}  // namespace
+
+CodecAccelerator::~CodecAccelerator() = default;
+
+bool CodecAccelerator::ShouldEncode(AcceleratedFormat format,
+                                    size_t input_size) const {
+  return false;
+}
+
+absl::Status CodecAccelerator::Encode(AcceleratedFormat format,
+                                      std::string_view input, int level,
+                                      absl::Cord* output) {
+  return absl::UnavailableError(
+      tensorstore::StrCat(name(), " does not support encoding"));
+}
+
+BatchingCodecAccelerator::BatchingCodecAccelerator(const Options& options)
+    : options_(options) {
+  options_.max_batch_size = std::max(options_.max_batch_size, size_t(1));
+}
+
+bool BatchingCodecAccelerator::BatchReady() const {
+  return queue_.size() >= options_.max_batch_size;
+}
+
+absl::Status BatchingCodecAccelerator::DecodeInto(AcceleratedFormat format,
+                                                  std::string_view input,
+                                                  span<char> output) {
+  Request request{/*encode=*/false, format, input, output};
+  return Submit(request);
+}
+
+absl::Status BatchingCodecAccelerator::Encode(AcceleratedFormat format,
+                                              std::string_view input,
+                                              int level, absl::Cord* output) {
+  Request request{/*encode=*/true, format, input};
+  request.level = level;
+  request.encoded = output;
+  return Submit(request);
+}
+
+absl::Status BatchingCodecAccelerator::Submit(Request& request) {
+  const auto can_proceed = [&]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    return request.done || !leader_active_;
+  };
+  std::vector<Request*> batch;
+  mutex_.Lock();
+  queue_.push_back(&request);
+  while (true) {
+    mutex_.Await(absl::Condition(&can_proceed));
+    if (request.done) break;
+
+    // Become the leader and form a batch, which may not include `request` if
+    // other requests were queued earlier.
+    leader_active_ = true;
+    mutex_.AwaitWithTimeout(
+        absl::Condition(this, &BatchingCodecAccelerator::BatchReady),
+        options_.max_delay);
+    const size_t n = std::min(queue_.size(), options_.max_batch_size);
+    batch.assign(queue_.begin(), queue_.begin() + n);
+    queue_.erase(queue_.begin(), queue_.begin() + n);
+    mutex_.Unlock();
+    ProcessBatch(batch);
+    mutex_.Lock();
+    for (auto* r : batch) r->done = true;
+    leader_active_ = false;
+  }
+  mutex_.Unlock();
+  return request.status;
+}
+
+void SetCodecAccelerator(std::shared_ptr<CodecAccelerator> accelerator) {
+  auto& installed = GetInstalledAccelerator();
+  absl::MutexLock lock(&installed.mutex);
+  installed.installed.store(accelerator != nullptr, std::memory_order_release);
+  installed.accelerator = std::move(accelerator);
+}
+
+std::shared_ptr<CodecAccelerator> GetCodecAccelerator() {
+  auto& installed = GetInstalledAccelerator();
+  if (!installed.installed.load(std::memory_order_acquire)) return nullptr;
+  absl::MutexLock lock(&installed.mutex);
+  return installed.accelerator;
+}
+
+ScopedCodecAccelerator::ScopedCodecAccelerator(CodecAccelerator* accelerator)
+    : prev_(scoped_accelerator) {
+  if (accelerator) scoped_accelerator = accelerator;
+}
+
+ScopedCodecAccelerator::~ScopedCodecAccelerator() {
+  scoped_accelerator = prev_;
+}
+
+bool AcceleratedDecodeInto(AcceleratedFormat format, const absl::Cord& input,
+                           span<char> output, absl::Status& status) {
+  std::shared_ptr<CodecAccelerator> installed;
+  auto* accelerator = GetCurrentAccelerator(installed);
+  if (!accelerator || !accelerator->ShouldDecode(format, output.size())) {
+    return false;
+  }
+  absl::Cord flat_input = input;
+  status = accelerator->DecodeInto(format, flat_input.Flatten(), output);
+  return !absl::IsUnavailable(status);
+}
+
+bool AcceleratedEncode(AcceleratedFormat format, const absl::Cord& input,
+                       int level, absl::Cord* output, absl::Status& status) {
+  std::shared_ptr<CodecAccelerator> installed;
+  auto* accelerator = GetCurrentAccelerator(installed);
+  if (!accelerator || !accelerator->ShouldEncode(format, input.size())) {
+    return false;
+  }
+  absl::Cord flat_input = input;
+  // Encode to a separate `Cord` such that `output` is unchanged if the caller
+  // must fall back to the CPU.
+  absl::Cord encoded;
+  status = accelerator->Encode(format, flat_input.Flatten(), level, &encoded);
+  if (absl::IsUnavailable(status)) return false;
+  if (status.ok()) output->Append(std::move(encoded));
+  return true;
+}
+
+void RegisterCodecAccelerator(std::string name,
+                              CodecAcceleratorFactory factory) {
+  auto& registry = GetAcceleratorRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.factories[std::move(name)] = std::move(factory);
+}
+
+Result<std::shared_ptr<CodecAccelerator>> CreateCodecAccelerator(
+    std::string_view name) {
+  CodecAcceleratorFactory factory;
+  {
+    auto& registry = GetAcceleratorRegistry();
+    absl::MutexLock lock(&registry.mutex);
+    auto it = registry.factories.find(name);
+    if (it == registry.factories.end()) {
+      return absl::NotFoundError(tensorstore::StrCat(
+          "Codec accelerator ", QuoteString(name), " is not registered"));
+    }
+    factory = it->second;
+  }
+  return factory();
+}
+
+}  // namespace internal
+}  // namespace tensorstore
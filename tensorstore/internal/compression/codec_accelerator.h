@@ -0,0 +1,250 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_H_
+
+/// \file
+///
+/// Interface for offloading compression and decompression to an accelerator
+/// device, such as a GPU or a dedicated compression engine.
+///
+/// The accelerator used by the current thread is, in order of precedence:
+///
+/// - the accelerator specified to an enclosing `ScopedCodecAccelerator`, which
+///   drivers use to apply the accelerator specified by the
+///   `CodecAcceleratorResource` context resource; or
+///
+/// - the accelerator installed process-wide via `SetCodecAccelerator`.
+///
+/// Compressors that decode complete inputs into a caller-provided buffer first
+/// offer the input to the accelerator by calling `AcceleratedDecodeInto`, and
+/// compressors that support accelerated encoding call `AcceleratedEncode`.
+/// Both fall back to the CPU if there is no accelerator, the format or input
+/// is not supported, or the accelerator is temporarily unavailable.
+///
+/// Accelerator implementations are registered by name with
+/// `RegisterCodecAccelerator`, such that they can be selected by the context
+/// resource.
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Compression formats that may be handled by a `CodecAccelerator`.
+enum class AcceleratedFormat {
+  /// Zstandard frames.
+  kZstd,
+  /// Deflate with the zlib header.
+  kZlib,
+  /// Deflate with the gzip header.
+  kGzip,
+};
+
+/// Abstract interface for a compression accelerator.
+///
+/// \threadsafety Implementations must be thread safe.
+class CodecAccelerator {
+ public:
+  virtual ~CodecAccelerator();
+
+  /// Returns a name that identifies the accelerator in diagnostics.
+  virtual std::string_view name() const = 0;
+
+  /// Indicates if inputs of the specified format and decoded size should be
+  /// offered to `DecodeInto`.
+  ///
+  /// Accelerators typically decline formats they do not implement and inputs
+  /// too small to amortize the cost of a transfer to the device.
+  virtual bool ShouldDecode(AcceleratedFormat format,
+                            size_t decoded_size) const = 0;
+
+  /// Decodes `input` into `output`, which is exactly the size of the decoded
+  /// data.
+  ///
+  /// \error `absl::StatusCode::kInvalidArgument` if `input` is invalid or does
+  ///     not decode to exactly `output.size()` bytes.
+  /// \error `absl::StatusCode::kUnavailable` to indicate that the caller
+  ///     should decode on the CPU instead, e.g. if device memory is exhausted.
+  virtual absl::Status DecodeInto(AcceleratedFormat format,
+                                  std::string_view input,
+                                  span<char> output) = 0;
+
+  /// Indicates if inputs of the specified format and size should be offered
+  /// to `Encode`.
+  ///
+  /// The default implementation returns `false`.
+  virtual bool ShouldEncode(AcceleratedFormat format, size_t input_size) const;
+
+  /// Encodes `input` with the specified compression `level`, where `-1`
+  /// indicates the default level, and appends the result to `*output`.
+  ///
+  /// The encoded representation must be decodable by the software
+  /// implementation of `format`, but need not be identical to it.
+  ///
+  /// \error `absl::StatusCode::kUnavailable` to indicate that the caller
+  ///     should encode on the CPU instead.
+  ///
+  /// The default implementation returns `absl::StatusCode::kUnavailable`.
+  virtual absl::Status Encode(AcceleratedFormat format, std::string_view input,
+                              int level, absl::Cord* output);
+};
+
+/// Partial `CodecAccelerator` implementation that combines concurrent calls to
+/// `DecodeInto` and `Encode` into batches, for accelerators whose per-call
+/// overhead (kernel launch, doorbell and transfer latency) would otherwise
+/// dominate for individual chunks.
+///
+/// Since chunks are encoded and decoded concurrently by many threads of the
+/// data copy executor, the first caller to arrive while no batch is being
+/// formed waits up to `Options::max_delay` for up to `Options::max_batch_size`
+/// requests, and then processes them all by calling `ProcessBatch`.  The other
+/// callers block until their request has been processed.  A single batch may
+/// contain both encode and decode requests.
+class BatchingCodecAccelerator : public CodecAccelerator {
+ public:
+  struct Options {
+    /// Maximum number of requests processed by a single `ProcessBatch` call.
+    size_t max_batch_size = 64;
+
+    /// Maximum time to wait for additional requests before processing a
+    /// batch.
+    absl::Duration max_delay = absl::Microseconds(100);
+  };
+
+  struct Request {
+    /// Indicates an `Encode` rather than a `DecodeInto` request.
+    bool encode;
+    AcceleratedFormat format;
+    std::string_view input;
+
+    /// Output buffer of a decode request.
+    span<char> output;
+
+    /// Compression level and output of an encode request.
+    int level = -1;
+    absl::Cord* encoded = nullptr;
+
+    /// Must be set by `ProcessBatch`.
+    absl::Status status;
+
+    // Set once `status` is valid.  Guarded by the accelerator mutex.
+    bool done = false;
+  };
+
+  explicit BatchingCodecAccelerator(const Options& options);
+
+  absl::Status DecodeInto(AcceleratedFormat format, std::string_view input,
+                          span<char> output) final;
+
+  absl::Status Encode(AcceleratedFormat format, std::string_view input,
+                      int level, absl::Cord* output) final;
+
+ protected:
+  /// Processes each request in `requests`, and sets its `status`.
+  ///
+  /// Called from one thread at a time.
+  virtual void ProcessBatch(span<Request* const> requests) = 0;
+
+ private:
+  absl::Status Submit(Request& request);
+  bool BatchReady() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  Options options_;
+  absl::Mutex mutex_;
+  // Requests not yet claimed by a batch.
+  std::vector<Request*> queue_ ABSL_GUARDED_BY(mutex_);
+  // Indicates that a caller is currently forming or processing a batch.
+  bool leader_active_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+/// Installs `accelerator` for use by all compressors, replacing any previously
+/// installed accelerator, or disables acceleration if `nullptr`.
+void SetCodecAccelerator(std::shared_ptr<CodecAccelerator> accelerator);
+
+/// Returns the installed accelerator, or `nullptr` if none.
+std::shared_ptr<CodecAccelerator> GetCodecAccelerator();
+
+/// Overrides the accelerator used by the current thread for the lifetime of
+/// this object.
+///
+/// If `accelerator` is `nullptr`, the current accelerator is left unchanged.
+/// The caller must ensure `accelerator` outlives this object.
+class ScopedCodecAccelerator {
+ public:
+  explicit ScopedCodecAccelerator(CodecAccelerator* accelerator);
+  ~ScopedCodecAccelerator();
+
+  ScopedCodecAccelerator(const ScopedCodecAccelerator&) = delete;
+  ScopedCodecAccelerator& operator=(const ScopedCodecAccelerator&) = delete;
+
+ private:
+  CodecAccelerator* prev_;
+};
+
+/// Attempts to decode `input` into `output` with the current accelerator.
+///
+/// \returns `true` if the accelerator handled the request, in which case
+///     `status` is set to the result; `false` if the caller must decode on the
+///     CPU.
+bool AcceleratedDecodeInto(AcceleratedFormat format, const absl::Cord& input,
+                           span<char> output, absl::Status& status);
+
+/// Attempts to encode `input` with the current accelerator, appending the
+/// result to `*output`.
+///
+/// \returns `true` if the accelerator handled the request, in which case
+///     `status` is set to the result; `false` if the caller must encode on the
+///     CPU, in which case `*output` is unchanged.
+bool AcceleratedEncode(AcceleratedFormat format, const absl::Cord& input,
+                       int level, absl::Cord* output, absl::Status& status);
+
+/// Creates an accelerator, or returns an error if the device is not present.
+using CodecAcceleratorFactory =
+    std::function<Result<std::shared_ptr<CodecAccelerator>>()>;
+
+/// Registers a factory for accelerators named `name`, for use by
+/// `CreateCodecAccelerator`.
+///
+/// This is normally called by a static initializer of the accelerator
+/// implementation.
+void RegisterCodecAccelerator(std::string name,
+                              CodecAcceleratorFactory factory);
+
+/// Creates an accelerator using the factory registered under `name`.
+///
+/// \error `absl::StatusCode::kNotFound` if no factory is registered.
+/// \error Any error returned by the factory.
+Result<std::shared_ptr<CodecAccelerator>> CreateCodecAccelerator(
+    std::string_view name);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_H_
@@ -0,0 +1,77 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/codec_accelerator_resource.h"
+
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+struct CodecAcceleratorResourceTraits
+    : public ContextResourceTraits<CodecAcceleratorResource> {
+  // The accelerator only affects performance, not the encoded data.
+  constexpr static bool shared_when_decoded = true;
+  using Spec = CodecAcceleratorResource::Spec;
+  using Resource = CodecAcceleratorResource::Resource;
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    return jb::Object(
+        jb::Member("accelerator",
+                   jb::Projection(&Spec::accelerator,
+                                  jb::DefaultInitializedValue())),
+        jb::Member("required",
+                   jb::Projection(&Spec::required,
+                                  jb::DefaultValue([](auto* v) {
+                                    *v = false;
+                                  }))));
+  }
+  static Result<Resource> Create(const Spec& spec,
+                                 ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (spec.accelerator.empty()) return resource;
+    auto accelerator = CreateCodecAccelerator(spec.accelerator);
+    if (accelerator.ok()) {
+      resource.accelerator = std::move(*accelerator);
+    } else if (spec.required) {
+      return std::move(accelerator).status();
+    } else {
+      ABSL_LOG(INFO) << "Falling back to encoding and decoding on the CPU: "
+                     << accelerator.status();
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+const ContextResourceRegistration<CodecAcceleratorResourceTraits>
+    registration;
+
+}  // namespace
+}  // namespace internal
+}  // namespace tensorstore
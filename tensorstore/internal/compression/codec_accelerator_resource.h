@@ -0,0 +1,61 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_RESOURCE_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_RESOURCE_H_
+
+#include <memory>
+#include <string>
+
+#include "tensorstore/internal/compression/codec_accelerator.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Context resource that selects the `CodecAccelerator` used to encode and
+/// decode chunks.
+///
+/// The JSON representation is an object with the optional members:
+///
+/// - "accelerator": Name of an accelerator registered with
+///   `RegisterCodecAccelerator`.  If not specified, the accelerator installed
+///   process-wide, if any, is used.
+///
+/// - "required": If `true`, failing to create the accelerator (e.g. because
+///   the device is not present) is an error.  Otherwise, which is the default,
+///   chunks are encoded and decoded on the CPU instead.
+struct CodecAcceleratorResource {
+  static constexpr char id[] = "codec_accelerator";
+
+  struct Spec {
+    std::string accelerator;
+    bool required = false;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.accelerator, x.required);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+
+    /// Null if no accelerator was specified or it could not be created.
+    std::shared_ptr<CodecAccelerator> accelerator;
+  };
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_CODEC_ACCELERATOR_RESOURCE_H_
@@ -0,0 +1,105 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/codec_accelerator_resource.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::span;
+using ::tensorstore::internal::AcceleratedFormat;
+using ::tensorstore::internal::CodecAccelerator;
+using ::tensorstore::internal::CodecAcceleratorResource;
+using ::tensorstore::internal::RegisterCodecAccelerator;
+
+class NullAccelerator : public CodecAccelerator {
+ public:
+  std::string_view name() const override { return "null"; }
+  bool ShouldDecode(AcceleratedFormat format,
+                    size_t decoded_size) const override {
+    return false;
+  }
+  absl::Status DecodeInto(AcceleratedFormat format, std::string_view input,
+                          span<char> output) override {
+    return absl::UnavailableError("");
+  }
+};
+
+TEST(CodecAcceleratorResourceTest, Default) {
+  auto resource_spec =
+      Context::Resource<CodecAcceleratorResource>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ("", resource->spec.accelerator);
+  EXPECT_FALSE(resource->accelerator);
+  EXPECT_THAT(resource_spec.ToJson(),
+              IsOkAndHolds(::nlohmann::json(::nlohmann::json::object_t{})));
+}
+
+TEST(CodecAcceleratorResourceTest, Registered) {
+  RegisterCodecAccelerator(
+      "test_null",
+      []() -> tensorstore::Result<std::shared_ptr<CodecAccelerator>> {
+        return std::make_shared<NullAccelerator>();
+      });
+  ::nlohmann::json json{{"accelerator", "test_null"}, {"required", true}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<CodecAcceleratorResource>::FromJson(json));
+  EXPECT_THAT(resource_spec.ToJson(), IsOkAndHolds(json));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, Context::Default().GetResource(resource_spec));
+  ASSERT_TRUE(resource->accelerator);
+  EXPECT_EQ("null", resource->accelerator->name());
+}
+
+TEST(CodecAcceleratorResourceTest, Unavailable) {
+  RegisterCodecAccelerator(
+      "test_absent",
+      []() -> tensorstore::Result<std::shared_ptr<CodecAccelerator>> {
+        return absl::NotFoundError("No device");
+      });
+
+  // Falls back to the CPU.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<CodecAcceleratorResource>::FromJson(
+                              {{"accelerator", "test_absent"}}));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource, Context::Default().GetResource(resource_spec));
+  EXPECT_FALSE(resource->accelerator);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      resource_spec, Context::Resource<CodecAcceleratorResource>::FromJson(
+                         {{"accelerator", "test_absent"}, {"required", true}}));
+  EXPECT_THAT(Context::Default().GetResource(resource_spec),
+              MatchesStatus(absl::StatusCode::kNotFound, ".*No device.*"));
+}
+
+}  // namespace
@@ -0,0 +1,281 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/compression/codec_accelerator.h"
+
+#include <stddef.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/compression/zlib_compressor.h"
+#include "tensorstore/internal/compression/zstd_compressor.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::span;
+using ::tensorstore::internal::AcceleratedFormat;
+using ::tensorstore::internal::BatchingCodecAccelerator;
+using ::tensorstore::internal::CodecAccelerator;
+using ::tensorstore::internal::CreateCodecAccelerator;
+using ::tensorstore::internal::RegisterCodecAccelerator;
+using ::tensorstore::internal::ScopedCodecAccelerator;
+using ::tensorstore::internal::SetCodecAccelerator;
+using ::tensorstore::internal::ZlibCompressor;
+using ::tensorstore::internal::ZstdCompressor;
+
+// "Decodes" and "encodes" by copying the input, and records the size of each
+// batch.
+class CopyingBatchAccelerator : public BatchingCodecAccelerator {
+ public:
+  using BatchingCodecAccelerator::BatchingCodecAccelerator;
+
+  std::string_view name() const override { return "copy"; }
+
+  bool ShouldDecode(AcceleratedFormat format,
+                    size_t decoded_size) const override {
+    return true;
+  }
+
+  bool ShouldEncode(AcceleratedFormat format,
+                    size_t input_size) const override {
+    return input_size != 0;
+  }
+
+  std::vector<size_t> batch_sizes() {
+    absl::MutexLock lock(&mutex_);
+    return batch_sizes_;
+  }
+
+ protected:
+  void ProcessBatch(span<Request* const> requests) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      batch_sizes_.push_back(requests.size());
+    }
+    for (auto* request : requests) {
+      if (request->encode) {
+        request->encoded->Append(request->input);
+        continue;
+      }
+      if (request->input.size() != request->output.size()) {
+        request->status = absl::InvalidArgumentError("size mismatch");
+        continue;
+      }
+      std::memcpy(request->output.data(), request->input.data(),
+                  request->input.size());
+    }
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<size_t> batch_sizes_;
+};
+
+// Accelerator that declines every request as unavailable.
+class UnavailableAccelerator : public CodecAccelerator {
+ public:
+  std::string_view name() const override { return "unavailable"; }
+
+  bool ShouldDecode(AcceleratedFormat format,
+                    size_t decoded_size) const override {
+    return format == AcceleratedFormat::kZstd;
+  }
+
+  absl::Status DecodeInto(AcceleratedFormat format, std::string_view input,
+                          span<char> output) override {
+    ++num_calls;
+    return absl::UnavailableError("busy");
+  }
+
+  std::atomic<int> num_calls{0};
+};
+
+TEST(BatchingCodecAcceleratorTest, CombinesConcurrentRequests) {
+  constexpr size_t kNumThreads = 8;
+  BatchingCodecAccelerator::Options options;
+  options.max_batch_size = kNumThreads;
+  // The batch is decoded as soon as all requests have arrived.
+  options.max_delay = absl::Seconds(60);
+  CopyingBatchAccelerator accelerator(options);
+  std::vector<std::string> outputs(kNumThreads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i] {
+      const std::string input(100 + i, static_cast<char>('a' + i));
+      outputs[i].resize(input.size());
+      EXPECT_TRUE(accelerator
+                      .DecodeInto(AcceleratedFormat::kZstd, input,
+                                  span<char>(outputs[i].data(),
+                                             outputs[i].size()))
+                      .ok());
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_THAT(accelerator.batch_sizes(), ::testing::ElementsAre(kNumThreads));
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(std::string(100 + i, static_cast<char>('a' + i)), outputs[i]);
+  }
+}
+
+TEST(BatchingCodecAcceleratorTest, SplitsLargeBatches) {
+  BatchingCodecAccelerator::Options options;
+  options.max_batch_size = 2;
+  options.max_delay = absl::Milliseconds(1);
+  CopyingBatchAccelerator accelerator(options);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 5; ++i) {
+    threads.emplace_back([&] {
+      std::string output(3, '\0');
+      EXPECT_TRUE(accelerator
+                      .DecodeInto(AcceleratedFormat::kZlib, "abc",
+                                  span<char>(output.data(), output.size()))
+                      .ok());
+      EXPECT_EQ("abc", output);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  size_t total = 0;
+  for (size_t size : accelerator.batch_sizes()) {
+    EXPECT_LE(size, 2);
+    total += size;
+  }
+  EXPECT_EQ(5, total);
+}
+
+TEST(BatchingCodecAcceleratorTest, PropagatesErrors) {
+  CopyingBatchAccelerator accelerator(BatchingCodecAccelerator::Options{});
+  std::string output(2, '\0');
+  EXPECT_THAT(accelerator.DecodeInto(AcceleratedFormat::kGzip, "abc",
+                                     span<char>(output.data(), output.size())),
+              tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CodecAcceleratorTest, ZstdDecodeInto) {
+  ZstdCompressor compressor;
+  const absl::Cord input(std::string(10000, 'x'));
+  absl::Cord encoded;
+  TENSORSTORE_ASSERT_OK(compressor.Encode(input, &encoded, 1));
+  std::string output(input.size(), '\0');
+  const span<char> output_span(output.data(), output.size());
+
+  // Inputs are offered to the accelerator, which here produces the encoded
+  // rather than the decoded representation.
+  auto accelerator = std::make_shared<CopyingBatchAccelerator>(
+      BatchingCodecAccelerator::Options{});
+  SetCodecAccelerator(accelerator);
+  std::string encoded_copy(encoded);
+  TENSORSTORE_EXPECT_OK(compressor.DecodeInto(
+      encoded, span<char>(encoded_copy.data(), encoded_copy.size()), 1));
+  EXPECT_EQ(std::string(encoded), encoded_copy);
+  EXPECT_THAT(accelerator->batch_sizes(), ::testing::ElementsAre(1));
+
+  // Unavailable accelerators fall back to decoding on the CPU.
+  auto unavailable = std::make_shared<UnavailableAccelerator>();
+  SetCodecAccelerator(unavailable);
+  TENSORSTORE_EXPECT_OK(compressor.DecodeInto(encoded, output_span, 1));
+  EXPECT_EQ(std::string(input), output);
+  EXPECT_EQ(1, unavailable->num_calls);
+
+  SetCodecAccelerator(nullptr);
+  output.assign(output.size(), '\0');
+  TENSORSTORE_EXPECT_OK(compressor.DecodeInto(encoded, output_span, 1));
+  EXPECT_EQ(std::string(input), output);
+  EXPECT_EQ(1, unavailable->num_calls);
+}
+
+TEST(CodecAcceleratorTest, ZlibEncode) {
+  ZlibCompressor compressor;
+  compressor.use_gzip_header = true;
+  const absl::Cord input("abc");
+  CopyingBatchAccelerator accelerator(BatchingCodecAccelerator::Options{});
+  absl::Cord encoded("prefix");
+  {
+    ScopedCodecAccelerator scope(&accelerator);
+    TENSORSTORE_EXPECT_OK(compressor.Encode(input, &encoded, 1));
+    // Empty inputs are declined, and encoded on the CPU.
+    absl::Cord empty_encoded;
+    TENSORSTORE_EXPECT_OK(
+        compressor.Encode(absl::Cord(), &empty_encoded, 1));
+    absl::Cord decoded;
+    TENSORSTORE_EXPECT_OK(compressor.Decode(empty_encoded, &decoded, 1));
+    EXPECT_EQ("", decoded);
+  }
+  EXPECT_EQ("prefixabc", encoded);
+  EXPECT_THAT(accelerator.batch_sizes(), ::testing::ElementsAre(1));
+
+  // Without the scope, the CPU is used.
+  absl::Cord cpu_encoded;
+  TENSORSTORE_EXPECT_OK(compressor.Encode(input, &cpu_encoded, 1));
+  absl::Cord decoded;
+  TENSORSTORE_EXPECT_OK(compressor.Decode(cpu_encoded, &decoded, 1));
+  EXPECT_EQ(input, decoded);
+  EXPECT_THAT(accelerator.batch_sizes(), ::testing::ElementsAre(1));
+}
+
+TEST(CodecAcceleratorTest, ScopeTakesPrecedence) {
+  ZstdCompressor compressor;
+  absl::Cord encoded;
+  TENSORSTORE_ASSERT_OK(
+      compressor.Encode(absl::Cord(std::string(100, 'x')), &encoded, 1));
+  std::string output(100, '\0');
+  const span<char> output_span(output.data(), output.size());
+  auto unavailable = std::make_shared<UnavailableAccelerator>();
+  SetCodecAccelerator(unavailable);
+  CopyingBatchAccelerator accelerator(BatchingCodecAccelerator::Options{});
+  {
+    ScopedCodecAccelerator scope(&accelerator);
+    // A null accelerator leaves the current accelerator unchanged.
+    ScopedCodecAccelerator inner_scope(nullptr);
+    std::string encoded_copy(encoded);
+    TENSORSTORE_EXPECT_OK(compressor.DecodeInto(
+        encoded, span<char>(encoded_copy.data(), encoded_copy.size()), 1));
+  }
+  EXPECT_THAT(accelerator.batch_sizes(), ::testing::ElementsAre(1));
+  EXPECT_EQ(0, unavailable->num_calls);
+  TENSORSTORE_EXPECT_OK(compressor.DecodeInto(encoded, output_span, 1));
+  EXPECT_EQ(1, unavailable->num_calls);
+  EXPECT_EQ(std::string(100, 'x'), output);
+  SetCodecAccelerator(nullptr);
+}
+
+TEST(CodecAcceleratorTest, Registry) {
+  EXPECT_THAT(CreateCodecAccelerator("test_unregistered"),
+              tensorstore::MatchesStatus(absl::StatusCode::kNotFound));
+  RegisterCodecAccelerator(
+      "test_copy",
+      []() -> tensorstore::Result<std::shared_ptr<CodecAccelerator>> {
+        return std::make_shared<CopyingBatchAccelerator>(
+            BatchingCodecAccelerator::Options{});
+      });
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto accelerator,
+                                   CreateCodecAccelerator("test_copy"));
+  EXPECT_EQ("copy", accelerator->name());
+}
+
+}  // namespace
@@ -23,7 +23,9 @@
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/write.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal {
@@ -55,5 +57,24 @@ absl::Status JsonSpecifiedCompressor::Decode(const absl::Cord& input,
   return absl::OkStatus();
 }
 
+absl::Status JsonSpecifiedCompressor::DecodeInto(const absl::Cord& input,
+                                                 span<char> output,
+                                                 size_t element_bytes) const {
+  auto base_reader = std::make_unique<riegeli::CordReader<>>(&input);
+  auto reader = GetReader(std::move(base_reader), element_bytes);
+  const bool read_all = reader->Read(output.size(), output.data());
+  if (read_all) reader->VerifyEnd();
+  if (!reader->Close()) {
+    return MaybeConvertStatusTo(reader->status(),
+                                absl::StatusCode::kInvalidArgument);
+  }
+  if (!read_all) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Decoded data is shorter than expected size of ",
+                            output.size(), " bytes"));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace internal
 }  // namespace tensorstore
@@ -24,6 +24,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_registry_fwd.h"
 #include "tensorstore/json_serialization_options.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -54,6 +55,9 @@ class JsonSpecifiedCompressor
 
   /// Encodes `input`.
   ///
+  /// The default implementation uses `GetWriter`.  Compressors may override
+  /// this to compress the entire input at once, e.g. with a reused context.
+  ///
   /// \param input The input data.
   /// \param output[out] Output buffer to which encoded output will be appended.
   ///     The value is unspecified if an error occurs.
@@ -61,11 +65,13 @@ class JsonSpecifiedCompressor
   ///     compressor, e.g. `4` if `input` is actually a sequence of `int32_t`
   ///     values.  Must be `> 0`.
   /// \returns `absl::Status()` on success, or an error if encoding fails.
-  absl::Status Encode(const absl::Cord& input, absl::Cord* output,
-                      size_t element_bytes) const;
+  virtual absl::Status Encode(const absl::Cord& input, absl::Cord* output,
+                              size_t element_bytes) const;
 
   /// Decodes `input`.
   ///
+  /// The default implementation uses `GetReader`.
+  ///
   /// \param input The input data.
   /// \param output[out] Output buffer to which decoded output will be appended.
   ///     The value is unspecified if an error occurs.
@@ -74,8 +80,26 @@ class JsonSpecifiedCompressor
   ///     values.  Must be `> 0`.
   /// \returns `absl::Status()` on success, or an error if decoding fails.
   /// \error `absl::StatusCode::kInvalidArgument` if `input` is invalid.
-  absl::Status Decode(const absl::Cord& input, absl::Cord* output,
-                      size_t element_bytes) const;
+  virtual absl::Status Decode(const absl::Cord& input, absl::Cord* output,
+                              size_t element_bytes) const;
+
+  /// Decodes `input` directly into `output`, which must be exactly the size of
+  /// the decoded data.
+  ///
+  /// The default implementation uses `GetReader`.  Compressors that can decode
+  /// the entire input at once may override this to avoid intermediate buffers.
+  ///
+  /// \param input The input data.
+  /// \param output[out] Output buffer to fill.  The contents are unspecified if
+  ///     an error occurs.
+  /// \param element_bytes Specifies the element size as a hint to the
+  ///     compressor, e.g. `4` if `input` is actually a sequence of `int32_t`
+  ///     values.  Must be `> 0`.
+  /// \returns `absl::Status()` on success, or an error if decoding fails.
+  /// \error `absl::StatusCode::kInvalidArgument` if `input` is invalid or does
+  ///     not decode to exactly `output.size()` bytes.
+  virtual absl::Status DecodeInto(const absl::Cord& input, span<char> output,
+                                  size_t element_bytes) const;
 
   using ToJsonOptions = JsonSerializationOptions;
   using FromJsonOptions = JsonSerializationOptions;
@@ -0,0 +1,282 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/lz4.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "absl/base/internal/endian.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include <lz4.h>
+#include <lz4hc.h>
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace lz4 {
+namespace {
+
+constexpr size_t kSizeHeaderLength = 4;
+
+// Constants defined by `net.jpountz.lz4.LZ4BlockOutputStream`.
+constexpr char kBlockMagic[] = {'L', 'Z', '4', 'B', 'l', 'o', 'c', 'k'};
+constexpr size_t kBlockMagicLength = sizeof(kBlockMagic);
+constexpr size_t kBlockHeaderLength = kBlockMagicLength + 1 + 4 + 4 + 4;
+constexpr uint8_t kCompressionMethodRaw = 0x10;
+constexpr uint8_t kCompressionMethodLz4 = 0x20;
+constexpr int kCompressionLevelBase = 10;
+constexpr uint32_t kBlockChecksumSeed = 0x9747b28c;
+
+// Upper bound on the ratio achievable by LZ4, used to reject corrupt size
+// headers before allocating.
+constexpr uint64_t kMaxCompressionRatio = 255;
+
+// Computes the XXH32 hash of `input`.
+//
+// The lz4 library only exposes XXH32 through the frame API, so it is
+// implemented here to compute the block stream checksums.
+uint32_t Xxh32(std::string_view input, uint32_t seed) {
+  constexpr uint32_t kPrime1 = 2654435761u;
+  constexpr uint32_t kPrime2 = 2246822519u;
+  constexpr uint32_t kPrime3 = 3266489917u;
+  constexpr uint32_t kPrime4 = 668265263u;
+  constexpr uint32_t kPrime5 = 374761393u;
+  const char* p = input.data();
+  const char* const end = p + input.size();
+  const auto round = [&](uint32_t acc, uint32_t value) {
+    return absl::rotl(acc + value * kPrime2, 13) * kPrime1;
+  };
+  uint32_t h;
+  if (input.size() >= 16) {
+    uint32_t v1 = seed + kPrime1 + kPrime2;
+    uint32_t v2 = seed + kPrime2;
+    uint32_t v3 = seed;
+    uint32_t v4 = seed - kPrime1;
+    for (; end - p >= 16; p += 16) {
+      v1 = round(v1, absl::little_endian::Load32(p));
+      v2 = round(v2, absl::little_endian::Load32(p + 4));
+      v3 = round(v3, absl::little_endian::Load32(p + 8));
+      v4 = round(v4, absl::little_endian::Load32(p + 12));
+    }
+    h = absl::rotl(v1, 1) + absl::rotl(v2, 7) + absl::rotl(v3, 12) +
+        absl::rotl(v4, 18);
+  } else {
+    h = seed + kPrime5;
+  }
+  h += static_cast<uint32_t>(input.size());
+  for (; end - p >= 4; p += 4) {
+    h = absl::rotl(h + absl::little_endian::Load32(p) * kPrime3, 17) * kPrime4;
+  }
+  for (; p != end; ++p) {
+    h = absl::rotl(h + static_cast<uint8_t>(*p) * kPrime5, 11) * kPrime1;
+  }
+  h ^= h >> 15;
+  h *= kPrime2;
+  h ^= h >> 13;
+  h *= kPrime3;
+  h ^= h >> 16;
+  return h;
+}
+
+// Checksum as computed by the `Checksum` adapter of lz4-java, which discards
+// the high 4 bits.
+uint32_t BlockChecksum(std::string_view input) {
+  return Xxh32(input, kBlockChecksumSeed) & 0xFFFFFFF;
+}
+
+absl::Status ValidateInputSize(std::string_view input) {
+  if (input.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "LZ4 compression input of ", input.size(),
+        " bytes exceeds maximum size of ", LZ4_MAX_INPUT_SIZE));
+  }
+  return absl::OkStatus();
+}
+
+// Compresses `input` as a single LZ4 block to `output`, which must have a
+// size of at least `LZ4_compressBound(input.size())`.  Returns the compressed
+// size, or `0` on failure.
+int CompressBlock(std::string_view input, char* output, int output_capacity,
+                  const Options& options) {
+  if (options.level > 0) {
+    return LZ4_compress_HC(input.data(), output, static_cast<int>(input.size()),
+                           output_capacity, options.level);
+  }
+  return LZ4_compress_fast(input.data(), output,
+                           static_cast<int>(input.size()), output_capacity,
+                           options.acceleration);
+}
+
+absl::Status DecompressBlock(std::string_view input, char* output,
+                             size_t output_size) {
+  const int n = LZ4_decompress_safe(input.data(), output,
+                                    static_cast<int>(input.size()),
+                                    static_cast<int>(output_size));
+  if (n < 0 || static_cast<size_t>(n) != output_size) {
+    return absl::InvalidArgumentError("Invalid lz4-compressed data");
+  }
+  return absl::OkStatus();
+}
+
+int BlockCompressionLevel(size_t block_size) {
+  const int bits =
+      32 - absl::countl_zero(static_cast<uint32_t>(block_size - 1));
+  return std::max(0, bits - kCompressionLevelBase);
+}
+
+void AppendBlockHeader(std::string& output, uint8_t token,
+                       uint32_t compressed_length, uint32_t decoded_length,
+                       uint32_t checksum) {
+  char header[kBlockHeaderLength];
+  std::copy(std::begin(kBlockMagic), std::end(kBlockMagic), header);
+  header[kBlockMagicLength] = static_cast<char>(token);
+  absl::little_endian::Store32(header + kBlockMagicLength + 1,
+                               compressed_length);
+  absl::little_endian::Store32(header + kBlockMagicLength + 5, decoded_length);
+  absl::little_endian::Store32(header + kBlockMagicLength + 9, checksum);
+  output.append(header, kBlockHeaderLength);
+}
+
+}  // namespace
+
+Result<std::string> Encode(std::string_view input, const Options& options) {
+  TENSORSTORE_RETURN_IF_ERROR(ValidateInputSize(input));
+  const int bound = LZ4_compressBound(static_cast<int>(input.size()));
+  std::string output(kSizeHeaderLength + bound, '\0');
+  absl::little_endian::Store32(output.data(),
+                               static_cast<uint32_t>(input.size()));
+  const int n =
+      CompressBlock(input, output.data() + kSizeHeaderLength, bound, options);
+  if (n <= 0) {
+    return absl::InternalError("Internal lz4 error");
+  }
+  output.erase(kSizeHeaderLength + n);
+  return output;
+}
+
+Result<std::string> Decode(std::string_view input) {
+  if (input.size() < kSizeHeaderLength) {
+    return absl::InvalidArgumentError("Invalid lz4-compressed data");
+  }
+  const uint64_t size = absl::little_endian::Load32(input.data());
+  input.remove_prefix(kSizeHeaderLength);
+  if (size > static_cast<uint64_t>(LZ4_MAX_INPUT_SIZE) ||
+      size > input.size() * kMaxCompressionRatio + 16) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Invalid lz4 uncompressed size: ", size));
+  }
+  std::string output(size, '\0');
+  if (size > 0) {
+    TENSORSTORE_RETURN_IF_ERROR(DecompressBlock(input, output.data(), size));
+  }
+  return output;
+}
+
+Result<std::string> EncodeBlockStream(std::string_view input,
+                                      const Options& options,
+                                      size_t block_size) {
+  if (block_size < kMinBlockSize || block_size > kMaxBlockSize) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "LZ4 block size of ", block_size, " is outside valid range [",
+        kMinBlockSize, ", ", kMaxBlockSize, "]"));
+  }
+  const int level = BlockCompressionLevel(block_size);
+  const int bound = LZ4_compressBound(static_cast<int>(block_size));
+  std::string output;
+  std::string compressed(bound, '\0');
+  output.reserve(kBlockHeaderLength * 2 +
+                 std::min(input.size(), static_cast<size_t>(bound)));
+  while (!input.empty()) {
+    const std::string_view block = input.substr(0, block_size);
+    input.remove_prefix(block.size());
+    const uint32_t checksum = BlockChecksum(block);
+    const int n = CompressBlock(block, compressed.data(), bound, options);
+    if (n <= 0) {
+      return absl::InternalError("Internal lz4 error");
+    }
+    if (static_cast<size_t>(n) >= block.size()) {
+      AppendBlockHeader(output, kCompressionMethodRaw | level, block.size(),
+                        block.size(), checksum);
+      output.append(block);
+    } else {
+      AppendBlockHeader(output, kCompressionMethodLz4 | level, n,
+                        block.size(), checksum);
+      output.append(compressed.data(), n);
+    }
+  }
+  AppendBlockHeader(output, kCompressionMethodRaw | level, 0, 0, 0);
+  return output;
+}
+
+Result<std::string> DecodeBlockStream(std::string_view input) {
+  std::string output;
+  // Concatenated streams are permitted, matching `LZ4BlockInputStream`.
+  while (!input.empty()) {
+    if (input.size() < kBlockHeaderLength ||
+        input.substr(0, kBlockMagicLength) !=
+            std::string_view(kBlockMagic, kBlockMagicLength)) {
+      return absl::InvalidArgumentError("Invalid lz4 block header");
+    }
+    const uint8_t token = static_cast<uint8_t>(input[kBlockMagicLength]);
+    const uint8_t method = token & 0xF0;
+    const int level = token & 0x0F;
+    const uint32_t compressed_length =
+        absl::little_endian::Load32(input.data() + kBlockMagicLength + 1);
+    const uint32_t decoded_length =
+        absl::little_endian::Load32(input.data() + kBlockMagicLength + 5);
+    const uint32_t checksum =
+        absl::little_endian::Load32(input.data() + kBlockMagicLength + 9);
+    input.remove_prefix(kBlockHeaderLength);
+    const uint64_t max_length = uint64_t(1) << (level + kCompressionLevelBase);
+    if ((method != kCompressionMethodRaw &&
+         method != kCompressionMethodLz4) ||
+        decoded_length > max_length || compressed_length > input.size() ||
+        (method == kCompressionMethodRaw &&
+         compressed_length != decoded_length) ||
+        (decoded_length == 0) != (compressed_length == 0)) {
+      return absl::InvalidArgumentError("Invalid lz4 block header");
+    }
+    if (decoded_length == 0) {
+      if (checksum != 0) {
+        return absl::InvalidArgumentError("Invalid lz4 block header");
+      }
+      continue;
+    }
+    const std::string_view block = input.substr(0, compressed_length);
+    input.remove_prefix(compressed_length);
+    const size_t offset = output.size();
+    if (method == kCompressionMethodRaw) {
+      output.append(block);
+    } else {
+      output.resize(offset + decoded_length);
+      TENSORSTORE_RETURN_IF_ERROR(
+          DecompressBlock(block, output.data() + offset, decoded_length));
+    }
+    if (BlockChecksum(std::string_view(output).substr(offset)) != checksum) {
+      return absl::InvalidArgumentError("lz4 block checksum mismatch");
+    }
+  }
+  return output;
+}
+
+}  // namespace lz4
+}  // namespace tensorstore
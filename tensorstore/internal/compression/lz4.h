@@ -0,0 +1,95 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "tensorstore/util/result.h"
+
+/// Convenience interface to the lz4 block API.
+///
+/// Two framings are supported:
+///
+/// - The numcodecs framing, used by zarr and zarr v3, consisting of the
+///   uncompressed size as a 4-byte little endian integer followed by a single
+///   LZ4 block.
+///
+/// - The block stream framing of `net.jpountz.lz4.LZ4BlockOutputStream`, used
+///   by the N5 "lz4" compression, consisting of a sequence of independently
+///   compressed blocks, each with a 21-byte header and an XXH32 checksum,
+///   terminated by an empty block.
+
+namespace tensorstore {
+namespace lz4 {
+
+/// Specifies the LZ4 encode options.
+struct Options {
+  /// Acceleration factor for the fast compressor, must be `>= 1`.  Larger
+  /// values are faster but provide a lower compression ratio.  Ignored if
+  /// `level > 0`.
+  int acceleration = 1;
+
+  /// Compression level for the high-compression (LZ4HC) compressor, in the
+  /// range `[0, 12]`.  A value of `0` selects the fast compressor.
+  ///
+  /// Both compressors produce the same format; the level affects only the
+  /// encode speed and compression ratio.
+  int level = 0;
+};
+
+/// Minimum and maximum `Options::level`.
+constexpr int kMinLevel = 0;
+constexpr int kMaxLevel = 12;
+
+/// Minimum and maximum block size supported by `EncodeBlockStream`.
+constexpr size_t kMinBlockSize = 64;
+constexpr size_t kMaxBlockSize = size_t(1) << 25;
+
+/// Default block size used by the N5 "lz4" compression.
+constexpr size_t kDefaultBlockSize = 65536;
+
+/// Compresses `input` using the numcodecs framing.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `input.size()` exceeds
+///     `LZ4_MAX_INPUT_SIZE`.
+Result<std::string> Encode(std::string_view input, const Options& options);
+
+/// Decompresses `input` using the numcodecs framing.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt.
+Result<std::string> Decode(std::string_view input);
+
+/// Compresses `input` using the block stream framing.
+///
+/// \param block_size Maximum uncompressed size of each block, must be in the
+///     range `[kMinBlockSize, kMaxBlockSize]`.
+Result<std::string> EncodeBlockStream(std::string_view input,
+                                      const Options& options,
+                                      size_t block_size);
+
+/// Decompresses `input` using the block stream framing.
+///
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt or a
+///     block checksum does not match.
+Result<std::string> DecodeBlockStream(std::string_view input);
+
+}  // namespace lz4
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_LZ4_H_
@@ -0,0 +1,126 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/lz4_compressor.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "riegeli/base/chain.h"
+#include "riegeli/bytes/chain_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "riegeli/bytes/read_all.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/write.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/internal/compression/lz4.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+using EncodeFunction =
+    absl::AnyInvocable<Result<std::string>(std::string_view) const>;
+using DecodeFunction = Result<std::string> (*)(std::string_view);
+
+// Buffers writes to a `Cord`, and then in `Done`, calls `encode` and forwards
+// the result to another `Writer`.
+class Lz4DeferredWriter : public riegeli::CordWriter<absl::Cord> {
+ public:
+  explicit Lz4DeferredWriter(EncodeFunction encode,
+                             std::unique_ptr<riegeli::Writer> base_writer)
+      : CordWriter(riegeli::CordWriterBase::Options().set_max_block_size(
+            std::numeric_limits<size_t>::max())),
+        encode_(std::move(encode)),
+        base_writer_(std::move(base_writer)) {}
+
+  void Done() override {
+    CordWriter::Done();
+    auto output = encode_(dest().Flatten());
+    if (!output.ok()) {
+      Fail(std::move(output).status());
+      return;
+    }
+    auto status = riegeli::Write(*std::move(output), std::move(base_writer_));
+    if (!status.ok()) {
+      Fail(std::move(status));
+      return;
+    }
+  }
+
+ private:
+  EncodeFunction encode_;
+  std::unique_ptr<riegeli::Writer> base_writer_;
+};
+
+std::unique_ptr<riegeli::Reader> GetDecodedReader(
+    std::unique_ptr<riegeli::Reader> base_reader, DecodeFunction decode) {
+  auto output = riegeli::ReadAll(
+      std::move(base_reader),
+      [decode](absl::string_view input) -> absl::StatusOr<std::string> {
+        auto output = decode(input);
+        if (!output.ok()) return std::move(output).status();
+        return *std::move(output);
+      });
+  auto reader = std::make_unique<riegeli::ChainReader<riegeli::Chain>>(
+      output.ok() ? riegeli::Chain(std::move(*output)) : riegeli::Chain());
+  if (!output.ok()) {
+    reader->Fail(std::move(output).status());
+  }
+  return reader;
+}
+
+}  // namespace
+
+std::unique_ptr<riegeli::Writer> Lz4Compressor::GetWriter(
+    std::unique_ptr<riegeli::Writer> base_writer, size_t element_bytes) const {
+  return std::make_unique<Lz4DeferredWriter>(
+      [options = static_cast<const lz4::Options&>(*this)](
+          std::string_view input) { return lz4::Encode(input, options); },
+      std::move(base_writer));
+}
+
+std::unique_ptr<riegeli::Reader> Lz4Compressor::GetReader(
+    std::unique_ptr<riegeli::Reader> base_reader, size_t element_bytes) const {
+  return GetDecodedReader(std::move(base_reader), &lz4::Decode);
+}
+
+std::unique_ptr<riegeli::Writer> Lz4BlockStreamCompressor::GetWriter(
+    std::unique_ptr<riegeli::Writer> base_writer, size_t element_bytes) const {
+  return std::make_unique<Lz4DeferredWriter>(
+      [options = static_cast<const lz4::Options&>(*this),
+       block_size = block_size](std::string_view input) {
+        return lz4::EncodeBlockStream(input, options, block_size);
+      },
+      std::move(base_writer));
+}
+
+std::unique_ptr<riegeli::Reader> Lz4BlockStreamCompressor::GetReader(
+    std::unique_ptr<riegeli::Reader> base_reader, size_t element_bytes) const {
+  return GetDecodedReader(std::move(base_reader), &lz4::DecodeBlockStream);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,155 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/lz4.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+
+namespace lz4 = tensorstore::lz4;
+
+std::vector<lz4::Options> GetTestOptions() {
+  return {
+      lz4::Options{1, 0},
+      lz4::Options{10, 0},
+      lz4::Options{1, 1},
+      lz4::Options{1, 9},
+      lz4::Options{1, 12},
+  };
+}
+
+std::vector<std::string> GetTestArrays() {
+  std::vector<std::string> arrays;
+
+  // Add empty array.
+  arrays.emplace_back();
+
+  {
+    std::string arr(100, '\0');
+    unsigned char v = 0;
+    for (auto& x : arr) {
+      x = (v += 7);
+    }
+    arrays.push_back(std::move(arr));
+  }
+
+  {
+    std::string arr(100000, '\0');
+    for (size_t i = 0; i < arr.size(); ++i) {
+      arr[i] = static_cast<char>((i / 100) % 7);
+    }
+    arrays.push_back(std::move(arr));
+  }
+
+  arrays.push_back("The quick brown fox jumped over the lazy dog.");
+  return arrays;
+}
+
+TEST(Lz4Test, EncodeDecode) {
+  for (const auto& options : GetTestOptions()) {
+    for (const auto& array : GetTestArrays()) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                       lz4::Encode(array, options));
+      ASSERT_GE(encoded.size(), 4);
+      EXPECT_EQ(array.size(), static_cast<unsigned char>(encoded[0]) |
+                                  static_cast<unsigned char>(encoded[1]) << 8 |
+                                  static_cast<unsigned char>(encoded[2]) << 16 |
+                                  static_cast<unsigned char>(encoded[3]) << 24);
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, lz4::Decode(encoded));
+      EXPECT_EQ(array, decoded);
+    }
+  }
+}
+
+TEST(Lz4Test, DecodeCorrupt) {
+  EXPECT_THAT(lz4::Decode("abc"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(lz4::Decode(std::string_view("\xff\xff\xff\x7f\x00", 5)),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Invalid lz4 uncompressed size.*"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, lz4::Encode(GetTestArrays()[2], lz4::Options{}));
+  encoded.resize(encoded.size() / 2);
+  EXPECT_THAT(lz4::Decode(encoded),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(Lz4Test, EncodeDecodeBlockStream) {
+  for (const auto& options : GetTestOptions()) {
+    for (const auto& array : GetTestArrays()) {
+      for (const size_t block_size : {size_t(64), size_t(1000),
+                                      lz4::kDefaultBlockSize}) {
+        TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+            auto encoded, lz4::EncodeBlockStream(array, options, block_size));
+        TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded,
+                                         lz4::DecodeBlockStream(encoded));
+        EXPECT_EQ(array, decoded);
+      }
+    }
+  }
+}
+
+// Tests that the block stream framing matches `LZ4BlockOutputStream`.
+TEST(Lz4Test, BlockStreamGolden) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, lz4::EncodeBlockStream("abc", lz4::Options{}, 64));
+  // Incompressible blocks are stored raw.
+  EXPECT_EQ(std::string_view("LZ4Block\x10"
+                             "\x03\x00\x00\x00"
+                             "\x03\x00\x00\x00"
+                             "\x22\xb2\x4c\x0d"
+                             "abc"
+                             "LZ4Block\x10"
+                             "\x00\x00\x00\x00"
+                             "\x00\x00\x00\x00"
+                             "\x00\x00\x00\x00",
+                             24 + 21),
+            encoded);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded,
+                                   lz4::DecodeBlockStream(encoded));
+  EXPECT_EQ("abc", decoded);
+}
+
+TEST(Lz4Test, BlockStreamInvalidBlockSize) {
+  EXPECT_THAT(lz4::EncodeBlockStream("abc", lz4::Options{}, 32),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "LZ4 block size of 32 is outside valid range.*"));
+}
+
+TEST(Lz4Test, DecodeBlockStreamCorrupt) {
+  EXPECT_THAT(lz4::DecodeBlockStream("LZ4Blocx"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Invalid lz4 block header"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, lz4::EncodeBlockStream("abc", lz4::Options{}, 64));
+  encoded[21] = 'x';
+  EXPECT_THAT(lz4::DecodeBlockStream(encoded),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "lz4 block checksum mismatch"));
+}
+
+}  // namespace
@@ -21,6 +21,7 @@
 #include <cassert>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/base/internal/endian.h"
@@ -40,6 +41,75 @@ void WriteBlockHeader(size_t encoded_value_base_offset,
                                encoded_value_base_offset);
 }
 
+// Maximum number of distinct labels within a block for which the label table
+// is built using a linear search rather than a hash table.  Most blocks of
+// typical segmentations contain only a handful of distinct labels.
+constexpr size_t kMaxLinearSearchLabels = 16;
+
+// Packs `num_words * (32 / Bits)` indices, each of which must be less than
+// `2**Bits`, into `num_words` little-endian 32-bit words.
+//
+// The fixed `Bits` allows the compiler to fully unroll and vectorize the inner
+// loop.
+template <size_t Bits>
+void PackIndices(const uint32_t* indices, size_t num_words, char* output) {
+  constexpr size_t kIndicesPerWord = 32 / Bits;
+  for (size_t word_i = 0; word_i < num_words; ++word_i) {
+    uint32_t word = 0;
+    for (size_t j = 0; j < kIndicesPerWord; ++j) {
+      word |= indices[word_i * kIndicesPerWord + j] << (j * Bits);
+    }
+    absl::little_endian::Store32(output + word_i * 4, word);
+  }
+}
+
+void PackIndices(size_t encoded_bits, const uint32_t* indices,
+                 size_t num_words, char* output) {
+  switch (encoded_bits) {
+    case 1:
+      return PackIndices<1>(indices, num_words, output);
+    case 2:
+      return PackIndices<2>(indices, num_words, output);
+    case 4:
+      return PackIndices<4>(indices, num_words, output);
+    case 8:
+      return PackIndices<8>(indices, num_words, output);
+    case 16:
+      return PackIndices<16>(indices, num_words, output);
+    case 32:
+      return PackIndices<32>(indices, num_words, output);
+  }
+}
+
+// Per-thread scratch memory used by `EncodeBlock`, to avoid allocating for
+// every block.
+template <typename Label>
+struct EncodeBlockScratch {
+  // Maps each distinct label to its index in `values`.  Only used once the
+  // number of distinct labels exceeds `kMaxLinearSearchLabels`.
+  absl::flat_hash_map<Label, uint32_t> value_indices;
+
+  // Distinct labels, in order of first occurrence.
+  std::vector<Label> values;
+
+  // Permutation that sorts `values`.
+  std::vector<uint32_t> order;
+
+  // Maps `1 + i` to the sorted index of `values[i]`, and `0` to `0`.
+  std::vector<uint32_t> sorted_index;
+
+  // Per-element index for each position in the block, in C order, padded to a
+  // whole number of 32-bit words.  Stores `1 + i` for `values[i]`, and `0` for
+  // positions outside the input.
+  std::vector<uint32_t> indices;
+};
+
+template <typename Label>
+EncodeBlockScratch<Label>& GetEncodeBlockScratch() {
+  thread_local EncodeBlockScratch<Label> scratch;
+  return scratch;
+}
+
 template <typename Label>
 void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
                  const ptrdiff_t input_byte_strides[3],
@@ -53,63 +123,107 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
   }
 
   constexpr size_t num_32bit_words_per_label = sizeof(Label) / 4;
+  const size_t num_block_elements =
+      block_shape[0] * block_shape[1] * block_shape[2];
+
+  auto& scratch = GetEncodeBlockScratch<Label>();
+  auto& value_indices = scratch.value_indices;
+  auto& values = scratch.values;
+  auto& indices = scratch.indices;
+  value_indices.clear();
+  values.clear();
+  // Allow enough room for padding to a whole number of words with 1-bit
+  // indices; the padding must be zero.
+  indices.assign(num_block_elements + 31, 0);
+
+  // Returns `1 + i`, where `i` is the index of `value` in `values`, adding it
+  // if not already present.
+  const auto get_unsorted_index = [&](Label value) -> uint32_t {
+    if (value_indices.empty()) {
+      auto it = std::find(values.begin(), values.end(), value);
+      if (it != values.end()) {
+        return static_cast<uint32_t>(it - values.begin()) + 1;
+      }
+      values.push_back(value);
+      if (values.size() > kMaxLinearSearchLabels) {
+        for (size_t i = 0; i < values.size(); ++i) {
+          value_indices.emplace(values[i], static_cast<uint32_t>(i));
+        }
+      }
+      return static_cast<uint32_t>(values.size());
+    }
+    auto [it, inserted] =
+        value_indices.emplace(value, static_cast<uint32_t>(values.size()));
+    if (inserted) values.push_back(value);
+    return it->second + 1;
+  };
 
-  // TODO(jbms): allow the memory allocated for these to be shared across
-  // multiple calls to EncodeBlock.
-  absl::flat_hash_map<Label, uint32_t> seen_values;
-  std::vector<Label> seen_values_inv;
-
-  // Calls `func(z, y, x, label)` for each `label` value within the block, in C
-  // order.
-  const auto ForEachElement = [&](auto func) {
+  // Determine the distinct values, and record the (unsorted) index of each
+  // element.
+  {
+    // Initialize previous_value such that it is guaranteed not to equal to
+    // the first value.
+    Label previous_value = input[0] + 1;
+    uint32_t previous_index = 0;
     auto* input_z = reinterpret_cast<const char*>(input);
     for (ptrdiff_t z = 0; z < input_shape[0]; ++z) {
       auto* input_y = input_z;
       for (ptrdiff_t y = 0; y < input_shape[1]; ++y) {
         auto* input_x = input_y;
+        uint32_t* indices_x =
+            indices.data() + block_shape[2] * (y + block_shape[1] * z);
         for (ptrdiff_t x = 0; x < input_shape[2]; ++x) {
-          func(z, y, x, *reinterpret_cast<const Label*>(input_x));
+          const Label value = *reinterpret_cast<const Label*>(input_x);
+          // If this value matches the previous value, we can skip the more
+          // expensive lookup.
+          if (value != previous_value) {
+            previous_value = value;
+            previous_index = get_unsorted_index(value);
+          }
+          indices_x[x] = previous_index;
           input_x += input_byte_strides[2];
         }
         input_y += input_byte_strides[1];
       }
       input_z += input_byte_strides[0];
     }
-  };
+  }
 
-  // First determine the distinct values.
-
-  // Initialize previous_value such that it is guaranteed not to equal to the
-  // first value.
-  Label previous_value = input[0] + 1;
-  ForEachElement([&](size_t z, size_t y, size_t x, Label value) {
-    // If this value matches the previous value, we can skip the more
-    // expensive hash table lookup.
-    if (value != previous_value) {
-      previous_value = value;
-      if (seen_values.emplace(value, 0).second) {
-        seen_values_inv.push_back(value);
-      }
+  const size_t num_values = values.size();
+  std::vector<Label> seen_values_inv(num_values);
+  {
+    auto& order = scratch.order;
+    auto& sorted_index = scratch.sorted_index;
+    order.resize(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+      order[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return values[a] < values[b]; });
+    sorted_index.resize(num_values + 1);
+    sorted_index[0] = 0;
+    for (size_t i = 0; i < num_values; ++i) {
+      seen_values_inv[i] = values[order[i]];
+      sorted_index[order[i] + 1] = static_cast<uint32_t>(i);
+    }
+    // Positions outside the input keep index 0, which corresponds to the
+    // lowest label.
+    for (size_t i = 0; i < num_block_elements; ++i) {
+      indices[i] = sorted_index[indices[i]];
     }
-  });
-
-  std::sort(seen_values_inv.begin(), seen_values_inv.end());
-  for (size_t i = 0; i < seen_values_inv.size(); ++i) {
-    seen_values[seen_values_inv[i]] = static_cast<uint32_t>(i);
   }
 
   // Determine number of bits with which to encode each index.
   size_t encoded_bits = 0;
-  if (seen_values.size() != 1) {
+  if (num_values != 1) {
     encoded_bits = 1;
-    while ((size_t(1) << encoded_bits) < seen_values.size()) {
+    while ((size_t(1) << encoded_bits) < num_values) {
       encoded_bits *= 2;
     }
   }
   *encoded_bits_output = encoded_bits;
   const size_t encoded_size_32bits =
-      (encoded_bits * block_shape[0] * block_shape[1] * block_shape[2] + 31) /
-      32;
+      (encoded_bits * num_block_elements + 31) / 32;
 
   const size_t encoded_value_base_offset = output->size();
   assert((encoded_value_base_offset - base_offset) % 4 == 0);
@@ -120,7 +234,7 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
     auto it = cache->find(seen_values_inv);
     if (it == cache->end()) {
       write_table = true;
-      elements_to_write += seen_values.size() * num_32bit_words_per_label;
+      elements_to_write += num_values * num_32bit_words_per_label;
       *table_offset_output =
           (encoded_value_base_offset - base_offset) / 4 + encoded_size_32bits;
     } else {
@@ -132,14 +246,7 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
   output->resize(encoded_value_base_offset + elements_to_write * 4);
   char* output_ptr = output->data() + encoded_value_base_offset;
   // Write encoded representation.
-  ForEachElement([&](size_t z, size_t y, size_t x, Label value) {
-    uint32_t index = seen_values.at(value);
-    size_t output_offset = x + block_shape[2] * (y + block_shape[1] * z);
-    void* cur_ptr = output_ptr + output_offset * encoded_bits / 32 * 4;
-    absl::little_endian::Store32(
-        cur_ptr, absl::little_endian::Load32(cur_ptr) |
-                     (index << (output_offset * encoded_bits % 32)));
-  });
+  PackIndices(encoded_bits, indices.data(), encoded_size_32bits, output_ptr);
 
   // Write table
   if (write_table) {
@@ -153,7 +260,7 @@ void EncodeBlock(const Label* input, const ptrdiff_t input_shape[3],
       }
       output_ptr += num_32bit_words_per_label * 4;
     }
-    cache->emplace(seen_values_inv,
+    cache->emplace(std::move(seen_values_inv),
                    static_cast<uint32_t>(*table_offset_output));
   }
 }
@@ -223,17 +330,51 @@ void ReadBlockHeader(const void* header, size_t* encoded_value_base_offset,
   *encoded_value_base_offset = (h >> 32) & 0xffffff;
 }
 
+// Unpacks `num_words * (32 / Bits)` indices from `num_words` little-endian
+// 32-bit words.
+template <size_t Bits>
+void UnpackIndices(const char* input, size_t num_words, uint32_t* indices) {
+  constexpr size_t kIndicesPerWord = 32 / Bits;
+  constexpr uint32_t kMask = static_cast<uint32_t>((uint64_t(1) << Bits) - 1);
+  for (size_t word_i = 0; word_i < num_words; ++word_i) {
+    const uint32_t word = absl::little_endian::Load32(input + word_i * 4);
+    for (size_t j = 0; j < kIndicesPerWord; ++j) {
+      indices[word_i * kIndicesPerWord + j] = (word >> (j * Bits)) & kMask;
+    }
+  }
+}
+
+void UnpackIndices(size_t encoded_bits, const char* input, size_t num_words,
+                   uint32_t* indices) {
+  switch (encoded_bits) {
+    case 1:
+      return UnpackIndices<1>(input, num_words, indices);
+    case 2:
+      return UnpackIndices<2>(input, num_words, indices);
+    case 4:
+      return UnpackIndices<4>(input, num_words, indices);
+    case 8:
+      return UnpackIndices<8>(input, num_words, indices);
+    case 16:
+      return UnpackIndices<16>(input, num_words, indices);
+    case 32:
+      return UnpackIndices<32>(input, num_words, indices);
+  }
+}
+
+// Returns per-thread scratch memory used by `DecodeBlock` to hold the unpacked
+// indices of a block.
+std::vector<uint32_t>& GetDecodeBlockScratch() {
+  thread_local std::vector<uint32_t> indices;
+  return indices;
+}
+
 template <typename Label>
 bool DecodeBlock(size_t encoded_bits, const char* encoded_input,
                  const char* table_input, size_t table_size,
                  const ptrdiff_t block_shape[3],
                  const ptrdiff_t output_shape[3],
                  const ptrdiff_t output_byte_strides[3], Label* output) {
-  // TODO(jbms): Consider specializing this function for the value of
-  // `encoded_bits` and whether `table_size` is `< 2**encoded_bits`.  If
-  // `table_size >= 2**encoded_bits`, there is no need to check below that
-  // `index <= table_size`.
-
   // Invokes `callback(label, z, y, x)` for each block position in C order.  If
   // `callback` returns `false`, stops iterating and returns `false`.  Otherwise
   // returns `true` when done.
@@ -275,19 +416,66 @@ bool DecodeBlock(size_t encoded_bits, const char* encoded_input,
         });
   }
 
-  const uint32_t encoded_value_mask = (1U << encoded_bits) - 1;
-  return for_each_position([&](Label& output_label, ptrdiff_t z, ptrdiff_t y,
-                               ptrdiff_t x) {
-    size_t encoded_offset = x + block_shape[2] * (y + block_shape[1] * z);
-    auto index = absl::little_endian::Load32(
-                     encoded_input + encoded_offset * encoded_bits / 32 * 4) >>
-                     (encoded_offset * encoded_bits % 32) &
-                 encoded_value_mask;
-    if (index >= table_size) return false;
-    output_label = read_label(index);
+  // Unpack all of the indices for the block at once.
+  const size_t num_block_elements =
+      block_shape[0] * block_shape[1] * block_shape[2];
+  const size_t encoded_size_32bits =
+      (encoded_bits * num_block_elements + 31) / 32;
+  auto& indices = GetDecodeBlockScratch();
+  indices.resize(encoded_size_32bits * (32 / encoded_bits));
+  UnpackIndices(encoded_bits, encoded_input, encoded_size_32bits,
+                indices.data());
+
+  // Calls `callback(indices_x, output_x)` for each row of the block, where
+  // `indices_x` points to the indices for the row and `output_x` points to the
+  // first output element of the row.
+  const auto for_each_row = [&](auto callback) {
+    auto* output_z = reinterpret_cast<char*>(output);
+    for (ptrdiff_t z = 0; z < output_shape[0]; ++z) {
+      auto* output_y = output_z;
+      for (ptrdiff_t y = 0; y < output_shape[1]; ++y) {
+        const uint32_t* indices_x =
+            indices.data() + block_shape[2] * (y + block_shape[1] * z);
+        if (!callback(indices_x, output_y)) return false;
+        output_y += output_byte_strides[1];
+      }
+      output_z += output_byte_strides[0];
+    }
+    return true;
+  };
+
+  // If `table_size >= 2**encoded_bits`, every index is valid.  Otherwise,
+  // validate all indices before writing any output.
+  if (encoded_bits < 32 && table_size < (size_t(1) << encoded_bits)) {
+    const uint32_t max_index = static_cast<uint32_t>(table_size - 1);
+    if (table_size == 0 ||
+        !for_each_row([&](const uint32_t* indices_x, char* output_x) {
+          uint32_t row_max = 0;
+          for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
+            row_max = std::max(row_max, indices_x[x]);
+          }
+          return row_max <= max_index;
+        })) {
+      return false;
+    }
+  }
+
+  const ptrdiff_t x_stride = output_byte_strides[2];
+  return for_each_row([&](const uint32_t* indices_x, char* output_x) {
+    if (x_stride == sizeof(Label)) {
+      // Common case of contiguous output.
+      Label* output_row = reinterpret_cast<Label*>(output_x);
+      for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
+        output_row[x] = read_label(indices_x[x]);
+      }
+    } else {
+      for (ptrdiff_t x = 0; x < output_shape[2]; ++x) {
+        *reinterpret_cast<Label*>(output_x) = read_label(indices_x[x]);
+        output_x += x_stride;
+      }
+    }
     return true;
   });
-  return true;
 }
 
 template <typename Label>
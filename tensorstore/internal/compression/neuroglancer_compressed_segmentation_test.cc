@@ -20,6 +20,7 @@
 #include <string_view>
 #include <vector>
 
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/random/random.h"
@@ -450,4 +451,62 @@ TEST(RoundTripTest, Random) {
                                /*num_iterations=*/100);
 }
 
+// Returns a 64^3 volume of labels in which each 8^3 block contains
+// approximately `num_labels_per_block` distinct labels.
+template <typename T>
+std::vector<T> MakeBenchmarkVolume(size_t num_labels_per_block) {
+  absl::BitGen gen;
+  std::vector<T> input(64 * 64 * 64);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<T>(1000 + absl::Uniform<size_t>(
+                                         gen, 0, num_labels_per_block) +
+                              (i / 512) * num_labels_per_block);
+  }
+  return input;
+}
+
+constexpr std::ptrdiff_t kBenchmarkInputShape[4] = {1, 64, 64, 64};
+constexpr std::ptrdiff_t kBenchmarkBlockShape[3] = {8, 8, 8};
+
+template <typename T>
+void BM_EncodeChannels(benchmark::State& state) {
+  const auto input = MakeBenchmarkVolume<T>(state.range(0));
+  constexpr std::ptrdiff_t s = sizeof(T);
+  const std::ptrdiff_t input_byte_strides[4] = {64 * 64 * 64 * s, 64 * 64 * s,
+                                                64 * s, s};
+  for (auto _ : state) {
+    std::string output;
+    EncodeChannels(input.data(), kBenchmarkInputShape, input_byte_strides,
+                   kBenchmarkBlockShape, &output);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size() * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_EncodeChannels, uint32_t)->Range(1, 256);
+BENCHMARK_TEMPLATE(BM_EncodeChannels, uint64_t)->Range(1, 256);
+
+template <typename T>
+void BM_DecodeChannels(benchmark::State& state) {
+  const auto input = MakeBenchmarkVolume<T>(state.range(0));
+  constexpr std::ptrdiff_t s = sizeof(T);
+  const std::ptrdiff_t input_byte_strides[4] = {64 * 64 * 64 * s, 64 * 64 * s,
+                                                64 * s, s};
+  std::string encoded;
+  EncodeChannels(input.data(), kBenchmarkInputShape, input_byte_strides,
+                 kBenchmarkBlockShape, &encoded);
+  std::vector<T> output(input.size());
+  for (auto _ : state) {
+    bool result =
+        DecodeChannels(encoded, kBenchmarkBlockShape, kBenchmarkInputShape,
+                       input_byte_strides, output.data());
+    benchmark::DoNotOptimize(result);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetBytesProcessed(state.iterations() * input.size() * sizeof(T));
+}
+
+BENCHMARK_TEMPLATE(BM_DecodeChannels, uint32_t)->Range(1, 256);
+BENCHMARK_TEMPLATE(BM_DecodeChannels, uint64_t)->Range(1, 256);
+
 }  // namespace
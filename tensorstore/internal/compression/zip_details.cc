@@ -30,16 +30,21 @@
 #include "absl/log/absl_log.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/limiting_reader.h"
 #include "riegeli/bytes/prefix_limiting_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
 #include "riegeli/bzip2/bzip2_reader.h"
 #include "riegeli/endian/endian_reading.h"
+#include "riegeli/endian/endian_writing.h"
 #include "riegeli/xz/xz_reader.h"
 #include "riegeli/zlib/zlib_reader.h"
+#include "riegeli/zlib/zlib_writer.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/riegeli/find.h"
@@ -47,6 +52,9 @@
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
+// Include system headers last to reduce impact of macros.
+#include <zlib.h>
+
 namespace tensorstore {
 namespace internal_zip {
 namespace {
@@ -55,6 +63,17 @@ using ::riegeli::ReadLittleEndian16;
 using ::riegeli::ReadLittleEndian32;
 using ::riegeli::ReadLittleEndian64;
 using ::riegeli::ReadLittleEndianSigned64;
+using ::riegeli::WriteLittleEndian16;
+using ::riegeli::WriteLittleEndian32;
+using ::riegeli::WriteLittleEndian64;
+
+constexpr uint16_t kMax16 = std::numeric_limits<uint16_t>::max();
+constexpr uint32_t kMax32 = std::numeric_limits<uint32_t>::max();
+
+// 4.4.3 Version needed to extract (minimum feature version required).
+constexpr uint16_t kVersionStore = 10;
+constexpr uint16_t kVersionDeflate = 20;
+constexpr uint16_t kVersionZip64 = 45;
 
 ABSL_CONST_INIT internal_log::VerboseFlag zip_logging("zip_details");
 
@@ -78,6 +97,35 @@ absl::Time MakeMSDOSTime(uint16_t date, uint16_t time) {
   return absl::FromTM(dos_tm, absl::UTCTimeZone());
 }
 
+// Inverse of MakeMSDOSTime; times outside of the MS-DOS range are clamped.
+void MakeMSDOSDateTime(absl::Time t, uint16_t &date, uint16_t &time) {
+  auto cs = absl::ToCivilSecond(t, absl::UTCTimeZone());
+  if (t == absl::InfinitePast() || cs.year() < 1980) {
+    cs = absl::CivilSecond(1980, 1, 1, 0, 0, 0);
+  } else if (t == absl::InfiniteFuture() || cs.year() > 2107) {
+    cs = absl::CivilSecond(2107, 12, 31, 23, 59, 58);
+  }
+  date = static_cast<uint16_t>(((cs.year() - 1980) << 9) | (cs.month() << 5) |
+                               cs.day());
+  time = static_cast<uint16_t>((cs.hour() << 11) | (cs.minute() << 5) |
+                               (cs.second() / 2));
+}
+
+uint16_t GetVersionNeeded(const ZipEntry &entry, bool zip64) {
+  if (zip64) return kVersionZip64;
+  return entry.compression_method == ZipCompression::kStore ? kVersionStore
+                                                            : kVersionDeflate;
+}
+
+uint32_t ComputeCrc32(const absl::Cord &value) {
+  uLong crc = crc32_z(0L, Z_NULL, 0);
+  for (std::string_view chunk : value.Chunks()) {
+    crc = crc32_z(crc, reinterpret_cast<const Bytef *>(chunk.data()),
+                  chunk.size());
+  }
+  return static_cast<uint32_t>(crc);
+}
+
 // These could have different implementations for central headers vs.
 // local headers.
 absl::Status ReadExtraField_Zip64_0001(riegeli::Reader &reader,
@@ -300,8 +348,6 @@ absl::Status ReadEOCD64(riegeli::Reader &reader, ZipEOCD &eocd) {
 
   if (disk_number != disk_number_with_cd ||
       eocd.num_entries != total_num_entries ||
-      eocd.num_entries == std::numeric_limits<uint16_t>::max() ||
-      eocd.cd_size == std::numeric_limits<uint16_t>::max() ||
       eocd.cd_offset == std::numeric_limits<uint32_t>::max() ||
       eocd.cd_size < 0 || eocd.cd_offset < 0) {
     return absl::InvalidArgumentError(
@@ -380,6 +426,47 @@ absl::Status ReadEOCD(riegeli::Reader &reader, ZipEOCD &eocd) {
   return absl::OkStatus();
 }
 
+// 4.3.14, 4.3.15, 4.3.16
+absl::Status WriteEOCD(riegeli::Writer &writer, const ZipEOCD &eocd) {
+  if (eocd.comment.size() > kMax16) {
+    return absl::InvalidArgumentError("ZIP archive comment is too long");
+  }
+  const bool zip64 = eocd.num_entries >= kMax16 || eocd.cd_size >= kMax32 ||
+                     eocd.cd_offset >= kMax32;
+  bool ok = true;
+  if (zip64) {
+    const uint64_t eocd64_offset = writer.pos();
+    ok = WriteLittleEndian32(0x06064b50, writer) &&
+         WriteLittleEndian64(44, writer) &&  // size of remaining fields
+         WriteLittleEndian16(kVersionZip64, writer) &&  // version made by
+         WriteLittleEndian16(kVersionZip64, writer) &&  // version needed
+         WriteLittleEndian32(0, writer) &&              // disk number
+         WriteLittleEndian32(0, writer) &&              // disk with cd
+         WriteLittleEndian64(eocd.num_entries, writer) &&
+         WriteLittleEndian64(eocd.num_entries, writer) &&
+         WriteLittleEndian64(eocd.cd_size, writer) &&
+         WriteLittleEndian64(eocd.cd_offset, writer) &&
+         // Zip64 end of central directory locator.
+         WriteLittleEndian32(0x07064b50, writer) &&
+         WriteLittleEndian32(0, writer) &&  // disk with eocd64
+         WriteLittleEndian64(eocd64_offset, writer) &&
+         WriteLittleEndian32(1, writer);  // total number of disks
+  }
+  const uint16_t num_entries =
+      zip64 ? kMax16 : static_cast<uint16_t>(eocd.num_entries);
+  ok = ok && WriteLittleEndian32(0x06054b50, writer) &&
+       WriteLittleEndian16(0, writer) &&  // disk number
+       WriteLittleEndian16(0, writer) &&  // disk with cd
+       WriteLittleEndian16(num_entries, writer) &&
+       WriteLittleEndian16(num_entries, writer) &&
+       WriteLittleEndian32(zip64 ? kMax32 : eocd.cd_size, writer) &&
+       WriteLittleEndian32(zip64 ? kMax32 : eocd.cd_offset, writer) &&
+       WriteLittleEndian16(eocd.comment.size(), writer) &&
+       writer.Write(eocd.comment);
+  if (!ok) return writer.status();
+  return absl::OkStatus();
+}
+
 // TODO: Modify kvstore::ReadResult to include the returned range as well
 // as the size of the file.
 
@@ -602,6 +689,139 @@ absl::Status ReadLocalEntry(riegeli::Reader &reader, ZipEntry &entry) {
   return absl::OkStatus();
 }
 
+// 4.3.12
+absl::Status WriteCentralDirectoryEntry(riegeli::Writer &writer,
+                                        const ZipEntry &entry) {
+  if (entry.filename.size() > kMax16 || entry.comment.size() > kMax16) {
+    return absl::InvalidArgumentError(
+        "ZIP Central Directory Entry filename or comment is too long");
+  }
+  const bool zip64_uncompressed = entry.uncompressed_size >= kMax32;
+  const bool zip64_compressed = entry.compressed_size >= kMax32;
+  const bool zip64_offset = entry.local_header_offset >= kMax32;
+  const bool zip64 = zip64_uncompressed || zip64_compressed || zip64_offset;
+  const uint16_t zip64_size = 8 * (zip64_uncompressed + zip64_compressed +
+                                   zip64_offset);
+
+  uint16_t last_mod_time;
+  uint16_t last_mod_date;
+  MakeMSDOSDateTime(entry.mtime, last_mod_date, last_mod_time);
+  const uint16_t version_needed = GetVersionNeeded(entry, zip64);
+
+  bool ok =
+      WriteLittleEndian32(0x02014b50, writer) &&
+      WriteLittleEndian16(std::max(entry.version_madeby, version_needed),
+                          writer) &&
+      WriteLittleEndian16(version_needed, writer) &&
+      WriteLittleEndian16(entry.flags, writer) &&
+      WriteLittleEndian16(static_cast<uint16_t>(entry.compression_method),
+                          writer) &&
+      WriteLittleEndian16(last_mod_time, writer) &&
+      WriteLittleEndian16(last_mod_date, writer) &&
+      WriteLittleEndian32(entry.crc, writer) &&
+      WriteLittleEndian32(zip64_compressed ? kMax32 : entry.compressed_size,
+                          writer) &&
+      WriteLittleEndian32(
+          zip64_uncompressed ? kMax32 : entry.uncompressed_size, writer) &&
+      WriteLittleEndian16(entry.filename.size(), writer) &&
+      WriteLittleEndian16(zip64 ? 4 + zip64_size : 0, writer) &&
+      WriteLittleEndian16(entry.comment.size(), writer) &&
+      WriteLittleEndian16(0, writer) &&  // start disk_number
+      WriteLittleEndian16(entry.internal_fa, writer) &&
+      WriteLittleEndian32(entry.external_fa, writer) &&
+      WriteLittleEndian32(zip64_offset ? kMax32 : entry.local_header_offset,
+                          writer) &&
+      writer.Write(entry.filename);
+
+  // ZIP64 extended information; fields are present only when the
+  // corresponding header field is 0xFFFFFFFF, in this order.
+  if (ok && zip64) {
+    ok = WriteLittleEndian16(0x0001, writer) &&
+         WriteLittleEndian16(zip64_size, writer) &&
+         (!zip64_uncompressed ||
+          WriteLittleEndian64(entry.uncompressed_size, writer)) &&
+         (!zip64_compressed ||
+          WriteLittleEndian64(entry.compressed_size, writer)) &&
+         (!zip64_offset ||
+          WriteLittleEndian64(entry.local_header_offset, writer));
+  }
+  ok = ok && writer.Write(entry.comment);
+  if (!ok) return writer.status();
+  return absl::OkStatus();
+}
+
+// 4.3.7
+absl::Status WriteLocalEntry(riegeli::Writer &writer, const ZipEntry &entry) {
+  if (entry.filename.size() > kMax16) {
+    return absl::InvalidArgumentError(
+        "ZIP Local Entry filename is too long");
+  }
+  const bool zip64 =
+      entry.uncompressed_size >= kMax32 || entry.compressed_size >= kMax32;
+
+  uint16_t last_mod_time;
+  uint16_t last_mod_date;
+  MakeMSDOSDateTime(entry.mtime, last_mod_date, last_mod_time);
+
+  bool ok =
+      WriteLittleEndian32(0x04034b50, writer) &&
+      WriteLittleEndian16(GetVersionNeeded(entry, zip64), writer) &&
+      WriteLittleEndian16(entry.flags, writer) &&
+      WriteLittleEndian16(static_cast<uint16_t>(entry.compression_method),
+                          writer) &&
+      WriteLittleEndian16(last_mod_time, writer) &&
+      WriteLittleEndian16(last_mod_date, writer) &&
+      WriteLittleEndian32(entry.crc, writer) &&
+      WriteLittleEndian32(zip64 ? kMax32 : entry.compressed_size, writer) &&
+      WriteLittleEndian32(zip64 ? kMax32 : entry.uncompressed_size, writer) &&
+      WriteLittleEndian16(entry.filename.size(), writer) &&
+      WriteLittleEndian16(zip64 ? 20 : 0, writer) &&
+      writer.Write(entry.filename);
+  if (ok && zip64) {
+    ok = WriteLittleEndian16(0x0001, writer) &&
+         WriteLittleEndian16(16, writer) &&
+         WriteLittleEndian64(entry.uncompressed_size, writer) &&
+         WriteLittleEndian64(entry.compressed_size, writer);
+  }
+  if (!ok) return writer.status();
+  return absl::OkStatus();
+}
+
+absl::Status WriteEntry(riegeli::Writer &writer, const absl::Cord &value,
+                        ZipEntry &entry) {
+  absl::Cord compressed;
+  const absl::Cord *data = &value;
+  switch (entry.compression_method) {
+    case ZipCompression::kStore:
+      break;
+    case ZipCompression::kDeflate: {
+      using DeflateWriter =
+          riegeli::ZlibWriter<riegeli::CordWriter<absl::Cord *>>;
+      DeflateWriter deflate_writer(
+          riegeli::CordWriter<absl::Cord *>(&compressed),
+          DeflateWriter::Options().set_header(DeflateWriter::Header::kRaw));
+      if (!deflate_writer.Write(value) || !deflate_writer.Close()) {
+        return deflate_writer.status();
+      }
+      data = &compressed;
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Writing ZIP compression method ",
+                              entry.compression_method, " is not supported"));
+  }
+
+  entry.flags &= ~kHasDataDescriptor;
+  entry.crc = ComputeCrc32(value);
+  entry.uncompressed_size = value.size();
+  entry.compressed_size = data->size();
+  entry.local_header_offset = writer.pos();
+  TENSORSTORE_RETURN_IF_ERROR(WriteLocalEntry(writer, entry));
+  if (!writer.Write(*data)) return writer.status();
+  return absl::OkStatus();
+}
+
 /// Returns whether the ZIP entry can be read.
 absl::Status ValidateEntryIsSupported(const ZipEntry &entry) {
   if (entry.flags & 0x01 ||                 // encryption
@@ -23,9 +23,11 @@
 #include <variant>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
 #include "tensorstore/util/result.h"
 
 // NOTE: Currently tensorstore does not use a third-party zip library such
@@ -129,6 +131,12 @@ struct ZipEOCD {
 /// Read an EOCD at the current reader position.
 absl::Status ReadEOCD(riegeli::Reader &reader, ZipEOCD &eocd);
 
+/// Writes the EOCD at the current writer position, preceded by the EOCD64
+/// record and locator when the archive requires ZIP64.
+///
+/// \pre `writer.pos()` is the offset from the start of the archive.
+absl::Status WriteEOCD(riegeli::Writer &writer, const ZipEOCD &eocd);
+
 /// Read an EOCD64 at the current reader position.
 absl::Status ReadEOCD64(riegeli::Reader &reader, ZipEOCD &eocd);
 
@@ -208,6 +216,31 @@ absl::Status ReadCentralDirectoryEntry(riegeli::Reader &reader,
 /// Read a ZIP Local Directory Entry at the current reader position.
 absl::Status ReadLocalEntry(riegeli::Reader &reader, ZipEntry &entry);
 
+/// Write a ZIP Central Directory Entry at the current writer position.
+///
+/// A ZIP64 extended information field is written for any of the sizes and
+/// `local_header_offset` which do not fit in 32 bits.
+absl::Status WriteCentralDirectoryEntry(riegeli::Writer &writer,
+                                        const ZipEntry &entry);
+
+/// Write a ZIP Local Directory Entry at the current writer position.
+///
+/// The sizes and crc must be known, so no data descriptor is used.  A ZIP64
+/// extended information field is written when either size does not fit in 32
+/// bits.
+absl::Status WriteLocalEntry(riegeli::Writer &writer, const ZipEntry &entry);
+
+/// Writes `value` as a new archive member at the current writer position: the
+/// local entry followed by the data, compressed with
+/// `entry.compression_method`, which must be `kStore` or `kDeflate`.
+///
+/// On success, sets the `crc`, sizes, and `local_header_offset` of `entry`, as
+/// required by `WriteCentralDirectoryEntry`.
+///
+/// \pre `writer.pos()` is the offset from the start of the archive.
+absl::Status WriteEntry(riegeli::Writer &writer, const absl::Cord &value,
+                        ZipEntry &entry);
+
 /// Returns an error when the zip entry cannot be read.
 absl::Status ValidateEntryIsSupported(const ZipEntry &entry);
 
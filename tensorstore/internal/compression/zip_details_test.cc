@@ -31,6 +31,7 @@
 #include "absl/strings/cord.h"
 #include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/fd_reader.h"
 #include "riegeli/bytes/read_all.h"
 #include "riegeli/bytes/reader.h"
@@ -49,6 +50,9 @@ using ::tensorstore::internal_zip::ReadEOCD;
 using ::tensorstore::internal_zip::ReadEOCD64Locator;
 using ::tensorstore::internal_zip::ReadLocalEntry;
 using ::tensorstore::internal_zip::TryReadFullEOCD;
+using ::tensorstore::internal_zip::WriteCentralDirectoryEntry;
+using ::tensorstore::internal_zip::WriteEntry;
+using ::tensorstore::internal_zip::WriteEOCD;
 using ::tensorstore::internal_zip::ZipCompression;
 using ::tensorstore::internal_zip::ZipEntry;
 using ::tensorstore::internal_zip::ZipEOCD;
@@ -562,6 +566,95 @@ TEST(ZipDetailsTest, Deflate) {
   EXPECT_EQ(data.size(), local_header.uncompressed_size);
 }
 
+TEST(ZipDetailsTest, WriteRoundTrip) {
+  const absl::Cord kStored("stored value");
+  const absl::Cord kDeflated(std::string(1000, 'x'));
+
+  absl::Cord archive;
+  riegeli::CordWriter<absl::Cord*> writer(&archive);
+  std::vector<ZipEntry> entries(2);
+  entries[0].filename = "a";
+  entries[0].compression_method = ZipCompression::kStore;
+  entries[0].mtime = absl::FromUnixSeconds(1700000000);
+  entries[1].filename = "dir/b";
+  entries[1].compression_method = ZipCompression::kDeflate;
+  TENSORSTORE_ASSERT_OK(WriteEntry(writer, kStored, entries[0]));
+  TENSORSTORE_ASSERT_OK(WriteEntry(writer, kDeflated, entries[1]));
+  EXPECT_LT(entries[1].compressed_size, entries[1].uncompressed_size);
+
+  ZipEOCD eocd{};
+  eocd.num_entries = entries.size();
+  eocd.cd_offset = writer.pos();
+  for (const auto& entry : entries) {
+    TENSORSTORE_ASSERT_OK(WriteCentralDirectoryEntry(writer, entry));
+  }
+  eocd.cd_size = writer.pos() - eocd.cd_offset;
+  TENSORSTORE_ASSERT_OK(WriteEOCD(writer, eocd));
+  ASSERT_TRUE(writer.Close());
+
+  riegeli::CordReader reader(&archive);
+  ZipDirectory dir;
+  TENSORSTORE_ASSERT_OK(ReadDirectory(reader, dir));
+  ASSERT_EQ(dir.entries.size(), 2);
+  const absl::Cord* values[] = {&kStored, &kDeflated};
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(dir.entries[i].filename, entries[i].filename);
+    EXPECT_EQ(dir.entries[i].crc, entries[i].crc);
+    EXPECT_EQ(dir.entries[i].local_header_offset,
+              entries[i].local_header_offset);
+
+    ZipEntry local_header{};
+    reader.Seek(dir.entries[i].local_header_offset);
+    TENSORSTORE_ASSERT_OK(ReadLocalEntry(reader, local_header));
+    EXPECT_EQ(local_header.compression_method, entries[i].compression_method);
+    EXPECT_EQ(local_header.compressed_size, entries[i].compressed_size);
+
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto entry_reader,
+                                     GetReader(&reader, local_header));
+    std::string data;
+    TENSORSTORE_EXPECT_OK(riegeli::ReadAll(*entry_reader, data));
+    EXPECT_EQ(data, *values[i]);
+  }
+  EXPECT_EQ(dir.entries[0].mtime, absl::FromUnixSeconds(1700000000));
+}
+
+TEST(ZipDetailsTest, WriteZip64) {
+  absl::Cord encoded;
+  riegeli::CordWriter<absl::Cord*> writer(&encoded);
+
+  ZipEntry entry{};
+  entry.filename = "large";
+  entry.compression_method = ZipCompression::kStore;
+  entry.compressed_size = 0x100000000;
+  entry.uncompressed_size = 0x100000000;
+  entry.local_header_offset = 0x200000000;
+  TENSORSTORE_ASSERT_OK(WriteCentralDirectoryEntry(writer, entry));
+
+  ZipEOCD eocd{};
+  eocd.num_entries = 70000;
+  eocd.cd_offset = 0;
+  eocd.cd_size = writer.pos();
+  TENSORSTORE_ASSERT_OK(WriteEOCD(writer, eocd));
+  ASSERT_TRUE(writer.Close());
+
+  riegeli::CordReader reader(&encoded);
+  ZipEntry central{};
+  TENSORSTORE_ASSERT_OK(ReadCentralDirectoryEntry(reader, central));
+  EXPECT_TRUE(central.is_zip64);
+  EXPECT_EQ(central.compressed_size, entry.compressed_size);
+  EXPECT_EQ(central.uncompressed_size, entry.uncompressed_size);
+  EXPECT_EQ(central.local_header_offset, entry.local_header_offset);
+  EXPECT_EQ(central.filename, "large");
+
+  ZipEOCD read_eocd{};
+  auto response = TryReadFullEOCD(reader, read_eocd, 0);
+  ASSERT_TRUE(std::holds_alternative<absl::Status>(response));
+  TENSORSTORE_ASSERT_OK(std::get<absl::Status>(response));
+  EXPECT_EQ(read_eocd.num_entries, 70000);
+  EXPECT_EQ(read_eocd.cd_size, eocd.cd_size);
+  EXPECT_EQ(read_eocd.cd_offset, 0);
+}
+
 /* zipdetails data.zip
 =-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 00000 LOCAL HEADER #1       04034B50
@@ -14,10 +14,15 @@
 
 #include "tensorstore/internal/compression/zlib.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "tensorstore/internal/compression/cord_stream_manager.h"
+#include "tensorstore/util/span.h"
 
 // Include zlib header last because it defines a bunch of poorly-named macros.
 #include <zlib.h>
@@ -31,6 +36,9 @@ struct InflateOp {
     return inflateInit2(s, /*windowBits=*/15 /* (default) */
                                + header_option);
   }
+  static int Reset(z_stream* s, [[maybe_unused]] int level) {
+    return inflateReset(s);
+  }
   static int Process(z_stream* s, int flags) { return inflate(s, flags); }
   static int Destroy(z_stream* s) { return inflateEnd(s); }
   static constexpr bool kDataErrorPossible = true;
@@ -44,11 +52,54 @@ struct DeflateOp {
                         /*memlevel=*/8 /* (default) */,
                         /*strategy=*/Z_DEFAULT_STRATEGY);
   }
+  static int Reset(z_stream* s, int level) {
+    int err = deflateReset(s);
+    if (err != Z_OK) return err;
+    // Changing the parameters of a freshly-reset stream does not flush any
+    // output.
+    return deflateParams(s, level, Z_DEFAULT_STRATEGY);
+  }
   static int Process(z_stream* s, int flags) { return deflate(s, flags); }
   static int Destroy(z_stream* s) { return deflateEnd(s); }
   static constexpr bool kDataErrorPossible = false;
 };
 
+/// Per-thread zlib stream that is reset rather than re-created for each call.
+///
+/// Allocating and initializing a zlib stream (in particular the ~256KiB of
+/// deflate state) otherwise dominates the cost of encoding small inputs.
+template <typename Op>
+struct CachedZlibStream {
+  z_stream s = {};
+  bool initialized = false;
+
+  ~CachedZlibStream() {
+    if (initialized) Op::Destroy(&s);
+  }
+};
+
+/// Returns a stream of the current thread that is ready to process new input.
+///
+/// \param header_option Either `0` (zlib header) or `16` (gzip header).
+template <typename Op>
+z_stream& AcquireZlibStream(int level, int header_option) {
+  // The window bits, and therefore the header format, cannot be changed by
+  // resetting a stream, so a separate stream is kept for each header format.
+  thread_local CachedZlibStream<Op> streams[2];
+  auto& stream = streams[header_option != 0];
+  int err = stream.initialized ? Op::Reset(&stream.s, level)
+                               : Op::Init(&stream.s, level, header_option);
+  if (err != Z_OK) {
+    // Terminate if allocating even the small amount of memory required fails.
+    ABSL_CHECK(false);
+  }
+  stream.initialized = true;
+  // Clear any input left over from a previous call.
+  stream.s.next_in = nullptr;
+  stream.s.avail_in = 0;
+  return stream.s;
+}
+
 /// Inflates or deflates using zlib.
 ///
 /// \tparam Op Either `InflateOp` or `DeflateOp`.
@@ -63,20 +114,12 @@ struct DeflateOp {
 template <typename Op>
 absl::Status ProcessZlib(const absl::Cord& input, absl::Cord* output, int level,
                          bool use_gzip_header) {
-  z_stream s = {};
-  internal::CordStreamManager<z_stream, /*BufferSize=*/16 * 1024>
-      stream_manager(s, input, output);
   const int header_option = use_gzip_header ? 16 /* require gzip header */
                                             : 0;
-  int err = Op::Init(&s, level, header_option);
-  if (err != Z_OK) {
-    // Terminate if allocating even the small amount of memory required fails.
-    ABSL_CHECK(false);
-  }
-  struct StreamDestroyer {
-    z_stream* s;
-    ~StreamDestroyer() { Op::Destroy(s); }
-  } stream_destroyer{&s};
+  z_stream& s = AcquireZlibStream<Op>(level, header_option);
+  internal::CordStreamManager<z_stream, /*BufferSize=*/16 * 1024>
+      stream_manager(s, input, output);
+  int err;
 
   while (true) {
     const bool input_complete = stream_manager.FeedInputAndOutputBuffers();
@@ -118,5 +161,51 @@ absl::Status Decode(const absl::Cord& input, absl::Cord* output,
   return ProcessZlib<InflateOp>(input, output, 0, use_gzip_header);
 }
 
+absl::Status Decode(const absl::Cord& input, span<char> output,
+                    bool use_gzip_header) {
+  z_stream& s = AcquireZlibStream<InflateOp>(
+      /*level=*/0, use_gzip_header ? 16 /* require gzip header */ : 0);
+  // zlib requires a non-null output pointer even if no output is expected.
+  char empty_output;
+  s.next_out = reinterpret_cast<Bytef*>(output.empty() ? &empty_output
+                                                       : output.data());
+  s.avail_out = 0;
+  size_t output_remaining = output.size();
+  auto chunks = input.Chunks();
+  auto chunk_it = chunks.begin();
+  int err;
+  while (true) {
+    if (s.avail_in == 0 && chunk_it != chunks.end()) {
+      s.next_in =
+          reinterpret_cast<Bytef*>(const_cast<char*>(chunk_it->data()));
+      s.avail_in = chunk_it->size();
+      ++chunk_it;
+    }
+    if (s.avail_out == 0 && output_remaining != 0) {
+      // `avail_out` is limited to 32 bits.
+      s.avail_out = static_cast<uInt>(std::min<size_t>(
+          output_remaining, std::numeric_limits<uInt>::max()));
+      output_remaining -= s.avail_out;
+    }
+    err = inflate(&s, chunk_it == chunks.end() ? Z_FINISH : Z_NO_FLUSH);
+    if (err != Z_OK) break;
+  }
+  switch (err) {
+    case Z_STREAM_END:
+      if (s.avail_in == 0 && chunk_it == chunks.end() && s.avail_out == 0 &&
+          output_remaining == 0) {
+        return absl::OkStatus();
+      }
+      [[fallthrough]];
+    case Z_NEED_DICT:
+    case Z_DATA_ERROR:
+    case Z_BUF_ERROR:
+      return absl::InvalidArgumentError("Error decoding zlib-compressed data");
+    default:
+      ABSL_CHECK(false);
+  }
+  ABSL_UNREACHABLE();  // COV_NF_LINE
+}
+
 }  // namespace zlib
 }  // namespace tensorstore
@@ -23,6 +23,7 @@
 
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
@@ -60,6 +61,18 @@ void Encode(const absl::Cord& input, absl::Cord* output,
 absl::Status Decode(const absl::Cord& input, absl::Cord* output,
                     bool use_gzip_header);
 
+/// Decompresses `input` directly into `output`.
+///
+/// \param input Input to decode.
+/// \param output[out] Buffer to fill, must be exactly the decompressed size.
+/// \param use_gzip_header Specifies the header type with which `input` was
+///     encoded.
+/// \returns `absl::Status()` on success.
+/// \error `absl::StatusCode::kInvalidArgument` if `input` is corrupt or does
+///     not decompress to `output.size()` bytes.
+absl::Status Decode(const absl::Cord& input, span<char> output,
+                    bool use_gzip_header);
+
 }  // namespace zlib
 }  // namespace tensorstore
 
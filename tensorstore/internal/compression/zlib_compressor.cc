@@ -17,9 +17,14 @@
 #include <cstddef>
 #include <memory>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "riegeli/zlib/zlib_reader.h"
 #include "riegeli/zlib/zlib_writer.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
 #include "tensorstore/internal/compression/json_specified_compressor.h"
+#include "tensorstore/internal/compression/zlib.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -43,5 +48,32 @@ std::unique_ptr<riegeli::Reader> ZlibCompressor::GetReader(
   return std::make_unique<Reader>(std::move(base_reader), options);
 }
 
+absl::Status ZlibCompressor::Encode(const absl::Cord& input, absl::Cord* output,
+                                    size_t element_bytes) const {
+  if (absl::Status status; AcceleratedEncode(
+          use_gzip_header ? AcceleratedFormat::kGzip : AcceleratedFormat::kZlib,
+          input, level, output, status)) {
+    return status;
+  }
+  zlib::Encode(input, output, *this);
+  return absl::OkStatus();
+}
+
+absl::Status ZlibCompressor::Decode(const absl::Cord& input, absl::Cord* output,
+                                    size_t element_bytes) const {
+  return zlib::Decode(input, output, use_gzip_header);
+}
+
+absl::Status ZlibCompressor::DecodeInto(const absl::Cord& input,
+                                        span<char> output,
+                                        size_t element_bytes) const {
+  if (absl::Status status; AcceleratedDecodeInto(
+          use_gzip_header ? AcceleratedFormat::kGzip : AcceleratedFormat::kZlib,
+          input, output, status)) {
+    return status;
+  }
+  return zlib::Decode(input, output, use_gzip_header);
+}
+
 }  // namespace internal
 }  // namespace tensorstore
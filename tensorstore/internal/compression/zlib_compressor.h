@@ -20,10 +20,13 @@
 #include <cstddef>
 #include <memory>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/internal/compression/json_specified_compressor.h"
 #include "tensorstore/internal/compression/zlib.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -37,6 +40,17 @@ class ZlibCompressor : public JsonSpecifiedCompressor, public zlib::Options {
   virtual std::unique_ptr<riegeli::Reader> GetReader(
       std::unique_ptr<riegeli::Reader> base_reader,
       size_t element_bytes) const override;
+
+  /// Uses the current `CodecAccelerator`, if any, or otherwise a zlib stream
+  /// that is reused by the current thread.
+  absl::Status Encode(const absl::Cord& input, absl::Cord* output,
+                      size_t element_bytes) const override;
+  absl::Status Decode(const absl::Cord& input, absl::Cord* output,
+                      size_t element_bytes) const override;
+
+  /// Uses the current `CodecAccelerator`, if any.
+  absl::Status DecodeInto(const absl::Cord& input, span<char> output,
+                          size_t element_bytes) const override;
 };
 
 }  // namespace internal
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 #include "absl/strings/cord.h"
 #include "absl/strings/cord_test_helpers.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
 
@@ -106,6 +107,42 @@ TEST_P(ZlibCompressorTest, NonDefaultLevel) {
   EXPECT_EQ(input, decode_result);
 }
 
+// Tests decoding directly into a buffer of the decoded size.
+TEST_P(ZlibCompressorTest, DecodeIntoBuffer) {
+  const bool use_gzip_header = GetParam();
+  zlib::Options options{6, use_gzip_header};
+  std::string input(100000, '\0');
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<char>(i * i);
+  }
+  absl::Cord encode_result;
+  zlib::Encode(absl::Cord(input), &encode_result, options);
+  std::string flat(encode_result);
+  std::vector<std::string> parts;
+  for (size_t i = 0; i < flat.size(); i += 1001) {
+    parts.push_back(flat.substr(i, 1001));
+  }
+  const absl::Cord fragmented = absl::MakeFragmentedCord(parts);
+
+  std::string decoded(input.size(), '\0');
+  TENSORSTORE_ASSERT_OK(
+      zlib::Decode(fragmented, tensorstore::span<char>(decoded),
+                   options.use_gzip_header));
+  EXPECT_EQ(input, decoded);
+
+  // Output buffer too small.
+  std::string too_small(input.size() - 1, '\0');
+  EXPECT_THAT(zlib::Decode(fragmented, tensorstore::span<char>(too_small),
+                           options.use_gzip_header),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+
+  // Output buffer too large.
+  std::string too_large(input.size() + 1, '\0');
+  EXPECT_THAT(zlib::Decode(fragmented, tensorstore::span<char>(too_large),
+                           options.use_gzip_header),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests that decoding corrupt data gives an error.
 TEST_P(ZlibCompressorTest, DecodeCorruptData) {
   const bool use_gzip_header = GetParam();
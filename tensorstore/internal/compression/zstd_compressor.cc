@@ -15,26 +15,155 @@
 #include "tensorstore/internal/compression/zstd_compressor.h"
 
 #include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/zstd/zstd_dictionary.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/codec_accelerator.h"
 #include "tensorstore/internal/compression/json_specified_compressor.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+// Include zstd header last.
+#include <zstd.h>
 
 namespace tensorstore {
 namespace internal {
+namespace {
+
+struct ZstdContextDeleter {
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+  void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+// Contexts are reused by each thread since creating them (which allocates
+// several hundred KiB of working memory) otherwise dominates the cost of
+// encoding or decoding small chunks.
+ZSTD_CCtx* GetThreadCompressionContext() {
+  thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> ctx(
+      ZSTD_createCCtx());
+  return ctx.get();
+}
+
+ZSTD_DCtx* GetThreadDecompressionContext() {
+  thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> ctx(
+      ZSTD_createDCtx());
+  return ctx.get();
+}
+
+}  // namespace
 
 std::unique_ptr<riegeli::Writer> ZstdCompressor::GetWriter(
     std::unique_ptr<riegeli::Writer> base_writer, size_t element_bytes) const {
   using Writer = riegeli::ZstdWriter<std::unique_ptr<riegeli::Writer>>;
   Writer::Options options;
   options.set_compression_level(level);
+  if (!dictionary_.empty()) {
+    options.set_dictionary(zstd_dictionary_);
+  }
   return std::make_unique<Writer>(std::move(base_writer), options);
 }
 
 std::unique_ptr<riegeli::Reader> ZstdCompressor::GetReader(
     std::unique_ptr<riegeli::Reader> base_reader, size_t element_bytes) const {
   using Reader = riegeli::ZstdReader<std::unique_ptr<riegeli::Reader>>;
-  return std::make_unique<Reader>(std::move(base_reader));
+  Reader::Options options;
+  if (!dictionary_.empty()) {
+    options.set_dictionary(zstd_dictionary_);
+  }
+  return std::make_unique<Reader>(std::move(base_reader), options);
+}
+
+absl::Status ZstdCompressor::Encode(const absl::Cord& input, absl::Cord* output,
+                                    size_t element_bytes) const {
+  if (!dictionary_.empty()) {
+    return JsonSpecifiedCompressor::Encode(input, output, element_bytes);
+  }
+  ZSTD_CCtx* ctx = GetThreadCompressionContext();
+  ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  size_t result = ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, level);
+  if (ZSTD_isError(result)) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Invalid zstd compression level: ", ZSTD_getErrorName(result)));
+  }
+  absl::Cord flat_input = input;
+  std::string_view source = flat_input.Flatten();
+  std::string buffer(ZSTD_compressBound(source.size()), '\0');
+  result = ZSTD_compress2(ctx, buffer.data(), buffer.size(), source.data(),
+                          source.size());
+  if (ZSTD_isError(result)) {
+    return absl::InternalError(tensorstore::StrCat(
+        "Error encoding zstd-compressed data: ", ZSTD_getErrorName(result)));
+  }
+  buffer.resize(result);
+  output->Append(std::move(buffer));
+  return absl::OkStatus();
+}
+
+absl::Status ZstdCompressor::Decode(const absl::Cord& input, absl::Cord* output,
+                                    size_t element_bytes) const {
+  absl::Cord flat_input = input;
+  std::string_view source = flat_input.Flatten();
+  const unsigned long long decoded_size =  // NOLINT
+      ZSTD_getFrameContentSize(source.data(), source.size());
+  // Only a single frame with a known and plausible size is decoded directly;
+  // anything else, including invalid input, is left to `ZstdReader`.  A 4-byte
+  // RLE block decodes to at most 128KiB, which bounds the size up front.
+  if (!dictionary_.empty() || decoded_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      decoded_size == ZSTD_CONTENTSIZE_ERROR ||
+      decoded_size / (ZSTD_BLOCKSIZE_MAX / 4) > source.size() ||
+      ZSTD_findFrameCompressedSize(source.data(), source.size()) !=
+          source.size()) {
+    return JsonSpecifiedCompressor::Decode(input, output, element_bytes);
+  }
+  ZSTD_DCtx* ctx = GetThreadDecompressionContext();
+  ZSTD_DCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  std::string buffer(static_cast<size_t>(decoded_size), '\0');
+  size_t result = ZSTD_decompressDCtx(ctx, buffer.data(), buffer.size(),
+                                      source.data(), source.size());
+  if (ZSTD_isError(result) || result != buffer.size()) {
+    return absl::InvalidArgumentError("Error decoding zstd-compressed data");
+  }
+  output->Append(std::move(buffer));
+  return absl::OkStatus();
+}
+
+absl::Status ZstdCompressor::DecodeInto(const absl::Cord& input,
+                                        span<char> output,
+                                        size_t element_bytes) const {
+  if (!dictionary_.empty()) {
+    return JsonSpecifiedCompressor::DecodeInto(input, output, element_bytes);
+  }
+  if (absl::Status status; AcceleratedDecodeInto(AcceleratedFormat::kZstd,
+                                                 input, output, status)) {
+    return status;
+  }
+  absl::Cord flat_input = input;
+  std::string_view source = flat_input.Flatten();
+  // The output size bounds the decoded size, so frames without a recorded
+  // content size, as well as multiple frames, are decoded directly.
+  ZSTD_DCtx* ctx = GetThreadDecompressionContext();
+  ZSTD_DCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  size_t result = ZSTD_decompressDCtx(ctx, output.data(), output.size(),
+                                      source.data(), source.size());
+  if (ZSTD_isError(result) || result != output.size()) {
+    return absl::InvalidArgumentError("Error decoding zstd-compressed data");
+  }
+  return absl::OkStatus();
+}
+
+void ZstdCompressor::set_dictionary(std::string dictionary) {
+  dictionary_ = std::move(dictionary);
+  zstd_dictionary_ = riegeli::ZstdDictionary();
+  if (!dictionary_.empty()) {
+    zstd_dictionary_.set_automatic(dictionary_);
+  }
 }
 
 }  // namespace internal
@@ -18,10 +18,16 @@
 /// \file Defines a Zstd JsonSpecifiedCompressor.
 
 #include <cstddef>
+#include <memory>
+#include <string>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
+#include "riegeli/zstd/zstd_dictionary.h"
 #include "tensorstore/internal/compression/json_specified_compressor.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal {
@@ -39,6 +45,34 @@ class ZstdCompressor : public JsonSpecifiedCompressor, public ZstdOptions {
   virtual std::unique_ptr<riegeli::Reader> GetReader(
       std::unique_ptr<riegeli::Reader> base_reader,
       size_t element_bytes) const override;
+
+  /// Compresses or decompresses the entire input at once using a zstd context
+  /// that is reused by the current thread.
+  ///
+  /// Falls back to `GetWriter` and `GetReader`, respectively, if a dictionary
+  /// is specified or the decompressed size is not recorded in the frame.
+  absl::Status Encode(const absl::Cord& input, absl::Cord* output,
+                      size_t element_bytes) const override;
+  absl::Status Decode(const absl::Cord& input, absl::Cord* output,
+                      size_t element_bytes) const override;
+
+  /// Decompresses directly into `output` using the current
+  /// `CodecAccelerator`, if any, or otherwise using a zstd context that is
+  /// reused by the current thread.  Falls back to `GetReader` if a dictionary
+  /// is specified.
+  absl::Status DecodeInto(const absl::Cord& input, span<char> output,
+                          size_t element_bytes) const override;
+
+  /// Dictionary used for both compression and decompression, in either the
+  /// zstd dictionary format or as raw content.  An empty string indicates that
+  /// no dictionary is used.
+  const std::string& dictionary() const { return dictionary_; }
+  void set_dictionary(std::string dictionary);
+
+ private:
+  std::string dictionary_;
+  // Shares the digested form of `dictionary_` across writers and readers.
+  riegeli::ZstdDictionary zstd_dictionary_;
 };
 
 }  // namespace internal
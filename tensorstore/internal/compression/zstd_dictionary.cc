@@ -0,0 +1,76 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/zstd_dictionary.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+// Include these last to avoid polluting the namespace.
+#include <zdict.h>
+#include <zstd.h>
+
+namespace tensorstore {
+namespace internal {
+
+Result<std::string> TrainZstdDictionary(span<const absl::Cord> samples,
+                                        size_t max_dictionary_size) {
+  std::string buffer;
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(samples.size());
+  for (const auto& sample : samples) {
+    sample_sizes.push_back(sample.size());
+  }
+  buffer.reserve([&] {
+    size_t total = 0;
+    for (size_t size : sample_sizes) total += size;
+    return total;
+  }());
+  for (const auto& sample : samples) {
+    for (absl::string_view fragment : sample.Chunks()) {
+      buffer.append(fragment.data(), fragment.size());
+    }
+  }
+  std::string dictionary(max_dictionary_size, '\0');
+  const size_t result = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), buffer.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(result)) {
+    return absl::InvalidArgumentError(
+        tensorstore::StrCat("Failed to train zstd dictionary from ",
+                            samples.size(), " samples totaling ", buffer.size(),
+                            " bytes: ", ZDICT_getErrorName(result)));
+  }
+  dictionary.resize(result);
+  return dictionary;
+}
+
+uint32_t GetZstdDictionaryId(std::string_view dictionary) {
+  return ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+}
+
+}  // namespace internal
+}  // namespace tensorstore
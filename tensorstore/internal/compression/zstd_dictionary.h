@@ -0,0 +1,97 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
+#define TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
+
+/// \file
+///
+/// Utilities for zstd dictionaries.
+///
+/// Small inputs, such as individual chunks of a few tens of kilobytes, compress
+/// poorly with zstd because each input is compressed starting from an empty
+/// context.  A dictionary trained on representative samples primes that
+/// context.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Default maximum size of a dictionary returned by `TrainZstdDictionary`.
+constexpr size_t kDefaultZstdDictionarySize = 16 * 1024;
+
+/// Trains a zstd dictionary from `samples`.
+///
+/// Each sample should be a complete uncompressed input, e.g. the encoded bytes
+/// of a single chunk prior to compression, and the samples should be
+/// representative of the data to be compressed.  Training requires at least a
+/// few dozen samples; more samples generally produce a better dictionary.
+///
+/// \param samples The sample inputs.
+/// \param max_dictionary_size Maximum size of the dictionary in bytes.
+/// \returns The dictionary in the zstd dictionary format, which specifies a
+///     non-zero dictionary ID.
+/// \error `absl::StatusCode::kInvalidArgument` if training fails, e.g. because
+///     there are too few samples.
+Result<std::string> TrainZstdDictionary(
+    span<const absl::Cord> samples,
+    size_t max_dictionary_size = kDefaultZstdDictionarySize);
+
+/// Returns the dictionary ID of a dictionary in the zstd dictionary format, or
+/// `0` if `dictionary` does not specify an ID (e.g. a raw content dictionary).
+uint32_t GetZstdDictionaryId(std::string_view dictionary);
+
+/// JSON binder for a zstd dictionary, represented as a base64-encoded string.
+///
+/// An empty dictionary, meaning no dictionary, corresponds to a discarded
+/// (omitted) JSON value.
+constexpr auto ZstdDictionaryJsonBinder =
+    [](auto is_loading, const auto& options, auto* obj,
+       ::nlohmann::json* j) -> absl::Status {
+  if constexpr (is_loading) {
+    obj->clear();
+    if (j->is_discarded()) return absl::OkStatus();
+    auto* s = j->get_ptr<const std::string*>();
+    if (!s || !absl::Base64Unescape(*s, obj)) {
+      return absl::InvalidArgumentError(tensorstore::StrCat(
+          "Expected base64-encoded string, but received: ", j->dump()));
+    }
+  } else {
+    if (obj->empty()) {
+      *j = ::nlohmann::json::value_t::discarded;
+    } else {
+      *j = absl::Base64Escape(*obj);
+    }
+  }
+  return absl::OkStatus();
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_COMPRESSION_ZSTD_DICTIONARY_H_
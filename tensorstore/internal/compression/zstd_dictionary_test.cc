@@ -0,0 +1,89 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/compression/zstd_dictionary.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::GetZstdDictionaryId;
+using ::tensorstore::internal::TrainZstdDictionary;
+using ::tensorstore::internal::ZstdDictionaryJsonBinder;
+
+namespace jb = ::tensorstore::internal_json_binding;
+
+std::vector<absl::Cord> GetTestSamples() {
+  std::vector<absl::Cord> samples;
+  for (int i = 0; i < 100; ++i) {
+    std::string sample;
+    for (int j = 0; j < 64; ++j) {
+      sample += "{\"segment\": " + std::to_string((i * 131 + j * 7) % 1000) +
+                ", \"label\": \"neuron\", \"type\": \"axon\"}\n";
+    }
+    samples.emplace_back(std::move(sample));
+  }
+  return samples;
+}
+
+TEST(TrainZstdDictionaryTest, Basic) {
+  auto samples = GetTestSamples();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto dictionary,
+                                   TrainZstdDictionary(samples, 4096));
+  EXPECT_LE(dictionary.size(), 4096);
+  EXPECT_NE(0, GetZstdDictionaryId(dictionary));
+}
+
+TEST(TrainZstdDictionaryTest, TooFewSamples) {
+  auto samples = GetTestSamples();
+  samples.resize(2);
+  EXPECT_THAT(
+      TrainZstdDictionary(samples),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Failed to train zstd dictionary from 2 samples.*"));
+}
+
+TEST(GetZstdDictionaryIdTest, RawContent) {
+  EXPECT_EQ(0, GetZstdDictionaryId("raw content dictionary"));
+}
+
+TEST(ZstdDictionaryJsonBinderTest, RoundTrip) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto dictionary, jb::FromJson<std::string>(::nlohmann::json("YWJj"),
+                                                 ZstdDictionaryJsonBinder));
+  EXPECT_EQ("abc", dictionary);
+  EXPECT_EQ(::nlohmann::json("YWJj"),
+            jb::ToJson(dictionary, ZstdDictionaryJsonBinder).value());
+  EXPECT_TRUE(jb::ToJson(std::string(), ZstdDictionaryJsonBinder)
+                  .value()
+                  .is_discarded());
+  EXPECT_THAT(jb::FromJson<std::string>(::nlohmann::json(5),
+                                        ZstdDictionaryJsonBinder),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Expected base64-encoded string.*"));
+}
+
+}  // namespace
@@ -20,6 +20,7 @@
 #include <optional>
 
 #include "absl/base/call_once.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/concurrency_resource_provider.h"
@@ -38,10 +39,15 @@ AnyContextResourceJsonBinder<ConcurrencyResource::Spec>
 ConcurrencyResourceTraits::JsonBinder() {
   namespace jb = tensorstore::internal_json_binding;
   return [](auto is_loading, const auto& options, auto* obj, auto* j) {
-    return jb::Object(jb::Member(
-        "limit", jb::DefaultInitializedValue(jb::Optional(
-                     jb::Integer<size_t>(1), [] { return "shared"; }))))(
-        is_loading, options, obj, j);
+    return jb::Object(
+        jb::Member("limit", jb::Projection<&Spec::limit>(
+                                jb::DefaultInitializedValue(jb::Optional(
+                                    jb::Integer<size_t>(1),
+                                    [] { return "shared"; })))),
+        jb::Member("numa_node",
+                   jb::Projection<&Spec::numa_node>(
+                       jb::Optional(jb::Integer<int>(0)))))(is_loading, options,
+                                                            obj, j);
   };
 }
 
@@ -49,8 +55,19 @@ Result<ConcurrencyResource::Resource> ConcurrencyResourceTraits::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
   Resource value;
   value.spec = spec;
-  if (spec) {
-    value.executor = DetachedThreadPool(*spec);
+  if (spec.numa_node) {
+    if (spec.limit) {
+      value.executor = DetachedThreadPool(*spec.limit, *spec.numa_node);
+    } else {
+      absl::MutexLock lock(&numa_mutex_);
+      auto& executor = numa_shared_executors_[*spec.numa_node];
+      if (!executor) {
+        executor = DetachedThreadPool(shared_limit_, *spec.numa_node);
+      }
+      value.executor = executor;
+    }
+  } else if (spec.limit) {
+    value.executor = DetachedThreadPool(*spec.limit);
   } else {
     absl::call_once(shared_executor_once_, [&] {
       shared_executor_ = DetachedThreadPool(shared_limit_);
@@ -48,10 +48,23 @@ namespace internal {
 ///    constructor.
 ///
 /// 3. Register the `Traits` type using a `ContextResourceRegistration` object.
+///
+/// The resource may optionally specify a `numa_node`, in which case the worker
+/// threads are restricted to the CPUs of that NUMA node.
 struct ConcurrencyResource {
-  using Spec = std::optional<size_t>;
-  struct Resource {
+  struct Spec {
     // If equal to `nullopt`, indicates that the shared executor is used.
+    std::optional<size_t> limit;
+
+    // If specified, worker threads are restricted to the CPUs of this NUMA
+    // node.
+    std::optional<int> numa_node;
+
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.limit, x.numa_node);
+    };
+  };
+  struct Resource {
     Spec spec;
     Executor executor;
   };
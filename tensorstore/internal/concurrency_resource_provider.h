@@ -18,9 +18,13 @@
 #include <optional>
 
 #include "absl/base/call_once.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/cache_key/std_optional.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/json_binding/bindable.h"
@@ -40,7 +44,7 @@ class ConcurrencyResourceTraits {
   ConcurrencyResourceTraits(size_t shared_limit)
       : shared_limit_(shared_limit) {}
 
-  static Spec Default() { return std::nullopt; }
+  static Spec Default() { return Spec{}; }
 
   static AnyContextResourceJsonBinder<Spec> JsonBinder();
 
@@ -56,6 +60,11 @@ class ConcurrencyResourceTraits {
   /// Lazily-initialization shared thread pool used in the case of a default
   /// resource specification.
   mutable Executor shared_executor_;
+  /// Lazily-initialized shared thread pools, indexed by NUMA node, used in the
+  /// case of a resource specification with a `numa_node` but no `limit`.
+  mutable absl::Mutex numa_mutex_;
+  mutable absl::flat_hash_map<int, Executor> numa_shared_executors_
+      ABSL_GUARDED_BY(numa_mutex_);
 };
 
 }  // namespace internal
@@ -0,0 +1,190 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/convert_contiguous.h"
+
+#include <stdint.h>
+
+#include <array>
+
+#include "absl/base/casts.h"
+#include <half.hpp>
+#include "tensorstore/index.h"
+#include "tensorstore/util/bfloat16.h"
+#include "tensorstore/util/float8.h"
+#include "tensorstore/util/int4.h"
+
+// Runtime dispatch relies on GNU indirect functions (for `target_clones`) and
+// `__builtin_cpu_supports`.
+#if !defined(TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISABLE_DISPATCH) && \
+    defined(__x86_64__) && defined(__linux__) &&                         \
+    (defined(__clang__) ? __clang_major__ >= 14 : defined(__GNUC__))
+#define TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#ifdef TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH
+#define TENSORSTORE_INTERNAL_TARGET_CLONES \
+  __attribute__((target_clones("avx2", "default")))
+#else
+#define TENSORSTORE_INTERNAL_TARGET_CLONES
+#endif
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// Equivalent to `Float32ToBfloat16RoundNearestEven`, but without a branch so
+// that the loop can be vectorized.
+inline uint16_t Float32ToBfloat16Bits(float v) {
+  const uint32_t input = absl::bit_cast<uint32_t>(v);
+  const uint32_t rounded = (input + 0x7fff + ((input >> 16) & 1)) >> 16;
+  const uint32_t nan = (input | 0x00200000u) >> 16;
+  return static_cast<uint16_t>(
+      (input & 0x7fffffffu) > 0x7f800000u ? nan : rounded);
+}
+
+TENSORSTORE_INTERNAL_TARGET_CLONES
+void ConvertFloat32ToBfloat16(Index count, const float* from, BFloat16* to) {
+  for (Index i = 0; i < count; ++i) {
+    to[i] = absl::bit_cast<BFloat16>(Float32ToBfloat16Bits(from[i]));
+  }
+}
+
+// float8 values are converted by table lookup, since there are only 256.
+template <typename Float8>
+const std::array<float, 256>& GetFloat8ToFloat32Table() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> table;
+    for (int i = 0; i < 256; ++i) {
+      table[i] = static_cast<float>(Float8::FromRep(static_cast<uint8_t>(i)));
+    }
+    return table;
+  }();
+  return table;
+}
+
+template <typename Float8>
+void ConvertFloat8ToFloat32(Index count, const Float8* from, float* to) {
+  const float* table = GetFloat8ToFloat32Table<Float8>().data();
+  for (Index i = 0; i < count; ++i) {
+    to[i] = table[from[i].rep()];
+  }
+}
+
+#ifdef TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH
+
+// Every CPU that supports AVX2 also supports F16C.
+bool HasF16c() {
+  static const bool has_f16c = __builtin_cpu_supports("avx2");
+  return has_f16c;
+}
+
+__attribute__((target("avx2,f16c"))) void ConvertFloat32ToFloat16F16c(
+    Index count, const float* from, ::half_float::half* to) {
+  Index i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(from + i),
+                                      _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), h);
+  }
+  ConvertContiguousLoop(count - i, from + i, to + i);
+}
+
+__attribute__((target("avx2,f16c"))) void ConvertFloat16ToFloat32F16c(
+    Index count, const ::half_float::half* from, float* to) {
+  Index i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+    _mm256_storeu_ps(to + i, _mm256_cvtph_ps(h));
+  }
+  ConvertContiguousLoop(count - i, from + i, to + i);
+}
+
+#endif  // TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH
+
+}  // namespace
+
+template <>
+void ConvertContiguous<float, BFloat16>(Index count, const float* from,
+                                        BFloat16* to) {
+  ConvertFloat32ToBfloat16(count, from, to);
+}
+
+template <>
+void ConvertContiguous<float, ::half_float::half>(Index count,
+                                                  const float* from,
+                                                  ::half_float::half* to) {
+#ifdef TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH
+  if (HasF16c()) return ConvertFloat32ToFloat16F16c(count, from, to);
+#endif
+  ConvertContiguousLoop(count, from, to);
+}
+
+template <>
+void ConvertContiguous<::half_float::half, float>(
+    Index count, const ::half_float::half* from, float* to) {
+#ifdef TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_DISPATCH
+  if (HasF16c()) return ConvertFloat16ToFloat32F16c(count, from, to);
+#endif
+  ConvertContiguousLoop(count, from, to);
+}
+
+#define TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(FROM)                   \
+  template <>                                                              \
+  void ConvertContiguous<FROM, float>(Index count, const FROM* from,       \
+                                      float* to) {                         \
+    ConvertFloat8ToFloat32(count, from, to);                               \
+  }                                                                        \
+  /**/
+
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(Float8e4m3fn)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(Float8e4m3fnuz)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(Float8e4m3b11fnuz)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(Float8e5m2)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8(Float8e5m2fnuz)
+
+#undef TENSORSTORE_INTERNAL_DEFINE_CONVERT_FLOAT8
+
+// Pairs for which the plain loop vectorizes well, and only benefits from being
+// compiled for a wider instruction set.
+#define TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(FROM, TO)               \
+  template <>                                                            \
+  TENSORSTORE_INTERNAL_TARGET_CLONES void ConvertContiguous<FROM, TO>(   \
+      Index count, const FROM* from, TO* to) {                           \
+    ConvertContiguousLoop(count, from, to);                              \
+  }                                                                      \
+  /**/
+
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(Int4Padded, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(int8_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(uint8_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(int16_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(uint16_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(int32_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(uint32_t, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(float, uint8_t)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(float, int16_t)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(float, uint16_t)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(float, int32_t)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(float, double)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(double, float)
+TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP(BFloat16, float)
+
+#undef TENSORSTORE_INTERNAL_DEFINE_CONVERT_LOOP
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,98 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_H_
+#define TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_H_
+
+/// \file
+/// Conversion kernels for contiguous arrays of numeric types.
+///
+/// These are used by the `ApplyContiguous` specialization of
+/// `ConvertDataType`, which the data type conversion functions, and in turn the
+/// `cast` driver and reads/writes with a data type conversion, invoke for
+/// contiguous buffers.
+
+#include <stdint.h>
+
+#include <half.hpp>
+#include "tensorstore/index.h"
+#include "tensorstore/util/bfloat16.h"
+#include "tensorstore/util/float8.h"
+#include "tensorstore/util/int4.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Converts `count` contiguous elements as if by `static_cast<To>`.
+///
+/// This is a plain loop over raw pointers, which the compiler can vectorize for
+/// the baseline instruction set.
+template <typename From, typename To>
+inline void ConvertContiguousLoop(Index count, const From* from, To* to) {
+  for (Index i = 0; i < count; ++i) {
+    to[i] = static_cast<To>(from[i]);
+  }
+}
+
+/// Converts `count` contiguous elements as if by `static_cast<To>`.
+///
+/// The specializations declared below for common pairs of types are defined
+/// out of line, and select at run time an implementation for the vector
+/// instruction set supported by the CPU (currently AVX2 and F16C on x86-64).
+template <typename From, typename To>
+inline void ConvertContiguous(Index count, const From* from, To* to) {
+  ConvertContiguousLoop(count, from, to);
+}
+
+#define TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(FROM, TO)  \
+  template <>                                                      \
+  void ConvertContiguous<FROM, TO>(Index count, const FROM* from, \
+                                   TO* to);                        \
+  /**/
+
+// Integer -> float32
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Int4Padded, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(int8_t, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(uint8_t, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(int16_t, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(uint16_t, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(int32_t, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(uint32_t, float)
+
+// float32 -> integer
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, uint8_t)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, int16_t)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, uint16_t)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, int32_t)
+
+// Floating point <-> floating point
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, double)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(double, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, BFloat16)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(BFloat16, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(float, ::half_float::half)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(::half_float::half, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Float8e4m3fn, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Float8e4m3fnuz, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Float8e4m3b11fnuz, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Float8e5m2, float)
+TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS(Float8e5m2fnuz, float)
+
+#undef TENSORSTORE_INTERNAL_DECLARE_CONVERT_CONTIGUOUS
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_CONVERT_CONTIGUOUS_H_
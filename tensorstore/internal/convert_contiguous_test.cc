@@ -0,0 +1,178 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/convert_contiguous.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <half.hpp>
+#include "tensorstore/index.h"
+#include "tensorstore/util/bfloat16.h"
+#include "tensorstore/util/float8.h"
+#include "tensorstore/util/int4.h"
+
+namespace {
+
+using ::tensorstore::BFloat16;
+using ::tensorstore::Index;
+using ::tensorstore::Int4Padded;
+using ::tensorstore::internal::ConvertContiguous;
+
+template <typename T>
+bool IsNan(T x) {
+  return x != x;  // NOLINT
+}
+
+template <typename To>
+bool SameValue(To a, To b) {
+  if constexpr (!std::numeric_limits<To>::is_integer) {
+    // The payload of a NaN is not required to be preserved.
+    if (IsNan(a) && IsNan(b)) return true;
+  }
+  return std::memcmp(&a, &b, sizeof(To)) == 0;
+}
+
+template <typename T>
+std::vector<T> AllBitPatterns() {
+  std::vector<T> values(size_t(1) << (8 * sizeof(T)));
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto bits = static_cast<std::conditional_t<sizeof(T) == 1, uint8_t,
+                                               uint16_t>>(i);
+    std::memcpy(&values[i], &bits, sizeof(T));
+  }
+  return values;
+}
+
+// Returns finite and non-finite float32 values across the whole range,
+// including values that lie exactly halfway between two bfloat16 or float16
+// values.
+std::vector<float> SampleFloats() {
+  std::vector<float> values = {0.0f,
+                               -0.0f,
+                               1.0f,
+                               -1.5f,
+                               std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               std::numeric_limits<float>::signaling_NaN(),
+                               std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::denorm_min(),
+                               65504.0f,
+                               65520.0f};
+  uint32_t state = 1;
+  for (int i = 0; i < 10000; ++i) {
+    state = state * 1664525u + 1013904223u;
+    uint32_t bits = state;
+    // Make every fourth value a tie for bfloat16 rounding.
+    if (i % 4 == 0) bits = (bits & 0xffff0000u) | 0x8000u;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    values.push_back(value);
+  }
+  return values;
+}
+
+template <typename From, typename To>
+void TestMatchesStaticCast(const std::vector<From>& values) {
+  SCOPED_TRACE(::testing::Message()
+               << "sizeof(From)=" << sizeof(From)
+               << ", sizeof(To)=" << sizeof(To));
+  // Small counts exercise the remainder handling of vectorized loops.
+  for (size_t count : {size_t(0), size_t(1), size_t(7), size_t(8), size_t(9),
+                       size_t(33), values.size()}) {
+    if (count > values.size()) continue;
+    std::vector<To> actual(count);
+    ConvertContiguous(static_cast<Index>(count), values.data(), actual.data());
+    for (size_t i = 0; i < count; ++i) {
+      const To expected = static_cast<To>(values[i]);
+      EXPECT_TRUE(SameValue(actual[i], expected))
+          << "count=" << count << ", i=" << i;
+    }
+  }
+}
+
+TEST(ConvertContiguousTest, IntegerToFloat32) {
+  std::vector<Int4Padded> int4_values;
+  for (int i = -8; i < 8; ++i) int4_values.push_back(Int4Padded(i));
+  TestMatchesStaticCast<Int4Padded, float>(int4_values);
+  TestMatchesStaticCast<int8_t, float>(AllBitPatterns<int8_t>());
+  TestMatchesStaticCast<uint8_t, float>(AllBitPatterns<uint8_t>());
+  TestMatchesStaticCast<int16_t, float>(AllBitPatterns<int16_t>());
+  TestMatchesStaticCast<uint16_t, float>(AllBitPatterns<uint16_t>());
+  TestMatchesStaticCast<int32_t, float>(
+      {0, 1, -1, 16777217, std::numeric_limits<int32_t>::min(),
+       std::numeric_limits<int32_t>::max()});
+  TestMatchesStaticCast<uint32_t, float>(
+      {0u, 1u, 16777217u, 0x80000000u, 0x80000001u,
+       std::numeric_limits<uint32_t>::max()});
+}
+
+TEST(ConvertContiguousTest, Float32ToInteger) {
+  std::vector<float> values;
+  for (int i = 0; i < 256; ++i) values.push_back(i + 0.25f * (i % 4));
+  TestMatchesStaticCast<float, uint8_t>(values);
+  TestMatchesStaticCast<float, int16_t>(values);
+  TestMatchesStaticCast<float, uint16_t>(values);
+  TestMatchesStaticCast<float, int32_t>(values);
+}
+
+TEST(ConvertContiguousTest, Float32Float64) {
+  TestMatchesStaticCast<float, double>(SampleFloats());
+  std::vector<double> values = {1.0 + 1e-12, -3.0, 1e300, -1e-300};
+  for (float x : SampleFloats()) values.push_back(static_cast<double>(x) * 3);
+  TestMatchesStaticCast<double, float>(values);
+}
+
+TEST(ConvertContiguousTest, Bfloat16) {
+  TestMatchesStaticCast<float, BFloat16>(SampleFloats());
+  TestMatchesStaticCast<BFloat16, float>(AllBitPatterns<BFloat16>());
+}
+
+TEST(ConvertContiguousTest, Float16) {
+  TestMatchesStaticCast<float, ::half_float::half>(SampleFloats());
+  TestMatchesStaticCast<::half_float::half, float>(
+      AllBitPatterns<::half_float::half>());
+}
+
+TEST(ConvertContiguousTest, Float8ToFloat32) {
+  using ::tensorstore::Float8e4m3b11fnuz;
+  using ::tensorstore::Float8e4m3fn;
+  using ::tensorstore::Float8e4m3fnuz;
+  using ::tensorstore::Float8e5m2;
+  using ::tensorstore::Float8e5m2fnuz;
+  TestMatchesStaticCast<Float8e4m3fn, float>(AllBitPatterns<Float8e4m3fn>());
+  TestMatchesStaticCast<Float8e4m3fnuz, float>(
+      AllBitPatterns<Float8e4m3fnuz>());
+  TestMatchesStaticCast<Float8e4m3b11fnuz, float>(
+      AllBitPatterns<Float8e4m3b11fnuz>());
+  TestMatchesStaticCast<Float8e5m2, float>(AllBitPatterns<Float8e5m2>());
+  TestMatchesStaticCast<Float8e5m2fnuz, float>(
+      AllBitPatterns<Float8e5m2fnuz>());
+}
+
+// Pairs without a specialization use the generic loop.
+TEST(ConvertContiguousTest, Generic) {
+  TestMatchesStaticCast<int64_t, double>({0, -1, 1LL << 60});
+  TestMatchesStaticCast<uint16_t, int32_t>(AllBitPatterns<uint16_t>());
+}
+
+}  // namespace
@@ -27,6 +27,7 @@ namespace {
 struct DataCopyConcurrencyResourceTraits
     : public ConcurrencyResourceTraits,
       public ContextResourceTraits<DataCopyConcurrencyResource> {
+  constexpr static bool shared_when_decoded = true;
   DataCopyConcurrencyResourceTraits()
       : ConcurrencyResourceTraits(
             // This resource is for CPU-bound tasks.  Therefore, there is no
@@ -0,0 +1,83 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/data_copy_concurrency_resource.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::DataCopyConcurrencyResource;
+
+TEST(DataCopyConcurrencyResourceTest, Default) {
+  auto resource_spec =
+      Context::Resource<DataCopyConcurrencyResource>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_FALSE(resource->spec.limit);
+  EXPECT_FALSE(resource->spec.numa_node);
+  EXPECT_THAT(resource_spec.ToJson(),
+              IsOkAndHolds(::nlohmann::json(::nlohmann::json::object_t{})));
+}
+
+TEST(DataCopyConcurrencyResourceTest, Limit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson({{"limit", 4}}));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(4u, resource->spec.limit);
+  EXPECT_FALSE(resource->spec.numa_node);
+}
+
+TEST(DataCopyConcurrencyResourceTest, NumaNode) {
+  ::nlohmann::json json{{"limit", 2}, {"numa_node", 0}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson(json));
+  EXPECT_THAT(resource_spec.ToJson(), IsOkAndHolds(json));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(2u, resource->spec.limit);
+  EXPECT_EQ(0, resource->spec.numa_node);
+
+  // The executor runs tasks regardless of whether affinity is supported.
+  absl::Notification notification;
+  resource->executor([&] { notification.Notify(); });
+  notification.WaitForNotification();
+}
+
+TEST(DataCopyConcurrencyResourceTest, SharedNumaNode) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<DataCopyConcurrencyResource>::FromJson(
+          {{"numa_node", 0}}));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_FALSE(resource->spec.limit);
+  EXPECT_EQ(0, resource->spec.numa_node);
+}
+
+TEST(DataCopyConcurrencyResourceTest, InvalidNumaNode) {
+  EXPECT_THAT(Context::Resource<DataCopyConcurrencyResource>::FromJson(
+                  {{"numa_node", -1}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
@@ -233,12 +233,22 @@ struct WriteSwapEndianLoopTemplate {
               shape[1], static_cast<Index>(element_i + (writer.available() /
                                                         sizeof(Element))));
           char* cursor = writer.cursor();
-          for (; element_i < end_element_i; ++element_i) {
-            SwapEndianUnaligned<SubElementSize, NumSubElements>(
+          if constexpr (ArrayAccessor::buffer_kind ==
+                        internal::IterationBufferKind::kContiguous) {
+            // Contiguous source: swap the entire block at once.
+            SwapEndianUnalignedArray<SubElementSize, NumSubElements>(
                 ArrayAccessor::template GetPointerAtPosition<Element>(
                     source, outer_i, element_i),
-                cursor);
-            cursor += sizeof(Element);
+                cursor, end_element_i - element_i);
+            cursor += (end_element_i - element_i) * sizeof(Element);
+          } else {
+            for (; element_i < end_element_i; ++element_i) {
+              SwapEndianUnaligned<SubElementSize, NumSubElements>(
+                  ArrayAccessor::template GetPointerAtPosition<Element>(
+                      source, outer_i, element_i),
+                  cursor);
+              cursor += sizeof(Element);
+            }
           }
           element_i = end_element_i;
           writer.set_cursor(cursor);
@@ -301,6 +311,18 @@ struct ReadSwapEndianLoopTemplate {
               shape[1], static_cast<Index>(element_i + (reader.available() /
                                                         sizeof(Element))));
           const char* cursor = reader.cursor();
+          if constexpr (!IsBool &&
+                        ArrayAccessor::buffer_kind ==
+                            internal::IterationBufferKind::kContiguous) {
+            // Contiguous destination: swap the entire block at once.
+            SwapEndianUnalignedArray<SubElementSize, NumSubElements>(
+                cursor,
+                ArrayAccessor::template GetPointerAtPosition<Element>(
+                    source, outer_i, element_i),
+                end_element_i - element_i);
+            cursor += (end_element_i - element_i) * sizeof(Element);
+            element_i = end_element_i;
+          }
           for (; element_i < end_element_i; ++element_i) {
             if constexpr (IsBool) {
               unsigned char val = static_cast<unsigned char>(*cursor);
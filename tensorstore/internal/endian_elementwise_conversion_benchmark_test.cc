@@ -0,0 +1,125 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmarks encoding and decoding of arrays with and without endian
+// conversion, which uses the loops defined in `endian_elementwise_conversion.h`.
+//
+// BM_Encode/<element_size>/<swap>
+// BM_Decode/<element_size>/<swap>
+//
+// element_size:
+//
+//   Size in bytes of the unsigned integer data type.
+//
+// swap:
+//
+//   Indicates whether the encoded representation uses non-native endianness.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/riegeli/array_endian_codec.h"
+#include "tensorstore/util/endian.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::DataType;
+using ::tensorstore::endian;
+using ::tensorstore::Index;
+
+constexpr Index kShape[] = {256, 1024};
+
+DataType GetDataType(int64_t element_size) {
+  switch (element_size) {
+    case 2:
+      return tensorstore::dtype_v<uint16_t>;
+    case 4:
+      return tensorstore::dtype_v<uint32_t>;
+    default:
+      return tensorstore::dtype_v<uint64_t>;
+  }
+}
+
+endian GetEncodedEndian(bool swap) {
+  return (endian::native == endian::little) == swap ? endian::big
+                                                    : endian::little;
+}
+
+tensorstore::SharedArray<void> MakeArray(DataType dtype) {
+  return tensorstore::AllocateArray(tensorstore::span<const Index>(kShape),
+                                    tensorstore::c_order,
+                                    tensorstore::value_init, dtype);
+}
+
+absl::Cord Encode(tensorstore::SharedArray<const void> array,
+                  endian encoded_endian) {
+  absl::Cord encoded;
+  riegeli::CordWriter writer{&encoded};
+  ABSL_CHECK(tensorstore::internal::EncodeArrayEndian(
+      std::move(array), encoded_endian, tensorstore::c_order, writer));
+  ABSL_CHECK(writer.Close());
+  return encoded;
+}
+
+void BM_Encode(benchmark::State& state) {
+  auto array = MakeArray(GetDataType(state.range(0)));
+  const endian encoded_endian = GetEncodedEndian(state.range(1));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(Encode(array, encoded_endian));
+  }
+  state.SetBytesProcessed(state.iterations() * array.num_elements() *
+                          array.dtype().size());
+}
+
+void BM_Decode(benchmark::State& state) {
+  auto array = MakeArray(GetDataType(state.range(0)));
+  const endian encoded_endian = GetEncodedEndian(state.range(1));
+  const absl::Cord encoded = Encode(array, encoded_endian);
+  for (auto s : state) {
+    // Decode into an existing array to exclude the cost of allocation.
+    riegeli::CordReader reader{&encoded};
+    ABSL_CHECK_OK(tensorstore::internal::DecodeArrayEndian(
+        reader, encoded_endian, tensorstore::c_order, array));
+    benchmark::DoNotOptimize(array.data());
+  }
+  state.SetBytesProcessed(state.iterations() * array.num_elements() *
+                          array.dtype().size());
+}
+
+template <typename Bench>
+void DefineArgs(Bench* bench) {
+  for (int element_size : {2, 4, 8}) {
+    for (int swap : {0, 1}) {
+      bench->Args({element_size, swap});
+    }
+  }
+}
+
+BENCHMARK(BM_Encode)->Apply(DefineArgs);
+BENCHMARK(BM_Decode)->Apply(DefineArgs);
+
+}  // namespace
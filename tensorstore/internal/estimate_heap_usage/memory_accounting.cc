@@ -0,0 +1,174 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/env.h"
+#include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/internal/metrics/collect.h"
+#include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/metrics/registry.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+struct CategoryState {
+  std::atomic<int64_t> bytes{0};
+  std::atomic<int64_t> peak_bytes{0};
+  std::atomic<int64_t> limit{0};
+  // Number of promises in `waiters`, checked without locking `mutex` when
+  // usage decreases.
+  std::atomic<int64_t> num_waiters{0};
+  absl::Mutex mutex;
+  std::vector<Promise<void>> waiters ABSL_GUARDED_BY(mutex);
+};
+
+CategoryState& GetCategoryState(MemoryCategory category) {
+  static absl::NoDestructor<std::array<CategoryState, kNumMemoryCategories>>
+      states;
+  return (*states)[static_cast<size_t>(category)];
+}
+
+void UpdatePeak(CategoryState& state, int64_t bytes) {
+  int64_t peak = state.peak_bytes.load(std::memory_order_relaxed);
+  while (bytes > peak && !state.peak_bytes.compare_exchange_weak(
+                             peak, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+// Releases all waiters if usage is below the limit.
+void MaybeReleaseWaiters(CategoryState& state) {
+  std::vector<Promise<void>> waiters;
+  {
+    absl::MutexLock lock(&state.mutex);
+    const int64_t limit = state.limit.load();
+    if (limit != 0 && state.bytes.load() >= limit) return;
+    waiters.swap(state.waiters);
+    state.num_waiters = 0;
+  }
+  for (auto& promise : waiters) {
+    promise.SetResult(absl::OkStatus());
+  }
+}
+
+std::optional<internal_metrics::CollectedMetric> CollectMemoryMetric() {
+  internal_metrics::CollectedMetric result{};
+  result.metric_name = "/tensorstore/memory/bytes";
+  result.field_names.push_back("category");
+  result.metadata = internal_metrics::MetricMetadata(
+      "Memory accounted to each category, with the peak as the maximum",
+      internal_metrics::Units::kBytes);
+  result.tag = "gauge";
+  for (size_t i = 0; i < kNumMemoryCategories; ++i) {
+    const auto category = static_cast<MemoryCategory>(i);
+    auto& state = GetCategoryState(category);
+    internal_metrics::CollectedMetric::Value value;
+    value.fields.push_back(std::string(MemoryCategoryName(category)));
+    value.value = state.bytes.load(std::memory_order_relaxed);
+    value.max_value = state.peak_bytes.load(std::memory_order_relaxed);
+    result.values.push_back(std::move(value));
+  }
+  return result;
+}
+
+TENSORSTORE_GLOBAL_INITIALIZER {
+  internal_metrics::GetMetricRegistry().AddGeneric("/tensorstore/memory/bytes",
+                                                   CollectMemoryMetric);
+  if (auto limit =
+          GetEnvValue<int64_t>("TENSORSTORE_IN_FLIGHT_IO_BYTES_LIMIT")) {
+    SetMemoryLimit(MemoryCategory::kInFlightIo, *limit);
+  }
+}
+
+}  // namespace
+
+std::string_view MemoryCategoryName(MemoryCategory category) {
+  switch (category) {
+    case MemoryCategory::kCache:
+      return "cache";
+    case MemoryCategory::kInFlightIo:
+      return "in_flight_io";
+    case MemoryCategory::kTransaction:
+      return "transaction";
+    case MemoryCategory::kCodecScratch:
+      return "codec_scratch";
+  }
+  return "unknown";
+}
+
+void UpdateMemoryUsage(MemoryCategory category, int64_t delta) {
+  auto& state = GetCategoryState(category);
+  const int64_t bytes = state.bytes.fetch_add(delta) + delta;
+  if (delta > 0) {
+    UpdatePeak(state, bytes);
+  } else if (state.num_waiters.load() != 0) {
+    MaybeReleaseWaiters(state);
+  }
+}
+
+int64_t GetMemoryUsage(MemoryCategory category) {
+  return GetCategoryState(category).bytes.load(std::memory_order_relaxed);
+}
+
+void SetMemoryLimit(MemoryCategory category, int64_t limit) {
+  auto& state = GetCategoryState(category);
+  state.limit = std::max(int64_t{0}, limit);
+  if (state.num_waiters.load() != 0) MaybeReleaseWaiters(state);
+}
+
+int64_t GetMemoryLimit(MemoryCategory category) {
+  return GetCategoryState(category).limit.load(std::memory_order_relaxed);
+}
+
+Future<const void> WaitForMemoryBudget(MemoryCategory category) {
+  auto& state = GetCategoryState(category);
+  const int64_t limit = state.limit.load(std::memory_order_relaxed);
+  if (limit == 0 || state.bytes.load(std::memory_order_relaxed) < limit) {
+    return MakeReadyFuture();
+  }
+  absl::MutexLock lock(&state.mutex);
+  // `num_waiters` is incremented before re-checking the usage, so that a
+  // concurrent decrease either observes the waiter or is observed here.
+  state.num_waiters.fetch_add(1);
+  const int64_t current_limit = state.limit.load();
+  if (current_limit == 0 || state.bytes.load() < current_limit) {
+    state.num_waiters.fetch_sub(1);
+    return MakeReadyFuture();
+  }
+  auto [promise, future] = PromiseFuturePair<void>::Make();
+  state.waiters.push_back(std::move(promise));
+  return std::move(future);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,132 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_ESTIMATE_HEAP_USAGE_MEMORY_ACCOUNTING_H_
+#define TENSORSTORE_INTERNAL_ESTIMATE_HEAP_USAGE_MEMORY_ACCOUNTING_H_
+
+/// \file
+///
+/// Process-wide accounting of memory by category.
+///
+/// Memory that is not otherwise visible through `CachePool` limits, such as
+/// in-flight I/O buffers, is tracked by holding a `MemoryReservation` for as
+/// long as the memory is in use.  The current and peak usage of each category
+/// is exported as the `/tensorstore/memory/bytes` gauge.
+///
+/// A limit may be set for a category with `SetMemoryLimit`, or for in-flight
+/// I/O with the `TENSORSTORE_IN_FLIGHT_IO_BYTES_LIMIT` environment variable.
+/// Limits do not cause allocations to fail; instead, code that is about to
+/// start new work of that category waits on `WaitForMemoryBudget`, which
+/// applies backpressure until usage drops back below the limit.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+#include <utility>
+
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal {
+
+enum class MemoryCategory {
+  /// Cache entries accounted to a `CachePool` with a non-zero limit.
+  kCache = 0,
+  /// Request and response payloads of I/O operations that have been issued
+  /// and not yet consumed.
+  kInFlightIo,
+  /// State of uncommitted transactions.
+  kTransaction,
+  /// Temporary buffers used while encoding or decoding chunks.
+  kCodecScratch,
+};
+
+constexpr size_t kNumMemoryCategories = 4;
+
+/// Returns the name of `category`, used as the metric label.
+std::string_view MemoryCategoryName(MemoryCategory category);
+
+/// Adjusts the usage of `category` by `delta` bytes.
+///
+/// Prefer `MemoryReservation`, which ensures the usage is released.
+void UpdateMemoryUsage(MemoryCategory category, int64_t delta);
+
+/// Returns the current usage of `category`.
+int64_t GetMemoryUsage(MemoryCategory category);
+
+/// Sets the limit for `category`, or removes it if `limit == 0`.
+void SetMemoryLimit(MemoryCategory category, int64_t limit);
+
+/// Returns the limit for `category`, or `0` if there is no limit.
+int64_t GetMemoryLimit(MemoryCategory category);
+
+/// Returns a future that becomes ready once the usage of `category` is below
+/// its limit.
+///
+/// The returned future is ready immediately if there is no limit or the usage
+/// is already below the limit.  All waiters are released together, so the
+/// limit bounds when new work starts rather than the total usage.
+Future<const void> WaitForMemoryBudget(MemoryCategory category);
+
+/// Holds an amount of memory accounted to a category, which is released on
+/// destruction.
+class MemoryReservation {
+ public:
+  /// Constructs an empty reservation.
+  MemoryReservation() = default;
+
+  MemoryReservation(MemoryCategory category, int64_t bytes)
+      : category_(category), bytes_(bytes) {
+    if (bytes_) UpdateMemoryUsage(category_, bytes_);
+  }
+
+  MemoryReservation(MemoryReservation&& other) noexcept
+      : category_(other.category_), bytes_(std::exchange(other.bytes_, 0)) {}
+
+  MemoryReservation& operator=(MemoryReservation&& other) noexcept {
+    if (this != &other) {
+      Release();
+      category_ = other.category_;
+      bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+  }
+
+  ~MemoryReservation() { Release(); }
+
+  /// Increases the reservation by `bytes`.
+  void Grow(int64_t bytes) {
+    bytes_ += bytes;
+    UpdateMemoryUsage(category_, bytes);
+  }
+
+  /// Releases the reservation.
+  void Release() {
+    if (bytes_) UpdateMemoryUsage(category_, -std::exchange(bytes_, 0));
+  }
+
+  MemoryCategory category() const { return category_; }
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  MemoryCategory category_ = MemoryCategory::kInFlightIo;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_ESTIMATE_HEAP_USAGE_MEMORY_ACCOUNTING_H_
@@ -0,0 +1,110 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/internal/metrics/registry.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::internal::GetMemoryUsage;
+using ::tensorstore::internal::MemoryCategory;
+using ::tensorstore::internal::MemoryReservation;
+using ::tensorstore::internal::SetMemoryLimit;
+using ::tensorstore::internal::WaitForMemoryBudget;
+
+TEST(MemoryAccountingTest, Reservation) {
+  const int64_t initial = GetMemoryUsage(MemoryCategory::kTransaction);
+  {
+    MemoryReservation a(MemoryCategory::kTransaction, 100);
+    EXPECT_EQ(initial + 100, GetMemoryUsage(MemoryCategory::kTransaction));
+    a.Grow(50);
+    EXPECT_EQ(150, a.bytes());
+    MemoryReservation b = std::move(a);
+    EXPECT_EQ(0, a.bytes());
+    EXPECT_EQ(initial + 150, GetMemoryUsage(MemoryCategory::kTransaction));
+    b.Release();
+    EXPECT_EQ(initial, GetMemoryUsage(MemoryCategory::kTransaction));
+    b = MemoryReservation(MemoryCategory::kTransaction, 10);
+    EXPECT_EQ(initial + 10, GetMemoryUsage(MemoryCategory::kTransaction));
+  }
+  EXPECT_EQ(initial, GetMemoryUsage(MemoryCategory::kTransaction));
+}
+
+TEST(MemoryAccountingTest, Metric) {
+  MemoryReservation reservation(MemoryCategory::kCodecScratch, 1000);
+  auto metric = tensorstore::internal_metrics::GetMetricRegistry().Collect(
+      "/tensorstore/memory/bytes");
+  ASSERT_TRUE(metric);
+  int64_t value = -1;
+  int64_t peak = -1;
+  for (const auto& v : metric->values) {
+    if (v.fields == std::vector<std::string>{"codec_scratch"}) {
+      value = std::get<int64_t>(v.value);
+      peak = std::get<int64_t>(v.max_value);
+    }
+  }
+  EXPECT_GE(value, 1000);
+  EXPECT_GE(peak, value);
+}
+
+TEST(MemoryAccountingTest, Backpressure) {
+  const auto category = MemoryCategory::kInFlightIo;
+  EXPECT_TRUE(WaitForMemoryBudget(category).ready());
+
+  std::optional<MemoryReservation> reservation;
+  reservation.emplace(category, 100);
+  SetMemoryLimit(category, GetMemoryUsage(category));
+  auto future = WaitForMemoryBudget(category);
+  EXPECT_FALSE(future.ready());
+
+  // Growing usage does not release waiters.
+  MemoryReservation other(category, 10);
+  EXPECT_FALSE(future.ready());
+  other.Release();
+  EXPECT_FALSE(future.ready());
+
+  // Dropping below the limit does.
+  reservation.reset();
+  ASSERT_TRUE(future.ready());
+  TENSORSTORE_EXPECT_OK(future.status());
+
+  SetMemoryLimit(category, 0);
+  EXPECT_TRUE(WaitForMemoryBudget(category).ready());
+}
+
+TEST(MemoryAccountingTest, RemovingLimitReleasesWaiters) {
+  const auto category = MemoryCategory::kInFlightIo;
+  MemoryReservation reservation(category, 100);
+  SetMemoryLimit(category, 1);
+  auto future = WaitForMemoryBudget(category);
+  EXPECT_FALSE(future.ready());
+  SetMemoryLimit(category, 0);
+  EXPECT_TRUE(future.ready());
+}
+
+}  // namespace
@@ -27,6 +27,7 @@ namespace {
 struct FileIoConcurrencyResourceTraits
     : public ConcurrencyResourceTraits,
       public ContextResourceTraits<FileIoConcurrencyResource> {
+  constexpr static bool shared_when_decoded = true;
   // TODO(jbms): use beter method of picking concurrency limit
   FileIoConcurrencyResourceTraits()
       : ConcurrencyResourceTraits(
@@ -17,6 +17,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <new>
 #include <string_view>
 #include <utility>
 
@@ -46,21 +47,34 @@ class FlatCordBuilder {
     ABSL_CHECK(size == 0 || data_);
   }
 
+  /// Constructs a builder whose buffer is aligned to `alignment`, which must
+  /// be a power of two.  This is required for direct (unbuffered) file I/O.
+  FlatCordBuilder(size_t size, size_t inuse, std::align_val_t alignment)
+      : data_(static_cast<char*>(
+            ::operator new(size, alignment, std::nothrow))),
+        size_(size),
+        inuse_(inuse <= size ? inuse : size),
+        alignment_(static_cast<size_t>(alignment)) {
+    ABSL_CHECK(size == 0 || data_);
+  }
+
   FlatCordBuilder(const FlatCordBuilder&) = delete;
   FlatCordBuilder& operator=(const FlatCordBuilder&) = delete;
   FlatCordBuilder(FlatCordBuilder&& other)
       : data_(std::exchange(other.data_, nullptr)),
         size_(std::exchange(other.size_, 0)),
-        inuse_(std::exchange(other.inuse_, 0)) {}
+        inuse_(std::exchange(other.inuse_, 0)),
+        alignment_(std::exchange(other.alignment_, 0)) {}
   FlatCordBuilder& operator=(FlatCordBuilder&& other) {
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(inuse_, other.inuse_);
+    std::swap(alignment_, other.alignment_);
     return *this;
   }
   ~FlatCordBuilder() {
     if (data_) {
-      ::free(data_);
+      Free(data_, alignment_);
     }
   }
 
@@ -83,24 +97,37 @@ class FlatCordBuilder {
   }
 
   absl::Cord Build() && {
-    return absl::MakeCordFromExternal(release(), [](absl::string_view s) {
-      ::free(const_cast<char*>(s.data()));
-    });
+    const size_t alignment = alignment_;
+    return absl::MakeCordFromExternal(
+        release(), [alignment](absl::string_view s) {
+          Free(const_cast<char*>(s.data()), alignment);
+        });
   }
 
  private:
-  /// Releases ownership of the buffer.  The caller must call `::free`.
+  static void Free(char* data, size_t alignment) {
+    if (alignment) {
+      ::operator delete(data, std::align_val_t(alignment));
+    } else {
+      ::free(data);
+    }
+  }
+
+  /// Releases ownership of the buffer.  The caller must call `Free`.
   absl::string_view release() {
     absl::string_view view(data_, inuse_);
     data_ = nullptr;
     size_ = 0;
     inuse_ = 0;
+    alignment_ = 0;
     return view;
   }
 
   char* data_ = nullptr;
   size_t size_ = 0;
   size_t inuse_ = 0;
+  // Alignment of `data_`, or `0` if allocated by `::malloc`.
+  size_t alignment_ = 0;
 };
 
 }  // namespace internal
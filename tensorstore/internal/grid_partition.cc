@@ -18,6 +18,7 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -35,8 +36,10 @@
 #include "tensorstore/internal/grid_partition_impl.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/regular_grid.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/util/dimension_set.h"
+#include "tensorstore/util/division.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -62,6 +65,12 @@ struct ConnectedSetIterateParameters {
   absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
                                  IndexTransformView<> cell_transform)>
       func;
+  /// Shift to add to the precomputed grid cell indices of `info`, indexed by
+  /// grid dimension, or empty if there is no shift.
+  span<const Index> index_array_grid_cell_shift;
+  /// Cell shape of the grid, or empty if the grid is not known to be regular.
+  /// Must be consistent with `output_to_grid_cell`.
+  span<const Index> regular_grid_cell_shape;
 };
 
 /// Sets the fixed grid cell indices for all grid dimensions that do not
@@ -89,16 +98,21 @@ void InitializeConstantGridCellIndices(
 // This computes the grid cells that intersect the original input domain, by
 // starting at the first input index and then iteratively advancing to the next
 // input index not contained in the same partial grid cell.
+//
+// If `regular_grid_cell_shape` is non-empty, the grid cells are computed in
+// closed form rather than by calling `output_to_grid_cell`.
 class StridedSetGridCellIterator {
  public:
   explicit StridedSetGridCellIterator(
       IndexTransformView<> transform,
       span<const DimensionIndex> grid_output_dimensions,
-      OutputToGridCellFn output_to_grid_cell, StridedSet strided_set)
+      OutputToGridCellFn output_to_grid_cell, StridedSet strided_set,
+      span<const Index> regular_grid_cell_shape = {})
       : transform_(transform),
         grid_output_dimensions_(grid_output_dimensions),
         output_to_grid_cell_(output_to_grid_cell),
-        strided_set_(strided_set) {
+        strided_set_(strided_set),
+        regular_grid_cell_shape_(regular_grid_cell_shape) {
     const IndexInterval domain =
         transform.input_domain()[strided_set.input_dimension];
     input_index_ = domain.inclusive_min();
@@ -109,6 +123,9 @@ class StridedSetGridCellIterator {
 
   IndexInterval Next(span<Index> grid_cell_indices) {
     assert(!AtEnd());
+    if (!regular_grid_cell_shape_.empty()) {
+      return NextRegular(grid_cell_indices);
+    }
     // The subset of the original input domain that corresponds to the current
     // partial grid cell.
     IndexInterval restricted_domain =
@@ -136,10 +153,42 @@ class StridedSetGridCellIterator {
   }
 
  private:
+  // Equivalent to `Next`, but specialized for a regular grid.
+  IndexInterval NextRegular(span<Index> grid_cell_indices) {
+    Index end_index = input_end_index_;
+    for (const DimensionIndex grid_dim :
+         strided_set_.grid_dimensions.index_view()) {
+      const DimensionIndex output_dim = grid_output_dimensions_[grid_dim];
+      const OutputIndexMapRef<> map = transform_.output_index_map(output_dim);
+      const Index offset = map.offset();
+      const Index stride = map.stride();
+      const Index cell_size = regular_grid_cell_shape_[grid_dim];
+      // The check in PrePartitionIndexTransformOverRegularGrid guarantees
+      // that this does not overflow.
+      const Index output_index = input_index_ * stride + offset;
+      const Index cell_index = FloorOfRatio(output_index, cell_size);
+      grid_cell_indices[grid_dim] = cell_index;
+      // Number of subsequent input indices that map into the same cell.
+      const Index cell_position = output_index - cell_index * cell_size;
+      const Index remaining =
+          (stride > 0) ? (cell_size - 1 - cell_position) / stride
+                       : cell_position / -stride;
+      if (remaining < end_index - input_index_) {
+        end_index = input_index_ + remaining + 1;
+      }
+    }
+    assert(end_index > input_index_);
+    const auto restricted_domain =
+        IndexInterval::UncheckedHalfOpen(input_index_, end_index);
+    input_index_ = end_index;
+    return restricted_domain;
+  }
+
   IndexTransformView<> transform_;
   span<const DimensionIndex> grid_output_dimensions_;
   OutputToGridCellFn output_to_grid_cell_;
   StridedSet strided_set_;
+  span<const Index> regular_grid_cell_shape_;
   Index input_index_;
   Index input_end_index_;
 };
@@ -202,6 +251,10 @@ class ConnectedSetIterateHelper {
         grid_cell_indices_[grid_dim] =
             index_array_set
                 .grid_cell_indices[grid_cell_indices_offset + grid_i++];
+        if (!params_.index_array_grid_cell_shift.empty()) {
+          grid_cell_indices_[grid_dim] +=
+              params_.index_array_grid_cell_shift[grid_dim];
+        }
       }
 
       UpdateCellTransformForIndexArraySetPartition(
@@ -232,7 +285,8 @@ class ConnectedSetIterateHelper {
     if (set_i == params_.info.strided_sets().size()) return InvokeCallback();
     StridedSetGridCellIterator iterator(
         params_.transform, params_.grid_output_dimensions,
-        params_.output_to_grid_cell, params_.info.strided_sets()[set_i]);
+        params_.output_to_grid_cell, params_.info.strided_sets()[set_i],
+        params_.regular_grid_cell_shape);
     const DimensionIndex cell_input_dim =
         set_i + params_.info.index_array_sets().size();
     while (!iterator.AtEnd()) {
@@ -255,9 +309,14 @@ class ConnectedSetIterateHelper {
   /// \error Any error returned by the iteration callback function.
   absl::Status InvokeCallback() {
     internal_index_space::DebugCheckInvariants(cell_transform_.get());
-    auto status = params_.func(
-        grid_cell_indices_,
-        TransformAccess::Make<IndexTransformView<>>(cell_transform_.get()));
+    absl::Status status;
+    {
+      // The work done by the callback is not part of the partitioning.
+      internal_tracing::StageScope stage(internal_tracing::Stage::kNone);
+      status = params_.func(
+          grid_cell_indices_,
+          TransformAccess::Make<IndexTransformView<>>(cell_transform_.get()));
+    }
     // If `func` created and is still holding a reference to `cell_transform_`,
     // we need to make a copy before modifying it.
     cell_transform_ = MutableRep(std::move(cell_transform_));
@@ -487,6 +546,7 @@ absl::Status PartitionIndexTransformOverGrid(
     absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
                                    IndexTransformView<> cell_transform)>
         func) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kIndexTransform);
   internal_grid_partition::IndexTransformGridPartition partition_info;
   auto status = internal_grid_partition::PrePartitionIndexTransformOverGrid(
       transform, grid_output_dimensions, output_to_grid_cell, partition_info);
@@ -497,7 +557,9 @@ absl::Status PartitionIndexTransformOverGrid(
               /*.grid_output_dimensions=*/grid_output_dimensions,
               /*.output_to_grid_cell=*/output_to_grid_cell,
               /*.transform=*/transform,
-              /*.func=*/std::move(func)})
+              /*.func=*/std::move(func),
+              /*.index_array_grid_cell_shift=*/{},
+              /*.regular_grid_cell_shape=*/{}})
       .Iterate();
 }
 
@@ -507,10 +569,138 @@ absl::Status PartitionIndexTransformOverRegularGrid(
     absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
                                    IndexTransformView<> cell_transform)>
         func) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kIndexTransform);
+  assert(grid_cell_shape.size() == grid_output_dimensions.size());
+  internal_grid_partition::RegularGridRef grid{grid_cell_shape};
+  internal_grid_partition::IndexTransformGridPartition partition_info;
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::PrePartitionIndexTransformOverGrid(
+          transform, grid_output_dimensions, grid, partition_info));
+  return internal_grid_partition::ConnectedSetIterateHelper(
+             {/*.info=*/partition_info,
+              /*.grid_output_dimensions=*/grid_output_dimensions,
+              /*.output_to_grid_cell=*/grid,
+              /*.transform=*/transform,
+              /*.func=*/std::move(func),
+              /*.index_array_grid_cell_shift=*/{},
+              /*.regular_grid_cell_shape=*/grid_cell_shape})
+      .Iterate();
+}
+
+Result<RegularGridPartitionPlan> RegularGridPartitionPlan::Make(
+    span<const DimensionIndex> grid_output_dimensions,
+    span<const Index> grid_cell_shape, IndexTransform<> transform) {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kIndexTransform);
   assert(grid_cell_shape.size() == grid_output_dimensions.size());
+  auto partition =
+      std::make_shared<internal_grid_partition::IndexTransformGridPartition>();
   internal_grid_partition::RegularGridRef grid{grid_cell_shape};
-  return PartitionIndexTransformOverGrid(grid_output_dimensions, grid,
-                                         transform, std::move(func));
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::PrePartitionIndexTransformOverGrid(
+          transform, grid_output_dimensions, grid, *partition));
+  RegularGridPartitionPlan plan;
+  plan.grid_output_dimensions_.assign(grid_output_dimensions.begin(),
+                                      grid_output_dimensions.end());
+  plan.grid_cell_shape_.assign(grid_cell_shape.begin(), grid_cell_shape.end());
+  plan.transform_ = std::move(transform);
+  plan.partition_ = std::move(partition);
+  return plan;
+}
+
+bool RegularGridPartitionPlan::GetIndexArrayGridCellShift(
+    IndexTransformView<> transform, span<Index> shift) const {
+  if (!partition_ || !transform.valid()) return false;
+  if (transform.input_rank() != transform_.input_rank() ||
+      transform.output_rank() != transform_.output_rank() ||
+      transform.domain().box() != transform_.domain().box()) {
+    return false;
+  }
+  for (DimensionIndex output_dim = 0; output_dim < transform.output_rank();
+       ++output_dim) {
+    const auto planned_map = transform_.output_index_map(output_dim);
+    const auto map = transform.output_index_map(output_dim);
+    if (planned_map.method() != map.method()) return false;
+    switch (map.method()) {
+      case OutputIndexMethod::constant:
+        break;
+      case OutputIndexMethod::single_input_dimension:
+        if (planned_map.input_dimension() != map.input_dimension() ||
+            planned_map.stride() != map.stride()) {
+          return false;
+        }
+        break;
+      case OutputIndexMethod::array: {
+        const auto planned_index_array = planned_map.index_array();
+        const auto index_array = map.index_array();
+        if (planned_map.stride() != map.stride() ||
+            planned_index_array.array_ref().data() !=
+                index_array.array_ref().data() ||
+            !std::equal(planned_index_array.byte_strides().begin(),
+                        planned_index_array.byte_strides().end(),
+                        index_array.byte_strides().begin()) ||
+            planned_index_array.index_range() != index_array.index_range()) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  std::fill(shift.begin(), shift.end(), Index(0));
+  for (DimensionIndex grid_dim = 0; grid_dim < grid_output_dimensions_.size();
+       ++grid_dim) {
+    const DimensionIndex output_dim = grid_output_dimensions_[grid_dim];
+    const auto map = transform.output_index_map(output_dim);
+    if (map.method() != OutputIndexMethod::single_input_dimension) continue;
+    // Same check as in `PrePartitionIndexTransformOverGrid`.
+    const IndexInterval input_domain =
+        transform.input_domain()[map.input_dimension()];
+    if (!GetAffineTransformRange(input_domain, map.offset(), map.stride())
+             .ok()) {
+      return false;
+    }
+  }
+  for (const auto& set : partition_->index_array_sets()) {
+    for (const DimensionIndex grid_dim : set.grid_dimensions.index_view()) {
+      const DimensionIndex output_dim = grid_output_dimensions_[grid_dim];
+      const Index offset_difference =
+          transform.output_index_map(output_dim).offset() -
+          transform_.output_index_map(output_dim).offset();
+      const Index cell_size = grid_cell_shape_[grid_dim];
+      if (offset_difference % cell_size != 0) return false;
+      shift[grid_dim] = offset_difference / cell_size;
+    }
+  }
+  return true;
+}
+
+bool RegularGridPartitionPlan::CanReuse(IndexTransformView<> transform) const {
+  Index shift[kMaxRank];
+  return GetIndexArrayGridCellShift(
+      transform, span<Index>(shift, grid_output_dimensions_.size()));
+}
+
+absl::Status RegularGridPartitionPlan::Partition(
+    IndexTransformView<> transform,
+    absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
+                                   IndexTransformView<> cell_transform)>
+        func) const {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kIndexTransform);
+  Index shift_storage[kMaxRank];
+  span<Index> shift(shift_storage, grid_output_dimensions_.size());
+  if (!GetIndexArrayGridCellShift(transform, shift)) {
+    return PartitionIndexTransformOverRegularGrid(
+        grid_output_dimensions_, grid_cell_shape_, transform, std::move(func));
+  }
+  internal_grid_partition::RegularGridRef grid{grid_cell_shape_};
+  return internal_grid_partition::ConnectedSetIterateHelper(
+             {/*.info=*/*partition_,
+              /*.grid_output_dimensions=*/grid_output_dimensions_,
+              /*.output_to_grid_cell=*/grid,
+              /*.transform=*/transform,
+              /*.func=*/std::move(func),
+              /*.index_array_grid_cell_shift=*/shift,
+              /*.regular_grid_cell_shape=*/grid_cell_shape_})
+      .Iterate();
 }
 
 }  // namespace internal
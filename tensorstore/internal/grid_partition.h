@@ -95,15 +95,24 @@
 /// irregular grids will be added in order to support virtual concatenated views
 /// of multiple tensorstores.
 
+#include <memory>
+
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/util/iterate.h"
+#include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 
 namespace tensorstore {
+namespace internal_grid_partition {
+class IndexTransformGridPartition;
+}  // namespace internal_grid_partition
+
 namespace internal {
 
 /// Partitions the input domain of a given `transform` from an input space
@@ -135,6 +144,75 @@ absl::Status PartitionIndexTransformOverRegularGrid(
                                    IndexTransformView<> cell_transform)>
         func);
 
+/// Precomputed partition of an index transform over a regular grid, which may
+/// be reused to partition transforms that differ only in their output offsets.
+///
+/// Partitioning a transform with `array` output index maps requires sorting
+/// the index array elements by grid cell, which dominates the cost of small
+/// reads that repeatedly use the same index arrays.  `Partition` reuses that
+/// work for any `transform` with the same input domain, output index methods,
+/// input dimensions, strides and index arrays as the planned transform, as
+/// long as the offsets of the `array` maps corresponding to grid dimensions
+/// differ by whole multiples of the grid cell shape.  Offsets of
+/// `single_input_dimension` and `constant` maps may differ arbitrarily, since
+/// those are partitioned directly.  Other transforms are partitioned from
+/// scratch.
+///
+/// A plan is immutable and may be shared by multiple threads.
+class RegularGridPartitionPlan {
+ public:
+  /// Constructs an invalid plan, for which `Partition` always partitions from
+  /// scratch.
+  RegularGridPartitionPlan() = default;
+
+  /// Precomputes the partition of `transform`.
+  ///
+  /// \param grid_output_dimensions The sequence of dimensions of the index
+  ///     space "output" corresponding to the grid.
+  /// \param grid_cell_shape The shape of a grid cell.
+  /// \param transform The index transform from "full" to "output".
+  /// \error Any error returned by `PartitionIndexTransformOverRegularGrid`
+  ///     other than errors returned by `func`.
+  static Result<RegularGridPartitionPlan> Make(
+      span<const DimensionIndex> grid_output_dimensions,
+      span<const Index> grid_cell_shape, IndexTransform<> transform);
+
+  /// Returns `true` if `Partition(transform, func)` reuses the precomputed
+  /// partition.
+  bool CanReuse(IndexTransformView<> transform) const;
+
+  /// Equivalent to calling `PartitionIndexTransformOverRegularGrid` with the
+  /// grid specified to `Make`.
+  absl::Status Partition(
+      IndexTransformView<> transform,
+      absl::FunctionRef<absl::Status(span<const Index> grid_cell_indices,
+                                     IndexTransformView<> cell_transform)>
+          func) const;
+
+  /// Returns the transform specified to `Make`.
+  IndexTransformView<> transform() const { return transform_; }
+
+  span<const DimensionIndex> grid_output_dimensions() const {
+    return grid_output_dimensions_;
+  }
+
+  span<const Index> grid_cell_shape() const { return grid_cell_shape_; }
+
+ private:
+  /// Computes the shift of the grid cell indices of the `array` maps of
+  /// `transform` relative to the planned transform.
+  ///
+  /// \returns `false` if the precomputed partition cannot be reused.
+  bool GetIndexArrayGridCellShift(IndexTransformView<> transform,
+                                  span<Index> shift) const;
+
+  absl::InlinedVector<DimensionIndex, kNumInlinedDims> grid_output_dimensions_;
+  absl::InlinedVector<Index, kNumInlinedDims> grid_cell_shape_;
+  IndexTransform<> transform_;
+  std::shared_ptr<const internal_grid_partition::IndexTransformGridPartition>
+      partition_;
+};
+
 /// Partitions the input domain of a given `transform` from an input space
 /// "full" to an output space "output" based on potentially irregular grid
 /// specified by `output_to_grid_cell`, which maps from a given dimension and
@@ -164,7 +242,6 @@ absl::Status GetGridCellRanges(
 }  // namespace internal
 
 namespace internal_grid_partition {
-class IndexTransformGridPartition;
 
 // Computes the set of grid cells that intersect the output range of
 // `transform`, and returns them as a set of lexicographical ranges.
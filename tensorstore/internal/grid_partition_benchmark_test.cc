@@ -0,0 +1,128 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/internal/grid_partition.h"
+#include "tensorstore/internal/regular_grid.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+
+namespace {
+
+using ::tensorstore::DimensionIndex;
+using ::tensorstore::Index;
+using ::tensorstore::IndexTransformBuilder;
+using ::tensorstore::IndexTransformView;
+using ::tensorstore::span;
+
+enum PartitionMode {
+  // `PartitionIndexTransformOverRegularGrid`.
+  kRegular,
+  // `PartitionIndexTransformOverGrid` with a regular grid, which does not use
+  // the closed-form computation.
+  kGeneric,
+};
+
+// Partitions a 2-d transform with the specified output `stride` over a grid
+// with a cell shape of `{8, 8}`, and a domain covering 320x320 (102400) cells.
+template <PartitionMode Mode>
+void BM_PartitionStrided(benchmark::State& state) {
+  const Index stride = state.range(0);
+  constexpr Index kCellSize = 8;
+  constexpr Index kCellsPerDim = 320;
+  const Index input_size = kCellsPerDim * kCellSize / stride;
+  auto transform = IndexTransformBuilder<>(2, 2)
+                       .input_origin({0, 0})
+                       .input_shape({input_size, input_size})
+                       .output_single_input_dimension(0, 3, stride, 0)
+                       .output_single_input_dimension(1, 5, stride, 1)
+                       .Finalize()
+                       .value();
+  const std::vector<DimensionIndex> grid_output_dimensions{0, 1};
+  const std::vector<Index> grid_cell_shape{kCellSize, kCellSize};
+  tensorstore::internal_grid_partition::RegularGridRef grid{grid_cell_shape};
+  int64_t num_cells = 0;
+  for (auto s : state) {
+    const auto func = [&](span<const Index> grid_cell_indices,
+                          IndexTransformView<> cell_transform) {
+      benchmark::DoNotOptimize(grid_cell_indices.data());
+      ++num_cells;
+      return absl::OkStatus();
+    };
+    if constexpr (Mode == kRegular) {
+      TENSORSTORE_CHECK_OK(
+          tensorstore::internal::PartitionIndexTransformOverRegularGrid(
+              grid_output_dimensions, grid_cell_shape, transform, func));
+    } else {
+      TENSORSTORE_CHECK_OK(
+          tensorstore::internal::PartitionIndexTransformOverGrid(
+              grid_output_dimensions, grid, transform, func));
+    }
+  }
+  state.SetItemsProcessed(num_cells);
+}
+
+BENCHMARK(BM_PartitionStrided<kRegular>)->Arg(1)->Arg(2);
+BENCHMARK(BM_PartitionStrided<kGeneric>)->Arg(1)->Arg(2);
+
+// Partitions `num_points` random points, specified by a pair of index arrays,
+// over a grid with a cell shape of `{64, 64}` covering 1024x1024 cells.
+void BM_PartitionIndexArrayPoints(benchmark::State& state) {
+  const Index num_points = state.range(0);
+  constexpr Index kCellSize = 64;
+  constexpr Index kExtent = 1024 * kCellSize;
+  std::minstd_rand gen(0);
+  std::uniform_int_distribution<Index> dist(0, kExtent - 1);
+  auto x = tensorstore::AllocateArray<Index>({num_points});
+  auto y = tensorstore::AllocateArray<Index>({num_points});
+  for (Index i = 0; i < num_points; ++i) {
+    x(i) = dist(gen);
+    y(i) = dist(gen);
+  }
+  auto transform = IndexTransformBuilder<>(1, 2)
+                       .input_origin({0})
+                       .input_shape({num_points})
+                       .output_index_array(0, 0, 1, x)
+                       .output_index_array(1, 0, 1, y)
+                       .Finalize()
+                       .value();
+  const std::vector<DimensionIndex> grid_output_dimensions{0, 1};
+  const std::vector<Index> grid_cell_shape{kCellSize, kCellSize};
+  for (auto s : state) {
+    TENSORSTORE_CHECK_OK(
+        tensorstore::internal::PartitionIndexTransformOverRegularGrid(
+            grid_output_dimensions, grid_cell_shape, transform,
+            [&](span<const Index> grid_cell_indices,
+                IndexTransformView<> cell_transform) {
+              benchmark::DoNotOptimize(grid_cell_indices.data());
+              return absl::OkStatus();
+            }));
+  }
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+BENCHMARK(BM_PartitionIndexArrayPoints)->Arg(1000)->Arg(1000000);
+
+}  // namespace
@@ -17,14 +17,14 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
-#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "tensorstore/array.h"
 #include "tensorstore/box.h"
@@ -520,30 +520,11 @@ Result<std::vector<Index>> GenerateIndexArraySetGridCellIndices(
   return temp_cell_indices;
 }
 
-/// Checks if two offsets into a cell indices array refer to the same cell
-/// indices.
+/// Compares two offsets into a cell indices array lexicographically by the
+/// index vectors to which they refer.
 ///
-/// Serves as the equality function for the `IndirectVectorMap` hash map type.
-struct IndirectIndicesEqual {
-  /// Pointer to the row-major array of shape `{num_vectors,num_dims}`
-  /// specifying the index vectors.
-  const Index* index_vectors;
-
-  /// Dimensionality (number of components) of the vectors.
-  DimensionIndex num_dims;
-
-  bool operator()(Index a, Index b) const {
-    return std::equal(index_vectors + a * num_dims,
-                      index_vectors + a * num_dims + num_dims,
-                      index_vectors + b * num_dims);
-  }
-};
-
-/// Same as `IndirectIndicesEqual`, but compares the index vectors
-/// lexicographically.
-///
-/// This is used by PartitionIndexArraySetGridCellIndexVectors to sort grid cell
-/// index vectors.
+/// This is used by `SortPositionsByGridCell` to sort small numbers of grid
+/// cell index vectors.
 struct IndirectIndicesLess {
   const Index* index_vectors;
   DimensionIndex num_dims;
@@ -554,48 +535,81 @@ struct IndirectIndicesLess {
   }
 };
 
-/// Computes a hash code for an offset into an array of index vectors based on
-/// the index vector.
+/// Computes the permutation of positions that stably sorts an array
+/// `temp_cell_indices` of non-unique partial grid cell index vectors
+/// lexicographically.
 ///
-/// This is consistent with the `IndirectIndicesEqual` function, and serves as
-/// the hash function for the `IndirectVectorMap` hash map type.
-struct IndirectHashIndices {
-  const Index* index_vectors;
-  DimensionIndex num_dims;
-
-  size_t operator()(Index x) const {
-    return absl::Hash<HashHelper>()(HashHelper{index_vectors, num_dims, x});
+/// Large arrays, such as those due to index arrays specifying many points, are
+/// sorted with a least-significant-digit radix sort over the grid cell indices
+/// relative to their minimum value, which requires a small number of linear
+/// passes per grid dimension (one per 11 bits of the range of cell indices).
+///
+/// \param temp_cell_indices Non-null pointer to row-major array of shape
+///     `{num_positions, num_grid_dims}` specifying partial grid cell index
+///     vectors, which may be non-unique and ordered arbitrarily.
+/// \param num_positions First dimension of the `temp_cell_indices` array.
+/// \param num_grid_dims Number of dimensions in the partial grid cell index
+///     vectors.
+/// \returns The positions in `[0, num_positions)`, ordered by their partial
+///     grid cell index vectors, and by position for equal vectors.
+std::vector<Index> SortPositionsByGridCell(const Index* temp_cell_indices,
+                                           Index num_positions,
+                                           DimensionIndex num_grid_dims) {
+  std::vector<Index> order(num_positions);
+  std::iota(order.begin(), order.end(), Index(0));
+  constexpr Index kMinRadixSortPositions = 1024;
+  if (num_positions < kMinRadixSortPositions) {
+    std::stable_sort(order.begin(), order.end(),
+                     IndirectIndicesLess{temp_cell_indices, num_grid_dims});
+    return order;
   }
-
- private:
-  // Helper type that combines the fields of a IndirectHashIndices object with
-  // the Index being hashed.
-  //
-  // This wrapper type is needed to workaround the fact that the Abseil hash
-  // framework only supports stateless hash functions.
-  struct HashHelper {
-    const Index* index_vectors;
-    DimensionIndex num_dims;
-    Index index;
-
-    template <typename H>
-    friend H AbslHashValue(H h, HashHelper x) {
-      return H::combine_contiguous(
-          std::move(h), x.index_vectors + x.index * x.num_dims, x.num_dims);
+  constexpr int kRadixBits = 11;
+  constexpr size_t kNumBuckets = size_t(1) << kRadixBits;
+  std::vector<Index> sorted(num_positions);
+  std::vector<Index> bucket_offsets(kNumBuckets);
+  // Sort by each grid dimension in turn, starting from the last, relying on
+  // each pass being stable.
+  for (DimensionIndex grid_i = num_grid_dims; grid_i-- > 0;) {
+    const Index* cell_indices = temp_cell_indices + grid_i;
+    const auto cell_index = [&](Index position) {
+      return cell_indices[position * num_grid_dims];
+    };
+    Index min_cell_index = cell_index(0), max_cell_index = min_cell_index;
+    for (Index position = 1; position < num_positions; ++position) {
+      min_cell_index = std::min(min_cell_index, cell_index(position));
+      max_cell_index = std::max(max_cell_index, cell_index(position));
     }
-  };
-};
-
-using IndirectVectorMap = absl::flat_hash_map<Index, Index, IndirectHashIndices,
-                                              IndirectIndicesEqual>;
+    const uint64_t range = static_cast<uint64_t>(max_cell_index) -
+                           static_cast<uint64_t>(min_cell_index);
+    for (int shift = 0; shift < 64 && (range >> shift) != 0;
+         shift += kRadixBits) {
+      const auto digit = [&](Index position) {
+        return static_cast<size_t>(
+                   (static_cast<uint64_t>(cell_index(position)) -
+                    static_cast<uint64_t>(min_cell_index)) >>
+                   shift) &
+               (kNumBuckets - 1);
+      };
+      std::fill(bucket_offsets.begin(), bucket_offsets.end(), Index(0));
+      for (const Index position : order) ++bucket_offsets[digit(position)];
+      Index offset = 0;
+      for (Index& bucket_offset : bucket_offsets) {
+        const Index count = bucket_offset;
+        bucket_offset = offset;
+        offset += count;
+      }
+      for (const Index position : order) {
+        sorted[bucket_offsets[digit(position)]++] = position;
+      }
+      order.swap(sorted);
+    }
+  }
+  return order;
+}
 
 /// Given an array `temp_cell_indices` of non-unique partial grid cell index
-/// vectors, implicitly computes a sorted version of this array (possibly
-/// containing duplicates), where the index vectors are ordered
-/// lexicographically.  For each distinct grid cell index vector in the sorted
-/// array, copies the index vector to `grid_cell_indices` and stores at the
-/// corresponding position in `grid_cell_partition_offsets` the offset of the
-/// first occurrence of that index vector in the sorted array.
+/// vectors, computes the distinct index vectors in lexicographical order and
+/// the offset of the first occurrence of each in the sorted array.
 ///
 /// \param temp_cell_indices Non-null pointer to row-major array of shape
 ///     `{num_positions, num_grid_dims}` specifying partial grid cell index
@@ -606,106 +620,60 @@ using IndirectVectorMap = absl::flat_hash_map<Index, Index, IndirectHashIndices,
 /// \param grid_cell_indices[out] Non-null pointer to vector to be filled with
 ///     the row-major array of shape `{num_partitions, num_grid_dims}`
 ///     specifying the distinct partial grid cell index vectors in
-///     `temp_cell_indices`, ordered lexicographically.  The vector is resized
-///     to the correct size, and any existing contents are overwritten.
+///     `temp_cell_indices`, ordered lexicographically.  Any existing contents
+///     are overwritten.
 /// \param grid_cell_partition_offsets[out] Non-null pointer to vector to be
-///     resized to a length of `num_partitions`, where
-///     `(*grid_cell_partition_offsets)[partition_i]` will be set to the offset
-///     of the first occurrence in the sorted array of the partial grid cell
-///     index vector
-///     `span(grid_cell_indices->data() + i * num_grid_dims, num_grid_dims)`.
-/// \returns An IndirectVectorMap that maps each position `position_i` in the
-///     range `[0,num_positions)`, representing the grid cell index vector
-///     `span(temp_celll_indices + position_i * num_grid_dims, num_grid_dims)`,
-///     to the offset in the sorted array of the first occurrence of that index
-///     vector.  All positions that correspond to equivalent partial grid cell
-///     index vectors map to the same slot in the hash table.  Note that these
-///     offsets are also stored in `*grid_cell_partition_offsets`, but there
-///     they are indexed by the sorted order of the unique index vectors in the
-///     `grid_cell_indices` array, not the original order.  The returned hash
-///     map references the `temp_cell_indices` array, which must remain valid as
-///     long as the hash map is used.
-/// \remark The sorted version of `temp_cell_indices` (possibly containing
-///     duplicates) is never explicitly computed.  Instead, an IndirectVectorMap
-///     is used to determine the set of unique index vectors and the number of
-///     occurrences of each.
-IndirectVectorMap PartitionIndexArraySetGridCellIndexVectors(
+///     filled with the `num_partitions` offsets in the sorted array of the
+///     first occurrence of each vector in `*grid_cell_indices`.
+/// \returns A vector of length `num_positions` that maps each position
+///     `position_i`, representing the grid cell index vector
+///     `span(temp_cell_indices + position_i * num_grid_dims, num_grid_dims)`,
+///     to its offset in the sorted array.  Positions with equal index vectors
+///     retain their relative order.
+std::vector<Index> PartitionIndexArraySetGridCellIndexVectors(
     const Index* temp_cell_indices, Index num_positions, Index num_grid_dims,
     std::vector<Index>* grid_cell_indices,
     std::vector<Index>* grid_cell_partition_offsets) {
-  /// Initialize an empty hash map keyed by positions `position_i` in the range
-  /// `[0,num_positions)`, corresponding to a vector:
-  /// `span(temp_cell_indices + grid_dims * position_i, num_dims)`.  Two
-  /// distinct positions that correspond to equivalent vectors map to the same
-  /// slot in the hash map.
-  IndirectVectorMap cells(
-      1, IndirectHashIndices{temp_cell_indices, num_grid_dims},
-      IndirectIndicesEqual{temp_cell_indices, num_grid_dims});
-  // Compute the number of occurrences of each partial grid cell index vector.
-  for (DimensionIndex i = 0; i < num_positions; ++i) {
-    ++cells[i];
-  }
-
-  // The total number of distinct partial grid cell index vectors is the number
-  // of partitions.
-  grid_cell_indices->resize(num_grid_dims * cells.size());
-  grid_cell_partition_offsets->resize(cells.size());
-
-  // Sort the partial grid cell index vectors lexicographically in order to
-  // ensure a deterministic result, using `grid_cell_partition_offsets` as a
-  // temporary array.  Note that `cells` is keyed by the
-  // range`[0,num_positions)` but `cells.size()` is in general much smaller than
-  // `num_positions`, as many positions may correspond to the same partial grid
-  // cell.
-  std::transform(cells.begin(), cells.end(),
-                 grid_cell_partition_offsets->begin(),
-                 [](IndirectVectorMap::const_reference x) { return x.first; });
-  std::sort(grid_cell_partition_offsets->begin(),
-            grid_cell_partition_offsets->end(),
-            IndirectIndicesLess{temp_cell_indices, num_grid_dims});
-
-  // Update the values stored in `cells`, as well as
-  // grid_cell_partition_offsets, to contain the offsets into
-  // partitioned_input_indices, and fill grid_cell_indices.  The `cells` hash
-  // map will be used to group by partition the input indices to be computed.
-  {
-    Index offset = 0;
-    Index* grid_cell_indices_ptr = grid_cell_indices->data();
-    for (Index& position_i_or_offset : *grid_cell_partition_offsets) {
-      const Index position_i = position_i_or_offset;
-      auto it = cells.find(position_i);
-      assert(it != cells.end());
-      auto& count_or_offset = it->second;
-      const Index count = count_or_offset;
-      position_i_or_offset = count_or_offset = offset;
-      offset += count;
-      grid_cell_indices_ptr =
-          std::copy_n(temp_cell_indices + position_i * num_grid_dims,
-                      num_grid_dims, grid_cell_indices_ptr);
+  std::vector<Index> order =
+      SortPositionsByGridCell(temp_cell_indices, num_positions, num_grid_dims);
+  grid_cell_indices->clear();
+  grid_cell_partition_offsets->clear();
+  const Index* prev_cell = nullptr;
+  for (Index offset = 0; offset < num_positions; ++offset) {
+    const Index* cell = temp_cell_indices + order[offset] * num_grid_dims;
+    if (!prev_cell || !std::equal(cell, cell + num_grid_dims, prev_cell)) {
+      grid_cell_partition_offsets->push_back(offset);
+      grid_cell_indices->insert(grid_cell_indices->end(), cell,
+                                cell + num_grid_dims);
     }
+    prev_cell = cell;
   }
-
-  return cells;
+  // Invert the permutation to obtain the offset of each position.
+  std::vector<Index> sorted_offsets(num_positions);
+  for (Index offset = 0; offset < num_positions; ++offset) {
+    sorted_offsets[order[offset]] = offset;
+  }
+  return sorted_offsets;
 }
 
 /// Computes the partial input index vectors within the domain subset of
 /// `full_input_domain` specified by `input_dims`, and writes them to an array
-/// in a partitioned way according to the `cells` map.
+/// in a partitioned way according to `sorted_offsets`.
 ///
 /// \param input_dims The list of distinct input dimensions in the subset, each
 ///     in the range `[0, full_input_domain.rank())`.
 /// \param full_input_domain The full input domain.  Only values at indices in
 ///     `input_dims` are used.
-/// \param cells An IndirectVectorMap that maps each partial grid cell,
-///     identified by a flat input position index, to the starting offset in the
-///     output array at which to write the partial input index vectors.
+/// \param sorted_offsets Array of length `num_positions` that maps each flat
+///     input position index to the offset in the output array at which to
+///     write the partial input index vector.
 /// \param num_positions The product of `input_shape[d]` for `d` in
 ///     `input_dims`.
 /// \returns A newly allocated array of shape
 ///     `{num_positions, input_dims.count()}` containing the
 SharedArray<Index, 2> GenerateIndexArraySetPartitionedInputIndices(
     DimensionSet input_dims, BoxView<> full_input_domain,
-    IndirectVectorMap cells, Index num_positions) {
+    span<const Index> sorted_offsets, Index num_positions) {
   const DimensionIndex num_input_dims = input_dims.count();
   Box<dynamic_rank(internal::kNumInlinedDims)> partial_input_domain(
       num_input_dims);
@@ -721,12 +689,9 @@ SharedArray<Index, 2> GenerateIndexArraySetPartitionedInputIndices(
   // Flat position index.
   Index position_i = 0;
   IterateOverIndexRange(partial_input_domain, [&](span<const Index> indices) {
-    auto it = cells.find(position_i);
-    assert(it != cells.end());
-    auto& offset = it->second;
     std::copy(indices.begin(), indices.end(),
-              partitioned_input_indices.data() + offset * num_input_dims);
-    ++offset;
+              partitioned_input_indices.data() +
+                  sorted_offsets[position_i] * num_input_dims);
     ++position_i;
   });
   return partitioned_input_indices;
@@ -792,23 +757,23 @@ absl::Status FillIndexArraySetData(
   // distinct index vectors in `temp_cell_indices`, and
   // `index_array_set.grid_cell_partition_offsets`, which specifies the
   // corresponding offsets, for each of those distinct index vectors, into the
-  // `partitioned_input_indices` array that will be generated.  Also compute a
-  // map `cells` that is used to partition the partial input index vectors
-  // corresponding to each partial grid cell index vector in
-  // `temp_cell_indices`.
-  IndirectVectorMap cells = PartitionIndexArraySetGridCellIndexVectors(
-      temp_cell_indices.data(), num_positions,
-      index_array_set.grid_dimensions.count(),
-      &index_array_set.grid_cell_indices,
-      &index_array_set.grid_cell_partition_offsets);
+  // `partitioned_input_indices` array that will be generated.  Also compute
+  // the offset `sorted_offsets` into that array for each position, which is
+  // used to partition the partial input index vectors.
+  std::vector<Index> sorted_offsets =
+      PartitionIndexArraySetGridCellIndexVectors(
+          temp_cell_indices.data(), num_positions,
+          index_array_set.grid_dimensions.count(),
+          &index_array_set.grid_cell_indices,
+          &index_array_set.grid_cell_partition_offsets);
 
   // Compute the partial input index vectors corresponding to each partial grid
   // cell index vector in `temp_cell_indices`, and directly write them
-  // partitioned by grid cell using the `cells` map.
+  // partitioned by grid cell using `sorted_offsets`.
   index_array_set.partitioned_input_indices =
       GenerateIndexArraySetPartitionedInputIndices(
           index_array_set.input_dimensions, index_transform.domain().box(),
-          std::move(cells), num_positions);
+          sorted_offsets, num_positions);
   return absl::OkStatus();
 }
 
@@ -32,6 +32,8 @@
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 namespace {
 using ::tensorstore::Box;
@@ -757,6 +759,101 @@ TEST(PartitionIndexTransformOverIrregularGrid, IndexArrayAndStridedDimensions) {
                   ));
 }
 
+// Tests that the closed-form computation used for regular grids matches the
+// generic computation.
+TEST(PartitionIndexTransformOverRegularGrid, StridedMatchesGeneric) {
+  const std::vector<DimensionIndex> grid_output_dimensions{0, 1};
+  const std::vector<Index> grid_cell_shape{3, 5};
+  RegularGridRef grid{grid_cell_shape};
+  for (const Index stride : {1, -1, 2, -3, 7}) {
+    for (const Index offset : {-11, 0, 4}) {
+      auto transform = IndexTransformBuilder<>(2, 2)
+                           .input_origin({-4, 2})
+                           .input_shape({13, 9})
+                           .output_single_input_dimension(0, offset, stride, 0)
+                           .output_single_input_dimension(1, -offset, 2, 1)
+                           .Finalize()
+                           .value();
+      SCOPED_TRACE(tensorstore::StrCat("transform=", transform));
+      std::vector<R> generic_results;
+      TENSORSTORE_ASSERT_OK(
+          tensorstore::internal::PartitionIndexTransformOverGrid(
+              grid_output_dimensions, grid, transform,
+              [&](span<const Index> grid_cell_indices,
+                  IndexTransformView<> cell_transform) {
+                generic_results.emplace_back(
+                    std::vector<Index>(grid_cell_indices.begin(),
+                                       grid_cell_indices.end()),
+                    IndexTransform<>(cell_transform));
+                return absl::OkStatus();
+              }));
+      EXPECT_EQ(generic_results, GetPartitions(grid_output_dimensions,
+                                               grid_cell_shape, transform));
+    }
+  }
+}
+
+/// Returns the list of partitions generated by `plan.Partition(transform)`.
+std::vector<R> GetPlanPartitions(
+    const tensorstore::internal::RegularGridPartitionPlan& plan,
+    IndexTransformView<> transform) {
+  std::vector<R> results;
+  TENSORSTORE_CHECK_OK(plan.Partition(
+      transform, [&](span<const Index> grid_cell_indices,
+                     IndexTransformView<> cell_transform) {
+        results.emplace_back(std::vector<Index>(grid_cell_indices.begin(),
+                                                grid_cell_indices.end()),
+                             IndexTransform<>(cell_transform));
+        return absl::OkStatus();
+      }));
+  return results;
+}
+
+TEST(RegularGridPartitionPlan, Reuse) {
+  const auto index_array =
+      MakeArray<Index>({{1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}});
+  const auto make_transform = [&](Index array_offset, Index strided_offset,
+                                  Index input_size = 10) {
+    return IndexTransformBuilder<>(2, 2)
+        .input_origin({100, 0})
+        .input_shape({8, input_size})
+        .output_index_array(0, array_offset, 1, index_array)
+        .output_single_input_dimension(1, strided_offset, 1, 1)
+        .Finalize()
+        .value();
+  };
+  const std::vector<DimensionIndex> grid_output_dimensions{0, 1};
+  const std::vector<Index> grid_cell_shape{3, 4};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto plan, tensorstore::internal::RegularGridPartitionPlan::Make(
+                     grid_output_dimensions, grid_cell_shape,
+                     make_transform(0, 0)));
+  EXPECT_EQ(make_transform(0, 0), plan.transform());
+
+  for (const auto& transform :
+       {make_transform(0, 0), make_transform(6, 5), make_transform(-3, -1)}) {
+    SCOPED_TRACE(tensorstore::StrCat("transform=", transform));
+    EXPECT_TRUE(plan.CanReuse(transform));
+    EXPECT_EQ(
+        GetPartitions(grid_output_dimensions, grid_cell_shape, transform),
+        GetPlanPartitions(plan, transform));
+  }
+
+  // Partitioned from scratch, since the index array offset is not a multiple
+  // of the grid cell size, or the domain differs.
+  for (const auto& transform :
+       {make_transform(4, 0), make_transform(0, 0, /*input_size=*/11)}) {
+    SCOPED_TRACE(tensorstore::StrCat("transform=", transform));
+    EXPECT_FALSE(plan.CanReuse(transform));
+    EXPECT_EQ(
+        GetPartitions(grid_output_dimensions, grid_cell_shape, transform),
+        GetPlanPartitions(plan, transform));
+  }
+
+  EXPECT_FALSE(tensorstore::internal::RegularGridPartitionPlan().CanReuse(
+      make_transform(0, 0)));
+}
+
 }  // namespace partition_tests
 
 namespace get_grid_cell_ranges_tests {
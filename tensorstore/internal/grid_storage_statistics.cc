@@ -14,6 +14,7 @@
 
 #include "tensorstore/internal/grid_storage_statistics.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <atomic>
@@ -24,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/time/time.h"
@@ -32,6 +34,7 @@
 #include "tensorstore/index.h"
 #include "tensorstore/index_interval.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
 #include "tensorstore/internal/grid_chunk_key_ranges.h"
 #include "tensorstore/internal/grid_chunk_key_ranges_base10.h"
 #include "tensorstore/internal/grid_partition_impl.h"
@@ -63,6 +66,10 @@ namespace {
 
 using ::tensorstore::kvstore::ListEntry;
 
+// Maximum number of partitions of each key range that are listed
+// concurrently, by kvstore drivers which support it.
+constexpr size_t kListConcurrency = 32;
+
 template <typename T>
 struct MovableAtomic : public std::atomic<T> {
   using std::atomic<T>::atomic;
@@ -111,6 +118,126 @@ struct ListReceiver {
   }
 };
 
+// Partitions `handler.full_transform` over the grid, and invokes
+// `handle_key` or `handle_key_range` for the chunks it intersects.
+absl::Status ForEachChunkKeyOrKeyRange(
+    GridStorageStatisticsChunkHandler& handler, BoxView<> grid_bounds,
+    absl::FunctionRef<absl::Status(std::string key,
+                                   span<const Index> grid_indices)>
+        handle_key,
+    absl::FunctionRef<absl::Status(KeyRange key_range, BoxView<> grid_bounds)>
+        handle_key_range) {
+  internal_grid_partition::RegularGridRef output_to_grid_cell{
+      handler.chunk_shape};
+  TENSORSTORE_RETURN_IF_ERROR(
+      internal_grid_partition::PrePartitionIndexTransformOverGrid(
+          handler.full_transform, handler.grid_output_dimensions,
+          output_to_grid_cell, handler.grid_partition));
+  return internal::GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
+      handler.grid_partition, handler.full_transform,
+      handler.grid_output_dimensions, output_to_grid_cell, grid_bounds,
+      *handler.key_formatter, handle_key, handle_key_range);
+}
+
+// Lists the chunks within the grid bounds in order to refresh a
+// `ChunkPresenceSummary`.
+struct ChunkPresenceRefreshHandler : public GridStorageStatisticsChunkHandler {
+  std::shared_ptr<ChunkPresenceSummary> summary;
+  uint64_t refresh_id;
+  std::vector<DimensionIndex> grid_dimensions;
+
+  // Keeps the `chunk_shape` and `key_formatter` referenced by this handler
+  // alive.
+  internal::IntrusivePtr<GridStorageStatisticsChunkHandler> query_handler;
+
+  void ChunkPresent(span<const Index> grid_indices) override {
+    summary->RefreshPresent(refresh_id, grid_indices);
+  }
+};
+
+void RefreshChunkPresenceSummary(
+    internal::IntrusivePtr<GridStorageStatisticsChunkHandler> query_handler,
+    const KvStore& kvs, BoxView<> grid_bounds, absl::Time staleness_bound,
+    uint64_t refresh_id) {
+  auto handler = internal::MakeIntrusivePtr<ChunkPresenceRefreshHandler>();
+  handler->summary = query_handler->chunk_presence;
+  handler->refresh_id = refresh_id;
+  const DimensionIndex rank = grid_bounds.rank();
+  handler->grid_dimensions.resize(rank);
+  Box<dynamic_rank(kMaxRank)> domain(rank);
+  for (DimensionIndex i = 0; i < rank; ++i) {
+    handler->grid_dimensions[i] = i;
+    const Index size = query_handler->chunk_shape[i];
+    domain[i] = IndexInterval::UncheckedSized(grid_bounds.origin()[i] * size,
+                                              grid_bounds.shape()[i] * size);
+  }
+  handler->full_transform = IdentityTransform(domain);
+  handler->grid_output_dimensions = handler->grid_dimensions;
+  handler->chunk_shape = query_handler->chunk_shape;
+  handler->key_formatter = query_handler->key_formatter;
+  handler->query_handler = std::move(query_handler);
+
+  // Since `ChunkPresent` does not count chunks as present, requesting only
+  // `query_not_stored` ensures that the listing never stops early.
+  Future<ArrayStorageStatistics> future;
+  GetArrayStorageStatisticsOptions options;
+  options.mask = ArrayStorageStatistics::query_not_stored;
+  handler->state =
+      internal::MakeIntrusivePtr<GetStorageStatisticsAsyncOperationState>(
+          future, options);
+  future.ExecuteWhenReady(
+      [summary = handler->summary,
+       refresh_id](ReadyFuture<ArrayStorageStatistics> future) {
+        summary->FinishRefresh(refresh_id, future.status());
+      });
+  internal::GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
+      std::move(handler), kvs, grid_bounds, staleness_bound);
+}
+
+// Computes the statistics from `handler->chunk_presence`, once it has been
+// refreshed.
+void GetStorageStatisticsFromSummary(
+    internal::IntrusivePtr<GridStorageStatisticsChunkHandler> handler,
+    BoxView<> grid_bounds) {
+  const ChunkPresenceSummary& summary = *handler->chunk_presence;
+  auto& state = *handler->state;
+  int64_t total_chunks = 0;
+  const auto handle_key = [&](std::string key,
+                              span<const Index> grid_indices) -> absl::Status {
+    if (internal::AddOverflow<Index>(total_chunks, 1, &total_chunks)) {
+      return absl::OutOfRangeError(
+          "Integer overflow computing number of chunks");
+    }
+    if (summary.IsPresent(grid_indices)) {
+      state.AddChunksPresent(1);
+    } else {
+      state.ChunkMissing();
+    }
+    return absl::OkStatus();
+  };
+  const auto handle_key_range = [&](KeyRange key_range,
+                                    BoxView<> grid_bounds) -> absl::Status {
+    const Index cur_total_chunks = grid_bounds.num_elements();
+    if (cur_total_chunks == std::numeric_limits<Index>::max()) {
+      return absl::OutOfRangeError(tensorstore::StrCat(
+          "Integer overflow computing number of chunks in ", grid_bounds));
+    }
+    if (internal::AddOverflow(total_chunks, cur_total_chunks, &total_chunks)) {
+      return absl::OutOfRangeError(
+          "Integer overflow computing number of chunks");
+    }
+    const Index present = summary.CountPresent(grid_bounds);
+    state.AddChunksPresent(present);
+    if (present != cur_total_chunks) state.ChunkMissing();
+    return absl::OkStatus();
+  };
+  TENSORSTORE_RETURN_IF_ERROR(
+      ForEachChunkKeyOrKeyRange(*handler, grid_bounds, handle_key,
+                                handle_key_range),
+      state.SetError(_));
+  state.total_chunks += total_chunks;
+}
+
 }  // namespace
 
 GridStorageStatisticsChunkHandler::~GridStorageStatisticsChunkHandler() =
@@ -127,8 +254,8 @@ GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
     span<const DimensionIndex> grid_output_dimensions,
     span<const Index> chunk_shape, BoxView<> grid_bounds,
     std::unique_ptr<const LexicographicalGridIndexKeyParser> key_formatter,
-    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options) {
-  // TODO(jbms): integrate this with the chunk cache
+    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options,
+    std::shared_ptr<ChunkPresenceSummary> chunk_presence) {
 
   struct Handler : public GridStorageStatisticsChunkHandler {
     std::unique_ptr<const LexicographicalGridIndexKeyParser> key_formatter_ptr;
@@ -145,6 +272,7 @@ GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
   handler->chunk_shape = chunk_shape;
   handler->key_formatter_ptr = std::move(key_formatter);
   handler->key_formatter = handler->key_formatter_ptr.get();
+  handler->chunk_presence = std::move(chunk_presence);
 
   // This function calls
   // `GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys` to compute the
@@ -163,7 +291,24 @@ GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
 void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
     internal::IntrusivePtr<GridStorageStatisticsChunkHandler> handler,
     const KvStore& kvs, BoxView<> grid_bounds, absl::Time staleness_bound) {
-  // TODO(jbms): integrate this with the chunk cache
+  if (handler->chunk_presence) {
+    uint64_t refresh_id;
+    auto refreshed = handler->chunk_presence->Refresh(
+        grid_bounds, staleness_bound, refresh_id);
+    if (refresh_id != 0) {
+      RefreshChunkPresenceSummary(handler, kvs, grid_bounds, staleness_bound,
+                                  refresh_id);
+    }
+    auto& promise = handler->state->promise;
+    LinkValue(
+        [handler = std::move(handler), grid_bounds = Box<>(grid_bounds)](
+            Promise<ArrayStorageStatistics> promise,
+            ReadyFuture<const void> future) mutable {
+          GetStorageStatisticsFromSummary(std::move(handler), grid_bounds);
+        },
+        promise, std::move(refreshed));
+    return;
+  }
 
   // This function calls
   // `GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys` to compute the
@@ -175,9 +320,21 @@ void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
 
   int64_t total_chunks = 0;
 
+  // Once the result is known (see
+  // `GetStorageStatisticsAsyncOperationState::MaybeStopEarly`), for example
+  // because a single present chunk answers a `query_not_stored` request, no
+  // further read or list operations are issued.
+  bool stopped_early = false;
+  const auto maybe_stop_early = [&] {
+    if (handler->state->promise.result_needed()) return false;
+    stopped_early = true;
+    return true;
+  };
+
   const auto handle_key = [&](std::string key, span<const Index> grid_indices) {
     ABSL_LOG_IF(INFO, TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_DEBUG)
         << "key: " << tensorstore::QuoteString(key);
+    if (maybe_stop_early()) return absl::CancelledError();
     if (internal::AddOverflow<Index>(total_chunks, 1, &total_chunks)) {
       return absl::OutOfRangeError(
           "Integer overflow computing number of chunks");
@@ -206,6 +363,7 @@ void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
                                     BoxView<> grid_bounds) -> absl::Status {
     ABSL_LOG_IF(INFO, TENSORSTORE_INTERNAL_GRID_STORAGE_STATISTICS_DEBUG)
         << "key_range: " << key_range << ", grid_bounds=" << grid_bounds;
+    if (maybe_stop_early()) return absl::CancelledError();
     Index cur_total_chunks = grid_bounds.num_elements();
     if (cur_total_chunks == std::numeric_limits<Index>::max()) {
       return absl::OutOfRangeError(tensorstore::StrCat(
@@ -218,26 +376,20 @@ void GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
     kvstore::ListOptions list_options;
     list_options.staleness_bound = staleness_bound;
     list_options.range = std::move(key_range);
+    // Chunks are counted in any order.
+    list_options.concurrency = kListConcurrency;
+    list_options.ordered = false;
     kvstore::List(kvs, std::move(list_options),
                   ListReceiver{handler, Box<>(grid_bounds)});
     return absl::OkStatus();
   };
 
-  internal_grid_partition::RegularGridRef output_to_grid_cell{
-      handler->chunk_shape};
-
-  TENSORSTORE_RETURN_IF_ERROR(
-      internal_grid_partition::PrePartitionIndexTransformOverGrid(
-          handler->full_transform, handler->grid_output_dimensions,
-          output_to_grid_cell, handler->grid_partition),
-      handler->state->SetError(_));
-
-  TENSORSTORE_RETURN_IF_ERROR(
-      internal::GetChunkKeyRangesForRegularGridWithSemiLexicographicalKeys(
-          handler->grid_partition, handler->full_transform,
-          handler->grid_output_dimensions, output_to_grid_cell, grid_bounds,
-          *handler->key_formatter, handle_key, handle_key_range),
-      handler->state->SetError(_));
+  auto status = ForEachChunkKeyOrKeyRange(*handler, grid_bounds, handle_key,
+                                          handle_key_range);
+  if (!status.ok() && !stopped_early) {
+    handler->state->SetError(std::move(status));
+    return;
+  }
 
   handler->state->total_chunks += total_chunks;
 }
@@ -247,7 +399,8 @@ Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithBase10Keys(
     span<const DimensionIndex> grid_output_dimensions,
     span<const Index> chunk_shape, span<const Index> shape,
     char dimension_separator, absl::Time staleness_bound,
-    GetArrayStorageStatisticsOptions options) {
+    GetArrayStorageStatisticsOptions options,
+    std::shared_ptr<ChunkPresenceSummary> chunk_presence) {
   const DimensionIndex rank = grid_output_dimensions.size();
   assert(rank == chunk_shape.size());
   assert(rank == shape.size());
@@ -260,7 +413,7 @@ Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithBase10Keys(
       kvs, transform, grid_output_dimensions, chunk_shape, grid_bounds,
       std::make_unique<Base10LexicographicalGridIndexKeyParser>(
           rank, dimension_separator),
-      staleness_bound, std::move(options));
+      staleness_bound, std::move(options), std::move(chunk_presence));
 }
 
 }  // namespace internal
@@ -22,6 +22,7 @@
 #include "tensorstore/box.h"
 #include "tensorstore/index.h"
 #include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/internal/cache/chunk_presence_summary.h"
 #include "tensorstore/internal/grid_chunk_key_ranges.h"
 #include "tensorstore/internal/grid_partition_impl.h"
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -53,13 +54,16 @@ namespace internal {
 //   key_formatter: Specifies the key format.
 //   staleness_bound: Staleness bound to use for kvstore operations.
 //   options: Specifies which statistics to compute.
+//   chunk_presence: Optional summary of the stored chunks, see
+//     `GridStorageStatisticsChunkHandler::chunk_presence`.
 Future<ArrayStorageStatistics>
 GetStorageStatisticsForRegularGridWithSemiLexicographicalKeys(
     const KvStore& kvs, IndexTransformView<> transform,
     span<const DimensionIndex> grid_output_dimensions,
     span<const Index> chunk_shape, BoxView<> grid_bounds,
     std::unique_ptr<const LexicographicalGridIndexKeyParser> key_formatter,
-    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options);
+    absl::Time staleness_bound, GetArrayStorageStatisticsOptions options,
+    std::shared_ptr<ChunkPresenceSummary> chunk_presence = nullptr);
 
 // Same as above, but uses `Base10LexicographicalGridIndexKeyParser` as the
 // `key_formatter`.
@@ -68,7 +72,8 @@ Future<ArrayStorageStatistics> GetStorageStatisticsForRegularGridWithBase10Keys(
     span<const DimensionIndex> grid_output_dimensions,
     span<const Index> chunk_shape, span<const Index> shape,
     char dimension_separator, absl::Time staleness_bound,
-    GetArrayStorageStatisticsOptions options);
+    GetArrayStorageStatisticsOptions options,
+    std::shared_ptr<ChunkPresenceSummary> chunk_presence = nullptr);
 
 struct GridStorageStatisticsChunkHandler
     : public internal::AtomicReferenceCount<GridStorageStatisticsChunkHandler> {
@@ -79,6 +84,13 @@ struct GridStorageStatisticsChunkHandler
   span<const Index> chunk_shape;
   const LexicographicalGridIndexKeyParser* key_formatter;
 
+  // Optional summary of the stored chunks, which must not be specified for
+  // transactional queries.  If specified, the statistics are computed from the
+  // summary, after first refreshing it by listing the chunks within the grid
+  // bounds if it is older than the staleness bound, and `ChunkPresent` is not
+  // called.
+  std::shared_ptr<ChunkPresenceSummary> chunk_presence;
+
   virtual void ChunkPresent(span<const Index> grid_indices);
 
   virtual ~GridStorageStatisticsChunkHandler();
@@ -150,6 +150,11 @@ class MockGrpcServer {
               (::grpc::ServerContext*, const request*,                    \
                ::grpc::ServerWriter<response>*))
 
+#define TENSORSTORE_GRPC_BIDI_STREAMING_MOCK(method, request, response) \
+  MOCK_METHOD(::grpc::Status, method,                                   \
+              (::grpc::ServerContext*,                                  \
+               (::grpc::ServerReaderWriter<response, request>*)))
+
 }  // namespace grpc_mocker
 }  // namespace tensorstore
 
@@ -0,0 +1,114 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_HEDGING_CONTEXT_RESOURCE_H_
+#define TENSORSTORE_INTERNAL_HEDGING_CONTEXT_RESOURCE_H_
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/request_hedger.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Specifies parameters for hedging slow requests.
+///
+/// Hedging is disabled unless `max_fraction` is greater than 0.  Drivers that
+/// share the resource also share the recorded latencies and hedging budget.
+template <typename Derived>
+struct HedgingResource : public ContextResourceTraits<Derived> {
+  constexpr static bool shared_when_decoded = true;
+  struct Spec {
+    double max_fraction = 0;
+    double latency_percentile = 0.95;
+    absl::Duration min_delay = absl::Milliseconds(10);
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.max_fraction, x.latency_percentile, x.min_delay);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    /// Null if hedging is disabled.
+    std::shared_ptr<RequestHedger> hedger;
+  };
+
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(
+        jb::Member(
+            "max_fraction",
+            jb::Projection(
+                &Spec::max_fraction,
+                jb::DefaultValue(
+                    [](auto* v) { *v = Derived::Default().max_fraction; },
+                    jb::Validate(
+                        [](const auto& options, double* x) {
+                          if (*x >= 0 && *x <= 1) return absl::OkStatus();
+                          return absl::InvalidArgumentError(
+                              "Expected value in the range [0, 1]");
+                        })))),
+        jb::Member(
+            "latency_percentile",
+            jb::Projection(
+                &Spec::latency_percentile,
+                jb::DefaultValue(
+                    [](auto* v) {
+                      *v = Derived::Default().latency_percentile;
+                    },
+                    jb::Validate(
+                        [](const auto& options, double* x) {
+                          if (*x > 0 && *x < 1) return absl::OkStatus();
+                          return absl::InvalidArgumentError(
+                              "Expected value in the range (0, 1)");
+                        })))),
+        jb::Member(
+            "min_delay",
+            jb::Projection(&Spec::min_delay, jb::DefaultValue([](auto* v) {
+                             *v = Derived::Default().min_delay;
+                           }))) /**/
+    );
+  }
+  static Result<Resource> Create(
+      const Spec& spec, internal::ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (spec.max_fraction > 0) {
+      RequestHedger::Options options;
+      options.max_fraction = spec.max_fraction;
+      options.latency_percentile = spec.latency_percentile;
+      options.min_delay = spec.min_delay;
+      resource.hedger = std::make_shared<RequestHedger>(options);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_HEDGING_CONTEXT_RESOURCE_H_
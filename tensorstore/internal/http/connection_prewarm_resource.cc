@@ -0,0 +1,44 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/http/connection_prewarm_resource.h"
+
+#include <string>
+#include <string_view>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+bool ConnectionPrewarmer::Prewarm(HttpTransport& transport,
+                                  std::string_view url) {
+  auto parsed = internal::ParseGenericUri(url);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!endpoints_.insert(tensorstore::StrCat(parsed.scheme, "://",
+                                               parsed.authority))
+             .second) {
+      return false;
+    }
+  }
+  transport.Prewarm(url, num_connections_);
+  return true;
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
@@ -0,0 +1,109 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_HTTP_CONNECTION_PREWARM_RESOURCE_H_
+#define TENSORSTORE_INTERNAL_HTTP_CONNECTION_PREWARM_RESOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Opens connections to each endpoint once, when the first key-value store
+/// for the endpoint is opened.
+///
+/// \threadsafety Thread safe.
+class ConnectionPrewarmer {
+ public:
+  explicit ConnectionPrewarmer(size_t num_connections)
+      : num_connections_(num_connections) {}
+
+  /// Calls `transport.Prewarm(url, num_connections)`, unless already called
+  /// for a URL with the same scheme and authority.
+  ///
+  /// \returns `true` if `transport.Prewarm` was called.
+  bool Prewarm(HttpTransport& transport, std::string_view url);
+
+ private:
+  size_t num_connections_;
+  absl::Mutex mutex_;
+  absl::flat_hash_set<std::string> endpoints_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Specifies the number of connections opened to an endpoint when a key-value
+/// store is opened, such that the first requests need not wait for the TCP
+/// and TLS handshakes.
+///
+/// Drivers that share the resource only pre-warm each endpoint once.
+template <typename Derived>
+struct ConnectionPrewarmResource
+    : public internal::ContextResourceTraits<Derived> {
+  constexpr static bool shared_when_decoded = true;
+  struct Spec {
+    int64_t connections = 0;
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.connections);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    /// Null if pre-warming is disabled.
+    std::shared_ptr<ConnectionPrewarmer> prewarmer;
+  };
+
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(jb::Member(
+        "connections",
+        jb::Projection(&Spec::connections,
+                       jb::DefaultValue(
+                           [](auto* v) { *v = Derived::Default().connections; },
+                           jb::Integer<int64_t>(0, 1024)))));
+  }
+  static Result<Resource> Create(
+      const Spec& spec, internal::ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (spec.connections > 0) {
+      resource.prewarmer =
+          std::make_shared<ConnectionPrewarmer>(spec.connections);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_HTTP_CONNECTION_PREWARM_RESOURCE_H_
@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/http/connection_prewarm_resource.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/http/mock_http_transport.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_http::ConnectionPrewarmer;
+using ::tensorstore::internal_http::ConnectionPrewarmResource;
+using ::tensorstore::internal_http::DefaultMockHttpTransport;
+using ::testing::ElementsAre;
+using ::testing::Field;
+
+struct TestConnectionPrewarm
+    : public ConnectionPrewarmResource<TestConnectionPrewarm> {
+  static constexpr char id[] = "test_connection_prewarm";
+};
+
+const tensorstore::internal::ContextResourceRegistration<TestConnectionPrewarm>
+    test_connection_prewarm_registration;
+
+TEST(ConnectionPrewarmResourceTest, Default) {
+  auto resource_spec = Context::Resource<TestConnectionPrewarm>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(nullptr, resource->prewarmer);
+  EXPECT_THAT(resource_spec.ToJson(),
+              IsOkAndHolds(::nlohmann::json(::nlohmann::json::object_t{})));
+}
+
+TEST(ConnectionPrewarmResourceTest, Enabled) {
+  ::nlohmann::json json{{"connections", 2}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<TestConnectionPrewarm>::FromJson(json));
+  EXPECT_THAT(resource_spec.ToJson(), IsOkAndHolds(json));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  ASSERT_NE(nullptr, resource->prewarmer);
+  EXPECT_EQ(2, resource->spec.connections);
+}
+
+TEST(ConnectionPrewarmResourceTest, Invalid) {
+  EXPECT_THAT(Context::Resource<TestConnectionPrewarm>::FromJson(
+                  {{"connections", -1}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ConnectionPrewarmerTest, PrewarmsEachEndpointOnce) {
+  DefaultMockHttpTransport transport({});
+  ConnectionPrewarmer prewarmer(2);
+  EXPECT_TRUE(prewarmer.Prewarm(transport, "https://example.com/a"));
+  EXPECT_FALSE(prewarmer.Prewarm(transport, "https://example.com/b"));
+  EXPECT_TRUE(prewarmer.Prewarm(transport, "https://example.org:8000/"));
+  EXPECT_THAT(
+      transport.requests(),
+      ElementsAre(
+          Field(&tensorstore::internal_http::HttpRequest::url,
+                "https://example.com/a"),
+          Field(&tensorstore::internal_http::HttpRequest::url,
+                "https://example.com/a"),
+          Field(&tensorstore::internal_http::HttpRequest::url,
+                "https://example.org:8000/"),
+          Field(&tensorstore::internal_http::HttpRequest::url,
+                "https://example.org:8000/")));
+  for (const auto& request : transport.requests()) {
+    EXPECT_EQ("HEAD", request.method);
+  }
+}
+
+}  // namespace
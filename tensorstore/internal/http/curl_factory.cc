@@ -60,6 +60,26 @@ ABSL_FLAG(std::optional<uint32_t>, tensorstore_http2_max_concurrent_streams,
           "Maximum concurrent streams for http2 connections. "
           "Overrides TENSORSTORE_HTTP2_MAX_CONCURRENT_STREAMS.");
 
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_curl_tcp_keepalive_seconds,
+          std::nullopt,
+          "Idle time before TCP keep-alive probes are sent, or 0 to disable. "
+          "Overrides TENSORSTORE_CURL_TCP_KEEPALIVE_SECONDS.");
+
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_curl_max_idle_connection_seconds,
+          std::nullopt,
+          "Maximum idle time of a cached connection before it is closed. "
+          "Overrides TENSORSTORE_CURL_MAX_IDLE_CONNECTION_SECONDS.");
+
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_curl_dns_cache_timeout_seconds,
+          std::nullopt,
+          "Lifetime of cached DNS entries. "
+          "Overrides TENSORSTORE_CURL_DNS_CACHE_TIMEOUT_SECONDS.");
+
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_curl_max_cached_connections,
+          std::nullopt,
+          "Maximum number of idle connections cached by each http thread. "
+          "Overrides TENSORSTORE_CURL_MAX_CACHED_CONNECTIONS.");
+
 namespace tensorstore {
 namespace internal_http {
 namespace {
@@ -127,6 +147,29 @@ struct CurlConfig {
   std::optional<std::string> ca_bundle =
       GetFlagOrEnvValue(FLAGS_tensorstore_ca_bundle, "TENSORSTORE_CA_BUNDLE");
   int32_t max_http2_concurrent_streams = GetMaxHttp2ConcurrentStreams();
+  // TCP keep-alive probes prevent load balancers and NAT gateways from
+  // dropping idle connections, which would otherwise need to be re-established
+  // with a full TCP and TLS handshake after a quiet period.
+  int64_t tcp_keepalive_seconds =
+      GetFlagOrEnvValue(FLAGS_tensorstore_curl_tcp_keepalive_seconds,
+                        "TENSORSTORE_CURL_TCP_KEEPALIVE_SECONDS")
+          .value_or(30);
+  // Defaults to the libcurl defaults if 0.
+  int64_t max_idle_connection_seconds =
+      GetFlagOrEnvValue(FLAGS_tensorstore_curl_max_idle_connection_seconds,
+                        "TENSORSTORE_CURL_MAX_IDLE_CONNECTION_SECONDS")
+          .value_or(0);
+  int64_t dns_cache_timeout_seconds =
+      GetFlagOrEnvValue(FLAGS_tensorstore_curl_dns_cache_timeout_seconds,
+                        "TENSORSTORE_CURL_DNS_CACHE_TIMEOUT_SECONDS")
+          .value_or(0);
+  // By default, libcurl limits the connection cache to 4 times the number of
+  // active transfers, which closes pre-warmed connections as soon as a loop
+  // becomes idle.
+  int64_t max_cached_connections =
+      GetFlagOrEnvValue(FLAGS_tensorstore_curl_max_cached_connections,
+                        "TENSORSTORE_CURL_MAX_CACHED_CONNECTIONS")
+          .value_or(64);
 };
 
 const CurlConfig& CurlEnvConfig() {
@@ -176,6 +219,27 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
                                                CURLOPT_LOW_SPEED_LIMIT, bytes));
     }
 
+    if (config.tcp_keepalive_seconds > 0) {
+      ABSL_CHECK_EQ(CURLE_OK,
+                    curl_easy_setopt(handle.get(), CURLOPT_TCP_KEEPALIVE, 1L));
+      ABSL_CHECK_EQ(CURLE_OK,
+                    curl_easy_setopt(handle.get(), CURLOPT_TCP_KEEPIDLE,
+                                     config.tcp_keepalive_seconds));
+      ABSL_CHECK_EQ(CURLE_OK,
+                    curl_easy_setopt(handle.get(), CURLOPT_TCP_KEEPINTVL,
+                                     config.tcp_keepalive_seconds));
+    }
+    if (config.max_idle_connection_seconds > 0) {
+      ABSL_CHECK_EQ(CURLE_OK,
+                    curl_easy_setopt(handle.get(), CURLOPT_MAXAGE_CONN,
+                                     config.max_idle_connection_seconds));
+    }
+    if (config.dns_cache_timeout_seconds > 0) {
+      ABSL_CHECK_EQ(CURLE_OK,
+                    curl_easy_setopt(handle.get(), CURLOPT_DNS_CACHE_TIMEOUT,
+                                     config.dns_cache_timeout_seconds));
+    }
+
     // Set ca_path or ca_bundle, if provided.
     if (config.ca_path || config.ca_bundle) {
       ABSL_CHECK_EQ(
@@ -210,6 +274,11 @@ class DefaultCurlHandleFactory : public CurlHandleFactory {
     ABSL_CHECK_EQ(CURLM_OK, curl_multi_setopt(
                                 handle.get(), CURLMOPT_MAX_CONCURRENT_STREAMS,
                                 config.max_http2_concurrent_streams));
+    if (config.max_cached_connections > 0) {
+      ABSL_CHECK_EQ(CURLM_OK,
+                    curl_multi_setopt(handle.get(), CURLMOPT_MAXCONNECTS,
+                                      config.max_cached_connections));
+    }
     return handle;
   }
 
@@ -33,6 +33,8 @@
 
 #include "absl/base/attributes.h"
 #include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/flags/flag.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -44,9 +46,11 @@
 #include "tensorstore/internal/container/circular_queue.h"
 #include "tensorstore/internal/cord_util.h"
 #include "tensorstore/internal/env.h"
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
 #include "tensorstore/internal/http/curl_factory.h"
 #include "tensorstore/internal/http/curl_handle.h"
 #include "tensorstore/internal/http/curl_wrappers.h"
+#include "tensorstore/internal/http/host_affinity.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_transport.h"
 #include "tensorstore/internal/metrics/counter.h"
@@ -54,6 +58,8 @@
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/internal/tracing/stage.h"
+#include "tensorstore/internal/uri_utils.h"
 
 ABSL_FLAG(std::optional<uint32_t>, tensorstore_http_threads, std::nullopt,
           "Threads to use for http requests. "
@@ -107,6 +113,13 @@ auto& http_total_time_ms =
         MetricMetadata("HTTP total latency (ms)",
                        internal_metrics::Units::kMilliseconds));
 
+auto& http_total_time_ms_by_version =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer,
+                                std::string>::New(
+        "/tensorstore/http/total_time_ms_by_version", "version",
+        MetricMetadata("HTTP total latency (ms) by negotiated HTTP version",
+                       internal_metrics::Units::kMilliseconds));
+
 auto& http_first_byte_latency_us =
     internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
         "/tensorstore/http/first_byte_latency_us",
@@ -119,12 +132,57 @@ auto& http_poll_time_ns =
         MetricMetadata("HTTP time spent in curl_multi_poll (ns)",
                        internal_metrics::Units::kNanoseconds));
 
+auto& http_loop_queue_depth = internal_metrics::Gauge<int64_t, int>::New(
+    "/tensorstore/http/loop_queue_depth", "loop",
+    MetricMetadata("HTTP requests waiting to be added to a curl multi loop"));
+
+auto& http_loop_active = internal_metrics::Gauge<int64_t, int>::New(
+    "/tensorstore/http/loop_active", "loop",
+    MetricMetadata("HTTP transfers active in a curl multi loop"));
+
+auto& http_connections_reused = internal_metrics::Counter<int64_t, int>::New(
+    "/tensorstore/http/connections_reused", "loop",
+    MetricMetadata("HTTP transfers which reused an existing connection"));
+
+auto& http_connections_created = internal_metrics::Counter<int64_t, int>::New(
+    "/tensorstore/http/connections_created", "loop",
+    MetricMetadata("HTTP connections created by transfers"));
+
+// Requests to a host are issued on the same curl multi loop, which keeps the
+// connections to that host in a single connection cache where they are reused
+// (and multiplexed, with HTTP/2).  Requests spill over to the least loaded loop
+// only once the host's loop has this many more transfers than it does.
+constexpr int64_t kMaxAffinityImbalance = 32;
+
+// Maximum number of hosts for which a loop assignment is retained.
+constexpr size_t kMaxAffinityHosts = 1024;
+
 uint32_t GetHttpThreads() {
   return std::max(1u, GetFlagOrEnvValue(FLAGS_tensorstore_http_threads,
                                         "TENSORSTORE_HTTP_THREADS")
                           .value_or(4u));
 }
 
+// Returns the label of the HTTP version negotiated by a completed transfer.
+std::string_view HttpVersionLabel(CurlHandle& handle) {
+  long version = CURL_HTTP_VERSION_NONE;  // NOLINT
+  handle.GetInfo(CURLINFO_HTTP_VERSION, &version);
+  switch (version) {
+    case CURL_HTTP_VERSION_1_0:
+      return "1.0";
+    case CURL_HTTP_VERSION_1_1:
+      return "1.1";
+    case CURL_HTTP_VERSION_2_0:
+      return "2";
+#ifdef CURL_VERSION_HTTP3
+    case CURL_HTTP_VERSION_3:
+      return "3";
+#endif
+    default:
+      return "unknown";
+  }
+}
+
 struct CurlRequestState {
   std::shared_ptr<CurlHandleFactory> factory_;
   CurlHandle handle_;
@@ -134,6 +192,10 @@ struct CurlRequestState {
   size_t payload_remaining_;
   HttpResponseHandler* response_handler_ = nullptr;
   size_t response_payload_size_ = 0;
+  // Accounts the request payload and the response body received so far as
+  // in-flight I/O until the request completes.
+  internal::MemoryReservation memory_{internal::MemoryCategory::kInFlightIo,
+                                      0};
   bool status_set = false;
   char error_buffer_[CURL_ERROR_SIZE];
 
@@ -170,6 +232,7 @@ struct CurlRequestState {
     handle_.SetOption(CURLOPT_HEADERDATA, nullptr);
     handle_.SetOption(CURLOPT_HEADERFUNCTION, nullptr);
     handle_.SetOption(CURLOPT_ERRORBUFFER, nullptr);
+    handle_.SetOption(CURLOPT_SHARE, nullptr);
     CurlHandle::Cleanup(*factory_, std::move(handle_));
   }
 
@@ -203,6 +266,7 @@ struct CurlRequestState {
 
     payload_ = std::move(options.payload);
     payload_remaining_ = payload_.size();
+    memory_.Grow(payload_.size());
     if (payload_remaining_ > 0) {
       payload_it_ = payload_.char_begin();
 
@@ -259,6 +323,17 @@ struct CurlRequestState {
         handle_.SetOption(CURLOPT_HTTP_VERSION,
                           CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
         break;
+      case IssueRequestOptions::HttpVersion::kHttp3:
+#ifdef CURL_VERSION_HTTP3
+        // CURL_HTTP_VERSION_3 falls back to earlier versions when the server
+        // does not support HTTP/3.
+        if (CurlSupportsHttp3()) {
+          handle_.SetOption(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_3);
+          break;
+        }
+#endif
+        handle_.SetOption(CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        break;
       default:
         break;
     }
@@ -302,6 +377,7 @@ struct CurlRequestState {
         std::string_view(static_cast<char const*>(contents), size * nmemb);
     if (self->MaybeSetStatusAndProcess()) {
       self->response_payload_size_ += data.size();
+      self->memory_.Grow(data.size());
       self->response_handler_->OnResponseBody(data);
     }
     return data.size();
@@ -347,10 +423,12 @@ class MultiTransportImpl {
   void EnqueueRequest(const HttpRequest& request, IssueRequestOptions options,
                       HttpResponseHandler* response_handler);
 
-  void FinishRequest(std::unique_ptr<CurlRequestState> state, CURLcode code);
+  void FinishRequest(std::unique_ptr<CurlRequestState> state, CURLcode code,
+                     int loop);
 
  private:
   struct ThreadData {
+    int index = 0;
     std::atomic<int64_t> count = 0;
     CurlMulti multi;
     absl::Mutex mutex;
@@ -364,9 +442,28 @@ class MultiTransportImpl {
   void MaybeAddPendingTransfers(ThreadData& thread_data);
   void RemoveCompletedTransfers(ThreadData& thread_data);
 
+  // Returns the index of the loop on which to issue a request to `host`.
+  size_t SelectThread(std::string_view host);
+
+  static void ShareLock(CURL* handle, curl_lock_data data,
+                        curl_lock_access access, void* userptr)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+  static void ShareUnlock(CURL* handle, curl_lock_data data, void* userptr)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
   std::shared_ptr<CurlHandleFactory> factory_;
   std::atomic<bool> done_{false};
 
+  // DNS and TLS session caches shared by the handles of all loops, so that a
+  // request which spills over to another loop need not repeat the name lookup
+  // or full TLS handshake.  Connections themselves remain in the connection
+  // cache of each multi handle, as libcurl does not support sharing them
+  // between threads.
+  absl::Mutex share_mutex_[CURL_LOCK_DATA_LAST];
+  CurlShare share_;
+
+  HostAffinity host_affinity_{kMaxAffinityHosts, kMaxAffinityImbalance};
+
   std::unique_ptr<ThreadData[]> thread_data_;
   std::vector<internal::Thread> threads_;
 };
@@ -375,9 +472,19 @@ MultiTransportImpl::MultiTransportImpl(
     std::shared_ptr<CurlHandleFactory> factory, size_t nthreads)
     : factory_(std::move(factory)) {
   assert(factory_);
+  share_.reset(curl_share_init());
+  curl_share_setopt(share_.get(), CURLSHOPT_LOCKFUNC,
+                    &MultiTransportImpl::ShareLock);
+  curl_share_setopt(share_.get(), CURLSHOPT_UNLOCKFUNC,
+                    &MultiTransportImpl::ShareUnlock);
+  curl_share_setopt(share_.get(), CURLSHOPT_USERDATA, this);
+  curl_share_setopt(share_.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share_.get(), CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
   threads_.reserve(nthreads);
   thread_data_ = std::make_unique<ThreadData[]>(nthreads);
   for (size_t i = 0; i < nthreads; ++i) {
+    thread_data_[i].index = static_cast<int>(i);
     thread_data_[i].multi = factory_->CreateMultiHandle();
     threads_.push_back(
         internal::Thread({"curl_multi_thread"},
@@ -403,6 +510,24 @@ MultiTransportImpl::~MultiTransportImpl() {
   }
 }
 
+void MultiTransportImpl::ShareLock(CURL* handle, curl_lock_data data,
+                                   curl_lock_access access, void* userptr) {
+  static_cast<MultiTransportImpl*>(userptr)->share_mutex_[data].Lock();
+}
+
+void MultiTransportImpl::ShareUnlock(CURL* handle, curl_lock_data data,
+                                     void* userptr) {
+  static_cast<MultiTransportImpl*>(userptr)->share_mutex_[data].Unlock();
+}
+
+size_t MultiTransportImpl::SelectThread(std::string_view host) {
+  absl::InlinedVector<int64_t, 8> counts(threads_.size());
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    counts[i] = thread_data_[i].count.load(std::memory_order_relaxed);
+  }
+  return host_affinity_.Select(host, counts);
+}
+
 void MultiTransportImpl::EnqueueRequest(const HttpRequest& request,
                                         IssueRequestOptions options,
                                         HttpResponseHandler* response_handler) {
@@ -415,25 +540,21 @@ void MultiTransportImpl::EnqueueRequest(const HttpRequest& request,
   auto state = std::make_unique<CurlRequestState>(factory_);
   state->response_handler_ = response_handler;
   state->Prepare(request, std::move(options));
+  state->handle_.SetOption(CURLOPT_SHARE, share_.get());
 
-  // Select the thread with the fewest active connections, and then enqueue
-  // the request on that thread.
-  size_t selected_index = 0;
-  for (size_t i = 1; i < threads_.size(); ++i) {
-    if (thread_data_[i].count < thread_data_[selected_index].count) {
-      selected_index = i;
-    }
-  }
-
-  auto& selected = thread_data_[selected_index];
+  // Select the thread which has connections to the request host, and then
+  // enqueue the request on that thread.
+  auto& selected = thread_data_[SelectThread(
+      internal::ParseGenericUri(request.url).authority)];
   absl::MutexLock l(&selected.mutex);
   selected.pending.push_back(std::move(state));
   selected.count++;
+  http_loop_queue_depth.Set(selected.pending.size(), selected.index);
   curl_multi_wakeup(selected.multi.get());
 }
 
 void MultiTransportImpl::FinishRequest(std::unique_ptr<CurlRequestState> state,
-                                       CURLcode code) {
+                                       CURLcode code, int loop) {
   if (code == CURLE_HTTP2) {
     ABSL_LOG(WARNING) << "CURLE_HTTP2 " << state->error_buffer_;
     // If there was an error in the HTTP2 framing, try and force
@@ -454,11 +575,26 @@ void MultiTransportImpl::FinishRequest(std::unique_ptr<CurlRequestState> state,
     http_first_byte_latency_us.Observe(first_byte_us);
   }
 
+  // Record whether the transfer reused a cached connection.
+  {
+    long num_connects = 0;  // NOLINT
+    state->handle_.GetInfo(CURLINFO_NUM_CONNECTS, &num_connects);
+    if (num_connects > 0) {
+      http_connections_created.IncrementBy(num_connects, loop);
+    } else if (code == CURLE_OK) {
+      http_connections_reused.Increment(loop);
+    }
+  }
+
   // Record the total time.
   {
     curl_off_t total_time_us = 0;
     state->handle_.GetInfo(CURLINFO_TOTAL_TIME_T, &total_time_us);
     http_total_time_ms.Observe(total_time_us / 1000);
+    if (code == CURLE_OK) {
+      http_total_time_ms_by_version.Observe(
+          total_time_us / 1000, HttpVersionLabel(state->handle_));
+    }
   }
 
   if (code != CURLE_OK) {
@@ -507,11 +643,13 @@ void MultiTransportImpl::Run(ThreadData& thread_data) {
 
     // Perform work.
     {
+      internal_tracing::StageScope stage(internal_tracing::Stage::kHttp);
       int running_handles = 0;
       CURLMcode mcode;
       do {
         mcode = curl_multi_perform(thread_data.multi.get(), &running_handles);
         http_active.Set(running_handles);
+        http_loop_active.Set(running_handles, thread_data.index);
       } while (mcode == CURLM_CALL_MULTI_PERFORM);
 
       if (mcode != CURLM_OK) {
@@ -528,6 +666,9 @@ void MultiTransportImpl::Run(ThreadData& thread_data) {
 
 void MultiTransportImpl::MaybeAddPendingTransfers(ThreadData& thread_data) {
   absl::MutexLock l(&thread_data.mutex);
+  if (!thread_data.pending.empty()) {
+    http_loop_queue_depth.Set(0, thread_data.index);
+  }
   while (!thread_data.pending.empty()) {
     std::unique_ptr<CurlRequestState> state =
         std::move(thread_data.pending.front());
@@ -571,7 +712,7 @@ void MultiTransportImpl::RemoveCompletedTransfers(ThreadData& thread_data) {
       assert(pvt);
       std::unique_ptr<CurlRequestState> state(pvt);
       state->handle_.SetOption(CURLOPT_PRIVATE, nullptr);
-      FinishRequest(std::move(state), result);
+      FinishRequest(std::move(state), result, thread_data.index);
     }
   } while (m != nullptr);
 }
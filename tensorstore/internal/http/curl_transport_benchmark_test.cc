@@ -0,0 +1,499 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/// Benchmarks of `CurlTransport` against an embedded local HTTP server.
+///
+/// The server answers `GET /<n>` with an `n` byte body, over HTTP/1.1 or
+/// HTTP/2 (with prior knowledge, i.e. h2c without the upgrade), using a thread
+/// per connection.  Since the server runs in the same process, the results
+/// include its cost and are intended for comparing changes to the transport
+/// rather than as absolute numbers.
+///
+/// Each benchmark keeps `concurrency` requests in flight, and each iteration
+/// waits for one response and issues a replacement request.  In addition to
+/// requests/s (`items_per_second`) and `bytes_per_second`, the latency
+/// percentiles of the requests and the number of connections accepted by the
+/// server are reported as counters.
+///
+/// Example:
+///
+///   bazel run -c opt \
+///     //tensorstore/internal/http:curl_transport_benchmark_test -- \
+///     --benchmark_filter=BM_Get/http2
+
+#ifdef _WIN32
+#undef UNICODE
+#define WIN32_LEAN_AND_MEAN
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/curl_factory.h"
+#include "tensorstore/internal/http/curl_transport.h"
+#include "tensorstore/internal/http/http_request.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/internal/http/transport_test_utils.h"
+#include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+#include <nghttp2/nghttp2.h>
+
+ABSL_DECLARE_FLAG(std::optional<uint32_t>, tensorstore_http_threads);
+
+namespace {
+
+using ::tensorstore::internal::Thread;
+using ::tensorstore::internal_http::CurlTransport;
+using ::tensorstore::internal_http::GetDefaultCurlHandleFactory;
+using ::tensorstore::internal_http::HttpRequest;
+using ::tensorstore::internal_http::HttpRequestBuilder;
+using ::tensorstore::internal_http::HttpResponse;
+using ::tensorstore::internal_http::IssueRequestOptions;
+using ::tensorstore::transport_test_utils::CloseSocket;
+using ::tensorstore::transport_test_utils::CreateBoundSocket;
+using ::tensorstore::transport_test_utils::FormatSocketAddress;
+using ::tensorstore::transport_test_utils::socket_t;
+using ::tensorstore::transport_test_utils::WaitForRead;
+
+// Platform specific defines.
+#ifdef _WIN32
+using ssize_t = ptrdiff_t;
+constexpr int kShutdownBoth = SD_BOTH;
+#else  // _WIN32
+using ssize_t = ::ssize_t;
+constexpr int kShutdownBoth = SHUT_RDWR;
+#endif  // _WIN32
+
+constexpr size_t kMaxObjectSize = 16 << 20;
+
+// Returns the response body for an object of `size` bytes.
+std::string_view GetObject(size_t size) {
+  static const std::string* const data = new std::string(kMaxObjectSize, 'x');
+  return std::string_view(*data).substr(0, size);
+}
+
+bool SendAll(socket_t fd, const char* data, size_t length) {
+  while (length > 0) {
+    int n = send(fd, data, length, 0);
+    if (n <= 0) return false;
+    data += n;
+    length -= n;
+  }
+  return true;
+}
+
+enum class Protocol {
+  kHttp1,
+  kHttp2,
+};
+
+// HTTP/2 connection served with nghttp2 over a blocking socket.
+class Http2Connection {
+ public:
+  explicit Http2Connection(socket_t fd) : fd_(fd) {
+    nghttp2_session_callbacks* callbacks;
+    ABSL_CHECK_EQ(0, nghttp2_session_callbacks_new(&callbacks));
+    nghttp2_session_callbacks_set_send_callback(callbacks,
+                                                &Http2Connection::Send);
+    nghttp2_session_callbacks_set_on_begin_headers_callback(
+        callbacks, &Http2Connection::OnBeginHeaders);
+    nghttp2_session_callbacks_set_on_header_callback(
+        callbacks, &Http2Connection::OnHeader);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(
+        callbacks, &Http2Connection::OnFrameRecv);
+    nghttp2_session_callbacks_set_on_stream_close_callback(
+        callbacks, &Http2Connection::OnStreamClose);
+    ABSL_CHECK_EQ(0, nghttp2_session_server_new(&session_, callbacks, this));
+    nghttp2_session_callbacks_del(callbacks);
+  }
+
+  ~Http2Connection() { nghttp2_session_del(session_); }
+
+  // Serves requests until the client closes the connection.
+  void Serve() {
+    nghttp2_settings_entry settings[] = {
+        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, 256},
+    };
+    if (nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, settings,
+                                std::size(settings)) != 0) {
+      return;
+    }
+    char buf[64 * 1024];
+    while (nghttp2_session_want_read(session_) ||
+           nghttp2_session_want_write(session_)) {
+      // Sends all pending frames; the remaining response data, if any, waits
+      // for a WINDOW_UPDATE from the client.
+      if (nghttp2_session_send(session_) != 0) return;
+      if (!nghttp2_session_want_read(session_)) continue;
+      int n = recv(fd_, buf, sizeof(buf), 0);
+      if (n <= 0) return;
+      if (nghttp2_session_mem_recv(session_,
+                                   reinterpret_cast<const uint8_t*>(buf),
+                                   n) < 0) {
+        return;
+      }
+    }
+  }
+
+ private:
+  struct Stream {
+    std::string path;
+    std::string_view remaining;
+    std::string content_length;
+  };
+
+  void Respond(int32_t stream_id, Stream& stream) {
+    size_t size = 0;
+    int status = 200;
+    if (!absl::SimpleAtoi(std::string_view(stream.path).substr(1), &size) ||
+        size > kMaxObjectSize) {
+      status = 404;
+    }
+    stream.remaining = GetObject(status == 200 ? size : 0);
+    stream.content_length = absl::StrCat(stream.remaining.size());
+    std::string status_str = absl::StrCat(status);
+    nghttp2_nv headers[] = {
+        MakeHeader(":status", status_str),
+        MakeHeader("content-length", stream.content_length),
+    };
+    nghttp2_data_provider data_provider;
+    data_provider.source.ptr = &stream;
+    data_provider.read_callback = &Http2Connection::ReadData;
+    ABSL_CHECK_EQ(0, nghttp2_submit_response(session_, stream_id, headers,
+                                             std::size(headers),
+                                             &data_provider));
+  }
+
+  static nghttp2_nv MakeHeader(std::string_view name, std::string_view value) {
+    return {
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(name.data())),
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(value.data())),
+        name.size(), value.size(), NGHTTP2_NV_FLAG_NONE};
+  }
+
+  // Callbacks for nghttp2_session:
+  static ssize_t Send(nghttp2_session* session, const uint8_t* data,
+                      size_t length, int flags, void* user_data) {
+    auto* self = static_cast<Http2Connection*>(user_data);
+    if (!SendAll(self->fd_, reinterpret_cast<const char*>(data), length)) {
+      return NGHTTP2_ERR_CALLBACK_FAILURE;
+    }
+    return length;
+  }
+
+  static int OnBeginHeaders(nghttp2_session* session,
+                            const nghttp2_frame* frame, void* user_data) {
+    if (frame->hd.type == NGHTTP2_HEADERS &&
+        frame->headers.cat == NGHTTP2_HCAT_REQUEST) {
+      nghttp2_session_set_stream_user_data(session, frame->hd.stream_id,
+                                           new Stream);
+    }
+    return 0;
+  }
+
+  static int OnHeader(nghttp2_session* session, const nghttp2_frame* frame,
+                      const uint8_t* name, size_t namelen, const uint8_t* value,
+                      size_t valuelen, uint8_t flags, void* user_data) {
+    auto* stream = static_cast<Stream*>(
+        nghttp2_session_get_stream_user_data(session, frame->hd.stream_id));
+    if (stream != nullptr &&
+        std::string_view(reinterpret_cast<const char*>(name), namelen) ==
+            ":path") {
+      stream->path.assign(reinterpret_cast<const char*>(value), valuelen);
+    }
+    return 0;
+  }
+
+  static int OnFrameRecv(nghttp2_session* session, const nghttp2_frame* frame,
+                         void* user_data) {
+    if ((frame->hd.type == NGHTTP2_DATA ||
+         frame->hd.type == NGHTTP2_HEADERS) &&
+        (frame->hd.flags & NGHTTP2_FLAG_END_STREAM)) {
+      if (auto* stream = static_cast<Stream*>(
+              nghttp2_session_get_stream_user_data(session,
+                                                   frame->hd.stream_id))) {
+        static_cast<Http2Connection*>(user_data)->Respond(frame->hd.stream_id,
+                                                          *stream);
+      }
+    }
+    return 0;
+  }
+
+  static int OnStreamClose(nghttp2_session* session, int32_t stream_id,
+                           uint32_t error_code, void* user_data) {
+    delete static_cast<Stream*>(
+        nghttp2_session_get_stream_user_data(session, stream_id));
+    return 0;
+  }
+
+  static ssize_t ReadData(nghttp2_session* session, int32_t stream_id,
+                          uint8_t* buf, size_t length, uint32_t* data_flags,
+                          nghttp2_data_source* source, void* user_data) {
+    auto* stream = static_cast<Stream*>(source->ptr);
+    length = std::min(length, stream->remaining.size());
+    std::memcpy(buf, stream->remaining.data(), length);
+    stream->remaining.remove_prefix(length);
+    if (stream->remaining.empty()) *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    return length;
+  }
+
+  socket_t fd_;
+  nghttp2_session* session_;
+};
+
+// Serves HTTP/1.1 requests until the client closes the connection or, if
+// `keep_alive` is false, after the first response.
+void ServeHttp1(socket_t fd, bool keep_alive) {
+  std::string buffer;
+  char buf[16 * 1024];
+  while (true) {
+    size_t header_end;
+    while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+      int n = recv(fd, buf, sizeof(buf), 0);
+      if (n <= 0) return;
+      buffer.append(buf, n);
+    }
+    // Request line: GET /<n> HTTP/1.1
+    std::string_view request_line =
+        std::string_view(buffer).substr(0, buffer.find("\r\n"));
+    size_t path_start = request_line.find(' ');
+    size_t path_end = request_line.rfind(' ');
+    size_t size = 0;
+    int status = 200;
+    if (path_start == std::string_view::npos || path_end <= path_start + 1 ||
+        !absl::SimpleAtoi(request_line.substr(path_start + 2,
+                                              path_end - path_start - 2),
+                          &size) ||
+        size > kMaxObjectSize) {
+      status = 404;
+      size = 0;
+    }
+    buffer.erase(0, header_end + 4);
+
+    std::string_view body = GetObject(size);
+    std::string header = absl::StrCat(
+        "HTTP/1.1 ", status, status == 200 ? " OK" : " Not Found",
+        "\r\nContent-Length: ", body.size(),
+        keep_alive ? "" : "\r\nConnection: close", "\r\n\r\n");
+    if (!SendAll(fd, header.data(), header.size()) ||
+        !SendAll(fd, body.data(), body.size()) || !keep_alive) {
+      return;
+    }
+  }
+}
+
+// Local HTTP server which serves each connection on a separate thread.
+class BenchmarkServer {
+ public:
+  BenchmarkServer(Protocol protocol, bool keep_alive)
+      : protocol_(protocol), keep_alive_(keep_alive) {
+    auto socket = CreateBoundSocket();
+    ABSL_CHECK(socket.has_value());
+    listen_fd_ = *socket;
+    // Calling listen again increases the backlog, so that connections opened
+    // concurrently by many requests are not dropped.
+    ::listen(listen_fd_, 1024);
+    hostport_ = FormatSocketAddress(listen_fd_);
+    ABSL_CHECK(!hostport_.empty());
+    accept_thread_ = Thread({"http_benchmark_accept"}, [this] { Accept(); });
+  }
+
+  ~BenchmarkServer() {
+    stop_.store(true);
+    accept_thread_.Join();
+    CloseSocket(listen_fd_);
+    absl::MutexLock lock(&mutex_);
+    for (socket_t fd : open_fds_) {
+      ::shutdown(fd, kShutdownBoth);
+    }
+    mutex_.Await(absl::Condition(
+        +[](BenchmarkServer* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+             self->mutex_) { return self->open_fds_.empty(); },
+        this));
+  }
+
+  const std::string& hostport() const { return hostport_; }
+
+  // Number of connections accepted.
+  size_t connections() const { return connections_.load(); }
+
+ private:
+  void Accept() {
+    while (!stop_.load()) {
+      if (!WaitForRead(listen_fd_)) continue;
+      socket_t fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) continue;
+      int yes = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&yes),
+                 sizeof(yes));
+      connections_.fetch_add(1);
+      {
+        absl::MutexLock lock(&mutex_);
+        open_fds_.insert(fd);
+      }
+      Thread::StartDetached({"http_benchmark_connection"}, [this, fd] {
+        if (protocol_ == Protocol::kHttp2) {
+          Http2Connection(fd).Serve();
+        } else {
+          ServeHttp1(fd, keep_alive_);
+        }
+        // The socket is closed while holding the lock, so that the destructor
+        // does not shut down a reused descriptor.
+        absl::MutexLock lock(&mutex_);
+        open_fds_.erase(fd);
+        CloseSocket(fd);
+      });
+    }
+  }
+
+  Protocol protocol_;
+  bool keep_alive_;
+  socket_t listen_fd_;
+  std::string hostport_;
+  std::atomic<bool> stop_{false};
+  std::atomic<size_t> connections_{0};
+  Thread accept_thread_;
+  absl::Mutex mutex_;
+  absl::flat_hash_set<socket_t> open_fds_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns the `p`-th percentile of sorted `values`.
+double Percentile(const std::vector<double>& values, double p) {
+  if (values.empty()) return 0;
+  return values[std::min(values.size() - 1,
+                         static_cast<size_t>(p / 100 * values.size()))];
+}
+
+// Keeps `concurrency` requests in flight.
+//
+// Arguments: object size, concurrency, `--tensorstore_http_threads`.
+void BM_Get(benchmark::State& state, Protocol protocol, bool keep_alive) {
+  const size_t size = state.range(0);
+  const size_t concurrency = state.range(1);
+  absl::SetFlag(&FLAGS_tensorstore_http_threads,
+                static_cast<uint32_t>(state.range(2)));
+
+  BenchmarkServer server(protocol, keep_alive);
+  // The number of threads is determined when the transport is created.
+  auto transport =
+      std::make_shared<CurlTransport>(GetDefaultCurlHandleFactory());
+  const HttpRequest request =
+      HttpRequestBuilder("GET",
+                         absl::StrCat("http://", server.hostport(), "/", size))
+          .BuildRequest();
+  const auto http_version =
+      protocol == Protocol::kHttp2
+          ? IssueRequestOptions::HttpVersion::kHttp2PriorKnowledge
+          : IssueRequestOptions::HttpVersion::kHttp1;
+
+  absl::Mutex mutex;
+  absl::CondVar completed_cv;
+  size_t completed ABSL_GUARDED_BY(mutex) = 0;
+  size_t errors ABSL_GUARDED_BY(mutex) = 0;
+  std::vector<double> latencies_us ABSL_GUARDED_BY(mutex);
+
+  auto issue = [&] {
+    const absl::Time start = absl::Now();
+    transport
+        ->IssueRequest(request,
+                       IssueRequestOptions().SetHttpVersion(http_version))
+        .ExecuteWhenReady([&, start](
+                              tensorstore::ReadyFuture<HttpResponse> future) {
+          const double latency_us =
+              absl::ToDoubleMicroseconds(absl::Now() - start);
+          auto& response = future.result();
+          absl::MutexLock lock(&mutex);
+          if (!response.ok() || response->status_code != 200 ||
+              response->payload.size() != size) {
+            ++errors;
+          }
+          latencies_us.push_back(latency_us);
+          ++completed;
+          completed_cv.Signal();
+        });
+  };
+
+  size_t issued = 0;
+  for (; issued < concurrency; ++issued) issue();
+  for (auto s : state) {
+    {
+      absl::MutexLock lock(&mutex);
+      while (completed <= issued - concurrency) completed_cv.Wait(&mutex);
+    }
+    issue();
+    ++issued;
+  }
+  absl::MutexLock lock(&mutex);
+  while (completed < issued) completed_cv.Wait(&mutex);
+  if (errors != 0) {
+    state.SkipWithError(absl::StrCat(errors, " requests failed").c_str());
+    return;
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["p50_us"] = Percentile(latencies_us, 50);
+  state.counters["p90_us"] = Percentile(latencies_us, 90);
+  state.counters["p99_us"] = Percentile(latencies_us, 99);
+  state.counters["connections"] = server.connections();
+}
+
+void GetArgs(benchmark::internal::Benchmark* b) {
+  b->ArgsProduct({
+       {1 << 10, 64 << 10, 1 << 20, 16 << 20},
+       {1, 8, 64},
+       {1, 4},
+   })
+      ->ArgNames({"size", "concurrency", "threads"})
+      ->UseRealTime();
+}
+
+BENCHMARK_CAPTURE(BM_Get, http1, Protocol::kHttp1, /*keep_alive=*/true)
+    ->Apply(GetArgs);
+BENCHMARK_CAPTURE(BM_Get, http1_no_reuse, Protocol::kHttp1,
+                  /*keep_alive=*/false)
+    ->Apply(GetArgs);
+BENCHMARK_CAPTURE(BM_Get, http2, Protocol::kHttp2, /*keep_alive=*/true)
+    ->Apply(GetArgs);
+
+}  // namespace
@@ -30,6 +30,7 @@ namespace internal_http {
 void CurlPtrCleanup::operator()(CURL* c) { curl_easy_cleanup(c); }
 void CurlMultiCleanup::operator()(CURLM* m) { curl_multi_cleanup(m); }
 void CurlSlistCleanup::operator()(curl_slist* s) { curl_slist_free_all(s); }
+void CurlShareCleanup::operator()(CURLSH* s) { curl_share_cleanup(s); }
 
 /// Returns the default CurlUserAgent.
 std::string GetCurlUserAgentSuffix() {
@@ -38,6 +39,16 @@ std::string GetCurlUserAgentSuffix() {
   return agent;
 }
 
+bool CurlSupportsHttp3() {
+#ifdef CURL_VERSION_HTTP3
+  static const bool supported =
+      (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP3) != 0;
+  return supported;
+#else
+  return false;
+#endif
+}
+
 /// Returns a absl::Status object for a corresponding CURLcode.
 absl::Status CurlCodeToStatus(CURLcode code, std::string_view detail,
                               SourceLocation loc) {
@@ -36,6 +36,9 @@ struct CurlMultiCleanup {
 struct CurlSlistCleanup {
   void operator()(curl_slist*);
 };
+struct CurlShareCleanup {
+  void operator()(CURLSH*);
+};
 
 /// CurlPtr holds a CURL* handle and automatically clean it up.
 using CurlPtr = std::unique_ptr<CURL, CurlPtrCleanup>;
@@ -43,12 +46,18 @@ using CurlPtr = std::unique_ptr<CURL, CurlPtrCleanup>;
 /// CurlMulti holds a CURLM* handle and automatically clean it up.
 using CurlMulti = std::unique_ptr<CURLM, CurlMultiCleanup>;
 
+/// CurlShare holds a CURLSH* handle and automatically clean it up.
+using CurlShare = std::unique_ptr<CURLSH, CurlShareCleanup>;
+
 /// CurlHeaders holds a singly-linked list of headers.
 using CurlHeaders = std::unique_ptr<curl_slist, CurlSlistCleanup>;
 
 /// Returns the default GetCurlUserAgentSuffix.
 std::string GetCurlUserAgentSuffix();
 
+/// Returns whether libcurl is built with HTTP/3 support.
+bool CurlSupportsHttp3();
+
 /// Returns a absl::Status object for a corresponding CURLcode.
 absl::Status CurlCodeToStatus(
     CURLcode code, std::string_view detail,
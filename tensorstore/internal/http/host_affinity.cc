@@ -0,0 +1,71 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/http/host_affinity.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+HostAffinity::HostAffinity(size_t max_hosts, int64_t max_imbalance)
+    : max_hosts_(std::max(size_t{1}, max_hosts)),
+      max_imbalance_(max_imbalance) {}
+
+size_t HostAffinity::Select(std::string_view host,
+                            span<const int64_t> loop_counts) {
+  assert(!loop_counts.empty());
+  const size_t least_loaded =
+      std::min_element(loop_counts.begin(), loop_counts.end()) -
+      loop_counts.begin();
+
+  absl::MutexLock lock(&mutex_);
+  auto it = hosts_.find(host);
+  if (it == hosts_.end()) {
+    if (hosts_.size() == max_hosts_) {
+      // Drop the least recently used assignment.
+      hosts_.erase(lru_.front().first);
+      lru_.pop_front();
+    }
+    lru_.emplace_back(std::string(host), least_loaded);
+    hosts_.emplace(lru_.back().first, std::prev(lru_.end()));
+    return least_loaded;
+  }
+  auto position = it->second;
+  lru_.splice(lru_.end(), lru_, position);
+  const size_t loop = position->second;
+  if (loop >= loop_counts.size() ||
+      loop_counts[loop] - loop_counts[least_loaded] > max_imbalance_) {
+    return least_loaded;
+  }
+  return loop;
+}
+
+size_t HostAffinity::size() const {
+  absl::MutexLock lock(&mutex_);
+  return hosts_.size();
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
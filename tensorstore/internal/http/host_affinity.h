@@ -0,0 +1,78 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_HTTP_HOST_AFFINITY_H_
+#define TENSORSTORE_INTERNAL_HTTP_HOST_AFFINITY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Assigns the hosts of HTTP requests to event loops.
+///
+/// Requests to a host are issued on the loop first chosen for it, which keeps
+/// the connections to that host in a single connection cache.  A request
+/// spills over to the least loaded loop once the host's loop has more than
+/// `max_imbalance` more active transfers than it does.
+///
+/// Only the `max_hosts` most recently used assignments are retained, such that
+/// memory usage is bounded when many distinct hosts are accessed.
+///
+/// Thread safety: safe to call concurrently from multiple threads.
+class HostAffinity {
+ public:
+  HostAffinity(size_t max_hosts, int64_t max_imbalance);
+
+  /// Returns the index of the loop on which to issue a request to `host`.
+  ///
+  /// \param host The host (URI authority) of the request.
+  /// \param loop_counts Number of active transfers of each loop.  Must be
+  ///     non-empty.
+  size_t Select(std::string_view host, span<const int64_t> loop_counts);
+
+  /// Returns the number of hosts for which an assignment is retained.
+  size_t size() const;
+
+ private:
+  using LruList = std::list<std::pair<std::string, size_t>>;
+
+  const size_t max_hosts_;
+  const int64_t max_imbalance_;
+
+  mutable absl::Mutex mutex_;
+
+  // Host and assigned loop, in order of least to most recently used.
+  LruList lru_ ABSL_GUARDED_BY(mutex_);
+
+  // Maps each host in `lru_` to its position.
+  absl::flat_hash_map<std::string_view, LruList::iterator> hosts_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_HTTP_HOST_AFFINITY_H_
@@ -0,0 +1,77 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/http/host_affinity.h"
+
+#include <stdint.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using ::tensorstore::internal_http::HostAffinity;
+
+TEST(HostAffinityTest, NewHostUsesLeastLoadedLoop) {
+  HostAffinity affinity(/*max_hosts=*/16, /*max_imbalance=*/4);
+  const int64_t counts[] = {3, 1, 2};
+  EXPECT_EQ(1, affinity.Select("a.example.com", counts));
+  EXPECT_EQ(1, affinity.size());
+}
+
+TEST(HostAffinityTest, HostSticksToLoop) {
+  HostAffinity affinity(/*max_hosts=*/16, /*max_imbalance=*/4);
+  const int64_t initial_counts[] = {0, 0, 0};
+  EXPECT_EQ(0, affinity.Select("a.example.com", initial_counts));
+
+  // Within the imbalance limit, the host keeps its loop.
+  const int64_t counts[] = {4, 0, 0};
+  EXPECT_EQ(0, affinity.Select("a.example.com", counts));
+  EXPECT_EQ(1, affinity.Select("b.example.com", counts));
+  EXPECT_EQ(1, affinity.Select("b.example.com", initial_counts));
+  EXPECT_EQ(2, affinity.size());
+}
+
+TEST(HostAffinityTest, SpillsOverWhenImbalanced) {
+  HostAffinity affinity(/*max_hosts=*/16, /*max_imbalance=*/4);
+  const int64_t initial_counts[] = {0, 0};
+  EXPECT_EQ(0, affinity.Select("a.example.com", initial_counts));
+
+  const int64_t imbalanced_counts[] = {6, 1};
+  EXPECT_EQ(1, affinity.Select("a.example.com", imbalanced_counts));
+
+  // Spilling over does not reassign the host.
+  const int64_t balanced_counts[] = {5, 1};
+  EXPECT_EQ(0, affinity.Select("a.example.com", balanced_counts));
+}
+
+TEST(HostAffinityTest, EvictsLeastRecentlyUsedHost) {
+  HostAffinity affinity(/*max_hosts=*/2, /*max_imbalance=*/4);
+  const int64_t counts_0[] = {0, 1};
+  const int64_t counts_1[] = {1, 0};
+  EXPECT_EQ(0, affinity.Select("a.example.com", counts_0));
+  EXPECT_EQ(1, affinity.Select("b.example.com", counts_1));
+
+  // Using "a" makes "b" the least recently used host.
+  EXPECT_EQ(0, affinity.Select("a.example.com", counts_1));
+  EXPECT_EQ(0, affinity.Select("c.example.com", counts_0));
+  EXPECT_EQ(2, affinity.size());
+
+  // "a" is retained, while "b" is assigned anew.
+  EXPECT_EQ(0, affinity.Select("a.example.com", counts_1));
+  EXPECT_EQ(0, affinity.Select("b.example.com", counts_0));
+  EXPECT_EQ(2, affinity.size());
+}
+
+}  // namespace
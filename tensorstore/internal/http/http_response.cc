@@ -217,6 +217,11 @@ absl::Status HttpResponseCodeToStatus(const HttpResponse& response,
   return status;
 }
 
+bool IsThrottlingStatus(const absl::Status& status) {
+  auto code = status.GetPayload("http_response_code");
+  return code && (*code == "429" || *code == "503");
+}
+
 Result<ParsedContentRange> ParseContentRangeHeader(
     const HttpResponse& response) {
   auto it = response.headers.find("content-range");
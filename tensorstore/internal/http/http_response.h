@@ -78,6 +78,11 @@ absl::Status HttpResponseCodeToStatus(
     const HttpResponse& response,
     SourceLocation loc = ::tensorstore::SourceLocation::current());
 
+/// Returns whether `status` was returned by `HttpResponseCodeToStatus` for a
+/// response indicating that the server is overloaded and the request rate
+/// should be reduced (429 Too Many Requests or 503 Service Unavailable).
+bool IsThrottlingStatus(const absl::Status& status);
+
 struct ParsedContentRange {
   // Inclusive min byte, always >= `0`.
   int64_t inclusive_min;
@@ -84,5 +84,15 @@ TEST(HttpResponseCodeToStatusTest, AllCodes) {
   }
 }
 
+TEST(IsThrottlingStatusTest, Basic) {
+  using ::tensorstore::internal_http::HttpResponseCodeToStatus;
+  using ::tensorstore::internal_http::IsThrottlingStatus;
+
+  EXPECT_TRUE(IsThrottlingStatus(HttpResponseCodeToStatus({429, {}, {}})));
+  EXPECT_TRUE(IsThrottlingStatus(HttpResponseCodeToStatus({503, {}, {}})));
+  EXPECT_FALSE(IsThrottlingStatus(HttpResponseCodeToStatus({500, {}, {}})));
+  EXPECT_FALSE(IsThrottlingStatus(absl::UnavailableError("")));
+  EXPECT_FALSE(IsThrottlingStatus(absl::OkStatus()));
+}
 
 }  // namespace
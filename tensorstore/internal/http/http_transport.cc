@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -27,11 +28,13 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
-#include "riegeli/bytes/cord_writer.h"
 #include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_request.h"
 #include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/http/response_body_buffer.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/internal/tracing/tracing.h"
 #include "tensorstore/util/future.h"
 
 namespace tensorstore {
@@ -43,7 +46,8 @@ ABSL_CONST_INIT internal_log::VerboseFlag verbose("http_transport");
 // Adapts the IssueRequestWithHandler api to IssueRequest.
 class LegacyHttpResponseHandler : public HttpResponseHandler {
  public:
-  LegacyHttpResponseHandler(Promise<HttpResponse> p);
+  LegacyHttpResponseHandler(Promise<HttpResponse> p,
+                            size_t response_size_hint);
 
   ~LegacyHttpResponseHandler() override = default;
 
@@ -56,14 +60,16 @@ class LegacyHttpResponseHandler : public HttpResponseHandler {
 
  private:
   Promise<HttpResponse> promise_;
-  absl::Cord data_;
-  riegeli::CordWriter<absl::Cord*> writer_;
+  size_t response_size_hint_;
+  bool body_started_ = false;
+  ResponseBodyBuffer body_;
   int32_t status_code_ = 0;
   absl::btree_multimap<std::string, std::string> headers_;
 };
 
-LegacyHttpResponseHandler::LegacyHttpResponseHandler(Promise<HttpResponse> p)
-    : promise_(std::move(p)), writer_(&data_) {}
+LegacyHttpResponseHandler::LegacyHttpResponseHandler(
+    Promise<HttpResponse> p, size_t response_size_hint)
+    : promise_(std::move(p)), response_size_hint_(response_size_hint) {}
 
 void LegacyHttpResponseHandler::OnStatus(int32_t status_code) {
   status_code_ = status_code;
@@ -71,14 +77,19 @@ void LegacyHttpResponseHandler::OnStatus(int32_t status_code) {
 
 void LegacyHttpResponseHandler::OnResponseHeader(std::string_view data) {
   AppendHeaderData(headers_, data);
-  auto content_length = TryGetContentLength(headers_);
-  if (content_length) {
-    writer_.SetWriteSizeHint(*content_length);
-  }
 }
 
 void LegacyHttpResponseHandler::OnResponseBody(std::string_view data) {
-  writer_.Write(data);
+  if (!body_started_) {
+    body_started_ = true;
+    // The Content-Length of an encoded response is the size before the
+    // transport decodes it.
+    auto content_length = headers_.find("content-encoding") == headers_.end()
+                              ? TryGetContentLength(headers_)
+                              : std::nullopt;
+    body_.Reserve(content_length.value_or(response_size_hint_));
+  }
+  body_.Append(data);
 }
 
 void LegacyHttpResponseHandler::OnFailure(absl::Status status) {
@@ -88,23 +99,52 @@ void LegacyHttpResponseHandler::OnFailure(absl::Status status) {
 }
 
 void LegacyHttpResponseHandler::OnComplete() {
-  writer_.Close();
-  HttpResponse response{status_code_, std::move(data_), std::move(headers_)};
+  HttpResponse response{status_code_, body_.Release(), std::move(headers_)};
   ABSL_LOG_IF(INFO, verbose.Level(1)) << response;
   promise_.SetResult(std::move(response));
   delete this;
 }
 
+// Discards the response to a request issued by `HttpTransport::Prewarm`.
+class PrewarmResponseHandler : public HttpResponseHandler {
+ public:
+  void OnFailure(absl::Status status) override {
+    ABSL_LOG_IF(INFO, verbose) << "Prewarm request failed: " << status;
+    delete this;
+  }
+  void OnStatus(int32_t status_code) override {}
+  void OnResponseHeader(std::string_view data) override {}
+  void OnResponseBody(std::string_view data) override {}
+  void OnComplete() override { delete this; }
+};
+
 }  // namespace
 
+void HttpTransport::Prewarm(std::string_view url, size_t num_connections) {
+  // Requests without `CURLOPT_PIPEWAIT` that are issued concurrently each open
+  // a new connection rather than waiting to multiplex over the first one.
+  HttpRequest request{"HEAD", std::string(url)};
+  for (size_t i = 0; i < num_connections; ++i) {
+    IssueRequestWithHandler(request, IssueRequestOptions{},
+                            new PrewarmResponseHandler);
+  }
+}
+
 Future<HttpResponse> HttpTransport::IssueRequest(const HttpRequest& request,
                                                  IssueRequestOptions options) {
   auto pair = PromiseFuturePair<HttpResponse>::Make();
   ABSL_LOG_IF(INFO, verbose.Level(1)) << request;
+  size_t response_size_hint = options.response_size_hint;
+  internal_tracing::Span span("http.Request");
+  span.SetAttribute("method", request.method);
+  span.SetAttribute("url", request.url);
+  internal_tracing::SpanScope scope(span);
   IssueRequestWithHandler(
       request, std::move(options),
-      new LegacyHttpResponseHandler(std::move(pair.promise)));
-  return std::move(pair.future);
+      new LegacyHttpResponseHandler(std::move(pair.promise),
+                                    response_size_hint));
+  return internal_tracing::EndSpanWhenReady(std::move(span),
+                                            std::move(pair.future));
 }
 
 }  // namespace internal_http
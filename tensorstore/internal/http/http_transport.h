@@ -15,6 +15,7 @@
 #ifndef TENSORSTORE_INTERNAL_HTTP_HTTP_TRANSPORT_H_
 #define TENSORSTORE_INTERNAL_HTTP_HTTP_TRANSPORT_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <string_view>
@@ -38,6 +39,10 @@ struct IssueRequestOptions {
     kHttp2,
     kHttp2TLS,
     kHttp2PriorKnowledge,
+    // Attempts HTTP/3 (QUIC), falling back to HTTP/2 over TLS or HTTP/1.1 if
+    // the server does not support it.  Equivalent to `kHttp2TLS` if curl is
+    // built without HTTP/3 support.
+    kHttp3,
   };
 
   IssueRequestOptions() = default;
@@ -59,11 +64,20 @@ struct IssueRequestOptions {
     this->connect_timeout = connect_timeout;
     return std::move(*this);
   }
+  IssueRequestOptions&& SetResponseSizeHint(size_t response_size_hint) && {
+    this->response_size_hint = response_size_hint;
+    return std::move(*this);
+  }
 
   absl::Cord payload;
   absl::Duration request_timeout = absl::ZeroDuration();
   absl::Duration connect_timeout = absl::ZeroDuration();
   HttpVersion http_version = HttpVersion::kDefault;
+
+  // Expected size of the response body, such as the size of the requested
+  // byte range, used when the response has no Content-Length.  If non-zero,
+  // `IssueRequest` receives the body into a single preallocated buffer.
+  size_t response_size_hint = 0;
 };
 
 /// Interface used by the HTTP transport to signal data to caller.
@@ -103,6 +117,14 @@ class HttpTransport {
   virtual void IssueRequestWithHandler(
       const HttpRequest& request, IssueRequestOptions options,
       HttpResponseHandler* response_handler) = 0;
+
+  /// Opens up to `num_connections` connections to the server of `url` in the
+  /// background, such that subsequent requests need not wait for the TCP and
+  /// TLS handshakes.
+  ///
+  /// The default implementation issues `num_connections` concurrent `HEAD`
+  /// requests for `url` and discards the responses; errors are ignored.
+  virtual void Prewarm(std::string_view url, size_t num_connections);
 };
 
 }  // namespace internal_http
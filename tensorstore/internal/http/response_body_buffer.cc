@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/http/response_body_buffer.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_writer.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+ResponseBodyBuffer::ResponseBodyBuffer() : writer_(&tail_) {}
+
+void ResponseBodyBuffer::Reserve(size_t size) {
+  if (size < kMinReserveSize || this->size() != 0) {
+    if (this->size() == 0) writer_.SetWriteSizeHint(size);
+    return;
+  }
+  // Default-initialized; every byte returned is written by `Append`.
+  buffer_.reset(new char[size]);
+  buffer_capacity_ = size;
+}
+
+void ResponseBodyBuffer::Append(std::string_view data) {
+  if (buffer_ && writer_.pos() == 0) {
+    size_t n = std::min(data.size(), buffer_capacity_ - buffer_size_);
+    std::memcpy(buffer_.get() + buffer_size_, data.data(), n);
+    buffer_size_ += n;
+    data.remove_prefix(n);
+    if (data.empty()) return;
+  }
+  writer_.Write(data);
+}
+
+absl::Cord ResponseBodyBuffer::Release() {
+  writer_.Close();
+  absl::Cord result;
+  if (buffer_ && buffer_size_ < buffer_capacity_ / 2) {
+    // Much less data was received than expected; avoid retaining the unused
+    // portion of the buffer.
+    result = absl::Cord(std::string_view(buffer_.get(), buffer_size_));
+    buffer_.reset();
+    result.Append(std::move(tail_));
+  } else if (buffer_) {
+    std::string_view data(buffer_.get(), buffer_size_);
+    result = absl::MakeCordFromExternal(
+        data, [buffer = std::move(buffer_)](std::string_view) mutable {
+          buffer.reset();
+        });
+    result.Append(std::move(tail_));
+  } else {
+    result = std::move(tail_);
+  }
+  buffer_capacity_ = 0;
+  buffer_size_ = 0;
+  tail_.Clear();
+  writer_.Reset(&tail_);
+  return result;
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
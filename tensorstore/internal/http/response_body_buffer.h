@@ -0,0 +1,71 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_HTTP_RESPONSE_BODY_BUFFER_H_
+#define TENSORSTORE_INTERNAL_HTTP_RESPONSE_BODY_BUFFER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string_view>
+
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_writer.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Accumulates the body of an HTTP response.
+///
+/// When the size of the body is known before it is received, such as from the
+/// Content-Length header or the requested byte range, `Reserve` allocates a
+/// single buffer into which the body is copied directly, and `Release`
+/// returns it as a flat `absl::Cord` which consumers need not `Flatten`.
+/// Otherwise, and for any data beyond the reserved size, the body is
+/// accumulated in Cord-sized blocks.
+class ResponseBodyBuffer {
+ public:
+  /// Bodies smaller than this are accumulated in blocks even when reserved.
+  static constexpr size_t kMinReserveSize = 64 * 1024;
+
+  ResponseBodyBuffer();
+
+  /// Reserves a buffer for a body of `size` bytes.  Has no effect if data has
+  /// already been appended, or if `size < kMinReserveSize`.
+  void Reserve(size_t size);
+
+  /// Appends `data` to the body.
+  void Append(std::string_view data);
+
+  /// Returns the number of bytes appended.
+  size_t size() const { return buffer_size_ + writer_.pos(); }
+
+  /// Returns the body, leaving the buffer empty.
+  absl::Cord Release();
+
+ private:
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_capacity_ = 0;
+  size_t buffer_size_ = 0;
+
+  // Data which did not fit in `buffer_`.
+  absl::Cord tail_;
+  riegeli::CordWriter<absl::Cord*> writer_;
+};
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_HTTP_RESPONSE_BODY_BUFFER_H_
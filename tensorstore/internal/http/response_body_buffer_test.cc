@@ -0,0 +1,95 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/http/response_body_buffer.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+
+namespace {
+
+using ::tensorstore::internal_http::ResponseBodyBuffer;
+
+constexpr size_t kSize = ResponseBodyBuffer::kMinReserveSize * 4;
+
+std::string MakeData(size_t size) {
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; ++i) data[i] = static_cast<char>(i * 7);
+  return data;
+}
+
+void AppendInChunks(ResponseBodyBuffer& body, std::string_view data) {
+  while (!data.empty()) {
+    size_t n = std::min<size_t>(data.size(), 16 * 1024);
+    body.Append(data.substr(0, n));
+    data.remove_prefix(n);
+  }
+}
+
+TEST(ResponseBodyBufferTest, Unreserved) {
+  auto data = MakeData(kSize);
+  ResponseBodyBuffer body;
+  AppendInChunks(body, data);
+  EXPECT_EQ(kSize, body.size());
+  EXPECT_EQ(data, std::string(body.Release()));
+  EXPECT_EQ(0, body.size());
+}
+
+TEST(ResponseBodyBufferTest, ReservedIsFlat) {
+  auto data = MakeData(kSize);
+  ResponseBodyBuffer body;
+  body.Reserve(kSize);
+  AppendInChunks(body, data);
+  auto cord = body.Release();
+  EXPECT_EQ(data, std::string(cord));
+  std::optional<std::string_view> flat = cord.TryFlat();
+  ASSERT_TRUE(flat.has_value());
+  EXPECT_EQ(kSize, flat->size());
+}
+
+TEST(ResponseBodyBufferTest, ReservedOverflow) {
+  auto data = MakeData(kSize + 100);
+  ResponseBodyBuffer body;
+  body.Reserve(kSize);
+  AppendInChunks(body, data);
+  EXPECT_EQ(kSize + 100, body.size());
+  EXPECT_EQ(data, std::string(body.Release()));
+}
+
+TEST(ResponseBodyBufferTest, ReservedUnderflow) {
+  auto data = MakeData(kSize / 4);
+  ResponseBodyBuffer body;
+  body.Reserve(kSize);
+  AppendInChunks(body, data);
+  EXPECT_EQ(data, std::string(body.Release()));
+}
+
+TEST(ResponseBodyBufferTest, ReuseAfterRelease) {
+  ResponseBodyBuffer body;
+  body.Reserve(kSize);
+  body.Append("abc");
+  EXPECT_EQ("abc", std::string(body.Release()));
+  body.Append("def");
+  EXPECT_EQ("def", std::string(body.Release()));
+}
+
+}  // namespace
@@ -14,6 +14,7 @@
 
 #include "tensorstore/internal/image/jpeg_reader.h"
 
+#include <algorithm>
 #include <cassert>
 #include <csetjmp>
 #include <memory>
@@ -171,6 +172,22 @@ ImageInfo GetJpegImageInfo(::jpeg_decompress_struct* cinfo) {
   return info;
 }
 
+/// Returns the ImageInfo of the output produced when decoding with `options`.
+ImageInfo GetJpegImageInfo(::jpeg_decompress_struct* cinfo,
+                           const JpegReaderOptions& options) {
+  ImageInfo info = GetJpegImageInfo(cinfo);
+  if (options.scale_denom > 1) {
+    // Matches `jpeg_calc_output_dimensions`, which rounds up.
+    info.width = (info.width + options.scale_denom - 1) / options.scale_denom;
+    info.height =
+        (info.height + options.scale_denom - 1) / options.scale_denom;
+  }
+  if (options.max_rows >= 0) {
+    info.height = std::min(info.height, options.max_rows);
+  }
+  return info;
+}
+
 }  // namespace
 
 struct JpegReader::Context {
@@ -249,8 +266,14 @@ absl::Status JpegReader::Context::Decode(tensorstore::span<unsigned char> dest,
     return absl::InternalError("");
   }
 
+  if (options.scale_denom != 1 && options.scale_denom != 2 &&
+      options.scale_denom != 4 && options.scale_denom != 8) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Invalid JPEG scale_denom: %d", options.scale_denom));
+  }
+
   // Validate the image is compatible.
-  auto info = GetJpegImageInfo(&cinfo_);
+  auto info = GetJpegImageInfo(&cinfo_, options);
   ABSL_CHECK_EQ(dest.size(), ImageRequiredBytes(info));
 
   ImageView dest_view(info, dest);
@@ -261,12 +284,18 @@ absl::Status JpegReader::Context::Decode(tensorstore::span<unsigned char> dest,
       return false;
     }
 
+    cinfo_.scale_num = 1;
+    cinfo_.scale_denom = options.scale_denom;
+
     // Start decompressing
     ::jpeg_start_decompress(&cinfo_);
     started_ = true;
 
-    // ... then read each scanline
-    while (cinfo_.output_scanline < cinfo_.output_height) {
+    // ... then read each requested scanline.  When only a prefix of the rows
+    // is requested, the remaining data is never decoded; the destructor
+    // aborts the decompression.
+    const JDIMENSION num_rows = info.height;
+    while (cinfo_.output_scanline < num_rows) {
       auto* output_line = reinterpret_cast<JSAMPLE*>(
           dest_view.data_row(cinfo_.output_scanline).data());
       if (::jpeg_read_scanlines(&cinfo_, &output_line, 1) != 1) {
@@ -319,6 +348,11 @@ ImageInfo JpegReader::GetImageInfo() {
   return GetJpegImageInfo(&context_->cinfo_);
 }
 
+ImageInfo JpegReader::GetImageInfo(const JpegReaderOptions& options) {
+  if (!context_) return {};
+  return GetJpegImageInfo(&context_->cinfo_, options);
+}
+
 absl::Status JpegReader::DecodeImpl(tensorstore::span<unsigned char> dest,
                                     const JpegReaderOptions& options) {
   if (!context_) {
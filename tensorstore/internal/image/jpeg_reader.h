@@ -15,6 +15,11 @@
 #ifndef TENSORSTORE_INTERNAL_IMAGE_JPEG_READER_H_
 #define TENSORSTORE_INTERNAL_IMAGE_JPEG_READER_H_
 
+#include <stdint.h>
+
+#include <memory>
+
+#include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
 #include "tensorstore/internal/image/image_info.h"
 #include "tensorstore/internal/image/image_reader.h"
@@ -23,7 +28,17 @@
 namespace tensorstore {
 namespace internal_image {
 
-struct JpegReaderOptions {};
+struct JpegReaderOptions {
+  /// Downscaling factor applied in the DCT domain by libjpeg; must be one of
+  /// 1, 2, 4, or 8.  The output dimensions are `ceil(dim / scale_denom)`.
+  /// Scaling during decode is substantially cheaper than decoding at full
+  /// resolution and downsampling afterwards.
+  int scale_denom = 1;
+
+  /// If non-negative, only the first `max_rows` output rows are decoded, and
+  /// decoding stops as soon as they are available.
+  int32_t max_rows = -1;
+};
 
 class JpegReader : public ImageReader {
  public:
@@ -41,6 +56,10 @@ class JpegReader : public ImageReader {
   // Returns the current ImageInfo.
   ImageInfo GetImageInfo() override;
 
+  // Returns the ImageInfo of the output produced by decoding with `options`,
+  // which determines the required size of the buffer passed to `Decode`.
+  ImageInfo GetImageInfo(const JpegReaderOptions& options);
+
   // Decodes the next available image into 'dest'.
   absl::Status Decode(tensorstore::span<unsigned char> dest) override {
     return DecodeImpl(dest, {});
@@ -13,16 +13,19 @@
 // limitations under the License.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <cmath>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/string_reader.h"
+#include "tensorstore/internal/image/image_info.h"
 #include "tensorstore/internal/image/jpeg_reader.h"
 #include "tensorstore/internal/image/jpeg_writer.h"
 #include "tensorstore/util/result.h"
@@ -32,7 +35,9 @@
 namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
+using ::tensorstore::internal_image::ImageRequiredBytes;
 using ::tensorstore::internal_image::JpegReader;
+using ::tensorstore::internal_image::JpegReaderOptions;
 using ::tensorstore::internal_image::JpegWriter;
 
 TEST(JpegTest, Decode) {
@@ -254,6 +259,78 @@ TEST(JpegTest, EncodeDecode) {
   }
 }
 
+absl::Cord EncodeTestJpeg(int32_t height, int32_t width) {
+  std::vector<uint8_t> pixels(height * width);
+  for (int32_t y = 0; y < height; ++y) {
+    for (int32_t x = 0; x < width; ++x) {
+      pixels[y * width + x] = static_cast<uint8_t>(x + 2 * y);
+    }
+  }
+  absl::Cord encoded;
+  JpegWriter encoder;
+  riegeli::CordWriter cord_writer(&encoded);
+  TENSORSTORE_CHECK_OK(encoder.Initialize(&cord_writer));
+  TENSORSTORE_CHECK_OK(encoder.Encode(ImageInfo{height, width, 1}, pixels));
+  TENSORSTORE_CHECK_OK(encoder.Done());
+  return encoded;
+}
+
+TEST(JpegTest, DecodeScaled) {
+  auto encoded = EncodeTestJpeg(45, 64);
+  JpegReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+
+  JpegReaderOptions options;
+  options.scale_denom = 4;
+  const auto info = decoder.GetImageInfo(options);
+  EXPECT_EQ(16, info.width);
+  EXPECT_EQ(12, info.height);
+  EXPECT_EQ(1, info.num_components);
+
+  std::vector<unsigned char> pixels(ImageRequiredBytes(info));
+  ASSERT_THAT(decoder.Decode(pixels, options), ::tensorstore::IsOk());
+  // Each output pixel approximates the mean of a 4x4 input block.
+  EXPECT_NEAR((4 * 5 + 1.5) + 2 * (4 * 2 + 1.5), pixels[2 * 16 + 5], 4);
+}
+
+TEST(JpegTest, DecodeInvalidScale) {
+  auto encoded = EncodeTestJpeg(8, 8);
+  JpegReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+
+  JpegReaderOptions options;
+  options.scale_denom = 3;
+  std::vector<unsigned char> pixels(64);
+  EXPECT_THAT(decoder.Decode(pixels, options),
+              tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JpegTest, DecodeMaxRows) {
+  auto encoded = EncodeTestJpeg(64, 40);
+  std::vector<unsigned char> full(64 * 40);
+  {
+    JpegReader decoder;
+    riegeli::CordReader cord_reader(&encoded);
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    ASSERT_THAT(decoder.Decode(full), ::tensorstore::IsOk());
+  }
+
+  JpegReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+  JpegReaderOptions options;
+  options.max_rows = 10;
+  const auto info = decoder.GetImageInfo(options);
+  EXPECT_EQ(40, info.width);
+  EXPECT_EQ(10, info.height);
+
+  std::vector<unsigned char> prefix(ImageRequiredBytes(info));
+  ASSERT_THAT(decoder.Decode(prefix, options), ::tensorstore::IsOk());
+  EXPECT_THAT(prefix, ::testing::ElementsAreArray(full.data(), prefix.size()));
+}
+
 TEST(JpegTest, NotAJpeg) {
   static constexpr unsigned char data[] = {
       0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a,  // sig
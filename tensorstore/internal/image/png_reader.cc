@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <stddef.h>
 
+#include <algorithm>
 #include <csetjmp>
 #include <limits>
 #include <memory>
@@ -84,7 +85,8 @@ struct PngReader::Context {
 
   absl::Status Initialize();
   ImageInfo GetImageInfo();
-  absl::Status Decode(tensorstore::span<unsigned char> dest);
+  absl::Status Decode(tensorstore::span<unsigned char> dest,
+                      const PngReaderOptions& options);
 };
 
 PngReader::Context::~Context() {
@@ -161,8 +163,12 @@ ImageInfo PngReader::Context::GetImageInfo() {
   return info;
 }
 
-absl::Status PngReader::Context::Decode(tensorstore::span<unsigned char> dest) {
+absl::Status PngReader::Context::Decode(tensorstore::span<unsigned char> dest,
+                                        const PngReaderOptions& options) {
   auto info = GetImageInfo();
+  if (options.max_rows >= 0) {
+    info.height = std::min(info.height, options.max_rows);
+  }
   if (auto required = ImageRequiredBytes(info); required > dest.size()) {
     return absl::InternalError(
         absl::StrFormat("Cannot read PNG; required buffer size %d, got %d",
@@ -171,6 +177,7 @@ absl::Status PngReader::Context::Decode(tensorstore::span<unsigned char> dest) {
 
   ImageView dest_view(info, dest);
   std::vector<uint8_t*> row_ptrs;
+  std::unique_ptr<unsigned char[]> interlace_buffer;
   absl::Status status;
 
   bool ok = [&]() {
@@ -196,19 +203,27 @@ absl::Status PngReader::Context::Decode(tensorstore::span<unsigned char> dest) {
     png_read_update_info(png_ptr_, info_ptr_);
 
     int64_t height = png_get_image_height(png_ptr_, info_ptr_);
-    assert(png_get_rowbytes(png_ptr_, info_ptr_) ==
-           dest_view.row_stride_bytes());
+    const size_t row_bytes = png_get_rowbytes(png_ptr_, info_ptr_);
+    assert(row_bytes == dest_view.row_stride_bytes());
 
     if (png_get_interlace_type(png_ptr_, info_ptr_) != PNG_INTERLACE_NONE) {
-      // Interleaved images require that allocation of an image-sized buffer.
+      // Interleaved images require that allocation of an image-sized buffer;
+      // rows beyond `info.height` are decoded into a scratch buffer.
       row_ptrs.resize(height);
+      if (height > info.height) {
+        interlace_buffer.reset(
+            new unsigned char[(height - info.height) * row_bytes]);
+      }
       for (int y = 0; y < height; ++y) {
-        row_ptrs[y] = dest_view.data_row(y).data();
+        row_ptrs[y] =
+            y < info.height
+                ? dest_view.data_row(y).data()
+                : interlace_buffer.get() + (y - info.height) * row_bytes;
       }
       png_read_image(png_ptr_, &row_ptrs[0]);
     } else {
-      // Decode and stream row by row.
-      for (int y = 0; y < height; ++y) {
+      // Decode and stream row by row, stopping after the requested rows.
+      for (int y = 0; y < info.height; ++y) {
         png_read_row(png_ptr_, dest_view.data_row(y).data(), nullptr);
       }
     }
@@ -257,13 +272,22 @@ ImageInfo PngReader::GetImageInfo() {
   return context_->GetImageInfo();
 }
 
+ImageInfo PngReader::GetImageInfo(const PngReaderOptions& options) {
+  if (!context_) return {};
+  auto info = context_->GetImageInfo();
+  if (options.max_rows >= 0) {
+    info.height = std::min(info.height, options.max_rows);
+  }
+  return info;
+}
+
 absl::Status PngReader::DecodeImpl(tensorstore::span<unsigned char> dest,
                                    const PngReaderOptions& options) {
   if (!context_) {
     return absl::InternalError("No PNG file to decode");
   }
   auto context = std::move(context_);
-  return context->Decode(dest);
+  return context->Decode(dest, options);
 }
 
 }  // namespace internal_image
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_INTERNAL_IMAGE_PNG_READER_H_
 #define TENSORSTORE_INTERNAL_IMAGE_PNG_READER_H_
 
+#include <stdint.h>
+
 #include <memory>
 
 #include "absl/status/status.h"
@@ -26,7 +28,11 @@
 namespace tensorstore {
 namespace internal_image {
 
-struct PngReaderOptions {};
+struct PngReaderOptions {
+  /// If non-negative, only the first `max_rows` rows are decoded.  For
+  /// non-interlaced images decoding stops as soon as they are available.
+  int32_t max_rows = -1;
+};
 
 class PngReader : public ImageReader {
  public:
@@ -42,6 +48,10 @@ class PngReader : public ImageReader {
   // Returns the current ImageInfo.
   ImageInfo GetImageInfo() override;
 
+  // Returns the ImageInfo of the output produced by decoding with `options`,
+  // which determines the required size of the buffer passed to `Decode`.
+  ImageInfo GetImageInfo(const PngReaderOptions& options);
+
   // Decodes the next available image into 'dest'.
   absl::Status Decode(tensorstore::span<unsigned char> dest) override {
     return DecodeImpl(dest, {});
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include <string_view>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -32,7 +33,9 @@
 namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
+using ::tensorstore::internal_image::ImageRequiredBytes;
 using ::tensorstore::internal_image::PngReader;
+using ::tensorstore::internal_image::PngReaderOptions;
 using ::tensorstore::internal_image::PngWriter;
 
 TEST(PngTest, Decode) {
@@ -102,6 +105,38 @@ TEST(PngTest, EncodeDecode) {
   }
 }
 
+TEST(PngTest, DecodeMaxRows) {
+  constexpr int32_t kHeight = 20, kWidth = 7;
+  std::vector<uint8_t> pixels(kHeight * kWidth);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<uint8_t>(i);
+  }
+  absl::Cord encoded;
+  {
+    PngWriter encoder;
+    riegeli::CordWriter cord_writer(&encoded);
+    ASSERT_THAT(encoder.Initialize(&cord_writer), ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Encode(ImageInfo{kHeight, kWidth, 1}, pixels),
+                ::tensorstore::IsOk());
+    ASSERT_THAT(encoder.Done(), ::tensorstore::IsOk());
+  }
+
+  PngReader decoder;
+  riegeli::CordReader cord_reader(&encoded);
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+
+  PngReaderOptions options;
+  options.max_rows = 5;
+  const auto info = decoder.GetImageInfo(options);
+  EXPECT_EQ(kWidth, info.width);
+  EXPECT_EQ(5, info.height);
+
+  std::vector<unsigned char> prefix(ImageRequiredBytes(info));
+  ASSERT_THAT(decoder.Decode(prefix, options), ::tensorstore::IsOk());
+  EXPECT_THAT(prefix,
+              ::testing::ElementsAreArray(pixels.data(), prefix.size()));
+}
+
 TEST(PngTest, CorruptData) {
   static constexpr unsigned char data[] = {
       0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a,  // sig
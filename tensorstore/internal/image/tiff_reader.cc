@@ -56,7 +56,8 @@ struct TiffReader::Context : public LibTiffErrorBase {
   absl::Status ExtractErrors(absl::Status in);
 
   absl::Status Open();
-  absl::Status DefaultDecode(tensorstore::span<unsigned char> data);
+  absl::Status DefaultDecode(tensorstore::span<unsigned char> data,
+                             const TiffReaderOptions& options);
 };
 
 namespace {
@@ -124,24 +125,6 @@ toff_t SizeProc(thandle_t data) {
   return size ? static_cast<toff_t>(*size) : -1;
 }
 
-/// Mapping function to convert bits-per-sample to byte arrays.
-template <size_t NBITS>
-const unsigned char* TranslateBits(ptrdiff_t& stride) {
-  static constexpr int kMask = (1 << NBITS) - 1;
-  static unsigned char mapping[256 * (8 / NBITS)];
-  [[maybe_unused]] static bool done = [&] {
-    unsigned char* dest = mapping;
-    for (int j = 0; j < 256; j++)
-      for (int i = NBITS - 1; i >= 0; i--) {
-        *(dest++) = static_cast<unsigned char>((j >> (NBITS * i)) & kMask);
-      }
-    return true;
-  }();
-
-  stride = 8 / NBITS;
-  return mapping;
-}
-
 struct TiffImageInfo : public ImageInfo {
   uint16_t extra_samples_ = 0;
   uint16_t extra_types_ = 0;
@@ -258,122 +241,101 @@ absl::Status GetTIFFImageInfo(TIFF* tiff, TiffImageInfo& info) {
   return absl::OkStatus();
 }
 
-absl::Status ReadStripImpl(TIFF* tiff, TiffImageInfo& info,
-                           tensorstore::span<unsigned char> data) {
-  ImageView dest_view(info, data);
-
-  // Translate 1,2,4 bits per sample to 8-bpp images.
-  const unsigned char* mapping = nullptr;
-  ptrdiff_t trstride = 1;
-  if (info.bits_per_sample_ == 1) {
-    mapping = TranslateBits<1>(trstride);
-  } else if (info.bits_per_sample_ == 2) {
-    mapping = TranslateBits<2>(trstride);
-  } else if (info.bits_per_sample_ == 4) {
-    mapping = TranslateBits<4>(trstride);
+/// Decodes the strips or tiles of the current directory that intersect
+/// `region` into `data`, which must be sized for `region`.
+absl::Status ReadRegionImpl(TIFF* tiff, const TiffImageInfo& info,
+                            const TiffReaderOptions::Region& region,
+                            tensorstore::span<unsigned char> data) {
+  ImageView dest_view(ImageInfo{/*.height=*/region.height,
+                                /*.width=*/region.width,
+                                /*.num_components=*/info.num_components,
+                                /*.dtype=*/info.dtype},
+                      data);
+  const size_t pixel_bytes = info.num_components * info.dtype.size();
+  const uint32_t bits_per_sample = info.bits_per_sample_;
+
+  // Strips are treated as tiles that span the full width of the image.
+  const bool tiled = TIFFIsTiled(tiff);
+  uint32_t block_width = info.width;
+  uint32_t block_height = 1;
+  tmsize_t block_bytes, block_row_bytes;
+  if (tiled) {
+    TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &block_width);
+    TIFFGetField(tiff, TIFFTAG_TILELENGTH, &block_height);
+    block_bytes = TIFFTileSize(tiff);
+    block_row_bytes = TIFFTileRowSize(tiff);
+  } else {
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &block_height);
+    block_height = std::min(block_height, static_cast<uint32_t>(info.height));
+    block_bytes = TIFFStripSize(tiff);
+    block_row_bytes = TIFFScanlineSize(tiff);
+  }
+  if (block_width == 0 || block_height == 0 || block_bytes <= 0 ||
+      block_row_bytes <= 0) {
+    return absl::DataLossError("TIFF read failed: invalid strip or tile size");
   }
 
-  const int strip_bytes = TIFFStripSize(tiff);
-  uint32_t rows_per_strip = 1;
-  TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
-
-  if (!mapping &&
-      strip_bytes == rows_per_strip * dest_view.row_stride_bytes()) {
-    /// No extra data && no mapping means that the TIFF can be read directly
-    /// into the output buffer.
-    for (size_t y = 0; y < info.height; y += rows_per_strip) {
-      // Read the strip.
+  const size_t region_y_end = region.y + region.height;
+  const size_t region_x_end = region.x + region.width;
+  const size_t first_block_y = region.y - region.y % block_height;
+  const size_t first_block_x = region.x - region.x % block_width;
+
+  // No extra data && no unpacking means that full-width strips can be read
+  // directly into the output buffer.
+  const bool direct = !tiled && bits_per_sample >= 8 && region.x == 0 &&
+                      region.width == info.width &&
+                      block_row_bytes == dest_view.row_stride_bytes();
+
+  std::unique_ptr<unsigned char[]> buffer;
+  for (size_t y = first_block_y; y < region_y_end; y += block_height) {
+    const size_t y_begin = std::max<size_t>(y, region.y);
+    const size_t y_end = std::min<size_t>(y + block_height, region_y_end);
+    if (direct && y_begin == y &&
+        (y_end == y + block_height || y_end == info.height)) {
+      // The strip lies entirely within the region.
       if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, y, 0),
-                               dest_view.data_row(y).data(),
-                               strip_bytes) == -1) {
+                               dest_view.data_row(y - region.y).data(),
+                               (y_end - y) * block_row_bytes) == -1) {
         return absl::DataLossError("TIFF read strip failed");
       }
+      continue;
     }
-    return absl::OkStatus();
-  }
-
-  std::unique_ptr<unsigned char[]> buffer(new unsigned char[strip_bytes]);
-  uint32_t line_bytes =
-      info.width * (info.bits_per_sample_ / 8) * info.num_components;
-
-  for (size_t y = 0; y < info.height; y += rows_per_strip) {
-    // Read the strip.
-    if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, y, 0), buffer.get(),
-                             strip_bytes) == -1) {
-      return absl::DataLossError("TIFF read strip failed");
-    }
-
-    unsigned char* source_row = buffer.get();
-    for (size_t r = 0; r < rows_per_strip; r++) {
-      if (y + r >= info.height) break;
-      auto target_row = dest_view.data_row(y + r);
-
-      if (info.bits_per_sample_ >= 8) {
-        assert(line_bytes == dest_view.row_stride_bytes());
-        memcpy(target_row.data(), source_row, line_bytes);
-        source_row += line_bytes;
-      } else {
-        while (!target_row.empty()) {
-          size_t n = std::min(trstride, target_row.size());
-          memcpy(target_row.data(), mapping + (*source_row * trstride), n);
-          target_row = target_row.subspan(n);
-          source_row++;
+    if (!buffer) buffer.reset(new unsigned char[block_bytes]);
+    for (size_t x = first_block_x; x < region_x_end; x += block_width) {
+      if (tiled) {
+        if (TIFFReadTile(tiff, buffer.get(), x, y, 0, 0) == -1) {
+          return absl::DataLossError("TIFF read tile failed");
         }
+      } else if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, y, 0),
+                                      buffer.get(), block_bytes) == -1) {
+        return absl::DataLossError("TIFF read strip failed");
       }
-    }
-  }
-  return absl::OkStatus();
-}
-
-absl::Status ReadTiledImpl(TIFF* tiff, TiffImageInfo& info,
-                           tensorstore::span<unsigned char> data) {
-  ImageView dest_view(info, data);
-
-  // Translate 1,2,4 bits per sample to 8-bpp images.
-  const unsigned char* mapping = nullptr;
-  ptrdiff_t trstride = 1;
-  if (info.bits_per_sample_ == 1) {
-    mapping = TranslateBits<1>(trstride);
-  } else if (info.bits_per_sample_ == 2) {
-    mapping = TranslateBits<2>(trstride);
-  } else if (info.bits_per_sample_ == 4) {
-    mapping = TranslateBits<4>(trstride);
-  }
-
-  uint32_t tile_width, tile_height;
-  TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tile_width);
-  TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tile_height);
-
-  const int tile_bytes = TIFFTileSize(tiff);
-  std::unique_ptr<unsigned char[]> tile_buffer(new unsigned char[tile_bytes]);
-  ImageView tile_view(ImageInfo{/*.height=*/static_cast<int32_t>(tile_height),
-                                /*.width=*/static_cast<int32_t>(tile_width),
-                                /*.num_components=*/info.num_components},
-                      {tile_buffer.get(), tile_bytes});
-
-  for (size_t y = 0; y < info.height; y += tile_height) {
-    for (size_t x = 0; x < info.width; x += tile_width) {
-      if (TIFFReadTile(tiff, tile_buffer.get(), x, y, 0, 0) == -1) {
-        return absl::DataLossError("TIFF read tile failed");
-      }
-      for (size_t y1 = 0; y1 < tile_height; y1++) {
-        if ((y + y1) >= info.height) break;
-        auto target_row = dest_view.data_row(y + y1, x);
-        auto tile_row = tile_view.data_row(y1);
-        if (info.bits_per_sample_ >= 8) {
-          memcpy(target_row.data(), tile_row.data(),
-                 std::min(target_row.size(), tile_row.size()));
-        } else {
-          unsigned char* packed = tile_row.data();
-          while (!target_row.empty()) {
-            size_t n = std::min(trstride, target_row.size());
-            memcpy(target_row.data(), mapping + (*packed * trstride), n);
-            target_row = target_row.subspan(n);
-            packed++;
-          }
-          assert(packed <= tile_row.data() + tile_row.size());
+      const size_t x_begin = std::max<size_t>(x, region.x);
+      const size_t x_end = std::min<size_t>(x + block_width, region_x_end);
+      for (size_t y1 = y_begin; y1 < y_end; ++y1) {
+        const unsigned char* source_row =
+            buffer.get() + (y1 - y) * block_row_bytes;
+        unsigned char* target =
+            dest_view
+                .data_row(y1 - region.y, (x_begin - region.x) * pixel_bytes)
+                .data();
+        if (bits_per_sample >= 8) {
+          std::memcpy(target, source_row + (x_begin - x) * pixel_bytes,
+                      (x_end - x_begin) * pixel_bytes);
+          continue;
+        }
+        // Unpack 1, 2, or 4 bits per sample to 8 bits per sample.  Samples
+        // are packed starting from the most significant bit.
+        const unsigned mask = (1u << bits_per_sample) - 1;
+        for (size_t sample = (x_begin - x) * info.num_components,
+                    sample_end = (x_end - x) * info.num_components;
+             sample < sample_end; ++sample) {
+          const size_t bit = sample * bits_per_sample;
+          *(target++) = static_cast<unsigned char>(
+              (source_row[bit / 8] >> (8 - bits_per_sample - bit % 8)) & mask);
         }
       }
+      if (!tiled) break;
     }
   }
   return absl::OkStatus();
@@ -424,10 +386,28 @@ absl::Status TiffReader::Context::Open() {
 }
 
 absl::Status TiffReader::Context::DefaultDecode(
-    tensorstore::span<unsigned char> data) {
+    tensorstore::span<unsigned char> data, const TiffReaderOptions& options) {
   TiffImageInfo info;
   TENSORSTORE_RETURN_IF_ERROR(GetTIFFImageInfo(tiff_, info));
-  ABSL_CHECK_EQ(data.size(), ImageRequiredBytes(info));
+  TiffReaderOptions::Region region{0, 0, info.height, info.width};
+  if (options.region) {
+    region = *options.region;
+    if (region.y < 0 || region.x < 0 || region.height < 0 ||
+        region.width < 0 || region.height > info.height - region.y ||
+        region.width > info.width - region.x) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "TIFF read failed: region [%d, %d) x [%d, %d) is not contained "
+          "within image of size %d x %d",
+          region.y, region.y + region.height, region.x,
+          region.x + region.width, info.height, info.width));
+    }
+  }
+  ABSL_CHECK_EQ(data.size(), ImageRequiredBytes(ImageInfo{
+                                 /*.height=*/region.height,
+                                 /*.width=*/region.width,
+                                 /*.num_components=*/info.num_components,
+                                 /*.dtype=*/info.dtype}));
+  if (region.height == 0 || region.width == 0) return absl::OkStatus();
 
   // Additional fields checks (beyond the info)
   uint32_t compress_tag = 0;
@@ -474,14 +454,7 @@ absl::Status TiffReader::Context::DefaultDecode(
     }
   }
 
-  absl::Status status;
-  if (TIFFIsTiled(tiff_)) {
-    status = ReadTiledImpl(tiff_, info, data);
-  } else {
-    status = ReadStripImpl(tiff_, info, data);
-  }
-
-  return ExtractErrors(status);
+  return ExtractErrors(ReadRegionImpl(tiff_, info, region, data));
 }
 
 TiffReader::TiffReader() = default;
@@ -534,7 +507,7 @@ absl::Status TiffReader::DecodeImpl(tensorstore::span<unsigned char> dest,
   if (!context_) {
     return absl::InternalError("No TIFF file to decode");
   }
-  return context_->DefaultDecode(dest);
+  return context_->DefaultDecode(dest, options);
 }
 
 }  // namespace internal_image
@@ -15,7 +15,10 @@
 #ifndef TENSORSTORE_INTERNAL_IMAGE_TIFF_READER_H_
 #define TENSORSTORE_INTERNAL_IMAGE_TIFF_READER_H_
 
+#include <stdint.h>
+
 #include <memory>
+#include <optional>
 
 #include "absl/status/status.h"
 #include "riegeli/bytes/reader.h"
@@ -26,7 +29,21 @@
 namespace tensorstore {
 namespace internal_image {
 
-struct TiffReaderOptions {};
+struct TiffReaderOptions {
+  /// Rectangular region of an image, in pixels.
+  struct Region {
+    int32_t y = 0;
+    int32_t x = 0;
+    int32_t height = 0;
+    int32_t width = 0;
+  };
+
+  /// If specified, only this region of the image is decoded, and the
+  /// destination must be sized for the region rather than the entire image.
+  /// Only the strips or tiles that intersect the region are read and
+  /// decompressed.
+  std::optional<Region> region;
+};
 
 class TiffReader : public ImageReader {
  public:
@@ -18,11 +18,13 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/fd_reader.h"
@@ -43,6 +45,7 @@ namespace {
 
 using ::tensorstore::internal_image::ImageInfo;
 using ::tensorstore::internal_image::TiffReader;
+using ::tensorstore::internal_image::TiffReaderOptions;
 using ::tensorstore::internal_image::TiffWriter;
 using ::tensorstore::internal_image::TiffWriterOptions;
 
@@ -195,6 +198,67 @@ TEST_F(TiffTest, ReadMultiPage) {
   }
 }
 
+TEST_F(TiffTest, DecodeRegion) {
+  for (std::string_view name :
+       {"D75_01b.tiff", "D75_08b.tiff", "D75_08b_tiled.tiff",
+        "D75_08b_scanline.tiff", "D75_08b_lzw.tiff", "D75_16b.tiff"}) {
+    SCOPED_TRACE(name);
+    absl::Cord file_data;
+    TENSORSTORE_ASSERT_OK(riegeli::ReadAll(
+        riegeli::FdReader(tensorstore::internal::JoinPath(
+            absl::GetFlag(FLAGS_tensorstore_test_data_dir), "tiff", name)),
+        file_data));
+
+    riegeli::CordReader cord_reader(&file_data);
+    TiffReader decoder;
+    ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+    const ImageInfo info = decoder.GetImageInfo();
+    std::vector<unsigned char> image(ImageRequiredBytes(info));
+    ASSERT_THAT(decoder.Decode(image), ::tensorstore::IsOk());
+
+    TiffReaderOptions options;
+    options.region = TiffReaderOptions::Region{/*.y=*/37, /*.x=*/101,
+                                               /*.height=*/60, /*.width=*/150};
+    const auto& region = *options.region;
+    const ImageInfo region_info{region.height, region.width,
+                                info.num_components, info.dtype};
+    std::vector<unsigned char> region_image(ImageRequiredBytes(region_info));
+    ASSERT_THAT(decoder.Decode(region_image, options), ::tensorstore::IsOk());
+
+    const size_t pixel_bytes = info.num_components * info.dtype.size();
+    const size_t row_bytes = info.width * pixel_bytes;
+    const size_t region_row_bytes = region.width * pixel_bytes;
+    for (int32_t y = 0; y < region.height; ++y) {
+      const auto* expected =
+          image.data() + (region.y + y) * row_bytes + region.x * pixel_bytes;
+      EXPECT_THAT(tensorstore::span(region_image.data() + y * region_row_bytes,
+                                    region_row_bytes),
+                  ::testing::ElementsAreArray(expected, region_row_bytes))
+          << "y=" << y;
+    }
+  }
+}
+
+TEST_F(TiffTest, DecodeRegionOutOfBounds) {
+  absl::Cord file_data;
+  TENSORSTORE_ASSERT_OK(riegeli::ReadAll(
+      riegeli::FdReader(tensorstore::internal::JoinPath(
+          absl::GetFlag(FLAGS_tensorstore_test_data_dir),
+          "tiff/D75_08b_tiled.tiff")),
+      file_data));
+  riegeli::CordReader cord_reader(&file_data);
+  TiffReader decoder;
+  ASSERT_THAT(decoder.Initialize(&cord_reader), ::tensorstore::IsOk());
+
+  TiffReaderOptions options;
+  options.region = TiffReaderOptions::Region{/*.y=*/100, /*.x=*/0,
+                                             /*.height=*/100, /*.width=*/10};
+  std::vector<unsigned char> region_image(100 * 10 * 3);
+  EXPECT_THAT(decoder.Decode(region_image, options),
+              tensorstore::MatchesStatus(absl::StatusCode::kInvalidArgument,
+                                         ".*not contained.*"));
+}
+
 TEST_F(TiffTest, CorruptData) {
   static constexpr unsigned char data[] = {
       0x49, 0x49, 0x2a, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00,
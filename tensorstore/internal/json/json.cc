@@ -27,7 +27,9 @@
 #include "absl/strings/str_join.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/index.h"
+#include "tensorstore/internal/json/parser.h"
 #include "tensorstore/internal/json/value_as.h"
+#include "tensorstore/internal/tracing/stage.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
@@ -52,7 +54,8 @@ absl::Status JsonExtraMembersError(const ::nlohmann::json::object_t& j_obj) {
 }
 
 ::nlohmann::json ParseJson(std::string_view str) {
-  return ::nlohmann::json::parse(str, nullptr, false);
+  internal_tracing::StageScope stage(internal_tracing::Stage::kJson);
+  return ParseJsonText(str);
 }
 
 absl::Status JsonParseArray(
@@ -0,0 +1,404 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/json/parser.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>  // NOLINT
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/charconv.h"
+#include <nlohmann/json.hpp>
+
+namespace tensorstore {
+namespace internal_json {
+namespace {
+
+using ::nlohmann::json;
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+void AppendUtf8(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xc0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xe0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  }
+}
+
+/// Recursive-descent JSON parser, using an explicit stack in place of
+/// recursion.
+///
+/// The accepted grammar matches that of `nlohmann::json::parse`: RFC 8259,
+/// with strings required to be valid UTF-8, an optional leading UTF-8 byte
+/// order mark, and later values for duplicate object members replacing
+/// earlier ones.
+class Parser {
+ public:
+  explicit Parser(std::string_view text)
+      : p_(text.data()), end_(text.data() + text.size()) {}
+
+  bool Parse(json& result);
+
+ private:
+  void SkipWhitespace() {
+    while (p_ != end_ &&
+           (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+      ++p_;
+    }
+  }
+
+  // Parses `"key":` and sets `value` to the member for `key` of `object`.
+  bool ParseMemberName(json& object, json*& value);
+
+  bool ParseLiteral(std::string_view literal) {
+    if (static_cast<size_t>(end_ - p_) < literal.size() ||
+        std::memcmp(p_, literal.data(), literal.size()) != 0) {
+      return false;
+    }
+    p_ += literal.size();
+    return true;
+  }
+
+  bool ParseString(std::string& out);
+  bool ParseEscape(std::string& out);
+  bool ParseHex4(uint32_t& code_unit);
+  bool SkipUtf8Sequence();
+  bool ParseNumber(json& out);
+
+  const char* p_;
+  const char* end_;
+};
+
+bool Parser::Parse(json& result) {
+  if (end_ - p_ >= 3 && std::memcmp(p_, "\xEF\xBB\xBF", 3) == 0) {
+    p_ += 3;
+  }
+  // Arrays and objects that have been started but not yet completed.
+  absl::InlinedVector<json*, 16> stack;
+  // Location at which the next value is stored.
+  json* value = &result;
+  while (true) {
+    SkipWhitespace();
+    if (p_ == end_) return false;
+    switch (*p_) {
+      case '{':
+        ++p_;
+        *value = json::object_t();
+        SkipWhitespace();
+        if (p_ != end_ && *p_ == '}') {
+          ++p_;
+          break;
+        }
+        stack.push_back(value);
+        if (!ParseMemberName(*value, value)) return false;
+        continue;
+      case '[':
+        ++p_;
+        *value = json::array_t();
+        SkipWhitespace();
+        if (p_ != end_ && *p_ == ']') {
+          ++p_;
+          break;
+        }
+        stack.push_back(value);
+        value = &value->get_ref<json::array_t&>().emplace_back();
+        continue;
+      case '"': {
+        std::string s;
+        if (!ParseString(s)) return false;
+        *value = std::move(s);
+        break;
+      }
+      case 't':
+        if (!ParseLiteral("true")) return false;
+        *value = true;
+        break;
+      case 'f':
+        if (!ParseLiteral("false")) return false;
+        *value = false;
+        break;
+      case 'n':
+        if (!ParseLiteral("null")) return false;
+        *value = nullptr;
+        break;
+      default:
+        if (!ParseNumber(*value)) return false;
+        break;
+    }
+    // A value has been completed; continue with the innermost incomplete
+    // array or object.
+    while (true) {
+      SkipWhitespace();
+      if (stack.empty()) return p_ == end_;
+      if (p_ == end_) return false;
+      json& container = *stack.back();
+      const char c = *p_++;
+      if (container.is_object()) {
+        if (c == ',') {
+          if (!ParseMemberName(container, value)) return false;
+          break;
+        }
+        if (c != '}') return false;
+      } else {
+        if (c == ',') {
+          // Only the innermost container is modified, so pointers to the
+          // values on `stack` remain valid.
+          value = &container.get_ref<json::array_t&>().emplace_back();
+          break;
+        }
+        if (c != ']') return false;
+      }
+      stack.pop_back();
+    }
+  }
+}
+
+bool Parser::ParseMemberName(json& object, json*& value) {
+  SkipWhitespace();
+  if (p_ == end_ || *p_ != '"') return false;
+  std::string key;
+  if (!ParseString(key)) return false;
+  SkipWhitespace();
+  if (p_ == end_ || *p_ != ':') return false;
+  ++p_;
+  // Members are commonly in sorted order (as written by `json::dump`), in
+  // which case inserting with a hint of `end()` takes constant time.
+  auto& members = object.get_ref<json::object_t&>();
+  value = &members.try_emplace(members.end(), std::move(key))->second;
+  return true;
+}
+
+bool Parser::ParseString(std::string& out) {
+  ++p_;  // Opening quote.
+  // Start of the run of characters that can be copied unchanged.
+  const char* run_start = p_;
+  while (true) {
+    if (p_ == end_) return false;
+    const unsigned char c = *p_;
+    if (c == '"') {
+      out.append(run_start, p_);
+      ++p_;
+      return true;
+    }
+    if (c == '\\') {
+      out.append(run_start, p_);
+      if (!ParseEscape(out)) return false;
+      run_start = p_;
+    } else if (c < 0x20) {
+      // Control characters must be escaped.
+      return false;
+    } else if (c < 0x80) {
+      ++p_;
+    } else if (!SkipUtf8Sequence()) {
+      return false;
+    }
+  }
+}
+
+bool Parser::ParseEscape(std::string& out) {
+  ++p_;  // Backslash.
+  if (p_ == end_) return false;
+  switch (*p_++) {
+    case '"':
+      out += '"';
+      return true;
+    case '\\':
+      out += '\\';
+      return true;
+    case '/':
+      out += '/';
+      return true;
+    case 'b':
+      out += '\b';
+      return true;
+    case 'f':
+      out += '\f';
+      return true;
+    case 'n':
+      out += '\n';
+      return true;
+    case 'r':
+      out += '\r';
+      return true;
+    case 't':
+      out += '\t';
+      return true;
+    case 'u':
+      break;
+    default:
+      return false;
+  }
+  uint32_t code_point;
+  if (!ParseHex4(code_point)) return false;
+  if (code_point >= 0xd800 && code_point <= 0xdbff) {
+    // A high surrogate must be followed by an escaped low surrogate.
+    if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') return false;
+    p_ += 2;
+    uint32_t low;
+    if (!ParseHex4(low)) return false;
+    if (low < 0xdc00 || low > 0xdfff) return false;
+    code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+  } else if (code_point >= 0xdc00 && code_point <= 0xdfff) {
+    return false;
+  }
+  AppendUtf8(out, code_point);
+  return true;
+}
+
+bool Parser::ParseHex4(uint32_t& code_unit) {
+  if (end_ - p_ < 4) return false;
+  code_unit = 0;
+  for (int i = 0; i < 4; ++i) {
+    const char c = *p_++;
+    uint32_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    code_unit = (code_unit << 4) | digit;
+  }
+  return true;
+}
+
+// Validates a multi-byte UTF-8 sequence, as specified by RFC 3629, which
+// excludes overlong encodings, surrogates, and code points above U+10FFFF.
+bool Parser::SkipUtf8Sequence() {
+  const unsigned char c = *p_;
+  // Number of continuation bytes, and the range of the first one.
+  int n = 0;
+  unsigned char lo = 0x80, hi = 0xbf;
+  if (c >= 0xc2 && c <= 0xdf) {
+    n = 1;
+  } else if (c == 0xe0) {
+    n = 2;
+    lo = 0xa0;
+  } else if ((c >= 0xe1 && c <= 0xec) || c == 0xee || c == 0xef) {
+    n = 2;
+  } else if (c == 0xed) {
+    n = 2;
+    hi = 0x9f;
+  } else if (c == 0xf0) {
+    n = 3;
+    lo = 0x90;
+  } else if (c >= 0xf1 && c <= 0xf3) {
+    n = 3;
+  } else if (c == 0xf4) {
+    n = 3;
+    hi = 0x8f;
+  } else {
+    return false;
+  }
+  if (end_ - p_ <= n) return false;
+  ++p_;
+  for (int i = 0; i < n; ++i, lo = 0x80, hi = 0xbf) {
+    const unsigned char b = *p_++;
+    if (b < lo || b > hi) return false;
+  }
+  return true;
+}
+
+bool Parser::ParseNumber(json& out) {
+  const char* start = p_;
+  const bool negative = (*p_ == '-');
+  if (negative) ++p_;
+  if (p_ == end_) return false;
+  if (*p_ == '0') {
+    ++p_;
+  } else if (IsDigit(*p_)) {
+    while (p_ != end_ && IsDigit(*p_)) ++p_;
+  } else {
+    return false;
+  }
+  bool is_integer = true;
+  if (p_ != end_ && *p_ == '.') {
+    ++p_;
+    is_integer = false;
+    if (p_ == end_ || !IsDigit(*p_)) return false;
+    while (p_ != end_ && IsDigit(*p_)) ++p_;
+  }
+  if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+    ++p_;
+    is_integer = false;
+    if (p_ != end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+    if (p_ == end_ || !IsDigit(*p_)) return false;
+    while (p_ != end_ && IsDigit(*p_)) ++p_;
+  }
+  if (is_integer) {
+    // As with `nlohmann::json`, non-negative integers are stored as unsigned
+    // and negative integers as signed, and integers out of range of either
+    // are stored as floating point.
+    if (negative) {
+      int64_t v;
+      if (std::from_chars(start, p_, v).ec == std::errc()) {
+        out = v;
+        return true;
+      }
+    } else {
+      uint64_t v;
+      if (std::from_chars(start, p_, v).ec == std::errc()) {
+        out = v;
+        return true;
+      }
+    }
+  }
+  // As with `nlohmann::json`, values that overflow are rejected while values
+  // that underflow are rounded to zero.
+  double v = 0;
+  const auto ec = absl::from_chars(start, p_, v).ec;
+  if (ec == std::errc::invalid_argument) return false;
+  if (ec == std::errc::result_out_of_range) {
+    if (v != 0) return false;
+  } else if (!std::isfinite(v)) {
+    return false;
+  }
+  out = v;
+  return true;
+}
+
+}  // namespace
+
+::nlohmann::json ParseJsonText(std::string_view text) {
+  json result;
+  if (!Parser(text).Parse(result)) {
+    return json(json::value_t::discarded);
+  }
+  return result;
+}
+
+}  // namespace internal_json
+}  // namespace tensorstore
@@ -0,0 +1,67 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/json/parser.h"
+
+namespace {
+
+using ::tensorstore::internal_json::ParseJsonText;
+
+// Returns a spec-like JSON text of approximately `size` bytes, with a large
+// `attributes` member.
+std::string MakeJsonText(size_t size) {
+  ::nlohmann::json attributes = ::nlohmann::json::object_t();
+  for (size_t i = 0, total_size = 0; total_size < size; ++i) {
+    auto& attribute = attributes["attribute_" + std::to_string(i)];
+    attribute = {
+        {"name", "value " + std::to_string(i)},
+        {"scale", {1.5 * i, 2.0, -3.25e-3}},
+        {"shape", {i, 1024, 1024}},
+        {"enabled", i % 2 == 0},
+    };
+    total_size += attribute.dump().size();
+  }
+  return ::nlohmann::json{
+      {"driver", "zarr3"},
+      {"kvstore", {{"driver", "file"}, {"path", "/tmp/dataset/"}}},
+      {"metadata", {{"shape", {1000, 2000}}, {"attributes", attributes}}},
+  }
+      .dump();
+}
+
+void BM_ParseJsonText(benchmark::State& state) {
+  const std::string text = MakeJsonText(state.range(0));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(ParseJsonText(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ParseJsonText)->Range(1 << 10, 1 << 20);
+
+void BM_NlohmannParse(benchmark::State& state) {
+  const std::string text = MakeJsonText(state.range(0));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(::nlohmann::json::parse(text, nullptr, false));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_NlohmannParse)->Range(1 << 10, 1 << 20);
+
+}  // namespace
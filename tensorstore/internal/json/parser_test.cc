@@ -0,0 +1,180 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/json/parser.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/random/random.h"
+#include <nlohmann/json.hpp>
+
+namespace {
+
+using ::tensorstore::internal_json::ParseJsonText;
+
+// Checks that `ParseJsonText` behaves identically to `nlohmann::json::parse`.
+void TestEquivalent(std::string_view text) {
+  SCOPED_TRACE(text);
+  auto expected = ::nlohmann::json::parse(text, nullptr, false);
+  auto actual = ParseJsonText(text);
+  ASSERT_EQ(expected.is_discarded(), actual.is_discarded());
+  if (expected.is_discarded()) return;
+  // `operator==` does not distinguish the numeric types.
+  EXPECT_EQ(expected.dump(), actual.dump());
+}
+
+TEST(ParseJsonTextTest, Scalars) {
+  EXPECT_EQ(::nlohmann::json(nullptr), ParseJsonText("null"));
+  EXPECT_EQ(::nlohmann::json(true), ParseJsonText(" true "));
+  EXPECT_EQ(::nlohmann::json(false), ParseJsonText("\tfalse\r\n"));
+  EXPECT_EQ(::nlohmann::json("abc"), ParseJsonText("\"abc\""));
+  EXPECT_TRUE(ParseJsonText("").is_discarded());
+  EXPECT_TRUE(ParseJsonText("nul").is_discarded());
+  EXPECT_TRUE(ParseJsonText("truex").is_discarded());
+  EXPECT_TRUE(ParseJsonText("1 2").is_discarded());
+}
+
+TEST(ParseJsonTextTest, Numbers) {
+  auto j = ParseJsonText("1");
+  EXPECT_TRUE(j.is_number_unsigned());
+  EXPECT_EQ(1, j.get<uint64_t>());
+  j = ParseJsonText("-1");
+  EXPECT_TRUE(j.is_number_integer());
+  EXPECT_FALSE(j.is_number_unsigned());
+  EXPECT_EQ(-1, j.get<int64_t>());
+  j = ParseJsonText("18446744073709551615");
+  EXPECT_TRUE(j.is_number_unsigned());
+  EXPECT_EQ(18446744073709551615u, j.get<uint64_t>());
+  EXPECT_TRUE(ParseJsonText("18446744073709551616").is_number_float());
+  EXPECT_TRUE(ParseJsonText("-9223372036854775809").is_number_float());
+  EXPECT_EQ(1.5, ParseJsonText("1.5").get<double>());
+  EXPECT_EQ(-1.5e10, ParseJsonText("-15E+9").get<double>());
+  EXPECT_EQ(0.0, ParseJsonText("1e-400").get<double>());
+  EXPECT_TRUE(ParseJsonText("1e400").is_discarded());
+  TestEquivalent("1e400");
+  TestEquivalent("-1e-400");
+  for (std::string_view text :
+       {"01", "-", "+1", "1.", ".5", "1e", "1e+", "-a", "0x1", "NaN"}) {
+    EXPECT_TRUE(ParseJsonText(text).is_discarded()) << text;
+  }
+}
+
+TEST(ParseJsonTextTest, Strings) {
+  EXPECT_EQ(::nlohmann::json("a\"\\/\b\f\n\r\t"),
+            ParseJsonText(R"("a\"\\\/\b\f\n\r\t")"));
+  EXPECT_EQ(::nlohmann::json("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"),
+            ParseJsonText(R"("\u00e9\u20AC\ud83d\ude00")"));
+  EXPECT_EQ(::nlohmann::json(std::string("\0", 1)),
+            ParseJsonText(R"("\u0000")"));
+  for (std::string_view text : {
+           "\"abc",                 // Unterminated
+           "\"\\x\"",               // Invalid escape
+           "\"\\u12\"",             // Truncated escape
+           "\"\\ud83d\"",           // Unpaired high surrogate
+           "\"\\ude00\"",           // Unpaired low surrogate
+           "\"\\ud83d\\u0041\"",    // Invalid low surrogate
+           "\"\x01\"",              // Unescaped control character
+           "\"\xC3\"",              // Truncated UTF-8
+           "\"\xC0\x80\"",          // Overlong UTF-8
+           "\"\xED\xA0\x80\"",      // UTF-8 encoded surrogate
+           "\"\xF4\x90\x80\x80\"",  // Above U+10FFFF
+           "\"\xFF\"",
+       }) {
+    EXPECT_TRUE(ParseJsonText(text).is_discarded()) << text;
+    TestEquivalent(text);
+  }
+}
+
+TEST(ParseJsonTextTest, Containers) {
+  const ::nlohmann::json empty_array = ::nlohmann::json::array_t();
+  EXPECT_EQ(::nlohmann::json::array_t(), ParseJsonText("[ ]"));
+  EXPECT_EQ(::nlohmann::json::object_t(), ParseJsonText("{ }"));
+  EXPECT_EQ(::nlohmann::json({{"a", {1, {{"b", nullptr}}, empty_array}},
+                              {"c", "x"}}),
+            ParseJsonText(R"({"a": [1, {"b": null}, []], "c": "x"})"));
+  // Later values of duplicate members replace earlier values.
+  EXPECT_EQ(::nlohmann::json({{"a", 2}}), ParseJsonText(R"({"a":1,"a":2})"));
+  for (std::string_view text :
+       {"[", "[1", "[1,", "[1,]", "[,]", "{", "{\"a\"", "{\"a\":",
+        "{\"a\":1,}", "{a:1}", "{\"a\" 1}", "[1}", "{\"a\":1]", "]"}) {
+    EXPECT_TRUE(ParseJsonText(text).is_discarded()) << text;
+  }
+}
+
+TEST(ParseJsonTextTest, ByteOrderMark) {
+  EXPECT_EQ(::nlohmann::json(1), ParseJsonText("\xEF\xBB\xBF 1"));
+  TestEquivalent("\xEF\xBB\xBF 1");
+  TestEquivalent("\xEF\xBB 1");
+}
+
+TEST(ParseJsonTextTest, DeeplyNested) {
+  constexpr size_t kDepth = 100000;
+  std::string text(kDepth, '[');
+  text.append(kDepth, ']');
+  auto j = ParseJsonText(text);
+  ASSERT_TRUE(j.is_array());
+  EXPECT_EQ(1, j.size());
+}
+
+TEST(ParseJsonTextTest, Equivalent) {
+  for (std::string_view text : {
+           R"({"driver": "zarr3", "kvstore": {"driver": "memory"}})",
+           R"({"zarr_format": 3, "shape": [100, 200],
+               "chunk_grid": {"name": "regular",
+                              "configuration": {"chunk_shape": [10, 20]}},
+               "fill_value": -0.0, "attributes": {"x": [1e3, 2.5E-3]}})",
+           "[-0, 0, -0.0, 1E0, 123456789012345678901234567890]",
+           "[4.9406564584124654e-324, 2.2250738585072014e-308]",
+           "[1.7976931348623157e308, 0.1, 1e23]",
+           "\"\\u00e9\xC3\xA9\"",
+       }) {
+    TestEquivalent(text);
+  }
+}
+
+// Compares the parsers on random mutations of valid JSON.
+TEST(ParseJsonTextTest, RandomMutations) {
+  constexpr std::string_view kBase =
+      R"({"a": [1, -2.5e3, true, false, null, "x\u00e9\n"], "b": {}})";
+  constexpr std::string_view kAlphabet = "{}[],:\"\\ 0123456789.eE+-tfnu\x80";
+  absl::BitGen gen;
+  for (int i = 0; i < 10000; ++i) {
+    std::string text(kBase);
+    const int num_mutations = absl::Uniform(gen, 1, 4);
+    for (int m = 0; m < num_mutations; ++m) {
+      const size_t pos = absl::Uniform<size_t>(gen, 0, text.size());
+      const char c = kAlphabet[absl::Uniform<size_t>(gen, 0, kAlphabet.size())];
+      switch (absl::Uniform(gen, 0, 3)) {
+        case 0:
+          text[pos] = c;
+          break;
+        case 1:
+          text.insert(pos, 1, c);
+          break;
+        default:
+          text.erase(pos, 1);
+          break;
+      }
+    }
+    TestEquivalent(text);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,102 @@
+// Copyright 2020 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// Benchmarks the cost of registering JSON-serializable types, which is
+/// incurred by every program during static initialization, and of the first
+/// lookup after registration.
+
+#include <stddef.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_registry.h"
+#include "tensorstore/json_serialization_options.h"
+
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+using ::tensorstore::internal::IntrusivePtr;
+using ::tensorstore::internal::JsonRegistry;
+
+class Base : public tensorstore::internal::AtomicReferenceCount<Base> {
+ public:
+  virtual ~Base() = default;
+};
+
+template <size_t I>
+class Derived : public Base {
+ public:
+  int x;
+};
+
+using Registry =
+    JsonRegistry<Base, tensorstore::JsonSerializationOptions,
+                 tensorstore::JsonSerializationOptions, IntrusivePtr<Base>>;
+
+// Comparable to the number of drivers, kvstores, codecs and compressors
+// registered when linking all of TensorStore.
+constexpr size_t kNumTypes = 256;
+
+template <size_t... I>
+void RegisterAll(Registry& registry, const std::vector<std::string>& ids,
+                 std::index_sequence<I...>) {
+  (registry.Register<Derived<I>>(
+       ids[I], jb::Object(jb::Member("x", jb::Projection(&Derived<I>::x)))),
+   ...);
+}
+
+std::vector<std::string> MakeIds() {
+  std::vector<std::string> ids;
+  for (size_t i = 0; i < kNumTypes; ++i) {
+    ids.push_back("driver_" + std::to_string(i));
+  }
+  return ids;
+}
+
+void BM_Register(benchmark::State& state) {
+  const auto ids = MakeIds();
+  for (auto s : state) {
+    Registry registry;
+    RegisterAll(registry, ids, std::make_index_sequence<kNumTypes>());
+    benchmark::DoNotOptimize(registry);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTypes);
+}
+BENCHMARK(BM_Register);
+
+void BM_RegisterAndFirstLookup(benchmark::State& state) {
+  const auto ids = MakeIds();
+  const ::nlohmann::json j{{"id", "driver_7"}, {"x", 1}};
+  for (auto s : state) {
+    Registry registry;
+    RegisterAll(registry, ids, std::make_index_sequence<kNumTypes>());
+    IntrusivePtr<Base> obj;
+    ::nlohmann::json j_copy = j;
+    auto status = jb::Object(registry.MemberBinder("id"))(
+        std::true_type{}, tensorstore::JsonSerializationOptions{}, &obj,
+        &j_copy);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumTypes);
+}
+BENCHMARK(BM_RegisterAndFirstLookup);
+
+}  // namespace
@@ -14,6 +14,9 @@
 
 #include "tensorstore/internal/json_registry_impl.h"
 
+#include <stddef.h>
+
+#include <atomic>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -21,6 +24,7 @@
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_log.h"
@@ -42,33 +46,75 @@ absl::Status GetJsonUnregisteredError(std::string_view id) {
       tensorstore::StrCat(QuoteString(id), " is not registered"));
 }
 
+JsonRegistryImpl::~JsonRegistryImpl() {
+  for (Entry* entry = pending_.load(std::memory_order_acquire); entry;) {
+    delete std::exchange(entry, entry->next_pending);
+  }
+}
+
 void JsonRegistryImpl::Register(std::unique_ptr<Entry> entry) {
+  Entry* e = entry.release();
+  e->next_pending = pending_.load(std::memory_order_relaxed);
+  while (!pending_.compare_exchange_weak(e->next_pending, e,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+void JsonRegistryImpl::IndexPendingEntries() const {
+  if (!pending_.load(std::memory_order_acquire)) return;
   absl::WriterMutexLock lock(&mutex_);
-  {
-    auto [it, inserted] = entries_by_type_.insert(entry.get());
-    if (!inserted) {
-      ABSL_LOG(FATAL) << (*it)->type->name() << " already registered";
-    }
+  // Index in order of registration, such that the error for a duplicate
+  // registration refers to the later registration.
+  std::vector<Entry*> entries;
+  for (Entry* entry = pending_.exchange(nullptr, std::memory_order_acquire);
+       entry; entry = entry->next_pending) {
+    entries.push_back(entry);
   }
-  {
-    auto [it, inserted] = entries_.insert(std::move(entry));
-    if (!inserted) {
-      ABSL_LOG(FATAL) << QuoteString((*it)->id) << " already registered";
+  entries_.reserve(entries_.size() + entries.size());
+  entries_by_type_.reserve(entries_by_type_.size() + entries.size());
+  for (size_t i = entries.size(); i--;) {
+    std::unique_ptr<Entry> entry(entries[i]);
+    entry->next_pending = nullptr;
+    {
+      auto [it, inserted] = entries_by_type_.insert(entry.get());
+      if (!inserted) {
+        ABSL_LOG(FATAL) << (*it)->type->name() << " already registered";
+      }
+    }
+    {
+      auto [it, inserted] = entries_.insert(std::move(entry));
+      if (!inserted) {
+        ABSL_LOG(FATAL) << QuoteString((*it)->id) << " already registered";
+      }
     }
   }
 }
 
+const JsonRegistryImpl::Entry* JsonRegistryImpl::FindById(
+    std::string_view id) const {
+  IndexPendingEntries();
+  absl::ReaderMutexLock lock(&mutex_);
+  if (auto it = entries_.find(id); it != entries_.end()) {
+    return it->get();
+  }
+  return nullptr;
+}
+
+const JsonRegistryImpl::Entry* JsonRegistryImpl::FindByType(
+    std::type_index type) const {
+  IndexPendingEntries();
+  absl::ReaderMutexLock lock(&mutex_);
+  if (auto it = entries_by_type_.find(type); it != entries_by_type_.end()) {
+    return *it;
+  }
+  return nullptr;
+}
+
 absl::Status JsonRegistryImpl::LoadKey(void* obj, ::nlohmann::json* j) const {
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto id, internal_json_binding::FromJson<std::string>(std::move(*j)));
-  const Entry* entry = nullptr;
-  {
-    absl::ReaderMutexLock lock(&mutex_);
-    if (auto it = entries_.find(id); it != entries_.end()) {
-      entry = it->get();
-    }
-  }
-  if (entry) {
+  if (const Entry* entry = FindById(id)) {
     entry->allocate(obj);
   } else {
     return internal_json_registry::GetJsonUnregisteredError(id);
@@ -78,14 +124,7 @@ absl::Status JsonRegistryImpl::LoadKey(void* obj, ::nlohmann::json* j) const {
 
 absl::Status JsonRegistryImpl::SaveKey(std::type_index type,
                                        ::nlohmann::json* j) const {
-  const Entry* entry = nullptr;
-  {
-    absl::ReaderMutexLock lock(&mutex_);
-    if (auto it = entries_by_type_.find(type); it != entries_by_type_.end()) {
-      entry = *it;
-    }
-  }
-  if (entry) {
+  if (const Entry* entry = FindByType(type)) {
     *j = entry->id;
   } else {
     return absl::UnimplementedError("JSON representation not supported");
@@ -96,14 +135,7 @@ absl::Status JsonRegistryImpl::SaveKey(std::type_index type,
 absl::Status JsonRegistryImpl::LoadRegisteredObject(
     std::type_index type, const void* options, const void* obj,
     ::nlohmann::json::object_t* j_obj) const {
-  const Entry* entry = nullptr;
-  {
-    absl::ReaderMutexLock lock(&mutex_);
-    if (auto it = entries_by_type_.find(type); it != entries_by_type_.end()) {
-      entry = *it;
-    }
-  }
-  if (entry) {
+  if (const Entry* entry = FindByType(type)) {
     return entry->binder(std::true_type{}, options, obj, j_obj);
   }
   return absl::OkStatus();
@@ -112,14 +144,7 @@ absl::Status JsonRegistryImpl::LoadRegisteredObject(
 absl::Status JsonRegistryImpl::SaveRegisteredObject(
     std::type_index type, const void* options, const void* obj,
     ::nlohmann::json::object_t* j_obj) const {
-  const Entry* entry = nullptr;
-  {
-    absl::ReaderMutexLock lock(&mutex_);
-    if (auto it = entries_by_type_.find(type); it != entries_by_type_.end()) {
-      entry = *it;
-    }
-  }
-  if (entry) {
+  if (const Entry* entry = FindByType(type)) {
     return entry->binder(std::false_type{}, options, obj, j_obj);
   }
   return absl::OkStatus();
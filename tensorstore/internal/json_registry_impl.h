@@ -17,8 +17,10 @@
 
 /// Implementation details for `json_registry.h`.
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <typeindex>
 #include <typeinfo>
 
@@ -77,11 +79,23 @@ class JsonRegistryImpl {
                absl::Status(std::false_type is_loading, const void* options,
                             const void* obj, ::nlohmann::json::object_t*) const>
         binder;
+
+    /// Next entry in the list of entries that have not yet been indexed.
+    Entry* next_pending = nullptr;
   };
 
+  JsonRegistryImpl() = default;
+  ~JsonRegistryImpl();
+
   /// Registers an object type.
   ///
-  /// Logs a fatal error if the type or id is already registered.
+  /// Since most registrations happen during static initialization, and many
+  /// programs use only a few of the registered types, this just adds `entry`
+  /// to a lock-free list of pending entries; they are indexed by id and type
+  /// upon the first lookup.
+  ///
+  /// Logs a fatal error, upon the next lookup, if the type or id is already
+  /// registered.
   void Register(std::unique_ptr<Entry> entry);
 
   /// Initializes a `BasePtr` from a JSON representation of the object
@@ -121,14 +135,24 @@ class JsonRegistryImpl {
                                     ::nlohmann::json::object_t* j_obj) const;
 
  private:
+  /// Adds any pending entries to `entries_` and `entries_by_type_`.
+  void IndexPendingEntries() const;
+
+  const Entry* FindById(std::string_view id) const;
+  const Entry* FindByType(std::type_index type) const;
+
+  /// Registered entries not yet added to `entries_` and `entries_by_type_`,
+  /// in reverse order of registration.
+  mutable std::atomic<Entry*> pending_{nullptr};
+
   mutable absl::Mutex mutex_;
   // Allows lookup of entries by string identifier rather than pointer identity.
-  internal::HeterogeneousHashSet<std::unique_ptr<Entry>, std::string_view,
-                                 &Entry::id>
+  mutable internal::HeterogeneousHashSet<std::unique_ptr<Entry>,
+                                         std::string_view, &Entry::id>
       entries_ ABSL_GUARDED_BY(mutex_);
   // Allows lookup of entries by `std::type_index` rather than pointer identity.
-  internal::HeterogeneousHashSet<const Entry*, std::type_index,
-                                 &Entry::type_index>
+  mutable internal::HeterogeneousHashSet<const Entry*, std::type_index,
+                                         &Entry::type_index>
       entries_by_type_ ABSL_GUARDED_BY(mutex_);
 };
 
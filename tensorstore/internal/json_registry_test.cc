@@ -112,4 +112,24 @@ TEST(RegistryTest, Unknown) {
                             "\"baz\" is not registered"));
 }
 
+class QuxImpl : public MyInterface {
+ public:
+  int z;
+  int Whatever() const override { return z; }
+};
+
+TEST(RegistryTest, RegisterAfterLookup) {
+  namespace jb = tensorstore::internal_json_binding;
+  EXPECT_THAT(MyInterfacePtr::FromJson({{"id", "qux"}, {"z", 3}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"qux\" is not registered"));
+  // Registrations are indexed lazily, including those after the first lookup.
+  GetRegistry().Register<QuxImpl>(
+      "qux", jb::Object(jb::Member("z", jb::Projection(&QuxImpl::z))));
+  const ::nlohmann::json j{{"id", "qux"}, {"z", 3}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto obj, MyInterfacePtr::FromJson(j));
+  EXPECT_EQ(3, obj->Whatever());
+  EXPECT_EQ(j, obj.ToJson());
+}
+
 }  // namespace
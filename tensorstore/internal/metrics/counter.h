@@ -110,8 +110,16 @@ class ABSL_CACHELINE_ALIGNED Counter {
   }
 
   value_type Get(typename FieldTraits<Fields>::param_type... labels) const {
-    auto* cell = impl_.FindCell(labels...);
-    return cell ? cell->Get() : value_type{};
+    if constexpr (sizeof...(Fields) == 0) {
+      // Combine the per-thread shards.
+      value_type result{};
+      impl_.CollectCells(
+          [&](const Cell& cell, const auto& fields) { result = cell.Get(); });
+      return result;
+    } else {
+      auto* cell = impl_.FindCell(labels...);
+      return cell ? cell->Get() : value_type{};
+    }
   }
 
   /// Collect the counter.
@@ -90,7 +90,7 @@ struct DefaultBucketer {
 template <typename Bucketer, typename... Fields>
 class ABSL_CACHELINE_ALIGNED Histogram {
   using Cell = HistogramCell<Bucketer>;
-  using Impl = AbstractMetric<Cell, false, Fields...>;
+  using Impl = AbstractMetric<Cell, true, Fields...>;
 
  public:
   using value_type = double;
@@ -126,20 +126,23 @@ class ABSL_CACHELINE_ALIGNED Histogram {
   }
 
   value_type GetMean(typename FieldTraits<Fields>::param_type... labels) const {
-    auto* cell = impl_.FindCell(labels...);
-    return cell ? cell->GetMean() : value_type{};
+    return Read([](const Cell& cell) { return cell.GetMean(); },
+                value_type{}, labels...);
   }
 
   count_type GetCount(
       typename FieldTraits<Fields>::param_type... labels) const {
-    auto* cell = impl_.FindCell(labels...);
-    return cell ? cell->GetCount() : count_type{};
+    return Read([](const Cell& cell) { return cell.GetCount(); },
+                count_type{}, labels...);
   }
 
   std::vector<int64_t> GetBucket(
       size_t idx, typename FieldTraits<Fields>::param_type... labels) const {
-    auto* cell = impl_.FindCell(labels...);
-    return cell ? cell->GetBucket(idx) : std::vector<int64_t>{};
+    return Read(
+        [&](const Cell& cell) -> std::vector<int64_t> {
+          return cell.GetBucket(idx);
+        },
+        std::vector<int64_t>{}, labels...);
   }
 
   /// Collect the histogram. There is potential tearing between the sum and the
@@ -181,6 +184,22 @@ class ABSL_CACHELINE_ALIGNED Histogram {
       : impl_(std::move(metric_name), std::move(metadata),
               std::move(field_names)) {}
 
+  // Applies `fn` to the cell for `labels`; unlabeled histograms are sharded
+  // per thread, so the shards are combined first.
+  template <typename Fn, typename T>
+  T Read(Fn fn, T default_value,
+         typename FieldTraits<Fields>::param_type... labels) const {
+    if constexpr (sizeof...(Fields) == 0) {
+      impl_.CollectCells([&](const Cell& cell, const auto& fields) {
+        default_value = fn(cell);
+      });
+      return default_value;
+    } else {
+      auto* cell = impl_.FindCell(labels...);
+      return cell ? fn(*cell) : default_value;
+    }
+  }
+
   Impl impl_;
 };
 
@@ -241,6 +260,36 @@ class ABSL_CACHELINE_ALIGNED HistogramCell : public Bucketer {
     count_ = 0;  // release spinlock
   }
 
+  /// Merges this cell into `other`, combining the means and sums of squared
+  /// deviations using the parallel form of Welford's algorithm.
+  void Combine(HistogramCell& other) const {
+    uint64_t count = AcquireCountSpinlock();
+    double mean = mean_.load(std::memory_order_relaxed);
+    double ssd = sum_squared_deviation_.load(std::memory_order_relaxed);
+    count_ = count;  // release spinlock
+    int64_t n = static_cast<int64_t>(count >> 1);
+    if (n == 0) return;
+
+    uint64_t other_count = other.AcquireCountSpinlock();
+    int64_t other_n = static_cast<int64_t>(other_count >> 1);
+    double other_mean = other.mean_.load(std::memory_order_relaxed);
+    double other_ssd =
+        other.sum_squared_deviation_.load(std::memory_order_relaxed);
+    int64_t total = n + other_n;
+    double delta = mean - other_mean;
+    other.mean_.store(other_mean + delta * n / total,
+                      std::memory_order_relaxed);
+    other.sum_squared_deviation_.store(
+        other_ssd + ssd + delta * delta * n * other_n / total,
+        std::memory_order_relaxed);
+    other.count_ = static_cast<uint64_t>(total) << 1;  // release spinlock
+
+    for (size_t i = 0; i < Max; ++i) {
+      other.buckets_[i].fetch_add(buckets_[i].load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+    }
+  }
+
   CollectedMetric::Histogram Collect(std::vector<std::string> fields) const {
     std::vector<int64_t> buckets;
     buckets.reserve(Bucketer::Max);
@@ -39,6 +39,19 @@ namespace internal_metrics {
 
 size_t MetricThreadCounter();
 
+/// Number of shards used by metrics whose cells can be combined.
+///
+/// Each thread updates the shard selected by `MetricShardIndex`, and shards are
+/// combined only when the metric is read or collected, so that concurrent
+/// updates from different threads typically touch different cache lines.
+inline constexpr size_t kMetricShards = 16;
+
+/// Returns the shard updated by the current thread.
+inline size_t MetricShardIndex() {
+  thread_local const size_t index = MetricThreadCounter() % kMetricShards;
+  return index;
+}
+
 // Metrics include an optional set of labels of type {int, string, bool}.
 template <typename K>
 struct FieldTraits;
@@ -196,20 +209,27 @@ class AbstractMetric : public AbstractMetricBase<sizeof...(Fields)> {
   const Cell* FindCell(
       typename FieldTraits<Fields>::param_type... labels) const {
     LookupKey k{labels...};
-    absl::MutexLock l(&mu_);
+    absl::ReaderMutexLock l(&mu_);
     auto it = impl_.find(k);
     return it == impl_.end() ? nullptr : &(it->second);
   }
 
   Cell* GetCell(typename FieldTraits<Fields>::param_type... labels) {
     LookupKey k{labels...};
+    {
+      // Cells are never removed, and node_hash_map provides pointer
+      // stability, so existing cells are found under a shared lock.
+      absl::ReaderMutexLock l(&mu_);
+      auto it = impl_.find(k);
+      if (it != impl_.end()) return &(it->second);
+    }
     absl::MutexLock l(&mu_);
     return &impl_[std::move(k)];
   }
 
   bool HasCell(typename FieldTraits<Fields>::param_type... labels) {
     LookupKey k{labels...};
-    absl::MutexLock l(&mu_);
+    absl::ReaderMutexLock l(&mu_);
     return impl_.count(std::move(k)) > 0;
   }
 
@@ -217,7 +237,7 @@ class AbstractMetric : public AbstractMetricBase<sizeof...(Fields)> {
       const Cell& /*value*/, const field_values_type& /*labels*/)>;
 
   void CollectCells(CollectCellFn on_cell) const {
-    absl::MutexLock l(&mu_);
+    absl::ReaderMutexLock l(&mu_);
     for (auto& kv : impl_) {
       on_cell(kv.second, kv.first.data());
     }
@@ -236,9 +256,12 @@ class AbstractMetric : public AbstractMetricBase<sizeof...(Fields)> {
   absl::node_hash_map<Key, Cell> impl_;
 };
 
-// Lock-free Specialization for no fields using a sharded counter.
+// Lock-free Specialization for no fields using sharded cells.
 // This assumes that the SFINAE parameter in AbstractMetric is appropriately
 // set with HasCombine when Cell has a Cell::Combine method.
+//
+// `FindCell` and `GetCell` return the current thread's shard; the value of the
+// metric is obtained from `CollectCells`, which combines all shards.
 template <typename Cell>
 class AbstractMetric<Cell, true> : public AbstractMetricBase<0> {
   using Base = AbstractMetricBase<0>;
@@ -256,8 +279,8 @@ class AbstractMetric<Cell, true> : public AbstractMetricBase<0> {
   using Base::metadata;
   using Base::metric_name;
 
-  const Cell* FindCell() const { return &cells_[get_id()]; }
-  Cell* GetCell() { return &cells_[get_id()]; }
+  const Cell* FindCell() const { return &cells_[MetricShardIndex()]; }
+  Cell* GetCell() { return &cells_[MetricShardIndex()]; }
   bool HasCell() { return true; }
 
   using CollectCellFn = absl::FunctionRef<void(
@@ -275,13 +298,9 @@ class AbstractMetric<Cell, true> : public AbstractMetricBase<0> {
   }
 
  private:
-  size_t get_id() const {
-    thread_local size_t id = MetricThreadCounter() & 3;
-    return id;
-  }
-
-  Cell cells_[4];
-  static_assert(sizeof(cells_) == 4 * ABSL_CACHELINE_SIZE);
+  Cell cells_[kMetricShards];
+  static_assert(sizeof(Cell) % ABSL_CACHELINE_SIZE == 0,
+                "Shards must not share cache lines");
 };
 
 // Lock-free Specialization for no fields.
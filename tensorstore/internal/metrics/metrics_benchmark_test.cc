@@ -20,6 +20,7 @@
 #include <benchmark/benchmark.h>
 #include "absl/synchronization/blocking_counter.h"
 #include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/metrics/registry.h"
 #include "tensorstore/internal/thread/thread_pool.h"
@@ -29,7 +30,9 @@ namespace {
 
 using ::tensorstore::Executor;
 using ::tensorstore::internal_metrics::Counter;
+using ::tensorstore::internal_metrics::DefaultBucketer;
 using ::tensorstore::internal_metrics::GetMetricRegistry;
+using ::tensorstore::internal_metrics::Histogram;
 using ::tensorstore::internal_metrics::MetricMetadata;
 
 Executor SetupThreadPoolTestEnv(size_t num_threads) {
@@ -46,6 +49,9 @@ static auto& benchmark_counter_int64 = Counter<int64_t>::New(
 static auto& benchmark_counter_double = Counter<double>::New(
     "/tensorstore/benchmark/counter_double", MetricMetadata("A metric"));
 
+static auto& benchmark_histogram = Histogram<DefaultBucketer>::New(
+    "/tensorstore/benchmark/histogram", MetricMetadata("A metric"));
+
 // This is a thread pool benchmark designed to create a lot of tasks with
 // large fanout and some memory locality.  The task itself Xors data into a
 // buffer by splitting the buffer into N x M x O chunks.
@@ -80,6 +86,35 @@ BENCHMARK(BM_Metric_Counter)  //
     ->Args({256})             //
     ->UseRealTime();
 
+static void BM_Metric_Histogram(benchmark::State& state) {
+  const size_t ops = 4 * 1024 * 1024;
+  const size_t num_threads = state.range(0) ? state.range(0) : 1;
+  const size_t iters = ops / num_threads;
+
+  auto executor = SetupThreadPoolTestEnv(state.range(0));
+
+  for (auto s : state) {
+    absl::BlockingCounter done(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      executor([&done, iters] {
+        for (size_t j = 0; j < iters; j++) {
+          benchmark_histogram.Observe(j & 1023);
+        }
+        done.DecrementCount();
+      });
+    }
+    done.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * iters * num_threads);
+}
+
+BENCHMARK(BM_Metric_Histogram)  //
+    ->Args({0})                 // InlineExecutor
+    ->Args({8})                 //
+    ->Args({32})                //
+    ->UseRealTime();
+
 }  // namespace
 
 #endif  // !defined(TENSORSTORE_METRICS_DISABLED)
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <string>
+#include <thread>  // NOLINT
 #include <variant>
 #include <vector>
 
@@ -250,6 +251,40 @@ TEST(MetricTest, Histogram) {
   EXPECT_EQ(1, metric.histograms[0].buckets[3]);  // <4
 }
 
+TEST(MetricTest, ShardedAcrossThreads) {
+  auto& counter = Counter<int64_t>::New("/tensorstore/sharded_counter",
+                                        MetricMetadata("A metric"));
+  auto& histogram = Histogram<DefaultBucketer>::New(
+      "/tensorstore/sharded_hist", MetricMetadata("A metric"));
+
+  constexpr int kThreads = 32;
+  constexpr int kIterations = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < kIterations; ++j) {
+        counter.Increment();
+        histogram.Observe(i);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(kThreads * kIterations, counter.Get());
+  EXPECT_EQ(kThreads * kIterations, histogram.GetCount());
+  EXPECT_NEAR((kThreads - 1) / 2.0, histogram.GetMean(), 0.001);
+
+  auto metric = histogram.Collect();
+  ASSERT_EQ(1, metric.histograms.size());
+  EXPECT_EQ(kThreads * kIterations, metric.histograms[0].count);
+  EXPECT_EQ(kIterations, metric.histograms[0].buckets[1]);  // value 0
+  // Variance of the uniform distribution over [0, kThreads).
+  EXPECT_NEAR((kThreads * kThreads - 1) / 12.0,
+              metric.histograms[0].sum_of_squared_deviation /
+                  (kThreads * kIterations),
+              0.001);
+}
+
 TEST(MetricTest, HistogramFields) {
   auto& histogram = Histogram<DefaultBucketer, int>::New(
       "/tensorstore/hist2", "field1", MetricMetadata("A metric"));
@@ -16,20 +16,30 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <memory>
+#include <optional>
+#include <thread>  // NOLINT
 #include <utility>
 
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/data_type.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/arena.h"
 #include "tensorstore/internal/element_copy_function.h"
 #include "tensorstore/internal/elementwise_function.h"
+#include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/nditerable.h"
 #include "tensorstore/internal/nditerable_buffer_management.h"
 #include "tensorstore/internal/nditerable_util.h"
+#include "tensorstore/internal/tracing/stage.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/extents.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -181,6 +191,14 @@ NDIteratorCopyManager::NDIteratorCopyManager(
   copy_impl_ = kCopyImpls[static_cast<int>(buffer_parameters.buffer_source)];
 }
 
+namespace {
+std::atomic<NDIterableCopyProfilingHook> copy_profiling_hook{nullptr};
+}  // namespace
+
+void SetNDIterableCopyProfilingHook(NDIterableCopyProfilingHook hook) {
+  copy_profiling_hook.store(hook, std::memory_order_relaxed);
+}
+
 NDIterableCopier::NDIterableCopier(const NDIterable& input,
                                    const NDIterable& output,
                                    span<const Index> shape,
@@ -192,52 +210,203 @@ NDIterableCopier::NDIterableCopier(const NDIterable& input,
 NDIterableCopier::NDIterableCopier(
     const NDIterableCopyManager& iterable_copy_manager, span<const Index> shape,
     IterationConstraints constraints, Arena* arena)
-    : layout_info_(iterable_copy_manager, shape, constraints),
+    : iterable_copy_manager_(iterable_copy_manager),
+      layout_info_(iterable_copy_manager, shape, constraints),
       block_shape_(GetNDIterationBlockShape(
           iterable_copy_manager.GetWorkingMemoryBytesPerElement(
               layout_info_.layout_view()),
           layout_info_.iteration_shape)),
       iterator_copy_manager_(iterable_copy_manager,
                              {layout_info_.layout_view(), block_shape_},
-                             arena) {}
-
-absl::Status NDIterableCopier::Copy() {
-  span<const Index> iteration_shape = layout_info_.iteration_shape;
-  std::fill_n(position_, iteration_shape.size(), static_cast<Index>(0));
-  if (layout_info_.empty) {
-    return absl::OkStatus();
+                             arena) {
+  if (auto hook = copy_profiling_hook.load(std::memory_order_relaxed);
+      ABSL_PREDICT_FALSE(hook)) {
+    const auto layout = layout_info_.layout_view();
+    NDIterableCopyProfile profile;
+    profile.layout = layout;
+    profile.block_shape = block_shape_;
+    profile.block_shape_mode = GetNDIterationBlockShapeMode();
+    profile.working_memory_bytes_per_element =
+        iterable_copy_manager.GetWorkingMemoryBytesPerElement(layout);
+    profile.buffer_parameters =
+        iterable_copy_manager.GetBufferParameters(layout);
+    hook(profile);
   }
+}
+
+namespace {
+
+/// Copies the portion of the iteration space for which the index into
+/// dimension `dim` is in `[begin, end)`.
+///
+/// \param position[out] Set to one past the last position copied.
+absl::Status CopyRange(NDIteratorCopyManager& iterator_copy_manager,
+                       span<const Index> iteration_shape,
+                       IterationBufferShape block_shape, DimensionIndex dim,
+                       Index begin, Index end, Index* position) {
+  const DimensionIndex rank = iteration_shape.size();
+  Index sub_shape_storage[kMaxRank];
+  std::copy(iteration_shape.begin(), iteration_shape.end(), sub_shape_storage);
+  sub_shape_storage[dim] = end - begin;
+  span<const Index> sub_shape(sub_shape_storage, rank);
+  Index indices[kMaxRank];
+  std::fill_n(position, rank, static_cast<Index>(0));
   absl::Status copy_status;
-  if (Index inner_block_size = block_shape_[1];
-      inner_block_size != iteration_shape.back()) {
+  const auto copy_block = [&](IterationBufferShape shape) {
+    std::copy_n(position, rank, indices);
+    indices[dim] += begin;
+    return iterator_copy_manager.Copy(span<const Index>(indices, rank), shape,
+                                      &copy_status);
+  };
+  // Converts `position` from `sub_shape` to `iteration_shape` coordinates.
+  const auto offset_position = [&] { position[dim] += begin; };
+  if (Index inner_block_size = std::min(block_shape[1], sub_shape.back());
+      inner_block_size != sub_shape.back()) {
     // Block shape is 1d, need to iterate over all dimensions including
     // innermost dimension.
-    assert(block_shape_[0] == 1);
+    assert(block_shape[0] == 1);
     for (Index block_size = inner_block_size; block_size;) {
-      if (!iterator_copy_manager_.Copy(
-              span<const Index>(position_, iteration_shape.size()),
-              {1, block_size}, &copy_status)) {
+      if (!copy_block({1, block_size})) {
+        offset_position();
         return GetElementCopyErrorStatus(std::move(copy_status));
       }
-      block_size = StepBufferPositionForward(iteration_shape, block_size,
-                                             inner_block_size, position_);
+      block_size = StepBufferPositionForward(sub_shape, block_size,
+                                             inner_block_size, position);
     }
   } else {
     // Block shape is 2d, exclude innermost dimension from iteration.
-    const Index outer_block_size = block_shape_[0];
+    const Index outer_block_size = block_shape[0];
     for (Index block_size = outer_block_size; block_size;) {
-      if (!iterator_copy_manager_.Copy(
-              span<const Index>(position_, iteration_shape.size()),
-              {block_size, inner_block_size}, &copy_status)) {
+      if (!copy_block({block_size, inner_block_size})) {
+        offset_position();
         return GetElementCopyErrorStatus(std::move(copy_status));
       }
-      block_size = StepBufferPositionForward(
-          iteration_shape.first(iteration_shape.size() - 1), block_size,
-          outer_block_size, position_);
+      block_size = StepBufferPositionForward(sub_shape.first(rank - 1),
+                                             block_size, outer_block_size,
+                                             position);
     }
   }
+  offset_position();
   return absl::OkStatus();
 }
 
+}  // namespace
+
+absl::Status NDIterableCopier::Copy() {
+  internal_tracing::StageScope stage(internal_tracing::Stage::kCopy);
+  span<const Index> iteration_shape = layout_info_.iteration_shape;
+  if (layout_info_.empty) {
+    std::fill_n(position_, iteration_shape.size(), static_cast<Index>(0));
+    return absl::OkStatus();
+  }
+  return CopyRange(iterator_copy_manager_, iteration_shape, block_shape_, 0, 0,
+                   iteration_shape[0], position_);
+}
+
+namespace {
+
+/// State shared by the tasks of `NDIterableCopier::Copy(executor, options)`.
+///
+/// Tasks that have not started by the time all partitions are claimed exit
+/// without accessing the copier, which may have been destroyed by then.
+struct ParallelCopyState : public AtomicReferenceCount<ParallelCopyState> {
+  const NDIterableCopyManager* iterable_copy_manager;
+  NDIterable::IterationLayoutView layout;
+  IterationBufferShape block_shape;
+  span<const Index> iteration_shape;
+  DimensionIndex partition_dim;
+  Index num_partitions;
+  std::atomic<Index> next_partition{0};
+  std::atomic<bool> failed{false};
+
+  absl::Mutex mutex;
+  Index remaining_partitions ABSL_GUARDED_BY(mutex);
+  absl::Status status ABSL_GUARDED_BY(mutex);
+
+  // Claims and copies partitions until none remain.
+  void Run() {
+    internal_tracing::StageScope stage(internal_tracing::Stage::kCopy);
+    for (Index i; (i = next_partition.fetch_add(1)) < num_partitions;) {
+      absl::Status partition_status;
+      if (!failed.load(std::memory_order_relaxed)) {
+        partition_status = CopyPartition(i);
+      }
+      absl::MutexLock lock(&mutex);
+      if (!partition_status.ok()) {
+        failed = true;
+        if (status.ok()) status = std::move(partition_status);
+      }
+      --remaining_partitions;
+    }
+  }
+
+  absl::Status CopyPartition(Index i) {
+    const Index extent = iteration_shape[partition_dim];
+    const Index begin = extent * i / num_partitions;
+    const Index end = extent * (i + 1) / num_partitions;
+    // Any external buffer is allocated from this arena, which is only used by
+    // this thread.
+    unsigned char arena_buffer[8 * 1024];
+    Arena arena(arena_buffer);
+    std::optional<NDIteratorCopyManager> iterator_copy_manager;
+    {
+      absl::MutexLock lock(&mutex);
+      iterator_copy_manager.emplace(*iterable_copy_manager,
+                                    NDIterable::IterationBufferLayoutView{
+                                        layout, block_shape},
+                                    &arena);
+    }
+    Index position[kMaxRank];
+    return CopyRange(*iterator_copy_manager, iteration_shape, block_shape,
+                     partition_dim, begin, end, position);
+  }
+};
+
+}  // namespace
+
+absl::Status NDIterableCopier::Copy(
+    const Executor& executor, const NDIterableParallelCopyOptions& options) {
+  span<const Index> iteration_shape = layout_info_.iteration_shape;
+  if (layout_info_.empty) return Copy();
+  Index max_tasks = options.max_tasks;
+  if (max_tasks <= 0) {
+    max_tasks = std::max(Index(1), Index(std::thread::hardware_concurrency()));
+  }
+  const Index num_elements = ProductOfExtents(iteration_shape);
+  const Index min_elements_per_task =
+      std::max(Index(1), options.min_elements_per_task);
+  // The outermost dimension is partitioned, unless it is the inert dimension
+  // of size 1 added for a single combined dimension.
+  const DimensionIndex partition_dim =
+      (iteration_shape[0] == 1) ? iteration_shape.size() - 1 : 0;
+  const Index num_partitions =
+      std::min({max_tasks, num_elements / min_elements_per_task,
+                iteration_shape[partition_dim]});
+  if (num_partitions <= 1) return Copy();
+
+  auto state = MakeIntrusivePtr<ParallelCopyState>();
+  state->iterable_copy_manager = &iterable_copy_manager_;
+  state->layout = layout_info_.layout_view();
+  state->block_shape = block_shape_;
+  state->iteration_shape = iteration_shape;
+  state->partition_dim = partition_dim;
+  state->num_partitions = num_partitions;
+  {
+    absl::MutexLock lock(&state->mutex);
+    state->remaining_partitions = num_partitions;
+  }
+  for (Index i = 1; i < num_partitions; ++i) {
+    executor([state] { state->Run(); });
+  }
+  state->Run();
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.Await(absl::Condition(
+      +[](ParallelCopyState* state) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+           state->mutex) { return state->remaining_partitions == 0; },
+      state.get()));
+  std::fill_n(position_, iteration_shape.size(), static_cast<Index>(0));
+  return state->status;
+}
+
 }  // namespace internal
 }  // namespace tensorstore
@@ -33,6 +33,7 @@
 #include "tensorstore/internal/nditerable_buffer_management.h"
 #include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
@@ -138,6 +139,48 @@ struct NDIteratorCopyManager {
   NDIteratorExternalBufferManager<1, 2> buffer_manager_;
 };
 
+/// Options for copying in parallel with `NDIterableCopier`.
+struct NDIterableParallelCopyOptions {
+  /// Minimum number of elements to copy per task.  Copies of fewer than twice
+  /// this many elements are performed entirely by the calling thread.
+  Index min_elements_per_task = 1024 * 1024;
+
+  /// Maximum number of tasks, including the calling thread.  If `0`, the
+  /// number of hardware threads is used.
+  Index max_tasks = 0;
+};
+
+/// Describes the layout and buffering chosen by an `NDIterableCopier`.
+struct NDIterableCopyProfile {
+  /// Simplified iteration layout.
+  NDIterable::IterationLayoutView layout;
+
+  /// Block shape used for iteration.
+  IterationBufferShape block_shape;
+
+  /// Mode with which `block_shape` was chosen.
+  NDIterationBlockShapeMode block_shape_mode;
+
+  /// Temporary buffer space required for each block element.
+  std::ptrdiff_t working_memory_bytes_per_element;
+
+  /// Buffering method and buffer kinds.
+  NDIterableCopyManager::BufferParameters buffer_parameters;
+};
+
+/// Function invoked with the profile of each `NDIterableCopier` constructed.
+///
+/// The `profile` is only valid for the duration of the call.
+using NDIterableCopyProfilingHook = void (*)(
+    const NDIterableCopyProfile& profile);
+
+/// Sets the hook invoked by the `NDIterableCopier` constructor, or disables
+/// profiling if `hook == nullptr` (the default).
+///
+/// May be called concurrently with copies in other threads.  The hook may be
+/// invoked concurrently from multiple threads.
+void SetNDIterableCopyProfilingHook(NDIterableCopyProfilingHook hook);
+
 /// Convenience interface for copying from one `NDIterable` to another.
 ///
 /// Example usage:
@@ -173,6 +216,22 @@ struct NDIterableCopier {
   /// Leaves `position()` at one past the last position copied.
   absl::Status Copy();
 
+  /// Same as above, but partitions the outermost iteration dimension (or the
+  /// sole dimension, if the layout is 1-d) into multiple tasks that are
+  /// performed by `executor` concurrently with the calling thread.
+  ///
+  /// This requires that separate iterators obtained from the input and output
+  /// iterables may be used from different threads to access disjoint
+  /// positions, which holds for array-backed iterables, but not, for example,
+  /// for iterables that track written elements in a shared mask.  Iterators
+  /// are obtained under a mutex, since the arena from which they are allocated
+  /// is not thread safe.
+  ///
+  /// Blocks until all tasks complete, but does not depend on `executor`
+  /// running any of them.  If an error occurs, `position()` is unspecified.
+  absl::Status Copy(const Executor& executor,
+                    const NDIterableParallelCopyOptions& options = {});
+
   /// Returns the layout used for copying.
   const NDIterationLayoutInfo<>& layout_info() const { return layout_info_; }
 
@@ -192,6 +251,7 @@ struct NDIterableCopier {
                    span<const Index> shape, IterationConstraints constraints,
                    Arena* arena);
 
+  NDIterableCopyManager iterable_copy_manager_;
   NDIterationLayoutInfo<> layout_info_;
   IterationBufferShape block_shape_;
   Index position_[kMaxRank];
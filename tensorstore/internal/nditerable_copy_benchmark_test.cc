@@ -30,6 +30,7 @@
 #include "tensorstore/internal/nditerable_array.h"
 #include "tensorstore/internal/nditerable_copy.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
+#include "tensorstore/internal/nditerable_util.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 
@@ -124,6 +125,7 @@ void DoCopySimpleRestrictNoBuiltin(
 
 enum CopyMode {
   kNDIter,
+  kNDIterCacheTuned,
   kUnrolled,
   kSimple,
   kSimpleRestrict,
@@ -144,6 +146,13 @@ void BM_Copy(benchmark::State& state) {
       {kOuterSizeFactor, outer, inner * kInnerSizeFactor}, tensorstore::c_order,
       tensorstore::value_init);
 
+  using ::tensorstore::internal::NDIterationBlockShapeMode;
+  const auto prev_block_shape_mode =
+      tensorstore::internal::GetNDIterationBlockShapeMode();
+  tensorstore::internal::SetNDIterationBlockShapeMode(
+      Mode == kNDIterCacheTuned ? NDIterationBlockShapeMode::kCacheTuned
+                                : NDIterationBlockShapeMode::kDefault);
+
   int64_t offset = 0;
   for (auto s : state) {
     tensorstore::internal::Arena arena;
@@ -158,7 +167,8 @@ void BM_Copy(benchmark::State& state) {
                                                         inner) |
             tensorstore::Materialize());
     switch (Mode) {
-      case kNDIter: {
+      case kNDIter:
+      case kNDIterCacheTuned: {
         auto source_iterable = GetArrayNDIterable(source_part, &arena);
         auto target_iterable =
             GetTransformedArrayNDIterable(target_part, &arena).value();
@@ -213,6 +223,7 @@ void BM_Copy(benchmark::State& state) {
     }
     offset = (offset + 1) % (kInnerSizeFactor * kOuterSizeFactor);
   }
+  tensorstore::internal::SetNDIterationBlockShapeMode(prev_block_shape_mode);
   state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * outer *
                           inner);
 }
@@ -227,6 +238,7 @@ void DefineArgs(Bench* benchmark) {
 }
 
 BENCHMARK(BM_Copy<kNDIter>)->Apply(DefineArgs);
+BENCHMARK(BM_Copy<kNDIterCacheTuned>)->Apply(DefineArgs);
 BENCHMARK(BM_Copy<kUnrolled>)->Apply(DefineArgs);
 BENCHMARK(BM_Copy<kSimple>)->Apply(DefineArgs);
 BENCHMARK(BM_Copy<kSimpleRestrict>)->Apply(DefineArgs);
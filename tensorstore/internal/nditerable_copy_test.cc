@@ -18,6 +18,7 @@
 #include <new>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -37,7 +38,9 @@
 #include "tensorstore/internal/nditerable_elementwise_output_transform.h"
 #include "tensorstore/internal/nditerable_transformed_array.h"
 #include "tensorstore/internal/nditerable_util.h"
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/rank.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -216,4 +219,149 @@ TEST_P(MaybeUnitBlockSizeTest, InnerIndexArray) {
   EXPECT_EQ(expected, dest);
 }
 
+// Copies `source` to a new array using `NDIterableCopier::Copy(executor)`.
+template <typename T>
+tensorstore::Result<tensorstore::SharedArray<T>> ParallelCopy(
+    tensorstore::TransformedArray<Shared<const T>> source,
+    const tensorstore::Executor& executor) {
+  auto dest = tensorstore::AllocateArray<T>(source.shape());
+  tensorstore::internal::Arena arena;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto source_iterable,
+                               GetTransformedArrayNDIterable(source, &arena));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto dest_iterable,
+                               GetTransformedArrayNDIterable(dest, &arena));
+  tensorstore::internal::NDIterableParallelCopyOptions options;
+  options.min_elements_per_task = 10;
+  options.max_tasks = 8;
+  TENSORSTORE_RETURN_IF_ERROR(
+      tensorstore::internal::NDIterableCopier(*source_iterable, *dest_iterable,
+                                              dest.shape(),
+                                              /*constraints=*/{}, &arena)
+          .Copy(executor, options));
+  return dest;
+}
+
+TEST_P(MaybeUnitBlockSizeTest, Parallel) {
+  auto executor = tensorstore::internal::DetachedThreadPool(4);
+  auto source = tensorstore::AllocateArray<int>({37, 53});
+  for (Index i = 0; i < 37; ++i) {
+    for (Index j = 0; j < 53; ++j) source(i, j) = i * 100 + j;
+  }
+
+  // Contiguous.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto dest,
+                                   ParallelCopy<int>(source, executor));
+  EXPECT_EQ(source, dest);
+
+  // Transposed, such that neither array is contiguous in the iteration order.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      tensorstore::TransformedArray<Shared<const int>> transposed,
+      source | tensorstore::Dims(0, 1).Transpose());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(dest,
+                                   ParallelCopy<int>(transposed, executor));
+  for (Index i = 0; i < 37; ++i) {
+    for (Index j = 0; j < 53; ++j) EXPECT_EQ(source(i, j), dest(j, i));
+  }
+
+  // One-dimensional.
+  auto flat = tensorstore::AllocateArray<int>({5000});
+  for (Index i = 0; i < 5000; ++i) flat(i) = -i;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto flat_dest,
+                                   ParallelCopy<int>(flat, executor));
+  EXPECT_EQ(flat, flat_dest);
+}
+
+// Tests that the copy completes even if the executor does not run the tasks
+// until after the copy returns.
+TEST(NDIterableCopyTest, ParallelDeferredExecutor) {
+  std::vector<tensorstore::ExecutorTask> tasks;
+  tensorstore::Executor executor = [&](tensorstore::ExecutorTask task) {
+    tasks.push_back(std::move(task));
+  };
+  auto source = tensorstore::AllocateArray<int>({100, 10});
+  for (Index i = 0; i < 1000; ++i) source.data()[i] = i;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto dest,
+                                   ParallelCopy<int>(source, executor));
+  EXPECT_EQ(source, dest);
+  EXPECT_FALSE(tasks.empty());
+  for (auto& task : tasks) std::move(task)();
+}
+
+TEST(NDIterableCopyTest, ParallelError) {
+  auto source = tensorstore::AllocateArray<int>({100, 10});
+  for (Index i = 0; i < 1000; ++i) source.data()[i] = i;
+  auto dest = tensorstore::AllocateArray<int>(source.shape());
+  auto dest_element_transform = [](const int* source, int* dest, void* arg) {
+    if (*source == 555) {
+      *static_cast<absl::Status*>(arg) = absl::UnknownError("555");
+      return false;
+    }
+    *dest = *source;
+    return true;
+  };
+  tensorstore::internal::ElementwiseClosure<2, void*> dest_closure =
+      tensorstore::internal::SimpleElementwiseFunction<
+          decltype(dest_element_transform)(const int, int),
+          void*>::Closure(&dest_element_transform);
+  tensorstore::internal::Arena arena;
+  auto source_iterable = GetTransformedArrayNDIterable(source, &arena).value();
+  auto dest_iterable = GetElementwiseOutputTransformNDIterable(
+      GetTransformedArrayNDIterable(dest, &arena).value(), dtype_v<int>,
+      dest_closure, &arena);
+  tensorstore::internal::NDIterableParallelCopyOptions options;
+  options.min_elements_per_task = 10;
+  EXPECT_THAT(
+      tensorstore::internal::NDIterableCopier(*source_iterable, *dest_iterable,
+                                              dest.shape(),
+                                              /*constraints=*/{}, &arena)
+          .Copy(tensorstore::InlineExecutor{}, options),
+      tensorstore::MatchesStatus(absl::StatusCode::kUnknown, "555"));
+}
+
+struct RecordedCopyProfile {
+  std::vector<Index> iteration_shape;
+  tensorstore::internal::IterationBufferShape block_shape;
+  tensorstore::internal::NDIterableCopyManager::BufferParameters
+      buffer_parameters;
+};
+
+std::vector<RecordedCopyProfile>* recorded_profiles;
+
+TEST(NDIterableCopyTest, ProfilingHook) {
+  using ::tensorstore::internal::IterationBufferKind;
+  using ::tensorstore::internal::NDIterableCopyManager;
+  std::vector<RecordedCopyProfile> profiles;
+  recorded_profiles = &profiles;
+  tensorstore::internal::SetNDIterableCopyProfilingHook(
+      +[](const tensorstore::internal::NDIterableCopyProfile& profile) {
+        recorded_profiles->push_back(
+            {std::vector<Index>(profile.layout.iteration_shape.begin(),
+                                profile.layout.iteration_shape.end()),
+             profile.block_shape, profile.buffer_parameters});
+      });
+  auto source = MakeArray<int>({{1, 2, 3}, {4, 5, 6}});
+  auto dest = tensorstore::AllocateArray<int>(source.shape());
+  tensorstore::internal::Arena arena;
+  auto source_iterable = GetTransformedArrayNDIterable(source, &arena).value();
+  auto dest_iterable = GetTransformedArrayNDIterable(dest, &arena).value();
+  tensorstore::internal::NDIterableCopier copier(
+      *source_iterable, *dest_iterable, dest.shape(), tensorstore::c_order,
+      &arena);
+  tensorstore::internal::SetNDIterableCopyProfilingHook(nullptr);
+  TENSORSTORE_EXPECT_OK(copier.Copy());
+  EXPECT_EQ(source, dest);
+  ASSERT_EQ(1, profiles.size());
+  EXPECT_THAT(profiles[0].iteration_shape, ::testing::ElementsAre(1, 6));
+  EXPECT_EQ(tensorstore::internal::GetNDIterationBlockShape(
+                /*working_memory_bytes_per_element=*/0,
+                profiles[0].iteration_shape),
+            profiles[0].block_shape);
+  EXPECT_EQ(NDIterableCopyManager::BufferSource::kBoth,
+            profiles[0].buffer_parameters.buffer_source);
+  EXPECT_EQ(IterationBufferKind::kContiguous,
+            profiles[0].buffer_parameters.input_buffer_kind);
+  EXPECT_EQ(IterationBufferKind::kContiguous,
+            profiles[0].buffer_parameters.output_buffer_kind);
+}
+
 }  // namespace
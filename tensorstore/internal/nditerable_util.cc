@@ -17,19 +17,29 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 
 #include "absl/base/optimization.h"
 #include "absl/status/status.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/index.h"
 #include "tensorstore/internal/elementwise_function.h"
+#include "tensorstore/internal/env.h"
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/nditerable.h"
 #include "tensorstore/rank.h"
 #include "tensorstore/util/iterate.h"
 #include "tensorstore/util/span.h"
 
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#endif
+
 namespace tensorstore {
 namespace internal {
 
@@ -39,6 +49,38 @@ namespace {
 bool nditerable_use_unit_block_size = false;
 #endif
 
+std::atomic<NDIterationBlockShapeMode>& BlockShapeMode() {
+  static std::atomic<NDIterationBlockShapeMode> mode{
+      GetEnvValue<bool>("TENSORSTORE_NDITERABLE_CACHE_TUNED_BLOCK_SHAPE")
+              .value_or(false)
+          ? NDIterationBlockShapeMode::kCacheTuned
+          : NDIterationBlockShapeMode::kDefault};
+  return mode;
+}
+
+NDIterationCacheSizes DetectCacheSizes() {
+  NDIterationCacheSizes sizes{32 * 1024, 256 * 1024, 64};
+  [[maybe_unused]] const auto set_if_valid = [](Index& size, int64_t value) {
+    if (value > 0) size = value;
+  };
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+  set_if_valid(sizes.l1_data_bytes, sysconf(_SC_LEVEL1_DCACHE_SIZE));
+  set_if_valid(sizes.l2_bytes, sysconf(_SC_LEVEL2_CACHE_SIZE));
+  set_if_valid(sizes.line_bytes, sysconf(_SC_LEVEL1_DCACHE_LINESIZE));
+#elif defined(__APPLE__)
+  const auto query = [](const char* name) -> int64_t {
+    int64_t value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, nullptr, 0) != 0) return 0;
+    return value;
+  };
+  set_if_valid(sizes.l1_data_bytes, query("hw.l1dcachesize"));
+  set_if_valid(sizes.l2_bytes, query("hw.l2cachesize"));
+  set_if_valid(sizes.line_bytes, query("hw.cachelinesize"));
+#endif
+  return sizes;
+}
+
 template <bool Full>
 void GetNDIterationLayoutInfo(const NDIterableLayoutConstraint& iterable,
                               span<const Index> shape,
@@ -158,6 +200,55 @@ void GetNDIterationLayoutInfo(const NDIterableLayoutConstraint& iterable,
   GetNDIterationLayoutInfo<true>(iterable, shape, constraints, info);
 }
 
+const NDIterationCacheSizes& GetNDIterationCacheSizes() {
+  static const NDIterationCacheSizes sizes = DetectCacheSizes();
+  return sizes;
+}
+
+void SetNDIterationBlockShapeMode(NDIterationBlockShapeMode mode) {
+  BlockShapeMode().store(mode, std::memory_order_relaxed);
+}
+
+NDIterationBlockShapeMode GetNDIterationBlockShapeMode() {
+  return BlockShapeMode().load(std::memory_order_relaxed);
+}
+
+IterationBufferShape GetCacheTunedNDIterationBlockShape(
+    ptrdiff_t working_memory_bytes_per_element,
+    span<const Index> iteration_shape, const NDIterationCacheSizes& cache) {
+  const Index penultimate_dimension_size =
+      iteration_shape[iteration_shape.size() - 2];
+  const Index last_dimension_size = iteration_shape[iteration_shape.size() - 1];
+  if (working_memory_bytes_per_element == 0) {
+    return {penultimate_dimension_size, last_dimension_size};
+  }
+  constexpr Index kMinBlockElements = 64;
+  const Index bytes_per_element = working_memory_bytes_per_element;
+  Index budget = cache.l1_data_bytes / 4 * 3;
+  if (budget / bytes_per_element < kMinBlockElements) {
+    budget = std::max(
+        budget, std::min(cache.l2_bytes / 2,
+                         kMinBlockElements * bytes_per_element));
+  }
+  const Index target_size = std::max(Index(8), budget / bytes_per_element);
+  Index block_inner_size =
+      std::max(Index(1), std::min(last_dimension_size, target_size));
+  if (block_inner_size < last_dimension_size) {
+    // Round down to a whole number of (approximate) cache lines, so that
+    // consecutive blocks of a strided row do not share a partial line.
+    const Index line_elements = cache.line_bytes / bytes_per_element;
+    if (line_elements > 1 && block_inner_size > line_elements) {
+      block_inner_size -= block_inner_size % line_elements;
+    }
+  }
+  Index block_outer_size = 1;
+  if (block_inner_size < target_size) {
+    block_outer_size =
+        std::min(penultimate_dimension_size, target_size / block_inner_size);
+  }
+  return {block_outer_size, block_inner_size};
+}
+
 IterationBufferShape GetNDIterationBlockShape(
     ptrdiff_t working_memory_bytes_per_element,
     span<const Index> iteration_shape) {
@@ -169,8 +260,12 @@ IterationBufferShape GetNDIterationBlockShape(
     return {1, 1};
   }
 #endif
-  // TODO(jbms): maybe choose based on actual L1 cache size.
-  //
+  if (GetNDIterationBlockShapeMode() ==
+      NDIterationBlockShapeMode::kCacheTuned) {
+    return GetCacheTunedNDIterationBlockShape(
+        working_memory_bytes_per_element, iteration_shape,
+        GetNDIterationCacheSizes());
+  }
   // Note: Choose an amount smaller than the default arena size of `32 * 1024`.
   constexpr Index kTargetMemoryUsage = 24 * 1024;
   const Index penultimate_dimension_size =
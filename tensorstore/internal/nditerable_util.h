@@ -138,7 +138,64 @@ struct NDIterationBufferInfo {
   IterationBufferShape block_shape;
 };
 
-/// Computes the block shape to use for iteration that is L1-cache efficient.
+/// Data cache parameters used to choose block shapes in
+/// `NDIterationBlockShapeMode::kCacheTuned` mode.
+struct NDIterationCacheSizes {
+  /// Size in bytes of the per-core L1 data cache.
+  Index l1_data_bytes;
+
+  /// Size in bytes of the L2 cache.
+  Index l2_bytes;
+
+  /// Size in bytes of a cache line.
+  Index line_bytes;
+};
+
+/// Returns the cache sizes detected for the current machine.
+///
+/// Values that cannot be detected default to 32KiB, 256KiB, and 64 bytes,
+/// respectively.
+const NDIterationCacheSizes& GetNDIterationCacheSizes();
+
+/// Specifies how `GetNDIterationBlockShape` chooses the block shape.
+enum class NDIterationBlockShapeMode {
+  /// Targets a fixed temporary buffer budget of 24KiB.
+  kDefault,
+
+  /// Targets a budget derived from `GetNDIterationCacheSizes()`, and rounds
+  /// the inner block size to whole cache lines.
+  kCacheTuned,
+};
+
+/// Sets the mode used by subsequent calls to `GetNDIterationBlockShape`.
+///
+/// The initial mode is `kCacheTuned` if the
+/// `TENSORSTORE_NDITERABLE_CACHE_TUNED_BLOCK_SHAPE` environment variable is
+/// set to a true value, and `kDefault` otherwise.
+void SetNDIterationBlockShapeMode(NDIterationBlockShapeMode mode);
+
+/// Returns the mode used by `GetNDIterationBlockShape`.
+NDIterationBlockShapeMode GetNDIterationBlockShapeMode();
+
+/// Computes the block shape used in `NDIterationBlockShapeMode::kCacheTuned`
+/// mode for the specified cache parameters.
+///
+/// The temporary buffers are sized to fit within 3/4 of the L1 data cache,
+/// leaving room for the source and target lines.  If that would leave fewer
+/// than 64 elements per block, as for large element types, up to half of the
+/// L2 cache is used instead, so that per-block overhead is amortized.
+///
+/// \param working_memory_bytes_per_element The number of bytes of temporary
+///     buffer space required for each block element.
+/// \param iteration_shape The simplified iteration shape, must have
+///     `size() >= 2`.
+/// \param cache The cache parameters.
+IterationBufferShape GetCacheTunedNDIterationBlockShape(
+    std::ptrdiff_t working_memory_bytes_per_element,
+    span<const Index> iteration_shape, const NDIterationCacheSizes& cache);
+
+/// Computes the block shape to use for iteration that is L1-cache efficient,
+/// according to `GetNDIterationBlockShapeMode()`.
 ///
 /// For testing purposes, the behavior may be overridden to always return 1 by
 /// calling `SetNDIterableTestUnitBlockSize(true)` or defining the
@@ -26,7 +26,9 @@ namespace {
 
 using ::tensorstore::Index;
 using ::tensorstore::span;
+using ::tensorstore::internal::GetCacheTunedNDIterationBlockShape;
 using ::tensorstore::internal::GetNDIterationBlockShape;
+using ::tensorstore::internal::NDIterationCacheSizes;
 using ::tensorstore::internal::NDIterationPositionStepper;
 using ::tensorstore::internal::ResetBufferPositionAtBeginning;
 using ::tensorstore::internal::ResetBufferPositionAtEnd;
@@ -68,6 +70,52 @@ TEST(GetNDIterationBlockShape, Basic) {
               ElementsAre(1, expected_block_size(384)));
 }
 
+TEST(GetCacheTunedNDIterationBlockShape, Basic) {
+  const NDIterationCacheSizes cache{/*l1_data_bytes=*/48 * 1024,
+                                    /*l2_bytes=*/2 * 1024 * 1024,
+                                    /*line_bytes=*/64};
+
+  // If no temporary buffer is required, uses the full extent of the last 2
+  // dimensions.
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/0,
+                  span<const Index>({3, 4, 1000000}), cache),
+              ElementsAre(4, 1000000));
+
+  // Block is limited by the extent of the last 2 dimensions.
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/1,
+                  span<const Index>({3, 4, 15}), cache),
+              ElementsAre(4, 15));
+
+  // Budget is 3/4 of the L1 data cache.
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/1,
+                  span<const Index>({3, 4, 1000000}), cache),
+              ElementsAre(1, 36 * 1024));
+
+  // Inner block size of 36864 / 12 = 3072 is rounded down to a multiple of
+  // 64 / 12 = 5 elements.
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/12,
+                  span<const Index>({3, 4, 1000000}), cache),
+              ElementsAre(1, 3070));
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/8,
+                  span<const Index>({3, 100, 1001}), cache),
+              ElementsAre(4, 1001));
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/8,
+                  span<const Index>({3, 100, 5000}), cache),
+              ElementsAre(1, 4608));
+
+  // Large elements use up to half of the L2 cache to fit 64 elements.
+  EXPECT_THAT(GetCacheTunedNDIterationBlockShape(
+                  /*working_memory_bytes_per_element=*/4096,
+                  span<const Index>({3, 4, 1000}), cache),
+              ElementsAre(1, 64));
+}
+
 TEST(ResetBufferPositionTest, OneDimensional) {
   std::vector<Index> shape{10};
   std::vector<Index> position{42};
@@ -20,10 +20,13 @@
 
 #include <gtest/gtest.h>
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/cord.h"
 #include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
+#include "tensorstore/util/status_testutil.h"
 
 namespace {
 
@@ -137,4 +140,47 @@ TEST(OAuth2AuthProviderTest, Status200) {
   }
 }
 
+TEST(OAuth2AuthProviderTest, EarlyRefresh) {
+  TestAuthProvider auth({"a", "b", "c"});
+  auth.responses = {
+      {0, {200, absl::Cord(kServiceAccountInfo), {}}},
+      {1,
+       {200,
+        absl::Cord(R"({"token_type": "123", "access_token": "def",
+                       "expires_in": 456})"),
+        {}}},
+  };
+  TENSORSTORE_ASSERT_OK(auth.GetToken());
+
+  // Shortly before expiration, the token is refreshed ahead of time.
+  auth.time += absl::Seconds(100);
+  EXPECT_TRUE(auth.IsValid());
+  auto result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(2, auth.request.size());
+  EXPECT_EQ("def", result->token);
+  EXPECT_EQ(auth.time + absl::Seconds(456), result->expiration);
+}
+
+TEST(OAuth2AuthProviderTest, EarlyRefreshFailure) {
+  TestAuthProvider auth({"a", "b", "c"});
+  auth.responses = {
+      {0, {200, absl::Cord(kServiceAccountInfo), {}}},
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto token, auth.GetToken());
+
+  // A failed early refresh continues to return the current token.
+  auth.time += absl::Seconds(100);
+  auto result = auth.GetToken();
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(2, auth.request.size());
+  EXPECT_EQ("abc", result->token);
+  EXPECT_EQ(token.expiration, result->expiration);
+
+  // Once the token expires, the refresh failure is returned.
+  auth.time += absl::Seconds(400);
+  EXPECT_FALSE(auth.GetToken().ok());
+  EXPECT_EQ(3, auth.request.size());
+}
+
 }  // namespace
@@ -20,26 +20,77 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/oauth2/bearer_token.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
 namespace internal_oauth2 {
+namespace {
+
+auto& token_wait_time_ms =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
+        "/tensorstore/oauth2/token_wait_time_ms",
+        internal_metrics::MetricMetadata(
+            "Time (ms) that GetToken calls were blocked waiting for an expired "
+            "OAuth2 token to be refreshed.",
+            internal_metrics::Units::kMilliseconds));
+
+}  // namespace
 
 RefreshableAuthProvider::RefreshableAuthProvider(
     std::function<absl::Time()> clock)
     : clock_(clock ? std::move(clock) : &absl::Now) {}
 
 Result<BearerTokenWithExpiration> RefreshableAuthProvider::GetToken() {
-  absl::MutexLock lock(&mutex_);
-  if (IsValidInternal()) {
-    return token_;
+  const absl::Time start_time = absl::Now();
+  const auto record_wait_time = [&] {
+    token_wait_time_ms.Observe(
+        absl::ToDoubleMilliseconds(absl::Now() - start_time));
+  };
+  bool expired;
+  {
+    absl::MutexLock lock(&mutex_);
+    bool waited = false;
+    while (true) {
+      if (IsValidInternal()) {
+        if (refresh_in_progress_ || !IsRefreshDueInternal()) {
+          if (waited) record_wait_time();
+          return token_;
+        }
+        // Refresh early; concurrent callers continue to use the current
+        // token.
+        break;
+      }
+      if (!refresh_in_progress_) break;
+      // Wait for the concurrent refresh rather than issuing another.
+      waited = true;
+      mutex_.Await(absl::Condition(
+          +[](bool* refresh_in_progress) { return !*refresh_in_progress; },
+          &refresh_in_progress_));
+    }
+    expired = !IsValidInternal();
+    refresh_in_progress_ = true;
+  }
+
+  Result<BearerTokenWithExpiration> token_result;
+  {
+    absl::MutexLock refresh_lock(&refresh_mutex_);
+    token_result = Refresh();
   }
 
-  auto token_result = Refresh();
-  if (token_result.ok()) {
-    token_ = token_result.value();
+  {
+    absl::MutexLock lock(&mutex_);
+    refresh_in_progress_ = false;
+    if (token_result.ok()) {
+      token_ = token_result.value();
+    } else if (!expired && IsValidInternal()) {
+      // A failed early refresh is retried by a subsequent call.
+      token_result = token_;
+    }
   }
+  if (expired) record_wait_time();
   return token_result;
 }
 
@@ -28,15 +28,24 @@ namespace tensorstore {
 namespace internal_oauth2 {
 
 /// Base class for auth providers that support refreshing.
+///
+/// At most one refresh is in progress at a time.  Once the token is within
+/// `kEarlyRefreshWindow` of expiring, a single caller refreshes it while
+/// concurrent callers continue to use the current token; callers only block
+/// when the token has actually expired.
 class RefreshableAuthProvider : public AuthProvider {
  public:
+  /// Duration before `kExpirationMargin` during which the token is refreshed
+  /// without blocking other callers.
+  static constexpr absl::Duration kEarlyRefreshWindow = absl::Minutes(5);
+
   explicit RefreshableAuthProvider(std::function<absl::Time()> clock = {});
 
   /// Returns the short-term authentication bearer token.
   ///
   /// Safe for concurrent use by multiple threads.
   Result<BearerTokenWithExpiration> GetToken()
-      ABSL_LOCKS_EXCLUDED(mutex_) override;
+      ABSL_LOCKS_EXCLUDED(mutex_, refresh_mutex_) override;
 
   /// Checks if the token is valid.
   bool IsValid() ABSL_LOCKS_EXCLUDED(mutex_) {
@@ -52,9 +61,9 @@ class RefreshableAuthProvider : public AuthProvider {
 
  protected:
   // Generate a new BearerTokenWithExpiration.
-  // Guaranteed to be called under lock.
+  // Guaranteed to be called under lock, by at most one thread at a time.
   virtual Result<BearerTokenWithExpiration> Refresh()
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) = 0;
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(refresh_mutex_) = 0;
 
   bool IsExpiredInternal() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
     return clock_() > (token_.expiration - kExpirationMargin);
@@ -64,6 +73,11 @@ class RefreshableAuthProvider : public AuthProvider {
     return !token_.token.empty() && !IsExpiredInternal();
   }
 
+  bool IsRefreshDueInternal() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return clock_() >
+           (token_.expiration - kExpirationMargin - kEarlyRefreshWindow);
+  }
+
   absl::Time GetCurrentTime() { return clock_(); }
 
  private:
@@ -72,6 +86,10 @@ class RefreshableAuthProvider : public AuthProvider {
   absl::Mutex mutex_;
   BearerTokenWithExpiration token_ ABSL_GUARDED_BY(mutex_) = {
       {}, absl::InfinitePast()};
+  bool refresh_in_progress_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Serializes calls to `Refresh`, which are made without holding `mutex_`.
+  absl::Mutex refresh_mutex_ ABSL_ACQUIRED_AFTER(mutex_);
 };
 
 }  // namespace internal_oauth2
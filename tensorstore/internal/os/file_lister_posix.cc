@@ -26,23 +26,35 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/os/error_code.h"
 #include "tensorstore/internal/os/potentially_blocking_region.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 // Include system headers last to reduce impact of macros.
 #include "tensorstore/internal/os/file_util.h"
 
@@ -57,6 +69,8 @@ struct ListerEntry::Impl {
   const std::string& full_path;
   std::string_view component;  // NULL-terminated.
   bool is_directory;
+  // Path of the entry relative to `parent_fd`, used by `Delete`.
+  const char* at_path = component.data();
 };
 
 bool ListerEntry::IsDirectory() { return impl_->is_directory; }
@@ -69,7 +83,7 @@ int64_t ListerEntry::GetSize() { return -1; }
 
 absl::Status ListerEntry::Delete() {
   PotentiallyBlockingRegion region;
-  if (::unlinkat(impl_->parent_fd, impl_->component.data(),
+  if (::unlinkat(impl_->parent_fd, impl_->at_path,
                  impl_->is_directory ? AT_REMOVEDIR : 0) == 0) {
     return absl::OkStatus();
   }
@@ -209,17 +223,319 @@ absl::Status RecursiveListImpl(
   return absl::OkStatus();
 }
 
-}  // namespace
+// Type of a directory entry, as reported when reading the directory.
+enum class DirectoryEntryType {
+  // Must be determined by opening the entry.
+  kUnknown,
+  kDirectory,
+  // Not a directory, nor a symbolic link.
+  kOther,
+};
 
-absl::Status RecursiveFileList(
-    std::string root_directory,
-    absl::FunctionRef<bool(std::string_view)> recurse_into,
-    absl::FunctionRef<absl::Status(ListerEntry)> on_item) {
-  // root_directory must be a directory.
+// Size of the buffer used to read directory entries.  Large buffers reduce
+// the number of system calls, which matters on filesystems where each call
+// requires a round trip to a metadata server.
+constexpr size_t kDirectoryBufferSize = 1024 * 1024;
+
+// Calls `callback` for each entry, other than "." and "..", of the directory
+// open as `fd`.  The name passed to `callback` is only valid for the duration
+// of the call.
+//
+// On Linux, entries are read directly with `getdents64`, rather than
+// `readdir`, which uses a fixed 32KiB buffer.
+absl::Status ForEachDirectoryEntry(
+    int fd, const std::string& path, std::vector<char>& buffer,
+    absl::FunctionRef<absl::Status(const char* name, DirectoryEntryType type)>
+        callback) {
+#ifdef __linux__
+  // Layout of the entries returned by `getdents64`.
+  struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];  // NULL-terminated.
+  };
+  if (buffer.empty()) buffer.resize(kDirectoryBufferSize);
+  while (true) {
+    long n;
+    {
+      PotentiallyBlockingRegion region;
+      n = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+    }
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return StatusFromOsError(errno,
+                               "Failed while listing: ", QuoteString(path));
+    }
+    if (n == 0) return absl::OkStatus();
+    for (long offset = 0; offset < n;) {
+      const auto* e =
+          reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+      offset += e->d_reclen;
+      if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) {
+        continue;
+      }
+      DirectoryEntryType type = DirectoryEntryType::kOther;
+      if (e->d_type == DT_DIR) {
+        type = DirectoryEntryType::kDirectory;
+      } else if (e->d_type == DT_UNKNOWN || e->d_type == DT_LNK) {
+        type = DirectoryEntryType::kUnknown;
+      }
+      TENSORSTORE_RETURN_IF_ERROR(callback(e->d_name, type));
+    }
+  }
+#else
+  // `fdopendir` takes ownership of the descriptor, which remains owned by the
+  // caller.
+  int dir_fd = ::dup(fd);
+  DIR* dir = dir_fd == -1 ? nullptr : ::fdopendir(dir_fd);
+  if (dir == nullptr) {
+    auto status =
+        StatusFromOsError(errno, "Failed while listing: ", QuoteString(path));
+    if (dir_fd != -1) ::close(dir_fd);
+    return status;
+  }
+  absl::Status status;
+  while (status.ok()) {
+    struct dirent* e;
+    {
+      PotentiallyBlockingRegion region;
+      errno = 0;
+      e = ::readdir(dir);
+    }
+    if (e == nullptr) {
+      if (errno != 0) {
+        status = StatusFromOsError(errno,
+                                   "Failed while listing: ", QuoteString(path));
+      }
+      break;
+    }
+    if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0) {
+      continue;
+    }
+    status = callback(e->d_name, DirectoryEntryType::kUnknown);
+  }
+  ::closedir(dir);
+  return status;
+#endif
+}
+
+// Shared state of a `ParallelRecursiveFileList` operation.
+struct ParallelListState {
+  // Entry that may be a directory, which is listed by a worker.
+  struct Directory {
+    Directory(std::string path, size_t component_size,
+              std::shared_ptr<Directory> parent)
+        : path(std::move(path)),
+          component_size(component_size),
+          parent(std::move(parent)) {}
+
+    std::string path;
+    size_t component_size;
+    std::shared_ptr<Directory> parent;
+
+    // Number of subdirectories not yet visited, plus one until this entry has
+    // been listed.  The entry is visited once this reaches zero.
+    std::atomic<size_t> pending{1};
+
+    // Set when this entry is opened successfully as a directory.
+    bool is_directory = false;
+  };
+
+  using DirectoryPtr = std::shared_ptr<Directory>;
+
+  // Maximum number of subdirectories found by a worker before they are made
+  // available to other workers.
+  constexpr static size_t kEnqueueBatchSize = 16;
+
+  ParallelListState(absl::FunctionRef<bool(std::string_view)> recurse_into,
+                    absl::FunctionRef<absl::Status(ListerEntry)> on_item,
+                    const ParallelFileListOptions& options)
+      : recurse_into(recurse_into),
+        on_item(on_item),
+        executor(options.executor),
+        max_helpers(options.concurrency - 1) {}
+
+  bool stopped() const { return stopped_.load(std::memory_order_relaxed); }
+
+  // Records the first error, which stops the listing.
+  void Fail(absl::Status error) {
+    if (error.ok()) return;
+    absl::MutexLock lock(&mutex);
+    if (!status.ok()) return;
+    status = std::move(error);
+    stopped_.store(true, std::memory_order_relaxed);
+  }
+
+  // Visits an entry that was queued as a `Directory`.
+  void Visit(const Directory& entry, bool is_directory) {
+    if (stopped()) return;
+    std::string_view component(entry.path);
+    component.remove_prefix(entry.path.size() - entry.component_size);
+    // Since the parent directory is no longer open, entries other than the
+    // root are deleted by full path.  The root is never deleted, as with
+    // `RecursiveFileList`.
+    ListerEntry::Impl impl{
+        AT_FDCWD, entry.path, component, is_directory,
+        entry.parent ? entry.path.c_str() : component.data()};
+    Fail(on_item(ListerEntry(&impl)));
+  }
+
+  // Indicates that one of the outstanding operations counted by
+  // `entry->pending` has completed, and visits the entry, and then
+  // recursively its parents, if they have no other outstanding operations.
+  void Release(DirectoryPtr entry) {
+    while (entry &&
+           entry->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (entry->is_directory) Visit(*entry, /*is_directory=*/true);
+      auto parent = std::move(entry->parent);
+      entry = std::move(parent);
+    }
+  }
+
+  // Makes `entries` available to other workers, and clears it.
+  static void Enqueue(const std::shared_ptr<ParallelListState>& self,
+                      std::vector<DirectoryPtr>& entries) {
+    if (entries.empty()) return;
+    size_t new_helpers = 0;
+    {
+      absl::MutexLock lock(&self->mutex);
+      for (auto& entry : entries) self->queue.push_back(std::move(entry));
+      while (self->num_helpers < self->max_helpers &&
+             self->num_helpers < self->queue.size()) {
+        ++self->num_helpers;
+        ++new_helpers;
+      }
+    }
+    entries.clear();
+    for (size_t i = 0; i < new_helpers; ++i) {
+      self->executor([self] {
+        std::vector<char> buffer;
+        RunWorker(self, buffer, /*is_helper=*/true);
+      });
+    }
+  }
+
+  // Lists the directory `entry`, visiting the files it contains and queuing
+  // its subdirectories.
+  static void ProcessEntry(const std::shared_ptr<ParallelListState>& self,
+                           DirectoryPtr entry, std::vector<char>& buffer) {
+    int fd;
+    do {
+      PotentiallyBlockingRegion region;
+      fd = ::openat(AT_FDCWD, entry->path.empty() ? "." : entry->path.c_str(),
+                    O_CLOEXEC | O_RDONLY | O_DIRECTORY |
+                        (entry->parent ? O_NOFOLLOW : 0));
+    } while (fd == -1 && (errno == EINTR || errno == EAGAIN));
+    if (fd == -1) {
+      if (errno == ENOTDIR) {
+        self->Visit(*entry, /*is_directory=*/false);
+      } else if (errno != ENOENT) {
+        self->Fail(StatusFromOsError(errno, "Failed while listing: ",
+                                     QuoteString(entry->path)));
+      }
+      self->Release(std::move(entry));
+      return;
+    }
+    entry->is_directory = true;
+    if (self->stopped() || !self->recurse_into(entry->path)) {
+      ::close(fd);
+      self->Release(std::move(entry));
+      return;
+    }
+
+    std::vector<DirectoryPtr> subdirectories;
+    const std::string& path = entry->path;
+    auto status = ForEachDirectoryEntry(
+        fd, path, buffer,
+        [&](const char* name, DirectoryEntryType type) -> absl::Status {
+          if (self->stopped()) return absl::CancelledError("");
+          std::string_view name_view(name);
+          std::string subpath = absl::StrCat(
+              path, (path.empty() || absl::EndsWith(path, "/")) ? "" : "/",
+              name_view);
+          if (type == DirectoryEntryType::kOther) {
+            std::string_view component(subpath);
+            component.remove_prefix(subpath.size() - name_view.size());
+            ListerEntry::Impl impl{fd, subpath, component, false};
+            return self->on_item(ListerEntry(&impl));
+          }
+          entry->pending.fetch_add(1, std::memory_order_relaxed);
+          subdirectories.push_back(std::make_shared<Directory>(
+              std::move(subpath), name_view.size(), entry));
+          if (subdirectories.size() >= kEnqueueBatchSize) {
+            Enqueue(self, subdirectories);
+          }
+          return absl::OkStatus();
+        });
+    Enqueue(self, subdirectories);
+    ::close(fd);
+    self->Fail(std::move(status));
+    self->Release(std::move(entry));
+  }
+
+  // Processes queued entries.  Helpers return once the queue is empty, while
+  // the calling thread returns once all entries have been processed.
+  static void RunWorker(const std::shared_ptr<ParallelListState>& self,
+                        std::vector<char>& buffer, bool is_helper) {
+    self->mutex.Lock();
+    while (true) {
+      if (is_helper) {
+        if (!self->status.ok() || self->queue.empty()) {
+          --self->num_helpers;
+          break;
+        }
+      } else {
+        self->mutex.Await(absl::Condition(
+            +[](ParallelListState* state) {
+              return (!state->queue.empty() && state->status.ok()) ||
+                     state->in_progress == 0;
+            },
+            self.get()));
+        if (self->queue.empty() || !self->status.ok()) {
+          assert(self->in_progress == 0);
+          break;
+        }
+      }
+      auto entry = std::move(self->queue.back());
+      self->queue.pop_back();
+      ++self->in_progress;
+      self->mutex.Unlock();
+      ProcessEntry(self, std::move(entry), buffer);
+      self->mutex.Lock();
+      --self->in_progress;
+    }
+    self->mutex.Unlock();
+  }
+
+  absl::FunctionRef<bool(std::string_view)> recurse_into;
+  absl::FunctionRef<absl::Status(ListerEntry)> on_item;
+  Executor executor;
+  size_t max_helpers;
+
+  absl::Mutex mutex;
+  // Entries not yet being processed.  Processed in LIFO order, which limits
+  // the number of queued entries similarly to a depth-first traversal.
+  std::vector<DirectoryPtr> queue ABSL_GUARDED_BY(mutex);
+  // Number of entries being processed.
+  size_t in_progress ABSL_GUARDED_BY(mutex) = 0;
+  // Number of helper tasks submitted to `executor` that have not returned.
+  size_t num_helpers ABSL_GUARDED_BY(mutex) = 0;
+  absl::Status status ABSL_GUARDED_BY(mutex);
+
+ private:
+  std::atomic<bool> stopped_{false};
+};
+
+// Checks that `root_directory` is a directory.
+//
+// \returns `false` if `root_directory` does not exist.
+Result<bool> CheckRootDirectory(const std::string& root_directory) {
   struct ::stat dir_stat;
   if (::fstatat(AT_FDCWD, root_directory.empty() ? "." : root_directory.c_str(),
                 &dir_stat, 0) != 0) {
-    if (errno == ENOENT) return absl::OkStatus();
+    if (errno == ENOENT) return false;
     return StatusFromOsError(errno,
                              "Failed to stat: ", QuoteString(root_directory));
   }
@@ -227,11 +543,54 @@ absl::Status RecursiveFileList(
     return absl::NotFoundError(absl::StrCat("Cannot list non-directory: ",
                                             QuoteString(root_directory)));
   }
+  return true;
+}
+
+}  // namespace
+
+absl::Status RecursiveFileList(
+    std::string root_directory,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_item) {
+  // root_directory must be a directory.
+  TENSORSTORE_ASSIGN_OR_RETURN(bool exists,
+                               CheckRootDirectory(root_directory));
+  if (!exists) return absl::OkStatus();
 
   auto status = RecursiveListImpl(recurse_into, on_item, root_directory);
   MaybeAddSourceLocation(status);
   return status;
 }
 
+absl::Status ParallelRecursiveFileList(
+    std::string root_directory,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_item,
+    const ParallelFileListOptions& options) {
+  if (options.concurrency <= 1) {
+    return RecursiveFileList(std::move(root_directory), recurse_into, on_item);
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(bool exists,
+                               CheckRootDirectory(root_directory));
+  if (!exists) return absl::OkStatus();
+
+  auto state =
+      std::make_shared<ParallelListState>(recurse_into, on_item, options);
+  {
+    absl::MutexLock lock(&state->mutex);
+    state->queue.push_back(std::make_shared<ParallelListState::Directory>(
+        std::move(root_directory), 0, nullptr));
+  }
+  std::vector<char> buffer;
+  ParallelListState::RunWorker(state, buffer, /*is_helper=*/false);
+  absl::Status status;
+  {
+    absl::MutexLock lock(&state->mutex);
+    status = state->status;
+  }
+  MaybeAddSourceLocation(status);
+  return status;
+}
+
 }  // namespace internal_os
 }  // namespace tensorstore
@@ -25,8 +25,10 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/os/file_util.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/internal/thread/thread_pool.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/status_testutil.h"
@@ -41,6 +43,8 @@ using ::tensorstore::internal_os::MakeDirectory;
 using ::tensorstore::internal_os::OpenDirectoryDescriptor;
 using ::tensorstore::internal_os::OpenExistingFileForReading;
 using ::tensorstore::internal_os::OpenFileForWriting;
+using ::tensorstore::internal_os::ParallelFileListOptions;
+using ::tensorstore::internal_os::ParallelRecursiveFileList;
 using ::tensorstore::internal_os::ReadFromFile;
 using ::tensorstore::internal_os::RecursiveFileList;
 using ::tensorstore::internal_os::WriteToFile;
@@ -228,4 +232,139 @@ TEST(RecursiveFileListEntryTest, DeleteWithOpenFile) {
   EXPECT_THAT(files, ::testing::UnorderedElementsAre("<dir>"));
 }
 
+ParallelFileListOptions GetParallelOptions() {
+  ParallelFileListOptions options;
+  options.executor = tensorstore::internal::DetachedThreadPool(4);
+  options.concurrency = 4;
+  return options;
+}
+
+TEST_F(RecursiveFileListTest, ParallelFullDirectory) {
+  for (const std::string& root :
+       {g_scoped_dir->path(), std::string("."), std::string()}) {
+    absl::Mutex mutex;
+    std::vector<std::string> files;
+    EXPECT_THAT(
+        ParallelRecursiveFileList(
+            root, /*recurse_into=*/[](std::string_view path) { return true; },
+            /*on_item=*/
+            [&](auto entry) {
+              absl::MutexLock lock(&mutex);
+              files.push_back(absl::StrCat(entry.IsDirectory() ? "<dir>" : "",
+                                           entry.GetPathComponent()));
+              return absl::OkStatus();
+            },
+            GetParallelOptions()),
+        IsOk());
+    EXPECT_THAT(files, ::testing::UnorderedElementsAre(
+                           "c.txt", "b.txt", "a.txt", "<dir>zzq", "c.txt",
+                           "b.txt", "a.txt", "<dir>xyz", "<dir>"));
+  }
+}
+
+TEST_F(RecursiveFileListTest, ParallelMissingAndFile) {
+  auto options = GetParallelOptions();
+  auto on_item = [](auto entry) { return absl::OkStatus(); };
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  g_scoped_dir->path() + "/aax",
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  on_item, options),
+              IsOk());
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  g_scoped_dir->path() + "/a.txt",
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  on_item, options),
+              ::testing::Not(IsOk()));
+}
+
+TEST_F(RecursiveFileListTest, ParallelNonRecursive) {
+  absl::Mutex mutex;
+  std::vector<std::string> files;
+  EXPECT_THAT(
+      ParallelRecursiveFileList(
+          "",
+          /*recurse_into=*/
+          [](std::string_view path) { return path.empty(); },
+          /*on_item=*/
+          [&](auto entry) {
+            absl::MutexLock lock(&mutex);
+            files.push_back(absl::StrCat(entry.IsDirectory() ? "<dir>" : "",
+                                         entry.GetFullPath()));
+            return absl::OkStatus();
+          },
+          GetParallelOptions()),
+      IsOk());
+  EXPECT_THAT(files,
+              ::testing::UnorderedElementsAre("c.txt", "b.txt", "a.txt",
+                                              "<dir>zzq", "<dir>xyz", "<dir>"));
+}
+
+TEST_F(RecursiveFileListTest, ParallelError) {
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  "",
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  /*on_item=*/
+                  [&](auto entry) -> absl::Status {
+                    if (entry.GetPathComponent() == "b.txt") {
+                      return absl::UnknownError("b.txt");
+                    }
+                    return absl::OkStatus();
+                  },
+                  GetParallelOptions()),
+              tensorstore::MatchesStatus(absl::StatusCode::kUnknown, "b.txt"));
+}
+
+TEST(ParallelRecursiveFileListTest, DeleteLargeTree) {
+  ScopedTemporaryDirectory tmpdir;
+  constexpr int kNumDirectories = 20;
+  constexpr int kNumFiles = 10;
+  for (int i = 0; i < kNumDirectories; ++i) {
+    std::string dir = absl::StrCat(tmpdir.path(), "/d", i);
+    TENSORSTORE_CHECK_OK(MakeDirectory(dir));
+    TENSORSTORE_CHECK_OK(MakeDirectory(absl::StrCat(dir, "/sub")));
+    for (int j = 0; j < kNumFiles; ++j) {
+      TENSORSTORE_CHECK_OK(OpenFileForWriting(absl::StrCat(dir, "/f", j)));
+      TENSORSTORE_CHECK_OK(
+          OpenFileForWriting(absl::StrCat(dir, "/sub/f", j)));
+    }
+  }
+
+  // Directories must be visited after their entries, such that they are
+  // empty when deleted.
+  absl::Mutex mutex;
+  int num_files = 0, num_directories = 0;
+  EXPECT_THAT(ParallelRecursiveFileList(
+                  tmpdir.path(),
+                  /*recurse_into=*/[](std::string_view path) { return true; },
+                  /*on_item=*/
+                  [&](auto entry) -> absl::Status {
+                    {
+                      absl::MutexLock lock(&mutex);
+                      ++(entry.IsDirectory() ? num_directories : num_files);
+                    }
+                    if (entry.GetFullPath() == tmpdir.path()) {
+                      return absl::OkStatus();
+                    }
+                    return entry.Delete();
+                  },
+                  GetParallelOptions()),
+              IsOk());
+  EXPECT_EQ(2 * kNumDirectories * kNumFiles, num_files);
+  EXPECT_EQ(2 * kNumDirectories + 1, num_directories);
+
+  std::vector<std::string> files;
+  EXPECT_THAT(
+      RecursiveFileList(
+          tmpdir.path(),
+          /*recurse_into=*/[](std::string_view path) { return true; },
+          /*on_item=*/
+          [&](auto entry) {
+            files.push_back(absl::StrCat(entry.IsDirectory() ? "<dir>" : "",
+                                         entry.GetPathComponent()));
+            return absl::OkStatus();
+          }),
+      IsOk());
+  EXPECT_THAT(files, ::testing::UnorderedElementsAre("<dir>"));
+}
+
 }  // namespace
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
@@ -262,5 +263,13 @@ absl::Status RecursiveFileList(
   return status;
 }
 
+absl::Status ParallelRecursiveFileList(
+    std::string root_directory,
+    absl::FunctionRef<bool(std::string_view)> recurse_into,
+    absl::FunctionRef<absl::Status(ListerEntry)> on_item,
+    const ParallelFileListOptions& options) {
+  return RecursiveFileList(std::move(root_directory), recurse_into, on_item);
+}
+
 }  // namespace internal_os
 }  // namespace tensorstore
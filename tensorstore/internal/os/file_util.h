@@ -111,6 +111,31 @@ Result<UniqueFileDescriptor> OpenExistingFileForReading(
 ///     the error).
 Result<UniqueFileDescriptor> OpenFileForWriting(const std::string& path);
 
+/// Opens a file that must already exist for appending.  Subsequent calls to
+/// `WriteToFile` and `WriteCordToFile` write at the end of the file.
+///
+/// \returns The open file descriptor on success.
+/// \error `absl::StatusCode::kNotFound` if the file does not exist.
+Result<UniqueFileDescriptor> OpenExistingFileForAppending(
+    const std::string& path);
+
+/// Opens an unnamed regular file for writing in the directory `dir_path`,
+/// which may later be given a name by `LinkAnonymousFile`.  The file is
+/// removed automatically when it is closed without having been linked.
+///
+/// This uses `O_TMPFILE` on Linux.
+///
+/// \returns The open file descriptor on success, or an invalid file descriptor
+///     if anonymous files are not supported by the platform or filesystem.
+Result<UniqueFileDescriptor> OpenAnonymousFileForWriting(
+    const std::string& dir_path);
+
+/// Links a file opened by `OpenAnonymousFileForWriting` at `path`.
+///
+/// \error `absl::StatusCode::kAlreadyExists` if `path` already exists.
+/// \error `absl::StatusCode::kUnimplemented` if not supported.
+absl::Status LinkAnonymousFile(FileDescriptor fd, const std::string& path);
+
 /// Reads from an open file.
 ///
 /// \param fd Open file descriptor.
@@ -123,6 +148,49 @@ Result<UniqueFileDescriptor> OpenFileForWriting(const std::string& path);
 Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
                                int64_t offset);
 
+/// Maps a region of an open file into memory.
+///
+/// The file contents must not be truncated while the region is mapped, since
+/// accessing a truncated portion results in a `SIGBUS`; this holds for files
+/// that are only ever replaced via `RenameOpenFile`.
+///
+/// \param fd Open file descriptor.
+/// \param offset Byte offset within file at which the region starts.
+/// \param size Size in bytes of the region.
+/// \returns A cord that directly references the mapped memory.  The mapping
+///     is released when the last reference to the cord (or to any of its
+///     sub-cords) is destroyed.
+/// \error `absl::StatusCode::kUnimplemented` on Windows, where a mapped file
+///     cannot be replaced or deleted.
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t offset,
+                                      size_t size);
+
+/// Alignment of the buffer address, file offset and size required for writes
+/// to a file on which direct I/O has been enabled by `SetFileDirectIo`.
+constexpr inline size_t kDirectIoAlignment = 4096;
+
+/// Enables or disables direct I/O on an open file, which transfers data
+/// between user buffers and the storage device without going through the
+/// page cache.
+///
+/// On Linux this sets `O_DIRECT`, which requires that writes use buffers,
+/// file offsets and sizes aligned to `kDirectIoAlignment`.  On macOS this
+/// sets `F_NOCACHE`, which has no alignment requirements.
+///
+/// \error `absl::StatusCode::kUnimplemented` if not supported on this
+///     platform.
+/// \error `absl::StatusCode::kInvalidArgument` if not supported by the
+///     filesystem.
+absl::Status SetFileDirectIo(FileDescriptor fd, bool enable);
+
+/// Advises the operating system that the specified byte range of an open file
+/// will not be accessed again soon, so that its cached pages (other than
+/// dirty pages) may be dropped.  A `size` of `0` extends to the end of the
+/// file.
+///
+/// This is only a hint, and does nothing on platforms that do not support it.
+void AdviseFileDontNeed(FileDescriptor fd, int64_t offset, int64_t size);
+
 /// Writes to an open file.
 ///
 /// \param fd Open file descriptor.
@@ -143,6 +211,17 @@ Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf, size_t count);
 ///     error).
 Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value);
 
+/// Copies the first `size` bytes of `source_fd` to the current position of
+/// `target_fd`, which must be empty.
+///
+/// Where supported, the data is shared with the source (reflink) or copied
+/// within the kernel rather than through a user-space buffer.
+///
+/// \error `absl::StatusCode::kUnavailable` if `source_fd` is shorter than
+///     `size`.
+absl::Status CopyFileData(FileDescriptor source_fd, FileDescriptor target_fd,
+                          int64_t size);
+
 /// Truncates an open file.
 ///
 /// \returns `true` on success, or `false` in case of an error (in which case
@@ -180,6 +259,14 @@ absl::Status DeleteFile(const std::string& path);
 ///     retrieve the error).
 absl::Status FsyncFile(FileDescriptor fd);
 
+/// Syncs the data of an open file descriptor, along with any metadata (such
+/// as the file size) required to read it back, but not necessarily other
+/// metadata such as the modification time.
+///
+/// Uses `fdatasync` where available, and is otherwise equivalent to
+/// `FsyncFile`.
+absl::Status FsyncFileData(FileDescriptor fd);
+
 /// --------------------------------------------------------------------------
 
 /// Retrieves the metadata for an open file.
@@ -23,20 +23,26 @@
 #include <fcntl.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
-#ifndef __linux__
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#else
 #include <sys/file.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/log/absl_check.h"
@@ -155,6 +161,58 @@ Result<UniqueFileDescriptor> OpenFileForWriting(const std::string& path) {
   return UniqueFileDescriptor(fd);
 }
 
+Result<UniqueFileDescriptor> OpenExistingFileForAppending(
+    const std::string& path) {
+  FileDescriptor fd;
+  {
+    PotentiallyBlockingRegion region;
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  }
+  if (fd == FileDescriptorTraits::Invalid()) {
+    return StatusFromOsError(errno, "Failed to open: ", QuoteString(path));
+  }
+  return UniqueFileDescriptor(fd);
+}
+
+Result<UniqueFileDescriptor> OpenAnonymousFileForWriting(
+    const std::string& dir_path) {
+#ifdef O_TMPFILE
+  FileDescriptor fd;
+  {
+    PotentiallyBlockingRegion region;
+    fd = ::open(dir_path.c_str(), O_TMPFILE | O_WRONLY | O_CLOEXEC, 0666);
+  }
+  if (fd != FileDescriptorTraits::Invalid()) {
+    return UniqueFileDescriptor(fd);
+  }
+  // These errors indicate that the kernel or filesystem does not support
+  // `O_TMPFILE`.
+  if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL) {
+    return StatusFromOsError(errno, "Failed to create anonymous file in: ",
+                             QuoteString(dir_path));
+  }
+#endif
+  return UniqueFileDescriptor{};
+}
+
+absl::Status LinkAnonymousFile(FileDescriptor fd, const std::string& path) {
+#ifdef O_TMPFILE
+  // Linking via `/proc/self/fd` with `AT_SYMLINK_FOLLOW`, unlike
+  // `AT_EMPTY_PATH`, does not require `CAP_DAC_READ_SEARCH`.
+  const std::string fd_path = absl::StrCat("/proc/self/fd/", fd);
+  int result;
+  {
+    PotentiallyBlockingRegion region;
+    result = ::linkat(AT_FDCWD, fd_path.c_str(), AT_FDCWD, path.c_str(),
+                      AT_SYMLINK_FOLLOW);
+  }
+  if (result == 0) return absl::OkStatus();
+  return StatusFromOsError(errno, "Failed to link: ", QuoteString(path));
+#else
+  return absl::UnimplementedError("Anonymous files are not supported");
+#endif
+}
+
 Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
                                int64_t offset) {
   ssize_t n;
@@ -168,6 +226,46 @@ Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
   return StatusFromOsError(errno, "Failed to read from file");
 }
 
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t offset,
+                                      size_t size) {
+  if (size == 0) return absl::Cord();
+  static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  // `mmap` requires the offset to be a multiple of the page size.
+  const size_t page_offset = offset % page_size;
+  const size_t map_size = size + page_offset;
+  void* address = ::mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd,
+                         static_cast<off_t>(offset - page_offset));
+  if (address == MAP_FAILED) {
+    return StatusFromOsError(errno, "Failed to mmap file");
+  }
+  return absl::MakeCordFromExternal(
+      std::string_view(static_cast<const char*>(address) + page_offset, size),
+      [address, map_size] { ::munmap(address, map_size); });
+}
+
+absl::Status SetFileDirectIo(FileDescriptor fd, bool enable) {
+#if defined(O_DIRECT)
+  int flags = ::fcntl(fd, F_GETFL);
+  if (flags != -1) {
+    flags = enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (::fcntl(fd, F_SETFL, flags) == 0) return absl::OkStatus();
+  }
+  return StatusFromOsError(errno, "Failed to set O_DIRECT");
+#elif defined(F_NOCACHE)
+  if (::fcntl(fd, F_NOCACHE, enable ? 1 : 0) == 0) return absl::OkStatus();
+  return StatusFromOsError(errno, "Failed to set F_NOCACHE");
+#else
+  return absl::UnimplementedError("Direct I/O is not supported");
+#endif
+}
+
+void AdviseFileDontNeed(FileDescriptor fd, int64_t offset, int64_t size) {
+#if defined(POSIX_FADV_DONTNEED)
+  ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size),
+                  POSIX_FADV_DONTNEED);
+#endif
+}
+
 Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
                               size_t count) {
   ssize_t n;
@@ -206,6 +304,71 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return StatusFromOsError(errno, "Failed to write to file");
 }
 
+absl::Status CopyFileData(FileDescriptor source_fd, FileDescriptor target_fd,
+                          int64_t size) {
+  if (size == 0) return absl::OkStatus();
+  off_t offset = 0;
+#ifdef __linux__
+#ifdef FICLONE
+  // Share the extents of the source when the filesystem supports it (btrfs,
+  // xfs); this requires the target to be empty.
+  {
+    PotentiallyBlockingRegion region;
+    if (::ioctl(target_fd, FICLONE, source_fd) == 0) {
+      struct ::stat info;
+      if (::fstat(target_fd, &info) != 0) {
+        return StatusFromOsError(errno, "Failed to get file info");
+      }
+      if (info.st_size != size) {
+        return absl::UnavailableError("Length changed while copying");
+      }
+      if (::lseek(target_fd, size, SEEK_SET) < 0) {
+        return StatusFromOsError(errno, "Failed to seek in file");
+      }
+      return absl::OkStatus();
+    }
+  }
+#endif
+  while (offset < size) {
+    ssize_t n;
+    {
+      PotentiallyBlockingRegion region;
+      n = ::copy_file_range(source_fd, &offset, target_fd, nullptr,
+                            static_cast<size_t>(size - offset), 0);
+    }
+    if (n > 0) continue;
+    if (n == 0) {
+      return absl::UnavailableError("Length changed while copying");
+    }
+    if (errno == EINTR) continue;
+    if (offset == 0 && (errno == EXDEV || errno == ENOSYS ||
+                        errno == EOPNOTSUPP || errno == EINVAL)) {
+      // Fall back to copying through a buffer below.
+      break;
+    }
+    return StatusFromOsError(errno, "Failed to copy file range");
+  }
+#endif
+  constexpr int64_t kMaxBufferSize = 1024 * 1024;
+  std::vector<char> buffer(std::min(size - offset, kMaxBufferSize));
+  while (offset < size) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n,
+        ReadFromFile(source_fd, buffer.data(),
+                     std::min<int64_t>(size - offset, buffer.size()), offset));
+    if (n == 0) {
+      return absl::UnavailableError("Length changed while copying");
+    }
+    for (ptrdiff_t written = 0; written < n;) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto m, WriteToFile(target_fd, buffer.data() + written, n - written));
+      written += m;
+    }
+    offset += n;
+  }
+  return absl::OkStatus();
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   if (::ftruncate(fd, 0) == 0) {
     return absl::OkStatus();
@@ -243,6 +406,17 @@ absl::Status FsyncFile(FileDescriptor fd) {
   return StatusFromOsError(errno);
 }
 
+absl::Status FsyncFileData(FileDescriptor fd) {
+#if defined(__linux__)
+  if (::fdatasync(fd) == 0) {
+    return absl::OkStatus();
+  }
+  return StatusFromOsError(errno);
+#else
+  return FsyncFile(fd);
+#endif
+}
+
 absl::Status GetFileInfo(FileDescriptor fd, FileInfo* info) {
   if (::fstat(fd, info) == 0) {
     return absl::OkStatus();
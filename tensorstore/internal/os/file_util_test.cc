@@ -14,7 +14,9 @@
 
 #include "tensorstore/internal/os/file_util.h"
 
+#include <new>
 #include <string>
+#include <string_view>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -22,6 +24,7 @@
 #include "absl/strings/cord.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
 #include "tensorstore/util/status_testutil.h"
 
@@ -30,6 +33,8 @@ namespace {
 using ::tensorstore::IsOk;
 using ::tensorstore::IsOkAndHolds;
 using ::tensorstore::StatusIs;
+using ::tensorstore::internal_os::AdviseFileDontNeed;
+using ::tensorstore::internal_os::CopyFileData;
 using ::tensorstore::internal_os::DeleteFile;
 using ::tensorstore::internal_os::DeleteOpenFile;
 using ::tensorstore::internal_os::FileInfo;
@@ -41,10 +46,16 @@ using ::tensorstore::internal_os::GetMTime;
 using ::tensorstore::internal_os::GetSize;
 using ::tensorstore::internal_os::IsDirSeparator;
 using ::tensorstore::internal_os::IsRegularFile;
+using ::tensorstore::internal_os::kDirectIoAlignment;
+using ::tensorstore::internal_os::LinkAnonymousFile;
+using ::tensorstore::internal_os::MemmapFileReadOnly;
+using ::tensorstore::internal_os::OpenAnonymousFileForWriting;
+using ::tensorstore::internal_os::OpenExistingFileForAppending;
 using ::tensorstore::internal_os::OpenExistingFileForReading;
 using ::tensorstore::internal_os::OpenFileForWriting;
 using ::tensorstore::internal_os::ReadFromFile;
 using ::tensorstore::internal_os::RenameOpenFile;
+using ::tensorstore::internal_os::SetFileDirectIo;
 using ::tensorstore::internal_os::TruncateFile;
 using ::tensorstore::internal_os::WriteCordToFile;
 using ::tensorstore::internal_os::WriteToFile;
@@ -120,4 +131,158 @@ TEST(FileUtilTest, Basics) {
   }
 }
 
+TEST(FileUtilTest, OpenExistingFileForAppending) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+
+  EXPECT_THAT(OpenExistingFileForAppending(foo_txt),
+              StatusIs(absl::StatusCode::kNotFound));
+  {
+    auto f = OpenFileForWriting(foo_txt);
+    EXPECT_THAT(WriteToFile(f->get(), "foo", 3), IsOkAndHolds(3));
+  }
+  {
+    auto f = OpenExistingFileForAppending(foo_txt);
+    ASSERT_THAT(f, IsOk());
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord("bar")), IsOkAndHolds(3));
+  }
+  {
+    char buf[16];
+    auto f = OpenExistingFileForReading(foo_txt);
+    ASSERT_THAT(f, IsOk());
+    EXPECT_THAT(ReadFromFile(f->get(), buf, sizeof(buf), 0), IsOkAndHolds(6));
+    EXPECT_EQ("foobar", std::string_view(buf, 6));
+  }
+}
+
+TEST(FileUtilTest, AnonymousFile) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  std::string bar_txt = tempdir.path() + "/bar.txt";
+
+  auto f = OpenAnonymousFileForWriting(tempdir.path());
+  ASSERT_THAT(f, IsOk());
+  if (!f->valid()) {
+    GTEST_SKIP() << "Anonymous files not supported";
+  }
+  EXPECT_THAT(WriteToFile(f->get(), "foo", 3), IsOkAndHolds(3));
+  {
+    auto g = OpenFileForWriting(bar_txt);
+    ASSERT_THAT(g, IsOk());
+  }
+  EXPECT_THAT(LinkAnonymousFile(f->get(), bar_txt),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(LinkAnonymousFile(f->get(), foo_txt), IsOk());
+  {
+    char buf[16];
+    auto g = OpenExistingFileForReading(foo_txt);
+    ASSERT_THAT(g, IsOk());
+    EXPECT_THAT(ReadFromFile(g->get(), buf, sizeof(buf), 0), IsOkAndHolds(3));
+    EXPECT_EQ("foo", std::string_view(buf, 3));
+  }
+}
+
+TEST(FileUtilTest, CopyFileData) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  std::string bar_txt = tempdir.path() + "/bar.txt";
+  std::string data(3 * 1024 * 1024 + 7, 'x');
+  data[5000] = 'y';
+  {
+    auto f = OpenFileForWriting(foo_txt);
+    ASSERT_THAT(f, IsOk());
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord(data)),
+                IsOkAndHolds(data.size()));
+  }
+  auto source = OpenExistingFileForReading(foo_txt);
+  ASSERT_THAT(source, IsOk());
+  {
+    auto target = OpenFileForWriting(bar_txt);
+    ASSERT_THAT(target, IsOk());
+    EXPECT_THAT(CopyFileData(source->get(), target->get(), data.size()),
+                IsOk());
+    FileInfo info;
+    EXPECT_THAT(GetFileInfo(target->get(), &info), IsOk());
+    EXPECT_EQ(data.size(), GetSize(info));
+  }
+  {
+    auto f = OpenExistingFileForReading(bar_txt);
+    ASSERT_THAT(f, IsOk());
+    std::string contents(data.size(), '\0');
+    for (size_t offset = 0; offset < contents.size();) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto n, ReadFromFile(f->get(), contents.data() + offset,
+                               contents.size() - offset, offset));
+      ASSERT_GT(n, 0);
+      offset += n;
+    }
+    EXPECT_EQ(data, contents);
+  }
+
+  // Source shorter than requested.
+  {
+    auto target = OpenFileForWriting(tempdir.path() + "/baz.txt");
+    ASSERT_THAT(target, IsOk());
+    EXPECT_THAT(CopyFileData(source->get(), target->get(), data.size() + 1),
+                StatusIs(absl::StatusCode::kUnavailable));
+  }
+}
+
+#ifndef _WIN32
+TEST(FileUtilTest, MemmapFileReadOnly) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  std::string data(10000, 'x');
+  data[5000] = 'y';
+  {
+    auto f = OpenFileForWriting(foo_txt);
+    EXPECT_THAT(WriteCordToFile(f->get(), absl::Cord(data)),
+                IsOkAndHolds(data.size()));
+  }
+
+  absl::Cord mapped;
+  {
+    auto f = OpenExistingFileForReading(foo_txt);
+    ASSERT_THAT(f, IsOk());
+    EXPECT_THAT(MemmapFileReadOnly(f->get(), 0, 0),
+                IsOkAndHolds(absl::Cord()));
+    // Unaligned offset.
+    auto result = MemmapFileReadOnly(f->get(), 4999, 3);
+    EXPECT_THAT(result, IsOkAndHolds(absl::Cord("xyx")));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        mapped, MemmapFileReadOnly(f->get(), 0, data.size()));
+  }
+  // The mapping remains valid after the file is closed and deleted.
+  EXPECT_THAT(DeleteFile(foo_txt), IsOk());
+  EXPECT_EQ(data, mapped);
+}
+
+TEST(FileUtilTest, DirectIoWrite) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string foo_txt = tempdir.path() + "/foo.txt";
+  auto f = OpenFileForWriting(foo_txt);
+  ASSERT_THAT(f, IsOk());
+  if (!SetFileDirectIo(f->get(), true).ok()) {
+    GTEST_SKIP() << "Direct I/O not supported by filesystem";
+  }
+  tensorstore::internal::FlatCordBuilder buffer(
+      2 * kDirectIoAlignment, 0, std::align_val_t(kDirectIoAlignment));
+  buffer.Append(std::string(buffer.size(), 'x'));
+  EXPECT_THAT(WriteToFile(f->get(), buffer.data(), buffer.size()),
+              IsOkAndHolds(buffer.size()));
+
+  // Unaligned tail.
+  EXPECT_THAT(SetFileDirectIo(f->get(), false), IsOk());
+  EXPECT_THAT(WriteToFile(f->get(), "abc", 3), IsOkAndHolds(3));
+
+  auto r = OpenExistingFileForReading(foo_txt);
+  ASSERT_THAT(r, IsOk());
+  AdviseFileDontNeed(r->get(), 0, 0);
+  std::string contents(buffer.size() + 3, '\0');
+  EXPECT_THAT(ReadFromFile(r->get(), contents.data(), contents.size(), 0),
+              IsOkAndHolds(contents.size()));
+  EXPECT_EQ(std::string(buffer.size(), 'x') + "abc", contents);
+}
+#endif
+
 }  // namespace
@@ -67,11 +67,13 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <limits>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/log/absl_check.h"
@@ -226,6 +228,43 @@ Result<UniqueFileDescriptor> OpenFileForWriting(const std::string& path) {
   return UniqueFileDescriptor(fd);
 }
 
+Result<UniqueFileDescriptor> OpenExistingFileForAppending(
+    const std::string& path) {
+  std::wstring wpath;
+  TENSORSTORE_RETURN_IF_ERROR(ConvertUTF8ToWindowsWide(path, wpath));
+
+  FileDescriptor fd = ::CreateFileW(
+      wpath.c_str(),
+      /*dwDesiredAccess=*/GENERIC_READ | GENERIC_WRITE,
+      /*dwShareMode=*/FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+      /*lpSecurityAttributes=*/nullptr,
+      /*dwCreationDisposition=*/OPEN_EXISTING,
+      /*dwFlagsAndAttributes=*/0,
+      /*hTemplateFile=*/nullptr);
+
+  if (fd == FileDescriptorTraits::Invalid()) {
+    return StatusFromOsError(::GetLastError(),
+                             "Failed to open: ", QuoteString(path));
+  }
+  UniqueFileDescriptor unique_fd(fd);
+  LARGE_INTEGER distance;
+  distance.QuadPart = 0;
+  if (!::SetFilePointerEx(fd, distance, nullptr, FILE_END)) {
+    return StatusFromOsError(::GetLastError(),
+                             "Failed to seek to end of: ", QuoteString(path));
+  }
+  return unique_fd;
+}
+
+Result<UniqueFileDescriptor> OpenAnonymousFileForWriting(
+    const std::string& dir_path) {
+  return UniqueFileDescriptor{};
+}
+
+absl::Status LinkAnonymousFile(FileDescriptor fd, const std::string& path) {
+  return absl::UnimplementedError("Anonymous files are not supported");
+}
+
 Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
                                int64_t offset) {
   auto overlapped = GetOverlappedWithOffset(static_cast<uint64_t>(offset));
@@ -240,6 +279,18 @@ Result<ptrdiff_t> ReadFromFile(FileDescriptor fd, void* buf, size_t count,
   return StatusFromOsError(::GetLastError(), "Failed to read from file");
 }
 
+Result<absl::Cord> MemmapFileReadOnly(FileDescriptor fd, size_t offset,
+                                      size_t size) {
+  return absl::UnimplementedError("Memory-mapped reads are not supported");
+}
+
+absl::Status SetFileDirectIo(FileDescriptor fd, bool enable) {
+  // `FILE_FLAG_NO_BUFFERING` can only be specified when opening a file.
+  return absl::UnimplementedError("Direct I/O is not supported");
+}
+
+void AdviseFileDontNeed(FileDescriptor fd, int64_t offset, int64_t size) {}
+
 Result<ptrdiff_t> WriteToFile(FileDescriptor fd, const void* buf,
                               size_t count) {
   if (count > std::numeric_limits<DWORD>::max()) {
@@ -268,6 +319,28 @@ Result<ptrdiff_t> WriteCordToFile(FileDescriptor fd, absl::Cord value) {
   return value.size();
 }
 
+absl::Status CopyFileData(FileDescriptor source_fd, FileDescriptor target_fd,
+                          int64_t size) {
+  constexpr int64_t kMaxBufferSize = 1024 * 1024;
+  std::vector<char> buffer(std::min(size, kMaxBufferSize));
+  for (int64_t offset = 0; offset < size;) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto n,
+        ReadFromFile(source_fd, buffer.data(),
+                     std::min<int64_t>(size - offset, buffer.size()), offset));
+    if (n == 0) {
+      return absl::UnavailableError("Length changed while copying");
+    }
+    for (ptrdiff_t written = 0; written < n;) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto m, WriteToFile(target_fd, buffer.data() + written, n - written));
+      written += m;
+    }
+    offset += n;
+  }
+  return absl::OkStatus();
+}
+
 absl::Status TruncateFile(FileDescriptor fd) {
   if (::SetEndOfFile(fd)) {
     return absl::OkStatus();
@@ -385,6 +458,8 @@ absl::Status FsyncFile(FileDescriptor fd) {
   return StatusFromOsError(::GetLastError());
 }
 
+absl::Status FsyncFileData(FileDescriptor fd) { return FsyncFile(fd); }
+
 absl::Status GetFileInfo(FileDescriptor fd, FileInfo* info) {
   if (::GetFileInformationByHandle(fd, info)) {
     return absl::OkStatus();
@@ -0,0 +1,472 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+// Maintain include ordering here:
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cerrno>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+// `IORING_OP_RENAMEAT` is an enumerator rather than a macro; require headers
+// from Linux 5.13 or later, which define the macro below.
+#if defined(IORING_FEAT_RSRC_TAGS)
+#define TENSORSTORE_INTERNAL_OS_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifdef TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/os/error_code.h"
+#include "tensorstore/internal/thread/thread.h"
+
+// Most modern unix allow 1024 iovs.
+#if defined(UIO_MAXIOV)
+#define TENSORSTORE_MAXIOV UIO_MAXIOV
+#else
+#define TENSORSTORE_MAXIOV 1024
+#endif
+#endif
+
+namespace tensorstore {
+namespace internal_os {
+
+#ifndef TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+struct IoUring::Impl {};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t queue_depth) {
+  return absl::UnimplementedError("io_uring is not supported on this platform");
+}
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUring::~IoUring() = default;
+
+bool IoUring::IsSupported(IoUringOperation::Opcode opcode) const {
+  return false;
+}
+
+void IoUring::Submit(span<IoUringOperation> operations) {
+  for (auto& op : operations) {
+    std::move(op.callback)(-ENOSYS);
+  }
+}
+
+#else  // TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+using ::tensorstore::internal::StatusFromOsError;
+
+namespace {
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit,
+                                    min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+/// `user_data` of the no-op used to stop the completion thread.
+constexpr uint64_t kStopUserData = 0;
+
+/// State that must outlive the kernel's use of an operation.
+struct PendingOperation {
+  absl::AnyInvocable<void(int64_t result) &&> callback;
+  absl::Cord data;
+  std::vector<iovec> iovecs;
+  std::string path;
+  std::string new_path;
+};
+
+uint8_t GetKernelOpcode(IoUringOperation::Opcode opcode) {
+  switch (opcode) {
+    case IoUringOperation::Opcode::kRead:
+      return IORING_OP_READV;
+    case IoUringOperation::Opcode::kWrite:
+      return IORING_OP_WRITEV;
+    case IoUringOperation::Opcode::kFsync:
+      return IORING_OP_FSYNC;
+    case IoUringOperation::Opcode::kRename:
+      return IORING_OP_RENAMEAT;
+  }
+  ABSL_UNREACHABLE();
+}
+
+/// Moves `op` into a newly allocated `PendingOperation` referenced by the
+/// returned submission queue entry.
+io_uring_sqe PrepareSqe(IoUringOperation& op, bool link) {
+  auto pending = std::make_unique<PendingOperation>();
+  pending->callback = std::move(op.callback);
+  io_uring_sqe sqe;
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = GetKernelOpcode(op.opcode);
+  sqe.fd = op.fd;
+  switch (op.opcode) {
+    case IoUringOperation::Opcode::kRead:
+      pending->iovecs.push_back(iovec{op.buffer, op.size});
+      sqe.addr = reinterpret_cast<uint64_t>(pending->iovecs.data());
+      sqe.len = 1;
+      sqe.off = op.offset;
+      break;
+    case IoUringOperation::Opcode::kWrite:
+      pending->data = std::move(op.data);
+      for (std::string_view chunk : pending->data.Chunks()) {
+        pending->iovecs.push_back(
+            iovec{const_cast<char*>(chunk.data()), chunk.size()});
+        if (pending->iovecs.size() >= TENSORSTORE_MAXIOV) break;
+      }
+      sqe.addr = reinterpret_cast<uint64_t>(pending->iovecs.data());
+      sqe.len = pending->iovecs.size();
+      sqe.off = op.offset;
+      break;
+    case IoUringOperation::Opcode::kFsync:
+      if (op.datasync) sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+      break;
+    case IoUringOperation::Opcode::kRename:
+      pending->path = std::move(op.path);
+      pending->new_path = std::move(op.new_path);
+      sqe.fd = AT_FDCWD;
+      sqe.addr = reinterpret_cast<uint64_t>(pending->path.c_str());
+      sqe.len = static_cast<uint32_t>(AT_FDCWD);
+      sqe.addr2 = reinterpret_cast<uint64_t>(pending->new_path.c_str());
+      break;
+  }
+  if (link) sqe.flags |= IOSQE_IO_LINK;
+  sqe.user_data = reinterpret_cast<uint64_t>(pending.release());
+  return sqe;
+}
+
+}  // namespace
+
+struct IoUring::Impl {
+  int ring_fd = -1;
+
+  // Submission queue, mapped from the kernel.
+  void* sq_ring = MAP_FAILED;
+  size_t sq_ring_size = 0;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+  size_t sqes_size = 0;
+  uint32_t sq_entries;
+
+  // Completion queue, mapped from the kernel.  Only accessed by the
+  // completion thread.
+  void* cq_ring = MAP_FAILED;
+  size_t cq_ring_size = 0;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  io_uring_cqe* cqes;
+  uint32_t cq_entries;
+
+  std::vector<bool> supported;
+
+  absl::Mutex mutex;
+
+  // Groups of entries (never splitting a linked chain) waiting for room in
+  // the kernel queues.
+  std::deque<std::vector<io_uring_sqe>> backlog ABSL_GUARDED_BY(mutex);
+
+  // Number of entries submitted to the kernel whose completions have not been
+  // consumed.  Bounded by `cq_entries` to ensure the completion queue never
+  // overflows.
+  size_t in_flight ABSL_GUARDED_BY(mutex) = 0;
+
+  // Number of operations passed to `Submit` whose callbacks have not returned.
+  size_t outstanding ABSL_GUARDED_BY(mutex) = 0;
+
+  internal::Thread completion_thread;
+
+  ~Impl() {
+    if (sqes != MAP_FAILED) ::munmap(sqes, sqes_size);
+    if (cq_ring != MAP_FAILED && cq_ring != sq_ring) {
+      ::munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring != MAP_FAILED) ::munmap(sq_ring, sq_ring_size);
+    if (ring_fd != -1) ::close(ring_fd);
+  }
+
+  absl::Status Init(uint32_t queue_depth) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CLAMP;
+    ring_fd = IoUringSetup(queue_depth, &params);
+    if (ring_fd < 0) {
+      ring_fd = -1;
+      return StatusFromOsError(errno, "Failed to initialize io_uring");
+    }
+    sq_entries = params.sq_entries;
+    cq_entries = params.cq_entries;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+    sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+      return StatusFromOsError(errno, "Failed to map io_uring");
+    }
+    if (single_mmap) {
+      cq_ring = sq_ring;
+    } else {
+      cq_ring = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (cq_ring == MAP_FAILED) {
+        return StatusFromOsError(errno, "Failed to map io_uring");
+      }
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe*>(
+        ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED) {
+      return StatusFromOsError(errno, "Failed to map io_uring");
+    }
+
+    char* sq = static_cast<char*>(sq_ring);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cq_ring);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    ProbeOpcodes();
+    return absl::OkStatus();
+  }
+
+  void ProbeOpcodes() {
+    constexpr unsigned kMaxOps = 256;
+    supported.assign(kMaxOps, false);
+    std::vector<char> buffer(sizeof(io_uring_probe) +
+                             kMaxOps * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (IoUringRegister(ring_fd, IORING_REGISTER_PROBE, probe, kMaxOps) != 0) {
+      // Probing requires Linux 5.6; the operations available since io_uring
+      // was introduced in 5.1 are always supported.
+      supported[IORING_OP_NOP] = true;
+      supported[IORING_OP_READV] = true;
+      supported[IORING_OP_WRITEV] = true;
+      supported[IORING_OP_FSYNC] = true;
+      return;
+    }
+    for (unsigned i = 0; i < probe->ops_len && i < kMaxOps; ++i) {
+      if (probe->ops[i].flags & IO_URING_OP_SUPPORTED) {
+        supported[probe->ops[i].op] = true;
+      }
+    }
+  }
+
+  /// Copies as many backlogged groups as fit into the submission queue and
+  /// submits them to the kernel.
+  void FlushLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    unsigned to_submit = 0;
+    // The kernel consumes all submitted entries during `io_uring_enter`, so
+    // the submission queue is empty on entry.
+    unsigned tail = *sq_tail;
+    const unsigned mask = *sq_mask;
+    while (!backlog.empty()) {
+      auto& group = backlog.front();
+      if (in_flight + group.size() > cq_entries) break;
+      if (to_submit + group.size() > sq_entries) {
+        __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+        Enter(to_submit);
+        to_submit = 0;
+      }
+      for (const auto& sqe : group) {
+        const unsigned index = tail & mask;
+        sqes[index] = sqe;
+        sq_array[index] = index;
+        ++tail;
+      }
+      to_submit += group.size();
+      in_flight += group.size();
+      backlog.pop_front();
+    }
+    if (to_submit == 0) return;
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    Enter(to_submit);
+  }
+
+  void Enter(unsigned to_submit) {
+    while (to_submit > 0) {
+      int n = IoUringEnter(ring_fd, to_submit, 0, 0);
+      if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+        ABSL_LOG(FATAL) << StatusFromOsError(errno,
+                                             "io_uring_enter failed");
+      }
+      to_submit -= n;
+    }
+  }
+
+  void Submit(span<IoUringOperation> operations) {
+    std::vector<std::vector<io_uring_sqe>> groups(1);
+    for (size_t begin = 0; begin < operations.size();) {
+      // Determine the extent of the linked chain starting at `begin`.
+      size_t end = begin;
+      bool chain_supported = true;
+      do {
+        chain_supported &= supported[GetKernelOpcode(operations[end].opcode)];
+      } while (operations[end++].link && end < operations.size());
+      for (size_t i = begin; i < end; ++i) {
+        auto& op = operations[i];
+        if (!chain_supported) {
+          std::move(op.callback)(
+              supported[GetKernelOpcode(op.opcode)] ? -ECANCELED
+                                                    : -EOPNOTSUPP);
+          continue;
+        }
+        groups.back().push_back(PrepareSqe(op, /*link=*/i + 1 < end));
+      }
+      if (groups.back().size() >= sq_entries / 2) groups.emplace_back();
+      begin = end;
+    }
+    absl::MutexLock lock(&mutex);
+    for (auto& group : groups) {
+      if (group.empty()) continue;
+      // A linked chain must fit in the submission queue.
+      ABSL_CHECK_LE(group.size(), sq_entries);
+      outstanding += group.size();
+      backlog.push_back(std::move(group));
+    }
+    FlushLocked();
+  }
+
+  void RunCompletionThread() {
+    std::vector<std::pair<PendingOperation*, int64_t>> completed;
+    while (true) {
+      if (IoUringEnter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+          errno != EINTR) {
+        ABSL_LOG(FATAL) << StatusFromOsError(errno,
+                                             "io_uring_enter failed");
+      }
+      bool stop = false;
+      unsigned head = *cq_head;
+      const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+      const unsigned mask = *cq_mask;
+      for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & mask];
+        if (cqe.user_data == kStopUserData) {
+          stop = true;
+          continue;
+        }
+        completed.emplace_back(reinterpret_cast<PendingOperation*>(cqe.user_data),
+                               cqe.res);
+      }
+      __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+      if (!completed.empty() || stop) {
+        absl::MutexLock lock(&mutex);
+        in_flight -= completed.size() + stop;
+        FlushLocked();
+      }
+      for (auto& [pending, result] : completed) {
+        std::move(pending->callback)(result);
+        delete pending;
+      }
+      if (!completed.empty()) {
+        absl::MutexLock lock(&mutex);
+        outstanding -= completed.size();
+        completed.clear();
+      }
+      if (stop) return;
+    }
+  }
+
+  void Stop() {
+    {
+      absl::MutexLock lock(&mutex);
+      mutex.Await(absl::Condition(
+          +[](size_t* outstanding) { return *outstanding == 0; },
+          &outstanding));
+      io_uring_sqe sqe;
+      std::memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = IORING_OP_NOP;
+      sqe.user_data = kStopUserData;
+      backlog.push_back({sqe});
+      FlushLocked();
+    }
+    completion_thread.Join();
+  }
+};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t queue_depth) {
+  auto impl = std::make_unique<Impl>();
+  TENSORSTORE_RETURN_IF_ERROR(impl->Init(queue_depth));
+  Impl* impl_ptr = impl.get();
+  impl->completion_thread =
+      internal::Thread({"tensorstore_io_uring"},
+                       [impl_ptr] { impl_ptr->RunCompletionThread(); });
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl)));
+}
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUring::~IoUring() { impl_->Stop(); }
+
+bool IoUring::IsSupported(IoUringOperation::Opcode opcode) const {
+  return impl_->supported[GetKernelOpcode(opcode)];
+}
+
+void IoUring::Submit(span<IoUringOperation> operations) {
+  impl_->Submit(operations);
+}
+
+#endif  // TENSORSTORE_INTERNAL_OS_HAVE_IO_URING
+
+}  // namespace internal_os
+}  // namespace tensorstore
@@ -0,0 +1,135 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_OS_IO_URING_H_
+#define TENSORSTORE_INTERNAL_OS_IO_URING_H_
+
+/// \file Asynchronous file I/O using Linux io_uring.
+///
+/// An `IoUring` owns a submission/completion queue pair shared with the kernel
+/// and a single thread that dispatches completions.  Operations submitted
+/// together are handed to the kernel with a single system call, which allows
+/// many reads and writes to be in flight without a thread blocked on each one.
+///
+/// On platforms other than Linux, `IoUring::Create` returns an error and
+/// callers are expected to fall back to the blocking functions defined in
+/// `file_util.h`.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_os {
+
+/// Single operation submitted to an `IoUring`.
+struct IoUringOperation {
+  enum class Opcode : uint8_t {
+    /// Reads up to `size` bytes at `offset` from `fd` into `buffer`.
+    kRead,
+    /// Writes `data` at `offset` to `fd`.  At most `UIO_MAXIOV` chunks of the
+    /// cord are written by a single operation; the result may indicate a
+    /// short write.
+    kWrite,
+    /// Calls `fsync` on `fd`, or `fdatasync` if `datasync` is `true`.
+    kFsync,
+    /// Renames `path` to `new_path`.
+    kRename,
+  };
+
+  Opcode opcode;
+  FileDescriptor fd = FileDescriptorTraits::Invalid();
+
+  /// Destination buffer for `kRead`.  Must remain valid until the callback is
+  /// invoked.
+  void* buffer = nullptr;
+  size_t size = 0;
+  int64_t offset = 0;
+
+  /// Source data for `kWrite`.
+  absl::Cord data;
+
+  /// Paths for `kRename`.
+  std::string path;
+  std::string new_path;
+
+  /// For `kFsync`, sync only the data and the metadata required to read it.
+  bool datasync = false;
+
+  /// If `true`, the next operation in the same `Submit` call is not started
+  /// until this operation completes successfully.  If this operation fails,
+  /// the remaining operations of the chain complete with `-ECANCELED`.
+  bool link = false;
+
+  /// Invoked from the completion thread with the result of the operation: the
+  /// number of bytes transferred for `kRead` and `kWrite`, `0` for other
+  /// successful operations, or a negated `errno` value on failure.
+  ///
+  /// The callback must not block; any potentially blocking work should be
+  /// handed off to an executor.
+  absl::AnyInvocable<void(int64_t result) &&> callback;
+};
+
+/// Wrapper around a Linux io_uring instance.
+///
+/// This class is thread safe.
+class IoUring {
+ public:
+  /// Creates an io_uring with room for `queue_depth` operations per
+  /// submission.
+  ///
+  /// \error `absl::StatusCode::kUnimplemented` if io_uring is not supported on
+  ///     this platform, or another error if it cannot be initialized (e.g.
+  ///     because it is disabled by a seccomp policy).
+  static Result<std::unique_ptr<IoUring>> Create(uint32_t queue_depth = 256);
+
+  /// Waits for all outstanding operations to complete.
+  ~IoUring();
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  /// Returns `true` if the running kernel supports `opcode`.
+  bool IsSupported(IoUringOperation::Opcode opcode) const;
+
+  /// Submits `operations`, moving out of each element.
+  ///
+  /// Never blocks: if the kernel queues are full, the operations are held
+  /// until enough outstanding operations have completed.  Linked chains are
+  /// always submitted together.
+  ///
+  /// If a chain contains an operation for which `IsSupported` returns
+  /// `false`, that operation completes with `-EOPNOTSUPP` and the other
+  /// operations of the chain with `-ECANCELED`, from within this call.
+  void Submit(span<IoUringOperation> operations);
+
+  struct Impl;
+
+ private:
+  explicit IoUring(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace internal_os
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_OS_IO_URING_H_
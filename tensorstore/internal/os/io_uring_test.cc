@@ -0,0 +1,161 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/os/io_uring.h"
+
+#include <stdint.h>
+
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/synchronization/notification.h"
+#include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/internal/testing/scoped_directory.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::internal_os::IoUring;
+using ::tensorstore::internal_os::IoUringOperation;
+
+std::unique_ptr<IoUring> CreateOrSkip() {
+  auto io_uring = IoUring::Create(8);
+  if (!io_uring.ok()) return nullptr;
+  return std::move(*io_uring);
+}
+
+/// Submits `ops` and waits for all of them to complete, returning the results.
+std::vector<int64_t> SubmitAndWait(IoUring& io_uring,
+                                   std::vector<IoUringOperation> ops) {
+  std::vector<int64_t> results(ops.size());
+  std::vector<absl::Notification> done(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    ops[i].callback = [&, i](int64_t result) {
+      results[i] = result;
+      done[i].Notify();
+    };
+  }
+  io_uring.Submit(ops);
+  for (auto& notification : done) notification.WaitForNotification();
+  return results;
+}
+
+TEST(IoUringTest, WriteFsyncRenameRead) {
+  auto io_uring = CreateOrSkip();
+  if (!io_uring) GTEST_SKIP() << "io_uring not available";
+
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string lock_path = tempdir.path() + "/foo.__lock";
+  std::string path = tempdir.path() + "/foo";
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto fd, tensorstore::internal_os::OpenFileForWriting(lock_path));
+
+  absl::Cord data("hello ");
+  data.Append(std::string(100, 'x'));
+  std::vector<IoUringOperation> ops(3);
+  ops[0].opcode = IoUringOperation::Opcode::kWrite;
+  ops[0].fd = fd.get();
+  ops[0].data = data;
+  ops[0].link = true;
+  ops[1].opcode = IoUringOperation::Opcode::kFsync;
+  ops[1].fd = fd.get();
+  ops[1].datasync = true;
+  ops[1].link = true;
+  ops[2].opcode = IoUringOperation::Opcode::kRename;
+  ops[2].path = lock_path;
+  ops[2].new_path = path;
+  if (!io_uring->IsSupported(IoUringOperation::Opcode::kRename)) {
+    ops.pop_back();
+  }
+  auto results = SubmitAndWait(*io_uring, std::move(ops));
+  EXPECT_EQ(data.size(), results[0]);
+  EXPECT_EQ(0, results[1]);
+  if (results.size() < 3) {
+    TENSORSTORE_ASSERT_OK(
+        tensorstore::internal_os::RenameOpenFile(fd.get(), lock_path, path));
+  } else {
+    EXPECT_EQ(0, results[2]);
+  }
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read_fd, tensorstore::internal_os::OpenExistingFileForReading(path));
+  std::string a(6, '\0');
+  std::string b(4, '\0');
+  std::vector<IoUringOperation> reads(2);
+  reads[0].opcode = IoUringOperation::Opcode::kRead;
+  reads[0].fd = read_fd.get();
+  reads[0].buffer = a.data();
+  reads[0].size = a.size();
+  reads[1].opcode = IoUringOperation::Opcode::kRead;
+  reads[1].fd = read_fd.get();
+  reads[1].buffer = b.data();
+  reads[1].size = b.size();
+  reads[1].offset = 104;
+  results = SubmitAndWait(*io_uring, std::move(reads));
+  EXPECT_THAT(results, ::testing::ElementsAre(6, 2));
+  EXPECT_EQ("hello ", a);
+  EXPECT_EQ("xx", b.substr(0, 2));
+}
+
+TEST(IoUringTest, LinkedChainCancelledAfterFailure) {
+  auto io_uring = CreateOrSkip();
+  if (!io_uring) GTEST_SKIP() << "io_uring not available";
+
+  std::vector<IoUringOperation> ops(2);
+  ops[0].opcode = IoUringOperation::Opcode::kFsync;
+  ops[0].fd = -1;
+  ops[0].link = true;
+  ops[1].opcode = IoUringOperation::Opcode::kFsync;
+  ops[1].fd = -1;
+  auto results = SubmitAndWait(*io_uring, std::move(ops));
+  EXPECT_THAT(results, ::testing::ElementsAre(-EBADF, -ECANCELED));
+}
+
+TEST(IoUringTest, MoreOperationsThanQueueDepth) {
+  auto io_uring = CreateOrSkip();
+  if (!io_uring) GTEST_SKIP() << "io_uring not available";
+
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  std::string path = tempdir.path() + "/foo";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto fd, tensorstore::internal_os::OpenFileForWriting(path));
+  TENSORSTORE_ASSERT_OK(
+      tensorstore::internal_os::WriteToFile(fd.get(), "abcdefgh", 8));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto read_fd, tensorstore::internal_os::OpenExistingFileForReading(path));
+
+  constexpr size_t kNumReads = 100;
+  std::vector<char> buffers(kNumReads);
+  std::vector<IoUringOperation> ops(kNumReads);
+  for (size_t i = 0; i < kNumReads; ++i) {
+    ops[i].opcode = IoUringOperation::Opcode::kRead;
+    ops[i].fd = read_fd.get();
+    ops[i].buffer = &buffers[i];
+    ops[i].size = 1;
+    ops[i].offset = i % 8;
+  }
+  auto results = SubmitAndWait(*io_uring, std::move(ops));
+  for (size_t i = 0; i < kNumReads; ++i) {
+    EXPECT_EQ(1, results[i]);
+    EXPECT_EQ("abcdefgh"[i % 8], buffers[i]);
+  }
+}
+
+}  // namespace
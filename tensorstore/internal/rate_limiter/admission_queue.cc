@@ -20,7 +20,7 @@
 #include <limits>
 
 #include "absl/synchronization/mutex.h"
-#include "tensorstore/internal/container/intrusive_linked_list.h"
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 
 namespace tensorstore {
@@ -29,6 +29,11 @@ namespace internal {
 AdmissionQueue::AdmissionQueue(size_t limit)
     : limit_(limit == 0 ? std::numeric_limits<size_t>::max() : limit) {}
 
+AdmissionQueue::~AdmissionQueue() {
+  absl::MutexLock l(&mutex_);
+  assert(queue_.empty());
+}
+
 void AdmissionQueue::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
   assert(node->next_ == nullptr);
   assert(node->prev_ == nullptr);
@@ -38,12 +43,12 @@ void AdmissionQueue::Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
   {
     absl::MutexLock lock(&mutex_);
     if (in_flight_++ >= limit_) {
-      internal::intrusive_linked_list::InsertBefore(RateLimiterNodeAccessor{},
-                                                    &head_, node);
+      queue_.Push(node);
       return;
     }
   }
 
+  FairQueue::RecordStartedImmediately(node);
   RunStartFunction(node);
 }
 
@@ -54,10 +59,8 @@ void AdmissionQueue::Finish(RateLimiterNode* node) {
   {
     absl::MutexLock lock(&mutex_);
     in_flight_--;
-    next_node = head_.next_;
-    if (next_node == &head_) return;
-    internal::intrusive_linked_list::Remove(RateLimiterNodeAccessor{},
-                                            next_node);
+    next_node = queue_.Pop();
+    if (next_node == nullptr) return;
   }
 
   // Next node gets a chance to run after clearing admission queue state.
@@ -19,6 +19,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 
 namespace tensorstore {
@@ -34,11 +35,15 @@ namespace internal {
 /// be called when an operation starts, and `Finish` must be called when an
 /// operation completes. Operations are enqueued if limit is reached, to be
 /// started once the number of parallel operations are below limit.
+///
+/// Queued nodes are started in the order determined by `FairQueue`: nodes
+/// with a positive `RateLimiterNode::priority_` first, and the remaining nodes
+/// in weighted round-robin order of their `RateLimiterNode::tenant_`.
 class AdmissionQueue : public RateLimiter {
  public:
   /// Construct an AdmissionQueue with `limit` parallelism.
   AdmissionQueue(size_t limit);
-  ~AdmissionQueue() override = default;
+  ~AdmissionQueue() override;
 
   size_t limit() const { return limit_; }
   size_t in_flight() const {
@@ -59,6 +64,8 @@ class AdmissionQueue : public RateLimiter {
  private:
   const size_t limit_;
   size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  FairQueue queue_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace internal
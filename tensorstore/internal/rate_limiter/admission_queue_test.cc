@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "tensorstore/internal/intrusive_ptr.h"
@@ -69,4 +70,32 @@ TEST(AdmissionQueueTest, Basic) {
   EXPECT_EQ(100, done);
 }
 
+TEST(AdmissionQueueTest, Priority) {
+  AdmissionQueue queue(1);
+  std::vector<int> order;
+
+  // The first node occupies the single slot until `first` is released.
+  auto first =
+      MakeIntrusivePtr<Node>(&queue, [&order] { order.push_back(0); });
+  intrusive_ptr_increment(first.get());  // adopted by Node::Start.
+  queue.Admit(first.get(), &Node::Start);
+  EXPECT_EQ(1, queue.in_flight());
+
+  for (int i = 1; i <= 4; ++i) {
+    auto node =
+        MakeIntrusivePtr<Node>(&queue, [&order, i] { order.push_back(i); });
+    node->priority_ = (i % 2 == 0) ? 1 : 0;
+    intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+    queue.Admit(node.get(), &Node::Start);
+  }
+  EXPECT_EQ(5, queue.in_flight());
+  EXPECT_EQ(std::vector<int>({0}), order);
+
+  // Releasing the first node starts the queued nodes one at a time, high
+  // priority nodes first.
+  first.reset();
+  EXPECT_EQ(std::vector<int>({0, 2, 4, 1, 3}), order);
+  EXPECT_EQ(0, queue.in_flight());
+}
+
 }  // namespace
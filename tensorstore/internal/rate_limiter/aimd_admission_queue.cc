@@ -0,0 +1,151 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+
+namespace tensorstore {
+namespace internal {
+
+AimdAdmissionQueue::AimdAdmissionQueue(Options options)
+    : options_(std::move(options)) {
+  assert(options_.min_limit > 0);
+  assert(options_.min_limit <= options_.max_limit);
+  assert(options_.decrease_factor > 0 && options_.decrease_factor < 1);
+  absl::MutexLock l(&mutex_);
+  limit_ = std::clamp<double>(static_cast<double>(options_.initial_limit),
+                              options_.min_limit, options_.max_limit);
+}
+
+AimdAdmissionQueue::~AimdAdmissionQueue() {
+  absl::MutexLock l(&mutex_);
+  assert(queue_.empty());
+}
+
+size_t AimdAdmissionQueue::limit() const {
+  absl::MutexLock l(&mutex_);
+  return static_cast<size_t>(limit_);
+}
+
+void AimdAdmissionQueue::SetLimitLocked(double limit) {
+  limit = std::clamp<double>(limit, options_.min_limit, options_.max_limit);
+  bool changed =
+      static_cast<size_t>(limit) != static_cast<size_t>(limit_);
+  limit_ = limit;
+  if (changed && options_.on_limit_changed) {
+    options_.on_limit_changed(static_cast<size_t>(limit_));
+  }
+}
+
+void AimdAdmissionQueue::Admit(RateLimiterNode* node,
+                               RateLimiterNode::StartFn fn) {
+  assert(node->next_ == nullptr);
+  assert(node->prev_ == nullptr);
+  assert(node->start_fn_ == nullptr);
+  node->start_fn_ = fn;
+
+  {
+    absl::MutexLock lock(&mutex_);
+    if (in_flight_ >= static_cast<size_t>(limit_)) {
+      queue_.Push(node);
+      return;
+    }
+    ++in_flight_;
+  }
+
+  FairQueue::RecordStartedImmediately(node);
+  RunStartFunction(node);
+}
+
+void AimdAdmissionQueue::Finish(RateLimiterNode* node) {
+  assert(node->next_ == nullptr);
+
+  // An increase of the limit may allow more than one queued node to start.
+  absl::InlinedVector<RateLimiterNode*, 2> next_nodes;
+  {
+    absl::MutexLock lock(&mutex_);
+    assert(in_flight_ > 0);
+    in_flight_--;
+    if (finish_before_decrease_ > 0) {
+      // Operations started before the last decrease complete without
+      // increasing the limit.
+      finish_before_decrease_--;
+    } else {
+      SetLimitLocked(limit_ + 1.0 / limit_);
+    }
+    while (in_flight_ < static_cast<size_t>(limit_)) {
+      RateLimiterNode* next_node = queue_.Pop();
+      if (next_node == nullptr) break;
+      ++in_flight_;
+      next_nodes.push_back(next_node);
+    }
+  }
+
+  // Next nodes get a chance to run after clearing admission queue state.
+  for (RateLimiterNode* next_node : next_nodes) {
+    RunStartFunction(next_node);
+  }
+}
+
+void AimdAdmissionQueue::OnThrottled() {
+  absl::MutexLock lock(&mutex_);
+  // Throttling reported while the operations which were in flight at the
+  // last decrease are still completing reflects the previous limit.
+  if (finish_before_decrease_ > 0) return;
+  SetLimitLocked(std::floor(limit_ * options_.decrease_factor));
+  finish_before_decrease_ = in_flight_;
+}
+
+AimdAdmissionQueueMap::AimdAdmissionQueueMap(
+    AimdAdmissionQueue::Options options,
+    std::function<void(std::string_view key, size_t limit)> on_limit_changed)
+    : options_(std::move(options)),
+      on_limit_changed_(std::move(on_limit_changed)) {}
+
+std::shared_ptr<AimdAdmissionQueue> AimdAdmissionQueueMap::Get(
+    std::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto& queue = queues_[key];
+  if (!queue) {
+    auto options = options_;
+    if (on_limit_changed_) {
+      options.on_limit_changed = [key = std::string(key),
+                                  callback = on_limit_changed_](size_t limit) {
+        callback(key, limit);
+      };
+    }
+    queue = std::make_shared<AimdAdmissionQueue>(std::move(options));
+    if (on_limit_changed_) on_limit_changed_(key, queue->limit());
+  }
+  return queue;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,132 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_RATE_LIMITER_AIMD_ADMISSION_QUEUE_H_
+#define TENSORSTORE_INTERNAL_RATE_LIMITER_AIMD_ADMISSION_QUEUE_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// AimdAdmissionQueue implements a `RateLimiter` which, like `AdmissionQueue`,
+/// restricts the number of operations in flight, but adjusts the limit using
+/// additive-increase/multiplicative-decrease (AIMD).
+///
+/// Each call to `Finish` increases the limit by `1 / limit`, so that the limit
+/// grows by about one for every `limit` operations which complete.  Each call
+/// to `OnThrottled`, which callers make when the service responds that it is
+/// overloaded (e.g. with HTTP 429 or 503), multiplies the limit by
+/// `decrease_factor`.  Throttling reported by operations which were already in
+/// flight when the limit was decreased does not decrease it again.
+///
+/// Queued nodes are started in the order determined by `FairQueue`: nodes
+/// with a positive `RateLimiterNode::priority_` first, and the remaining nodes
+/// in weighted round-robin order of their `RateLimiterNode::tenant_`.
+class AimdAdmissionQueue : public RateLimiter {
+ public:
+  struct Options {
+    size_t initial_limit = 32;
+    size_t min_limit = 1;
+    size_t max_limit = 1024;
+
+    /// Factor by which the limit is multiplied by `OnThrottled`.
+    double decrease_factor = 0.5;
+
+    /// Invoked with the new limit whenever its integer value changes, for
+    /// example to update a metric.  Must not call back into the queue.
+    std::function<void(size_t limit)> on_limit_changed;
+  };
+
+  explicit AimdAdmissionQueue(Options options);
+  ~AimdAdmissionQueue() override;
+
+  /// Returns the current limit on the number of operations in flight.
+  size_t limit() const;
+
+  /// Returns the number of admitted operations which have started and not yet
+  /// finished.
+  size_t in_flight() const {
+    absl::MutexLock l(&mutex_);
+    return in_flight_;
+  }
+
+  /// Admit a task node to the queue.  The start function, `fn(node)`, is
+  /// invoked immediately if fewer than `limit()` operations are in flight,
+  /// and otherwise once enough operations have finished.
+  void Admit(RateLimiterNode* node, RateLimiterNode::StartFn fn) override;
+
+  /// Mark a task node for completion, increasing the limit.
+  void Finish(RateLimiterNode* node) override;
+
+  /// Indicates that an operation was throttled by the service.
+  void OnThrottled();
+
+ private:
+  void SetLimitLocked(double limit) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const Options options_;
+  double limit_ ABSL_GUARDED_BY(mutex_);
+  size_t in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Number of operations, in flight at the time of the last decrease, which
+  // have yet to finish.
+  size_t finish_before_decrease_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  FairQueue queue_ ABSL_GUARDED_BY(mutex_);
+};
+
+/// Maintains a separate `AimdAdmissionQueue` for each key, such as a bucket
+/// name, so that throttling of requests to one bucket does not limit the
+/// requests to other buckets.
+class AimdAdmissionQueueMap {
+ public:
+  /// Constructs a map whose queues are created with `options`.
+  ///
+  /// If specified, `on_limit_changed` is invoked with the key and the new
+  /// limit of a queue whenever its limit changes, and when it is created.
+  AimdAdmissionQueueMap(
+      AimdAdmissionQueue::Options options,
+      std::function<void(std::string_view key, size_t limit)>
+          on_limit_changed = {});
+
+  /// Returns the queue for `key`, creating it if necessary.
+  std::shared_ptr<AimdAdmissionQueue> Get(std::string_view key);
+
+ private:
+  const AimdAdmissionQueue::Options options_;
+  const std::function<void(std::string_view key, size_t limit)>
+      on_limit_changed_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::shared_ptr<AimdAdmissionQueue>>
+      queues_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_RATE_LIMITER_AIMD_ADMISSION_QUEUE_H_
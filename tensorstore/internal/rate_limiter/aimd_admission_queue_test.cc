@@ -0,0 +1,223 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+#include "tensorstore/util/executor.h"
+
+namespace {
+
+using ::tensorstore::ExecutorTask;
+using ::tensorstore::internal::adopt_object_ref;
+using ::tensorstore::internal::AimdAdmissionQueue;
+using ::tensorstore::internal::AimdAdmissionQueueMap;
+using ::tensorstore::internal::AtomicReferenceCount;
+using ::tensorstore::internal::IntrusivePtr;
+using ::tensorstore::internal::MakeIntrusivePtr;
+using ::tensorstore::internal::RateLimiterNode;
+
+struct Node : public RateLimiterNode, public AtomicReferenceCount<Node> {
+  AimdAdmissionQueue* queue_;
+  ExecutorTask task_;
+
+  Node(AimdAdmissionQueue* queue, ExecutorTask task)
+      : queue_(queue), task_(std::move(task)) {}
+
+  ~Node() { queue_->Finish(this); }
+
+  static void Start(void* task) {
+    IntrusivePtr<Node> self(reinterpret_cast<Node*>(task), adopt_object_ref);
+    std::move(self->task_)();
+  }
+};
+
+/// Admits a node which remains in flight until the returned pointer, and the
+/// reference held by the started task, are released.
+IntrusivePtr<Node> AdmitHeld(AimdAdmissionQueue& queue,
+                             std::vector<IntrusivePtr<Node>>& started) {
+  auto node = MakeIntrusivePtr<Node>(&queue, ExecutorTask{});
+  node->task_ = [&started, n = node.get()] { started.emplace_back(n); };
+  intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+  queue.Admit(node.get(), &Node::Start);
+  return node;
+}
+
+AimdAdmissionQueue::Options MakeOptions(size_t initial_limit) {
+  AimdAdmissionQueue::Options options;
+  options.initial_limit = initial_limit;
+  options.min_limit = 1;
+  options.max_limit = 8;
+  return options;
+}
+
+TEST(AimdAdmissionQueueTest, Basic) {
+  AimdAdmissionQueue queue(MakeOptions(1));
+  size_t done = 0;
+
+  EXPECT_EQ(1, queue.limit());
+  EXPECT_EQ(0, queue.in_flight());
+  for (int i = 0; i < 100; i++) {
+    auto node = MakeIntrusivePtr<Node>(&queue, [&done] { done++; });
+    intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+    queue.Admit(node.get(), &Node::Start);
+  }
+  EXPECT_EQ(100, done);
+  EXPECT_EQ(0, queue.in_flight());
+
+  // 100 completions raise the limit to the maximum of 8.
+  EXPECT_EQ(8, queue.limit());
+}
+
+TEST(AimdAdmissionQueueTest, AdditiveIncrease) {
+  AimdAdmissionQueue queue(MakeOptions(1));
+  std::vector<IntrusivePtr<Node>> started;
+  std::vector<IntrusivePtr<Node>> nodes;
+  for (int i = 0; i < 4; ++i) nodes.push_back(AdmitHeld(queue, started));
+  EXPECT_EQ(1, started.size());
+  EXPECT_EQ(1, queue.in_flight());
+
+  // The first completion increases the limit from 1 to 2, which starts two of
+  // the queued nodes.
+  nodes[0].reset();
+  started[0].reset();
+  EXPECT_EQ(2, queue.limit());
+  EXPECT_EQ(3, started.size());
+  EXPECT_EQ(2, queue.in_flight());
+
+  // The next two completions increase the limit from 2 to 2.9.
+  nodes[1].reset();
+  started[1].reset();
+  EXPECT_EQ(4, started.size());
+  nodes[2].reset();
+  started[2].reset();
+  EXPECT_EQ(2, queue.limit());
+  EXPECT_EQ(1, queue.in_flight());
+
+  nodes.clear();
+  started.clear();
+  EXPECT_EQ(0, queue.in_flight());
+  EXPECT_EQ(3, queue.limit());
+}
+
+TEST(AimdAdmissionQueueTest, MultiplicativeDecrease) {
+  std::vector<size_t> limits;
+  auto options = MakeOptions(8);
+  options.on_limit_changed = [&](size_t limit) { limits.push_back(limit); };
+  AimdAdmissionQueue queue(std::move(options));
+
+  std::vector<IntrusivePtr<Node>> started;
+  std::vector<IntrusivePtr<Node>> nodes;
+  for (int i = 0; i < 10; ++i) nodes.push_back(AdmitHeld(queue, started));
+  EXPECT_EQ(8, started.size());
+
+  // Only the first of several throttled responses from the operations in
+  // flight decreases the limit.
+  queue.OnThrottled();
+  queue.OnThrottled();
+  EXPECT_EQ(4, queue.limit());
+  EXPECT_THAT(limits, ::testing::ElementsAre(4));
+
+  // No queued nodes start until fewer than 4 operations are in flight, and
+  // the operations started before the decrease do not increase the limit.
+  for (int i = 0; i < 4; ++i) {
+    nodes[i].reset();
+    started[i].reset();
+  }
+  EXPECT_EQ(8, started.size());
+  nodes[4].reset();
+  started[4].reset();
+  EXPECT_EQ(9, started.size());
+  nodes[5].reset();
+  started[5].reset();
+  EXPECT_EQ(10, started.size());
+  EXPECT_EQ(4, queue.limit());
+
+  // Once the operations in flight at the time of the decrease have finished,
+  // another throttled response decreases the limit again.
+  nodes[6].reset();
+  started[6].reset();
+  nodes[7].reset();
+  started[7].reset();
+  queue.OnThrottled();
+  EXPECT_EQ(2, queue.limit());
+  queue.OnThrottled();
+  EXPECT_EQ(2, queue.limit());
+  EXPECT_THAT(limits, ::testing::ElementsAre(4, 2));
+
+  nodes.clear();
+  started.clear();
+  EXPECT_EQ(0, queue.in_flight());
+  queue.OnThrottled();
+  queue.OnThrottled();
+  EXPECT_EQ(1, queue.limit());
+}
+
+TEST(AimdAdmissionQueueTest, Priority) {
+  // A fixed limit of 1 starts the queued nodes one at a time.
+  auto options = MakeOptions(1);
+  options.max_limit = 1;
+  AimdAdmissionQueue queue(std::move(options));
+  std::vector<int> order;
+
+  auto first =
+      MakeIntrusivePtr<Node>(&queue, [&order] { order.push_back(0); });
+  intrusive_ptr_increment(first.get());  // adopted by Node::Start.
+  queue.Admit(first.get(), &Node::Start);
+
+  for (int i = 1; i <= 4; ++i) {
+    auto node =
+        MakeIntrusivePtr<Node>(&queue, [&order, i] { order.push_back(i); });
+    node->priority_ = (i % 2 == 0) ? 1 : 0;
+    intrusive_ptr_increment(node.get());  // adopted by Node::Start.
+    queue.Admit(node.get(), &Node::Start);
+  }
+  EXPECT_EQ(std::vector<int>({0}), order);
+
+  first.reset();
+  EXPECT_EQ(std::vector<int>({0, 2, 4, 1, 3}), order);
+  EXPECT_EQ(0, queue.in_flight());
+}
+
+TEST(AimdAdmissionQueueMapTest, SeparateQueuesPerKey) {
+  std::vector<std::pair<std::string, size_t>> limits;
+  AimdAdmissionQueueMap map(MakeOptions(4),
+                            [&](std::string_view key, size_t limit) {
+                              limits.emplace_back(std::string(key), limit);
+                            });
+  auto a = map.Get("a");
+  auto b = map.Get("b");
+  EXPECT_EQ(a, map.Get("a"));
+  EXPECT_NE(a, b);
+
+  a->OnThrottled();
+  EXPECT_EQ(2, a->limit());
+  EXPECT_EQ(4, b->limit());
+  EXPECT_THAT(limits, ::testing::ElementsAre(::testing::Pair("a", 4),
+                                             ::testing::Pair("b", 4),
+                                             ::testing::Pair("a", 2)));
+}
+
+}  // namespace
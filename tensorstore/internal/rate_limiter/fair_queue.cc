@@ -0,0 +1,116 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/container/intrusive_linked_list.h"
+#include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+
+using ::tensorstore::internal_metrics::MetricMetadata;
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+namespace ll = internal::intrusive_linked_list;
+
+auto& tenant_queue_delay_ms =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer,
+                                std::string>::
+        New("/tensorstore/rate_limiter/tenant/queue_delay_ms", "tenant",
+            MetricMetadata("Time operations spent queued by an admission "
+                           "queue before starting (ms), by tenant"));
+
+void RecordQueueDelay(const RateLimiterNode* node) {
+  if (!node->tenant_) return;
+  tenant_queue_delay_ms.Observe(
+      absl::ToDoubleMilliseconds(absl::Now() - node->queued_time_),
+      node->tenant_->name);
+}
+
+}  // namespace
+
+FairQueue::FairQueue() {
+  ll::Initialize(RateLimiterNodeAccessor{}, &priority_head_);
+}
+
+FairQueue::~FairQueue() {
+  assert(size_ == 0);
+  assert(active_.empty());
+}
+
+void FairQueue::RecordStartedImmediately(const RateLimiterNode* node) {
+  if (!node->tenant_) return;
+  tenant_queue_delay_ms.Observe(0, node->tenant_->name);
+}
+
+void FairQueue::Push(RateLimiterNode* node) {
+  ++size_;
+  if (node->tenant_) node->queued_time_ = absl::Now();
+  if (node->priority_ > 0) {
+    ll::InsertBefore(RateLimiterNodeAccessor{}, &priority_head_, node);
+    return;
+  }
+  auto [it, inserted] = tenants_.try_emplace(node->tenant_);
+  TenantQueue& queue = it->second;
+  if (inserted) {
+    ll::Initialize(RateLimiterNodeAccessor{}, &queue.head);
+    queue.tenant = node->tenant_;
+    queue.weight =
+        node->tenant_ ? std::max<uint32_t>(1, node->tenant_->weight) : 1;
+    active_.push_back(&queue);
+  }
+  ll::InsertBefore(RateLimiterNodeAccessor{}, &queue.head, node);
+}
+
+RateLimiterNode* FairQueue::Pop() {
+  if (size_ == 0) return nullptr;
+  --size_;
+  RateLimiterNode* node = priority_head_.next_;
+  if (node != &priority_head_) {
+    ll::Remove(RateLimiterNodeAccessor{}, node);
+    RecordQueueDelay(node);
+    return node;
+  }
+  assert(!active_.empty());
+  TenantQueue* queue = active_.front();
+  node = queue->head.next_;
+  assert(node != &queue->head);
+  ll::Remove(RateLimiterNodeAccessor{}, node);
+  if (queue->head.next_ == &queue->head) {
+    // The tenant has no more queued nodes.
+    active_.pop_front();
+    tenants_.erase(queue->tenant);
+  } else if (++queue->served >= queue->weight) {
+    // End of the turn of the tenant.
+    queue->served = 0;
+    active_.pop_front();
+    active_.push_back(queue);
+  }
+  RecordQueueDelay(node);
+  return node;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
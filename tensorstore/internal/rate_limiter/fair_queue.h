@@ -0,0 +1,85 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_RATE_LIMITER_FAIR_QUEUE_H_
+#define TENSORSTORE_INTERNAL_RATE_LIMITER_FAIR_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+
+#include "absl/container/node_hash_map.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Queue of pending `RateLimiterNode`s shared between the tenants of the
+/// nodes, used by the admission queues.
+///
+/// Nodes with a positive `RateLimiterNode::priority_` are dequeued first, in
+/// FIFO order.  The remaining nodes are queued separately for each
+/// `RateLimiterNode::tenant_`, and the tenants with queued nodes are served in
+/// weighted round-robin order: each turn of a tenant dequeues up to `weight`
+/// of its nodes, in FIFO order.  With a single tenant, nodes are therefore
+/// dequeued in FIFO order.
+///
+/// For nodes with a tenant, the time spent queued is recorded in the
+/// `/tensorstore/rate_limiter/tenant/queue_delay_ms` metric.
+///
+/// \threadsafety Not thread safe; the rate limiter must serialize access.
+class FairQueue {
+ public:
+  FairQueue();
+  ~FairQueue();
+
+  FairQueue(const FairQueue&) = delete;
+  FairQueue& operator=(const FairQueue&) = delete;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  /// Adds `node` to the queue.
+  void Push(RateLimiterNode* node);
+
+  /// Removes and returns the next node, or returns `nullptr` if the queue is
+  /// empty.
+  RateLimiterNode* Pop();
+
+  /// Records, for the metrics, that `node` started without being queued.
+  static void RecordStartedImmediately(const RateLimiterNode* node);
+
+ private:
+  struct TenantQueue {
+    RateLimiterNode head;
+    const RateLimiterTenant* tenant;
+    uint32_t weight;
+    // Number of nodes dequeued in the current turn of the tenant.
+    uint32_t served = 0;
+  };
+
+  size_t size_ = 0;
+  RateLimiterNode priority_head_;
+  absl::node_hash_map<const RateLimiterTenant*, TenantQueue> tenants_;
+
+  // Tenants with queued nodes, in the order in which they are served.  The
+  // front tenant is currently being served.
+  std::deque<TenantQueue*> active_;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_RATE_LIMITER_FAIR_QUEUE_H_
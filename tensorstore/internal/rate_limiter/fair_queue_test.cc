@@ -0,0 +1,105 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/rate_limiter/fair_queue.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+
+namespace {
+
+using ::tensorstore::internal::FairQueue;
+using ::tensorstore::internal::RateLimiterNode;
+using ::tensorstore::internal::RateLimiterTenant;
+
+struct Node : public RateLimiterNode {
+  int id;
+};
+
+// Pops all nodes from `queue`, returning their ids.
+std::vector<int> PopAll(FairQueue& queue) {
+  std::vector<int> ids;
+  while (auto* node = queue.Pop()) {
+    node->next_ = nullptr;
+    node->prev_ = nullptr;
+    ids.push_back(static_cast<Node*>(node)->id);
+  }
+  return ids;
+}
+
+TEST(FairQueueTest, SingleTenantFifo) {
+  FairQueue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(nullptr, queue.Pop());
+  std::vector<Node> nodes(5);
+  for (int i = 0; i < 5; ++i) {
+    nodes[i].id = i;
+    queue.Push(&nodes[i]);
+  }
+  EXPECT_EQ(5, queue.size());
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), PopAll(queue));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(FairQueueTest, PriorityFirst) {
+  FairQueue queue;
+  RateLimiterTenant tenant{"a"};
+  std::vector<Node> nodes(4);
+  for (int i = 0; i < 4; ++i) {
+    nodes[i].id = i;
+    nodes[i].priority_ = (i % 2 == 1) ? 1 : 0;
+    nodes[i].tenant_ = (i < 2) ? &tenant : nullptr;
+    queue.Push(&nodes[i]);
+  }
+  EXPECT_EQ(std::vector<int>({1, 3, 0, 2}), PopAll(queue));
+}
+
+TEST(FairQueueTest, WeightedRoundRobin) {
+  FairQueue queue;
+  RateLimiterTenant heavy{"heavy", 2};
+  RateLimiterTenant light{"light", 1};
+  // The heavy tenant queues its nodes before the light tenant.
+  std::vector<Node> nodes(9);
+  for (int i = 0; i < 9; ++i) {
+    nodes[i].id = i;
+    nodes[i].tenant_ = (i < 6) ? &heavy : &light;
+    queue.Push(&nodes[i]);
+  }
+  EXPECT_EQ(std::vector<int>({0, 1, 6, 2, 3, 7, 4, 5, 8}), PopAll(queue));
+}
+
+TEST(FairQueueTest, TenantRequeued) {
+  FairQueue queue;
+  RateLimiterTenant a{"a"};
+  RateLimiterTenant b{"b"};
+  std::vector<Node> nodes(4);
+  for (int i = 0; i < 4; ++i) nodes[i].id = i;
+  nodes[0].tenant_ = &a;
+  nodes[1].tenant_ = &b;
+  queue.Push(&nodes[0]);
+  queue.Push(&nodes[1]);
+  EXPECT_EQ(std::vector<int>({0, 1}), PopAll(queue));
+
+  // After all of its nodes are dequeued, a tenant is served after the
+  // tenants which are already queued.
+  nodes[2].tenant_ = &b;
+  nodes[3].tenant_ = &a;
+  queue.Push(&nodes[2]);
+  queue.Push(&nodes[3]);
+  EXPECT_EQ(std::vector<int>({2, 3}), PopAll(queue));
+}
+
+}  // namespace
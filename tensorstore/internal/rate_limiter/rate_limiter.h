@@ -15,13 +15,32 @@
 #ifndef TENSORSTORE_INTERNAL_RATE_LIMITER_RATE_LIMITER_H_
 #define TENSORSTORE_INTERNAL_RATE_LIMITER_RATE_LIMITER_H_
 
+#include <stdint.h>
+
+#include <string>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/container/intrusive_linked_list.h"
 
 namespace tensorstore {
 namespace internal {
 
+// Identifies the tenant on whose behalf an operation is performed.
+//
+// Rate limiters which support fair queuing start the queued nodes of
+// different tenants in proportion to their `weight`, so that the operations
+// of one tenant cannot delay those of other tenants indefinitely.
+struct RateLimiterTenant {
+  // Name of the tenant, used as the metric field.
+  std::string name;
+
+  // Number of queued nodes of the tenant started in each round, relative to
+  // other tenants.  Must be at least 1.
+  uint32_t weight = 1;
+};
+
 // RateLimiter is an interface which supports rate-limiting for an operation.
 // Pending operations use the `RateLimiterNode` base class, and are managed
 // via `RateLimiter::Admit` and `RateLimiter::Finish` calls.
@@ -36,6 +55,17 @@ struct RateLimiterNode {
   RateLimiterNode* next_ = nullptr;
   RateLimiterNode* prev_ = nullptr;
   StartFn start_fn_ = nullptr;
+
+  // Rate limiters which support prioritization start pending nodes with a
+  // positive priority before other pending nodes.
+  int priority_ = 0;
+
+  // Tenant of the node, or `nullptr` for the default tenant.  Must remain
+  // valid until the node is started.
+  const RateLimiterTenant* tenant_ = nullptr;
+
+  // Time at which the node was queued, if it has a tenant.
+  absl::Time queued_time_;
 };
 
 using RateLimiterNodeAccessor = internal::intrusive_linked_list::MemberAccessor<
@@ -0,0 +1,73 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/request_hedger.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorstore {
+namespace internal {
+
+RequestHedger::RequestHedger(const Options& options) : options_(options) {
+  latencies_.reserve(kMaxSamples);
+}
+
+absl::Duration RequestHedger::StartRequest() {
+  absl::MutexLock lock(&mutex_);
+  budget_ = std::min(kMaxBurst, budget_ + options_.max_fraction);
+  return delay_;
+}
+
+bool RequestHedger::TryStartHedge() {
+  absl::MutexLock lock(&mutex_);
+  if (budget_ < 1) return false;
+  budget_ -= 1;
+  return true;
+}
+
+void RequestHedger::RecordLatency(absl::Duration latency) {
+  absl::MutexLock lock(&mutex_);
+  if (latencies_.size() < kMaxSamples) {
+    latencies_.push_back(latency);
+  } else {
+    latencies_[next_sample_] = latency;
+    next_sample_ = (next_sample_ + 1) % kMaxSamples;
+  }
+  // Recomputing the percentile is linear in the number of samples, so it is
+  // only done periodically.
+  if (latencies_.size() >= kMinSamples &&
+      (delay_ == absl::InfiniteDuration() ||
+       ++samples_since_update_ >= kMinSamples)) {
+    UpdateDelay();
+  }
+}
+
+void RequestHedger::UpdateDelay() {
+  samples_since_update_ = 0;
+  std::vector<absl::Duration> sorted = latencies_;
+  auto nth = sorted.begin() +
+             static_cast<size_t>(options_.latency_percentile *
+                                 static_cast<double>(sorted.size() - 1));
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  delay_ = std::max(options_.min_delay, *nth);
+}
+
+}  // namespace internal
+}  // namespace tensorstore
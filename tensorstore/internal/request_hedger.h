@@ -0,0 +1,93 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_REQUEST_HEDGER_H_
+#define TENSORSTORE_INTERNAL_REQUEST_HEDGER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Decides when to issue hedged requests, which are duplicates of an
+/// outstanding request issued in case the original request is slow to
+/// complete.
+///
+/// The hedging delay is the specified percentile of recently recorded
+/// latencies, and the number of hedged requests is limited by a budget that
+/// accrues a fraction of a hedged request for each request started.
+///
+/// This class is thread safe.
+class RequestHedger {
+ public:
+  struct Options {
+    /// Requests that have not completed within this percentile of recent
+    /// latencies, in the range `(0, 1)`, are hedged.
+    double latency_percentile = 0.95;
+
+    /// Minimum delay before a request is hedged.
+    absl::Duration min_delay = absl::Milliseconds(10);
+
+    /// Maximum fraction of requests that are hedged.
+    double max_fraction = 0.05;
+  };
+
+  /// Number of most recent latencies from which the delay is computed.
+  constexpr static size_t kMaxSamples = 256;
+
+  /// Number of latencies that must be recorded before any request is hedged.
+  constexpr static size_t kMinSamples = 32;
+
+  /// Maximum number of hedged requests that may be issued in a burst.
+  constexpr static double kMaxBurst = 10;
+
+  explicit RequestHedger(const Options& options);
+
+  /// Called when a request is started.
+  ///
+  /// Returns the delay after which the request should be hedged, or
+  /// `absl::InfiniteDuration()` if too few latencies have been recorded.
+  absl::Duration StartRequest();
+
+  /// Called when the hedging delay of a request expires before the request
+  /// completes.
+  ///
+  /// Returns `true`, consuming budget, if a hedged request should be issued.
+  bool TryStartHedge();
+
+  /// Records the latency of a successful request.
+  void RecordLatency(absl::Duration latency);
+
+ private:
+  void UpdateDelay() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  Options options_;
+  absl::Mutex mutex_;
+  std::vector<absl::Duration> latencies_ ABSL_GUARDED_BY(mutex_);
+  size_t next_sample_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t samples_since_update_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Duration delay_ ABSL_GUARDED_BY(mutex_) = absl::InfiniteDuration();
+  double budget_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_REQUEST_HEDGER_H_
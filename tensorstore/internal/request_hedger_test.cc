@@ -0,0 +1,94 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/request_hedger.h"
+
+#include <gtest/gtest.h>
+#include "absl/time/time.h"
+
+namespace {
+
+using ::tensorstore::internal::RequestHedger;
+
+TEST(RequestHedgerTest, NoDelayUntilMinSamples) {
+  RequestHedger hedger({});
+  for (size_t i = 0; i + 1 < RequestHedger::kMinSamples; ++i) {
+    EXPECT_EQ(absl::InfiniteDuration(), hedger.StartRequest());
+    hedger.RecordLatency(absl::Milliseconds(100));
+  }
+  EXPECT_EQ(absl::InfiniteDuration(), hedger.StartRequest());
+  hedger.RecordLatency(absl::Milliseconds(100));
+  EXPECT_EQ(absl::Milliseconds(100), hedger.StartRequest());
+}
+
+TEST(RequestHedgerTest, Percentile) {
+  RequestHedger::Options options;
+  options.latency_percentile = 0.9;
+  options.min_delay = absl::ZeroDuration();
+  RequestHedger hedger(options);
+  for (int i = 0; i < 100; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(100 - i));
+  }
+  EXPECT_EQ(absl::Milliseconds(90), hedger.StartRequest());
+}
+
+TEST(RequestHedgerTest, MinDelay) {
+  RequestHedger::Options options;
+  options.min_delay = absl::Milliseconds(50);
+  RequestHedger hedger(options);
+  for (size_t i = 0; i < RequestHedger::kMinSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(absl::Milliseconds(50), hedger.StartRequest());
+}
+
+TEST(RequestHedgerTest, RecentSamples) {
+  RequestHedger::Options options;
+  options.min_delay = absl::ZeroDuration();
+  RequestHedger hedger(options);
+  for (size_t i = 0; i < RequestHedger::kMaxSamples; ++i) {
+    hedger.RecordLatency(absl::Seconds(1));
+  }
+  EXPECT_EQ(absl::Seconds(1), hedger.StartRequest());
+  for (size_t i = 0; i < RequestHedger::kMaxSamples; ++i) {
+    hedger.RecordLatency(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(absl::Milliseconds(1), hedger.StartRequest());
+}
+
+TEST(RequestHedgerTest, Budget) {
+  RequestHedger::Options options;
+  options.max_fraction = 0.25;
+  RequestHedger hedger(options);
+  int hedges = 0;
+  for (int i = 0; i < 100; ++i) {
+    hedger.StartRequest();
+    if (hedger.TryStartHedge()) ++hedges;
+  }
+  EXPECT_EQ(25, hedges);
+}
+
+TEST(RequestHedgerTest, BudgetBurst) {
+  RequestHedger::Options options;
+  options.max_fraction = 1;
+  RequestHedger hedger(options);
+  for (int i = 0; i < 100; ++i) {
+    hedger.StartRequest();
+  }
+  int hedges = 0;
+  while (hedger.TryStartHedge()) ++hedges;
+  EXPECT_EQ(RequestHedger::kMaxBurst, hedges);
+}
+
+}  // namespace
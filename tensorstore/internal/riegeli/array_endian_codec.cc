@@ -22,6 +22,7 @@
 #include <string_view>
 #include <utility>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "riegeli/base/chain.h"
@@ -226,6 +227,39 @@ Result<SharedArray<const void>> DecodeArrayEndian(
   return decoded;
 }
 
+Result<SharedArray<const void>> DecodeArrayEndian(
+    absl::FunctionRef<absl::Status(span<char> encoded)> decode, DataType dtype,
+    span<const Index> decoded_shape, endian encoded_endian,
+    ContiguousLayoutOrder order) {
+  const auto& functions =
+      kUnalignedDataTypeFunctions[static_cast<size_t>(dtype.id())];
+  assert(functions.copy != nullptr);  // fail on non-trivial types
+
+  auto decoded =
+      tensorstore::AllocateArray(decoded_shape, order, default_init, dtype);
+  const Index num_elements = decoded.num_elements();
+  const size_t expected_length = dtype.size() * num_elements;
+  TENSORSTORE_RETURN_IF_ERROR(
+      decode(span<char>(static_cast<char*>(decoded.data()), expected_length)));
+
+  // The allocated array is contiguous and suitably aligned, so validation and
+  // endian conversion are done in place.
+  const IterationBufferPointer pointer(decoded.data(), 0, dtype.size());
+  if (functions.validate) {
+    absl::Status status;
+    if (!(*functions.validate)[IterationBufferKind::kContiguous](
+            /*context=*/nullptr, {1, num_elements}, pointer, &status)) {
+      return status;
+    }
+  }
+  if (encoded_endian != endian::native && functions.swap_endian_inplace) {
+    (*functions.swap_endian_inplace)[IterationBufferKind::kContiguous](
+        /*context=*/nullptr, {1, num_elements}, pointer, /*status=*/nullptr);
+  }
+  contiguous_bytes.IncrementBy(expected_length);
+  return decoded;
+}
+
 absl::Status DecodeArrayEndian(riegeli::Reader& reader, endian encoded_endian,
                                ContiguousLayoutOrder order,
                                ArrayView<void> decoded) {
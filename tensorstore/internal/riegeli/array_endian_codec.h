@@ -21,6 +21,7 @@
 #include <string_view>
 #include <utility>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "riegeli/bytes/reader.h"
@@ -54,6 +55,16 @@ Result<SharedArray<const void>> DecodeArrayEndian(
     riegeli::Reader& reader, DataType dtype, span<const Index> decoded_shape,
     endian encoded_endian, ContiguousLayoutOrder order);
 
+// Decodes an array of trivial elements in the specified order.
+//
+// The encoded representation is written directly into the newly allocated
+// array by `decode`, which is called with a buffer of exactly the encoded size
+// and must fill it entirely.
+Result<SharedArray<const void>> DecodeArrayEndian(
+    absl::FunctionRef<absl::Status(span<char> encoded)> decode, DataType dtype,
+    span<const Index> decoded_shape, endian encoded_endian,
+    ContiguousLayoutOrder order);
+
 // Decodes an array of trivial elements in the specified order.
 absl::Status DecodeArrayEndian(riegeli::Reader& reader, endian encoded_endian,
                                ContiguousLayoutOrder order,
@@ -14,8 +14,18 @@
 
 #include "tensorstore/internal/riegeli/array_endian_codec.h"
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/base/internal/endian.h"
+#include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/cord_test_helpers.h"
 #include "riegeli/bytes/cord_reader.h"
@@ -25,6 +35,7 @@
 #include "riegeli/zlib/zlib_writer.h"
 #include "tensorstore/array.h"
 #include "tensorstore/contiguous_layout.h"
+#include "tensorstore/internal/cord_util.h"
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/util/endian.h"
 #include "tensorstore/util/result.h"
@@ -324,4 +335,84 @@ TEST(DecodeArrayEndianTest, Fragmented) {
   EXPECT_THAT(decoded, MakeTestArray<uint16_t>(c_order));
 }
 
+TEST(DecodeArrayEndianTest, FragmentedSwapped) {
+  // Fragment boundaries are not aligned to elements.
+  auto c_array = MakeTestArray<uint32_t>(c_order, 100, 200);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, EncodeArrayAsCord(c_array, endian::big, c_order));
+  std::string flat(encoded.Flatten());
+  std::vector<std::string> parts;
+  for (size_t i = 0; i < flat.size(); i += 1001) {
+    parts.push_back(flat.substr(i, 1001));
+  }
+  absl::Cord cord = absl::MakeFragmentedCord(parts);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded, DecodeArrayFromCord(dtype_v<uint32_t>, {{100, 200}}, cord,
+                                        endian::big, c_order));
+  EXPECT_THAT(decoded, c_array);
+}
+
+TEST(DecodeArrayEndianTest, DecodeFunctionSwapped) {
+  auto c_array = MakeTestArray<uint32_t>(c_order, 100, 200);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, EncodeArrayAsCord(c_array, endian::big, c_order));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded,
+      DecodeArrayEndian(
+          [&](span<char> output) {
+            EXPECT_EQ(encoded.size(), output.size());
+            tensorstore::internal::CopyCordToSpan(encoded, output);
+            return absl::OkStatus();
+          },
+          dtype_v<uint32_t>, {{100, 200}}, endian::big, c_order));
+  EXPECT_THAT(decoded, c_array);
+}
+
+TEST(DecodeArrayEndianTest, DecodeFunctionInvalidBool) {
+  EXPECT_THAT(DecodeArrayEndian(
+                  [&](span<char> output) {
+                    std::fill(output.begin(), output.end(), 1);
+                    output[3] = 2;
+                    return absl::OkStatus();
+                  },
+                  dtype_v<bool>, {{2, 2}}, endian::native, c_order),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Invalid bool value: 2"));
+}
+
+TEST(DecodeArrayEndianTest, DecodeFunctionError) {
+  EXPECT_THAT(DecodeArrayEndian(
+                  [&](span<char> output) {
+                    return absl::InvalidArgumentError("Corrupt");
+                  },
+                  dtype_v<uint16_t>, {{2, 3}}, endian::native, c_order),
+              MatchesStatus(absl::StatusCode::kInvalidArgument, "Corrupt"));
+}
+
+TEST(EncodeArrayEndianTest, RoundTripSwappedComplex) {
+  auto array = AllocateArray<std::complex<float>>({3, 5}, c_order,
+                                                   tensorstore::default_init);
+  for (Index i = 0; i < array.num_elements(); ++i) {
+    array.data()[i] = {static_cast<float>(i), static_cast<float>(-i)};
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded, EncodeArrayAsCord(array, endian::big, c_order));
+  std::string flat(encoded.Flatten());
+  ASSERT_EQ(flat.size(), 15 * 8);
+  for (Index i = 0; i < array.num_elements(); ++i) {
+    for (int j = 0; j < 2; ++j) {
+      uint32_t value;
+      std::memcpy(&value, flat.data() + i * 8 + j * 4, 4);
+      float expected = j == 0 ? array.data()[i].real() : array.data()[i].imag();
+      uint32_t expected_bits;
+      std::memcpy(&expected_bits, &expected, 4);
+      EXPECT_EQ(absl::big_endian::FromHost32(expected_bits), value);
+    }
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto decoded, DecodeArrayFromCord(array.dtype(), array.shape(), encoded,
+                                        endian::big, c_order));
+  EXPECT_EQ(array, decoded);
+}
+
 }  // namespace
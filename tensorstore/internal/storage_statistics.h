@@ -67,6 +67,13 @@ struct GetStorageStatisticsAsyncOperationState
     }
   }
 
+  // Same as above, but for `count` chunks at once.
+  void AddChunksPresent(int64_t count) {
+    if (count != 0 && chunks_present.fetch_add(count) == 0) {
+      MaybeStopEarly();
+    }
+  }
+
   // Must be called when a chunk is known to be missing.  Depending on
   // `options`, this may result in `promise.result_needed()` becoming `false`.
   void ChunkMissing() {
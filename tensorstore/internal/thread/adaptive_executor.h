@@ -0,0 +1,99 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_THREAD_ADAPTIVE_EXECUTOR_H_
+#define TENSORSTORE_INTERNAL_THREAD_ADAPTIVE_EXECUTOR_H_
+
+/// \file
+///
+/// Executor adapter that runs small tasks inline.
+///
+/// Many continuations are submitted to an executor (such as the
+/// `data_copy_concurrency` executor) because they *may* perform substantial
+/// work, even though, in common cases, they just forward an existing result,
+/// in which case the latency of the thread hop exceeds the cost of the task.
+/// Such call sites can specify a cost hint, computed from the state they
+/// observe, with `AdaptiveExecutor`.
+
+#include <utility>
+
+#include "tensorstore/util/executor.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Estimated cost of a task submitted to an `AdaptiveExecutor`.
+enum class TaskCost {
+  /// Small, bounded amount of work, such as completing a receiver or promise
+  /// with an existing value.
+  kSmall,
+
+  /// Potentially substantial work, such as decoding, encoding, or copying a
+  /// chunk.
+  kLarge,
+};
+
+/// Maximum number of nested tasks that `AdaptiveExecutor` runs inline on a
+/// single thread.  Tasks beyond this depth are submitted to the underlying
+/// executor, which bounds the stack growth from chains of continuations that
+/// each submit another small task.
+constexpr int kMaxInlineTaskDepth = 8;
+
+namespace internal_executor {
+inline thread_local int inline_task_depth = 0;
+}  // namespace internal_executor
+
+/// Runs `func` inline if `cost` is `TaskCost::kSmall` and fewer than
+/// `kMaxInlineTaskDepth` tasks are already being run inline on the current
+/// thread, and otherwise submits it to `executor`.
+template <typename BaseExecutor, typename Func>
+void ExecuteWithCost(const BaseExecutor& executor, TaskCost cost,
+                     Func&& func) {
+  int& depth = internal_executor::inline_task_depth;
+  if (cost == TaskCost::kSmall && depth < kMaxInlineTaskDepth) {
+    ++depth;
+    std::forward<Func>(func)();
+    --depth;
+    return;
+  }
+  executor(std::forward<Func>(func));
+}
+
+/// Executor that invokes `ExecuteWithCost` with a fixed cost hint.
+///
+/// Example usage:
+///
+///     auto continuation = WithExecutor(
+///         AdaptiveExecutor{cache.executor(),
+///                          needs_copy ? TaskCost::kLarge : TaskCost::kSmall},
+///         [...](ReadyFuture<const void> future) { ... });
+template <typename BaseExecutor = Executor>
+struct AdaptiveExecutor {
+  BaseExecutor executor;
+  TaskCost cost;
+
+  template <typename Func>
+  void operator()(Func&& func) const {
+    ExecuteWithCost(executor, cost, std::forward<Func>(func));
+  }
+};
+
+template <typename BaseExecutor>
+AdaptiveExecutor(BaseExecutor executor, TaskCost cost)
+    -> AdaptiveExecutor<BaseExecutor>;
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_THREAD_ADAPTIVE_EXECUTOR_H_
@@ -0,0 +1,112 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/adaptive_executor.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/util/executor.h"
+
+namespace {
+
+using ::tensorstore::Executor;
+using ::tensorstore::ExecutorTask;
+using ::tensorstore::WithExecutor;
+using ::tensorstore::internal::AdaptiveExecutor;
+using ::tensorstore::internal::ExecuteWithCost;
+using ::tensorstore::internal::kMaxInlineTaskDepth;
+using ::tensorstore::internal::TaskCost;
+
+// Executor that defers tasks until `RunAll` is called.
+struct QueueExecutor {
+  std::vector<ExecutorTask>* queue;
+  void operator()(ExecutorTask task) const {
+    queue->push_back(std::move(task));
+  }
+};
+
+void RunAll(std::vector<ExecutorTask>& queue) {
+  while (!queue.empty()) {
+    auto task = std::move(queue.front());
+    queue.erase(queue.begin());
+    std::move(task)();
+  }
+}
+
+TEST(AdaptiveExecutorTest, SmallTasksRunInline) {
+  std::vector<ExecutorTask> queue;
+  Executor executor = QueueExecutor{&queue};
+  bool ran = false;
+  ExecuteWithCost(executor, TaskCost::kSmall, [&] { ran = true; });
+  EXPECT_TRUE(ran);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(AdaptiveExecutorTest, LargeTasksAreDeferred) {
+  std::vector<ExecutorTask> queue;
+  Executor executor = QueueExecutor{&queue};
+  bool ran = false;
+  ExecuteWithCost(executor, TaskCost::kLarge, [&] { ran = true; });
+  EXPECT_FALSE(ran);
+  ASSERT_EQ(1, queue.size());
+  RunAll(queue);
+  EXPECT_TRUE(ran);
+}
+
+TEST(AdaptiveExecutorTest, DepthLimit) {
+  std::vector<ExecutorTask> queue;
+  AdaptiveExecutor executor{Executor(QueueExecutor{&queue}), TaskCost::kSmall};
+  constexpr int kNumTasks = 3 * kMaxInlineTaskDepth;
+  int num_run = 0;
+  int max_inline_depth = 0;
+  // Each task submits the next one from within its invocation.
+  std::function<void(int)> submit = [&](int depth) {
+    executor([&, depth] {
+      ++num_run;
+      max_inline_depth = std::max(max_inline_depth, depth);
+      if (num_run < kNumTasks) submit(depth + 1);
+    });
+  };
+  submit(1);
+  EXPECT_EQ(kMaxInlineTaskDepth, num_run);
+  EXPECT_EQ(kMaxInlineTaskDepth, max_inline_depth);
+  // The task beyond the depth limit was deferred; when run from the queue, it
+  // again runs its continuations inline, up to the limit.
+  EXPECT_EQ(1, queue.size());
+  RunAll(queue);
+  EXPECT_EQ(kNumTasks, num_run);
+}
+
+TEST(AdaptiveExecutorTest, WithExecutor) {
+  std::vector<ExecutorTask> queue;
+  Executor executor = QueueExecutor{&queue};
+  int value = 0;
+  auto small = WithExecutor(AdaptiveExecutor{executor, TaskCost::kSmall},
+                            [&](int x) { value = x; });
+  small(1);
+  EXPECT_EQ(1, value);
+  auto large = WithExecutor(AdaptiveExecutor{executor, TaskCost::kLarge},
+                            [&](int x) { value = x; });
+  large(2);
+  EXPECT_EQ(1, value);
+  RunAll(queue);
+  EXPECT_EQ(2, value);
+}
+
+}  // namespace
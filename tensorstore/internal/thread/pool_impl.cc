@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
@@ -45,6 +46,7 @@ constexpr absl::Duration kThreadStartDelay = absl::Milliseconds(5);
 constexpr absl::Duration kThreadExitDelay = absl::Milliseconds(5);
 constexpr absl::Duration kThreadIdleBeforeExit = absl::Seconds(20);
 constexpr absl::Duration kOverseerIdleBeforeExit = absl::Seconds(20);
+constexpr size_t kMaxThreadStartBurst = 16;
 
 auto& thread_pool_started = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/thread_pool/started",
@@ -62,8 +64,12 @@ ABSL_CONST_INIT internal_log::VerboseFlag thread_pool_logging("thread_pool");
 
 }  // namespace
 
-SharedThreadPool::SharedThreadPool() : waiting_(128) {
-  ABSL_LOG_IF(INFO, thread_pool_logging) << "SharedThreadPool: " << this;
+SharedThreadPool::SharedThreadPool() : SharedThreadPool(std::vector<int>{}) {}
+
+SharedThreadPool::SharedThreadPool(std::vector<int> cpu_affinity)
+    : cpu_affinity_(std::move(cpu_affinity)), waiting_(128) {
+  ABSL_LOG_IF(INFO, thread_pool_logging)
+      << "SharedThreadPool: " << this << " cpus=" << cpu_affinity_.size();
 }
 
 void SharedThreadPool::NotifyWorkAvailable(
@@ -81,7 +87,7 @@ void SharedThreadPool::NotifyWorkAvailable(
 }
 
 internal::IntrusivePtr<TaskProvider>
-SharedThreadPool::FindActiveTaskProvider() {
+SharedThreadPool::FindActiveTaskProvider(int64_t* work_out) {
   for (int i = waiting_.size(); i > 0; i--) {
     internal::IntrusivePtr<TaskProvider> ptr = std::move(waiting_.front());
     waiting_.pop_front();
@@ -96,6 +102,7 @@ SharedThreadPool::FindActiveTaskProvider() {
       waiting_.push_back(ptr);
     }
     thread_pool_task_providers.Set(waiting_.size());
+    if (work_out) *work_out = work;
     return ptr;
   }
   return nullptr;
@@ -153,11 +160,32 @@ absl::Time SharedThreadPool::Overseer::MaybeStartWorker(absl::Time now) {
     return pool_->queue_assignment_time_ + kThreadStartDelay;
   }
 
-  auto task_provider = pool_->FindActiveTaskProvider();
-  if (!task_provider) {
+  // When a worker was started in the previous interval and there are still no
+  // idle threads, demand is sustained; double the number of workers started
+  // per interval so that the pool reaches full width quickly.
+  if (now < pool_->last_thread_start_time_ + 2 * kThreadStartDelay) {
+    pool_->start_burst_ =
+        std::min(pool_->start_burst_ * 2, kMaxThreadStartBurst);
+  } else {
+    pool_->start_burst_ = 1;
+  }
+
+  // Visit each waiting TaskProvider at most once, starting no more workers
+  // than it currently estimates it requires.
+  size_t remaining = pool_->start_burst_;
+  for (size_t i = pool_->waiting_.size(); i > 0 && remaining > 0; --i) {
+    int64_t work = 0;
+    auto task_provider = pool_->FindActiveTaskProvider(&work);
+    if (!task_provider) break;
+    size_t n = std::min(remaining, static_cast<size_t>(work));
+    remaining -= n;
+    while (n--) {
+      pool_->StartWorker(task_provider, now);
+    }
+  }
+  if (remaining == pool_->start_burst_) {
     return idle_start_time_ + kOverseerIdleBeforeExit;
   }
-  pool_->StartWorker(std::move(task_provider), now);
   idle_start_time_ = now;
   return now + kThreadStartDelay;
 }
@@ -196,6 +224,13 @@ void SharedThreadPool::Worker::WorkerBody() {
   thread_pool_active.Increment();
   ABSL_LOG_IF(INFO, thread_pool_logging.Level(1)) << "Worker: " << this;
 
+  if (!pool_->cpu_affinity_.empty() &&
+      !tensorstore::internal::TrySetCurrentThreadAffinity(
+          pool_->cpu_affinity_)) {
+    ABSL_LOG_FIRST_N(WARNING, 1)
+        << "SharedThreadPool: Failed to set worker thread affinity";
+  }
+
   while (true) {
     // Get a TaskProvider assignment.
     if (task_provider_) {
@@ -16,8 +16,10 @@
 #define TENSORSTORE_INTERNAL_THREAD_POOL_IMPL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <cassert>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_set.h"
@@ -34,7 +36,10 @@ namespace internal_thread_impl {
 ///
 /// Worker threads are started automatically at a limited rate when needed
 /// for registered TaskProviders. Threads are started by an overseer thread
-/// to provide rate-limiting and fairness.
+/// to provide rate-limiting and fairness.  While demand remains unsatisfied
+/// the overseer starts exponentially larger batches of threads, so that a
+/// burst of work reaches the requested concurrency in a logarithmic number
+/// of start intervals.
 ///
 /// Both worker threads and the overseer thread automatically terminate after
 /// they are idle for longer than `kThreadIdleBeforeExit` or
@@ -44,6 +49,10 @@ class SharedThreadPool
  public:
   SharedThreadPool();
 
+  /// Constructs a pool whose worker threads are restricted to `cpu_affinity`.
+  /// An empty vector indicates no restriction.
+  explicit SharedThreadPool(std::vector<int> cpu_affinity);
+
   /// TaskProviderMethod:  Notify that there is work available.
   /// If the task provider identified by the token is not in the waiting_
   /// queue, add it.
@@ -55,9 +64,10 @@ class SharedThreadPool
   struct Worker;
 
   // Gets the next TaskProvider with work available where the last thread
-  // assignment time was before the deadline.
-  internal::IntrusivePtr<TaskProvider> FindActiveTaskProvider()
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // assignment time was before the deadline.  When `work` is not null, it is
+  // set to the estimated number of threads required by the returned provider.
+  internal::IntrusivePtr<TaskProvider> FindActiveTaskProvider(
+      int64_t* work = nullptr) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   /// Starts the overseer thread.
   void StartOverseer() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -66,10 +76,17 @@ class SharedThreadPool
   void StartWorker(internal::IntrusivePtr<TaskProvider>, absl::Time now)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // CPUs to which worker threads are restricted; empty if unrestricted.
+  const std::vector<int> cpu_affinity_;
+
   absl::Mutex mutex_;
   size_t worker_threads_ ABSL_GUARDED_BY(mutex_) = 0;
   size_t idle_threads_ ABSL_GUARDED_BY(mutex_) = 0;
 
+  // Number of workers the overseer may start per `kThreadStartDelay`
+  // interval.  Doubles while demand is sustained and resets to 1 otherwise.
+  size_t start_burst_ ABSL_GUARDED_BY(mutex_) = 1;
+
   // Overseer state.
   absl::CondVar overseer_condvar_;
   bool overseer_running_ ABSL_GUARDED_BY(mutex_) = false;
@@ -128,4 +128,49 @@ TEST(SharedThreadPoolTest, LotsOfProviders) {
   }
 }
 
+// TaskProvider which requires `n` concurrent threads; each thread blocks
+// until all `n` threads have been assigned.
+struct ConcurrentTaskProvider : public TaskProvider {
+  ConcurrentTaskProvider(IntrusivePtr<SharedThreadPool> pool, int64_t n)
+      : pool_(std::move(pool)), n_(n) {}
+
+  int64_t EstimateThreadsRequired() override {
+    absl::MutexLock lock(&mutex_);
+    return n_ - started_;
+  }
+
+  void Trigger() {
+    pool_->NotifyWorkAvailable(IntrusivePtr<TaskProvider>(this));
+  }
+
+  void DoWorkOnThread() override {
+    absl::MutexLock lock(&mutex_);
+    if (started_ == n_) return;
+    ++started_;
+    WaitUntilAllStarted();
+  }
+
+  void WaitUntilAllStarted() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    mutex_.Await(absl::Condition(
+        +[](ConcurrentTaskProvider* self) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+             self->mutex_) { return self->started_ == self->n_; },
+        this));
+  }
+
+  IntrusivePtr<SharedThreadPool> pool_;
+  absl::Mutex mutex_;
+  const int64_t n_;
+  int64_t started_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Tests that the thread pool starts enough threads to satisfy a single
+// provider requiring many concurrent threads.
+TEST(SharedThreadPoolTest, ConcurrentThreads) {
+  auto pool = MakeIntrusivePtr<SharedThreadPool>();
+  auto provider = MakeIntrusivePtr<ConcurrentTaskProvider>(pool, 64);
+  provider->Trigger();
+  absl::MutexLock lock(&provider->mutex_);
+  provider->WaitUntilAllStarted();
+}
+
 }  // namespace
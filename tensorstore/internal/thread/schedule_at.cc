@@ -16,9 +16,8 @@
 
 #include <stdint.h>
 
-#include <algorithm>
 #include <atomic>
-#include <iterator>
+#include <limits>
 #include <memory>
 #include <utility>
 
@@ -30,14 +29,14 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
-#include "absl/types/compare.h"
-#include "tensorstore/internal/container/intrusive_red_black_tree.h"
+#include "tensorstore/internal/container/intrusive_linked_list.h"
 #include "tensorstore/internal/metrics/gauge.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/metrics/value.h"
 #include "tensorstore/internal/tagged_ptr.h"
 #include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/internal/thread/timer_wheel.h"
 #include "tensorstore/internal/tracing/tracing.h"
 #include "tensorstore/util/stop_token.h"
 
@@ -67,16 +66,18 @@ class DeadlineTaskQueue;
 
 using TaggedQueuePointer = TaggedPtr<DeadlineTaskQueue, 1>;
 
-struct DeadlineTaskNode;
+using internal_thread_impl::TimerWheel;
+
+using NodeAccessor = intrusive_linked_list::MemberAccessor<TimerWheel::Node>;
 
-using DeadlineTaskTree = intrusive_red_black_tree::Tree<DeadlineTaskNode>;
+struct DeadlineTaskNode;
 
 struct DeadlineTaskStopCallback {
   DeadlineTaskNode& node;
   void operator()() const;
 };
 
-struct DeadlineTaskNode : public DeadlineTaskTree::NodeBase {
+struct DeadlineTaskNode : public TimerWheel::Node {
   DeadlineTaskNode(absl::Time deadline, ScheduleAtTask&& task,
                    const StopToken& token)
       : deadline(deadline),
@@ -94,7 +95,7 @@ struct DeadlineTaskNode : public DeadlineTaskTree::NodeBase {
   ABSL_ATTRIBUTE_NO_UNIQUE_ADDRESS internal_tracing::TraceContext trace_context;
 
   // The raw `DeadlineTaskQueue` pointer is non-null once the task has been
-  // added to the tree.  The tag bit is 1 if cancellation of the task has been
+  // added to the queue.  The tag bit is 1 if cancellation of the task has been
   // requested.
   //
   // If the stop request occurs while the `DeadlineTaskQueue` pointer is null
@@ -103,21 +104,35 @@ struct DeadlineTaskNode : public DeadlineTaskTree::NodeBase {
   // will be cancelled by the thread that is adding it.
   //
   // If the stop request occurs while the `DeadlineTaskQueue` point is
-  // non-null, then it is removed from the queue directly.
+  // non-null, then it is removed from the timer wheel directly.
   std::atomic<TaggedQueuePointer> queue;
   StopCallback<DeadlineTaskStopCallback> stop_callback;
 };
 
-using RunImmediatelyQueueAccessor =
-    intrusive_red_black_tree::LinkedListAccessor<DeadlineTaskNode>;
+// Timer wheel ticks are in units of milliseconds since the Unix epoch.
+//
+// Deadlines are rounded up, such that tasks never run early, and tasks whose
+// deadlines fall within the same millisecond are run by a single wakeup.
+int64_t DeadlineToTick(absl::Time deadline) {
+  if (deadline == absl::InfiniteFuture()) return TimerWheel::kNever;
+  if (deadline == absl::InfinitePast()) {
+    return std::numeric_limits<int64_t>::min();
+  }
+  int64_t tick = absl::ToUnixMillis(deadline);
+  if (absl::FromUnixMillis(tick) < deadline) ++tick;
+  return tick;
+}
+
+int64_t NowTick() { return absl::ToUnixMillis(absl::Now()); }
 
 class DeadlineTaskQueue {
  public:
   explicit DeadlineTaskQueue()
-      : run_immediately_queue_(nullptr),
-        next_wakeup_(absl::InfinitePast()),
-        woken_up_(absl::InfinitePast()),
-        thread_({"TensorstoreScheduleAt"}, &DeadlineTaskQueue::Run, this) {}
+      : wheel_(NowTick()),
+        next_wakeup_(kAwake),
+        thread_({"TensorstoreScheduleAt"}, &DeadlineTaskQueue::Run, this) {
+    intrusive_linked_list::Initialize(NodeAccessor{}, &ready_);
+  }
 
   ~DeadlineTaskQueue() { ABSL_UNREACHABLE(); }  // COV_NF_LINE
 
@@ -130,6 +145,9 @@ class DeadlineTaskQueue {
   friend struct DeadlineTaskNode;
   friend struct DeadlineTaskStopCallback;
 
+  // Value of `next_wakeup_` while the thread is not waiting.
+  constexpr static int64_t kAwake = std::numeric_limits<int64_t>::min();
+
   // Called from `DeadlineTaskStopCallback::operator()` to attempt to remove a
   // node if it is not already exiting.
   //
@@ -141,13 +159,15 @@ class DeadlineTaskQueue {
 
   absl::Mutex mutex_;
   absl::CondVar cond_var_;
-  DeadlineTaskTree tree_ ABSL_GUARDED_BY(mutex_);
+  TimerWheel wheel_ ABSL_GUARDED_BY(mutex_);
 
-  // Additional circular linked list of tasks to run immediately.
-  DeadlineTaskNode* run_immediately_queue_ ABSL_GUARDED_BY(mutex_);
+  // Head of the circular linked list of expired tasks to run on the next
+  // wakeup of the thread.
+  TimerWheel::Node ready_ ABSL_GUARDED_BY(mutex_);
 
-  absl::Time next_wakeup_ ABSL_GUARDED_BY(mutex_);
-  absl::Time woken_up_ ABSL_GUARDED_BY(mutex_);
+  // Tick until which the thread is waiting, `TimerWheel::kNever` if it is
+  // waiting indefinitely, or `kAwake`.
+  int64_t next_wakeup_ ABSL_GUARDED_BY(mutex_);
   Thread thread_;
 };
 
@@ -159,6 +179,7 @@ void DeadlineTaskQueue::ScheduleAt(absl::Time target_time, ScheduleAtTask task,
 
   auto node = std::make_unique<DeadlineTaskNode>(target_time, std::move(task),
                                                  stop_token);
+  const int64_t tick = DeadlineToTick(target_time);
 
   // Enqueue the task.
   absl::MutexLock l(&mutex_);
@@ -171,36 +192,19 @@ void DeadlineTaskQueue::ScheduleAt(absl::Time target_time, ScheduleAtTask task,
     // is declared before `l`.
     return;
   }
-  if (target_time <= woken_up_) {
+  if (!wheel_.Insert(node.get(), tick)) {
     // Target time is in the past, schedule to run immediately.
-    RunImmediatelyQueueAccessor{}.SetNext(node.get(), nullptr);
-    if (run_immediately_queue_) {
-      RunImmediatelyQueueAccessor{}.SetNext(
-          RunImmediatelyQueueAccessor{}.GetPrev(run_immediately_queue_),
-          node.get());
-      RunImmediatelyQueueAccessor{}.SetPrev(run_immediately_queue_, node.get());
-    } else {
-      run_immediately_queue_ = node.get();
-      RunImmediatelyQueueAccessor{}.SetPrev(node.get(), node.get());
-    }
-    if (next_wakeup_ != absl::InfinitePast()) {
-      next_wakeup_ = absl::InfinitePast();
-      // Wake up thread immediately due to earlier deadline.
+    intrusive_linked_list::InsertBefore(NodeAccessor{}, &ready_,
+                                        node.release());
+    if (next_wakeup_ != kAwake) {
+      next_wakeup_ = kAwake;
       cond_var_.Signal();
     }
-    node.release();
     return;
   }
-
-  // Schedule to run normally.
-  tree_.FindOrInsert(
-      [&](DeadlineTaskNode& other) {
-        return target_time < other.deadline ? absl::weak_ordering::less
-                                            : absl::weak_ordering::greater;
-      },
-      [&] { return node.release(); });
-  if (target_time < next_wakeup_) {
-    next_wakeup_ = target_time;
+  node.release();
+  if (tick < next_wakeup_) {
+    next_wakeup_ = tick;
     // Wake up thread immediately due to earlier deadline.
     cond_var_.Signal();
   }
@@ -208,35 +212,32 @@ void DeadlineTaskQueue::ScheduleAt(absl::Time target_time, ScheduleAtTask task,
 
 void DeadlineTaskQueue::Run() {
   while (true) {
-    DeadlineTaskTree runnable;
-    DeadlineTaskNode* run_immediately = nullptr;
+    TimerWheel::Node runnable;
+    intrusive_linked_list::Initialize(NodeAccessor{}, &runnable);
     {
       absl::MutexLock l(&mutex_);
-      do {
-        run_immediately = std::exchange(run_immediately_queue_, nullptr);
-
-        if (!run_immediately) {
-          next_wakeup_ =
-              tree_.empty() ? absl::InfiniteFuture() : tree_.begin()->deadline;
-
-          // Sleep until our next deadline.
-          schedule_at_next_event.Set(next_wakeup_);
-          cond_var_.WaitWithDeadline(&mutex_, next_wakeup_);
+      while (true) {
+        // Expire all tasks with deadlines up to now, and cascade the timer
+        // wheel as necessary.
+        wheel_.Advance(NowTick(), ready_);
+        if (!intrusive_linked_list::OnlyContainsNode(NodeAccessor{}, &ready_)) {
+          break;
         }
-
-        // Consume the queue.
-        auto woken_up = woken_up_ = std::max(woken_up_, absl::Now());
-
-        auto split_result = tree_.FindSplit([&](DeadlineTaskNode& node) {
-          return node.deadline <= woken_up ? absl::weak_ordering::greater
-                                           : absl::weak_ordering::less;
-        });
-
-        runnable = std::move(split_result.trees[0]);
-        tree_ = std::move(split_result.trees[1]);
-      } while (runnable.empty() && !run_immediately);
-
-      next_wakeup_ = absl::InfinitePast();
+        // Sleep until our next deadline.
+        next_wakeup_ = wheel_.NextEventTick();
+        const absl::Time wakeup = next_wakeup_ == TimerWheel::kNever
+                                      ? absl::InfiniteFuture()
+                                      : absl::FromUnixMillis(next_wakeup_);
+        schedule_at_next_event.Set(wakeup);
+        cond_var_.WaitWithDeadline(&mutex_, wakeup);
+        next_wakeup_ = kAwake;
+      }
+      // Take all ready tasks as a single batch.
+      while (ready_.next != &ready_) {
+        auto* node = ready_.next;
+        intrusive_linked_list::Remove(NodeAccessor{}, node);
+        intrusive_linked_list::InsertBefore(NodeAccessor{}, &runnable, node);
+      }
     }  // MutexLock
 
     // Execute functions without lock
@@ -244,19 +245,10 @@ void DeadlineTaskQueue::Run() {
     internal_tracing::TraceContext base =
         internal_tracing::TraceContext(internal_tracing::TraceContext::kThread);
 
-    // First run any tasks in `run_immediately` list.
-    while (run_immediately) {
-      auto* next = RunImmediatelyQueueAccessor{}.GetNext(run_immediately);
-      run_immediately->RunAndDelete();
-      run_immediately = next;
-    }
-
-    // Run any tasks in `runnable` tree.
-    for (DeadlineTaskTree::iterator it = runnable.begin(), next;
-         it != runnable.end(); it = next) {
-      next = std::next(it);
-      runnable.Remove(*it);
-      it->RunAndDelete();
+    for (auto* node = runnable.next; node != &runnable;) {
+      auto* next = node->next;
+      static_cast<DeadlineTaskNode*>(node)->RunAndDelete();
+      node = next;
     }
 
     internal_tracing::SwapCurrentTraceContext(&base);
@@ -288,15 +280,13 @@ void DeadlineTaskStopCallback::operator()() const {
 void DeadlineTaskQueue::TryRemove(DeadlineTaskNode& node) {
   {
     absl::MutexLock lock(&mutex_);
-    // If deadline is met after the exchange operation above, the node will be
-    // removed from the queue but not destroyed.
-    if (node.deadline <= woken_up_) {
+    // If the node has already expired, it will be run (and skipped due to the
+    // cancellation tag) and destroyed by the thread.
+    if (!node.in_wheel()) {
       // Task is being executed now.  Too late to cancel.
       return;
     }
-    tree_.Remove(node);
-    // No need to recompute `queue_ptr->next_wakeup_` here, since it can only
-    // get later.
+    wheel_.Remove(&node);
   }
   delete &node;
   schedule_at_queued_ops.Decrement();
@@ -0,0 +1,111 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/random/random.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/container/intrusive_linked_list.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/internal/thread/timer_wheel.h"
+#include "tensorstore/util/stop_token.h"
+
+namespace {
+
+using ::tensorstore::StopSource;
+using ::tensorstore::internal::ScheduleAt;
+using ::tensorstore::internal_thread_impl::TimerWheel;
+
+// Expiry ticks of `n` timers with retry-like backoff delays of up to ~1 hour
+// of 1ms ticks.
+std::vector<int64_t> RandomTicks(size_t n) {
+  absl::BitGen gen;
+  std::vector<int64_t> ticks(n);
+  for (auto& tick : ticks) {
+    tick = absl::LogUniform<int64_t>(gen, 1, 3600 * 1000);
+  }
+  return ticks;
+}
+
+// Inserts and removes a timer while `state.range(0)` other timers are
+// outstanding.
+void BM_TimerWheelInsertRemove(benchmark::State& state) {
+  const size_t n = state.range(0);
+  auto ticks = RandomTicks(n);
+  TimerWheel wheel;
+  auto nodes = std::make_unique<TimerWheel::Node[]>(n);
+  for (size_t i = 0; i < n; ++i) wheel.Insert(&nodes[i], ticks[i]);
+  TimerWheel::Node node;
+  size_t i = 0;
+  for (auto s : state) {
+    wheel.Insert(&node, ticks[i++ % n]);
+    wheel.Remove(&node);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimerWheelInsertRemove)->Arg(1000)->Arg(1000000);
+
+// Inserts `state.range(0)` timers and advances through all of their expiry
+// ticks in steps of 1ms.
+void BM_TimerWheelExpire(benchmark::State& state) {
+  const size_t n = state.range(0);
+  auto ticks = RandomTicks(n);
+  auto nodes = std::make_unique<TimerWheel::Node[]>(n);
+  using Accessor = tensorstore::internal::intrusive_linked_list::
+      MemberAccessor<TimerWheel::Node>;
+  for (auto s : state) {
+    TimerWheel wheel;
+    for (size_t i = 0; i < n; ++i) wheel.Insert(&nodes[i], ticks[i]);
+    size_t expired_count = 0;
+    while (wheel.size()) {
+      TimerWheel::Node expired;
+      tensorstore::internal::intrusive_linked_list::Initialize(Accessor{},
+                                                               &expired);
+      wheel.Advance(wheel.NextEventTick(), expired);
+      for (auto* node = expired.next; node != &expired; node = node->next) {
+        ++expired_count;
+      }
+    }
+    benchmark::DoNotOptimize(expired_count);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TimerWheelExpire)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Schedules `state.range(0)` retries with `ScheduleAt`, and then cancels them
+// all via their `StopToken`s.
+void BM_ScheduleAtCancel(benchmark::State& state) {
+  const size_t n = state.range(0);
+  auto ticks = RandomTicks(n);
+  for (auto s : state) {
+    const absl::Time now = absl::Now();
+    std::vector<StopSource> stop_sources(n);
+    for (size_t i = 0; i < n; ++i) {
+      ScheduleAt(
+          now + absl::Minutes(1) + absl::Milliseconds(ticks[i]), [] {},
+          stop_sources[i].get_token());
+    }
+    for (auto& stop_source : stop_sources) stop_source.request_stop();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ScheduleAtCancel)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -34,7 +34,6 @@
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_provider.h"
-#include "tensorstore/util/span.h"
 
 using ::tensorstore::internal_metrics::MetricMetadata;
 
@@ -301,7 +300,10 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
     }
   }
 
-  if (state != 0) {
+  size_t pending;
+  if (state == 0) {
+    pending = per_thread_data->queue.size();
+  } else {
     absl::MutexLock lock(&mutex_);
 
     if (state == 1) {
@@ -318,24 +320,24 @@ void TaskGroup::AddTask(std::unique_ptr<InFlightTask> task) {
     }
 
     queue_.push_back(std::move(task));
+    pending = queue_.size();
   }
 
-  if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
-    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
-  }
+  MaybeNotifyWorkAvailable(pending);
 }
 
-void TaskGroup::BulkAddTask(
-    tensorstore::span<std::unique_ptr<InFlightTask>> tasks) {
-  {
-    absl::MutexLock lock(&mutex_);
-    for (auto& t : tasks) {
-      queue_.push_back(std::move(t));
-    }
-  }
-  if (threads_in_use_.load(std::memory_order_relaxed) < thread_limit_) {
-    pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
+void TaskGroup::MaybeNotifyWorkAvailable(size_t pending) {
+  const size_t in_use = threads_in_use_.load(std::memory_order_relaxed);
+  if (in_use >= thread_limit_) return;
+  // When a thread is blocked waiting on the global queue it will pick up the
+  // new work; skip taking the SharedThreadPool mutex in that case, but only if
+  // the threads in use already suffice for the pending work.  Otherwise a
+  // burst of tasks could leave fewer threads running than it needs.
+  if (threads_blocked_.load(std::memory_order_relaxed) != 0 &&
+      in_use >= std::min(pending, thread_limit_)) {
+    return;
   }
+  pool_->NotifyWorkAvailable(internal::IntrusivePtr<TaskProvider>(this));
 }
 
 }  // namespace internal_thread_impl
@@ -34,7 +34,6 @@
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_provider.h"
-#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal_thread_impl {
@@ -67,11 +66,6 @@ class TaskGroup : public TaskProvider {
   /// Thread safety: safe to call concurrently from multiple threads.
   void AddTask(std::unique_ptr<InFlightTask> task);
 
-  /// Enqueues a task.
-  ///
-  /// Thread safety: safe to call concurrently from multiple threads.
-  void BulkAddTask(tensorstore::span<std::unique_ptr<InFlightTask>> tasks);
-
   /// Retrieve work units available.
   int64_t EstimateThreadsRequired() override;
 
@@ -83,6 +77,11 @@ class TaskGroup : public TaskProvider {
   std::unique_ptr<InFlightTask> AcquireTask(PerThreadData* thread_data,
                                             absl::Duration timeout);
 
+  /// Requests an additional thread from the SharedThreadPool if this group
+  /// may use one, unless a thread is already waiting for work and the threads
+  /// in use suffice for the `pending` queued tasks.
+  void MaybeNotifyWorkAvailable(size_t pending);
+
   const internal::IntrusivePtr<SharedThreadPool> pool_;
   const size_t thread_limit_;
 
@@ -15,9 +15,22 @@
 #if defined(__linux__) || defined(__APPLE__)
 #include <pthread.h>
 #endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
+#include <fstream>
+#include <string>
+#include <string_view>
 #include <thread>  // NOLINT
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 
 namespace tensorstore {
 namespace internal {
@@ -36,5 +49,48 @@ void TrySetCurrentThreadName(const char* name) {
   // TODO: Add windows via SetThreadDescription()
 }
 
+std::vector<int> GetNumaNodeCpus(int numa_node) {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  if (numa_node < 0) return cpus;
+  // The cpulist is formatted as a comma-separated list of ranges, such as
+  // "0-11,24-35".
+  std::ifstream file(absl::StrCat("/sys/devices/system/node/node", numa_node,
+                                  "/cpulist"));
+  std::string line;
+  if (!file || !std::getline(file, line)) return cpus;
+  for (std::string_view range :
+       absl::StrSplit(absl::StripAsciiWhitespace(line), ',',
+                      absl::SkipEmpty())) {
+    std::pair<std::string_view, std::string_view> parts =
+        absl::StrSplit(range, absl::MaxSplits('-', 1));
+    int first, last;
+    if (!absl::SimpleAtoi(parts.first, &first)) return {};
+    if (parts.second.empty()) {
+      last = first;
+    } else if (!absl::SimpleAtoi(parts.second, &last) || last < first) {
+      return {};
+    }
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+#endif
+  return cpus;
+}
+
+bool TrySetCurrentThreadAffinity(const std::vector<int>& cpus) {
+  if (cpus.empty()) return false;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) continue;
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace internal
 }  // namespace tensorstore
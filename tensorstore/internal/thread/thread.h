@@ -20,6 +20,7 @@
 #include <functional>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 
@@ -29,6 +30,14 @@ namespace internal {
 /// Helper functions to set the thread name.
 void TrySetCurrentThreadName(const char* name);
 
+/// Returns the CPUs which belong to the specified NUMA node, or an empty
+/// vector if they cannot be determined on this platform.
+std::vector<int> GetNumaNodeCpus(int numa_node);
+
+/// Attempts to restrict the current thread to run on the specified CPUs.
+/// Returns `false` if the affinity could not be set.
+bool TrySetCurrentThreadAffinity(const std::vector<int>& cpus);
+
 // Tensorstore-specific Thread class to be used instead of std::thread.
 // This exposes a limited subset of the std::thread api.
 class Thread {
@@ -23,21 +23,23 @@
 #include <utility>
 
 #include "absl/base/no_destructor.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/thread/pool_impl.h"
 #include "tensorstore/internal/thread/task.h"
 #include "tensorstore/internal/thread/task_group_impl.h"
+#include "tensorstore/internal/thread/thread.h"
 #include "tensorstore/util/executor.h"
 
 namespace tensorstore {
 namespace internal {
 namespace {
 
-Executor DefaultThreadPool(size_t num_threads) {
-  static absl::NoDestructor<internal_thread_impl::SharedThreadPool> pool_;
-  intrusive_ptr_increment(pool_.get());
+Executor MakeTaskGroupExecutor(internal_thread_impl::SharedThreadPool* pool,
+                               size_t num_threads) {
   if (num_threads == 0 || num_threads == std::numeric_limits<size_t>::max()) {
     // Threads are "unbounded"; that doesn't work so well, so put a bound on it.
     num_threads = std::thread::hardware_concurrency() * 16;
@@ -48,8 +50,7 @@ Executor DefaultThreadPool(size_t num_threads) {
   }
 
   auto task_group = internal_thread_impl::TaskGroup::Make(
-      internal::IntrusivePtr<internal_thread_impl::SharedThreadPool>(
-          pool_.get()),
+      internal::IntrusivePtr<internal_thread_impl::SharedThreadPool>(pool),
       num_threads);
   return [task_group = std::move(task_group)](ExecutorTask task) {
     task_group->AddTask(
@@ -57,11 +58,47 @@ Executor DefaultThreadPool(size_t num_threads) {
   };
 }
 
+Executor DefaultThreadPool(size_t num_threads) {
+  static absl::NoDestructor<internal_thread_impl::SharedThreadPool> pool_;
+  intrusive_ptr_increment(pool_.get());
+  return MakeTaskGroupExecutor(pool_.get(), num_threads);
+}
+
+Executor NumaThreadPool(size_t num_threads, int numa_node) {
+  static absl::NoDestructor<absl::Mutex> mutex;
+  static absl::NoDestructor<
+      absl::flat_hash_map<int, internal_thread_impl::SharedThreadPool*>>
+      pools;
+
+  internal_thread_impl::SharedThreadPool* pool;
+  {
+    absl::MutexLock lock(mutex.get());
+    auto& entry = (*pools)[numa_node];
+    if (entry == nullptr) {
+      auto cpus = GetNumaNodeCpus(numa_node);
+      if (cpus.empty()) {
+        ABSL_LOG_FIRST_N(WARNING, 1)
+            << "DetachedThreadPool: Unable to determine CPUs for NUMA node "
+            << numa_node;
+      }
+      // Per-node pools are never destroyed, matching the default pool.
+      entry = new internal_thread_impl::SharedThreadPool(std::move(cpus));
+      intrusive_ptr_increment(entry);
+    }
+    pool = entry;
+  }
+  return MakeTaskGroupExecutor(pool, num_threads);
+}
+
 }  // namespace
 
 Executor DetachedThreadPool(size_t num_threads) {
   return DefaultThreadPool(num_threads);
 }
 
+Executor DetachedThreadPool(size_t num_threads, int numa_node) {
+  return NumaThreadPool(num_threads, numa_node);
+}
+
 }  // namespace internal
 }  // namespace tensorstore
@@ -30,6 +30,16 @@ namespace internal {
 /// \param num_threads Maximum number of threads to use.
 Executor DetachedThreadPool(size_t num_threads);
 
+/// Returns a detached thread pool executor whose threads are restricted to
+/// the CPUs of the specified NUMA node.
+///
+/// Pools for the same NUMA node share worker threads.  If the CPUs of the
+/// NUMA node cannot be determined, the threads are not restricted.
+///
+/// \param num_threads Maximum number of threads to use.
+/// \param numa_node NUMA node index.
+Executor DetachedThreadPool(size_t num_threads, int numa_node);
+
 }  // namespace internal
 }  // namespace tensorstore
 
@@ -35,4 +35,22 @@ TEST(ThreadTest, Basic) {
   EXPECT_EQ(1, x);
 }
 
+TEST(ThreadTest, GetNumaNodeCpusInvalid) {
+  EXPECT_TRUE(tensorstore::internal::GetNumaNodeCpus(-1).empty());
+  EXPECT_TRUE(tensorstore::internal::GetNumaNodeCpus(1 << 20).empty());
+}
+
+TEST(ThreadTest, TrySetCurrentThreadAffinity) {
+  EXPECT_FALSE(tensorstore::internal::TrySetCurrentThreadAffinity({}));
+
+  // Restricting a thread to the CPUs of NUMA node 0 should succeed whenever
+  // the CPUs can be determined.
+  auto cpus = tensorstore::internal::GetNumaNodeCpus(0);
+  if (cpus.empty()) return;
+  tensorstore::internal::Thread thread({}, [&] {
+    EXPECT_TRUE(tensorstore::internal::TrySetCurrentThreadAffinity(cpus));
+  });
+  thread.Join();
+}
+
 }  // namespace
@@ -0,0 +1,164 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/timer_wheel.h"
+
+#include <stdint.h>
+
+#include <cassert>
+
+#include "absl/numeric/bits.h"
+#include "tensorstore/internal/container/intrusive_linked_list.h"
+
+namespace tensorstore {
+namespace internal_thread_impl {
+namespace {
+
+using Accessor =
+    internal::intrusive_linked_list::MemberAccessor<TimerWheel::Node>;
+
+// Shift and mask of the slot index of a given level within a tick.
+constexpr int LevelShift(int level) {
+  return level * TimerWheel::kBitsPerLevel;
+}
+
+constexpr uint64_t kSlotMask = TimerWheel::kSlotsPerLevel - 1;
+
+}  // namespace
+
+TimerWheel::TimerWheel(int64_t current_tick) : current_tick_(current_tick) {
+  for (auto& head : heads_) {
+    internal::intrusive_linked_list::Initialize(Accessor{}, &head);
+  }
+}
+
+void TimerWheel::SetOccupied(int32_t slot) {
+  occupied_[slot / kSlotsPerLevel][(slot % kSlotsPerLevel) / 64] |=
+      uint64_t(1) << (slot % 64);
+}
+
+void TimerWheel::ClearOccupied(int32_t slot) {
+  occupied_[slot / kSlotsPerLevel][(slot % kSlotsPerLevel) / 64] &=
+      ~(uint64_t(1) << (slot % 64));
+}
+
+bool TimerWheel::Insert(Node* node, int64_t tick) {
+  node->tick = tick;
+  if (tick <= current_tick_) return false;
+  // The level is determined by the most significant bit in which `tick`
+  // differs from `current_tick_`.  Consequently, the slot index of `tick` at
+  // that level is greater than the slot index of `current_tick_`, and the
+  // node remains in the same slot until the current tick reaches the start of
+  // the slot.
+  const uint64_t diff =
+      static_cast<uint64_t>(tick) ^ static_cast<uint64_t>(current_tick_);
+  const int level = (63 - absl::countl_zero(diff)) / kBitsPerLevel;
+  int32_t slot;
+  if (level >= kNumLevels) {
+    slot = kOverflowSlot;
+  } else {
+    slot = level * kSlotsPerLevel +
+           static_cast<int32_t>((static_cast<uint64_t>(tick) >>
+                                 LevelShift(level)) &
+                                kSlotMask);
+    SetOccupied(slot);
+  }
+  node->slot = slot;
+  internal::intrusive_linked_list::InsertBefore(Accessor{}, &heads_[slot],
+                                                node);
+  ++size_;
+  return true;
+}
+
+void TimerWheel::Remove(Node* node) {
+  assert(node->in_wheel());
+  const int32_t slot = node->slot;
+  internal::intrusive_linked_list::Remove(Accessor{}, node);
+  node->slot = kNotInWheel;
+  if (slot != kOverflowSlot &&
+      internal::intrusive_linked_list::OnlyContainsNode(Accessor{},
+                                                        &heads_[slot])) {
+    ClearOccupied(slot);
+  }
+  --size_;
+}
+
+int64_t TimerWheel::NextEvent(int32_t& slot) const {
+  const uint64_t current = static_cast<uint64_t>(current_tick_);
+  // Events of lower levels always precede events of higher levels, since all
+  // slots of a level that are occupied lie within the span of the current
+  // slot of the next higher level.
+  for (int level = 0; level < kNumLevels; ++level) {
+    const uint64_t current_index = (current >> LevelShift(level)) & kSlotMask;
+    // Find the first occupied slot after `current_index`.
+    for (uint64_t word = current_index / 64; word < kWordsPerLevel; ++word) {
+      uint64_t bits = occupied_[level][word];
+      if (word == current_index / 64) {
+        const uint64_t bit = current_index % 64;
+        bits = (bit == 63) ? 0 : bits & (~uint64_t(0) << (bit + 1));
+      }
+      if (!bits) continue;
+      const uint64_t index = word * 64 + absl::countr_zero(bits);
+      slot = static_cast<int32_t>(level * kSlotsPerLevel + index);
+      const int shift = LevelShift(level);
+      return static_cast<int64_t>(
+          ((current >> (shift + kBitsPerLevel)) << (shift + kBitsPerLevel)) |
+          (index << shift));
+    }
+  }
+  const Node& overflow = heads_[kOverflowSlot];
+  if (overflow.next == &overflow) return kNever;
+  // The overflow list is redistributed at the start of the next span of the
+  // highest level.
+  slot = kOverflowSlot;
+  constexpr int kTotalBits = kNumLevels * kBitsPerLevel;
+  const uint64_t next_span = ((current >> kTotalBits) + 1) << kTotalBits;
+  return next_span > static_cast<uint64_t>(kNever)
+             ? kNever
+             : static_cast<int64_t>(next_span);
+}
+
+int64_t TimerWheel::NextEventTick() const {
+  int32_t slot;
+  return NextEvent(slot);
+}
+
+void TimerWheel::Advance(int64_t now, Node& expired) {
+  while (true) {
+    int32_t slot;
+    const int64_t next = NextEvent(slot);
+    if (next > now) break;
+    current_tick_ = next;
+    // Detach the list of the slot, and then either expire or redistribute its
+    // nodes.
+    Node& head = heads_[slot];
+    Node* node = head.next;
+    internal::intrusive_linked_list::Initialize(Accessor{}, &head);
+    if (slot != kOverflowSlot) ClearOccupied(slot);
+    while (node != &head) {
+      Node* next_node = node->next;
+      node->slot = kNotInWheel;
+      --size_;
+      if (!Insert(node, node->tick)) {
+        internal::intrusive_linked_list::InsertBefore(Accessor{}, &expired,
+                                                      node);
+      }
+      node = next_node;
+    }
+  }
+  if (now > current_tick_) current_tick_ = now;
+}
+
+}  // namespace internal_thread_impl
+}  // namespace tensorstore
@@ -0,0 +1,125 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_THREAD_TIMER_WHEEL_H_
+#define TENSORSTORE_INTERNAL_THREAD_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+
+namespace tensorstore {
+namespace internal_thread_impl {
+
+/// Hierarchical timing wheel of intrusive timer nodes.
+///
+/// Time is measured in integer ticks.  Level ``l`` of the wheel has
+/// `kSlotsPerLevel` slots, each spanning ``kSlotsPerLevel**l`` ticks, and a
+/// timer is stored in the lowest level whose slots distinguish its expiry tick
+/// from the current tick.  Timers beyond the range of the highest level are
+/// stored in a separate overflow list.  As the current tick advances past the
+/// start of a higher-level slot, its timers are redistributed ("cascaded") to
+/// lower levels.
+///
+/// `Insert` and `Remove` take constant time, and `Advance` takes time
+/// proportional to the number of expired and cascaded timers, independent of
+/// the number of ticks elapsed.  Timers that expire at the same tick are
+/// returned together, which allows wakeups to be coalesced.
+///
+/// This class is not thread safe.
+class TimerWheel {
+ public:
+  constexpr static int kBitsPerLevel = 8;
+  constexpr static int kSlotsPerLevel = 1 << kBitsPerLevel;
+  constexpr static int kNumLevels = 4;
+
+  /// Tick value indicating that there is no next event.
+  constexpr static int64_t kNever = std::numeric_limits<int64_t>::max();
+
+  /// Base class of timers.  The `prev` and `next` pointers form a circular
+  /// doubly-linked list, compatible with
+  /// `internal::intrusive_linked_list::MemberAccessor`, which may also be used
+  /// to hold nodes that are not in the wheel.
+  struct Node {
+    Node* prev = nullptr;
+    Node* next = nullptr;
+
+    /// Expiry tick.
+    int64_t tick = 0;
+
+    /// Index of the containing slot, `kOverflowSlot`, or `kNotInWheel`.
+    int32_t slot = kNotInWheel;
+
+    /// Returns `true` if the node is currently contained in a `TimerWheel`.
+    bool in_wheel() const { return slot != kNotInWheel; }
+  };
+
+  explicit TimerWheel(int64_t current_tick = 0);
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /// Returns the current tick.
+  int64_t current_tick() const { return current_tick_; }
+
+  /// Returns the number of timers in the wheel.
+  size_t size() const { return size_; }
+
+  /// Inserts `node` to expire at `tick`.
+  ///
+  /// \returns `false`, without inserting `node`, if
+  ///     `tick <= current_tick()`.
+  bool Insert(Node* node, int64_t tick);
+
+  /// Removes `node`, which must be contained in this wheel.
+  void Remove(Node* node);
+
+  /// Returns the tick at which `Advance` must next be called, either to
+  /// expire or to cascade timers, or `kNever` if the wheel is empty.
+  ///
+  /// This is never later than the earliest expiry tick.
+  int64_t NextEventTick() const;
+
+  /// Advances the current tick to `now`, and appends all timers with an expiry
+  /// tick `<= now` to the circular list with head node `expired`.
+  void Advance(int64_t now, Node& expired);
+
+ private:
+  constexpr static int32_t kOverflowSlot = kSlotsPerLevel * kNumLevels;
+  constexpr static int32_t kNotInWheel = -1;
+  constexpr static int kWordsPerLevel = kSlotsPerLevel / 64;
+
+  /// Returns the next event tick and sets `slot` to the slot to process, or
+  /// `kOverflowSlot`.
+  int64_t NextEvent(int32_t& slot) const;
+
+  void SetOccupied(int32_t slot);
+  void ClearOccupied(int32_t slot);
+
+  int64_t current_tick_;
+  size_t size_ = 0;
+
+  /// Head nodes of the slot lists, indexed by ``level * kSlotsPerLevel +
+  /// index``, followed by the overflow list.
+  Node heads_[kOverflowSlot + 1];
+
+  /// Bit vector of non-empty slots for each level.
+  uint64_t occupied_[kNumLevels][kWordsPerLevel] = {};
+};
+
+}  // namespace internal_thread_impl
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_THREAD_TIMER_WHEEL_H_
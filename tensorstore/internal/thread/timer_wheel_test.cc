@@ -0,0 +1,127 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/thread/timer_wheel.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/random/random.h"
+#include "tensorstore/internal/container/intrusive_linked_list.h"
+
+namespace {
+
+using ::tensorstore::internal_thread_impl::TimerWheel;
+using Accessor = ::tensorstore::internal::intrusive_linked_list::MemberAccessor<
+    TimerWheel::Node>;
+
+// Advances `wheel` to `now` and returns the expiry ticks of the expired nodes.
+std::vector<int64_t> Advance(TimerWheel& wheel, int64_t now) {
+  TimerWheel::Node expired;
+  tensorstore::internal::intrusive_linked_list::Initialize(Accessor{},
+                                                           &expired);
+  wheel.Advance(now, expired);
+  std::vector<int64_t> ticks;
+  for (auto* node = expired.next; node != &expired; node = node->next) {
+    EXPECT_FALSE(node->in_wheel());
+    EXPECT_LE(node->tick, now);
+    ticks.push_back(node->tick);
+  }
+  return ticks;
+}
+
+TEST(TimerWheelTest, Basic) {
+  TimerWheel wheel(1000);
+  EXPECT_EQ(TimerWheel::kNever, wheel.NextEventTick());
+  TimerWheel::Node a, b, c;
+  EXPECT_FALSE(wheel.Insert(&a, 1000));
+  EXPECT_FALSE(a.in_wheel());
+  EXPECT_TRUE(wheel.Insert(&a, 1005));
+  EXPECT_TRUE(wheel.Insert(&b, 1005));
+  EXPECT_TRUE(wheel.Insert(&c, 1010));
+  EXPECT_EQ(3, wheel.size());
+  EXPECT_EQ(1005, wheel.NextEventTick());
+  EXPECT_THAT(Advance(wheel, 1004), ::testing::IsEmpty());
+  EXPECT_EQ(1004, wheel.current_tick());
+  // Timers expiring at the same tick are returned together.
+  EXPECT_THAT(Advance(wheel, 1007), ::testing::ElementsAre(1005, 1005));
+  EXPECT_EQ(1007, wheel.current_tick());
+  EXPECT_EQ(1010, wheel.NextEventTick());
+  EXPECT_THAT(Advance(wheel, 2000), ::testing::ElementsAre(1010));
+  EXPECT_EQ(0, wheel.size());
+}
+
+TEST(TimerWheelTest, Remove) {
+  TimerWheel wheel;
+  TimerWheel::Node a, b;
+  ASSERT_TRUE(wheel.Insert(&a, 100000));
+  ASSERT_TRUE(wheel.Insert(&b, 200000));
+  wheel.Remove(&a);
+  EXPECT_FALSE(a.in_wheel());
+  EXPECT_EQ(1, wheel.size());
+  EXPECT_THAT(Advance(wheel, 300000), ::testing::ElementsAre(200000));
+  EXPECT_EQ(TimerWheel::kNever, wheel.NextEventTick());
+}
+
+TEST(TimerWheelTest, Overflow) {
+  TimerWheel wheel;
+  TimerWheel::Node a, never;
+  const int64_t far = int64_t(1) << 40;
+  ASSERT_TRUE(wheel.Insert(&a, far));
+  ASSERT_TRUE(wheel.Insert(&never, TimerWheel::kNever));
+  EXPECT_LE(wheel.NextEventTick(), far);
+  EXPECT_THAT(Advance(wheel, far - 1), ::testing::IsEmpty());
+  EXPECT_EQ(far, wheel.NextEventTick());
+  EXPECT_THAT(Advance(wheel, far), ::testing::ElementsAre(far));
+  EXPECT_EQ(1, wheel.size());
+  wheel.Remove(&never);
+}
+
+TEST(TimerWheelTest, Random) {
+  absl::BitGen gen;
+  TimerWheel wheel(12345);
+  std::vector<TimerWheel::Node> nodes(10000);
+  std::vector<int64_t> expected;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const int64_t tick =
+        12345 + absl::LogUniform<int64_t>(gen, 1, int64_t(1) << 36);
+    ASSERT_TRUE(wheel.Insert(&nodes[i], tick));
+    if (i % 3 == 0) {
+      wheel.Remove(&nodes[i]);
+    } else {
+      expected.push_back(tick);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  std::vector<int64_t> actual;
+  int64_t now = 12345;
+  while (wheel.size()) {
+    const int64_t next = wheel.NextEventTick();
+    ASSERT_GT(next, wheel.current_tick());
+    now = std::max(now, next) + absl::Uniform<int64_t>(gen, 0, 1000);
+    for (int64_t tick : Advance(wheel, now)) {
+      // Timers must not expire late.
+      EXPECT_GT(tick, now - 1000 - 1);
+      actual.push_back(tick);
+    }
+  }
+  std::sort(actual.begin(), actual.end());
+  EXPECT_EQ(expected, actual);
+}
+
+}  // namespace
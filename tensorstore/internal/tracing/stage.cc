@@ -0,0 +1,182 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/tracing/stage.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else  // !_WIN32
+#include <time.h>
+#endif  // _WIN32
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "tensorstore/internal/env.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/metadata.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+namespace {
+
+auto& stage_cpu_seconds = internal_metrics::Counter<double, std::string>::New(
+    "/tensorstore/stage/cpu_seconds", "stage",
+    internal_metrics::MetricMetadata(
+        "Thread CPU time attributed to each pipeline stage",
+        internal_metrics::Units::kSeconds));
+
+// Accumulated CPU time is flushed to `stage_cpu_seconds` once it reaches this
+// threshold, to avoid contention on the shared counter cells.
+constexpr int64_t kFlushThresholdNs = 1000000;
+
+struct ThreadStageState {
+  Stage stage = Stage::kNone;
+  // Thread CPU time at the last transition.
+  int64_t last_cpu_ns = 0;
+  // CPU time per stage not yet flushed to `stage_cpu_seconds`.
+  int64_t pending_ns[kNumStages] = {};
+};
+
+thread_local ThreadStageState thread_stage_state;
+
+std::atomic<StageChangeCallback> stage_change_callback{nullptr};
+
+bool CpuAccountingEnabled() {
+  static const bool enabled =
+      internal::GetEnvValue<bool>("TENSORSTORE_STAGE_CPU_ACCOUNTING")
+          .value_or(true);
+  return enabled;
+}
+
+int64_t ThreadCpuNanos() {
+#ifdef _WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!::GetThreadTimes(::GetCurrentThread(), &creation_time, &exit_time,
+                        &kernel_time, &user_time)) {
+    return 0;
+  }
+  const auto to_100ns = [](const FILETIME& t) {
+    return (static_cast<int64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+  };
+  return (to_100ns(kernel_time) + to_100ns(user_time)) * 100;
+#else
+  struct timespec ts;
+  if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+internal_metrics::CounterCell<double>& GetStageCell(size_t stage) {
+  static const auto cells = [] {
+    std::array<internal_metrics::CounterCell<double>*, kNumStages> cells;
+    for (size_t i = 0; i < kNumStages; ++i) {
+      cells[i] = &stage_cpu_seconds.GetCell(
+          std::string(StageName(static_cast<Stage>(i))));
+    }
+    return cells;
+  }();
+  return *cells[stage];
+}
+
+void FlushStage(ThreadStageState& state, size_t stage) {
+  int64_t& pending = state.pending_ns[stage];
+  if (pending == 0) return;
+  GetStageCell(stage).IncrementBy(static_cast<double>(pending) * 1e-9);
+  pending = 0;
+}
+
+void Transition(Stage next) {
+  auto& state = thread_stage_state;
+  const Stage previous = state.stage;
+  if (CpuAccountingEnabled()) {
+    const int64_t now = ThreadCpuNanos();
+    if (previous != Stage::kNone) {
+      const size_t i = static_cast<size_t>(previous);
+      state.pending_ns[i] += now - state.last_cpu_ns;
+      if (state.pending_ns[i] >= kFlushThresholdNs) FlushStage(state, i);
+    }
+    state.last_cpu_ns = now;
+  }
+  state.stage = next;
+  // Ensures a signal handler on this thread observes the new stage.
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  if (auto callback = stage_change_callback.load(std::memory_order_acquire)) {
+    callback(previous, next);
+  }
+}
+
+}  // namespace
+
+std::string_view StageName(Stage stage) {
+  switch (stage) {
+    case Stage::kNone:
+      return "none";
+    case Stage::kDecode:
+      return "decode";
+    case Stage::kEncode:
+      return "encode";
+    case Stage::kCopy:
+      return "copy";
+    case Stage::kIndexTransform:
+      return "index_transform";
+    case Stage::kJson:
+      return "json";
+    case Stage::kHttp:
+      return "http";
+  }
+  return "unknown";
+}
+
+Stage CurrentStage() {
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  return thread_stage_state.stage;
+}
+
+void SetStageChangeCallback(StageChangeCallback callback) {
+  stage_change_callback.store(callback, std::memory_order_release);
+}
+
+StageScope::StageScope(Stage stage) : previous_(thread_stage_state.stage) {
+  changed_ = (stage != previous_);
+  if (changed_) Transition(stage);
+}
+
+StageScope::~StageScope() {
+  if (changed_) Transition(previous_);
+}
+
+void FlushStageCpuTime() {
+  auto& state = thread_stage_state;
+  if (state.stage != Stage::kNone && CpuAccountingEnabled()) {
+    // Charge the time spent so far in the current stage.
+    const int64_t now = ThreadCpuNanos();
+    state.pending_ns[static_cast<size_t>(state.stage)] +=
+        now - state.last_cpu_ns;
+    state.last_cpu_ns = now;
+  }
+  for (size_t i = 0; i < kNumStages; ++i) FlushStage(state, i);
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
@@ -0,0 +1,119 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_STAGE_H_
+#define TENSORSTORE_INTERNAL_TRACING_STAGE_H_
+
+/// \file
+///
+/// Attribution of CPU time to pipeline stages.
+///
+/// Code that performs a CPU-heavy step, such as chunk decoding or an
+/// `NDIterable` copy, marks it with a `StageScope`.  Each thread tracks its
+/// current stage, and the thread CPU time spent between stage transitions is
+/// exported as the `/tensorstore/stage/cpu_seconds` counter, labeled by stage.
+/// Time is attributed exclusively: while a nested scope is active, CPU time is
+/// charged only to the innermost stage.  CPU time outside of any scope is not
+/// exported.
+///
+/// Sampling profilers can attribute samples to stages as well:
+///
+/// - `CurrentStage` is async-signal-safe, so a `SIGPROF` handler (as used by
+///   gperftools/pprof) may record it along with each sample.
+///
+/// - `SetStageChangeCallback` registers a function that is invoked on every
+///   transition, e.g. to set profiler labels or emit perf/USDT markers.
+///
+/// CPU accounting may be disabled by setting the environment variable
+/// `TENSORSTORE_STAGE_CPU_ACCOUNTING=0`, in which case a `StageScope` only
+/// updates the thread-local stage marker.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+
+namespace tensorstore {
+namespace internal_tracing {
+
+/// Pipeline stage to which CPU time is attributed.
+enum class Stage : uint8_t {
+  /// Not within any stage.
+  kNone = 0,
+  /// Decoding of stored chunks into arrays.
+  kDecode,
+  /// Encoding of arrays into stored chunks.
+  kEncode,
+  /// Copying between arrays, chunks and user buffers.
+  kCopy,
+  /// Composing and partitioning index transforms.
+  kIndexTransform,
+  /// Parsing JSON.
+  kJson,
+  /// Driving HTTP transfers.
+  kHttp,
+};
+
+constexpr size_t kNumStages = 7;
+
+/// Returns the name of `stage`, used as the metric label, e.g. "decode".
+std::string_view StageName(Stage stage);
+
+/// Returns the current stage of the calling thread.
+///
+/// This is async-signal-safe.
+Stage CurrentStage();
+
+/// Function invoked on the calling thread after its current stage changes.
+using StageChangeCallback = void (*)(Stage previous, Stage current);
+
+/// Sets the callback invoked on every stage transition, or clears it if
+/// `callback == nullptr`.
+void SetStageChangeCallback(StageChangeCallback callback);
+
+/// Sets the current stage of the calling thread for the lifetime of the
+/// scope, and restores the previous stage on destruction.
+///
+/// Example:
+///
+///     internal_tracing::StageScope stage(internal_tracing::Stage::kDecode);
+///
+/// Entering a scope for the stage that is already current has no cost beyond
+/// reading a thread-local variable.
+class StageScope {
+ public:
+  explicit StageScope(Stage stage);
+  ~StageScope();
+
+  StageScope(const StageScope&) = delete;
+  StageScope& operator=(const StageScope&) = delete;
+
+ private:
+  Stage previous_;
+  bool changed_;
+};
+
+/// Flushes the CPU time accumulated by the calling thread to the
+/// `/tensorstore/stage/cpu_seconds` counter.
+///
+/// CPU time is otherwise flushed in batches, to avoid contention on the
+/// counter; this is intended for tests and for threads that are about to
+/// exit.
+void FlushStageCpuTime();
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_STAGE_H_
@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/tracing/stage.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/registry.h"
+
+namespace {
+
+using ::tensorstore::internal_tracing::CurrentStage;
+using ::tensorstore::internal_tracing::FlushStageCpuTime;
+using ::tensorstore::internal_tracing::SetStageChangeCallback;
+using ::tensorstore::internal_tracing::Stage;
+using ::tensorstore::internal_tracing::StageName;
+using ::tensorstore::internal_tracing::StageScope;
+
+double GetStageCpuSeconds(std::string_view stage) {
+  auto metric = tensorstore::internal_metrics::GetMetricRegistry().Collect(
+      "/tensorstore/stage/cpu_seconds");
+  if (metric) {
+    for (const auto& value : metric->values) {
+      if (value.fields == std::vector<std::string>{std::string(stage)}) {
+        return std::get<double>(value.value);
+      }
+    }
+  }
+  return 0;
+}
+
+// Consumes CPU time on the calling thread.
+void Spin(absl::Duration duration) {
+  const absl::Time end = absl::Now() + duration;
+  volatile int x = 0;
+  while (absl::Now() < end) {
+    for (int i = 0; i < 1000; ++i) x = x + i;
+  }
+}
+
+TEST(StageTest, Name) {
+  EXPECT_EQ("decode", StageName(Stage::kDecode));
+  EXPECT_EQ("index_transform", StageName(Stage::kIndexTransform));
+}
+
+TEST(StageTest, NestedScopes) {
+  EXPECT_EQ(Stage::kNone, CurrentStage());
+  {
+    StageScope decode(Stage::kDecode);
+    EXPECT_EQ(Stage::kDecode, CurrentStage());
+    {
+      StageScope copy(Stage::kCopy);
+      EXPECT_EQ(Stage::kCopy, CurrentStage());
+      StageScope copy_again(Stage::kCopy);
+      EXPECT_EQ(Stage::kCopy, CurrentStage());
+    }
+    EXPECT_EQ(Stage::kDecode, CurrentStage());
+  }
+  EXPECT_EQ(Stage::kNone, CurrentStage());
+}
+
+std::vector<std::pair<Stage, Stage>> transitions;
+
+TEST(StageTest, ChangeCallback) {
+  transitions.clear();
+  SetStageChangeCallback([](Stage previous, Stage current) {
+    transitions.emplace_back(previous, current);
+  });
+  {
+    StageScope json(Stage::kJson);
+    StageScope json_again(Stage::kJson);
+  }
+  SetStageChangeCallback(nullptr);
+  EXPECT_THAT(transitions, ::testing::ElementsAre(
+                               std::pair(Stage::kNone, Stage::kJson),
+                               std::pair(Stage::kJson, Stage::kNone)));
+}
+
+TEST(StageTest, CpuSeconds) {
+  const double encode_before = GetStageCpuSeconds("encode");
+  const double http_before = GetStageCpuSeconds("http");
+  {
+    StageScope encode(Stage::kEncode);
+    Spin(absl::Milliseconds(20));
+    {
+      // Time in a nested scope is only attributed to the nested stage.
+      StageScope http(Stage::kHttp);
+      Spin(absl::Milliseconds(20));
+    }
+  }
+  FlushStageCpuTime();
+  const double encode_seconds = GetStageCpuSeconds("encode") - encode_before;
+  const double http_seconds = GetStageCpuSeconds("http") - http_before;
+  EXPECT_GT(encode_seconds, 0.005);
+  EXPECT_GT(http_seconds, 0.005);
+  EXPECT_LT(encode_seconds, 1);
+  EXPECT_LT(http_seconds, 1);
+}
+
+}  // namespace
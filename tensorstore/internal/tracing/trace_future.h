@@ -0,0 +1,48 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_INTERNAL_TRACING_TRACE_FUTURE_H_
+#define TENSORSTORE_INTERNAL_TRACING_TRACE_FUTURE_H_
+
+#include <utility>
+
+#include "tensorstore/internal/tracing/tracing.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+
+/// Ends `span` when `future` becomes ready, recording any error.
+///
+/// Returns `future` unchanged if `span` is not recorded.
+template <typename T>
+Future<T> EndSpanWhenReady(Span span, Future<T> future) {
+  if (!span.active()) return future;
+  return PromiseFuturePair<T>::Link(
+             [span = std::move(span)](Promise<T> promise,
+                                      ReadyFuture<T> ready) mutable {
+               if (!ready.result().status().ok()) {
+                 span.SetError(ready.result().status().ToString());
+               }
+               span.End();
+               promise.SetResult(ready.result());
+             },
+             std::move(future))
+      .future;
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRACING_TRACE_FUTURE_H_
@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/tracing.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/random/random.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+
+namespace tensorstore {
+namespace internal_tracing {
+namespace {
+
+struct ExporterState {
+  absl::Mutex mutex;
+  std::shared_ptr<TraceExporter> exporter ABSL_GUARDED_BY(mutex);
+};
+
+ExporterState& GetExporterState() {
+  static absl::NoDestructor<ExporterState> state;
+  return *state;
+}
+
+// Returns a random non-zero id.
+uint64_t NewId() {
+  thread_local absl::InsecureBitGen gen;
+  uint64_t id;
+  do {
+    id = absl::Uniform<uint64_t>(gen);
+  } while (id == 0);
+  return id;
+}
+
+}  // namespace
+
+TraceExporter::~TraceExporter() = default;
+
+void SetTraceExporter(std::shared_ptr<TraceExporter> exporter) {
+  auto& state = GetExporterState();
+  absl::MutexLock lock(&state.mutex);
+  internal::tracing_enabled.store(static_cast<bool>(exporter),
+                                  std::memory_order_relaxed);
+  state.exporter = std::move(exporter);
+}
+
+void Span::Start(std::string_view name) {
+  data_ = std::make_unique<SpanData>();
+  data_->name = std::string(name);
+  const SpanContext parent = internal::current_span_context;
+  if (parent.valid()) {
+    data_->context.trace_id = parent.trace_id;
+    data_->parent_span_id = parent.span_id;
+  } else {
+    data_->context.trace_id = NewId();
+  }
+  data_->context.span_id = NewId();
+  data_->start_time = absl::Now();
+}
+
+void Span::EndImpl() {
+  auto data = std::move(data_);
+  data->end_time = absl::Now();
+  std::shared_ptr<TraceExporter> exporter;
+  {
+    auto& state = GetExporterState();
+    absl::MutexLock lock(&state.mutex);
+    exporter = state.exporter;
+  }
+  if (exporter) exporter->Export(std::move(*data));
+}
+
+}  // namespace internal_tracing
+}  // namespace tensorstore
@@ -15,19 +15,188 @@
 #ifndef TENSORSTORE_INTERNAL_TRACING_TRACING_H_
 #define TENSORSTORE_INTERNAL_TRACING_TRACING_H_
 
+/// \file
+///
+/// Lightweight distributed tracing.
+///
+/// A `Span` records the start and end time of an operation, along with its
+/// parent span, and is reported to the `TraceExporter` registered with
+/// `SetTraceExporter` when it ends.  The current span of each thread is
+/// propagated automatically through `Future` callbacks, executors and
+/// `ScheduleAt`, which capture the `TraceContext` of the thread on which they
+/// are created, and install it while they run.
+///
+/// When no exporter is registered, creating a `Span` only checks an atomic
+/// flag.
+///
+/// TensorStore does not depend on a particular tracing backend; an exporter
+/// that forwards `SpanData` to e.g. OpenTelemetry may be registered by the
+/// application.
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
 
 namespace tensorstore {
 namespace internal_tracing {
 
+/// Identifies a span within a trace.
+///
+/// A default-constructed `SpanContext` (with a `trace_id` of `0`) is invalid
+/// and indicates that no span is active.
+struct SpanContext {
+  uint64_t trace_id = 0;
+  uint64_t span_id = 0;
+
+  bool valid() const { return trace_id != 0; }
+};
+
+/// Trace context propagated through asynchronous callbacks.
 struct TraceContext {
   struct ThreadInitType {};
   inline static constexpr ThreadInitType kThread{};
-  explicit TraceContext(ThreadInitType) {}
+
+  /// Captures the trace context of the current thread.
+  explicit TraceContext(ThreadInitType);
   TraceContext() = delete;
+
+  SpanContext span_context;
+};
+
+namespace internal {
+inline thread_local SpanContext current_span_context;
+inline std::atomic<bool> tracing_enabled{false};
+}  // namespace internal
+
+inline TraceContext::TraceContext(ThreadInitType)
+    : span_context(internal::current_span_context) {}
+
+/// Swaps the trace context of the current thread with `*context`.
+///
+/// Calling this a second time with the same `context` restores the prior
+/// context of the thread.
+inline void SwapCurrentTraceContext(TraceContext* context) {
+  std::swap(context->span_context, internal::current_span_context);
+}
+
+/// Returns the span context of the current thread.
+inline SpanContext GetCurrentSpanContext() {
+  return internal::current_span_context;
+}
+
+/// Returns `true` if a `TraceExporter` is registered.
+inline bool IsTracingEnabled() {
+  return internal::tracing_enabled.load(std::memory_order_relaxed);
+}
+
+/// Completed span reported to a `TraceExporter`.
+struct SpanData {
+  std::string name;
+  SpanContext context;
+  /// Span id of the parent span within the same trace, or `0` for a root span.
+  uint64_t parent_span_id = 0;
+  absl::Time start_time;
+  absl::Time end_time;
+  std::vector<std::pair<std::string, std::string>> attributes;
+  /// Error message if the operation failed, or empty on success.
+  std::string error;
 };
 
-inline void SwapCurrentTraceContext(TraceContext* context) {}
+/// Receives completed spans.
+///
+/// `Export` may be called concurrently from any thread, and must not block.
+class TraceExporter {
+ public:
+  virtual ~TraceExporter();
+  virtual void Export(SpanData span) = 0;
+};
+
+/// Registers `exporter` to receive all spans that end after this call.
+///
+/// Specify `nullptr` to disable tracing.
+void SetTraceExporter(std::shared_ptr<TraceExporter> exporter);
+
+/// Traces an operation.
+///
+/// If tracing is enabled when the `Span` is constructed, it becomes a child of
+/// the span of the current thread (or the root of a new trace), and is
+/// exported when `End` is called or the `Span` is destroyed.  Otherwise, all
+/// operations are no-ops.
+///
+/// Constructing a `Span` does not make it the current span; use `SpanScope`
+/// while starting child operations.
+class Span {
+ public:
+  Span() = default;
+  explicit Span(std::string_view name) {
+    if (IsTracingEnabled()) Start(name);
+  }
+
+  Span(Span&& other) = default;
+  Span& operator=(Span&& other) {
+    End();
+    data_ = std::move(other.data_);
+    return *this;
+  }
+
+  ~Span() { End(); }
+
+  /// Returns `true` if the span is recorded.
+  bool active() const { return static_cast<bool>(data_); }
+
+  SpanContext context() const {
+    return data_ ? data_->context : SpanContext{};
+  }
+
+  /// Adds an attribute, if the span is recorded.
+  void SetAttribute(std::string_view key, std::string_view value) {
+    if (data_) data_->attributes.emplace_back(key, value);
+  }
+
+  /// Records an error, if the span is recorded.
+  void SetError(std::string_view error) {
+    if (data_) data_->error = error;
+  }
+
+  /// Ends the span, if it has not already ended.
+  void End() {
+    if (data_) EndImpl();
+  }
+
+ private:
+  void Start(std::string_view name);
+  void EndImpl();
+  std::unique_ptr<SpanData> data_;
+};
+
+/// Makes `span` the current span of this thread for the lifetime of the
+/// `SpanScope`.
+class SpanScope {
+ public:
+  explicit SpanScope(const Span& span) {
+    if (span.active()) {
+      previous_ =
+          std::exchange(internal::current_span_context, span.context());
+      active_ = true;
+    }
+  }
+  ~SpanScope() {
+    if (active_) internal::current_span_context = previous_;
+  }
+  SpanScope(const SpanScope&) = delete;
+  SpanScope& operator=(const SpanScope&) = delete;
+
+ private:
+  SpanContext previous_;
+  bool active_ = false;
+};
 
 }  // namespace internal_tracing
 }  // namespace tensorstore
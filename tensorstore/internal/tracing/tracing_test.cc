@@ -0,0 +1,151 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/internal/tracing/tracing.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "tensorstore/internal/thread/thread_pool.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::ReadyFuture;
+using ::tensorstore::internal_tracing::EndSpanWhenReady;
+using ::tensorstore::internal_tracing::GetCurrentSpanContext;
+using ::tensorstore::internal_tracing::SetTraceExporter;
+using ::tensorstore::internal_tracing::Span;
+using ::tensorstore::internal_tracing::SpanData;
+using ::tensorstore::internal_tracing::SpanScope;
+using ::tensorstore::internal_tracing::TraceExporter;
+
+class TestExporter : public TraceExporter {
+ public:
+  void Export(SpanData span) override {
+    absl::MutexLock lock(&mutex_);
+    spans_.push_back(std::move(span));
+  }
+
+  std::vector<SpanData> spans() {
+    absl::MutexLock lock(&mutex_);
+    return spans_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<SpanData> spans_;
+};
+
+class TracingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SetTraceExporter(exporter_); }
+  void TearDown() override { SetTraceExporter(nullptr); }
+
+  std::shared_ptr<TestExporter> exporter_ = std::make_shared<TestExporter>();
+};
+
+TEST(TracingDisabledTest, SpansAreNotRecorded) {
+  Span span("a");
+  EXPECT_FALSE(span.active());
+  EXPECT_FALSE(span.context().valid());
+  SpanScope scope(span);
+  EXPECT_FALSE(GetCurrentSpanContext().valid());
+}
+
+TEST_F(TracingTest, NestedSpans) {
+  {
+    Span parent("parent");
+    ASSERT_TRUE(parent.active());
+    SpanScope scope(parent);
+    EXPECT_EQ(parent.context().span_id, GetCurrentSpanContext().span_id);
+    Span child("child");
+    child.SetAttribute("key", "value");
+  }
+  EXPECT_FALSE(GetCurrentSpanContext().valid());
+  auto spans = exporter_->spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("child", spans[0].name);
+  EXPECT_EQ("parent", spans[1].name);
+  EXPECT_EQ(spans[1].context.trace_id, spans[0].context.trace_id);
+  EXPECT_EQ(spans[1].context.span_id, spans[0].parent_span_id);
+  EXPECT_EQ(0, spans[1].parent_span_id);
+  EXPECT_THAT(spans[0].attributes,
+              ::testing::ElementsAre(::testing::Pair("key", "value")));
+  EXPECT_LE(spans[1].start_time, spans[1].end_time);
+}
+
+TEST_F(TracingTest, PropagatesThroughFutureCallback) {
+  auto pair = PromiseFuturePair<int>::Make();
+  Span parent("parent");
+  {
+    SpanScope scope(parent);
+    pair.future.ExecuteWhenReady(
+        [](ReadyFuture<int> future) { Span child("callback"); });
+  }
+  pair.promise.SetResult(1);
+  parent.End();
+  auto spans = exporter_->spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("callback", spans[0].name);
+  EXPECT_EQ(spans[1].context.span_id, spans[0].parent_span_id);
+}
+
+TEST_F(TracingTest, PropagatesThroughExecutor) {
+  auto executor = tensorstore::internal::DetachedThreadPool(1);
+  absl::Notification done;
+  Span parent("parent");
+  {
+    SpanScope scope(parent);
+    executor([&] {
+      { Span child("task"); }
+      done.Notify();
+    });
+  }
+  done.WaitForNotification();
+  parent.End();
+  auto spans = exporter_->spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("task", spans[0].name);
+  EXPECT_EQ(spans[1].context.span_id, spans[0].parent_span_id);
+}
+
+TEST_F(TracingTest, EndSpanWhenReady) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = EndSpanWhenReady(Span("op"), pair.future);
+  EXPECT_TRUE(exporter_->spans().empty());
+  pair.promise.SetResult(absl::UnknownError("failed"));
+  EXPECT_EQ(absl::UnknownError("failed"), future.status());
+  auto spans = exporter_->spans();
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ("op", spans[0].name);
+  EXPECT_THAT(spans[0].error, ::testing::HasSubstr("failed"));
+}
+
+TEST(TracingDisabledTest, EndSpanWhenReadyReturnsSameFuture) {
+  auto future = MakeReadyFuture<int>(1);
+  auto traced = EndSpanWhenReady(Span("op"), future);
+  EXPECT_TRUE(tensorstore::HaveSameSharedState(future, traced));
+}
+
+}  // namespace
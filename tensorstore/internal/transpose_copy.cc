@@ -0,0 +1,164 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/transpose_copy.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include "tensorstore/index.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+namespace {
+
+// Tile extent, in elements, along each of the two innermost dimensions.  A
+// tile of 8-byte elements accesses 16 rows of 128 bytes in each array.
+constexpr Index kTileSize = 16;
+
+// Two-dimensional plane in which `source` is contiguous along `j` and `dest`
+// is contiguous along `i`.
+struct Plane {
+  Index size_i;
+  Index size_j;
+  Index source_stride_i;
+  Index dest_stride_j;
+};
+
+template <size_t ElementSize>
+void CopyTransposedPlane(const Plane& plane, const char* source, char* dest) {
+  for (Index i0 = 0; i0 < plane.size_i; i0 += kTileSize) {
+    const Index i1 = std::min(plane.size_i, i0 + kTileSize);
+    for (Index j0 = 0; j0 < plane.size_j; j0 += kTileSize) {
+      const Index j1 = std::min(plane.size_j, j0 + kTileSize);
+      for (Index j = j0; j < j1; ++j) {
+        const char* source_ptr =
+            source + i0 * plane.source_stride_i + j * ElementSize;
+        char* dest_ptr = dest + j * plane.dest_stride_j + i0 * ElementSize;
+        for (Index i = i0; i < i1; ++i) {
+          std::memcpy(dest_ptr, source_ptr, ElementSize);
+          source_ptr += plane.source_stride_i;
+          dest_ptr += ElementSize;
+        }
+      }
+    }
+  }
+}
+
+// Iterates over the remaining (outer) dimensions, and copies each plane.
+template <size_t ElementSize>
+void CopyTransposedOuter(const Plane& plane, span<const Index> outer_shape,
+                         const Index* outer_source_strides,
+                         const Index* outer_dest_strides, const char* source,
+                         char* dest) {
+  if (outer_shape.empty()) {
+    CopyTransposedPlane<ElementSize>(plane, source, dest);
+    return;
+  }
+  for (Index k = 0; k < outer_shape[0]; ++k) {
+    CopyTransposedOuter<ElementSize>(
+        plane, outer_shape.subspan(1), outer_source_strides + 1,
+        outer_dest_strides + 1, source + k * outer_source_strides[0],
+        dest + k * outer_dest_strides[0]);
+  }
+}
+
+// Returns the dimension with a byte stride of `element_size`, preferring the
+// largest extent, or `-1` if there is none.
+DimensionIndex FindContiguousDimension(span<const Index> shape,
+                                       span<const Index> byte_strides,
+                                       size_t element_size) {
+  DimensionIndex result = -1;
+  for (DimensionIndex dim = 0; dim < shape.size(); ++dim) {
+    if (byte_strides[dim] == static_cast<Index>(element_size) &&
+        shape[dim] > 1 && (result == -1 || shape[dim] > shape[result])) {
+      result = dim;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+bool TryCopyTransposed(size_t element_size, span<const Index> shape,
+                       const void* source,
+                       span<const Index> source_byte_strides, void* dest,
+                       span<const Index> dest_byte_strides) {
+  assert(shape.size() == source_byte_strides.size());
+  assert(shape.size() == dest_byte_strides.size());
+  const DimensionIndex rank = shape.size();
+  if (rank < 2 || rank > kMaxRank) return false;
+  if (element_size != 1 && element_size != 2 && element_size != 4 &&
+      element_size != 8) {
+    return false;
+  }
+  const DimensionIndex source_inner_dim =
+      FindContiguousDimension(shape, source_byte_strides, element_size);
+  const DimensionIndex dest_inner_dim =
+      FindContiguousDimension(shape, dest_byte_strides, element_size);
+  if (source_inner_dim == -1 || dest_inner_dim == -1 ||
+      source_inner_dim == dest_inner_dim) {
+    return false;
+  }
+  Plane plane;
+  plane.size_i = shape[dest_inner_dim];
+  plane.size_j = shape[source_inner_dim];
+  plane.source_stride_i = source_byte_strides[dest_inner_dim];
+  plane.dest_stride_j = dest_byte_strides[source_inner_dim];
+
+  Index outer_shape[kMaxRank];
+  Index outer_source_strides[kMaxRank];
+  Index outer_dest_strides[kMaxRank];
+  DimensionIndex outer_rank = 0;
+  for (DimensionIndex dim = 0; dim < rank; ++dim) {
+    if (shape[dim] == 0) return true;
+    if (dim == source_inner_dim || dim == dest_inner_dim) continue;
+    outer_shape[outer_rank] = shape[dim];
+    outer_source_strides[outer_rank] = source_byte_strides[dim];
+    outer_dest_strides[outer_rank] = dest_byte_strides[dim];
+    ++outer_rank;
+  }
+
+  const auto copy = [&](auto element_size_constant) {
+    CopyTransposedOuter<decltype(element_size_constant)::value>(
+        plane, span<const Index>(outer_shape, outer_rank),
+        outer_source_strides, outer_dest_strides,
+        static_cast<const char*>(source), static_cast<char*>(dest));
+  };
+  switch (element_size) {
+    case 1:
+      copy(std::integral_constant<size_t, 1>{});
+      break;
+    case 2:
+      copy(std::integral_constant<size_t, 2>{});
+      break;
+    case 4:
+      copy(std::integral_constant<size_t, 4>{});
+      break;
+    default:
+      copy(std::integral_constant<size_t, 8>{});
+      break;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace tensorstore
@@ -0,0 +1,58 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_INTERNAL_TRANSPOSE_COPY_H_
+#define TENSORSTORE_INTERNAL_TRANSPOSE_COPY_H_
+
+#include <stddef.h>
+
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal {
+
+/// Copies an array of trivially-copyable elements between two strided layouts
+/// of the same shape that are transposed relative to each other.
+///
+/// A generic strided copy iterates in the order of one of the two layouts, and
+/// therefore accesses the other with a large stride in the innermost loop.
+/// This instead copies square tiles of the two-dimensional plane formed by the
+/// innermost dimensions of `source` and `dest`, such that each tile is read
+/// and written through a small number of cache lines.
+///
+/// The copy is performed only if `element_size` is 1, 2, 4, or 8 and the
+/// source and dest layouts each have a dimension, distinct from the other, with
+/// a byte stride equal to `element_size` and an extent of at least 2.
+///
+/// \param element_size Size in bytes of each element.
+/// \param shape Shape of the array.
+/// \param source Pointer to the source element at index vector `0`.
+/// \param source_byte_strides Byte strides of `source`.
+/// \param dest Pointer to the dest element at index vector `0`.  Must not
+///     overlap `source`.
+/// \param dest_byte_strides Byte strides of `dest`.
+/// \returns `true` if the copy was performed, or `false` if the layouts are not
+///     suitable, in which case nothing is copied and a generic strided copy
+///     should be used instead.
+bool TryCopyTransposed(size_t element_size, span<const Index> shape,
+                       const void* source,
+                       span<const Index> source_byte_strides, void* dest,
+                       span<const Index> dest_byte_strides);
+
+}  // namespace internal
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_INTERNAL_TRANSPOSE_COPY_H_
@@ -0,0 +1,114 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Compares `TryCopyTransposed` against the generic strided copy for 2-d and
+// 3-d transposes.
+//
+// BM_Transpose<Generic|Tiled>/<element_size>/<rank>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "tensorstore/array.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/index.h"
+#include "tensorstore/internal/elementwise_function.h"
+#include "tensorstore/internal/transpose_copy.h"
+#include "tensorstore/util/iterate.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::DataType;
+using ::tensorstore::Index;
+
+DataType GetDataType(int64_t element_size) {
+  switch (element_size) {
+    case 1:
+      return tensorstore::dtype_v<uint8_t>;
+    case 2:
+      return tensorstore::dtype_v<uint16_t>;
+    case 4:
+      return tensorstore::dtype_v<uint32_t>;
+    default:
+      return tensorstore::dtype_v<uint64_t>;
+  }
+}
+
+// Source array in c order, and a destination array in Fortran order, both of
+// which contain 16Mi elements.
+struct TransposeHelper {
+  explicit TransposeHelper(int64_t element_size, int64_t rank) {
+    std::vector<Index> shape =
+        rank == 2 ? std::vector<Index>{4096, 4096}
+                  : std::vector<Index>{256, 256, 256};
+    auto dtype = GetDataType(element_size);
+    source = tensorstore::AllocateArray(shape, tensorstore::c_order,
+                                        tensorstore::value_init, dtype);
+    dest = tensorstore::AllocateArray(shape, tensorstore::fortran_order,
+                                      tensorstore::value_init, dtype);
+  }
+
+  int64_t total_bytes() const {
+    return source.num_elements() * source.dtype().size();
+  }
+
+  tensorstore::SharedArray<void> source;
+  tensorstore::SharedArray<void> dest;
+};
+
+void BM_TransposeGeneric(benchmark::State& state) {
+  TransposeHelper helper(state.range(0), state.range(1));
+  for (auto s : state) {
+    tensorstore::internal::IterateOverArrays(
+        {&helper.source.dtype()->copy_assign, nullptr},
+        /*arg=*/nullptr, tensorstore::skip_repeated_elements,
+        tensorstore::ArrayView<const void>(helper.source),
+        tensorstore::ArrayView<void>(helper.dest));
+    benchmark::DoNotOptimize(helper.dest.data());
+  }
+  state.SetBytesProcessed(state.iterations() * helper.total_bytes());
+}
+
+void BM_TransposeTiled(benchmark::State& state) {
+  TransposeHelper helper(state.range(0), state.range(1));
+  for (auto s : state) {
+    bool copied = tensorstore::internal::TryCopyTransposed(
+        helper.source.dtype().size(), helper.source.shape(),
+        helper.source.data(), helper.source.byte_strides(), helper.dest.data(),
+        helper.dest.byte_strides());
+    benchmark::DoNotOptimize(copied);
+    benchmark::DoNotOptimize(helper.dest.data());
+  }
+  state.SetBytesProcessed(state.iterations() * helper.total_bytes());
+}
+
+template <typename Bench>
+void DefineArgs(Bench* bench) {
+  for (int element_size : {1, 2, 4, 8}) {
+    for (int rank : {2, 3}) {
+      bench->Args({element_size, rank});
+    }
+  }
+}
+
+BENCHMARK(BM_TransposeGeneric)->Apply(DefineArgs);
+BENCHMARK(BM_TransposeTiled)->Apply(DefineArgs);
+
+}  // namespace
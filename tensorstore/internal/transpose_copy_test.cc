@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/internal/transpose_copy.h"
+
+#include <stddef.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/index.h"
+#include "tensorstore/util/span.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::span;
+using ::tensorstore::internal::TryCopyTransposed;
+
+// Returns the c-order byte strides for `shape` after permuting the dimensions
+// by `order`, where `order[0]` is the outermost dimension.
+std::vector<Index> GetPermutedByteStrides(span<const Index> shape,
+                                          span<const size_t> order,
+                                          size_t element_size) {
+  std::vector<Index> byte_strides(shape.size());
+  Index stride = element_size;
+  for (size_t i = order.size(); i--;) {
+    byte_strides[order[i]] = stride;
+    stride *= shape[order[i]];
+  }
+  return byte_strides;
+}
+
+// Returns the byte offset of `indices` in a layout with `byte_strides`.
+Index GetOffset(span<const Index> indices, span<const Index> byte_strides) {
+  Index offset = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    offset += indices[i] * byte_strides[i];
+  }
+  return offset;
+}
+
+void TestTranspose(std::vector<Index> shape, std::vector<size_t> source_order,
+                   std::vector<size_t> dest_order, size_t element_size) {
+  SCOPED_TRACE(::testing::Message() << "element_size=" << element_size);
+  Index num_elements = 1;
+  for (Index s : shape) num_elements *= s;
+  const auto source_byte_strides =
+      GetPermutedByteStrides(shape, source_order, element_size);
+  const auto dest_byte_strides =
+      GetPermutedByteStrides(shape, dest_order, element_size);
+  std::vector<unsigned char> source(num_elements * element_size);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<unsigned char>(i * 7 + 3);
+  }
+  std::vector<unsigned char> dest(source.size());
+  ASSERT_TRUE(TryCopyTransposed(element_size, shape, source.data(),
+                                source_byte_strides, dest.data(),
+                                dest_byte_strides));
+  std::vector<Index> indices(shape.size());
+  for (Index i = 0; i < num_elements; ++i) {
+    Index remainder = i;
+    for (size_t dim = shape.size(); dim--;) {
+      indices[dim] = remainder % shape[dim];
+      remainder /= shape[dim];
+    }
+    ASSERT_EQ(0, std::memcmp(&dest[GetOffset(indices, dest_byte_strides)],
+                             &source[GetOffset(indices, source_byte_strides)],
+                             element_size))
+        << "i=" << i;
+  }
+}
+
+TEST(TryCopyTransposedTest, TwoDimensional) {
+  for (size_t element_size : {1, 2, 4, 8}) {
+    TestTranspose({37, 53}, {0, 1}, {1, 0}, element_size);
+    TestTranspose({16, 16}, {1, 0}, {0, 1}, element_size);
+  }
+}
+
+TEST(TryCopyTransposedTest, ThreeDimensional) {
+  for (size_t element_size : {1, 2, 4, 8}) {
+    TestTranspose({5, 19, 33}, {0, 1, 2}, {2, 1, 0}, element_size);
+    TestTranspose({5, 19, 33}, {0, 1, 2}, {1, 2, 0}, element_size);
+    TestTranspose({5, 19, 33}, {2, 0, 1}, {0, 1, 2}, element_size);
+  }
+}
+
+TEST(TryCopyTransposedTest, Unsuitable) {
+  std::vector<unsigned char> source(64), dest(64);
+  const Index shape[] = {4, 4};
+  // Same innermost dimension.
+  EXPECT_FALSE(TryCopyTransposed(4, shape, source.data(), {{16, 4}},
+                                 dest.data(), {{16, 4}}));
+  // Unsupported element size.
+  EXPECT_FALSE(TryCopyTransposed(3, shape, source.data(), {{12, 3}},
+                                 dest.data(), {{3, 12}}));
+  // No contiguous dimension.
+  EXPECT_FALSE(TryCopyTransposed(2, shape, source.data(), {{16, 4}},
+                                 dest.data(), {{2, 8}}));
+  // Rank 1.
+  EXPECT_FALSE(TryCopyTransposed(4, span<const Index>(shape, 1),
+                                 source.data(), {{4}}, dest.data(), {{4}}));
+}
+
+}  // namespace
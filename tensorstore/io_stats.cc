@@ -0,0 +1,115 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/io_stats.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <tuple>
+
+namespace tensorstore {
+
+struct IoStats::Impl {
+  std::atomic<int64_t> kvstore_reads{0};
+  std::atomic<int64_t> bytes_read{0};
+  std::atomic<int64_t> kvstore_writes{0};
+  std::atomic<int64_t> bytes_written{0};
+  std::atomic<int64_t> cache_hits{0};
+  std::atomic<int64_t> cache_misses{0};
+  std::atomic<int64_t> bytes_decoded{0};
+  std::atomic<int64_t> bytes_encoded{0};
+};
+
+namespace {
+void Add(std::atomic<int64_t>& counter, int64_t value) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+int64_t Load(const std::atomic<int64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+auto Tie(const IoStats::Counters& x) {
+  return std::tie(x.kvstore_reads, x.bytes_read, x.kvstore_writes,
+                  x.bytes_written, x.cache_hits, x.cache_misses,
+                  x.bytes_decoded, x.bytes_encoded);
+}
+}  // namespace
+
+IoStats IoStats::New() {
+  IoStats stats;
+  stats.impl_ = std::make_shared<Impl>();
+  return stats;
+}
+
+IoStats::Counters IoStats::Get() const {
+  Counters counters;
+  if (!impl_) return counters;
+  counters.kvstore_reads = Load(impl_->kvstore_reads);
+  counters.bytes_read = Load(impl_->bytes_read);
+  counters.kvstore_writes = Load(impl_->kvstore_writes);
+  counters.bytes_written = Load(impl_->bytes_written);
+  counters.cache_hits = Load(impl_->cache_hits);
+  counters.cache_misses = Load(impl_->cache_misses);
+  counters.bytes_decoded = Load(impl_->bytes_decoded);
+  counters.bytes_encoded = Load(impl_->bytes_encoded);
+  return counters;
+}
+
+void IoStats::RecordKvstoreRead(int64_t bytes) const {
+  if (!impl_) return;
+  Add(impl_->kvstore_reads, 1);
+  Add(impl_->bytes_read, bytes);
+}
+
+void IoStats::RecordKvstoreWrite(int64_t bytes) const {
+  if (!impl_) return;
+  Add(impl_->kvstore_writes, 1);
+  Add(impl_->bytes_written, bytes);
+}
+
+void IoStats::RecordCacheHit() const {
+  if (impl_) Add(impl_->cache_hits, 1);
+}
+
+void IoStats::RecordCacheMiss() const {
+  if (impl_) Add(impl_->cache_misses, 1);
+}
+
+void IoStats::RecordDecode(int64_t encoded_bytes) const {
+  if (impl_) Add(impl_->bytes_decoded, encoded_bytes);
+}
+
+void IoStats::RecordEncode(int64_t encoded_bytes) const {
+  if (impl_) Add(impl_->bytes_encoded, encoded_bytes);
+}
+
+bool operator==(const IoStats::Counters& a, const IoStats::Counters& b) {
+  return Tie(a) == Tie(b);
+}
+
+std::ostream& operator<<(std::ostream& os, const IoStats::Counters& x) {
+  return os << "{kvstore_reads=" << x.kvstore_reads
+            << ", bytes_read=" << x.bytes_read
+            << ", kvstore_writes=" << x.kvstore_writes
+            << ", bytes_written=" << x.bytes_written
+            << ", cache_hits=" << x.cache_hits
+            << ", cache_misses=" << x.cache_misses
+            << ", bytes_decoded=" << x.bytes_decoded
+            << ", bytes_encoded=" << x.bytes_encoded << "}";
+}
+
+}  // namespace tensorstore
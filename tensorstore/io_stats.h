@@ -0,0 +1,114 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_IO_STATS_H_
+#define TENSORSTORE_IO_STATS_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <memory>
+
+namespace tensorstore {
+
+/// Collects the storage cost of the operations to which it is attached.
+///
+/// An `IoStats` collector is attached to a `tensorstore::Read` or
+/// `tensorstore::Write` operation by passing it as an option, and is updated by
+/// the driver, chunk cache and kvstore layers as the operation proceeds.  This
+/// allows read and write amplification to be determined for an individual
+/// request, which is not possible from the process-wide metrics.
+///
+/// The counters are final once the future returned by the operation becomes
+/// ready; for writes, the kvstore counters are final once the write is
+/// committed.
+///
+/// Copies of an `IoStats` object refer to the same counters, and the same
+/// collector may be attached to any number of concurrent operations.
+///
+/// Example::
+///
+///     auto stats = tensorstore::IoStats::New();
+///     TENSORSTORE_ASSIGN_OR_RETURN(auto array,
+///                                  tensorstore::Read(store, stats).result());
+///     std::cout << stats.Get() << std::endl;
+///
+/// \ingroup core
+class IoStats {
+ public:
+  /// Snapshot of the collected counters.
+  struct Counters {
+    /// Number of kvstore read requests issued.
+    int64_t kvstore_reads = 0;
+
+    /// Number of bytes returned by kvstore reads.
+    int64_t bytes_read = 0;
+
+    /// Number of kvstore writes issued, including writeback of cached chunks.
+    int64_t kvstore_writes = 0;
+
+    /// Number of bytes submitted to kvstore writes.
+    int64_t bytes_written = 0;
+
+    /// Number of chunk reads satisfied without issuing a new kvstore read,
+    /// either from cached data or by sharing a read already in progress.
+    int64_t cache_hits = 0;
+
+    /// Number of chunk reads that required a new kvstore read.
+    int64_t cache_misses = 0;
+
+    /// Number of encoded bytes decoded into chunks.
+    int64_t bytes_decoded = 0;
+
+    /// Number of encoded bytes produced when writing back chunks.
+    int64_t bytes_encoded = 0;
+
+    friend bool operator==(const Counters& a, const Counters& b);
+    friend bool operator!=(const Counters& a, const Counters& b) {
+      return !(a == b);
+    }
+    friend std::ostream& operator<<(std::ostream& os, const Counters& x);
+  };
+
+  /// Constructs a null collector, which records nothing.
+  IoStats() = default;
+
+  /// Returns a new collector, with all counters zero.
+  static IoStats New();
+
+  /// Returns `true` if this is not a null collector.
+  explicit operator bool() const { return static_cast<bool>(impl_); }
+
+  /// Returns the current values of the counters.  Returns all zeros for a null
+  /// collector.
+  Counters Get() const;
+
+  /// Functions used by the driver, cache and kvstore layers to record costs.
+  /// Each is a no-op for a null collector.
+  void RecordKvstoreRead(int64_t bytes) const;
+  void RecordKvstoreWrite(int64_t bytes) const;
+  void RecordCacheHit() const;
+  void RecordCacheMiss() const;
+  void RecordDecode(int64_t encoded_bytes) const;
+  void RecordEncode(int64_t encoded_bytes) const;
+
+ private:
+  struct Impl;
+  std::shared_ptr<Impl> impl_;
+};
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_IO_STATS_H_
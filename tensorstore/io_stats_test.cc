@@ -0,0 +1,66 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/io_stats.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::IoStats;
+
+TEST(IoStatsTest, NullCollectorRecordsNothing) {
+  IoStats stats;
+  EXPECT_FALSE(stats);
+  stats.RecordKvstoreRead(10);
+  stats.RecordCacheHit();
+  EXPECT_EQ(IoStats::Counters{}, stats.Get());
+}
+
+TEST(IoStatsTest, Record) {
+  auto stats = IoStats::New();
+  EXPECT_TRUE(stats);
+  stats.RecordKvstoreRead(10);
+  stats.RecordKvstoreRead(5);
+  stats.RecordKvstoreWrite(7);
+  stats.RecordCacheHit();
+  stats.RecordCacheMiss();
+  stats.RecordCacheMiss();
+  stats.RecordDecode(15);
+  stats.RecordEncode(7);
+
+  // Copies share the counters.
+  IoStats copy = stats;
+  copy.RecordCacheHit();
+
+  IoStats::Counters expected;
+  expected.kvstore_reads = 2;
+  expected.bytes_read = 15;
+  expected.kvstore_writes = 1;
+  expected.bytes_written = 7;
+  expected.cache_hits = 2;
+  expected.cache_misses = 2;
+  expected.bytes_decoded = 15;
+  expected.bytes_encoded = 7;
+  EXPECT_EQ(expected, stats.Get());
+  EXPECT_EQ(
+      "{kvstore_reads=2, bytes_read=15, kvstore_writes=1, bytes_written=7, "
+      "cache_hits=2, cache_misses=2, bytes_decoded=15, bytes_encoded=7}",
+      tensorstore::StrCat(stats.Get()));
+}
+
+}  // namespace
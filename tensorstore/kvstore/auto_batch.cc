@@ -0,0 +1,58 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/auto_batch.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+
+AutoBatcher::AutoBatcher(absl::Duration window)
+    : window_(window), state_(std::make_shared<State>()) {}
+
+Batch AutoBatcher::GetBatch() {
+  absl::MutexLock lock(&state_->mutex);
+  if (state_->batch) return state_->batch;
+  state_->batch = Batch::New();
+  internal::ScheduleAt(absl::Now() + window_, [state = state_] {
+    Batch batch{no_batch};
+    {
+      absl::MutexLock lock(&state->mutex);
+      std::swap(batch, state->batch);
+    }
+    // Submitting the batch, if this is the last reference, runs the batch
+    // entries, and must be done without `mutex` held.
+    batch.Release();
+  });
+  return state_->batch;
+}
+
+namespace {
+
+const internal::ContextResourceRegistration<AutoBatchResource>
+    auto_batch_registration;
+
+}  // namespace
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
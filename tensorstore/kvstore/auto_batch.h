@@ -0,0 +1,129 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_AUTO_BATCH_H_
+#define TENSORSTORE_KVSTORE_AUTO_BATCH_H_
+
+/// \file
+///
+/// Implicit batching of concurrent reads that do not specify a `Batch`.
+
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache_key/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/absl_time.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+
+/// Collects requests issued within a fixed time window into a shared implicit
+/// batch.
+///
+/// The first call to `GetBatch` creates a new batch, which is submitted once
+/// `window` has elapsed and all references returned by `GetBatch` have been
+/// released.  Calls to `GetBatch` within the window return the same batch.
+class AutoBatcher {
+ public:
+  explicit AutoBatcher(absl::Duration window);
+
+  /// Returns the window specified to the constructor.
+  absl::Duration window() const { return window_; }
+
+  /// Returns the current implicit batch.
+  ///
+  /// The caller must release the returned reference once it has added its
+  /// requests to the batch.
+  Batch GetBatch();
+
+ private:
+  struct State {
+    absl::Mutex mutex;
+    Batch batch ABSL_GUARDED_BY(mutex){no_batch};
+  };
+
+  absl::Duration window_;
+
+  // Shared with the scheduled tasks that submit each batch, which may outlive
+  // this object.
+  std::shared_ptr<State> state_;
+};
+
+/// Context resource that specifies the time window in which reads that do not
+/// specify a `Batch` are collected into an implicit batch.
+///
+/// Auto-batching is disabled unless `window` is greater than 0.  Key-value
+/// stores that share the resource also share the implicit batches.
+struct AutoBatchResource
+    : public internal::ContextResourceTraits<AutoBatchResource> {
+  static constexpr char id[] = "kvstore_auto_batch";
+  constexpr static bool shared_when_decoded = true;
+
+  struct Spec {
+    absl::Duration window = absl::ZeroDuration();
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.window);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    /// Null if auto-batching is disabled.
+    std::shared_ptr<AutoBatcher> batcher;
+  };
+
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(jb::Member(
+        "window",
+        jb::Projection(&Spec::window,
+                       jb::DefaultValue(
+                           [](auto* v) { *v = Default().window; },
+                           jb::Validate([](const auto& options,
+                                           absl::Duration* x) {
+                             if (*x >= absl::ZeroDuration()) {
+                               return absl::OkStatus();
+                             }
+                             return absl::InvalidArgumentError(
+                                 "Expected non-negative duration");
+                           })))));
+  }
+  static Result<Resource> Create(
+      const Spec& spec, internal::ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (spec.window > absl::ZeroDuration()) {
+      resource.batcher = std::make_shared<AutoBatcher>(spec.window);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_AUTO_BATCH_H_
@@ -0,0 +1,83 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/auto_batch.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
+#include "tensorstore/context.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Batch;
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_kvstore_batch::AutoBatcher;
+using ::tensorstore::internal_kvstore_batch::AutoBatchResource;
+
+bool SameBatch(const Batch& a, const Batch& b) {
+  return Batch::View(a).impl_ == Batch::View(b).impl_;
+}
+
+TEST(AutoBatcherTest, SharesBatchWithinWindow) {
+  AutoBatcher batcher(absl::Hours(1));
+  auto batch1 = batcher.GetBatch();
+  auto batch2 = batcher.GetBatch();
+  EXPECT_TRUE(batch1.deferred());
+  EXPECT_TRUE(SameBatch(batch1, batch2));
+}
+
+TEST(AutoBatcherTest, NewBatchAfterWindow) {
+  AutoBatcher batcher(absl::Milliseconds(1));
+  auto batch1 = batcher.GetBatch();
+  EXPECT_TRUE(batch1.deferred());
+  const absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (SameBatch(batch1, batcher.GetBatch()) && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_FALSE(SameBatch(batch1, batcher.GetBatch()));
+  // `batch1` is submitted once this last reference is released.
+  EXPECT_TRUE(batch1.deferred());
+}
+
+TEST(AutoBatchResourceTest, Default) {
+  auto resource_spec = Context::Resource<AutoBatchResource>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(nullptr, resource->batcher);
+}
+
+TEST(AutoBatchResourceTest, Window) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<AutoBatchResource>::FromJson({{"window", "200us"}}));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  ASSERT_NE(nullptr, resource->batcher);
+  EXPECT_EQ(absl::Microseconds(200), resource->batcher->window());
+}
+
+TEST(AutoBatchResourceTest, NegativeWindow) {
+  EXPECT_THAT(
+      Context::Resource<AutoBatchResource>::FromJson({{"window", "-1s"}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Error parsing object member \"window\": .*"));
+}
+
+}  // namespace
@@ -0,0 +1,177 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/batch_revalidation.h"
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/batch_impl.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::SupportedFeatures;
+
+struct RevalidationRequest {
+  kvstore::Key key;
+  kvstore::ReadOptions options;
+  Promise<ReadResult> promise;
+};
+
+void IssueRead(kvstore::Driver& driver, RevalidationRequest& request,
+               Batch::View batch) {
+  request.options.batch = batch;
+  LinkResult(std::move(request.promise),
+             driver.Read(std::move(request.key), std::move(request.options)));
+}
+
+/// Completes `requests` given the result of listing their keys, which was
+/// started at `time`.
+void CompleteRevalidation(kvstore::Driver& driver,
+                          std::vector<RevalidationRequest>& requests,
+                          const Result<std::vector<ListEntry>>& entries,
+                          absl::Time time) {
+  if (!entries.ok()) {
+    for (auto& request : requests) IssueRead(driver, request, no_batch);
+    return;
+  }
+  absl::flat_hash_map<std::string_view, const StorageGeneration*> generations;
+  generations.reserve(entries->size());
+  for (const auto& entry : *entries) {
+    generations.emplace(entry.key, &entry.generation);
+  }
+  for (auto& request : requests) {
+    if (!request.promise.result_needed()) continue;
+    const auto& if_not_equal =
+        request.options.generation_conditions.if_not_equal;
+    auto it = generations.find(request.key);
+    if (it == generations.end()) {
+      request.promise.SetResult(
+          StorageGeneration::IsNoValue(if_not_equal)
+              ? ReadResult::Unspecified({StorageGeneration::NoValue(), time})
+              : ReadResult::Missing(time));
+      continue;
+    }
+    const StorageGeneration& generation = *it->second;
+    if (!StorageGeneration::IsUnknown(generation) &&
+        generation == if_not_equal) {
+      request.promise.SetResult(ReadResult::Unspecified({generation, time}));
+      continue;
+    }
+    IssueRead(driver, request, no_batch);
+  }
+}
+
+/// Batch entry that collects the conditional reads from a single driver.
+class RevalidationBatchEntry : public Batch::Impl::Entry {
+ public:
+  using KeyParam = kvstore::Driver*;
+
+  explicit RevalidationBatchEntry(kvstore::DriverPtr driver)
+      : Batch::Impl::Entry(driver->BatchNestingDepth() + 1),
+        driver_(std::move(driver)) {}
+
+  KeyParam key() const { return driver_.get(); }
+
+  void AddRequest(RevalidationRequest request) {
+    absl::MutexLock lock(&mutex_);
+    requests_.push_back(std::move(request));
+  }
+
+ private:
+  void Submit(Batch::View batch) override {
+    std::unique_ptr<RevalidationBatchEntry> self(this);
+    auto& requests = requests_;
+    if (requests.size() < kMinListRevalidationReads) {
+      for (auto& request : requests) IssueRead(*driver_, request, batch);
+      return;
+    }
+    const auto [min_it, max_it] = std::minmax_element(
+        requests.begin(), requests.end(),
+        [](const RevalidationRequest& a, const RevalidationRequest& b) {
+          return a.key < b.key;
+        });
+    kvstore::ListOptions list_options;
+    list_options.range =
+        KeyRange(min_it->key, KeyRange::Successor(max_it->key));
+    list_options.staleness_bound = absl::InfinitePast();
+    for (const auto& request : requests) {
+      list_options.staleness_bound = std::max(list_options.staleness_bound,
+                                              request.options.staleness_bound);
+    }
+    const absl::Time time = absl::Now();
+    kvstore::ListFuture(driver_.get(), std::move(list_options))
+        .ExecuteWhenReady(
+            [driver = driver_, requests = std::move(requests), time](
+                ReadyFuture<std::vector<ListEntry>> future) mutable {
+              CompleteRevalidation(*driver, requests, future.result(), time);
+            });
+  }
+
+  kvstore::DriverPtr driver_;
+  absl::Mutex mutex_;
+  // Protected by `mutex_` until the batch is submitted.
+  std::vector<RevalidationRequest> requests_;
+};
+
+}  // namespace
+
+Future<ReadResult> ReadWithBatchedRevalidation(kvstore::Driver& driver,
+                                               kvstore::Key key,
+                                               kvstore::ReadOptions options) {
+  const auto& conditions = options.generation_conditions;
+  if (!options.batch.deferred() ||
+      StorageGeneration::IsUnknown(conditions.if_not_equal) ||
+      !StorageGeneration::IsUnknown(conditions.if_equal) ||
+      !options.byte_range.IsFull() ||
+      (driver.GetSupportedFeatures(KeyRange::Singleton(key)) &
+       SupportedFeatures::kListGenerations) == SupportedFeatures::kNone) {
+    return driver.Read(std::move(key), std::move(options));
+  }
+  auto* batch = Batch::Impl::From(options.batch);
+  // The reference to the batch must not be retained by the entry.
+  options.batch = no_batch;
+  auto [promise, future] = PromiseFuturePair<ReadResult>::Make();
+  batch
+      ->GetEntry<RevalidationBatchEntry>(
+          &driver,
+          [&] {
+            return std::make_unique<RevalidationBatchEntry>(
+                kvstore::DriverPtr(&driver));
+          })
+      .AddRequest({std::move(key), std::move(options), std::move(promise)});
+  return std::move(future);
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,57 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_BATCH_REVALIDATION_H_
+#define TENSORSTORE_KVSTORE_BATCH_REVALIDATION_H_
+
+/// \file
+///
+/// Revalidation of many cached values with a single `List` operation.
+
+#include <stddef.h>
+
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Minimum number of conditional reads within a batch for which they are
+/// revalidated by a single `List` operation rather than individually.
+constexpr size_t kMinListRevalidationReads = 8;
+
+/// Reads `key` from `driver`, equivalent to `driver.Read(key, options)`.
+///
+/// If `options.batch` is specified, `options.generation_conditions` specifies
+/// only an `if_not_equal` generation, the full value is requested, and
+/// `driver` supports `kvstore::SupportedFeatures::kListGenerations`, the read
+/// is deferred until the batch is submitted.  If the batch contains at least
+/// `kMinListRevalidationReads` such reads from `driver`, they are validated by
+/// a single `List` operation over the range of their keys: reads of unchanged
+/// values complete with `kvstore::ReadResult::Unspecified`, and reads of keys
+/// that are no longer present complete with `kvstore::ReadResult::Missing`,
+/// without reading the values.  Only the changed values are read
+/// individually.
+///
+/// This is intended for revalidating many cached values, such as chunks, whose
+/// staleness bound has passed.
+Future<kvstore::ReadResult> ReadWithBatchedRevalidation(
+    kvstore::Driver& driver, kvstore::Key key, kvstore::ReadOptions options);
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_BATCH_REVALIDATION_H_
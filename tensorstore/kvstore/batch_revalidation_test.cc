@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/batch_revalidation.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = tensorstore::kvstore;
+using ::tensorstore::Batch;
+using ::tensorstore::Future;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal_kvstore::kMinListRevalidationReads;
+using ::tensorstore::internal_kvstore::ReadWithBatchedRevalidation;
+
+// Writes `num_keys` keys, then modifies key 1 and deletes key 2, and
+// revalidates all of the keys against their original generations within a
+// single batch.
+std::vector<tensorstore::Result<kvstore::ReadResult>> WriteAndRevalidate(
+    size_t num_keys) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_CHECK_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "memory"}}, context).result());
+  std::vector<StorageGeneration> generations;
+  for (size_t i = 0; i < num_keys; ++i) {
+    TENSORSTORE_CHECK_OK_AND_ASSIGN(
+        auto stamp, kvstore::Write(store, "key" + std::to_string(i),
+                                   absl::Cord("value"))
+                        .result());
+    generations.push_back(stamp.generation);
+  }
+  TENSORSTORE_CHECK_OK(
+      kvstore::Write(store, "key1", absl::Cord("changed")).result());
+  TENSORSTORE_CHECK_OK(kvstore::Delete(store, "key2").result());
+
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = Batch::New();
+    for (size_t i = 0; i < num_keys; ++i) {
+      kvstore::ReadOptions options;
+      options.generation_conditions.if_not_equal = generations[i];
+      options.staleness_bound = absl::Now();
+      options.batch = batch;
+      futures.push_back(ReadWithBatchedRevalidation(
+          *store.driver, "key" + std::to_string(i), std::move(options)));
+    }
+  }
+  std::vector<tensorstore::Result<kvstore::ReadResult>> results;
+  for (auto& future : futures) {
+    results.push_back(future.result());
+  }
+  return results;
+}
+
+void ExpectRevalidationResults(
+    const std::vector<tensorstore::Result<kvstore::ReadResult>>& results) {
+  for (size_t i = 0; i < results.size(); ++i) {
+    SCOPED_TRACE(i);
+    if (i == 1) {
+      EXPECT_THAT(results[i], MatchesKvsReadResult(absl::Cord("changed")));
+    } else if (i == 2) {
+      EXPECT_THAT(results[i], MatchesKvsReadResultNotFound());
+    } else {
+      EXPECT_THAT(results[i],
+                  MatchesKvsReadResult(kvstore::ReadResult::kUnspecified));
+    }
+  }
+}
+
+TEST(ReadWithBatchedRevalidationTest, List) {
+  ExpectRevalidationResults(WriteAndRevalidate(kMinListRevalidationReads + 2));
+}
+
+TEST(ReadWithBatchedRevalidationTest, BelowThreshold) {
+  ExpectRevalidationResults(WriteAndRevalidate(kMinListRevalidationReads - 1));
+}
+
+TEST(ReadWithBatchedRevalidationTest, NoBatch) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "memory"}}, context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a", absl::Cord("value")).result());
+  kvstore::ReadOptions options;
+  options.generation_conditions.if_not_equal = stamp.generation;
+  EXPECT_THAT(
+      ReadWithBatchedRevalidation(*store.driver, "a", options).result(),
+      MatchesKvsReadResult(kvstore::ReadResult::kUnspecified));
+}
+
+}  // namespace
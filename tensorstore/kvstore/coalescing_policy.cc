@@ -0,0 +1,102 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/coalescing_policy.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <optional>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/batch_util.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+namespace {
+
+// Weight of each new sample in the exponentially weighted means.
+constexpr double kSampleWeight = 1.0 / 64;
+
+}  // namespace
+
+CoalescingPolicy::CoalescingPolicy(CoalescingOptions defaults,
+                                   CoalescingOverrides overrides)
+    : defaults_(defaults), overrides_(overrides) {}
+
+void CoalescingPolicy::RecordRead(int64_t bytes, absl::Duration latency) {
+  const double x = static_cast<double>(bytes);
+  const double y = absl::ToDoubleSeconds(latency);
+  absl::MutexLock lock(&mutex_);
+  // Use a plain average for the initial samples so that the estimate is not
+  // biased towards zero.
+  const double w = std::max(kSampleWeight, 1.0 / (num_samples_ + 1));
+  if (num_samples_ < kMinSamples) ++num_samples_;
+  mean_x_ += w * (x - mean_x_);
+  mean_y_ += w * (y - mean_y_);
+  mean_xx_ += w * (x * x - mean_xx_);
+  mean_xy_ += w * (x * y - mean_xy_);
+}
+
+bool CoalescingPolicy::Estimate(double& latency,
+                                double& seconds_per_byte) const {
+  if (num_samples_ < kMinSamples) return false;
+  const double var_x = mean_xx_ - mean_x_ * mean_x_;
+  // Without variation in the request sizes, latency and bandwidth cannot be
+  // distinguished.
+  if (!(var_x > 1.0)) return false;
+  const double cov_xy = mean_xy_ - mean_x_ * mean_y_;
+  seconds_per_byte = cov_xy / var_x;
+  latency = mean_y_ - seconds_per_byte * mean_x_;
+  return seconds_per_byte > 0 && latency >= 0;
+}
+
+CoalescingOptions CoalescingPolicy::GetOptions() const {
+  CoalescingOptions options = defaults_;
+  if (overrides_.target_coalesced_size) {
+    options.target_coalesced_size = *overrides_.target_coalesced_size;
+  }
+  if (overrides_.max_extra_read_bytes) {
+    options.max_extra_read_bytes = *overrides_.max_extra_read_bytes;
+    return options;
+  }
+  double latency, seconds_per_byte;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!Estimate(latency, seconds_per_byte)) return options;
+  }
+  const double break_even_bytes = latency / seconds_per_byte;
+  options.max_extra_read_bytes = static_cast<int64_t>(std::min(
+      break_even_bytes, static_cast<double>(kMaxAdaptiveExtraReadBytes)));
+  return options;
+}
+
+std::optional<absl::Duration> CoalescingPolicy::estimated_latency() const {
+  double latency, seconds_per_byte;
+  absl::MutexLock lock(&mutex_);
+  if (!Estimate(latency, seconds_per_byte)) return std::nullopt;
+  return absl::Seconds(latency);
+}
+
+std::optional<double> CoalescingPolicy::estimated_bandwidth() const {
+  double latency, seconds_per_byte;
+  absl::MutexLock lock(&mutex_);
+  if (!Estimate(latency, seconds_per_byte)) return std::nullopt;
+  return 1 / seconds_per_byte;
+}
+
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
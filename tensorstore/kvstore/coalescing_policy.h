@@ -0,0 +1,131 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_COALESCING_POLICY_H_
+#define TENSORSTORE_KVSTORE_COALESCING_POLICY_H_
+
+/// \file
+///
+/// Adaptive policy for coalescing byte range reads.
+///
+/// Coalescing two reads of the same key separated by a gap of `g` bytes saves
+/// one request, at the cost of reading `g` additional bytes.  If a request to a
+/// given key-value store takes approximately `latency + bytes / bandwidth`,
+/// coalescing is beneficial if `g < latency * bandwidth`.  The
+/// `CoalescingPolicy` estimates `latency` and `bandwidth` from the observed
+/// reads, and uses that break-even gap as
+/// `CoalescingOptions::max_extra_read_bytes`.
+
+#include <stdint.h>
+
+#include <optional>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/kvstore/batch_util.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+
+/// Coalescing constraints specified explicitly by a key-value store spec.
+///
+/// Members that are specified are used as is, rather than adapted.
+struct CoalescingOverrides {
+  std::optional<int64_t> max_extra_read_bytes;
+  std::optional<int64_t> target_coalesced_size;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.max_extra_read_bytes, x.target_coalesced_size);
+  };
+
+  constexpr static auto default_json_binder = [](auto is_loading,
+                                                 const auto& options,
+                                                 auto* obj, auto* j) {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(
+        jb::Member("max_extra_read_bytes",
+                   jb::Projection<&CoalescingOverrides::max_extra_read_bytes>(
+                       jb::Optional(jb::Integer<int64_t>(0)))),
+        jb::Member(
+            "target_coalesced_size",
+            jb::Projection<&CoalescingOverrides::target_coalesced_size>(
+                jb::Optional(jb::Integer<int64_t>(1)))))(is_loading, options,
+                                                         obj, j);
+  };
+};
+
+/// Determines the `CoalescingOptions` for a key-value store from a simple
+/// cost model fitted to its observed reads.
+///
+/// The per-request latency and bandwidth are estimated by an exponentially
+/// weighted least-squares fit of the read latency as a linear function of the
+/// number of bytes read.  Until enough reads of sufficiently different sizes
+/// have been observed, the default options are used.
+///
+/// Thread-safe.
+class CoalescingPolicy {
+ public:
+  /// Maximum `max_extra_read_bytes` that is chosen adaptively.
+  constexpr static int64_t kMaxAdaptiveExtraReadBytes = 16 * 1024 * 1024;
+
+  /// Minimum number of recorded reads before the estimate is used.
+  constexpr static int kMinSamples = 16;
+
+  explicit CoalescingPolicy(CoalescingOptions defaults,
+                            CoalescingOverrides overrides = {});
+
+  /// Returns the options to use for coalescing.
+  CoalescingOptions GetOptions() const;
+
+  /// Records a completed request to the key-value store.
+  ///
+  /// \param bytes Number of bytes read.
+  /// \param latency Time taken by the request.
+  void RecordRead(int64_t bytes, absl::Duration latency);
+
+  /// Returns the estimated per-request latency, or `std::nullopt` if no
+  /// estimate is available yet.
+  std::optional<absl::Duration> estimated_latency() const;
+
+  /// Returns the estimated bandwidth in bytes per second, or `std::nullopt` if
+  /// no estimate is available yet.
+  std::optional<double> estimated_bandwidth() const;
+
+ private:
+  // Returns `true` if `latency` and `seconds_per_byte` were estimated.
+  bool Estimate(double& latency, double& seconds_per_byte) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  CoalescingOptions defaults_;
+  CoalescingOverrides overrides_;
+
+  mutable absl::Mutex mutex_;
+  int num_samples_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Exponentially weighted means of the bytes read `x`, the latency in seconds
+  // `y`, `x * x` and `x * y`.
+  double mean_x_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_y_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_xx_ ABSL_GUARDED_BY(mutex_) = 0;
+  double mean_xy_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_COALESCING_POLICY_H_
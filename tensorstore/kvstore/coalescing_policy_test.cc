@@ -0,0 +1,121 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/coalescing_policy.h"
+
+#include <stdint.h>
+
+#include <optional>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/internal/json_binding/gtest.h"
+#include "tensorstore/kvstore/batch_util.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_kvstore_batch::CoalescingOptions;
+using ::tensorstore::internal_kvstore_batch::CoalescingOverrides;
+using ::tensorstore::internal_kvstore_batch::CoalescingPolicy;
+using ::testing::DoubleNear;
+using ::testing::Optional;
+
+constexpr CoalescingOptions kDefaults = {
+    /*.max_extra_read_bytes=*/4095,
+    /*.target_coalesced_size=*/1024 * 1024,
+};
+
+// Records reads of varying sizes from a store with a latency of 10ms and a
+// bandwidth of 100MB/s.
+void RecordSimulatedReads(CoalescingPolicy& policy, int count) {
+  for (int i = 0; i < count; ++i) {
+    const int64_t bytes = (i % 8 + 1) * 100000;
+    policy.RecordRead(bytes, absl::Milliseconds(10) +
+                                 absl::Seconds(static_cast<double>(bytes) /
+                                               1e8));
+  }
+}
+
+TEST(CoalescingPolicyTest, DefaultsBeforeEstimate) {
+  CoalescingPolicy policy(kDefaults);
+  EXPECT_EQ(std::nullopt, policy.estimated_latency());
+  RecordSimulatedReads(policy, CoalescingPolicy::kMinSamples - 1);
+  EXPECT_EQ(std::nullopt, policy.estimated_latency());
+  auto options = policy.GetOptions();
+  EXPECT_EQ(4095, options.max_extra_read_bytes);
+  EXPECT_EQ(1024 * 1024, options.target_coalesced_size);
+}
+
+TEST(CoalescingPolicyTest, DefaultsWithUniformReadSizes) {
+  CoalescingPolicy policy(kDefaults);
+  for (int i = 0; i < 100; ++i) {
+    policy.RecordRead(1000, absl::Milliseconds(10));
+  }
+  EXPECT_EQ(4095, policy.GetOptions().max_extra_read_bytes);
+}
+
+TEST(CoalescingPolicyTest, Estimate) {
+  CoalescingPolicy policy(kDefaults);
+  RecordSimulatedReads(policy, 100);
+  EXPECT_THAT(policy.estimated_bandwidth(), Optional(DoubleNear(1e8, 1e5)));
+  auto latency = policy.estimated_latency();
+  ASSERT_TRUE(latency);
+  EXPECT_NEAR(0.01, absl::ToDoubleSeconds(*latency), 1e-5);
+  auto options = policy.GetOptions();
+  // latency * bandwidth = 1MB
+  EXPECT_NEAR(1e6, options.max_extra_read_bytes, 1e3);
+  EXPECT_EQ(1024 * 1024, options.target_coalesced_size);
+}
+
+TEST(CoalescingPolicyTest, EstimateIsClamped) {
+  CoalescingPolicy policy(kDefaults);
+  for (int i = 0; i < 100; ++i) {
+    const int64_t bytes = (i % 2 + 1) * 1000;
+    policy.RecordRead(bytes, absl::Seconds(10) + absl::Nanoseconds(bytes));
+  }
+  EXPECT_EQ(CoalescingPolicy::kMaxAdaptiveExtraReadBytes,
+            policy.GetOptions().max_extra_read_bytes);
+}
+
+TEST(CoalescingPolicyTest, Overrides) {
+  CoalescingOverrides overrides;
+  overrides.max_extra_read_bytes = 100;
+  overrides.target_coalesced_size = 2000;
+  CoalescingPolicy policy(kDefaults, overrides);
+  RecordSimulatedReads(policy, 100);
+  auto options = policy.GetOptions();
+  EXPECT_EQ(100, options.max_extra_read_bytes);
+  EXPECT_EQ(2000, options.target_coalesced_size);
+}
+
+TEST(CoalescingOverridesTest, JsonBinding) {
+  tensorstore::TestJsonBinderRoundTripJsonOnly<CoalescingOverrides>({
+      ::nlohmann::json::object_t(),
+      {{"max_extra_read_bytes", 0}},
+      {{"max_extra_read_bytes", 100}, {"target_coalesced_size", 1000}},
+  });
+  tensorstore::TestJsonBinderFromJson<CoalescingOverrides>({
+      {{{"max_extra_read_bytes", -1}},
+       MatchesStatus(absl::StatusCode::kInvalidArgument)},
+      {{{"target_coalesced_size", 0}},
+       MatchesStatus(absl::StatusCode::kInvalidArgument)},
+  });
+}
+
+}  // namespace
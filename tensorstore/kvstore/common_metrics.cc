@@ -0,0 +1,63 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/common_metrics.h"
+
+#include <utility>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+double ElapsedMilliseconds(absl::Time start_time) {
+  return absl::ToDoubleMilliseconds(absl::Now() - start_time);
+}
+
+}  // namespace
+
+Future<kvstore::ReadResult> RecordReadMetrics(
+    const CommonMetrics& metrics, Future<kvstore::ReadResult> future,
+    bool count_bytes) {
+  metrics.in_flight.Increment();
+  future.ExecuteWhenReady([&metrics, count_bytes, start_time = absl::Now()](
+                              ReadyFuture<kvstore::ReadResult> ready) {
+    metrics.in_flight.Decrement();
+    metrics.read_latency_ms.Observe(ElapsedMilliseconds(start_time));
+    if (count_bytes && ready.result().ok() && ready.value().has_value()) {
+      metrics.bytes_read.IncrementBy(ready.value().value.size());
+    }
+  });
+  return future;
+}
+
+Future<TimestampedStorageGeneration> RecordWriteMetrics(
+    const CommonMetrics& metrics,
+    Future<TimestampedStorageGeneration> future) {
+  metrics.in_flight.Increment();
+  future.ExecuteWhenReady([&metrics, start_time = absl::Now()](
+                              ReadyFuture<TimestampedStorageGeneration>) {
+    metrics.in_flight.Decrement();
+    metrics.write_latency_ms.Observe(ElapsedMilliseconds(start_time));
+  });
+  return future;
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,104 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_COMMON_METRICS_H_
+#define TENSORSTORE_KVSTORE_COMMON_METRICS_H_
+
+/// \file
+///
+/// Metrics reported uniformly by kvstore drivers.
+///
+/// Each driver defines its metrics once, at namespace scope:
+///
+///     auto file_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(file);
+///
+/// which registers, under `/tensorstore/kvstore/file/`:
+///
+/// - `read_latency_ms` and `write_latency_ms` histograms,
+/// - an `in_flight` gauge of outstanding reads and writes,
+/// - `bytes_read` and `bytes_written` counters.
+
+#include <stdint.h>
+
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/gauge.h"
+#include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+struct CommonMetrics {
+  internal_metrics::Histogram<internal_metrics::DefaultBucketer>&
+      read_latency_ms;
+  internal_metrics::Histogram<internal_metrics::DefaultBucketer>&
+      write_latency_ms;
+  internal_metrics::Gauge<int64_t>& in_flight;
+  internal_metrics::Counter<int64_t>& bytes_read;
+  internal_metrics::Counter<int64_t>& bytes_written;
+};
+
+#define TENSORSTORE_KVSTORE_COMMON_METRICS(KVSTORE)                          \
+  ::tensorstore::internal_kvstore::CommonMetrics {                           \
+    ::tensorstore::internal_metrics::Histogram<                              \
+        ::tensorstore::internal_metrics::DefaultBucketer>::                  \
+        New("/tensorstore/kvstore/" #KVSTORE "/read_latency_ms",             \
+            ::tensorstore::internal_metrics::MetricMetadata(                 \
+                #KVSTORE " driver kvstore::Read latency (ms)",               \
+                ::tensorstore::internal_metrics::Units::kMilliseconds)),     \
+        ::tensorstore::internal_metrics::Histogram<                          \
+            ::tensorstore::internal_metrics::DefaultBucketer>::              \
+            New("/tensorstore/kvstore/" #KVSTORE "/write_latency_ms",        \
+                ::tensorstore::internal_metrics::MetricMetadata(             \
+                    #KVSTORE " driver kvstore::Write latency (ms)",          \
+                    ::tensorstore::internal_metrics::Units::kMilliseconds)), \
+        ::tensorstore::internal_metrics::Gauge<int64_t>::New(                \
+            "/tensorstore/kvstore/" #KVSTORE "/in_flight",                   \
+            ::tensorstore::internal_metrics::MetricMetadata(                 \
+                #KVSTORE " driver reads and writes in progress")),           \
+        ::tensorstore::internal_metrics::Counter<int64_t>::New(              \
+            "/tensorstore/kvstore/" #KVSTORE "/bytes_read",                  \
+            ::tensorstore::internal_metrics::MetricMetadata(                 \
+                "Bytes read by the " #KVSTORE " kvstore driver",             \
+                ::tensorstore::internal_metrics::Units::kBytes)),            \
+        ::tensorstore::internal_metrics::Counter<int64_t>::New(              \
+            "/tensorstore/kvstore/" #KVSTORE "/bytes_written",               \
+            ::tensorstore::internal_metrics::MetricMetadata(                 \
+                "Bytes written by the " #KVSTORE " kvstore driver",          \
+                ::tensorstore::internal_metrics::Units::kBytes)),            \
+  }
+
+/// Records the latency of a read in `metrics` when `future` becomes ready.
+///
+/// \param count_bytes If `true`, the size of the returned value is added to
+///     `metrics.bytes_read`.  Drivers that count bytes as they are
+///     transferred specify `false`.
+Future<kvstore::ReadResult> RecordReadMetrics(
+    const CommonMetrics& metrics, Future<kvstore::ReadResult> future,
+    bool count_bytes = true);
+
+/// Records the latency of a write in `metrics` when `future` becomes ready.
+///
+/// Bytes written are counted by the caller.
+Future<TimestampedStorageGeneration> RecordWriteMetrics(
+    const CommonMetrics& metrics,
+    Future<TimestampedStorageGeneration> future);
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_COMMON_METRICS_H_
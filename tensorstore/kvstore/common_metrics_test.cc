@@ -0,0 +1,72 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/common_metrics.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace {
+
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal_kvstore::RecordReadMetrics;
+using ::tensorstore::internal_kvstore::RecordWriteMetrics;
+using ::tensorstore::kvstore::ReadResult;
+
+auto test_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(common_metrics_test);
+
+TEST(CommonMetricsTest, Read) {
+  auto pair = PromiseFuturePair<ReadResult>::Make();
+  auto future = RecordReadMetrics(test_metrics, pair.future);
+  EXPECT_EQ(1, test_metrics.in_flight.Get());
+  pair.promise.SetResult(ReadResult::Value(absl::Cord("abcd"), {}));
+  EXPECT_TRUE(future.result().ok());
+  EXPECT_EQ(0, test_metrics.in_flight.Get());
+  EXPECT_EQ(4, test_metrics.bytes_read.Get());
+  EXPECT_EQ(1, test_metrics.read_latency_ms.Collect().histograms[0].count);
+
+  // Failed reads are still timed, but contribute no bytes.
+  RecordReadMetrics(test_metrics,
+                    tensorstore::MakeReadyFuture<ReadResult>(
+                        absl::UnknownError("failed")));
+  EXPECT_EQ(4, test_metrics.bytes_read.Get());
+  EXPECT_EQ(2, test_metrics.read_latency_ms.Collect().histograms[0].count);
+}
+
+TEST(CommonMetricsTest, ReadWithoutCountingBytes) {
+  const auto bytes_read = test_metrics.bytes_read.Get();
+  RecordReadMetrics(test_metrics,
+                    tensorstore::MakeReadyFuture<ReadResult>(
+                        ReadResult::Value(absl::Cord("abcd"), {})),
+                    /*count_bytes=*/false);
+  EXPECT_EQ(bytes_read, test_metrics.bytes_read.Get());
+}
+
+TEST(CommonMetricsTest, Write) {
+  auto pair = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  auto future = RecordWriteMetrics(test_metrics, pair.future);
+  EXPECT_EQ(1, test_metrics.in_flight.Get());
+  pair.promise.SetResult(TimestampedStorageGeneration{});
+  EXPECT_TRUE(future.result().ok());
+  EXPECT_EQ(0, test_metrics.in_flight.Get());
+  EXPECT_EQ(1, test_metrics.write_latency_ms.Collect().histograms[0].count);
+}
+
+}  // namespace
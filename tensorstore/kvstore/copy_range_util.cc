@@ -0,0 +1,103 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/copy_range_util.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+namespace {
+
+struct CopyRangeState : public internal::AtomicReferenceCount<CopyRangeState> {
+  CopyKeyFunction copy_key;
+  size_t source_prefix_length;
+  std::string target_prefix;
+  Promise<void> promise;
+};
+
+// Receiver used by `CopyRangeByListing` for processing the results from
+// `List`.
+struct CopyRangeListReceiver {
+  internal::IntrusivePtr<CopyRangeState> state_;
+  FutureCallbackRegistration cancel_registration_;
+
+  void set_starting(AnyCancelReceiver cancel) {
+    cancel_registration_ =
+        state_->promise.ExecuteWhenNotNeeded(std::move(cancel));
+  }
+
+  void set_value(kvstore::ListEntry entry) {
+    std::string target_key = tensorstore::StrCat(
+        state_->target_prefix,
+        std::string_view(entry.key).substr(
+            std::min(state_->source_prefix_length, entry.key.size())));
+    LinkError(state_->promise,
+              state_->copy_key(std::move(entry), std::move(target_key)));
+  }
+
+  void set_error(absl::Status error) {
+    SetDeferredResult(state_->promise, std::move(error));
+    state_->promise = Promise<void>();
+  }
+
+  void set_done() { state_->promise = Promise<void>(); }
+
+  void set_stopping() { cancel_registration_.Unregister(); }
+};
+
+}  // namespace
+
+Future<const void> CopyRangeByListing(const KvStore& source,
+                                      std::string target_prefix,
+                                      const kvstore::CopyRangeOptions& options,
+                                      CopyKeyFunction copy_key,
+                                      size_t list_concurrency) {
+  assert(source.transaction == no_transaction);
+  auto op = PromiseFuturePair<void>::Make(absl::OkStatus());
+  auto state = internal::MakeIntrusivePtr<CopyRangeState>();
+  state->copy_key = std::move(copy_key);
+  state->source_prefix_length = source.path.size();
+  state->target_prefix = std::move(target_prefix);
+  state->promise = std::move(op.promise);
+
+  kvstore::ListOptions list_options;
+  list_options.range = KeyRange::AddPrefix(source.path, options.source_range);
+  list_options.staleness_bound = options.source_staleness_bound;
+  list_options.concurrency = std::max(list_concurrency, size_t{1});
+  list_options.ordered = false;
+  source.driver->ListImpl(std::move(list_options),
+                          CopyRangeListReceiver{std::move(state)});
+  return std::move(op.future);
+}
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
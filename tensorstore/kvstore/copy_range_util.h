@@ -0,0 +1,65 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_COPY_RANGE_UTIL_H_
+#define TENSORSTORE_KVSTORE_COPY_RANGE_UTIL_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "absl/functional/any_invocable.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/future.h"
+
+// This file defines utilities for use by kvstore drivers to implement
+// `kvstore::Driver::ExperimentalCopyRangeFrom` with a per-key server-side copy
+// operation.
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Copies a single key.
+///
+/// Invoked with the listed source entry, whose `key` is relative to the source
+/// driver (i.e. includes `source.path`), and the corresponding target key.  It
+/// may be invoked concurrently from multiple threads.
+using CopyKeyFunction = absl::AnyInvocable<Future<const void>(
+    kvstore::ListEntry entry, std::string target_key)>;
+
+/// Lists the keys of `source` in `options.source_range` and invokes `copy_key`
+/// for each key as soon as it is listed, such that copies proceed concurrently
+/// with the listing.
+///
+/// The key `source.path + suffix` is copied to `target_prefix + suffix`.
+/// Listing is unordered, and up to `list_concurrency` sub-ranges are listed
+/// concurrently.  The concurrency of the copies themselves is bounded by
+/// `copy_key`, typically by the admission queue of the driver.
+///
+/// The returned future becomes ready once the listing and all copies have
+/// completed, or with the first error.  Cancelling it cancels the listing;
+/// copies that have already been issued are not cancelled.
+///
+/// \pre `source.transaction == no_transaction`
+Future<const void> CopyRangeByListing(const KvStore& source,
+                                      std::string target_prefix,
+                                      const kvstore::CopyRangeOptions& options,
+                                      CopyKeyFunction copy_key,
+                                      size_t list_concurrency = 1);
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_COPY_RANGE_UTIL_H_
@@ -0,0 +1,558 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+///
+/// Key-value store adapter that caches the values read from a base kvstore in
+/// a second, typically local, kvstore.
+///
+/// Each cached value is stored in the cache kvstore under the same key,
+/// prefixed by a header that records the `TimestampedStorageGeneration` of the
+/// value in the base kvstore.  An in-memory index of the cached keys, which is
+/// rebuilt by listing the cache kvstore when the driver is opened, tracks the
+/// total size of the cache and the order in which entries were used.
+///
+/// If the cache kvstore is shared with other processes, such as the worker
+/// processes of a data loader on the same host, entries written by the other
+/// processes after the index was built are found by reading the cache kvstore
+/// on an index miss, and are then added to the index.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListReceiver;
+using ::tensorstore::kvstore::ReadResult;
+using ::tensorstore::kvstore::SupportedFeatures;
+
+// Format version, stored as the first byte of every cache entry.
+constexpr uint8_t kCacheEntryFormatVersion = 0;
+
+// Format version, timestamp, and generation length.
+constexpr size_t kCacheEntryHeaderSize = 1 + 8 + 8;
+
+struct CacheEntry {
+  TimestampedStorageGeneration stamp;
+  absl::Cord value;
+};
+
+absl::Cord EncodeCacheEntry(const TimestampedStorageGeneration& stamp,
+                            const absl::Cord& value) {
+  std::string header(kCacheEntryHeaderSize, '\0');
+  header[0] = static_cast<char>(kCacheEntryFormatVersion);
+  absl::little_endian::Store64(header.data() + 1,
+                               absl::ToUnixNanos(stamp.time));
+  absl::little_endian::Store64(header.data() + 9,
+                               stamp.generation.value.size());
+  header += stamp.generation.value;
+  absl::Cord entry(std::move(header));
+  entry.Append(value);
+  return entry;
+}
+
+Result<CacheEntry> DecodeCacheEntry(const absl::Cord& entry) {
+  if (entry.size() < kCacheEntryHeaderSize) {
+    return absl::DataLossError("Truncated cache entry header");
+  }
+  std::string header(entry.Subcord(0, kCacheEntryHeaderSize));
+  if (static_cast<uint8_t>(header[0]) != kCacheEntryFormatVersion) {
+    return absl::DataLossError(tensorstore::StrCat(
+        "Unsupported cache entry format version: ",
+        static_cast<int>(static_cast<uint8_t>(header[0]))));
+  }
+  const uint64_t generation_size =
+      absl::little_endian::Load64(header.data() + 9);
+  if (generation_size > entry.size() - kCacheEntryHeaderSize) {
+    return absl::DataLossError("Truncated cache entry generation");
+  }
+  CacheEntry result;
+  result.stamp.time = absl::FromUnixNanos(
+      static_cast<int64_t>(absl::little_endian::Load64(header.data() + 1)));
+  result.stamp.generation.value =
+      std::string(entry.Subcord(kCacheEntryHeaderSize, generation_size));
+  result.value = entry.Subcord(kCacheEntryHeaderSize + generation_size,
+                               entry.size());
+  return result;
+}
+
+struct DiskCacheKvStoreSpecData {
+  kvstore::Spec base;
+  kvstore::Spec cache;
+  uint64_t max_bytes;
+  bool shared = false;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.base, x.cache, x.max_bytes, x.shared);
+  };
+
+  constexpr static auto default_json_binder = jb::Object(
+      jb::Member("base", jb::Projection<&DiskCacheKvStoreSpecData::base>()),
+      jb::Member("cache", jb::Projection<&DiskCacheKvStoreSpecData::cache>()),
+      jb::Member("max_bytes",
+                 jb::Projection<&DiskCacheKvStoreSpecData::max_bytes>(
+                     jb::Integer<uint64_t>(1))),
+      jb::Member("shared", jb::Projection<&DiskCacheKvStoreSpecData::shared>(
+                               jb::DefaultValue([](auto* v) { *v = false; })))
+      /**/
+  );
+};
+
+class DiskCacheKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<DiskCacheKvStoreSpec,
+                                                    DiskCacheKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "disk_cache";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+
+  absl::Status ApplyOptions(kvstore::DriverSpecOptions&& options) override {
+    return data_.base.driver.Set(std::move(options));
+  }
+
+  Result<kvstore::Spec> GetBase(std::string_view path) const override {
+    return data_.base;
+  }
+};
+
+/// Defines the "disk_cache" key value store.
+class DiskCacheKvStore
+    : public internal_kvstore::RegisteredDriver<DiskCacheKvStore,
+                                                DiskCacheKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override;
+
+  Future<const void> DeleteRange(KeyRange range) override;
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override {
+    options.range = KeyRange::AddPrefix(base_.path, std::move(options.range));
+    options.strip_prefix_length += base_.path.size();
+    base_.driver->ListImpl(std::move(options), std::move(receiver));
+  }
+
+  std::string DescribeKey(std::string_view key) override {
+    return base_.driver->DescribeKey(tensorstore::StrCat(base_.path, key));
+  }
+
+  absl::Status GetBoundSpecData(DiskCacheKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    return base_.driver->GetSupportedFeatures(
+        KeyRange::AddPrefix(base_.path, key_range));
+  }
+
+  Result<KvStore> GetBase(std::string_view path,
+                          const Transaction& transaction) const override {
+    return KvStore(base_.driver, base_.path, transaction);
+  }
+
+  /// Reads `key` from the base kvstore, and updates the cache with the result
+  /// if the read was for the full value.
+  Future<ReadResult> ReadFromBase(Key key, ReadOptions options);
+
+  /// Writes `value` to the cache kvstore, evicting the least-recently used
+  /// entries as needed to stay within `max_bytes`.
+  void UpdateCache(Key key, const TimestampedStorageGeneration& stamp,
+                   const absl::Cord& value);
+
+  /// Adds an entry of `size` bytes for `key`, stored in the cache kvstore with
+  /// `cache_generation`, to the index as the most-recently used entry, and
+  /// evicts the least-recently used entries as needed to stay within
+  /// `max_bytes`.
+  void AddToIndex(Key key, uint64_t size, StorageGeneration cache_generation);
+
+  /// Removes `key` from the cache, if it is present in the index.
+  void Invalidate(Key key);
+
+  /// Adds the entries of the cache kvstore, as returned by `List`, to the
+  /// index.  The entries are evicted in the order in which they are listed.
+  void InitializeIndex(std::vector<ListEntry> entries);
+
+  /// Marks `key` as the most-recently used entry.  Returns `false` if `key` is
+  /// not in the cache.
+  bool Touch(std::string_view key);
+
+  DiskCacheKvStoreSpecData spec_data_;
+  kvstore::KvStore base_;
+  kvstore::KvStore cache_;
+
+  struct IndexEntry {
+    uint64_t size;
+
+    // Generation of the entry in the cache kvstore, used to ensure that an
+    // eviction does not delete a more recent entry written concurrently.
+    // Unknown for entries found when the index was initialized.
+    StorageGeneration cache_generation;
+
+    std::list<const std::string*>::iterator lru_position;
+  };
+
+  // Removes the index entry `it`, which must be valid.
+  void EraseIndexEntry(std::map<std::string, IndexEntry>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  std::map<std::string, IndexEntry> index_ ABSL_GUARDED_BY(mutex_);
+
+  // Keys of `index_`, in order of least to most recently used.
+  std::list<const std::string*> lru_ ABSL_GUARDED_BY(mutex_);
+
+  uint64_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+Future<kvstore::DriverPtr> DiskCacheKvStoreSpec::DoOpen() const {
+  auto driver = internal::MakeIntrusivePtr<DiskCacheKvStore>();
+  driver->spec_data_ = data_;
+  return PromiseFuturePair<kvstore::DriverPtr>::LinkValue(
+             [driver = std::move(driver)](
+                 Promise<kvstore::DriverPtr> promise,
+                 ReadyFuture<kvstore::KvStore> base_future,
+                 ReadyFuture<kvstore::KvStore> cache_future) mutable {
+               driver->base_ = std::move(base_future.value());
+               driver->cache_ = std::move(cache_future.value());
+               auto list_future = kvstore::ListFuture(driver->cache_);
+               LinkValue(
+                   [driver = std::move(driver)](
+                       Promise<kvstore::DriverPtr> promise,
+                       ReadyFuture<std::vector<ListEntry>> future) mutable {
+                     driver->InitializeIndex(std::move(future.value()));
+                     promise.SetResult(std::move(driver));
+                   },
+                   std::move(promise), std::move(list_future));
+             },
+             kvstore::Open(data_.base), kvstore::Open(data_.cache))
+      .future;
+}
+
+void DiskCacheKvStore::InitializeIndex(std::vector<ListEntry> entries) {
+  absl::MutexLock lock(&mutex_);
+  for (auto& entry : entries) {
+    const uint64_t size = entry.has_size() ? entry.size : 0;
+    auto [it, inserted] = index_.emplace(std::move(entry.key), IndexEntry{});
+    if (!inserted) continue;
+    it->second.size = size;
+    it->second.lru_position = lru_.insert(lru_.end(), &it->first);
+    total_bytes_ += size;
+  }
+}
+
+bool DiskCacheKvStore::Touch(std::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(std::string(key));
+  if (it == index_.end()) return false;
+  lru_.splice(lru_.end(), lru_, it->second.lru_position);
+  return true;
+}
+
+void DiskCacheKvStore::EraseIndexEntry(
+    std::map<std::string, IndexEntry>::iterator it) {
+  total_bytes_ -= it->second.size;
+  lru_.erase(it->second.lru_position);
+  index_.erase(it);
+}
+
+void DiskCacheKvStore::UpdateCache(Key key,
+                                   const TimestampedStorageGeneration& stamp,
+                                   const absl::Cord& value) {
+  absl::Cord entry = EncodeCacheEntry(stamp, value);
+  const uint64_t size = entry.size();
+  if (size > spec_data_.max_bytes) {
+    Invalidate(std::move(key));
+    return;
+  }
+  auto future = kvstore::Write(cache_, key, std::move(entry));
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+       key = std::move(key),
+       size](ReadyFuture<TimestampedStorageGeneration> future) mutable {
+        auto& r = future.result();
+        if (!r.ok() || StorageGeneration::IsUnknown(r->generation)) {
+          self->Invalidate(std::move(key));
+          return;
+        }
+        self->AddToIndex(std::move(key), size, std::move(r->generation));
+      });
+}
+
+void DiskCacheKvStore::AddToIndex(Key key, uint64_t size,
+                                  StorageGeneration cache_generation) {
+  std::vector<std::pair<std::string, StorageGeneration>> evicted;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto [it, inserted] = index_.emplace(std::move(key), IndexEntry{});
+    if (inserted) {
+      it->second.lru_position = lru_.insert(lru_.end(), &it->first);
+    } else {
+      total_bytes_ -= it->second.size;
+      lru_.splice(lru_.end(), lru_, it->second.lru_position);
+    }
+    it->second.size = size;
+    it->second.cache_generation = std::move(cache_generation);
+    total_bytes_ += size;
+    while (total_bytes_ > spec_data_.max_bytes) {
+      auto lru_it = index_.find(*lru_.front());
+      evicted.emplace_back(lru_it->first,
+                           std::move(lru_it->second.cache_generation));
+      EraseIndexEntry(lru_it);
+    }
+  }
+  for (auto& [evicted_key, generation] : evicted) {
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = std::move(generation);
+    kvstore::Delete(cache_, std::move(evicted_key), std::move(options));
+  }
+}
+
+void DiskCacheKvStore::Invalidate(Key key) {
+  kvstore::WriteOptions options;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return;
+    // Only delete the entry that was indexed, not a more recent entry written
+    // concurrently by `UpdateCache`.
+    options.generation_conditions.if_equal =
+        std::move(it->second.cache_generation);
+    EraseIndexEntry(it);
+  }
+  kvstore::Delete(cache_, std::move(key), std::move(options));
+}
+
+Future<ReadResult> DiskCacheKvStore::ReadFromBase(Key key,
+                                                  ReadOptions options) {
+  const bool update_cache =
+      options.byte_range.IsFull() && !options.generation_conditions;
+  auto future = kvstore::Read(base_, key, std::move(options));
+  if (update_cache) {
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+         key = std::move(key)](ReadyFuture<ReadResult> future) mutable {
+          auto& r = future.result();
+          if (!r.ok()) return;
+          if (r->has_value()) {
+            self->UpdateCache(std::move(key), r->stamp, r->value);
+          } else if (r->not_found()) {
+            self->Invalidate(std::move(key));
+          }
+        });
+  }
+  return future;
+}
+
+// Returns the result of a read of `value` in the cache, with generation and
+// time specified by `stamp`.
+Result<ReadResult> GetCachedReadResult(const kvstore::ReadOptions& options,
+                                       const absl::Cord& value,
+                                       TimestampedStorageGeneration stamp) {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto byte_range,
+                               options.byte_range.Validate(value.size()));
+  return ReadResult::Value(internal::GetSubCord(value, byte_range),
+                           std::move(stamp));
+}
+
+// Implements DiskCacheKvStore::Read for keys that are present in the cache.
+struct ReadState : public internal::AtomicReferenceCount<ReadState> {
+  internal::IntrusivePtr<DiskCacheKvStore> owner_;
+  kvstore::Key key_;
+  kvstore::ReadOptions options_;
+  CacheEntry entry_;
+
+  // Indicates that `key_` was found in the index.  Otherwise, the cache
+  // kvstore is shared and the entry may have been written by another process.
+  bool indexed_;
+
+  // The cache entry has been read from the cache kvstore.
+  void OnCacheRead(Promise<ReadResult> promise,
+                   ReadyFuture<ReadResult> ready) {
+    if (!promise.result_needed()) return;
+    Result<CacheEntry> entry = absl::NotFoundError("");
+    if (ready.result().ok() && ready.value().has_value()) {
+      entry = DecodeCacheEntry(ready.value().value);
+    }
+    if (!entry.ok()) {
+      // The entry was evicted concurrently, or is corrupt.
+      if (indexed_) owner_->Invalidate(key_);
+      LinkResult(std::move(promise),
+                 owner_->ReadFromBase(std::move(key_), std::move(options_)));
+      return;
+    }
+    if (!indexed_) {
+      owner_->AddToIndex(key_, ready.value().value.size(),
+                         ready.value().stamp.generation);
+    }
+    entry_ = *std::move(entry);
+
+    if (entry_.stamp.time >= options_.staleness_bound) {
+      promise.SetResult(
+          GetCachedReadResult(options_, entry_.value, entry_.stamp));
+      return;
+    }
+
+    // Revalidate the cached value.  The value is only transferred from the
+    // base kvstore if it has changed.
+    kvstore::ReadOptions options = options_;
+    options.generation_conditions.if_not_equal = entry_.stamp.generation;
+    Link(
+        [self = internal::IntrusivePtr<ReadState>(this)](
+            Promise<ReadResult> promise, ReadyFuture<ReadResult> ready) {
+          self->OnRevalidated(std::move(promise), std::move(ready));
+        },
+        std::move(promise), kvstore::Read(owner_->base_, key_, options));
+  }
+
+  void OnRevalidated(Promise<ReadResult> promise,
+                     ReadyFuture<ReadResult> ready) {
+    if (!promise.result_needed()) return;
+    auto& r = ready.result();
+    if (!r.ok()) {
+      promise.SetResult(r.status());
+      return;
+    }
+    if (r->aborted()) {
+      // The cached value is still current.  Persist the refreshed time, so that
+      // subsequent reads with a staleness bound up to that time are served from
+      // the cache without revalidating again.
+      owner_->UpdateCache(
+          std::move(key_),
+          TimestampedStorageGeneration{entry_.stamp.generation, r->stamp.time},
+          entry_.value);
+      promise.SetResult(
+          GetCachedReadResult(options_, entry_.value, std::move(r->stamp)));
+      return;
+    }
+    if (r->has_value() && options_.byte_range.IsFull()) {
+      owner_->UpdateCache(std::move(key_), r->stamp, r->value);
+    } else {
+      owner_->Invalidate(std::move(key_));
+    }
+    promise.SetResult(std::move(r));
+  }
+};
+
+Future<ReadResult> DiskCacheKvStore::Read(Key key, ReadOptions options) {
+  if (options.generation_conditions) {
+    return ReadFromBase(std::move(key), std::move(options));
+  }
+  const bool indexed = Touch(key);
+  if (!indexed && !spec_data_.shared) {
+    return ReadFromBase(std::move(key), std::move(options));
+  }
+  auto state = internal::MakeIntrusivePtr<ReadState>();
+  state->owner_ = internal::IntrusivePtr<DiskCacheKvStore>(this);
+  state->key_ = key;
+  state->options_ = std::move(options);
+  state->indexed_ = indexed;
+  return PromiseFuturePair<ReadResult>::Link(
+             [state = std::move(state)](Promise<ReadResult> promise,
+                                        ReadyFuture<ReadResult> ready) {
+               state->OnCacheRead(std::move(promise), std::move(ready));
+             },
+             kvstore::Read(cache_, std::move(key)))
+      .future;
+}
+
+Future<TimestampedStorageGeneration> DiskCacheKvStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  auto future = kvstore::Write(base_, key, value, std::move(options));
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<DiskCacheKvStore>(this),
+       key = std::move(key), value = std::move(value)](
+          ReadyFuture<TimestampedStorageGeneration> future) mutable {
+        auto& r = future.result();
+        if (!r.ok() || StorageGeneration::IsUnknown(r->generation)) {
+          // The write failed, or its generation conditions were not
+          // satisfied; the base kvstore is unchanged.
+          return;
+        }
+        if (value) {
+          self->UpdateCache(std::move(key), *r, *value);
+        } else {
+          self->Invalidate(std::move(key));
+        }
+      });
+  return future;
+}
+
+Future<const void> DiskCacheKvStore::DeleteRange(KeyRange range) {
+  {
+    absl::MutexLock lock(&mutex_);
+    for (auto it = index_.lower_bound(range.inclusive_min);
+         it != index_.end() &&
+         KeyRange::CompareKeyAndExclusiveMax(it->first, range.exclusive_max) <
+             0;) {
+      EraseIndexEntry(it++);
+    }
+  }
+  auto cache_future = kvstore::DeleteRange(cache_, range);
+  return WaitAllFuture(kvstore::DeleteRange(base_, std::move(range)),
+                       std::move(cache_future));
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::DiskCacheKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::DiskCacheKvStoreSpec>
+    registration;
+}  // namespace
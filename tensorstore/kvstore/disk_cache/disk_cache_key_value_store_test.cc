@@ -0,0 +1,248 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+
+using ::tensorstore::Context;
+using ::tensorstore::internal::GetMap;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::kvstore::KvStore;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+class DiskCacheKvStoreTest : public ::testing::Test {
+ public:
+  DiskCacheKvStoreTest() : context_(Context::Default()) {
+    base_ = kvstore::Open("memory://base/", context_).value();
+    cache_ = kvstore::Open("memory://cache/", context_).value();
+  }
+
+  KvStore Open(size_t max_bytes = 1000000, bool shared = false) {
+    return kvstore::Open({{"driver", "disk_cache"},
+                          {"base", "memory://base/"},
+                          {"cache", "memory://cache/"},
+                          {"max_bytes", max_bytes},
+                          {"shared", shared}},
+                         context_)
+        .value();
+  }
+
+  Context context_;
+  KvStore base_;
+  KvStore cache_;
+};
+
+TEST_F(DiskCacheKvStoreTest, Basic) {
+  auto store = Open();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST_F(DiskCacheKvStoreTest, DeleteRange) {
+  auto store = Open();
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST_F(DiskCacheKvStoreTest, DeletePrefix) {
+  auto store = Open();
+  tensorstore::internal::TestKeyValueStoreDeletePrefix(store);
+}
+
+TEST_F(DiskCacheKvStoreTest, List) {
+  auto store = Open();
+  tensorstore::internal::TestKeyValueStoreList(store);
+}
+
+TEST_F(DiskCacheKvStoreTest, SpecRoundtrip) {
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {{"driver", "disk_cache"},
+                       {"base", {{"driver", "memory"}, {"path", "base/"}}},
+                       {"cache", {{"driver", "memory"}, {"path", "cache/"}}},
+                       {"max_bytes", 1000},
+                       {"shared", true}};
+  options.full_base_spec = {{"driver", "memory"}, {"path", "base/"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST_F(DiskCacheKvStoreTest, InvalidSpec) {
+  EXPECT_THAT(kvstore::Open({{"driver", "disk_cache"},
+                             {"base", "memory://base/"},
+                             {"cache", "memory://cache/"},
+                             {"max_bytes", 0}},
+                            context_)
+                  .result(),
+              tensorstore::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(DiskCacheKvStoreTest, ReadPopulatesCache) {
+  auto store = Open();
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "a", absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre(Pair("a", ::testing::_)));
+
+  // Byte range reads are served from the cached value.
+  kvstore::ReadOptions options;
+  options.byte_range = tensorstore::OptionalByteRangeRequest::Range(1, 3);
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("al")));
+}
+
+TEST_F(DiskCacheKvStoreTest, RevalidatesStaleEntries) {
+  auto store = Open();
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "a", absl::Cord("old")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("old")));
+
+  // Modify the base kvstore directly, bypassing the cache.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "a", absl::Cord("new")));
+
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::InfinitePast();
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("old")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("new")));
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("new")));
+
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(base_, "a"));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre());
+}
+
+TEST_F(DiskCacheKvStoreTest, RevalidationPersistsStamp) {
+  auto store = Open();
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "a", absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+
+  // Revalidation finds that the cached value is unchanged.
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::Now();
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+
+  // Subsequent reads with the same staleness bound are served from the cache
+  // without revalidating.
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(base_, "a"));
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST_F(DiskCacheKvStoreTest, WriteThrough) {
+  auto store = Open();
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(base_, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre(Pair("a", ::testing::_)));
+
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "a"));
+  EXPECT_THAT(kvstore::Read(base_, "a").result(),
+              MatchesKvsReadResultNotFound());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre());
+}
+
+TEST_F(DiskCacheKvStoreTest, EvictsLeastRecentlyUsed) {
+  const std::string value(100, 'x');
+  // Room for two entries, including their headers.
+  auto store = Open(300);
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord(value)));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord(value)));
+  TENSORSTORE_ASSERT_OK(kvstore::Read(store, "a").result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "c", absl::Cord(value)));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre(Pair("a", ::testing::_),
+                                  Pair("c", ::testing::_)));
+
+  // Evicted entries are still read from the base kvstore.
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResult(absl::Cord(value)));
+}
+
+TEST_F(DiskCacheKvStoreTest, EntriesTooLargeAreNotCached) {
+  auto store = Open(50);
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "a", absl::Cord(std::string(100, 'x'))));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto cached, GetMap(cache_));
+  EXPECT_THAT(cached, ElementsAre());
+}
+
+TEST_F(DiskCacheKvStoreTest, ExistingEntriesUsedOnOpen) {
+  {
+    auto store = Open();
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("value")));
+  }
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(base_, "a"));
+
+  // A different `max_bytes` ensures that a new driver is opened, which must
+  // build its index from the existing contents of the cache kvstore.
+  auto store = Open(2000000);
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::InfinitePast();
+  EXPECT_THAT(kvstore::Read(store, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST_F(DiskCacheKvStoreTest, SharedCacheUsesEntriesWrittenConcurrently) {
+  // Different values of `max_bytes` ensure that separate drivers are opened,
+  // as when each process of a data loader opens its own driver.
+  auto store1 = Open(1000000, /*shared=*/true);
+  auto store2 = Open(2000000, /*shared=*/true);
+  auto unshared_store = Open(3000000);
+
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "a", absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(store1, "a").result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(base_, "a"));
+
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::InfinitePast();
+  EXPECT_THAT(kvstore::Read(store2, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("value")));
+  EXPECT_THAT(kvstore::Read(unshared_store, "a", options).result(),
+              MatchesKvsReadResultNotFound());
+}
+
+}  // namespace
@@ -71,7 +71,8 @@
 ///       write attempt that terminated unexpectedly) and write the new
 ///       contents.
 ///
-///    b. `fsync` the lock file.
+///    b. `fsync` the lock file (`fdatasync` where available, since the file
+///       is new or truncated and only its data and size need to be durable).
 ///
 ///    c. Rename the lock file to the actual data path.
 ///
@@ -79,26 +80,55 @@
 ///
 /// 8. `fsync` the parent directory of the file (to ensure the `unlink` or
 ///    `rename` operations are durable).  This step is skipped on MS Windows,
-///    where `fsync` is not supported for directories.
+///    where `fsync` is not supported for directories.  Concurrent writes to the
+///    same directory share a single directory `fsync` (group commit), as
+///    described by `DirectorySyncGroups`.
+///
+/// If the ``append_in_place`` option is enabled, a conditional write that
+/// specifies `WriteOptions::unchanged_prefix_length` equal to the size of the
+/// existing file instead appends just the new suffix to the existing file (with
+/// the lock acquired as above), and then removes the lock file.  This avoids
+/// rewriting the unchanged prefix, but is not atomic.  The file size is
+/// included in the storage generation, since the device/volume identifier and
+/// inode number are unchanged by such a write.
+///
+/// If the ``exclusive_writer`` option is enabled, the caller guarantees that no
+/// other process writes to the store, and writes are serialized by an
+/// in-process mutex (selected by the hash of the path) in place of the lock
+/// file.  Where supported (Linux `O_TMPFILE`), the new value is written to an
+/// anonymous file in the parent directory, which is then published: if the key
+/// does not exist, by linking it directly at the data path (an atomic
+/// create-if-absent); otherwise by linking it at the lock file path and
+/// renaming that to the data path.  Deletes only remove the data path.
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <memory>
+#include <new>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>  // NOLINT
 #include <tuple>  // IWYU pragma: keep for std::get<>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
+#include "absl/hash/hash.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/batch.h"
@@ -110,6 +140,7 @@
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
@@ -119,15 +150,19 @@
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
+#include "tensorstore/kvstore/copy_range_util.h"
 #include "tensorstore/kvstore/file/util.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/url_registry.h"
+#include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
@@ -141,6 +176,7 @@
 // Include these last to reduce impact of macros.
 #include "tensorstore/internal/os/file_lister.h"
 #include "tensorstore/internal/os/file_util.h"
+#include "tensorstore/internal/os/io_uring.h"
 
 /// On FreeBSD and Mac OS X, `flock` can safely be used instead of open file
 /// descriptor locks.  `flock`/`fcntl`/`lockf` all use the same underlying lock
@@ -163,11 +199,13 @@
 /// `MapFuture`.
 
 using ::tensorstore::internal::OsErrorCode;
+using ::tensorstore::internal::StatusFromOsError;
 using ::tensorstore::internal_file_util::IsKeyValid;
 using ::tensorstore::internal_file_util::LongestDirectoryPrefix;
 using ::tensorstore::internal_metrics::MetricMetadata;
 using ::tensorstore::internal_os::FileDescriptor;
 using ::tensorstore::internal_os::FileInfo;
+using ::tensorstore::internal_os::IoUringOperation;
 using ::tensorstore::internal_os::kLockSuffix;
 using ::tensorstore::internal_os::UniqueFileDescriptor;
 using ::tensorstore::kvstore::ListEntry;
@@ -180,15 +218,7 @@ namespace internal_file_kvstore {
 namespace {
 namespace jb = tensorstore::internal_json_binding;
 
-auto& file_bytes_read = internal_metrics::Counter<int64_t>::New(
-    "/tensorstore/kvstore/file/bytes_read",
-    MetricMetadata("Bytes read by the file kvstore driver",
-                   internal_metrics::Units::kBytes));
-
-auto& file_bytes_written = internal_metrics::Counter<int64_t>::New(
-    "/tensorstore/kvstore/file/bytes_written",
-    MetricMetadata("Bytes written by the file kvstore driver",
-                   internal_metrics::Units::kBytes));
+auto file_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(file);
 
 auto& file_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/read",
@@ -206,10 +236,18 @@ auto& file_write = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/write",
     MetricMetadata("file driver kvstore::Write calls"));
 
+auto& file_write_in_place = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/file/write_in_place",
+    MetricMetadata("file driver writes performed by appending in place"));
+
 auto& file_delete_range = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/delete_range",
     MetricMetadata("file driver kvstore::DeleteRange calls"));
 
+auto& file_copy_range = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/file/copy_range",
+    MetricMetadata("file driver kvstore::ExperimentalCopyRange calls"));
+
 auto& file_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/list",
     MetricMetadata("file driver kvstore::List calls"));
@@ -218,6 +256,10 @@ auto& file_lock_contention = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/file/lock_contention",
     MetricMetadata("file driver write lock contention"));
 
+auto& file_write_anonymous = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/file/write_anonymous",
+    MetricMetadata("file driver writes published from an anonymous file"));
+
 ABSL_CONST_INIT internal_log::VerboseFlag file_logging("file");
 
 struct FileIoSyncResource
@@ -237,12 +279,60 @@ struct FileIoSyncResource
   }
 };
 
+enum class FileIoEngine {
+  kBlocking,
+  kIoUring,
+};
+
+struct FileIoEngineResource
+    : public internal::ContextResourceTraits<FileIoEngineResource> {
+  static constexpr char id[] = "file_io_engine";
+  using Spec = FileIoEngine;
+  struct Resource {
+    Spec spec;
+    // Null if `spec` is `kBlocking` or io_uring is not available, in which
+    // case blocking I/O is performed on the `file_io_concurrency` executor.
+    std::shared_ptr<internal_os::IoUring> io_uring;
+  };
+  static Spec Default() { return FileIoEngine::kBlocking; }
+  static constexpr auto JsonBinder() {
+    return jb::Enum<FileIoEngine, std::string_view>({
+        {FileIoEngine::kBlocking, "blocking"},
+        {FileIoEngine::kIoUring, "io_uring"},
+    });
+  }
+  static Result<Resource> Create(
+      Spec v, internal::ContextResourceCreationContext context) {
+    Resource resource{v};
+    if (v == FileIoEngine::kIoUring) {
+      auto io_uring = internal_os::IoUring::Create();
+      if (io_uring.ok()) {
+        resource.io_uring = std::move(*io_uring);
+      } else {
+        ABSL_LOG_IF(INFO, file_logging)
+            << "Falling back to blocking file I/O: " << io_uring.status();
+      }
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
 struct FileKeyValueStoreSpecData {
   Context::Resource<internal::FileIoConcurrencyResource> file_io_concurrency;
   Context::Resource<FileIoSyncResource> file_io_sync;
+  Context::Resource<FileIoEngineResource> file_io_engine;
+  bool mmap = false;
+  bool direct_io = false;
+  bool append_in_place = false;
+  bool exclusive_writer = false;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(x.file_io_concurrency, x.file_io_sync);
+    return f(x.file_io_concurrency, x.file_io_sync, x.file_io_engine, x.mmap,
+             x.direct_io, x.append_in_place, x.exclusive_writer);
   };
 
   // TODO(jbms): Storing a UNIX path as a JSON string presents a challenge
@@ -265,11 +355,96 @@ struct FileKeyValueStoreSpecData {
           internal::FileIoConcurrencyResource::id,
           jb::Projection<&FileKeyValueStoreSpecData::file_io_concurrency>()),
       jb::Member(FileIoSyncResource::id,
-                 jb::Projection<&FileKeyValueStoreSpecData::file_io_sync>())
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_sync>()),
+      jb::Member(FileIoEngineResource::id,
+                 jb::Projection<&FileKeyValueStoreSpecData::file_io_engine>()),
+      jb::Member("mmap", jb::Projection<&FileKeyValueStoreSpecData::mmap>(
+                             jb::DefaultValue([](auto* v) { *v = false; }))),
+      jb::Member("direct_io",
+                 jb::Projection<&FileKeyValueStoreSpecData::direct_io>(
+                     jb::DefaultValue([](auto* v) { *v = false; }))),
+      jb::Member("append_in_place",
+                 jb::Projection<&FileKeyValueStoreSpecData::append_in_place>(
+                     jb::DefaultValue([](auto* v) { *v = false; }))),
+      jb::Member("exclusive_writer",
+                 jb::Projection<&FileKeyValueStoreSpecData::exclusive_writer>(
+                     jb::DefaultValue([](auto* v) { *v = false; })))
       //
   );
 };
 
+/// Coalesces concurrent `fsync` calls on the same directory (group commit).
+///
+/// An `fsync` of a directory makes durable every `rename` and `unlink` in the
+/// directory that completed before it started.  Each caller that needs its own
+/// `rename` or `unlink` to be durable takes a ticket; a single `fsync` started
+/// after the most recent ticket was issued then satisfies all callers holding
+/// a ticket up to that point, while callers that arrive during the `fsync`
+/// wait for the next one.
+class DirectorySyncGroups {
+ public:
+  /// Blocks until an `fsync` of the directory `dir_path` (open as `dir_fd`)
+  /// that started after this call has completed, and returns its status.
+  absl::Status Sync(const std::string& dir_path, FileDescriptor dir_fd) {
+    absl::MutexLock lock(&mutex_);
+    auto& group_ptr = groups_[dir_path];
+    if (!group_ptr) group_ptr = std::make_unique<Group>();
+    Group& group = *group_ptr;
+    ++group.waiters;
+    const uint64_t ticket = ++group.requested;
+    while (group.completed < ticket) {
+      if (!group.in_progress) {
+        group.in_progress = true;
+        const uint64_t target = group.requested;
+        mutex_.Unlock();
+        auto status = internal_os::FsyncDirectory(dir_fd);
+        mutex_.Lock();
+        group.in_progress = false;
+        group.completed = target;
+        group.status = std::move(status);
+        continue;
+      }
+      std::pair<Group*, uint64_t> wait_state(&group, ticket);
+      mutex_.Await(absl::Condition(
+          +[](std::pair<Group*, uint64_t>* state) {
+            return state->first->completed >= state->second ||
+                   !state->first->in_progress;
+          },
+          &wait_state));
+    }
+    absl::Status status = group.status;
+    if (--group.waiters == 0) groups_.erase(dir_path);
+    return status;
+  }
+
+ private:
+  struct Group {
+    // Number of `Sync` calls in progress for this directory.
+    size_t waiters = 0;
+    // Number of tickets issued.
+    uint64_t requested = 0;
+    // All tickets up to this value are satisfied by the most recent `fsync`.
+    uint64_t completed = 0;
+    bool in_progress = false;
+    // Status of the most recent `fsync`.
+    absl::Status status;
+  };
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<Group>> groups_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+/// Returns the path of the directory containing `path`, as opened by
+/// `OpenParentDirectory`.
+std::string GetParentDirectoryPath(std::string_view path) {
+  size_t pos = path.size();
+  while (pos != 0 && !internal_os::IsDirSeparator(path[pos - 1])) --pos;
+  if (pos == 0) return ".";
+  if (pos == 1) return std::string(path.substr(0, 1));
+  return std::string(path.substr(0, pos - 1));
+}
+
 class FileKeyValueStoreSpec
     : public internal_kvstore::RegisteredDriverSpec<FileKeyValueStoreSpec,
                                                     FileKeyValueStoreSpecData> {
@@ -293,12 +468,32 @@ class FileKeyValueStore
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
+  Future<TimestampedStorageGeneration> WriteImpl(Key key,
+                                                 std::optional<Value> value,
+                                                 WriteOptions options);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
+  Future<const void> ExperimentalCopyRangeFrom(
+      const internal::OpenTransactionPtr& transaction, const KvStore& source,
+      Key target_prefix, kvstore::CopyRangeOptions options) override;
+
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
   const Executor& executor() { return spec_.file_io_concurrency->executor; }
 
+  /// Returns the options for listing directories concurrently on the
+  /// `file_io_concurrency` executor.
+  internal_os::ParallelFileListOptions list_options() {
+    internal_os::ParallelFileListOptions options;
+    options.executor = executor();
+    // Matches the size of the shared `file_io_concurrency` pool used when no
+    // limit is specified.
+    options.concurrency = spec_.file_io_concurrency->spec.limit.value_or(
+        std::max(size_t(4), size_t(std::thread::hardware_concurrency())));
+    return options;
+  }
+
   std::string DescribeKey(std::string_view key) override {
     return tensorstore::StrCat("local file ", tensorstore::QuoteString(key));
   }
@@ -310,13 +505,29 @@ class FileKeyValueStore
 
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
-    return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+    auto features = SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
+                    SupportedFeatures::kAtomicWriteWithoutOverwrite;
+    if (spec_.append_in_place) {
+      features = features | SupportedFeatures::kAppendInPlace;
+    }
+    return features;
   }
 
   bool sync() const { return *spec_.file_io_sync; }
 
+  const std::shared_ptr<DirectorySyncGroups>& directory_sync() const {
+    return directory_sync_;
+  }
+
+  /// Returns the io_uring used for reads and writes, or `nullptr` if blocking
+  /// I/O is used.
+  internal_os::IoUring* io_uring() const {
+    return spec_.file_io_engine->io_uring.get();
+  }
+
   SpecData spec_;
+  std::shared_ptr<DirectorySyncGroups> directory_sync_ =
+      std::make_shared<DirectorySyncGroups>();
 };
 
 absl::Status ValidateKey(std::string_view key) {
@@ -335,9 +546,13 @@ absl::Status ValidateKeyRange(const KeyRange& range) {
 
 // Encode in the generation fields that uniquely identify the file.
 StorageGeneration GetFileGeneration(const FileInfo& info) {
+  // The size is included since a file updated in place (see
+  // `WriteTask::AppendInPlace`) retains its file id, and the modification time
+  // may have coarse granularity.
   return StorageGeneration::FromValues(
       internal_os::GetDeviceId(info), internal_os::GetFileId(info),
-      absl::ToUnixNanos(internal_os::GetMTime(info)));
+      absl::ToUnixNanos(internal_os::GetMTime(info)),
+      internal_os::GetSize(info));
 }
 
 /// RAII lock on an open file.
@@ -441,6 +656,17 @@ Result<UniqueFileDescriptor> OpenValueFile(const char* path,
   return fd;
 }
 
+/// Returns the mutex that serializes writes to `full_path` within this process
+/// if the ``exclusive_writer`` option is enabled.
+///
+/// A fixed number of mutexes is shared by all paths, such that unrelated keys
+/// only rarely contend.
+absl::Mutex& GetExclusiveWriterMutex(std::string_view full_path) {
+  constexpr size_t kNumMutexes = 256;
+  static absl::Mutex* const mutexes = new absl::Mutex[kNumMutexes];
+  return mutexes[absl::HashOf(full_path) % kNumMutexes];
+}
+
 /// Helper class to acquire write lock for the specified path.
 struct WriteLockHelper {
   std::string lock_path;  // Composed write lock file path.
@@ -515,7 +741,7 @@ Result<absl::Cord> ReadFromFileDescriptor(FileDescriptor fd,
                                           buffer.size() - offset,
                                           byte_range.inclusive_min + offset));
     if (n > 0) {
-      file_bytes_read.IncrementBy(n);
+      file_metrics.bytes_read.IncrementBy(n);
       offset += n;
       buffer.set_inuse(offset);
       continue;
@@ -564,9 +790,18 @@ class BatchReadTask final
     TENSORSTORE_ASSIGN_OR_RETURN(
         value, ReadFromFileDescriptor(fd_.get(), byte_range),
         tensorstore::MaybeAnnotateStatus(_, "Error reading from open file"));
+    MaybeDropCachedRange(byte_range);
     return kvstore::ReadResult::Value(std::move(value), stamp_);
   }
 
+  /// With `direct_io`, allows the page cache to drop the pages just read,
+  /// since streaming reads are unlikely to be repeated.
+  void MaybeDropCachedRange(ByteRange byte_range) {
+    if (!driver().spec_.direct_io) return;
+    internal_os::AdviseFileDontNeed(fd_.get(), byte_range.inclusive_min,
+                                    byte_range.size());
+  }
+
   void ProcessBatch() {
     stamp_.time = absl::Now();
     file_open_read.Increment();
@@ -586,6 +821,11 @@ class BatchReadTask final
                                                              size_);
 
     if (requests.empty()) return;
+    if (driver().spec_.mmap && ProcessMmapBatch()) return;
+    if (auto* io_uring = driver().io_uring()) {
+      SubmitIoUringReads(*io_uring);
+      return;
+    }
     if (requests.size() == 1) {
       auto& byte_range_request =
           std::get<internal_kvstore_batch::ByteRangeReadRequest>(requests[0]);
@@ -620,6 +860,129 @@ class BatchReadTask final
     internal_kvstore_batch::ResolveCoalescedRequests(
         coalesced_byte_range, coalesced_requests, std::move(read_result));
   }
+
+  /// Resolves all requests from a single memory mapping of the file, without
+  /// copying.
+  ///
+  /// Values are never modified in place (they are replaced by `rename`), so
+  /// the mapping remains valid for as long as the returned cords are alive.
+  ///
+  /// \returns `false` if the file could not be mapped, in which case it is
+  ///     read normally.
+  bool ProcessMmapBatch() {
+    auto& requests = request_batch.requests;
+    int64_t inclusive_min = size_;
+    int64_t exclusive_max = 0;
+    for (auto& request : requests) {
+      auto byte_range =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(request)
+              .byte_range.AsByteRange();
+      inclusive_min = std::min(inclusive_min, byte_range.inclusive_min);
+      exclusive_max = std::max(exclusive_max, byte_range.exclusive_max);
+    }
+    if (inclusive_min > exclusive_max) inclusive_min = exclusive_max;
+    auto mapped = internal_os::MemmapFileReadOnly(
+        fd_.get(), inclusive_min, exclusive_max - inclusive_min);
+    if (!mapped.ok()) {
+      ABSL_LOG_IF(INFO, file_logging) << mapped.status();
+      return false;
+    }
+    file_batch_read.Increment();
+    for (auto& request : requests) {
+      auto& byte_range_request =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(request);
+      auto byte_range = byte_range_request.byte_range.AsByteRange();
+      file_metrics.bytes_read.IncrementBy(byte_range.size());
+      byte_range.inclusive_min -= inclusive_min;
+      byte_range.exclusive_max -= inclusive_min;
+      byte_range_request.promise.SetResult(kvstore::ReadResult::Value(
+          internal::GetSubCord(*mapped, byte_range), stamp_));
+    }
+    return true;
+  }
+
+  /// State of a single coalesced read performed using io_uring.
+  struct IoUringRead {
+    internal::IntrusivePtr<BatchReadTask> self;
+    ByteRange byte_range;
+    span<Request> requests;
+    internal::FlatCordBuilder buffer;
+    size_t offset = 0;
+    absl::Status status;
+
+    static IoUringOperation MakeOperation(std::unique_ptr<IoUringRead> read) {
+      IoUringOperation op;
+      op.opcode = IoUringOperation::Opcode::kRead;
+      op.fd = read->self->fd_.get();
+      op.buffer = read->buffer.data() + read->offset;
+      op.size = read->buffer.size() - read->offset;
+      op.offset = read->byte_range.inclusive_min + read->offset;
+      op.callback = [read = std::move(read)](int64_t result) mutable {
+        OnComplete(std::move(read), result);
+      };
+      return op;
+    }
+
+    // Called from the io_uring completion thread.
+    static void OnComplete(std::unique_ptr<IoUringRead> read, int64_t result) {
+      auto& buffer = read->buffer;
+      if (result > 0) {
+        file_metrics.bytes_read.IncrementBy(result);
+        read->offset += result;
+        buffer.set_inuse(read->offset);
+        if (read->offset < buffer.size()) {
+          // Resubmit the remainder of a short read.
+          auto& io_uring = *read->self->driver().io_uring();
+          auto op = MakeOperation(std::move(read));
+          io_uring.Submit(span(&op, 1));
+          return;
+        }
+      } else if (result == 0) {
+        read->status = absl::UnavailableError("Length changed while reading");
+      } else {
+        read->status =
+            StatusFromOsError(-result, "Error reading from open file");
+      }
+      // Resolve the promises on the executor rather than on the completion
+      // thread, which must not run arbitrary continuations.
+      Executor executor = read->self->driver().executor();
+      executor([read = std::move(read)] { read->Resolve(); });
+    }
+
+    void Resolve() {
+      if (!status.ok()) {
+        internal_kvstore_batch::SetCommonResult(requests, std::move(status));
+        return;
+      }
+      self->MaybeDropCachedRange(byte_range);
+      internal_kvstore_batch::ResolveCoalescedRequests(
+          byte_range, requests,
+          kvstore::ReadResult::Value(std::move(buffer).Build(), self->stamp_));
+    }
+  };
+
+  /// Submits all of the (coalesced) byte range reads of the batch to `io_uring`
+  /// together.
+  void SubmitIoUringReads(internal_os::IoUring& io_uring) {
+    std::vector<IoUringOperation> ops;
+    internal_kvstore_batch::CoalescingOptions coalescing_options;
+    coalescing_options.max_extra_read_bytes = 255;
+    internal_kvstore_batch::ForEachCoalescedRequest<Request>(
+        request_batch.requests, coalescing_options,
+        [&](ByteRange coalesced_byte_range, span<Request> coalesced_requests) {
+          file_batch_read.Increment();
+          auto read = std::make_unique<IoUringRead>(IoUringRead{
+              internal::IntrusivePtr<BatchReadTask>(this), coalesced_byte_range,
+              coalesced_requests,
+              internal::FlatCordBuilder(coalesced_byte_range.size(), 0)});
+          if (read->buffer.size() == 0) {
+            read->Resolve();
+            return;
+          }
+          ops.push_back(IoUringRead::MakeOperation(std::move(read)));
+        });
+    io_uring.Submit(ops);
+  }
 };
 
 Future<ReadResult> FileKeyValueStore::Read(Key key, ReadOptions options) {
@@ -630,7 +993,8 @@ Future<ReadResult> FileKeyValueStore::Read(Key key, ReadOptions options) {
       *this, {std::move(key)}, options.batch, options.staleness_bound,
       BatchReadTask::Request{{std::move(promise), options.byte_range},
                              std::move(options.generation_conditions)});
-  return std::move(future);
+  return internal_kvstore::RecordReadMetrics(file_metrics, std::move(future),
+                                             /*count_bytes=*/false);
 }
 
 /// Implements `FileKeyValueStore::Write`.
@@ -639,79 +1003,451 @@ struct WriteTask {
   absl::Cord value;
   kvstore::WriteOptions options;
   bool sync;
+  bool direct_io;
+  bool append_in_place;
+  std::shared_ptr<DirectorySyncGroups> directory_sync;
+  /// Serialize writes using `GetExclusiveWriterMutex` rather than lock files.
+  bool exclusive_writer = false;
+
+  /// Returns `true` if `AppendInPlace` should be attempted.
+  bool MayAppendInPlace() const {
+    return append_in_place && options.unchanged_prefix_length != 0 &&
+           options.unchanged_prefix_length <= value.size() &&
+           !StorageGeneration::IsUnknown(
+               options.generation_conditions.if_equal);
+  }
+
+  /// Updates the existing file in place by appending only the suffix of
+  /// `value` that follows `options.unchanged_prefix_length`.
+  ///
+  /// This is possible only if the existing file matches the generation
+  /// condition and has a size equal to the unchanged prefix length.  Must be
+  /// called with the write lock held.
+  ///
+  /// \returns `std::nullopt` if the file cannot be updated in place.
+  Result<std::optional<StorageGeneration>> AppendInPlace() const {
+    const uint64_t prefix_length = options.unchanged_prefix_length;
+    {
+      StorageGeneration generation;
+      int64_t size;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor value_fd,
+          OpenValueFile(full_path.c_str(), &generation, &size));
+      if (!value_fd.valid() ||
+          generation != options.generation_conditions.if_equal ||
+          static_cast<uint64_t>(size) != prefix_length) {
+        return std::nullopt;
+      }
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        UniqueFileDescriptor fd,
+        internal_os::OpenExistingFileForAppending(full_path));
+    absl::Cord suffix = value.Subcord(prefix_length, value.size());
+    while (!suffix.empty()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto n, internal_os::WriteCordToFile(fd.get(), suffix),
+          MaybeAnnotateStatus(_, tensorstore::StrCat("Failed writing: ",
+                                                     QuoteString(full_path))));
+      file_metrics.bytes_written.IncrementBy(n);
+      suffix.RemovePrefix(n);
+    }
+    if (this->sync) {
+      TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFileData(fd.get()));
+    }
+    file_write_in_place.Increment();
+    FileInfo info;
+    TENSORSTORE_RETURN_IF_ERROR(internal_os::GetFileInfo(fd.get(), &info));
+    return GetFileGeneration(info);
+  }
+
+  /// Checks the generation condition and truncates the locked lock file if
+  /// necessary.
+  ///
+  /// \returns `false` if the condition is not satisfied.
+  Result<bool> PrepareLockFile(WriteLockHelper& lock_helper) const {
+    if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal)) {
+      StorageGeneration generation;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor value_fd,
+          OpenValueFile(full_path.c_str(), &generation));
+      if (generation != options.generation_conditions.if_equal) {
+        return false;
+      }
+    }
+    if (internal_os::GetSize(lock_helper.info) > value.size()) {
+      // Only truncate when the file is larger. In the common path, the lock
+      // file is newly created, so truncate is useless.
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_os::TruncateFile(lock_helper.lock_fd.get()));
+    }
+    return true;
+  }
+
+  absl::Status WriteLockFile(WriteLockHelper& lock_helper) const {
+    absl::Cord value_for_write = value;
+    if (direct_io) {
+      TENSORSTORE_RETURN_IF_ERROR(
+          WriteAlignedPrefixDirect(lock_helper, value_for_write));
+    }
+    for (; !value_for_write.empty();) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto n,
+          internal_os::WriteCordToFile(lock_helper.lock_fd.get(),
+                                       value_for_write),
+          MaybeAnnotateStatus(
+              _, tensorstore::StrCat("Failed writing: ",
+                                     QuoteString(lock_helper.lock_path))));
+      file_metrics.bytes_written.IncrementBy(n);
+      if (n == value_for_write.size()) break;
+      value_for_write.RemovePrefix(n);
+    }
+    return absl::OkStatus();
+  }
+
+  /// Writes the largest prefix of `value_for_write` whose size is a multiple of
+  /// `kDirectIoAlignment` using direct I/O, which bypasses the page cache, and
+  /// removes it from `value_for_write`.  The remaining unaligned tail is
+  /// written normally by the caller.
+  ///
+  /// If direct I/O is not supported by the platform or filesystem, nothing is
+  /// written and the entire value is written normally.
+  absl::Status WriteAlignedPrefixDirect(WriteLockHelper& lock_helper,
+                                        absl::Cord& value_for_write) const {
+    constexpr size_t kAlignment = internal_os::kDirectIoAlignment;
+    // Size of the aligned staging buffer into which the value is copied.
+    constexpr size_t kMaxBufferSize = 8 * 1024 * 1024;
+    const size_t aligned_size =
+        value_for_write.size() - value_for_write.size() % kAlignment;
+    if (aligned_size == 0) return absl::OkStatus();
+    const FileDescriptor fd = lock_helper.lock_fd.get();
+    if (auto status = internal_os::SetFileDirectIo(fd, true); !status.ok()) {
+      ABSL_LOG_IF(INFO, file_logging) << status;
+      return absl::OkStatus();
+    }
+    internal::FlatCordBuilder buffer(std::min(aligned_size, kMaxBufferSize), 0,
+                                     std::align_val_t(kAlignment));
+    size_t written = 0;
+    while (written < aligned_size) {
+      const size_t block_size = std::min(aligned_size - written, buffer.size());
+      buffer.set_inuse(0);
+      for (std::string_view chunk :
+           value_for_write.Subcord(written, block_size).Chunks()) {
+        buffer.Append(chunk);
+      }
+      size_t offset = 0;
+      while (offset < block_size) {
+        auto n = internal_os::WriteToFile(fd, buffer.data() + offset,
+                                          block_size - offset);
+        if (!n.ok()) {
+          // Some filesystems only reject direct I/O when writing.
+          if (absl::IsInvalidArgument(n.status()) && (written + offset) == 0) {
+            break;
+          }
+          return MaybeAnnotateStatus(
+              n.status(),
+              tensorstore::StrCat("Failed writing: ",
+                                  QuoteString(lock_helper.lock_path)));
+        }
+        file_metrics.bytes_written.IncrementBy(*n);
+        offset += *n;
+        // A short write leaves the file position unaligned.
+        if (offset % kAlignment != 0) break;
+      }
+      written += offset;
+      if (offset != block_size) break;
+    }
+    value_for_write.RemovePrefix(written);
+    return internal_os::SetFileDirectIo(fd, false);
+  }
+
+  /// Makes the data written to `fd` durable, if `sync` is enabled.
+  absl::Status SyncFileData(FileDescriptor fd) const {
+    if (!this->sync) return absl::OkStatus();
+    TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFileData(fd));
+    if (direct_io) {
+      // Drop the now-clean pages of the unaligned tail.
+      internal_os::AdviseFileDontNeed(fd, 0, 0);
+    }
+    return absl::OkStatus();
+  }
+
+  /// Syncs the written lock file and renames it to `full_path`.
+  Result<StorageGeneration> CommitLockFile(WriteLockHelper& lock_helper,
+                                           FileDescriptor dir_fd,
+                                           bool& delete_lock_file) const {
+    FileDescriptor fd = lock_helper.lock_fd.get();
+    TENSORSTORE_RETURN_IF_ERROR(SyncFileData(fd));
+    TENSORSTORE_RETURN_IF_ERROR(
+        internal_os::RenameOpenFile(fd, lock_helper.lock_path, full_path));
+    delete_lock_file = false;
+    if (this->sync) {
+      TENSORSTORE_RETURN_IF_ERROR(SyncDirectory(dir_fd));
+    }
+    return GetCommittedGeneration(lock_helper);
+  }
+
+  /// fsyncs the parent directory to ensure the `rename` is durable.
+  absl::Status SyncDirectory(FileDescriptor dir_fd) const {
+    return MaybeAnnotateStatus(
+        directory_sync->Sync(GetParentDirectoryPath(full_path), dir_fd),
+        tensorstore::StrCat("Error calling fsync on parent directory of: ",
+                            full_path));
+  }
+
+  /// Releases the lock on the renamed lock file and returns its generation.
+  static Result<StorageGeneration> GetCommittedGeneration(
+      WriteLockHelper& lock_helper) {
+    lock_helper.lock = FileLock{};
+
+    // Retrieve `FileInfo` after the fsync and rename to ensure the
+    // modification time doesn't change afterwards.
+    FileInfo info;
+    TENSORSTORE_RETURN_IF_ERROR(
+        internal_os::GetFileInfo(lock_helper.lock_fd.get(), &info));
+    return GetFileGeneration(info);
+  }
+
+  static Result<TimestampedStorageGeneration> Finish(
+      WriteLockHelper& lock_helper, bool delete_lock_file,
+      Result<StorageGeneration> generation_result, absl::Time time) {
+    if (delete_lock_file) {
+      TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
+    }
+    if (!generation_result) {
+      return std::move(generation_result).status();
+    }
+    return TimestampedStorageGeneration(std::move(*generation_result), time);
+  }
+
+  /// Writes `value` without acquiring a file lock, for a store with the
+  /// ``exclusive_writer`` option enabled.  Must be called with the
+  /// `GetExclusiveWriterMutex` lock held.
+  ///
+  /// If anonymous files are not supported, falls back to writing and renaming
+  /// the lock file.
+  Result<StorageGeneration> WriteExclusive(WriteLockHelper& lock_helper,
+                                           FileDescriptor dir_fd,
+                                           bool& delete_lock_file) const {
+    if (MayAppendInPlace()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto generation, AppendInPlace());
+      if (generation) return *std::move(generation);
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(lock_helper.lock_fd,
+                                 internal_os::OpenAnonymousFileForWriting(
+                                     GetParentDirectoryPath(full_path)));
+    if (!lock_helper.lock_fd.valid()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(lock_helper.lock_fd,
+                                   lock_helper.OpenLockFile(&lock_helper.info));
+      delete_lock_file = true;
+      TENSORSTORE_ASSIGN_OR_RETURN(bool condition_satisfied,
+                                   PrepareLockFile(lock_helper));
+      if (!condition_satisfied) return StorageGeneration::Unknown();
+      TENSORSTORE_RETURN_IF_ERROR(WriteLockFile(lock_helper));
+      return CommitLockFile(lock_helper, dir_fd, delete_lock_file);
+    }
+
+    const StorageGeneration& if_equal = options.generation_conditions.if_equal;
+    // Whether `full_path` is known not to exist.
+    bool missing = false;
+    if (!StorageGeneration::IsUnknown(if_equal)) {
+      StorageGeneration generation;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor value_fd,
+          OpenValueFile(full_path.c_str(), &generation));
+      if (generation != if_equal) return StorageGeneration::Unknown();
+      missing = !value_fd.valid();
+    }
+    TENSORSTORE_RETURN_IF_ERROR(WriteLockFile(lock_helper));
+    const FileDescriptor fd = lock_helper.lock_fd.get();
+    TENSORSTORE_RETURN_IF_ERROR(SyncFileData(fd));
+
+    bool linked = false;
+    if (missing || StorageGeneration::IsUnknown(if_equal)) {
+      // Linking fails if `full_path` exists, which makes this an atomic
+      // create-if-absent.
+      auto status = internal_os::LinkAnonymousFile(fd, full_path);
+      if (status.ok()) {
+        linked = true;
+      } else if (!absl::IsAlreadyExists(status)) {
+        return status;
+      } else if (missing) {
+        // Created concurrently, despite `exclusive_writer`.
+        return StorageGeneration::Unknown();
+      }
+    }
+    if (!linked) {
+      // `linkat` cannot replace an existing file; link at the lock file path
+      // and rename that over `full_path`.
+      auto status = internal_os::LinkAnonymousFile(fd, lock_helper.lock_path);
+      if (absl::IsAlreadyExists(status)) {
+        // Remove a stale lock file left by a process that terminated during a
+        // write.
+        TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
+        status = internal_os::LinkAnonymousFile(fd, lock_helper.lock_path);
+      }
+      TENSORSTORE_RETURN_IF_ERROR(status);
+      delete_lock_file = true;
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_os::RenameOpenFile(fd, lock_helper.lock_path, full_path));
+      delete_lock_file = false;
+    }
+    file_write_anonymous.Increment();
+    if (this->sync) {
+      TENSORSTORE_RETURN_IF_ERROR(SyncDirectory(dir_fd));
+    }
+    return GetCommittedGeneration(lock_helper);
+  }
 
   Result<TimestampedStorageGeneration> operator()() const {
-    TimestampedStorageGeneration r;
-    r.time = absl::Now();
+    const absl::Time time = absl::Now();
 
     WriteLockHelper lock_helper(full_path);
     TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
+    if (exclusive_writer) {
+      absl::MutexLock lock(&GetExclusiveWriterMutex(full_path));
+      bool delete_lock_file = false;
+      auto generation_result =
+          WriteExclusive(lock_helper, dir_fd.get(), delete_lock_file);
+      return Finish(lock_helper, delete_lock_file,
+                    std::move(generation_result), time);
+    }
     TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
     bool delete_lock_file = true;
 
     auto generation_result = [&]() -> Result<StorageGeneration> {
-      FileDescriptor fd = lock_helper.lock_fd.get();
-      const std::string& lock_path = lock_helper.lock_path;
-      // Check condition.
-      if (!StorageGeneration::IsUnknown(
-              options.generation_conditions.if_equal)) {
-        StorageGeneration generation;
-        TENSORSTORE_ASSIGN_OR_RETURN(
-            UniqueFileDescriptor value_fd,
-            OpenValueFile(full_path.c_str(), &generation));
-        if (generation != options.generation_conditions.if_equal) {
-          return StorageGeneration::Unknown();
+      if (MayAppendInPlace()) {
+        TENSORSTORE_ASSIGN_OR_RETURN(auto generation, AppendInPlace());
+        if (generation) return *std::move(generation);
+      }
+      TENSORSTORE_ASSIGN_OR_RETURN(bool condition_satisfied,
+                                   PrepareLockFile(lock_helper));
+      if (!condition_satisfied) return StorageGeneration::Unknown();
+      TENSORSTORE_RETURN_IF_ERROR(WriteLockFile(lock_helper));
+      return CommitLockFile(lock_helper, dir_fd.get(), delete_lock_file);
+    }();
+    return Finish(lock_helper, delete_lock_file, std::move(generation_result),
+                  time);
+  }
+};
+
+/// Implements `FileKeyValueStore::Write` using io_uring.
+///
+/// Acquiring the lock and checking the generation condition are performed as
+/// blocking operations on the executor.  The write, `fsync`, and `rename` of
+/// the lock file are then submitted as a single linked chain.  Once the chain
+/// completes, the parent directory is synced on the executor (shared with
+/// other concurrent writes to the same directory) and the result is set.
+struct IoUringWriteTask
+    : public internal::AtomicReferenceCount<IoUringWriteTask> {
+  IoUringWriteTask(WriteTask task,
+                   internal::IntrusivePtr<FileKeyValueStore> driver,
+                   Promise<TimestampedStorageGeneration> promise)
+      : task(std::move(task)),
+        driver(std::move(driver)),
+        promise(std::move(promise)),
+        lock_helper(this->task.full_path) {}
+
+  WriteTask task;
+  internal::IntrusivePtr<FileKeyValueStore> driver;
+  Promise<TimestampedStorageGeneration> promise;
+  absl::Time time;
+  WriteLockHelper lock_helper;
+  UniqueFileDescriptor dir_fd;
+
+  // Results of the chained operations, in submission order.
+  std::vector<int64_t> results;
+  std::atomic<size_t> remaining{0};
+
+  void Start() {
+    time = absl::Now();
+    auto status = [&]() -> absl::Status {
+      TENSORSTORE_ASSIGN_OR_RETURN(dir_fd, OpenParentDirectory(task.full_path));
+      return lock_helper.CreateAndAcquire();
+    }();
+    if (!status.ok()) {
+      promise.SetResult(std::move(status));
+      return;
+    }
+    auto condition_satisfied = task.PrepareLockFile(lock_helper);
+    if (!condition_satisfied.ok() || !*condition_satisfied) {
+      promise.SetResult(WriteTask::Finish(
+          lock_helper, /*delete_lock_file=*/true,
+          condition_satisfied.ok()
+              ? Result<StorageGeneration>(StorageGeneration::Unknown())
+              : std::move(condition_satisfied).status(),
+          time));
+      return;
+    }
+
+    const FileDescriptor fd = lock_helper.lock_fd.get();
+    std::vector<IoUringOperation> ops;
+    ops.emplace_back();
+    ops.back().opcode = IoUringOperation::Opcode::kWrite;
+    ops.back().fd = fd;
+    ops.back().data = task.value;
+    if (task.sync) {
+      ops.emplace_back();
+      ops.back().opcode = IoUringOperation::Opcode::kFsync;
+      ops.back().fd = fd;
+      ops.back().datasync = true;
+    }
+    ops.emplace_back();
+    ops.back().opcode = IoUringOperation::Opcode::kRename;
+    ops.back().path = lock_helper.lock_path;
+    ops.back().new_path = task.full_path;
+    results.resize(ops.size());
+    remaining = ops.size();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      ops[i].link = true;
+      ops[i].callback = [self = internal::IntrusivePtr<IoUringWriteTask>(this),
+                         i](int64_t result) mutable {
+        self->results[i] = result;
+        if (self->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+          return;
         }
+        Executor executor = self->driver->executor();
+        executor([self = std::move(self)] { self->Complete(); });
+      };
+    }
+    driver->io_uring()->Submit(ops);
+  }
+
+  void Complete() {
+    bool delete_lock_file = true;
+    auto generation_result = [&]() -> Result<StorageGeneration> {
+      size_t i = 0;
+      const int64_t n = results[i++];
+      if (n < 0) {
+        return StatusFromOsError(
+            -n, "Failed writing: ", QuoteString(lock_helper.lock_path));
       }
-      if (internal_os::GetSize(lock_helper.info) > value.size()) {
-        // Only truncate when the file is larger. In the common path, the lock
-        // file is newly created, so truncate is useless.
-        TENSORSTORE_RETURN_IF_ERROR(internal_os::TruncateFile(fd));
+      file_metrics.bytes_written.IncrementBy(n);
+      if (static_cast<size_t>(n) < task.value.size()) {
+        // A short write breaks the chain.  Since io_uring writes do not
+        // advance the file position, rewrite the entire value using blocking
+        // calls.
+        TENSORSTORE_RETURN_IF_ERROR(
+            internal_os::TruncateFile(lock_helper.lock_fd.get()));
+        TENSORSTORE_RETURN_IF_ERROR(task.WriteLockFile(lock_helper));
+        return task.CommitLockFile(lock_helper, dir_fd.get(),
+                                   delete_lock_file);
       }
-      absl::Cord value_for_write = value;
-      for (; !value_for_write.empty();) {
-        TENSORSTORE_ASSIGN_OR_RETURN(
-            auto n, internal_os::WriteCordToFile(fd, value_for_write),
-            MaybeAnnotateStatus(_,
-                                tensorstore::StrCat("Failed writing: ",
-                                                    QuoteString(lock_path))));
-        file_bytes_written.IncrementBy(n);
-        if (n == value_for_write.size()) break;
-        value_for_write.RemovePrefix(n);
+      if (task.sync) {
+        if (int64_t r = results[i++]; r < 0) return StatusFromOsError(-r);
       }
-
-      if (this->sync) {
-        TENSORSTORE_RETURN_IF_ERROR(internal_os::FsyncFile(fd));
+      if (int64_t r = results[i++]; r < 0) {
+        return StatusFromOsError(-r, "Failed to rename: ",
+                                 QuoteString(lock_helper.lock_path),
+                                 " to: ", QuoteString(task.full_path));
       }
-      TENSORSTORE_RETURN_IF_ERROR(
-          internal_os::RenameOpenFile(fd, lock_path, full_path));
       delete_lock_file = false;
-      if (this->sync) {
-        // fsync the parent directory to ensure the `rename` is durable.
-        TENSORSTORE_RETURN_IF_ERROR(
-            internal_os::FsyncDirectory(dir_fd.get()),
-            MaybeAnnotateStatus(
-                _, tensorstore::StrCat(
-                       "Error calling fsync on parent directory of: ",
-                       full_path)));
+      if (task.sync) {
+        TENSORSTORE_RETURN_IF_ERROR(task.SyncDirectory(dir_fd.get()));
       }
-      lock_helper.lock = FileLock{};
-
-      // Retrieve `FileInfo` after the fsync and rename to ensure the
-      // modification time doesn't change afterwards.
-      FileInfo info;
-      TENSORSTORE_RETURN_IF_ERROR(internal_os::GetFileInfo(fd, &info));
-      return GetFileGeneration(info);
+      return WriteTask::GetCommittedGeneration(lock_helper);
     }();
-
-    if (delete_lock_file) {
-      TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
-    }
-    if (!generation_result) {
-      return std::move(generation_result).status();
-    }
-    r.generation = std::move(*generation_result);
-    return r;
+    promise.SetResult(WriteTask::Finish(lock_helper, delete_lock_file,
+                                        std::move(generation_result), time));
   }
 };
 
@@ -720,6 +1456,9 @@ struct DeleteTask {
   std::string full_path;
   kvstore::WriteOptions options;
   bool sync;
+  std::shared_ptr<DirectorySyncGroups> directory_sync;
+  /// Serialize deletes using `GetExclusiveWriterMutex` rather than lock files.
+  bool exclusive_writer = false;
 
   Result<TimestampedStorageGeneration> operator()() const {
     TimestampedStorageGeneration r;
@@ -727,7 +1466,12 @@ struct DeleteTask {
 
     WriteLockHelper lock_helper(full_path);
     TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
-    TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
+    std::optional<absl::MutexLock> exclusive_lock;
+    if (exclusive_writer) {
+      exclusive_lock.emplace(&GetExclusiveWriterMutex(full_path));
+    } else {
+      TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
+    }
 
     bool fsync_directory = false;
     auto generation_result = [&]() -> Result<StorageGeneration> {
@@ -751,12 +1495,15 @@ struct DeleteTask {
     }();
 
     // Delete the lock file.
-    TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
+    if (!exclusive_writer) {
+      TENSORSTORE_RETURN_IF_ERROR(lock_helper.Delete());
+    }
+    exclusive_lock.reset();
 
-    // fsync the parent directory to ensure the `rename` is durable.
+    // fsync the parent directory to ensure the `unlink` is durable.
     if (fsync_directory) {
       TENSORSTORE_RETURN_IF_ERROR(
-          internal_os::FsyncDirectory(dir_fd.get()),
+          directory_sync->Sync(GetParentDirectoryPath(full_path), dir_fd.get()),
           MaybeAnnotateStatus(
               _,
               tensorstore::StrCat(
@@ -770,29 +1517,110 @@ struct DeleteTask {
   }
 };
 
+/// Copies a single key for `FileKeyValueStore::ExperimentalCopyRangeFrom`.
+///
+/// The source file is copied into the lock file of the target using
+/// `internal_os::CopyFileData`, which avoids copying through a user-space
+/// buffer where supported, and then renamed exactly like a regular write.
+struct CopyTask {
+  std::string source_path;
+  /// Write of an empty value to the target, used for its lock file handling.
+  WriteTask write_task;
+
+  Result<TimestampedStorageGeneration> operator()() const {
+    const absl::Time time = absl::Now();
+    const std::string& full_path = write_task.full_path;
+
+    WriteLockHelper lock_helper(full_path);
+    TENSORSTORE_ASSIGN_OR_RETURN(auto dir_fd, OpenParentDirectory(full_path));
+    std::optional<absl::MutexLock> exclusive_lock;
+    if (write_task.exclusive_writer) {
+      // The lock file is still used as the staging file, but without a file
+      // lock.
+      exclusive_lock.emplace(&GetExclusiveWriterMutex(full_path));
+      TENSORSTORE_ASSIGN_OR_RETURN(lock_helper.lock_fd,
+                                   lock_helper.OpenLockFile(&lock_helper.info));
+    } else {
+      TENSORSTORE_RETURN_IF_ERROR(lock_helper.CreateAndAcquire());
+    }
+    bool delete_lock_file = true;
+
+    auto generation_result = [&]() -> Result<StorageGeneration> {
+      StorageGeneration source_generation;
+      int64_t size;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          UniqueFileDescriptor source_fd,
+          OpenValueFile(source_path.c_str(), &source_generation, &size));
+      // The source was deleted after it was listed.
+      if (!source_fd.valid()) return StorageGeneration::Unknown();
+      TENSORSTORE_ASSIGN_OR_RETURN(bool condition_satisfied,
+                                   write_task.PrepareLockFile(lock_helper));
+      if (!condition_satisfied) return StorageGeneration::Unknown();
+      TENSORSTORE_RETURN_IF_ERROR(
+          internal_os::CopyFileData(source_fd.get(), lock_helper.lock_fd.get(),
+                                    size),
+          MaybeAnnotateStatus(
+              _, tensorstore::StrCat("Failed copying ",
+                                     QuoteString(source_path), " to ",
+                                     QuoteString(full_path))));
+      file_metrics.bytes_written.IncrementBy(size);
+      return write_task.CommitLockFile(lock_helper, dir_fd.get(),
+                                       delete_lock_file);
+    }();
+    return WriteTask::Finish(lock_helper, delete_lock_file,
+                             std::move(generation_result), time);
+  }
+};
+
 Future<TimestampedStorageGeneration> FileKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   file_write.Increment();
+  return internal_kvstore::RecordWriteMetrics(
+      file_metrics, WriteImpl(std::move(key), std::move(value),
+                              std::move(options)));
+}
+
+Future<TimestampedStorageGeneration> FileKeyValueStore::WriteImpl(
+    Key key, std::optional<Value> value, WriteOptions options) {
   TENSORSTORE_RETURN_IF_ERROR(ValidateKey(key));
   if (value) {
-    return MapFuture(executor(), WriteTask{std::move(key), std::move(*value),
-                                           std::move(options), this->sync()});
+    WriteTask task{std::move(key),       std::move(*value),
+                   std::move(options), this->sync(),
+                   spec_.direct_io,    spec_.append_in_place,
+                   directory_sync_,    spec_.exclusive_writer};
+    if (auto* io_uring = this->io_uring();
+        io_uring && !spec_.direct_io && !spec_.exclusive_writer &&
+        !task.MayAppendInPlace() &&
+        io_uring->IsSupported(IoUringOperation::Opcode::kRename)) {
+      auto [promise, future] =
+          PromiseFuturePair<TimestampedStorageGeneration>::Make();
+      executor()([state = internal::MakeIntrusivePtr<IoUringWriteTask>(
+                      std::move(task),
+                      internal::IntrusivePtr<FileKeyValueStore>(this),
+                      std::move(promise))] { state->Start(); });
+      return std::move(future);
+    }
+    return MapFuture(executor(), std::move(task));
   } else {
-    return MapFuture(executor(), DeleteTask{std::move(key), std::move(options),
-                                            this->sync()});
+    return MapFuture(executor(),
+                     DeleteTask{std::move(key), std::move(options),
+                                this->sync(), directory_sync_,
+                                spec_.exclusive_writer});
   }
 }
 
 /// Implements `FileKeyValueStore::DeleteRange`.
 struct DeleteRangeTask {
   KeyRange range;
+  internal_os::ParallelFileListOptions list_options;
 
   // TODO(jbms): Add fsync support
 
   void operator()(Promise<void> promise) {
     std::string prefix(internal_file_util::LongestDirectoryPrefix(range));
+    absl::Mutex mutex;
     absl::Status delete_status;
-    auto status = internal_os::RecursiveFileList(
+    auto status = internal_os::ParallelRecursiveFileList(
         prefix,
         [&](std::string_view path) {
           return tensorstore::IntersectsPrefix(range, path);
@@ -811,13 +1639,15 @@ struct DeleteRangeTask {
             if (!s.ok() && !absl::IsNotFound(s) &&  // Already deleted
                 !absl::IsFailedPrecondition(s)) {   // No delete permissions
               ABSL_LOG_IF(INFO, file_logging) << s;
+              absl::MutexLock lock(&mutex);
               delete_status.Update(s);
             }
           }
           // Even when failing to delete the current file, continue to the next
           // file.
           return absl::OkStatus();
-        });
+        },
+        list_options);
     if (!status.ok()) {
       promise.SetResult(MakeResult(std::move(status)));
     }
@@ -830,14 +1660,49 @@ Future<const void> FileKeyValueStore::DeleteRange(KeyRange range) {
   if (range.empty()) return absl::OkStatus();  // Converted to a ReadyFuture.
   TENSORSTORE_RETURN_IF_ERROR(ValidateKeyRange(range));
   return PromiseFuturePair<void>::Link(
-             WithExecutor(executor(), DeleteRangeTask{std::move(range)}))
+             WithExecutor(executor(),
+                          DeleteRangeTask{std::move(range), list_options()}))
       .future;
 }
 
+Future<const void> FileKeyValueStore::ExperimentalCopyRangeFrom(
+    const internal::OpenTransactionPtr& transaction, const KvStore& source,
+    Key target_prefix, kvstore::CopyRangeOptions options) {
+  if (typeid(*source.driver) != typeid(FileKeyValueStore) || transaction ||
+      source.transaction != no_transaction) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  file_copy_range.Increment();
+  if (options.source_range.empty()) return absl::OkStatus();
+  return internal_kvstore::CopyRangeByListing(
+      source, std::move(target_prefix), options,
+      [self = internal::IntrusivePtr<FileKeyValueStore>(this)](
+          ListEntry entry, std::string target_key) -> Future<const void> {
+        TENSORSTORE_RETURN_IF_ERROR(ValidateKey(target_key));
+        WriteTask write_task{std::move(target_key),
+                             absl::Cord(),
+                             {},
+                             self->sync(),
+                             /*direct_io=*/false,
+                             /*append_in_place=*/false,
+                             self->directory_sync(),
+                             self->spec_.exclusive_writer};
+        auto [promise, future] =
+            PromiseFuturePair<void>::Make(absl::OkStatus());
+        LinkError(std::move(promise),
+                  MapFuture(self->executor(),
+                            CopyTask{std::move(entry.key),
+                                     std::move(write_task)}));
+        return std::move(future);
+      });
+}
+
 /// Implements `FileKeyValueStore:::List`.
 struct ListTask {
   kvstore::ListOptions options;
   ListReceiver receiver;
+  internal_os::ParallelFileListOptions list_options;
 
   void operator()() {
     std::atomic<bool> cancelled = false;
@@ -846,7 +1711,9 @@ struct ListTask {
     });
     std::string prefix(
         internal_file_util::LongestDirectoryPrefix(options.range));
-    auto status = internal_os::RecursiveFileList(
+    // Serializes calls to `receiver`, since entries are visited concurrently.
+    absl::Mutex mutex;
+    auto status = internal_os::ParallelRecursiveFileList(
         prefix,
         [&](std::string_view path) {
           return tensorstore::IntersectsPrefix(options.range, path);
@@ -861,11 +1728,13 @@ struct ListTask {
               !absl::EndsWith(path, kLockSuffix)) {
             // TODO: If the file was stat'd, include length.
             path.remove_prefix(options.strip_prefix_length);
-            execution::set_value(receiver,
-                                 ListEntry{std::string(path), entry.GetSize()});
+            ListEntry list_entry{std::string(path), entry.GetSize()};
+            absl::MutexLock lock(&mutex);
+            execution::set_value(receiver, std::move(list_entry));
           }
           return absl::OkStatus();
-        });
+        },
+        list_options);
     if (!status.ok() && !cancelled.load(std::memory_order_relaxed)) {
       execution::set_error(receiver, std::move(status));
       execution::set_stopping(receiver);
@@ -890,7 +1759,8 @@ void FileKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
     execution::set_stopping(receiver);
     return;
   }
-  executor()(ListTask{std::move(options), std::move(receiver)});
+  executor()(
+      ListTask{std::move(options), std::move(receiver), list_options()});
 }
 
 Future<kvstore::DriverPtr> FileKeyValueStoreSpec::DoOpen() const {
@@ -905,6 +1775,8 @@ Result<kvstore::Spec> ParseFileUrl(std::string_view url) {
       Context::Resource<internal::FileIoConcurrencyResource>::DefaultSpec();
   driver_spec->data_.file_io_sync =
       Context::Resource<FileIoSyncResource>::DefaultSpec();
+  driver_spec->data_.file_io_engine =
+      Context::Resource<FileIoEngineResource>::DefaultSpec();
   auto parsed = internal::ParseGenericUri(url);
   assert(parsed.scheme == internal_file_kvstore::FileKeyValueStoreSpec::id);
   if (!parsed.query.empty()) {
@@ -939,4 +1811,8 @@ const tensorstore::internal::ContextResourceRegistration<
     tensorstore::internal_file_kvstore::FileIoSyncResource>
     file_io_sync_registration;
 
+const tensorstore::internal::ContextResourceRegistration<
+    tensorstore::internal_file_kvstore::FileIoEngineResource>
+    file_io_engine_registration;
+
 }  // namespace
@@ -31,11 +31,13 @@
 #include "tensorstore/internal/os/filesystem.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
 #include "tensorstore/internal/thread/thread.h"
+#include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/util/execution/execution.h"
@@ -43,6 +45,7 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
+#include "tensorstore/util/str_cat.h"
 
 // Include system headers last to reduce impact of macros.
 #ifndef _WIN32
@@ -59,8 +62,10 @@ using ::tensorstore::KeyRange;
 using ::tensorstore::KvStore;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal::MatchesRegularTimestampedStorageGeneration;
 using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
 using ::tensorstore::internal_os::GetDirectoryContents;
 using ::tensorstore::internal_testing::ScopedCurrentWorkingDirectory;
@@ -71,6 +76,13 @@ KvStore GetStore(std::string root) {
   return kvstore::Open({{"driver", "file"}, {"path", root + "/"}}).value();
 }
 
+KvStore GetIoUringStore(std::string root) {
+  return kvstore::Open({{"driver", "file"},
+                        {"path", root + "/"},
+                        {"file_io_engine", "io_uring"}})
+      .value();
+}
+
 TEST(FileKeyValueStoreTest, Basic) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
@@ -78,6 +90,212 @@ TEST(FileKeyValueStoreTest, Basic) {
   tensorstore::internal::TestKeyValueReadWriteOps(store);
 }
 
+TEST(FileKeyValueStoreTest, IoUringBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetIoUringStore(root);
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, IoUringNoSync) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({{"driver", "file"},
+                              {"path", root + "/"},
+                              {"file_io_engine", "io_uring"},
+                              {"file_io_sync", false}})
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, MmapBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store =
+      kvstore::Open({{"driver", "file"}, {"path", root + "/"}, {"mmap", true}})
+          .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, MmapValueOutlivesOverwrite) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store =
+      kvstore::Open({{"driver", "file"}, {"path", root + "/"}, {"mmap", true}})
+          .value();
+  std::string value(100000, 'x');
+  value[70000] = 'y';
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord(value)));
+
+  kvstore::ReadOptions options;
+  options.byte_range =
+      tensorstore::OptionalByteRangeRequest::Range(69999, 70002);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto partial,
+                                   kvstore::Read(store, "a", options).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto full,
+                                   kvstore::Read(store, "a").result());
+
+  // Replacing and deleting the value does not affect the mapped values.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("new")));
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "a"));
+  EXPECT_EQ("xyx", partial.value);
+  EXPECT_EQ(value, full.value);
+}
+
+TEST(FileKeyValueStoreTest, DirectIoBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({{"driver", "file"},
+                              {"path", root + "/"},
+                              {"direct_io", true}})
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, DirectIoLargeUnalignedValue) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({{"driver", "file"},
+                              {"path", root + "/"},
+                              {"direct_io", true}})
+                   .value();
+  // Value spanning several staging buffers, with an unaligned tail.
+  std::string value(20 * 1024 * 1024 + 123, '\0');
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = static_cast<char>(i % 251);
+  }
+  absl::Cord cord;
+  for (size_t i = 0; i < value.size(); i += 1000) {
+    cord.Append(value.substr(i, 1000));
+  }
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", cord));
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord(value)));
+}
+
+TEST(FileKeyValueStoreTest, AppendInPlaceBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({{"driver", "file"},
+                              {"path", root + "/"},
+                              {"append_in_place", true}})
+                   .value();
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+KvStore GetExclusiveWriterStore(std::string root) {
+  return kvstore::Open({{"driver", "file"},
+                        {"path", root + "/"},
+                        {"exclusive_writer", true}})
+      .value();
+}
+
+TEST(FileKeyValueStoreTest, ExclusiveWriterBasic) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetExclusiveWriterStore(root);
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(FileKeyValueStoreTest, ExclusiveWriterNoLockFiles) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = GetExclusiveWriterStore(root);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a/foo", absl::Cord("xyz"),
+                                 {/*.if_equal=*/StorageGeneration::NoValue()})
+                      .result());
+  EXPECT_THAT(
+      kvstore::Write(store, "a/foo", absl::Cord("qqq"),
+                     {/*.if_equal=*/StorageGeneration::NoValue()})
+          .result(),
+      MatchesTimestampedStorageGeneration(StorageGeneration::Unknown()));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a/foo", absl::Cord("abc"),
+                                       {/*.if_equal=*/stamp.generation})
+                            .result());
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "a/bar", absl::Cord("def")).result());
+  EXPECT_THAT(kvstore::Read(store, "a/foo").result(),
+              MatchesKvsReadResult(absl::Cord("abc")));
+  EXPECT_THAT(GetDirectoryContents(root),
+              ::testing::UnorderedElementsAre("a", "a/foo", "a/bar"));
+
+  // A stale lock file does not interfere with writing.
+  { std::ofstream x(root + "/a/foo.__lock"); }
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "a/foo", absl::Cord("xyz")).result());
+  EXPECT_THAT(kvstore::Read(store, "a/foo").result(),
+              MatchesKvsReadResult(absl::Cord("xyz")));
+
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "a/bar").result());
+  EXPECT_THAT(GetDirectoryContents(root),
+              ::testing::UnorderedElementsAre("a", "a/foo"));
+}
+
+TEST(FileKeyValueStoreTest, ExclusiveWriterConcurrentWrites) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::TestConcurrentWritesOptions options;
+  options.get_store = [&] { return GetExclusiveWriterStore(root); };
+  tensorstore::internal::TestConcurrentWrites(options);
+}
+
+TEST(FileKeyValueStoreTest, AppendInPlace) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  auto store = kvstore::Open({{"driver", "file"},
+                              {"path", root + "/"},
+                              {"append_in_place", true}})
+                   .value();
+  EXPECT_EQ(kvstore::SupportedFeatures::kAppendInPlace,
+            store.driver->GetSupportedFeatures(KeyRange::Singleton("a")) &
+                kvstore::SupportedFeatures::kAppendInPlace);
+  EXPECT_EQ(kvstore::SupportedFeatures::kNone,
+            GetStore(root).driver->GetSupportedFeatures(
+                KeyRange::Singleton("a")) &
+                kvstore::SupportedFeatures::kAppendInPlace);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp1, kvstore::Write(store, "a", absl::Cord("abc")).result());
+#ifndef _WIN32
+  struct ::stat info1;
+  ASSERT_EQ(0, ::stat((root + "/a").c_str(), &info1));
+#endif
+
+  // Append to the existing value.
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = stamp1.generation;
+  options.unchanged_prefix_length = 3;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp2,
+      kvstore::Write(store, "a", absl::Cord("abcdef"), options).result());
+  EXPECT_THAT(stamp2, MatchesRegularTimestampedStorageGeneration());
+  EXPECT_NE(stamp1.generation, stamp2.generation);
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abcdef"), stamp2.generation));
+#ifndef _WIN32
+  // The file was updated in place rather than replaced.
+  struct ::stat info2;
+  ASSERT_EQ(0, ::stat((root + "/a").c_str(), &info2));
+  EXPECT_EQ(info1.st_ino, info2.st_ino);
+#endif
+
+  // A stale generation condition is not satisfied.
+  EXPECT_THAT(
+      kvstore::Write(store, "a", absl::Cord("abcxyz"), options).result(),
+      MatchesTimestampedStorageGeneration(StorageGeneration::Unknown()));
+
+  // An unchanged prefix that does not match the existing size falls back to
+  // replacing the file.
+  options.generation_conditions.if_equal = stamp2.generation;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp3,
+      kvstore::Write(store, "a", absl::Cord("abcX"), options).result());
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("abcX"), stamp3.generation));
+  EXPECT_THAT(GetDirectoryContents(root), ::testing::ElementsAre("a"));
+}
+
 TEST(FileKeyValueStoreTest, InvalidKey) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
@@ -192,6 +410,44 @@ TEST(FileKeyValueStoreTest, ConcurrentWrites) {
   tensorstore::internal::TestConcurrentWrites(options);
 }
 
+// Tests many concurrent durable writes and deletes in the same directory,
+// which share directory fsyncs.
+TEST(FileKeyValueStoreTest, ConcurrentSyncWritesSameDirectory) {
+  for (auto store_getter : {&GetStore, &GetIoUringStore}) {
+    ScopedTemporaryDirectory tempdir;
+    auto store = store_getter(tempdir.path() + "/root");
+    constexpr size_t kNumKeys = 64;
+    std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>>
+        futures;
+    for (size_t i = 0; i < kNumKeys; ++i) {
+      futures.push_back(kvstore::Write(store, tensorstore::StrCat("dir/", i),
+                                       absl::Cord(tensorstore::StrCat(i))));
+    }
+    for (auto& future : futures) {
+      EXPECT_THAT(future.result(),
+                  MatchesRegularTimestampedStorageGeneration());
+    }
+    futures.clear();
+    for (size_t i = 0; i < kNumKeys; i += 2) {
+      futures.push_back(kvstore::Delete(store, tensorstore::StrCat("dir/", i)));
+    }
+    for (auto& future : futures) {
+      EXPECT_THAT(future.result(), MatchesTimestampedStorageGeneration(
+                                       StorageGeneration::NoValue()));
+    }
+    for (size_t i = 0; i < kNumKeys; ++i) {
+      auto read_result =
+          kvstore::Read(store, tensorstore::StrCat("dir/", i)).result();
+      if (i % 2 == 0) {
+        EXPECT_THAT(read_result, MatchesKvsReadResultNotFound());
+      } else {
+        EXPECT_THAT(read_result,
+                    MatchesKvsReadResult(absl::Cord(tensorstore::StrCat(i))));
+      }
+    }
+  }
+}
+
 // Tests `FileKeyValueStore` on a directory without write or read/write
 // permissions.
 #ifndef _WIN32
@@ -282,14 +538,12 @@ TEST(FileKeyValueStoreTest, DeleteRangeFromBeginning) {
   tensorstore::internal::TestKeyValueStoreDeleteRangeFromBeginning(store);
 }
 
-#if 0
 TEST(FileKeyValueStoreTest, CopyRange) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
   auto store = GetStore(root);
   tensorstore::internal::TestKeyValueStoreCopyRange(store);
 }
-#endif
 
 TEST(FileKeyValueStoreTest, ListErrors) {
   ScopedTemporaryDirectory tempdir;
@@ -338,12 +592,47 @@ TEST(FileKeyValueStoreTest, SpecRoundtripSync) {
       {"context",
        {
            {"file_io_concurrency", ::nlohmann::json::object_t()},
+           {"file_io_engine", "blocking"},
        }},
   };
   options.spec_request_options.Set(tensorstore::retain_context);
   tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
 }
 
+TEST(FileKeyValueStoreTest, SpecRoundtripMmap) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {{"driver", "file"}, {"path", root}, {"mmap", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(FileKeyValueStoreTest, SpecRoundtripDirectIo) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {{"driver", "file"}, {"path", root}, {"direct_io", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(FileKeyValueStoreTest, SpecRoundtripAppendInPlace) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "file"}, {"path", root}, {"append_in_place", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(FileKeyValueStoreTest, SpecRoundtripExclusiveWriter) {
+  ScopedTemporaryDirectory tempdir;
+  std::string root = tempdir.path() + "/root";
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", "file"}, {"path", root}, {"exclusive_writer", true}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
 TEST(FileKeyValueStoreTest, InvalidSpec) {
   ScopedTemporaryDirectory tempdir;
   std::string root = tempdir.path() + "/root";
@@ -407,4 +696,23 @@ TEST(FileKeyValueStoreTest, BatchRead) {
   tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
 }
 
+TEST(FileKeyValueStoreTest, IoUringBatchRead) {
+  ScopedTemporaryDirectory tempdir;
+  auto store = GetIoUringStore(tempdir.path());
+
+  tensorstore::internal::BatchReadGenericCoalescingTestOptions options;
+  options.coalescing_options.max_extra_read_bytes = 255;
+  options.metric_prefix = "/tensorstore/kvstore/file/";
+  options.has_file_open_metric = true;
+  tensorstore::internal::TestBatchReadGenericCoalescing(store, options);
+}
+
+TEST(FileKeyValueStoreTest, InvalidFileIoEngine) {
+  EXPECT_THAT(kvstore::Open({{"driver", "file"},
+                             {"path", "/tmp/"},
+                             {"file_io_engine", "aio"}})
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
@@ -33,4 +33,8 @@ const tensorstore::internal::ContextResourceRegistration<
     tensorstore::internal_storage_gcs::GcsRequestRetries>
     gcs_request_retries_registration;
 
+const tensorstore::internal::ContextResourceRegistration<
+    tensorstore::internal_storage_gcs::GcsRequestHedging>
+    gcs_request_hedging_registration;
+
 }  // namespace
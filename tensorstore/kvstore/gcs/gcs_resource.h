@@ -18,6 +18,7 @@
 #include <optional>
 
 #include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/hedging_context_resource.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/retries_context_resource.h"
 
@@ -62,6 +63,11 @@ struct GcsRequestRetries : public internal::RetriesResource<GcsRequestRetries> {
   static constexpr char id[] = "gcs_request_retries";
 };
 
+/// Specifies when slow requests are hedged.
+struct GcsRequestHedging : public internal::HedgingResource<GcsRequestHedging> {
+  static constexpr char id[] = "gcs_request_hedging";
+};
+
 }  // namespace internal_storage_gcs
 }  // namespace tensorstore
 
@@ -57,8 +57,10 @@
 #include "tensorstore/internal/source_location.h"
 #include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/kvstore/auto_batch.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/gcs/gcs_resource.h"
 #include "tensorstore/kvstore/gcs/validate.h"
@@ -70,6 +72,7 @@
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/single_flight_read.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/url_registry.h"
@@ -93,6 +96,8 @@
 #include "tensorstore/internal/json_binding/enum.h"  // IWYU pragma: keep
 #include "tensorstore/serialization/absl_time.h"  // IWYU pragma: keep
 #include "tensorstore/serialization/fwd.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
 
 // protos
 #include "google/protobuf/empty.pb.h"
@@ -105,6 +110,7 @@ using ::tensorstore::internal::ScheduleAt;
 using ::tensorstore::internal_gcs_grpc::GetCredentialsForEndpoint;
 using ::tensorstore::internal_gcs_grpc::GetSharedStorageStubPool;
 using ::tensorstore::internal_gcs_grpc::StorageStubPool;
+using ::tensorstore::internal_kvstore_batch::AutoBatchResource;
 using ::tensorstore::internal_metrics::MetricMetadata;
 using ::tensorstore::internal_storage_gcs::GcsUserProjectResource;
 using ::tensorstore::internal_storage_gcs::IsRetriable;
@@ -181,12 +187,14 @@ struct GcsGrpcKeyValueStoreSpecData {
   absl::Duration wait_for_connection = absl::ZeroDuration();
   Context::Resource<GcsUserProjectResource> user_project;
   Context::Resource<internal_storage_gcs::GcsRequestRetries> retries;
+  Context::Resource<AutoBatchResource> auto_batch;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
+  internal_kvstore_batch::CoalescingOverrides read_coalescing;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(x.bucket, x.endpoint, x.num_channels, x.timeout,
-             x.wait_for_connection, x.user_project, x.retries,
-             x.data_copy_concurrency);
+             x.wait_for_connection, x.user_project, x.retries, x.auto_batch,
+             x.data_copy_concurrency, x.read_coalescing);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -219,10 +227,16 @@ struct GcsGrpcKeyValueStoreSpecData {
                  jb::Projection<&GcsGrpcKeyValueStoreSpecData::user_project>()),
       jb::Member(internal_storage_gcs::GcsRequestRetries::id,
                  jb::Projection<&GcsGrpcKeyValueStoreSpecData::retries>()),
+      jb::Member(AutoBatchResource::id,
+                 jb::Projection<&GcsGrpcKeyValueStoreSpecData::auto_batch>()),
       jb::Member(
           DataCopyConcurrencyResource::id,
           jb::Projection<
-              &GcsGrpcKeyValueStoreSpecData::data_copy_concurrency>()), /**/
+              &GcsGrpcKeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member(
+          "read_coalescing",
+          jb::Projection<&GcsGrpcKeyValueStoreSpecData::read_coalescing>(
+              jb::DefaultInitializedValue())), /**/
       jb::DiscardExtraMembers);
 };
 
@@ -248,9 +262,12 @@ class GcsGrpcKeyValueStore
     : public internal_kvstore::RegisteredDriver<GcsGrpcKeyValueStore,
                                                 GcsGrpcKeyValueStoreSpec> {
  public:
-  internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
-      const {
-    return internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions;
+  internal_kvstore_batch::CoalescingPolicy& coalescing_policy() {
+    return *coalescing_policy_;
+  }
+
+  internal_kvstore_batch::SingleFlightReads& single_flight_reads() {
+    return single_flight_reads_;
   }
 
   /// Key value store operations.
@@ -345,6 +362,8 @@ class GcsGrpcKeyValueStore
   }
 
   SpecData spec_;
+  std::optional<internal_kvstore_batch::CoalescingPolicy> coalescing_policy_;
+  internal_kvstore_batch::SingleFlightReads single_flight_reads_;
   std::string bucket_;
   std::shared_ptr<StorageStubPool> storage_stub_pool_;
   std::function<std::shared_ptr<grpc::CallCredentials>()> call_credentials_fn_;
@@ -370,7 +389,7 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
   Promise<kvstore::ReadResult> promise_;
 
   // working state.
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   ReadObjectRequest request_;
   ReadObjectResponse response_;
   std::optional<absl::crc32c_t> crc32c_;
@@ -389,7 +408,7 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask>,
   void Start(const std::string& object_name) {
     ABSL_LOG_IF(INFO, gcs_grpc_logging) << "ReadTask::Start " << this;
 
-    stub_ = driver_->get_stub().get();
+    stub_ = driver_->get_stub();
     promise_.ExecuteWhenNotNeeded(
         [self = internal::IntrusivePtr<ReadTask>(this)] { self->TryCancel(); });
 
@@ -613,7 +632,7 @@ struct WriteTask : public internal::AtomicReferenceCount<WriteTask>,
   Promise<TimestampedStorageGeneration> promise_;
   std::string object_name_;
   absl::Cord value_;
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
 
   // working state.
   WriteObjectRequest request_;
@@ -678,7 +697,7 @@ struct WriteTask : public internal::AtomicReferenceCount<WriteTask>,
 
     object_name_ = std::move(object_name);
     value_ = std::move(value);
-    stub_ = driver_->get_stub().get();
+    stub_ = driver_->get_stub();
     promise_.ExecuteWhenNotNeeded([self = internal::IntrusivePtr<WriteTask>(
                                        this)] { self->TryCancel(); });
     Retry();
@@ -803,7 +822,7 @@ struct DeleteTask : public internal::AtomicReferenceCount<DeleteTask> {
   Promise<TimestampedStorageGeneration> promise_;
 
   // Working state
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   absl::Time start_time_;
   DeleteObjectRequest request_;
   ::google::protobuf::Empty response_;
@@ -817,7 +836,7 @@ struct DeleteTask : public internal::AtomicReferenceCount<DeleteTask> {
   }
 
   void Start(const std::string& object_name) {
-    stub_ = driver_->get_stub().get();
+    stub_ = driver_->get_stub();
     promise_.ExecuteWhenNotNeeded([self = internal::IntrusivePtr<DeleteTask>(
                                        this)] { self->TryCancel(); });
 
@@ -911,7 +930,7 @@ struct ListTask : public internal::AtomicReferenceCount<ListTask> {
   ListReceiver receiver_;
 
   // working state.
-  Storage::StubInterface* stub_ = nullptr;
+  std::shared_ptr<Storage::StubInterface> stub_;
   ListObjectsRequest request;
   ListObjectsResponse response;
 
@@ -952,7 +971,7 @@ struct ListTask : public internal::AtomicReferenceCount<ListTask> {
   }
 
   void Start() {
-    stub_ = driver_->get_stub().get();
+    stub_ = driver_->get_stub();
     request.set_lexicographic_start(options_.range.inclusive_min);
     request.set_lexicographic_end(options_.range.exclusive_max);
     request.set_parent(driver_->bucket_name());
@@ -1088,7 +1107,8 @@ Future<kvstore::ReadResult> GcsGrpcKeyValueStore::Read(Key key,
     return absl::InvalidArgumentError("Malformed StorageGeneration");
   }
   return internal_kvstore_batch::HandleBatchRequestByGenericByteRangeCoalescing(
-      *this, std::move(key), std::move(options));
+      *this, std::move(key), std::move(options),
+      spec_.auto_batch->batcher.get());
 }
 
 Future<kvstore::ReadResult> GcsGrpcKeyValueStore::ReadImpl(
@@ -1166,6 +1186,9 @@ Future<const void> GcsGrpcKeyValueStore::DeleteRange(KeyRange range) {
 Future<kvstore::DriverPtr> GcsGrpcKeyValueStoreSpec::DoOpen() const {
   auto driver = internal::MakeIntrusivePtr<GcsGrpcKeyValueStore>();
   driver->spec_ = data_;
+  driver->coalescing_policy_.emplace(
+      internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions,
+      data_.read_coalescing);
   driver->bucket_ = absl::StrFormat("projects/_/buckets/%s", data_.bucket);
 
   std::string endpoint = data_.endpoint;
@@ -1211,6 +1234,8 @@ Result<kvstore::Spec> ParseGcsGrpcUrl(std::string_view url) {
       Context::Resource<GcsUserProjectResource>::DefaultSpec();
   driver_spec->data_.retries =
       Context::Resource<internal_storage_gcs::GcsRequestRetries>::DefaultSpec();
+  driver_spec->data_.auto_batch =
+      Context::Resource<AutoBatchResource>::DefaultSpec();
   driver_spec->data_.data_copy_concurrency =
       Context::Resource<DataCopyConcurrencyResource>::DefaultSpec();
   return {std::in_place, std::move(driver_spec), std::move(decoded_path)};
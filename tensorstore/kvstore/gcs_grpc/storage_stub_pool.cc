@@ -24,6 +24,7 @@
 #include <string_view>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/const_init.h"
@@ -52,9 +53,14 @@ ABSL_FLAG(std::optional<bool>, tensorstore_gcs_grpc_use_local_subchannel_pool,
           "Overrides TENSORSTORE_GCS_GRPC_USE_LOCAL_SUBCHANNEL_POOL.");
 
 ABSL_FLAG(std::optional<uint32_t>, tensorstore_gcs_grpc_channels, std::nullopt,
-          "Default (and maximum) channels to use in gcs_grpc driver. "
+          "Default channels to use in gcs_grpc driver. "
           "Overrides TENSORSTORE_GCS_GRPC_CHANNELS.");
 
+ABSL_FLAG(std::optional<uint32_t>, tensorstore_gcs_grpc_max_channels,
+          std::nullopt,
+          "Maximum channels to which the gcs_grpc driver grows a channel pool "
+          "under load. Overrides TENSORSTORE_GCS_GRPC_MAX_CHANNELS.");
+
 using ::tensorstore::internal::GetFlagOrEnvValue;
 
 namespace tensorstore {
@@ -65,6 +71,12 @@ ABSL_CONST_INIT absl::Mutex global_mu(absl::kConstInit);
 
 ABSL_CONST_INIT internal_log::VerboseFlag gcs_grpc_logging("gcs_grpc");
 
+bool IsDirectPathAddress(std::string_view address) {
+  return absl::StartsWith(address, "google-c2p:///") ||
+         absl::StartsWith(address, "google-c2p-experimental:///") ||
+         absl::EndsWith(address, ".googleprod.com");
+}
+
 /// Returns the number of channels to use.
 /// See also the channel construction in googleapis/google-cloud-cpp repository:
 /// https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/grpc_client.cc#L188
@@ -81,9 +93,7 @@ uint32_t ChannelsForAddress(std::string_view address, uint32_t num_channels) {
     return *opt;
   }
 
-  if (absl::StartsWith(address, "google-c2p:///") ||
-      absl::StartsWith(address, "google-c2p-experimental:///") ||
-      absl::EndsWith(address, ".googleprod.com")) {
+  if (IsDirectPathAddress(address)) {
     // google-c2p are direct-path addresses; multiple channels are handled
     // internally in gRPC.
     return 1;
@@ -93,50 +103,141 @@ uint32_t ChannelsForAddress(std::string_view address, uint32_t num_channels) {
   return std::max(4u, std::thread::hardware_concurrency() / 2);
 }
 
+/// Returns the maximum number of channels to which a pool may grow.
+uint32_t MaxChannelsForAddress(std::string_view address,
+                               uint32_t num_channels) {
+  // Use the flag --tensorstore_gcs_grpc_max_channels if present.
+  // Use the environment variable TENSORSTORE_GCS_GRPC_MAX_CHANNELS if present.
+  auto opt = GetFlagOrEnvValue(FLAGS_tensorstore_gcs_grpc_max_channels,
+                               "TENSORSTORE_GCS_GRPC_MAX_CHANNELS");
+  if (opt && *opt > 0) {
+    return *opt;
+  }
+  // Otherwise, only pools using the default channel count grow; an explicit
+  // channel count is treated as fixed, as are direct-path addresses.
+  auto channels = GetFlagOrEnvValue(FLAGS_tensorstore_gcs_grpc_channels,
+                                    "TENSORSTORE_GCS_GRPC_CHANNELS");
+  if (num_channels != 0 || (channels && *channels > 0) ||
+      IsDirectPathAddress(address)) {
+    return ChannelsForAddress(address, num_channels);
+  }
+  return 2 * ChannelsForAddress(address, 0);
+}
+
 }  // namespace
 
 StorageStubPool::StorageStubPool(
     std::string address, uint32_t size,
-    std::shared_ptr<::grpc::ChannelCredentials> creds)
-    : address_(std::move(address)) {
+    std::shared_ptr<::grpc::ChannelCredentials> creds, uint32_t max_size)
+    : address_(std::move(address)), creds_(std::move(creds)) {
+  if (max_size == 0) {
+    max_size = MaxChannelsForAddress(address_, size);
+  }
   size = ChannelsForAddress(address_, size);
-  channels_.resize(size);
-  stubs_.resize(size);
+  max_size_ = std::max(size, max_size);
+  channels_.resize(max_size_);
 
   ABSL_LOG_IF(INFO, gcs_grpc_logging)
-      << "Connecting to " << address_ << " with " << size << " channels";
+      << "Connecting to " << address_ << " with " << size << " channels"
+      << " (max " << max_size_ << ")";
 
-  bool use_subchannel_pool =
+  use_subchannel_pool_ =
+      max_size_ > 1 &&
       GetFlagOrEnvValue(FLAGS_tensorstore_gcs_grpc_use_local_subchannel_pool,
                         "TENSORSTORE_GCS_GRPC_USE_LOCAL_SUBCHANNEL_POOL")
           .value_or(false);
-  for (int id = 0; id < channels_.size(); id++) {
-    // See google cloud storage client in:
-    // https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/storage_stub_factory.cc
-    auto args = grpc::ChannelArguments();
-    if (size > 1 && use_subchannel_pool) {
-      args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
-      args.SetInt(GRPC_ARG_CHANNEL_ID, id);
-      args.SetInt(GRPC_ARG_DNS_ENABLE_SRV_QUERIES, 0);
+  for (size_t id = 0; id < size; id++) {
+    channels_[id] = CreateChannelState(id);
+  }
+  size_.store(size, std::memory_order_release);
+}
+
+std::shared_ptr<StorageStubPool::ChannelState>
+StorageStubPool::CreateChannelState(size_t id) const {
+  // See google cloud storage client in:
+  // https://github.com/googleapis/google-cloud-cpp/blob/main/google/cloud/storage/internal/storage_stub_factory.cc
+  auto args = grpc::ChannelArguments();
+  if (use_subchannel_pool_) {
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    args.SetInt(GRPC_ARG_CHANNEL_ID, id);
+    args.SetInt(GRPC_ARG_DNS_ENABLE_SRV_QUERIES, 0);
+  }
+  auto state = std::make_shared<ChannelState>();
+  state->channel = grpc::CreateCustomChannel(address_, creds_, args);
+  state->stub = Storage::NewStub(state->channel);
+  return state;
+}
+
+size_t StorageStubPool::AddChannel(size_t expected_size,
+                                   size_t fallback) const {
+  absl::MutexLock lock(&mutex_);
+  size_t size = size_.load(std::memory_order_relaxed);
+  if (size != expected_size) {
+    // Another caller grew the pool; its new channel is the least loaded.
+    return size - 1;
+  }
+  if (size >= max_size_) return fallback;
+  channels_[size] = CreateChannelState(size);
+  size_.store(size + 1, std::memory_order_release);
+  ABSL_LOG_IF(INFO, gcs_grpc_logging)
+      << "Growing channel pool for " << address_ << " to " << (size + 1)
+      << " channels";
+  return size;
+}
+
+std::shared_ptr<StorageStubPool::Storage::StubInterface>
+StorageStubPool::get_next_stub() const {
+  const size_t size = this->size();
+  // Start the scan at a round-robin offset so that ties are spread across
+  // channels.
+  size_t id = (size > 1) ? (next_channel_index_.fetch_add(1) % size) : 0;
+  int64_t min_in_flight =
+      channels_[id]->in_flight.load(std::memory_order_relaxed);
+  for (size_t i = 1; i < size && min_in_flight > 0; ++i) {
+    size_t candidate = (id + i) % size;
+    int64_t in_flight =
+        channels_[candidate]->in_flight.load(std::memory_order_relaxed);
+    if (in_flight < min_in_flight) {
+      id = candidate;
+      min_in_flight = in_flight;
     }
-    channels_[id] = grpc::CreateCustomChannel(address_, creds, args);
-    stubs_[id] = Storage::NewStub(channels_[id]);
   }
+  if (min_in_flight >= kMaxInFlightPerChannel && size < max_size_) {
+    id = AddChannel(size, id);
+  }
+
+  std::shared_ptr<ChannelState> state = channels_[id];
+  state->in_flight.fetch_add(1, std::memory_order_relaxed);
+  Storage::StubInterface* stub = state->stub.get();
+  return std::shared_ptr<Storage::StubInterface>(
+      stub, [state = std::move(state)](Storage::StubInterface*) {
+        state->in_flight.fetch_sub(1, std::memory_order_relaxed);
+      });
+}
+
+std::vector<int64_t> StorageStubPool::in_flight() const {
+  const size_t size = this->size();
+  std::vector<int64_t> result(size);
+  for (size_t id = 0; id < size; ++id) {
+    result[id] = channels_[id]->in_flight.load(std::memory_order_relaxed);
+  }
+  return result;
 }
 
 void StorageStubPool::WaitForConnected(absl::Duration duration) {
-  for (auto& channel : channels_) {
-    channel->GetState(true);
+  const size_t size = this->size();
+  for (size_t id = 0; id < size; ++id) {
+    channels_[id]->channel->GetState(true);
   }
   if (duration > absl::ZeroDuration()) {
     auto timeout = absl::ToChronoTime(absl::Now() + duration);
-    for (auto& channel : channels_) {
-      channel->WaitForConnected(timeout);
+    for (size_t id = 0; id < size; ++id) {
+      channels_[id]->channel->WaitForConnected(timeout);
     }
   }
   ABSL_LOG_IF(INFO, gcs_grpc_logging)
       << "Connection established to " << address_ << " in state "
-      << channels_[0]->GetState(false);
+      << channels_[0]->channel->GetState(false);
 }
 
 std::shared_ptr<StorageStubPool> GetSharedStorageStubPool(
@@ -145,6 +246,7 @@ std::shared_ptr<StorageStubPool> GetSharedStorageStubPool(
   static absl::NoDestructor<
       absl::flat_hash_map<std::string, std::shared_ptr<StorageStubPool>>>
       shared_pool;
+  uint32_t max_size = MaxChannelsForAddress(address, size);
   size = ChannelsForAddress(address, size);
   std::string key = absl::StrFormat("%d/%s", size, address);
 
@@ -152,7 +254,7 @@ std::shared_ptr<StorageStubPool> GetSharedStorageStubPool(
   auto& pool = (*shared_pool)[key];
   if (pool == nullptr) {
     pool = std::make_shared<StorageStubPool>(std::move(address), size,
-                                             std::move(creds));
+                                             std::move(creds), max_size);
   }
   return pool;
 }
@@ -17,11 +17,13 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "google/storage/v2/storage.grpc.pb.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "grpcpp/channel.h"  // third_party
 #include "grpcpp/security/credentials.h"  // third_party
@@ -30,32 +32,67 @@ namespace tensorstore {
 namespace internal_gcs_grpc {
 
 // A gRPC ConnectionPool for Storage stubs.
+//
+// Stubs are handed out as leases: each stub returned by `get_next_stub()`
+// counts as an in-flight call on its channel until the last copy of the
+// returned pointer is released.  New calls are assigned to the channel with the
+// fewest in-flight calls, and when every channel is saturated the pool grows,
+// up to `max_size()` channels.
 class StorageStubPool {
   using Storage = ::google::storage::v2::Storage;
 
  public:
+  // In-flight calls per channel above which the pool adds a channel.  This
+  // matches the default HTTP/2 max concurrent streams limit, beyond which
+  // additional calls on the channel are queued.
+  static constexpr int64_t kMaxInFlightPerChannel = 100;
+
+  // Constructs a pool of `size` channels to `address`.  When `max_size` is 0,
+  // the maximum is derived from `address`, `size` and the
+  // `TENSORSTORE_GCS_GRPC_MAX_CHANNELS` environment variable.
   StorageStubPool(std::string address, uint32_t size,
-                  std::shared_ptr<::grpc::ChannelCredentials> creds);
+                  std::shared_ptr<::grpc::ChannelCredentials> creds,
+                  uint32_t max_size = 0);
 
   // Accessors
   const std::string& address() const { return address_; }
-  size_t size() const { return stubs_.size(); }
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+  size_t max_size() const { return max_size_; }
 
-  // Round-robin stub acquisition.
-  std::shared_ptr<Storage::StubInterface> get_next_stub() const {
-    size_t id = (stubs_.size() > 1)
-                    ? (next_channel_index_.fetch_add(1) % stubs_.size())
-                    : 0;
-    return stubs_[id];
-  }
+  // Returns the number of in-flight calls on each channel.
+  std::vector<int64_t> in_flight() const;
+
+  // Least-loaded stub acquisition.  The returned stub should be held for the
+  // duration of the call.
+  std::shared_ptr<Storage::StubInterface> get_next_stub() const;
 
   // Wait for the channels to resolve to the Connected state.
   void WaitForConnected(absl::Duration duration);
 
  private:
+  struct ChannelState {
+    std::shared_ptr<grpc::Channel> channel;
+    std::shared_ptr<Storage::StubInterface> stub;
+    std::atomic<int64_t> in_flight{0};
+  };
+
+  std::shared_ptr<ChannelState> CreateChannelState(size_t id) const;
+
+  // Adds a channel when the pool still has `expected_size` channels and is
+  // below `max_size_`, and returns its index.  If another caller has already
+  // grown the pool, returns the newest channel; otherwise returns `fallback`.
+  size_t AddChannel(size_t expected_size, size_t fallback) const;
+
   std::string address_;
-  std::vector<std::shared_ptr<Storage::StubInterface>> stubs_;
-  std::vector<std::shared_ptr<grpc::Channel>> channels_;
+  std::shared_ptr<::grpc::ChannelCredentials> creds_;
+  bool use_subchannel_pool_ = false;
+  size_t max_size_;
+
+  // Channels are only appended, into `channels_` which is sized to `max_size_`
+  // on construction, so readers need only observe `size_`.
+  mutable absl::Mutex mutex_;
+  mutable std::vector<std::shared_ptr<ChannelState>> channels_;
+  mutable std::atomic<size_t> size_ = 0;
   mutable std::atomic<size_t> next_channel_index_ = 0;
 };
 
@@ -0,0 +1,94 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/gcs_grpc/storage_stub_pool.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "grpcpp/security/credentials.h"  // third_party
+
+// protos
+#include "google/storage/v2/storage.grpc.pb.h"
+
+namespace {
+
+using ::google::storage::v2::Storage;
+using ::tensorstore::internal_gcs_grpc::StorageStubPool;
+using ::testing::ElementsAre;
+
+// Channels connect lazily, so no server is required at the address.
+constexpr char kAddress[] = "localhost:1";
+
+TEST(StorageStubPoolTest, LeastLoaded) {
+  StorageStubPool pool(kAddress, 2, grpc::InsecureChannelCredentials(),
+                       /*max_size=*/2);
+  EXPECT_EQ(2, pool.size());
+  EXPECT_EQ(2, pool.max_size());
+
+  auto a = pool.get_next_stub();
+  auto b = pool.get_next_stub();
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_THAT(pool.in_flight(), ElementsAre(1, 1));
+
+  // Releasing a lease makes its channel the least loaded one.
+  auto* released = a.get();
+  a.reset();
+  auto c = pool.get_next_stub();
+  EXPECT_EQ(released, c.get());
+
+  // Copies share a single lease.
+  auto d = c;
+  EXPECT_THAT(pool.in_flight(), ElementsAre(1, 1));
+  c.reset();
+  d.reset();
+  b.reset();
+  EXPECT_THAT(pool.in_flight(), ElementsAre(0, 0));
+}
+
+TEST(StorageStubPoolTest, GrowsWhenSaturated) {
+  StorageStubPool pool(kAddress, 1, grpc::InsecureChannelCredentials(),
+                       /*max_size=*/2);
+  EXPECT_EQ(1, pool.size());
+
+  std::vector<std::shared_ptr<Storage::StubInterface>> leases;
+  for (int64_t i = 0; i < StorageStubPool::kMaxInFlightPerChannel; ++i) {
+    leases.push_back(pool.get_next_stub());
+  }
+  EXPECT_EQ(1, pool.size());
+
+  // The next call saturates the first channel, adding a second.
+  leases.push_back(pool.get_next_stub());
+  EXPECT_EQ(2, pool.size());
+  EXPECT_NE(leases.front().get(), leases.back().get());
+
+  // Calls are balanced across both channels until the maximum is reached,
+  // after which the pool stops growing.
+  for (int64_t i = 1; i < StorageStubPool::kMaxInFlightPerChannel + 10; ++i) {
+    leases.push_back(pool.get_next_stub());
+  }
+  EXPECT_EQ(2, pool.size());
+  EXPECT_THAT(pool.in_flight(),
+              ElementsAre(StorageStubPool::kMaxInFlightPerChannel + 5,
+                          StorageStubPool::kMaxInFlightPerChannel + 5));
+
+  leases.clear();
+  EXPECT_THAT(pool.in_flight(), ElementsAre(0, 0));
+}
+
+}  // namespace
@@ -0,0 +1,141 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_kvstore_gcs_http {
+
+std::string FormatBatchBody(std::string_view boundary,
+                            span<const BatchPart> parts) {
+  std::string body;
+  for (const auto& part : parts) {
+    absl::StrAppend(&body, "--", boundary, "\r\n",
+                    "Content-Type: application/http\r\n", "Content-ID: <",
+                    part.content_id, ">\r\n\r\n", part.http_message, "\r\n");
+  }
+  absl::StrAppend(&body, "--", boundary, "--\r\n");
+  return body;
+}
+
+Result<std::vector<BatchPart>> ParseBatchBody(std::string_view boundary,
+                                              std::string_view body) {
+  const std::string delimiter = absl::StrCat("--", boundary);
+  std::vector<BatchPart> parts;
+
+  // Skip the preamble.
+  size_t pos = body.find(delimiter);
+  if (pos == std::string_view::npos || (pos != 0 && body[pos - 1] != '\n')) {
+    return absl::InvalidArgumentError("Missing multipart boundary");
+  }
+  while (true) {
+    std::string_view rest = body.substr(pos + delimiter.size());
+    if (absl::StartsWith(rest, "--")) break;
+
+    // Skip the remainder of the delimiter line.
+    size_t line_end = rest.find('\n');
+    if (line_end == std::string_view::npos) break;
+    rest.remove_prefix(line_end + 1);
+
+    // The part extends until the next delimiter, which starts a line.
+    size_t next = rest.find(absl::StrCat("\n", delimiter));
+    if (next == std::string_view::npos) {
+      return absl::InvalidArgumentError("Missing closing multipart boundary");
+    }
+    std::string_view part = rest.substr(0, next);
+    pos = (body.size() - rest.size()) + next + 1;
+    absl::ConsumeSuffix(&part, "\r");
+    absl::ConsumeSuffix(&part, "\r\n");
+
+    // Headers of the part are separated from the HTTP message by a blank line.
+    BatchPart batch_part;
+    while (!part.empty()) {
+      size_t eol = part.find('\n');
+      std::string_view line = part.substr(0, eol);
+      part.remove_prefix(eol == std::string_view::npos ? part.size()
+                                                       : eol + 1);
+      absl::ConsumeSuffix(&line, "\r");
+      if (line.empty()) break;
+      std::pair<std::string_view, std::string_view> header =
+          absl::StrSplit(line, absl::MaxSplits(':', 1));
+      if (absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(header.first),
+                                 "content-id")) {
+        std::string_view id = absl::StripAsciiWhitespace(header.second);
+        absl::ConsumePrefix(&id, "<");
+        absl::ConsumeSuffix(&id, ">");
+        batch_part.content_id = std::string(id);
+      }
+    }
+    batch_part.http_message = std::string(part);
+    parts.push_back(std::move(batch_part));
+  }
+  return parts;
+}
+
+std::optional<std::string> GetBatchBoundary(std::string_view content_type) {
+  for (std::string_view param : absl::StrSplit(content_type, ';')) {
+    param = absl::StripAsciiWhitespace(param);
+    std::string_view name = param.substr(0, param.find('='));
+    if (name.size() == param.size() ||
+        !absl::EqualsIgnoreCase(name, "boundary")) {
+      continue;
+    }
+    std::string_view value = param.substr(name.size() + 1);
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+      value = value.substr(1, value.size() - 2);
+    }
+    if (value.empty()) return std::nullopt;
+    return std::string(value);
+  }
+  return std::nullopt;
+}
+
+Result<int> GetBatchPartStatusCode(std::string_view http_message) {
+  // Status line: HTTP-version SP status-code SP reason-phrase
+  std::string_view status_line =
+      http_message.substr(0, http_message.find('\n'));
+  absl::ConsumeSuffix(&status_line, "\r");
+  std::vector<std::string_view> fields =
+      absl::StrSplit(status_line, absl::MaxSplits(' ', 2));
+  int status_code;
+  if (fields.size() < 2 || !absl::StartsWith(fields[0], "HTTP/") ||
+      !absl::SimpleAtoi(fields[1], &status_code)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid batch response status line: ",
+                     QuoteString(absl::StripAsciiWhitespace(status_line))));
+  }
+  return status_code;
+}
+
+}  // namespace internal_kvstore_gcs_http
+}  // namespace tensorstore
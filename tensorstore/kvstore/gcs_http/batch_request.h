@@ -0,0 +1,68 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
+#define TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
+
+/// \file
+/// Encoding of the `multipart/mixed` bodies used by the GCS JSON API batch
+/// endpoint, which combines up to 100 API calls into a single HTTP request.
+/// https://cloud.google.com/storage/docs/batch
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_kvstore_gcs_http {
+
+/// Maximum number of calls in a single batch request.
+constexpr size_t kMaxBatchSize = 100;
+
+/// A single embedded HTTP request or response of a batch.
+struct BatchPart {
+  /// Value of the `Content-ID` header, without the enclosing angle brackets.
+  /// Each part of a response has the `Content-ID` of the corresponding request
+  /// part, prefixed by "response-".
+  std::string content_id;
+
+  /// The embedded HTTP message, e.g. "DELETE /storage/v1/b/... HTTP/1.1".
+  std::string http_message;
+};
+
+/// Returns a `multipart/mixed` body containing `parts`.
+std::string FormatBatchBody(std::string_view boundary,
+                            span<const BatchPart> parts);
+
+/// Parses a `multipart/mixed` body.
+Result<std::vector<BatchPart>> ParseBatchBody(std::string_view boundary,
+                                              std::string_view body);
+
+/// Returns the boundary parameter of a `multipart/mixed` content type.
+std::optional<std::string> GetBatchBoundary(std::string_view content_type);
+
+/// Returns the status code from the status line of an embedded HTTP response.
+Result<int> GetBatchPartStatusCode(std::string_view http_message);
+
+}  // namespace internal_kvstore_gcs_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_GCS_HTTP_BATCH_REQUEST_H_
@@ -0,0 +1,117 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_kvstore_gcs_http::BatchPart;
+using ::tensorstore::internal_kvstore_gcs_http::FormatBatchBody;
+using ::tensorstore::internal_kvstore_gcs_http::GetBatchBoundary;
+using ::tensorstore::internal_kvstore_gcs_http::GetBatchPartStatusCode;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchBody;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::Optional;
+
+TEST(BatchRequestTest, FormatBatchBody) {
+  std::vector<BatchPart> parts{
+      {"0", "DELETE /storage/v1/b/bucket/o/a HTTP/1.1\r\n"},
+      {"1", "DELETE /storage/v1/b/bucket/o/b HTTP/1.1\r\n"},
+  };
+  EXPECT_EQ(
+      "--xyz\r\n"
+      "Content-Type: application/http\r\n"
+      "Content-ID: <0>\r\n"
+      "\r\n"
+      "DELETE /storage/v1/b/bucket/o/a HTTP/1.1\r\n"
+      "\r\n"
+      "--xyz\r\n"
+      "Content-Type: application/http\r\n"
+      "Content-ID: <1>\r\n"
+      "\r\n"
+      "DELETE /storage/v1/b/bucket/o/b HTTP/1.1\r\n"
+      "\r\n"
+      "--xyz--\r\n",
+      FormatBatchBody("xyz", parts));
+}
+
+TEST(BatchRequestTest, RoundTrip) {
+  std::vector<BatchPart> parts{
+      {"response-0", "HTTP/1.1 204 No Content\r\n"},
+      {"response-1", "HTTP/1.1 404 Not Found\r\n\r\n{}"},
+  };
+  auto body = FormatBatchBody("batch_abc", parts);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto parsed,
+                                   ParseBatchBody("batch_abc", body));
+  EXPECT_THAT(
+      parsed,
+      ElementsAre(
+          Field(&BatchPart::content_id, "response-0"),
+          Field(&BatchPart::content_id, "response-1")));
+  EXPECT_THAT(GetBatchPartStatusCode(parsed[0].http_message),
+              IsOkAndHolds(204));
+  EXPECT_THAT(GetBatchPartStatusCode(parsed[1].http_message),
+              IsOkAndHolds(404));
+}
+
+TEST(BatchRequestTest, ParseWithPreambleAndBareNewlines) {
+  std::string body =
+      "preamble\n"
+      "--b\n"
+      "Content-Type: application/http\n"
+      "content-id: <response-7>\n"
+      "\n"
+      "HTTP/1.1 200 OK\n"
+      "Content-Type: application/json\n"
+      "\n"
+      "{}\n"
+      "--b--\n";
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto parsed, ParseBatchBody("b", body));
+  ASSERT_EQ(1, parsed.size());
+  EXPECT_EQ("response-7", parsed[0].content_id);
+  EXPECT_EQ("HTTP/1.1 200 OK\nContent-Type: application/json\n\n{}",
+            parsed[0].http_message);
+}
+
+TEST(BatchRequestTest, ParseErrors) {
+  EXPECT_THAT(ParseBatchBody("b", "no boundary"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseBatchBody("b", "--b\r\nContent-ID: <0>\r\n\r\nHTTP/1.1"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(GetBatchPartStatusCode("garbage"),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BatchRequestTest, GetBatchBoundary) {
+  EXPECT_THAT(GetBatchBoundary("multipart/mixed; boundary=batch_x"),
+              Optional(std::string("batch_x")));
+  EXPECT_THAT(GetBatchBoundary("multipart/mixed; Boundary=\"a b\""),
+              Optional(std::string("a b")));
+  EXPECT_EQ(std::nullopt, GetBatchBoundary("multipart/mixed"));
+  EXPECT_EQ(std::nullopt, GetBatchBoundary("application/json"));
+}
+
+}  // namespace
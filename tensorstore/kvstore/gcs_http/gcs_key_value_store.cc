@@ -15,12 +15,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -31,8 +33,10 @@
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/strip.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -48,6 +52,7 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json/json.h"
 #include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
@@ -56,28 +61,41 @@
 #include "tensorstore/internal/oauth2/auth_provider.h"
 #include "tensorstore/internal/oauth2/google_auth_provider.h"
 #include "tensorstore/internal/path.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/retries_context_resource.h"
 #include "tensorstore/internal/source_location.h"
 #include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/kvstore/auto_batch.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
+#include "tensorstore/kvstore/copy_range_util.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/gcs/gcs_resource.h"
 #include "tensorstore/kvstore/gcs/validate.h"
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
 #include "tensorstore/kvstore/gcs_http/gcs_resource.h"
 #include "tensorstore/kvstore/gcs_http/object_metadata.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/hedged_read.h"
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+#include "tensorstore/kvstore/http/parallel_list.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_byte_budget.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/single_flight_read.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/kvstore/tenant_resource.h"
 #include "tensorstore/kvstore/url_registry.h"
+#include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/executor.h"
@@ -122,13 +140,26 @@ using ::tensorstore::internal_http::HttpRequest;
 using ::tensorstore::internal_http::HttpRequestBuilder;
 using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_http::HttpTransport;
+using ::tensorstore::internal_http::DelimitedListPage;
 using ::tensorstore::internal_http::IssueRequestOptions;
+using ::tensorstore::internal_http::IsThrottlingStatus;
+using ::tensorstore::internal_kvstore::ReadByteBudgetResource;
+using ::tensorstore::internal_kvstore::TenantResource;
+using ::tensorstore::internal_kvstore_batch::AutoBatchResource;
+using ::tensorstore::internal_kvstore_gcs_http::BatchPart;
+using ::tensorstore::internal_kvstore_gcs_http::FormatBatchBody;
 using ::tensorstore::internal_kvstore_gcs_http::GcsConcurrencyResource;
+using ::tensorstore::internal_kvstore_gcs_http::GcsConnectionPrewarm;
 using ::tensorstore::internal_kvstore_gcs_http::GcsRateLimiterResource;
+using ::tensorstore::internal_kvstore_gcs_http::GetBatchBoundary;
+using ::tensorstore::internal_kvstore_gcs_http::GetBatchPartStatusCode;
+using ::tensorstore::internal_kvstore_gcs_http::kMaxBatchSize;
 using ::tensorstore::internal_kvstore_gcs_http::ObjectMetadata;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchBody;
 using ::tensorstore::internal_kvstore_gcs_http::ParseObjectMetadata;
 using ::tensorstore::internal_metrics::MetricMetadata;
 using ::tensorstore::internal_storage_gcs::GcsHttpResponseToStatus;
+using ::tensorstore::internal_storage_gcs::GcsRequestHedging;
 using ::tensorstore::internal_storage_gcs::GcsRequestRetries;
 using ::tensorstore::internal_storage_gcs::GcsUserProjectResource;
 using ::tensorstore::internal_storage_gcs::IsRetriable;
@@ -191,6 +222,10 @@ auto& gcs_delete_range = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/delete_range",
     MetricMetadata("GCS driver kvstore::DeleteRange calls"));
 
+auto& gcs_copy_range = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/gcs/copy_range",
+    MetricMetadata("GCS driver kvstore::ExperimentalCopyRange calls"));
+
 auto& gcs_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/gcs/list",
     MetricMetadata("GCS driver kvstore::List calls"));
@@ -221,6 +256,9 @@ IssueRequestOptions::HttpVersion GetHttpVersion() {
     if (*version == "2" || *version == "2.0") {
       return HttpVersion::kHttp2PriorKnowledge;
     }
+    if (*version == "3" || *version == "3.0") {
+      return HttpVersion::kHttp3;
+    }
     return HttpVersion::kHttp2TLS;
   }();
   return http_version;
@@ -278,18 +316,60 @@ std::string BucketUploadRoot(std::string_view bucket) {
                              "/b/", bucket);
 }
 
+/// Chunks of a resumable upload, other than the last, must be a multiple of
+/// this size.
+/// https://cloud.google.com/storage/docs/performing-resumable-uploads
+static constexpr size_t kResumableUploadChunkAlignment = size_t{256} * 1024;
+
+/// Maximum number of source objects of a compose request.
+/// https://cloud.google.com/storage/docs/composite-objects
+static constexpr size_t kMaxComposeSources = 32;
+
+/// Default resumable upload parameters.
+static constexpr size_t kDefaultResumableUploadThreshold =
+    size_t{16} * 1024 * 1024;
+static constexpr size_t kDefaultResumableUploadChunkSize =
+    size_t{16} * 1024 * 1024;
+
 struct GcsKeyValueStoreSpecData {
   std::string bucket;
 
+  /// Values of at least this size are written using a resumable upload, in
+  /// chunks of `resumable_upload_chunk_size` bytes.
+  size_t resumable_upload_threshold = kDefaultResumableUploadThreshold;
+  size_t resumable_upload_chunk_size = kDefaultResumableUploadChunkSize;
+
+  /// If specified, values larger than this are uploaded as concurrent parts
+  /// of at least this size, which are then composed into the final object.
+  std::optional<size_t> composite_upload_part_size;
+
+  /// If specified, reads of byte ranges larger than this are split into
+  /// concurrent requests of at most this many bytes.
+  std::optional<int64_t> parallel_read_part_size;
+
+  /// If specified, overrides the HTTP version specified by
+  /// `--tensorstore_gcs_http_version`.
+  std::optional<IssueRequestOptions::HttpVersion> http_version;
+
   Context::Resource<GcsConcurrencyResource> request_concurrency;
   std::optional<Context::Resource<GcsRateLimiterResource>> rate_limiter;
   Context::Resource<GcsUserProjectResource> user_project;
   Context::Resource<GcsRequestRetries> retries;
+  Context::Resource<GcsRequestHedging> request_hedging;
+  Context::Resource<GcsConnectionPrewarm> connection_prewarm;
+  Context::Resource<AutoBatchResource> auto_batch;
+  Context::Resource<ReadByteBudgetResource> read_byte_budget;
+  Context::Resource<TenantResource> tenant;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
+  internal_kvstore_batch::CoalescingOverrides read_coalescing;
 
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(x.bucket, x.request_concurrency, x.rate_limiter, x.user_project,
-             x.retries, x.data_copy_concurrency);
+    return f(x.bucket, x.resumable_upload_threshold,
+             x.resumable_upload_chunk_size, x.composite_upload_part_size,
+             x.parallel_read_part_size, x.http_version, x.request_concurrency,
+             x.rate_limiter, x.user_project, x.retries, x.request_hedging,
+             x.connection_prewarm, x.auto_batch, x.read_byte_budget, x.tenant,
+             x.data_copy_concurrency, x.read_coalescing);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -304,6 +384,49 @@ struct GcsKeyValueStoreSpecData {
                        }
                        return absl::OkStatus();
                      }))),
+      jb::Member(
+          "resumable_upload_threshold",
+          jb::Projection<
+              &GcsKeyValueStoreSpecData::resumable_upload_threshold>(
+              jb::DefaultValue(
+                  [](auto* v) { *v = kDefaultResumableUploadThreshold; },
+                  jb::Integer<size_t>(1)))),
+      jb::Member(
+          "resumable_upload_chunk_size",
+          jb::Projection<
+              &GcsKeyValueStoreSpecData::resumable_upload_chunk_size>(
+              jb::DefaultValue(
+                  [](auto* v) { *v = kDefaultResumableUploadChunkSize; },
+                  jb::Validate(
+                      [](const auto& options, const size_t* x) {
+                        if (*x % kResumableUploadChunkAlignment != 0) {
+                          return absl::InvalidArgumentError(
+                              tensorstore::StrCat(
+                                  "resumable_upload_chunk_size must be a "
+                                  "multiple of ",
+                                  kResumableUploadChunkAlignment));
+                        }
+                        return absl::OkStatus();
+                      },
+                      jb::Integer<size_t>(kResumableUploadChunkAlignment))))),
+      jb::Member(
+          "composite_upload_part_size",
+          jb::Projection<
+              &GcsKeyValueStoreSpecData::composite_upload_part_size>(
+              jb::Optional(jb::Integer<size_t>(1)))),
+      jb::Member(
+          "parallel_read_part_size",
+          jb::Projection<&GcsKeyValueStoreSpecData::parallel_read_part_size>(
+              jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member(
+          "http_version",
+          jb::Projection<&GcsKeyValueStoreSpecData::http_version>(
+              jb::Optional(jb::Enum<IssueRequestOptions::HttpVersion,
+                                    std::string_view>({
+                  {IssueRequestOptions::HttpVersion::kHttp1, "1.1"},
+                  {IssueRequestOptions::HttpVersion::kHttp2TLS, "2"},
+                  {IssueRequestOptions::HttpVersion::kHttp3, "3"},
+              })))),
 
       jb::Member(
           GcsConcurrencyResource::id,
@@ -318,9 +441,25 @@ struct GcsKeyValueStoreSpecData {
                  jb::Projection<&GcsKeyValueStoreSpecData::user_project>()),
       jb::Member(GcsRequestRetries::id,
                  jb::Projection<&GcsKeyValueStoreSpecData::retries>()),
+      jb::Member(
+          GcsRequestHedging::id,
+          jb::Projection<&GcsKeyValueStoreSpecData::request_hedging>()),
+      jb::Member(
+          GcsConnectionPrewarm::id,
+          jb::Projection<&GcsKeyValueStoreSpecData::connection_prewarm>()),
+      jb::Member(AutoBatchResource::id,
+                 jb::Projection<&GcsKeyValueStoreSpecData::auto_batch>()),
+      jb::Member(
+          ReadByteBudgetResource::id,
+          jb::Projection<&GcsKeyValueStoreSpecData::read_byte_budget>()),
+      jb::Member(TenantResource::id,
+                 jb::Projection<&GcsKeyValueStoreSpecData::tenant>()),
       jb::Member(DataCopyConcurrencyResource::id,
                  jb::Projection<
-                     &GcsKeyValueStoreSpecData::data_copy_concurrency>()) /**/
+                     &GcsKeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member("read_coalescing",
+                 jb::Projection<&GcsKeyValueStoreSpecData::read_coalescing>(
+                     jb::DefaultInitializedValue())) /**/
   );
 };
 
@@ -359,23 +498,58 @@ class GcsKeyValueStore
     return encoded_user_project_;
   }
 
-  internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
-      const {
-    return internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions;
+  internal_kvstore_batch::CoalescingPolicy& coalescing_policy() {
+    return *coalescing_policy_;
+  }
+
+  internal_kvstore_batch::SingleFlightReads& single_flight_reads() {
+    return single_flight_reads_;
   }
 
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a single read request.
+  Future<ReadResult> ReadPart(const Key& key, ReadOptions options);
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
+  /// Writes a value to a single object, using a resumable upload if it is
+  /// large.
+  Future<TimestampedStorageGeneration> WriteObject(
+      std::string encoded_object_name, absl::Cord value, WriteOptions options);
+
+  /// Deletes a single object.
+  Future<TimestampedStorageGeneration> DeleteObject(
+      std::string encoded_object_name, WriteOptions options);
+
+  /// Unconditionally deletes up to `kMaxBatchSize` objects with a single
+  /// batch request.
+  Future<const void> BatchDelete(std::vector<std::string> encoded_object_names);
+
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// Lists the first page of the objects with the prefix
+  /// `LongestPrefix(range)`, using `/` as the delimiter.
+  Future<DelimitedListPage> ListPage(KeyRange range);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
+  /// Copies the keys of another `gcs` kvstore using server-side rewrites, such
+  /// that the data is never transferred through the client.  Otherwise, falls
+  /// back to the default implementation.
+  Future<const void> ExperimentalCopyRangeFrom(
+      const internal::OpenTransactionPtr& transaction, const KvStore& source,
+      Key target_prefix, kvstore::CopyRangeOptions options) override;
+
+  /// Copies a single object, which may be in another bucket, to this bucket.
+  Future<const void> RewriteObject(std::string source_resource_root,
+                                   std::string encoded_source_object_name,
+                                   std::string encoded_object_name);
+
   /// Returns the Auth header for a GCS request.
   Result<std::optional<std::string>> GetAuthHeader() {
     absl::MutexLock lock(&auth_provider_mutex_);
@@ -414,7 +588,16 @@ class GcsKeyValueStore
     return no_rate_limiter_;
   }
 
-  RateLimiter& admission_queue() { return *spec_.request_concurrency->queue; }
+  RateLimiter& admission_queue() {
+    if (adaptive_queue_) return *adaptive_queue_;
+    return *spec_.request_concurrency->queue;
+  }
+
+  // Admits `node` to the admission queue on behalf of the tenant.
+  void AdmitRequest(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
+    node->tenant_ = spec_.tenant->tenant.get();
+    admission_queue().Admit(node, fn);
+  }
 
   absl::Status GetBoundSpecData(SpecData& spec) const {
     spec = spec_;
@@ -428,7 +611,8 @@ class GcsKeyValueStore
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
     return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+           SupportedFeatures::kAtomicWriteWithoutOverwrite |
+           SupportedFeatures::kListGenerations;
   }
 
   // Apply default backoff/retry logic to the task.
@@ -440,6 +624,9 @@ class GcsKeyValueStore
       absl::Status status, int attempt, Task* task,
       SourceLocation loc = ::tensorstore::SourceLocation::current()) {
     assert(task != nullptr);
+    if (adaptive_queue_ && IsThrottlingStatus(status)) {
+      adaptive_queue_->OnThrottled();
+    }
     auto delay = spec_.retries->BackoffForAttempt(attempt);
     if (!delay) {
       return MaybeAnnotateStatus(std::move(status),
@@ -458,12 +645,17 @@ class GcsKeyValueStore
   }
 
   SpecData spec_;
+  std::optional<internal_kvstore_batch::CoalescingPolicy> coalescing_policy_;
+  internal_kvstore_batch::SingleFlightReads single_flight_reads_;
   std::string resource_root_;  // bucket resource root.
   std::string upload_root_;    // bucket upload root.
   std::string encoded_user_project_;
   NoRateLimiter no_rate_limiter_;
+  // Admission queue for the bucket when `request_concurrency` is adaptive.
+  std::shared_ptr<internal::AimdAdmissionQueue> adaptive_queue_;
 
   std::shared_ptr<HttpTransport> transport_;
+  IssueRequestOptions::HttpVersion http_version_;
 
   absl::Mutex auth_provider_mutex_;
   // Optional state indicates whether the provider has been obtained.  A
@@ -474,9 +666,19 @@ class GcsKeyValueStore
 Future<kvstore::DriverPtr> GcsKeyValueStoreSpec::DoOpen() const {
   auto driver = internal::MakeIntrusivePtr<GcsKeyValueStore>();
   driver->spec_ = data_;
+  driver->coalescing_policy_.emplace(
+      internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions,
+      data_.read_coalescing);
   driver->resource_root_ = BucketResourceRoot(data_.bucket);
   driver->upload_root_ = BucketUploadRoot(data_.bucket);
   driver->transport_ = internal_http::GetDefaultHttpTransport();
+  driver->http_version_ = data_.http_version.value_or(GetHttpVersion());
+  if (const auto& prewarmer = data_.connection_prewarm->prewarmer) {
+    prewarmer->Prewarm(*driver->transport_, driver->resource_root_);
+  }
+  if (const auto& queues = data_.request_concurrency->adaptive_queues) {
+    driver->adaptive_queue_ = queues->Get(data_.bucket);
+  }
 
   // NOTE: Remove temporary logging use of experimental feature.
   if (data_.rate_limiter.has_value()) {
@@ -536,14 +738,16 @@ struct ReadTask : public RateLimiterNode,
       : owner(std::move(owner)),
         resource(std::move(resource)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)) {
+    priority_ = static_cast<int>(this->options.priority);
+  }
 
   ~ReadTask() { owner->admission_queue().Finish(this); }
 
   static void Start(void* task) {
     auto* self = reinterpret_cast<ReadTask*>(task);
     self->owner->read_rate_limiter().Finish(self);
-    self->owner->admission_queue().Admit(self, &ReadTask::Admit);
+    self->owner->AdmitRequest(self, &ReadTask::Admit);
   }
 
   static void Admit(void* task) {
@@ -594,7 +798,10 @@ struct ReadTask : public RateLimiterNode,
 
     ABSL_LOG_IF(INFO, gcs_http_logging) << "ReadTask: " << request;
     auto future = owner->transport_->IssueRequest(
-        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
+        request, IssueRequestOptions()
+                     .SetHttpVersion(owner->http_version_)
+                     .SetResponseSizeHint(
+                         std::max<int64_t>(0, options.byte_range.size())));
     future.ExecuteWhenReady([self = IntrusivePtr<ReadTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
       self->OnResponse(response.result());
@@ -698,12 +905,45 @@ Future<kvstore::ReadResult> GcsKeyValueStore::Read(Key key,
     return absl::InvalidArgumentError("Malformed StorageGeneration");
   }
   return internal_kvstore_batch::HandleBatchRequestByGenericByteRangeCoalescing(
-      *this, std::move(key), std::move(options));
+      *this, std::move(key), std::move(options),
+      spec_.auto_batch->batcher.get());
 }
 
 Future<kvstore::ReadResult> GcsKeyValueStore::ReadImpl(Key&& key,
                                                        ReadOptions&& options) {
   gcs_batch_read.Increment();
+  const auto& hedger = spec_.request_hedging->hedger;
+  const auto& budget = spec_.read_byte_budget->budget;
+  if (!spec_.parallel_read_part_size && !hedger && !budget) {
+    return ReadPart(key, std::move(options));
+  }
+  internal_http::ReadPartFunction read_part =
+      [self = internal::IntrusivePtr<GcsKeyValueStore>(this),
+       key = std::move(key)](ReadOptions options) {
+        return self->ReadPart(key, std::move(options));
+      };
+  if (hedger) {
+    read_part = [hedger, read_part = std::move(read_part)](
+                    ReadOptions options) {
+      return internal_http::HedgedRead(hedger, std::move(options), read_part);
+    };
+  }
+  if (budget) {
+    read_part = [budget, executor = executor(),
+                 read_part = std::move(read_part)](ReadOptions options) {
+      return budget->Read(executor, std::move(options), read_part);
+    };
+  }
+  if (spec_.parallel_read_part_size) {
+    return internal_http::ParallelByteRangeRead(
+        std::move(options), *spec_.parallel_read_part_size,
+        std::move(read_part));
+  }
+  return read_part(std::move(options));
+}
+
+Future<kvstore::ReadResult> GcsKeyValueStore::ReadPart(const Key& key,
+                                                       ReadOptions options) {
   auto encoded_object_name = internal::PercentEncodeUriComponent(key);
   std::string resource = tensorstore::internal::JoinPath(resource_root_, "/o/",
                                                          encoded_object_name);
@@ -718,6 +958,41 @@ Future<kvstore::ReadResult> GcsKeyValueStore::ReadImpl(Key&& key,
   return std::move(op.future);
 }
 
+/// Returns the generation written by a successful request which uploads or
+/// composes an object, or `StorageGeneration::Unknown()` if the generation
+/// condition of `options` was not satisfied.
+Result<TimestampedStorageGeneration> ParseWriteResponse(
+    const HttpResponse& httpresponse, const kvstore::WriteOptions& options,
+    absl::Time start_time) {
+  TimestampedStorageGeneration r;
+  r.time = start_time;
+  switch (httpresponse.status_code) {
+    case 304:
+      // Not modified implies that the generation did not match.
+      [[fallthrough]];
+    case 412:
+      // Failed precondition implies the generation did not match.
+      r.generation = StorageGeneration::Unknown();
+      return r;
+    case 404:
+      if (!StorageGeneration::IsUnknown(
+              options.generation_conditions.if_equal)) {
+        r.generation = StorageGeneration::Unknown();
+        return r;
+      }
+  }
+
+  // TODO: Avoid parsing the entire metadata & only extract the
+  // generation field.
+  auto payload = httpresponse.payload;
+  auto parsed_object_metadata = ParseObjectMetadata(payload.Flatten());
+  TENSORSTORE_RETURN_IF_ERROR(parsed_object_metadata);
+
+  r.generation =
+      StorageGeneration::FromUint64(parsed_object_metadata->generation);
+  return r;
+}
+
 /// A WriteTask is a function object used to satisfy a
 /// GcsKeyValueStore::Write request.
 struct WriteTask : public RateLimiterNode,
@@ -746,7 +1021,7 @@ struct WriteTask : public RateLimiterNode,
   static void Start(void* task) {
     auto* self = reinterpret_cast<WriteTask*>(task);
     self->owner->write_rate_limiter().Finish(self);
-    self->owner->admission_queue().Admit(self, &WriteTask::Admit);
+    self->owner->AdmitRequest(self, &WriteTask::Admit);
   }
   static void Admit(void* task) {
     auto* self = reinterpret_cast<WriteTask*>(task);
@@ -794,7 +1069,8 @@ struct WriteTask : public RateLimiterNode,
         << "WriteTask: " << request << " size=" << value.size();
 
     auto future = owner->transport_->IssueRequest(
-        request, IssueRequestOptions(value).SetHttpVersion(GetHttpVersion()));
+        request,
+        IssueRequestOptions(value).SetHttpVersion(owner->http_version_));
     future.ExecuteWhenReady([self = IntrusivePtr<WriteTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
       self->OnResponse(response.result());
@@ -845,109 +1121,127 @@ struct WriteTask : public RateLimiterNode,
 
   Result<TimestampedStorageGeneration> FinishResponse(
       const HttpResponse& httpresponse) {
-    TimestampedStorageGeneration r;
-    r.time = start_time_;
-    switch (httpresponse.status_code) {
-      case 304:
-        // Not modified implies that the generation did not match.
-        [[fallthrough]];
-      case 412:
-        // Failed precondition implies the generation did not match.
-        r.generation = StorageGeneration::Unknown();
-        return r;
-      case 404:
-        if (!StorageGeneration::IsUnknown(
-                options.generation_conditions.if_equal)) {
-          r.generation = StorageGeneration::Unknown();
-          return r;
-        }
+    auto r = ParseWriteResponse(httpresponse, options, start_time_);
+    if (r.ok() && !StorageGeneration::IsUnknown(r->generation)) {
+      auto latency = absl::Now() - start_time_;
+      gcs_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+      gcs_bytes_written.IncrementBy(value.size());
     }
-
-    auto latency = absl::Now() - start_time_;
-    gcs_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
-    gcs_bytes_written.IncrementBy(value.size());
-
-    // TODO: Avoid parsing the entire metadata & only extract the
-    // generation field.
-    auto payload = httpresponse.payload;
-    auto parsed_object_metadata = ParseObjectMetadata(payload.Flatten());
-    TENSORSTORE_RETURN_IF_ERROR(parsed_object_metadata);
-
-    r.generation =
-        StorageGeneration::FromUint64(parsed_object_metadata->generation);
     return r;
   }
 };
 
-/// A DeleteTask is a function object used to satisfy a
-/// GcsKeyValueStore::Delete request.
-struct DeleteTask : public RateLimiterNode,
-                    public internal::AtomicReferenceCount<DeleteTask> {
+/// A ResumableUploadTask writes a large value using a resumable upload.
+///
+/// The upload session is created with the generation condition, which GCS
+/// checks again when the object is finalized.  The value is then sent in
+/// chunks of `resumable_upload_chunk_size` bytes.  If a chunk fails, the number
+/// of bytes persisted by GCS is queried and the upload resumes from there,
+/// rather than sending the whole value again.
+/// https://cloud.google.com/storage/docs/performing-resumable-uploads
+struct ResumableUploadTask
+    : public RateLimiterNode,
+      public internal::AtomicReferenceCount<ResumableUploadTask> {
   IntrusivePtr<GcsKeyValueStore> owner;
-  std::string resource;
+  std::string encoded_object_name;
+  absl::Cord value;
   kvstore::WriteOptions options;
   Promise<TimestampedStorageGeneration> promise;
 
   int attempt_ = 0;
   absl::Time start_time_;
 
-  DeleteTask(IntrusivePtr<GcsKeyValueStore> owner, std::string resource,
-             kvstore::WriteOptions options,
-             Promise<TimestampedStorageGeneration> promise)
+  // Session URI of the upload, or empty if no session has been created.
+  std::string session_uri_;
+  // Number of bytes of `value` persisted by GCS.
+  size_t persisted_ = 0;
+  // Whether the upload status must be queried before sending the next chunk.
+  bool query_status_ = false;
+
+  ResumableUploadTask(IntrusivePtr<GcsKeyValueStore> owner,
+                      std::string encoded_object_name, absl::Cord value,
+                      kvstore::WriteOptions options,
+                      Promise<TimestampedStorageGeneration> promise)
       : owner(std::move(owner)),
-        resource(std::move(resource)),
+        encoded_object_name(std::move(encoded_object_name)),
+        value(std::move(value)),
         options(std::move(options)),
         promise(std::move(promise)) {}
 
-  ~DeleteTask() { owner->admission_queue().Finish(this); }
+  ~ResumableUploadTask() { owner->admission_queue().Finish(this); }
 
   static void Start(void* task) {
-    auto* self = reinterpret_cast<DeleteTask*>(task);
+    auto* self = reinterpret_cast<ResumableUploadTask*>(task);
     self->owner->write_rate_limiter().Finish(self);
-    self->owner->admission_queue().Admit(self, &DeleteTask::Admit);
+    self->owner->AdmitRequest(self, &ResumableUploadTask::Admit);
   }
-
   static void Admit(void* task) {
-    auto* self = reinterpret_cast<DeleteTask*>(task);
-    self->owner->executor()(
-        [state = IntrusivePtr<DeleteTask>(self, internal::adopt_object_ref)] {
-          state->Retry();
-        });
+    auto* self = reinterpret_cast<ResumableUploadTask*>(task);
+    self->owner->executor()([state = IntrusivePtr<ResumableUploadTask>(
+                                 self, internal::adopt_object_ref)] {
+      state->Retry();
+    });
   }
 
-  /// Removes an object from GCS.
+  /// Issues the next request of the upload.
   void Retry() {
     if (!promise.result_needed()) {
       return;
     }
-    std::string delete_url = resource;
-
-    // Add the ifGenerationNotMatch condition.
-    bool has_query = AddGenerationParam(&delete_url, false, "ifGenerationMatch",
-                                        options.generation_conditions.if_equal);
-
-    // Assume that if the user_project field is set, that we want to provide
-    // it on the uri for a requestor pays bucket.
-    AddUserProjectParam(&delete_url, has_query, owner->encoded_user_project());
-
     auto maybe_auth_header = owner->GetAuthHeader();
     if (!maybe_auth_header.ok()) {
       promise.SetResult(maybe_auth_header.status());
       return;
     }
-    HttpRequestBuilder request_builder("DELETE", delete_url);
+
+    absl::Cord payload;
+    std::string url = session_uri_;
+    if (session_uri_.empty()) {
+      url = tensorstore::StrCat(owner->upload_root(), "/o",
+                                "?uploadType=resumable",
+                                "&name=", encoded_object_name);
+      AddGenerationParam(&url, true, "ifGenerationMatch",
+                         options.generation_conditions.if_equal);
+      AddUserProjectParam(&url, true, owner->encoded_user_project());
+    }
+    HttpRequestBuilder request_builder(session_uri_.empty() ? "POST" : "PUT",
+                                       url);
     if (maybe_auth_header.value().has_value()) {
       request_builder.AddHeader(*maybe_auth_header.value());
     }
+    if (session_uri_.empty()) {
+      // Starts a new upload session.
+      start_time_ = absl::Now();
+      request_builder
+          .AddHeader("X-Upload-Content-Type: application/octet-stream")
+          .AddHeader(
+              tensorstore::StrCat("X-Upload-Content-Length: ", value.size()));
+    } else if (query_status_) {
+      // Queries the number of bytes persisted.
+      request_builder.AddHeader(
+          tensorstore::StrCat("Content-Range: bytes */", value.size()));
+    } else {
+      // Sends the next chunk.
+      payload = value.Subcord(
+          persisted_, std::min(owner->spec_.resumable_upload_chunk_size,
+                               value.size() - persisted_));
+      request_builder.AddHeader(tensorstore::StrCat(
+          "Content-Range: bytes ", persisted_, "-",
+          persisted_ + payload.size() - 1, "/", value.size()));
+    }
+    auto request =
+        request_builder
+            .AddHeader(tensorstore::StrCat("Content-Length: ", payload.size()))
+            .BuildRequest();
 
-    auto request = request_builder.BuildRequest();
-    start_time_ = absl::Now();
-
-    ABSL_LOG_IF(INFO, gcs_http_logging) << "DeleteTask: " << request;
+    ABSL_LOG_IF(INFO, gcs_http_logging)
+        << "ResumableUploadTask: " << request << " size=" << payload.size();
 
     auto future = owner->transport_->IssueRequest(
-        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
-    future.ExecuteWhenReady([self = IntrusivePtr<DeleteTask>(this)](
+        request,
+        IssueRequestOptions(std::move(payload))
+            .SetHttpVersion(owner->http_version_));
+    future.ExecuteWhenReady([self = IntrusivePtr<ResumableUploadTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
       self->OnResponse(response.result());
     });
@@ -958,17 +1252,43 @@ struct DeleteTask : public RateLimiterNode,
       return;
     }
     ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
-        << "DeleteTask " << *response;
+        << "ResumableUploadTask " << *response;
 
+    const bool has_session = !session_uri_.empty();
     bool is_retryable = IsRetriable(response.status());
     absl::Status status = [&]() -> absl::Status {
       if (!response.ok()) return response.status();
       switch (response.value().status_code) {
+        case 304:
+          // Not modified implies that the generation did not match.
+          [[fallthrough]];
         case 412:
           // Failed precondition implies the generation did not match.
-          [[fallthrough]];
-        case 404:
           return absl::OkStatus();
+        case 308:
+          // Resume incomplete.
+          if (has_session) {
+            return OnIncomplete(response.value(), is_retryable);
+          }
+          break;
+        case 404:
+          if (!has_session) {
+            if (!options.generation_conditions.MatchesNoValue()) {
+              return absl::OkStatus();
+            }
+            break;
+          }
+          [[fallthrough]];
+        case 410:
+          if (has_session) {
+            // The upload session has expired, so start a new one.
+            session_uri_.clear();
+            persisted_ = 0;
+            query_status_ = false;
+            is_retryable = true;
+            return absl::UnavailableError("Resumable upload session expired");
+          }
+          break;
         default:
           break;
       }
@@ -976,6 +1296,8 @@ struct DeleteTask : public RateLimiterNode,
     }();
 
     if (!status.ok() && is_retryable) {
+      // Part of an interrupted chunk may have been persisted.
+      query_status_ = !session_uri_.empty();
       status =
           owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
       if (status.ok()) {
@@ -987,143 +1309,948 @@ struct DeleteTask : public RateLimiterNode,
       return;
     }
 
-    TimestampedStorageGeneration r;
-    r.time = start_time_;
-    switch (response.value().status_code) {
-      case 412:
-        // Failed precondition implies the generation did not match.
-        r.generation = StorageGeneration::Unknown();
-        break;
-      case 404:
-        // 404 Not Found means aborted when a StorageGeneration was specified.
-        if (!options.generation_conditions.MatchesNoValue()) {
-          r.generation = StorageGeneration::Unknown();
-          break;
+    const auto& httpresponse = response.value();
+    if (httpresponse.status_code == 308 ||
+        (!has_session && httpresponse.status_code / 100 == 2)) {
+      if (!has_session) {
+        auto it = httpresponse.headers.find("location");
+        if (it == httpresponse.headers.end()) {
+          promise.SetResult(
+              absl::NotFoundError("location not found in response headers"));
+          return;
         }
-        [[fallthrough]];
-      default:
-        r.generation = StorageGeneration::NoValue();
-        break;
+        session_uri_ = it->second;
+      }
+      owner->executor()(
+          [self = IntrusivePtr<ResumableUploadTask>(this)] { self->Retry(); });
+      return;
     }
-    promise.SetResult(std::move(r));
+    promise.SetResult(FinishResponse(httpresponse));
   }
-};
 
-Future<TimestampedStorageGeneration> GcsKeyValueStore::Write(
-    Key key, std::optional<Value> value, WriteOptions options) {
-  gcs_write.Increment();
-  if (!IsValidObjectName(key)) {
-    return absl::InvalidArgumentError("Invalid GCS object name");
-  }
-  if (!IsValidStorageGeneration(options.generation_conditions.if_equal)) {
-    return absl::InvalidArgumentError("Malformed StorageGeneration");
+  /// Updates the number of persisted bytes from a "308 Resume Incomplete"
+  /// response.
+  absl::Status OnIncomplete(const HttpResponse& httpresponse,
+                            bool& is_retryable) {
+    size_t persisted = 0;
+    if (auto it = httpresponse.headers.find("range");
+        it != httpresponse.headers.end()) {
+      std::string_view range = it->second;
+      size_t last;
+      if (!absl::ConsumePrefix(&range, "bytes=0-") ||
+          !absl::SimpleAtoi(range, &last) || last >= value.size()) {
+        return absl::InvalidArgumentError(tensorstore::StrCat(
+            "Invalid range header in resumable upload response: ",
+            QuoteString(it->second)));
+      }
+      persisted = last + 1;
+    }
+    if (persisted == value.size()) {
+      // All bytes were persisted, but the object was not finalized.
+      is_retryable = true;
+      return absl::UnavailableError("Resumable upload was not finalized");
+    }
+    if (persisted > persisted_) {
+      // Reset the retry budget once progress has been made.
+      attempt_ = 0;
+    }
+    persisted_ = persisted;
+    query_status_ = false;
+    return absl::OkStatus();
   }
 
-  std::string encoded_object_name = internal::PercentEncodeUriComponent(key);
-  auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
-
-  if (value) {
-    auto state = internal::MakeIntrusivePtr<WriteTask>(
-        IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_name),
-        std::move(*value), std::move(options), std::move(op.promise));
-
-    intrusive_ptr_increment(state.get());  // adopted by WriteTask::Start.
-    write_rate_limiter().Admit(state.get(), &WriteTask::Start);
-  } else {
-    std::string resource = tensorstore::internal::JoinPath(
-        resource_root_, "/o/", encoded_object_name);
-
-    auto state = internal::MakeIntrusivePtr<DeleteTask>(
-        IntrusivePtr<GcsKeyValueStore>(this), std::move(resource),
-        std::move(options), std::move(op.promise));
-
-    intrusive_ptr_increment(state.get());  // adopted by DeleteTask::Start.
-    write_rate_limiter().Admit(state.get(), &DeleteTask::Start);
+  Result<TimestampedStorageGeneration> FinishResponse(
+      const HttpResponse& httpresponse) {
+    auto r = ParseWriteResponse(httpresponse, options, start_time_);
+    if (r.ok() && !StorageGeneration::IsUnknown(r->generation)) {
+      auto latency = absl::Now() - start_time_;
+      gcs_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+      gcs_bytes_written.IncrementBy(value.size());
+    }
+    return r;
   }
-  return std::move(op.future);
-}
-
-// List responds with a Json payload that includes these fields.
-struct GcsListResponsePayload {
-  std::string next_page_token;        // used to page through list results.
-  std::vector<ObjectMetadata> items;  // individual result metadata.
 };
 
-constexpr static auto GcsListResponsePayloadBinder = jb::Object(
-    jb::Member("nextPageToken",
-               jb::Projection(&GcsListResponsePayload::next_page_token,
-                              jb::DefaultInitializedValue())),
-    jb::Member("items", jb::Projection(&GcsListResponsePayload::items,
-                                       jb::DefaultInitializedValue())),
-    jb::DiscardExtraMembers);
-
-/// ListTask implements the ListImpl execution flow.
-struct ListTask : public RateLimiterNode,
-                  public internal::AtomicReferenceCount<ListTask> {
-  internal::IntrusivePtr<GcsKeyValueStore> owner_;
-  ListOptions options_;
-  ListReceiver receiver_;
-  std::string resource_;
+/// A ComposeTask concatenates temporary part objects of a
+/// `CompositeUploadTask` into the destination object.
+/// https://cloud.google.com/storage/docs/json_api/v1/objects/compose
+struct ComposeTask : public RateLimiterNode,
+                     public internal::AtomicReferenceCount<ComposeTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string encoded_object_name;
+  absl::Cord body;
+  kvstore::WriteOptions options;
+  Promise<TimestampedStorageGeneration> promise;
 
-  std::string base_list_url_;
-  std::string next_page_token_;
   int attempt_ = 0;
-  bool has_query_parameters_;
-  std::atomic<bool> cancelled_{false};
-
-  ListTask(internal::IntrusivePtr<GcsKeyValueStore>&& owner,
-           ListOptions&& options, ListReceiver&& receiver,
-           std::string&& resource)
-      : owner_(std::move(owner)),
-        options_(std::move(options)),
-        receiver_(std::move(receiver)),
-        resource_(std::move(resource)) {
-    // Construct the base LIST url. This will be modified to include the
-    // nextPageToken
-    base_list_url_ = resource_;
-    has_query_parameters_ = AddUserProjectParam(&base_list_url_, false,
-                                                owner_->encoded_user_project());
-    if (auto& inclusive_min = options_.range.inclusive_min;
-        !inclusive_min.empty()) {
-      absl::StrAppend(
-          &base_list_url_, (has_query_parameters_ ? "&" : "?"),
-          "startOffset=", internal::PercentEncodeUriComponent(inclusive_min));
-      has_query_parameters_ = true;
-    }
-    if (auto& exclusive_max = options_.range.exclusive_max;
-        !exclusive_max.empty()) {
-      absl::StrAppend(
-          &base_list_url_, (has_query_parameters_ ? "&" : "?"),
-          "endOffset=", internal::PercentEncodeUriComponent(exclusive_max));
-      has_query_parameters_ = true;
-    }
-  }
+  absl::Time start_time_;
 
-  ~ListTask() { owner_->admission_queue().Finish(this); }
+  ComposeTask(IntrusivePtr<GcsKeyValueStore> owner,
+              std::string encoded_object_name, absl::Cord body,
+              kvstore::WriteOptions options,
+              Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        encoded_object_name(std::move(encoded_object_name)),
+        body(std::move(body)),
+        options(std::move(options)),
+        promise(std::move(promise)) {}
 
-  inline bool is_cancelled() {
-    return cancelled_.load(std::memory_order_relaxed);
-  }
+  ~ComposeTask() { owner->admission_queue().Finish(this); }
 
   static void Start(void* task) {
-    auto* self = reinterpret_cast<ListTask*>(task);
-    self->owner_->read_rate_limiter().Finish(self);
-    self->owner_->admission_queue().Admit(self, &ListTask::Admit);
+    auto* self = reinterpret_cast<ComposeTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &ComposeTask::Admit);
   }
   static void Admit(void* task) {
-    auto* self = reinterpret_cast<ListTask*>(task);
-    execution::set_starting(self->receiver_, [self] {
-      self->cancelled_.store(true, std::memory_order_relaxed);
-    });
-    self->owner_->executor()(
-        [state = IntrusivePtr<ListTask>(self, internal::adopt_object_ref)] {
-          state->IssueRequest();
+    auto* self = reinterpret_cast<ComposeTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<ComposeTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
         });
   }
 
-  void Retry() { IssueRequest(); }
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string compose_url = tensorstore::StrCat(
+        owner->resource_root(), "/o/", encoded_object_name, "/compose");
+    bool has_query =
+        AddGenerationParam(&compose_url, false, "ifGenerationMatch",
+                           options.generation_conditions.if_equal);
+    AddUserProjectParam(&compose_url, has_query, owner->encoded_user_project());
 
-  void IssueRequest() {
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder("POST", compose_url);
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request =
+        request_builder.AddHeader("Content-Type: application/json")
+            .AddHeader(tensorstore::StrCat("Content-Length: ", body.size()))
+            .BuildRequest();
+    start_time_ = absl::Now();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "ComposeTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(
+        request,
+        IssueRequestOptions(body).SetHttpVersion(owner->http_version_));
+    future.ExecuteWhenReady([self = IntrusivePtr<ComposeTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "ComposeTask " << *response;
+
+    bool is_retryable = IsRetriable(response.status());
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      switch (response.value().status_code) {
+        case 304:
+          // Not modified implies that the generation did not match.
+          [[fallthrough]];
+        case 412:
+          // Failed precondition implies the generation did not match.
+          return absl::OkStatus();
+        default:
+          break;
+      }
+      return GcsHttpResponseToStatus(response.value(), is_retryable);
+    }();
+
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+    } else {
+      promise.SetResult(
+          ParseWriteResponse(response.value(), options, start_time_));
+    }
+  }
+};
+
+/// A RewriteTask copies an object within GCS, without transferring the data
+/// through the client.
+///
+/// Large objects, or copies between locations or storage classes, may require
+/// multiple rewrite requests; each response that is not `done` includes a
+/// `rewriteToken` with which the next request continues the copy.
+/// https://cloud.google.com/storage/docs/json_api/v1/objects/rewrite
+struct RewriteTask : public RateLimiterNode,
+                     public internal::AtomicReferenceCount<RewriteTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string source_resource_root;
+  std::string encoded_source_object_name;
+  std::string encoded_object_name;
+  Promise<void> promise;
+
+  std::string rewrite_token_;
+  int attempt_ = 0;
+
+  RewriteTask(IntrusivePtr<GcsKeyValueStore> owner,
+              std::string source_resource_root,
+              std::string encoded_source_object_name,
+              std::string encoded_object_name, Promise<void> promise)
+      : owner(std::move(owner)),
+        source_resource_root(std::move(source_resource_root)),
+        encoded_source_object_name(std::move(encoded_source_object_name)),
+        encoded_object_name(std::move(encoded_object_name)),
+        promise(std::move(promise)) {}
+
+  ~RewriteTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<RewriteTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &RewriteTask::Admit);
+  }
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<RewriteTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<RewriteTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string rewrite_url = tensorstore::StrCat(
+        source_resource_root, "/o/", encoded_source_object_name,
+        "/rewriteTo/b/", owner->spec_.bucket, "/o/", encoded_object_name);
+    bool has_query = false;
+    if (!rewrite_token_.empty()) {
+      absl::StrAppend(&rewrite_url, "?rewriteToken=",
+                      internal::PercentEncodeUriComponent(rewrite_token_));
+      has_query = true;
+    }
+    AddUserProjectParam(&rewrite_url, has_query, owner->encoded_user_project());
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder("POST", rewrite_url);
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request =
+        request_builder.AddHeader("Content-Length: 0").BuildRequest();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "RewriteTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(
+        request, IssueRequestOptions().SetHttpVersion(owner->http_version_));
+    future.ExecuteWhenReady([self = IntrusivePtr<RewriteTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "RewriteTask " << *response;
+
+    bool is_retryable = IsRetriable(response.status());
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      return GcsHttpResponseToStatus(response.value(), is_retryable);
+    }();
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+
+    auto payload = response->payload;
+    auto j = ::nlohmann::json::parse(payload.Flatten(), nullptr,
+                                     /*allow_exceptions=*/false);
+    if (!j.is_object() || !j.contains("done") || !j["done"].is_boolean()) {
+      promise.SetResult(absl::UnavailableError(tensorstore::StrCat(
+          "Failed to parse rewrite response: ", payload)));
+      return;
+    }
+    if (j["done"].get<bool>()) {
+      promise.SetResult(absl::OkStatus());
+      return;
+    }
+    if (!j.contains("rewriteToken") || !j["rewriteToken"].is_string()) {
+      promise.SetResult(absl::UnavailableError(tensorstore::StrCat(
+          "Missing rewriteToken in rewrite response: ", payload)));
+      return;
+    }
+    // Continue the copy; the admission slot of this task is retained.
+    rewrite_token_ = j["rewriteToken"].get<std::string>();
+    attempt_ = 0;
+    owner->executor()(
+        [self = IntrusivePtr<RewriteTask>(this)] { self->Retry(); });
+  }
+};
+
+/// A DeleteTask is a function object used to satisfy a
+/// GcsKeyValueStore::Delete request.
+struct DeleteTask : public RateLimiterNode,
+                    public internal::AtomicReferenceCount<DeleteTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string resource;
+  kvstore::WriteOptions options;
+  Promise<TimestampedStorageGeneration> promise;
+
+  int attempt_ = 0;
+  absl::Time start_time_;
+
+  DeleteTask(IntrusivePtr<GcsKeyValueStore> owner, std::string resource,
+             kvstore::WriteOptions options,
+             Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        resource(std::move(resource)),
+        options(std::move(options)),
+        promise(std::move(promise)) {}
+
+  ~DeleteTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<DeleteTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &DeleteTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<DeleteTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<DeleteTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  /// Removes an object from GCS.
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    std::string delete_url = resource;
+
+    // Add the ifGenerationNotMatch condition.
+    bool has_query = AddGenerationParam(&delete_url, false, "ifGenerationMatch",
+                                        options.generation_conditions.if_equal);
+
+    // Assume that if the user_project field is set, that we want to provide
+    // it on the uri for a requestor pays bucket.
+    AddUserProjectParam(&delete_url, has_query, owner->encoded_user_project());
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder("DELETE", delete_url);
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+
+    auto request = request_builder.BuildRequest();
+    start_time_ = absl::Now();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "DeleteTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(
+        request, IssueRequestOptions().SetHttpVersion(owner->http_version_));
+    future.ExecuteWhenReady([self = IntrusivePtr<DeleteTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "DeleteTask " << *response;
+
+    bool is_retryable = IsRetriable(response.status());
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      switch (response.value().status_code) {
+        case 412:
+          // Failed precondition implies the generation did not match.
+          [[fallthrough]];
+        case 404:
+          return absl::OkStatus();
+        default:
+          break;
+      }
+      return GcsHttpResponseToStatus(response.value(), is_retryable);
+    }();
+
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+
+    TimestampedStorageGeneration r;
+    r.time = start_time_;
+    switch (response.value().status_code) {
+      case 412:
+        // Failed precondition implies the generation did not match.
+        r.generation = StorageGeneration::Unknown();
+        break;
+      case 404:
+        // 404 Not Found means aborted when a StorageGeneration was specified.
+        if (!options.generation_conditions.MatchesNoValue()) {
+          r.generation = StorageGeneration::Unknown();
+          break;
+        }
+        [[fallthrough]];
+      default:
+        r.generation = StorageGeneration::NoValue();
+        break;
+    }
+    promise.SetResult(std::move(r));
+  }
+};
+
+/// A BatchDeleteTask is a function object used to satisfy a
+/// GcsKeyValueStore::BatchDelete request.
+///
+/// Up to `kMaxBatchSize` objects are deleted by a single request to the JSON
+/// API batch endpoint.  Objects which do not exist are ignored, and objects
+/// whose deletion fails with a retryable error are retried in a subsequent
+/// batch request.
+/// https://cloud.google.com/storage/docs/batch
+struct BatchDeleteTask
+    : public RateLimiterNode,
+      public internal::AtomicReferenceCount<BatchDeleteTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::vector<std::string> encoded_object_names;
+  Promise<void> promise;
+
+  int attempt_ = 0;
+
+  BatchDeleteTask(IntrusivePtr<GcsKeyValueStore> owner,
+                  std::vector<std::string> encoded_object_names,
+                  Promise<void> promise)
+      : owner(std::move(owner)),
+        encoded_object_names(std::move(encoded_object_names)),
+        promise(std::move(promise)) {}
+
+  ~BatchDeleteTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<BatchDeleteTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &BatchDeleteTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<BatchDeleteTask*>(task);
+    self->owner->executor()(
+        [state =
+             IntrusivePtr<BatchDeleteTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    // Each embedded request specifies a path relative to the batch endpoint
+    // host; the authorization of the outer request applies to all of them.
+    const std::string object_path_prefix =
+        tensorstore::StrCat("/storage/v1/b/", owner->spec_.bucket, "/o/");
+    std::vector<BatchPart> parts;
+    parts.reserve(encoded_object_names.size());
+    for (size_t i = 0; i < encoded_object_names.size(); ++i) {
+      std::string path =
+          tensorstore::StrCat(object_path_prefix, encoded_object_names[i]);
+      AddUserProjectParam(&path, false, owner->encoded_user_project());
+      parts.push_back(BatchPart{tensorstore::StrCat(i),
+                                tensorstore::StrCat("DELETE ", path,
+                                                    " HTTP/1.1\r\n")});
+    }
+    absl::BitGen gen;
+    const std::string boundary =
+        absl::StrFormat("batch_%016x", absl::Uniform<uint64_t>(gen));
+    absl::Cord body(FormatBatchBody(boundary, parts));
+
+    auto maybe_auth_header = owner->GetAuthHeader();
+    if (!maybe_auth_header.ok()) {
+      promise.SetResult(maybe_auth_header.status());
+      return;
+    }
+    HttpRequestBuilder request_builder(
+        "POST", tensorstore::StrCat(GetGcsBaseUrl(), "/batch/storage/v1"));
+    if (maybe_auth_header.value().has_value()) {
+      request_builder.AddHeader(*maybe_auth_header.value());
+    }
+    auto request =
+        request_builder
+            .AddHeader(tensorstore::StrCat(
+                "Content-Type: multipart/mixed; boundary=", boundary))
+            .AddHeader(tensorstore::StrCat("Content-Length: ", body.size()))
+            .BuildRequest();
+
+    ABSL_LOG_IF(INFO, gcs_http_logging)
+        << "BatchDeleteTask: " << request << " objects="
+        << encoded_object_names.size();
+
+    auto future = owner->transport_->IssueRequest(
+        request,
+        IssueRequestOptions(body).SetHttpVersion(owner->http_version_));
+    future.ExecuteWhenReady([self = IntrusivePtr<BatchDeleteTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  /// Returns the status of the delete of each object in the batch response.
+  std::vector<absl::Status> ParseBatchResponse(
+      const HttpResponse& httpresponse) {
+    std::vector<absl::Status> results(
+        encoded_object_names.size(),
+        absl::UnavailableError("Missing batch response part"));
+    std::optional<std::string> boundary;
+    if (auto it = httpresponse.headers.find("content-type");
+        it != httpresponse.headers.end()) {
+      boundary = GetBatchBoundary(it->second);
+    }
+    if (!boundary) return results;
+    absl::Cord payload = httpresponse.payload;
+    auto parts = ParseBatchBody(*boundary, payload.Flatten());
+    if (!parts.ok()) return results;
+
+    for (const auto& part : *parts) {
+      std::string_view content_id = part.content_id;
+      size_t index;
+      if (!absl::ConsumePrefix(&content_id, "response-") ||
+          !absl::SimpleAtoi(content_id, &index) || index >= results.size()) {
+        continue;
+      }
+      auto status_code = GetBatchPartStatusCode(part.http_message);
+      if (!status_code.ok()) continue;
+      if (*status_code == 404 || (*status_code >= 200 && *status_code < 300)) {
+        // The object was deleted, or did not exist.
+        results[index] = absl::OkStatus();
+        continue;
+      }
+      HttpResponse part_response{*status_code, absl::Cord()};
+      if (size_t pos = part.http_message.find("\r\n\r\n");
+          pos != std::string::npos) {
+        part_response.payload = absl::Cord(part.http_message.substr(pos + 4));
+      }
+      bool is_retryable = false;
+      results[index] = GcsHttpResponseToStatus(part_response, is_retryable);
+      if (is_retryable) {
+        // Distinguish retryable errors, which are described by an
+        // `absl::StatusCode::kUnavailable` status below.
+        results[index] = absl::UnavailableError(results[index].message());
+      }
+    }
+    return results;
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "BatchDeleteTask " << *response;
+
+    bool is_retryable = IsRetriable(response.status());
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) return response.status();
+      return GcsHttpResponseToStatus(response.value(), is_retryable);
+    }();
+
+    if (status.ok()) {
+      // Retain the objects which could not be deleted due to retryable
+      // errors.
+      auto results = ParseBatchResponse(response.value());
+      std::vector<std::string> remaining;
+      for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].ok()) continue;
+        if (!absl::IsUnavailable(results[i])) {
+          promise.SetResult(MaybeAnnotateStatus(
+              results[i],
+              tensorstore::StrCat("Deleting ",
+                                  QuoteString(encoded_object_names[i]))));
+          return;
+        }
+        if (status.ok()) status = results[i];
+        remaining.push_back(std::move(encoded_object_names[i]));
+      }
+      if (remaining.size() < encoded_object_names.size()) {
+        // Progress was made; restart the backoff sequence.
+        attempt_ = 0;
+      }
+      encoded_object_names = std::move(remaining);
+      is_retryable = true;
+    }
+
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+    promise.SetResult(MakeResult());
+  }
+};
+
+/// A CompositeUploadTask writes a large value as parts which are uploaded
+/// concurrently as temporary objects, and then concatenated into the
+/// destination object by a compose request.
+///
+/// The generation condition is checked by the compose request, so all parts
+/// are uploaded even if it turns out not to be satisfied.  The temporary
+/// objects are deleted before the write completes, but are visible to
+/// concurrent `List` operations while the upload is in progress.
+/// https://cloud.google.com/storage/docs/parallel-composite-uploads
+struct CompositeUploadTask
+    : public internal::AtomicReferenceCount<CompositeUploadTask> {
+  IntrusivePtr<GcsKeyValueStore> owner;
+  std::string encoded_object_name;
+  kvstore::WriteOptions options;
+  Promise<TimestampedStorageGeneration> promise;
+
+  // Names of the temporary part objects.
+  std::vector<std::string> part_names_;
+  // Generations of the part objects which were written.
+  std::vector<StorageGeneration> part_generations_;
+  // Pending writes, and then deletes, of the part objects.
+  std::vector<Future<TimestampedStorageGeneration>> part_futures_;
+  std::atomic<size_t> parts_remaining_{0};
+  // Result of the compose request.
+  Result<TimestampedStorageGeneration> result_;
+
+  CompositeUploadTask(IntrusivePtr<GcsKeyValueStore> owner,
+                      std::string encoded_object_name,
+                      kvstore::WriteOptions options,
+                      Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        encoded_object_name(std::move(encoded_object_name)),
+        options(std::move(options)),
+        promise(std::move(promise)),
+        result_(absl::CancelledError()) {}
+
+  /// Uploads the parts of `value`, named `part_prefix` followed by the part
+  /// index.
+  void Start(const absl::Cord& value, std::string_view part_prefix) {
+    // Increase the part size if necessary to stay within the source limit.
+    const size_t part_size =
+        std::max(*owner->spec_.composite_upload_part_size,
+                 (value.size() + kMaxComposeSources - 1) / kMaxComposeSources);
+    // The part names are unique, so the parts are written unconditionally,
+    // which allows a part to be retried after an ambiguous failure.
+    for (size_t offset = 0; offset < value.size(); offset += part_size) {
+      part_names_.push_back(
+          tensorstore::StrCat(part_prefix, part_names_.size()));
+      part_futures_.push_back(owner->WriteObject(
+          internal::PercentEncodeUriComponent(part_names_.back()),
+          value.Subcord(offset, std::min(part_size, value.size() - offset)),
+          {}));
+    }
+    part_generations_.resize(part_names_.size());
+    WhenPartsReady(&CompositeUploadTask::OnPartsWritten);
+  }
+
+  /// Invokes `callback` once all of `part_futures_` are ready.
+  void WhenPartsReady(void (CompositeUploadTask::*callback)()) {
+    parts_remaining_ = part_futures_.size();
+    // `callback` may replace `part_futures_`.
+    auto futures = part_futures_;
+    for (auto& future : futures) {
+      future.ExecuteWhenReady(
+          [self = IntrusivePtr<CompositeUploadTask>(this),
+           callback](ReadyFuture<TimestampedStorageGeneration>) {
+            if (self->parts_remaining_.fetch_sub(
+                    1, std::memory_order_acq_rel) == 1) {
+              ((*self).*callback)();
+            }
+          });
+    }
+  }
+
+  void OnPartsWritten() {
+    absl::Status status;
+    for (size_t i = 0; i < part_futures_.size(); ++i) {
+      auto& r = part_futures_[i].result();
+      if (!r.ok()) {
+        if (status.ok()) status = r.status();
+      } else {
+        part_generations_[i] = r->generation;
+      }
+    }
+    if (!status.ok() || !promise.result_needed()) {
+      DeleteParts(status.ok() ? absl::CancelledError() : std::move(status));
+      return;
+    }
+
+    ::nlohmann::json::array_t source_objects;
+    for (size_t i = 0; i < part_names_.size(); ++i) {
+      source_objects.push_back(
+          {{"name", part_names_[i]},
+           {"generation", tensorstore::StrCat(StorageGeneration::ToUint64(
+                              part_generations_[i]))}});
+    }
+    ::nlohmann::json body{
+        {"sourceObjects", std::move(source_objects)},
+        {"destination", {{"contentType", "application/octet-stream"}}}};
+
+    auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+    auto task = internal::MakeIntrusivePtr<ComposeTask>(
+        owner, encoded_object_name, absl::Cord(body.dump()), options,
+        std::move(op.promise));
+    intrusive_ptr_increment(task.get());  // adopted by ComposeTask::Start.
+    owner->write_rate_limiter().Admit(task.get(), &ComposeTask::Start);
+    op.future.ExecuteWhenReady(
+        [self = IntrusivePtr<CompositeUploadTask>(this)](
+            ReadyFuture<TimestampedStorageGeneration> future) {
+          self->DeleteParts(future.result());
+        });
+  }
+
+  /// Deletes the part objects which were written, and then completes the
+  /// write with `result`.
+  void DeleteParts(Result<TimestampedStorageGeneration> result) {
+    result_ = std::move(result);
+    std::vector<Future<TimestampedStorageGeneration>> deletes;
+    for (size_t i = 0; i < part_names_.size(); ++i) {
+      if (StorageGeneration::IsUnknown(part_generations_[i])) continue;
+      kvstore::WriteOptions delete_options;
+      delete_options.generation_conditions.if_equal = part_generations_[i];
+      deletes.push_back(owner->DeleteObject(
+          internal::PercentEncodeUriComponent(part_names_[i]),
+          std::move(delete_options)));
+    }
+    if (deletes.empty()) {
+      promise.SetResult(std::move(result_));
+      return;
+    }
+    part_futures_ = std::move(deletes);
+    WhenPartsReady(&CompositeUploadTask::OnPartsDeleted);
+  }
+
+  void OnPartsDeleted() {
+    for (auto& future : part_futures_) {
+      ABSL_LOG_IF(INFO, gcs_http_logging && !future.result().ok())
+          << "Failed to delete temporary object: " << future.result().status();
+    }
+    promise.SetResult(std::move(result_));
+  }
+};
+
+Future<TimestampedStorageGeneration> GcsKeyValueStore::WriteObject(
+    std::string encoded_object_name, absl::Cord value, WriteOptions options) {
+  auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  if (value.size() >= spec_.resumable_upload_threshold) {
+    auto state = internal::MakeIntrusivePtr<ResumableUploadTask>(
+        IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_name),
+        std::move(value), std::move(options), std::move(op.promise));
+
+    intrusive_ptr_increment(state.get());  // adopted by Start.
+    write_rate_limiter().Admit(state.get(), &ResumableUploadTask::Start);
+  } else {
+    auto state = internal::MakeIntrusivePtr<WriteTask>(
+        IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_name),
+        std::move(value), std::move(options), std::move(op.promise));
+
+    intrusive_ptr_increment(state.get());  // adopted by WriteTask::Start.
+    write_rate_limiter().Admit(state.get(), &WriteTask::Start);
+  }
+  return std::move(op.future);
+}
+
+Future<TimestampedStorageGeneration> GcsKeyValueStore::DeleteObject(
+    std::string encoded_object_name, WriteOptions options) {
+  auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  std::string resource = tensorstore::internal::JoinPath(
+      resource_root_, "/o/", encoded_object_name);
+
+  auto state = internal::MakeIntrusivePtr<DeleteTask>(
+      IntrusivePtr<GcsKeyValueStore>(this), std::move(resource),
+      std::move(options), std::move(op.promise));
+
+  intrusive_ptr_increment(state.get());  // adopted by DeleteTask::Start.
+  write_rate_limiter().Admit(state.get(), &DeleteTask::Start);
+  return std::move(op.future);
+}
+
+Future<const void> GcsKeyValueStore::BatchDelete(
+    std::vector<std::string> encoded_object_names) {
+  assert(!encoded_object_names.empty() &&
+         encoded_object_names.size() <= kMaxBatchSize);
+  auto op = PromiseFuturePair<void>::Make();
+  auto state = internal::MakeIntrusivePtr<BatchDeleteTask>(
+      IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_names),
+      std::move(op.promise));
+
+  intrusive_ptr_increment(state.get());  // adopted by BatchDeleteTask::Start.
+  write_rate_limiter().Admit(state.get(), &BatchDeleteTask::Start);
+  return std::move(op.future);
+}
+
+Future<TimestampedStorageGeneration> GcsKeyValueStore::Write(
+    Key key, std::optional<Value> value, WriteOptions options) {
+  gcs_write.Increment();
+  if (!IsValidObjectName(key)) {
+    return absl::InvalidArgumentError("Invalid GCS object name");
+  }
+  if (!IsValidStorageGeneration(options.generation_conditions.if_equal)) {
+    return absl::InvalidArgumentError("Malformed StorageGeneration");
+  }
+
+  std::string encoded_object_name = internal::PercentEncodeUriComponent(key);
+  if (!value) {
+    return DeleteObject(std::move(encoded_object_name), std::move(options));
+  }
+
+  if (spec_.composite_upload_part_size &&
+      value->size() > *spec_.composite_upload_part_size) {
+    // A random suffix avoids collisions between concurrent uploads.
+    absl::BitGen gen;
+    std::string part_prefix =
+        absl::StrFormat("%s.__tensorstore_part_%016x_", key,
+                        absl::Uniform<uint64_t>(gen));
+    if (IsValidObjectName(
+            tensorstore::StrCat(part_prefix, kMaxComposeSources))) {
+      auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+      internal::MakeIntrusivePtr<CompositeUploadTask>(
+          IntrusivePtr<GcsKeyValueStore>(this), std::move(encoded_object_name),
+          std::move(options), std::move(op.promise))
+          ->Start(*value, part_prefix);
+      return std::move(op.future);
+    }
+  }
+  return WriteObject(std::move(encoded_object_name), *std::move(value),
+                     std::move(options));
+}
+
+// List responds with a Json payload that includes these fields.
+struct GcsListResponsePayload {
+  std::string next_page_token;        // used to page through list results.
+  std::vector<ObjectMetadata> items;  // individual result metadata.
+  std::vector<std::string> prefixes;  // prefixes, when using a delimiter.
+};
+
+constexpr static auto GcsListResponsePayloadBinder = jb::Object(
+    jb::Member("nextPageToken",
+               jb::Projection(&GcsListResponsePayload::next_page_token,
+                              jb::DefaultInitializedValue())),
+    jb::Member("items", jb::Projection(&GcsListResponsePayload::items,
+                                       jb::DefaultInitializedValue())),
+    jb::Member("prefixes", jb::Projection(&GcsListResponsePayload::prefixes,
+                                          jb::DefaultInitializedValue())),
+    jb::DiscardExtraMembers);
+
+/// ListTask implements the ListImpl execution flow.
+struct ListTask : public RateLimiterNode,
+                  public internal::AtomicReferenceCount<ListTask> {
+  internal::IntrusivePtr<GcsKeyValueStore> owner_;
+  ListOptions options_;
+  ListReceiver receiver_;
+  std::string resource_;
+
+  std::string base_list_url_;
+  std::string next_page_token_;
+  int attempt_ = 0;
+  bool has_query_parameters_;
+  std::atomic<bool> cancelled_{false};
+
+  ListTask(internal::IntrusivePtr<GcsKeyValueStore>&& owner,
+           ListOptions&& options, ListReceiver&& receiver,
+           std::string&& resource)
+      : owner_(std::move(owner)),
+        options_(std::move(options)),
+        receiver_(std::move(receiver)),
+        resource_(std::move(resource)) {
+    // Construct the base LIST url. This will be modified to include the
+    // nextPageToken
+    base_list_url_ = resource_;
+    has_query_parameters_ = AddUserProjectParam(&base_list_url_, false,
+                                                owner_->encoded_user_project());
+    if (auto& inclusive_min = options_.range.inclusive_min;
+        !inclusive_min.empty()) {
+      absl::StrAppend(
+          &base_list_url_, (has_query_parameters_ ? "&" : "?"),
+          "startOffset=", internal::PercentEncodeUriComponent(inclusive_min));
+      has_query_parameters_ = true;
+    }
+    if (auto& exclusive_max = options_.range.exclusive_max;
+        !exclusive_max.empty()) {
+      absl::StrAppend(
+          &base_list_url_, (has_query_parameters_ ? "&" : "?"),
+          "endOffset=", internal::PercentEncodeUriComponent(exclusive_max));
+      has_query_parameters_ = true;
+    }
+  }
+
+  ~ListTask() { owner_->admission_queue().Finish(this); }
+
+  inline bool is_cancelled() {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<ListTask*>(task);
+    self->owner_->read_rate_limiter().Finish(self);
+    self->owner_->AdmitRequest(self, &ListTask::Admit);
+  }
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<ListTask*>(task);
+    execution::set_starting(self->receiver_, [self] {
+      self->cancelled_.store(true, std::memory_order_relaxed);
+    });
+    self->owner_->executor()(
+        [state = IntrusivePtr<ListTask>(self, internal::adopt_object_ref)] {
+          state->IssueRequest();
+        });
+  }
+
+  void Retry() { IssueRequest(); }
+
+  void IssueRequest() {
     if (is_cancelled()) {
       execution::set_done(receiver_);
       execution::set_stopping(receiver_);
@@ -1152,7 +2279,7 @@ struct ListTask : public RateLimiterNode,
     ABSL_LOG_IF(INFO, gcs_http_logging) << "List: " << request;
 
     auto future = owner_->transport_->IssueRequest(
-        request, IssueRequestOptions().SetHttpVersion(GetHttpVersion()));
+        request, IssueRequestOptions().SetHttpVersion(owner_->http_version_));
     future.ExecuteWhenReady(WithExecutor(
         owner_->executor(), [self = IntrusivePtr<ListTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
@@ -1208,11 +2335,13 @@ struct ListTask : public RateLimiterNode,
       if (options_.strip_prefix_length) {
         name = name.substr(options_.strip_prefix_length);
       }
-      execution::set_value(receiver_,
-                           ListEntry{
-                               std::string(name),
-                               ListEntry::checked_size(metadata.size),
-                           });
+      execution::set_value(
+          receiver_,
+          ListEntry{
+              std::string(name),
+              ListEntry::checked_size(metadata.size),
+              StorageGeneration::FromUint64(metadata.generation),
+          });
     }
 
     // Successful request, so clear the retry_attempt for the next request.
@@ -1228,6 +2357,139 @@ struct ListTask : public RateLimiterNode,
   }
 };
 
+/// ListPageTask issues a single list request with a `/` delimiter, which is
+/// used to partition the range listed by a concurrent `ListImpl`.
+struct ListPageTask : public RateLimiterNode,
+                      public internal::AtomicReferenceCount<ListPageTask> {
+  internal::IntrusivePtr<GcsKeyValueStore> owner_;
+  Promise<DelimitedListPage> promise_;
+  std::string list_url_;
+  int attempt_ = 0;
+
+  ListPageTask(internal::IntrusivePtr<GcsKeyValueStore> owner,
+               Promise<DelimitedListPage> promise, const KeyRange& range,
+               std::string_view resource)
+      : owner_(std::move(owner)), promise_(std::move(promise)) {
+    list_url_ = resource;
+    bool has_query_parameters = AddUserProjectParam(
+        &list_url_, false, owner_->encoded_user_project());
+    absl::StrAppend(&list_url_, (has_query_parameters ? "&" : "?"),
+                    "delimiter=%2F");
+    if (auto prefix = LongestPrefix(range); !prefix.empty()) {
+      absl::StrAppend(&list_url_,
+                      "&prefix=", internal::PercentEncodeUriComponent(prefix));
+    }
+    if (!range.inclusive_min.empty()) {
+      absl::StrAppend(
+          &list_url_, "&startOffset=",
+          internal::PercentEncodeUriComponent(range.inclusive_min));
+    }
+    if (!range.exclusive_max.empty()) {
+      absl::StrAppend(
+          &list_url_, "&endOffset=",
+          internal::PercentEncodeUriComponent(range.exclusive_max));
+    }
+  }
+
+  ~ListPageTask() { owner_->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<ListPageTask*>(task);
+    self->owner_->read_rate_limiter().Finish(self);
+    self->owner_->AdmitRequest(self, &ListPageTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<ListPageTask*>(task);
+    self->owner_->executor()(
+        [state = IntrusivePtr<ListPageTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise_.result_needed()) {
+      return;
+    }
+    auto auth_header = owner_->GetAuthHeader();
+    if (!auth_header.ok()) {
+      promise_.SetResult(std::move(auth_header).status());
+      return;
+    }
+    HttpRequestBuilder request_builder("GET", list_url_);
+    if (auth_header->has_value()) {
+      request_builder.AddHeader(auth_header->value());
+    }
+    auto request = request_builder.BuildRequest();
+    ABSL_LOG_IF(INFO, gcs_http_logging) << "ListPage: " << request;
+
+    auto future = owner_->transport_->IssueRequest(
+        request, IssueRequestOptions().SetHttpVersion(owner_->http_version_));
+    future.ExecuteWhenReady(WithExecutor(
+        owner_->executor(), [self = IntrusivePtr<ListPageTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+          self->OnResponse(response.result());
+        }));
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise_.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, gcs_http_logging.Level(1) && response.ok())
+        << "ListPage " << *response;
+
+    bool is_retryable = IsRetriable(response.status());
+    absl::Status status =
+        response.ok() ? GcsHttpResponseToStatus(response.value(), is_retryable)
+                      : response.status();
+    if (!status.ok() && is_retryable) {
+      status =
+          owner_->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise_.SetResult(status);
+      return;
+    }
+    promise_.SetResult(ParsePage(response->payload));
+  }
+
+  static Result<DelimitedListPage> ParsePage(absl::Cord payload) {
+    auto j = internal::ParseJson(payload.Flatten());
+    if (j.is_discarded()) {
+      return absl::InternalError(tensorstore::StrCat(
+          "Failed to parse response metadata: ", payload.Flatten()));
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto parsed_payload,
+        jb::FromJson<GcsListResponsePayload>(j, GcsListResponsePayloadBinder));
+    DelimitedListPage page;
+    page.entries.reserve(parsed_payload.items.size());
+    for (auto& metadata : parsed_payload.items) {
+      page.entries.push_back(
+          ListEntry{std::move(metadata.name),
+                    ListEntry::checked_size(metadata.size),
+                    StorageGeneration::FromUint64(metadata.generation)});
+    }
+    page.prefixes = std::move(parsed_payload.prefixes);
+    page.truncated = !parsed_payload.next_page_token.empty();
+    return page;
+  }
+};
+
+Future<DelimitedListPage> GcsKeyValueStore::ListPage(KeyRange range) {
+  auto op = PromiseFuturePair<DelimitedListPage>::Make();
+  auto state = internal::MakeIntrusivePtr<ListPageTask>(
+      IntrusivePtr<GcsKeyValueStore>(this), std::move(op.promise), range,
+      tensorstore::internal::JoinPath(resource_root_, "/o"));
+  intrusive_ptr_increment(state.get());  // adopted by ListPageTask::Admit.
+  read_rate_limiter().Admit(state.get(), &ListPageTask::Start);
+  return std::move(op.future);
+}
+
 void GcsKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
   gcs_list.Increment();
   if (options.range.empty()) {
@@ -1236,6 +2498,19 @@ void GcsKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
     execution::set_stopping(receiver);
     return;
   }
+  if (options.concurrency > 1) {
+    // Each partition is listed by a sequential `ListImpl`.
+    internal_http::ParallelList(
+        std::move(options), std::move(receiver),
+        [self = IntrusivePtr<GcsKeyValueStore>(this)](KeyRange range) {
+          return self->ListPage(std::move(range));
+        },
+        [self = IntrusivePtr<GcsKeyValueStore>(this)](ListOptions options,
+                                                      ListReceiver receiver) {
+          self->ListImpl(std::move(options), std::move(receiver));
+        });
+    return;
+  }
 
   auto state = internal::MakeIntrusivePtr<ListTask>(
       IntrusivePtr<GcsKeyValueStore>(this), std::move(options),
@@ -1247,10 +2522,14 @@ void GcsKeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
 }
 
 // Receiver used by `DeleteRange` for processing the results from `List`.
+//
+// Keys are deleted by batch requests of up to `kMaxBatchSize` objects, which
+// are issued as soon as enough keys have been listed.
 struct DeleteRangeListReceiver {
   IntrusivePtr<GcsKeyValueStore> owner_;
   Promise<void> promise_;
   FutureCallbackRegistration cancel_registration_;
+  std::vector<std::string> pending_;
 
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
@@ -1259,16 +2538,26 @@ struct DeleteRangeListReceiver {
   void set_value(ListEntry entry) {
     assert(!entry.key.empty());
     if (!entry.key.empty()) {
-      LinkError(promise_, owner_->Delete(std::move(entry.key)));
+      pending_.push_back(internal::PercentEncodeUriComponent(entry.key));
+      if (pending_.size() == kMaxBatchSize) Flush();
     }
   }
 
   void set_error(absl::Status error) {
+    Flush();
     SetDeferredResult(promise_, std::move(error));
     promise_ = Promise<void>();
   }
 
-  void set_done() { promise_ = Promise<void>(); }
+  void set_done() {
+    Flush();
+    promise_ = Promise<void>();
+  }
+
+  void Flush() {
+    if (pending_.empty()) return;
+    LinkError(promise_, owner_->BatchDelete(std::exchange(pending_, {})));
+  }
 
   void set_stopping() { cancel_registration_.Unregister(); }
 };
@@ -1289,6 +2578,46 @@ Future<const void> GcsKeyValueStore::DeleteRange(KeyRange range) {
   return std::move(op.future);
 }
 
+Future<const void> GcsKeyValueStore::RewriteObject(
+    std::string source_resource_root, std::string encoded_source_object_name,
+    std::string encoded_object_name) {
+  auto op = PromiseFuturePair<void>::Make();
+  auto state = internal::MakeIntrusivePtr<RewriteTask>(
+      internal::IntrusivePtr<GcsKeyValueStore>(this),
+      std::move(source_resource_root), std::move(encoded_source_object_name),
+      std::move(encoded_object_name), std::move(op.promise));
+  intrusive_ptr_increment(state.get());  // adopted by RewriteTask::Start.
+  write_rate_limiter().Admit(state.get(), &RewriteTask::Start);
+  return std::move(op.future);
+}
+
+Future<const void> GcsKeyValueStore::ExperimentalCopyRangeFrom(
+    const internal::OpenTransactionPtr& transaction, const KvStore& source,
+    Key target_prefix, kvstore::CopyRangeOptions options) {
+  if (typeid(*source.driver) != typeid(GcsKeyValueStore) || transaction ||
+      source.transaction != no_transaction) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  gcs_copy_range.Increment();
+  if (options.source_range.empty()) return absl::OkStatus();
+  auto& source_driver = static_cast<GcsKeyValueStore&>(*source.driver);
+  return internal_kvstore::CopyRangeByListing(
+      source, std::move(target_prefix), options,
+      [self = internal::IntrusivePtr<GcsKeyValueStore>(this),
+       source_resource_root = source_driver.resource_root()](
+          ListEntry entry, std::string target_key) -> Future<const void> {
+        if (!IsValidObjectName(target_key)) {
+          return absl::InvalidArgumentError(tensorstore::StrCat(
+              "Invalid GCS object name: ", QuoteString(target_key)));
+        }
+        return self->RewriteObject(
+            source_resource_root,
+            internal::PercentEncodeUriComponent(entry.key),
+            internal::PercentEncodeUriComponent(target_key));
+      });
+}
+
 Result<kvstore::Spec> ParseGcsUrl(std::string_view url) {
   auto parsed = internal::ParseGenericUri(url);
   assert(parsed.scheme == kUriScheme);
@@ -1314,6 +2643,15 @@ Result<kvstore::Spec> ParseGcsUrl(std::string_view url) {
       Context::Resource<GcsUserProjectResource>::DefaultSpec();
   driver_spec->data_.retries =
       Context::Resource<GcsRequestRetries>::DefaultSpec();
+  driver_spec->data_.request_hedging =
+      Context::Resource<GcsRequestHedging>::DefaultSpec();
+  driver_spec->data_.connection_prewarm =
+      Context::Resource<GcsConnectionPrewarm>::DefaultSpec();
+  driver_spec->data_.auto_batch =
+      Context::Resource<AutoBatchResource>::DefaultSpec();
+  driver_spec->data_.read_byte_budget =
+      Context::Resource<ReadByteBudgetResource>::DefaultSpec();
+  driver_spec->data_.tenant = Context::Resource<TenantResource>::DefaultSpec();
   driver_spec->data_.data_copy_concurrency =
       Context::Resource<DataCopyConcurrencyResource>::DefaultSpec();
 
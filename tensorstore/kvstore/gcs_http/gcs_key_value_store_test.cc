@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <atomic>
@@ -22,6 +23,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -30,6 +32,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
@@ -42,6 +45,8 @@
 #include "tensorstore/internal/http/http_transport.h"
 #include "tensorstore/internal/http/mock_http_transport.h"
 #include "tensorstore/internal/json_gtest.h"
+#include "tensorstore/internal/metrics/collect.h"
+#include "tensorstore/internal/metrics/registry.h"
 #include "tensorstore/internal/oauth2/google_auth_provider.h"
 #include "tensorstore/internal/oauth2/google_auth_test_utils.h"
 #include "tensorstore/internal/thread/schedule_at.h"
@@ -77,7 +82,9 @@ using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
 using ::tensorstore::internal::ScheduleAt;
 using ::tensorstore::internal_http::ApplyResponseToHandler;
 using ::tensorstore::internal_http::HttpRequest;
@@ -141,6 +148,10 @@ class MyMockTransport : public HttpTransport {
           if (result.ok()) return result;
 
           // Next, try each bucket until there is a success.
+          {
+            absl::MutexLock lock(&mutex_);
+            http_versions_.push_back(options.http_version);
+          }
           for (auto* bucket : buckets_) {
             result = bucket->IssueRequest(request, options.payload);
             if (result.ok()) break;
@@ -150,8 +161,18 @@ class MyMockTransport : public HttpTransport {
         response_handler);
   }
 
+  std::vector<IssueRequestOptions::HttpVersion> http_versions() {
+    absl::MutexLock lock(&mutex_);
+    return http_versions_;
+  }
+
   MetadataMockHelper metadata_mock_;
   std::vector<GCSMockStorageBucket*> buckets_;
+
+ private:
+  absl::Mutex mutex_;
+  // HTTP versions of the requests issued to `buckets_`.
+  std::vector<IssueRequestOptions::HttpVersion> http_versions_;
 };
 
 struct DefaultHttpTransportSetter {
@@ -288,6 +309,72 @@ TEST(GcsKeyValueStoreTest, Retry) {
   }
 }
 
+TEST(GcsKeyValueStoreTest, ResumableUpload) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", kDriver},
+                                 {"bucket", "my-bucket"},
+                                 {"resumable_upload_threshold", 1},
+                                 {"resumable_upload_chunk_size", 256 * 1024}},
+                                context)
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+
+  // A value which is sent in several chunks.
+  absl::Cord value(std::string(600 * 1024, 'x'));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "large", value).result());
+  EXPECT_THAT(kvstore::Read(store, "large").result(),
+              MatchesKvsReadResult(value, stamp.generation));
+
+  // The generation condition is still checked.
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = StorageGeneration::NoValue();
+  EXPECT_THAT(kvstore::Write(store, "large", value, options).result(),
+              MatchesTimestampedStorageGeneration(
+                  StorageGeneration::Unknown()));
+}
+
+TEST(GcsKeyValueStoreTest, CompositeUpload) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", kDriver},
+                                 {"bucket", "my-bucket"},
+                                 {"composite_upload_part_size", 2}},
+                                context)
+                      .result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+
+  absl::Cord value("0123456789");
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp, kvstore::Write(store, "a/b", value).result());
+  EXPECT_THAT(kvstore::Read(store, "a/b").result(),
+              MatchesKvsReadResult(value, stamp.generation));
+
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = StorageGeneration::NoValue();
+  EXPECT_THAT(kvstore::Write(store, "a/b", value, options).result(),
+              MatchesTimestampedStorageGeneration(
+                  StorageGeneration::Unknown()));
+
+  // The temporary part objects have been deleted.
+  EXPECT_THAT(ListFuture(store, {}).result(),
+              ::testing::Optional(
+                  ::testing::UnorderedElementsAre(MatchesListEntry("a/b"))));
+}
+
 TEST(GcsKeyValueStoreTest, List) {
   // Setup mocks for:
   // https://www.googleapis.com/kvstore/v1/b/my-bucket/o/test
@@ -407,6 +494,42 @@ TEST(GcsKeyValueStoreTest, List) {
                   MatchesListEntry("a/c/z/e"), MatchesListEntry("a/c/x"))));
 }
 
+TEST(GcsKeyValueStoreTest, ConcurrentList) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+
+  for (std::string key :
+       {"a/b", "a/c/x", "a/c/y", "a/c/z/e", "a/c/z/f", "a/d", "b/0", "c"}) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, key, absl::Cord("xyz")));
+  }
+
+  kvstore::ListOptions options;
+  options.concurrency = 4;
+  EXPECT_THAT(ListFuture(store, options).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesListEntry("a/b"), MatchesListEntry("a/c/x"),
+                  MatchesListEntry("a/c/y"), MatchesListEntry("a/c/z/e"),
+                  MatchesListEntry("a/c/z/f"), MatchesListEntry("a/d"),
+                  MatchesListEntry("b/0"), MatchesListEntry("c"))));
+
+  options.range = KeyRange::Prefix("a/c/");
+  options.strip_prefix_length = 4;
+  options.ordered = false;
+  EXPECT_THAT(ListFuture(store, options).result(),
+              ::testing::Optional(::testing::UnorderedElementsAre(
+                  MatchesListEntry("x"), MatchesListEntry("y"),
+                  MatchesListEntry("z/e"), MatchesListEntry("z/f"))));
+}
+
 TEST(GcsKeyValueStoreTest, SpecRoundtrip) {
   auto mock_transport = std::make_shared<MyMockTransport>();
   DefaultHttpTransportSetter mock_transport_setter{mock_transport};
@@ -419,6 +542,50 @@ TEST(GcsKeyValueStoreTest, SpecRoundtrip) {
   tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
 }
 
+TEST(GcsKeyValueStoreTest, SpecRoundtripHttpVersion) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
+  options.full_spec = {
+      {"driver", kDriver}, {"bucket", "my-bucket"}, {"http_version", "3"}};
+  tensorstore::internal::TestKeyValueStoreSpecRoundtrip(options);
+}
+
+TEST(GcsKeyValueStoreTest, HttpVersion) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open(
+          {{"driver", kDriver}, {"bucket", "my-bucket"}, {"http_version", "3"}},
+          context)
+          .result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("abc")));
+  TENSORSTORE_ASSERT_OK(kvstore::Read(store, "a").result());
+
+  auto http_versions = mock_transport->http_versions();
+  EXPECT_THAT(http_versions, ::testing::Not(::testing::IsEmpty()));
+  EXPECT_THAT(http_versions,
+              ::testing::Each(IssueRequestOptions::HttpVersion::kHttp3));
+
+  // Unsupported versions are rejected.
+  EXPECT_THAT(
+      kvstore::Open(
+          {{"driver", kDriver}, {"bucket", "my-bucket"}, {"http_version", "4"}},
+          context)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(GcsKeyValueStoreTest, InvalidSpec) {
   auto mock_transport = std::make_shared<MyMockTransport>();
   DefaultHttpTransportSetter mock_transport_setter{mock_transport};
@@ -441,6 +608,14 @@ TEST(GcsKeyValueStoreTest, InvalidSpec) {
   EXPECT_THAT(
       kvstore::Open({{"driver", kDriver}, {"bucket", 5}}, context).result(),
       MatchesStatus(absl::StatusCode::kInvalidArgument));
+
+  // Test with a resumable upload chunk size which is not a multiple of 256KiB.
+  EXPECT_THAT(kvstore::Open({{"driver", kDriver},
+                             {"bucket", "my-bucket"},
+                             {"resumable_upload_chunk_size", 1000}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
 TEST(GcsKeyValueStoreTest, RequestorPays) {
@@ -555,12 +730,112 @@ TEST(GcsKeyValueStoreTest, DeleteRangeFromBeginning) {
   tensorstore::internal::TestKeyValueStoreDeleteRangeFromBeginning(store);
 }
 
-class MyDeleteRangeCancellationMockTransport : public MyMockTransport {
+class MyRequestCountingMockTransport : public MyMockTransport {
  public:
   void IssueRequestWithHandler(const HttpRequest& request,
                                IssueRequestOptions options,
                                HttpResponseHandler* response_handler) final {
     if (request.method == "DELETE") {
+      ++delete_requests_;
+    } else if (absl::StrContains(request.url, "/batch/storage/v1")) {
+      ++batch_requests_;
+    } else if (absl::StrContains(request.url, "/rewriteTo/")) {
+      ++rewrite_requests_;
+    } else if (absl::StrContains(request.url, "alt=media")) {
+      ++media_requests_;
+    }
+    MyMockTransport::IssueRequestWithHandler(request, std::move(options),
+                                             response_handler);
+  }
+
+  std::atomic<size_t> delete_requests_{0};
+  std::atomic<size_t> batch_requests_{0};
+  std::atomic<size_t> rewrite_requests_{0};
+  std::atomic<size_t> media_requests_{0};
+};
+
+TEST(GcsKeyValueStoreTest, DeleteRangeBatched) {
+  auto mock_transport = std::make_shared<MyRequestCountingMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  bucket.SetErrorRate(0);
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+  for (int i = 0; i < 250; ++i) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(
+        store, absl::StrFormat("a/%03d", i), absl::Cord("x")));
+  }
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "b", absl::Cord("x")));
+
+  TENSORSTORE_ASSERT_OK(
+      kvstore::DeleteRange(store, KeyRange::Prefix("a/")).result());
+  EXPECT_EQ(0, mock_transport->delete_requests_.load());
+  EXPECT_EQ(3, mock_transport->batch_requests_.load());
+  EXPECT_THAT(ListFuture(store).result(),
+              ::testing::Optional(
+                  ::testing::ElementsAre(MatchesListEntry("b"))));
+}
+
+TEST(GcsKeyValueStoreTest, CopyRange) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  bucket.SetErrorRate(0.02);
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+  tensorstore::internal::TestKeyValueStoreCopyRange(store);
+}
+
+TEST(GcsKeyValueStoreTest, CopyRangeRewriteToken) {
+  auto mock_transport = std::make_shared<MyRequestCountingMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-bucket");
+  bucket.SetErrorRate(0);
+  bucket.SetMaxBytesRewrittenPerCall(4);
+  mock_transport->buckets_.push_back(&bucket);
+
+  auto context = DefaultTestContext();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-bucket"}}, context)
+          .result());
+  TENSORSTORE_ASSERT_OK(
+      kvstore::Write(store, "x/a", absl::Cord("0123456789")));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "x/b", absl::Cord("ab")));
+
+  TENSORSTORE_ASSERT_OK(kvstore::ExperimentalCopyRange(
+      store.WithPathSuffix("x/"), store.WithPathSuffix("y/")));
+
+  // "y/a" requires 3 rewrite requests, "y/b" requires 1, and no data is read
+  // by the client.
+  EXPECT_EQ(4, mock_transport->rewrite_requests_.load());
+  EXPECT_EQ(0, mock_transport->media_requests_.load());
+  EXPECT_THAT(kvstore::Read(store, "y/a").result(),
+              MatchesKvsReadResult(absl::Cord("0123456789")));
+  EXPECT_THAT(kvstore::Read(store, "y/b").result(),
+              MatchesKvsReadResult(absl::Cord("ab")));
+}
+
+class MyDeleteRangeCancellationMockTransport : public MyMockTransport {
+ public:
+  void IssueRequestWithHandler(const HttpRequest& request,
+                               IssueRequestOptions options,
+                               HttpResponseHandler* response_handler) final {
+    if (request.method == "DELETE" ||
+        absl::StrContains(request.url, "/batch/storage/v1")) {
       cancellation_notification_.WaitForNotification();
       ++total_delete_requests_;
     }
@@ -697,6 +972,51 @@ TEST(GcsKeyValueStoreTest, Concurrency) {
   EXPECT_EQ(3, mock_transport->reset());
 }
 
+TEST(GcsKeyValueStoreTest, AdaptiveConcurrency) {
+  auto mock_transport = std::make_shared<MyMockTransport>();
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+
+  GCSMockStorageBucket bucket("my-adaptive-bucket");
+  mock_transport->buckets_.push_back(&bucket);
+
+  Context context{Context::Spec::FromJson(
+                      {{"gcs_request_retries",
+                        {{"max_retries", 4},
+                         {"initial_delay", "1ms"},
+                         {"max_delay", "5ms"}}},
+                       {"gcs_request_concurrency",
+                        {{"limit", 8}, {"adaptive", true}}}})
+                      .value()};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", kDriver}, {"bucket", "my-adaptive-bucket"}},
+                    context)
+          .result());
+
+  const auto get_limit = [] {
+    auto metric = tensorstore::internal_metrics::GetMetricRegistry().Collect(
+        "/tensorstore/kvstore/gcs/adaptive_request_concurrency");
+    if (metric) {
+      for (const auto& value : metric->values) {
+        if (value.fields == std::vector<std::string>{"my-adaptive-bucket"}) {
+          return std::get<int64_t>(value.value);
+        }
+      }
+    }
+    return int64_t{-1};
+  };
+  EXPECT_EQ(8, get_limit());
+
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "abc", absl::Cord("x")));
+
+  // A throttled (429) response halves the limit, and the read succeeds once
+  // retried.
+  bucket.TriggerErrors(1);
+  EXPECT_THAT(kvstore::Read(store, "abc").result(),
+              MatchesKvsReadResult(absl::Cord("x")));
+  EXPECT_EQ(4, get_limit());
+}
+
 class MyRateLimitedMockTransport : public MyMockTransport {
  public:
   std::tuple<absl::Time, absl::Time, size_t> reset() {
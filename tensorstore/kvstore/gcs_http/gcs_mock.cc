@@ -34,6 +34,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
 #include "re2/re2.h"
@@ -41,6 +42,7 @@
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/gcs_http/batch_request.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -49,6 +51,11 @@ namespace {
 
 using ::tensorstore::internal_http::HttpRequest;
 using ::tensorstore::internal_http::HttpResponse;
+using ::tensorstore::internal_kvstore_gcs_http::BatchPart;
+using ::tensorstore::internal_kvstore_gcs_http::FormatBatchBody;
+using ::tensorstore::internal_kvstore_gcs_http::GetBatchBoundary;
+using ::tensorstore::internal_kvstore_gcs_http::kMaxBatchSize;
+using ::tensorstore::internal_kvstore_gcs_http::ParseBatchBody;
 
 const char kInvalidLongBody[] =
     R"({"error": {"code": 400,  "message": "Invalid long value: '$0'." }})";
@@ -86,6 +93,35 @@ std::optional<internal_http::HttpResponse> ParseQueryParameters(
   return std::nullopt;
 }
 
+// Checks the preconditions of a request which writes an object, returning an
+// error HttpResponse if they are not satisfied.
+std::optional<internal_http::HttpResponse> CheckWritePreconditions(
+    const QueryParameters& query_params,
+    const GCSMockStorageBucket::Object* existing) {
+  if (query_params.ifGenerationMatch.has_value()) {
+    const int64_t v = query_params.ifGenerationMatch.value();
+    if (v == 0) {
+      if (existing) {
+        // Live version => failure
+        return HttpResponse{412, absl::Cord()};
+      }
+      // No live versions => success;
+    } else if (!existing || v != existing->generation) {
+      // generation does not match.
+      return HttpResponse{412, absl::Cord()};
+    }
+  }
+
+  if (query_params.ifGenerationNotMatch.has_value()) {
+    const int64_t v = query_params.ifGenerationNotMatch.value();
+    if (existing && v == existing->generation) {
+      // generation matches.
+      return HttpResponse{412, absl::Cord()};
+    }
+  }
+  return std::nullopt;
+}
+
 }  // namespace
 
 GCSMockStorageBucket::~GCSMockStorageBucket() = default;
@@ -125,6 +161,12 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
     return {};
   }
   std::string_view path = parsed.authority_and_path;
+  if (path == "storage.googleapis.com/batch/storage/v1" &&
+      request.method == "POST") {
+    // Batch requests are handled before acquiring the lock, since each
+    // embedded request is matched individually.
+    return HandleBatchRequest(request, std::move(payload));
+  }
   if (absl::StartsWith(path, bucket_prefix_)) {
     // Bucket path.
     path.remove_prefix(bucket_prefix_.size());
@@ -186,7 +228,19 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
           absl::Cord(
               R"({ "error": { "code": 400, "message": "Uploads must be sent to the upload URL." } })")};
     }
-    return HandleInsertRequest(path, params, payload);
+    return HandleInsertRequest(request, path, params, payload);
+  } else if (path == "/o" && request.method == "PUT" && is_upload) {
+    // PUT request for a resumable upload session.
+    return HandleResumableUploadRequest(request, params, payload);
+  } else if (absl::StartsWith(path, "/o/") &&
+             absl::EndsWith(path, "/compose") && request.method == "POST") {
+    // POST request to compose an object.
+    return HandleComposeRequest(path, params, payload);
+  } else if (absl::StartsWith(path, "/o/") &&
+             absl::StrContains(path, "/rewriteTo/b/") &&
+             request.method == "POST") {
+    // POST request to rewrite an object.
+    return HandleRewriteRequest(path, params);
   } else if (absl::StartsWith(path, "/o/") && request.method == "GET") {
     // GET request on an object.
     return HandleGetRequest(request, path, params);
@@ -197,20 +251,74 @@ GCSMockStorageBucket::Match(const HttpRequest& request, absl::Cord payload) {
 
   // NOT HANDLED
   // update (PUT request)
-  // .../compose
   // .../watch
-  // .../rewrite/...
   // patch (PATCH request)
   // .../copyTo/...
 
   return HttpResponse{404, absl::Cord()};
 }
 
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleBatchRequest(const HttpRequest& request,
+                                         absl::Cord payload) {
+  // https://cloud.google.com/storage/docs/batch
+  std::optional<std::string> boundary;
+  for (std::string_view header : request.headers) {
+    if (absl::ConsumePrefix(&header, "Content-Type:")) {
+      boundary = GetBatchBoundary(header);
+    }
+  }
+  if (!boundary) {
+    return HttpResponse{400, absl::Cord("Missing multipart boundary")};
+  }
+  auto parts = ParseBatchBody(*boundary, payload.Flatten());
+  if (!parts.ok() || parts->empty() || parts->size() > kMaxBatchSize) {
+    return HttpResponse{400, absl::Cord("Invalid batch request")};
+  }
+
+  std::vector<BatchPart> response_parts;
+  for (const auto& part : *parts) {
+    // Request line: method SP path SP HTTP-version
+    std::string_view request_line = part.http_message;
+    request_line = request_line.substr(0, request_line.find('\n'));
+    absl::ConsumeSuffix(&request_line, "\r");
+    std::vector<std::string_view> fields = absl::StrSplit(request_line, ' ');
+    if (fields.size() != 3) {
+      return HttpResponse{400, absl::Cord("Invalid batch request part")};
+    }
+    HttpRequest part_request;
+    part_request.method = std::string(fields[0]);
+    part_request.url =
+        tensorstore::StrCat("https://storage.googleapis.com", fields[1]);
+    auto result = Match(part_request, absl::Cord());
+    if (std::holds_alternative<std::monostate>(result)) {
+      // The batch is for a different bucket.
+      return {};
+    }
+    if (std::holds_alternative<absl::Status>(result)) {
+      return std::get<absl::Status>(std::move(result));
+    }
+    const auto& part_response = std::get<HttpResponse>(result);
+    response_parts.push_back(
+        BatchPart{tensorstore::StrCat("response-", part.content_id),
+                  tensorstore::StrCat("HTTP/1.1 ", part_response.status_code,
+                                      "\r\n\r\n",
+                                      std::string(part_response.payload))});
+  }
+
+  constexpr char kResponseBoundary[] = "batch_response";
+  HttpResponse response{
+      200, absl::Cord(FormatBatchBody(kResponseBoundary, response_parts))};
+  response.headers.emplace(
+      "content-type",
+      tensorstore::StrCat("multipart/mixed; boundary=", kResponseBoundary));
+  return response;
+}
+
 std::variant<std::monostate, HttpResponse, absl::Status>
 GCSMockStorageBucket::HandleListRequest(std::string_view path,
                                         const ParamMap& params) {
   // https://cloud.google.com/storage/docs/json_api/v1/objects/list
-  // TODO: handle Delimiter
   int64_t maxResults = std::numeric_limits<int64_t>::max();
   for (auto it = params.find("maxResults"); it != params.end();) {
     if (!absl::SimpleAtoi(it->second, &maxResults) || maxResults < 1) {
@@ -244,14 +352,40 @@ GCSMockStorageBucket::HandleListRequest(std::string_view path,
     object_end_it = data_.end();
   }
 
+  std::string_view prefix;
+  if (auto it = params.find("prefix"); it != params.end()) {
+    prefix = it->second;
+  }
+  std::string_view delimiter;
+  if (auto it = params.find("delimiter"); it != params.end()) {
+    delimiter = it->second;
+  }
+
   // NOTE: Use ::nlohmann::json to construct json objects & dump the response.
   ::nlohmann::json result{{"kind", "storage#objects"}};
   ::nlohmann::json::array_t items;
+  std::vector<std::string> prefixes;
   for (; object_it != object_end_it; ++object_it) {
+    std::string_view name = object_it->first;
+    if (!absl::StartsWith(name, prefix)) continue;
+    if (size_t pos = delimiter.empty()
+                         ? std::string_view::npos
+                         : name.find(delimiter, prefix.size());
+        pos != std::string_view::npos) {
+      // Objects with the same prefix up to the delimiter are rolled up.
+      std::string_view common_prefix = name.substr(0, pos + delimiter.size());
+      if (prefixes.empty() || prefixes.back() != common_prefix) {
+        prefixes.emplace_back(common_prefix);
+      }
+      continue;
+    }
     items.push_back(ObjectMetadata(object_it->second));
     if (maxResults-- <= 0) break;
   }
   result["items"] = std::move(items);
+  if (!delimiter.empty()) {
+    result["prefixes"] = std::move(prefixes);
+  }
   if (object_it != object_end_it) {
     result["nextPageToken"] = object_it->first;
   }
@@ -259,7 +393,8 @@ GCSMockStorageBucket::HandleListRequest(std::string_view path,
 }
 
 std::variant<std::monostate, HttpResponse, absl::Status>
-GCSMockStorageBucket::HandleInsertRequest(std::string_view path,
+GCSMockStorageBucket::HandleInsertRequest(const HttpRequest& request,
+                                          std::string_view path,
                                           const ParamMap& params,
                                           absl::Cord payload) {
   // https://cloud.google.com/storage/docs/json_api/v1/objects/insert
@@ -274,48 +409,251 @@ GCSMockStorageBucket::HandleInsertRequest(std::string_view path,
   do {
     /// TODO: What does GCS return if these values are bad?
     auto uploadType = params.find("uploadType");
-    if (uploadType == params.end() || uploadType->second != "media") break;
+    if (uploadType == params.end()) break;
+    if (uploadType->second != "media" && uploadType->second != "resumable") {
+      break;
+    }
 
     auto name_it = params.find("name");
     if (name_it == params.end() || name_it->second.empty()) break;
     std::string name(name_it->second.data(), name_it->second.length());
 
     auto it = data_.find(name);
-    if (parsed_parameters.ifGenerationMatch.has_value()) {
-      const int64_t v = parsed_parameters.ifGenerationMatch.value();
-      if (v == 0) {
-        if (it != data_.end()) {
-          // Live version => failure
-          return HttpResponse{412, absl::Cord()};
-        }
-        // No live versions => success;
-      } else if (it == data_.end() || v != it->second.generation) {
-        // generation does not match.
-        return HttpResponse{412, absl::Cord()};
-      }
+    if (auto response = CheckWritePreconditions(
+            parsed_parameters, it == data_.end() ? nullptr : &it->second)) {
+      return *std::move(response);
     }
 
-    if (parsed_parameters.ifGenerationNotMatch.has_value()) {
-      const int64_t v = parsed_parameters.ifGenerationNotMatch.value();
-      if (it != data_.end() && v == it->second.generation) {
-        // generation matches.
-        return HttpResponse{412, absl::Cord()};
+    if (uploadType->second == "resumable") {
+      // https://cloud.google.com/storage/docs/performing-resumable-uploads
+      UploadSession session;
+      session.name = std::move(name);
+      session.if_generation_match = parsed_parameters.ifGenerationMatch;
+      session.if_generation_not_match = parsed_parameters.ifGenerationNotMatch;
+      session.size = -1;
+      for (const auto& header : request.headers) {
+        static LazyRE2 kUploadLength = {
+            R"((?i)x-upload-content-length: (\d+))"};
+        RE2::FullMatch(header, *kUploadLength, &session.size);
       }
+      std::string upload_id = tensorstore::StrCat(next_upload_id_++);
+      upload_sessions_.emplace(upload_id, std::move(session));
+
+      HttpResponse response{200, absl::Cord()};
+      response.headers.insert(
+          {"location",
+           tensorstore::StrCat("https://", upload_prefix_,
+                               "/o?uploadType=resumable&upload_id=",
+                               upload_id)});
+      return response;
+    }
+
+    return ObjectMetadataResponse(StoreObject(std::move(name), payload));
+  } while (false);
+
+  return HttpResponse{404, absl::Cord()};
+}
+
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleResumableUploadRequest(const HttpRequest& request,
+                                                   const ParamMap& params,
+                                                   absl::Cord payload) {
+  // https://cloud.google.com/storage/docs/performing-resumable-uploads
+  auto id_it = params.find("upload_id");
+  if (id_it == params.end()) return HttpResponse{404, absl::Cord()};
+  auto session_it = upload_sessions_.find(id_it->second);
+  if (session_it == upload_sessions_.end()) {
+    return HttpResponse{404, absl::Cord()};
+  }
+  auto& session = session_it->second;
+
+  // Either "bytes first-last/size" to upload data, or "bytes */size" to query
+  // the upload status.
+  static LazyRE2 kContentRange = {
+      R"((?i)content-range: bytes (?:(\d+)-(\d+)|\*)/(\d+|\*))"};
+  std::optional<int64_t> first, last;
+  std::string size_str;
+  bool has_content_range = false;
+  for (const auto& header : request.headers) {
+    if (RE2::FullMatch(header, *kContentRange, &first, &last, &size_str)) {
+      has_content_range = true;
+      break;
+    }
+  }
+  if (!has_content_range) return HttpResponse{400, absl::Cord()};
+  if (size_str != "*") {
+    int64_t size;
+    if (!absl::SimpleAtoi(size_str, &size) ||
+        (session.size != -1 && session.size != size)) {
+      return HttpResponse{400, absl::Cord()};
     }
+    session.size = size;
+  }
 
-    auto& obj = data_[name];
-    if (obj.name.empty()) {
-      obj.name = std::move(name);
+  if (first) {
+    const int64_t persisted = session.data.size();
+    if (*first > persisted || *last < *first ||
+        *last - *first + 1 != static_cast<int64_t>(payload.size())) {
+      return HttpResponse{400, absl::Cord()};
     }
-    obj.generation = ++next_generation_;
-    obj.data = payload;
+    // Bytes which have already been persisted are ignored.
+    const int64_t skip = persisted - *first;
+    if (skip < static_cast<int64_t>(payload.size())) {
+      session.data.Append(payload.Subcord(skip, payload.size() - skip));
+    }
+  }
 
-    ABSL_LOG(INFO) << "Uploaded: " << obj.name << " " << obj.generation;
+  if (session.size == -1 ||
+      static_cast<int64_t>(session.data.size()) < session.size) {
+    HttpResponse response{308, absl::Cord()};
+    if (!session.data.empty()) {
+      response.headers.insert(
+          {"range", tensorstore::StrCat("bytes=0-", session.data.size() - 1)});
+    }
+    return response;
+  }
 
-    return ObjectMetadataResponse(obj);
-  } while (false);
+  // The upload is complete.
+  QueryParameters parsed_parameters;
+  parsed_parameters.ifGenerationMatch = session.if_generation_match;
+  parsed_parameters.ifGenerationNotMatch = session.if_generation_not_match;
+  std::string name = std::move(session.name);
+  absl::Cord data = std::move(session.data);
+  upload_sessions_.erase(session_it);
+
+  auto it = data_.find(name);
+  if (auto response = CheckWritePreconditions(
+          parsed_parameters, it == data_.end() ? nullptr : &it->second)) {
+    return *std::move(response);
+  }
+  return ObjectMetadataResponse(StoreObject(std::move(name), std::move(data)));
+}
 
-  return HttpResponse{404, absl::Cord()};
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleComposeRequest(std::string_view path,
+                                           const ParamMap& params,
+                                           absl::Cord payload) {
+  // https://cloud.google.com/storage/docs/json_api/v1/objects/compose
+  path.remove_prefix(3);  // remove /o/
+  path.remove_suffix(8);  // remove /compose
+  std::string name = internal::PercentDecode(path);
+
+  QueryParameters parsed_parameters;
+  {
+    auto parse_result = ParseQueryParameters(params, &parsed_parameters);
+    if (parse_result.has_value()) {
+      return std::move(parse_result.value());
+    }
+  }
+
+  auto body = ::nlohmann::json::parse(std::string(payload), nullptr,
+                                      /*allow_exceptions=*/false);
+  if (!body.is_object() || !body.contains("sourceObjects") ||
+      !body["sourceObjects"].is_array() || body["sourceObjects"].empty() ||
+      body["sourceObjects"].size() > 32) {
+    return HttpResponse{400, absl::Cord()};
+  }
+
+  absl::Cord data;
+  for (const auto& source : body["sourceObjects"]) {
+    if (!source.is_object() || !source.contains("name") ||
+        !source["name"].is_string()) {
+      return HttpResponse{400, absl::Cord()};
+    }
+    auto it = data_.find(source["name"].get<std::string>());
+    if (it == data_.end()) return HttpResponse{404, absl::Cord()};
+    if (source.contains("generation") &&
+        source["generation"] != tensorstore::StrCat(it->second.generation)) {
+      return HttpResponse{404, absl::Cord()};
+    }
+    data.Append(it->second.data);
+  }
+
+  auto it = data_.find(name);
+  if (auto response = CheckWritePreconditions(
+          parsed_parameters, it == data_.end() ? nullptr : &it->second)) {
+    return *std::move(response);
+  }
+  return ObjectMetadataResponse(StoreObject(std::move(name), std::move(data)));
+}
+
+std::variant<std::monostate, HttpResponse, absl::Status>
+GCSMockStorageBucket::HandleRewriteRequest(std::string_view path,
+                                           const ParamMap& params) {
+  // https://cloud.google.com/storage/docs/json_api/v1/objects/rewrite
+  path.remove_prefix(3);  // remove /o/
+  std::pair<std::string_view, std::string_view> split =
+      absl::StrSplit(path, absl::MaxSplits("/rewriteTo/b/", 1));
+  std::string source_name = internal::PercentDecode(split.first);
+  std::string_view destination = split.second;
+  if (!absl::ConsumePrefix(&destination, bucket_) ||
+      !absl::ConsumePrefix(&destination, "/o/")) {
+    // Only rewrites within the bucket are supported.
+    return HttpResponse{404, absl::Cord()};
+  }
+  std::string name = internal::PercentDecode(destination);
+
+  QueryParameters parsed_parameters;
+  {
+    auto parse_result = ParseQueryParameters(params, &parsed_parameters);
+    if (parse_result.has_value()) {
+      return std::move(parse_result.value());
+    }
+  }
+
+  auto source_it = data_.find(source_name);
+  if (source_it == data_.end()) return HttpResponse{404, absl::Cord()};
+  const int64_t size = source_it->second.data.size();
+
+  // The rewrite token of the mock is the number of bytes already rewritten.
+  int64_t rewritten = 0;
+  if (auto it = params.find("rewriteToken"); it != params.end()) {
+    if (!absl::SimpleAtoi(it->second, &rewritten) || rewritten < 0 ||
+        rewritten > size) {
+      return HttpResponse{400, absl::Cord("Invalid rewriteToken")};
+    }
+  }
+  if (max_bytes_rewritten_per_call_ > 0 &&
+      size - rewritten > max_bytes_rewritten_per_call_) {
+    rewritten += max_bytes_rewritten_per_call_;
+    ::nlohmann::json response{
+        {"kind", "storage#rewriteResponse"},
+        {"totalBytesRewritten", tensorstore::StrCat(rewritten)},
+        {"objectSize", tensorstore::StrCat(size)},
+        {"done", false},
+        {"rewriteToken", tensorstore::StrCat(rewritten)},
+    };
+    return HttpResponse{200, absl::Cord(response.dump())};
+  }
+
+  auto it = data_.find(name);
+  if (auto response = CheckWritePreconditions(
+          parsed_parameters, it == data_.end() ? nullptr : &it->second)) {
+    return *std::move(response);
+  }
+  absl::Cord data = source_it->second.data;
+  auto& object = StoreObject(std::move(name), std::move(data));
+  ::nlohmann::json response{
+      {"kind", "storage#rewriteResponse"},
+      {"totalBytesRewritten", tensorstore::StrCat(size)},
+      {"objectSize", tensorstore::StrCat(size)},
+      {"done", true},
+      {"resource", ObjectMetadata(object)},
+  };
+  return HttpResponse{200, absl::Cord(response.dump())};
+}
+
+GCSMockStorageBucket::Object& GCSMockStorageBucket::StoreObject(
+    std::string name, absl::Cord data) {
+  auto& obj = data_[name];
+  if (obj.name.empty()) {
+    obj.name = std::move(name);
+  }
+  obj.generation = ++next_generation_;
+  obj.data = std::move(data);
+
+  ABSL_LOG(INFO) << "Uploaded: " << obj.name << " " << obj.generation;
+  return obj;
 }
 
 std::optional<OptionalByteRangeRequest> ParseRangeHeader(
@@ -72,15 +72,35 @@ class GCSMockStorageBucket {
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status> Match(
       const internal_http::HttpRequest& request, absl::Cord payload);
 
+  // Perform the requests embedded in a batch request.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleBatchRequest(const internal_http::HttpRequest& request,
+                     absl::Cord payload);
+
   // List objects in the bucket.
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
   HandleListRequest(std::string_view path, const ParamMap& params);
 
   // Insert an object into the bucket.
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
-  HandleInsertRequest(std::string_view path, const ParamMap& params,
+  HandleInsertRequest(const internal_http::HttpRequest& request,
+                      std::string_view path, const ParamMap& params,
                       absl::Cord payload);
 
+  // Upload data to, or query the status of, a resumable upload session.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleResumableUploadRequest(const internal_http::HttpRequest& request,
+                               const ParamMap& params, absl::Cord payload);
+
+  // Compose objects in the bucket into a new object.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleComposeRequest(std::string_view path, const ParamMap& params,
+                       absl::Cord payload);
+
+  // Rewrite an object in the bucket to a new object in the same bucket.
+  std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
+  HandleRewriteRequest(std::string_view path, const ParamMap& params);
+
   // Get an object, which might be the data or the metadata.
   std::variant<std::monostate, internal_http::HttpResponse, absl::Status>
   HandleGetRequest(const internal_http::HttpRequest& request,
@@ -107,6 +127,14 @@ class GCSMockStorageBucket {
     p_error_ = 0;
   }
 
+  // Limits the number of bytes copied by each rewrite request, such that
+  // larger objects require multiple requests.  `0` indicates no limit.
+  void SetMaxBytesRewrittenPerCall(int64_t max_bytes) {
+    assert(max_bytes >= 0);
+    absl::MutexLock l(&mutex_);
+    max_bytes_rewritten_per_call_ = max_bytes;
+  }
+
   // Sets the error rate on the mock interface.
   void SetErrorRate(double p_error) {
     assert(p_error >= 0 && p_error <= 1);
@@ -124,10 +152,25 @@ class GCSMockStorageBucket {
 
   int64_t next_error_count_ ABSL_GUARDED_BY(mutex_) = 0;
   double p_error_ ABSL_GUARDED_BY(mutex_) = 0.05;
+  int64_t max_bytes_rewritten_per_call_ ABSL_GUARDED_BY(mutex_) = 0;
   std::minstd_rand urbg_ ABSL_GUARDED_BY(mutex_);
 
+  // Stores `data` as a new generation of the object `name`.
+  Object& StoreObject(std::string name, absl::Cord data);
+
   using Map = std::map<std::string, Object, std::less<>>;
   Map data_;
+
+  // An in-progress resumable upload.
+  struct UploadSession {
+    std::string name;
+    std::optional<int64_t> if_generation_match;
+    std::optional<int64_t> if_generation_not_match;
+    int64_t size;  // -1 if unknown.
+    absl::Cord data;
+  };
+  std::map<std::string, UploadSession, std::less<>> upload_sessions_;
+  int64_t next_upload_id_ = 1;
 };
 
 }  // namespace tensorstore
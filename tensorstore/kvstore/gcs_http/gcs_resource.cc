@@ -15,10 +15,14 @@
 #include "tensorstore/kvstore/gcs_http/gcs_resource.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "absl/base/attributes.h"
 #include "absl/base/call_once.h"
@@ -29,7 +33,10 @@
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/env.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/gauge.h"
+#include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/rate_limiter/scaling_rate_limiter.h"
 #include "tensorstore/util/result.h"
@@ -44,11 +51,14 @@
 #include "tensorstore/internal/json_binding/std_optional.h"
 
 using ::tensorstore::internal::AdmissionQueue;
+using ::tensorstore::internal::AimdAdmissionQueue;
+using ::tensorstore::internal::AimdAdmissionQueueMap;
 using ::tensorstore::internal::AnyContextResourceJsonBinder;
 using ::tensorstore::internal::ConstantRateLimiter;
 using ::tensorstore::internal::ContextResourceCreationContext;
 using ::tensorstore::internal::DoublingRateLimiter;
 using ::tensorstore::internal::NoRateLimiter;
+using ::tensorstore::internal_metrics::MetricMetadata;
 
 namespace tensorstore {
 namespace internal_kvstore_gcs_http {
@@ -60,10 +70,22 @@ const internal::ContextResourceRegistration<GcsConcurrencyResource>
 const internal::ContextResourceRegistration<GcsRateLimiterResource>
     gcs_rate_limiter_registration;
 
+const internal::ContextResourceRegistration<GcsConnectionPrewarm>
+    gcs_connection_prewarm_registration;
+
 ABSL_CONST_INIT internal_log::VerboseFlag gcs_logging("gcs");
 
 constexpr size_t kDefaultRequestConcurrency = 32;
 
+// Upper bound on the limit of an adaptive admission queue.
+constexpr size_t kMaxAdaptiveRequestConcurrency = 1024;
+
+auto& gcs_adaptive_request_concurrency =
+    internal_metrics::Gauge<int64_t, std::string>::New(
+        "/tensorstore/kvstore/gcs/adaptive_request_concurrency", "bucket",
+        MetricMetadata("Current limit on concurrent GCS requests to a bucket "
+                       "using an adaptive gcs_request_concurrency"));
+
 std::optional<size_t> GetEnvGcsRequestConcurrency() {
   // Called before flag parsing during resource registration.
   auto env =
@@ -102,6 +124,19 @@ GcsConcurrencyResource::GcsConcurrencyResource()
 
 Result<GcsConcurrencyResource::Resource> GcsConcurrencyResource::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
+  if (spec.adaptive) {
+    Resource value;
+    value.spec = spec;
+    AimdAdmissionQueue::Options options;
+    options.initial_limit = spec.limit.value_or(shared_limit_);
+    options.max_limit =
+        std::max(options.initial_limit, kMaxAdaptiveRequestConcurrency);
+    value.adaptive_queues = std::make_shared<AimdAdmissionQueueMap>(
+        std::move(options), [](std::string_view bucket, size_t limit) {
+          gcs_adaptive_request_concurrency.Set(limit, std::string(bucket));
+        });
+    return value;
+  }
   if (spec.limit) {
     Resource value;
     value.spec = spec;
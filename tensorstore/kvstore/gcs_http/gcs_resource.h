@@ -24,8 +24,10 @@
 #include "absl/time/time.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/http/connection_prewarm_resource.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/util/result.h"
 
@@ -41,10 +43,15 @@ namespace internal_kvstore_gcs_http {
 ///
 /// This provides a way to limit the concurrency across multiple tensorstores
 /// rather than each tensorstore always having independent limits.
+///
+/// When `adaptive` is set, a separate limit is maintained for each bucket,
+/// starting at `limit`, which is increased additively as requests succeed and
+/// decreased multiplicatively when requests are throttled.
 struct GcsConcurrencyResource
     : public internal::ContextResourceTraits<GcsConcurrencyResource> {
  public:
   static constexpr char id[] = "gcs_request_concurrency";
+  constexpr static bool shared_when_decoded = true;
 
   GcsConcurrencyResource(size_t shared_limit);
   GcsConcurrencyResource();
@@ -52,24 +59,33 @@ struct GcsConcurrencyResource
   struct Spec {
     // If equal to `nullopt`, indicates that the shared executor is used.
     std::optional<size_t> limit;
+    // Indicates that the limit of each bucket is adjusted in response to
+    // throttling.
+    bool adaptive = false;
 
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.limit);
+      return f(x.limit, x.adaptive);
     };
   };
   struct Resource {
     Spec spec;
     std::shared_ptr<internal::AdmissionQueue> queue;
+    // If non-null, used instead of `queue`.
+    std::shared_ptr<internal::AimdAdmissionQueueMap> adaptive_queues;
   };
 
-  static Spec Default() { return Spec{std::nullopt}; }
+  static Spec Default() { return Spec{std::nullopt, false}; }
 
   static constexpr auto JsonBinder() {
     namespace jb = tensorstore::internal_json_binding;
-    return jb::Object(jb::Member(
-        "limit",
-        jb::Projection<&Spec::limit>(jb::DefaultInitializedValue(
-            jb::Optional(jb::Integer<size_t>(1), [] { return "shared"; })))));
+    return jb::Object(
+        jb::Member("limit",
+                   jb::Projection<&Spec::limit>(jb::DefaultInitializedValue(
+                       jb::Optional(jb::Integer<size_t>(1),
+                                    [] { return "shared"; })))),
+        jb::Member("adaptive",
+                   jb::Projection<&Spec::adaptive>(
+                       jb::DefaultValue([](auto* v) { *v = false; }))));
   }
 
   Result<Resource> Create(
@@ -99,6 +115,7 @@ struct GcsRateLimiterResource
     : public internal::ContextResourceTraits<GcsRateLimiterResource> {
  public:
   static constexpr char id[] = "experimental_gcs_rate_limiter";
+  constexpr static bool shared_when_decoded = true;
 
   struct Spec {
     // If equal to `nullopt`, indicates that no rate-limiter is used.
@@ -137,6 +154,12 @@ struct GcsRateLimiterResource
   }
 };
 
+/// Specifies the number of connections opened when the driver is opened.
+struct GcsConnectionPrewarm
+    : public internal_http::ConnectionPrewarmResource<GcsConnectionPrewarm> {
+  static constexpr char id[] = "gcs_connection_prewarm";
+};
+
 }  // namespace internal_kvstore_gcs_http
 }  // namespace tensorstore
 
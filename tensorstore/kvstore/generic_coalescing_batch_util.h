@@ -21,12 +21,17 @@
 #include <cassert>
 #include <utility>
 
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/batch.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/auto_batch.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/single_flight_read.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -38,11 +43,40 @@ template <typename DerivedDriver>
 using GenericCoalescingBatchReadEntryBase =
     BatchReadEntry<DerivedDriver, ReadRequest<>,
                    // BatchEntryKey members:
-                   kvstore::Key, kvstore::ReadGenerationConditions>;
+                   kvstore::Key, kvstore::ReadGenerationConditions,
+                   kvstore::RequestPriority>;
+
+// Performs a non-batch read using `driver.ReadImpl`, and records its latency
+// with `driver.coalescing_policy()`.
+//
+// Identical reads that are in flight concurrently are merged by
+// `driver.single_flight_reads()`.
+template <typename DerivedDriver>
+Future<kvstore::ReadResult> ReadImplAndRecordLatency(
+    DerivedDriver& driver, kvstore::Key&& key, kvstore::ReadOptions&& options) {
+  return driver.single_flight_reads().Read(
+      std::move(key), std::move(options),
+      [&driver](kvstore::Key key, kvstore::ReadOptions options) {
+        const absl::Time start_time = absl::Now();
+        return PromiseFuturePair<kvstore::ReadResult>::Link(
+                   [driver = internal::IntrusivePtr<DerivedDriver>(&driver),
+                    start_time](Promise<kvstore::ReadResult> promise,
+                                ReadyFuture<kvstore::ReadResult> future) {
+                     if (future.result().ok()) {
+                       driver->coalescing_policy().RecordRead(
+                           future.value().value.size(),
+                           absl::Now() - start_time);
+                     }
+                     promise.SetResult(future.result());
+                   },
+                   driver.ReadImpl(std::move(key), std::move(options)))
+            .future;
+      });
+}
 
 // Generic batch read implementation that simply coalesces requests to the same
-// key with the same generation constraints, and then dispatches each coalesced
-// request independently to the driver.
+// key with the same generation constraints and priority, and then dispatches
+// each coalesced request independently to the driver.
 //
 // This may be used by drivers to implement batch read support when no specific
 // optimizations are possible.
@@ -53,8 +87,12 @@ using GenericCoalescingBatchReadEntryBase =
 //     - `Future<ReadResult> ReadImpl(Key, ReadOptions)` that performs a regular
 //       non-batch read (`ReadOptions::batch` will always be `no_batch`).
 //
-//     - `CoalescingOptions GetBatchReadCoalescingOptions()` that returns the
-//       coalescing options to use.
+//     - `CoalescingPolicy& coalescing_policy()` that returns the policy that
+//       determines the coalescing options to use.  The latency of each
+//       non-batch read is recorded with the policy.
+//
+//     - `SingleFlightReads& single_flight_reads()` that returns the object
+//       used to merge identical in-flight non-batch reads.
 //
 //     - `Executor executor()` that returns an executor to use for handling
 //       batch read operations.
@@ -91,14 +129,17 @@ struct GenericCoalescingBatchReadEntry
     internal::IntrusivePtr<GenericCoalescingBatchReadEntry> self(
         this, internal::adopt_object_ref);
     ForEachCoalescedRequest<Request>(
-        request_batch.requests, this->driver().GetBatchReadCoalescingOptions(),
+        request_batch.requests, this->driver().coalescing_policy().GetOptions(),
         [&](ByteRange coalesced_byte_range, span<Request> coalesced_requests) {
           kvstore::ReadOptions options;
           options.generation_conditions =
               std::get<kvstore::ReadGenerationConditions>(batch_entry_key);
           options.staleness_bound = request_batch.staleness_bound;
           options.byte_range = coalesced_byte_range;
-          auto read_future = this->driver().ReadImpl(
+          options.priority =
+              std::get<kvstore::RequestPriority>(batch_entry_key);
+          auto read_future = ReadImplAndRecordLatency(
+              this->driver(),
               kvstore::Key(std::get<kvstore::Key>(batch_entry_key)),
               std::move(options));
           read_future.Force();
@@ -123,18 +164,32 @@ struct GenericCoalescingBatchReadEntry
 /// non-batch read request.
 ///
 /// See `GenericCoalescingBatchReadEntry` for details.
-template <typename DerivedDriver>
+///
+/// \tparam Entry Batch entry type, which may be a type derived from
+///     `GenericCoalescingBatchReadEntryBase<DerivedDriver>` that handles the
+///     coalesced requests differently.
+/// \param auto_batcher If non-null, byte range requests that do not specify a
+///     batch are added to the implicit batch returned by
+///     `auto_batcher->GetBatch()`.
+template <typename DerivedDriver,
+          typename Entry = GenericCoalescingBatchReadEntry<DerivedDriver>>
 Future<kvstore::ReadResult> HandleBatchRequestByGenericByteRangeCoalescing(
-    DerivedDriver& driver, kvstore::Key&& key, kvstore::ReadOptions&& options) {
-  if (!options.batch || options.byte_range.IsFull() ||
-      !options.byte_range.IsRange()) {
-    return driver.ReadImpl(std::move(key), std::move(options));
+    DerivedDriver& driver, kvstore::Key&& key, kvstore::ReadOptions&& options,
+    AutoBatcher* auto_batcher = nullptr) {
+  if (options.byte_range.IsFull() || !options.byte_range.IsRange()) {
+    return ReadImplAndRecordLatency(driver, std::move(key), std::move(options));
+  }
+  if (!options.batch) {
+    if (!auto_batcher) {
+      return ReadImplAndRecordLatency(driver, std::move(key),
+                                      std::move(options));
+    }
+    options.batch = auto_batcher->GetBatch();
   }
   auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
-  using Entry = GenericCoalescingBatchReadEntry<DerivedDriver>;
   Entry::template MakeRequest<Entry>(
       driver, std::move(key), std::move(options.generation_conditions),
-      options.batch, options.staleness_bound,
+      options.priority, options.batch, options.staleness_bound,
       typename Entry::Request{{std::move(promise), options.byte_range}});
   return std::move(future);
 }
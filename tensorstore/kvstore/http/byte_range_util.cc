@@ -14,17 +14,127 @@
 
 #include "tensorstore/kvstore/http/byte_range_util.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <cassert>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/btree_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace internal_http {
+namespace {
+
+/// Byte range and content of a single part of a response.
+struct ResponsePart {
+  ByteRange byte_range;
+  absl::Cord value;
+};
+
+/// Maximum size of the delimiter line and headers of a single part of a
+/// `multipart/byteranges` response.
+constexpr size_t kMaxPartHeaderSize = 4096;
+
+/// Returns the boundary of a `multipart/byteranges` response, or
+/// `std::nullopt` if `response` has a different content type.
+Result<std::optional<std::string>> GetMultipartBoundary(
+    const HttpResponse& response) {
+  auto it = response.headers.find("content-type");
+  if (it == response.headers.end()) return std::nullopt;
+  std::vector<std::string_view> params = absl::StrSplit(it->second, ';');
+  if (!absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(params[0]),
+                              "multipart/byteranges")) {
+    return std::nullopt;
+  }
+  for (size_t i = 1; i < params.size(); ++i) {
+    std::string_view param = absl::StripAsciiWhitespace(params[i]);
+    if (!absl::StartsWithIgnoreCase(param, "boundary=")) continue;
+    param.remove_prefix(9);
+    if (param.size() >= 2 && param.front() == '"' && param.back() == '"') {
+      param.remove_prefix(1);
+      param.remove_suffix(1);
+    }
+    if (!param.empty()) return std::string(param);
+  }
+  return absl::InvalidArgumentError(tensorstore::StrCat(
+      "Missing boundary in \"content-type\" response header: ", it->second));
+}
+
+/// Parses the body of a `multipart/byteranges` response.
+///
+/// The content of each part is returned as a subcord of `payload`; only the
+/// delimiter and headers of each part are flattened.
+Result<std::vector<ResponsePart>> ParseMultipartByteRanges(
+    const absl::Cord& payload, std::string_view boundary,
+    int64_t& total_size) {
+  const std::string delimiter = tensorstore::StrCat("--", boundary);
+  std::vector<ResponsePart> parts;
+  size_t pos = 0;
+  while (true) {
+    const std::string head(payload.Subcord(pos, kMaxPartHeaderSize));
+    // The delimiter is preceded by a CRLF, except possibly for the first part,
+    // which may be preceded by an ignored preamble.
+    size_t i = head.find(delimiter);
+    if (i == std::string::npos) {
+      return absl::DataLossError(
+          "Missing delimiter in multipart/byteranges response");
+    }
+    i += delimiter.size();
+    if (head.compare(i, 2, "--") == 0) break;
+    // Skip any transport padding following the delimiter.
+    i = head.find("\r\n", i);
+    const size_t headers_end =
+        (i == std::string::npos) ? i : head.find("\r\n\r\n", i);
+    if (headers_end == std::string::npos) {
+      return absl::DataLossError(
+          "Invalid part headers in multipart/byteranges response");
+    }
+    absl::btree_multimap<std::string, std::string> headers;
+    AppendHeaderData(headers, std::string_view(head).substr(
+                                  i + 2, headers_end + 2 - (i + 2)));
+    auto content_range = TryParseContentRangeHeader(headers);
+    if (!content_range ||
+        std::get<1>(*content_range) < std::get<0>(*content_range)) {
+      return absl::DataLossError(
+          "Missing or invalid \"content-range\" header in "
+          "multipart/byteranges response part");
+    }
+    const auto [inclusive_min, inclusive_max, part_total_size] =
+        *content_range;
+    // An unknown total size is parsed as `0`.
+    if (part_total_size != 0) total_size = part_total_size;
+    const size_t size = inclusive_max - inclusive_min + 1;
+    pos += headers_end + 4;
+    if (pos + size > payload.size()) {
+      return absl::DataLossError(
+          "Truncated part in multipart/byteranges response");
+    }
+    parts.push_back(
+        ResponsePart{ByteRange{static_cast<int64_t>(inclusive_min),
+                               static_cast<int64_t>(inclusive_max + 1)},
+                     payload.Subcord(pos, size)});
+    pos += size;
+  }
+  return parts;
+}
+
+}  // namespace
 
 absl::Status ValidateResponseByteRange(
     const HttpResponse& response,
@@ -74,5 +184,73 @@ absl::Status ValidateResponseByteRange(
   return absl::OkStatus();
 }
 
+std::string FormatMultiRangeHeader(span<const ByteRange> byte_ranges) {
+  // https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Range
+  std::string header = "Range: bytes=";
+  for (size_t i = 0; i < byte_ranges.size(); ++i) {
+    const auto& byte_range = byte_ranges[i];
+    assert(byte_range.SatisfiesInvariants() && byte_range.size() > 0);
+    absl::StrAppendFormat(&header, "%s%d-%d", i == 0 ? "" : ",",
+                          byte_range.inclusive_min,
+                          byte_range.exclusive_max - 1);
+  }
+  return header;
+}
+
+absl::Status ValidateResponseByteRanges(const HttpResponse& response,
+                                        span<const ByteRange> byte_ranges,
+                                        span<absl::Cord> values,
+                                        int64_t& total_size) {
+  assert(byte_ranges.size() == values.size());
+  std::vector<ResponsePart> parts;
+  total_size = -1;
+  if (response.status_code != 206) {
+    // The server ignored the `Range` header and sent the entire value.
+    total_size = response.payload.size();
+    parts.push_back(ResponsePart{ByteRange{0, total_size}, response.payload});
+  } else {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto boundary,
+                                 GetMultipartBoundary(response));
+    if (boundary) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          parts, ParseMultipartByteRanges(response.payload, *boundary,
+                                          total_size));
+    } else {
+      // The server coalesced the requested ranges into a single range.
+      TENSORSTORE_ASSIGN_OR_RETURN(auto content_range_info,
+                                   ParseContentRangeHeader(response));
+      ByteRange byte_range{content_range_info.inclusive_min,
+                           content_range_info.exclusive_max};
+      if (byte_range.size() != response.payload.size()) {
+        return absl::DataLossError(tensorstore::StrCat(
+            "Response with byte range ", byte_range, " has size ",
+            response.payload.size()));
+      }
+      total_size = content_range_info.total_size;
+      parts.push_back(ResponsePart{byte_range, response.payload});
+    }
+  }
+  for (size_t i = 0; i < byte_ranges.size(); ++i) {
+    const auto& byte_range = byte_ranges[i];
+    const ResponsePart* part = nullptr;
+    for (const auto& p : parts) {
+      if (p.byte_range.inclusive_min <= byte_range.inclusive_min &&
+          byte_range.exclusive_max <= p.byte_range.exclusive_max) {
+        part = &p;
+        break;
+      }
+    }
+    if (!part) {
+      return absl::OutOfRangeError(
+          tensorstore::StrCat("Requested byte range ", byte_range,
+                              " was not satisfied by response"));
+    }
+    values[i] = part->value.Subcord(
+        byte_range.inclusive_min - part->byte_range.inclusive_min,
+        byte_range.size());
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace internal_http
 }  // namespace tensorstore
@@ -17,10 +17,13 @@
 
 #include <stdint.h>
 
+#include <string>
+
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/internal/http/http_response.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal_http {
@@ -34,6 +37,26 @@ absl::Status ValidateResponseByteRange(
     const OptionalByteRangeRequest& byte_range_request, absl::Cord& value,
     ByteRange& byte_range, int64_t& total_size);
 
+/// Formats a `Range` header requesting all of `byte_ranges`.
+///
+/// \param byte_ranges Non-empty byte ranges, sorted by start offset and
+///     non-overlapping.
+std::string FormatMultiRangeHeader(span<const ByteRange> byte_ranges);
+
+/// Extracts the content of each of `byte_ranges` from `response` to a request
+/// that specified the header returned by `FormatMultiRangeHeader`.
+///
+/// In addition to a `multipart/byteranges` response, accepts a single-part
+/// `206` response, which a server may return after coalescing the ranges, or
+/// a `200` response containing the entire value.
+///
+/// Assigns the content of `byte_ranges[i]` to `values[i]`, and the total size
+/// (or `-1` if unknown) to `total_size`.
+absl::Status ValidateResponseByteRanges(const HttpResponse& response,
+                                        span<const ByteRange> byte_ranges,
+                                        span<absl::Cord> values,
+                                        int64_t& total_size);
+
 }  // namespace internal_http
 }  // namespace tensorstore
 
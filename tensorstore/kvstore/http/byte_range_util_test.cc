@@ -0,0 +1,142 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/byte_range_util.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::ByteRange;
+using ::tensorstore::StatusIs;
+using ::tensorstore::internal_http::FormatMultiRangeHeader;
+using ::tensorstore::internal_http::HttpResponse;
+using ::tensorstore::internal_http::ValidateResponseByteRanges;
+
+TEST(FormatMultiRangeHeaderTest, Basic) {
+  EXPECT_EQ("Range: bytes=0-9",
+            FormatMultiRangeHeader(std::vector<ByteRange>{{0, 10}}));
+  EXPECT_EQ("Range: bytes=0-9,20-20,30-39",
+            FormatMultiRangeHeader(
+                std::vector<ByteRange>{{0, 10}, {20, 21}, {30, 40}}));
+}
+
+TEST(ValidateResponseByteRangesTest, Multipart) {
+  HttpResponse response{
+      206,
+      absl::Cord("preamble\r\n"
+                 "--THIS_STRING_SEPARATES \r\n"
+                 "Content-Type: application/octet-stream\r\n"
+                 "Content-Range: bytes 30-34/50\r\n"
+                 "\r\n"
+                 "01234\r\n"
+                 "--THIS_STRING_SEPARATES\r\n"
+                 "Content-Range: bytes 10-19/50\r\n"
+                 "\r\n"
+                 "valueabcde\r\n"
+                 "--THIS_STRING_SEPARATES--\r\n"),
+      {{"content-type",
+        "multipart/byteranges; boundary=\"THIS_STRING_SEPARATES\""}}};
+  std::vector<ByteRange> byte_ranges{{10, 20}, {31, 34}};
+  std::vector<absl::Cord> values(2);
+  int64_t total_size;
+  TENSORSTORE_ASSERT_OK(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size));
+  EXPECT_THAT(values, ::testing::ElementsAre("valueabcde", "123"));
+  EXPECT_EQ(50, total_size);
+}
+
+TEST(ValidateResponseByteRangesTest, SinglePart) {
+  HttpResponse response{
+      206, absl::Cord("abcdef"), {{"content-range", "bytes 10-15/50"}}};
+  std::vector<ByteRange> byte_ranges{{10, 12}, {14, 16}};
+  std::vector<absl::Cord> values(2);
+  int64_t total_size;
+  TENSORSTORE_ASSERT_OK(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size));
+  EXPECT_THAT(values, ::testing::ElementsAre("ab", "ef"));
+  EXPECT_EQ(50, total_size);
+}
+
+TEST(ValidateResponseByteRangesTest, EntireValue) {
+  HttpResponse response{200, absl::Cord("0123456789")};
+  std::vector<ByteRange> byte_ranges{{1, 3}, {7, 10}};
+  std::vector<absl::Cord> values(2);
+  int64_t total_size;
+  TENSORSTORE_ASSERT_OK(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size));
+  EXPECT_THAT(values, ::testing::ElementsAre("12", "789"));
+  EXPECT_EQ(10, total_size);
+
+  byte_ranges[1] = ByteRange{7, 11};
+  EXPECT_THAT(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size),
+      StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST(ValidateResponseByteRangesTest, MissingPart) {
+  HttpResponse response{
+      206,
+      absl::Cord("--XYZ\r\n"
+                 "Content-Range: bytes 10-19/50\r\n"
+                 "\r\n"
+                 "valueabcde\r\n"
+                 "--XYZ--\r\n"),
+      {{"content-type", "multipart/byteranges; boundary=XYZ"}}};
+  std::vector<ByteRange> byte_ranges{{10, 20}, {30, 35}};
+  std::vector<absl::Cord> values(2);
+  int64_t total_size;
+  EXPECT_THAT(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size),
+      StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST(ValidateResponseByteRangesTest, Truncated) {
+  HttpResponse response{
+      206,
+      absl::Cord("--XYZ\r\n"
+                 "Content-Range: bytes 10-19/50\r\n"
+                 "\r\n"
+                 "value"),
+      {{"content-type", "multipart/byteranges; boundary=XYZ"}}};
+  std::vector<ByteRange> byte_ranges{{10, 20}};
+  std::vector<absl::Cord> values(1);
+  int64_t total_size;
+  EXPECT_THAT(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size),
+      StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(ValidateResponseByteRangesTest, MissingBoundary) {
+  HttpResponse response{
+      206, absl::Cord(), {{"content-type", "multipart/byteranges"}}};
+  std::vector<ByteRange> byte_ranges{{10, 20}};
+  std::vector<absl::Cord> values(1);
+  int64_t total_size;
+  EXPECT_THAT(
+      ValidateResponseByteRanges(response, byte_ranges, values, total_size),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
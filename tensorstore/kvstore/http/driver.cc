@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -26,14 +27,19 @@
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/concurrency_resource_provider.h"
+#include "tensorstore/internal/hedging_context_resource.h"
+#include "tensorstore/internal/http/connection_prewarm_resource.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_request.h"
@@ -48,14 +54,20 @@
 #include "tensorstore/internal/retries_context_resource.h"
 #include "tensorstore/internal/retry.h"
 #include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/kvstore/auto_batch.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/hedged_read.h"
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_byte_budget.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/single_flight_read.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/url_registry.h"
 #include "tensorstore/util/executor.h"
@@ -63,18 +75,25 @@
 #include "tensorstore/util/garbage_collection/fwd.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 #include "tensorstore/util/str_cat.h"
 
 /// specializations
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/cache_key/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/internal/json_binding/std_array.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/serialization/std_vector.h"  // IWYU pragma: keep
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
 
 using ::tensorstore::internal::IntrusivePtr;
 using ::tensorstore::internal_http::HttpRequestBuilder;
 using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_http::HttpTransport;
+using ::tensorstore::internal_kvstore::ReadByteBudgetResource;
+using ::tensorstore::internal_kvstore_batch::AutoBatchResource;
 using ::tensorstore::internal_metrics::MetricMetadata;
 
 namespace tensorstore {
@@ -107,9 +126,22 @@ struct HttpRequestRetries
   static constexpr char id[] = "http_request_retries";
 };
 
+/// Specifies when slow requests are hedged.
+struct HttpRequestHedging
+    : public internal::HedgingResource<HttpRequestHedging> {
+  static constexpr char id[] = "http_request_hedging";
+};
+
+/// Specifies the number of connections opened when the driver is opened.
+struct HttpConnectionPrewarm
+    : public internal_http::ConnectionPrewarmResource<HttpConnectionPrewarm> {
+  static constexpr char id[] = "http_connection_prewarm";
+};
+
 struct HttpRequestConcurrencyResourceTraits
     : public internal::ConcurrencyResourceTraits,
       public internal::ContextResourceTraits<HttpRequestConcurrencyResource> {
+  constexpr static bool shared_when_decoded = true;
   HttpRequestConcurrencyResourceTraits() : ConcurrencyResourceTraits(32) {}
 };
 const internal::ContextResourceRegistration<
@@ -119,6 +151,12 @@ const internal::ContextResourceRegistration<
 const internal::ContextResourceRegistration<HttpRequestRetries>
     http_request_retries_registration;
 
+const internal::ContextResourceRegistration<HttpRequestHedging>
+    http_request_hedging_registration;
+
+const internal::ContextResourceRegistration<HttpConnectionPrewarm>
+    http_connection_prewarm_registration;
+
 /// Returns whether the absl::Status is a retriable request.
 bool IsRetriable(const absl::Status& status) {
   return (status.code() == absl::StatusCode::kDeadlineExceeded ||
@@ -137,6 +175,33 @@ absl::Status ValidateParsedHttpUrl(const internal::ParsedGenericUri& parsed) {
   return absl::OkStatus();
 }
 
+/// Returns the remaining freshness lifetime of `response` indicated by its
+/// `Cache-Control` and `Age` headers, or `std::nullopt` if the response may
+/// not be used without revalidation.
+std::optional<absl::Duration> GetFreshnessLifetime(
+    const HttpResponse& response) {
+  auto it = response.headers.find("cache-control");
+  if (it == response.headers.end()) return std::nullopt;
+  std::optional<int64_t> max_age;
+  for (std::string_view directive : absl::StrSplit(it->second, ',')) {
+    directive = absl::StripAsciiWhitespace(directive);
+    if (absl::EqualsIgnoreCase(directive, "no-cache") ||
+        absl::EqualsIgnoreCase(directive, "no-store")) {
+      return std::nullopt;
+    }
+    int64_t seconds;
+    if (absl::StartsWithIgnoreCase(directive, "max-age=") &&
+        absl::SimpleAtoi(directive.substr(8), &seconds) && seconds >= 0) {
+      max_age = seconds;
+    }
+  }
+  if (!max_age) return std::nullopt;
+  const int64_t age =
+      internal_http::TryParseIntHeader<int64_t>(response.headers, "age")
+          .value_or(0);
+  return absl::Seconds(*max_age - std::max<int64_t>(0, age));
+}
+
 void SplitParsedHttpUrl(const internal::ParsedGenericUri& parsed,
                         std::string& base_url, std::string& path) {
   size_t end_of_authority = parsed.authority_and_path.find('/');
@@ -155,10 +220,31 @@ struct HttpKeyValueStoreSpecData {
   std::string base_url;
   Context::Resource<HttpRequestConcurrencyResource> request_concurrency;
   Context::Resource<HttpRequestRetries> retries;
+  Context::Resource<HttpRequestHedging> request_hedging;
+  Context::Resource<HttpConnectionPrewarm> connection_prewarm;
+  Context::Resource<AutoBatchResource> auto_batch;
+  Context::Resource<ReadByteBudgetResource> read_byte_budget;
   std::vector<std::string> headers;
 
+  /// If specified, reads of byte ranges larger than this are split into
+  /// concurrent requests of at most this many bytes.
+  std::optional<int64_t> parallel_read_part_size;
+
+  /// Maximum number of coalesced byte ranges of a batch that are requested
+  /// using a single multi-range request.
+  int64_t max_ranges_per_request = 1;
+
+  /// If `true`, responses are treated as current until their freshness
+  /// lifetime, as indicated by the `Cache-Control` header, expires.
+  bool trust_cache_control = false;
+
+  internal_kvstore_batch::CoalescingOverrides read_coalescing;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
-    return f(x.base_url, x.request_concurrency, x.retries, x.headers);
+    return f(x.base_url, x.request_concurrency, x.retries, x.request_hedging,
+             x.connection_prewarm, x.auto_batch, x.read_byte_budget, x.headers,
+             x.parallel_read_part_size, x.max_ranges_per_request,
+             x.trust_cache_control, x.read_coalescing);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -174,11 +260,38 @@ struct HttpKeyValueStoreSpecData {
                          [](const auto& options, const std::string* x) {
                            return internal_http::ValidateHttpHeader(*x);
                          }))))),
+      jb::Member(
+          "parallel_read_part_size",
+          jb::Projection<&HttpKeyValueStoreSpecData::parallel_read_part_size>(
+              jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member(
+          "max_ranges_per_request",
+          jb::Projection<&HttpKeyValueStoreSpecData::max_ranges_per_request>(
+              jb::DefaultValue([](auto* v) { *v = 1; },
+                               jb::Integer<int64_t>(1)))),
+      jb::Member(
+          "trust_cache_control",
+          jb::Projection<&HttpKeyValueStoreSpecData::trust_cache_control>(
+              jb::DefaultValue([](auto* v) { *v = false; }))),
+      jb::Member("read_coalescing",
+                 jb::Projection<&HttpKeyValueStoreSpecData::read_coalescing>(
+                     jb::DefaultInitializedValue())),
       jb::Member(
           HttpRequestConcurrencyResource::id,
           jb::Projection<&HttpKeyValueStoreSpecData::request_concurrency>()),
       jb::Member(HttpRequestRetries::id,
-                 jb::Projection<&HttpKeyValueStoreSpecData::retries>()));
+                 jb::Projection<&HttpKeyValueStoreSpecData::retries>()),
+      jb::Member(
+          HttpRequestHedging::id,
+          jb::Projection<&HttpKeyValueStoreSpecData::request_hedging>()),
+      jb::Member(
+          HttpConnectionPrewarm::id,
+          jb::Projection<&HttpKeyValueStoreSpecData::connection_prewarm>()),
+      jb::Member(AutoBatchResource::id,
+                 jb::Projection<&HttpKeyValueStoreSpecData::auto_batch>()),
+      jb::Member(
+          ReadByteBudgetResource::id,
+          jb::Projection<&HttpKeyValueStoreSpecData::read_byte_budget>()));
 
   std::string GetUrl(std::string_view path) const {
     auto parsed = internal::ParseGenericUri(base_url);
@@ -225,14 +338,34 @@ class HttpKeyValueStore
     : public internal_kvstore::RegisteredDriver<HttpKeyValueStore,
                                                 HttpKeyValueStoreSpec> {
  public:
-  internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
-      const {
-    return internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions;
+  internal_kvstore_batch::CoalescingPolicy& coalescing_policy() {
+    return *coalescing_policy_;
+  }
+
+  internal_kvstore_batch::SingleFlightReads& single_flight_reads() {
+    return single_flight_reads_;
   }
 
   Future<ReadResult> Read(Key key, ReadOptions options) override;
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a single request for all of `byte_ranges`.
+  ///
+  /// The value of the returned result is the concatenation of the content of
+  /// each byte range.
+  Future<ReadResult> ReadMultiRange(Key&& key, ReadOptions&& options,
+                                    std::vector<ByteRange> byte_ranges);
+
+  /// Issues a single read request.
+  ///
+  /// If `byte_ranges` is non-empty, it overrides `options.byte_range`.
+  Future<ReadResult> ReadPart(const Key& key, ReadOptions options,
+                              std::vector<ByteRange> byte_ranges = {});
+
+  /// Applies request hedging and the read byte budget to `read_part`.
+  internal_http::ReadPartFunction WrapReadPart(
+      internal_http::ReadPartFunction read_part);
+
   const Executor& executor() const {
     return spec_.request_concurrency->executor;
   }
@@ -247,6 +380,8 @@ class HttpKeyValueStore
   }
 
   HttpKeyValueStoreSpecData spec_;
+  std::optional<internal_kvstore_batch::CoalescingPolicy> coalescing_policy_;
+  internal_kvstore_batch::SingleFlightReads single_flight_reads_;
 
   std::shared_ptr<HttpTransport> transport_;
 };
@@ -254,7 +389,13 @@ class HttpKeyValueStore
 Future<kvstore::DriverPtr> HttpKeyValueStoreSpec::DoOpen() const {
   auto driver = internal::MakeIntrusivePtr<HttpKeyValueStore>();
   driver->spec_ = data_;
+  driver->coalescing_policy_.emplace(
+      internal_kvstore_batch::kDefaultRemoteStorageCoalescingOptions,
+      data_.read_coalescing);
   driver->transport_ = internal_http::GetDefaultHttpTransport();
+  if (const auto& prewarmer = data_.connection_prewarm->prewarmer) {
+    prewarmer->Prewarm(*driver->transport_, data_.base_url);
+  }
   return driver;
 }
 
@@ -265,15 +406,23 @@ struct ReadTask {
   std::string url;
   kvstore::ReadOptions options;
 
+  /// If non-empty, the byte ranges requested by a multi-range request.
+  std::vector<ByteRange> byte_ranges;
+
   HttpResponse httpresponse;
 
   absl::Status DoRead() {
+    const bool multi_range = !byte_ranges.empty();
     HttpRequestBuilder request_builder(
-        options.byte_range.size() == 0 ? "HEAD" : "GET", url);
+        (!multi_range && options.byte_range.size() == 0) ? "HEAD" : "GET",
+        url);
     for (const auto& header : owner->spec_.headers) {
       request_builder.AddHeader(header);
     }
-    if (options.byte_range.size() != 0) {
+    if (multi_range) {
+      request_builder.AddHeader(
+          internal_http::FormatMultiRangeHeader(byte_ranges));
+    } else if (options.byte_range.size() != 0) {
       request_builder.MaybeAddRangeHeader(options.byte_range);
     }
 
@@ -299,7 +448,13 @@ struct ReadTask {
 
     ABSL_LOG_IF(INFO, http_logging) << "[http] Read: " << request;
 
-    auto response = owner->transport_->IssueRequest(request, {}).result();
+    auto response =
+        owner->transport_
+            ->IssueRequest(
+                request,
+                internal_http::IssueRequestOptions().SetResponseSizeHint(
+                    std::max<int64_t>(0, options.byte_range.size())))
+            .result();
     if (!response.ok()) return response.status();
     httpresponse = std::move(*response);
     http_bytes_read.IncrementBy(httpresponse.payload.size());
@@ -343,6 +498,14 @@ struct ReadTask {
       }
     }
 
+    if (owner->spec_.trust_cache_control) {
+      // The response remains current, without revalidation, until its
+      // freshness lifetime expires.
+      if (auto lifetime = GetFreshnessLifetime(httpresponse)) {
+        start_time = std::max(start_time, start_time + *lifetime);
+      }
+    }
+
     switch (httpresponse.status_code) {
       case 204:
       case 404:
@@ -361,7 +524,15 @@ struct ReadTask {
     }
 
     absl::Cord value;
-    if (options.byte_range.size() != 0) {
+    if (!byte_ranges.empty()) {
+      std::vector<absl::Cord> values(byte_ranges.size());
+      int64_t total_size;
+      TENSORSTORE_RETURN_IF_ERROR(internal_http::ValidateResponseByteRanges(
+          httpresponse, byte_ranges, values, total_size));
+      for (auto& range_value : values) {
+        value.Append(std::move(range_value));
+      }
+    } else if (options.byte_range.size() != 0) {
       // Currently unused
       ByteRange byte_range;
       int64_t total_size;
@@ -429,19 +600,198 @@ struct ReadTask {
   }
 };
 
+/// Batch read entry used in place of `GenericCoalescingBatchReadEntry` when
+/// `max_ranges_per_request > 1`.
+///
+/// Requests are coalesced in the same way, and then each group of up to
+/// `max_ranges_per_request` coalesced byte ranges is read using a single
+/// multi-range request.
+struct MultiRangeBatchReadEntry
+    : public internal_kvstore_batch::GenericCoalescingBatchReadEntryBase<
+          HttpKeyValueStore>,
+      public internal::AtomicReferenceCount<MultiRangeBatchReadEntry> {
+  using Base = internal_kvstore_batch::GenericCoalescingBatchReadEntryBase<
+      HttpKeyValueStore>;
+  using Base::batch_entry_key;
+  using Base::request_batch;
+  using Request = typename Base::Request;
+
+  explicit MultiRangeBatchReadEntry(BatchEntryKey&& batch_entry_key_)
+      : Base(std::move(batch_entry_key_)),
+        // Create an initial reference count that is implicitly transferred to
+        // `Submit`.
+        internal::AtomicReferenceCount<MultiRangeBatchReadEntry>(
+            /*initial_ref_count=*/1) {}
+
+  // Submit is responsible for destroying the entry when done.
+  void Submit(Batch::View batch) final {
+    if (request_batch.requests.empty()) return;
+    driver().executor()([this] { ProcessBatch(); });
+  }
+
+  void ProcessBatch() {
+    // Take ownership of the initial reference.  A separate reference is held
+    // by each read.
+    IntrusivePtr<MultiRangeBatchReadEntry> self(this,
+                                                internal::adopt_object_ref);
+    std::vector<ByteRange> byte_ranges;
+    std::vector<span<Request>> range_requests;
+    const size_t max_ranges = driver().spec_.max_ranges_per_request;
+    const auto flush = [&] {
+      if (byte_ranges.empty()) return;
+      IssueRead(std::exchange(byte_ranges, {}),
+                std::exchange(range_requests, {}));
+    };
+    internal_kvstore_batch::ForEachCoalescedRequest<Request>(
+        request_batch.requests, driver().coalescing_policy().GetOptions(),
+        [&](ByteRange coalesced_byte_range, span<Request> coalesced_requests) {
+          if (coalesced_byte_range.size() == 0) {
+            // Empty byte ranges cannot be included in a multi-range request.
+            IssueRead({coalesced_byte_range}, {coalesced_requests});
+            return;
+          }
+          byte_ranges.push_back(coalesced_byte_range);
+          range_requests.push_back(coalesced_requests);
+          if (byte_ranges.size() == max_ranges) flush();
+        });
+    flush();
+  }
+
+  void IssueRead(std::vector<ByteRange> byte_ranges,
+                 std::vector<span<Request>> range_requests) {
+    kvstore::ReadOptions options;
+    options.generation_conditions =
+        std::get<kvstore::ReadGenerationConditions>(batch_entry_key);
+    options.staleness_bound = request_batch.staleness_bound;
+    options.priority = std::get<kvstore::RequestPriority>(batch_entry_key);
+    kvstore::Key key(std::get<kvstore::Key>(batch_entry_key));
+    const absl::Time start_time = absl::Now();
+    const bool multi_range = byte_ranges.size() > 1;
+    Future<kvstore::ReadResult> read_future;
+    if (multi_range) {
+      read_future = driver().ReadMultiRange(std::move(key), std::move(options),
+                                            byte_ranges);
+    } else {
+      options.byte_range = byte_ranges[0];
+      read_future = internal_kvstore_batch::ReadImplAndRecordLatency(
+          driver(), std::move(key), std::move(options));
+    }
+    read_future.Force();
+    std::move(read_future)
+        .ExecuteWhenReady(WithExecutor(
+            driver().executor(),
+            [self = IntrusivePtr<MultiRangeBatchReadEntry>(this),
+             byte_ranges = std::move(byte_ranges),
+             range_requests = std::move(range_requests), start_time,
+             multi_range](ReadyFuture<kvstore::ReadResult> future) {
+              auto& result = future.result();
+              if (!result.ok()) {
+                for (const auto& requests : range_requests) {
+                  internal_kvstore_batch::SetCommonResult(requests,
+                                                          result.status());
+                }
+                return;
+              }
+              if (multi_range) {
+                self->driver().coalescing_policy().RecordRead(
+                    result->value.size(), absl::Now() - start_time);
+              }
+              // The value is the concatenation of the content of each byte
+              // range.
+              int64_t offset = 0;
+              for (size_t i = 0; i < byte_ranges.size(); ++i) {
+                kvstore::ReadResult range_result;
+                range_result.stamp = result->stamp;
+                range_result.state = result->state;
+                if (result->has_value()) {
+                  range_result.value =
+                      result->value.Subcord(offset, byte_ranges[i].size());
+                  offset += byte_ranges[i].size();
+                }
+                internal_kvstore_batch::ResolveCoalescedRequests(
+                    byte_ranges[i], range_requests[i],
+                    std::move(range_result));
+              }
+            }));
+  }
+};
+
 Future<kvstore::ReadResult> HttpKeyValueStore::Read(Key key,
                                                     ReadOptions options) {
   http_read.Increment();
+  if (spec_.max_ranges_per_request > 1) {
+    return internal_kvstore_batch::
+        HandleBatchRequestByGenericByteRangeCoalescing<
+            HttpKeyValueStore, MultiRangeBatchReadEntry>(
+            *this, std::move(key), std::move(options),
+            spec_.auto_batch->batcher.get());
+  }
   return internal_kvstore_batch::HandleBatchRequestByGenericByteRangeCoalescing(
-      *this, std::move(key), std::move(options));
+      *this, std::move(key), std::move(options),
+      spec_.auto_batch->batcher.get());
 }
 
 Future<kvstore::ReadResult> HttpKeyValueStore::ReadImpl(Key&& key,
                                                         ReadOptions&& options) {
   http_batch_read.Increment();
+  if (!spec_.parallel_read_part_size && !spec_.request_hedging->hedger &&
+      !spec_.read_byte_budget->budget) {
+    return ReadPart(key, std::move(options));
+  }
+  internal_http::ReadPartFunction read_part =
+      WrapReadPart([self = IntrusivePtr<HttpKeyValueStore>(this),
+                    key = std::move(key)](ReadOptions options) {
+        return self->ReadPart(key, std::move(options));
+      });
+  if (spec_.parallel_read_part_size) {
+    return internal_http::ParallelByteRangeRead(
+        std::move(options), *spec_.parallel_read_part_size,
+        std::move(read_part));
+  }
+  return read_part(std::move(options));
+}
+
+Future<kvstore::ReadResult> HttpKeyValueStore::ReadMultiRange(
+    Key&& key, ReadOptions&& options, std::vector<ByteRange> byte_ranges) {
+  http_batch_read.Increment();
+  // `options.byte_range` only determines the size reserved from the read byte
+  // budget and the response size hint.
+  int64_t total_size = 0;
+  for (const auto& byte_range : byte_ranges) total_size += byte_range.size();
+  options.byte_range = ByteRange{0, total_size};
+  return WrapReadPart(
+      [self = IntrusivePtr<HttpKeyValueStore>(this), key = std::move(key),
+       byte_ranges = std::move(byte_ranges)](ReadOptions options) {
+        return self->ReadPart(key, std::move(options), byte_ranges);
+      })(std::move(options));
+}
+
+internal_http::ReadPartFunction HttpKeyValueStore::WrapReadPart(
+    internal_http::ReadPartFunction read_part) {
+  const auto& hedger = spec_.request_hedging->hedger;
+  const auto& budget = spec_.read_byte_budget->budget;
+  if (hedger) {
+    read_part = [hedger, read_part = std::move(read_part)](
+                    ReadOptions options) {
+      return internal_http::HedgedRead(hedger, std::move(options), read_part);
+    };
+  }
+  if (budget) {
+    read_part = [budget, executor = executor(),
+                 read_part = std::move(read_part)](ReadOptions options) {
+      return budget->Read(executor, std::move(options), read_part);
+    };
+  }
+  return read_part;
+}
+
+Future<kvstore::ReadResult> HttpKeyValueStore::ReadPart(
+    const Key& key, ReadOptions options, std::vector<ByteRange> byte_ranges) {
   std::string url = spec_.GetUrl(key);
-  return MapFuture(executor(), ReadTask{IntrusivePtr<HttpKeyValueStore>(this),
-                                        std::move(url), std::move(options)});
+  return MapFuture(executor(),
+                   ReadTask{IntrusivePtr<HttpKeyValueStore>(this),
+                            std::move(url), std::move(options),
+                            std::move(byte_ranges)});
 }
 
 Result<kvstore::Spec> ParseHttpUrl(std::string_view url) {
@@ -454,6 +804,14 @@ Result<kvstore::Spec> ParseHttpUrl(std::string_view url) {
       Context::Resource<HttpRequestConcurrencyResource>::DefaultSpec();
   driver_spec->data_.retries =
       Context::Resource<HttpRequestRetries>::DefaultSpec();
+  driver_spec->data_.request_hedging =
+      Context::Resource<HttpRequestHedging>::DefaultSpec();
+  driver_spec->data_.connection_prewarm =
+      Context::Resource<HttpConnectionPrewarm>::DefaultSpec();
+  driver_spec->data_.auto_batch =
+      Context::Resource<AutoBatchResource>::DefaultSpec();
+  driver_spec->data_.read_byte_budget =
+      Context::Resource<ReadByteBudgetResource>::DefaultSpec();
   return {std::in_place, std::move(driver_spec), std::move(path)};
 }
 
@@ -14,8 +14,10 @@
 
 #include "tensorstore/kvstore/driver.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -25,6 +27,7 @@
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/context.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/internal/http/http_header.h"
 #include "tensorstore/internal/http/http_request.h"
@@ -164,6 +167,40 @@ TEST_F(HttpKeyValueStoreTest, ReadByteRange) {
                                    StorageGeneration::Invalid()));
 }
 
+TEST_F(HttpKeyValueStoreTest, ReadByteRangeParallel) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"parallel_read_part_size", 6}})
+                      .result());
+  kvstore::ReadOptions options;
+  options.byte_range.inclusive_min = 10;
+  options.byte_range.exclusive_max = 20;
+  auto read_future = kvstore::Read(store, "abc", options);
+  for (int i = 0; i < 2; ++i) {
+    auto request = mock_transport->requests_.pop();
+    EXPECT_EQ("https://example.com/my/path/abc", request.request.url);
+    EXPECT_THAT(request.request.method, "GET");
+    const auto& headers = request.request.headers;
+    if (std::find(headers.begin(), headers.end(), "Range: bytes=10-15") !=
+        headers.end()) {
+      request.set_result(HttpResponse{206,
+                                      absl::Cord("valuea"),
+                                      {{"content-range", "bytes 10-15/50"},
+                                       {"etag", "\"xyz\""}}});
+    } else {
+      EXPECT_THAT(headers, ::testing::Contains("Range: bytes=16-19"));
+      request.set_result(HttpResponse{206,
+                                      absl::Cord("bcde"),
+                                      {{"content-range", "bytes 16-19/50"},
+                                       {"etag", "\"xyz\""}}});
+    }
+  }
+  EXPECT_THAT(read_future.result(),
+              MatchesKvsReadResult(absl::Cord("valueabcde"),
+                                   StorageGeneration::FromString("xyz")));
+}
+
 TEST_F(HttpKeyValueStoreTest, ReadBatch) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, kvstore::Open("https://example.com/my/path/").result());
@@ -202,6 +239,97 @@ TEST_F(HttpKeyValueStoreTest, ReadBatch) {
       MatchesKvsReadResult(absl::Cord("01234"), StorageGeneration::Invalid()));
 }
 
+TEST_F(HttpKeyValueStoreTest, ReadBatchMultiRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"max_ranges_per_request", 2},
+                                 {"read_coalescing",
+                                  {{"max_extra_read_bytes", 0}}}})
+                      .result());
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = Batch::New();
+    for (auto [inclusive_min, exclusive_max] :
+         {std::pair{10, 20}, std::pair{30, 35}, std::pair{40, 45}}) {
+      kvstore::ReadOptions options;
+      options.byte_range.inclusive_min = inclusive_min;
+      options.byte_range.exclusive_max = exclusive_max;
+      options.batch = batch;
+      futures.push_back(kvstore::Read(store, "abc", options));
+    }
+  }
+  for (int i = 0; i < 2; ++i) {
+    auto request = mock_transport->requests_.pop();
+    EXPECT_EQ("https://example.com/my/path/abc", request.request.url);
+    EXPECT_THAT(request.request.method, "GET");
+    const auto& headers = request.request.headers;
+    if (std::find(headers.begin(), headers.end(),
+                  "Range: bytes=10-19,30-34") != headers.end()) {
+      request.set_result(HttpResponse{
+          206,
+          absl::Cord("--XYZ\r\n"
+                     "content-type: application/octet-stream\r\n"
+                     "content-range: bytes 10-19/50\r\n"
+                     "\r\n"
+                     "valueabcde\r\n"
+                     "--XYZ\r\n"
+                     "content-range: bytes 30-34/50\r\n"
+                     "\r\n"
+                     "01234\r\n"
+                     "--XYZ--\r\n"),
+          {{"content-type", "multipart/byteranges; boundary=XYZ"},
+           {"etag", "\"xyz\""}}});
+    } else {
+      EXPECT_THAT(headers, ::testing::Contains("Range: bytes=40-44"));
+      request.set_result(HttpResponse{206,
+                                      absl::Cord("fghij"),
+                                      {{"content-range", "bytes 40-44/50"},
+                                       {"etag", "\"xyz\""}}});
+    }
+  }
+  EXPECT_THAT(futures[0].result(),
+              MatchesKvsReadResult(absl::Cord("valueabcde"),
+                                   StorageGeneration::FromString("xyz")));
+  EXPECT_THAT(futures[1].result(),
+              MatchesKvsReadResult(absl::Cord("01234"),
+                                   StorageGeneration::FromString("xyz")));
+  EXPECT_THAT(futures[2].result(),
+              MatchesKvsReadResult(absl::Cord("fghij"),
+                                   StorageGeneration::FromString("xyz")));
+}
+
+TEST_F(HttpKeyValueStoreTest, ReadBatchMultiRangeCoalescedByServer) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"max_ranges_per_request", 4},
+                                 {"read_coalescing",
+                                  {{"max_extra_read_bytes", 0}}}})
+                      .result());
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = Batch::New();
+    for (auto [inclusive_min, exclusive_max] :
+         {std::pair{10, 12}, std::pair{14, 16}}) {
+      kvstore::ReadOptions options;
+      options.byte_range.inclusive_min = inclusive_min;
+      options.byte_range.exclusive_max = exclusive_max;
+      options.batch = batch;
+      futures.push_back(kvstore::Read(store, "abc", options));
+    }
+  }
+  auto request = mock_transport->requests_.pop();
+  EXPECT_THAT(request.request.headers,
+              ::testing::UnorderedElementsAre("cache-control: no-cache",
+                                              "Range: bytes=10-11,14-15"));
+  // The server may respond with a single range covering all requested ranges.
+  request.set_result(HttpResponse{
+      206, absl::Cord("abcdef"), {{"content-range", "bytes 10-15/50"}}});
+  EXPECT_THAT(futures[0].result(), MatchesKvsReadResult(absl::Cord("ab")));
+  EXPECT_THAT(futures[1].result(), MatchesKvsReadResult(absl::Cord("ef")));
+}
+
 TEST_F(HttpKeyValueStoreTest, ReadZeroByteRange) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, kvstore::Open("https://example.com/my/path/").result());
@@ -371,6 +499,57 @@ TEST_F(HttpKeyValueStoreTest, Date) {
                            response_date));
 }
 
+TEST_F(HttpKeyValueStoreTest, TrustCacheControl) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"trust_cache_control", true}})
+                      .result());
+
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::InfinitePast();
+  auto read_future = kvstore::Read(store, "abc", options);
+  auto response_date = absl::UnixEpoch() + absl::Seconds(100);
+  auto request = mock_transport->requests_.pop();
+  request.set_result(HttpResponse{
+      200,
+      absl::Cord("value"),
+      {{"date", absl::FormatTime(tensorstore::internal_http::kHttpTimeFormat,
+                                 response_date, absl::UTCTimeZone())},
+       {"cache-control", "public, max-age=60"},
+       {"age", "10"}}});
+  // The response remains current for the remaining 50 seconds of its
+  // freshness lifetime.
+  EXPECT_THAT(
+      read_future.result(),
+      MatchesKvsReadResult(absl::Cord("value"), StorageGeneration::Invalid(),
+                           response_date + absl::Seconds(50)));
+}
+
+TEST_F(HttpKeyValueStoreTest, TrustCacheControlNoCache) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "http"},
+                                 {"base_url", "https://example.com/my/path/"},
+                                 {"trust_cache_control", true}})
+                      .result());
+
+  kvstore::ReadOptions options;
+  options.staleness_bound = absl::InfinitePast();
+  auto read_future = kvstore::Read(store, "abc", options);
+  auto response_date = absl::UnixEpoch() + absl::Seconds(100);
+  auto request = mock_transport->requests_.pop();
+  request.set_result(HttpResponse{
+      200,
+      absl::Cord("value"),
+      {{"date", absl::FormatTime(tensorstore::internal_http::kHttpTimeFormat,
+                                 response_date, absl::UTCTimeZone())},
+       {"cache-control", "max-age=60, no-cache"}}});
+  EXPECT_THAT(
+      read_future.result(),
+      MatchesKvsReadResult(absl::Cord("value"), StorageGeneration::Invalid(),
+                           response_date));
+}
+
 TEST_F(HttpKeyValueStoreTest, DateSkew) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, kvstore::Open("https://example.com/my/path/").result());
@@ -440,6 +619,28 @@ TEST_F(HttpKeyValueStoreTest, ExtraHeaders) {
   EXPECT_THAT(read_future.result(), MatchesKvsReadResult(absl::Cord("value")));
 }
 
+TEST_F(HttpKeyValueStoreTest, ConnectionPrewarm) {
+  auto context =
+      tensorstore::Context::FromJson(
+          {{"http_connection_prewarm", {{"connections", 2}}}})
+          .value();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open("https://example.com/my/path/", context).result());
+  for (int i = 0; i < 2; ++i) {
+    auto request = mock_transport->requests_.pop();
+    EXPECT_EQ("HEAD", request.request.method);
+    EXPECT_EQ("https://example.com", request.request.url);
+    request.set_result(HttpResponse{404, absl::Cord()});
+  }
+
+  // Connections to the same endpoint are only pre-warmed once per resource.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store2,
+      kvstore::Open("https://example.com/other/path/", context).result());
+  EXPECT_TRUE(mock_transport->requests_.empty());
+}
+
 TEST(UrlTest, UrlRoundtrip) {
   tensorstore::internal::TestKeyValueStoreUrlRoundtrip(
       {{"driver", "http"},
@@ -493,6 +694,20 @@ TEST(SpecTest, InvalidHeader) {
               MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(SpecTest, InvalidHedging) {
+  EXPECT_THAT(kvstore::Open({{"driver", "http"},
+                             {"base_url", "https://example.com"},
+                             {"http_request_hedging", {{"max_fraction", 2}}}})
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      kvstore::Open({{"driver", "http"},
+                     {"base_url", "https://example.com"},
+                     {"http_request_hedging", {{"latency_percentile", 1}}}})
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(SpecTest, SpecRoundtrip) {
   tensorstore::internal::KeyValueStoreSpecRoundtripOptions options;
   options.check_write_read = false;
@@ -0,0 +1,86 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/hedged_read.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/request_hedger.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+using ::tensorstore::internal_metrics::MetricMetadata;
+
+namespace tensorstore {
+namespace internal_http {
+namespace {
+
+auto& hedged_reads = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/http/hedged_reads",
+    MetricMetadata("Number of hedged read requests issued"));
+
+/// Links the result of `future` to `promise`, recording the latency since
+/// `start_time` if the read succeeds first.
+void LinkRead(std::shared_ptr<internal::RequestHedger> hedger,
+              absl::Time start_time, Promise<kvstore::ReadResult> promise,
+              Future<kvstore::ReadResult> future) {
+  // The link is removed once `promise` is no longer needed, in particular
+  // once the other read completes, which cancels this read.
+  Link(
+      [hedger = std::move(hedger), start_time](
+          Promise<kvstore::ReadResult> promise,
+          ReadyFuture<kvstore::ReadResult> future) {
+        if (future.status().ok()) {
+          hedger->RecordLatency(absl::Now() - start_time);
+        }
+        promise.SetResult(future.result());
+      },
+      std::move(promise), std::move(future));
+}
+
+}  // namespace
+
+Future<kvstore::ReadResult> HedgedRead(
+    std::shared_ptr<internal::RequestHedger> hedger,
+    kvstore::ReadOptions options, ReadPartFunction read_part) {
+  const absl::Duration delay = hedger->StartRequest();
+  const absl::Time start_time = absl::Now();
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  LinkRead(hedger, start_time, pair.promise, read_part(options));
+  if (delay != absl::InfiniteDuration()) {
+    internal::ScheduleAt(
+        start_time + delay,
+        [hedger = std::move(hedger), start_time, promise = pair.promise,
+         options = std::move(options),
+         read_part = std::move(read_part)]() mutable {
+          if (!promise.result_needed() || !hedger->TryStartHedge()) return;
+          hedged_reads.Increment();
+          auto future = read_part(std::move(options));
+          LinkRead(std::move(hedger), start_time, std::move(promise),
+                   std::move(future));
+        });
+  }
+  return std::move(pair.future);
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
@@ -0,0 +1,41 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_HTTP_HEDGED_READ_H_
+#define TENSORSTORE_KVSTORE_HTTP_HEDGED_READ_H_
+
+#include <memory>
+
+#include "tensorstore/internal/request_hedger.h"
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Reads using `read_part`, and if the read has not completed after the delay
+/// determined by `hedger`, issues a second identical read.
+///
+/// The result of whichever read completes first is returned, and the other
+/// read is cancelled.
+Future<kvstore::ReadResult> HedgedRead(
+    std::shared_ptr<internal::RequestHedger> hedger,
+    kvstore::ReadOptions options, ReadPartFunction read_part);
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_HTTP_HEDGED_READ_H_
@@ -0,0 +1,140 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/hedged_read.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/request_hedger.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::Promise;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal::RequestHedger;
+using ::tensorstore::internal_http::HedgedRead;
+using ::tensorstore::kvstore::ReadOptions;
+using ::tensorstore::kvstore::ReadResult;
+
+/// Records each read so that the test can complete it.
+struct PendingReads {
+  absl::Mutex mutex;
+  std::vector<Promise<ReadResult>> promises;
+
+  Future<ReadResult> Read(ReadOptions options) {
+    auto pair = PromiseFuturePair<ReadResult>::Make();
+    absl::MutexLock lock(&mutex);
+    promises.push_back(std::move(pair.promise));
+    return std::move(pair.future);
+  }
+
+  Promise<ReadResult> WaitForRead(size_t i) {
+    absl::MutexLock lock(&mutex);
+    auto has_read = [&] { return promises.size() > i; };
+    mutex.Await(absl::Condition(&has_read));
+    return promises[i];
+  }
+
+  size_t size() {
+    absl::MutexLock lock(&mutex);
+    return promises.size();
+  }
+};
+
+ReadResult MakeValue(const char* value) {
+  return ReadResult::Value(
+      absl::Cord(value),
+      TimestampedStorageGeneration{StorageGeneration::FromString("g"),
+                                   absl::Now()});
+}
+
+std::shared_ptr<RequestHedger> MakeHedger(double max_fraction) {
+  RequestHedger::Options options;
+  options.max_fraction = max_fraction;
+  options.min_delay = absl::ZeroDuration();
+  auto hedger = std::make_shared<RequestHedger>(options);
+  for (size_t i = 0; i < RequestHedger::kMinSamples; ++i) {
+    hedger->RecordLatency(absl::Milliseconds(1));
+  }
+  return hedger;
+}
+
+TEST(HedgedReadTest, NoSamples) {
+  auto hedger = std::make_shared<RequestHedger>(RequestHedger::Options{});
+  PendingReads reads;
+  auto future = HedgedRead(hedger, {}, [&](ReadOptions options) {
+    return reads.Read(std::move(options));
+  });
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_EQ(1, reads.size());
+  reads.WaitForRead(0).SetResult(MakeValue("a"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, future.result());
+  EXPECT_EQ("a", result.value);
+}
+
+TEST(HedgedReadTest, HedgeWins) {
+  PendingReads reads;
+  auto future = HedgedRead(MakeHedger(1), {}, [&](ReadOptions options) {
+    return reads.Read(std::move(options));
+  });
+  auto primary = reads.WaitForRead(0);
+  auto hedge = reads.WaitForRead(1);
+  hedge.SetResult(MakeValue("b"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, future.result());
+  EXPECT_EQ("b", result.value);
+  // The slower read is cancelled.
+  EXPECT_FALSE(primary.result_needed());
+}
+
+TEST(HedgedReadTest, PrimaryWins) {
+  PendingReads reads;
+  auto future = HedgedRead(MakeHedger(1), {}, [&](ReadOptions options) {
+    return reads.Read(std::move(options));
+  });
+  auto primary = reads.WaitForRead(0);
+  auto hedge = reads.WaitForRead(1);
+  primary.SetResult(MakeValue("a"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result, future.result());
+  EXPECT_EQ("a", result.value);
+  EXPECT_FALSE(hedge.result_needed());
+}
+
+TEST(HedgedReadTest, BudgetExhausted) {
+  PendingReads reads;
+  auto future = HedgedRead(MakeHedger(0.5), {}, [&](ReadOptions options) {
+    return reads.Read(std::move(options));
+  });
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_EQ(1, reads.size());
+  reads.WaitForRead(0).SetResult(MakeValue("a"));
+  TENSORSTORE_ASSERT_OK(future.result());
+}
+
+}  // namespace
@@ -0,0 +1,101 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_http {
+namespace {
+
+/// Combines the results of the parts of a split read.
+///
+/// Returns `false` if the parts are not consistent with each other.
+bool CombineParts(span<const Future<kvstore::ReadResult>> parts,
+                  kvstore::ReadResult& combined) {
+  const auto& first = parts[0].value();
+  combined.state = first.state;
+  combined.stamp = first.stamp;
+  for (const auto& future : parts) {
+    const auto& part = future.value();
+    if (part.state != first.state ||
+        part.stamp.generation != first.stamp.generation) {
+      return false;
+    }
+    // The combined value is known to be current as of the earliest time
+    // reported by any of the parts.
+    combined.stamp.time = std::min(combined.stamp.time, part.stamp.time);
+    if (part.has_value()) {
+      combined.value.Append(part.value);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Future<kvstore::ReadResult> ParallelByteRangeRead(kvstore::ReadOptions options,
+                                                  int64_t part_size,
+                                                  ReadPartFunction read_part) {
+  const auto& byte_range = options.byte_range;
+  if (part_size <= 0 || byte_range.inclusive_min < 0 ||
+      byte_range.exclusive_max == -1 || byte_range.size() <= part_size) {
+    return read_part(std::move(options));
+  }
+
+  std::vector<Future<kvstore::ReadResult>> parts;
+  parts.reserve((byte_range.size() + part_size - 1) / part_size);
+  for (int64_t start = byte_range.inclusive_min;
+       start < byte_range.exclusive_max; start += part_size) {
+    kvstore::ReadOptions part_options = options;
+    part_options.byte_range = OptionalByteRangeRequest::Range(
+        start, std::min(start + part_size, byte_range.exclusive_max));
+    parts.push_back(read_part(std::move(part_options)));
+  }
+
+  auto all_parts = WaitAllFuture(span<Future<kvstore::ReadResult>>(parts));
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  LinkValue(
+      [parts = std::move(parts), options = std::move(options),
+       read_part = std::move(read_part)](
+          Promise<kvstore::ReadResult> promise, ReadyFuture<void>) mutable {
+        kvstore::ReadResult combined;
+        if (CombineParts(parts, combined)) {
+          promise.SetResult(std::move(combined));
+          return;
+        }
+        LinkResult(std::move(promise), read_part(std::move(options)));
+      },
+      std::move(pair.promise), std::move(all_parts));
+  return std::move(pair.future);
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
@@ -0,0 +1,50 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_HTTP_PARALLEL_BYTE_RANGE_READ_H_
+#define TENSORSTORE_KVSTORE_HTTP_PARALLEL_BYTE_RANGE_READ_H_
+
+#include <stdint.h>
+
+#include <functional>
+
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Function that issues a single read request, used by
+/// `ParallelByteRangeRead`.
+using ReadPartFunction =
+    std::function<Future<kvstore::ReadResult>(kvstore::ReadOptions options)>;
+
+/// Reads `options.byte_range` by issuing concurrent requests for sub-ranges of
+/// at most `part_size` bytes using `read_part`, and concatenates the results.
+///
+/// Only byte ranges with an explicit start and end that are larger than
+/// `part_size` are split; other requests are passed to `read_part` unchanged.
+///
+/// All parts must return a value with the same generation.  If they do not,
+/// for example because the object was modified while the parts were being
+/// read, the entire byte range is read again using a single request.
+Future<kvstore::ReadResult> ParallelByteRangeRead(kvstore::ReadOptions options,
+                                                  int64_t part_size,
+                                                  ReadPartFunction read_part);
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_HTTP_PARALLEL_BYTE_RANGE_READ_H_
@@ -0,0 +1,136 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal_http::ParallelByteRangeRead;
+using ::tensorstore::kvstore::ReadOptions;
+using ::tensorstore::kvstore::ReadResult;
+
+/// Serves reads of `value`, recording the requested byte ranges.
+struct FakeObject {
+  std::string value = "abcdefghijklmnopqrstuvwxyz";
+  std::vector<OptionalByteRangeRequest> requests;
+  // Generation returned for each request, indexed by request number.
+  std::vector<std::string> generations;
+
+  Future<ReadResult> Read(ReadOptions options) {
+    size_t i = requests.size();
+    requests.push_back(options.byte_range);
+    auto byte_range = options.byte_range.Validate(value.size());
+    if (!byte_range.ok()) return byte_range.status();
+    std::string generation =
+        i < generations.size() ? generations[i] : std::string("g");
+    return ReadResult::Value(
+        absl::Cord(value.substr(byte_range->inclusive_min, byte_range->size())),
+        TimestampedStorageGeneration{StorageGeneration::FromString(generation),
+                                     absl::Now()});
+  }
+};
+
+TEST(ParallelByteRangeReadTest, SplitsRange) {
+  FakeObject object;
+  ReadOptions options;
+  options.byte_range = OptionalByteRangeRequest::Range(2, 12);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      ParallelByteRangeRead(options, 4,
+                            [&](ReadOptions options) {
+                              return object.Read(std::move(options));
+                            })
+          .result());
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ("cdefghijkl", result.value);
+  EXPECT_EQ(StorageGeneration::FromString("g"), result.stamp.generation);
+  EXPECT_THAT(object.requests,
+              ::testing::ElementsAre(OptionalByteRangeRequest::Range(2, 6),
+                                     OptionalByteRangeRequest::Range(6, 10),
+                                     OptionalByteRangeRequest::Range(10, 12)));
+}
+
+TEST(ParallelByteRangeReadTest, UnsplitRequests) {
+  FakeObject object;
+  auto read_part = [&](ReadOptions options) {
+    return object.Read(std::move(options));
+  };
+  for (auto byte_range :
+       {OptionalByteRangeRequest::Range(0, 4), OptionalByteRangeRequest(),
+        OptionalByteRangeRequest::SuffixLength(10),
+        OptionalByteRangeRequest::Suffix(3)}) {
+    object.requests.clear();
+    ReadOptions options;
+    options.byte_range = byte_range;
+    TENSORSTORE_ASSERT_OK(ParallelByteRangeRead(options, 4, read_part).result());
+    EXPECT_THAT(object.requests, ::testing::ElementsAre(byte_range));
+  }
+}
+
+TEST(ParallelByteRangeReadTest, GenerationMismatch) {
+  FakeObject object;
+  object.generations = {"g", "h", "g", "h"};
+  ReadOptions options;
+  options.byte_range = OptionalByteRangeRequest::Range(0, 12);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      ParallelByteRangeRead(options, 4,
+                            [&](ReadOptions options) {
+                              return object.Read(std::move(options));
+                            })
+          .result());
+  EXPECT_EQ("abcdefghijkl", result.value);
+  EXPECT_EQ(StorageGeneration::FromString("h"), result.stamp.generation);
+  EXPECT_THAT(object.requests,
+              ::testing::ElementsAre(OptionalByteRangeRequest::Range(0, 4),
+                                     OptionalByteRangeRequest::Range(4, 8),
+                                     OptionalByteRangeRequest::Range(8, 12),
+                                     OptionalByteRangeRequest::Range(0, 12)));
+}
+
+TEST(ParallelByteRangeReadTest, PartError) {
+  FakeObject object;
+  ReadOptions options;
+  options.byte_range = OptionalByteRangeRequest::Range(20, 40);
+  EXPECT_THAT(ParallelByteRangeRead(options, 4,
+                                    [&](ReadOptions options) {
+                                      return object.Read(std::move(options));
+                                    })
+                  .result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+}
+
+}  // namespace
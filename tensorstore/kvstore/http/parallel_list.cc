@@ -0,0 +1,375 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/http/parallel_list.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
+
+namespace tensorstore {
+namespace internal_http {
+namespace {
+
+using ::tensorstore::internal::IntrusivePtr;
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListOptions;
+using ::tensorstore::kvstore::ListReceiver;
+
+/// Maximum number of levels of delimited prefixes that are expanded in order
+/// to obtain enough partitions.
+constexpr int kMaxExpansionDepth = 3;
+
+/// Part of the listed range.  The segments of a listing are in key order.
+struct Segment {
+  /// Keys of the partition.  Unused for a segment that holds a single key
+  /// returned by a delimited list request.
+  KeyRange range;
+
+  /// Indicates that `range` corresponds to a delimited prefix, and may be
+  /// expanded by another delimited list request.
+  bool expandable = false;
+
+  bool started = false;
+  bool done = false;
+
+  /// Keys received but not yet emitted.
+  std::vector<ListEntry> buffered;
+};
+
+struct ParallelListState
+    : public internal::AtomicReferenceCount<ParallelListState> {
+  ListOptions options_;
+  ListReceiver receiver_;
+  ListPageFunction list_page_;
+  ListRangeFunction list_range_;
+  std::atomic<bool> cancelled_{false};
+
+  // Only modified by `Expand` and `OnPages` prior to `StartListing`; after
+  // that, the members of each segment are guarded by `mutex_`.
+  std::vector<Segment> segments_;
+
+  absl::Mutex mutex_;
+  // Index of the next segment to consider starting.
+  size_t next_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Index of the first segment whose keys have not all been emitted, if
+  // `options_.ordered`.
+  size_t head_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t running_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t remaining_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+
+  absl::Mutex cancel_mutex_;
+  absl::flat_hash_map<size_t, AnyCancelReceiver> cancel_
+      ABSL_GUARDED_BY(cancel_mutex_);
+
+  ParallelListState(ListOptions options, ListReceiver receiver,
+                    ListPageFunction list_page, ListRangeFunction list_range)
+      : options_(std::move(options)),
+        receiver_(std::move(receiver)),
+        list_page_(std::move(list_page)),
+        list_range_(std::move(list_range)) {
+    options_.concurrency = std::max<size_t>(1, options_.concurrency);
+    segments_.push_back(Segment{options_.range, /*expandable=*/true});
+    execution::set_starting(receiver_, [this] { DoCancel(); });
+  }
+
+  ~ParallelListState() { execution::set_stopping(receiver_); }
+
+  void DoCancel() {
+    cancelled_ = true;
+    absl::MutexLock lock(&cancel_mutex_);
+    for (auto& [index, cancel] : cancel_) cancel();
+    cancel_.clear();
+  }
+
+  void SetCancel(size_t index, AnyCancelReceiver cancel) {
+    {
+      absl::MutexLock lock(&cancel_mutex_);
+      if (!cancelled_) {
+        cancel_.emplace(index, std::move(cancel));
+        return;
+      }
+    }
+    cancel();
+  }
+
+  void ClearCancel(size_t index) {
+    absl::MutexLock lock(&cancel_mutex_);
+    cancel_.erase(index);
+  }
+
+  void Fail(absl::Status status) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (finished_) return;
+      finished_ = true;
+      execution::set_error(receiver_, std::move(status));
+    }
+    DoCancel();
+  }
+
+  /// Expands the partitions with delimited prefixes until there are enough
+  /// of them, and then starts listing.
+  static void Expand(IntrusivePtr<ParallelListState> self, int depth) {
+    std::vector<size_t> to_expand;
+    size_t num_partitions = 0;
+    for (size_t i = 0; i < self->segments_.size(); ++i) {
+      const auto& segment = self->segments_[i];
+      if (segment.started) continue;
+      ++num_partitions;
+      if (segment.expandable) to_expand.push_back(i);
+    }
+    if (self->cancelled_ || depth == kMaxExpansionDepth ||
+        num_partitions >= self->options_.concurrency || to_expand.empty()) {
+      StartListing(std::move(self));
+      return;
+    }
+    std::vector<Future<DelimitedListPage>> pages;
+    pages.reserve(to_expand.size());
+    for (size_t i : to_expand) {
+      pages.push_back(self->list_page_(self->segments_[i].range));
+    }
+    auto all_ready = WaitAllFuture(span(pages));
+    all_ready.ExecuteWhenReady(
+        [self = std::move(self), depth, to_expand = std::move(to_expand),
+         pages = std::move(pages)](ReadyFuture<void> ready) mutable {
+          if (!ready.status().ok()) {
+            self->Fail(ready.status());
+            return;
+          }
+          self->OnPages(to_expand, pages);
+          Expand(std::move(self), depth + 1);
+        });
+  }
+
+  /// Replaces each segment `segments_[to_expand[i]]` with the segments
+  /// obtained from `pages[i]`.
+  void OnPages(span<const size_t> to_expand,
+               span<const Future<DelimitedListPage>> pages) {
+    std::vector<Segment> segments;
+    size_t k = 0;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+      if (k < to_expand.size() && to_expand[k] == i) {
+        AppendPage(segments_[i].range, pages[k].value(), segments);
+        ++k;
+      } else {
+        segments.push_back(std::move(segments_[i]));
+      }
+    }
+    segments_ = std::move(segments);
+  }
+
+  /// Appends segments for the keys and prefixes of `page` within `range`.
+  void AppendPage(const KeyRange& range, const DelimitedListPage& page,
+                  std::vector<Segment>& segments) {
+    // Lower bound of the keys that are not covered by `page`.
+    std::string rest_min = range.inclusive_min;
+    bool rest_unbounded = true;
+    auto entry_it = page.entries.begin();
+    auto prefix_it = page.prefixes.begin();
+    while (entry_it != page.entries.end() ||
+           prefix_it != page.prefixes.end()) {
+      if (prefix_it == page.prefixes.end() ||
+          (entry_it != page.entries.end() && entry_it->key < *prefix_it)) {
+        if (Contains(range, entry_it->key)) {
+          ListEntry entry = *entry_it;
+          entry.key.erase(0, std::min(options_.strip_prefix_length,
+                                      entry.key.size()));
+          Segment segment;
+          segment.started = true;
+          segment.done = true;
+          segment.buffered.push_back(std::move(entry));
+          segments.push_back(std::move(segment));
+        }
+        rest_min = KeyRange::Successor(entry_it->key);
+        ++entry_it;
+      } else {
+        auto partition = Intersect(KeyRange::Prefix(*prefix_it), range);
+        if (!partition.empty()) {
+          segments.push_back(Segment{std::move(partition),
+                                     /*expandable=*/true});
+        }
+        rest_min = KeyRange::PrefixExclusiveMax(*prefix_it);
+        // An empty `exclusive_max` indicates that there are no larger keys.
+        rest_unbounded = !rest_min.empty();
+        ++prefix_it;
+      }
+    }
+    if (!page.truncated || !rest_unbounded) return;
+    auto rest = Intersect(KeyRange(std::move(rest_min), ""), range);
+    if (!rest.empty()) {
+      segments.push_back(Segment{std::move(rest), /*expandable=*/false});
+    }
+  }
+
+  static void StartListing(IntrusivePtr<ParallelListState> self) {
+    std::vector<size_t> to_start;
+    {
+      absl::MutexLock lock(&self->mutex_);
+      for (const auto& segment : self->segments_) {
+        if (!segment.done) ++self->remaining_;
+      }
+      if (!self->options_.ordered) {
+        for (auto& segment : self->segments_) {
+          for (auto& entry : segment.buffered) {
+            self->EmitLocked(std::move(entry));
+          }
+          segment.buffered.clear();
+        }
+      }
+      self->FlushLocked();
+      self->StartPartitionsLocked(to_start);
+      self->MaybeFinishLocked();
+    }
+    for (size_t i : to_start) StartPartition(self, i);
+  }
+
+  struct PartitionReceiver;
+
+  static void StartPartition(IntrusivePtr<ParallelListState> self,
+                             size_t index);
+
+  void OnPartitionValue(size_t index, ListEntry entry) {
+    absl::MutexLock lock(&mutex_);
+    if (!options_.ordered || index == head_) {
+      EmitLocked(std::move(entry));
+    } else if (!finished_ && !cancelled_) {
+      segments_[index].buffered.push_back(std::move(entry));
+    }
+  }
+
+  static void OnPartitionStopping(IntrusivePtr<ParallelListState> self,
+                                  size_t index) {
+    self->ClearCancel(index);
+    std::vector<size_t> to_start;
+    {
+      absl::MutexLock lock(&self->mutex_);
+      --self->running_;
+      self->segments_[index].done = true;
+      --self->remaining_;
+      self->FlushLocked();
+      self->StartPartitionsLocked(to_start);
+      self->MaybeFinishLocked();
+    }
+    for (size_t i : to_start) StartPartition(self, i);
+  }
+
+  void EmitLocked(ListEntry entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (finished_ || cancelled_) return;
+    execution::set_value(receiver_, std::move(entry));
+  }
+
+  /// Emits the buffered keys of the segments starting at `head_`, up to the
+  /// first segment that is not done.
+  void FlushLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (!options_.ordered) return;
+    for (; head_ < segments_.size(); ++head_) {
+      auto& segment = segments_[head_];
+      for (auto& entry : segment.buffered) EmitLocked(std::move(entry));
+      segment.buffered.clear();
+      if (!segment.done) break;
+    }
+  }
+
+  void StartPartitionsLocked(std::vector<size_t>& to_start)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (finished_ || cancelled_) return;
+    for (; next_ < segments_.size() && running_ < options_.concurrency;
+         ++next_) {
+      auto& segment = segments_[next_];
+      if (segment.started) continue;
+      segment.started = true;
+      ++running_;
+      to_start.push_back(next_);
+    }
+  }
+
+  void MaybeFinishLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (finished_ || running_ != 0) return;
+    if (remaining_ != 0 && !cancelled_) return;
+    finished_ = true;
+    execution::set_done(receiver_);
+  }
+};
+
+/// Receiver for the listing of a single partition.
+struct ParallelListState::PartitionReceiver {
+  IntrusivePtr<ParallelListState> state;
+  size_t index;
+
+  [[maybe_unused]] friend void set_starting(PartitionReceiver& self,
+                                            AnyCancelReceiver cancel) {
+    self.state->SetCancel(self.index, std::move(cancel));
+  }
+
+  [[maybe_unused]] friend void set_value(PartitionReceiver& self,
+                                         ListEntry entry) {
+    self.state->OnPartitionValue(self.index, std::move(entry));
+  }
+
+  [[maybe_unused]] friend void set_done(PartitionReceiver& self) {
+    // Completion is handled by `set_stopping`.
+  }
+
+  [[maybe_unused]] friend void set_error(PartitionReceiver& self,
+                                         absl::Status status) {
+    self.state->Fail(std::move(status));
+  }
+
+  [[maybe_unused]] friend void set_stopping(PartitionReceiver& self) {
+    OnPartitionStopping(std::move(self.state), self.index);
+  }
+};
+
+void ParallelListState::StartPartition(IntrusivePtr<ParallelListState> self,
+                                       size_t index) {
+  ListOptions options = self->options_;
+  options.range = self->segments_[index].range;
+  options.concurrency = 1;
+  auto* state = self.get();
+  state->list_range_(std::move(options),
+                     PartitionReceiver{std::move(self), index});
+}
+
+}  // namespace
+
+void ParallelList(ListOptions options, ListReceiver receiver,
+                  ListPageFunction list_page, ListRangeFunction list_range) {
+  ParallelListState::Expand(
+      internal::MakeIntrusivePtr<ParallelListState>(
+          std::move(options), std::move(receiver), std::move(list_page),
+          std::move(list_range)),
+      /*depth=*/0);
+}
+
+}  // namespace internal_http
+}  // namespace tensorstore
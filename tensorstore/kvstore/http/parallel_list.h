@@ -0,0 +1,75 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_HTTP_PARALLEL_LIST_H_
+#define TENSORSTORE_KVSTORE_HTTP_PARALLEL_LIST_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_http {
+
+/// Single page of the keys with the prefix `LongestPrefix(range)`, listed
+/// using ``/`` as the delimiter.
+struct DelimitedListPage {
+  /// Keys that do not contain a ``/`` after the prefix, in increasing order.
+  /// Keys are not stripped.
+  std::vector<kvstore::ListEntry> entries;
+
+  /// Distinct prefixes, each ending in ``/``, of the remaining keys, in
+  /// increasing order.
+  std::vector<std::string> prefixes;
+
+  /// Indicates that `entries` and `prefixes` are only the first of several
+  /// pages of results.
+  bool truncated = false;
+};
+
+/// Function that issues a single delimited list request, used by
+/// `ParallelList`.
+///
+/// The returned page may include keys and prefixes outside of `range`, which
+/// are ignored.
+using ListPageFunction =
+    std::function<Future<DelimitedListPage>(KeyRange range)>;
+
+/// Function that lists `options.range` sequentially, used by `ParallelList`.
+using ListRangeFunction = std::function<void(kvstore::ListOptions options,
+                                             kvstore::ListReceiver receiver)>;
+
+/// Lists `options.range` by partitioning it at the delimited prefixes
+/// returned by `list_page`, and listing up to `options.concurrency` partitions
+/// concurrently using `list_range`.
+///
+/// Prefixes are expanded breadth-first, for at most a few levels, until there
+/// are at least `options.concurrency` partitions.  Only the first page of each
+/// delimited listing is used; any keys beyond it form a single additional
+/// partition.
+///
+/// If `options.ordered` is `true`, keys are emitted to `receiver` in the same
+/// order as by `list_range(options, receiver)`.
+void ParallelList(kvstore::ListOptions options, kvstore::ListReceiver receiver,
+                  ListPageFunction list_page, ListRangeFunction list_range);
+
+}  // namespace internal_http
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_HTTP_PARALLEL_LIST_H_
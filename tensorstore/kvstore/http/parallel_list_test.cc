@@ -0,0 +1,246 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/http/parallel_list.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/execution/sender_testutil.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::KeyRange;
+using ::tensorstore::LoggingReceiver;
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::internal_http::DelimitedListPage;
+using ::tensorstore::internal_http::ParallelList;
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListOptions;
+using ::tensorstore::kvstore::ListReceiver;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::UnorderedElementsAreArray;
+
+namespace execution = ::tensorstore::execution;
+
+/// In-memory object store which defers partition listings until `RunAll`.
+struct FakeStore {
+  std::map<std::string, int64_t> keys;
+  size_t page_size = 1000;
+  bool defer = true;
+  std::vector<std::string> page_prefixes;
+  std::vector<std::pair<ListOptions, ListReceiver>> pending;
+  size_t max_pending = 0;
+
+  Future<DelimitedListPage> ListPage(KeyRange range) {
+    std::string prefix(tensorstore::LongestPrefix(range));
+    page_prefixes.push_back(prefix);
+    DelimitedListPage page;
+    size_t count = 0;
+    for (auto it = keys.lower_bound(prefix);
+         it != keys.end() && absl::StartsWith(it->first, prefix);) {
+      if (count == page_size) {
+        page.truncated = true;
+        break;
+      }
+      ++count;
+      std::string_view suffix =
+          std::string_view(it->first).substr(prefix.size());
+      size_t pos = suffix.find('/');
+      if (pos == std::string_view::npos) {
+        page.entries.push_back(ListEntry{it->first, it->second});
+        ++it;
+        continue;
+      }
+      std::string common_prefix =
+          prefix + std::string(suffix.substr(0, pos + 1));
+      page.prefixes.push_back(common_prefix);
+      it = keys.lower_bound(KeyRange::PrefixExclusiveMax(common_prefix));
+    }
+    return MakeReadyFuture<DelimitedListPage>(std::move(page));
+  }
+
+  void ListRange(ListOptions options, ListReceiver receiver) {
+    if (!defer) {
+      Run(std::move(options), std::move(receiver));
+      return;
+    }
+    pending.emplace_back(std::move(options), std::move(receiver));
+    max_pending = std::max(max_pending, pending.size());
+  }
+
+  void Run(ListOptions options, ListReceiver receiver) {
+    execution::set_starting(receiver, [] {});
+    for (const auto& [key, size] : keys) {
+      if (!tensorstore::Contains(options.range, key)) continue;
+      execution::set_value(
+          receiver, ListEntry{key.substr(options.strip_prefix_length), size});
+    }
+    execution::set_done(receiver);
+    execution::set_stopping(receiver);
+  }
+
+  /// Runs the pending listings, most recently started first.
+  void RunAll() {
+    while (!pending.empty()) {
+      auto [options, receiver] = std::move(pending.back());
+      pending.pop_back();
+      Run(std::move(options), std::move(receiver));
+    }
+  }
+
+  std::vector<std::string> ExpectedLog(const ListOptions& options) {
+    std::vector<std::string> log{"set_starting"};
+    for (const auto& [key, size] : keys) {
+      if (!tensorstore::Contains(options.range, key)) continue;
+      log.push_back("set_value: " + key.substr(options.strip_prefix_length));
+    }
+    log.push_back("set_done");
+    log.push_back("set_stopping");
+    return log;
+  }
+
+  void List(ListOptions options, std::vector<std::string>* log) {
+    ParallelList(
+        std::move(options), LoggingReceiver{log},
+        [this](KeyRange range) { return ListPage(std::move(range)); },
+        [this](ListOptions options, ListReceiver receiver) {
+          ListRange(std::move(options), std::move(receiver));
+        });
+  }
+};
+
+FakeStore MakeChunkStore() {
+  FakeStore store;
+  store.keys["a/.zarray"] = 10;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      store.keys[tensorstore::StrCat("a/c/", i, "/", j)] = i * 10 + j;
+    }
+  }
+  store.keys["a/zarr.json"] = 20;
+  store.keys["b"] = 30;
+  return store;
+}
+
+TEST(ParallelListTest, Ordered) {
+  auto store = MakeChunkStore();
+  ListOptions options;
+  options.range = KeyRange::Prefix("a/");
+  options.concurrency = 3;
+  std::vector<std::string> log;
+  store.List(options, &log);
+  // "a/" has the single prefix "a/c/", which is expanded.
+  EXPECT_THAT(store.page_prefixes, ElementsAre("a/", "a/c/"));
+  EXPECT_EQ(3, store.max_pending);
+  store.RunAll();
+  EXPECT_THAT(log, ElementsAreArray(store.ExpectedLog(options)));
+}
+
+TEST(ParallelListTest, Unordered) {
+  auto store = MakeChunkStore();
+  ListOptions options;
+  options.concurrency = 8;
+  options.ordered = false;
+  std::vector<std::string> log;
+  store.List(options, &log);
+  store.RunAll();
+  auto expected = store.ExpectedLog(options);
+  ASSERT_EQ(expected.size(), log.size());
+  EXPECT_EQ("set_starting", log.front());
+  EXPECT_EQ("set_done", log[log.size() - 2]);
+  EXPECT_THAT((std::vector<std::string>(log.begin() + 1, log.end() - 2)),
+              UnorderedElementsAreArray(expected.begin() + 1,
+                                        expected.end() - 2));
+}
+
+TEST(ParallelListTest, TruncatedPages) {
+  auto store = MakeChunkStore();
+  store.page_size = 2;
+  store.defer = false;
+  ListOptions options;
+  options.range = KeyRange(std::string("a/.zarray"), std::string("a/c/3/2"));
+  options.strip_prefix_length = 2;
+  options.concurrency = 16;
+  std::vector<std::string> log;
+  store.List(options, &log);
+  EXPECT_THAT(log, ElementsAreArray(store.ExpectedLog(options)));
+}
+
+TEST(ParallelListTest, FlatKeys) {
+  FakeStore store;
+  for (int i = 0; i < 10; ++i) store.keys[tensorstore::StrCat("k", i)] = i;
+  store.page_size = 4;
+  ListOptions options;
+  options.concurrency = 4;
+  std::vector<std::string> log;
+  store.List(options, &log);
+  // The keys beyond the first page are listed by a single partition.
+  EXPECT_EQ(1, store.max_pending);
+  store.RunAll();
+  EXPECT_THAT(log, ElementsAreArray(store.ExpectedLog(options)));
+}
+
+TEST(ParallelListTest, PageError) {
+  std::vector<std::string> log;
+  ListOptions options;
+  options.concurrency = 4;
+  ParallelList(
+      options, LoggingReceiver{&log},
+      [](KeyRange range) {
+        return MakeReadyFuture<DelimitedListPage>(
+            absl::UnknownError("list failed"));
+      },
+      [](ListOptions options, ListReceiver receiver) { FAIL(); });
+  EXPECT_THAT(log,
+              ElementsAre("set_starting", "set_error: UNKNOWN: list failed",
+                          "set_stopping"));
+}
+
+TEST(ParallelListTest, CancelStopsListing) {
+  auto store = MakeChunkStore();
+  ListOptions options;
+  options.concurrency = 2;
+  std::vector<std::string> log;
+  ParallelList(
+      options, tensorstore::CancelAfterNReceiver<3>{{&log}},
+      [&](KeyRange range) { return store.ListPage(std::move(range)); },
+      [&](ListOptions options, ListReceiver receiver) {
+        store.ListRange(std::move(options), std::move(receiver));
+      });
+  store.RunAll();
+  EXPECT_THAT(log, ElementsAre("set_starting", "set_value: a/.zarray",
+                               "set_value: a/c/0/0", "set_done",
+                               "set_stopping"));
+}
+
+}  // namespace
@@ -37,6 +37,7 @@
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -82,6 +83,8 @@ using ::tensorstore::kvstore::ListReceiver;
 using ::tensorstore::kvstore::ReadResult;
 using ::tensorstore::kvstore::SupportedFeatures;
 
+auto kvstack_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(kvstack);
+
 // -----------------------------------------------------------------------------
 
 constexpr auto KvStackLayerJsonBinder() {
@@ -346,7 +349,9 @@ Future<ReadResult> KvStack::Read(Key key, ReadOptions options) {
     return ReadResult::Missing(absl::InfiniteFuture());
   }
   key = key.substr(it->value.strip_prefix_length);
-  return kvstore::Read(it->value.kvstore, std::move(key), std::move(options));
+  return internal_kvstore::RecordReadMetrics(
+      kvstack_metrics,
+      kvstore::Read(it->value.kvstore, std::move(key), std::move(options)));
 }
 
 Future<TimestampedStorageGeneration> KvStack::Write(Key key,
@@ -358,8 +363,11 @@ Future<TimestampedStorageGeneration> KvStack::Write(Key key,
         tensorstore::StrCat("Key not found in any layers: ", QuoteString(key)));
   }
   key = key.substr(it->value.strip_prefix_length);
-  return kvstore::Write(it->value.kvstore, std::move(key), std::move(value),
-                        std::move(options));
+  if (value) kvstack_metrics.bytes_written.IncrementBy(value->size());
+  return internal_kvstore::RecordWriteMetrics(
+      kvstack_metrics,
+      kvstore::Write(it->value.kvstore, std::move(key), std::move(value),
+                     std::move(options)));
 }
 
 Future<const void> KvStack::DeleteRange(KeyRange range) {
@@ -409,29 +417,43 @@ Future<const void> KvStack::ExperimentalCopyRangeFrom(
   return WaitAllFuture(tensorstore::span(copy_futures));
 }
 
-// ListReceiver which issues kvstore::List requests in order.
+// Implements KvStack::List.
+//
+// The intersecting layers are listed concurrently.  Entries are emitted in
+// layer order, so that the listing proceeds in the same order as if the
+// layers were listed sequentially: entries from the first layer which has not
+// yet completed are forwarded directly, while entries from subsequent layers
+// are buffered until all preceding layers have completed.
 struct KvStackListState final
     : public internal::AtomicReferenceCount<KvStackListState> {
-  using Self = internal::IntrusivePtr<KvStackListState>;
-
   struct V {
     KeyRange range;
     kvstore::KvStore kvstore;
     std::string prefix_to_add;
+
+    // Entries received before the preceding layers have completed.
+    std::vector<ListEntry> buffered;
+    bool done = false;
   };
 
   ListOptions options_;
   ListReceiver receiver_;
   std::vector<V> ranges_;
-  std::atomic<size_t> pos_{0};
 
-  absl::Mutex mutex_;
-  std::optional<AnyCancelReceiver> cancel_ ABSL_GUARDED_BY(mutex_);
+  std::atomic<bool> cancelled_{false};
+
+  // Serializes calls to `receiver_`.  Acquired before `cancel_mutex_`, and
+  // never held while acquiring `cancel_mutex_` for cancellation, since
+  // `receiver_` may request cancellation from within `set_value`.
+  absl::Mutex emit_mutex_;
+  size_t current_ ABSL_GUARDED_BY(emit_mutex_) = 0;
+  bool finished_ ABSL_GUARDED_BY(emit_mutex_) = false;
+
+  absl::Mutex cancel_mutex_;
+  std::vector<AnyCancelReceiver> cancel_ ABSL_GUARDED_BY(cancel_mutex_);
 
   KvStackListState(KvStack& driver, ListOptions options, ListReceiver receiver)
       : options_(std::move(options)), receiver_(std::move(receiver)) {
-    // Note that List doesn't guarantee any particular order so it would be
-    // fine to list all intersecting layers.
     driver.layers_.VisitRange(
         options_.range, [this](KeyRange intersect, auto& mapped) {
           std::string prefix_to_add =
@@ -448,21 +470,71 @@ struct KvStackListState final
   ~KvStackListState() { execution::set_stopping(receiver_); }
 
   void SetCancel(AnyCancelReceiver cancel) {
-    absl::MutexLock lock(&mutex_);
-    cancel_ = std::move(cancel);
+    {
+      absl::MutexLock lock(&cancel_mutex_);
+      if (!cancelled_) {
+        cancel_.push_back(std::move(cancel));
+        return;
+      }
+    }
+    cancel();
   }
 
   void DoCancel() {
-    absl::MutexLock lock(&mutex_);
-    if (cancel_) (*cancel_)();
-    cancel_ = std::nullopt;
-    pos_ = ranges_.size();
+    std::vector<AnyCancelReceiver> cancel;
+    {
+      absl::MutexLock lock(&cancel_mutex_);
+      if (cancelled_.exchange(true)) return;
+      cancel.swap(cancel_);
+    }
+    for (auto& c : cancel) c();
+  }
+
+  void SetValue(size_t idx, ListEntry entry) {
+    auto& v = ranges_[idx];
+    if (!v.prefix_to_add.empty()) {
+      entry.key = tensorstore::StrCat(v.prefix_to_add, entry.key);
+    }
+    absl::MutexLock lock(&emit_mutex_);
+    if (finished_ || cancelled_) return;
+    if (idx != current_) {
+      v.buffered.push_back(std::move(entry));
+      return;
+    }
+    execution::set_value(receiver_, std::move(entry));
   }
 
-  /// AnyFlowReceiver implementation.
+  void SetDone(size_t idx) {
+    absl::MutexLock lock(&emit_mutex_);
+    ranges_[idx].done = true;
+    while (current_ < ranges_.size() && ranges_[current_].done) {
+      if (++current_ == ranges_.size()) break;
+      auto buffered = std::exchange(ranges_[current_].buffered, {});
+      if (finished_ || cancelled_) continue;
+      for (auto& entry : buffered) {
+        execution::set_value(receiver_, std::move(entry));
+      }
+    }
+    if (current_ == ranges_.size() && !finished_) {
+      finished_ = true;
+      execution::set_done(receiver_);
+    }
+  }
+
+  void SetError(absl::Status status) {
+    {
+      absl::MutexLock lock(&emit_mutex_);
+      if (finished_) return;
+      finished_ = true;
+      execution::set_error(receiver_, std::move(status));
+    }
+    DoCancel();
+  }
+
+  /// AnyFlowReceiver implementation for the listing of `state->ranges_[idx]`.
   struct Receiver {
     IntrusivePtr<KvStackListState> state;
-    V* v;
+    size_t idx;
 
     /// AnyFlowReceiver methods.
     [[maybe_unused]] friend void set_starting(Receiver& self,
@@ -471,51 +543,42 @@ struct KvStackListState final
     }
 
     [[maybe_unused]] friend void set_value(Receiver& self, ListEntry entry) {
-      if (!self.v->prefix_to_add.empty()) {
-        entry.key = tensorstore::StrCat(self.v->prefix_to_add, entry.key);
-      }
-      execution::set_value(self.state->receiver_, std::move(entry));
+      self.state->SetValue(self.idx, std::move(entry));
     }
 
     [[maybe_unused]] friend void set_done(Receiver& self) {
-      // set_done is not propagated; StartNextRange handles it on the
-      // last range instead of starting a new range.
+      self.state->SetDone(self.idx);
     }
 
     [[maybe_unused]] friend void set_error(Receiver& self, absl::Status s) {
-      execution::set_error(self.state->receiver_, std::move(s));
-      self.v = nullptr;
+      self.state->SetError(std::move(s));
     }
 
     [[maybe_unused]] friend void set_stopping(Receiver& self) {
-      auto* state = self.state.get();
-      if (self.v) state->StartNextRange(std::move(self.state));
+      self.state.reset();
     }
   };
 
-  static void StartNextRange(internal::IntrusivePtr<KvStackListState> state) {
-    size_t idx;
-    {
-      absl::MutexLock lock(&state->mutex_);
-      state->cancel_ = std::nullopt;
-      idx = state->pos_.fetch_add(1);
+  static void Start(IntrusivePtr<KvStackListState> state) {
+    if (state->ranges_.empty()) {
+      absl::MutexLock lock(&state->emit_mutex_);
+      state->finished_ = true;
+      execution::set_done(state->receiver_);
+      return;
     }
-    if (idx < state->ranges_.size()) {
-      auto& v = state->ranges_[idx];
+    for (size_t i = 0; i < state->ranges_.size(); ++i) {
+      auto& v = state->ranges_[i];
       ListOptions options = state->options_;
       options.range = v.range;
-      kvstore::List(v.kvstore, std::move(options),
-                    Receiver{std::move(state), &v});
-    } else if (idx == state->ranges_.size()) {
-      execution::set_done(state->receiver_);
+      kvstore::List(v.kvstore, std::move(options), Receiver{state, i});
     }
   }
 };
 
 void KvStack::ListImpl(ListOptions options, ListReceiver receiver) {
-  // Ownership of the pointer is transferred to the kvstore::List calls via
-  // the sequence of StartNextRange() calls.
-  KvStackListState::StartNextRange(internal::MakeIntrusivePtr<KvStackListState>(
+  // Ownership of the state is shared by the kvstore::List calls, one for each
+  // layer, which are issued concurrently.
+  KvStackListState::Start(internal::MakeIntrusivePtr<KvStackListState>(
       *this, std::move(options), std::move(receiver)));
 }
 
@@ -13,17 +13,21 @@
 // limitations under the License.
 
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/time.h"
 #include <nlohmann/json_fwd.hpp>
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/kvs_backed_cache_testutil.h"
 #include "tensorstore/internal/global_initializer.h"
+#include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -33,6 +37,7 @@
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
@@ -56,6 +61,29 @@ class KvStackTest : public ::testing::Test {
  public:
   KvStackTest() : context_(Context::Default()) {}
 
+  // Opens a kvstack with two layers on the mock kvstore, such that the range
+  // `["a", "b")` maps to "prefix/" and all other keys map to "base/".
+  Result<KvStore> MockKvStoreOpen() const {
+    return kvstore::Open(
+               {{"driver", "kvstack"},
+                {"layers",
+                 ::nlohmann::json::array_t{
+                     {
+                         {"base",
+                          {{"driver", "mock_key_value_store"},
+                           {"path", "base/"}}},
+                     },
+                     {
+                         {"base",
+                          {{"driver", "mock_key_value_store"},
+                           {"path", "prefix/"}}},
+                         {"prefix", "a"},
+                     },
+                 }}},
+               context_)
+        .result();
+  }
+
   Result<KvStore> KvStoreOpen() const {
     return kvstore::Open(
                {{"driver", "kvstack"},
@@ -115,6 +143,115 @@ TEST_F(KvStackTest, List) {
   tensorstore::internal::TestKeyValueStoreList(store);
 }
 
+TEST_F(KvStackTest, ListConcurrentWithMock) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context_.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore *mock_store = mock_key_value_store_resource->get();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, MockKvStoreOpen());
+
+  auto list_future = kvstore::ListFuture(store);
+
+  // The three intersecting ranges are listed concurrently.
+  ASSERT_THAT(mock_store->list_requests.size(), ::testing::Eq(3));
+  std::vector<MockKeyValueStore::ListRequest> requests;
+  for (int i = 0; i < 3; ++i) {
+    requests.push_back(mock_store->list_requests.pop());
+  }
+
+  // Completing the listings in reverse order still yields entries in layer
+  // order.
+  for (int i = 2; i >= 0; --i) {
+    auto &receiver = requests[i].receiver;
+    tensorstore::execution::set_starting(receiver, [] {});
+    tensorstore::execution::set_value(
+        receiver, kvstore::ListEntry{absl::StrFormat("key%d", i), 1});
+    tensorstore::execution::set_done(receiver);
+    tensorstore::execution::set_stopping(receiver);
+    if (i > 0) EXPECT_FALSE(list_future.ready());
+  }
+
+  ASSERT_TRUE(list_future.ready());
+  EXPECT_THAT(list_future.result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesListEntry("key0"), MatchesListEntry("key1"),
+                  MatchesListEntry("key2"))));
+}
+
+TEST_F(KvStackTest, ListErrorWithMock) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context_.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore *mock_store = mock_key_value_store_resource->get();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, MockKvStoreOpen());
+
+  auto list_future = kvstore::ListFuture(store);
+  ASSERT_THAT(mock_store->list_requests.size(), ::testing::Eq(3));
+  std::vector<MockKeyValueStore::ListRequest> requests;
+  for (int i = 0; i < 3; ++i) {
+    requests.push_back(mock_store->list_requests.pop());
+  }
+
+  // An error from any layer cancels the remaining layers.
+  bool cancelled = false;
+  tensorstore::execution::set_starting(requests[0].receiver,
+                                       [&] { cancelled = true; });
+  tensorstore::execution::set_starting(requests[1].receiver, [] {});
+  tensorstore::execution::set_error(requests[1].receiver,
+                                    absl::UnknownError("layer error"));
+  tensorstore::execution::set_stopping(requests[1].receiver);
+  EXPECT_TRUE(cancelled);
+
+  tensorstore::execution::set_done(requests[0].receiver);
+  tensorstore::execution::set_stopping(requests[0].receiver);
+  tensorstore::execution::set_starting(requests[2].receiver, [] {});
+  tensorstore::execution::set_done(requests[2].receiver);
+  tensorstore::execution::set_stopping(requests[2].receiver);
+
+  ASSERT_TRUE(list_future.ready());
+  EXPECT_THAT(list_future.result(),
+              StatusIs(absl::StatusCode::kUnknown, "layer error"));
+}
+
+TEST_F(KvStackTest, BatchReadWithMock) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_key_value_store_resource,
+      context_.GetResource<MockKeyValueStoreResource>());
+  MockKeyValueStore *mock_store = mock_key_value_store_resource->get();
+  mock_store->handle_batch_requests = true;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store, MockKvStoreOpen());
+
+  // Reads of keys in different layers which specify the same batch are
+  // deferred until the batch is submitted.
+  std::vector<tensorstore::Future<kvstore::ReadResult>> futures;
+  {
+    auto batch = tensorstore::Batch::New();
+    for (const char *key : {"a/x", "b", "a/y", "c"}) {
+      kvstore::ReadOptions options;
+      options.batch = batch;
+      futures.push_back(kvstore::Read(store, key, std::move(options)));
+    }
+    EXPECT_EQ(0, mock_store->batch_read_requests.size());
+  }
+
+  std::vector<std::string> keys;
+  while (!mock_store->batch_read_requests.empty()) {
+    auto req = mock_store->batch_read_requests.pop();
+    keys.push_back(req.key);
+    for (auto &request : req.request_batch.requests) {
+      std::get<tensorstore::internal_kvstore_batch::ByteRangeReadRequest>(
+          request)
+          .promise.SetResult(
+              kvstore::ReadResult::Missing(absl::InfiniteFuture()));
+    }
+  }
+  EXPECT_THAT(keys, ::testing::UnorderedElementsAre("prefix/a/x", "base/b",
+                                                    "prefix/a/y", "base/c"));
+  for (auto &future : futures) {
+    EXPECT_THAT(future.result(), MatchesKvsReadResultNotFound());
+  }
+}
+
 TEST_F(KvStackTest, PrefixCheck) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto base, kvstore::Open({{"driver", "memory"}}, context_).result());
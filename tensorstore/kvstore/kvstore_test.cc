@@ -12,11 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "tensorstore/context.h"
 #include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/operations.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
@@ -36,4 +40,14 @@ TEST(KeyValueStoreTest, OpenInvalid) {
                             "\"invalid\" is not registered"));
 }
 
+TEST(KeyValueStoreTest, Prefetch) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "memory"}}, context).result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("value")));
+  const std::string keys[] = {"a", "missing"};
+  TENSORSTORE_EXPECT_OK(kvstore::Prefetch(store, keys).result());
+  TENSORSTORE_EXPECT_OK(kvstore::Prefetch(store, {}).result());
+}
+
 }  // namespace
@@ -20,14 +20,18 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
@@ -36,15 +40,18 @@
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
-#include "tensorstore/internal/mutex.h"
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/internal/uri_utils.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
@@ -52,10 +59,13 @@
 #include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/transaction.h"
 #include "tensorstore/kvstore/url_registry.h"
+#include "tensorstore/serialization/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/garbage_collection/std_optional.h"  // IWYU pragma: keep
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -67,7 +77,10 @@ namespace jb = tensorstore::internal_json_binding;
 using ::tensorstore::internal_kvstore::DeleteRangeEntry;
 using ::tensorstore::internal_kvstore::kReadModifyWrite;
 using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListReceiver;
 using ::tensorstore::kvstore::ReadResult;
+
+auto memory_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(memory);
 using ::tensorstore::kvstore::SupportedFeatures;
 
 TimestampedStorageGeneration GenerationNow(StorageGeneration generation) {
@@ -85,35 +98,234 @@ TimestampedStorageGeneration GenerationNow(StorageGeneration generation) {
 struct StoredKeyValuePairs
     : public internal::AtomicReferenceCount<StoredKeyValuePairs> {
   using Ptr = internal::IntrusivePtr<StoredKeyValuePairs>;
+
+  /// State of a stored value in write-back mode (see `Writeback`).  Stores
+  /// that are not in write-back mode only contain `kDirty` values.
+  enum class ValueState : uint8_t {
+    /// The value is held in memory, and has not been written to the base
+    /// kvstore.
+    kDirty,
+    /// The value has been evicted from memory, and is stored only in the base
+    /// kvstore, with a generation of `base_generation`.
+    kSpilled,
+    /// The key has been deleted, but the deletion may not yet have been
+    /// applied to the base kvstore.
+    kDeleted,
+  };
+
   struct ValueWithGenerationNumber {
     absl::Cord value;
     uint64_t generation_number;
+    ValueState state = ValueState::kDirty;
+
+    /// Indicates that the value (or deletion) with `generation_number` is
+    /// being written to the base kvstore.  Entries are not erased while a
+    /// write back is in progress.
+    bool writeback_in_progress = false;
+
+    /// Indicates that the value was accessed since it was last considered for
+    /// eviction.
+    bool referenced = false;
+
+    /// Generation of the value in the base kvstore, valid if
+    /// `state == ValueState::kSpilled`.
+    StorageGeneration base_generation;
+
     StorageGeneration generation() const {
+      if (state == ValueState::kDeleted) return StorageGeneration::NoValue();
       return StorageGeneration::FromUint64(generation_number);
     }
   };
 
   using Map = absl::btree_map<std::string, ValueWithGenerationNumber>;
-  std::pair<Map::iterator, Map::iterator> Find(const std::string& inclusive_min,
-                                               const std::string& exclusive_max)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex) {
-    return {values.lower_bound(inclusive_min),
-            exclusive_max.empty() ? values.end()
-                                  : values.lower_bound(exclusive_max)};
+
+  /// Keys are partitioned by hash across independently locked shards, so that
+  /// concurrent operations on different keys rarely contend.  Operations that
+  /// may affect more than one key (`List`, `DeleteRange` and atomic
+  /// transactions) lock all of the shards they access, in increasing index
+  /// order, and therefore remain atomic.
+  static constexpr size_t kNumShards = 64;
+  using ShardMask = uint64_t;
+  static_assert(kNumShards <= sizeof(ShardMask) * 8);
+  static constexpr ShardMask kAllShards = ~ShardMask{0};
+
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    std::pair<Map::iterator, Map::iterator> Find(
+        const std::string& inclusive_min, const std::string& exclusive_max)
+        ABSL_SHARED_LOCKS_REQUIRED(mutex) {
+      return {values.lower_bound(inclusive_min),
+              exclusive_max.empty() ? values.end()
+                                    : values.lower_bound(exclusive_max)};
+    }
+
+    std::pair<Map::iterator, Map::iterator> Find(const KeyRange& range)
+        ABSL_SHARED_LOCKS_REQUIRED(mutex) {
+      return Find(range.inclusive_min, range.exclusive_max);
+    }
+
+    absl::Mutex mutex;
+    Map values ABSL_GUARDED_BY(mutex);
+
+    /// Key at which the next eviction scan of `values` starts.
+    std::string eviction_position ABSL_GUARDED_BY(mutex);
+  };
+
+  static size_t GetShardIndex(std::string_view key) {
+    return absl::HashOf(key) % kNumShards;
+  }
+
+  Shard& GetShard(std::string_view key) { return shards[GetShardIndex(key)]; }
+
+  /// Acquires exclusive locks on the shards in `mask`.
+  void LockShards(ShardMask mask) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = 0; i < kNumShards; ++i) {
+      if (mask & (ShardMask{1} << i)) shards[i].mutex.Lock();
+    }
+  }
+
+  /// Releases the locks acquired by `LockShards(mask)`.
+  void UnlockShards(ShardMask mask) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = 0; i < kNumShards; ++i) {
+      if (mask & (ShardMask{1} << i)) shards[i].mutex.Unlock();
+    }
+  }
+
+  uint64_t NextGenerationNumber() {
+    return next_generation_number.fetch_add(1, std::memory_order_relaxed);
   }
 
-  std::pair<Map::iterator, Map::iterator> Find(const KeyRange& range)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex) {
-    return Find(range.inclusive_min, range.exclusive_max);
+  /// State of the write-back mode, in which the store acts as a bounded
+  /// write-back buffer in front of a base kvstore.
+  ///
+  /// Values are held in memory until the total size of the values in memory
+  /// exceeds `max_bytes`, at which point approximately least-recently used
+  /// values are written to the base kvstore and then evicted from memory.
+  /// Deletions are applied to the base kvstore immediately.  Keys that are not
+  /// in memory are read through from the base kvstore.
+  ///
+  /// Evicted values retain an entry that records their generation number, so
+  /// that the generations returned by this store remain valid conditions for
+  /// subsequent reads and writes.  The base kvstore must not be modified by
+  /// other means.
+  struct Writeback {
+    kvstore::KvStore base;
+    int64_t max_bytes;
+
+    /// Total size of the values held in memory.
+    std::atomic<int64_t> resident_bytes{0};
+
+    /// Total size of the values being written to the base kvstore.
+    std::atomic<int64_t> writeback_bytes{0};
+
+    /// Shard from which the next value is evicted.
+    std::atomic<size_t> next_eviction_shard{0};
+
+    absl::Mutex mutex;
+
+    /// Ranges for which a `DeleteRange` request on the base kvstore is in
+    /// progress.  Keys in these ranges are not read from, or written to, the
+    /// base kvstore until the request completes, since the order in which
+    /// the requests are applied is unspecified.
+    std::vector<KeyRange> pending_delete_ranges ABSL_GUARDED_BY(mutex);
+  };
+
+  /// Returns the write-back state, or `nullptr` if the store is not in
+  /// write-back mode.
+  Writeback* writeback() const {
+    return writeback_.load(std::memory_order_acquire);
   }
 
-  absl::Mutex mutex;
+  /// Puts the store into write-back mode with the specified `base` kvstore.
+  ///
+  /// \error `absl::StatusCode::kFailedPrecondition` if the store is already
+  ///     in write-back mode with a different `base` or `max_bytes`.
+  absl::Status EnableWriteback(kvstore::KvStore base,
+                               std::optional<uint64_t> max_bytes);
+
+  /// Write to the base kvstore, obtained by `BeginWriteback`.
+  struct PendingWriteback {
+    std::string key;
+    std::optional<absl::Cord> value;
+    uint64_t generation_number;
+  };
+  using PendingWritebacks = std::vector<PendingWriteback>;
+
+  // The functions below implement the driver operations in write-back mode.
+  Future<ReadResult> WritebackRead(kvstore::Key key,
+                                   kvstore::ReadOptions options);
+  Future<TimestampedStorageGeneration> WritebackWrite(
+      kvstore::Key key, std::optional<kvstore::Value> value,
+      kvstore::WriteOptions options, bool checked_base = false);
+
+  /// Applies a write to the entry for `key`.  Returns `std::nullopt` if the
+  /// write is conditioned on `key` not existing, and the base kvstore must be
+  /// checked first.  The entries for which a write back was started are added
+  /// to `pending`.
+  std::optional<TimestampedStorageGeneration> WritebackWriteEntry(
+      kvstore::Key& key, std::optional<kvstore::Value>& value,
+      const kvstore::WriteOptions& options, bool checked_base,
+      PendingWritebacks& pending);
+  Future<const void> WritebackDeleteRange(KeyRange range);
+  void WritebackList(kvstore::ListOptions options, ListReceiver receiver);
+
+  /// Starts writing the entry `it` of `shard` to the base kvstore.  The write
+  /// is added to `pending`, and must be issued by `IssueWritebacks` after
+  /// `shard.mutex` is released.
+  void BeginWriteback(Shard& shard, Map::iterator it,
+                      PendingWritebacks& pending)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+  /// Issues the writes obtained by `BeginWriteback`.
+  void IssueWritebacks(PendingWritebacks pending);
+
+  /// Completes a write to the base kvstore started by `BeginWriteback`.
+  void WritebackDone(std::string key, uint64_t generation_number,
+                     int64_t size,
+                     const Result<TimestampedStorageGeneration>& result);
+
+  /// Evicts values until the values held in memory are within the
+  /// `max_bytes` limit, or no more values can be evicted.
+  void MaybeEvict();
+
+  /// Evicts the next value of `shard`, using the "clock" approximation of
+  /// least-recently used order.  Returns `false` if no value of `shard` can
+  /// be evicted.
+  bool Evict(Shard& shard, PendingWritebacks& pending)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+  /// Indicates if the size of the values held in memory, excluding values
+  /// being written back, exceeds `max_bytes`.
+  bool OverBudget() const {
+    auto& wb = *writeback();
+    return wb.resident_bytes.load(std::memory_order_relaxed) -
+               wb.writeback_bytes.load(std::memory_order_relaxed) >
+           wb.max_bytes;
+  }
+
+  /// Indicates if `key` is in one of the `pending_delete_ranges`.
+  bool InPendingDeleteRange(std::string_view key);
+
+  /// Adds an entry, with a new generation number, for a value stored in the
+  /// base kvstore under `key` with `base_generation`, if `key` has no entry.
+  void AddSpilledEntry(const std::string& key,
+                       StorageGeneration base_generation);
+
+  /// Erases the entry for the evicted value of `key` with
+  /// `generation_number`, after the value in the base kvstore was found to
+  /// have changed.
+  void ForgetSpilledEntry(const std::string& key, uint64_t generation_number);
+
   /// Next generation number to use when updating the value associated with a
   /// key.  Using a single per-store counter rather than a per-key counter
   /// ensures that creating a key, deleting it, then creating it again does
   /// not result in the same generation number being reused for a given key.
-  uint64_t next_generation_number ABSL_GUARDED_BY(mutex) = 0;
-  Map values ABSL_GUARDED_BY(mutex);
+  std::atomic<uint64_t> next_generation_number{0};
+  Shard shards[kNumShards];
+
+  absl::Mutex writeback_mutex_;
+  std::unique_ptr<Writeback> writeback_storage_
+      ABSL_GUARDED_BY(writeback_mutex_);
+  std::atomic<Writeback*> writeback_{nullptr};
 };
 
 /// Defines the context resource (see `tensorstore/context.h`) that actually
@@ -144,11 +356,18 @@ struct MemoryDriverSpecData {
 
   bool atomic = true;
 
+  /// Base kvstore to which values are written back, see
+  /// `StoredKeyValuePairs::Writeback`.
+  std::optional<kvstore::Spec> base;
+
+  /// Maximum total size of the values held in memory in write-back mode.
+  std::optional<uint64_t> max_bytes;
+
   /// Make this type compatible with `tensorstore::ApplyMembers`.
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     // `x` is a reference to a `SpecData` object.  This function must invoke
     // `f` with a reference to each member of `x`.
-    return f(x.memory_key_value_store, x.atomic);
+    return f(x.memory_key_value_store, x.atomic, x.base, x.max_bytes);
   };
 
   /// Must specify a JSON binder.
@@ -157,7 +376,18 @@ struct MemoryDriverSpecData {
           MemoryKeyValueStoreResource::id,
           jb::Projection<&MemoryDriverSpecData::memory_key_value_store>()),
       jb::Member("atomic", jb::Projection<&MemoryDriverSpecData::atomic>(
-                               jb::DefaultValue([](auto* y) { *y = true; }))));
+                               jb::DefaultValue([](auto* y) { *y = true; }))),
+      jb::Member("base", jb::Projection<&MemoryDriverSpecData::base>()),
+      jb::Member("max_bytes",
+                 jb::Projection<&MemoryDriverSpecData::max_bytes>(
+                     jb::Optional(jb::Integer<uint64_t>(1)))),
+      jb::Initialize([](auto* obj) -> absl::Status {
+        if (obj->max_bytes && !obj->base) {
+          return absl::InvalidArgumentError(
+              "\"max_bytes\" requires \"base\" to be specified");
+        }
+        return absl::OkStatus();
+      }));
 };
 
 class MemoryDriverSpec
@@ -188,6 +418,11 @@ class MemoryDriver
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
+  Result<ReadResult> ReadImpl(Key key, ReadOptions options);
+
+  TimestampedStorageGeneration WriteImpl(Key key, std::optional<Value> value,
+                                         WriteOptions options);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
@@ -220,8 +455,14 @@ class MemoryDriver
 
   SupportedFeatures GetSupportedFeatures(
       const KeyRange& key_range) const final {
-    return SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-           SupportedFeatures::kAtomicWriteWithoutOverwrite;
+    auto features = SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
+                    SupportedFeatures::kAtomicWriteWithoutOverwrite;
+    // Keys stored only in the base kvstore of a writeback store are listed
+    // without generations.
+    if (!(**spec_.memory_key_value_store).writeback()) {
+      features = features | SupportedFeatures::kListGenerations;
+    }
+    return features;
   }
 
   /// In simple cases, such as the "memory" driver, the `Driver` can simply
@@ -232,7 +473,21 @@ class MemoryDriver
 Future<kvstore::DriverPtr> MemoryDriverSpec::DoOpen() const {
   auto driver = internal::MakeIntrusivePtr<MemoryDriver>();
   driver->spec_ = data_;
-  return driver;
+  if (!data_.base) return driver;
+  return MapFutureValue(
+      InlineExecutor{},
+      [driver = std::move(driver)](
+          kvstore::KvStore& base) -> Result<kvstore::DriverPtr> {
+        if (auto* base_driver = dynamic_cast<MemoryDriver*>(base.driver.get());
+            base_driver && &base_driver->data() == &driver->data()) {
+          return absl::InvalidArgumentError(
+              "\"base\" must not refer to the same memory_key_value_store");
+        }
+        TENSORSTORE_RETURN_IF_ERROR(driver->data().EnableWriteback(
+            std::move(base), driver->spec_.max_bytes));
+        return driver;
+      },
+      kvstore::Open(*data_.base));
 }
 
 using BufferedReadModifyWriteEntry =
@@ -247,8 +502,8 @@ class MemoryDriver::TransactionNode
 
   /// Commits a (possibly multi-key) transaction atomically.
   ///
-  /// The commit involves two steps, both while holding a lock on the entire
-  /// KeyValueStore:
+  /// The commit involves two steps, both while holding locks on all shards of
+  /// the KeyValueStore that are affected by the transaction:
   ///
   /// 1. Without making any modifications, validates that the underlying
   ///    KeyValueStore data matches the generation constraints specified in the
@@ -262,16 +517,16 @@ class MemoryDriver::TransactionNode
       ABSL_NO_THREAD_SAFETY_ANALYSIS {
     if (!single_phase_mutation.remaining_entries_.HasError()) {
       auto& data = static_cast<MemoryDriver&>(*this->driver()).data();
-      TimestampedStorageGeneration generation;
-      UniqueWriterLock lock(data.mutex);
+      const auto shard_mask = GetShardMask(single_phase_mutation);
+      data.LockShards(shard_mask);
       absl::Time commit_time = absl::Now();
       if (!ValidateEntryConditions(data, single_phase_mutation, commit_time)) {
-        lock.unlock();
+        data.UnlockShards(shard_mask);
         this->RetryAtomicWriteback(commit_time);
         return;
       }
       ApplyMutation(data, single_phase_mutation, commit_time);
-      lock.unlock();
+      data.UnlockShards(shard_mask);
       this->AtomicCommitWritebackSuccess();
     } else {
       internal_kvstore::WritebackError(single_phase_mutation);
@@ -279,12 +534,30 @@ class MemoryDriver::TransactionNode
     MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
   }
 
+  /// Returns the shards that must be locked to commit `single_phase_mutation`.
+  static StoredKeyValuePairs::ShardMask GetShardMask(
+      internal_kvstore::SinglePhaseMutation& single_phase_mutation) {
+    StoredKeyValuePairs::ShardMask mask = 0;
+    for (auto& entry : single_phase_mutation.entries_) {
+      if (entry.entry_type() != kReadModifyWrite) {
+        // A `DeleteRangeEntry` may affect keys in every shard.
+        return StoredKeyValuePairs::kAllShards;
+      }
+      mask |= StoredKeyValuePairs::ShardMask{1}
+              << StoredKeyValuePairs::GetShardIndex(entry.key_);
+    }
+    return mask;
+  }
+
+  // The functions below require that the shards given by `GetShardMask` are
+  // locked, which cannot be expressed with thread safety annotations.
+
   /// Validates that the underlying `data` matches the generation constraints
   /// specified in the transaction.  No changes are made to the `data`.
   static bool ValidateEntryConditions(
       StoredKeyValuePairs& data,
       internal_kvstore::SinglePhaseMutation& single_phase_mutation,
-      const absl::Time& commit_time) ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+      const absl::Time& commit_time) {
     bool validated = true;
     for (auto& entry : single_phase_mutation.entries_) {
       if (!ValidateEntryConditions(data, entry, commit_time)) {
@@ -296,8 +569,7 @@ class MemoryDriver::TransactionNode
 
   static bool ValidateEntryConditions(StoredKeyValuePairs& data,
                                       internal_kvstore::MutationEntry& entry,
-                                      const absl::Time& commit_time)
-      ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+                                      const absl::Time& commit_time) {
     if (entry.entry_type() == kReadModifyWrite) {
       return ValidateEntryConditions(
           data, static_cast<BufferedReadModifyWriteEntry&>(entry), commit_time);
@@ -319,15 +591,16 @@ class MemoryDriver::TransactionNode
   static bool ValidateEntryConditions(StoredKeyValuePairs& data,
                                       BufferedReadModifyWriteEntry& entry,
                                       const absl::Time& commit_time)
-      ABSL_SHARED_LOCKS_REQUIRED(data.mutex) {
+      ABSL_NO_THREAD_SAFETY_ANALYSIS {
     auto& stamp = entry.stamp();
     auto if_equal = StorageGeneration::Clean(stamp.generation);
     if (StorageGeneration::IsUnknown(if_equal)) {
       assert(stamp.time == absl::InfiniteFuture());
       return true;
     }
-    auto it = data.values.find(entry.key_);
-    if (it == data.values.end()) {
+    auto& values = data.GetShard(entry.key_).values;
+    auto it = values.find(entry.key_);
+    if (it == values.end()) {
       if (StorageGeneration::IsNoValue(if_equal)) {
         stamp.time = commit_time;
         return true;
@@ -346,7 +619,7 @@ class MemoryDriver::TransactionNode
   static void ApplyMutation(
       StoredKeyValuePairs& data,
       internal_kvstore::SinglePhaseMutation& single_phase_mutation,
-      const absl::Time& commit_time) ABSL_EXCLUSIVE_LOCKS_REQUIRED(data.mutex) {
+      const absl::Time& commit_time) ABSL_NO_THREAD_SAFETY_ANALYSIS {
     for (auto& entry : single_phase_mutation.entries_) {
       if (entry.entry_type() == kReadModifyWrite) {
         auto& rmw_entry = static_cast<BufferedReadModifyWriteEntry&>(entry);
@@ -356,28 +629,552 @@ class MemoryDriver::TransactionNode
         if (!StorageGeneration::IsDirty(stamp.generation)) {
           // Do nothing
         } else if (value_state == ReadResult::kMissing) {
-          data.values.erase(rmw_entry.key_);
+          data.GetShard(rmw_entry.key_).values.erase(rmw_entry.key_);
           stamp.generation = StorageGeneration::NoValue();
         } else {
           assert(value_state == ReadResult::kValue);
-          auto& v = data.values[rmw_entry.key_];
-          v.generation_number = data.next_generation_number++;
+          auto& v = data.GetShard(rmw_entry.key_).values[rmw_entry.key_];
+          v.generation_number = data.NextGenerationNumber();
           v.value = std::move(rmw_entry.value_);
           stamp.generation = v.generation();
         }
       } else {
         auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
-        auto it_range = data.Find(dr_entry.key_, dr_entry.exclusive_max_);
-        data.values.erase(it_range.first, it_range.second);
+        for (auto& shard : data.shards) {
+          auto it_range = shard.Find(dr_entry.key_, dr_entry.exclusive_max_);
+          shard.values.erase(it_range.first, it_range.second);
+        }
       }
     }
   }
 };
 
+absl::Status StoredKeyValuePairs::EnableWriteback(
+    kvstore::KvStore base, std::optional<uint64_t> max_bytes)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  const int64_t limit =
+      static_cast<int64_t>(std::min<uint64_t>(
+          max_bytes.value_or(std::numeric_limits<int64_t>::max()),
+          std::numeric_limits<int64_t>::max()));
+  {
+    absl::MutexLock lock(&writeback_mutex_);
+    if (auto* wb = writeback()) {
+      if (wb->base == base && wb->max_bytes == limit) return absl::OkStatus();
+      return absl::FailedPreconditionError(
+          "memory_key_value_store is already in use with a different "
+          "\"base\" or \"max_bytes\"");
+    }
+    auto wb = std::make_unique<Writeback>();
+    wb->base = std::move(base);
+    wb->max_bytes = limit;
+    // Values stored before write-back mode was enabled are held in memory.
+    LockShards(kAllShards);
+    int64_t resident_bytes = 0;
+    for (auto& shard : shards) {
+      for (auto& [key, entry] : shard.values) {
+        resident_bytes += entry.value.size();
+      }
+    }
+    wb->resident_bytes = resident_bytes;
+    writeback_.store(wb.get(), std::memory_order_release);
+    writeback_storage_ = std::move(wb);
+    UnlockShards(kAllShards);
+  }
+  MaybeEvict();
+  return absl::OkStatus();
+}
+
+bool StoredKeyValuePairs::InPendingDeleteRange(std::string_view key) {
+  auto& wb = *writeback();
+  absl::MutexLock lock(&wb.mutex);
+  for (const auto& range : wb.pending_delete_ranges) {
+    if (Contains(range, key)) return true;
+  }
+  return false;
+}
+
+void StoredKeyValuePairs::BeginWriteback(Shard& shard, Map::iterator it,
+                                         PendingWritebacks& pending) {
+  auto& entry = it->second;
+  assert(entry.state != ValueState::kSpilled);
+  assert(!entry.writeback_in_progress);
+  entry.writeback_in_progress = true;
+  auto& write = pending.emplace_back();
+  write.key = it->first;
+  write.generation_number = entry.generation_number;
+  if (entry.state == ValueState::kDirty) {
+    write.value = entry.value;
+    writeback()->writeback_bytes.fetch_add(entry.value.size(),
+                                           std::memory_order_relaxed);
+  }
+}
+
+void StoredKeyValuePairs::IssueWritebacks(PendingWritebacks pending) {
+  auto& wb = *writeback();
+  for (auto& write : pending) {
+    const int64_t size = write.value ? write.value->size() : 0;
+    auto future = kvstore::Write(wb.base, write.key, std::move(write.value));
+    future.ExecuteWhenReady(
+        [self = Ptr(this), key = std::move(write.key),
+         generation_number = write.generation_number,
+         size](ReadyFuture<TimestampedStorageGeneration> future) mutable {
+          self->WritebackDone(std::move(key), generation_number, size,
+                              future.result());
+        });
+  }
+}
+
+void StoredKeyValuePairs::WritebackDone(
+    std::string key, uint64_t generation_number, int64_t size,
+    const Result<TimestampedStorageGeneration>& result) {
+  auto& wb = *writeback();
+  const bool ok =
+      result.ok() && !StorageGeneration::IsUnknown(result->generation);
+  PendingWritebacks pending;
+  {
+    auto& shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    wb.writeback_bytes.fetch_sub(size, std::memory_order_relaxed);
+    auto it = shard.values.find(key);
+    assert(it != shard.values.end());
+    auto& entry = it->second;
+    entry.writeback_in_progress = false;
+    if (ok && entry.generation_number == generation_number) {
+      if (entry.state == ValueState::kDeleted) {
+        shard.values.erase(it);
+      } else {
+        // Evict the value, which is now stored in the base kvstore.
+        wb.resident_bytes.fetch_sub(entry.value.size(),
+                                    std::memory_order_relaxed);
+        entry.value.Clear();
+        entry.state = ValueState::kSpilled;
+        entry.base_generation = result->generation;
+      }
+    } else if (ok && entry.state == ValueState::kDeleted &&
+               !InPendingDeleteRange(key)) {
+      // The key was deleted while the prior value was written back.
+      BeginWriteback(shard, it, pending);
+    }
+    // Otherwise, the entry is still dirty.  If the write failed, it is retried
+    // when the entry is next evicted.
+  }
+  IssueWritebacks(std::move(pending));
+  if (ok) MaybeEvict();
+}
+
+bool StoredKeyValuePairs::Evict(Shard& shard, PendingWritebacks& pending) {
+  auto& values = shard.values;
+  auto it = values.lower_bound(shard.eviction_position);
+  bool evicted = false;
+  // Each entry is visited at most twice: the first visit clears the
+  // `referenced` bit.
+  for (size_t remaining = 2 * values.size(); remaining > 0; --remaining) {
+    if (it == values.end()) it = values.begin();
+    auto& entry = it->second;
+    if (entry.writeback_in_progress || entry.state == ValueState::kSpilled ||
+        InPendingDeleteRange(it->first)) {
+      ++it;
+      continue;
+    }
+    if (entry.referenced) {
+      entry.referenced = false;
+      ++it;
+      continue;
+    }
+    BeginWriteback(shard, it, pending);
+    ++it;
+    evicted = true;
+    break;
+  }
+  shard.eviction_position = it == values.end() ? std::string() : it->first;
+  return evicted;
+}
+
+void StoredKeyValuePairs::MaybeEvict() {
+  auto& wb = *writeback();
+  // Values are evicted from the shards in turn, which approximates a global
+  // least-recently used order without locking all of the shards.
+  for (size_t idle_shards = 0; idle_shards < kNumShards && OverBudget();) {
+    auto& shard = shards[wb.next_eviction_shard.fetch_add(
+                             1, std::memory_order_relaxed) %
+                         kNumShards];
+    PendingWritebacks pending;
+    bool evicted;
+    {
+      absl::MutexLock lock(&shard.mutex);
+      evicted = Evict(shard, pending);
+    }
+    IssueWritebacks(std::move(pending));
+    idle_shards = evicted ? 0 : idle_shards + 1;
+  }
+}
+
+void StoredKeyValuePairs::AddSpilledEntry(const std::string& key,
+                                          StorageGeneration base_generation) {
+  auto& shard = GetShard(key);
+  absl::MutexLock lock(&shard.mutex);
+  auto [it, inserted] = shard.values.emplace(
+      key, ValueWithGenerationNumber{absl::Cord(), NextGenerationNumber()});
+  if (!inserted) return;
+  it->second.state = ValueState::kSpilled;
+  it->second.base_generation = std::move(base_generation);
+}
+
+void StoredKeyValuePairs::ForgetSpilledEntry(const std::string& key,
+                                             uint64_t generation_number) {
+  auto& shard = GetShard(key);
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.values.find(key);
+  if (it != shard.values.end() &&
+      it->second.state == ValueState::kSpilled &&
+      it->second.generation_number == generation_number) {
+    shard.values.erase(it);
+  }
+}
+
+Future<ReadResult> StoredKeyValuePairs::WritebackRead(
+    kvstore::Key key, kvstore::ReadOptions options) {
+  kvstore::ReadOptions base_options;
+  base_options.staleness_bound = options.staleness_bound;
+  base_options.byte_range = options.byte_range;
+  base_options.batch = options.batch;
+  // Generation number of the evicted value, if `key` has an entry.
+  std::optional<uint64_t> generation_number;
+  {
+    auto& shard = GetShard(key);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.values.find(key);
+    if (it != shard.values.end()) {
+      auto& entry = it->second;
+      auto stamp = GenerationNow(entry.generation());
+      if (entry.state == ValueState::kDeleted) {
+        return ReadResult::Missing(std::move(stamp));
+      }
+      if (!options.generation_conditions.Matches(stamp.generation)) {
+        return ReadResult::Unspecified(std::move(stamp));
+      }
+      entry.referenced = true;
+      if (entry.state == ValueState::kDirty) {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto byte_range, options.byte_range.Validate(entry.value.size()));
+        return ReadResult::Value(internal::GetSubCord(entry.value, byte_range),
+                                 std::move(stamp));
+      }
+      // The value was evicted.  The read is conditioned on the generation of
+      // the evicted value, since a more recent value may be written back
+      // concurrently.
+      base_options.generation_conditions.if_equal = entry.base_generation;
+      generation_number = entry.generation_number;
+    } else if (InPendingDeleteRange(key)) {
+      return ReadResult::Missing(GenerationNow(StorageGeneration::NoValue()));
+    }
+  }
+  auto future = kvstore::Read(writeback()->base, key, std::move(base_options));
+  return PromiseFuturePair<ReadResult>::Link(
+             [self = Ptr(this), key = std::move(key),
+              options = std::move(options), generation_number](
+                 Promise<ReadResult> promise,
+                 ReadyFuture<ReadResult> ready) mutable {
+               if (!promise.result_needed()) return;
+               auto& r = ready.result();
+               if (!r.ok()) {
+                 promise.SetResult(r.status());
+                 return;
+               }
+               if (generation_number) {
+                 if (r->has_value()) {
+                   r->stamp.generation =
+                       StorageGeneration::FromUint64(*generation_number);
+                   promise.SetResult(std::move(r));
+                   return;
+                 }
+                 // The value in the base kvstore no longer matches the
+                 // evicted value.
+                 self->ForgetSpilledEntry(key, *generation_number);
+               } else if (r->not_found()) {
+                 promise.SetResult(std::move(r));
+                 return;
+               } else if (r->has_value()) {
+                 // Add an entry for the value read through from the base
+                 // kvstore, and return its generation.
+                 auto& shard = self->GetShard(key);
+                 absl::MutexLock lock(&shard.mutex);
+                 auto [it, inserted] = shard.values.emplace(
+                     key, ValueWithGenerationNumber{
+                              absl::Cord(), self->NextGenerationNumber()});
+                 if (inserted) {
+                   auto& entry = it->second;
+                   entry.state = ValueState::kSpilled;
+                   entry.base_generation = std::move(r->stamp.generation);
+                   entry.referenced = true;
+                   r->stamp.generation = entry.generation();
+                   if (!options.generation_conditions.Matches(
+                           r->stamp.generation)) {
+                     r->state = ReadResult::kUnspecified;
+                     r->value.Clear();
+                   }
+                   promise.SetResult(std::move(r));
+                   return;
+                 }
+               }
+               // The entry for `key` changed concurrently.
+               LinkResult(std::move(promise),
+                          self->WritebackRead(std::move(key),
+                                              std::move(options)));
+             },
+             std::move(future))
+      .future;
+}
+
+std::optional<TimestampedStorageGeneration>
+StoredKeyValuePairs::WritebackWriteEntry(kvstore::Key& key,
+                                         std::optional<kvstore::Value>& value,
+                                         const kvstore::WriteOptions& options,
+                                         bool checked_base,
+                                         PendingWritebacks& pending) {
+  auto& wb = *writeback();
+  auto& shard = GetShard(key);
+  absl::MutexLock lock(&shard.mutex);
+  auto it = shard.values.find(key);
+  if (it == shard.values.end()) {
+    // The key has no entry, but may be stored in the base kvstore.
+    if (!options.generation_conditions.MatchesNoValue()) {
+      return GenerationNow(StorageGeneration::Unknown());
+    }
+    const bool maybe_in_base = !checked_base && !InPendingDeleteRange(key);
+    if (maybe_in_base &&
+        StorageGeneration::IsNoValue(options.generation_conditions.if_equal)) {
+      return std::nullopt;
+    }
+    if (!value && !maybe_in_base) {
+      return GenerationNow(StorageGeneration::NoValue());
+    }
+    it = shard.values
+             .emplace(std::move(key),
+                      ValueWithGenerationNumber{absl::Cord(), 0})
+             .first;
+  } else {
+    if (!options.generation_conditions.Matches(it->second.generation())) {
+      return GenerationNow(StorageGeneration::Unknown());
+    }
+    if (!value && it->second.state == ValueState::kDeleted) {
+      return GenerationNow(StorageGeneration::NoValue());
+    }
+  }
+  auto& entry = it->second;
+  if (entry.state == ValueState::kDirty) {
+    wb.resident_bytes.fetch_sub(entry.value.size(), std::memory_order_relaxed);
+  }
+  entry.generation_number = NextGenerationNumber();
+  entry.referenced = true;
+  if (value) {
+    wb.resident_bytes.fetch_add(value->size(), std::memory_order_relaxed);
+    entry.value = std::move(*value);
+    entry.state = ValueState::kDirty;
+  } else {
+    entry.value.Clear();
+    entry.state = ValueState::kDeleted;
+    if (!entry.writeback_in_progress && !InPendingDeleteRange(it->first)) {
+      BeginWriteback(shard, it, pending);
+    }
+  }
+  return GenerationNow(entry.generation());
+}
+
+Future<TimestampedStorageGeneration> StoredKeyValuePairs::WritebackWrite(
+    kvstore::Key key, std::optional<kvstore::Value> value,
+    kvstore::WriteOptions options, bool checked_base) {
+  PendingWritebacks pending;
+  if (auto stamp =
+          WritebackWriteEntry(key, value, options, checked_base, pending)) {
+    IssueWritebacks(std::move(pending));
+    MaybeEvict();
+    return *std::move(stamp);
+  }
+  // Check whether the key is stored in the base kvstore before creating it.
+  kvstore::ReadOptions base_options;
+  base_options.byte_range = OptionalByteRangeRequest::Range(0, 0);
+  auto future = kvstore::Read(writeback()->base, key, std::move(base_options));
+  return PromiseFuturePair<TimestampedStorageGeneration>::Link(
+             [self = Ptr(this), key = std::move(key), value = std::move(value),
+              options = std::move(options)](
+                 Promise<TimestampedStorageGeneration> promise,
+                 ReadyFuture<ReadResult> ready) mutable {
+               if (!promise.result_needed()) return;
+               auto& r = ready.result();
+               if (!r.ok()) {
+                 promise.SetResult(r.status());
+                 return;
+               }
+               if (r->has_value()) {
+                 self->AddSpilledEntry(key, std::move(r->stamp.generation));
+               }
+               LinkResult(std::move(promise),
+                          self->WritebackWrite(std::move(key), std::move(value),
+                                               std::move(options),
+                                               /*checked_base=*/true));
+             },
+             std::move(future))
+      .future;
+}
+
+Future<const void> StoredKeyValuePairs::WritebackDeleteRange(KeyRange range)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto& wb = *writeback();
+  LockShards(kAllShards);
+  for (auto& shard : shards) {
+    auto it_range = shard.Find(range);
+    for (auto it = it_range.first; it != it_range.second;) {
+      auto& entry = it->second;
+      if (entry.state == ValueState::kDirty) {
+        wb.resident_bytes.fetch_sub(entry.value.size(),
+                                    std::memory_order_relaxed);
+      }
+      if (!entry.writeback_in_progress) {
+        it = shard.values.erase(it);
+        continue;
+      }
+      // The write back in progress must be followed by a deletion, which is
+      // started by `WritebackDone`.
+      entry.value.Clear();
+      entry.state = ValueState::kDeleted;
+      entry.generation_number = NextGenerationNumber();
+      ++it;
+    }
+  }
+  {
+    absl::MutexLock lock(&wb.mutex);
+    wb.pending_delete_ranges.push_back(range);
+  }
+  UnlockShards(kAllShards);
+  auto future = kvstore::DeleteRange(wb.base, range);
+  future.ExecuteWhenReady([self = Ptr(this), range = std::move(range)](
+                              ReadyFuture<const void> future) {
+    auto& wb = *self->writeback();
+    {
+      absl::MutexLock lock(&wb.mutex);
+      auto& ranges = wb.pending_delete_ranges;
+      ranges.erase(std::find(ranges.begin(), ranges.end(), range));
+    }
+    // Start the deletions that were deferred while the request was in
+    // progress.
+    for (auto& shard : self->shards) {
+      PendingWritebacks pending;
+      {
+        absl::MutexLock lock(&shard.mutex);
+        auto it_range = shard.Find(range);
+        for (auto it = it_range.first; it != it_range.second; ++it) {
+          if (it->second.state == ValueState::kDeleted &&
+              !it->second.writeback_in_progress &&
+              !self->InPendingDeleteRange(it->first)) {
+            self->BeginWriteback(shard, it, pending);
+          }
+        }
+      }
+      self->IssueWritebacks(std::move(pending));
+    }
+    self->MaybeEvict();
+  });
+  return future;
+}
+
+void StoredKeyValuePairs::WritebackList(kvstore::ListOptions options,
+                                        ListReceiver receiver)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto& wb = *writeback();
+  // Snapshot of the entries in `options.range`, with the size of the values
+  // held in memory.
+  constexpr int64_t kSpilledSize = -1;
+  constexpr int64_t kDeletedSize = -2;
+  absl::btree_map<std::string, int64_t> entries;
+  std::vector<KeyRange> pending_delete_ranges;
+  for (auto& shard : shards) shard.mutex.ReaderLock();
+  for (auto& shard : shards) {
+    auto it_range = shard.Find(options.range);
+    for (auto it = it_range.first; it != it_range.second; ++it) {
+      const auto& entry = it->second;
+      entries.emplace(it->first,
+                      entry.state == ValueState::kDirty
+                          ? static_cast<int64_t>(entry.value.size())
+                      : entry.state == ValueState::kSpilled ? kSpilledSize
+                                                            : kDeletedSize);
+    }
+  }
+  {
+    absl::MutexLock lock(&wb.mutex);
+    pending_delete_ranges = wb.pending_delete_ranges;
+  }
+  for (auto& shard : shards) shard.mutex.ReaderUnlock();
+
+  kvstore::ListOptions base_options;
+  base_options.range = options.range;
+  base_options.staleness_bound = options.staleness_bound;
+  auto future = kvstore::ListFuture(wb.base, std::move(base_options));
+  future.ExecuteWhenReady(
+      [entries = std::move(entries),
+       pending_delete_ranges = std::move(pending_delete_ranges),
+       strip_prefix_length = options.strip_prefix_length,
+       receiver = std::move(receiver)](
+          ReadyFuture<std::vector<ListEntry>> future) mutable {
+        std::atomic<bool> cancelled{false};
+        execution::set_starting(receiver, [&cancelled] {
+          cancelled.store(true, std::memory_order_relaxed);
+        });
+        auto& r = future.result();
+        if (!r.ok()) {
+          execution::set_error(receiver, r.status());
+          execution::set_stopping(receiver);
+          return;
+        }
+        std::vector<ListEntry> list_entries;
+        for (auto& [key, size] : entries) {
+          if (size < 0) continue;
+          list_entries.push_back(
+              ListEntry{key, ListEntry::checked_size(size)});
+        }
+        // Add the keys that are stored only in the base kvstore.
+        for (auto& base_entry : *r) {
+          auto it = entries.find(base_entry.key);
+          if (it != entries.end() ? it->second != kSpilledSize
+                                  : std::any_of(pending_delete_ranges.begin(),
+                                                pending_delete_ranges.end(),
+                                                [&](const KeyRange& range) {
+                                                  return Contains(
+                                                      range, base_entry.key);
+                                                })) {
+            continue;
+          }
+          list_entries.push_back(std::move(base_entry));
+        }
+        std::sort(list_entries.begin(), list_entries.end(),
+                  [](const ListEntry& a, const ListEntry& b) {
+                    return a.key < b.key;
+                  });
+        for (auto& entry : list_entries) {
+          if (cancelled.load(std::memory_order_relaxed)) break;
+          entry.key.erase(
+              0, std::min(strip_prefix_length, entry.key.size()));
+          execution::set_value(receiver, std::move(entry));
+        }
+        execution::set_done(receiver);
+        execution::set_stopping(receiver);
+      });
+}
+
 Future<ReadResult> MemoryDriver::Read(Key key, ReadOptions options) {
-  auto& data = this->data();
-  absl::ReaderMutexLock lock(&data.mutex);
-  auto& values = data.values;
+  if (data().writeback()) {
+    return internal_kvstore::RecordReadMetrics(
+        memory_metrics,
+        data().WritebackRead(std::move(key), std::move(options)));
+  }
+  return internal_kvstore::RecordReadMetrics(
+      memory_metrics, ReadImpl(std::move(key), std::move(options)));
+}
+
+Result<ReadResult> MemoryDriver::ReadImpl(Key key, ReadOptions options) {
+  auto& shard = data().GetShard(key);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto& values = shard.values;
   auto it = values.find(key);
   if (it == values.end()) {
     // Key not found.
@@ -396,11 +1193,25 @@ Future<ReadResult> MemoryDriver::Read(Key key, ReadOptions options) {
 
 Future<TimestampedStorageGeneration> MemoryDriver::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
+  if (value) memory_metrics.bytes_written.IncrementBy(value->size());
+  if (data().writeback()) {
+    return internal_kvstore::RecordWriteMetrics(
+        memory_metrics, data().WritebackWrite(std::move(key), std::move(value),
+                                              std::move(options)));
+  }
+  return internal_kvstore::RecordWriteMetrics(
+      memory_metrics,
+      WriteImpl(std::move(key), std::move(value), std::move(options)));
+}
+
+TimestampedStorageGeneration MemoryDriver::WriteImpl(
+    Key key, std::optional<Value> value, WriteOptions options) {
   using ValueWithGenerationNumber =
       StoredKeyValuePairs::ValueWithGenerationNumber;
   auto& data = this->data();
-  absl::WriterMutexLock lock(&data.mutex);
-  auto& values = data.values;
+  auto& shard = data.GetShard(key);
+  absl::WriterMutexLock lock(&shard.mutex);
+  auto& values = shard.values;
   auto it = values.find(key);
   if (it == values.end()) {
     // Key does not already exist.
@@ -418,7 +1229,7 @@ Future<TimestampedStorageGeneration> MemoryDriver::Write(
     it = values
              .emplace(std::move(key),
                       ValueWithGenerationNumber{std::move(*value),
-                                                data.next_generation_number++})
+                                                data.NextGenerationNumber()})
              .first;
     return GenerationNow(it->second.generation());
   }
@@ -434,43 +1245,63 @@ Future<TimestampedStorageGeneration> MemoryDriver::Write(
     return GenerationNow(StorageGeneration::NoValue());
   }
   // Set the generation number to the next unused generation number.
-  it->second.generation_number = data.next_generation_number++;
+  it->second.generation_number = data.NextGenerationNumber();
   // Update the value.
   it->second.value = std::move(*value);
   return GenerationNow(it->second.generation());
 }
 
-Future<const void> MemoryDriver::DeleteRange(KeyRange range) {
+Future<const void> MemoryDriver::DeleteRange(KeyRange range)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  if (range.empty()) return absl::OkStatus();
   auto& data = this->data();
-  absl::WriterMutexLock lock(&data.mutex);
-  if (!range.empty()) {
-    auto it_range = data.Find(range);
-    data.values.erase(it_range.first, it_range.second);
+  if (data.writeback()) return data.WritebackDeleteRange(std::move(range));
+  data.LockShards(StoredKeyValuePairs::kAllShards);
+  for (auto& shard : data.shards) {
+    auto it_range = shard.Find(range);
+    shard.values.erase(it_range.first, it_range.second);
   }
+  data.UnlockShards(StoredKeyValuePairs::kAllShards);
   return absl::OkStatus();  // Converted to a ReadyFuture.
 }
 
-void MemoryDriver::ListImpl(ListOptions options, ListReceiver receiver) {
+void MemoryDriver::ListImpl(ListOptions options, ListReceiver receiver)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
   auto& data = this->data();
+  if (data.writeback()) {
+    data.WritebackList(std::move(options), std::move(receiver));
+    return;
+  }
   std::atomic<bool> cancelled{false};
   execution::set_starting(receiver, [&cancelled] {
     cancelled.store(true, std::memory_order_relaxed);
   });
 
-  // Collect the keys.
+  // Collect the keys.  All shards are locked together so that the listing
+  // reflects a single consistent state.
   std::vector<ListEntry> entries;
-  {
-    absl::ReaderMutexLock lock(&data.mutex);
-    auto it_range = data.Find(options.range);
+  for (auto& shard : data.shards) shard.mutex.ReaderLock();
+  for (auto& shard : data.shards) {
+    // Each shard is sorted, so the entries are merged to preserve the order.
+    const size_t num_sorted = entries.size();
+    auto it_range = shard.Find(options.range);
     for (auto it = it_range.first; it != it_range.second; ++it) {
       if (cancelled.load(std::memory_order_relaxed)) break;
-      std::string_view key = it->first;
       entries.push_back(ListEntry{
-          std::string(
-              key.substr(std::min(options.strip_prefix_length, key.size()))),
+          it->first,
           ListEntry::checked_size(it->second.value.size()),
+          it->second.generation(),
       });
     }
+    std::inplace_merge(entries.begin(), entries.begin() + num_sorted,
+                       entries.end(),
+                       [](const ListEntry& a, const ListEntry& b) {
+                         return a.key < b.key;
+                       });
+  }
+  for (auto& shard : data.shards) shard.mutex.ReaderUnlock();
+  for (auto& entry : entries) {
+    entry.key.erase(0, std::min(options.strip_prefix_length, entry.key.size()));
   }
 
   // Send the keys.
@@ -485,7 +1316,9 @@ void MemoryDriver::ListImpl(ListOptions options, ListReceiver receiver) {
 absl::Status MemoryDriver::ReadModifyWrite(
     internal::OpenTransactionPtr& transaction, size_t& phase, Key key,
     ReadModifyWriteSource& source) {
-  if (!spec_.atomic) {
+  // In write-back mode, the stored values are not all held in memory, and
+  // multi-key transactions are not atomic.
+  if (!spec_.atomic || data().writeback()) {
     return Driver::ReadModifyWrite(transaction, phase, std::move(key), source);
   }
   return internal_kvstore::AddReadModifyWrite<TransactionNode>(
@@ -494,7 +1327,7 @@ absl::Status MemoryDriver::ReadModifyWrite(
 
 absl::Status MemoryDriver::TransactionalDeleteRange(
     const internal::OpenTransactionPtr& transaction, KeyRange range) {
-  if (!spec_.atomic) {
+  if (!spec_.atomic || data().writeback()) {
     return Driver::TransactionalDeleteRange(transaction, std::move(range));
   }
   return internal_kvstore::AddDeleteRange<TransactionNode>(this, transaction,
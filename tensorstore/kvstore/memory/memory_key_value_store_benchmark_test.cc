@@ -0,0 +1,82 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/memory/memory_key_value_store.h"
+#include "tensorstore/kvstore/operations.h"
+
+namespace {
+
+namespace kvstore = tensorstore::kvstore;
+
+// Store shared by the threads of a benchmark run.
+kvstore::DriverPtr shared_store;
+
+// Each thread repeatedly overwrites its own set of keys, which measures how
+// well writes to different keys scale with the number of threads.
+void BM_ConcurrentWrite(benchmark::State& state) {
+  constexpr int kKeysPerThread = 64;
+  if (state.thread_index() == 0) {
+    shared_store = tensorstore::GetMemoryKeyValueStore();
+  }
+  std::vector<std::string> keys;
+  for (int i = 0; i < kKeysPerThread; ++i) {
+    keys.push_back(absl::StrCat("thread", state.thread_index(), "/key", i));
+  }
+  const absl::Cord value(std::string(state.range(0), 'x'));
+  int64_t i = 0;
+  for (auto s : state) {
+    auto result =
+        kvstore::Write(shared_store, keys[i++ % kKeysPerThread], value)
+            .result();
+    ABSL_CHECK(result.ok());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ConcurrentWrite)->Arg(1024)->ThreadRange(1, 64)->UseRealTime();
+
+// Mixed workload of reads and writes of keys shared by all threads.
+void BM_ConcurrentReadWrite(benchmark::State& state) {
+  constexpr int kNumKeys = 1024;
+  if (state.thread_index() == 0) {
+    shared_store = tensorstore::GetMemoryKeyValueStore();
+  }
+  const absl::Cord value(std::string(1024, 'x'));
+  int64_t i = state.thread_index();
+  for (auto s : state) {
+    const std::string key = absl::StrCat("key", (i * 7919) % kNumKeys);
+    if (i++ % 4 == 0) {
+      ABSL_CHECK(kvstore::Write(shared_store, key, value).result().ok());
+    } else {
+      ABSL_CHECK(kvstore::Read(shared_store, key).result().ok());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConcurrentReadWrite)->ThreadRange(1, 64)->UseRealTime();
+
+}  // namespace
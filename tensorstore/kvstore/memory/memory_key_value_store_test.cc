@@ -14,17 +14,23 @@
 
 #include "tensorstore/kvstore/memory/memory_key_value_store.h"
 
+#include <stdint.h>
+
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache_key/cache_key.h"
 #include "tensorstore/internal/json_gtest.h"
 #include "tensorstore/json_serialization_options_base.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/spec.h"
@@ -41,8 +47,12 @@ using ::tensorstore::Context;
 using ::tensorstore::KvStore;
 using ::tensorstore::MatchesJson;
 using ::tensorstore::MatchesStatus;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal::MatchesKnownTimestampedStorageGeneration;
 using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal::MatchesTimestampedStorageGeneration;
 using ::tensorstore::serialization::SerializationRoundTrip;
 
 TEST(MemoryKeyValueStoreTest, Basic) {
@@ -82,6 +92,146 @@ TEST(MemoryKeyValueStoreTest, List) {
   tensorstore::internal::TestKeyValueStoreList(store);
 }
 
+// Keys are stored in multiple shards, which must be merged in order.
+TEST(MemoryKeyValueStoreTest, ListSorted) {
+  auto store = tensorstore::GetMemoryKeyValueStore();
+  std::vector<std::string> keys;
+  for (int i = 0; i < 500; ++i) {
+    keys.push_back(absl::StrFormat("k%03d", i));
+  }
+  for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, *it, absl::Cord("v")));
+  }
+  kvstore::ListOptions options;
+  options.range = tensorstore::KeyRange("k1", "k3");
+  options.strip_prefix_length = 1;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto entries, kvstore::ListFuture(store.get(), options).result());
+  std::vector<std::string> listed_keys;
+  for (const auto& entry : entries) listed_keys.push_back(entry.key);
+  std::vector<std::string> expected_keys;
+  for (int i = 100; i < 300; ++i) {
+    expected_keys.push_back(absl::StrFormat("%03d", i));
+  }
+  EXPECT_THAT(listed_keys, ::testing::ElementsAreArray(expected_keys));
+}
+
+// Returns the JSON spec of a memory kvstore in write-back mode, with a
+// separate `memory_key_value_store` than the base memory kvstore.
+::nlohmann::json WritebackSpec(uint64_t max_bytes) {
+  return {{"driver", "memory"},
+          {"memory_key_value_store", ::nlohmann::json::object_t()},
+          {"base", {{"driver", "memory"}}},
+          {"max_bytes", max_bytes}};
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackBasic) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open(WritebackSpec(1), Context::Default()).result());
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackDeleteRange) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open(WritebackSpec(1), Context::Default()).result());
+  tensorstore::internal::TestKeyValueStoreDeleteRange(store);
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackList) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open(WritebackSpec(1), Context::Default()).result());
+  tensorstore::internal::TestKeyValueStoreList(store);
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackSpillsToBase) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, kvstore::Open({{"driver", "memory"}}, context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open(WritebackSpec(10), context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp_a,
+      kvstore::Write(store, "a", absl::Cord("aaaaaaaa")).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp_b,
+      kvstore::Write(store, "b", absl::Cord("bbbbbbbb")).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto stamp_c,
+      kvstore::Write(store, "c", absl::Cord("cccccccc")).result());
+
+  // Only one of the values fits within `max_bytes`; the others were written
+  // back to the base kvstore.
+  EXPECT_THAT(kvstore::ListFuture(base).result(),
+              ::testing::Optional(::testing::SizeIs(2)));
+
+  // Evicted values retain the generation assigned by `store`.
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("aaaaaaaa"), stamp_a.generation));
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResult(absl::Cord("bbbbbbbb"), stamp_b.generation));
+  EXPECT_THAT(kvstore::Read(store, "c").result(),
+              MatchesKvsReadResult(absl::Cord("cccccccc"), stamp_c.generation));
+
+  // Conditional writes are validated against those generations.
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = stamp_b.generation;
+  EXPECT_THAT(
+      kvstore::Write(store, "a", absl::Cord("x"), options).result(),
+      MatchesTimestampedStorageGeneration(StorageGeneration::Unknown()));
+  options.generation_conditions.if_equal = stamp_a.generation;
+  EXPECT_THAT(kvstore::Write(store, "a", absl::Cord("x"), options).result(),
+              MatchesKnownTimestampedStorageGeneration());
+
+  // Keys stored only in the base kvstore are read through.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base, "d", absl::Cord("dd")).result());
+  EXPECT_THAT(kvstore::Read(store, "d").result(),
+              MatchesKvsReadResult(absl::Cord("dd")));
+  EXPECT_THAT(kvstore::ListFuture(store).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesListEntry("a", 1), MatchesListEntry("b", 8),
+                  MatchesListEntry("c", 8), MatchesListEntry("d", 2))));
+
+  // Deletions are applied to the base kvstore.
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "d").result());
+  EXPECT_THAT(kvstore::Read(base, "d").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(kvstore::Read(store, "d").result(),
+              MatchesKvsReadResultNotFound());
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackConditionalCreate) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base, kvstore::Open({{"driver", "memory"}}, context).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open(WritebackSpec(10), context).result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base, "a", absl::Cord("a")).result());
+
+  // A key stored only in the base kvstore exists.
+  kvstore::WriteOptions options;
+  options.generation_conditions.if_equal = StorageGeneration::NoValue();
+  EXPECT_THAT(
+      kvstore::Write(store, "a", absl::Cord("x"), options).result(),
+      MatchesTimestampedStorageGeneration(StorageGeneration::Unknown()));
+  EXPECT_THAT(kvstore::Write(store, "b", absl::Cord("x"), options).result(),
+              MatchesKnownTimestampedStorageGeneration());
+}
+
+TEST(MemoryKeyValueStoreTest, WritebackInvalidSpec) {
+  auto context = Context::Default();
+  EXPECT_THAT(
+      kvstore::Open({{"driver", "memory"}, {"max_bytes", 10}}, context)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    ".*\"max_bytes\" requires \"base\".*"));
+  EXPECT_THAT(kvstore::Open({{"driver", "memory"},
+                             {"base", {{"driver", "memory"}}}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*same memory_key_value_store.*"));
+}
+
 TEST(MemoryKeyValueStoreTest, Open) {
   auto context = Context::Default();
 
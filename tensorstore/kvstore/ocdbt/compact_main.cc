@@ -0,0 +1,112 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include <nlohmann/json.hpp>
+#include "absl/flags/parse.h"
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/internal/path.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/compact_util.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/util/json_absl_flag.h"
+#include "tensorstore/util/result.h"
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<std::optional<tensorstore::kvstore::Spec>>,
+          kvstore, std::nullopt, "Underlying kvstore");
+ABSL_FLAG(bool, rewrite_values, true,
+          "Rewrite live values into new data files in key order");
+ABSL_FLAG(absl::Duration, version_retention, absl::Minutes(10),
+          "Retain versions superseded within this duration");
+ABSL_FLAG(bool, delete_unreferenced_data_files, true,
+          "Delete data files not referenced by any retained version");
+ABSL_FLAG(std::optional<absl::Duration>, grace_period, std::nullopt,
+          "Time to wait between listing data files and reading the manifest; "
+          "must exceed the duration of any concurrent commit, and is "
+          "required to delete unreferenced data files");
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+namespace {
+absl::Status RunCompactCommand() {
+  auto kvs_spec = absl::GetFlag(FLAGS_kvstore).value;
+  if (!kvs_spec) {
+    return absl::InvalidArgumentError("Must specify --kvstore");
+  }
+  internal::EnsureDirectoryPath(kvs_spec->path);
+  TENSORSTORE_ASSIGN_OR_RETURN(auto base_json, kvs_spec->ToJson());
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto kvs,
+      kvstore::Open({{"driver", "ocdbt"}, {"base", std::move(base_json)}})
+          .result());
+
+  CompactOptions options;
+  options.rewrite_values = absl::GetFlag(FLAGS_rewrite_values);
+  options.version_retention = absl::GetFlag(FLAGS_version_retention);
+  options.delete_unreferenced_data_files =
+      absl::GetFlag(FLAGS_delete_unreferenced_data_files);
+  options.unreferenced_data_file_grace_period =
+      absl::GetFlag(FLAGS_grace_period);
+  TENSORSTORE_ASSIGN_OR_RETURN(auto stats, Compact(kvs, options));
+  std::cout << stats << std::endl;
+  return absl::OkStatus();
+}
+}  // namespace
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);  // InitTensorstore
+  auto status = tensorstore::internal_ocdbt::RunCompactCommand();
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+
+    if (absl::IsInvalidArgument(status)) {
+      std::cerr << "Usage: " << argv[0]
+                << " --kvstore <kvstore-json-spec> [--version_retention 10m]"
+                << " [--norewrite_values]"
+                << " [--grace_period 1h | --nodelete_unreferenced_data_files]"
+                << "\n";
+      std::cerr << R"(
+The kvstore must refer to a prefix/directory containing an OCDBT database.
+
+Rewrites the live values of the latest version into new data files, removes
+versions that were superseded more than `--version_retention` ago, and deletes
+the data files that are no longer referenced.
+
+Readers that are still using a version superseded within the retention period
+are unaffected.  Deleting unreferenced data files requires `--grace_period`:
+commits from other processes that take longer than the grace period to complete
+lose their data files, which corrupts the database.  Specify `--grace_period 0`
+only if there are no concurrent writers.
+
+Example usage:
+
+bazel run //tensorstore/kvstore/ocdbt:compact -- --kvstore '"file:///tmp/ocdbt/"' --version_retention 1h --grace_period 1h
+
+)";
+      std::cerr << std::flush;
+    }
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,393 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/ocdbt/compact_util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+// Length of the random portion of the names generated by `GenerateDataFileId`.
+constexpr size_t kDataFileIdHexDigits = 32;
+
+// Checks if `key` is of the form generated by `GenerateDataFileId(prefix)`.
+//
+// Only such keys are considered for deletion, in order to avoid deleting
+// unrelated files that happen to share the data file prefix.
+bool IsGeneratedDataFileName(std::string_view key, std::string_view prefix) {
+  if (!absl::StartsWith(key, prefix)) return false;
+  key.remove_prefix(prefix.size());
+  return key.size() == kDataFileIdHexDigits &&
+         std::all_of(key.begin(), key.end(), [](char c) {
+           return absl::ascii_isdigit(c) || (c >= 'a' && c <= 'f');
+         });
+}
+
+// Rewrites all out-of-line values of the latest version, in key order.
+//
+// Each value is written back conditioned on the generation that was read, such
+// that values modified concurrently are left as is.
+absl::Status RewriteValues(OcdbtDriver& driver, const CompactOptions& options,
+                           CompactStatistics& stats) {
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto manifest_with_time,
+      driver.io_handle_->GetManifest(absl::Now()).result());
+  if (!manifest_with_time.manifest) return absl::OkStatus();
+  const uint64_t max_inline_value_bytes =
+      manifest_with_time.manifest->config.max_inline_value_bytes;
+
+  KvStore root{kvstore::DriverPtr(&driver)};
+  TENSORSTORE_ASSIGN_OR_RETURN(auto entries,
+                               kvstore::ListFuture(root).result());
+  std::sort(entries.begin(), entries.end(),
+            [](const kvstore::ListEntry& a, const kvstore::ListEntry& b) {
+              return a.key < b.key;
+            });
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&](const kvstore::ListEntry& entry) {
+                                 return entry.has_size() &&
+                                        static_cast<uint64_t>(entry.size) <=
+                                            max_inline_value_bytes;
+                               }),
+                entries.end());
+
+  for (size_t begin = 0; begin < entries.size();) {
+    size_t end = begin;
+    for (int64_t batch_bytes = 0;
+         end < entries.size() && batch_bytes < options.rewrite_batch_bytes;
+         ++end) {
+      batch_bytes += std::max(entries[end].size, int64_t{0});
+    }
+
+    std::vector<Future<kvstore::ReadResult>> read_futures;
+    {
+      kvstore::ReadOptions read_options;
+      Batch batch = Batch::New();
+      read_options.batch = batch;
+      for (size_t i = begin; i < end; ++i) {
+        read_futures.push_back(
+            kvstore::Read(root, entries[i].key, read_options));
+      }
+    }
+
+    std::vector<Future<TimestampedStorageGeneration>> write_futures;
+    for (size_t i = begin; i < end; ++i) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto read_result,
+                                   read_futures[i - begin].result());
+      if (!read_result.has_value() ||
+          read_result.value.size() <= max_inline_value_bytes) {
+        continue;
+      }
+      kvstore::WriteOptions write_options;
+      write_options.generation_conditions.if_equal =
+          std::move(read_result.stamp.generation);
+      write_futures.push_back(kvstore::Write(root, entries[i].key,
+                                             std::move(read_result.value),
+                                             std::move(write_options)));
+    }
+    for (auto& future : write_futures) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto stamp, future.result());
+      if (!StorageGeneration::IsUnknown(stamp.generation)) {
+        ++stats.num_values_rewritten;
+      }
+    }
+    begin = end;
+  }
+  return absl::OkStatus();
+}
+
+// Removes the versions outside of `options.version_retention` from the
+// manifest.
+absl::Status PruneVersions(const IoHandle& io_handle,
+                           const CompactOptions& options,
+                           CompactStatistics& stats) {
+  if (options.version_retention == absl::InfiniteDuration()) {
+    return absl::OkStatus();
+  }
+  while (true) {
+    const absl::Time now = absl::Now();
+    TENSORSTORE_ASSIGN_OR_RETURN(auto manifest_with_time,
+                                 io_handle.GetManifest(now).result());
+    if (!manifest_with_time.manifest ||
+        manifest_with_time.manifest->config.manifest_kind !=
+            ManifestKind::kSingle) {
+      // Numbered manifests are keyed by the latest generation number, and
+      // therefore cannot be replaced without adding a new generation.
+      return absl::OkStatus();
+    }
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto cutoff,
+        CommitTime::FromAbslTime(
+            std::max(now - options.version_retention, absl::UnixEpoch())));
+    GenerationNumber num_pruned;
+    auto new_manifest = std::make_shared<Manifest>(PruneManifestVersions(
+        *manifest_with_time.manifest, cutoff, num_pruned));
+    if (num_pruned == 0) return absl::OkStatus();
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto update_result,
+        io_handle
+            .TryUpdateManifest(manifest_with_time.manifest,
+                               std::move(new_manifest), now)
+            .result());
+    if (update_result.success) {
+      stats.num_versions_pruned += num_pruned;
+      return absl::OkStatus();
+    }
+    // The manifest was concurrently modified; retry with the new manifest.
+  }
+}
+
+// Adds the paths of all data files referenced by `manifest` to `referenced`.
+//
+// The version tree and the B+trees are traversed breadth-first, such that all
+// nodes at a given level are read concurrently.  B+tree nodes shared by
+// multiple versions are only visited once.
+absl::Status CollectReferencedDataFiles(
+    const ReadonlyIoHandle& io_handle, const Manifest& manifest,
+    absl::flat_hash_set<std::string>& referenced) {
+  std::vector<IndirectDataReference> btree_roots;
+  const auto add_versions =
+      [&](const VersionTreeNode::LeafNodeEntries& versions) {
+        for (const auto& version : versions) {
+          if (version.root.location.IsMissing()) continue;
+          btree_roots.push_back(version.root.location);
+        }
+      };
+  add_versions(manifest.versions);
+
+  std::vector<IndirectDataReference> version_nodes;
+  for (const auto& node_ref : manifest.version_tree_nodes) {
+    version_nodes.push_back(node_ref.location);
+  }
+  while (!version_nodes.empty()) {
+    std::vector<Future<const std::shared_ptr<const VersionTreeNode>>> futures;
+    for (const auto& location : version_nodes) {
+      referenced.insert(location.file_id.FullPath());
+      futures.push_back(io_handle.GetVersionTreeNode(location));
+    }
+    version_nodes.clear();
+    for (auto& future : futures) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto node, future.result());
+      if (auto* versions =
+              std::get_if<VersionTreeNode::LeafNodeEntries>(&node->entries)) {
+        add_versions(*versions);
+        continue;
+      }
+      for (const auto& child :
+           std::get<VersionTreeNode::InteriorNodeEntries>(node->entries)) {
+        version_nodes.push_back(child.location);
+      }
+    }
+  }
+
+  absl::flat_hash_set<std::string> visited_btree_nodes;
+  std::vector<IndirectDataReference> btree_nodes;
+  const auto add_btree_node = [&](const IndirectDataReference& location) {
+    if (visited_btree_nodes.insert(location.EncodeCacheKey()).second) {
+      btree_nodes.push_back(location);
+    }
+  };
+  for (const auto& location : btree_roots) add_btree_node(location);
+  while (!btree_nodes.empty()) {
+    std::vector<Future<const std::shared_ptr<const BtreeNode>>> futures;
+    {
+      Batch batch = Batch::New();
+      for (const auto& location : btree_nodes) {
+        referenced.insert(location.file_id.FullPath());
+        futures.push_back(io_handle.GetBtreeNode(location, batch));
+      }
+    }
+    btree_nodes.clear();
+    for (auto& future : futures) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto node, future.result());
+      if (auto* entries =
+              std::get_if<BtreeNode::LeafNodeEntries>(&node->entries)) {
+        for (const auto& entry : *entries) {
+          if (auto* location =
+                  std::get_if<IndirectDataReference>(&entry.value_reference)) {
+            referenced.insert(location->file_id.FullPath());
+          }
+        }
+        continue;
+      }
+      for (const auto& entry :
+           std::get<BtreeNode::InteriorNodeEntries>(node->entries)) {
+        add_btree_node(entry.node.location);
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Deletes the data files that are not referenced by any retained version.
+absl::Status DeleteUnreferencedDataFiles(OcdbtDriver& driver,
+                                         const CompactOptions& options,
+                                         CompactStatistics& stats) {
+  // The existing data files must be listed before the manifest is read, such
+  // that files written by commits that have not yet completed are excluded.
+  const auto& data_file_prefixes = driver.data_file_prefixes_;
+  std::vector<std::string> prefixes{data_file_prefixes.value,
+                                    data_file_prefixes.btree_node,
+                                    data_file_prefixes.version_tree_node};
+  std::sort(prefixes.begin(), prefixes.end());
+  prefixes.erase(std::unique(prefixes.begin(), prefixes.end()),
+                 prefixes.end());
+  std::vector<std::string> candidates;
+  for (const auto& prefix : prefixes) {
+    kvstore::ListOptions list_options;
+    list_options.range = KeyRange::Prefix(prefix);
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto entries,
+        kvstore::ListFuture(driver.base_, std::move(list_options)).result());
+    for (auto& entry : entries) {
+      // Since generated names have a fixed length, a key listed under more
+      // than one (nested) prefix is only matched by one of them.
+      if (IsGeneratedDataFileName(entry.key, prefix)) {
+        candidates.push_back(std::move(entry.key));
+      }
+    }
+  }
+
+  // Allows commits whose data files were listed above to complete.
+  if (*options.unreferenced_data_file_grace_period > absl::ZeroDuration()) {
+    absl::SleepFor(*options.unreferenced_data_file_grace_period);
+  }
+
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto manifest_with_time,
+      driver.io_handle_->GetManifest(absl::Now()).result());
+  absl::flat_hash_set<std::string> referenced;
+  if (manifest_with_time.manifest) {
+    TENSORSTORE_RETURN_IF_ERROR(CollectReferencedDataFiles(
+        *driver.io_handle_, *manifest_with_time.manifest, referenced));
+  }
+  stats.num_referenced_data_files = referenced.size();
+
+  std::vector<Future<TimestampedStorageGeneration>> delete_futures;
+  for (const auto& key : candidates) {
+    if (referenced.contains(key)) continue;
+    delete_futures.push_back(kvstore::Delete(driver.base_, key));
+  }
+  for (auto& future : delete_futures) {
+    TENSORSTORE_RETURN_IF_ERROR(future.result());
+  }
+  stats.num_data_files_deleted += delete_futures.size();
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const CompactStatistics& x) {
+  return os << "{num_values_rewritten=" << x.num_values_rewritten
+            << ", num_versions_pruned=" << x.num_versions_pruned
+            << ", num_referenced_data_files=" << x.num_referenced_data_files
+            << ", num_data_files_deleted=" << x.num_data_files_deleted << "}";
+}
+
+Manifest PruneManifestVersions(const Manifest& manifest, CommitTime cutoff,
+                               GenerationNumber& num_pruned) {
+  num_pruned = 0;
+  Manifest new_manifest;
+  new_manifest.config = manifest.config;
+  const auto& versions = manifest.versions;
+  const auto& version_tree_nodes = manifest.version_tree_nodes;
+  // The last generation referenced by a version tree node was superseded no
+  // later than the first commit time of the following node (or of the inline
+  // versions), since commit times are monotonically increasing.
+  for (size_t i = 0; i < version_tree_nodes.size(); ++i) {
+    const CommitTime next_commit_time =
+        (i + 1 < version_tree_nodes.size())
+            ? version_tree_nodes[i + 1].commit_time
+            : versions.front().commit_time;
+    if (next_commit_time < cutoff) {
+      num_pruned += version_tree_nodes[i].num_generations;
+      continue;
+    }
+    new_manifest.version_tree_nodes.push_back(version_tree_nodes[i]);
+  }
+  for (size_t i = 0; i < versions.size(); ++i) {
+    if (i + 1 < versions.size() && versions[i + 1].commit_time < cutoff) {
+      ++num_pruned;
+      continue;
+    }
+    new_manifest.versions.push_back(versions[i]);
+  }
+  return new_manifest;
+}
+
+Result<CompactStatistics> Compact(const KvStore& store,
+                                  const CompactOptions& options) {
+  auto* driver = dynamic_cast<OcdbtDriver*>(store.driver.get());
+  if (!driver) {
+    return absl::InvalidArgumentError(
+        "Compaction requires a kvstore using the \"ocdbt\" driver");
+  }
+  if (options.delete_unreferenced_data_files &&
+      !options.unreferenced_data_file_grace_period) {
+    return absl::InvalidArgumentError(
+        "Deleting unreferenced data files requires a grace period that exceeds "
+        "the duration of any concurrent commit");
+  }
+  CompactStatistics stats;
+  if (options.rewrite_values) {
+    TENSORSTORE_RETURN_IF_ERROR(RewriteValues(*driver, options, stats));
+  }
+  TENSORSTORE_RETURN_IF_ERROR(
+      PruneVersions(*driver->io_handle_, options, stats));
+  if (options.delete_unreferenced_data_files) {
+    TENSORSTORE_RETURN_IF_ERROR(
+        DeleteUnreferencedDataFiles(*driver, options, stats));
+  }
+  return stats;
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
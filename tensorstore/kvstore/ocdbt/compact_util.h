@@ -0,0 +1,136 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_COMPACT_UTIL_H_
+#define TENSORSTORE_KVSTORE_OCDBT_COMPACT_UTIL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iosfwd>
+#include <optional>
+
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Options for `Compact`.
+struct CompactOptions {
+  /// Rewrite all live values that are stored out-of-line into new data files,
+  /// in key order.  All B+tree nodes of the latest version are rewritten as a
+  /// consequence.
+  bool rewrite_values = true;
+
+  /// Maximum total size of the values that are rewritten by a single commit.
+  int64_t rewrite_batch_bytes = int64_t{64} << 20;
+
+  /// Versions that were superseded by a later version more than
+  /// `version_retention` ago are removed from the version tree.  The latest
+  /// version is always retained.
+  ///
+  /// Readers that obtained the manifest within the retention window may still
+  /// be reading a superseded version; its data files are only deleted once it
+  /// falls outside the window.  Specify `absl::InfiniteDuration()` to retain
+  /// all versions.
+  ///
+  /// Versions are only pruned from databases using the ``"single"``
+  /// manifest kind.
+  absl::Duration version_retention = absl::Minutes(10);
+
+  /// Delete data files that are not referenced by any retained version.
+  ///
+  /// Requires that `unreferenced_data_file_grace_period` is specified.
+  bool delete_unreferenced_data_files = true;
+
+  /// Time to wait between listing the existing data files and determining the
+  /// set of referenced data files.
+  ///
+  /// A concurrent writer writes the data files of a commit before the
+  /// manifest update that references them.  Data files that exist when they
+  /// are listed, but whose commit does not complete within this period, are
+  /// deleted, which corrupts the database once that commit completes.  Data
+  /// files written after they are listed are never deleted.
+  ///
+  /// There is no safe default: the period must exceed the time that any
+  /// concurrent writer may take to complete a commit.  Specify
+  /// `absl::ZeroDuration()` only if there are no concurrent writers.
+  std::optional<absl::Duration> unreferenced_data_file_grace_period;
+};
+
+/// Statistics returned by `Compact`.
+struct CompactStatistics {
+  /// Number of values rewritten into new data files.
+  int64_t num_values_rewritten = 0;
+
+  /// Number of versions removed from the version tree.
+  GenerationNumber num_versions_pruned = 0;
+
+  /// Number of data files that were found to be referenced.
+  int64_t num_referenced_data_files = 0;
+
+  /// Number of unreferenced data files deleted.
+  int64_t num_data_files_deleted = 0;
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const CompactStatistics& x);
+};
+
+/// Compacts an OCDBT database and reclaims the storage used by old versions.
+///
+/// The following steps are performed:
+///
+/// 1. If `options.rewrite_values` is `true`, all live out-of-line values are
+///    read and conditionally written back, which places them in new, large
+///    data files in key order.  Values concurrently modified by another writer
+///    are skipped.
+///
+/// 2. Versions outside of `options.version_retention` are removed from the
+///    manifest.
+///
+/// 3. If `options.delete_unreferenced_data_files` is `true`, the data files
+///    under the configured data file prefixes that are not referenced from
+///    any retained version are deleted, after waiting for
+///    `options.unreferenced_data_file_grace_period`.
+///
+/// Blocks until compaction completes.
+///
+/// \param store Open kvstore using the ``"ocdbt"`` driver (the path is
+///     ignored).
+/// \error `absl::StatusCode::kInvalidArgument` if `store` does not use the
+///     ``"ocdbt"`` driver.
+/// \error `absl::StatusCode::kInvalidArgument` if
+///     `options.delete_unreferenced_data_files` is `true` but
+///     `options.unreferenced_data_file_grace_period` is not specified.
+Result<CompactStatistics> Compact(const KvStore& store,
+                                  const CompactOptions& options = {});
+
+/// Returns a copy of `manifest` from which all versions that were superseded
+/// before `cutoff` have been removed.
+///
+/// Versions that are referenced from version tree nodes are only removed if
+/// the entire subtree can be removed.
+///
+/// \param num_pruned[out] Set to the number of removed versions.
+Manifest PruneManifestVersions(const Manifest& manifest, CommitTime cutoff,
+                               GenerationNumber& num_pruned);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_COMPACT_UTIL_H_
@@ -0,0 +1,269 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/ocdbt/compact_util.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/ocdbt/format/manifest.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/list_versions.h"
+#include "tensorstore/kvstore/ocdbt/test_util.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::Context;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal_ocdbt::BtreeGenerationReference;
+using ::tensorstore::internal_ocdbt::CommitTime;
+using ::tensorstore::internal_ocdbt::Compact;
+using ::tensorstore::internal_ocdbt::CompactOptions;
+using ::tensorstore::internal_ocdbt::GenerationNumber;
+using ::tensorstore::internal_ocdbt::GetOcdbtIoHandle;
+using ::tensorstore::internal_ocdbt::IoHandle;
+using ::tensorstore::internal_ocdbt::ListVersionsFuture;
+using ::tensorstore::internal_ocdbt::Manifest;
+using ::tensorstore::internal_ocdbt::OcdbtDriver;
+using ::tensorstore::internal_ocdbt::PruneManifestVersions;
+using ::tensorstore::internal_ocdbt::ReadManifest;
+using ::tensorstore::internal_ocdbt::VersionNodeReference;
+
+BtreeGenerationReference MakeVersion(GenerationNumber generation_number,
+                                     CommitTime::Value commit_time) {
+  BtreeGenerationReference version{};
+  version.generation_number = generation_number;
+  version.commit_time = CommitTime{commit_time};
+  return version;
+}
+
+std::vector<GenerationNumber> GetGenerationNumbers(const Manifest& manifest) {
+  std::vector<GenerationNumber> generation_numbers;
+  for (const auto& version : manifest.versions) {
+    generation_numbers.push_back(version.generation_number);
+  }
+  return generation_numbers;
+}
+
+TEST(PruneManifestVersionsTest, InlineVersions) {
+  Manifest manifest;
+  manifest.versions = {MakeVersion(1, 10), MakeVersion(2, 20),
+                       MakeVersion(3, 30), MakeVersion(4, 40)};
+  GenerationNumber num_pruned;
+  auto pruned = PruneManifestVersions(manifest, CommitTime{25}, num_pruned);
+  EXPECT_EQ(1, num_pruned);
+  EXPECT_THAT(GetGenerationNumbers(pruned), ::testing::ElementsAre(2, 3, 4));
+
+  // The latest version is always retained.
+  pruned = PruneManifestVersions(manifest, CommitTime::max(), num_pruned);
+  EXPECT_EQ(3, num_pruned);
+  EXPECT_THAT(GetGenerationNumbers(pruned), ::testing::ElementsAre(4));
+
+  pruned = PruneManifestVersions(manifest, CommitTime{0}, num_pruned);
+  EXPECT_EQ(0, num_pruned);
+  EXPECT_EQ(manifest, pruned);
+}
+
+TEST(PruneManifestVersionsTest, VersionTreeNodes) {
+  Manifest manifest;
+  manifest.config.version_tree_arity_log2 = 1;
+  VersionNodeReference height2_ref{};
+  height2_ref.generation_number = 4;
+  height2_ref.height = 2;
+  height2_ref.num_generations = 4;
+  height2_ref.commit_time = CommitTime{10};
+  VersionNodeReference height1_ref{};
+  height1_ref.generation_number = 6;
+  height1_ref.height = 1;
+  height1_ref.num_generations = 2;
+  height1_ref.commit_time = CommitTime{50};
+  manifest.version_tree_nodes = {height2_ref, height1_ref};
+  manifest.versions = {MakeVersion(7, 70)};
+
+  GenerationNumber num_pruned;
+  // Generation 4 was superseded no later than time 50.
+  auto pruned = PruneManifestVersions(manifest, CommitTime{50}, num_pruned);
+  EXPECT_EQ(0, num_pruned);
+  EXPECT_EQ(manifest, pruned);
+
+  pruned = PruneManifestVersions(manifest, CommitTime{51}, num_pruned);
+  EXPECT_EQ(4, num_pruned);
+  EXPECT_THAT(pruned.version_tree_nodes, ::testing::ElementsAre(height1_ref));
+  EXPECT_EQ(manifest.versions, pruned.versions);
+
+  pruned = PruneManifestVersions(manifest, CommitTime{71}, num_pruned);
+  EXPECT_EQ(6, num_pruned);
+  EXPECT_THAT(pruned.version_tree_nodes, ::testing::ElementsAre());
+  EXPECT_EQ(manifest.versions, pruned.versions);
+}
+
+// Returns the keys in the data file directory of the base kvstore.
+std::vector<std::string> ListDataFiles(const kvstore::KvStore& base) {
+  std::vector<std::string> keys;
+  kvstore::ListOptions options;
+  options.range = tensorstore::KeyRange::Prefix("d/");
+  for (auto& entry : kvstore::ListFuture(base, options).value()) {
+    keys.push_back(entry.key);
+  }
+  return keys;
+}
+
+class CompactTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        base_, kvstore::Open("memory://", context_).result());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        store_,
+        kvstore::Open({{"driver", "ocdbt"},
+                       {"base", "memory://"},
+                       {"config",
+                        {{"max_inline_value_bytes", 0},
+                         {"version_tree_arity_log2", 1}}}},
+                      context_)
+            .result());
+    for (int i = 0; i < 3; ++i) {
+      for (const char* key : {"a", "b", "c"}) {
+        TENSORSTORE_ASSERT_OK(kvstore::Write(
+            store_, key, absl::Cord(absl::StrFormat("%s%d", key, i))));
+      }
+    }
+  }
+
+  void ExpectLatestValues() {
+    for (const char* key : {"a", "b", "c"}) {
+      EXPECT_THAT(kvstore::Read(store_, key).result(),
+                  MatchesKvsReadResult(absl::Cord(absl::StrFormat("%s2", key))))
+          << key;
+    }
+  }
+
+  IoHandle::Ptr GetIoHandle() { return GetOcdbtIoHandle(*store_.driver); }
+
+  Context context_ = Context::Default();
+  kvstore::KvStore base_;
+  kvstore::KvStore store_;
+};
+
+TEST_F(CompactTest, PruneAllSupersededVersions) {
+  const size_t num_data_files = ListDataFiles(base_).size();
+  // Files unrelated to the database are never deleted.
+  TENSORSTORE_ASSERT_OK(kvstore::Write(base_, "d/other", absl::Cord("x")));
+
+  CompactOptions options;
+  // There are no concurrent writers.
+  options.unreferenced_data_file_grace_period = absl::ZeroDuration();
+  options.version_retention = absl::ZeroDuration();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats, Compact(store_, options));
+  EXPECT_EQ(3, stats.num_values_rewritten);
+  // The initial empty version, 9 writes, and at least one rewrite commit.
+  EXPECT_GE(stats.num_versions_pruned, 10);
+  EXPECT_GE(stats.num_data_files_deleted, num_data_files);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto manifest, ReadManifest(static_cast<OcdbtDriver&>(*store_.driver)));
+  ASSERT_TRUE(manifest);
+  EXPECT_THAT(manifest->versions, ::testing::SizeIs(1));
+  EXPECT_THAT(manifest->version_tree_nodes, ::testing::ElementsAre());
+  EXPECT_THAT(ListVersionsFuture(GetIoHandle()).result(),
+              ::testing::Optional(::testing::SizeIs(1)));
+  EXPECT_THAT(ListDataFiles(base_),
+              ::testing::SizeIs(stats.num_referenced_data_files + 1));
+  ExpectLatestValues();
+
+  // The database can still be written after compaction.
+  for (int i = 0; i < 4; ++i) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store_, "d", absl::Cord("d0")));
+  }
+  EXPECT_THAT(kvstore::Read(store_, "d").result(),
+              MatchesKvsReadResult(absl::Cord("d0")));
+  ExpectLatestValues();
+  EXPECT_THAT(ListVersionsFuture(GetIoHandle()).result(),
+              ::testing::Optional(::testing::SizeIs(5)));
+}
+
+TEST_F(CompactTest, RetainAllVersions) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto versions,
+                                   ListVersionsFuture(GetIoHandle()).result());
+  CompactOptions options;
+  // There are no concurrent writers.
+  options.unreferenced_data_file_grace_period = absl::ZeroDuration();
+  options.rewrite_values = false;
+  options.version_retention = absl::InfiniteDuration();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats, Compact(store_, options));
+  EXPECT_EQ(0, stats.num_values_rewritten);
+  EXPECT_EQ(0, stats.num_versions_pruned);
+  // Only version tree nodes that were replaced by later copies can have become
+  // unreferenced.
+  EXPECT_THAT(ListDataFiles(base_),
+              ::testing::SizeIs(stats.num_referenced_data_files));
+  EXPECT_THAT(ListVersionsFuture(GetIoHandle()).result(),
+              ::testing::Optional(versions));
+  ExpectLatestValues();
+}
+
+TEST_F(CompactTest, RetainRecentVersions) {
+  CompactOptions options;
+  // There are no concurrent writers.
+  options.unreferenced_data_file_grace_period = absl::ZeroDuration();
+  options.version_retention = absl::Hours(1);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats, Compact(store_, options));
+  EXPECT_EQ(3, stats.num_values_rewritten);
+  EXPECT_EQ(0, stats.num_versions_pruned);
+  EXPECT_THAT(ListDataFiles(base_),
+              ::testing::SizeIs(stats.num_referenced_data_files));
+  ExpectLatestValues();
+}
+
+TEST_F(CompactTest, GracePeriodRequired) {
+  const size_t num_data_files = ListDataFiles(base_).size();
+  EXPECT_THAT(Compact(store_),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*requires a grace period.*"));
+  EXPECT_THAT(ListDataFiles(base_), ::testing::SizeIs(num_data_files));
+
+  CompactOptions options;
+  options.rewrite_values = false;
+  options.delete_unreferenced_data_files = false;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats, Compact(store_, options));
+  EXPECT_EQ(0, stats.num_data_files_deleted);
+  ExpectLatestValues();
+}
+
+TEST(CompactInvalidTest, NotOcdbt) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto store,
+                                   kvstore::Open("memory://").result());
+  EXPECT_THAT(Compact(store),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            ".*\"ocdbt\" driver.*"));
+}
+
+}  // namespace
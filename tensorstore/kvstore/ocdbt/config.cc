@@ -17,13 +17,16 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include <nlohmann/json.hpp>
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/zstd_dictionary.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/enum.h"
@@ -31,6 +34,8 @@
 #include "tensorstore/internal/json_binding/raw_bytes_hex.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/json_binding/std_variant.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
+#include "tensorstore/kvstore/ocdbt/format/codec_util.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
 #include "tensorstore/kvstore/supported_features.h"
@@ -42,8 +47,19 @@ namespace tensorstore {
 namespace internal_ocdbt {
 
 namespace jb = ::tensorstore::internal_json_binding;
-
 constexpr auto NoCompressionJsonBinder = jb::Constant([] { return nullptr; });
+
+/// Binds a zstd dictionary as a base64-encoded string, omitted if empty.
+constexpr auto ZstdDictionaryJsonBinder = jb::Validate(
+    [](const auto& options, std::string* obj) {
+      if (!obj->empty() && GetZstdDictionaryId(*obj) == 0) {
+        return absl::InvalidArgumentError(
+            "Expected zstd dictionary with a non-zero dictionary ID");
+      }
+      return absl::OkStatus();
+    },
+    internal::ZstdDictionaryJsonBinder);
+
 constexpr auto ZstdCompressionJsonBinder = jb::Object(
     jb::Member("id", jb::Constant([] { return "zstd"; })),
     jb::Member(
@@ -51,9 +67,22 @@ constexpr auto ZstdCompressionJsonBinder = jb::Object(
         jb::Projection<&Config::ZstdCompression::level>(
             jb::DefaultInitializedValue(jb::Integer<int32_t>(
                 riegeli::ZstdWriterBase::Options::kMinCompressionLevel,
-                riegeli::ZstdWriterBase::Options::kMaxCompressionLevel)))));
+                riegeli::ZstdWriterBase::Options::kMaxCompressionLevel)))),
+    jb::Member("dictionary",
+               jb::GetterSetter<std::string>(
+                   [](const Config::ZstdCompression& x) {
+                     return x.dictionary.data();
+                   },
+                   [](Config::ZstdCompression& x, std::string dictionary) {
+                     x.dictionary =
+                         Config::ZstdDictionary(std::move(dictionary));
+                   },
+                   ZstdDictionaryJsonBinder)));
+constexpr auto Lz4CompressionJsonBinder =
+    jb::Object(jb::Member("id", jb::Constant([] { return "lz4"; })));
 constexpr auto ConfigCompressionJsonBinder =
-    jb::Variant(NoCompressionJsonBinder, ZstdCompressionJsonBinder);
+    jb::Variant(NoCompressionJsonBinder, ZstdCompressionJsonBinder,
+                Lz4CompressionJsonBinder);
 
 constexpr auto ManifestKindJsonBinder = [](auto is_loading, const auto& options,
                                            auto* obj, auto* j) {
@@ -86,7 +115,15 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                            jb::Integer<uint8_t>(1, kMaxVersionTreeArityLog2)))),
         jb::Member("compression",
                    jb::Projection<&ConfigConstraints::compression>(
-                       jb::Optional(ConfigCompressionJsonBinder)))))
+                       jb::Optional(ConfigCompressionJsonBinder))),
+        jb::Member(
+            "bloom_filter_bits_per_key",
+            jb::Projection<&ConfigConstraints::bloom_filter_bits_per_key>(
+                jb::Optional(
+                    jb::Integer<uint32_t>(0, kMaxBloomFilterBitsPerKey)))),
+        jb::Member(
+            "max_decoded_leaf_node_bytes",
+            jb::Projection<&ConfigConstraints::max_decoded_leaf_node_bytes>())))
 
 void to_json(::nlohmann::json& j, const Config::Compression& compression) {
   ConfigCompressionJsonBinder(/*is_loading=*/std::false_type{},
@@ -129,6 +166,8 @@ absl::Status ValidateConfig(const Config& config,
   TENSORTORE_INTERNAL_DO_VALIDATE(max_decoded_node_bytes)
   TENSORTORE_INTERNAL_DO_VALIDATE(version_tree_arity_log2)
   TENSORTORE_INTERNAL_DO_VALIDATE(compression)
+  TENSORTORE_INTERNAL_DO_VALIDATE(bloom_filter_bits_per_key)
+  TENSORTORE_INTERNAL_DO_VALIDATE(max_decoded_leaf_node_bytes)
 
 #undef TENSORTORE_INTERNAL_DO_VALIDATE
 
@@ -172,6 +211,12 @@ absl::Status CreateConfig(const ConfigConstraints& constraints,
       default_config.version_tree_arity_log2);
   config.compression =
       constraints.compression.value_or(default_config.compression);
+  config.bloom_filter_bits_per_key =
+      constraints.bloom_filter_bits_per_key.value_or(
+          default_config.bloom_filter_bits_per_key);
+  config.max_decoded_leaf_node_bytes =
+      constraints.max_decoded_leaf_node_bytes.value_or(
+          default_config.max_decoded_leaf_node_bytes);
   return absl::OkStatus();
 }
 
@@ -180,7 +225,16 @@ ConfigConstraints::ConfigConstraints(const Config& config)
       max_inline_value_bytes(config.max_inline_value_bytes),
       max_decoded_node_bytes(config.max_decoded_node_bytes),
       version_tree_arity_log2(config.version_tree_arity_log2),
-      compression(config.compression) {}
+      compression(config.compression) {
+  // Only constrain `bloom_filter_bits_per_key` when filters are enabled, so
+  // that databases without filters continue to have the same spec.
+  if (config.bloom_filter_bits_per_key != 0) {
+    bloom_filter_bits_per_key = config.bloom_filter_bits_per_key;
+  }
+  if (config.max_decoded_leaf_node_bytes != 0) {
+    max_decoded_leaf_node_bytes = config.max_decoded_leaf_node_bytes;
+  }
+}
 
 Result<ConfigStatePtr> ConfigState::Make(
     const ConfigConstraints& constraints,
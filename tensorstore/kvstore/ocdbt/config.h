@@ -41,6 +41,8 @@ struct ConfigConstraints {
   std::optional<uint32_t> max_decoded_node_bytes;
   std::optional<uint8_t> version_tree_arity_log2;
   std::optional<Config::Compression> compression;
+  std::optional<uint32_t> bloom_filter_bits_per_key;
+  std::optional<uint32_t> max_decoded_leaf_node_bytes;
 
   friend bool operator==(const ConfigConstraints& a,
                          const ConfigConstraints& b);
@@ -56,7 +58,8 @@ struct ConfigConstraints {
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(x.uuid, x.manifest_kind, x.max_inline_value_bytes,
              x.max_decoded_node_bytes, x.version_tree_arity_log2,
-             x.compression);
+             x.compression, x.bloom_filter_bits_per_key,
+             x.max_decoded_leaf_node_bytes);
   };
 };
 
@@ -243,6 +243,12 @@ class DistributedBtreeWriter : public BtreeWriter {
   // coordinator server.  Currently defined as SHA256 hash of the base kvstore
   // JSON spec.
   std::string storage_identifier_;
+
+  // Whether to publish new root generations to the coordinator server.
+  bool publish_manifests_ = false;
+
+  // Passed to the cooperator, see `DistributedBtreeWriterOptions`.
+  absl::Duration group_commit_window_ = absl::ZeroDuration();
 };
 
 struct WriterCommitOperation
@@ -392,6 +398,8 @@ void WriterCommitOperation::StartCommit(DistributedBtreeWriter& writer,
     cooperator_options.security = writer.security_;
     cooperator_options.lease_duration = writer.lease_duration_;
     cooperator_options.storage_identifier = writer.storage_identifier_;
+    cooperator_options.publish_manifests = writer.publish_manifests_;
+    cooperator_options.group_commit_window = writer.group_commit_window_;
     TENSORSTORE_ASSIGN_OR_RETURN(
         writer.cooperator_,
         internal_ocdbt_cooperator::Start(std::move(cooperator_options)),
@@ -789,6 +797,8 @@ BtreeWriterPtr MakeDistributedBtreeWriter(
   assert(writer->security_);
   writer->lease_duration_ = options.lease_duration;
   writer->storage_identifier_ = std::move(options.storage_identifier);
+  writer->publish_manifests_ = options.publish_manifests;
+  writer->group_commit_window_ = options.group_commit_window;
   return writer;
 }
 
@@ -34,6 +34,14 @@ struct DistributedBtreeWriterOptions {
 
   // Unique identifier of base kvstore, e.g. base kvstore JSON spec.
   std::string storage_identifier;
+
+  // Publish each new root generation to the coordinator, for use by readers
+  // subscribed via `SubscribeToManifestNotifications`.
+  bool publish_manifests = false;
+
+  // Maximum time that mutations received by the lease holder for a B+tree node
+  // are held back so that they can be committed together.
+  absl::Duration group_commit_window = absl::ZeroDuration();
 };
 
 BtreeWriterPtr MakeDistributedBtreeWriter(
@@ -83,6 +83,11 @@ struct Options {
   // Unique identifier of base kvstore.  Currently defined as SHA256 hash of
   // the base kvstore JSON spec.
   std::string storage_identifier;
+  // Publish each new root generation to the coordinator.
+  bool publish_manifests = false;
+  // Maximum delay before committing mutations to a leased node, in order to
+  // group mutations that arrive close together into a single commit.
+  absl::Duration group_commit_window = absl::ZeroDuration();
 };
 
 struct Cooperator;
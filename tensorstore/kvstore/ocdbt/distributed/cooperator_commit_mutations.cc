@@ -17,8 +17,13 @@
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorstore/internal/grpc/utils.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator_impl.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/create_new_manifest.h"
 #include "tensorstore/kvstore/ocdbt/non_distributed/storage_generation.h"
@@ -29,7 +34,22 @@ namespace tensorstore {
 namespace internal_ocdbt_cooperator {
 namespace {
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
-}
+
+auto& commit_batch_size =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
+        "/tensorstore/kvstore/ocdbt/cooperator/commit_batch_size",
+        internal_metrics::MetricMetadata(
+            "Number of mutations applied by each successful commit of a "
+            "leased OCDBT B+tree node."));
+
+auto& commit_wait_time_ms =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
+        "/tensorstore/kvstore/ocdbt/cooperator/commit_wait_time_ms",
+        internal_metrics::MetricMetadata(
+            "Time (ms) from receiving the oldest mutation for a leased OCDBT "
+            "B+tree node until it is staged for commit.",
+            internal_metrics::Units::kMilliseconds));
+}  // namespace
 
 using NodeMutationRequests = Cooperator::NodeMutationRequests;
 
@@ -425,6 +445,11 @@ void NodeCommitOperation::StagePending() {
       << "[Port=" << server->listening_port_
       << "] StagePending: initial staged=" << staged.requests.size()
       << ", pending=" << mutation_requests->pending.requests.size();
+  if (mutation_requests->pending_since != absl::InfiniteFuture()) {
+    commit_wait_time_ms.Observe(absl::ToInt64Milliseconds(
+        absl::Now() - mutation_requests->pending_since));
+    mutation_requests->pending_since = absl::InfiniteFuture();
+  }
   staged.Append(std::move(mutation_requests->pending));
   ABSL_LOG_IF(INFO, ocdbt_logging)
       << "[Port=" << server->listening_port_
@@ -452,6 +477,7 @@ void NodeCommitOperation::SetSuccess(GenerationNumber root_generation,
       << "[Port=" << server->listening_port_
       << "] SetSuccess: root_generation=" << root_generation
       << ", time=" << time;
+  commit_batch_size.Observe(staged.requests.size());
   for (auto& request : staged.requests) {
     if (request.index_within_batch != 0) continue;
     auto& p = request.batch_promise;
@@ -801,6 +827,8 @@ void NodeCommitOperation::WriteNewManifest(NodeCommitOperation::Ptr commit_op) {
           RetryCommit(std::move(commit_op));
           return;
         }
+        PublishManifest(*commit_op->server,
+                        commit_op->new_manifest->latest_generation());
         commit_op->SetSuccess(commit_op->new_manifest->latest_generation(),
                               r->time);
       });
@@ -831,12 +859,30 @@ void MaybeCommit(Cooperator& server,
     }
     lock = UniqueWriterLock{mutation_requests->mutex};
   }
+  const absl::Time now = absl::Now();
+  if (mutation_requests->pending_since == absl::InfiniteFuture()) {
+    mutation_requests->pending_since = now;
+  }
   if (mutation_requests->commit_in_progress) return;
   mutation_requests->commit_in_progress = true;
+  // Requests that arrive before the commit starts are staged along with the
+  // existing pending requests.
+  const absl::Time commit_time =
+      mutation_requests->pending_since + server.group_commit_window_;
   lock.unlock();
   auto commit_op = internal::MakeIntrusivePtr<NodeCommitOperation>();
   commit_op->server.reset(&server);
   commit_op->mutation_requests = std::move(mutation_requests);
+  if (commit_time > now) {
+    internal::ScheduleAt(commit_time,
+                         [commit_op = std::move(commit_op)]() mutable {
+                           NodeCommitOperation::StartCommit(
+                               std::move(commit_op),
+                               /*manifest_staleness_bound=*/
+                               absl::InfinitePast());
+                         });
+    return;
+  }
   NodeCommitOperation::StartCommit(
       std::move(commit_op), /*manifest_staleness_bound=*/absl::InfinitePast());
 }
@@ -28,9 +28,11 @@
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "grpcpp/client_context.h"  // third_party
 #include "grpcpp/server.h"  // third_party
 #include "grpcpp/support/server_callback.h"  // third_party
 #include "grpcpp/support/status.h"  // third_party
+#include "tensorstore/internal/grpc/utils.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/driver.h"
@@ -127,5 +129,29 @@ absl::Status ManifestUnexpectedlyDeletedError(Cooperator& server) {
       absl::FailedPreconditionError("Manifest unexpectedly deleted"));
 }
 
+void PublishManifest(Cooperator& server,
+                     internal_ocdbt::GenerationNumber root_generation) {
+  if (!server.publish_manifests_) return;
+  struct PublishState {
+    grpc::ClientContext client_context;
+    grpc_gen::PublishManifestRequest request;
+    grpc_gen::PublishManifestResponse response;
+  };
+  auto state = std::make_shared<PublishState>();
+  auto key = internal_ocdbt::BtreeNodeIdentifier::Root().GetKey(
+      server.storage_identifier_);
+  state->request.set_key(key.data(), key.size());
+  state->request.set_root_generation(root_generation);
+  auto* state_ptr = state.get();
+  server.coordinator_stub_->async()->PublishManifest(
+      &state_ptr->client_context, &state_ptr->request, &state_ptr->response,
+      [state = std::move(state)](::grpc::Status s) {
+        ABSL_LOG_IF(INFO, ocdbt_logging)
+            << "PublishManifest: root_generation="
+            << state->request.root_generation() << ": "
+            << internal::GrpcStatusToAbslStatus(std::move(s));
+      });
+}
+
 }  // namespace internal_ocdbt_cooperator
 }  // namespace tensorstore
@@ -38,6 +38,7 @@
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.grpc.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/lease_cache_for_cooperator.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
@@ -79,6 +80,10 @@ struct Cooperator : public grpc_gen::Cooperator::CallbackService,
     PendingRequests pending;
     bool commit_in_progress = false;
 
+    // Time at which the oldest request in `pending` was added, or
+    // `absl::InfiniteFuture()` if `pending` is empty.
+    absl::Time pending_since = absl::InfiniteFuture();
+
     NodeKey node_key() const {
       return {lease_node->key, node_identifier.height};
     }
@@ -135,6 +140,14 @@ struct Cooperator : public grpc_gen::Cooperator::CallbackService,
   // Storage identifier used for computing lease keys.
   std::string storage_identifier_;
 
+  // Used to publish new root generations, if `publish_manifests_` is `true`.
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> coordinator_stub_;
+  bool publish_manifests_ = false;
+
+  // Commits are delayed until this long after the oldest pending request was
+  // received, so that concurrent requests are merged into a single commit.
+  absl::Duration group_commit_window_ = absl::ZeroDuration();
+
   absl::Mutex mutex_;
   Future<const absl::Time> manifest_available_;
 
@@ -170,6 +183,12 @@ bool ShouldRevokeLeaseAndRetryAfterError(const absl::Status& status);
 // previously successfully read.
 absl::Status ManifestUnexpectedlyDeletedError(Cooperator& server);
 
+// Notifies the coordinator, if enabled, that `root_generation` has been
+// written.  Errors are ignored, since notifications only serve to improve
+// caching by readers.
+void PublishManifest(Cooperator& server,
+                     internal_ocdbt::GenerationNumber root_generation);
+
 }  // namespace internal_ocdbt_cooperator
 }  // namespace tensorstore
 
@@ -65,10 +65,13 @@ Result<CooperatorPtr> Start(Options&& options) {
   {
     LeaseCacheForCooperator::Options cache_options;
     cache_options.clock = impl->clock_;
-    cache_options.coordinator_stub =
+    impl->coordinator_stub_ =
         tensorstore::internal_ocdbt::grpc_gen::Coordinator::NewStub(
             grpc::CreateChannel(options.coordinator_address,
                                 options.security->GetClientCredentials()));
+    impl->publish_manifests_ = options.publish_manifests;
+    impl->group_commit_window_ = options.group_commit_window;
+    cache_options.coordinator_stub = impl->coordinator_stub_;
     cache_options.security = options.security;
     cache_options.cooperator_port = impl->listening_port_;
     cache_options.lease_duration = options.lease_duration;
@@ -18,6 +18,8 @@
 #include "riegeli/bytes/string_writer.h"
 #include "tensorstore/internal/grpc/utils.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
+#include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/kvstore/ocdbt/distributed/cooperator_impl.h"
 #include "tensorstore/util/division.h"
 #include "tensorstore/util/quote_string.h"
@@ -26,7 +28,20 @@ namespace tensorstore {
 namespace internal_ocdbt_cooperator {
 namespace {
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+auto& lease_mutations = internal_metrics::Counter<int64_t, int>::New(
+    "/tensorstore/kvstore/ocdbt/cooperator/lease_mutations", "height",
+    internal_metrics::MetricMetadata(
+        "Number of mutations applied to OCDBT B+tree nodes leased by this "
+        "cooperator, by node height."));
+
+// Accounts for `num_mutations` mutations applied under `lease_node`.
+void RecordLeaseMutations(const LeaseCacheForCooperator::LeaseNode& lease_node,
+                          BtreeNodeHeight height, size_t num_mutations) {
+  lease_node.num_mutations.fetch_add(num_mutations, std::memory_order_relaxed);
+  lease_mutations.IncrementBy(num_mutations, height);
 }
+}  // namespace
 
 // Asynchronous state for submitting a mutation batch for a particular B+tree
 // node (`SubmitMutationBatch`).
@@ -117,6 +132,8 @@ struct SubmitMutationBatchOperation
         << "SubmitMutationBatch: HandleRequestLocally: "
         << state->node_identifier;
     auto& mutation_requests = state->batch_request.mutations;
+    RecordLeaseMutations(*state->lease_node, state->node_identifier.height,
+                         mutation_requests.size());
     std::vector<PendingRequest> pending_requests(mutation_requests.size());
     for (size_t i = 0; i < pending_requests.size(); ++i) {
       auto& mutation_request = mutation_requests[i];
@@ -293,6 +310,7 @@ void EnqueueWriteRequest(Cooperator& server,
             grpc::StatusCode::INTERNAL,
             tensorstore::StrCat("Failed to decode write request: ", _)))));
   }
+  RecordLeaseMutations(lease_node, node_height, batch.requests.size());
   auto mutation_requests =
       server.GetNodeMutationRequests(lease_node, node_height);
   future.ExecuteWhenReady([reactor, response](
@@ -20,6 +20,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_log.h"
 #include "absl/meta/type_traits.h"
 #include "absl/status/status.h"
@@ -47,6 +49,7 @@
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/coordinator.pb.h"
@@ -71,6 +74,8 @@ struct LeaseNode : public LeaseTree::NodeBase {
   std::string owner;
   absl::Time expiration_time;
   uint64_t lease_id;
+  // Mutations per second most recently reported by `owner`.
+  double mutation_rate = 0;
 };
 }  // namespace
 
@@ -84,7 +89,20 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                        internal_ocdbt::RpcSecurityMethodJsonBinder)),
         jb::Member("bind_addresses",
                    jb::Projection<&CoordinatorServer::Spec::bind_addresses>(
-                       jb::DefaultInitializedValue()))));
+                       jb::DefaultInitializedValue())),
+        jb::Member(
+            "experimental_lease_rebalance_ratio",
+            jb::Projection<
+                &CoordinatorServer::Spec::experimental_lease_rebalance_ratio>(
+                jb::Optional(jb::Validate(
+                    [](const auto& options, double* ratio) {
+                      if (!(*ratio > 1)) {
+                        return absl::InvalidArgumentError(
+                            "Must be greater than 1");
+                      }
+                      return absl::OkStatus();
+                    },
+                    jb::FloatBinder))))));
 
 CoordinatorServer::CoordinatorServer() = default;
 CoordinatorServer::~CoordinatorServer() = default;
@@ -94,6 +112,8 @@ CoordinatorServer& CoordinatorServer::operator=(CoordinatorServer&&) = default;
 class CoordinatorServer::Impl
     : public internal_ocdbt::grpc_gen::Coordinator::CallbackService {
  public:
+  ~Impl();
+
   std::vector<int> listening_ports_;
   std::unique_ptr<grpc::Server> server_;
   internal_ocdbt::RpcSecurityMethod::Ptr security_;
@@ -104,16 +124,149 @@ class CoordinatorServer::Impl
       const internal_ocdbt::grpc_gen::LeaseRequest* request,
       internal_ocdbt::grpc_gen::LeaseResponse* response) override;
 
+  grpc::ServerUnaryReactor* PublishManifest(
+      grpc::CallbackServerContext* context,
+      const internal_ocdbt::grpc_gen::PublishManifestRequest* request,
+      internal_ocdbt::grpc_gen::PublishManifestResponse* response) override;
+
+  grpc::ServerWriteReactor<internal_ocdbt::grpc_gen::ManifestNotification>*
+  SubscribeManifest(
+      grpc::CallbackServerContext* context,
+      const internal_ocdbt::grpc_gen::SubscribeManifestRequest* request)
+      override;
+
   void PurgeExpiredLeases() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Updates `load_by_owner_` for a lease that is removed from, or added to,
+  // `node.owner`.
+  void RemoveOwnerLoad(const LeaseNode& node)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void AddOwnerLoad(const LeaseNode& node)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns `true` if the active lease `node` should be transferred to
+  // `requester` according to `rebalance_ratio_`.
+  bool ShouldTransferLease(const LeaseNode& node, const std::string& requester)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  class ManifestSubscriber;
+
+  // Total load of the active leases owned by a single cooperator.
+  struct OwnerLoad {
+    size_t num_leases = 0;
+    double mutation_rate = 0;
+  };
+
+  // Latest published manifest generation and subscribers for a single key.
+  struct ManifestTopic {
+    uint64_t latest_generation = 0;
+    absl::flat_hash_set<ManifestSubscriber*> subscribers;
+  };
+
   absl::Mutex mutex_;
   LeaseTree leases_by_expiration_time_ ABSL_GUARDED_BY(mutex_);
   using LeaseSet =
       internal::HeterogeneousHashSet<std::unique_ptr<LeaseNode>,
                                      std::string_view, &LeaseNode::key>;
   LeaseSet leases_by_key_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, OwnerLoad> load_by_owner_
+      ABSL_GUARDED_BY(mutex_);
+  std::optional<double> rebalance_ratio_;
+  absl::flat_hash_map<std::string, ManifestTopic> manifest_topics_
+      ABSL_GUARDED_BY(mutex_);
+  // Number of `ManifestSubscriber` objects that have not yet been destroyed.
+  size_t num_manifest_subscribers_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
+// Streams `ManifestNotification` messages for a single subscription.
+//
+// All state is guarded by `Impl::mutex_`.
+class CoordinatorServer::Impl::ManifestSubscriber
+    : public grpc::ServerWriteReactor<
+          internal_ocdbt::grpc_gen::ManifestNotification> {
+ public:
+  ManifestSubscriber(Impl& impl, std::string key)
+      : impl_(impl), key_(std::move(key)) {}
+
+  // Requests that `generation` be sent to the subscriber.  If a write is
+  // already in flight, only the latest generation is sent once it completes.
+  void Notify(uint64_t generation) ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl_.mutex_) {
+    if (!pending_generation_ || *pending_generation_ < generation) {
+      pending_generation_ = generation;
+    }
+    MaybeWrite();
+  }
+
+  void FinishOnce(grpc::Status status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl_.mutex_) {
+    if (finished_) return;
+    finished_ = true;
+    Finish(std::move(status));
+  }
+
+  void OnWriteDone(bool ok) override {
+    absl::MutexLock lock(&impl_.mutex_);
+    write_in_flight_ = false;
+    if (!ok) {
+      FinishOnce(grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                              "Failed to send manifest notification"));
+      return;
+    }
+    MaybeWrite();
+  }
+
+  void OnCancel() override {
+    absl::MutexLock lock(&impl_.mutex_);
+    FinishOnce(grpc::Status::CANCELLED);
+  }
+
+  void OnDone() override {
+    {
+      absl::MutexLock lock(&impl_.mutex_);
+      if (auto it = impl_.manifest_topics_.find(key_);
+          it != impl_.manifest_topics_.end()) {
+        it->second.subscribers.erase(this);
+      }
+      --impl_.num_manifest_subscribers_;
+    }
+    delete this;
+  }
+
+ private:
+  void MaybeWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(impl_.mutex_) {
+    if (finished_ || write_in_flight_ || !pending_generation_) return;
+    if (sent_generation_ && *sent_generation_ == *pending_generation_) return;
+    sent_generation_ = pending_generation_;
+    notification_.set_root_generation(*sent_generation_);
+    write_in_flight_ = true;
+    StartWrite(&notification_);
+  }
+
+  Impl& impl_;
+  std::string key_;
+  internal_ocdbt::grpc_gen::ManifestNotification notification_;
+  std::optional<uint64_t> pending_generation_;
+  std::optional<uint64_t> sent_generation_;
+  bool write_in_flight_ = false;
+  bool finished_ = false;
+};
+
+CoordinatorServer::Impl::~Impl() {
+  // Subscriptions never complete on their own, and must be finished before the
+  // gRPC server can shut down.
+  absl::MutexLock lock(&mutex_);
+  shutting_down_ = true;
+  for (auto& [key, topic] : manifest_topics_) {
+    for (auto* subscriber : topic.subscribers) {
+      subscriber->FinishOnce(grpc::Status(grpc::StatusCode::CANCELLED,
+                                          "Coordinator shutting down"));
+    }
+  }
+  mutex_.Await(absl::Condition(
+      +[](size_t* n) { return *n == 0; }, &num_manifest_subscribers_));
+}
+
 span<const int> CoordinatorServer::ports() const {
   return impl_->listening_ports_;
 }
@@ -127,10 +280,59 @@ void CoordinatorServer::Impl::PurgeExpiredLeases() {
     next = std::next(it);
     LeaseNode& node = *it;
     leases_by_expiration_time_.Remove(node);
+    RemoveOwnerLoad(node);
     leases_by_key_.erase(node.key);
   }
 }
 
+void CoordinatorServer::Impl::RemoveOwnerLoad(const LeaseNode& node) {
+  auto it = load_by_owner_.find(node.owner);
+  if (it == load_by_owner_.end()) return;
+  if (--it->second.num_leases == 0) {
+    load_by_owner_.erase(it);
+    return;
+  }
+  it->second.mutation_rate -= node.mutation_rate;
+}
+
+void CoordinatorServer::Impl::AddOwnerLoad(const LeaseNode& node) {
+  auto& load = load_by_owner_[node.owner];
+  ++load.num_leases;
+  load.mutation_rate += node.mutation_rate;
+}
+
+bool CoordinatorServer::Impl::ShouldTransferLease(
+    const LeaseNode& node, const std::string& requester) {
+  if (!rebalance_ratio_ || node.mutation_rate <= 0 ||
+      node.owner == requester) {
+    return false;
+  }
+  auto owner_it = load_by_owner_.find(node.owner);
+  if (owner_it == load_by_owner_.end()) return false;
+  double requester_rate = 0;
+  if (auto it = load_by_owner_.find(requester); it != load_by_owner_.end()) {
+    requester_rate = it->second.mutation_rate;
+  }
+  // Since the ratio is greater than 1, the load of the requester after the
+  // transfer is less than the load of the owner before the transfer, and the
+  // lease is not transferred back.
+  return owner_it->second.mutation_rate >
+         *rebalance_ratio_ * (requester_rate + node.mutation_rate);
+}
+
+std::vector<CoordinatorServer::LeaseInfo> CoordinatorServer::GetLeases()
+    const {
+  std::vector<LeaseInfo> leases;
+  absl::MutexLock lock(&impl_->mutex_);
+  impl_->PurgeExpiredLeases();
+  leases.reserve(impl_->leases_by_key_.size());
+  for (const auto& node : impl_->leases_by_key_) {
+    leases.push_back(LeaseInfo{node->key, node->owner, node->expiration_time,
+                               node->mutation_rate});
+  }
+  return leases;
+}
+
 grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
     grpc::CallbackServerContext* context,
     const internal_ocdbt::grpc_gen::LeaseRequest* request,
@@ -157,6 +359,26 @@ grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
            tensorstore::StrCat("Invalid lease duration: ", _.message()))),
        reactor));
 
+  // Mutation rate reported for the lease specified by `renew_lease_id`.
+  std::optional<double> reported_mutation_rate;
+  if (request->has_renew_lease_id() && request->has_num_mutations() &&
+      request->has_mutation_interval()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto mutation_interval,
+        internal::ProtoToAbslDuration(request->mutation_interval()),
+        (reactor->Finish(grpc::Status(
+             grpc::StatusCode::INVALID_ARGUMENT,
+             tensorstore::StrCat("Invalid mutation interval: ", _.message()))),
+         reactor));
+    if (mutation_interval > absl::ZeroDuration()) {
+      reported_mutation_rate = request->num_mutations() /
+                               absl::ToDoubleSeconds(mutation_interval);
+    }
+  }
+
+  const std::string requester = tensorstore::StrCat(
+      peer_address->first, ":", request->cooperator_port());
+
   // Lookup lease.
   {
     absl::MutexLock lock(&mutex_);
@@ -177,6 +399,12 @@ grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
         // Terminate existing lease, and grant lease to requesting client.
         leases_by_expiration_time_.Remove(*node);
         assign_new_lease = true;
+      } else if (ShouldTransferLease(*node, requester)) {
+        ABSL_LOG_IF(INFO, ocdbt_logging)
+            << "Coordinator: transferring lease " << node->lease_id
+            << " from " << node->owner << " to " << requester;
+        leases_by_expiration_time_.Remove(*node);
+        assign_new_lease = true;
       }
     } else {
       auto new_node = std::make_unique<LeaseNode>();
@@ -192,8 +420,14 @@ grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
       if (assign_new_lease) {
         node->lease_id = static_cast<uint64_t>(
             absl::ToInt64Nanoseconds(cur_time - absl::UnixEpoch()));
-        node->owner = tensorstore::StrCat(peer_address->first, ":",
-                                          request->cooperator_port());
+        RemoveOwnerLoad(*node);
+        node->owner = requester;
+        AddOwnerLoad(*node);
+      }
+      if (reported_mutation_rate) {
+        RemoveOwnerLoad(*node);
+        node->mutation_rate = *reported_mutation_rate;
+        AddOwnerLoad(*node);
       }
       response->set_is_owner(true);
       leases_by_expiration_time_.FindOrInsert(
@@ -215,6 +449,55 @@ grpc::ServerUnaryReactor* CoordinatorServer::Impl::RequestLease(
   return reactor;
 }
 
+grpc::ServerUnaryReactor* CoordinatorServer::Impl::PublishManifest(
+    grpc::CallbackServerContext* context,
+    const internal_ocdbt::grpc_gen::PublishManifestRequest* request,
+    internal_ocdbt::grpc_gen::PublishManifestResponse* response) {
+  auto* reactor = context->DefaultReactor();
+  if (auto status = security_->ValidateServerRequest(context); !status.ok()) {
+    reactor->Finish(internal::AbslStatusToGrpcStatus(status));
+    return reactor;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    auto& topic = manifest_topics_[request->key()];
+    if (request->root_generation() > topic.latest_generation) {
+      topic.latest_generation = request->root_generation();
+      for (auto* subscriber : topic.subscribers) {
+        subscriber->Notify(topic.latest_generation);
+      }
+    }
+  }
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Coordinator: PublishManifest: request=" << *request;
+  reactor->Finish(grpc::Status());
+  return reactor;
+}
+
+grpc::ServerWriteReactor<internal_ocdbt::grpc_gen::ManifestNotification>*
+CoordinatorServer::Impl::SubscribeManifest(
+    grpc::CallbackServerContext* context,
+    const internal_ocdbt::grpc_gen::SubscribeManifestRequest* request) {
+  auto* subscriber = new ManifestSubscriber(*this, request->key());
+  absl::MutexLock lock(&mutex_);
+  ++num_manifest_subscribers_;
+  if (auto status = security_->ValidateServerRequest(context); !status.ok()) {
+    subscriber->FinishOnce(internal::AbslStatusToGrpcStatus(status));
+    return subscriber;
+  }
+  if (shutting_down_) {
+    subscriber->FinishOnce(grpc::Status(grpc::StatusCode::CANCELLED,
+                                        "Coordinator shutting down"));
+    return subscriber;
+  }
+  auto& topic = manifest_topics_[request->key()];
+  topic.subscribers.insert(subscriber);
+  subscriber->Notify(topic.latest_generation);
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Coordinator: SubscribeManifest: request=" << *request;
+  return subscriber;
+}
+
 Result<CoordinatorServer> CoordinatorServer::Start(Options options) {
   auto impl = std::make_unique<Impl>();
   if (options.clock) {
@@ -223,6 +506,7 @@ Result<CoordinatorServer> CoordinatorServer::Start(Options options) {
     impl->clock_ = [] { return absl::Now(); };
   }
   impl->security_ = options.spec.security;
+  impl->rebalance_ratio_ = options.spec.experimental_lease_rebalance_ratio;
   if (!impl->security_) {
     impl->security_ = internal_ocdbt::GetInsecureRpcSecurityMethod();
   }
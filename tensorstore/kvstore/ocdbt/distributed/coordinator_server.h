@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -82,6 +83,18 @@ class CoordinatorServer {
     ///
     /// If none are specified, binds to `[::]:0`.
     std::vector<std::string> bind_addresses;
+
+    /// Enables load-aware rebalancing of leases.
+    ///
+    /// Cooperators report the rate at which mutations are applied under each
+    /// lease they own.  When a cooperator requests a lease owned by another
+    /// cooperator whose total mutation rate exceeds this ratio times the total
+    /// rate the requesting cooperator would have if it acquired the lease, the
+    /// lease is transferred to the requesting cooperator.  Must be greater
+    /// than 1, which ensures that a lease is not immediately transferred back.
+    ///
+    /// If not specified, leases are only reassigned once they expire.
+    std::optional<double> experimental_lease_rebalance_ratio;
   };
   using Clock = std::function<absl::Time()>;
   struct Options {
@@ -110,6 +123,23 @@ class CoordinatorServer {
   /// Returns the list of port numbers corresponding to the bind addresses.
   span<const int> ports() const;
 
+  /// Information about an active lease, intended for monitoring.
+  struct LeaseInfo {
+    /// Lease key, identifying the B+tree node.
+    std::string key;
+
+    /// Address (hostname:port) of the owner.
+    std::string owner;
+
+    absl::Time expiration_time;
+
+    /// Rate, in mutations per second, most recently reported by the owner.
+    double mutation_rate = 0;
+  };
+
+  /// Returns the active leases.
+  std::vector<LeaseInfo> GetLeases() const;
+
  private:
   class Impl;
 
@@ -14,7 +14,10 @@
 
 #include "tensorstore/kvstore/ocdbt/distributed/coordinator_server.h"
 
+#include <stdint.h>
+
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -24,12 +27,16 @@
 #include "absl/log/absl_log.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "grpcpp/client_context.h"  // third_party
 #include "grpcpp/create_channel.h"  // third_party
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/ocdbt/distributed/btree_node_identifier.h"
 #include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.pb.h"
 #include "tensorstore/kvstore/ocdbt/distributed/lease_cache_for_cooperator.h"
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_subscription.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
+#include "tensorstore/proto/encode_time.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
@@ -39,14 +46,22 @@ namespace {
 
 using ::tensorstore::KeyRange;
 using ::tensorstore::internal_ocdbt::BtreeNodeIdentifier;
+using ::tensorstore::internal_ocdbt::grpc_gen::LeaseRequest;
+using ::tensorstore::internal_ocdbt::grpc_gen::LeaseResponse;
+using ::tensorstore::internal_ocdbt::ManifestNotificationSource;
+using ::tensorstore::internal_ocdbt::SubscribeToManifestNotifications;
 using ::tensorstore::internal_ocdbt_cooperator::LeaseCacheForCooperator;
 using ::tensorstore::ocdbt::CoordinatorServer;
 
 class CoordinatorServerTest : public ::testing::Test {
  protected:
   absl::Time cur_time;
+  std::optional<double> lease_rebalance_ratio;
   CoordinatorServer server_;
   LeaseCacheForCooperator lease_cache;
+  std::string address;
+  std::shared_ptr<tensorstore::internal_ocdbt::grpc_gen::Coordinator::Stub>
+      coordinator_stub;
 
   void SetUp() override {
     auto security =
@@ -54,11 +69,12 @@ class CoordinatorServerTest : public ::testing::Test {
     CoordinatorServer::Options options;
     options.spec.security = security;
     options.spec.bind_addresses.push_back("localhost:0");
+    options.spec.experimental_lease_rebalance_ratio = lease_rebalance_ratio;
     options.clock = [this] { return cur_time; };
     TENSORSTORE_CHECK_OK_AND_ASSIGN(
         server_, CoordinatorServer::Start(std::move(options)));
 
-    std::string address = tensorstore::StrCat("localhost:", server_.port());
+    address = tensorstore::StrCat("localhost:", server_.port());
     auto channel =
         ::grpc::CreateChannel(address, security->GetClientCredentials());
     if (!channel->WaitForConnected(
@@ -70,9 +86,10 @@ class CoordinatorServerTest : public ::testing::Test {
     LeaseCacheForCooperator::Options lease_cache_options;
     lease_cache_options.clock = {};
     lease_cache_options.cooperator_port = 42;
-    lease_cache_options.coordinator_stub =
+    coordinator_stub =
         tensorstore::internal_ocdbt::grpc_gen::Coordinator::NewStub(
             std::move(channel));
+    lease_cache_options.coordinator_stub = coordinator_stub;
     lease_cache_options.security = security;
 
     lease_cache = LeaseCacheForCooperator(std::move(lease_cache_options));
@@ -89,4 +106,116 @@ TEST_F(CoordinatorServerTest, Basic) {
   EXPECT_THAT(lease_info->peer_address, ::testing::MatchesRegex(".*:42"));
 }
 
+// Requests the lease on `key` as the cooperator listening on `cooperator_port`.
+//
+// If `renew_lease_id` is specified, reports `num_mutations` mutations applied
+// over 10 seconds.
+LeaseResponse RequestLease(
+    tensorstore::internal_ocdbt::grpc_gen::Coordinator::Stub& stub,
+    std::string key, int32_t cooperator_port,
+    std::optional<uint64_t> renew_lease_id = std::nullopt,
+    uint64_t num_mutations = 0) {
+  grpc::ClientContext context;
+  LeaseRequest request;
+  LeaseResponse response;
+  request.set_key(std::move(key));
+  request.set_cooperator_port(cooperator_port);
+  tensorstore::internal::AbslDurationToProto(absl::Seconds(100),
+                                             request.mutable_lease_duration());
+  if (renew_lease_id) {
+    request.set_renew_lease_id(*renew_lease_id);
+    request.set_num_mutations(num_mutations);
+    tensorstore::internal::AbslDurationToProto(
+        absl::Seconds(10), request.mutable_mutation_interval());
+  }
+  EXPECT_TRUE(stub.RequestLease(&context, request, &response).ok());
+  return response;
+}
+
+TEST_F(CoordinatorServerTest, NoRebalanceByDefault) {
+  auto a = RequestLease(*coordinator_stub, "k1", 1);
+  EXPECT_TRUE(a.is_owner());
+  RequestLease(*coordinator_stub, "k1", 1, a.lease_id(), 1000);
+  auto b = RequestLease(*coordinator_stub, "k1", 2);
+  EXPECT_FALSE(b.is_owner());
+  EXPECT_EQ(a.owner(), b.owner());
+}
+
+class CoordinatorServerRebalanceTest : public CoordinatorServerTest {
+ protected:
+  CoordinatorServerRebalanceTest() { lease_rebalance_ratio = 1.5; }
+};
+
+TEST_F(CoordinatorServerRebalanceTest, TransfersLeaseFromLoadedOwner) {
+  auto a1 = RequestLease(*coordinator_stub, "k1", 1);
+  auto a2 = RequestLease(*coordinator_stub, "k2", 1);
+  ASSERT_TRUE(a1.is_owner());
+  ASSERT_TRUE(a2.is_owner());
+
+  // Cooperator 1 reports 100 mutations/s for each lease.
+  EXPECT_TRUE(RequestLease(*coordinator_stub, "k1", 1, a1.lease_id(), 1000)
+                  .is_owner());
+  EXPECT_TRUE(RequestLease(*coordinator_stub, "k2", 1, a2.lease_id(), 1000)
+                  .is_owner());
+
+  // 200 > 1.5 * (0 + 100): transferred to cooperator 2.
+  auto b1 = RequestLease(*coordinator_stub, "k1", 2);
+  EXPECT_TRUE(b1.is_owner());
+  EXPECT_THAT(b1.owner(), ::testing::EndsWith(":2"));
+
+  // 100 <= 1.5 * (100 + 100): not transferred.
+  auto b2 = RequestLease(*coordinator_stub, "k2", 2);
+  EXPECT_FALSE(b2.is_owner());
+  EXPECT_EQ(a2.owner(), b2.owner());
+
+  auto leases = server_.GetLeases();
+  ASSERT_EQ(2, leases.size());
+  for (const auto& lease : leases) {
+    EXPECT_EQ(100, lease.mutation_rate) << lease.key;
+    EXPECT_THAT(lease.owner,
+                ::testing::EndsWith(lease.key == "k1" ? ":2" : ":1"));
+  }
+}
+
+void PublishManifest(
+    tensorstore::internal_ocdbt::grpc_gen::Coordinator::Stub& stub,
+    std::string key, uint64_t root_generation) {
+  grpc::ClientContext context;
+  tensorstore::internal_ocdbt::grpc_gen::PublishManifestRequest request;
+  tensorstore::internal_ocdbt::grpc_gen::PublishManifestResponse response;
+  request.set_key(std::move(key));
+  request.set_root_generation(root_generation);
+  EXPECT_TRUE(stub.PublishManifest(&context, request, &response).ok());
+}
+
+// Waits until `source` reports `generation` as the latest generation.
+bool WaitForLatestGeneration(const ManifestNotificationSource& source,
+                             uint64_t generation) {
+  for (auto deadline = absl::Now() + absl::Seconds(10);
+       absl::Now() < deadline;) {
+    if (source.GetLatestGenerationTime(generation) != absl::InfinitePast()) {
+      return true;
+    }
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  return false;
+}
+
+TEST_F(CoordinatorServerTest, ManifestNotifications) {
+  PublishManifest(*coordinator_stub, "key", 5);
+  auto source = SubscribeToManifestNotifications(
+      address, ::tensorstore::internal_ocdbt::GetInsecureRpcSecurityMethod(),
+      "key");
+  EXPECT_TRUE(WaitForLatestGeneration(*source, 5));
+  EXPECT_EQ(absl::InfinitePast(), source->GetLatestGenerationTime(4));
+
+  // Older generations are ignored.
+  PublishManifest(*coordinator_stub, "key", 3);
+  PublishManifest(*coordinator_stub, "other", 7);
+  PublishManifest(*coordinator_stub, "key", 6);
+  EXPECT_TRUE(WaitForLatestGeneration(*source, 6));
+  EXPECT_EQ(absl::InfinitePast(), source->GetLatestGenerationTime(5));
+  EXPECT_EQ(absl::InfinitePast(), source->GetLatestGenerationTime(7));
+}
+
 }  // namespace
@@ -209,6 +209,44 @@ TEST_F(DistributedTest, MultipleCooperatorsManyWrites) {
   }
 }
 
+TEST_F(DistributedTest, GroupCommitWindow) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto context_spec_with_window,
+      Context::Spec::FromJson({{"ocdbt_coordinator",
+                                {{"address", coordinator_address_},
+                                 {"group_commit_window", "200ms"}}}}));
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  ::nlohmann::json kvs_spec{
+      {"driver", "ocdbt"},
+      {"base", {{"driver", "file"}, {"path", tempdir.path() + "/"}}},
+  };
+  constexpr size_t kNumCooperators = 2;
+  constexpr size_t kNumWrites = 20;
+  std::vector<kvstore::KvStore> stores;
+  for (size_t i = 0; i < kNumCooperators; ++i) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store,
+        kvstore::Open(kvs_spec, Context(context_spec_with_window)).result());
+    stores.push_back(store);
+  }
+  std::vector<tensorstore::AnyFuture> write_futures;
+  for (size_t i = 0; i < kNumWrites; ++i) {
+    write_futures.push_back(kvstore::Write(stores[i % kNumCooperators],
+                                           absl::StrFormat("%04d", i),
+                                           absl::Cord("a")));
+  }
+  for (auto& future : write_futures) {
+    TENSORSTORE_ASSERT_OK(future.status());
+  }
+  auto& driver = static_cast<OcdbtDriver&>(*stores[0].driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto manifest, ReadManifest(driver));
+  ASSERT_TRUE(manifest);
+  // Writes are merged into fewer commits than there are writes.
+  EXPECT_LT(manifest->latest_version().generation_number, kNumWrites);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto map, GetMap(stores[1]));
+  EXPECT_EQ(kNumWrites, map.size());
+}
+
 TEST_F(DistributedTest, TwoCooperatorsManifestDeleted) {
   ::nlohmann::json base_kvs_store_spec = "memory://";
   ::nlohmann::json kvs_spec{
@@ -136,6 +136,9 @@ LeaseCacheForCooperator::GetLease(std::string_view key,
   // mutex is released.
   Future<const LeaseNode::Ptr> stale_future;
 
+  // Expired lease owned by this cooperator, to be renewed.
+  LeaseNode::Ptr renewed_lease;
+
   PromiseFuturePair<LeaseNode::Ptr> promise_future;
   {
     absl::MutexLock lock(&impl_->mutex_);
@@ -154,6 +157,7 @@ LeaseCacheForCooperator::GetLease(std::string_view key,
               << ": returning existing lease future";
           return future;
         }
+        if (!node.peer_stub) renewed_lease.reset(&node);
       }
       // Existing lease request failed, or lease expired.  New request is
       // needed.
@@ -179,6 +183,14 @@ LeaseCacheForCooperator::GetLease(std::string_view key,
   if (uncooperative_lease) {
     state->request.set_uncooperative_lease_id(uncooperative_lease->lease_id);
   }
+  if (renewed_lease) {
+    // Report the mutation rate, which the coordinator uses to balance leases.
+    state->request.set_renew_lease_id(renewed_lease->lease_id);
+    state->request.set_num_mutations(
+        renewed_lease->num_mutations.load(std::memory_order_relaxed));
+    internal::AbslDurationToProto(impl_->clock_() - renewed_lease->acquire_time,
+                                  state->request.mutable_mutation_interval());
+  }
   state->request.set_cooperator_port(impl_->cooperator_port_);
   internal::AbslDurationToProto(impl_->lease_duration_,
                                 state->request.mutable_lease_duration());
@@ -236,6 +248,8 @@ LeaseCacheForCooperator::GetLease(std::string_view key,
         }
 
         lease_node->expiration_time = expiration_time;
+        lease_node->acquire_time =
+            expiration_time - state->owner->lease_duration_;
         state->promise.SetResult(std::move(lease_node));
       });
 
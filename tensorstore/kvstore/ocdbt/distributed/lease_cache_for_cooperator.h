@@ -15,6 +15,7 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_LEASE_CACHE_FOR_COOPERATOR_H_
 #define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_LEASE_CACHE_FOR_COOPERATOR_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -61,6 +62,13 @@ class LeaseCacheForCooperator {
     //
     // Null if this cooperator owns the lease on this node.
     std::shared_ptr<grpc_gen::Cooperator::StubInterface> peer_stub;
+
+    // Time at which the lease was acquired.
+    absl::Time acquire_time;
+
+    // Number of mutations applied under this lease by the local cooperator.
+    // Reported to the coordinator when the lease is renewed.
+    mutable std::atomic<uint64_t> num_mutations{0};
   };
 
   LeaseCacheForCooperator();
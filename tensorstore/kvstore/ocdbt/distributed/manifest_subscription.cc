@@ -0,0 +1,178 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_subscription.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"  // third_party
+#include "grpcpp/create_channel.h"  // third_party
+#include "grpcpp/support/client_callback.h"  // third_party
+#include "grpcpp/support/status.h"  // third_party
+#include "tensorstore/internal/grpc/utils.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.grpc.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/coordinator.pb.h"
+#include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
+
+constexpr absl::Duration kInitialRetryDelay = absl::Milliseconds(100);
+constexpr absl::Duration kMaxRetryDelay = absl::Seconds(10);
+
+// State of a single subscription, which may span multiple calls if the
+// connection to the coordinator is lost.
+//
+// A reference is held by each outstanding call and by each scheduled retry.
+class ManifestSubscriptionState
+    : public internal::AtomicReferenceCount<ManifestSubscriptionState>,
+      public grpc::ClientReadReactor<grpc_gen::ManifestNotification> {
+ public:
+  explicit ManifestSubscriptionState(
+      std::shared_ptr<grpc_gen::Coordinator::StubInterface> stub,
+      std::string key)
+      : stub_(std::move(stub)) {
+    request_.set_key(std::move(key));
+  }
+
+  void Start() ABSL_LOCKS_EXCLUDED(mutex_) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_) return;
+      context_ = std::make_unique<grpc::ClientContext>();
+      intrusive_ptr_increment(this);  // adopted in OnDone.
+      stub_->async()->SubscribeManifest(context_.get(), &request_, this);
+    }
+    StartRead(&notification_);
+    StartCall();
+  }
+
+  void Cancel() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    cancelled_ = true;
+    if (context_) context_->TryCancel();
+  }
+
+  absl::Time GetLatestGenerationTime(GenerationNumber generation)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (!connected_ || latest_generation_ == 0 ||
+        latest_generation_ != generation) {
+      return absl::InfinitePast();
+    }
+    return absl::Now();
+  }
+
+  void OnReadDone(bool ok) override {
+    if (!ok) {
+      // The stream has ended; `OnDone` will be called.
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      latest_generation_ = notification_.root_generation();
+      connected_ = true;
+      retry_delay_ = kInitialRetryDelay;
+    }
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "ManifestSubscription: " << request_.key()
+        << ": root_generation=" << notification_.root_generation();
+    StartRead(&notification_);
+  }
+
+  void OnDone(const grpc::Status& s) override {
+    internal::IntrusivePtr<ManifestSubscriptionState> self(
+        this, internal::adopt_object_ref);
+    absl::Duration delay;
+    {
+      absl::MutexLock lock(&mutex_);
+      connected_ = false;
+      if (cancelled_) return;
+      delay = retry_delay_;
+      retry_delay_ = std::min(retry_delay_ * 2, kMaxRetryDelay);
+    }
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "ManifestSubscription: " << request_.key()
+        << ": call ended: " << internal::GrpcStatusToAbslStatus(s)
+        << ", retrying in " << delay;
+    internal::ScheduleAt(absl::Now() + delay,
+                         [self = std::move(self)] { self->Start(); });
+  }
+
+ private:
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> stub_;
+  grpc_gen::SubscribeManifestRequest request_;
+  grpc_gen::ManifestNotification notification_;
+
+  absl::Mutex mutex_;
+  std::unique_ptr<grpc::ClientContext> context_ ABSL_GUARDED_BY(mutex_);
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+  // Indicates that a notification has been received on the current call.
+  bool connected_ ABSL_GUARDED_BY(mutex_) = false;
+  GenerationNumber latest_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Duration retry_delay_ ABSL_GUARDED_BY(mutex_) = kInitialRetryDelay;
+};
+
+class ManifestSubscription : public ManifestNotificationSource {
+ public:
+  explicit ManifestSubscription(
+      internal::IntrusivePtr<ManifestSubscriptionState> state)
+      : state_(std::move(state)) {}
+
+  ~ManifestSubscription() override { state_->Cancel(); }
+
+  absl::Time GetLatestGenerationTime(
+      GenerationNumber generation) const override {
+    return state_->GetLatestGenerationTime(generation);
+  }
+
+ private:
+  internal::IntrusivePtr<ManifestSubscriptionState> state_;
+};
+
+}  // namespace
+
+ManifestNotificationSource::Ptr SubscribeToManifestNotifications(
+    const std::string& coordinator_address, RpcSecurityMethod::Ptr security,
+    std::string key) {
+  std::shared_ptr<grpc_gen::Coordinator::StubInterface> stub =
+      grpc_gen::Coordinator::NewStub(grpc::CreateChannel(
+          coordinator_address, security->GetClientCredentials()));
+  auto state = internal::MakeIntrusivePtr<ManifestSubscriptionState>(
+      std::move(stub), std::move(key));
+  state->Start();
+  return internal::MakeIntrusivePtr<ManifestSubscription>(std::move(state));
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
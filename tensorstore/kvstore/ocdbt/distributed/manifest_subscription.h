@@ -0,0 +1,45 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_SUBSCRIPTION_H_
+#define TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_SUBSCRIPTION_H_
+
+#include <string>
+
+#include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Subscribes to notifications of new root generations of the database
+/// identified by `key`, published to the coordinator at `coordinator_address`
+/// by cooperators with `experimental_manifest_notifications` enabled.
+///
+/// The returned source reports a cached manifest as current only while the
+/// subscription is connected, and only if its generation matches the latest
+/// generation received.  The subscription is re-established automatically,
+/// with exponential backoff, after an error, and is cancelled when the
+/// returned source is destroyed.
+///
+/// Since notifications are delivered asynchronously, a manifest reported as
+/// current may be stale by up to the notification propagation delay.
+ManifestNotificationSource::Ptr SubscribeToManifestNotifications(
+    const std::string& coordinator_address, RpcSecurityMethod::Ptr security,
+    std::string key);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_DISTRIBUTED_MANIFEST_SUBSCRIPTION_H_
@@ -28,6 +28,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/cache/cache_pool_resource.h"
@@ -39,13 +40,17 @@
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/path.h"
 #include "tensorstore/internal/ref_counted_string.h"
+#include "tensorstore/kvstore/batch_util.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/ocdbt/btree_writer.h"
 #include "tensorstore/kvstore/ocdbt/config.h"
+#include "tensorstore/kvstore/ocdbt/distributed/btree_node_identifier.h"
 #include "tensorstore/kvstore/ocdbt/distributed/btree_writer.h"
+#include "tensorstore/kvstore/ocdbt/distributed/manifest_subscription.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security.h"
 #include "tensorstore/kvstore/ocdbt/distributed/rpc_security_registry.h"
 #include "tensorstore/kvstore/ocdbt/format/manifest.h"
@@ -96,7 +101,12 @@ struct OcdbtCoordinatorResourceTraits
         jb::Member("address", jb::Projection<&Spec::address>()),
         jb::Member("lease_duration", jb::Projection<&Spec::lease_duration>()),
         jb::Member("security", jb::Projection<&Spec::security>(
-                                   RpcSecurityMethodJsonBinder)));
+                                   RpcSecurityMethodJsonBinder)),
+        jb::Member("experimental_manifest_notifications",
+                   jb::Projection<&Spec::experimental_manifest_notifications>(
+                       jb::DefaultInitializedValue())),
+        jb::Member("group_commit_window",
+                   jb::Projection<&Spec::group_commit_window>()));
   }
   static Result<Resource> Create(
       const Spec& spec, internal::ContextResourceCreationContext context) {
@@ -128,6 +138,8 @@ auto& ocdbt_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/ocdbt/list",
     MetricMetadata("OCDBT driver kvstore::List calls"));
 
+auto ocdbt_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(ocdbt);
+
 }  // namespace
 namespace jb = ::tensorstore::internal_json_binding;
 
@@ -174,6 +186,20 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
         jb::Member(
             "target_data_file_size",
             jb::Projection<&OcdbtDriverSpecData::target_data_file_size>()),
+        jb::Member(
+            "experimental_key_ordered_writes",
+            jb::Projection<
+                &OcdbtDriverSpecData::experimental_key_ordered_writes>(
+                jb::DefaultInitializedValue())),
+        jb::Member(
+            "experimental_deduplicate_values",
+            jb::Projection<
+                &OcdbtDriverSpecData::experimental_deduplicate_values>(
+                jb::DefaultInitializedValue())),
+        jb::Member(
+            "experimental_list_concurrency",
+            jb::Projection<&OcdbtDriverSpecData::experimental_list_concurrency>(
+                jb::Optional(jb::Integer<size_t>(1)))),
         jb::Member("coordinator",
                    jb::Projection<&OcdbtDriverSpecData::coordinator>()),
         jb::Member(internal::CachePoolResource::id,
@@ -214,20 +240,31 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
         driver->experimental_read_coalescing_interval_ =
             spec->data_.experimental_read_coalescing_interval;
         driver->target_data_file_size_ = spec->data_.target_data_file_size;
+        driver->experimental_key_ordered_writes_ =
+            spec->data_.experimental_key_ordered_writes;
+        driver->experimental_deduplicate_values_ =
+            spec->data_.experimental_deduplicate_values;
+        driver->experimental_list_concurrency_ =
+            spec->data_.experimental_list_concurrency;
 
         std::optional<ReadCoalesceOptions> read_coalesce_options;
         if (driver->experimental_read_coalescing_threshold_bytes_ ||
             driver->experimental_read_coalescing_merged_bytes_ ||
             driver->experimental_read_coalescing_interval_) {
           read_coalesce_options.emplace();
-          read_coalesce_options->max_overhead_bytes_per_request =
-              static_cast<int64_t>(
-                  driver->experimental_read_coalescing_threshold_bytes_
-                      .value_or(0));
-          read_coalesce_options->max_merged_bytes_per_request =
-              static_cast<int64_t>(
-                  driver->experimental_read_coalescing_merged_bytes_.value_or(
-                      0));
+          // If the threshold is not specified, it is chosen adaptively from
+          // the observed latency and bandwidth of the base kvstore.
+          if (const auto& threshold =
+                  driver->experimental_read_coalescing_threshold_bytes_) {
+            read_coalesce_options->max_overhead_bytes_per_request =
+                static_cast<int64_t>(*threshold);
+          }
+          if (const auto& merged_bytes =
+                  driver->experimental_read_coalescing_merged_bytes_;
+              merged_bytes && *merged_bytes > 0) {
+            read_coalesce_options->max_merged_bytes_per_request =
+                static_cast<int64_t>(*merged_bytes);
+          }
           read_coalesce_options->max_interval =
               driver->experimental_read_coalescing_interval_.value_or(
                   absl::ZeroDuration());
@@ -238,6 +275,30 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
             ConfigState::Make(spec->data_.config, supported_manifest_features,
                               spec->data_.assume_config));
 
+        driver->coordinator_ = spec->data_.coordinator;
+        RpcSecurityMethod::Ptr security;
+        std::string storage_identifier;
+        ManifestNotificationSource::Ptr manifest_notifications;
+        if (driver->coordinator_->address) {
+          security = driver->coordinator_->security;
+          if (!security) {
+            security = GetInsecureRpcSecurityMethod();
+          }
+
+          // Compute unique identifier for the base kvstore to use with
+          // coordinator.
+          TENSORSTORE_ASSIGN_OR_RETURN(auto base_spec,
+                                       driver->base_.spec(MinimalSpec{}));
+          TENSORSTORE_ASSIGN_OR_RETURN(auto base_spec_json,
+                                       base_spec.ToJson());
+          storage_identifier = base_spec_json.dump();
+          if (driver->coordinator_->experimental_manifest_notifications) {
+            manifest_notifications = SubscribeToManifestNotifications(
+                *driver->coordinator_->address, security,
+                BtreeNodeIdentifier::Root().GetKey(storage_identifier));
+          }
+        }
+
         driver->io_handle_ = internal_ocdbt::MakeIoHandle(
             driver->data_copy_concurrency_, driver->cache_pool_->get(),
             driver->base_,
@@ -245,10 +306,12 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
                                              : driver->base_,
             std::move(config_state), driver->data_file_prefixes_,
             driver->target_data_file_size_.value_or(kDefaultTargetBufferSize),
-            std::move(read_coalesce_options));
+            std::move(read_coalesce_options),
+            driver->experimental_key_ordered_writes_,
+            driver->experimental_deduplicate_values_,
+            std::move(manifest_notifications));
         driver->btree_writer_ =
             MakeNonDistributedBtreeWriter(driver->io_handle_);
-        driver->coordinator_ = spec->data_.coordinator;
         if (!driver->coordinator_->address) {
           driver->btree_writer_ =
               MakeNonDistributedBtreeWriter(driver->io_handle_);
@@ -259,19 +322,15 @@ Future<kvstore::DriverPtr> OcdbtDriverSpec::DoOpen() const {
         DistributedBtreeWriterOptions options;
         options.io_handle = driver->io_handle_;
         options.coordinator_address = *driver->coordinator_->address;
-        options.security = driver->coordinator_->security;
-        if (!options.security) {
-          options.security = GetInsecureRpcSecurityMethod();
-        }
+        options.security = std::move(security);
         options.lease_duration = driver->coordinator_->lease_duration.value_or(
             kDefaultLeaseDuration);
-
-        // Compute unique identifier for the base kvstore to use with
-        // coordinator.
-        TENSORSTORE_ASSIGN_OR_RETURN(auto base_spec,
-                                     driver->base_.spec(MinimalSpec{}));
-        TENSORSTORE_ASSIGN_OR_RETURN(auto base_spec_json, base_spec.ToJson());
-        options.storage_identifier = base_spec_json.dump();
+        options.storage_identifier = std::move(storage_identifier);
+        options.publish_manifests =
+            driver->coordinator_->experimental_manifest_notifications;
+        options.group_commit_window =
+            driver->coordinator_->group_commit_window.value_or(
+                absl::ZeroDuration());
         driver->btree_writer_ = MakeDistributedBtreeWriter(std::move(options));
         return driver;
       },
@@ -308,6 +367,9 @@ absl::Status OcdbtDriver::GetBoundSpecData(OcdbtDriverSpecData& spec) const {
   spec.experimental_read_coalescing_interval =
       experimental_read_coalescing_interval_;
   spec.target_data_file_size = target_data_file_size_;
+  spec.experimental_key_ordered_writes = experimental_key_ordered_writes_;
+  spec.experimental_deduplicate_values = experimental_deduplicate_values_;
+  spec.experimental_list_concurrency = experimental_list_concurrency_;
   spec.coordinator = coordinator_;
   return absl::Status();
 }
@@ -315,28 +377,61 @@ absl::Status OcdbtDriver::GetBoundSpecData(OcdbtDriverSpecData& spec) const {
 kvstore::SupportedFeatures OcdbtDriver::GetSupportedFeatures(
     const KeyRange& key_range) const {
   return kvstore::SupportedFeatures::kSingleKeyAtomicReadModifyWrite |
-         kvstore::SupportedFeatures::kAtomicWriteWithoutOverwrite;
+         kvstore::SupportedFeatures::kAtomicWriteWithoutOverwrite |
+         kvstore::SupportedFeatures::kListGenerations;
 }
 
+namespace {
+// Batch of `kvstore::Read` requests issued to the same `OcdbtDriver`.
+//
+// All keys in the batch are looked up together by
+// `NonDistributedReadBatch`, which fetches the B+tree nodes one level at a
+// time rather than separately for each key.
+class ReadBatchEntry
+    : public internal_kvstore_batch::BatchReadEntry<OcdbtDriver,
+                                                    NonDistributedReadRequest> {
+ public:
+  using BatchReadEntry::BatchReadEntry;
+
+  void Submit(Batch::View batch) final {
+    NonDistributedReadBatch(driver().io_handle_, std::move(request_batch));
+    delete this;
+  }
+};
+}  // namespace
+
 Future<kvstore::ReadResult> OcdbtDriver::Read(kvstore::Key key,
                                               kvstore::ReadOptions options) {
   ocdbt_read.Increment();
-  return internal_ocdbt::NonDistributedRead(io_handle_, std::move(key),
-                                            std::move(options));
+  if (!options.batch) {
+    return internal_kvstore::RecordReadMetrics(
+        ocdbt_metrics, internal_ocdbt::NonDistributedRead(
+                           io_handle_, std::move(key), std::move(options)));
+  }
+  auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
+  ReadBatchEntry::MakeRequest<ReadBatchEntry>(
+      *this, options.batch, options.staleness_bound,
+      NonDistributedReadRequest{{std::move(promise), options.byte_range},
+                                std::move(key),
+                                std::move(options.generation_conditions)});
+  return internal_kvstore::RecordReadMetrics(ocdbt_metrics, std::move(future));
 }
 
 void OcdbtDriver::ListImpl(kvstore::ListOptions options,
                            ListReceiver receiver) {
   ocdbt_list.Increment();
-  return internal_ocdbt::NonDistributedList(io_handle_, std::move(options),
-                                            std::move(receiver));
+  return internal_ocdbt::NonDistributedList(
+      io_handle_, std::move(options), std::move(receiver),
+      experimental_list_concurrency_.value_or(0));
 }
 
 Future<TimestampedStorageGeneration> OcdbtDriver::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   ocdbt_write.Increment();
-  return btree_writer_->Write(std::move(key), std::move(value),
-                              std::move(options));
+  if (value) ocdbt_metrics.bytes_written.IncrementBy(value->size());
+  return internal_kvstore::RecordWriteMetrics(
+      ocdbt_metrics, btree_writer_->Write(std::move(key), std::move(value),
+                                          std::move(options)));
 }
 
 Future<const void> OcdbtDriver::DeleteRange(KeyRange range) {
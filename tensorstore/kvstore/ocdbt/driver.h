@@ -69,8 +69,11 @@ struct OcdbtCoordinatorResource
     std::optional<std::string> address;
     std::optional<absl::Duration> lease_duration;
     RpcSecurityMethod::Ptr security;
+    bool experimental_manifest_notifications = false;
+    std::optional<absl::Duration> group_commit_window;
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.address, x.lease_duration, x.security);
+      return f(x.address, x.lease_duration, x.security,
+               x.experimental_manifest_notifications, x.group_commit_window);
     };
   };
   using Resource = Spec;
@@ -88,6 +91,9 @@ struct OcdbtDriverSpecData {
   std::optional<size_t> experimental_read_coalescing_merged_bytes;
   std::optional<absl::Duration> experimental_read_coalescing_interval;
   std::optional<size_t> target_data_file_size;
+  bool experimental_key_ordered_writes = false;
+  bool experimental_deduplicate_values = false;
+  std::optional<size_t> experimental_list_concurrency;
   bool assume_config = false;
   Context::Resource<OcdbtCoordinatorResource> coordinator;
 
@@ -102,7 +108,9 @@ struct OcdbtDriverSpecData {
              x.experimental_read_coalescing_threshold_bytes,
              x.experimental_read_coalescing_merged_bytes,
              x.experimental_read_coalescing_interval, x.target_data_file_size,
-             x.coordinator);
+             x.experimental_key_ordered_writes,
+             x.experimental_deduplicate_values,
+             x.experimental_list_concurrency, x.coordinator);
   };
 };
 
@@ -167,6 +175,9 @@ class OcdbtDriver
   std::optional<size_t> experimental_read_coalescing_merged_bytes_;
   std::optional<absl::Duration> experimental_read_coalescing_interval_;
   std::optional<size_t> target_data_file_size_;
+  bool experimental_key_ordered_writes_ = false;
+  bool experimental_deduplicate_values_ = false;
+  std::optional<size_t> experimental_list_concurrency_;
   Context::Resource<OcdbtCoordinatorResource> coordinator_;
 };
 
@@ -17,18 +17,22 @@
 #include <stdint.h>
 
 #include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <variant>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include <nlohmann/json_fwd.hpp>
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/kvs_backed_cache_testutil.h"
 #include "tensorstore/internal/global_initializer.h"
@@ -36,6 +40,8 @@
 #include "tensorstore/internal/testing/dynamic.h"
 #include "tensorstore/internal/testing/scoped_directory.h"
 #include "tensorstore/json_serialization_options_base.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/mock_kvstore.h"
@@ -45,6 +51,7 @@
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
 #include "tensorstore/kvstore/ocdbt/format/manifest.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/ocdbt/test_util.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
@@ -69,8 +76,12 @@ using ::tensorstore::internal::MatchesKvsReadResult;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
 using ::tensorstore::internal::MatchesListEntry;
 using ::tensorstore::internal::MockKeyValueStore;
+using ::tensorstore::internal_ocdbt::BtreeNode;
 using ::tensorstore::internal_ocdbt::Config;
 using ::tensorstore::internal_ocdbt::ConfigConstraints;
+using ::tensorstore::internal_ocdbt::DataFileId;
+using ::tensorstore::internal_ocdbt::GetOcdbtIoHandle;
+using ::tensorstore::internal_ocdbt::IndirectDataReference;
 using ::tensorstore::internal_ocdbt::ManifestKind;
 using ::tensorstore::internal_ocdbt::OcdbtDriver;
 using ::tensorstore::internal_ocdbt::ReadManifest;
@@ -351,6 +362,260 @@ TEST(OcdbtTest, DeleteRangeMinArity) {
               MatchesKvsReadResultNotFound());
 }
 
+TEST(OcdbtTest, BloomFilterMinArity) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config",
+                                   {{"max_decoded_node_bytes", 1},
+                                    {"bloom_filter_bits_per_key", 10}}},
+                                  {"data_copy_concurrency", {{"limit", 1}}}})
+          .result());
+  for (int i = 0; i < 20; ++i) {
+    TENSORSTORE_EXPECT_OK(kvstore::Write(store, absl::StrFormat("a/%02d", i),
+                                         absl::Cord("xyz")));
+  }
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_THAT(kvstore::Read(store, absl::StrFormat("a/%02d", i)).result(),
+                MatchesKvsReadResult(absl::Cord("xyz")));
+    EXPECT_THAT(kvstore::Read(store, absl::StrFormat("a/%02dx", i)).result(),
+                MatchesKvsReadResultNotFound());
+  }
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(OcdbtTest, MaxDecodedLeafNodeBytes) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config",
+                                   {{"max_decoded_node_bytes", 1 << 20},
+                                    {"max_decoded_leaf_node_bytes", 64}}}})
+          .result());
+  std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>>
+      futures;
+  for (int i = 0; i < 20; ++i) {
+    futures.push_back(
+        kvstore::Write(store, absl::StrFormat("a/%02d", i), absl::Cord("xyz")));
+  }
+  for (auto& future : futures) {
+    TENSORSTORE_EXPECT_OK(future);
+  }
+
+  // Leaf nodes are split, but a single interior node suffices.
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto manifest, ReadManifest(driver));
+  ASSERT_TRUE(manifest);
+  EXPECT_EQ(64, manifest->config.max_decoded_leaf_node_bytes);
+  EXPECT_EQ(1, manifest->latest_version().root_height);
+
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_THAT(kvstore::Read(store, absl::StrFormat("a/%02d", i)).result(),
+                MatchesKvsReadResult(absl::Cord("xyz")));
+  }
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(OcdbtTest, Lz4Compression) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config",
+                                   {{"compression", {{"id", "lz4"}}}}}})
+          .result());
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "a", absl::Cord("xyz")));
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto manifest, ReadManifest(driver));
+  ASSERT_TRUE(manifest);
+  EXPECT_EQ(Config::Compression(Config::Lz4Compression{}),
+            manifest->config.compression);
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("xyz")));
+  tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST(OcdbtTest, ZstdDictionaryCompressionWithSameDictionaryId) {
+  // Two different dictionaries that both specify dictionary ID 1234, generated
+  // by `ZDICT_finalizeDictionary`.
+  const char* const kDictionaries[] = {
+      "N6Qw7NIEAAAtELiX0gH8/////////9+neE7O3P//F4QIIYTsvbdCqr/++uuvv/76"
+      "66+//vo/Q0BAQCBsE0IIERGRB1SgQEFBQUFBQUFBQUFBQUFBQUFBQUFBQUFBQUFB"
+      "QUFBweuiKIqiKKWUUkqpquoBZMCAgYGBgcFcg8FgMBiGYRiGYRiGYRhjjDHGzA4B"
+      "AAAABAAAAAgAAABhYmNkZWZnaGlqa2xtbm9wcXJzdHV2d3h5ejAxMjM0NTY3ODk=",
+      "N6Qw7NIEAAAtELiX0gH8/////////9+neE7O3P//F4QIIYTsvbdCqr/++uuvv/76"
+      "66+//vo/Q0BAQCBsE0IIERGRB1SgQEFBQUFBQUFBQUFBQUFBQUFBQUFBQUFBQUFB"
+      "QUFBweuiKIqiKKWUUkqpquoBZMCAgYGBgcFcg8FgMBiGYRiGYRiGYRhjjDHGzA4B"
+      "AAAABAAAAAgAAAA5ODc2NTQzMjEwenl4d3Z1dHNycXBvbm1sa2ppaGdmZWRjYmE=",
+  };
+  // Both databases are open at once and share the cache pool.
+  auto context = Context::Default();
+  std::vector<tensorstore::KvStore> stores;
+  for (size_t i = 0; i < std::size(kDictionaries); ++i) {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto store,
+        tensorstore::kvstore::Open(
+            {{"driver", "ocdbt"},
+             {"base", absl::StrFormat("memory://%d/", i)},
+             {"config",
+              {{"compression",
+                {{"id", "zstd"}, {"dictionary", kDictionaries[i]}}}}}},
+            context)
+            .result());
+    stores.push_back(std::move(store));
+  }
+  for (size_t i = 0; i < stores.size(); ++i) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(
+        stores[i], "a", absl::Cord(absl::StrFormat("abcdefghij%d", i))));
+  }
+  for (size_t i = 0; i < stores.size(); ++i) {
+    EXPECT_THAT(
+        kvstore::Read(stores[i], "a").result(),
+        MatchesKvsReadResult(absl::Cord(absl::StrFormat("abcdefghij%d", i))));
+  }
+}
+
+TEST(OcdbtTest, BatchRead) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config",
+                                   {{"max_decoded_node_bytes", 1},
+                                    {"max_inline_value_bytes", 4}}}})
+          .result());
+  // Even keys are stored inline, odd keys are stored indirectly.
+  const auto get_value = [](int i) {
+    return absl::Cord(std::string(i % 2 ? 10 : 3, 'a' + i));
+  };
+  for (int i = 0; i < 20; ++i) {
+    TENSORSTORE_EXPECT_OK(
+        kvstore::Write(store, absl::StrFormat("a/%02d", i), get_value(i)));
+  }
+
+  std::vector<tensorstore::Future<kvstore::ReadResult>> present, missing,
+      partial;
+  {
+    auto batch = tensorstore::Batch::New();
+    kvstore::ReadOptions options;
+    options.batch = batch;
+    for (int i = 19; i >= 0; --i) {
+      present.push_back(
+          kvstore::Read(store, absl::StrFormat("a/%02d", i), options));
+      missing.push_back(
+          kvstore::Read(store, absl::StrFormat("a/%02dx", i), options));
+    }
+    missing.push_back(kvstore::Read(store, "b", options));
+    kvstore::ReadOptions partial_options = options;
+    partial_options.byte_range = tensorstore::OptionalByteRangeRequest(1, 2);
+    partial.push_back(kvstore::Read(store, "a/00", partial_options));
+    partial.push_back(kvstore::Read(store, "a/01", partial_options));
+    kvstore::ReadOptions conditional_options = options;
+    conditional_options.generation_conditions.if_equal =
+        tensorstore::StorageGeneration::FromString("x");
+    partial.push_back(kvstore::Read(store, "a/01", conditional_options));
+  }
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_THAT(present[19 - i].result(), MatchesKvsReadResult(get_value(i)))
+        << i;
+  }
+  for (auto& future : missing) {
+    EXPECT_THAT(future.result(), MatchesKvsReadResultNotFound());
+  }
+  EXPECT_THAT(partial[0].result(), MatchesKvsReadResult(absl::Cord("a")));
+  EXPECT_THAT(partial[1].result(), MatchesKvsReadResult(absl::Cord("b")));
+  EXPECT_THAT(partial[2].result(),
+              ::testing::Optional(::testing::Field(
+                  &kvstore::ReadResult::state,
+                  kvstore::ReadResult::kUnspecified)));
+}
+
+TEST(OcdbtTest, KeyOrderedWrites) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config", {{"max_inline_value_bytes", 0}}},
+                                  {"experimental_key_ordered_writes", true}})
+          .result());
+  std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>>
+      futures;
+  for (int i = 19; i >= 0; --i) {
+    futures.push_back(
+        kvstore::Write(store, absl::StrFormat("a/%02d", i), absl::Cord("xyz")));
+  }
+  for (auto& future : futures) {
+    TENSORSTORE_EXPECT_OK(future);
+  }
+
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto manifest, ReadManifest(driver));
+  ASSERT_TRUE(manifest);
+  auto& version = manifest->latest_version();
+  ASSERT_EQ(0, version.root_height);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto node,
+      GetOcdbtIoHandle(driver)->GetBtreeNode(version.root.location).result());
+  auto& entries = std::get<BtreeNode::LeafNodeEntries>(node->entries);
+  ASSERT_EQ(20, entries.size());
+
+  // Within each data file, values must be laid out in key order, even though
+  // they were written in reverse key order.
+  absl::flat_hash_map<DataFileId, uint64_t> last_offset;
+  for (auto& entry : entries) {
+    auto* ref = std::get_if<IndirectDataReference>(&entry.value_reference);
+    ASSERT_TRUE(ref) << entry.key;
+    auto [it, inserted] = last_offset.emplace(ref->file_id, ref->offset);
+    if (!inserted) {
+      EXPECT_GT(ref->offset, it->second) << entry.key;
+      it->second = ref->offset;
+    }
+  }
+}
+
+TEST(OcdbtTest, DeduplicateValues) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      tensorstore::kvstore::Open({{"driver", "ocdbt"},
+                                  {"base", "memory://"},
+                                  {"config", {{"max_inline_value_bytes", 0}}},
+                                  {"experimental_deduplicate_values", true}})
+          .result());
+  for (int i = 0; i < 10; ++i) {
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store, absl::StrFormat("a/%02d", i),
+                                         absl::Cord(i % 2 ? "odd" : "even")));
+  }
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_THAT(kvstore::Read(store, absl::StrFormat("a/%02d", i)).result(),
+                MatchesKvsReadResult(absl::Cord(i % 2 ? "odd" : "even")));
+  }
+
+  auto& driver = static_cast<OcdbtDriver&>(*store.driver);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto manifest, ReadManifest(driver));
+  ASSERT_TRUE(manifest);
+  auto& version = manifest->latest_version();
+  ASSERT_EQ(0, version.root_height);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto node,
+      GetOcdbtIoHandle(driver)->GetBtreeNode(version.root.location).result());
+  auto& entries = std::get<BtreeNode::LeafNodeEntries>(node->entries);
+  ASSERT_EQ(10, entries.size());
+
+  // Identical values share a single stored copy.
+  std::vector<IndirectDataReference> refs;
+  for (auto& entry : entries) {
+    auto* ref = std::get_if<IndirectDataReference>(&entry.value_reference);
+    ASSERT_TRUE(ref) << entry.key;
+    refs.push_back(*ref);
+  }
+  for (size_t i = 2; i < refs.size(); ++i) {
+    EXPECT_EQ(refs[i % 2], refs[i]) << i;
+  }
+  EXPECT_NE(refs[0], refs[1]);
+}
+
 TEST(OcdbtTest, WithExperimentalSpec) {
   ::nlohmann::json json_spec{
       {"driver", "ocdbt"},
@@ -360,6 +625,9 @@ TEST(OcdbtTest, WithExperimentalSpec) {
       {"experimental_read_coalescing_merged_bytes", 2048},
       {"experimental_read_coalescing_interval", "10ms"},
       {"target_data_file_size", 1024},
+      {"experimental_key_ordered_writes", true},
+      {"experimental_deduplicate_values", true},
+      {"experimental_list_concurrency", 2},
   };
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
       auto store, tensorstore::kvstore::Open(json_spec).result());
@@ -0,0 +1,107 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "absl/flags/parse.h"
+#include "tensorstore/internal/json_binding/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/internal/path.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/export_snapshot_util.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/util/json_absl_flag.h"
+#include "tensorstore/util/result.h"
+
+ABSL_FLAG(tensorstore::JsonAbslFlag<std::optional<tensorstore::kvstore::Spec>>,
+          kvstore, std::nullopt, "Underlying kvstore of the OCDBT database");
+ABSL_FLAG(tensorstore::JsonAbslFlag<std::optional<tensorstore::kvstore::Spec>>,
+          target, std::nullopt, "Kvstore to which the snapshot is written");
+ABSL_FLAG(uint64_t, generation, 0,
+          "Generation number to export, or 0 for the latest version");
+ABSL_FLAG(int64_t, target_data_file_bytes, int64_t{256} << 20,
+          "Target size of each packed data file");
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+namespace {
+absl::Status RunExportSnapshotCommand() {
+  auto kvs_spec = absl::GetFlag(FLAGS_kvstore).value;
+  if (!kvs_spec) {
+    return absl::InvalidArgumentError("Must specify --kvstore");
+  }
+  auto target_spec = absl::GetFlag(FLAGS_target).value;
+  if (!target_spec) {
+    return absl::InvalidArgumentError("Must specify --target");
+  }
+  internal::EnsureDirectoryPath(kvs_spec->path);
+  internal::EnsureDirectoryPath(target_spec->path);
+  TENSORSTORE_ASSIGN_OR_RETURN(auto base_json, kvs_spec->ToJson());
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto kvs,
+      kvstore::Open({{"driver", "ocdbt"}, {"base", std::move(base_json)}})
+          .result());
+  TENSORSTORE_ASSIGN_OR_RETURN(auto target,
+                               kvstore::Open(*std::move(target_spec)).result());
+
+  ExportSnapshotOptions options;
+  if (GenerationNumber generation = absl::GetFlag(FLAGS_generation)) {
+    options.version = generation;
+  }
+  options.target_data_file_bytes = absl::GetFlag(FLAGS_target_data_file_bytes);
+  TENSORSTORE_ASSIGN_OR_RETURN(auto stats,
+                               ExportSnapshot(kvs, target, options));
+  std::cout << stats << std::endl;
+  return absl::OkStatus();
+}
+}  // namespace
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);  // InitTensorstore
+  auto status = tensorstore::internal_ocdbt::RunExportSnapshotCommand();
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+
+    if (absl::IsInvalidArgument(status)) {
+      std::cerr << "Usage: " << argv[0]
+                << " --kvstore <kvstore-json-spec>"
+                << " --target <kvstore-json-spec> [--generation N]\n";
+      std::cerr << R"(
+The kvstore must refer to a prefix/directory containing an OCDBT database.
+
+Writes the specified version (by default the latest version) as a read-only
+snapshot to the target prefix/directory, which may then be opened using the
+"ocdbt_snapshot" kvstore driver.
+
+Example usage:
+
+bazel run //tensorstore/kvstore/ocdbt:export_snapshot -- --kvstore '"file:///tmp/ocdbt/"' --target '"file:///tmp/snapshot/"'
+
+)";
+      std::cerr << std::flush;
+    }
+    return 1;
+  }
+  return 0;
+}
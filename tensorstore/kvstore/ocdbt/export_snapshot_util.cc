@@ -0,0 +1,239 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/export_snapshot_util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "tensorstore/batch.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/driver.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/data_file_id.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/snapshot_index.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/read_version.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+namespace {
+
+// Prefix under the snapshot root of the packed data files.
+constexpr std::string_view kSnapshotDataFilePrefix = "d/";
+
+// Appends all leaf entries of the B+tree specified by `root`, with their full
+// keys, to `entries`.
+//
+// The tree is traversed breadth-first, such that all nodes at a given level
+// are read concurrently.  Since children are visited in order and all leaves
+// are at the same height, the entries are appended in key order.
+absl::Status CollectSnapshotEntries(const ReadonlyIoHandle& io_handle,
+                                    const BtreeGenerationReference& root,
+                                    std::vector<SnapshotIndexEntry>& entries) {
+  if (root.root.location.IsMissing()) return absl::OkStatus();
+  struct PendingNode {
+    IndirectDataReference location;
+    // Full inclusive min key of the subtree.
+    std::string inclusive_min_key;
+    // Length of the prefix of `inclusive_min_key` that is excluded from the
+    // encoded representation of the node.
+    size_t subtree_common_prefix_length;
+  };
+  std::vector<PendingNode> nodes;
+  nodes.push_back(PendingNode{root.root.location, {}, 0});
+  for (BtreeNodeHeight height = root.root_height;; --height) {
+    std::vector<Future<const std::shared_ptr<const BtreeNode>>> futures;
+    {
+      Batch batch = Batch::New();
+      for (const auto& pending : nodes) {
+        futures.push_back(io_handle.GetBtreeNode(pending.location, batch));
+      }
+    }
+    std::vector<PendingNode> children;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto node, futures[i].result());
+      auto& pending = nodes[i];
+      TENSORSTORE_RETURN_IF_ERROR(ValidateBtreeNodeReference(
+          *node, height,
+          std::string_view(pending.inclusive_min_key)
+              .substr(pending.subtree_common_prefix_length)));
+      std::string subtree_key_prefix = tensorstore::StrCat(
+          std::string_view(pending.inclusive_min_key)
+              .substr(0, pending.subtree_common_prefix_length),
+          node->key_prefix);
+      if (height == 0) {
+        for (const auto& entry :
+             std::get<BtreeNode::LeafNodeEntries>(node->entries)) {
+          entries.push_back(SnapshotIndexEntry{
+              tensorstore::StrCat(subtree_key_prefix, entry.key),
+              entry.value_reference});
+        }
+        continue;
+      }
+      for (const auto& entry :
+           std::get<BtreeNode::InteriorNodeEntries>(node->entries)) {
+        children.push_back(PendingNode{
+            entry.node.location,
+            tensorstore::StrCat(subtree_key_prefix, entry.key),
+            subtree_key_prefix.size() + entry.subtree_common_prefix_length});
+      }
+    }
+    if (height == 0) break;
+    nodes = std::move(children);
+  }
+  return absl::OkStatus();
+}
+
+// Copies the out-of-line values of `entries` into a single new data file within
+// `target`, and updates their references to point to it.
+absl::Status WriteSnapshotDataFile(const ReadonlyIoHandle& io_handle,
+                                   const KvStore& target,
+                                   span<SnapshotIndexEntry> entries) {
+  std::vector<Future<kvstore::ReadResult>> read_futures;
+  {
+    kvstore::ReadOptions read_options;
+    Batch batch = Batch::New();
+    read_options.batch = batch;
+    for (auto& entry : entries) {
+      if (auto* ref =
+              std::get_if<IndirectDataReference>(&entry.value_reference)) {
+        read_futures.push_back(io_handle.ReadIndirectData(*ref, read_options));
+      }
+    }
+  }
+  const DataFileId file_id = GenerateDataFileId(kSnapshotDataFilePrefix);
+  absl::Cord data;
+  size_t read_index = 0;
+  for (auto& entry : entries) {
+    auto* ref = std::get_if<IndirectDataReference>(&entry.value_reference);
+    if (!ref) continue;
+    TENSORSTORE_ASSIGN_OR_RETURN(auto read_result,
+                                 read_futures[read_index++].result());
+    if (!read_result.has_value()) {
+      return absl::DataLossError(tensorstore::StrCat(
+          "Value for key ", tensorstore::QuoteString(entry.key),
+          " not found at ", *ref));
+    }
+    ref->file_id = file_id;
+    ref->offset = data.size();
+    ref->length = read_result.value.size();
+    data.Append(std::move(read_result.value));
+  }
+  return kvstore::Write(target, file_id.FullPath(), std::move(data))
+      .result()
+      .status();
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const ExportSnapshotStatistics& x) {
+  return os << "{generation_number=" << x.generation_number
+            << ", num_keys=" << x.num_keys
+            << ", num_inline_values=" << x.num_inline_values
+            << ", num_data_files=" << x.num_data_files
+            << ", num_data_file_bytes=" << x.num_data_file_bytes << "}";
+}
+
+Result<ExportSnapshotStatistics> ExportSnapshot(
+    const KvStore& store, const KvStore& target,
+    const ExportSnapshotOptions& options) {
+  auto* driver = dynamic_cast<OcdbtDriver*>(store.driver.get());
+  if (!driver) {
+    return absl::InvalidArgumentError(
+        "Snapshot export requires a kvstore using the \"ocdbt\" driver");
+  }
+  const auto& io_handle = driver->io_handle_;
+  TENSORSTORE_ASSIGN_OR_RETURN(auto manifest_with_time,
+                               io_handle->GetManifest(absl::Now()).result());
+  ExportSnapshotStatistics stats;
+  SnapshotIndex index;
+  Config index_config;
+  if (manifest_with_time.manifest) {
+    index_config.compression = manifest_with_time.manifest->config.compression;
+    if (auto* zstd =
+            std::get_if<Config::ZstdCompression>(&index_config.compression)) {
+      zstd->dictionary = {};
+    }
+    BtreeGenerationReference root;
+    if (options.version) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          root, ReadVersion(io_handle, *options.version).result());
+    } else {
+      root = manifest_with_time.manifest->latest_version();
+    }
+    stats.generation_number = root.generation_number;
+    TENSORSTORE_RETURN_IF_ERROR(
+        CollectSnapshotEntries(*io_handle, root, index.entries));
+  } else if (options.version) {
+    return absl::NotFoundError(
+        tensorstore::StrCat("Version ", FormatVersionSpec(*options.version),
+                            " not present in empty database"));
+  }
+
+  auto& entries = index.entries;
+  stats.num_keys = entries.size();
+  for (size_t begin = 0; begin < entries.size();) {
+    size_t end = begin;
+    int64_t file_bytes = 0;
+    for (; end < entries.size() && file_bytes < options.target_data_file_bytes;
+         ++end) {
+      if (auto* ref =
+              std::get_if<IndirectDataReference>(&entries[end].value_reference)) {
+        file_bytes += ref->length;
+      } else {
+        ++stats.num_inline_values;
+      }
+    }
+    if (file_bytes != 0) {
+      TENSORSTORE_RETURN_IF_ERROR(WriteSnapshotDataFile(
+          *io_handle, target,
+          span<SnapshotIndexEntry>(entries.data() + begin, end - begin)));
+      ++stats.num_data_files;
+      stats.num_data_file_bytes += file_bytes;
+    }
+    begin = end;
+  }
+
+  TENSORSTORE_ASSIGN_OR_RETURN(auto encoded,
+                               EncodeSnapshotIndex(index_config, index));
+  TENSORSTORE_RETURN_IF_ERROR(
+      kvstore::Write(target, kSnapshotIndexKey, std::move(encoded)).result());
+  return stats;
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,86 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_EXPORT_SNAPSHOT_UTIL_H_
+#define TENSORSTORE_KVSTORE_OCDBT_EXPORT_SNAPSHOT_UTIL_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <optional>
+
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Options for `ExportSnapshot`.
+struct ExportSnapshotOptions {
+  /// Version to export.  If not specified, the latest version is exported.
+  std::optional<VersionSpec> version;
+
+  /// Target size of each packed data file.  Values are never split across data
+  /// files, so a single large value may exceed this size.
+  int64_t target_data_file_bytes = int64_t{256} << 20;
+};
+
+/// Statistics returned by `ExportSnapshot`.
+struct ExportSnapshotStatistics {
+  /// Generation number of the exported version, or `0` if the database is
+  /// empty.
+  GenerationNumber generation_number = 0;
+
+  /// Number of keys in the snapshot.
+  int64_t num_keys = 0;
+
+  /// Number of values stored inline in the index.
+  int64_t num_inline_values = 0;
+
+  /// Number of packed data files written.
+  int64_t num_data_files = 0;
+
+  /// Total size of the values stored in packed data files.
+  int64_t num_data_file_bytes = 0;
+
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const ExportSnapshotStatistics& x);
+};
+
+/// Exports a single version of an OCDBT database as a read-only snapshot
+/// readable using the ``"ocdbt_snapshot"`` driver.
+///
+/// All keys of the version are written to a single sorted index, stored under
+/// `kSnapshotIndexKey` within `target`.  Values stored inline in the B+tree
+/// remain inline in the index; all other values are copied, in key order, into
+/// packed data files under ``d/`` within `target`.  The index is written last,
+/// such that a partially-written snapshot is never visible.
+///
+/// Blocks until the export completes.
+///
+/// \param store Open kvstore using the ``"ocdbt"`` driver (the path is
+///     ignored).
+/// \param target Location of the snapshot, which should be empty.
+/// \error `absl::StatusCode::kInvalidArgument` if `store` does not use the
+///     ``"ocdbt"`` driver.
+/// \error `absl::StatusCode::kNotFound` if `options.version` does not exist.
+Result<ExportSnapshotStatistics> ExportSnapshot(
+    const KvStore& store, const KvStore& target,
+    const ExportSnapshotOptions& options = {});
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_EXPORT_SNAPSHOT_UTIL_H_
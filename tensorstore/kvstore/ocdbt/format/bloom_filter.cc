@@ -0,0 +1,120 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <string_view>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+namespace {
+
+// Every filter has at least 64 bits, to limit the false positive rate for
+// nodes with very few keys.
+constexpr size_t kMinBloomFilterBits = 64;
+
+// Iterates over the bit positions of `hash` within a filter of `num_bits`
+// bits, using double hashing.
+template <typename Callback>
+bool ForEachProbe(uint64_t hash, uint8_t num_probes, size_t num_bits,
+                  Callback callback) {
+  const uint64_t delta = (hash >> 33) | (hash << 31);
+  for (uint8_t i = 0; i < num_probes; ++i) {
+    if (!callback(static_cast<size_t>(hash % num_bits))) return false;
+    hash += delta;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint64_t GetBloomFilterKeyHash(std::string_view key) {
+  // 64-bit FNV-1a, followed by the MurmurHash3 finalizer for better avalanche
+  // behavior on keys that differ only in their last bytes.
+  uint64_t h = 0xcbf29ce484222325;
+  for (char c : key) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 0x100000001b3;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccd;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53;
+  h ^= h >> 33;
+  return h;
+}
+
+BloomFilterBuilder::BloomFilterBuilder(uint32_t bits_per_key)
+    : bits_per_key_(bits_per_key) {
+  assert(bits_per_key >= 1 && bits_per_key <= kMaxBloomFilterBitsPerKey);
+}
+
+std::string BloomFilterBuilder::Finalize() const {
+  // ln(2) * bits_per_key minimizes the false positive rate.
+  const uint8_t num_probes = static_cast<uint8_t>(std::clamp<uint32_t>(
+      (bits_per_key_ * 69 + 50) / 100, 1, kMaxBloomFilterProbes));
+  size_t num_bits =
+      std::max(kMinBloomFilterBits, hashes_.size() * bits_per_key_);
+  const size_t num_bytes = (num_bits + 7) / 8;
+  num_bits = num_bytes * 8;
+  std::string filter(num_bytes + 1, '\0');
+  filter[0] = static_cast<char>(num_probes);
+  char* bits = filter.data() + 1;
+  for (uint64_t hash : hashes_) {
+    ForEachProbe(hash, num_probes, num_bits, [&](size_t bit) {
+      bits[bit / 8] |= static_cast<char>(1 << (bit % 8));
+      return true;
+    });
+  }
+  return filter;
+}
+
+bool BloomFilterMayContain(std::string_view filter, std::string_view key) {
+  if (filter.empty()) return true;
+  const uint8_t num_probes = static_cast<uint8_t>(filter[0]);
+  const char* bits = filter.data() + 1;
+  const size_t num_bits = (filter.size() - 1) * 8;
+  return ForEachProbe(GetBloomFilterKeyHash(key), num_probes, num_bits,
+                      [&](size_t bit) {
+                        return (bits[bit / 8] & (1 << (bit % 8))) != 0;
+                      });
+}
+
+absl::Status ValidateBloomFilter(std::string_view filter) {
+  if (filter.empty()) return absl::OkStatus();
+  if (filter.size() < 2) {
+    return absl::DataLossError("Bloom filter is missing bit array");
+  }
+  const uint8_t num_probes = static_cast<uint8_t>(filter[0]);
+  if (num_probes == 0 || num_probes > kMaxBloomFilterProbes) {
+    return absl::DataLossError(absl::StrFormat(
+        "Bloom filter number of probes %d is outside valid range [1, %d]",
+        num_probes, kMaxBloomFilterProbes));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
@@ -0,0 +1,88 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_FORMAT_BLOOM_FILTER_H_
+#define TENSORSTORE_KVSTORE_OCDBT_FORMAT_BLOOM_FILTER_H_
+
+/// \file
+///
+/// Bloom filters over the keys of a b+tree leaf node.
+///
+/// A filter is stored along with each reference to a leaf node (within the
+/// parent interior node), and allows a read of a key that is not present to
+/// stop without fetching the leaf node.
+///
+/// The encoded representation is a single byte specifying the number of probes,
+/// followed by the bit array.  The bit positions are derived from a fixed
+/// 64-bit hash of the key, such that the encoding is platform independent.
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/status.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Maximum supported value of `Config::bloom_filter_bits_per_key`.
+constexpr uint32_t kMaxBloomFilterBitsPerKey = 64;
+
+/// Maximum number of probes per key.
+constexpr uint8_t kMaxBloomFilterProbes = 30;
+
+/// Returns the hash of `key` used to compute bit positions.
+uint64_t GetBloomFilterKeyHash(std::string_view key);
+
+/// Accumulates the hashes of keys and produces an encoded filter.
+class BloomFilterBuilder {
+ public:
+  /// Constructs a builder.
+  ///
+  /// \param bits_per_key Number of filter bits per key, must be in the range
+  ///     `[1, kMaxBloomFilterBitsPerKey]`.
+  explicit BloomFilterBuilder(uint32_t bits_per_key);
+
+  void AddKey(std::string_view key) {
+    hashes_.push_back(GetBloomFilterKeyHash(key));
+  }
+
+  /// Returns the encoded filter over all keys added.
+  std::string Finalize() const;
+
+ private:
+  uint32_t bits_per_key_;
+  std::vector<uint64_t> hashes_;
+};
+
+/// Returns `false` if `key` is definitely not contained in the set of keys
+/// used to build `filter`.
+///
+/// An empty `filter` indicates that no filter is available, and always returns
+/// `true`.
+///
+/// \param filter Encoded filter, must be valid according to
+///     `ValidateBloomFilter`.
+bool BloomFilterMayContain(std::string_view filter, std::string_view key);
+
+/// Validates an encoded filter.
+absl::Status ValidateBloomFilter(std::string_view filter);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_FORMAT_BLOOM_FILTER_H_
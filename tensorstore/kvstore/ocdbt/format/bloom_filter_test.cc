@@ -0,0 +1,94 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_ocdbt::BloomFilterBuilder;
+using ::tensorstore::internal_ocdbt::BloomFilterMayContain;
+using ::tensorstore::internal_ocdbt::GetBloomFilterKeyHash;
+using ::tensorstore::internal_ocdbt::ValidateBloomFilter;
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+  BloomFilterBuilder builder(10);
+  for (int i = 0; i < 1000; ++i) {
+    builder.AddKey(absl::StrFormat("%d.%d.0", i / 10, i % 10));
+  }
+  auto filter = builder.Finalize();
+  TENSORSTORE_EXPECT_OK(ValidateBloomFilter(filter));
+  EXPECT_EQ(10000 / 8 + 1, filter.size());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(BloomFilterMayContain(
+        filter, absl::StrFormat("%d.%d.0", i / 10, i % 10)))
+        << i;
+  }
+  size_t false_positives = 0;
+  for (int i = 0; i < 10000; ++i) {
+    if (BloomFilterMayContain(filter,
+                              absl::StrFormat("%d.%d.1", i / 10, i % 10))) {
+      ++false_positives;
+    }
+  }
+  // The expected false positive rate for 10 bits per key is about 1%.
+  EXPECT_LT(false_positives, 300);
+}
+
+TEST(BloomFilterTest, Empty) {
+  // An empty filter is treated as absent.
+  EXPECT_TRUE(BloomFilterMayContain("", "a"));
+  TENSORSTORE_EXPECT_OK(ValidateBloomFilter(""));
+
+  // A filter over no keys excludes all keys.
+  auto filter = BloomFilterBuilder(10).Finalize();
+  EXPECT_EQ(9, filter.size());
+  EXPECT_FALSE(BloomFilterMayContain(filter, "a"));
+}
+
+TEST(BloomFilterTest, StableHash) {
+  // The hash is part of the storage format and must not change.
+  EXPECT_EQ(uint64_t{0xefd01f60ba992926}, GetBloomFilterKeyHash(""));
+  EXPECT_EQ(uint64_t{0x33ebaf9927cbc5bd}, GetBloomFilterKeyHash("abc"));
+  auto filter = std::string("\x01\x00\x00\x00\x00\x00\x00\x00\x00", 9);
+  size_t bit = GetBloomFilterKeyHash("abc") % 64;
+  filter[1 + bit / 8] = static_cast<char>(1 << (bit % 8));
+  EXPECT_TRUE(BloomFilterMayContain(filter, "abc"));
+}
+
+TEST(BloomFilterTest, Invalid) {
+  EXPECT_THAT(ValidateBloomFilter(std::string(1, '\x01')),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Bloom filter is missing bit array"));
+  EXPECT_THAT(ValidateBloomFilter(std::string(2, '\0')),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Bloom filter number of probes 0 is outside .*"));
+  EXPECT_THAT(ValidateBloomFilter(std::string(2, '\x1f')),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Bloom filter number of probes 31 is outside .*"));
+}
+
+}  // namespace
@@ -181,17 +181,36 @@ bool ReadKeys(riegeli::Reader& reader, std::string_view& common_prefix,
 template <typename Entry>
 bool ReadBtreeNodeEntries(riegeli::Reader& reader,
                           const DataFileTable& data_file_table,
-                          uint64_t num_entries, BtreeNode& node) {
+                          uint64_t num_entries, uint32_t version,
+                          BtreeNode& node) {
   auto& entries = node.entries.emplace<std::vector<Entry>>();
   entries.resize(num_entries);
   if (!ReadKeys<Entry>(reader, node.key_prefix, node.key_buffer, entries)) {
     return false;
   }
   if constexpr (std::is_same_v<Entry, InteriorNodeEntry>) {
-    return BtreeNodeReferenceArrayCodec{data_file_table,
-                                        [](auto& entry) -> decltype(auto) {
-                                          return (entry.node);
-                                        }}(reader, entries);
+    if (!BtreeNodeReferenceArrayCodec{data_file_table,
+                                      [](auto& entry) -> decltype(auto) {
+                                        return (entry.node);
+                                      }}(reader, entries)) {
+      return false;
+    }
+    if (version < kBtreeNodeBloomFilterFormatVersion) return true;
+    if (!BloomFilterArrayCodec{[](auto& entry) -> decltype(auto) {
+          return (entry.node.bloom_filter);
+        }}(reader, entries)) {
+      return false;
+    }
+    if (node.height != 1) {
+      for (const auto& entry : entries) {
+        if (!entry.node.bloom_filter.empty()) {
+          reader.Fail(absl::DataLossError(
+              "Bloom filter specified for reference to interior node"));
+          return false;
+        }
+      }
+    }
+    return true;
   } else {
     return LeafNodeValueReferenceArrayCodec{data_file_table,
                                             [](auto& entry) -> decltype(auto) {
@@ -202,8 +221,9 @@ bool ReadBtreeNodeEntries(riegeli::Reader& reader,
 
 }  // namespace
 
-Result<BtreeNode> DecodeBtreeNode(const absl::Cord& encoded,
-                                  const BasePath& base_path) {
+Result<BtreeNode> DecodeBtreeNode(
+    const absl::Cord& encoded, const BasePath& base_path,
+    const Config::ZstdDictionary& zstd_dictionary) {
   BtreeNode node;
   auto status = DecodeWithOptionalCompression(
       encoded, kBtreeNodeMagic, kBtreeNodeFormatVersion,
@@ -226,13 +246,14 @@ Result<BtreeNode> DecodeBtreeNode(const absl::Cord& encoded,
           return false;
         }
         if (node.height == 0) {
-          return ReadBtreeNodeEntries<LeafNodeEntry>(reader, data_file_table,
-                                                     num_entries, node);
+          return ReadBtreeNodeEntries<LeafNodeEntry>(
+              reader, data_file_table, num_entries, version, node);
         } else {
           return ReadBtreeNodeEntries<InteriorNodeEntry>(
-              reader, data_file_table, num_entries, node);
+              reader, data_file_table, num_entries, version, node);
         }
-      });
+      },
+      zstd_dictionary);
   if (!status.ok()) {
     return tensorstore::MaybeAnnotateStatus(status,
                                             "Error decoding b-tree node");
@@ -306,12 +327,16 @@ std::ostream& operator<<(std::ostream& os, const LeafNodeEntry& e) {
 }
 
 bool operator==(const BtreeNodeReference& a, const BtreeNodeReference& b) {
-  return a.location == b.location && a.statistics == b.statistics;
+  return a.location == b.location && a.statistics == b.statistics &&
+         a.bloom_filter == b.bloom_filter;
 }
 
 std::ostream& operator<<(std::ostream& os, const BtreeNodeReference& x) {
-  return os << "{location=" << x.location << ", statistics=" << x.statistics
-            << "}";
+  os << "{location=" << x.location << ", statistics=" << x.statistics;
+  if (!x.bloom_filter.empty()) {
+    os << ", bloom_filter_bytes=" << x.bloom_filter.size();
+  }
+  return os << "}";
 }
 
 std::ostream& operator<<(std::ostream& os, const InteriorNodeEntry& e) {
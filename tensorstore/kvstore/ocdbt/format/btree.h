@@ -38,6 +38,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/internal/estimate_heap_usage/estimate_heap_usage.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/span.h"
@@ -87,6 +88,13 @@ struct BtreeNodeReference {
   /// Statistics for the referenced sub-tree.
   BtreeNodeStatistics statistics;
 
+  /// Encoded Bloom filter over the keys of the referenced leaf node, relative
+  /// to the subtree common prefix, or empty if there is no filter.
+  ///
+  /// Only references to leaf nodes from interior nodes may have a filter.  See
+  /// `bloom_filter.h`.
+  std::string bloom_filter;
+
   friend bool operator==(const BtreeNodeReference& a,
                          const BtreeNodeReference& b);
   friend bool operator!=(const BtreeNodeReference& a,
@@ -96,7 +104,7 @@ struct BtreeNodeReference {
   friend std::ostream& operator<<(std::ostream& os,
                                   const BtreeNodeReference& x);
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.location, x.statistics);
+    return f(x.location, x.statistics, x.bloom_filter);
   };
 };
 
@@ -275,7 +283,8 @@ inline size_t EstimateDecodedEntrySizeExcludingKey(const LeafNodeEntry& entry) {
 /// an interior node entry.
 inline size_t EstimateDecodedEntrySizeExcludingKey(
     const InteriorNodeEntry& entry) {
-  return kInteriorNodeFixedSize + entry.node.location.file_id.size();
+  return kInteriorNodeFixedSize + entry.node.location.file_id.size() +
+         entry.node.bloom_filter.size();
 }
 
 /// Validates that a b+tree node has the expected height and min key.
@@ -286,8 +295,12 @@ absl::Status ValidateBtreeNodeReference(const BtreeNode& node,
                                         std::string_view inclusive_min_key);
 
 /// Decodes a b+tree node.
-Result<BtreeNode> DecodeBtreeNode(const absl::Cord& encoded,
-                                  const BasePath& base_path);
+///
+/// \param zstd_dictionary Zstd dictionary specified by the configuration,
+///     required if the node was compressed with a dictionary.
+Result<BtreeNode> DecodeBtreeNode(
+    const absl::Cord& encoded, const BasePath& base_path,
+    const Config::ZstdDictionary& zstd_dictionary = {});
 
 /// Function object where `ComparePrefixedKeyToUnprefixedKey{prefix}(a, b)`
 /// returns `(prefix + a).compare(b)`.
@@ -21,13 +21,16 @@
 /// version tree and manifest codecs.
 
 #include <cstdint>
+#include <string>
 #include <variant>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
@@ -39,7 +42,13 @@ namespace tensorstore {
 namespace internal_ocdbt {
 
 constexpr uint32_t kBtreeNodeMagic = 0x0cdb20de;
-constexpr uint8_t kBtreeNodeFormatVersion = 0;
+// Maximum b+tree node format version that is supported.
+constexpr uint8_t kBtreeNodeFormatVersion = 1;
+
+// First b+tree node format version that includes the `bloom_filter_length` and
+// `bloom_filter` columns in interior nodes.  Nodes without any filters are
+// still written using version 0.
+constexpr uint8_t kBtreeNodeBloomFilterFormatVersion = 1;
 constexpr size_t kMaxNodeArity = 1024 * 1024;
 
 using NumIndirectValueBytesCodec = VarintCodec<uint64_t>;
@@ -108,6 +117,44 @@ BtreeNodeReferenceArrayCodec(const DataFileTable&, Getter,
                              bool allow_missing = false)
     -> BtreeNodeReferenceArrayCodec<DataFileTable, Getter>;
 
+using BloomFilterLengthCodec = VarintCodec<uint64_t>;
+
+template <typename Getter>
+struct BloomFilterArrayCodec {
+  Getter getter;
+
+  template <typename Vec>
+  [[nodiscard]] bool operator()(riegeli::Reader& reader, Vec&& vec) const {
+    std::vector<uint64_t> lengths(vec.size());
+    for (auto& length : lengths) {
+      if (!BloomFilterLengthCodec{}(reader, length)) return false;
+    }
+    for (size_t i = 0; i < vec.size(); ++i) {
+      auto& filter = getter(vec[i]);
+      if (!reader.Read(lengths[i], filter)) return false;
+      TENSORSTORE_RETURN_IF_ERROR(ValidateBloomFilter(filter),
+                                  (reader.Fail(_), false));
+    }
+    return true;
+  }
+
+  template <typename Vec>
+  [[nodiscard]] bool operator()(riegeli::Writer& writer, Vec&& vec) const {
+    for (auto& entry : vec) {
+      if (!BloomFilterLengthCodec{}(writer, getter(entry).size())) {
+        return false;
+      }
+    }
+    for (auto& entry : vec) {
+      if (!writer.Write(getter(entry))) return false;
+    }
+    return true;
+  }
+};
+
+template <typename Getter>
+BloomFilterArrayCodec(Getter) -> BloomFilterArrayCodec<Getter>;
+
 template <typename DataFileTable, typename Getter>
 struct LeafNodeValueReferenceArrayCodec {
   const DataFileTable& data_file_table;
@@ -35,6 +35,7 @@
 #include "tensorstore/internal/integer_overflow.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/ocdbt/debug_defines.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/btree_codec.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
@@ -191,9 +192,22 @@ void BtreeNodeEncoder<Entry>::AddEntry(bool existing, Entry&& entry) {
 }
 
 namespace {
+// Returns `true` if any entry references a node with a Bloom filter, in which
+// case `kBtreeNodeBloomFilterFormatVersion` must be used.
+template <typename Entry>
+bool HasBloomFilters(
+    span<const typename BtreeNodeEncoder<Entry>::BufferedEntry> entries) {
+  if constexpr (std::is_same_v<Entry, InteriorNodeEntry>) {
+    for (const auto& entry : entries) {
+      if (!entry.entry.node.bloom_filter.empty()) return true;
+    }
+  }
+  return false;
+}
+
 template <typename Entry>
 bool EncodeEntriesInner(
-    riegeli::Writer& writer, BtreeNodeHeight height,
+    riegeli::Writer& writer, const Config& config, BtreeNodeHeight height,
     std::string_view existing_prefix,
     span<typename BtreeNodeEncoder<Entry>::BufferedEntry> entries, bool is_root,
     EncodedNodeInfo& info) {
@@ -288,6 +302,24 @@ bool EncodeEntriesInner(
             info.statistics.num_indirect_value_bytes, data_ref->length);
       }
     }
+
+    if (config.bloom_filter_bits_per_key != 0) {
+      // The filter is keyed by the portion of each key following the prefix
+      // that will be stored as the `subtree_common_prefix_length` of the
+      // reference to this node, since that is what a reader has left to match
+      // once it has located the reference within the parent node.
+      BloomFilterBuilder bloom_filter(config.bloom_filter_bits_per_key);
+      std::string key;
+      for (auto& entry : entries) {
+        key.clear();
+        tensorstore::StrAppend(
+            &key, entry.existing ? existing_prefix : std::string_view{},
+            entry.entry.key);
+        bloom_filter.AddKey(
+            std::string_view(key).substr(info.excluded_prefix_length));
+      }
+      info.bloom_filter = bloom_filter.Finalize();
+    }
   } else {
     if (!BtreeNodeReferenceArrayCodec{data_file_table,
                                       [](auto& e) -> decltype(auto) {
@@ -295,9 +327,16 @@ bool EncodeEntriesInner(
                                       }}(writer, entries)) {
       return false;
     }
+    if (HasBloomFilters<Entry>(entries) &&
+        !BloomFilterArrayCodec{[](auto& e) -> decltype(auto) {
+          return (e.entry.node.bloom_filter);
+        }}(writer, entries)) {
+      return false;
+    }
   }
   return true;
 }
+
 }  // namespace
 
 template <typename Entry>
@@ -308,12 +347,14 @@ Result<EncodedNode> EncodeEntries(
     bool is_root) {
   EncodedNode encoded;
   auto result = EncodeWithOptionalCompression(
-      config, kBtreeNodeMagic, kBtreeNodeFormatVersion,
+      config, kBtreeNodeMagic,
+      HasBloomFilters<Entry>(entries) ? kBtreeNodeBloomFilterFormatVersion : 0,
       [&](riegeli::Writer& writer) -> bool {
         // height
         if (!writer.WriteByte(height)) return false;
-        return EncodeEntriesInner<Entry>(writer, height, existing_prefix,
-                                         entries, is_root, encoded.info);
+        return EncodeEntriesInner<Entry>(writer, config, height,
+                                         existing_prefix, entries, is_root,
+                                         encoded.info);
       });
   TENSORSTORE_ASSIGN_OR_RETURN(
       encoded.encoded_node, std::move(result),
@@ -325,6 +366,17 @@ Result<EncodedNode> EncodeEntries(
 template <typename Entry>
 Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     bool may_be_root) {
+  std::vector<EncodedNode> encoded_nodes;
+  for (const auto& range : Partition(may_be_root)) {
+    TENSORSTORE_ASSIGN_OR_RETURN(auto encoded_node, EncodeNode(range));
+    encoded_nodes.push_back(std::move(encoded_node));
+  }
+  return encoded_nodes;
+}
+
+template <typename Entry>
+std::vector<typename BtreeNodeEncoder<Entry>::NodeRange>
+BtreeNodeEncoder<Entry>::Partition(bool may_be_root) const {
 #ifdef TENSORSTORE_INTERNAL_OCDBT_DEBUG
   // Verify that entries are sorted.
   for (size_t i = 1; i < buffered_entries_.size(); ++i) {
@@ -343,9 +395,11 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     }
   }
 #endif  //  TENSORSTORE_INTERNAL_OCDBT_DEBUG
-  std::vector<EncodedNode> encoded_nodes;
+  std::vector<NodeRange> ranges;
 
-  constexpr size_t kMinArity = std::is_same_v<Entry, LeafNodeEntry> ? 1 : 2;
+  constexpr bool kIsLeaf = std::is_same_v<Entry, LeafNodeEntry>;
+  constexpr size_t kMinArity = kIsLeaf ? 1 : 2;
+  const size_t max_decoded_node_bytes = config_.GetMaxDecodedNodeBytes(kIsLeaf);
 
   size_t start_i = 0;
   size_t prev_size_estimate = 0;
@@ -359,10 +413,10 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     size_t size_upper_bound = get_range_size(buffered_entries_.size());
     size_t num_nodes = tensorstore::CeilOfRatio<size_t>(
         buffered_entries_.size() - start_i, kMaxNodeArity);
-    if (config_.max_decoded_node_bytes != 0) {
-      num_nodes = std::max(
-          num_nodes, tensorstore::CeilOfRatio<size_t>(
-                         size_upper_bound, config_.max_decoded_node_bytes));
+    if (max_decoded_node_bytes != 0) {
+      num_nodes = std::max(num_nodes, tensorstore::CeilOfRatio<size_t>(
+                                          size_upper_bound,
+                                          max_decoded_node_bytes));
     }
     size_t target_size = tensorstore::CeilOfRatio(size_upper_bound, num_nodes);
     size_t end_i;
@@ -370,7 +424,7 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
       if (end_i - start_i >= kMaxNodeArity) break;
       size_t size = get_range_size(end_i);
       if (size >= target_size && end_i >= start_i + kMinArity) {
-        if (size > config_.max_decoded_node_bytes &&
+        if (size > max_decoded_node_bytes &&
             end_i > start_i + kMinArity) {
           --end_i;
         }
@@ -379,17 +433,23 @@ Result<std::vector<EncodedNode>> BtreeNodeEncoder<Entry>::Finalize(
     }
     assert(end_i > start_i);
     assert(end_i - start_i <= kMaxNodeArity);
-    TENSORSTORE_ASSIGN_OR_RETURN(
-        auto encoded_node,
-        EncodeEntries<Entry>(
-            config_, height_, existing_prefix_,
-            span(buffered_entries_.data() + start_i, end_i - start_i),
-            may_be_root && start_i == 0 && end_i == buffered_entries_.size()));
-    encoded_nodes.push_back(std::move(encoded_node));
+    ranges.push_back(NodeRange{
+        start_i, end_i,
+        may_be_root && start_i == 0 && end_i == buffered_entries_.size()});
     start_i = end_i;
     prev_size_estimate = buffered_entries_[end_i - 1].cumulative_size;
   }
-  return encoded_nodes;
+  return ranges;
+}
+
+template <typename Entry>
+Result<EncodedNode> BtreeNodeEncoder<Entry>::EncodeNode(
+    const NodeRange& range) {
+  assert(range.begin < range.end && range.end <= buffered_entries_.size());
+  return EncodeEntries<Entry>(
+      config_, height_, existing_prefix_,
+      span(buffered_entries_.data() + range.begin, range.end - range.begin),
+      range.is_root);
 }
 
 void AddNewInteriorEntry(BtreeNodeEncoder<InteriorNodeEntry>& encoder,
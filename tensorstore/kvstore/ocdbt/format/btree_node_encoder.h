@@ -37,6 +37,11 @@ struct EncodedNodeInfo {
 
   /// Statistics for the encoded node.
   BtreeNodeStatistics statistics;
+
+  /// Bloom filter over the keys of the encoded node, excluding the first
+  /// `excluded_prefix_length` bytes.  Only computed for leaf nodes, and only if
+  /// `Config::bloom_filter_bits_per_key` is non-zero; otherwise empty.
+  std::string bloom_filter;
 };
 
 /// Encoded b+tree node, generated by `BtreeNodeEncoder`.
@@ -82,6 +87,24 @@ class BtreeNodeEncoder {
   ///     `0`.  This is needed because no prefix is supported for the root node.
   Result<std::vector<EncodedNode>> Finalize(bool may_be_root);
 
+  /// Range of buffered entries that is encoded as a single node.
+  struct NodeRange {
+    size_t begin;
+    size_t end;
+    bool is_root;
+  };
+
+  /// Determines how the entries are split into nodes, without encoding them.
+  ///
+  /// `Finalize` is equivalent to calling `EncodeNode` for each returned range,
+  /// in order.
+  std::vector<NodeRange> Partition(bool may_be_root) const;
+
+  /// Encodes a single node returned by `Partition`.
+  ///
+  /// May be called concurrently from multiple threads for distinct ranges.
+  Result<EncodedNode> EncodeNode(const NodeRange& range);
+
   // Treat as private:
 
   struct BufferedEntry {
@@ -25,10 +25,13 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
 #include "riegeli/bytes/writer.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
 #include "tensorstore/kvstore/ocdbt/format/btree_codec.h"
 #include "tensorstore/kvstore/ocdbt/format/btree_node_encoder.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
@@ -41,6 +44,8 @@ namespace {
 
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
+using ::tensorstore::internal_ocdbt::BloomFilterBuilder;
+using ::tensorstore::internal_ocdbt::BloomFilterMayContain;
 using ::tensorstore::internal_ocdbt::BtreeNode;
 using ::tensorstore::internal_ocdbt::BtreeNodeEncoder;
 using ::tensorstore::internal_ocdbt::Config;
@@ -77,12 +82,19 @@ void TestBtreeNodeRoundTrip(const Config& config, const BtreeNode& node) {
       "data=",
       tensorstore::QuoteString(std::string(encoded_node.encoded_node))));
 
+  Config::ZstdDictionary zstd_dictionary;
+  if (const auto* zstd_config =
+          std::get_if<Config::ZstdCompression>(&config.compression)) {
+    zstd_dictionary = zstd_config->dictionary;
+  }
+
   std::visit(
       [&](const auto& entries) {
         using Entry = typename std::decay_t<decltype(entries)>::value_type;
         TENSORSTORE_ASSERT_OK_AND_ASSIGN(
             auto decoded_node,
-            DecodeBtreeNode(encoded_nodes[0].encoded_node, /*base_path=*/{}));
+            DecodeBtreeNode(encoded_nodes[0].encoded_node, /*base_path=*/{},
+                            zstd_dictionary));
 
         EXPECT_EQ(node.key_prefix,
                   tensorstore::StrCat(
@@ -109,6 +121,61 @@ TEST(BtreeNodeTest, LeafNodeRoundTrip) {
   TestBtreeNodeRoundTrip(config, node);
 }
 
+/// Returns a zstd dictionary with dictionary ID 1234, generated by
+/// `ZDICT_finalizeDictionary`.
+std::string GetTestZstdDictionary() {
+  std::string dictionary;
+  ABSL_CHECK(absl::Base64Unescape(
+      "N6Qw7NIEAAAtELiX0gH8/////////9+neE7O3P//F4QIIYTsvbdCqr/++uuvv/76"
+      "66+//vo/Q0BAQCBsE0IIERGRB1SgQEFBQUFBQUFBQUFBQUFBQUFBQUFBQUFBQUFB"
+      "QUFBweuiKIqiKKWUUkqpquoBZMCAgYGBgcFcg8FgMBiGYRiGYRiGYRhjjDHGzA4B"
+      "AAAABAAAAAgAAABhYmNkZWZnaGlqa2xtbm9wcXJzdHV2d3h5ejAxMjM0NTY3ODk=",
+      &dictionary));
+  return dictionary;
+}
+
+BtreeNode GetSimpleLeafNode() {
+  BtreeNode node;
+  node.height = 0;
+  node.key_prefix = "ab";
+  auto& entries = node.entries.emplace<BtreeNode::LeafNodeEntries>();
+  entries.push_back({/*.key =*/"c",
+                     /*.value_reference =*/absl::Cord("value1")});
+  entries.push_back({/*.key =*/"d",
+                     /*.value_reference =*/absl::Cord("value2")});
+  return node;
+}
+
+TEST(BtreeNodeTest, LeafNodeRoundTripLz4) {
+  Config config;
+  config.compression = Config::Lz4Compression{};
+  TestBtreeNodeRoundTrip(config, GetSimpleLeafNode());
+}
+
+TEST(BtreeNodeTest, LeafNodeRoundTripZstdDictionary) {
+  Config config;
+  config.compression = Config::ZstdCompression{
+      /*level=*/3, Config::ZstdDictionary(GetTestZstdDictionary())};
+  auto node = GetSimpleLeafNode();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded_nodes,
+                                   EncodeExistingNode(config, node));
+  ASSERT_EQ(1, encoded_nodes.size());
+  EXPECT_EQ(3, encoded_nodes[0].encoded_node.Subcord(13, 1).Flatten()[0]);
+  TestBtreeNodeRoundTrip(config, node);
+}
+
+TEST(BtreeNodeTest, ZstdDictionaryRequired) {
+  Config config;
+  config.compression = Config::ZstdCompression{
+      /*level=*/3, Config::ZstdDictionary(GetTestZstdDictionary())};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto encoded_nodes, EncodeExistingNode(config, GetSimpleLeafNode()));
+  ASSERT_EQ(1, encoded_nodes.size());
+  EXPECT_THAT(DecodeBtreeNode(encoded_nodes[0].encoded_node, /*base_path=*/{}),
+              MatchesStatus(absl::StatusCode::kFailedPrecondition,
+                            ".*Zstd dictionary.*"));
+}
+
 TEST(BtreeNodeTest, InteriorNodeRoundTrip) {
   Config config;
   BtreeNode node;
@@ -218,6 +285,78 @@ TEST(BtreeNodeTest, InteriorNodeBasePath) {
               ::testing::VariantWith<std::vector<InteriorNodeEntry>>(entries));
 }
 
+InteriorNodeEntry MakeLeafReference(std::string_view key,
+                                    std::string bloom_filter) {
+  InteriorNodeEntry entry;
+  entry.key = key;
+  entry.subtree_common_prefix_length = 1;
+  entry.node.location.file_id.base_path = "abc";
+  entry.node.location.file_id.relative_path = "def";
+  entry.node.location.offset = 5;
+  entry.node.location.length = 6;
+  entry.node.statistics.num_keys = 5;
+  entry.node.bloom_filter = std::move(bloom_filter);
+  return entry;
+}
+
+TEST(BtreeNodeTest, LeafNodeBloomFilter) {
+  Config config;
+  config.bloom_filter_bits_per_key = 10;
+  BtreeNode node;
+  node.height = 0;
+  node.key_prefix = "ab";
+  auto& entries = node.entries.emplace<BtreeNode::LeafNodeEntries>();
+  entries.push_back({/*.key =*/"c",
+                     /*.value_reference =*/absl::Cord("value1")});
+  entries.push_back({/*.key =*/"d",
+                     /*.value_reference =*/absl::Cord("value2")});
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded_nodes,
+                                   EncodeExistingNode(config, node));
+  ASSERT_EQ(1, encoded_nodes.size());
+  auto& info = encoded_nodes[0].info;
+  ASSERT_EQ(2, info.excluded_prefix_length);
+  ASSERT_FALSE(info.bloom_filter.empty());
+  // Keys are relative to the excluded prefix.
+  EXPECT_TRUE(BloomFilterMayContain(info.bloom_filter, "c"));
+  EXPECT_TRUE(BloomFilterMayContain(info.bloom_filter, "d"));
+
+  config.bloom_filter_bits_per_key = 0;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(encoded_nodes,
+                                   EncodeExistingNode(config, node));
+  ASSERT_EQ(1, encoded_nodes.size());
+  EXPECT_TRUE(encoded_nodes[0].info.bloom_filter.empty());
+}
+
+TEST(BtreeNodeTest, InteriorNodeBloomFilterRoundTrip) {
+  Config config;
+  BtreeNode node;
+  node.height = 1;
+  auto& entries = node.entries.emplace<BtreeNode::InteriorNodeEntries>();
+  BloomFilterBuilder builder(10);
+  builder.AddKey("bc");
+  entries.push_back(MakeLeafReference("abc", builder.Finalize()));
+  // References without a filter may be mixed with references with a filter.
+  entries.push_back(MakeLeafReference("def", ""));
+  TestBtreeNodeRoundTrip(config, node);
+}
+
+TEST(BtreeNodeTest, CorruptBloomFilterForInteriorChild) {
+  Config config;
+  BtreeNode node;
+  node.height = 2;
+  auto& entries = node.entries.emplace<BtreeNode::InteriorNodeEntries>();
+  BloomFilterBuilder builder(10);
+  builder.AddKey("bc");
+  entries.push_back(MakeLeafReference("abc", builder.Finalize()));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded_nodes,
+                                   EncodeExistingNode(config, node));
+  ASSERT_EQ(1, encoded_nodes.size());
+  EXPECT_THAT(DecodeBtreeNode(encoded_nodes[0].encoded_node, /*base_path=*/{}),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Error decoding b-tree node: Bloom filter "
+                            "specified for reference to interior node.*"));
+}
+
 absl::Cord EncodeRawBtree(const std::vector<unsigned char>& data) {
   using ::tensorstore::internal_ocdbt::kBtreeNodeFormatVersion;
   using ::tensorstore::internal_ocdbt::kBtreeNodeMagic;
@@ -318,4 +457,76 @@ TEST(BtreeNodeTest, MaxArity) {
             std::get<BtreeNode::LeafNodeEntries>(decoded_node2.entries).size());
 }
 
+TEST(BtreeNodeTest, PartitionMatchesFinalize) {
+  Config config;
+  config.max_decoded_node_bytes = 100;
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 50; ++i) {
+    keys.push_back(absl::StrFormat("key%03d", i));
+  }
+  const auto make_encoder = [&] {
+    BtreeNodeEncoder<LeafNodeEntry> encoder(config, /*height=*/0,
+                                            /*existing_prefix=*/{});
+    for (const auto& key : keys) {
+      encoder.AddEntry(/*existing=*/false,
+                       LeafNodeEntry{/*.key=*/key,
+                                     /*.value_reference=*/absl::Cord("value")});
+    }
+    return encoder;
+  };
+  auto encoder = make_encoder();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto expected,
+                                   encoder.Finalize(/*may_be_root=*/true));
+  ASSERT_GT(expected.size(), 1);
+
+  // Encoding the ranges out of order gives the same nodes.
+  auto partitioned_encoder = make_encoder();
+  auto ranges = partitioned_encoder.Partition(/*may_be_root=*/true);
+  ASSERT_EQ(expected.size(), ranges.size());
+  for (size_t i = ranges.size(); i-- > 0;) {
+    EXPECT_FALSE(ranges[i].is_root);
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto encoded_node, partitioned_encoder.EncodeNode(ranges[i]));
+    EXPECT_EQ(expected[i].encoded_node, encoded_node.encoded_node) << i;
+    EXPECT_EQ(expected[i].info.inclusive_min_key,
+              encoded_node.info.inclusive_min_key)
+        << i;
+    EXPECT_EQ(expected[i].info.excluded_prefix_length,
+              encoded_node.info.excluded_prefix_length)
+        << i;
+  }
+}
+
+TEST(BtreeNodeTest, MaxDecodedLeafNodeBytes) {
+  Config config;
+  config.max_decoded_node_bytes = 1000;
+  config.max_decoded_leaf_node_bytes = 100;
+  BtreeNodeEncoder<LeafNodeEntry> leaf_encoder(config, /*height=*/0,
+                                               /*existing_prefix=*/{});
+  BtreeNodeEncoder<InteriorNodeEntry> interior_encoder(config, /*height=*/1,
+                                                       /*existing_prefix=*/{});
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 50; ++i) {
+    keys.push_back(absl::StrFormat("key%03d", i));
+  }
+  for (const auto& key : keys) {
+    leaf_encoder.AddEntry(/*existing=*/false,
+                          LeafNodeEntry{/*.key=*/key,
+                                        /*.value_reference=*/absl::Cord("v")});
+    InteriorNodeEntry entry;
+    entry.key = key;
+    entry.node.location.file_id.base_path = "abc";
+    entry.node.location.file_id.relative_path = "def";
+    entry.node.location.length = 1;
+    interior_encoder.AddEntry(/*existing=*/false, std::move(entry));
+  }
+  const size_t num_leaf_nodes =
+      leaf_encoder.Partition(/*may_be_root=*/true).size();
+  EXPECT_GE(num_leaf_nodes, 5);
+
+  // Interior nodes are subject only to `max_decoded_node_bytes`.
+  EXPECT_LT(interior_encoder.Partition(/*may_be_root=*/true).size(),
+            num_leaf_nodes);
+}
+
 }  // namespace
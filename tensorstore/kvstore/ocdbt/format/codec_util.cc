@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <string>
 #include <string_view>
 #include <variant>
 
@@ -33,6 +34,8 @@
 #include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/limiting_reader.h"
 #include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/string_reader.h"
+#include "riegeli/bytes/string_writer.h"
 #include "riegeli/bytes/writer.h"
 #include "riegeli/digests/crc32c_digester.h"
 #include "riegeli/digests/digesting_reader.h"
@@ -43,13 +46,72 @@
 #include "riegeli/varint/varint_writing.h"
 #include "riegeli/zstd/zstd_reader.h"
 #include "riegeli/zstd/zstd_writer.h"
+#include "tensorstore/internal/compression/zstd_dictionary.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status.h"
 
+// Include this last to avoid polluting the namespace.
+#include <lz4.h>
+
 namespace tensorstore {
 namespace internal_ocdbt {
 
+namespace {
+
+/// Compresses `uncompressed` as a varint-encoded uncompressed size followed by
+/// a single LZ4 block.
+bool Lz4Compress(const std::string& uncompressed, riegeli::Writer& writer) {
+  if (uncompressed.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+    return writer.Fail(absl::InvalidArgumentError(absl::StrFormat(
+        "Uncompressed size (%d) exceeds maximum supported by lz4 (%d)",
+        uncompressed.size(), LZ4_MAX_INPUT_SIZE)));
+  }
+  std::string compressed;
+  compressed.resize(LZ4_compressBound(static_cast<int>(uncompressed.size())));
+  int result = LZ4_compress_default(
+      uncompressed.data(), compressed.data(),
+      static_cast<int>(uncompressed.size()),
+      static_cast<int>(compressed.size()));
+  if (result <= 0) {
+    return writer.Fail(absl::InternalError("Lz4 compression failed"));
+  }
+  compressed.resize(result);
+  return riegeli::WriteVarint64(uncompressed.size(), writer) &&
+         writer.Write(std::move(compressed));
+}
+
+bool Lz4Decompress(std::string_view compressed, std::string& uncompressed,
+                   riegeli::Reader& reader) {
+  riegeli::StringReader size_reader(compressed);
+  uint64_t size;
+  if (!ReadVarintChecked(size_reader, size)) {
+    return reader.Fail(
+        absl::DataLossError("Invalid lz4 uncompressed size"));
+  }
+  compressed.remove_prefix(size_reader.pos());
+  // LZ4 cannot achieve a compression ratio better than 255.
+  if (size > LZ4_MAX_INPUT_SIZE ||
+      size > static_cast<uint64_t>(compressed.size()) * 255 + 16) {
+    return reader.Fail(absl::DataLossError(
+        absl::StrFormat("Invalid lz4 uncompressed size: %d", size)));
+  }
+  uncompressed.resize(size);
+  int result = LZ4_decompress_safe(compressed.data(), uncompressed.data(),
+                                   static_cast<int>(compressed.size()),
+                                   static_cast<int>(size));
+  if (result < 0 || static_cast<uint64_t>(result) != size) {
+    return reader.Fail(absl::DataLossError("Lz4 decompression failed"));
+  }
+  return true;
+}
+
+}  // namespace
+
+uint32_t GetZstdDictionaryId(std::string_view dictionary) {
+  return internal::GetZstdDictionaryId(dictionary);
+}
+
 bool ReadVarintChecked(riegeli::Reader& reader, uint64_t& value) {
   if (riegeli::ReadVarint64(reader, value)) return true;
   if (!reader.Pull()) {
@@ -88,7 +150,8 @@ absl::Status DecodeWithOptionalCompression(
     const absl::Cord& encoded, uint32_t expected_magic,
     uint32_t max_version_number,
     absl::FunctionRef<bool(riegeli::Reader& reader, uint32_t version)>
-        decode_decompressed) {
+        decode_decompressed,
+    const Config::ZstdDictionary& zstd_dictionary) {
   constexpr size_t kMinLength = 4     // magic
                                 + 8   // length
                                 + 4;  // crc32.
@@ -151,8 +214,18 @@ absl::Status DecodeWithOptionalCompression(
         // Uncompressed
         success = decode_decompressed(digesting_reader, version);
         break;
-      case 1: {
-        riegeli::ZstdReader zstd_reader(&digesting_reader);
+      case 1:
+      case 3: {
+        riegeli::ZstdReaderBase::Options options;
+        if (compression_format == 3) {
+          if (zstd_dictionary.empty()) {
+            digesting_reader.Fail(absl::FailedPreconditionError(
+                "Zstd dictionary specified by the configuration is required"));
+            return false;
+          }
+          options.set_dictionary(zstd_dictionary.prepared());
+        }
+        riegeli::ZstdReader zstd_reader(&digesting_reader, options);
         success = decode_decompressed(zstd_reader, version) &&
                   zstd_reader.VerifyEndAndClose();
         if (!success && !zstd_reader.ok()) {
@@ -160,6 +233,25 @@ absl::Status DecodeWithOptionalCompression(
         }
         break;
       }
+      case 2: {
+        // Single block compressed as a whole.
+        std::string compressed;
+        if (!digesting_reader.Read(
+                (encoded.size() - 4) - digesting_reader.pos(), compressed)) {
+          return false;
+        }
+        std::string uncompressed;
+        if (!Lz4Decompress(compressed, uncompressed, digesting_reader)) {
+          return false;
+        }
+        riegeli::StringReader string_reader(uncompressed);
+        success = decode_decompressed(string_reader, version) &&
+                  string_reader.VerifyEndAndClose();
+        if (!success && !string_reader.ok()) {
+          digesting_reader.Fail(string_reader.status());
+        }
+        break;
+      }
       default:
         digesting_reader.Fail(absl::DataLossError(absl::StrFormat(
             "Unsupported compression format: %d", compression_format)));
@@ -185,7 +277,8 @@ absl::Status DecodeWithOptionalCompression(
 
 Result<absl::Cord> EncodeWithOptionalCompression(
     const Config& config, uint32_t magic, uint32_t version_number,
-    absl::FunctionRef<bool(riegeli::Writer& writer)> encode) {
+    absl::FunctionRef<bool(riegeli::Writer& writer)> encode,
+    bool use_dictionary) {
   absl::Cord encoded;
   riegeli::CordWriter writer(&encoded);
   bool success = [&] {
@@ -199,17 +292,50 @@ Result<absl::Cord> EncodeWithOptionalCompression(
     riegeli::DigestingWriter digesting_writer(&writer,
                                               riegeli::Crc32cDigester());
     if (!riegeli::WriteVarint32(version_number, digesting_writer)) return false;
+    // Encodes the uncompressed body in memory, for formats that compress it as
+    // a single block.
+    const auto encode_to_string = [&](std::string& uncompressed) {
+      riegeli::StringWriter string_writer(&uncompressed);
+      if (!encode(string_writer) || !string_writer.Close()) {
+        digesting_writer.Fail(string_writer.status());
+        return false;
+      }
+      return true;
+    };
+    const auto* zstd_config =
+        std::get_if<Config::ZstdCompression>(&config.compression);
     if (std::holds_alternative<Config::NoCompression>(config.compression)) {
       if (!riegeli::WriteVarint32(0, digesting_writer)) return false;
       if (!encode(digesting_writer)) return false;
+    } else if (std::holds_alternative<Config::Lz4Compression>(
+                   config.compression)) {
+      if (!riegeli::WriteVarint32(2, digesting_writer)) return false;
+      std::string uncompressed;
+      if (!encode_to_string(uncompressed) ||
+          !Lz4Compress(uncompressed, digesting_writer)) {
+        return false;
+      }
+    } else if (use_dictionary && !zstd_config->dictionary.empty()) {
+      if (!riegeli::WriteVarint32(3, digesting_writer)) return false;
+      // Encode in memory first so that the frame specifies the uncompressed
+      // size.
+      std::string uncompressed;
+      if (!encode_to_string(uncompressed)) return false;
+      riegeli::ZstdWriterBase::Options options;
+      options.set_compression_level(zstd_config->level);
+      options.set_dictionary(zstd_config->dictionary.prepared());
+      options.set_pledged_size(uncompressed.size());
+      riegeli::ZstdWriter zstd_writer(&digesting_writer, options);
+      if (!zstd_writer.Write(std::move(uncompressed)) || !zstd_writer.Close()) {
+        digesting_writer.Fail(zstd_writer.status());
+        return false;
+      }
     } else {
       if (!riegeli::WriteVarint32(1, digesting_writer)) return false;
-      const auto& zstd_config =
-          std::get<Config::ZstdCompression>(config.compression);
       riegeli::ZstdWriter zstd_writer(
           &digesting_writer,
           riegeli::ZstdWriterBase::Options().set_compression_level(
-              zstd_config.level));
+              zstd_config->level));
       if (!encode(zstd_writer) || !zstd_writer.Close()) {
         digesting_writer.Fail(zstd_writer.status());
         return false;
@@ -27,6 +27,7 @@
 ///   bool (riegeli::Writer &writer, const T& value);
 
 #include <cstdint>
+#include <string_view>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
@@ -132,11 +133,14 @@ struct NoOpCodec {
 /// \param max_version_number Maximum allowed version number in header.
 /// \param decode_compressed Callback to be invoked to encode the uncompressed
 ///     body.
+/// \param zstd_dictionary Zstd dictionary specified by the configuration, used
+///     to decode data compressed with a dictionary.
 absl::Status DecodeWithOptionalCompression(
     const absl::Cord& encoded, uint32_t expected_magic,
     uint32_t max_version_number,
     absl::FunctionRef<bool(riegeli::Reader& reader, uint32_t version)>
-        decode_decompressed);
+        decode_decompressed,
+    const Config::ZstdDictionary& zstd_dictionary = {});
 
 /// Encodes with the common compression header.
 ///
@@ -144,9 +148,17 @@ absl::Status DecodeWithOptionalCompression(
 /// \param magic Magic number to include at start of header.
 /// \param version_number Version number to include in header.
 /// \param encode Callback to be invoked to encode the uncompressed body.
+/// \param use_dictionary If `false`, a zstd dictionary specified by `config`
+///     is not used.  This is required for the manifest, which itself specifies
+///     the dictionary.
 Result<absl::Cord> EncodeWithOptionalCompression(
     const Config& config, uint32_t magic, uint32_t version_number,
-    absl::FunctionRef<bool(riegeli::Writer& writer)> encode);
+    absl::FunctionRef<bool(riegeli::Writer& writer)> encode,
+    bool use_dictionary = true);
+
+/// Returns the dictionary ID of a dictionary in the zstd dictionary format, or
+/// `0` if `dictionary` does not specify an ID.
+uint32_t GetZstdDictionaryId(std::string_view dictionary);
 
 /// Closes `reader`, verifying that the end has been reached and
 /// `success == true`.
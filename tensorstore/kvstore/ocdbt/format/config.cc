@@ -16,11 +16,15 @@
 
 #include <array>
 #include <ostream>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 
 #include "absl/log/absl_check.h"
 #include "absl/strings/escaping.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/serialization/serialization.h"
 #include <openssl/rand.h>
 
 namespace tensorstore {
@@ -55,12 +59,32 @@ std::ostream& operator<<(std::ostream& os, Config::NoCompression) {
   return os << "raw";
 }
 
-bool operator==(Config::ZstdCompression a, Config::ZstdCompression b) {
-  return a.level == b.level;
+Config::ZstdDictionary::ZstdDictionary(std::string data)
+    : data_(std::move(data)) {
+  if (!data_.empty()) {
+    prepared_.set_automatic(data_);
+  }
+}
+
+void EncodeCacheKeyAdl(std::string* out, const Config::ZstdDictionary& x) {
+  internal::EncodeCacheKey(out, x.data_);
+}
+
+bool operator==(const Config::ZstdCompression& a,
+                const Config::ZstdCompression& b) {
+  return a.level == b.level && a.dictionary == b.dictionary;
+}
+
+std::ostream& operator<<(std::ostream& os, const Config::ZstdCompression& x) {
+  os << "zstd{level=" << x.level;
+  if (!x.dictionary.empty()) {
+    os << ", dictionary_size=" << x.dictionary.data().size();
+  }
+  return os << "}";
 }
 
-std::ostream& operator<<(std::ostream& os, Config::ZstdCompression x) {
-  return os << "zstd{level=" << x.level << "}";
+std::ostream& operator<<(std::ostream& os, Config::Lz4Compression) {
+  return os << "lz4";
 }
 
 std::ostream& operator<<(std::ostream& os, const Config::Compression& x) {
@@ -73,7 +97,9 @@ bool operator==(const Config& a, const Config& b) {
          a.max_inline_value_bytes == b.max_inline_value_bytes &&
          a.max_decoded_node_bytes == b.max_decoded_node_bytes &&
          a.version_tree_arity_log2 == b.version_tree_arity_log2 &&
-         a.compression == b.compression;
+         a.compression == b.compression &&
+         a.bloom_filter_bits_per_key == b.bloom_filter_bits_per_key &&
+         a.max_decoded_leaf_node_bytes == b.max_decoded_leaf_node_bytes;
 }
 
 std::ostream& operator<<(std::ostream& os, const Config& x) {
@@ -82,8 +108,30 @@ std::ostream& operator<<(std::ostream& os, const Config& x) {
             << ", max_decoded_node_bytes=" << x.max_decoded_node_bytes
             << ", version_tree_arity_log2="
             << static_cast<int>(x.version_tree_arity_log2)
-            << ", compression=" << x.compression << "}";
+            << ", compression=" << x.compression
+            << ", bloom_filter_bits_per_key=" << x.bloom_filter_bits_per_key
+            << ", max_decoded_leaf_node_bytes=" << x.max_decoded_leaf_node_bytes
+            << "}";
 }
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
+
+namespace tensorstore {
+namespace serialization {
+
+bool Serializer<internal_ocdbt::Config::ZstdDictionary>::Encode(
+    EncodeSink& sink, const internal_ocdbt::Config::ZstdDictionary& value) {
+  return serialization::Encode(sink, value.data());
+}
+
+bool Serializer<internal_ocdbt::Config::ZstdDictionary>::Decode(
+    DecodeSource& source, internal_ocdbt::Config::ZstdDictionary& value) {
+  std::string data;
+  if (!serialization::Decode(source, data)) return false;
+  value = internal_ocdbt::Config::ZstdDictionary(std::move(data));
+  return true;
+}
+
+}  // namespace serialization
+}  // namespace tensorstore
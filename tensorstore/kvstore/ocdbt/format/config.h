@@ -18,9 +18,13 @@
 #include <array>
 #include <cstdint>
 #include <iosfwd>
+#include <string>
 #include <variant>
 
+#include "riegeli/zstd/zstd_dictionary.h"
+#include "tensorstore/serialization/fwd.h"
 #include "tensorstore/util/apply_members/std_array.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
 
 namespace tensorstore {
 namespace internal_ocdbt {
@@ -67,6 +71,9 @@ struct Config {
   uint32_t max_inline_value_bytes = 100;
 
   /// Maximum size in bytes of a decoded b-tree node.
+  ///
+  /// Applies to interior nodes, and also to leaf nodes unless
+  /// `max_decoded_leaf_node_bytes` is non-zero.
   uint32_t max_decoded_node_bytes = 8 * 1024 * 1024;
 
   /// Base-2 logarithm of the arity of the version tree, must be >= 1.
@@ -78,25 +85,101 @@ struct Config {
     friend std::ostream& operator<<(std::ostream& os, NoCompression);
   };
 
+  /// Zstd dictionary, along with its prepared form.
+  ///
+  /// The dictionary is prepared for compression and decompression on first
+  /// use, and the prepared form is shared by copies.  Nodes of a database are
+  /// therefore compressed and decompressed using the dictionary prepared once
+  /// for its configuration.
+  class ZstdDictionary {
+   public:
+    ZstdDictionary() = default;
+    explicit ZstdDictionary(std::string data);
+
+    /// Returns the dictionary in the zstd dictionary format, or an empty string
+    /// if there is no dictionary.
+    const std::string& data() const { return data_; }
+
+    bool empty() const { return data_.empty(); }
+
+    /// Returns the prepared dictionary, for use with `riegeli::ZstdWriter` and
+    /// `riegeli::ZstdReader`.
+    const riegeli::ZstdDictionary& prepared() const { return prepared_; }
+
+    friend bool operator==(const ZstdDictionary& a, const ZstdDictionary& b) {
+      return a.data_ == b.data_;
+    }
+    friend bool operator!=(const ZstdDictionary& a, const ZstdDictionary& b) {
+      return !(a == b);
+    }
+
+    friend void EncodeCacheKeyAdl(std::string* out, const ZstdDictionary& x);
+
+   private:
+    std::string data_;
+    riegeli::ZstdDictionary prepared_;
+  };
+
   struct ZstdCompression {
     int32_t level;
-    friend bool operator==(ZstdCompression a, ZstdCompression b);
-    friend bool operator!=(ZstdCompression a, ZstdCompression b) {
+
+    /// Optional zstd dictionary, in the zstd dictionary format with a non-zero
+    /// dictionary ID, used to compress B+tree and version tree nodes.  The
+    /// manifest itself is compressed without the dictionary.
+    ZstdDictionary dictionary;
+
+    friend bool operator==(const ZstdCompression& a, const ZstdCompression& b);
+    friend bool operator!=(const ZstdCompression& a,
+                           const ZstdCompression& b) {
       return !(a == b);
     }
-    friend std::ostream& operator<<(std::ostream& os, ZstdCompression x);
+    friend std::ostream& operator<<(std::ostream& os,
+                                    const ZstdCompression& x);
 
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.level);
+      return f(x.level, x.dictionary);
     };
   };
 
+  struct Lz4Compression {
+    friend bool operator==(Lz4Compression, Lz4Compression) { return true; }
+    friend bool operator!=(Lz4Compression, Lz4Compression) { return false; }
+    friend std::ostream& operator<<(std::ostream& os, Lz4Compression);
+  };
+
   /// Encoded as:
   ///   0 -> no compression
   ///   1 -> zstd
-  using Compression = std::variant<NoCompression, ZstdCompression>;
+  ///   2 -> lz4
+  ///   3 -> zstd with dictionary
+  using Compression =
+      std::variant<NoCompression, ZstdCompression, Lz4Compression>;
   Compression compression = ZstdCompression{0};
 
+  /// Number of Bloom filter bits per key stored with each reference to a leaf
+  /// node, or `0` to disable Bloom filters.
+  ///
+  /// Filters allow reads of keys that are not present to complete without
+  /// fetching the leaf node.  A non-zero value requires manifest format version
+  /// 1.
+  uint32_t bloom_filter_bits_per_key = 0;
+
+  /// Maximum size in bytes of a decoded b-tree leaf node, or `0` to use
+  /// `max_decoded_node_bytes`.
+  ///
+  /// Small leaf nodes reduce the amount of data fetched by point reads, while
+  /// larger interior nodes keep the height of the tree small.  A non-zero value
+  /// requires manifest format version 2.
+  uint32_t max_decoded_leaf_node_bytes = 0;
+
+  /// Returns the maximum size in bytes of a decoded leaf node (if `leaf` is
+  /// `true`) or interior node.
+  uint32_t GetMaxDecodedNodeBytes(bool leaf) const {
+    return (leaf && max_decoded_leaf_node_bytes != 0)
+               ? max_decoded_leaf_node_bytes
+               : max_decoded_node_bytes;
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const Compression& x);
   friend bool operator==(const Config& a, const Config& b);
   friend bool operator!=(const Config& a, const Config& b) { return !(a == b); }
@@ -110,4 +193,10 @@ constexpr size_t kMaxInlineValueLength = 1024 * 1024;
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
 
+TENSORSTORE_DECLARE_SERIALIZER_SPECIALIZATION(
+    tensorstore::internal_ocdbt::Config::ZstdDictionary)
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::internal_ocdbt::Config::Compression)
+
 #endif  // TENSORSTORE_KVSTORE_OCDBT_FORMAT_CONFIG_H_
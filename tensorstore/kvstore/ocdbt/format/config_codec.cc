@@ -15,6 +15,7 @@
 #include "tensorstore/kvstore/ocdbt/format/config_codec.h"
 
 #include <string>
+#include <utility>
 #include <variant>
 
 #include "absl/status/status.h"
@@ -23,6 +24,7 @@
 #include "riegeli/bytes/writer.h"
 #include "riegeli/zstd/zstd_writer.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
 
@@ -50,9 +52,44 @@ struct ZstdCompressionOptionsCodec {
   }
 };
 
+struct ZstdDictionaryCodec {
+  [[nodiscard]] bool operator()(riegeli::Reader& reader,
+                                Config::ZstdDictionary& value) const {
+    uint32_t length;
+    if (!ReadVarintChecked(reader, length)) return false;
+    std::string data;
+    if (!reader.Read(length, data)) return false;
+    if (GetZstdDictionaryId(data) == 0) {
+      reader.Fail(absl::DataLossError(
+          "Zstd dictionary does not specify a dictionary ID"));
+      return false;
+    }
+    value = Config::ZstdDictionary(std::move(data));
+    return true;
+  }
+
+  [[nodiscard]] bool operator()(riegeli::Writer& writer,
+                                const Config::ZstdDictionary& value) const {
+    const std::string& data = value.data();
+    return WriteVarint<uint32_t>(writer, data.size()) && writer.Write(data);
+  }
+};
+
 using CompressionMethodCodec = VarintCodec<uint32_t>;
 }  // namespace
 
+bool BloomFilterBitsPerKeyCodec::operator()(riegeli::Reader& reader,
+                                            uint32_t& value) const {
+  if (!VarintCodec<uint32_t>{}(reader, value)) return false;
+  if (value > kMaxBloomFilterBitsPerKey) {
+    reader.Fail(absl::DataLossError(absl::StrFormat(
+        "bloom_filter_bits_per_key=%d exceeds maximum of %d", value,
+        kMaxBloomFilterBitsPerKey)));
+    return false;
+  }
+  return true;
+}
+
 bool CompressionConfigCodec::operator()(riegeli::Reader& reader,
                                         Config::Compression& value) const {
   uint32_t compression_method;
@@ -67,6 +104,17 @@ bool CompressionConfigCodec::operator()(riegeli::Reader& reader,
         return false;
       }
       break;
+    case 2:
+      value.emplace<Config::Lz4Compression>();
+      break;
+    case 3: {
+      auto& zstd_config = value.emplace<Config::ZstdCompression>();
+      if (!ZstdCompressionOptionsCodec{}(reader, zstd_config) ||
+          !ZstdDictionaryCodec{}(reader, zstd_config.dictionary)) {
+        return false;
+      }
+      break;
+    }
     default:
       reader.Fail(absl::InvalidArgumentError(absl::StrFormat(
           "Invalid compression method: %d", compression_method)));
@@ -81,12 +129,24 @@ bool CompressionConfigCodec::operator()(
     if (!CompressionMethodCodec{}(writer, 0)) {
       return false;
     }
-  } else {
-    if (!CompressionMethodCodec{}(writer, 1) ||
-        !ZstdCompressionOptionsCodec{}(
-            writer, std::get<Config::ZstdCompression>(value))) {
+  } else if (std::holds_alternative<Config::Lz4Compression>(value)) {
+    if (!CompressionMethodCodec{}(writer, 2)) {
       return false;
     }
+  } else {
+    const auto& zstd_config = std::get<Config::ZstdCompression>(value);
+    if (zstd_config.dictionary.empty()) {
+      if (!CompressionMethodCodec{}(writer, 1) ||
+          !ZstdCompressionOptionsCodec{}(writer, zstd_config)) {
+        return false;
+      }
+    } else {
+      if (!CompressionMethodCodec{}(writer, 3) ||
+          !ZstdCompressionOptionsCodec{}(writer, zstd_config) ||
+          !ZstdDictionaryCodec{}(writer, zstd_config.dictionary)) {
+        return false;
+      }
+    }
   }
   return true;
 }
@@ -19,6 +19,8 @@
 ///
 /// Internal codecs for `Config`, used by the manifest codec.
 
+#include <stdint.h>
+
 #include "riegeli/bytes/reader.h"
 #include "riegeli/bytes/writer.h"
 #include "tensorstore/kvstore/ocdbt/format/codec_util.h"
@@ -31,6 +33,7 @@ namespace internal_ocdbt {
 using UuidCodec = RawBytesCodec<Uuid>;
 using MaxInlineValueBytesCodec = VarintCodec<uint32_t>;
 using MaxDecodedNodeBytesCodec = VarintCodec<uint32_t>;
+using MaxDecodedLeafNodeBytesCodec = VarintCodec<uint32_t>;
 
 struct CompressionConfigCodec {
   [[nodiscard]] bool operator()(riegeli::Reader& reader,
@@ -50,15 +53,58 @@ struct ManifestKindCodec {
   }
 };
 
+struct BloomFilterBitsPerKeyCodec {
+  [[nodiscard]] bool operator()(riegeli::Reader& reader,
+                                uint32_t& value) const;
+
+  [[nodiscard]] bool operator()(riegeli::Writer& writer, uint32_t value) const {
+    return VarintCodec<uint32_t>{}(writer, value);
+  }
+};
+
+/// First manifest format version that includes the
+/// `bloom_filter_bits_per_key` configuration field.
+constexpr uint32_t kManifestBloomFilterFormatVersion = 1;
+
+/// First manifest format version that includes the
+/// `max_decoded_leaf_node_bytes` configuration field.
+constexpr uint32_t kManifestLeafNodeBytesFormatVersion = 2;
+
+/// Returns the manifest format version used to encode `config`.
+///
+/// The lowest version able to represent `config` is used, such that the
+/// manifest remains readable by older versions of this library whenever
+/// possible.
+inline uint32_t GetManifestFormatVersion(const Config& config) {
+  if (config.max_decoded_leaf_node_bytes != 0) {
+    return kManifestLeafNodeBytesFormatVersion;
+  }
+  return config.bloom_filter_bits_per_key != 0
+             ? kManifestBloomFilterFormatVersion
+             : 0;
+}
+
 struct ConfigCodec {
+  /// Manifest format version.
+  uint32_t version;
+
   template <typename IO, typename T>
   [[nodiscard]] bool operator()(IO& io, T&& value) const {
-    return UuidCodec{}(io, value.uuid) &&
-           ManifestKindCodec{}(io, value.manifest_kind) &&
-           MaxInlineValueBytesCodec{}(io, value.max_inline_value_bytes) &&
-           MaxDecodedNodeBytesCodec{}(io, value.max_decoded_node_bytes) &&
-           VersionTreeArityLog2Codec{}(io, value.version_tree_arity_log2) &&
-           CompressionConfigCodec{}(io, value.compression);
+    if (!UuidCodec{}(io, value.uuid) ||
+        !ManifestKindCodec{}(io, value.manifest_kind) ||
+        !MaxInlineValueBytesCodec{}(io, value.max_inline_value_bytes) ||
+        !MaxDecodedNodeBytesCodec{}(io, value.max_decoded_node_bytes) ||
+        !VersionTreeArityLog2Codec{}(io, value.version_tree_arity_log2) ||
+        !CompressionConfigCodec{}(io, value.compression)) {
+      return false;
+    }
+    if (version < kManifestBloomFilterFormatVersion) return true;
+    if (!BloomFilterBitsPerKeyCodec{}(io, value.bloom_filter_bits_per_key)) {
+      return false;
+    }
+    if (version < kManifestLeafNodeBytesFormatVersion) return true;
+    return MaxDecodedLeafNodeBytesCodec{}(io,
+                                          value.max_decoded_leaf_node_bytes);
   }
 };
 
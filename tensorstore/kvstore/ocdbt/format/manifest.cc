@@ -42,7 +42,9 @@ namespace tensorstore {
 namespace internal_ocdbt {
 
 constexpr uint32_t kManifestMagic = 0x0cdb3a2a;
-constexpr uint8_t kManifestFormatVersion = 0;
+// Maximum manifest format version that is supported.  The version actually
+// written is determined by `GetManifestFormatVersion`.
+constexpr uint8_t kManifestFormatVersion = kManifestLeafNodeBytesFormatVersion;
 
 void ForEachManifestVersionTreeNodeRef(
     GenerationNumber generation_number, uint8_t version_tree_arity_log2,
@@ -162,15 +164,16 @@ Result<absl::Cord> EncodeManifest(const Manifest& manifest,
 #ifndef NDEBUG
   CheckManifestInvariants(manifest, encode_as_single);
 #endif
+  const uint32_t version = GetManifestFormatVersion(manifest.config);
   return EncodeWithOptionalCompression(
-      manifest.config, kManifestMagic, kManifestFormatVersion,
+      manifest.config, kManifestMagic, version,
       [&](riegeli::Writer& writer) -> bool {
         if (encode_as_single) {
           Config new_config = manifest.config;
           new_config.manifest_kind = ManifestKind::kSingle;
-          if (!ConfigCodec{}(writer, new_config)) return false;
+          if (!ConfigCodec{version}(writer, new_config)) return false;
         } else {
-          if (!ConfigCodec{}(writer, manifest.config)) return false;
+          if (!ConfigCodec{version}(writer, manifest.config)) return false;
           if (manifest.config.manifest_kind != ManifestKind::kSingle) {
             // This is a config-only manifest.
             return true;
@@ -194,7 +197,10 @@ Result<absl::Cord> EncodeManifest(const Manifest& manifest,
           return false;
         }
         return true;
-      });
+      },
+      // The manifest must be decodable before the dictionary it specifies is
+      // known.
+      /*use_dictionary=*/false);
 }
 
 Result<Manifest> DecodeManifest(const absl::Cord& encoded) {
@@ -202,7 +208,7 @@ Result<Manifest> DecodeManifest(const absl::Cord& encoded) {
   auto status = DecodeWithOptionalCompression(
       encoded, kManifestMagic, kManifestFormatVersion,
       [&](riegeli::Reader& reader, uint32_t version) -> bool {
-        if (!ConfigCodec{}(reader, manifest.config)) return false;
+        if (!ConfigCodec{version}(reader, manifest.config)) return false;
         if (manifest.config.manifest_kind != ManifestKind::kSingle) {
           // This is a config-only manifest.
           return true;
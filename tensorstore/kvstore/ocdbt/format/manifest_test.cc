@@ -16,6 +16,8 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/config.h"
@@ -29,6 +31,7 @@ namespace {
 using ::tensorstore::MatchesStatus;
 using ::tensorstore::Result;
 using ::tensorstore::internal_ocdbt::CommitTime;
+using ::tensorstore::internal_ocdbt::Config;
 using ::tensorstore::internal_ocdbt::DecodeManifest;
 using ::tensorstore::internal_ocdbt::Manifest;
 
@@ -59,6 +62,19 @@ void TestManifestRoundTrip(const Manifest& manifest) {
   EXPECT_EQ(manifest, decoded);
 }
 
+/// Returns a zstd dictionary with dictionary ID 1234, generated by
+/// `ZDICT_finalizeDictionary`.
+std::string GetTestZstdDictionary() {
+  std::string dictionary;
+  ABSL_CHECK(absl::Base64Unescape(
+      "N6Qw7NIEAAAtELiX0gH8/////////9+neE7O3P//F4QIIYTsvbdCqr/++uuvv/76"
+      "66+//vo/Q0BAQCBsE0IIERGRB1SgQEFBQUFBQUFBQUFBQUFBQUFBQUFBQUFBQUFB"
+      "QUFBweuiKIqiKKWUUkqpquoBZMCAgYGBgcFcg8FgMBiGYRiGYRiGYRhjjDHGzA4B"
+      "AAAABAAAAAgAAABhYmNkZWZnaGlqa2xtbm9wcXJzdHV2d3h5ejAxMjM0NTY3ODk=",
+      &dictionary));
+  return dictionary;
+}
+
 Manifest GetSimpleManifest() {
   Manifest manifest;
 
@@ -122,12 +138,53 @@ TEST(ManifestTest, InvalidVersion) {
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
                                    EncodeManifest(GetSimpleManifest()));
   auto corrupt = encoded.Subcord(0, 12);
-  corrupt.Append(std::string(1, 1));
+  corrupt.Append(std::string(1, 3));
   corrupt.Append(encoded.Subcord(13, -1));
   EXPECT_THAT(
       DecodeManifest(corrupt),
       MatchesStatus(absl::StatusCode::kDataLoss,
-                    ".*: Maximum supported version is 0 but received: 1.*"));
+                    ".*: Maximum supported version is 2 but received: 3.*"));
+}
+
+TEST(ManifestTest, RoundTripBloomFilterBitsPerKey) {
+  auto manifest = GetSimpleManifest();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeManifest(manifest));
+  // Version 0 is used when Bloom filters are disabled.
+  EXPECT_EQ(0, encoded.Subcord(12, 1).Flatten()[0]);
+
+  manifest.config.bloom_filter_bits_per_key = 10;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(encoded, EncodeManifest(manifest));
+  EXPECT_EQ(1, encoded.Subcord(12, 1).Flatten()[0]);
+  TestManifestRoundTrip(manifest);
+}
+
+TEST(ManifestTest, RoundTripMaxDecodedLeafNodeBytes) {
+  auto manifest = GetSimpleManifest();
+  manifest.config.max_decoded_leaf_node_bytes = 65536;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeManifest(manifest));
+  EXPECT_EQ(2, encoded.Subcord(12, 1).Flatten()[0]);
+  TestManifestRoundTrip(manifest);
+
+  manifest.config.bloom_filter_bits_per_key = 10;
+  TestManifestRoundTrip(manifest);
+}
+
+TEST(ManifestTest, RoundTripLz4) {
+  auto manifest = GetSimpleManifest();
+  manifest.config.compression = Config::Lz4Compression{};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeManifest(manifest));
+  EXPECT_EQ(2, encoded.Subcord(13, 1).Flatten()[0]);
+  TestManifestRoundTrip(manifest);
+}
+
+TEST(ManifestTest, RoundTripZstdDictionary) {
+  auto manifest = GetSimpleManifest();
+  manifest.config.compression = Config::ZstdCompression{
+      /*level=*/3, Config::ZstdDictionary(GetTestZstdDictionary())};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeManifest(manifest));
+  // The manifest itself is compressed without the dictionary.
+  EXPECT_EQ(1, encoded.Subcord(13, 1).Flatten()[0]);
+  TestManifestRoundTrip(manifest);
 }
 
 TEST(ManifestTest, CorruptChecksum) {
@@ -0,0 +1,216 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/format/snapshot_index.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include "riegeli/bytes/reader.h"
+#include "riegeli/bytes/writer.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/btree_codec.h"
+#include "tensorstore/kvstore/ocdbt/format/codec_util.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/data_file_id_codec.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
+#include "tensorstore/util/status.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+namespace {
+
+constexpr auto ValueReferenceGetter = [](auto& entry) -> decltype(auto) {
+  return (entry.value_reference);
+};
+
+// Reads the key columns of the index.  Unlike b-tree nodes, keys are returned
+// in full since the index is stored as a single flat array.
+bool ReadSnapshotIndexKeys(riegeli::Reader& reader,
+                           span<SnapshotIndexEntry> entries) {
+  const size_t num_entries = entries.size();
+  std::vector<KeyLength> prefix_lengths(num_entries);
+  std::vector<KeyLength> suffix_lengths(num_entries);
+  for (size_t i = 1; i < num_entries; ++i) {
+    if (!KeyLengthCodec{}(reader, prefix_lengths[i])) return false;
+  }
+  for (auto& length : suffix_lengths) {
+    if (!KeyLengthCodec{}(reader, length)) return false;
+  }
+  for (size_t i = 0; i < num_entries; ++i) {
+    size_t prefix_length = prefix_lengths[i];
+    size_t suffix_length = suffix_lengths[i];
+    std::string_view prev_key;
+    if (i != 0) prev_key = entries[i - 1].key;
+    if (prefix_length > prev_key.size()) {
+      reader.Fail(absl::DataLossError(absl::StrFormat(
+          "Entry %d: Prefix length of %d exceeds previous key length %d", i,
+          prefix_length, prev_key.size())));
+      return false;
+    }
+    if (!reader.Pull(suffix_length)) return false;
+    std::string_view suffix(reader.cursor(), suffix_length);
+    if (i != 0 && prev_key.substr(prefix_length) >= suffix) {
+      reader.Fail(absl::DataLossError("Invalid key order"));
+      return false;
+    }
+    auto& key = entries[i].key;
+    key.reserve(prefix_length + suffix_length);
+    key.append(prev_key.substr(0, prefix_length));
+    key.append(suffix);
+    reader.move_cursor(suffix_length);
+  }
+  return true;
+}
+
+bool WriteSnapshotIndexKeys(riegeli::Writer& writer,
+                            span<const SnapshotIndexEntry> entries) {
+  const size_t num_entries = entries.size();
+  std::vector<KeyLength> prefix_lengths(num_entries);
+  for (size_t i = 1; i < num_entries; ++i) {
+    prefix_lengths[i] =
+        FindCommonPrefixLength(entries[i - 1].key, entries[i].key);
+    if (!KeyLengthCodec{}(writer, prefix_lengths[i])) return false;
+  }
+  for (size_t i = 0; i < num_entries; ++i) {
+    if (!KeyLengthCodec{}(writer,
+                          entries[i].key.size() - prefix_lengths[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < num_entries; ++i) {
+    if (!writer.Write(
+            std::string_view(entries[i].key).substr(prefix_lengths[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool operator==(const SnapshotIndexEntry& a, const SnapshotIndexEntry& b) {
+  return a.key == b.key && a.value_reference == b.value_reference;
+}
+
+std::ostream& operator<<(std::ostream& os, const SnapshotIndexEntry& e) {
+  return os << "{key=" << tensorstore::QuoteString(e.key)
+            << ", value_reference=" << e.value_reference << "}";
+}
+
+std::vector<SnapshotIndexEntry>::const_iterator SnapshotIndex::LowerBound(
+    std::string_view inclusive_min) const {
+  return std::lower_bound(
+      entries.begin(), entries.end(), inclusive_min,
+      [](const SnapshotIndexEntry& entry, std::string_view inclusive_min) {
+        return entry.key < inclusive_min;
+      });
+}
+
+const SnapshotIndexEntry* SnapshotIndex::Find(std::string_view key) const {
+  auto it = LowerBound(key);
+  if (it == entries.end() || it->key != key) return nullptr;
+  return &*it;
+}
+
+size_t SnapshotIndex::EstimateSizeInBytes() const {
+  size_t size = entries.capacity() * sizeof(SnapshotIndexEntry);
+  for (const auto& entry : entries) {
+    size += entry.key.capacity();
+    if (auto* value = std::get_if<absl::Cord>(&entry.value_reference)) {
+      size += value->size();
+    } else {
+      const auto& file_id =
+          std::get<IndirectDataReference>(entry.value_reference).file_id;
+      size += file_id.base_path.size() + file_id.relative_path.size();
+    }
+  }
+  return size;
+}
+
+Result<absl::Cord> EncodeSnapshotIndex(const Config& config,
+                                       const SnapshotIndex& index) {
+#ifndef NDEBUG
+  for (size_t i = 1; i < index.entries.size(); ++i) {
+    assert(index.entries[i - 1].key < index.entries[i].key);
+  }
+#endif
+  return EncodeWithOptionalCompression(
+      config, kSnapshotIndexMagic, kSnapshotIndexFormatVersion,
+      [&](riegeli::Writer& writer) -> bool {
+        DataFileTableBuilder data_file_table;
+        for (const auto& entry : index.entries) {
+          if (auto* data_ref =
+                  std::get_if<IndirectDataReference>(&entry.value_reference)) {
+            data_file_table.Add(data_ref->file_id);
+          }
+        }
+        if (!data_file_table.Finalize(writer)) return false;
+        if (!WriteVarint<uint64_t>(writer, index.entries.size())) return false;
+        if (!WriteSnapshotIndexKeys(writer, index.entries)) return false;
+        return LeafNodeValueReferenceArrayCodec{
+            data_file_table, ValueReferenceGetter}(writer, index.entries);
+      },
+      /*use_dictionary=*/false);
+}
+
+Result<SnapshotIndex> DecodeSnapshotIndex(const absl::Cord& encoded) {
+  SnapshotIndex index;
+  auto status = DecodeWithOptionalCompression(
+      encoded, kSnapshotIndexMagic, kSnapshotIndexFormatVersion,
+      [&](riegeli::Reader& reader, uint32_t version) -> bool {
+        DataFileTable data_file_table;
+        if (!ReadDataFileTable(reader, /*transitive_path=*/{},
+                               data_file_table)) {
+          return false;
+        }
+        uint64_t num_entries;
+        if (!ReadVarintChecked(reader, num_entries)) return false;
+        // Each entry requires at least two bytes, which bounds the allocation
+        // below for corrupt input.
+        if (num_entries > encoded.size()) {
+          reader.Fail(absl::DataLossError(absl::StrFormat(
+              "Number of entries %d is inconsistent with encoded size of %d",
+              num_entries, encoded.size())));
+          return false;
+        }
+        index.entries.resize(num_entries);
+        if (!ReadSnapshotIndexKeys(reader, index.entries)) return false;
+        return LeafNodeValueReferenceArrayCodec{
+            data_file_table, ValueReferenceGetter}(reader, index.entries);
+      });
+  if (!status.ok()) {
+    return tensorstore::MaybeAnnotateStatus(status,
+                                            "Error decoding snapshot index");
+  }
+  return index;
+}
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
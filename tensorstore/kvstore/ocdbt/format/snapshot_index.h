@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_OCDBT_FORMAT_SNAPSHOT_INDEX_H_
+#define TENSORSTORE_KVSTORE_OCDBT_FORMAT_SNAPSHOT_INDEX_H_
+
+/// \file
+///
+/// Index of a read-only snapshot exported from a single OCDBT version.
+///
+/// The index is a single flat, sorted array of keys and value references,
+/// which allows a reader to locate any value after fetching only the index.
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_ocdbt {
+
+/// Key under the snapshot root at which the index is stored.
+constexpr std::string_view kSnapshotIndexKey = "snapshot";
+
+constexpr uint32_t kSnapshotIndexMagic = 0x0cdb5a90;
+constexpr uint8_t kSnapshotIndexFormatVersion = 0;
+
+struct SnapshotIndexEntry {
+  std::string key;
+
+  /// Inline value, or reference to the value within a data file.  Data file
+  /// paths are relative to the snapshot root.
+  LeafNodeValueReference value_reference;
+
+  friend bool operator==(const SnapshotIndexEntry& a,
+                         const SnapshotIndexEntry& b);
+  friend bool operator!=(const SnapshotIndexEntry& a,
+                         const SnapshotIndexEntry& b) {
+    return !(a == b);
+  }
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const SnapshotIndexEntry& e);
+};
+
+/// Decoded representation of a snapshot index.
+struct SnapshotIndex {
+  /// Entries ordered by strictly increasing `key`.
+  std::vector<SnapshotIndexEntry> entries;
+
+  /// Returns the entry for `key`, or `nullptr` if not present.
+  const SnapshotIndexEntry* Find(std::string_view key) const;
+
+  /// Returns the first entry with a key not less than `inclusive_min`.
+  std::vector<SnapshotIndexEntry>::const_iterator LowerBound(
+      std::string_view inclusive_min) const;
+
+  size_t EstimateSizeInBytes() const;
+};
+
+/// Encodes a snapshot index.
+///
+/// \param config Specifies the compression used.  A zstd dictionary is never
+///     used, such that the index can be decoded without the source database.
+/// \dchecks `index.entries` are ordered by strictly increasing key.
+Result<absl::Cord> EncodeSnapshotIndex(const Config& config,
+                                       const SnapshotIndex& index);
+
+/// Decodes a snapshot index.
+Result<SnapshotIndex> DecodeSnapshotIndex(const absl::Cord& encoded);
+
+}  // namespace internal_ocdbt
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_OCDBT_FORMAT_SNAPSHOT_INDEX_H_
@@ -0,0 +1,103 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/format/snapshot_index.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
+#include "tensorstore/kvstore/ocdbt/format/data_file_id.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_ocdbt::Config;
+using ::tensorstore::internal_ocdbt::DecodeSnapshotIndex;
+using ::tensorstore::internal_ocdbt::EncodeSnapshotIndex;
+using ::tensorstore::internal_ocdbt::IndirectDataReference;
+using ::tensorstore::internal_ocdbt::SnapshotIndex;
+
+SnapshotIndex GetSimpleSnapshotIndex() {
+  SnapshotIndex index;
+  {
+    auto& entry = index.entries.emplace_back();
+    entry.key = "abc";
+    entry.value_reference = absl::Cord("inline");
+  }
+  {
+    auto& entry = index.entries.emplace_back();
+    entry.key = "abd";
+    IndirectDataReference ref;
+    ref.file_id.relative_path = "d/00000000";
+    ref.offset = 0;
+    ref.length = 500;
+    entry.value_reference = ref;
+  }
+  {
+    auto& entry = index.entries.emplace_back();
+    entry.key = "b";
+    IndirectDataReference ref;
+    ref.file_id.relative_path = "d/00000000";
+    ref.offset = 500;
+    ref.length = 200;
+    entry.value_reference = ref;
+  }
+  return index;
+}
+
+void TestSnapshotIndexRoundTrip(const Config& config,
+                                const SnapshotIndex& index) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded,
+                                   EncodeSnapshotIndex(config, index));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, DecodeSnapshotIndex(encoded));
+  EXPECT_EQ(index.entries, decoded.entries);
+}
+
+TEST(SnapshotIndexTest, RoundTripEmpty) {
+  TestSnapshotIndexRoundTrip(Config{}, SnapshotIndex{});
+}
+
+TEST(SnapshotIndexTest, RoundTripUncompressed) {
+  Config config;
+  config.compression = Config::NoCompression{};
+  TestSnapshotIndexRoundTrip(config, GetSimpleSnapshotIndex());
+}
+
+TEST(SnapshotIndexTest, RoundTripZstd) {
+  Config config;
+  config.compression = Config::ZstdCompression{0};
+  TestSnapshotIndexRoundTrip(config, GetSimpleSnapshotIndex());
+}
+
+TEST(SnapshotIndexTest, Find) {
+  auto index = GetSimpleSnapshotIndex();
+  ASSERT_TRUE(index.Find("abd"));
+  EXPECT_EQ("abd", index.Find("abd")->key);
+  EXPECT_FALSE(index.Find("ab"));
+  EXPECT_FALSE(index.Find("c"));
+  EXPECT_EQ(index.entries.begin() + 2, index.LowerBound("abe"));
+  EXPECT_EQ(index.entries.end(), index.LowerBound("c"));
+}
+
+TEST(SnapshotIndexTest, InvalidMagic) {
+  EXPECT_THAT(DecodeSnapshotIndex(absl::Cord("abcdefghijklmnop")),
+              MatchesStatus(absl::StatusCode::kDataLoss,
+                            "Error decoding snapshot index: .*"));
+}
+
+}  // namespace
@@ -154,8 +154,9 @@ GetVersionTreeLeafNodeRangeContainingGeneration(
   return true;
 }
 
-Result<VersionTreeNode> DecodeVersionTreeNode(const absl::Cord& encoded,
-                                              const BasePath& base_path) {
+Result<VersionTreeNode> DecodeVersionTreeNode(
+    const absl::Cord& encoded, const BasePath& base_path,
+    const Config::ZstdDictionary& zstd_dictionary) {
   VersionTreeNode node;
   auto status = DecodeWithOptionalCompression(
       encoded, kVersionTreeNodeMagic, kVersionTreeNodeFormatVersion,
@@ -179,7 +180,8 @@ Result<VersionTreeNode> DecodeVersionTreeNode(const absl::Cord& encoded,
               node.height,
               node.entries.emplace<VersionTreeNode::InteriorNodeEntries>());
         }
-      });
+      },
+      zstd_dictionary);
   if (!status.ok()) {
     return tensorstore::MaybeAnnotateStatus(status,
                                             "Error decoding version tree node");
@@ -226,8 +226,12 @@ absl::Status ValidateVersionTreeLeafNodeEntries(
     const VersionTreeNode::LeafNodeEntries& entries);
 
 /// Decodes a version tree node, and validates invariants.
-Result<VersionTreeNode> DecodeVersionTreeNode(const absl::Cord& encoded,
-                                              const BasePath& base_path);
+///
+/// \param zstd_dictionary Zstd dictionary specified by the configuration,
+///     required if the node was compressed with a dictionary.
+Result<VersionTreeNode> DecodeVersionTreeNode(
+    const absl::Cord& encoded, const BasePath& base_path,
+    const Config::ZstdDictionary& zstd_dictionary = {});
 
 /// Encodes a version tree node.
 ///
@@ -15,6 +15,7 @@
 #include "tensorstore/kvstore/ocdbt/io/coalesce_kvstore.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <cassert>
@@ -41,7 +42,9 @@
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/thread/schedule_at.h"
+#include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -136,12 +139,12 @@ struct PendingReadHash {
 
 class CoalesceKvStoreDriver final : public kvstore::Driver {
  public:
-  explicit CoalesceKvStoreDriver(kvstore::DriverPtr base, size_t threshold,
-                                 size_t merged_threshold,
-                                 absl::Duration interval, Executor executor)
+  explicit CoalesceKvStoreDriver(
+      kvstore::DriverPtr base,
+      internal_kvstore_batch::CoalescingOverrides overrides,
+      absl::Duration interval, Executor executor)
       : base_(std::move(base)),
-        threshold_(threshold),
-        merged_threshold_(merged_threshold),
+        policy_(kDefaultCoalescingOptions, overrides),
         interval_(interval),
         thread_pool_executor_(std::move(executor)) {}
 
@@ -196,9 +199,19 @@ class CoalesceKvStoreDriver final : public kvstore::Driver {
   void StartNextRead(internal::IntrusivePtr<PendingRead> state_ptr);
 
  private:
+  // Coalescing options used until the latency and bandwidth of `base_` have
+  // been estimated.
+  constexpr static internal_kvstore_batch::CoalescingOptions
+      kDefaultCoalescingOptions = {
+          /*.max_extra_read_bytes=*/0,
+          /*.target_coalesced_size=*/std::numeric_limits<int64_t>::max(),
+  };
+
+  // Reads from `base_`, and records the latency with `policy_`.
+  Future<ReadResult> ReadBase(Key key, ReadOptions options);
+
   kvstore::DriverPtr base_;
-  size_t threshold_;
-  size_t merged_threshold_;
+  internal_kvstore_batch::CoalescingPolicy policy_;
   absl::Duration interval_;
   Executor thread_pool_executor_;
 
@@ -208,6 +221,20 @@ class CoalesceKvStoreDriver final : public kvstore::Driver {
       pending_ ABSL_GUARDED_BY(mu_);
 };
 
+Future<kvstore::ReadResult> CoalesceKvStoreDriver::ReadBase(
+    Key key, ReadOptions options) {
+  const absl::Time start_time = absl::Now();
+  auto future = base_->Read(std::move(key), std::move(options));
+  future.ExecuteWhenReady(
+      [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
+       start_time](ReadyFuture<ReadResult> ready) {
+        if (!ready.result().ok()) return;
+        self->policy_.RecordRead(ready.value().value.size(),
+                                 absl::Now() - start_time);
+      });
+  return future;
+}
+
 Future<kvstore::ReadResult> CoalesceKvStoreDriver::Read(Key key,
                                                         ReadOptions options) {
   internal::IntrusivePtr<PendingRead> state_ptr;
@@ -252,7 +279,7 @@ Future<kvstore::ReadResult> CoalesceKvStoreDriver::Read(Key key,
   }
 
   // non-interval based trigger
-  auto future = base_->Read(key, std::move(options));
+  auto future = ReadBase(key, std::move(options));
   future.ExecuteWhenReady(
       [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
        state = std::move(state_ptr)](ReadyFuture<ReadResult>) {
@@ -350,6 +377,7 @@ void CoalesceKvStoreDriver::StartNextRead(
   });
 
   kvstore::Key key = state_ptr->key;
+  const auto coalescing_options = policy_.GetOptions();
 
   MergeValue merged;
   const auto& first_pending = pending.front();
@@ -372,7 +400,7 @@ void CoalesceKvStoreDriver::StartNextRead(
       // The options differ from the prior options, so issue the pending
       // request and start another.
       assert(!merged.subreads.empty());
-      auto f = base_->Read(key, merged.options);
+      auto f = ReadBase(key, merged.options);
       f.ExecuteWhenReady(
           [merged = std::move(merged)](ReadyFuture<kvstore::ReadResult> ready) {
             OnReadComplete(std::move(merged), std::move(ready));
@@ -382,15 +410,15 @@ void CoalesceKvStoreDriver::StartNextRead(
     } else if (merged.options.byte_range.exclusive_max != -1 &&
                ((e.options.byte_range.inclusive_min -
                      merged.options.byte_range.exclusive_max >
-                 threshold_) ||
-                (merged_threshold_ > 0 &&
-                 merged.options.byte_range.size() > merged_threshold_))) {
+                 coalescing_options.max_extra_read_bytes) ||
+                (merged.options.byte_range.size() >
+                 coalescing_options.target_coalesced_size))) {
       // The distance from the end of the prior read to the beginning of the
-      // next read exceeds threshold_ or the total merged_size exceeds
-      // merged_threshold_, so issue the pending request and start
+      // next read exceeds max_extra_read_bytes or the total merged_size
+      // exceeds target_coalesced_size, so issue the pending request and start
       // another.
       assert(!merged.subreads.empty());
-      auto f = base_->Read(key, merged.options);
+      auto f = ReadBase(key, merged.options);
       f.ExecuteWhenReady(
           [merged = std::move(merged)](ReadyFuture<kvstore::ReadResult> ready) {
             OnReadComplete(std::move(merged), std::move(ready));
@@ -424,7 +452,7 @@ void CoalesceKvStoreDriver::StartNextRead(
   // Issue final request. This request will trigger additional reads via
   // StartNextRead.
   assert(!merged.subreads.empty());
-  auto f = base_->Read(key, merged.options);
+  auto f = ReadBase(key, merged.options);
   f.ExecuteWhenReady(
       [self = internal::IntrusivePtr<CoalesceKvStoreDriver>(this),
        merged = std::move(merged),
@@ -442,18 +470,36 @@ void CoalesceKvStoreDriver::StartNextRead(
 
 }  // namespace
 
+kvstore::DriverPtr MakeCoalesceKvStoreDriver(
+    kvstore::DriverPtr base,
+    internal_kvstore_batch::CoalescingOverrides overrides,
+    absl::Duration interval, Executor executor) {
+  ABSL_LOG_IF(INFO, ocdbt_logging)
+      << "Coalescing reads with threshold: "
+      << (overrides.max_extra_read_bytes
+              ? std::to_string(*overrides.max_extra_read_bytes)
+              : "adaptive")
+      << ", merged_threshold: "
+      << (overrides.target_coalesced_size
+              ? std::to_string(*overrides.target_coalesced_size)
+              : "none")
+      << ", interval: " << interval;
+  return internal::MakeIntrusivePtr<CoalesceKvStoreDriver>(
+      std::move(base), std::move(overrides), interval, std::move(executor));
+}
+
 kvstore::DriverPtr MakeCoalesceKvStoreDriver(kvstore::DriverPtr base,
                                              size_t threshold,
                                              size_t merged_threshold,
                                              absl::Duration interval,
                                              Executor executor) {
-  ABSL_LOG_IF(INFO, ocdbt_logging)
-      << "Coalescing reads with threshold: " << threshold
-      << ", merged_threshold: " << merged_threshold
-      << ", interval: " << interval;
-  return internal::MakeIntrusivePtr<CoalesceKvStoreDriver>(
-      std::move(base), threshold, merged_threshold, interval,
-      std::move(executor));
+  internal_kvstore_batch::CoalescingOverrides overrides;
+  overrides.max_extra_read_bytes = static_cast<int64_t>(threshold);
+  if (merged_threshold > 0) {
+    overrides.target_coalesced_size = static_cast<int64_t>(merged_threshold);
+  }
+  return MakeCoalesceKvStoreDriver(std::move(base), std::move(overrides),
+                                   interval, std::move(executor));
 }
 
 }  // namespace internal_ocdbt
@@ -15,6 +15,10 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_IO_COALESCE_KVSTORE_H_
 #define TENSORSTORE_KVSTORE_OCDBT_IO_COALESCE_KVSTORE_H_
 
+#include <stddef.h>
+
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/util/executor.h"
 
@@ -24,8 +28,22 @@ namespace internal_ocdbt {
 /// Adapts a base kvstore to coalesce read ranges.
 ///
 /// Concurrent reads for the same key may be merged if the ranges are
+/// separated by at most `overrides.max_extra_read_bytes` bytes, and the merged
+/// read does not already exceed `overrides.target_coalesced_size` bytes.  If
+/// either is unspecified, it is determined by an
+/// `internal_kvstore_batch::CoalescingPolicy` from the latency and bandwidth
+/// observed for `base`.
+kvstore::DriverPtr MakeCoalesceKvStoreDriver(
+    kvstore::DriverPtr base,
+    internal_kvstore_batch::CoalescingOverrides overrides,
+    absl::Duration interval, Executor executor);
+
+/// Same as above, but with fixed thresholds.
+///
+/// Concurrent reads for the same key may be merged if the ranges are
 /// separated by less than threshold bytes. 1MB may be a reasonable value
-/// for reducing GCS reads in the OCDBT driver.
+/// for reducing GCS reads in the OCDBT driver.  A `merged_threshold` of `0`
+/// indicates no limit.
 kvstore::DriverPtr MakeCoalesceKvStoreDriver(kvstore::DriverPtr base,
                                              size_t threshold,
                                              size_t merged_threshold,
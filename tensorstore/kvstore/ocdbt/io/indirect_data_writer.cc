@@ -16,17 +16,23 @@
 
 #include <stddef.h>
 
+#include <array>
 #include <cassert>
+#include <deque>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
+#include "tensorstore/internal/digest/sha256.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/mutex.h"
@@ -48,8 +54,21 @@ auto& indirect_data_writer_histogram =
             "Histogram of OCDBT buffered write sizes.",
             internal_metrics::Units::kBytes));
 
+auto& indirect_data_deduplicated_bytes =
+    internal_metrics::Counter<int64_t>::New(
+        "/tensorstore/kvstore/ocdbt/indirect_data_deduplicated_bytes",
+        internal_metrics::MetricMetadata(
+            "OCDBT bytes not written due to deduplication",
+            internal_metrics::Units::kBytes));
+
 ABSL_CONST_INIT internal_log::VerboseFlag ocdbt_logging("ocdbt");
 
+// Maximum number of entries in the deduplication index.  Each entry requires
+// about 100 bytes.
+constexpr size_t kMaxDeduplicationIndexEntries = 1 << 20;
+
+using Digest = internal::SHA256Digester::DigestType;
+
 }  // namespace
 
 class IndirectDataWriter
@@ -85,6 +104,23 @@ class IndirectDataWriter
 
   // Data file identifier to which `buffer_` will be written.
   DataFileId data_file_id_;
+
+  struct DeduplicationEntry {
+    IndirectDataReference ref;
+    // Future that becomes ready once the value is durable.
+    Future<const void> future;
+    // Assigned from `next_insertion_` when the entry is inserted.
+    uint64_t insertion;
+  };
+
+  // Index of deduplicated values by digest.
+  absl::flat_hash_map<Digest, DeduplicationEntry> deduplication_index_;
+
+  // Keys of `deduplication_index_` in insertion order, along with the value of
+  // `DeduplicationEntry::insertion`, used to evict the oldest entries.  Entries
+  // that were since removed or replaced are skipped.
+  std::deque<std::pair<Digest, uint64_t>> deduplication_order_;
+  uint64_t next_insertion_ = 0;
 };
 
 void intrusive_ptr_increment(IndirectDataWriter* p) {
@@ -97,6 +133,42 @@ void intrusive_ptr_decrement(IndirectDataWriter* p) {
 }
 
 namespace {
+
+// Returns the existing reference to a value with the specified `digest`, if
+// any.  Must be called with `self.mutex_` held.
+std::optional<IndirectDataWriter::DeduplicationEntry> FindDuplicate(
+    IndirectDataWriter& self, const Digest& digest) {
+  auto it = self.deduplication_index_.find(digest);
+  if (it == self.deduplication_index_.end()) return std::nullopt;
+  auto& entry = it->second;
+  if (entry.future.ready() && !entry.future.status().ok()) {
+    // The value was never written successfully.
+    self.deduplication_index_.erase(it);
+    return std::nullopt;
+  }
+  return entry;
+}
+
+// Adds a value to the deduplication index, evicting the oldest entries if the
+// index is full.  Must be called with `self.mutex_` held.
+void AddDuplicate(IndirectDataWriter& self, const Digest& digest,
+                  const IndirectDataReference& ref,
+                  const Future<const void>& future) {
+  const uint64_t insertion = self.next_insertion_++;
+  self.deduplication_index_.insert_or_assign(
+      digest, IndirectDataWriter::DeduplicationEntry{ref, future, insertion});
+  self.deduplication_order_.emplace_back(digest, insertion);
+  while (self.deduplication_index_.size() > kMaxDeduplicationIndexEntries) {
+    auto [oldest_digest, oldest_insertion] = self.deduplication_order_.front();
+    self.deduplication_order_.pop_front();
+    auto it = self.deduplication_index_.find(oldest_digest);
+    if (it != self.deduplication_index_.end() &&
+        it->second.insertion == oldest_insertion) {
+      self.deduplication_index_.erase(it);
+    }
+  }
+}
+
 void MaybeFlush(IndirectDataWriter& self, UniqueWriterLock<absl::Mutex> lock) {
   bool buffer_at_target =
       self.target_size_ > 0 && self.buffer_.size() >= self.target_size_;
@@ -156,7 +228,7 @@ void MaybeFlush(IndirectDataWriter& self, UniqueWriterLock<absl::Mutex> lock) {
 }  // namespace
 
 Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
-                         IndirectDataReference& ref) {
+                         IndirectDataReference& ref, bool deduplicate) {
   ABSL_LOG_IF(INFO, ocdbt_logging)
       << "Write indirect data: size=" << data.size();
   if (data.empty()) {
@@ -165,7 +237,24 @@ Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
     ref.length = 0;
     return absl::OkStatus();
   }
+  std::optional<Digest> digest;
+  if (deduplicate) {
+    // Computed before acquiring the lock, such that concurrent writers hash
+    // their values in parallel.
+    internal::SHA256Digester digester;
+    digester.Write(data);
+    digest = digester.Digest();
+  }
   UniqueWriterLock lock{self.mutex_};
+  if (digest) {
+    if (auto existing = FindDuplicate(self, *digest)) {
+      ABSL_LOG_IF(INFO, ocdbt_logging)
+          << "Deduplicated indirect data: " << existing->ref;
+      indirect_data_deduplicated_bytes.IncrementBy(data.size());
+      ref = std::move(existing->ref);
+      return std::move(existing->future);
+    }
+  }
   Future<const void> future;
   if (self.promise_.null() || (future = self.promise_.future()).null()) {
     // Create new data file.
@@ -187,6 +276,7 @@ Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
   ref.offset = self.buffer_.size();
   ref.length = data.size();
   self.buffer_.Append(std::move(data));
+  if (digest) AddDuplicate(self, *digest, ref, future);
 
   if (self.target_size_ > 0 && self.buffer_.size() >= self.target_size_) {
     MaybeFlush(self, std::move(lock));
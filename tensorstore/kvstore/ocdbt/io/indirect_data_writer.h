@@ -40,6 +40,13 @@
 /// underlying kvstore.
 ///
 /// This is used to store data values and btree nodes.
+///
+/// Values written with `deduplicate == true` are identified by their SHA-256
+/// digest.  If a value with the same digest was previously written, with
+/// `deduplicate == true`, through the same `IndirectDataWriter`, the existing
+/// reference is returned instead of storing the value again.  The index of
+/// digests is maintained in memory, and is limited to the most recently
+/// written values.
 
 namespace tensorstore {
 namespace internal_ocdbt {
@@ -55,7 +62,7 @@ IndirectDataWriterPtr MakeIndirectDataWriter(kvstore::KvStore kvstore,
                                              size_t target_size);
 
 Future<const void> Write(IndirectDataWriter& self, absl::Cord data,
-                         IndirectDataReference& ref);
+                         IndirectDataReference& ref, bool deduplicate = false);
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
@@ -22,6 +22,7 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "tensorstore/internal/flat_cord_builder.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -152,4 +153,54 @@ TEST(IndirectDataWriter, LimitedSize) {
   EXPECT_THAT(files, ::testing::ElementsAreArray(refs));
 }
 
+TEST(IndirectDataWriter, Deduplicate) {
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  auto mock_key_value_store = MockKeyValueStore::Make();
+  auto writer = MakeIndirectDataWriter(
+      tensorstore::kvstore::KvStore(mock_key_value_store), "d/", 0);
+
+  IndirectDataReference ref1, ref2, ref3, ref4;
+  auto f1 = Write(*writer, absl::Cord("abc"), ref1, /*deduplicate=*/true);
+  auto f2 = Write(*writer, absl::Cord("abc"), ref2, /*deduplicate=*/true);
+  auto f3 = Write(*writer, absl::Cord("def"), ref3, /*deduplicate=*/true);
+  auto f4 = Write(*writer, absl::Cord("abc"), ref4, /*deduplicate=*/false);
+  EXPECT_EQ(ref1, ref2);
+  EXPECT_EQ(ref1.file_id, ref3.file_id);
+  EXPECT_EQ(3, ref3.offset);
+  EXPECT_EQ(6, ref4.offset);
+
+  // The duplicate shares the pending write of the original value.
+  EXPECT_FALSE(f2.ready());
+  f2.Force();
+  ASSERT_EQ(1, mock_key_value_store->write_requests.size());
+  mock_key_value_store->write_requests.pop()(memory_store);
+  TENSORSTORE_ASSERT_OK(f1.status());
+  TENSORSTORE_ASSERT_OK(f2.status());
+
+  // Once written, the duplicate is ready immediately.
+  IndirectDataReference ref5;
+  auto f5 = Write(*writer, absl::Cord("abc"), ref5, /*deduplicate=*/true);
+  EXPECT_EQ(ref1, ref5);
+  TENSORSTORE_ASSERT_OK(f5.status());
+  EXPECT_EQ(0, mock_key_value_store->write_requests.size());
+}
+
+TEST(IndirectDataWriter, DeduplicateAfterFailedWrite) {
+  auto mock_key_value_store = MockKeyValueStore::Make();
+  auto writer = MakeIndirectDataWriter(
+      tensorstore::kvstore::KvStore(mock_key_value_store), "d/", 0);
+
+  IndirectDataReference ref1, ref2;
+  auto f1 = Write(*writer, absl::Cord("abc"), ref1, /*deduplicate=*/true);
+  f1.Force();
+  mock_key_value_store->write_requests.pop().promise.SetResult(
+      absl::UnknownError("write failed"));
+  EXPECT_FALSE(f1.status().ok());
+
+  // The value is written again.
+  auto f2 = Write(*writer, absl::Cord("abc"), ref2, /*deduplicate=*/true);
+  EXPECT_NE(ref1.file_id, ref2.file_id);
+  EXPECT_FALSE(f2.ready());
+}
+
 }  // namespace
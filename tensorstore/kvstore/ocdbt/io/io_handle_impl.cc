@@ -17,11 +17,13 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_check.h"
@@ -39,6 +41,7 @@
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -87,13 +90,32 @@ class IoHandleImpl : public IoHandle {
                                                       absl::InfinitePast()};
   mutable ManifestWithTime cached_numbered_manifest_{nullptr,
                                                      absl::InfinitePast()};
+  mutable std::atomic<bool> zstd_dictionary_set_{false};
+
+  // Provides the zstd dictionary specified by the configuration to the node
+  // caches, once the configuration is known.  Nodes are only referenced by a
+  // manifest, and the configuration is known once a manifest has been read.
+  void MaybeSetZstdDictionary() const {
+    if (zstd_dictionary_set_.load(std::memory_order_acquire)) return;
+    const Config* config = config_state->GetExistingConfig();
+    if (!config) return;
+    if (const auto* zstd_config =
+            std::get_if<Config::ZstdCompression>(&config->compression)) {
+      btree_node_cache_->SetZstdDictionary(zstd_config->dictionary);
+      version_tree_node_cache_->SetZstdDictionary(zstd_config->dictionary);
+    }
+    zstd_dictionary_set_.store(true, std::memory_order_release);
+  }
+
   Future<const std::shared_ptr<const BtreeNode>> GetBtreeNode(
-      const IndirectDataReference& ref) const final {
-    return btree_node_cache_->ReadEntry(ref);
+      const IndirectDataReference& ref, Batch::View batch) const final {
+    MaybeSetZstdDictionary();
+    return btree_node_cache_->ReadEntry(ref, absl::InfinitePast(), batch);
   }
 
   Future<const std::shared_ptr<const VersionTreeNode>> GetVersionTreeNode(
       const IndirectDataReference& ref) const final {
+    MaybeSetZstdDictionary();
     return version_tree_node_cache_->ReadEntry(ref);
   }
 
@@ -159,6 +181,24 @@ class IoHandleImpl : public IoHandle {
   }
 
   struct GetManifestOp {
+    // Returns `true` if the cached `manifest_with_time` satisfies
+    // `staleness_bound`.  If `manifest_notifications` reports that the cached
+    // manifest is still the latest, its time is advanced accordingly.
+    static bool IsFresh(const IoHandleImpl* self,
+                        ManifestWithTime& manifest_with_time,
+                        absl::Time staleness_bound) {
+      if (manifest_with_time.time == absl::InfinitePast()) return false;
+      if (manifest_with_time.time >= staleness_bound) return true;
+      if (!self->manifest_notifications || !manifest_with_time.manifest) {
+        return false;
+      }
+      absl::Time time = self->manifest_notifications->GetLatestGenerationTime(
+          GetLatestGeneration(manifest_with_time.manifest.get()));
+      if (time < staleness_bound) return false;
+      manifest_with_time.time = time;
+      return true;
+    }
+
     static void Start(const IoHandleImpl* self,
                       Promise<ManifestWithTime> promise,
                       absl::Time staleness_bound) {
@@ -178,8 +218,7 @@ class IoHandleImpl : public IoHandle {
         return;
       }
 
-      if (manifest_with_time.time >= staleness_bound &&
-          manifest_with_time.time != absl::InfinitePast()) {
+      if (IsFresh(self, manifest_with_time, staleness_bound)) {
         promise.SetResult(std::move(manifest_with_time));
         return;
       }
@@ -213,8 +252,7 @@ class IoHandleImpl : public IoHandle {
       TENSORSTORE_RETURN_IF_ERROR(
           self->GetCachedNumberedManifest(manifest_with_time),
           static_cast<void>(promise.SetResult(_)));
-      if (manifest_with_time.time >= staleness_bound &&
-          manifest_with_time.time != absl::InfinitePast()) {
+      if (IsFresh(self.get(), manifest_with_time, staleness_bound)) {
         ABSL_LOG_IF(INFO, ocdbt_logging)
             << "GetManifestOp::Start: using cached numbered manifest: time="
             << manifest_with_time.time
@@ -407,7 +445,8 @@ class IoHandleImpl : public IoHandle {
                                IndirectDataReference& ref) const final {
     return internal_ocdbt::Write(
         *indirect_data_writer_[static_cast<size_t>(kind)], std::move(data),
-        ref);
+        ref,
+        /*deduplicate=*/deduplicate_values && kind == IndirectDataKind::kValue);
   }
 
   std::string DescribeLocation() const final {
@@ -421,14 +460,17 @@ IoHandle::Ptr MakeIoHandle(
     internal::CachePool* cache_pool, const KvStore& base_kvstore,
     const KvStore& manifest_kvstore, ConfigStatePtr config_state,
     const DataFilePrefixes& data_file_prefixes, size_t write_target_size,
-    std::optional<ReadCoalesceOptions> read_coalesce_options) {
+    std::optional<ReadCoalesceOptions> read_coalesce_options,
+    bool key_ordered_writes, bool deduplicate_values,
+    ManifestNotificationSource::Ptr manifest_notifications) {
   // Maybe wrap the base driver in CoalesceKvStoreDriver.
   kvstore::DriverPtr driver_with_optional_coalescing =
       read_coalesce_options.has_value()
           ? MakeCoalesceKvStoreDriver(
                 base_kvstore.driver,
-                read_coalesce_options->max_overhead_bytes_per_request,
-                read_coalesce_options->max_merged_bytes_per_request,
+                internal_kvstore_batch::CoalescingOverrides{
+                    read_coalesce_options->max_overhead_bytes_per_request,
+                    read_coalesce_options->max_merged_bytes_per_request},
                 read_coalesce_options->max_interval,
                 data_copy_concurrency->executor)
           : base_kvstore.driver;
@@ -436,6 +478,10 @@ IoHandle::Ptr MakeIoHandle(
   impl->base_kvstore_ = base_kvstore;
   impl->config_state = std::move(config_state);
   impl->executor = data_copy_concurrency->executor;
+  impl->key_ordered_writes = key_ordered_writes;
+  impl->deduplicate_values = deduplicate_values;
+  impl->manifest_notifications = std::move(manifest_notifications);
+  impl->version_root_cache = std::make_shared<VersionRootCache>();
   auto data_kvstore =
       kvstore::KvStore(driver_with_optional_coalescing, base_kvstore.path);
   {
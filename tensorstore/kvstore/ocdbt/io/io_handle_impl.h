@@ -43,8 +43,11 @@ struct DataFilePrefixes {
 };
 
 struct ReadCoalesceOptions {
-  int64_t max_overhead_bytes_per_request;
-  int64_t max_merged_bytes_per_request;
+  /// Maximum gap between merged reads.  If not specified, it is chosen
+  /// adaptively from the observed latency and bandwidth.
+  std::optional<int64_t> max_overhead_bytes_per_request;
+  /// Maximum size of a merged read.  If not specified, there is no limit.
+  std::optional<int64_t> max_merged_bytes_per_request;
   absl::Duration max_interval;
 };
 
@@ -55,7 +58,9 @@ IoHandle::Ptr MakeIoHandle(
     internal::CachePool* cache_pool, const KvStore& base_kvstore,
     const KvStore& manifest_kvstore, ConfigStatePtr config_state,
     const DataFilePrefixes& data_file_prefixes, size_t write_target_size = 0,
-    std::optional<ReadCoalesceOptions> read_coalesce_options = std::nullopt);
+    std::optional<ReadCoalesceOptions> read_coalesce_options = std::nullopt,
+    bool key_ordered_writes = false, bool deduplicate_values = false,
+    ManifestNotificationSource::Ptr manifest_notifications = {});
 
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
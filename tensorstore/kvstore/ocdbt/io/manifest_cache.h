@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include <memory>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -90,6 +91,7 @@ class ManifestCache : public internal::AsyncCache {
 
   Entry* DoAllocateEntry() final;
   size_t DoGetSizeofEntry() final;
+  std::string_view DoGetCacheTypeName() final { return "ocdbt_manifest"; }
   TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final;
 
   kvstore::DriverPtr kvstore_driver_;
@@ -159,6 +161,7 @@ class NumberedManifestCache : public internal::AsyncCache {
 
   Entry* DoAllocateEntry() final;
   size_t DoGetSizeofEntry() final;
+  std::string_view DoGetCacheTypeName() final { return "ocdbt_manifest"; }
   TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final;
 
   kvstore::DriverPtr kvstore_driver_;
@@ -20,12 +20,16 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
@@ -37,6 +41,7 @@
 #include "tensorstore/internal/estimate_heap_usage/std_variant.h"
 #include "tensorstore/internal/estimate_heap_usage/std_vector.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/config.h"
 #include "tensorstore/kvstore/ocdbt/format/data_file_id.h"
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
@@ -82,12 +87,14 @@ class DecodedIndirectDataCache
       IndirectDataReference ref;
       ABSL_CHECK(ref.DecodeCacheKey(this->key()));
 
-      GetOwningCache(*this).executor()(
+      auto& cache = GetOwningCache(*this);
+      cache.executor()(
           [value = std::move(*value), base_path = ref.file_id.base_path,
+           zstd_dictionary = cache.zstd_dictionary(),
            receiver = std::move(receiver)]() mutable {
             auto read_data = std::make_shared<T>();
             TENSORSTORE_ASSIGN_OR_RETURN(
-                *read_data, Derived::Decode(value, base_path),
+                *read_data, Derived::Decode(value, base_path, zstd_dictionary),
                 static_cast<void>(execution::set_error(receiver, _)));
             execution::set_value(receiver, std::move(read_data));
           });
@@ -110,7 +117,8 @@ class DecodedIndirectDataCache
 
   Future<const std::shared_ptr<const T>> ReadEntry(
       const IndirectDataReference& ref,
-      absl::Time staleness_bound = absl::InfinitePast()) {
+      absl::Time staleness_bound = absl::InfinitePast(),
+      Batch::View batch = no_batch) {
     auto entry = GetEntry(ref);
     auto* entry_ptr = entry.get();
     return PromiseFuturePair<std::shared_ptr<const T>>::LinkValue(
@@ -120,13 +128,27 @@ class DecodedIndirectDataCache
                  promise.SetResult(
                      internal::AsyncCache::ReadLock<T>(*entry).shared_data());
                },
-               entry_ptr->Read({staleness_bound}))
+               entry_ptr->Read({staleness_bound, batch}))
         .future;
   }
 
   const Executor& executor() { return executor_; }
 
+  /// Sets the zstd dictionary specified by the configuration of the database,
+  /// used to decode nodes compressed with a dictionary.
+  void SetZstdDictionary(const Config::ZstdDictionary& zstd_dictionary) {
+    absl::MutexLock lock(&mutex_);
+    zstd_dictionary_ = zstd_dictionary;
+  }
+
+  Config::ZstdDictionary zstd_dictionary() {
+    absl::MutexLock lock(&mutex_);
+    return zstd_dictionary_;
+  }
+
   Executor executor_;
+  absl::Mutex mutex_;
+  Config::ZstdDictionary zstd_dictionary_ ABSL_GUARDED_BY(mutex_);
 };
 
 template <typename Derived>
@@ -150,10 +172,13 @@ class BtreeNodeCache
  public:
   using Base::Base;
 
-  static Result<BtreeNode> Decode(const absl::Cord& encoded,
-                                  const BasePath& base_path) {
-    return DecodeBtreeNode(encoded, base_path);
+  static Result<BtreeNode> Decode(
+      const absl::Cord& encoded, const BasePath& base_path,
+      const Config::ZstdDictionary& zstd_dictionary) {
+    return DecodeBtreeNode(encoded, base_path, zstd_dictionary);
   }
+
+  std::string_view DoGetCacheTypeName() final { return "ocdbt_btree_node"; }
 };
 
 extern template class DecodedIndirectDataCache<BtreeNodeCache, BtreeNode>;
@@ -165,9 +190,14 @@ class VersionTreeNodeCache
  public:
   using Base::Base;
 
-  static Result<VersionTreeNode> Decode(const absl::Cord& encoded,
-                                        const BasePath& base_path) {
-    return DecodeVersionTreeNode(encoded, base_path);
+  static Result<VersionTreeNode> Decode(
+      const absl::Cord& encoded, const BasePath& base_path,
+      const Config::ZstdDictionary& zstd_dictionary) {
+    return DecodeVersionTreeNode(encoded, base_path, zstd_dictionary);
+  }
+
+  std::string_view DoGetCacheTypeName() final {
+    return "ocdbt_version_tree_node";
   }
 };
 
@@ -14,17 +14,62 @@
 
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 
+#include <stddef.h>
+
+#include <optional>
 #include <utility>
+#include <variant>
 
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "tensorstore/kvstore/ocdbt/format/version_tree.h"
 #include "tensorstore/util/future.h"
 
 namespace tensorstore {
 namespace internal_ocdbt {
 
+ManifestNotificationSource::~ManifestNotificationSource() = default;
 ReadonlyIoHandle::~ReadonlyIoHandle() = default;
 
+VersionRootCache::VersionRootCache(size_t max_entries)
+    : max_entries_(max_entries) {}
+
+std::optional<BtreeGenerationReference> VersionRootCache::Find(
+    VersionSpec version_spec) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  GenerationNumber generation_number;
+  if (auto* g = std::get_if<GenerationNumber>(&version_spec)) {
+    generation_number = *g;
+  } else if (auto* t = std::get_if<CommitTime>(&version_spec)) {
+    auto it = by_commit_time_.find(t->value);
+    if (it == by_commit_time_.end()) return std::nullopt;
+    generation_number = it->second;
+  } else {
+    return std::nullopt;
+  }
+  auto it = by_generation_.find(generation_number);
+  if (it == by_generation_.end()) return std::nullopt;
+  return it->second;
+}
+
+void VersionRootCache::Insert(const BtreeGenerationReference& ref) {
+  if (max_entries_ == 0) return;
+  absl::MutexLock lock(&mutex_);
+  if (by_generation_.contains(ref.generation_number)) return;
+  if (by_generation_.size() >= max_entries_) {
+    auto it = by_generation_.begin();
+    by_commit_time_.erase(it->second.commit_time.value);
+    by_generation_.erase(it);
+  }
+  by_generation_.emplace(ref.generation_number, ref);
+  by_commit_time_.emplace(ref.commit_time.value, ref.generation_number);
+}
+
+size_t VersionRootCache::size() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return by_generation_.size();
+}
+
 FlushPromise::FlushPromise(FlushPromise&& other) noexcept
     : prev_linked_future_(std::move(other.prev_linked_future_)),
       promise_(std::move(other.promise_)),
@@ -15,14 +15,21 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_IO_HANDLE_H_
 #define TENSORSTORE_KVSTORE_OCDBT_IO_HANDLE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/kvstore/ocdbt/config.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
@@ -37,6 +44,54 @@
 namespace tensorstore {
 namespace internal_ocdbt {
 
+/// Source of notifications of newly-written manifests, used to avoid
+/// re-reading a cached manifest that is known to be up to date.
+class ManifestNotificationSource
+    : public internal::AtomicReferenceCount<ManifestNotificationSource> {
+ public:
+  using Ptr = internal::IntrusivePtr<ManifestNotificationSource>;
+
+  /// Returns the time as of which `generation` is known to be the latest
+  /// manifest generation, or `absl::InfinitePast()` if unknown.
+  virtual absl::Time GetLatestGenerationTime(
+      GenerationNumber generation) const = 0;
+
+  virtual ~ManifestNotificationSource();
+};
+
+/// In-memory cache of the roots of versions found in the version tree.
+///
+/// The root of a committed version never changes, so a cached root remains
+/// valid indefinitely.  Repeated reads at the same exact version, by
+/// generation number or commit time, therefore skip reading the manifest and
+/// descending the version tree.
+///
+/// \threadsafety Thread safe.
+class VersionRootCache {
+ public:
+  constexpr static size_t kDefaultMaxEntries = 4096;
+
+  explicit VersionRootCache(size_t max_entries = kDefaultMaxEntries);
+
+  /// Returns the cached root for `version_spec`, or `std::nullopt` if not
+  /// cached or `version_spec` is not exact.
+  std::optional<BtreeGenerationReference> Find(VersionSpec version_spec) const;
+
+  /// Caches `ref`.  If the cache is full, an arbitrary entry is evicted.
+  void Insert(const BtreeGenerationReference& ref);
+
+  /// Returns the number of cached versions.
+  size_t size() const;
+
+ private:
+  size_t max_entries_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<GenerationNumber, BtreeGenerationReference>
+      by_generation_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, GenerationNumber> by_commit_time_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 /// Abstract interface used by operation implementations to read the OCDBT data
 /// structures for a single database.
 class ReadonlyIoHandle
@@ -45,8 +100,12 @@ class ReadonlyIoHandle
   using Ptr = internal::IntrusivePtr<const ReadonlyIoHandle>;
 
   /// Reads the B+tree node at the specified location.
+  ///
+  /// If `batch` is specified, the read of an uncached node may be deferred
+  /// until `batch` is submitted, and coalesced with other reads in the same
+  /// batch.
   virtual Future<const std::shared_ptr<const BtreeNode>> GetBtreeNode(
-      const IndirectDataReference& ref) const = 0;
+      const IndirectDataReference& ref, Batch::View batch = no_batch) const = 0;
 
   /// Reads the version tree node at the specified location.
   virtual Future<const std::shared_ptr<const VersionTreeNode>>
@@ -64,6 +123,14 @@ class ReadonlyIoHandle
   ConfigStatePtr config_state;
   Executor executor;
 
+  /// Optional.  If specified, a cached manifest that `manifest_notifications`
+  /// reports to be the latest is returned without re-reading it.
+  ManifestNotificationSource::Ptr manifest_notifications;
+
+  /// Optional.  If specified, used by `ReadVersion` to cache the roots of
+  /// versions found in the version tree.
+  std::shared_ptr<VersionRootCache> version_root_cache;
+
   virtual ~ReadonlyIoHandle();
 };
 
@@ -101,6 +168,17 @@ class IoHandle : public ReadonlyIoHandle {
   /// Returns a description of the storage location,
   /// e.g. ``"\"gs://bucket/path/\""``.
   virtual std::string DescribeLocation() const = 0;
+
+  /// If `true`, out-of-line values are not written as soon as they are
+  /// submitted, but rather when they are staged by a commit, in key order.
+  /// Values with nearby keys are then stored contiguously within data files,
+  /// which allows reads of nearby keys to be coalesced.
+  bool key_ordered_writes = false;
+
+  /// If `true`, out-of-line values written by `WriteData` with
+  /// `IndirectDataKind::kValue` that are identical to a value previously
+  /// written through this handle reuse the existing reference.
+  bool deduplicate_values = false;
 };
 
 /// Wrapper around `Promise` that allows the same `Future` to be repeatedly
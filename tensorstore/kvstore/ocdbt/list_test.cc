@@ -0,0 +1,133 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/ocdbt/non_distributed/list.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/cord.h"
+#include "absl/strings/str_format.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/test_util.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::KeyRange;
+using ::tensorstore::internal_ocdbt::GetOcdbtIoHandle;
+using ::tensorstore::internal_ocdbt::KeyRangeStatistics;
+using ::tensorstore::internal_ocdbt::NonDistributedGetKeyRangeStatistics;
+
+constexpr size_t kNumKeys = 200;
+
+std::string GetKey(size_t i) { return absl::StrFormat("%04d", i); }
+
+// Opens a database with a multi-level B+tree, in which the values of keys
+// with an odd index are stored out of line.
+kvstore::KvStore OpenPopulatedStore(::nlohmann::json extra_spec = {}) {
+  ::nlohmann::json json_spec{
+      {"driver", "ocdbt"},
+      {"base", "memory://"},
+      {"config",
+       {{"max_decoded_node_bytes", 200}, {"max_inline_value_bytes", 4}}},
+  };
+  json_spec.update(extra_spec);
+  auto store = kvstore::Open(json_spec).value();
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    TENSORSTORE_CHECK_OK(
+        kvstore::Write(store, GetKey(i),
+                       absl::Cord(std::string(i % 2 ? 10 : 1, 'x')))
+            .result());
+  }
+  return store;
+}
+
+// Returns the statistics of the keys with indices in `[begin, end)`.
+KeyRangeStatistics ExpectedStatistics(size_t begin, size_t end) {
+  KeyRangeStatistics statistics;
+  for (size_t i = begin; i < end; ++i) {
+    ++statistics.num_keys;
+    if (i % 2) statistics.num_indirect_value_bytes += 10;
+  }
+  return statistics;
+}
+
+TEST(ListTest, ConcurrencyLimit) {
+  std::vector<std::string> expected_keys;
+  for (size_t i = 0; i < kNumKeys; ++i) expected_keys.push_back(GetKey(i));
+  for (size_t concurrency : {1, 2, 5}) {
+    SCOPED_TRACE(concurrency);
+    auto store = OpenPopulatedStore(
+        {{"experimental_list_concurrency", concurrency}});
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto entries,
+                                     kvstore::ListFuture(store).result());
+    std::vector<std::string> keys;
+    for (auto& entry : entries) keys.push_back(entry.key);
+    EXPECT_THAT(keys, ::testing::UnorderedElementsAreArray(expected_keys));
+
+    kvstore::ListOptions options;
+    options.range = KeyRange(GetKey(17), GetKey(123));
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        entries, kvstore::ListFuture(store, options).result());
+    EXPECT_EQ(123 - 17, entries.size());
+  }
+}
+
+TEST(ListTest, KeyRangeStatistics) {
+  auto store = OpenPopulatedStore();
+  auto io_handle = GetOcdbtIoHandle(*store.driver);
+  EXPECT_THAT(NonDistributedGetKeyRangeStatistics(io_handle, KeyRange())
+                  .result(),
+              ::testing::Optional(ExpectedStatistics(0, kNumKeys)));
+  for (auto [begin, end] : std::vector<std::pair<size_t, size_t>>{
+           {0, 1}, {0, 50}, {17, 123}, {99, 100}, {150, kNumKeys}}) {
+    SCOPED_TRACE(absl::StrFormat("[%d, %d)", begin, end));
+    EXPECT_THAT(
+        NonDistributedGetKeyRangeStatistics(
+            io_handle, KeyRange(GetKey(begin),
+                                end == kNumKeys ? "" : GetKey(end)))
+            .result(),
+        ::testing::Optional(ExpectedStatistics(begin, end)));
+  }
+  EXPECT_THAT(NonDistributedGetKeyRangeStatistics(io_handle,
+                                                  KeyRange::Prefix("01"))
+                  .result(),
+              ::testing::Optional(ExpectedStatistics(100, 200)));
+  EXPECT_THAT(NonDistributedGetKeyRangeStatistics(io_handle,
+                                                  KeyRange::Prefix("1"))
+                  .result(),
+              ::testing::Optional(KeyRangeStatistics{}));
+}
+
+TEST(ListTest, KeyRangeStatisticsEmpty) {
+  auto store = kvstore::Open({{"driver", "ocdbt"}, {"base", "memory://"}})
+                   .value();
+  EXPECT_THAT(NonDistributedGetKeyRangeStatistics(
+                  GetOcdbtIoHandle(*store.driver), KeyRange())
+                  .result(),
+              ::testing::Optional(KeyRangeStatistics{}));
+}
+
+}  // namespace
@@ -206,7 +206,7 @@ void CommitOperation::StagePending(WriteStager& stager) {
     if (request->kind_ != MutationEntry::kWrite) continue;
     auto& write_request = static_cast<WriteEntry&>(*request);
     if (!write_request.value_) continue;
-    stager.Stage(*write_request.value_);
+    stager.Stage(write_request.key_, *write_request.value_);
   }
 
   ABSL_LOG_IF(INFO, ocdbt_logging)
@@ -289,8 +289,10 @@ Future<TimestampedStorageGeneration> NonDistributedBtreeWriter::Write(
     auto& value_ref = request->value_.emplace();
     if (auto* config =
             writer.io_handle_->config_state->GetAssumedOrExistingConfig();
-        !config || value->size() <= config->max_inline_value_bytes) {
-      // Config not yet known or value to be written inline.
+        !config || value->size() <= config->max_inline_value_bytes ||
+        writer.io_handle_->key_ordered_writes) {
+      // Config not yet known, value to be written inline, or the write is
+      // deferred until commit so that values are laid out in key order.
       value_ref = std::move(*value);
     } else {
       value_future = writer.io_handle_->WriteData(
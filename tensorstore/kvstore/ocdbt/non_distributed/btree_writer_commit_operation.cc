@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -77,6 +78,7 @@ void BtreeWriterCommitOperationBase::ReadManifest() {
         executor([this]() mutable {
           WriteStager stager(*this);
           StagePending(stager);
+          stager.Flush();
           auto [promise, future] =
               PromiseFuturePair<void>::Make(absl::OkStatus());
           TraverseBtreeStartingFromRoot(std::move(promise));
@@ -99,16 +101,38 @@ void BtreeWriterCommitOperationBase::ReadManifest() {
 }
 
 void BtreeWriterCommitOperationBase::WriteStager::Stage(
-    LeafNodeValueReference& value_ref) {
-  if (auto* value_ptr = std::get_if<absl::Cord>(&value_ref)) {
-    if (value_ptr->size() > config.max_inline_value_bytes) {
-      auto value = std::move(*value_ptr);
-      auto value_future =
-          op.io_handle_->WriteData(IndirectDataKind::kValue, std::move(value),
-                                   value_ref.emplace<IndirectDataReference>());
-      op.flush_promise_.Link(std::move(value_future));
-    }
+    std::string_view key, LeafNodeValueReference& value_ref) {
+  auto* value_ptr = std::get_if<absl::Cord>(&value_ref);
+  if (!value_ptr || value_ptr->size() <= config.max_inline_value_bytes) {
+    return;
+  }
+  if (op.io_handle_->key_ordered_writes) {
+    deferred_.emplace_back(key, &value_ref);
+    return;
+  }
+  WriteValue(value_ref);
+}
+
+void BtreeWriterCommitOperationBase::WriteStager::Flush() {
+  // `IndirectDataWriter` assigns offsets in the order in which writes are
+  // issued, so issuing them in key order places the values of nearby keys
+  // adjacent to each other within a data file.
+  std::stable_sort(
+      deferred_.begin(), deferred_.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (auto& [key, value_ref] : deferred_) {
+    WriteValue(*value_ref);
   }
+  deferred_.clear();
+}
+
+void BtreeWriterCommitOperationBase::WriteStager::WriteValue(
+    LeafNodeValueReference& value_ref) {
+  auto value = std::move(std::get<absl::Cord>(value_ref));
+  auto value_future =
+      op.io_handle_->WriteData(IndirectDataKind::kValue, std::move(value),
+                               value_ref.emplace<IndirectDataReference>());
+  op.flush_promise_.Link(std::move(value_future));
 }
 
 void BtreeWriterCommitOperationBase::RootNodeTraversalState::ApplyMutations() {
@@ -131,6 +155,10 @@ void BtreeWriterCommitOperationBase::RootNodeTraversalState::ApplyMutations() {
     return;
   }
 
+  // The new children of the root may have been added concurrently, and
+  // therefore in any order.
+  SortInteriorNodeMutations(this->mutations_);
+
   while (true) {
     // Mutations must be of the form: delete "", add ...
     [[maybe_unused]] auto& deletion_entry = this->mutations_.front();
@@ -188,14 +216,18 @@ void BtreeWriterCommitOperationBase::InteriorNodeTraversalState::
     return;
   }
 
-  UpdateParent(
-      *parent_state_, existing_relative_child_key_,
-      EncodeUpdatedInteriorNodes(
-          this->writer_->existing_config(), this->height_,
-          this->existing_subtree_key_prefix_,
-          std::get<BtreeNode::InteriorNodeEntries>(existing_node_->entries),
-          this->mutations_,
-          /*may_be_root=*/parent_state_->is_root_parent()));
+  auto state = std::make_shared<NodeEncodingState<InteriorNodeEntry>>(
+      this->writer_->existing_config(), this->height_, existing_node_,
+      this->existing_subtree_key_prefix_);
+  state->mutations = std::move(this->mutations_);
+  AddUpdatedInteriorEntries(
+      state->encoder, state->existing_prefix,
+      std::get<BtreeNode::InteriorNodeEntries>(existing_node_->entries),
+      state->mutations);
+  const bool may_be_root = parent_state_->is_root_parent();
+  EncodeNodesAndUpdateParent<InteriorNodeEntry>(
+      parent_state_, existing_relative_child_key_, std::move(state),
+      may_be_root);
 }
 
 void BtreeWriterCommitOperationBase::UpdateParent(
@@ -231,22 +263,100 @@ void BtreeWriterCommitOperationBase::UpdateParent(
   }
 }
 
+template <typename Entry>
+void BtreeWriterCommitOperationBase::EncodeNodesAndUpdateParent(
+    NodeTraversalState::Ptr parent_state,
+    std::string_view existing_relative_child_key,
+    std::shared_ptr<NodeEncodingState<Entry>> state, bool may_be_root) {
+  auto ranges = state->encoder.Partition(may_be_root);
+  if (ranges.size() <= 1) {
+    // Not worth the overhead of scheduling a separate task.
+    std::vector<EncodedNode> encoded_nodes;
+    if (!ranges.empty()) {
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto encoded_node, state->encoder.EncodeNode(ranges[0]),
+          static_cast<void>(SetDeferredResult(parent_state->promise_, _)));
+      encoded_nodes.push_back(std::move(encoded_node));
+    }
+    UpdateParent(*parent_state, existing_relative_child_key,
+                 std::move(encoded_nodes));
+    return;
+  }
+
+  {
+    absl::MutexLock lock(&parent_state->mutex_);
+    // Remove `existing_relative_child_key` from the parent node.
+    auto& mutation = parent_state->mutations_.emplace_back();
+    mutation.add = false;
+    mutation.entry.key =
+        tensorstore::StrCat(parent_state->existing_subtree_key_prefix_,
+                            existing_relative_child_key);
+  }
+
+  // Add the new children in its place as they are encoded.  Each task holds a
+  // reference to `parent_state`, which defers `ApplyMutations` on the parent
+  // until all of them have completed.
+  const auto& executor = parent_state->writer_->io_handle_->executor;
+  for (const auto& range : ranges) {
+    executor([parent_state, state, range] {
+      if (!parent_state->promise_.result_needed()) return;
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto encoded_node, state->encoder.EncodeNode(range),
+          static_cast<void>(SetDeferredResult(parent_state->promise_, _)));
+      auto& writer = *parent_state->writer_;
+      auto new_entry = internal_ocdbt::WriteNode(
+          *writer.io_handle_, writer.flush_promise_, std::move(encoded_node));
+      absl::MutexLock lock(&parent_state->mutex_);
+      auto& mutation = parent_state->mutations_.emplace_back();
+      mutation.add = true;
+      mutation.entry = std::move(new_entry);
+    });
+  }
+}
+
+template void
+BtreeWriterCommitOperationBase::EncodeNodesAndUpdateParent<LeafNodeEntry>(
+    NodeTraversalState::Ptr parent_state,
+    std::string_view existing_relative_child_key,
+    std::shared_ptr<NodeEncodingState<LeafNodeEntry>> state, bool may_be_root);
+
+template void
+BtreeWriterCommitOperationBase::EncodeNodesAndUpdateParent<InteriorNodeEntry>(
+    NodeTraversalState::Ptr parent_state,
+    std::string_view existing_relative_child_key,
+    std::shared_ptr<NodeEncodingState<InteriorNodeEntry>> state,
+    bool may_be_root);
+
+void BtreeWriterCommitOperationBase::SortInteriorNodeMutations(
+    span<InteriorNodeMutation> mutations) {
+  std::sort(mutations.begin(), mutations.end(),
+            [](const InteriorNodeMutation& a, const InteriorNodeMutation& b) {
+              int c = a.entry.key.compare(b.entry.key);
+              if (c != 0) return c < 0;
+              return a.add < b.add;
+            });
+}
+
 Result<std::vector<EncodedNode>>
 BtreeWriterCommitOperationBase::EncodeUpdatedInteriorNodes(
     const Config& config, BtreeNodeHeight height,
     std::string_view existing_prefix,
     span<const InteriorNodeEntry> existing_entries,
     span<InteriorNodeMutation> mutations, bool may_be_root) {
+  BtreeInteriorNodeEncoder encoder(config, height, existing_prefix);
+  AddUpdatedInteriorEntries(encoder, existing_prefix, existing_entries,
+                            mutations);
+  return encoder.Finalize(may_be_root);
+}
+
+void BtreeWriterCommitOperationBase::AddUpdatedInteriorEntries(
+    BtreeInteriorNodeEncoder& encoder, std::string_view existing_prefix,
+    span<const InteriorNodeEntry> existing_entries,
+    span<InteriorNodeMutation> mutations) {
   // Sort by key order, with deletions before additions, which allows the code
   // below to remove and add the same key without additional checks.
-  std::sort(mutations.begin(), mutations.end(),
-            [](const InteriorNodeMutation& a, const InteriorNodeMutation& b) {
-              int c = a.entry.key.compare(b.entry.key);
-              if (c != 0) return c < 0;
-              return a.add < b.add;
-            });
+  SortInteriorNodeMutations(mutations);
 
-  BtreeInteriorNodeEncoder encoder(config, height, existing_prefix);
   auto existing_it = existing_entries.begin();
   auto mutation_it = mutations.begin();
 
@@ -278,12 +388,18 @@ BtreeWriterCommitOperationBase::EncodeUpdatedInteriorNodes(
     }
     ++mutation_it;
   }
-
-  return encoder.Finalize(may_be_root);
 }
 
 void BtreeWriterCommitOperationBase::CreateNewManifest(
     Promise<void> promise, const BtreeGenerationReference& new_generation) {
+  // Begin flushing the new B+tree nodes and values now, rather than once the
+  // new manifest is ready, such that writing them overlaps with updating the
+  // version tree.
+  if (auto flush_future = std::move(flush_promise_).future();
+      !flush_future.null()) {
+    flush_future.Force();
+    flush_promise_.Link(std::move(flush_future));
+  }
   auto future = internal_ocdbt::CreateNewManifest(
       io_handle_, existing_manifest_, new_generation);
   LinkValue(
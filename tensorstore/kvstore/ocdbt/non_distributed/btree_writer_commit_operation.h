@@ -368,14 +368,28 @@ class BtreeWriterCommitOperationBase {
 
   class WriteStager {
    public:
-    void Stage(LeafNodeValueReference& value_ref);
+    // Ensures `value_ref`, to be stored under `key`, is written out-of-line
+    // if it exceeds `max_inline_value_bytes`.
+    //
+    // If `IoHandle::key_ordered_writes` is set, the write is deferred until
+    // `Flush`, such that the values of a single commit are written in key
+    // order.  Both `key` and `value_ref` must remain valid until then.
+    void Stage(std::string_view key, LeafNodeValueReference& value_ref);
 
    private:
     friend class BtreeWriterCommitOperationBase;
     explicit WriteStager(BtreeWriterCommitOperationBase& op)
         : op(op), config(op.existing_config()) {}
+
+    // Writes any values deferred by `Stage`, sorted by key.
+    void Flush();
+
+    void WriteValue(LeafNodeValueReference& value_ref);
+
     BtreeWriterCommitOperationBase& op;
     const Config& config;
+    std::vector<std::pair<std::string_view, LeafNodeValueReference*>>
+        deferred_;
   };
 
   // "Stages" all pending mutations by merging them into the `StagedMutations`
@@ -425,7 +439,11 @@ class BtreeWriterCommitOperationBase {
   //
   // Note that there is no `NodeTraversalState` type for leaf nodes; leaf nodes
   // are not part of the `NodeTraversalState` tree, since they can be updated
-  // synchronously without waiting on any additional I/O.
+  // without waiting on any additional I/O.
+  //
+  // Tasks that encode the updated children of a node also hold a reference to
+  // its `NodeTraversalState`, such that the node is not updated until all of
+  // its new children have been written.
   struct NodeTraversalState
       : public internal::AtomicReferenceCount<NodeTraversalState> {
     using Ptr = internal::IntrusivePtr<NodeTraversalState>;
@@ -490,6 +508,60 @@ class BtreeWriterCommitOperationBase {
       std::string_view existing_relative_child_key,
       Result<std::vector<EncodedNode>>&& encoded_nodes_result);
 
+  // Encoder for the updated version of an existing node, along with the data
+  // referenced by the entries added to it.
+  template <typename Entry>
+  struct NodeEncodingState {
+    NodeEncodingState(const Config& config, BtreeNodeHeight height,
+                      std::shared_ptr<const BtreeNode> existing_node,
+                      std::string existing_prefix)
+        : existing_node(std::move(existing_node)),
+          existing_prefix(std::move(existing_prefix)),
+          encoder(config, height, this->existing_prefix) {}
+
+    // Referenced by the keys of existing entries.
+    std::shared_ptr<const BtreeNode> existing_node;
+    std::string existing_prefix;
+
+    // Referenced by the keys of new interior node entries.
+    std::vector<InteriorNodeMutation> mutations;
+
+    BtreeNodeEncoder<Entry> encoder;
+  };
+
+  // Same as `UpdateParent`, but encodes the nodes from `state->encoder`.
+  //
+  // If the entries are split into more than one node, each node is encoded
+  // by a separate task on `IoHandle::executor` and written as soon as it has
+  // been encoded, rather than encoding all of the nodes in sequence.
+  //
+  // Args:
+  //   parent_state: Parent to modify.
+  //   existing_relative_child_key: Key of existing child to replace.
+  //   state: Encoder containing the entries of the new children.
+  //   may_be_root: Whether the updated node may be the root node.
+  template <typename Entry>
+  static void EncodeNodesAndUpdateParent(
+      NodeTraversalState::Ptr parent_state,
+      std::string_view existing_relative_child_key,
+      std::shared_ptr<NodeEncodingState<Entry>> state, bool may_be_root);
+
+  // Sorts `mutations` by key order, with deletions before additions.
+  static void SortInteriorNodeMutations(span<InteriorNodeMutation> mutations);
+
+  // Adds to `encoder` the entries of an interior node with the specified
+  // `mutations` applied.
+  //
+  // Args:
+  //   encoder: Encoder to which the entries are added.
+  //   existing_prefix: Key prefix that applies to `existing_entries`.
+  //   existing_entries: Existing children of the node.
+  //   mutations: Mutations to apply.
+  static void AddUpdatedInteriorEntries(
+      BtreeInteriorNodeEncoder& encoder, std::string_view existing_prefix,
+      span<const InteriorNodeEntry> existing_entries,
+      span<InteriorNodeMutation> mutations);
+
   // Applies mutations to an interior node.
   //
   // Args:
@@ -914,8 +986,10 @@ void BtreeWriterCommitOperation<MutationEntry>::VisitLeafNode(
     existing_entries =
         std::get<BtreeNode::LeafNodeEntries>(params.node->entries);
   }
-  BtreeLeafNodeEncoder encoder(params.parent_state->writer_->existing_config(),
-                               /*height=*/0, params.full_prefix);
+  auto state = std::make_shared<NodeEncodingState<LeafNodeEntry>>(
+      params.parent_state->writer_->existing_config(), /*height=*/0,
+      params.node, params.full_prefix);
+  auto& encoder = state->encoder;
   ComparePrefixedKeyToUnprefixedKey compare_existing_and_new_keys{
       params.full_prefix};
   bool modified = false;
@@ -1024,8 +1098,10 @@ void BtreeWriterCommitOperation<MutationEntry>::VisitLeafNode(
     encoder.AddEntry(/*existing=*/true, LeafNodeEntry(*existing_it));
   }
 
-  UpdateParent(*params.parent_state, params.inclusive_min_key_suffix,
-               encoder.Finalize(params.parent_state->is_root_parent()));
+  const bool may_be_root = params.parent_state->is_root_parent();
+  EncodeNodesAndUpdateParent<LeafNodeEntry>(
+      std::move(params.parent_state), params.inclusive_min_key_suffix,
+      std::move(state), may_be_root);
 }
 
 }  // namespace internal_ocdbt
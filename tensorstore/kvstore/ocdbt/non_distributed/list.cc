@@ -15,8 +15,10 @@
 #include "tensorstore/kvstore/ocdbt/non_distributed/list.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -26,6 +28,7 @@
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -34,6 +37,7 @@
 #include "tensorstore/kvstore/ocdbt/format/manifest.h"
 #include "tensorstore/kvstore/ocdbt/format/version_tree.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
+#include "tensorstore/kvstore/ocdbt/non_distributed/storage_generation.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/util/execution/any_receiver.h"
@@ -65,10 +69,13 @@ using ::tensorstore::kvstore::ListReceiver;
 // 2. Recursively descend the tree in parallel, reading all nodes that
 //    intersect the key range specified in `list_options`.
 //
-// 3. Emit matching leaf-node keys to the receiver.
+// 3. Emit matching leaf-node keys to the receiver, in no particular order.
 //
-// TODO(jbms): Currently memory usage is not bounded.  That needs to be
-// addressed, e.g. by limiting the number of in-flight nodes.
+// If `max_concurrent_node_reads` is non-zero, at most that many nodes are read
+// concurrently.  Nodes that are not yet read are then visited depth first, such
+// that the number of pending nodes, and therefore the memory usage, is bounded
+// by the product of the height of the tree and the maximum number of children
+// of a node.  Otherwise, memory usage is not bounded.
 struct ListOperation
     : public internal::FlowSenderOperationState<std::string_view,
                                                 span<const LeafNodeEntry>> {
@@ -78,8 +85,22 @@ struct ListOperation
 
   using Base::Base;
 
+  // Node that is not yet read due to `max_concurrent_node_reads`.
+  struct PendingVisit {
+    BtreeNodeReference node_ref;
+    BtreeNodeHeight node_height;
+    std::string inclusive_min_key;
+    KeyLength subtree_common_prefix_length;
+  };
+
   ReadonlyIoHandle::Ptr io_handle;
   KeyRange range;
+  size_t max_concurrent_node_reads = 0;
+
+  absl::Mutex mutex;
+  size_t num_node_reads_in_flight ABSL_GUARDED_BY(mutex) = 0;
+  // Visited in last-in, first-out order.
+  std::vector<PendingVisit> pending_visits ABSL_GUARDED_BY(mutex);
 
   // Prepares the asynchronous list operation.
   //
@@ -87,11 +108,15 @@ struct ListOperation
   //   io_handle: I/O handle to use.
   //   range: Key range constraint.
   //   receiver: Receiver of the results.
+  //   max_concurrent_node_reads: Maximum number of concurrent node reads, or
+  //     0 for no limit.
   static Ptr Initialize(ReadonlyIoHandle::Ptr&& io_handle, KeyRange&& range,
-                        BaseReceiver&& receiver) {
+                        BaseReceiver&& receiver,
+                        size_t max_concurrent_node_reads = 0) {
     auto op = internal::MakeIntrusivePtr<ListOperation>(std::move(receiver));
     op->io_handle = std::move(io_handle);
     op->range = std::move(range);
+    op->max_concurrent_node_reads = max_concurrent_node_reads;
     return op;
   }
 
@@ -135,6 +160,25 @@ struct ListOperation
         << ", subtree_common_prefix_length=" << subtree_common_prefix_length
         << ", inclusive_min_key=" << tensorstore::QuoteString(inclusive_min_key)
         << ", key_range=" << op->range;
+    if (op->max_concurrent_node_reads != 0) {
+      absl::MutexLock lock(&op->mutex);
+      if (op->num_node_reads_in_flight == op->max_concurrent_node_reads) {
+        op->pending_visits.push_back(
+            PendingVisit{node_ref, node_height, std::move(inclusive_min_key),
+                         subtree_common_prefix_length});
+        return;
+      }
+      ++op->num_node_reads_in_flight;
+    }
+    ReadNode(std::move(op), node_ref, node_height, std::move(inclusive_min_key),
+             subtree_common_prefix_length);
+  }
+
+  static void ReadNode(ListOperation::Ptr op,
+                       const BtreeNodeReference& node_ref,
+                       BtreeNodeHeight node_height,
+                       std::string inclusive_min_key,
+                       KeyLength subtree_common_prefix_length) {
     auto* op_ptr = op.get();
     Link(WithExecutor(op_ptr->io_handle->executor,
                       NodeReadyCallback{std::move(op), node_height,
@@ -143,6 +187,29 @@ struct ListOperation
          op_ptr->promise, op_ptr->io_handle->GetBtreeNode(node_ref.location));
   }
 
+  // Called when a node read started by `ReadNode` completes, after any
+  // children of the node have been visited.
+  void NodeReadDone() {
+    if (max_concurrent_node_reads == 0) return;
+    std::vector<PendingVisit> visits;
+    {
+      absl::MutexLock lock(&mutex);
+      --num_node_reads_in_flight;
+      if (cancelled()) return;
+      while (num_node_reads_in_flight < max_concurrent_node_reads &&
+             !pending_visits.empty()) {
+        visits.push_back(std::move(pending_visits.back()));
+        pending_visits.pop_back();
+        ++num_node_reads_in_flight;
+      }
+    }
+    for (auto& visit : visits) {
+      ReadNode(ListOperation::Ptr(this), visit.node_ref, visit.node_height,
+               std::move(visit.inclusive_min_key),
+               visit.subtree_common_prefix_length);
+    }
+  }
+
   // Called when a B+tree node lookup completes.
   struct NodeReadyCallback {
     ListOperation::Ptr op;
@@ -161,6 +228,13 @@ struct ListOperation
     void operator()(
         Promise<void> promise,
         ReadyFuture<const std::shared_ptr<const BtreeNode>> read_future) {
+      ListOperation::Ptr self = op;
+      VisitNode(std::move(read_future));
+      self->NodeReadDone();
+    }
+
+    void VisitNode(
+        ReadyFuture<const std::shared_ptr<const BtreeNode>> read_future) {
       TENSORSTORE_ASSIGN_OR_RETURN(auto node, read_future.result(),
                                    op->SetError(_));
       if (op->cancelled()) return;
@@ -257,6 +331,7 @@ struct KeyReceiverAdapter {
                            ListEntry{
                                std::move(key),
                                ListEntry::checked_size(entry.value_size()),
+                               ComputeStorageGeneration(entry.value_reference),
                            });
     }
   }
@@ -269,13 +344,156 @@ struct KeyReceiverAdapter {
   void set_stopping() { execution::set_stopping(receiver); }
 };
 
+// Asynchronous operation state used to implement
+// `NonDistributedGetKeyRangeStatistics`.
+//
+// The tree is descended as for `ListOperation`, except that the statistics
+// stored in the parent node are used for subtrees that are entirely contained
+// in the key range, rather than reading them.  Consequently, only the nodes
+// that intersect the bounds of the key range are read.
+struct KeyRangeStatisticsOperation
+    : public internal::AtomicReferenceCount<KeyRangeStatisticsOperation> {
+  using Ptr = internal::IntrusivePtr<KeyRangeStatisticsOperation>;
+
+  ReadonlyIoHandle::Ptr io_handle;
+  KeyRange range;
+  Promise<KeyRangeStatistics> promise;
+  std::atomic<uint64_t> num_keys{0};
+  std::atomic<uint64_t> num_indirect_value_bytes{0};
+
+  // The result is set once all node reads have completed, unless an error
+  // occurred.
+  ~KeyRangeStatisticsOperation() {
+    promise.SetResult(KeyRangeStatistics{num_keys.load(),
+                                         num_indirect_value_bytes.load()});
+  }
+
+  // Called when the manifest lookup has completed.
+  struct ManifestReadyCallback {
+    KeyRangeStatisticsOperation::Ptr op;
+    void operator()(Promise<KeyRangeStatistics> promise,
+                    ReadyFuture<const ManifestWithTime> read_future) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto manifest_with_time,
+                                   read_future.result(),
+                                   static_cast<void>(promise.SetResult(_)));
+      const auto* manifest = manifest_with_time.manifest.get();
+      if (!manifest || manifest->latest_version().root.location.IsMissing()) {
+        // Manifest not present or btree is empty.
+        return;
+      }
+      auto& latest_version = manifest->versions.back();
+      VisitSubtree(std::move(op), latest_version.root,
+                   latest_version.root_height,
+                   /*inclusive_min_key=*/{},
+                   /*subtree_common_prefix_length=*/0,
+                   /*exclusive_max_key=*/{});
+    }
+  };
+
+  // Accumulates the statistics of a subtree within the key range.
+  //
+  // Args:
+  //   op: Operation state.
+  //   node_ref: Reference to the root of the subtree.
+  //   node_height: Height of the node.
+  //   inclusive_min_key: Full inclusive min key for the node.
+  //   subtree_common_prefix_length: Length of the implicit prefix of
+  //     `inclusive_min_key` that is excluded from the encoded node.
+  //   exclusive_max_key: Full exclusive max key for the node, or empty if
+  //     there is no upper bound.
+  static void VisitSubtree(KeyRangeStatisticsOperation::Ptr op,
+                           const BtreeNodeReference& node_ref,
+                           BtreeNodeHeight node_height,
+                           std::string inclusive_min_key,
+                           KeyLength subtree_common_prefix_length,
+                           std::string exclusive_max_key) {
+    if (Contains(op->range, KeyRange(inclusive_min_key, exclusive_max_key))) {
+      op->num_keys.fetch_add(node_ref.statistics.num_keys);
+      op->num_indirect_value_bytes.fetch_add(
+          node_ref.statistics.num_indirect_value_bytes);
+      return;
+    }
+    auto* op_ptr = op.get();
+    Link(WithExecutor(op_ptr->io_handle->executor,
+                      NodeReadyCallback{std::move(op), node_height,
+                                        std::move(inclusive_min_key),
+                                        subtree_common_prefix_length,
+                                        std::move(exclusive_max_key)}),
+         op_ptr->promise, op_ptr->io_handle->GetBtreeNode(node_ref.location));
+  }
+
+  // Called when a B+tree node lookup completes.
+  struct NodeReadyCallback {
+    KeyRangeStatisticsOperation::Ptr op;
+    BtreeNodeHeight node_height;
+    std::string inclusive_min_key;
+    KeyLength subtree_common_prefix_length;
+    std::string exclusive_max_key;
+
+    void operator()(
+        Promise<KeyRangeStatistics> promise,
+        ReadyFuture<const std::shared_ptr<const BtreeNode>> read_future) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto node, read_future.result(),
+                                   static_cast<void>(promise.SetResult(_)));
+      TENSORSTORE_RETURN_IF_ERROR(
+          ValidateBtreeNodeReference(*node, node_height,
+                                     std::string_view(inclusive_min_key)
+                                         .substr(subtree_common_prefix_length)),
+          static_cast<void>(promise.SetResult(_)));
+      auto& subtree_key_prefix = inclusive_min_key;
+      subtree_key_prefix.resize(subtree_common_prefix_length);
+      subtree_key_prefix += node->key_prefix;
+      auto key_range = KeyRange::RemovePrefix(subtree_key_prefix, op->range);
+
+      if (node->height == 0) {
+        auto entries = FindBtreeEntryRange(
+            std::get<BtreeNode::LeafNodeEntries>(node->entries),
+            key_range.inclusive_min, key_range.exclusive_max);
+        uint64_t num_indirect_value_bytes = 0;
+        for (const auto& entry : entries) {
+          if (auto* data_ref =
+                  std::get_if<IndirectDataReference>(&entry.value_reference)) {
+            num_indirect_value_bytes += data_ref->length;
+          }
+        }
+        op->num_keys.fetch_add(entries.size());
+        op->num_indirect_value_bytes.fetch_add(num_indirect_value_bytes);
+        return;
+      }
+
+      auto& all_entries =
+          std::get<BtreeNode::InteriorNodeEntries>(node->entries);
+      auto entries = FindBtreeEntryRange(all_entries, key_range.inclusive_min,
+                                         key_range.exclusive_max);
+      for (const auto& entry : entries) {
+        // The subtree of each entry ends where the subtree of the next entry
+        // begins.
+        const InteriorNodeEntry* next_entry = &entry + 1;
+        std::string child_exclusive_max_key =
+            next_entry == all_entries.data() + all_entries.size()
+                ? exclusive_max_key
+                : tensorstore::StrCat(subtree_key_prefix, next_entry->key);
+        VisitSubtree(
+            op, entry.node, node->height - 1,
+            /*inclusive_min_key=*/
+            tensorstore::StrCat(subtree_key_prefix, entry.key),
+            /*subtree_common_prefix_length=*/subtree_key_prefix.size() +
+                entry.subtree_common_prefix_length,
+            std::move(child_exclusive_max_key));
+      }
+    }
+  };
+};
+
 }  // namespace
 
 void NonDistributedList(ReadonlyIoHandle::Ptr io_handle,
-                        kvstore::ListOptions options, ListReceiver&& receiver) {
+                        kvstore::ListOptions options, ListReceiver&& receiver,
+                        size_t max_concurrent_node_reads) {
   auto op = ListOperation::Initialize(
       std::move(io_handle), std::move(options.range),
-      KeyReceiverAdapter{std::move(receiver), options.strip_prefix_length});
+      KeyReceiverAdapter{std::move(receiver), options.strip_prefix_length},
+      max_concurrent_node_reads);
   auto* op_ptr = op.get();
   Link(WithExecutor(op_ptr->io_handle->executor,
                     ListOperation::ManifestReadyCallback{std::move(op)}),
@@ -297,5 +515,21 @@ void NonDistributedListSubtree(
                               subtree_common_prefix_length);
 }
 
+Future<KeyRangeStatistics> NonDistributedGetKeyRangeStatistics(
+    ReadonlyIoHandle::Ptr io_handle, KeyRange range,
+    absl::Time staleness_bound) {
+  auto op = internal::MakeIntrusivePtr<KeyRangeStatisticsOperation>();
+  op->io_handle = std::move(io_handle);
+  op->range = std::move(range);
+  auto [promise, future] = PromiseFuturePair<KeyRangeStatistics>::Make();
+  op->promise = promise;
+  auto* op_ptr = op.get();
+  Link(WithExecutor(
+           op_ptr->io_handle->executor,
+           KeyRangeStatisticsOperation::ManifestReadyCallback{std::move(op)}),
+       std::move(promise), op_ptr->io_handle->GetManifest(staleness_bound));
+  return std::move(future);
+}
+
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
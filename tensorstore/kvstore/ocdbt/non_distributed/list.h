@@ -15,23 +15,70 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_LIST_H_
 #define TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_LIST_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
 #include <string_view>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/util/execution/any_receiver.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace internal_ocdbt {
 
+/// Lists the keys of the latest version of the B+tree.
+///
+/// All children of an interior node that intersect `options.range` are read in
+/// parallel, and keys are emitted in no particular order.
+///
+/// \param max_concurrent_node_reads Maximum number of B+tree nodes read
+///     concurrently, or `0` for no limit.
 void NonDistributedList(ReadonlyIoHandle::Ptr io_handle,
                         kvstore::ListOptions options,
-                        kvstore::ListReceiver&& receiver);
+                        kvstore::ListReceiver&& receiver,
+                        size_t max_concurrent_node_reads = 0);
+
+/// Statistics of the keys within a key range.
+struct KeyRangeStatistics {
+  /// Number of keys.
+  uint64_t num_keys = 0;
+
+  /// Sum of the lengths of the values that are not stored inline.
+  uint64_t num_indirect_value_bytes = 0;
+
+  friend bool operator==(const KeyRangeStatistics& a,
+                         const KeyRangeStatistics& b) {
+    return a.num_keys == b.num_keys &&
+           a.num_indirect_value_bytes == b.num_indirect_value_bytes;
+  }
+  friend bool operator!=(const KeyRangeStatistics& a,
+                         const KeyRangeStatistics& b) {
+    return !(a == b);
+  }
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.num_keys, x.num_indirect_value_bytes);
+  };
+};
+
+/// Computes the statistics of the keys of the latest version of the B+tree
+/// that are within `range`.
+///
+/// The statistics stored in interior nodes are used for subtrees entirely
+/// contained in `range`, such that only the nodes intersecting the bounds of
+/// `range` are read, and leaf nodes in the interior of `range` are not
+/// visited.
+Future<KeyRangeStatistics> NonDistributedGetKeyRangeStatistics(
+    ReadonlyIoHandle::Ptr io_handle, KeyRange range,
+    absl::Time staleness_bound = absl::InfiniteFuture());
 
 void NonDistributedListSubtree(
     ReadonlyIoHandle::Ptr io_handle, const BtreeNodeReference& node_ref,
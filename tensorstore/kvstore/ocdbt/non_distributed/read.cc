@@ -16,23 +16,30 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/type_traits.h"
+#include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/ocdbt/format/bloom_filter.h"
 #include "tensorstore/kvstore/ocdbt/format/btree.h"
 #include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
 #include "tensorstore/kvstore/ocdbt/format/manifest.h"
@@ -45,6 +52,7 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/status.h"
 
 namespace tensorstore {
@@ -225,6 +233,15 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
         << ", subtree_common_prefix_length="
         << entry->subtree_common_prefix_length;
 
+    if (!BloomFilterMayContain(entry->node.bloom_filter,
+                               unmatched_key_suffix.substr(
+                                   entry->subtree_common_prefix_length))) {
+      // The Bloom filter of the leaf node excludes the key, so the leaf node
+      // need not be read.
+      op->KeyNotPresent(promise);
+      return;
+    }
+
     op->matched_length += entry->subtree_common_prefix_length;
     LookupNodeReference(std::move(op), std::move(promise), entry->node,
                         node.height - 1, entry->key_suffix());
@@ -284,6 +301,263 @@ struct ReadOperation : public internal::AtomicReferenceCount<ReadOperation> {
   }
 };
 
+// Asynchronous operation state used to implement
+// `internal_ocdbt::NonDistributedReadBatch`.
+//
+// The B+tree is traversed breadth-first, one level at a time:
+//
+// 1. Resolve the root b+tree node by reading the manifest.
+//
+// 2. Request all of the nodes needed at the current level within a single
+//    batch, and wait for all of them to become ready.
+//
+// 3. Partition the requests of each node among its children, or, for leaf
+//    nodes, resolve them directly or via `ReadonlyIoHandle::ReadIndirectData`
+//    using a single batch shared by all of the leaf nodes.
+struct BatchReadOperation
+    : public internal::AtomicReferenceCount<BatchReadOperation> {
+  using Ptr = internal::IntrusivePtr<BatchReadOperation>;
+  using Request = NonDistributedReadRequest;
+  ReadonlyIoHandle::Ptr io_handle;
+  // Requests, sorted by key.
+  std::vector<Request> requests;
+  absl::Time time;
+
+  // Pending lookup of a single node.
+  struct NodeLookup {
+    IndirectDataReference location;
+    BtreeNodeHeight height;
+    // Lower bound of the key range corresponding to the node.
+    std::string inclusive_min_key;
+    // Length of the implicit prefix of the node.
+    size_t matched_length;
+    // Indices into `requests` of the requests for keys that may be contained
+    // in the node, in increasing order.
+    std::vector<size_t> request_indices;
+  };
+
+  static void Start(
+      ReadonlyIoHandle::Ptr io_handle,
+      internal_kvstore_batch::RequestBatch<Request>&& request_batch) {
+    auto op = internal::MakeIntrusivePtr<BatchReadOperation>();
+    op->io_handle = std::move(io_handle);
+    op->requests.assign(
+        std::make_move_iterator(request_batch.requests.begin()),
+        std::make_move_iterator(request_batch.requests.end()));
+    std::stable_sort(op->requests.begin(), op->requests.end(),
+                     [](const Request& a, const Request& b) {
+                       return std::get<kvstore::Key>(a) <
+                              std::get<kvstore::Key>(b);
+                     });
+    auto* op_ptr = op.get();
+    op_ptr->io_handle->GetManifest(request_batch.staleness_bound)
+        .ExecuteWhenReady(WithExecutor(
+            op_ptr->io_handle->executor,
+            [op = std::move(op)](
+                ReadyFuture<const ManifestWithTime> future) mutable {
+              ManifestReady(std::move(op), future.result());
+            }));
+  }
+
+  static void ManifestReady(
+      BatchReadOperation::Ptr op,
+      const Result<ManifestWithTime>& manifest_with_time) {
+    if (!manifest_with_time.ok()) {
+      internal_kvstore_batch::SetCommonResult(op->requests,
+                                              manifest_with_time.status());
+      return;
+    }
+    op->time = manifest_with_time->time;
+    auto* manifest = manifest_with_time->manifest.get();
+    if (!manifest || manifest->latest_version().root.location.IsMissing()) {
+      // Manifest not preset or btree is empty.
+      internal_kvstore_batch::SetCommonResult(
+          op->requests, kvstore::ReadResult::Missing(op->time));
+      return;
+    }
+    auto& latest_version = manifest->versions.back();
+    std::vector<NodeLookup> lookups(1);
+    auto& lookup = lookups[0];
+    lookup.location = latest_version.root.location;
+    lookup.height = latest_version.root_height;
+    lookup.matched_length = 0;
+    lookup.request_indices.resize(op->requests.size());
+    std::iota(lookup.request_indices.begin(), lookup.request_indices.end(),
+              size_t(0));
+    ReadLevel(std::move(op), std::move(lookups));
+  }
+
+  // Requests all of the nodes specified by `lookups` as a single batch.
+  static void ReadLevel(BatchReadOperation::Ptr op,
+                        std::vector<NodeLookup> lookups) {
+    if (lookups.empty()) return;
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "ReadBatch: height=" << static_cast<int>(lookups[0].height)
+        << ", num_nodes=" << lookups.size();
+    std::vector<Future<const std::shared_ptr<const BtreeNode>>> node_futures;
+    node_futures.reserve(lookups.size());
+    {
+      Batch batch = Batch::New();
+      for (const auto& lookup : lookups) {
+        node_futures.push_back(
+            op->io_handle->GetBtreeNode(lookup.location, batch));
+      }
+    }
+    auto all_ready = WaitAllFuture(span(node_futures));
+    auto executor = op->io_handle->executor;
+    std::move(all_ready).ExecuteWhenReady(WithExecutor(
+        std::move(executor),
+        [op = std::move(op), lookups = std::move(lookups),
+         node_futures = std::move(node_futures)](
+            ReadyFuture<void> future) mutable {
+          LevelReady(std::move(op), lookups, node_futures);
+        }));
+  }
+
+  // Called once all of the nodes of a level are ready.
+  static void LevelReady(
+      BatchReadOperation::Ptr op, span<const NodeLookup> lookups,
+      span<const Future<const std::shared_ptr<const BtreeNode>>>
+          node_futures) {
+    std::vector<NodeLookup> next_lookups;
+    {
+      // Batch used for reading all indirectly-stored values referenced by
+      // leaf nodes of this level.
+      Batch value_batch = Batch::New();
+      for (size_t i = 0; i < lookups.size(); ++i) {
+        VisitNode(*op, lookups[i], node_futures[i].result(), next_lookups,
+                  value_batch);
+      }
+    }
+    ReadLevel(std::move(op), std::move(next_lookups));
+  }
+
+  void SetResultForLookup(const NodeLookup& lookup,
+                          const Result<kvstore::ReadResult>& result) {
+    for (size_t request_i : lookup.request_indices) {
+      std::get<internal_kvstore_batch::ByteRangeReadRequest>(
+          requests[request_i])
+          .promise.SetResult(result);
+    }
+  }
+
+  void KeyNotPresent(Request& request) {
+    std::get<internal_kvstore_batch::ByteRangeReadRequest>(request)
+        .promise.SetResult(kvstore::ReadResult::Missing(time));
+  }
+
+  static void VisitNode(
+      BatchReadOperation& op, const NodeLookup& lookup,
+      const Result<std::shared_ptr<const BtreeNode>>& node_result,
+      std::vector<NodeLookup>& next_lookups, Batch::View value_batch) {
+    if (!node_result.ok()) {
+      op.SetResultForLookup(lookup, node_result.status());
+      return;
+    }
+    const auto& node = **node_result;
+    if (auto status = ValidateBtreeNodeReference(node, lookup.height,
+                                                 lookup.inclusive_min_key);
+        !status.ok()) {
+      op.SetResultForLookup(lookup, status);
+      return;
+    }
+    const size_t matched_length =
+        lookup.matched_length + node.key_prefix.size();
+    // Child entry to which the previous request was assigned.
+    const InteriorNodeEntry* prev_entry = nullptr;
+    for (size_t request_i : lookup.request_indices) {
+      auto& request = op.requests[request_i];
+      auto unmatched_key_suffix =
+          std::string_view(std::get<kvstore::Key>(request))
+              .substr(lookup.matched_length);
+      if (!absl::StartsWith(unmatched_key_suffix, node.key_prefix)) {
+        op.KeyNotPresent(request);
+        continue;
+      }
+      unmatched_key_suffix.remove_prefix(node.key_prefix.size());
+      if (node.height == 0) {
+        op.VisitLeafEntry(request, node, unmatched_key_suffix, value_batch);
+        continue;
+      }
+      auto* entry = FindBtreeEntry(
+          std::get<BtreeNode::InteriorNodeEntries>(node.entries),
+          unmatched_key_suffix);
+      if (!entry ||
+          !absl::StartsWith(unmatched_key_suffix,
+                            std::string_view(entry->key).substr(
+                                0, entry->subtree_common_prefix_length)) ||
+          !BloomFilterMayContain(entry->node.bloom_filter,
+                                 unmatched_key_suffix.substr(
+                                     entry->subtree_common_prefix_length))) {
+        op.KeyNotPresent(request);
+        continue;
+      }
+      // Since the requests are sorted by key, all requests assigned to a given
+      // child are consecutive.
+      if (entry != prev_entry) {
+        prev_entry = entry;
+        auto& child_lookup = next_lookups.emplace_back();
+        child_lookup.location = entry->node.location;
+        child_lookup.height = node.height - 1;
+        child_lookup.inclusive_min_key = std::string(entry->key_suffix());
+        child_lookup.matched_length =
+            matched_length + entry->subtree_common_prefix_length;
+      }
+      next_lookups.back().request_indices.push_back(request_i);
+    }
+  }
+
+  void VisitLeafEntry(Request& request, const BtreeNode& node,
+                      std::string_view unmatched_key_suffix,
+                      Batch::View value_batch) {
+    auto* entry =
+        FindBtreeEntry(std::get<BtreeNode::LeafNodeEntries>(node.entries),
+                       unmatched_key_suffix);
+    if (!entry) {
+      KeyNotPresent(request);
+      return;
+    }
+    TimestampedStorageGeneration stamp{
+        internal_ocdbt::ComputeStorageGeneration(entry->value_reference),
+        time};
+    if (!internal_kvstore_batch::ValidateRequestGeneration(request, stamp)) {
+      return;
+    }
+    auto& byte_range_request =
+        std::get<internal_kvstore_batch::ByteRangeReadRequest>(request);
+    if (auto* direct_value = std::get_if<absl::Cord>(&entry->value_reference)) {
+      // Value stored directly in btree node.
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          auto byte_range,
+          byte_range_request.byte_range.Validate(direct_value->size()),
+          static_cast<void>(byte_range_request.promise.SetResult(_)));
+      byte_range_request.promise.SetResult(kvstore::ReadResult::Value(
+          internal::GetSubCord(*direct_value, byte_range), std::move(stamp)));
+      return;
+    }
+
+    // Value stored indirectly.
+    auto& indirect_ref =
+        std::get<IndirectDataReference>(entry->value_reference);
+    kvstore::ReadOptions read_options;
+    read_options.byte_range = byte_range_request.byte_range;
+    read_options.batch = value_batch;
+    ABSL_LOG_IF(INFO, ocdbt_logging)
+        << "Reading "
+        << tensorstore::QuoteString(std::get<kvstore::Key>(request)) << " from "
+        << indirect_ref;
+    LinkValue(
+        [stamp = std::move(stamp)](
+            Promise<kvstore::ReadResult> promise,
+            ReadyFuture<kvstore::ReadResult> read_future) mutable {
+          promise.SetResult(kvstore::ReadResult::Value(
+              std::move(read_future.result()->value), std::move(stamp)));
+        },
+        byte_range_request.promise,
+        io_handle->ReadIndirectData(indirect_ref, std::move(read_options)));
+  }
+};
+
 }  // namespace
 
 Future<kvstore::ReadResult> NonDistributedRead(ReadonlyIoHandle::Ptr io_handle,
@@ -293,5 +567,12 @@ Future<kvstore::ReadResult> NonDistributedRead(ReadonlyIoHandle::Ptr io_handle,
                               std::move(options));
 }
 
+void NonDistributedReadBatch(
+    ReadonlyIoHandle::Ptr io_handle,
+    internal_kvstore_batch::RequestBatch<NonDistributedReadRequest>
+        request_batch) {
+  BatchReadOperation::Start(std::move(io_handle), std::move(request_batch));
+}
+
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_READ_H_
 #define TENSORSTORE_KVSTORE_OCDBT_NON_DISTRIBUTED_READ_H_
 
+#include "tensorstore/kvstore/batch_util.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/ocdbt/io_handle.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
@@ -27,6 +29,28 @@ Future<kvstore::ReadResult> NonDistributedRead(ReadonlyIoHandle::Ptr io_handle,
                                                kvstore::Key key,
                                                kvstore::ReadOptions options);
 
+/// Individual request within a batch of reads passed to
+/// `NonDistributedReadBatch`.
+using NonDistributedReadRequest =
+    internal_kvstore_batch::ReadRequest<kvstore::Key,
+                                        kvstore::ReadGenerationConditions>;
+
+/// Reads multiple keys from the same database.
+///
+/// Rather than descending the B+tree separately for each key, the tree is
+/// traversed one level at a time: all of the nodes required at a given level
+/// are requested concurrently in a single batch, and all of the indirectly
+/// stored values are likewise read in a single batch, which allows the
+/// underlying kvstore to coalesce them.  The number of sequential round trips
+/// is therefore bounded by the height of the tree rather than by the number of
+/// keys times the height.
+///
+/// The result of each request is set on its promise.
+void NonDistributedReadBatch(
+    ReadonlyIoHandle::Ptr io_handle,
+    internal_kvstore_batch::RequestBatch<NonDistributedReadRequest>
+        request_batch);
+
 }  // namespace internal_ocdbt
 }  // namespace tensorstore
 
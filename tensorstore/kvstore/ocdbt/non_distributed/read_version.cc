@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
 
@@ -222,6 +223,9 @@ struct ReadVersionOperation
       op->VersionNotPresent(std::move(promise));
       return;
     }
+    if (auto& cache = op->io_handle->version_root_cache) {
+      cache->Insert(*ref);
+    }
     promise.SetResult(*ref);
   }
 };
@@ -237,6 +241,11 @@ Future<BtreeGenerationReference> ReadVersion(ReadonlyIoHandle::Ptr io_handle,
       return absl::InvalidArgumentError("Generation number must be positive");
     }
   }
+  if (io_handle->version_root_cache) {
+    if (auto ref = io_handle->version_root_cache->Find(version_spec)) {
+      return MakeReadyFuture<BtreeGenerationReference>(*std::move(ref));
+    }
+  }
   return ReadVersionOperation::Start(std::move(io_handle), version_spec,
                                      std::move(staleness_bound));
 }
@@ -220,7 +220,7 @@ void BtreeWriterTransactionNode::StagePending(WriteStager& stager) {
     if (base_entry.entry_type() != kReadModifyWrite) continue;
     auto& entry = static_cast<ReadModifyWriteEntry&>(base_entry);
     if (entry.value_state_ != kvstore::ReadResult::kValue) continue;
-    stager.Stage(entry.value_);
+    stager.Stage(entry.key_, entry.value_);
   }
 }
 
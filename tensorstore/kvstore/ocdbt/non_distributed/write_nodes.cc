@@ -32,23 +32,30 @@
 namespace tensorstore {
 namespace internal_ocdbt {
 
+InteriorNodeEntryData<std::string> WriteNode(const IoHandle& io_handle,
+                                             FlushPromise& flush_promise,
+                                             EncodedNode encoded_node) {
+  InteriorNodeEntryData<std::string> new_entry;
+  flush_promise.Link(io_handle.WriteData(IndirectDataKind::kBtreeNode,
+                                         std::move(encoded_node.encoded_node),
+                                         new_entry.node.location));
+  new_entry.key = std::move(encoded_node.info.inclusive_min_key);
+  new_entry.node.statistics = encoded_node.info.statistics;
+  new_entry.node.bloom_filter = std::move(encoded_node.info.bloom_filter);
+  new_entry.subtree_common_prefix_length =
+      encoded_node.info.excluded_prefix_length;
+  return new_entry;
+}
+
 std::vector<InteriorNodeEntryData<std::string>> WriteNodes(
     const IoHandle& io_handle, FlushPromise& flush_promise,
     std::vector<EncodedNode> encoded_nodes) {
-  std::vector<InteriorNodeEntryData<std::string>> new_entries(
-      encoded_nodes.size());
-  for (size_t i = 0; i < encoded_nodes.size(); ++i) {
-    auto& encoded_node = encoded_nodes[i];
-    auto& new_entry = new_entries[i];
-    flush_promise.Link(io_handle.WriteData(IndirectDataKind::kBtreeNode,
-                                           std::move(encoded_node.encoded_node),
-                                           new_entry.node.location));
-    new_entry.key = std::move(encoded_node.info.inclusive_min_key);
-    new_entry.node.statistics = encoded_node.info.statistics;
-    new_entry.subtree_common_prefix_length =
-        encoded_node.info.excluded_prefix_length;
+  std::vector<InteriorNodeEntryData<std::string>> new_entries;
+  new_entries.reserve(encoded_nodes.size());
+  for (auto& encoded_node : encoded_nodes) {
+    new_entries.push_back(
+        WriteNode(io_handle, flush_promise, std::move(encoded_node)));
   }
-
   return new_entries;
 }
 
@@ -66,6 +73,9 @@ Result<BtreeGenerationReference> WriteRootNode(
       } else {
         new_generation.root_height = height;
         new_generation.root = new_entries[0].node;
+        // The version tree does not store Bloom filters for root nodes, and a
+        // root node must always be read anyway.
+        new_generation.root.bloom_filter.clear();
       }
       return new_generation;
     }
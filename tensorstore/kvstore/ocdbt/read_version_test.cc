@@ -130,6 +130,31 @@ void TestVersioning(::nlohmann::json config_json, size_t num_writes) {
     }
   }
 
+  // Test that the versions found in the version tree were cached, so that
+  // subsequent reads at the same version skip the version tree traversal.
+  {
+    auto& cache = io_handle->version_root_cache;
+    ASSERT_TRUE(cache);
+    size_t num_tree_versions = 0;
+    for (const auto& version : generations) {
+      if (version.generation_number >=
+          manifest->versions.front().generation_number) {
+        EXPECT_FALSE(cache->Find(version.generation_number));
+        continue;
+      }
+      ++num_tree_versions;
+      EXPECT_THAT(cache->Find(version.generation_number),
+                  ::testing::Optional(version));
+      EXPECT_THAT(cache->Find(version.commit_time),
+                  ::testing::Optional(version));
+      EXPECT_FALSE(cache->Find(CommitTimeUpperBound{version.commit_time}));
+      EXPECT_THAT(ReadVersion(io_handle, version.generation_number).result(),
+                  ::testing::Optional(version));
+    }
+    EXPECT_LT(0, num_tree_versions);
+    EXPECT_EQ(num_tree_versions, cache->size());
+  }
+
   // Test that reading generation 0 fails.
   EXPECT_THAT(ReadVersion(io_handle, GenerationNumber(0)).result(),
               MatchesStatus(absl::StatusCode::kInvalidArgument));
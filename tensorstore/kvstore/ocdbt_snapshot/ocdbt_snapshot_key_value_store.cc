@@ -0,0 +1,453 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "tensorstore/context.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/data_copy_concurrency_resource.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/path.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/driver.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/format/btree.h"
+#include "tensorstore/kvstore/ocdbt/format/indirect_data_reference.h"
+#include "tensorstore/kvstore/ocdbt/format/snapshot_index.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/execution.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/garbage_collection/fwd.h"
+#include "tensorstore/util/quote_string.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+/// specializations
+#include "tensorstore/serialization/serialization.h"  // IWYU pragma: keep
+
+using ::tensorstore::internal_ocdbt::IndirectDataReference;
+using ::tensorstore::internal_ocdbt::SnapshotIndex;
+using ::tensorstore::internal_ocdbt::SnapshotIndexEntry;
+using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore::kvstore::ListReceiver;
+
+namespace tensorstore {
+namespace {
+
+namespace jb = tensorstore::internal_json_binding;
+
+/// Cache used for reading the snapshot index.
+///
+/// The entire index is decoded by a single read, after which the location of
+/// every value is known.
+class SnapshotIndexCache : public internal::AsyncCache {
+  using Base = internal::AsyncCache;
+
+ public:
+  using ReadData = SnapshotIndex;
+
+  explicit SnapshotIndexCache(kvstore::DriverPtr kvstore_driver,
+                              Executor executor)
+      : kvstore_driver_(std::move(kvstore_driver)),
+        executor_(std::move(executor)) {}
+
+  class Entry : public Base::Entry {
+   public:
+    using OwningCache = SnapshotIndexCache;
+
+    size_t ComputeReadDataSizeInBytes(const void* read_data) final {
+      return static_cast<const ReadData*>(read_data)->EstimateSizeInBytes();
+    }
+
+    void DoRead(AsyncCacheReadRequest request) final {
+      kvstore::ReadOptions options;
+      options.staleness_bound = request.staleness_bound;
+      {
+        ReadLock<ReadData> lock(*this);
+        options.generation_conditions.if_not_equal =
+            lock.read_state().stamp.generation;
+      }
+      auto& cache = internal::GetOwningCache(*this);
+      auto future =
+          cache.kvstore_driver_->Read(std::string(key()), std::move(options));
+      future.Force();
+      future.ExecuteWhenReady(
+          [this](ReadyFuture<kvstore::ReadResult> ready) {
+            OnIndexRead(std::move(ready));
+          });
+    }
+
+    void OnIndexRead(ReadyFuture<kvstore::ReadResult> ready) {
+      auto& r = ready.result();
+      if (!r.ok()) {
+        ReadError(
+            internal::ConvertInvalidArgumentToFailedPrecondition(r.status()));
+        return;
+      }
+      if (r->aborted()) {
+        // Index is unchanged.
+        ReadSuccess(ReadState{read_request_state_.read_state.data,
+                              std::move(r->stamp)});
+        return;
+      }
+      if (r->not_found()) {
+        ReadError(absl::NotFoundError(tensorstore::StrCat(
+            "Snapshot index ", tensorstore::QuoteString(key()),
+            " not found")));
+        return;
+      }
+      internal::GetOwningCache(*this).executor()(
+          [this, ready = std::move(ready)]() mutable {
+            auto& read_result = ready.value();
+            auto index =
+                internal_ocdbt::DecodeSnapshotIndex(read_result.value);
+            if (!index.ok()) {
+              ReadError(std::move(index).status());
+              return;
+            }
+            ReadSuccess(ReadState{
+                std::make_shared<const SnapshotIndex>(*std::move(index)),
+                std::move(read_result.stamp)});
+          });
+    }
+  };
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  std::string_view DoGetCacheTypeName() final { return "ocdbt_snapshot_index"; }
+
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    ABSL_UNREACHABLE();
+  }
+
+  kvstore::DriverPtr kvstore_driver_;
+  Executor executor_;
+
+  const Executor& executor() { return executor_; }
+};
+
+// -----------------------------------------------------------------------------
+
+struct OcdbtSnapshotKvStoreSpecData {
+  kvstore::Spec base;
+  Context::Resource<internal::CachePoolResource> cache_pool;
+  Context::Resource<internal::DataCopyConcurrencyResource>
+      data_copy_concurrency;
+
+  constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+    return f(x.base, x.cache_pool, x.data_copy_concurrency);
+  };
+
+  constexpr static auto default_json_binder = jb::Object(
+      jb::Member("base", jb::Projection<&OcdbtSnapshotKvStoreSpecData::base>()),
+      jb::Initialize([](auto* obj) {
+        internal::EnsureDirectoryPath(obj->base.path);
+        return absl::OkStatus();
+      }),
+      jb::Member(internal::CachePoolResource::id,
+                 jb::Projection<&OcdbtSnapshotKvStoreSpecData::cache_pool>()),
+      jb::Member(internal::DataCopyConcurrencyResource::id,
+                 jb::Projection<
+                     &OcdbtSnapshotKvStoreSpecData::data_copy_concurrency>()));
+};
+
+class OcdbtSnapshotKvStoreSpec
+    : public internal_kvstore::RegisteredDriverSpec<
+          OcdbtSnapshotKvStoreSpec, OcdbtSnapshotKvStoreSpecData> {
+ public:
+  static constexpr char id[] = "ocdbt_snapshot";
+
+  Future<kvstore::DriverPtr> DoOpen() const override;
+
+  absl::Status ApplyOptions(kvstore::DriverSpecOptions&& options) override {
+    return data_.base.driver.Set(std::move(options));
+  }
+
+  Result<kvstore::Spec> GetBase(std::string_view path) const override {
+    return data_.base;
+  }
+};
+
+/// Defines the "ocdbt_snapshot" key value store.
+class OcdbtSnapshotKvStore
+    : public internal_kvstore::RegisteredDriver<OcdbtSnapshotKvStore,
+                                                OcdbtSnapshotKvStoreSpec> {
+ public:
+  Future<ReadResult> Read(Key key, ReadOptions options) override;
+
+  std::string DescribeKey(std::string_view key) override {
+    return tensorstore::StrCat(QuoteString(key), " in OCDBT snapshot at ",
+                               base_.driver->DescribeKey(base_.path));
+  }
+
+  void ListImpl(ListOptions options, ListReceiver receiver) override;
+
+  absl::Status GetBoundSpecData(OcdbtSnapshotKvStoreSpecData& spec) const {
+    spec = spec_data_;
+    return absl::OkStatus();
+  }
+
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    return base_.driver->GetSupportedFeatures(
+        KeyRange::Prefix(base_.path));
+  }
+
+  Result<KvStore> GetBase(std::string_view path,
+                          const Transaction& transaction) const override {
+    return KvStore(base_.driver, base_.path, transaction);
+  }
+
+  const Executor& executor() const {
+    return spec_data_.data_copy_concurrency->executor;
+  }
+
+  OcdbtSnapshotKvStoreSpecData spec_data_;
+  kvstore::KvStore base_;
+  internal::PinnedCacheEntry<SnapshotIndexCache> cache_entry_;
+};
+
+Future<kvstore::DriverPtr> OcdbtSnapshotKvStoreSpec::DoOpen() const {
+  return MapFutureValue(
+      InlineExecutor{},
+      [spec = internal::IntrusivePtr<const OcdbtSnapshotKvStoreSpec>(this)](
+          kvstore::KvStore& base_kvstore) mutable
+      -> Result<kvstore::DriverPtr> {
+        std::string cache_key;
+        internal::EncodeCacheKey(&cache_key, base_kvstore.driver,
+                                 spec->data_.data_copy_concurrency);
+        auto& cache_pool = *spec->data_.cache_pool;
+        auto index_cache = internal::GetCache<SnapshotIndexCache>(
+            cache_pool.get(), cache_key, [&] {
+              return std::make_unique<SnapshotIndexCache>(
+                  base_kvstore.driver,
+                  spec->data_.data_copy_concurrency->executor);
+            });
+
+        auto driver = internal::MakeIntrusivePtr<OcdbtSnapshotKvStore>();
+        driver->base_ = std::move(base_kvstore);
+        driver->spec_data_ = std::move(spec->data_);
+        driver->cache_entry_ = GetCacheEntry(
+            index_cache, tensorstore::StrCat(driver->base_.path,
+                                             internal_ocdbt::kSnapshotIndexKey));
+        return driver;
+      },
+      kvstore::Open(data_.base));
+}
+
+// Implements OcdbtSnapshotKvStore::Read
+struct ReadState : public internal::AtomicReferenceCount<ReadState> {
+  internal::IntrusivePtr<OcdbtSnapshotKvStore> owner_;
+  kvstore::Key key_;
+  kvstore::ReadOptions options_;
+
+  // The cache read has completed, so the index entries are available.
+  void OnIndexReady(Promise<kvstore::ReadResult> promise) {
+    TimestampedStorageGeneration stamp;
+    IndirectDataReference ref;
+    {
+      SnapshotIndexCache::ReadLock<SnapshotIndexCache::ReadData> lock(
+          *(owner_->cache_entry_));
+      stamp = lock.stamp();
+      assert(lock.data());
+      const SnapshotIndexEntry* entry = lock.data()->Find(key_);
+      if (!entry) {
+        promise.SetResult(kvstore::ReadResult::Missing(std::move(stamp)));
+        return;
+      }
+      // All values are immutable, so the generation of the index also serves
+      // as the generation of each value.
+      if (!options_.generation_conditions.Matches(stamp.generation)) {
+        promise.SetResult(kvstore::ReadResult::Unspecified(std::move(stamp)));
+        return;
+      }
+      if (auto* value = std::get_if<absl::Cord>(&entry->value_reference)) {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto byte_range, options_.byte_range.Validate(value->size()),
+            static_cast<void>(promise.SetResult(_)));
+        promise.SetResult(kvstore::ReadResult::Value(
+            internal::GetSubCord(*value, byte_range), std::move(stamp)));
+        return;
+      }
+      ref = std::get<IndirectDataReference>(entry->value_reference);
+    }
+
+    TENSORSTORE_ASSIGN_OR_RETURN(auto byte_range,
+                                 options_.byte_range.Validate(ref.length),
+                                 static_cast<void>(promise.SetResult(_)));
+    kvstore::ReadOptions options;
+    options.staleness_bound = options_.staleness_bound;
+    options.batch = std::move(options_.batch);
+    options.byte_range = OptionalByteRangeRequest::Range(
+        ref.offset + byte_range.inclusive_min,
+        ref.offset + byte_range.exclusive_max);
+    std::string data_file_key =
+        tensorstore::StrCat(owner_->base_.path, ref.file_id.FullPath());
+    auto future =
+        owner_->base_.driver->Read(data_file_key, std::move(options));
+    future.Force();
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<ReadState>(this),
+         promise = std::move(promise), stamp = std::move(stamp),
+         data_file_key = std::move(data_file_key)](
+            ReadyFuture<kvstore::ReadResult> ready) mutable {
+          if (!promise.result_needed()) return;
+          auto& r = ready.result();
+          if (!r.ok()) {
+            promise.SetResult(r.status());
+            return;
+          }
+          if (!r->has_value()) {
+            promise.SetResult(absl::DataLossError(tensorstore::StrCat(
+                "Data file ",
+                self->owner_->base_.driver->DescribeKey(data_file_key),
+                " referenced by key ", tensorstore::QuoteString(self->key_),
+                " not found")));
+            return;
+          }
+          promise.SetResult(kvstore::ReadResult::Value(std::move(r->value),
+                                                       std::move(stamp)));
+        });
+  }
+};
+
+Future<kvstore::ReadResult> OcdbtSnapshotKvStore::Read(Key key,
+                                                       ReadOptions options) {
+  auto state = internal::MakeIntrusivePtr<ReadState>();
+  state->owner_ = internal::IntrusivePtr<OcdbtSnapshotKvStore>(this);
+  state->key_ = std::move(key);
+  state->options_ = options;
+
+  return PromiseFuturePair<kvstore::ReadResult>::LinkValue(
+             WithExecutor(
+                 executor(),
+                 [state = std::move(state)](Promise<ReadResult> promise,
+                                            ReadyFuture<const void>) {
+                   if (!promise.result_needed()) return;
+                   state->OnIndexReady(std::move(promise));
+                 }),
+             cache_entry_->Read({options.staleness_bound}))
+      .future;
+}
+
+// Implements OcdbtSnapshotKvStore::List
+struct ListState : public internal::AtomicReferenceCount<ListState> {
+  internal::IntrusivePtr<OcdbtSnapshotKvStore> owner_;
+  kvstore::ListOptions options_;
+  ListReceiver receiver_;
+  Promise<void> promise_;
+  Future<void> future_;
+
+  ListState(internal::IntrusivePtr<OcdbtSnapshotKvStore>&& owner,
+            kvstore::ListOptions&& options, ListReceiver&& receiver)
+      : owner_(std::move(owner)),
+        options_(std::move(options)),
+        receiver_(std::move(receiver)) {
+    auto [promise, future] = PromiseFuturePair<void>::Make(MakeResult());
+    this->promise_ = std::move(promise);
+    this->future_ = std::move(future);
+    future_.Force();
+    execution::set_starting(receiver_, [promise = promise_] {
+      promise.SetResult(absl::CancelledError(""));
+    });
+  }
+
+  ~ListState() {
+    auto& r = promise_.raw_result();
+    if (r.ok()) {
+      execution::set_done(receiver_);
+    } else {
+      execution::set_error(receiver_, r.status());
+    }
+    execution::set_stopping(receiver_);
+  }
+
+  void OnIndexReady() {
+    auto index = SnapshotIndexCache::ReadLock<SnapshotIndexCache::ReadData>(
+                     *(owner_->cache_entry_))
+                     .shared_data();
+    assert(index);
+
+    for (auto it = index->LowerBound(options_.range.inclusive_min);
+         it != index->entries.end(); ++it) {
+      if (KeyRange::CompareKeyAndExclusiveMax(
+              it->key, options_.range.exclusive_max) >= 0) {
+        break;
+      }
+      if (it->key.size() < options_.strip_prefix_length) continue;
+      uint64_t size;
+      if (auto* value = std::get_if<absl::Cord>(&it->value_reference)) {
+        size = value->size();
+      } else {
+        size = std::get<IndirectDataReference>(it->value_reference).length;
+      }
+      execution::set_value(
+          receiver_, ListEntry{it->key.substr(options_.strip_prefix_length),
+                               ListEntry::checked_size(size)});
+    }
+  }
+};
+
+void OcdbtSnapshotKvStore::ListImpl(ListOptions options,
+                                    ListReceiver receiver) {
+  auto state = internal::MakeIntrusivePtr<ListState>(
+      internal::IntrusivePtr<OcdbtSnapshotKvStore>(this), std::move(options),
+      std::move(receiver));
+  auto* state_ptr = state.get();
+  LinkValue(WithExecutor(executor(),
+                         [state = std::move(state)](Promise<void> promise,
+                                                    ReadyFuture<const void>) {
+                           state->OnIndexReady();
+                         }),
+            state_ptr->promise_,
+            cache_entry_->Read({state_ptr->options_.staleness_bound}));
+}
+
+}  // namespace
+}  // namespace tensorstore
+
+TENSORSTORE_DECLARE_GARBAGE_COLLECTION_NOT_REQUIRED(
+    tensorstore::OcdbtSnapshotKvStore)
+
+// Registers the driver.
+namespace {
+const tensorstore::internal_kvstore::DriverRegistration<
+    tensorstore::OcdbtSnapshotKvStoreSpec>
+    registration;
+
+}  // namespace
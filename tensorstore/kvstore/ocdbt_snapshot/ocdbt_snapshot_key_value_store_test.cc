@@ -0,0 +1,166 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/ocdbt/export_snapshot_util.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/test_matchers.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+namespace kvstore = ::tensorstore::kvstore;
+using ::tensorstore::Context;
+using ::tensorstore::KvStore;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::internal::MatchesKvsReadResult;
+using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore::internal::MatchesListEntry;
+using ::tensorstore::internal_ocdbt::ExportSnapshot;
+using ::tensorstore::internal_ocdbt::ExportSnapshotOptions;
+
+class OcdbtSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        store_, kvstore::Open({{"driver", "ocdbt"}, {"base", "memory://db/"}},
+                              context_)
+                    .result());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        target_, kvstore::Open("memory://snapshot/", context_).result());
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store_, "a", absl::Cord("inline")));
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store_, "b", large_b_));
+    TENSORSTORE_ASSERT_OK(kvstore::Write(store_, "c", large_c_));
+  }
+
+  KvStore OpenSnapshot(std::string path = "snapshot/") {
+    auto snapshot =
+        kvstore::Open({{"driver", "ocdbt_snapshot"},
+                       {"base", "memory://" + path}},
+                      context_)
+            .result();
+    EXPECT_TRUE(snapshot.ok()) << snapshot.status();
+    return snapshot.ok() ? *snapshot : KvStore{};
+  }
+
+  Context context_ = Context::Default();
+  absl::Cord large_b_ = absl::Cord(std::string(500, 'b'));
+  absl::Cord large_c_ = absl::Cord(std::string(300, 'c'));
+  KvStore store_;
+  KvStore target_;
+};
+
+TEST_F(OcdbtSnapshotTest, ReadExported) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats,
+                                   ExportSnapshot(store_, target_));
+  EXPECT_EQ(3, stats.num_keys);
+  EXPECT_EQ(1, stats.num_inline_values);
+  EXPECT_EQ(1, stats.num_data_files);
+  EXPECT_EQ(800, stats.num_data_file_bytes);
+
+  auto snapshot = OpenSnapshot();
+  EXPECT_THAT(kvstore::Read(snapshot, "a").result(),
+              MatchesKvsReadResult(absl::Cord("inline")));
+  EXPECT_THAT(kvstore::Read(snapshot, "b").result(),
+              MatchesKvsReadResult(large_b_));
+  EXPECT_THAT(kvstore::Read(snapshot, "c").result(),
+              MatchesKvsReadResult(large_c_));
+  EXPECT_THAT(kvstore::Read(snapshot, "d").result(),
+              MatchesKvsReadResultNotFound());
+
+  kvstore::ReadOptions options;
+  options.byte_range = OptionalByteRangeRequest::Range(1, 3);
+  EXPECT_THAT(kvstore::Read(snapshot, "a", options).result(),
+              MatchesKvsReadResult(absl::Cord("nl")));
+  EXPECT_THAT(kvstore::Read(snapshot, "c", options).result(),
+              MatchesKvsReadResult(absl::Cord("cc")));
+  options.byte_range = OptionalByteRangeRequest::Range(1, 301);
+  EXPECT_THAT(kvstore::Read(snapshot, "c", options).result(),
+              MatchesStatus(absl::StatusCode::kOutOfRange));
+
+  EXPECT_THAT(kvstore::ListFuture(snapshot).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesListEntry("a", 6), MatchesListEntry("b", 500),
+                  MatchesListEntry("c", 300))));
+
+  EXPECT_THAT(kvstore::Write(snapshot, "a", absl::Cord("x")).result(),
+              MatchesStatus(absl::StatusCode::kUnimplemented));
+}
+
+TEST_F(OcdbtSnapshotTest, TargetDataFileBytes) {
+  ExportSnapshotOptions options;
+  options.target_data_file_bytes = 1;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats,
+                                   ExportSnapshot(store_, target_, options));
+  EXPECT_EQ(2, stats.num_data_files);
+
+  auto snapshot = OpenSnapshot();
+  EXPECT_THAT(kvstore::Read(snapshot, "b").result(),
+              MatchesKvsReadResult(large_b_));
+  EXPECT_THAT(kvstore::Read(snapshot, "c").result(),
+              MatchesKvsReadResult(large_c_));
+}
+
+TEST_F(OcdbtSnapshotTest, ExportVersion) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto stats,
+                                   ExportSnapshot(store_, target_));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store_, "a", absl::Cord("new")));
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store_, "b"));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto old_target,
+      kvstore::Open("memory://old_snapshot/", context_).result());
+  ExportSnapshotOptions options;
+  options.version = stats.generation_number;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto old_stats, ExportSnapshot(store_, old_target, options));
+  EXPECT_EQ(stats.generation_number, old_stats.generation_number);
+
+  auto snapshot = OpenSnapshot("old_snapshot/");
+  EXPECT_THAT(kvstore::Read(snapshot, "a").result(),
+              MatchesKvsReadResult(absl::Cord("inline")));
+  EXPECT_THAT(kvstore::Read(snapshot, "b").result(),
+              MatchesKvsReadResult(large_b_));
+
+  options.version = stats.generation_number + 100;
+  EXPECT_THAT(ExportSnapshot(store_, old_target, options),
+              MatchesStatus(absl::StatusCode::kNotFound));
+}
+
+TEST_F(OcdbtSnapshotTest, MissingIndex) {
+  auto snapshot = OpenSnapshot("empty/");
+  EXPECT_THAT(kvstore::Read(snapshot, "a").result(),
+              MatchesStatus(absl::StatusCode::kNotFound,
+                            ".*Snapshot index .* not found.*"));
+}
+
+TEST(OcdbtSnapshotInvalidTest, NotOcdbt) {
+  auto context = Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open("memory://", context).result());
+  EXPECT_THAT(ExportSnapshot(store, store),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
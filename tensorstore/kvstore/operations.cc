@@ -15,15 +15,20 @@
 #include "tensorstore/kvstore/operations.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <cassert>
 #include <optional>
 #include <ostream>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "tensorstore/internal/tracing/trace_future.h"
+#include "tensorstore/internal/tracing/tracing.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -40,10 +45,38 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/quote_string.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
 namespace kvstore {
+namespace {
+
+Future<ReadResult> RecordReadIoStats(Future<ReadResult> future,
+                                     const IoStats& io_stats) {
+  if (io_stats) {
+    future.ExecuteWhenReady([io_stats](ReadyFuture<ReadResult> f) {
+      if (!f.status().ok()) return;
+      io_stats.RecordKvstoreRead(f.value().has_value() ? f.value().value.size()
+                                                       : 0);
+    });
+  }
+  return future;
+}
+
+Future<TimestampedStorageGeneration> RecordWriteIoStats(
+    Future<TimestampedStorageGeneration> future, const IoStats& io_stats,
+    int64_t bytes) {
+  if (io_stats) {
+    future.ExecuteWhenReady(
+        [io_stats, bytes](ReadyFuture<TimestampedStorageGeneration> f) {
+          if (f.status().ok()) io_stats.RecordKvstoreWrite(bytes);
+        });
+  }
+  return future;
+}
+
+}  // namespace
 
 std::ostream& operator<<(std::ostream& os, const ReadGenerationConditions& x) {
   os << "{";
@@ -84,7 +117,15 @@ Future<ReadResult> Read(const KvStore& store, std::string_view key,
   auto full_key = tensorstore::StrCat(store.path, key);
   if (store.transaction == no_transaction) {
     // Regular non-transactional read.
-    return store.driver->Read(std::move(full_key), std::move(options));
+    internal_tracing::Span span("kvstore.Read");
+    span.SetAttribute("key", full_key);
+    internal_tracing::SpanScope scope(span);
+    IoStats io_stats = options.io_stats;
+    return RecordReadIoStats(
+        internal_tracing::EndSpanWhenReady(
+            std::move(span),
+            store.driver->Read(std::move(full_key), std::move(options))),
+        io_stats);
   }
   if (!StorageGeneration::IsUnknown(options.generation_conditions.if_equal)) {
     return absl::UnimplementedError(
@@ -107,6 +148,16 @@ Future<ReadResult> Read(const KvStore& store, std::string_view key,
       std::move(transactional_read_options));
 }
 
+Future<const void> Prefetch(const KvStore& store,
+                            span<const std::string> keys,
+                            ReadOptions options) {
+  auto [promise, future] = PromiseFuturePair<void>::Make(std::in_place);
+  for (const auto& key : keys) {
+    LinkError(promise, kvstore::Read(store, key, options));
+  }
+  return std::move(future);
+}
+
 Future<TimestampedStorageGeneration> Write(const KvStore& store,
                                            std::string_view key,
                                            std::optional<Value> value,
@@ -114,12 +165,21 @@ Future<TimestampedStorageGeneration> Write(const KvStore& store,
   auto full_key = tensorstore::StrCat(store.path, key);
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
-    return store.driver->Write(std::move(full_key), std::move(value),
-                               std::move(options));
+    internal_tracing::Span span("kvstore.Write");
+    span.SetAttribute("key", full_key);
+    internal_tracing::SpanScope scope(span);
+    IoStats io_stats = options.io_stats;
+    const int64_t bytes = value ? value->size() : 0;
+    return RecordWriteIoStats(
+        internal_tracing::EndSpanWhenReady(
+            std::move(span), store.driver->Write(std::move(full_key),
+                                                 std::move(value),
+                                                 std::move(options))),
+        io_stats, bytes);
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
-      internal::AcquireOpenTransactionPtrOrError(store.transaction));
+      internal::AcquireOpenTransactionPtrForWriteOrError(store.transaction));
   size_t phase;
   // Drop the write future; the transactional write completes as soon as the
   // write is applied to the transaction.
@@ -145,12 +205,16 @@ Future<TimestampedStorageGeneration> WriteCommitted(const KvStore& store,
   auto full_key = tensorstore::StrCat(store.path, key);
   if (store.transaction == no_transaction) {
     // Regular non-transactional write.
-    return store.driver->Write(std::move(full_key), std::move(value),
-                               std::move(options));
+    IoStats io_stats = options.io_stats;
+    const int64_t bytes = value ? value->size() : 0;
+    return RecordWriteIoStats(
+        store.driver->Write(std::move(full_key), std::move(value),
+                            std::move(options)),
+        io_stats, bytes);
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
-      internal::AcquireOpenTransactionPtrOrError(store.transaction));
+      internal::AcquireOpenTransactionPtrForWriteOrError(store.transaction));
   size_t phase;
   return internal_kvstore::WriteViaExistingTransaction(
       store.driver.get(), open_transaction, phase, std::move(full_key),
@@ -185,7 +249,7 @@ Future<const void> DeleteRange(const KvStore& store, KeyRange range) {
   }
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto open_transaction,
-      internal::AcquireOpenTransactionPtrOrError(store.transaction));
+      internal::AcquireOpenTransactionPtrForWriteOrError(store.transaction));
   return store.driver->TransactionalDeleteRange(open_transaction,
                                                 std::move(range));
 }
@@ -197,7 +261,7 @@ Future<const void> ExperimentalCopyRange(const KvStore& source,
   if (target.transaction != no_transaction) {
     TENSORSTORE_ASSIGN_OR_RETURN(
         target_transaction,
-        internal::AcquireOpenTransactionPtrOrError(target.transaction));
+        internal::AcquireOpenTransactionPtrForWriteOrError(target.transaction));
   }
   return target.driver->ExperimentalCopyRangeFrom(
       target_transaction, source, target.path, std::move(options));
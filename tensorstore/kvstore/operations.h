@@ -22,12 +22,14 @@
 #include <limits>
 #include <optional>
 #include <ostream>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/time/time.h"
 #include "tensorstore/batch.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -38,6 +40,7 @@
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/any_sender.h"
 #include "tensorstore/util/future.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace kvstore {
@@ -96,6 +99,19 @@ struct ReadGenerationConditions {
                                   const ReadGenerationConditions& x);
 };
 
+/// Relative priority of a read request.
+///
+/// Drivers which limit the number of concurrent requests, such as the ``gcs``
+/// and ``s3`` drivers, start pending `kHigh` requests before pending `kNormal`
+/// requests.  This allows latency-sensitive reads to proceed while bulk
+/// operations are queued.
+///
+/// \relates KvStore
+enum class RequestPriority : int {
+  kNormal = 0,
+  kHigh = 1,
+};
+
 /// Read options for non-transactional reads.
 ///
 /// See also `TransactionalReadOptions`.
@@ -118,6 +134,13 @@ struct ReadOptions {
 
   /// Optional batch to use.
   Batch batch{no_batch};
+
+  /// Priority of the request.
+  RequestPriority priority = RequestPriority::kNormal;
+
+  /// Optional collector to which the read is attributed.  Only recorded for
+  /// non-transactional reads.
+  IoStats io_stats;
 };
 
 struct TransactionalReadGenerationConditions {
@@ -183,6 +206,19 @@ struct WriteGenerationConditions {
 struct WriteOptions {
   /// Specifies conditions for the write.
   WriteGenerationConditions generation_conditions;
+
+  /// Hint that the first `unchanged_prefix_length` bytes of the new value are
+  /// identical to the existing value with generation
+  /// `generation_conditions.if_equal`.
+  ///
+  /// Drivers that support `SupportedFeatures::kAppendInPlace` may use this to
+  /// write only the remaining suffix.  Ignored if `if_equal` is not specified,
+  /// and by all other drivers.
+  uint64_t unchanged_prefix_length = 0;
+
+  /// Optional collector to which the write is attributed.  Only recorded for
+  /// non-transactional writes.
+  IoStats io_stats;
 };
 
 /// Options for `ListFuture`.
@@ -197,6 +233,23 @@ struct ListOptions {
 
   /// Staleness bound on list results.
   absl::Time staleness_bound = absl::InfiniteFuture();
+
+  /// Maximum number of sub-ranges of `range` to list concurrently.
+  ///
+  /// Object store drivers, such as ``gcs`` and ``s3``, otherwise page through
+  /// the keys in `range` sequentially.  If greater than 1, they partition
+  /// `range` at the ``/``-delimited prefixes of the keys it contains, and list
+  /// up to this many partitions concurrently.  Other drivers ignore this
+  /// option.
+  size_t concurrency = 1;
+
+  /// Specifies whether the keys of concurrently listed partitions are emitted
+  /// in the same order as by a sequential listing.
+  ///
+  /// This requires buffering the keys of partitions that are listed ahead of
+  /// the earliest partition that has not completed.  If `false`, keys are
+  /// emitted as soon as they are received.
+  bool ordered = true;
 };
 
 /// Return value for List operations
@@ -205,6 +258,12 @@ struct ListEntry {
 
   int64_t size;
 
+  /// Generation of the value, equal to the generation that `Read` would
+  /// report, if supported by the driver (as indicated by
+  /// `SupportedFeatures::kListGenerations`).  Otherwise,
+  /// `StorageGeneration::Unknown()`.
+  StorageGeneration generation;
+
   bool has_size() const { return size >= 0; }
 
   template <typename T>
@@ -254,6 +313,27 @@ struct CopyRangeOptions {
 Future<ReadResult> Read(const KvStore& store, std::string_view key,
                         ReadOptions options = {});
 
+/// Reads the values for the keys `store.path + key` for each `key` in `keys`,
+/// discarding the results.
+///
+/// This is useful to populate any caches maintained by `store.driver` (e.g.
+/// the b+tree node cache of the ``ocdbt`` driver or the shard index cache of
+/// sharded formats) in advance of subsequent reads.  Specifying a
+/// `ReadOptions::batch` allows the reads to be coalesced with each other and
+/// with other reads in the same batch.
+///
+/// \param store `KvStore` from which to read.
+/// \param keys The keys to read, each interpreted as a suffix to be appended
+///     to `store.path`.
+/// \param options Specifies options for reading, used for each key.
+/// \returns A Future that becomes ready when all reads have completed, or
+///     with the first error encountered.  A missing value is not considered an
+///     error.
+/// \relates KvStore
+Future<const void> Prefetch(const KvStore& store,
+                            span<const std::string> keys,
+                            ReadOptions options = {});
+
 /// Performs an optionally-conditional write.
 ///
 /// Atomically updates or deletes the value stored for `store.path + key`
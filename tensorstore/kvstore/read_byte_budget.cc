@@ -0,0 +1,203 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/read_byte_budget.h"
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/cord.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+struct ReadByteBudget::State {
+  explicit State(int64_t limit) : limit(limit) {}
+
+  struct Waiter {
+    int64_t bytes;
+    Executor executor;
+    ExecutorTask start;
+  };
+
+  const int64_t limit;
+  absl::Mutex mutex;
+  int64_t in_flight ABSL_GUARDED_BY(mutex) = 0;
+  std::deque<Waiter> waiters ABSL_GUARDED_BY(mutex);
+
+  // Total size and number of completed reads without a bounded byte range,
+  // used to estimate the size of subsequent such reads.
+  int64_t unbounded_bytes ABSL_GUARDED_BY(mutex) = 0;
+  int64_t unbounded_reads ABSL_GUARDED_BY(mutex) = 0;
+
+  bool CanAdmit(int64_t bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    return in_flight == 0 || in_flight + bytes <= limit;
+  }
+
+  int64_t EstimateBytes(const OptionalByteRangeRequest& byte_range) {
+    if (byte_range.IsRange()) {
+      return byte_range.exclusive_max - byte_range.inclusive_min;
+    }
+    if (byte_range.IsSuffixLength()) return -byte_range.inclusive_min;
+    absl::MutexLock lock(&mutex);
+    return unbounded_reads == 0 ? 0 : unbounded_bytes / unbounded_reads;
+  }
+
+  void RecordUnboundedRead(int64_t bytes) {
+    absl::MutexLock lock(&mutex);
+    unbounded_bytes += bytes;
+    ++unbounded_reads;
+  }
+
+  // Invokes `start` once `bytes` have been reserved.
+  void Acquire(int64_t bytes, const Executor& executor, ExecutorTask start) {
+    {
+      absl::MutexLock lock(&mutex);
+      if (!waiters.empty() || !CanAdmit(bytes)) {
+        waiters.push_back(Waiter{bytes, executor, std::move(start)});
+        return;
+      }
+      in_flight += bytes;
+    }
+    std::move(start)();
+  }
+
+  // Adds `delta` to the reserved bytes without waiting.  If `delta` is
+  // negative, starts any waiting reads that become admissible.
+  void Adjust(int64_t delta) {
+    std::vector<Waiter> admitted;
+    {
+      absl::MutexLock lock(&mutex);
+      in_flight += delta;
+      while (delta < 0 && !waiters.empty() &&
+             CanAdmit(waiters.front().bytes)) {
+        in_flight += waiters.front().bytes;
+        admitted.push_back(std::move(waiters.front()));
+        waiters.pop_front();
+      }
+    }
+    // Bytes may be released from arbitrary contexts, such as the destructor
+    // of a cached value, so admitted reads are issued using their executor.
+    for (auto& waiter : admitted) {
+      waiter.executor(std::move(waiter.start));
+    }
+  }
+};
+
+/// Bytes reserved from a `ReadByteBudget`, released on destruction.
+class ReadByteBudget::Reservation {
+ public:
+  /// Adopts `bytes` previously added to the reserved bytes of `state`.
+  Reservation(std::shared_ptr<State> state, int64_t bytes)
+      : state_(std::move(state)), bytes_(bytes) {}
+  Reservation(Reservation&&) = default;
+  Reservation& operator=(Reservation&&) = delete;
+  ~Reservation() {
+    if (state_ && bytes_ != 0) state_->Adjust(-bytes_);
+  }
+
+  State& state() const { return *state_; }
+
+  void Resize(int64_t bytes) {
+    state_->Adjust(bytes - bytes_);
+    bytes_ = bytes;
+  }
+
+ private:
+  std::shared_ptr<State> state_;
+  int64_t bytes_;
+};
+
+ReadByteBudget::ReadByteBudget(int64_t limit)
+    : limit_(limit), state_(std::make_shared<State>(limit)) {}
+
+int64_t ReadByteBudget::in_flight() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->in_flight;
+}
+
+Future<kvstore::ReadResult> ReadByteBudget::Read(const Executor& executor,
+                                                 kvstore::ReadOptions options,
+                                                 ReadFunction read) {
+  const bool unbounded = !options.byte_range.IsRange() &&
+                         !options.byte_range.IsSuffixLength();
+  const int64_t bytes = state_->EstimateBytes(options.byte_range);
+  auto pair = PromiseFuturePair<kvstore::ReadResult>::Make();
+  state_->Acquire(
+      bytes, executor,
+      [state = state_, bytes, unbounded, promise = std::move(pair.promise),
+       options = std::move(options), read = std::move(read)]() mutable {
+        Reservation reservation(std::move(state), bytes);
+        if (!promise.result_needed()) return;
+        auto future = read(std::move(options));
+        // If the result is no longer needed, the link and therefore the
+        // reservation are destroyed without invoking the callback.
+        Link(
+            [reservation = std::move(reservation), unbounded](
+                Promise<kvstore::ReadResult> promise,
+                ReadyFuture<kvstore::ReadResult> future) mutable {
+              auto& result = future.result();
+              if (!result.ok()) {
+                promise.SetResult(result.status());
+                return;
+              }
+              kvstore::ReadResult read_result = *result;
+              const int64_t size = read_result.value.size();
+              if (unbounded && read_result.has_value()) {
+                reservation.state().RecordUnboundedRead(size);
+              }
+              // Exchange the estimate for the actual size, which remains
+              // reserved until every reference to the value is released.
+              reservation.Resize(size);
+              if (size != 0) {
+                struct Holder {
+                  absl::Cord value;
+                  Reservation reservation;
+                };
+                auto holder = std::make_shared<Holder>(
+                    Holder{std::move(read_result.value),
+                           std::move(reservation)});
+                for (std::string_view chunk : holder->value.Chunks()) {
+                  read_result.value.Append(
+                      absl::MakeCordFromExternal(chunk, [holder] {}));
+                }
+              }
+              promise.SetResult(std::move(read_result));
+            },
+            std::move(promise), std::move(future));
+      });
+  return std::move(pair.future);
+}
+
+namespace {
+
+const internal::ContextResourceRegistration<ReadByteBudgetResource>
+    read_byte_budget_registration;
+
+}  // namespace
+}  // namespace internal_kvstore
+}  // namespace tensorstore
@@ -0,0 +1,135 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_READ_BYTE_BUDGET_H_
+#define TENSORSTORE_KVSTORE_READ_BYTE_BUDGET_H_
+
+/// \file
+///
+/// Byte-based admission control for key-value store reads.
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/cache_key/std_optional.h"  // IWYU pragma: keep
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/json_binding/std_optional.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Limits the total size of read results that are in flight, that is,
+/// requested but not yet released by the caller.
+///
+/// Each read reserves its expected size before it is issued: the size of
+/// `options.byte_range` if it is bounded, and otherwise the mean size of
+/// previous unbounded reads.  Once the read completes, the reservation is
+/// adjusted to the actual size of the value and remains held until every
+/// copy of the returned `absl::Cord` has been destroyed, typically once the
+/// value has been decoded.
+///
+/// Reads are admitted in FIFO order.  A read is always admitted when nothing
+/// else is in flight, so a single read larger than the limit still proceeds.
+class ReadByteBudget {
+ public:
+  using ReadFunction =
+      std::function<Future<kvstore::ReadResult>(kvstore::ReadOptions options)>;
+
+  /// Constructs a budget of `limit` bytes.
+  explicit ReadByteBudget(int64_t limit);
+
+  /// Returns the limit specified to the constructor.
+  int64_t limit() const { return limit_; }
+
+  /// Returns the number of bytes currently reserved.
+  int64_t in_flight() const;
+
+  /// Issues `read(options)` once the expected size of the read has been
+  /// reserved.
+  ///
+  /// If the read is not admitted immediately, it is issued using `executor`
+  /// once enough previously reserved bytes have been released.
+  Future<kvstore::ReadResult> Read(const Executor& executor,
+                                   kvstore::ReadOptions options,
+                                   ReadFunction read);
+
+ private:
+  struct State;
+  class Reservation;
+
+  int64_t limit_;
+
+  // Shared with pending reads and returned values, which may outlive this
+  // object.
+  std::shared_ptr<State> state_;
+};
+
+/// Context resource that limits the total size of in-flight reads.
+///
+/// Reads are not limited unless `limit` is specified.  Key-value stores that
+/// share the resource also share the limit.
+struct ReadByteBudgetResource
+    : public internal::ContextResourceTraits<ReadByteBudgetResource> {
+  static constexpr char id[] = "kvstore_in_flight_read_bytes";
+  constexpr static bool shared_when_decoded = true;
+
+  struct Spec {
+    std::optional<int64_t> limit;
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.limit);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    /// Null if reads are not limited.
+    std::shared_ptr<ReadByteBudget> budget;
+  };
+
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(jb::Member(
+        "limit",
+        jb::Projection(&Spec::limit, jb::Optional(jb::Integer<int64_t>(1)))));
+  }
+  static Result<Resource> Create(
+      const Spec& spec, internal::ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (spec.limit) {
+      resource.budget = std::make_shared<ReadByteBudget>(*spec.limit);
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_READ_BYTE_BUDGET_H_
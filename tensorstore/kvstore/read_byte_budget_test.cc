@@ -0,0 +1,165 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/read_byte_budget.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::Future;
+using ::tensorstore::InlineExecutor;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::Promise;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::TimestampedStorageGeneration;
+using ::tensorstore::internal_kvstore::ReadByteBudget;
+using ::tensorstore::internal_kvstore::ReadByteBudgetResource;
+using ::tensorstore::kvstore::ReadOptions;
+using ::tensorstore::kvstore::ReadResult;
+
+/// Records issued reads, which are completed by the test.
+struct MockReads {
+  std::vector<Promise<ReadResult>> promises;
+
+  Future<ReadResult> Read(ReadByteBudget& budget, ReadOptions options) {
+    return budget.Read(InlineExecutor{}, std::move(options),
+                       [this](ReadOptions options) {
+                         auto pair = PromiseFuturePair<ReadResult>::Make();
+                         promises.push_back(std::move(pair.promise));
+                         return std::move(pair.future);
+                       });
+  }
+};
+
+ReadOptions ByteRange(int64_t inclusive_min, int64_t exclusive_max) {
+  ReadOptions options;
+  options.byte_range =
+      OptionalByteRangeRequest::Range(inclusive_min, exclusive_max);
+  return options;
+}
+
+ReadResult MakeValue(size_t size) {
+  return ReadResult::Value(
+      absl::Cord(std::string(size, 'x')),
+      TimestampedStorageGeneration{StorageGeneration::FromString("g"),
+                                   absl::Now()});
+}
+
+TEST(ReadByteBudgetTest, HoldsBytesUntilValueReleased) {
+  ReadByteBudget budget(10);
+  MockReads reads;
+  auto future1 = reads.Read(budget, ByteRange(0, 8));
+  auto future2 = reads.Read(budget, ByteRange(0, 8));
+  ASSERT_EQ(1, reads.promises.size());
+  EXPECT_EQ(8, budget.in_flight());
+
+  reads.promises[0].SetResult(MakeValue(8));
+  std::optional<ReadResult> result1;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(result1, future1.result());
+  future1 = {};
+  EXPECT_EQ(8, result1->value.size());
+  EXPECT_EQ(1, reads.promises.size());
+
+  // Releasing the value admits the second read.
+  result1.reset();
+  ASSERT_EQ(2, reads.promises.size());
+  EXPECT_EQ(8, budget.in_flight());
+
+  reads.promises[1].SetResult(MakeValue(4));
+  future2.result().value();
+  future2 = {};
+  EXPECT_EQ(0, budget.in_flight());
+}
+
+TEST(ReadByteBudgetTest, OversizedReadAdmittedWhenIdle) {
+  ReadByteBudget budget(10);
+  MockReads reads;
+  auto future = reads.Read(budget, ByteRange(0, 100));
+  ASSERT_EQ(1, reads.promises.size());
+  EXPECT_EQ(100, budget.in_flight());
+  reads.promises[0].SetResult(absl::UnavailableError("failed"));
+  EXPECT_THAT(future.result(), MatchesStatus(absl::StatusCode::kUnavailable));
+  EXPECT_EQ(0, budget.in_flight());
+}
+
+TEST(ReadByteBudgetTest, UnboundedReadsUseObservedSize) {
+  ReadByteBudget budget(10);
+  MockReads reads;
+  reads.Read(budget, {});
+  ASSERT_EQ(1, reads.promises.size());
+  EXPECT_EQ(0, budget.in_flight());
+  reads.promises[0].SetResult(MakeValue(6));
+  EXPECT_EQ(0, budget.in_flight());
+
+  auto future = reads.Read(budget, {});
+  EXPECT_EQ(6, budget.in_flight());
+}
+
+TEST(ReadByteBudgetTest, CancelledReadReleasesBytes) {
+  ReadByteBudget budget(10);
+  MockReads reads;
+  auto future1 = reads.Read(budget, ByteRange(0, 8));
+  auto future2 = reads.Read(budget, ByteRange(0, 8));
+  ASSERT_EQ(1, reads.promises.size());
+  future1 = {};
+  EXPECT_EQ(2, reads.promises.size());
+}
+
+TEST(ReadByteBudgetResourceTest, Default) {
+  auto resource_spec =
+      Context::Resource<ReadByteBudgetResource>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(nullptr, resource->budget);
+}
+
+TEST(ReadByteBudgetResourceTest, Limit) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec,
+      Context::Resource<ReadByteBudgetResource>::FromJson({{"limit", 1000}}));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  ASSERT_NE(nullptr, resource->budget);
+  EXPECT_EQ(1000, resource->budget->limit());
+}
+
+TEST(ReadByteBudgetResourceTest, InvalidLimit) {
+  EXPECT_THAT(
+      Context::Resource<ReadByteBudgetResource>::FromJson({{"limit", 0}}),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Error parsing object member \"limit\": .*"));
+}
+
+}  // namespace
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_KVSTORE_READ_MODIFY_WRITE_H_
 #define TENSORSTORE_KVSTORE_READ_MODIFY_WRITE_H_
 
+#include <stdint.h>
+
 #include "absl/status/status.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/operations.h"
@@ -188,6 +190,14 @@ class ReadModifyWriteSource {
   /// kinds can call this method during writeback.
   virtual void* IsSpecialSource() { return 0; }
 
+  /// Returns the length of a prefix of the most recently-provided writeback
+  /// value that is known to be identical to the existing value on which it is
+  /// conditioned, or `0` if unknown.
+  ///
+  /// This is forwarded as `WriteOptions::unchanged_prefix_length` when the
+  /// writeback value is written directly to a kvstore driver.
+  virtual uint64_t KvsWritebackUnchangedPrefixLength() { return 0; }
+
  protected:
   ~ReadModifyWriteSource() = default;
 };
@@ -25,6 +25,13 @@
 ///
 /// Refer to `memory/memory_key_value_store.cc` for an example.
 
+#include <optional>
+#include <string>
+#include <typeinfo>
+
+#include "absl/base/call_once.h"
+#include "tensorstore/internal/cache_key/cache_key.h"
+#include "tensorstore/internal/cache_key/fingerprint.h"
 #include "tensorstore/internal/context_binding.h"
 #include "tensorstore/internal/json_registry.h"
 #include "tensorstore/json_serialization_options.h"
@@ -162,8 +169,20 @@ class RegisteredDriverSpec : public Parent {
   /// The `SpecData` template parameter is always equal to
   /// `typename Derived::SpecData`, but is specified as a template parameter
   /// because `Derived` is incomplete when this class template is instantiated.
+  ///
+  /// Since the `SpecData` of layered drivers includes the specs of the
+  /// underlying drivers, its full encoding may be large; only its fixed-size
+  /// fingerprint is encoded, such that cache keys that refer to a spec or
+  /// driver remain small.
   static void EncodeCacheKeyImpl(std::string* out, const SpecData& data) {
-    internal::EncodeCacheKey(out, typeid(Derived), data);
+    internal::EncodeCacheKey(out, ComputeCacheKeyFingerprint(data));
+  }
+
+  static internal::CacheKeyFingerprint ComputeCacheKeyFingerprint(
+      const SpecData& data) {
+    std::string encoded;
+    internal::EncodeCacheKey(&encoded, typeid(Derived), data);
+    return internal::CacheKeyFingerprint::Compute(encoded);
   }
 
   /// Data members required by `Derived` spec class.
@@ -193,15 +212,27 @@ class RegisteredDriver : public Parent {
   void EncodeCacheKey(std::string* out) const override {
     // Generates a cache key by obtaining the `SpecData` representation,
     // then computing the cache key from that.
-    SpecData bound_spec_data;
-    if (auto status = static_cast<const Derived*>(this)->GetBoundSpecData(
-            bound_spec_data);
-        !status.ok()) {
+    //
+    // The cache key of a driver does not change, but is needed by every open
+    // of a TensorStore driver or cache that uses this driver, and obtaining
+    // and encoding the `SpecData` is relatively expensive.  Therefore, its
+    // fingerprint is computed once.
+    absl::call_once(cache_key_fingerprint_once_, [&] {
+      SpecData bound_spec_data;
+      if (!static_cast<const Derived*>(this)
+               ->GetBoundSpecData(bound_spec_data)
+               .ok()) {
+        return;
+      }
+      cache_key_fingerprint_ =
+          DerivedSpec::ComputeCacheKeyFingerprint(bound_spec_data);
+    });
+    if (!cache_key_fingerprint_) {
       // Could not obtain bound spec data.  Just use the default implementation
       // that encodes the exact object identity.
       return Driver::EncodeCacheKey(out);
     }
-    DerivedSpec::EncodeCacheKeyImpl(out, bound_spec_data);
+    internal::EncodeCacheKey(out, *cache_key_fingerprint_);
   }
 
   Result<DriverSpecPtr> GetBoundSpec() const override {
@@ -217,6 +248,10 @@ class RegisteredDriver : public Parent {
     garbage_collection::GarbageCollectionVisit(
         visitor, *static_cast<const Derived*>(this));
   }
+
+ private:
+  mutable absl::once_flag cache_key_fingerprint_once_;
+  mutable std::optional<internal::CacheKeyFingerprint> cache_key_fingerprint_;
 };
 
 /// Registers a KeyValueStore driver implementation.
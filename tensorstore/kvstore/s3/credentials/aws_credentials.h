@@ -39,6 +39,9 @@ struct AwsCredentials {
   std::string session_token;
   /// Expiration date
   absl::Time expires_at = absl::InfinitePast();
+  /// Indicates that these are S3 Express One Zone session credentials obtained
+  /// from `CreateSession`, which are only valid for a directory bucket.
+  bool s3_express_session = false;
 
   /// Anonymous credentials that do not expire
   static AwsCredentials Anonymous() {
@@ -29,6 +29,8 @@
 #include "absl/time/time.h"
 #include "tensorstore/internal/http/http_transport.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/histogram.h"
+#include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
 #include "tensorstore/kvstore/s3/credentials/ec2_credential_provider.h"
 #include "tensorstore/kvstore/s3/credentials/environment_credential_provider.h"
@@ -41,6 +43,14 @@ namespace {
 
 ABSL_CONST_INIT internal_log::VerboseFlag s3_logging("s3");
 
+auto& credentials_wait_time_ms =
+    internal_metrics::Histogram<internal_metrics::DefaultBucketer>::New(
+        "/tensorstore/kvstore/s3/credentials_wait_time_ms",
+        internal_metrics::MetricMetadata(
+            "Time (ms) that GetCredentials calls were blocked waiting for "
+            "expired AWS credentials to be refreshed.",
+            internal_metrics::Units::kMilliseconds));
+
 struct AwsCredentialProviderRegistry {
   std::vector<std::pair<int, AwsCredentialProviderFn>> providers;
   absl::Mutex mutex;
@@ -98,22 +108,63 @@ DefaultAwsCredentialsProvider::DefaultAwsCredentialsProvider(
       credentials_{{}, {}, {}, absl::InfinitePast()} {}
 
 Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
+  const absl::Time start_time = absl::Now();
+  const auto record_wait_time = [&] {
+    credentials_wait_time_ms.Observe(
+        absl::ToDoubleMilliseconds(absl::Now() - start_time));
+  };
+  bool expired;
   {
-    absl::ReaderMutexLock lock(&mutex_);
-    if (credentials_.expires_at > clock_()) {
-      return credentials_;
+    absl::MutexLock lock(&mutex_);
+    bool waited = false;
+    while (true) {
+      const absl::Time now = clock_();
+      if (credentials_.expires_at > now) {
+        if (refresh_in_progress_ ||
+            credentials_.expires_at - kEarlyRefreshWindow > now) {
+          if (waited) record_wait_time();
+          return credentials_;
+        }
+        // Refresh early; concurrent callers continue to use the current
+        // credentials.
+        break;
+      }
+      if (!refresh_in_progress_) break;
+      // Wait for the concurrent refresh rather than issuing another.
+      waited = true;
+      mutex_.Await(absl::Condition(
+          +[](bool* refresh_in_progress) { return !*refresh_in_progress; },
+          &refresh_in_progress_));
     }
+    expired = !(credentials_.expires_at > clock_());
+    refresh_in_progress_ = true;
   }
 
-  absl::WriterMutexLock lock(&mutex_);
+  Result<AwsCredentials> credentials_result;
+  {
+    absl::MutexLock refresh_lock(&refresh_mutex_);
+    credentials_result = Refresh(/*early=*/!expired);
+  }
 
+  absl::MutexLock lock(&mutex_);
+  refresh_in_progress_ = false;
+  if (credentials_result.ok()) {
+    credentials_ = *credentials_result;
+  } else if (!expired) {
+    // A failed early refresh is retried by a subsequent call.
+    credentials_result = credentials_;
+  }
+  if (expired) record_wait_time();
+  return credentials_result;
+}
+
+Result<AwsCredentials> DefaultAwsCredentialsProvider::Refresh(bool early) {
   // Refresh existing credentials
   if (provider_) {
     auto credentials_result = provider_->GetCredentials();
-    if (credentials_result.ok()) {
-      credentials_ = credentials_result.value();
-      return credentials_;
-    }
+    if (credentials_result.ok() || early) return credentials_result;
+  } else if (early) {
+    return absl::UnavailableError("No credential source to refresh");
   }
 
   bool only_default_options = options_.filename.empty() &&
@@ -128,8 +179,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
     provider_ = std::make_unique<EnvironmentCredentialProvider>();
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return credentials_result;
     } else if (s3_logging) {
       ABSL_LOG_FIRST_N(INFO, 1)
           << "Could not acquire credentials from environment: "
@@ -144,8 +194,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
                                                          options_.profile);
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return credentials_result;
     } else if (s3_logging) {
       ABSL_LOG_FIRST_N(INFO, 1)
           << "Could not acquire credentials from file/profile: "
@@ -159,8 +208,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
         options_.endpoint, options_.transport);
     if (auto credentials_result = provider_->GetCredentials();
         credentials_result.ok()) {
-      credentials_ = std::move(credentials_result).value();
-      return credentials_;
+      return credentials_result;
     } else if (s3_logging) {
       ABSL_LOG(INFO)
           << "Could not acquire credentials from EC2 Metadata Server "
@@ -170,8 +218,7 @@ Result<AwsCredentials> DefaultAwsCredentialsProvider::GetCredentials() {
 
   // 4. Anonymous credentials
   provider_ = nullptr;
-  credentials_ = AwsCredentials::Anonymous();
-  return credentials_;
+  return AwsCredentials::Anonymous();
 }
 
 }  // namespace internal_kvstore_s3
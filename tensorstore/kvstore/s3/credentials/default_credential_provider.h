@@ -42,9 +42,18 @@ namespace internal_kvstore_s3 {
 ///
 /// The cached credentials are returned until they expire,
 /// at which point the original source is queried again to
-/// obtain fresher credentials
+/// obtain fresher credentials.
+///
+/// At most one refresh is in progress at a time.  Once the credentials are
+/// within `kEarlyRefreshWindow` of expiring, a single caller queries the
+/// original source again while concurrent callers continue to use the current
+/// credentials; callers only block when the credentials have actually expired.
 class DefaultAwsCredentialsProvider : public AwsCredentialProvider {
  public:
+  /// Duration before expiration during which the credentials are refreshed
+  /// without blocking other callers.
+  static constexpr absl::Duration kEarlyRefreshWindow = absl::Minutes(5);
+
   /// Options to configure the provider. These include the:
   ///
   /// 1. Shared Credential Filename
@@ -61,14 +70,27 @@ class DefaultAwsCredentialsProvider : public AwsCredentialProvider {
   DefaultAwsCredentialsProvider(
       Options options = {{}, {}, {}, internal_http::GetDefaultHttpTransport()},
       absl::FunctionRef<absl::Time()> clock = absl::Now);
-  Result<AwsCredentials> GetCredentials() override;
+  Result<AwsCredentials> GetCredentials()
+      ABSL_LOCKS_EXCLUDED(mutex_, refresh_mutex_) override;
 
  private:
+  /// Obtains new credentials.
+  ///
+  /// If `early` is `true`, only the source of the current credentials is
+  /// queried; otherwise, each source is tried in order.
+  Result<AwsCredentials> Refresh(bool early)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(refresh_mutex_);
+
   Options options_;
   absl::FunctionRef<absl::Time()> clock_;
   absl::Mutex mutex_;
-  std::unique_ptr<AwsCredentialProvider> provider_ ABSL_GUARDED_BY(mutex_);
   AwsCredentials credentials_ ABSL_GUARDED_BY(mutex_);
+  bool refresh_in_progress_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Serializes calls to `Refresh`, which are made without holding `mutex_`.
+  absl::Mutex refresh_mutex_ ABSL_ACQUIRED_AFTER(mutex_);
+  std::unique_ptr<AwsCredentialProvider> provider_
+      ABSL_GUARDED_BY(refresh_mutex_);
 };
 
 using AwsCredentialProviderFn =
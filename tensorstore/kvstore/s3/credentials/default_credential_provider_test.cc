@@ -195,4 +195,37 @@ TEST_F(DefaultCredentialProviderTest, ConfigureEC2ProviderFromOptions) {
   EXPECT_EQ(credentials.expires_at, absl::InfiniteFuture());
 }
 
+/// Test that EC2 credentials are refreshed shortly before they expire.
+TEST_F(DefaultCredentialProviderTest, EarlyRefreshEC2Credentials) {
+  auto now = absl::Now();
+  auto stuck_clock = [&]() -> absl::Time { return now; };
+  auto expiry = now + absl::Hours(1);
+
+  auto mock_transport = std::make_shared<DefaultMockHttpTransport>(
+      DefaultEC2MetadataFlow(kEndpoint, "1234", "ASIA1234567890",
+                             "1234567890abcdef", "token", expiry));
+
+  auto provider = std::make_unique<DefaultAwsCredentialsProvider>(
+      Options{{}, {}, kEndpoint, mock_transport}, stuck_clock);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto credentials,
+                                   provider->GetCredentials());
+  EXPECT_EQ(credentials.session_token, "token");
+
+  // Outside of the early refresh window, the cached credentials are returned.
+  now += absl::Minutes(50);
+  auto new_expiry = now + absl::Hours(1);
+  mock_transport->Reset(
+      DefaultEC2MetadataFlow(kEndpoint, "1234", "ASIA1234567890",
+                             "1234567890abcdef", "TOKEN", new_expiry));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider->GetCredentials());
+  EXPECT_EQ(credentials.session_token, "token");
+
+  // Within the early refresh window, the credentials are refreshed before
+  // they expire.
+  now += absl::Minutes(6);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider->GetCredentials());
+  EXPECT_EQ(credentials.session_token, "TOKEN");
+  EXPECT_EQ(credentials.expires_at, new_expiry - absl::Seconds(60));
+}
+
 }  // namespace
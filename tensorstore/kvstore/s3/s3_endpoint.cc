@@ -81,6 +81,20 @@ struct S3PathFormatter {
   }
 };
 
+// S3 Express One Zone directory buckets are accessed using the zonal
+// endpoint of their availability zone:
+//
+// <bucket>.s3express-<zone_id>.<aws_region>.amazonaws.com
+//
+// https://docs.aws.amazon.com/AmazonS3/latest/userguide/s3-express-Regions-and-Zones.html
+struct S3ExpressFormatter {
+  std::string GetEndpoint(std::string_view bucket,
+                          std::string_view aws_region) const {
+    return absl::StrFormat("https://%s.s3express-%s.%s.amazonaws.com", bucket,
+                           DirectoryBucketZoneId(bucket), aws_region);
+  }
+};
+
 struct S3CustomFormatter {
   std::string endpoint;
 
@@ -142,6 +156,22 @@ std::variant<absl::Status, S3EndpointRegion> ValidateEndpoint(
     aws_region = "us-east-1";
   }
 
+  // The region of a directory bucket cannot be resolved with a HEAD request.
+  if (internal_kvstore_s3::IsDirectoryBucket(bucket)) {
+    if (aws_region.empty()) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Directory bucket ", QuoteString(bucket),
+                              " requires \"aws_region\""));
+    }
+    if (endpoint.empty()) {
+      S3ExpressFormatter formatter;
+      return S3EndpointRegion{
+          formatter.GetEndpoint(bucket, aws_region),
+          aws_region,
+      };
+    }
+  }
+
   if (endpoint.empty()) {
     if (!aws_region.empty()) {
       if (!absl::StrContains(bucket, ".")) {
@@ -76,6 +76,29 @@ TEST(ValidateEndpointTest, Basic) {
 
 // Mock-based tests for s3.
 
+TEST(ValidateEndpointTest, DirectoryBucket) {
+  // Directory buckets use the zonal endpoint.
+  EXPECT_THAT(ValidateEndpoint("bucket--usw2-az1--x-s3", "us-west-2", {}, {}),
+              ::testing::VariantWith<S3EndpointRegion>(S3EndpointRegion{
+                  "https://bucket--usw2-az1--x-s3.s3express-usw2-az1."
+                  "us-west-2.amazonaws.com",
+                  "us-west-2"}));
+
+  EXPECT_THAT(ValidateEndpoint("bucket--usw2-az1--x-s3", "us-west-2",
+                               "http://my.host", {}),
+              ::testing::VariantWith<S3EndpointRegion>(S3EndpointRegion{
+                  "http://my.host/bucket--usw2-az1--x-s3", "us-west-2"}));
+
+  // error: the region of a directory bucket is not resolved.
+  EXPECT_THAT(ValidateEndpoint("bucket--usw2-az1--x-s3", {}, {}, {}),
+              ::testing::VariantWith<absl::Status>(
+                  tensorstore::StatusIs(absl::StatusCode::kInvalidArgument)));
+  EXPECT_THAT(
+      ValidateEndpoint("bucket--usw2-az1--x-s3", {}, "http://my.host", {}),
+      ::testing::VariantWith<absl::Status>(
+          tensorstore::StatusIs(absl::StatusCode::kInvalidArgument)));
+}
+
 TEST(ResolveEndpointRegion, Basic) {
   absl::flat_hash_map<std::string, HttpResponse> url_to_response{
       // initial HEAD request responds with an x-amz-bucket-region header.
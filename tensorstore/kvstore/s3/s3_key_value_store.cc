@@ -15,16 +15,21 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
@@ -34,6 +39,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include <openssl/md5.h>
 #include "tensorstore/context.h"
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/digest/sha256.h"
@@ -47,19 +53,30 @@
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/histogram.h"
 #include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/source_location.h"
 #include "tensorstore/internal/thread/schedule_at.h"
 #include "tensorstore/internal/uri_utils.h"
+#include "tensorstore/kvstore/auto_batch.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/coalescing_policy.h"
+#include "tensorstore/kvstore/copy_range_util.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/generic_coalescing_batch_util.h"
 #include "tensorstore/kvstore/http/byte_range_util.h"
+#include "tensorstore/kvstore/http/hedged_read.h"
+#include "tensorstore/kvstore/http/parallel_byte_range_read.h"
+#include "tensorstore/kvstore/http/parallel_list.h"
 #include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_byte_budget.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/registry.h"
+#include "tensorstore/kvstore/single_flight_read.h"
+#include "tensorstore/kvstore/supported_features.h"
 #include "tensorstore/kvstore/s3/aws_credentials_resource.h"
 #include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
 #include "tensorstore/kvstore/s3/s3_endpoint.h"
@@ -67,9 +84,12 @@
 #include "tensorstore/kvstore/s3/s3_request_builder.h"
 #include "tensorstore/kvstore/s3/s3_resource.h"
 #include "tensorstore/kvstore/s3/s3_uri_utils.h"
+#include "tensorstore/kvstore/s3/s3express_session.h"
 #include "tensorstore/kvstore/s3/validate.h"
 #include "tensorstore/kvstore/spec.h"
+#include "tensorstore/kvstore/tenant_resource.h"
 #include "tensorstore/kvstore/url_registry.h"
+#include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/any_receiver.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/executor.h"
@@ -95,14 +115,21 @@ using ::tensorstore::internal::RateLimiter;
 using ::tensorstore::internal::RateLimiterNode;
 using ::tensorstore::internal::ScheduleAt;
 using ::tensorstore::internal::SHA256Digester;
+using ::tensorstore::internal_http::DelimitedListPage;
 using ::tensorstore::internal_http::HttpRequest;
 using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_http::HttpTransport;
+using ::tensorstore::internal_http::IsThrottlingStatus;
+using ::tensorstore::internal_kvstore::ReadByteBudgetResource;
+using ::tensorstore::internal_kvstore::TenantResource;
+using ::tensorstore::internal_kvstore_batch::AutoBatchResource;
 using ::tensorstore::internal_kvstore_s3::AwsCredentials;
 using ::tensorstore::internal_kvstore_s3::AwsCredentialsResource;
 using ::tensorstore::internal_kvstore_s3::AwsHttpResponseToStatus;
+using ::tensorstore::internal_kvstore_s3::EscapeXml;
 using ::tensorstore::internal_kvstore_s3::GetNodeInt;
 using ::tensorstore::internal_kvstore_s3::GetNodeText;
+using ::tensorstore::internal_kvstore_s3::IsDirectoryBucket;
 using ::tensorstore::internal_kvstore_s3::IsValidBucketName;
 using ::tensorstore::internal_kvstore_s3::IsValidObjectName;
 using ::tensorstore::internal_kvstore_s3::IsValidStorageGeneration;
@@ -110,8 +137,11 @@ using ::tensorstore::internal_kvstore_s3::S3ConcurrencyResource;
 using ::tensorstore::internal_kvstore_s3::S3EndpointRegion;
 using ::tensorstore::internal_kvstore_s3::S3RateLimiterResource;
 using ::tensorstore::internal_kvstore_s3::S3RequestBuilder;
+using ::tensorstore::internal_kvstore_s3::S3RequestHedging;
 using ::tensorstore::internal_kvstore_s3::S3RequestRetries;
+using ::tensorstore::internal_kvstore_s3::S3ExpressSessionProvider;
 using ::tensorstore::internal_kvstore_s3::S3UriEncode;
+using ::tensorstore::internal_kvstore_s3::S3UriObjectKeyEncode;
 using ::tensorstore::internal_kvstore_s3::StorageGenerationFromHeaders;
 using ::tensorstore::internal_metrics::MetricMetadata;
 using ::tensorstore::kvstore::Key;
@@ -166,6 +196,10 @@ auto& s3_delete_range = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/delete_range",
     MetricMetadata("S3 driver kvstore::DeleteRange calls"));
 
+auto& s3_copy_range = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/s3/copy_range",
+    MetricMetadata("S3 driver kvstore::ExperimentalCopyRange calls"));
+
 auto& s3_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/s3/list",
     MetricMetadata("S3 driver kvstore::List calls"));
@@ -184,6 +218,28 @@ static constexpr char kEmptyEtag[] = "\"\"";
 
 static constexpr size_t kMaxS3PutSize = size_t{5} * 1024 * 1024 * 1024;  // 5GB
 
+/// Limits on multipart uploads.
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/qfacts.html
+static constexpr size_t kMinS3PartSize = size_t{5} * 1024 * 1024;  // 5MB
+static constexpr size_t kMaxS3Parts = 10000;
+static constexpr size_t kMaxS3ObjectSize = kMaxS3PutSize * 1024;  // 5TB
+
+/// Maximum number of keys of a DeleteObjects request.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_DeleteObjects.html
+static constexpr size_t kMaxDeleteObjectsKeys = 1000;
+
+/// Default multipart upload parameters.
+static constexpr size_t kDefaultMultipartThreshold = size_t{64} * 1024 * 1024;
+static constexpr size_t kDefaultMultipartPartSize = size_t{16} * 1024 * 1024;
+
+/// Default read coalescing parameters, used until the latency and bandwidth
+/// have been estimated.
+static constexpr internal_kvstore_batch::CoalescingOptions
+    kDefaultCoalescingOptions = {
+        /*.max_extra_read_bytes=*/4095,
+        /*.target_coalesced_size=*/128 * 1024 * 1024,
+};
+
 /// Adds the generation header to the provided builder.
 bool AddGenerationHeader(S3RequestBuilder* builder, std::string_view header,
                          const StorageGeneration& gen) {
@@ -211,6 +267,20 @@ std::string payload_sha256(const absl::Cord& cord = absl::Cord()) {
   return absl::BytesToHexString(digest_sv);
 }
 
+/// Returns the base64-encoded MD5 digest of `cord`, as required by the
+/// `Content-MD5` header.
+std::string payload_md5(const absl::Cord& cord) {
+  MD5_CTX ctx;
+  MD5_Init(&ctx);
+  for (std::string_view chunk : cord.Chunks()) {
+    MD5_Update(&ctx, chunk.data(), chunk.size());
+  }
+  unsigned char digest[MD5_DIGEST_LENGTH];
+  MD5_Final(digest, &ctx);
+  return absl::Base64Escape(
+      std::string_view(reinterpret_cast<const char*>(digest), sizeof(digest)));
+}
+
 bool DefaultIsRetryableCode(absl::StatusCode code) {
   return code == absl::StatusCode::kDeadlineExceeded ||
          code == absl::StatusCode::kUnavailable;
@@ -227,12 +297,24 @@ struct S3KeyValueStoreSpecData {
   Context::Resource<S3ConcurrencyResource> request_concurrency;
   std::optional<Context::Resource<S3RateLimiterResource>> rate_limiter;
   Context::Resource<S3RequestRetries> retries;
+  Context::Resource<S3RequestHedging> request_hedging;
+  Context::Resource<AutoBatchResource> auto_batch;
+  Context::Resource<ReadByteBudgetResource> read_byte_budget;
+  Context::Resource<TenantResource> tenant;
   Context::Resource<DataCopyConcurrencyResource> data_copy_concurrency;
 
+  size_t multipart_threshold = kDefaultMultipartThreshold;
+  size_t multipart_part_size = kDefaultMultipartPartSize;
+  std::optional<int64_t> parallel_read_part_size;
+  internal_kvstore_batch::CoalescingOverrides read_coalescing;
+
   constexpr static auto ApplyMembers = [](auto& x, auto f) {
     return f(x.bucket, x.requester_pays, x.endpoint, x.host_header,
              x.aws_region, x.aws_credentials, x.request_concurrency,
-             x.rate_limiter, x.retries, x.data_copy_concurrency);
+             x.rate_limiter, x.retries, x.request_hedging, x.auto_batch,
+             x.read_byte_budget, x.tenant, x.data_copy_concurrency,
+             x.multipart_threshold, x.multipart_part_size,
+             x.parallel_read_part_size, x.read_coalescing);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -266,9 +348,37 @@ struct S3KeyValueStoreSpecData {
                  jb::Projection<&S3KeyValueStoreSpecData::rate_limiter>()),
       jb::Member(S3RequestRetries::id,
                  jb::Projection<&S3KeyValueStoreSpecData::retries>()),
+      jb::Member(S3RequestHedging::id,
+                 jb::Projection<&S3KeyValueStoreSpecData::request_hedging>()),
+      jb::Member(AutoBatchResource::id,
+                 jb::Projection<&S3KeyValueStoreSpecData::auto_batch>()),
+      jb::Member(
+          ReadByteBudgetResource::id,
+          jb::Projection<&S3KeyValueStoreSpecData::read_byte_budget>()),
+      jb::Member(TenantResource::id,
+                 jb::Projection<&S3KeyValueStoreSpecData::tenant>()),
       jb::Member(DataCopyConcurrencyResource::id,
                  jb::Projection<
-                     &S3KeyValueStoreSpecData::data_copy_concurrency>()) /**/
+                     &S3KeyValueStoreSpecData::data_copy_concurrency>()),
+      jb::Member(
+          "multipart_threshold",
+          jb::Projection<&S3KeyValueStoreSpecData::multipart_threshold>(
+              jb::DefaultValue(
+                  [](auto* v) { *v = kDefaultMultipartThreshold; },
+                  jb::Integer<size_t>(1, kMaxS3PutSize)))),
+      jb::Member(
+          "multipart_part_size",
+          jb::Projection<&S3KeyValueStoreSpecData::multipart_part_size>(
+              jb::DefaultValue(
+                  [](auto* v) { *v = kDefaultMultipartPartSize; },
+                  jb::Integer<size_t>(kMinS3PartSize, kMaxS3PutSize)))),
+      jb::Member(
+          "parallel_read_part_size",
+          jb::Projection<&S3KeyValueStoreSpecData::parallel_read_part_size>(
+              jb::Optional(jb::Integer<int64_t>(1)))),
+      jb::Member("read_coalescing",
+                 jb::Projection<&S3KeyValueStoreSpecData::read_coalescing>(
+                     jb::DefaultInitializedValue())) /**/
   );
 };
 
@@ -276,6 +386,14 @@ std::string GetS3Url(std::string_view bucket, std::string_view path) {
   return tensorstore::StrCat(kUriScheme, "://", bucket, "/", S3UriEncode(path));
 }
 
+/// Returns the generation of a `<Contents>` element of a List response, which
+/// is derived from the ETag in the same way as for a GetObject response.
+StorageGeneration ListGeneration(tinyxml2::XMLElement* contents) {
+  auto* etag_node = contents->FirstChildElement("ETag");
+  if (etag_node == nullptr) return StorageGeneration::Unknown();
+  return StorageGeneration::FromString(GetNodeText(etag_node));
+}
+
 class S3KeyValueStoreSpec
     : public internal_kvstore::RegisteredDriverSpec<S3KeyValueStoreSpec,
                                                     S3KeyValueStoreSpecData> {
@@ -297,33 +415,66 @@ class S3KeyValueStore
                   S3KeyValueStoreSpecData spec)
       : transport_(std::move(transport)),
         spec_(std::move(spec)),
-        host_header_(spec_.host_header.value_or(std::string())) {}
+        host_header_(spec_.host_header.value_or(std::string())),
+        coalescing_policy_(kDefaultCoalescingOptions, spec_.read_coalescing) {}
+
+  internal_kvstore_batch::CoalescingPolicy& coalescing_policy() {
+    return coalescing_policy_;
+  }
 
-  internal_kvstore_batch::CoalescingOptions GetBatchReadCoalescingOptions()
-      const {
-    internal_kvstore_batch::CoalescingOptions options;
-    options.max_extra_read_bytes = 4095;
-    options.target_coalesced_size = 128 * 1024 * 1024;
-    return options;
+  internal_kvstore_batch::SingleFlightReads& single_flight_reads() {
+    return single_flight_reads_;
   }
 
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
   Future<ReadResult> ReadImpl(Key&& key, ReadOptions&& options);
 
+  /// Issues a single read request.
+  Future<ReadResult> ReadPart(const Key& key, ReadOptions options);
+
   Future<TimestampedStorageGeneration> Write(Key key,
                                              std::optional<Value> value,
                                              WriteOptions options) override;
 
   void ListImpl(ListOptions options, ListReceiver receiver) override;
 
+  /// Lists the first page of the objects with the prefix
+  /// `LongestPrefix(range)`, using `/` as the delimiter.
+  Future<DelimitedListPage> ListPage(KeyRange range);
+
   Future<const void> DeleteRange(KeyRange range) override;
 
+  /// Copies the keys of another `s3` kvstore with the same endpoint using
+  /// server-side copies, such that the data is never transferred through the
+  /// client.  Otherwise, falls back to the default implementation.
+  Future<const void> ExperimentalCopyRangeFrom(
+      const internal::OpenTransactionPtr& transaction,
+      const kvstore::KvStore& source, Key target_prefix,
+      kvstore::CopyRangeOptions options) override;
+
+  /// Copies the object `source_key` of `source_bucket`, whose size is `size`
+  /// or `-1` if unknown, to `key` with CopyObject or, if it is large, with a
+  /// multipart upload of UploadPartCopy requests.
+  Future<TimestampedStorageGeneration> CopyObject(std::string source_bucket,
+                                                  std::string source_key,
+                                                  std::string key,
+                                                  int64_t size);
+
+  /// Unconditionally deletes up to `kMaxDeleteObjectsKeys` objects with a
+  /// single DeleteObjects request.
+  Future<const void> DeleteObjects(std::vector<std::string> keys);
+
   absl::Status GetBoundSpecData(SpecData& spec) const {
     spec = spec_;
     return absl::OkStatus();
   }
 
+  kvstore::SupportedFeatures GetSupportedFeatures(
+      const KeyRange& key_range) const final {
+    return kvstore::SupportedFeatures::kListGenerations;
+  }
+
   const Executor& executor() const {
     return spec_.data_copy_concurrency->executor;
   }
@@ -341,9 +492,23 @@ class S3KeyValueStore
     return no_rate_limiter_;
   }
 
-  RateLimiter& admission_queue() { return *spec_.request_concurrency->queue; }
+  RateLimiter& admission_queue() {
+    if (adaptive_queue_) return *adaptive_queue_;
+    return *spec_.request_concurrency->queue;
+  }
+
+  // Admits `node` to the admission queue on behalf of the tenant.
+  void AdmitRequest(RateLimiterNode* node, RateLimiterNode::StartFn fn) {
+    node->tenant_ = spec_.tenant->tenant.get();
+    admission_queue().Admit(node, fn);
+  }
 
   Result<std::optional<AwsCredentials>> GetCredentials() {
+    if (session_provider_) {
+      TENSORSTORE_ASSIGN_OR_RETURN(auto credentials,
+                                   session_provider_->GetCredentials());
+      return std::optional<AwsCredentials>(std::move(credentials));
+    }
     return spec_.aws_credentials->GetCredentials();
   }
 
@@ -359,6 +524,9 @@ class S3KeyValueStore
       absl::Status status, int attempt, Task* task,
       SourceLocation loc = ::tensorstore::SourceLocation::current()) {
     assert(task != nullptr);
+    if (adaptive_queue_ && IsThrottlingStatus(status)) {
+      adaptive_queue_->OnThrottled();
+    }
     auto delay = spec_.retries->BackoffForAttempt(attempt);
     if (!delay) {
       return MaybeAnnotateStatus(std::move(status),
@@ -376,9 +544,18 @@ class S3KeyValueStore
   }
 
   internal::NoRateLimiter no_rate_limiter_;
+  // Admission queue for the bucket when `request_concurrency` is adaptive.
+  std::shared_ptr<internal::AimdAdmissionQueue> adaptive_queue_;
   std::shared_ptr<HttpTransport> transport_;
   S3KeyValueStoreSpecData spec_;
   std::string host_header_;
+  internal_kvstore_batch::CoalescingPolicy coalescing_policy_;
+  internal_kvstore_batch::SingleFlightReads single_flight_reads_;
+  // Whether the bucket is an S3 Express One Zone directory bucket, whose
+  // listings are not sorted and only support prefixes ending in `/`.
+  bool directory_bucket_ = false;
+  // Provides the session credentials of a directory bucket.
+  std::unique_ptr<S3ExpressSessionProvider> session_provider_;
 
   absl::Mutex mutex_;  // Guards resolve_ehr_ creation.
   Future<const S3EndpointRegion> resolve_ehr_;
@@ -404,14 +581,16 @@ struct ReadTask : public RateLimiterNode,
       : owner(std::move(owner)),
         object_name(std::move(object_name)),
         options(std::move(options)),
-        promise(std::move(promise)) {}
+        promise(std::move(promise)) {
+    priority_ = static_cast<int>(this->options.priority);
+  }
 
   ~ReadTask() { owner->admission_queue().Finish(this); }
 
   static void Start(void* task) {
     auto* self = reinterpret_cast<ReadTask*>(task);
     self->owner->read_rate_limiter().Finish(self);
-    self->owner->admission_queue().Admit(self, &ReadTask::Admit);
+    self->owner->AdmitRequest(self, &ReadTask::Admit);
   }
 
   static void Admit(void* task) {
@@ -456,7 +635,9 @@ struct ReadTask : public RateLimiterNode,
                                      ehr.aws_region, kEmptySha256, start_time_);
 
     ABSL_LOG_IF(INFO, s3_logging) << "ReadTask: " << request;
-    auto future = owner->transport_->IssueRequest(request, {});
+    auto future = owner->transport_->IssueRequest(
+        request, internal_http::IssueRequestOptions().SetResponseSizeHint(
+                     std::max<int64_t>(0, options.byte_range.size())));
     future.ExecuteWhenReady([self = IntrusivePtr<ReadTask>(this)](
                                 ReadyFuture<HttpResponse> response) {
       self->OnResponse(response.result());
@@ -553,12 +734,45 @@ Future<kvstore::ReadResult> S3KeyValueStore::Read(Key key,
     return absl::InvalidArgumentError("Malformed StorageGeneration");
   }
   return internal_kvstore_batch::HandleBatchRequestByGenericByteRangeCoalescing(
-      *this, std::move(key), std::move(options));
+      *this, std::move(key), std::move(options),
+      spec_.auto_batch->batcher.get());
 }
 
 Future<kvstore::ReadResult> S3KeyValueStore::ReadImpl(Key&& key,
                                                       ReadOptions&& options) {
   s3_batch_read.Increment();
+  const auto& hedger = spec_.request_hedging->hedger;
+  const auto& budget = spec_.read_byte_budget->budget;
+  if (!spec_.parallel_read_part_size && !hedger && !budget) {
+    return ReadPart(key, std::move(options));
+  }
+  internal_http::ReadPartFunction read_part =
+      [self = internal::IntrusivePtr<S3KeyValueStore>(this),
+       key = std::move(key)](ReadOptions options) {
+        return self->ReadPart(key, std::move(options));
+      };
+  if (hedger) {
+    read_part = [hedger, read_part = std::move(read_part)](
+                    ReadOptions options) {
+      return internal_http::HedgedRead(hedger, std::move(options), read_part);
+    };
+  }
+  if (budget) {
+    read_part = [budget, executor = executor(),
+                 read_part = std::move(read_part)](ReadOptions options) {
+      return budget->Read(executor, std::move(options), read_part);
+    };
+  }
+  if (spec_.parallel_read_part_size) {
+    return internal_http::ParallelByteRangeRead(
+        std::move(options), *spec_.parallel_read_part_size,
+        std::move(read_part));
+  }
+  return read_part(std::move(options));
+}
+
+Future<kvstore::ReadResult> S3KeyValueStore::ReadPart(const Key& key,
+                                                      ReadOptions options) {
   auto op = PromiseFuturePair<ReadResult>::Make();
   auto state = internal::MakeIntrusivePtr<ReadTask>(
       internal::IntrusivePtr<S3KeyValueStore>(this), key, std::move(options),
@@ -610,7 +824,7 @@ struct ConditionTask : public RateLimiterNode,
   static void Start(void* task) {
     auto* self = reinterpret_cast<Base*>(task);
     self->owner->write_rate_limiter().Finish(self);
-    self->owner->admission_queue().Admit(self, &Base::Admit);
+    self->owner->AdmitRequest(self, &Base::Admit);
   }
 
   static void Admit(void* task) {
@@ -661,6 +875,404 @@ struct ConditionTask : public RateLimiterNode,
   }
 };
 
+/// Returns an error if `response`, which has a successful status, contains an
+/// `<Error>` element.
+///
+/// CompleteMultipartUpload and the copy requests may fail after returning a 200
+/// status.
+absl::Status CheckForErrorElement(const HttpResponse& response,
+                                  bool& is_retryable) {
+  auto cord = response.payload;
+  auto payload = cord.Flatten();
+  tinyxml2::XMLDocument xmlDocument;
+  if (xmlDocument.Parse(payload.data(), payload.size()) ==
+          tinyxml2::XML_SUCCESS &&
+      xmlDocument.FirstChildElement("Error") != nullptr) {
+    HttpResponse error_response = response;
+    error_response.status_code = 500;
+    return AwsHttpResponseToStatus(error_response, is_retryable);
+  }
+  return absl::OkStatus();
+}
+
+/// Uploads a value using an S3 multipart upload.
+///
+/// The value is split into parts which are uploaded in parallel, subject to
+/// the request concurrency and rate limits, and then combined into the final
+/// object by CompleteMultipartUpload.  A failed part is retried on its own,
+/// and if the upload cannot be completed it is aborted so that the uploaded
+/// parts are not retained by S3.
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/mpuoverview.html
+///
+/// Like a single PUT, the generation condition is checked by the `WriteTask`
+/// before the upload is started.
+///
+/// Alternatively, the parts are copied from an existing object by
+/// UploadPartCopy requests, which is used to copy objects that are too large
+/// for a single CopyObject request.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_UploadPartCopy.html
+struct MultipartUploadTask
+    : public internal::AtomicReferenceCount<MultipartUploadTask> {
+  enum class RequestKind { kCreate, kUploadPart, kComplete, kAbort };
+
+  IntrusivePtr<S3KeyValueStore> owner;
+  ReadyFuture<const S3EndpointRegion> endpoint_region_;
+  std::string object_url_;
+  absl::Cord value_;
+  // `x-amz-copy-source` of the object to copy, or empty to upload `value_`.
+  std::string copy_source_;
+  size_t size_;
+  Promise<TimestampedStorageGeneration> promise;
+  size_t part_size_;
+  absl::Time start_time_;
+
+  // Set by the CreateMultipartUpload response, before any part is uploaded.
+  std::string upload_id_;
+  // ETag of each part, set by its UploadPart response.
+  std::vector<std::string> part_etags_;
+  std::atomic<size_t> parts_remaining_{0};
+  std::atomic<bool> failed_{false};
+
+  absl::Mutex mutex_;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+
+  MultipartUploadTask(IntrusivePtr<S3KeyValueStore> owner,
+                      ReadyFuture<const S3EndpointRegion> endpoint_region,
+                      std::string object_url, absl::Cord value,
+                      Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        endpoint_region_(std::move(endpoint_region)),
+        object_url_(std::move(object_url)),
+        value_(std::move(value)),
+        size_(value_.size()),
+        promise(std::move(promise)) {
+    InitParts();
+  }
+
+  MultipartUploadTask(IntrusivePtr<S3KeyValueStore> owner,
+                      ReadyFuture<const S3EndpointRegion> endpoint_region,
+                      std::string object_url, std::string copy_source,
+                      size_t size,
+                      Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        endpoint_region_(std::move(endpoint_region)),
+        object_url_(std::move(object_url)),
+        copy_source_(std::move(copy_source)),
+        size_(size),
+        promise(std::move(promise)) {
+    InitParts();
+  }
+
+  void InitParts() {
+    // Increase the part size if necessary to stay within the part limit.
+    part_size_ = std::max(owner->spec_.multipart_part_size,
+                          (size_ + kMaxS3Parts - 1) / kMaxS3Parts);
+    part_etags_.resize((size_ + part_size_ - 1) / part_size_);
+  }
+
+  bool IsCancelled() const {
+    return failed_.load(std::memory_order_relaxed) || !promise.result_needed();
+  }
+
+  ByteRange GetPartRange(size_t part_index) const {
+    const size_t offset = part_index * part_size_;
+    return ByteRange{static_cast<int64_t>(offset),
+                     static_cast<int64_t>(
+                         offset + std::min(part_size_, size_ - offset))};
+  }
+
+  absl::Cord GetPart(size_t part_index) const {
+    auto range = GetPartRange(part_index);
+    return value_.Subcord(range.inclusive_min, range.size());
+  }
+
+  void Start() {
+    start_time_ = absl::Now();
+    Issue(RequestKind::kCreate);
+  }
+
+  void Issue(RequestKind kind, size_t part_index = 0);
+
+  /// Builds the request and its payload.
+  std::pair<HttpRequest, absl::Cord> BuildRequest(
+      RequestKind kind, size_t part_index, const AwsCredentials& credentials) {
+    auto builder = S3RequestBuilder(
+        kind == RequestKind::kUploadPart
+            ? "PUT"
+            : (kind == RequestKind::kAbort ? "DELETE" : "POST"),
+        object_url_);
+    absl::Cord payload;
+    switch (kind) {
+      case RequestKind::kCreate:
+        builder.AddQueryParameter("uploads", "");
+        break;
+      case RequestKind::kUploadPart:
+        builder.AddQueryParameter("partNumber", absl::StrCat(part_index + 1))
+            .AddQueryParameter("uploadId", upload_id_);
+        if (!copy_source_.empty()) {
+          auto range = GetPartRange(part_index);
+          builder
+              .AddHeader(absl::StrCat("x-amz-copy-source: ", copy_source_))
+              .AddHeader(absl::StrCat("x-amz-copy-source-range: bytes=",
+                                      range.inclusive_min, "-",
+                                      range.exclusive_max - 1));
+          break;
+        }
+        payload = GetPart(part_index);
+        builder.AddHeader("Content-Type: application/octet-stream");
+        break;
+      case RequestKind::kComplete:
+        payload.Append("<CompleteMultipartUpload>");
+        for (size_t i = 0; i < part_etags_.size(); ++i) {
+          payload.Append(absl::StrCat("<Part><PartNumber>", i + 1,
+                                      "</PartNumber><ETag>", part_etags_[i],
+                                      "</ETag></Part>"));
+        }
+        payload.Append("</CompleteMultipartUpload>");
+        builder.AddQueryParameter("uploadId", upload_id_)
+            .AddHeader("Content-Type: application/xml");
+        break;
+      case RequestKind::kAbort:
+        builder.AddQueryParameter("uploadId", upload_id_);
+        break;
+    }
+    if (!payload.empty()) {
+      builder.AddHeader(absl::StrCat("Content-Length: ", payload.size()));
+    }
+    const auto& ehr = endpoint_region_.value();
+    auto request = builder.MaybeAddRequesterPayer(owner->spec_.requester_pays)
+                       .BuildRequest(owner->host_header_, credentials,
+                                     ehr.aws_region,
+                                     payload.empty() ? std::string(kEmptySha256)
+                                                     : payload_sha256(payload),
+                                     absl::Now());
+    return {std::move(request), std::move(payload)};
+  }
+
+  /// Parses a successful response.
+  absl::Status OnResponse(RequestKind kind, size_t part_index,
+                          const HttpResponse& response, bool& is_retryable) {
+    switch (kind) {
+      case RequestKind::kCreate: {
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto root_text,
+            ParseXmlResponse(response, "InitiateMultipartUploadResult",
+                             "UploadId"));
+        upload_id_ = std::move(root_text);
+        return absl::OkStatus();
+      }
+      case RequestKind::kUploadPart: {
+        if (!copy_source_.empty()) {
+          TENSORSTORE_RETURN_IF_ERROR(
+              CheckForErrorElement(response, is_retryable));
+          TENSORSTORE_ASSIGN_OR_RETURN(
+              part_etags_[part_index],
+              ParseXmlResponse(response, "CopyPartResult", "ETag"));
+          return absl::OkStatus();
+        }
+        auto it = response.headers.find("etag");
+        if (it == response.headers.end()) {
+          return absl::NotFoundError("etag not found in response headers");
+        }
+        part_etags_[part_index] = it->second;
+        s3_bytes_written.IncrementBy(GetPart(part_index).size());
+        return absl::OkStatus();
+      }
+      case RequestKind::kComplete: {
+        TENSORSTORE_RETURN_IF_ERROR(
+            CheckForErrorElement(response, is_retryable));
+        TENSORSTORE_ASSIGN_OR_RETURN(
+            auto etag, ParseXmlResponse(response,
+                                        "CompleteMultipartUploadResult",
+                                        "ETag"));
+        etag_ = std::move(etag);
+        return absl::OkStatus();
+      }
+      case RequestKind::kAbort:
+        return absl::OkStatus();
+    }
+    ABSL_UNREACHABLE();
+  }
+
+  /// Returns the text of the `element` child of the root element `root`.
+  static Result<std::string> ParseXmlResponse(const HttpResponse& response,
+                                              const char* root,
+                                              const char* element) {
+    auto cord = response.payload;
+    auto payload = cord.Flatten();
+    tinyxml2::XMLDocument xmlDocument;
+    if (int xmlcode = xmlDocument.Parse(payload.data(), payload.size());
+        xmlcode != tinyxml2::XML_SUCCESS) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Malformed ", root, " response: ", xmlcode));
+    }
+    auto* root_node = xmlDocument.FirstChildElement(root);
+    auto* node = root_node ? root_node->FirstChildElement(element) : nullptr;
+    if (node == nullptr) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Malformed ", root, " response: missing <", element, ">"));
+    }
+    return GetNodeText(node);
+  }
+
+  /// Called once each request has completed (after any retries).
+  void OnRequestDone(RequestKind kind, absl::Status status) {
+    switch (kind) {
+      case RequestKind::kCreate:
+        if (!status.ok()) {
+          promise.SetResult(std::move(status));
+          return;
+        }
+        parts_remaining_ = part_etags_.size();
+        for (size_t i = 0; i < part_etags_.size(); ++i) {
+          Issue(RequestKind::kUploadPart, i);
+        }
+        return;
+      case RequestKind::kUploadPart:
+        if (!status.ok()) {
+          Fail(std::move(status));
+        }
+        if (parts_remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+          return;
+        }
+        if (failed_.load(std::memory_order_relaxed)) {
+          Abort();
+        } else {
+          Issue(RequestKind::kComplete);
+        }
+        return;
+      case RequestKind::kComplete:
+        if (!status.ok()) {
+          Fail(std::move(status));
+          Abort();
+          return;
+        }
+        FinishUpload();
+        return;
+      case RequestKind::kAbort:
+        ABSL_LOG_IF(INFO, s3_logging && !status.ok())
+            << "Failed to abort multipart upload " << upload_id_ << ": "
+            << status;
+        absl::MutexLock lock(&mutex_);
+        promise.SetResult(status_);
+        return;
+    }
+  }
+
+  void Fail(absl::Status status) {
+    absl::MutexLock lock(&mutex_);
+    if (status_.ok()) status_ = std::move(status);
+    failed_.store(true, std::memory_order_relaxed);
+  }
+
+  /// Aborts the upload after a failure, and then fails the write.
+  void Abort() { Issue(RequestKind::kAbort); }
+
+  void FinishUpload() {
+    auto latency = absl::Now() - start_time_;
+    s3_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+    promise.SetResult(TimestampedStorageGeneration{
+        StorageGeneration::FromString(etag_), start_time_});
+  }
+
+  // ETag of the completed object.
+  std::string etag_;
+};
+
+/// A single request of a `MultipartUploadTask`, which is admitted and retried
+/// independently of the other requests.
+struct MultipartUploadRequest
+    : public RateLimiterNode,
+      public internal::AtomicReferenceCount<MultipartUploadRequest> {
+  using RequestKind = MultipartUploadTask::RequestKind;
+
+  IntrusivePtr<MultipartUploadTask> upload;
+  RequestKind kind;
+  size_t part_index;
+  int attempt_ = 0;
+
+  MultipartUploadRequest(IntrusivePtr<MultipartUploadTask> upload,
+                         RequestKind kind, size_t part_index)
+      : upload(std::move(upload)), kind(kind), part_index(part_index) {}
+
+  ~MultipartUploadRequest() { upload->owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<MultipartUploadRequest*>(task);
+    self->upload->owner->write_rate_limiter().Finish(self);
+    self->upload->owner->AdmitRequest(self, &MultipartUploadRequest::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<MultipartUploadRequest*>(task);
+    self->upload->owner->executor()(
+        [state = IntrusivePtr<MultipartUploadRequest>(
+             self, internal::adopt_object_ref)] { state->Retry(); });
+  }
+
+  void Retry() {
+    if (kind != RequestKind::kAbort && upload->IsCancelled()) {
+      upload->OnRequestDone(kind, absl::CancelledError());
+      return;
+    }
+    AwsCredentials credentials;
+    if (auto maybe_credentials = upload->owner->GetCredentials();
+        !maybe_credentials.ok()) {
+      upload->OnRequestDone(kind, maybe_credentials.status());
+      return;
+    } else if (maybe_credentials.value().has_value()) {
+      credentials = std::move(*maybe_credentials.value());
+    }
+
+    auto [request, payload] =
+        upload->BuildRequest(kind, part_index, credentials);
+    ABSL_LOG_IF(INFO, s3_logging)
+        << "MultipartUpload: " << request << " size=" << payload.size();
+
+    auto future = upload->owner->transport_->IssueRequest(
+        request, internal_http::IssueRequestOptions(std::move(payload)));
+    future.ExecuteWhenReady(
+        [self = IntrusivePtr<MultipartUploadRequest>(this)](
+            ReadyFuture<HttpResponse> response) {
+          self->OnResponse(response.result());
+        });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    ABSL_LOG_IF(INFO, s3_logging.Level(1) && response.ok())
+        << "MultipartUpload " << *response;
+
+    bool is_retryable = false;
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) {
+        is_retryable = DefaultIsRetryableCode(response.status().code());
+        return response.status();
+      }
+      TENSORSTORE_RETURN_IF_ERROR(
+          AwsHttpResponseToStatus(response.value(), is_retryable));
+      return upload->OnResponse(kind, part_index, response.value(),
+                                is_retryable);
+    }();
+    if (!status.ok() && is_retryable) {
+      status = upload->owner->BackoffForAttemptAsync(std::move(status),
+                                                     attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    upload->OnRequestDone(kind, std::move(status));
+  }
+};
+
+void MultipartUploadTask::Issue(RequestKind kind, size_t part_index) {
+  auto request = internal::MakeIntrusivePtr<MultipartUploadRequest>(
+      IntrusivePtr<MultipartUploadTask>(this), kind, part_index);
+  intrusive_ptr_increment(
+      request.get());  // adopted by MultipartUploadRequest::Admit.
+  owner->write_rate_limiter().Admit(request.get(),
+                                    &MultipartUploadRequest::Start);
+}
+
 // A WriteTask is a function object used to satisfy S3KeyValueStore::Write.
 struct WriteTask : public ConditionTask<WriteTask> {
   using Base = ConditionTask<WriteTask>;
@@ -722,6 +1334,17 @@ struct WriteTask : public ConditionTask<WriteTask> {
     // Some more headers need to be added to allow POST to work:
     // https://docs.aws.amazon.com/AmazonS3/latest/API/sigv4-authentication-HTTPPOST.html
 
+    if (value_.size() >= owner->spec_.multipart_threshold ||
+        value_.size() > kMaxS3PutSize) {
+      // The admission slot of this task is released once it is destroyed,
+      // which allows the requests of the upload to be admitted.
+      internal::MakeIntrusivePtr<MultipartUploadTask>(
+          owner, endpoint_region_, object_url_, std::move(value_),
+          std::move(promise))
+          ->Start();
+      return;
+    }
+
     start_time_ = absl::Now();
     auto content_sha256 = payload_sha256(value_);
 
@@ -797,6 +1420,133 @@ struct WriteTask : public ConditionTask<WriteTask> {
   }
 };
 
+/// A CopyObjectTask copies an object within S3, without transferring the data
+/// through the client.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CopyObject.html
+struct CopyObjectTask : public RateLimiterNode,
+                        public internal::AtomicReferenceCount<CopyObjectTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  ReadyFuture<const S3EndpointRegion> endpoint_region_;
+  std::string object_url_;
+  std::string copy_source_;
+  int64_t size_;
+  Promise<TimestampedStorageGeneration> promise;
+
+  int attempt_ = 0;
+  absl::Time start_time_;
+
+  CopyObjectTask(IntrusivePtr<S3KeyValueStore> owner,
+                 ReadyFuture<const S3EndpointRegion> endpoint_region,
+                 std::string object_url, std::string copy_source,
+                 int64_t size, Promise<TimestampedStorageGeneration> promise)
+      : owner(std::move(owner)),
+        endpoint_region_(std::move(endpoint_region)),
+        object_url_(std::move(object_url)),
+        copy_source_(std::move(copy_source)),
+        size_(size),
+        promise(std::move(promise)) {}
+
+  ~CopyObjectTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<CopyObjectTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &CopyObjectTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<CopyObjectTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<CopyObjectTask>(self,
+                                              internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    if (size_ > 0 &&
+        (static_cast<size_t>(size_) >= owner->spec_.multipart_threshold ||
+         static_cast<size_t>(size_) > kMaxS3PutSize)) {
+      // The admission slot of this task is released once it is destroyed,
+      // which allows the requests of the upload to be admitted.
+      internal::MakeIntrusivePtr<MultipartUploadTask>(
+          owner, endpoint_region_, object_url_, copy_source_,
+          static_cast<size_t>(size_), std::move(promise))
+          ->Start();
+      return;
+    }
+
+    AwsCredentials credentials;
+    if (auto maybe_credentials = owner->GetCredentials();
+        !maybe_credentials.ok()) {
+      promise.SetResult(maybe_credentials.status());
+      return;
+    } else if (maybe_credentials.value().has_value()) {
+      credentials = std::move(*maybe_credentials.value());
+    }
+
+    start_time_ = absl::Now();
+    const auto& ehr = endpoint_region_.value();
+    auto request =
+        S3RequestBuilder("PUT", object_url_)
+            .AddHeader(absl::StrCat("x-amz-copy-source: ", copy_source_))
+            .MaybeAddRequesterPayer(owner->spec_.requester_pays)
+            .BuildRequest(owner->host_header_, credentials, ehr.aws_region,
+                          kEmptySha256, start_time_);
+
+    ABSL_LOG_IF(INFO, s3_logging) << "CopyObjectTask: " << request;
+
+    auto future = owner->transport_->IssueRequest(request, {});
+    future.ExecuteWhenReady([self = IntrusivePtr<CopyObjectTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, s3_logging.Level(1) && response.ok())
+        << "CopyObjectTask " << *response;
+
+    bool is_retryable = false;
+    std::string etag;
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) {
+        is_retryable = DefaultIsRetryableCode(response.status().code());
+        return response.status();
+      }
+      TENSORSTORE_RETURN_IF_ERROR(
+          AwsHttpResponseToStatus(response.value(), is_retryable));
+      TENSORSTORE_RETURN_IF_ERROR(
+          CheckForErrorElement(response.value(), is_retryable));
+      TENSORSTORE_ASSIGN_OR_RETURN(
+          etag, MultipartUploadTask::ParseXmlResponse(
+                    response.value(), "CopyObjectResult", "ETag"));
+      return absl::OkStatus();
+    }();
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(status);
+      return;
+    }
+    auto latency = absl::Now() - start_time_;
+    s3_write_latency_ms.Observe(absl::ToInt64Milliseconds(latency));
+    promise.SetResult(TimestampedStorageGeneration{
+        StorageGeneration::FromString(etag), start_time_});
+  }
+};
+
 /// A DeleteTask is a function object used to satisfy S3KeyValueStore::Delete.
 struct DeleteTask : public ConditionTask<DeleteTask> {
   using Base = ConditionTask<DeleteTask>;
@@ -929,12 +1679,10 @@ Future<TimestampedStorageGeneration> S3KeyValueStore::Write(
   if (!IsValidStorageGeneration(options.generation_conditions.if_equal)) {
     return absl::InvalidArgumentError("Malformed StorageGeneration");
   }
-  if (value && value->size() > kMaxS3PutSize) {
-    // TODO: Support multi-part uploads of files larger than 5GB.
-    // Generally, asws-cli splits uploads which exceed ~8MB into multiple
-    // parts.
-    return absl::InvalidArgumentError(absl::StrCat(
-        "Object size ", value->size(), " exceeds S3 limit of ", kMaxS3PutSize));
+  if (value && value->size() > kMaxS3ObjectSize) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Object size ", value->size(), " exceeds S3 limit of ",
+                     kMaxS3ObjectSize));
   }
 
   auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
@@ -976,6 +1724,207 @@ Future<TimestampedStorageGeneration> S3KeyValueStore::Write(
   return std::move(op.future);
 }
 
+/// A DeleteObjectsTask is a function object used to satisfy a
+/// S3KeyValueStore::DeleteObjects request.
+///
+/// Up to `kMaxDeleteObjectsKeys` objects are deleted by a single
+/// DeleteObjects request.  Objects which do not exist are ignored, and
+/// objects whose deletion fails with a retryable error are retried in a
+/// subsequent request.
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_DeleteObjects.html
+struct DeleteObjectsTask
+    : public RateLimiterNode,
+      public internal::AtomicReferenceCount<DeleteObjectsTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  ReadyFuture<const S3EndpointRegion> endpoint_region_;
+  std::vector<std::string> keys_;
+  Promise<void> promise;
+
+  int attempt_ = 0;
+
+  DeleteObjectsTask(IntrusivePtr<S3KeyValueStore> owner,
+                    ReadyFuture<const S3EndpointRegion> endpoint_region,
+                    std::vector<std::string> keys, Promise<void> promise)
+      : owner(std::move(owner)),
+        endpoint_region_(std::move(endpoint_region)),
+        keys_(std::move(keys)),
+        promise(std::move(promise)) {}
+
+  ~DeleteObjectsTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<DeleteObjectsTask*>(task);
+    self->owner->write_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &DeleteObjectsTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<DeleteObjectsTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<DeleteObjectsTask>(self,
+                                                 internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    AwsCredentials credentials;
+    if (auto maybe_credentials = owner->GetCredentials();
+        !maybe_credentials.ok()) {
+      promise.SetResult(maybe_credentials.status());
+      return;
+    } else if (maybe_credentials.value().has_value()) {
+      credentials = std::move(*maybe_credentials.value());
+    }
+
+    // Quiet mode limits the response to the keys which could not be deleted.
+    absl::Cord payload;
+    payload.Append("<Delete><Quiet>true</Quiet>");
+    for (const auto& key : keys_) {
+      payload.Append(
+          absl::StrCat("<Object><Key>", EscapeXml(key), "</Key></Object>"));
+    }
+    payload.Append("</Delete>");
+
+    const auto& ehr = endpoint_region_.value();
+    auto request =
+        S3RequestBuilder("POST", tensorstore::StrCat(ehr.endpoint, "/"))
+            .AddQueryParameter("delete", "")
+            .AddHeader("Content-Type: application/xml")
+            .AddHeader(absl::StrCat("Content-Length: ", payload.size()))
+            .AddHeader(absl::StrCat("Content-MD5: ", payload_md5(payload)))
+            .MaybeAddRequesterPayer(owner->spec_.requester_pays)
+            .BuildRequest(owner->host_header_, credentials, ehr.aws_region,
+                          payload_sha256(payload), absl::Now());
+
+    ABSL_LOG_IF(INFO, s3_logging)
+        << "DeleteObjects: " << request << " keys=" << keys_.size();
+
+    auto future = owner->transport_->IssueRequest(
+        request, internal_http::IssueRequestOptions(std::move(payload)));
+    future.ExecuteWhenReady([self = IntrusivePtr<DeleteObjectsTask>(this)](
+                                ReadyFuture<HttpResponse> response) {
+      self->OnResponse(response.result());
+    });
+  }
+
+  /// Handles the errors reported for individual keys by a successful
+  /// response, retaining the keys whose deletion should be retried.
+  absl::Status OnDeleteResult(const HttpResponse& response,
+                              bool& is_retryable) {
+    auto cord = response.payload;
+    auto payload = cord.Flatten();
+    tinyxml2::XMLDocument xmlDocument;
+    if (int xmlcode = xmlDocument.Parse(payload.data(), payload.size());
+        xmlcode != tinyxml2::XML_SUCCESS) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Malformed DeleteObjects response: ", xmlcode));
+    }
+    if (xmlDocument.FirstChildElement("Error") != nullptr) {
+      // As with CompleteMultipartUpload, the request may fail after returning
+      // a 200 status.
+      HttpResponse error_response = response;
+      error_response.status_code = 500;
+      return AwsHttpResponseToStatus(error_response, is_retryable);
+    }
+    auto* root_node = xmlDocument.FirstChildElement("DeleteResult");
+    if (root_node == nullptr) {
+      return absl::InvalidArgumentError(
+          "Malformed DeleteObjects response: missing <DeleteResult>");
+    }
+
+    absl::Status status;
+    std::vector<std::string> remaining;
+    for (auto* error_node = root_node->FirstChildElement("Error");
+         error_node != nullptr;
+         error_node = error_node->NextSiblingElement("Error")) {
+      std::string key = GetNodeText(error_node->FirstChildElement("Key"));
+      std::string code = GetNodeText(error_node->FirstChildElement("Code"));
+      if (code == "NoSuchKey") continue;
+      std::string message = absl::StrCat(
+          "Failed to delete ", QuoteString(key), ": ", code, " ",
+          GetNodeText(error_node->FirstChildElement("Message")));
+      if (code == "InternalError" || code == "SlowDown" ||
+          code == "ServiceUnavailable") {
+        if (status.ok()) status = absl::UnavailableError(std::move(message));
+        remaining.push_back(std::move(key));
+        continue;
+      }
+      if (code == "AccessDenied") {
+        return absl::PermissionDeniedError(std::move(message));
+      }
+      return absl::UnknownError(std::move(message));
+    }
+    if (!remaining.empty()) {
+      if (remaining.size() < keys_.size()) {
+        // Progress was made; restart the backoff sequence.
+        attempt_ = 0;
+      }
+      keys_ = std::move(remaining);
+      is_retryable = true;
+    }
+    return status;
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, s3_logging.Level(1) && response.ok())
+        << "DeleteObjects " << *response;
+
+    bool is_retryable = false;
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) {
+        is_retryable = DefaultIsRetryableCode(response.status().code());
+        return response.status();
+      }
+      TENSORSTORE_RETURN_IF_ERROR(
+          AwsHttpResponseToStatus(response.value(), is_retryable));
+      return OnDeleteResult(response.value(), is_retryable);
+    }();
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(std::move(status));
+      return;
+    }
+    promise.SetResult(MakeResult());
+  }
+};
+
+Future<const void> S3KeyValueStore::DeleteObjects(
+    std::vector<std::string> keys) {
+  assert(!keys.empty() && keys.size() <= kMaxDeleteObjectsKeys);
+  auto op = PromiseFuturePair<void>::Make();
+  MaybeResolveRegion().ExecuteWhenReady(
+      [self = IntrusivePtr<S3KeyValueStore>(this),
+       promise = std::move(op.promise),
+       keys = std::move(keys)](ReadyFuture<const S3EndpointRegion> ready) {
+        if (!ready.status().ok()) {
+          promise.SetResult(ready.status());
+          return;
+        }
+        auto state = internal::MakeIntrusivePtr<DeleteObjectsTask>(
+            std::move(self), std::move(ready), std::move(keys),
+            std::move(promise));
+
+        intrusive_ptr_increment(
+            state.get());  // adopted by DeleteObjectsTask::Admit.
+        state->owner->write_rate_limiter().Admit(state.get(),
+                                                 &DeleteObjectsTask::Start);
+      });
+  return std::move(op.future);
+}
+
 /// ListTask implements the ListImpl execution flow.
 struct ListTask : public RateLimiterNode,
                   public internal::AtomicReferenceCount<ListTask> {
@@ -1014,7 +1963,7 @@ struct ListTask : public RateLimiterNode,
   static void Start(void* task) {
     auto* self = reinterpret_cast<ListTask*>(task);
     self->owner_->read_rate_limiter().Finish(self);
-    self->owner_->admission_queue().Admit(self, &ListTask::Admit);
+    self->owner_->AdmitRequest(self, &ListTask::Admit);
   }
   static void Admit(void* task) {
     auto* self = reinterpret_cast<ListTask*>(task);
@@ -1036,7 +1985,13 @@ struct ListTask : public RateLimiterNode,
     auto request_builder =
         S3RequestBuilder("GET", resource_).AddQueryParameter("list-type", "2");
     if (auto prefix = LongestPrefix(options_.range); !prefix.empty()) {
-      request_builder.AddQueryParameter("prefix", std::string(prefix));
+      if (owner_->directory_bucket_) {
+        // Directory buckets only support prefixes which end in `/`.
+        prefix = prefix.substr(0, prefix.rfind('/') + 1);
+      }
+      if (!prefix.empty()) {
+        request_builder.AddQueryParameter("prefix", std::string(prefix));
+      }
     }
     // NOTE: Consider adding a start-after query parameter, however that
     // would require a predecessor to inclusive_min key.
@@ -1138,6 +2093,8 @@ struct ListTask : public RateLimiterNode,
       if (key < options_.range.inclusive_min) continue;
       if (KeyRange::CompareKeyAndExclusiveMax(
               key, options_.range.exclusive_max) >= 0) {
+        // Directory buckets do not return keys in sorted order.
+        if (owner_->directory_bucket_) continue;
         // Objects are returned sorted in ascending order of the respective
         // key names, so after the current key exceeds exclusive max no
         // additional requests need to be made.
@@ -1152,8 +2109,8 @@ struct ListTask : public RateLimiterNode,
       // TODO: Visit /ListBucketResult/Contents/LastModified?
       if (key.size() > options_.strip_prefix_length) {
         execution::set_value(
-            receiver_,
-            ListEntry{key.substr(options_.strip_prefix_length), size});
+            receiver_, ListEntry{key.substr(options_.strip_prefix_length), size,
+                                 ListGeneration(contents)});
       }
     }
 
@@ -1177,6 +2134,172 @@ struct ListTask : public RateLimiterNode,
   }
 };
 
+/// ListPageTask issues a single ListObjectsV2 request with a `/` delimiter,
+/// which is used to partition the range listed by a concurrent `ListImpl`.
+struct ListPageTask : public RateLimiterNode,
+                      public internal::AtomicReferenceCount<ListPageTask> {
+  IntrusivePtr<S3KeyValueStore> owner;
+  ReadyFuture<const S3EndpointRegion> endpoint_region_;
+  std::string prefix_;
+  Promise<DelimitedListPage> promise;
+
+  int attempt_ = 0;
+
+  ListPageTask(IntrusivePtr<S3KeyValueStore> owner,
+               ReadyFuture<const S3EndpointRegion> endpoint_region,
+               std::string prefix, Promise<DelimitedListPage> promise)
+      : owner(std::move(owner)),
+        endpoint_region_(std::move(endpoint_region)),
+        prefix_(std::move(prefix)),
+        promise(std::move(promise)) {}
+
+  ~ListPageTask() { owner->admission_queue().Finish(this); }
+
+  static void Start(void* task) {
+    auto* self = reinterpret_cast<ListPageTask*>(task);
+    self->owner->read_rate_limiter().Finish(self);
+    self->owner->AdmitRequest(self, &ListPageTask::Admit);
+  }
+
+  static void Admit(void* task) {
+    auto* self = reinterpret_cast<ListPageTask*>(task);
+    self->owner->executor()(
+        [state = IntrusivePtr<ListPageTask>(self, internal::adopt_object_ref)] {
+          state->Retry();
+        });
+  }
+
+  void Retry() {
+    if (!promise.result_needed()) {
+      return;
+    }
+    AwsCredentials credentials;
+    if (auto maybe_credentials = owner->GetCredentials();
+        !maybe_credentials.ok()) {
+      promise.SetResult(maybe_credentials.status());
+      return;
+    } else if (maybe_credentials.value().has_value()) {
+      credentials = std::move(*maybe_credentials.value());
+    }
+
+    // https://docs.aws.amazon.com/AmazonS3/latest/API/API_ListObjectsV2.html
+    const auto& ehr = endpoint_region_.value();
+    auto request_builder =
+        S3RequestBuilder("GET", tensorstore::StrCat(ehr.endpoint, "/"))
+            .AddQueryParameter("delimiter", "/")
+            .AddQueryParameter("list-type", "2");
+    if (!prefix_.empty()) {
+      request_builder.AddQueryParameter("prefix", prefix_);
+    }
+    auto request =
+        request_builder.BuildRequest(owner->host_header_, credentials,
+                                     ehr.aws_region, kEmptySha256, absl::Now());
+
+    ABSL_LOG_IF(INFO, s3_logging) << "ListPage: " << request;
+
+    auto future = owner->transport_->IssueRequest(request, {});
+    future.ExecuteWhenReady(WithExecutor(
+        owner->executor(), [self = IntrusivePtr<ListPageTask>(this)](
+                               ReadyFuture<HttpResponse> response) {
+          self->OnResponse(response.result());
+        }));
+  }
+
+  void OnResponse(const Result<HttpResponse>& response) {
+    if (!promise.result_needed()) {
+      return;
+    }
+    ABSL_LOG_IF(INFO, s3_logging.Level(1) && response.ok())
+        << "ListPage " << *response;
+
+    bool is_retryable = false;
+    absl::Status status = [&]() -> absl::Status {
+      if (!response.ok()) {
+        is_retryable = DefaultIsRetryableCode(response.status().code());
+        return response.status();
+      }
+      return AwsHttpResponseToStatus(response.value(), is_retryable);
+    }();
+    if (!status.ok() && is_retryable) {
+      status =
+          owner->BackoffForAttemptAsync(std::move(status), attempt_++, this);
+      if (status.ok()) {
+        return;
+      }
+    }
+    if (!status.ok()) {
+      promise.SetResult(std::move(status));
+      return;
+    }
+    promise.SetResult(ParsePage(response.value()));
+  }
+
+  static Result<DelimitedListPage> ParsePage(const HttpResponse& response) {
+    auto cord = response.payload;
+    auto payload = cord.Flatten();
+    tinyxml2::XMLDocument xmlDocument;
+    if (int xmlcode = xmlDocument.Parse(payload.data(), payload.size());
+        xmlcode != tinyxml2::XML_SUCCESS) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Malformed List response: ", xmlcode));
+    }
+    auto* root = xmlDocument.FirstChildElement("ListBucketResult");
+    if (root == nullptr) {
+      return absl::InvalidArgumentError(
+          "Malformed List response: missing <ListBucketResult>");
+    }
+    DelimitedListPage page;
+    // Visit /ListBucketResult/Contents
+    for (auto* contents = root->FirstChildElement("Contents");
+         contents != nullptr;
+         contents = contents->NextSiblingElement("Contents")) {
+      auto* key_node = contents->FirstChildElement("Key");
+      if (key_node == nullptr) {
+        return absl::InvalidArgumentError(
+            "Malformed List response: missing <Key> in <Contents>");
+      }
+      page.entries.push_back(ListEntry{
+          GetNodeText(key_node),
+          GetNodeInt(contents->FirstChildElement("Size")).value_or(-1),
+          ListGeneration(contents)});
+    }
+    // Visit /ListBucketResult/CommonPrefixes
+    for (auto* prefixes = root->FirstChildElement("CommonPrefixes");
+         prefixes != nullptr;
+         prefixes = prefixes->NextSiblingElement("CommonPrefixes")) {
+      page.prefixes.push_back(
+          GetNodeText(prefixes->FirstChildElement("Prefix")));
+    }
+    // Visit /ListBucketResult/IsTruncated
+    page.truncated =
+        GetNodeText(root->FirstChildElement("IsTruncated")) == "true";
+    return page;
+  }
+};
+
+Future<DelimitedListPage> S3KeyValueStore::ListPage(KeyRange range) {
+  auto op = PromiseFuturePair<DelimitedListPage>::Make();
+  MaybeResolveRegion().ExecuteWhenReady(
+      [self = IntrusivePtr<S3KeyValueStore>(this),
+       promise = std::move(op.promise),
+       prefix = std::string(LongestPrefix(range))](
+          ReadyFuture<const S3EndpointRegion> ready) {
+        if (!ready.status().ok()) {
+          promise.SetResult(ready.status());
+          return;
+        }
+        auto state = internal::MakeIntrusivePtr<ListPageTask>(
+            std::move(self), std::move(ready), std::move(prefix),
+            std::move(promise));
+
+        intrusive_ptr_increment(
+            state.get());  // adopted by ListPageTask::Admit.
+        state->owner->read_rate_limiter().Admit(state.get(),
+                                                &ListPageTask::Start);
+      });
+  return std::move(op.future);
+}
+
 void S3KeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
   s3_list.Increment();
   if (options.range.empty()) {
@@ -1185,6 +2308,21 @@ void S3KeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
     execution::set_stopping(receiver);
     return;
   }
+  // Delimited listings of directory buckets are not sorted, and therefore
+  // cannot be used to partition the range.
+  if (options.concurrency > 1 && !directory_bucket_) {
+    // Each partition is listed by a sequential `ListImpl`.
+    internal_http::ParallelList(
+        std::move(options), std::move(receiver),
+        [self = IntrusivePtr<S3KeyValueStore>(this)](KeyRange range) {
+          return self->ListPage(std::move(range));
+        },
+        [self = IntrusivePtr<S3KeyValueStore>(this)](ListOptions options,
+                                                     ListReceiver receiver) {
+          self->ListImpl(std::move(options), std::move(receiver));
+        });
+    return;
+  }
 
   auto state = internal::MakeIntrusivePtr<ListTask>(
       IntrusivePtr<S3KeyValueStore>(this), std::move(options),
@@ -1204,10 +2342,15 @@ void S3KeyValueStore::ListImpl(ListOptions options, ListReceiver receiver) {
 }
 
 // Receiver used by `DeleteRange` for processing the results from `List`.
+//
+// Keys are deleted by DeleteObjects requests of up to
+// `kMaxDeleteObjectsKeys` keys, which are issued as soon as enough keys have
+// been listed.
 struct DeleteRangeListReceiver {
   IntrusivePtr<S3KeyValueStore> owner_;
   Promise<void> promise_;
   FutureCallbackRegistration cancel_registration_;
+  std::vector<std::string> pending_;
 
   void set_starting(AnyCancelReceiver cancel) {
     cancel_registration_ = promise_.ExecuteWhenNotNeeded(std::move(cancel));
@@ -1216,16 +2359,26 @@ struct DeleteRangeListReceiver {
   void set_value(ListEntry entry) {
     assert(!entry.key.empty());
     if (!entry.key.empty()) {
-      LinkError(promise_, owner_->Delete(std::move(entry.key)));
+      pending_.push_back(std::move(entry.key));
+      if (pending_.size() == kMaxDeleteObjectsKeys) Flush();
     }
   }
 
   void set_error(absl::Status error) {
+    Flush();
     SetDeferredResult(promise_, std::move(error));
     promise_ = Promise<void>();
   }
 
-  void set_done() { promise_ = Promise<void>(); }
+  void set_done() {
+    Flush();
+    promise_ = Promise<void>();
+  }
+
+  void Flush() {
+    if (pending_.empty()) return;
+    LinkError(promise_, owner_->DeleteObjects(std::exchange(pending_, {})));
+  }
 
   void set_stopping() { cancel_registration_.Unregister(); }
 };
@@ -1246,6 +2399,73 @@ Future<const void> S3KeyValueStore::DeleteRange(KeyRange range) {
   return std::move(op.future);
 }
 
+Future<TimestampedStorageGeneration> S3KeyValueStore::CopyObject(
+    std::string source_bucket, std::string source_key, std::string key,
+    int64_t size) {
+  if (!IsValidObjectName(key)) {
+    return absl::InvalidArgumentError("Invalid S3 object name");
+  }
+  if (size > 0 && static_cast<size_t>(size) > kMaxS3ObjectSize) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Object size ", size, " exceeds S3 limit of ", kMaxS3ObjectSize));
+  }
+  auto op = PromiseFuturePair<TimestampedStorageGeneration>::Make();
+  MaybeResolveRegion().ExecuteWhenReady(
+      [self = IntrusivePtr<S3KeyValueStore>(this),
+       promise = std::move(op.promise),
+       copy_source = tensorstore::StrCat(
+           source_bucket, "/", S3UriObjectKeyEncode(source_key)),
+       key = std::move(key),
+       size](ReadyFuture<const S3EndpointRegion> ready) mutable {
+        if (!ready.status().ok()) {
+          promise.SetResult(ready.status());
+          return;
+        }
+        std::string object_url =
+            tensorstore::StrCat(ready.value().endpoint, "/", key);
+        auto state = internal::MakeIntrusivePtr<CopyObjectTask>(
+            std::move(self), std::move(ready), std::move(object_url),
+            std::move(copy_source), size, std::move(promise));
+        intrusive_ptr_increment(
+            state.get());  // adopted by CopyObjectTask::Admit.
+        state->owner->write_rate_limiter().Admit(state.get(),
+                                                 &CopyObjectTask::Start);
+      });
+  return std::move(op.future);
+}
+
+Future<const void> S3KeyValueStore::ExperimentalCopyRangeFrom(
+    const internal::OpenTransactionPtr& transaction,
+    const kvstore::KvStore& source, Key target_prefix,
+    kvstore::CopyRangeOptions options) {
+  if (typeid(*source.driver) != typeid(S3KeyValueStore) || transaction ||
+      source.transaction != no_transaction) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  auto& source_driver = static_cast<S3KeyValueStore&>(*source.driver);
+  // A copy request is sent to the target endpoint, which must therefore also
+  // serve the source bucket.
+  if (source_driver.spec_.endpoint != spec_.endpoint ||
+      source_driver.spec_.host_header != spec_.host_header) {
+    return kvstore::Driver::ExperimentalCopyRangeFrom(
+        transaction, source, std::move(target_prefix), std::move(options));
+  }
+  s3_copy_range.Increment();
+  if (options.source_range.empty()) return absl::OkStatus();
+  return internal_kvstore::CopyRangeByListing(
+      source, std::move(target_prefix), options,
+      [self = IntrusivePtr<S3KeyValueStore>(this),
+       source_bucket = source_driver.spec_.bucket](
+          ListEntry entry, std::string target_key) -> Future<const void> {
+        auto op = PromiseFuturePair<void>::Make(absl::OkStatus());
+        LinkError(std::move(op.promise),
+                  self->CopyObject(source_bucket, std::move(entry.key),
+                                   std::move(target_key), entry.size));
+        return std::move(op.future);
+      });
+}
+
 // Resolves the region endpoint for the bucket.
 Future<const S3EndpointRegion> S3KeyValueStore::MaybeResolveRegion() {
   absl::MutexLock l(&mutex_);
@@ -1280,6 +2500,12 @@ Future<kvstore::DriverPtr> S3KeyValueStoreSpec::DoOpen() const {
   if (data_.rate_limiter.has_value()) {
     ABSL_LOG_IF(INFO, s3_logging) << "Using experimental_s3_rate_limiter";
   }
+  if (const auto& queues = data_.request_concurrency->adaptive_queues) {
+    // Buckets of the same name at different endpoints are limited separately.
+    driver->adaptive_queue_ = queues->Get(
+        data_.endpoint ? tensorstore::StrCat(*data_.endpoint, "/", data_.bucket)
+                       : data_.bucket);
+  }
 
   auto result = internal_kvstore_s3::ValidateEndpoint(
       data_.bucket, data_.aws_region, data_.endpoint.value_or(std::string{}),
@@ -1291,6 +2517,16 @@ Future<kvstore::DriverPtr> S3KeyValueStoreSpec::DoOpen() const {
   if (auto* ehr = std::get_if<S3EndpointRegion>(&result); ehr != nullptr) {
     ABSL_LOG_IF(INFO, s3_logging)
         << "S3 driver using endpoint [" << *ehr << "]";
+    if (IsDirectoryBucket(data_.bucket)) {
+      driver->directory_bucket_ = true;
+      driver->session_provider_ = std::make_unique<S3ExpressSessionProvider>(
+          S3ExpressSessionProvider::Options{
+              ehr->endpoint, driver->host_header_, ehr->aws_region,
+              [aws_credentials = data_.aws_credentials] {
+                return aws_credentials->GetCredentials();
+              },
+              driver->transport_});
+    }
     driver->resolve_ehr_ = MakeReadyFuture<S3EndpointRegion>(std::move(*ehr));
   }
 
@@ -1324,6 +2560,13 @@ Result<kvstore::Spec> ParseS3Url(std::string_view url) {
       Context::Resource<S3ConcurrencyResource>::DefaultSpec();
   driver_spec->data_.retries =
       Context::Resource<S3RequestRetries>::DefaultSpec();
+  driver_spec->data_.request_hedging =
+      Context::Resource<S3RequestHedging>::DefaultSpec();
+  driver_spec->data_.auto_batch =
+      Context::Resource<AutoBatchResource>::DefaultSpec();
+  driver_spec->data_.read_byte_budget =
+      Context::Resource<ReadByteBudgetResource>::DefaultSpec();
+  driver_spec->data_.tenant = Context::Resource<TenantResource>::DefaultSpec();
   driver_spec->data_.data_copy_concurrency =
       Context::Resource<DataCopyConcurrencyResource>::DefaultSpec();
 
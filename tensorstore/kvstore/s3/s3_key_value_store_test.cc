@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -21,6 +23,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/http/curl_transport.h"
 #include "tensorstore/internal/http/http_request.h"
@@ -116,6 +119,13 @@ TEST(S3KeyValueStoreTest, InvalidSpec) {
   EXPECT_THAT(
       kvstore::Open({{"driver", "s3"}, {"bucket", "a"}}, context).result(),
       MatchesStatus(absl::StatusCode::kInvalidArgument));
+
+  // Test with a directory bucket and no `"aws_region"`.
+  EXPECT_THAT(
+      kvstore::Open({{"driver", "s3"}, {"bucket", "bucket--usw2-az1--x-s3"}},
+                    context)
+          .result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument));
 }
 
 // Mock-based tests for s3.
@@ -438,6 +448,137 @@ TEST(S3KeyValueStoreTest, SimpleMock_ListPrefix) {
                                                   MatchesListEntry("b/b")));
 }
 
+TEST(S3KeyValueStoreTest, SimpleMock_DeleteRange) {
+  const auto kListResult =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"                            //
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"  //
+      "<Name>bucket</Name>"                                                   //
+      "<Prefix>b</Prefix>"                                                    //
+      "<KeyCount>2</KeyCount>"                                                //
+      "<MaxKeys>1000</MaxKeys>"                                               //
+      "<IsTruncated>false</IsTruncated>"                                      //
+      "<Contents><Key>b/a</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "<Contents><Key>b/b</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>0</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "</ListBucketResult>";
+
+  // A key which was concurrently deleted is reported as an error, which is
+  // ignored.
+  const auto kDeleteResult =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"                      //
+      "<DeleteResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"  //
+      "<Error><Key>b/b</Key><Code>NoSuchKey</Code>"                     //
+      "<Message>The specified key does not exist.</Message></Error>"    //
+      "</DeleteResult>";
+
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      // initial HEAD request responds with an x-amz-bucket-region header.
+      {"HEAD https://my-bucket.s3.amazonaws.com",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+
+      {"GET "
+       "https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?list-type=2&prefix=b%2F",
+       HttpResponse{200, absl::Cord(kListResult), {}}},
+
+      {"POST https://my-bucket.s3.us-east-1.amazonaws.com/?delete",
+       HttpResponse{200, absl::Cord(kDeleteResult), {}}},
+  };
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+  auto context = DefaultTestContext();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "s3"}, {"bucket", "my-bucket"}}, context)
+          .result());
+
+  TENSORSTORE_EXPECT_OK(
+      kvstore::DeleteRange(store, ::tensorstore::KeyRange::Prefix("b/"))
+          .result());
+
+  // Both keys are deleted by a single DeleteObjects request.
+  std::vector<std::string> requests;
+  for (const auto& request : mock_transport->requests()) {
+    requests.push_back(absl::StrCat(request.method, " ", request.url));
+  }
+  constexpr char kDeleteObjectsRequest[] =
+      "POST https://my-bucket.s3.us-east-1.amazonaws.com/?delete";
+  EXPECT_EQ(1, std::count(requests.begin(), requests.end(),
+                          kDeleteObjectsRequest));
+  EXPECT_THAT(requests, ::testing::Not(::testing::Contains(
+                            ::testing::StartsWith("DELETE "))));
+}
+
+TEST(S3KeyValueStoreTest, SimpleMock_ConcurrentList) {
+  constexpr char kListHeader[] =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Name>bucket</Name>"
+      "<MaxKeys>1000</MaxKeys>"
+      "<IsTruncated>false</IsTruncated>";
+  auto contents = [](std::string key) {
+    return absl::StrCat("<Contents><Key>", key, "</Key><Size>1</Size>",
+                        "<StorageClass>STANDARD</StorageClass></Contents>");
+  };
+  auto common_prefixes = [](std::string prefix) {
+    return absl::StrCat("<CommonPrefixes><Prefix>", prefix,
+                        "</Prefix></CommonPrefixes>");
+  };
+  auto list_result = [&](std::string body) {
+    return HttpResponse{
+        200, absl::Cord(absl::StrCat(kListHeader, body, "</ListBucketResult>")),
+        {}};
+  };
+
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      // initial HEAD request responds with an x-amz-bucket-region header.
+      {"HEAD https://my-bucket.s3.amazonaws.com",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+
+      // Delimited list requests which partition the bucket.
+      {"GET https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?delimiter=%2F&list-type=2",
+       list_result(absl::StrCat(contents("b"), common_prefixes("a/")))},
+      {"GET https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?delimiter=%2F&list-type=2&prefix=a%2F",
+       list_result(
+           absl::StrCat(common_prefixes("a/x/"), common_prefixes("a/y/")))},
+
+      // Each partition is listed separately.
+      {"GET https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?list-type=2&prefix=a%2Fx%2F",
+       list_result(absl::StrCat(contents("a/x/0"), contents("a/x/1")))},
+      {"GET https://my-bucket.s3.us-east-1.amazonaws.com/"
+       "?list-type=2&prefix=a%2Fy%2F",
+       list_result(contents("a/y/0"))},
+  };
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+  auto context = DefaultTestContext();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "s3"}, {"bucket", "my-bucket"}}, context)
+          .result());
+
+  kvstore::ListOptions options;
+  options.concurrency = 2;
+  EXPECT_THAT(kvstore::ListFuture(store, options).result(),
+              ::testing::Optional(::testing::ElementsAre(
+                  MatchesListEntry("a/x/0"), MatchesListEntry("a/x/1"),
+                  MatchesListEntry("a/y/0"), MatchesListEntry("b"))));
+}
+
 // TODO: Add tests for various responses
 TEST(S3KeyValueStoreTest, SimpleMock_RetryTimesOut) {
   // Mocks for s3
@@ -478,6 +619,244 @@ TEST(S3KeyValueStoreTest, SimpleMock_RetryTimesOut) {
   EXPECT_THAT(read_result, StatusIs(absl::StatusCode::kAborted));
 }
 
+TEST(S3KeyValueStoreTest, SimpleMock_MultipartUpload) {
+  const std::string base_url =
+      "https://localhost:1234/base/my-bucket/tmp:1/key_write";
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      {"HEAD https://localhost:1234/base/my-bucket",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+      {absl::StrCat("POST ", base_url, "?uploads"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<InitiateMultipartUploadResult>
+  <Bucket>my-bucket</Bucket>
+  <Key>tmp:1/key_write</Key>
+  <UploadId>abc</UploadId>
+</InitiateMultipartUploadResult>
+)")}},
+      {absl::StrCat("POST ", base_url, "?uploadId=abc"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<CompleteMultipartUploadResult>
+  <Key>tmp:1/key_write</Key>
+  <ETag>"900150983cd24fb0d6963f7d28e17f72-3"</ETag>
+</CompleteMultipartUploadResult>
+)")}},
+  };
+  for (int i = 1; i <= 3; ++i) {
+    url_to_response[absl::StrCat("PUT ", base_url, "?partNumber=", i,
+                                 "&uploadId=abc")] =
+        HttpResponse{200,
+                     absl::Cord(),
+                     {{"etag", absl::StrCat("\"", i, "\"")}}};
+  }
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+  auto context = DefaultTestContext();
+
+  constexpr size_t kPartSize = 5 * 1024 * 1024;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "s3"},
+                                 {"bucket", "my-bucket"},
+                                 {"endpoint", "https://localhost:1234/base"},
+                                 {"path", "tmp:1/"},
+                                 {"multipart_threshold", kPartSize},
+                                 {"multipart_part_size", kPartSize}},
+                                context)
+                      .result());
+
+  EXPECT_THAT(
+      kvstore::Write(store, "key_write",
+                     absl::Cord(std::string(2 * kPartSize + 1, 'x')))
+          .result(),
+      MatchesTimestampedStorageGeneration(StorageGeneration::FromString(
+          "\"900150983cd24fb0d6963f7d28e17f72-3\"")));
+
+  std::vector<std::string> urls;
+  for (const auto& request : mock_transport->requests()) {
+    if (absl::StartsWith(request.url, base_url)) {
+      urls.push_back(absl::StrCat(request.method, " ",
+                                  request.url.substr(base_url.size())));
+    }
+  }
+  EXPECT_THAT(urls, ::testing::UnorderedElementsAre(
+                        "POST ?uploads", "PUT ?partNumber=1&uploadId=abc",
+                        "PUT ?partNumber=2&uploadId=abc",
+                        "PUT ?partNumber=3&uploadId=abc",
+                        "POST ?uploadId=abc"));
+  ASSERT_EQ(5, urls.size());
+  EXPECT_EQ("POST ?uploads", urls.front());
+  EXPECT_EQ("POST ?uploadId=abc", urls.back());
+}
+
+TEST(S3KeyValueStoreTest, SimpleMock_MultipartUploadAbortsOnFailure) {
+  const std::string base_url =
+      "https://localhost:1234/base/my-bucket/tmp:1/key_write";
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      {"HEAD https://localhost:1234/base/my-bucket",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+      {absl::StrCat("POST ", base_url, "?uploads"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<InitiateMultipartUploadResult>
+  <UploadId>abc</UploadId>
+</InitiateMultipartUploadResult>
+)")}},
+      {absl::StrCat("PUT ", base_url, "?partNumber=1&uploadId=abc"),
+       HttpResponse{200, absl::Cord(), {{"etag", "\"1\""}}}},
+      // Part 2 is not found, which is not retried.
+      {absl::StrCat("DELETE ", base_url, "?uploadId=abc"),
+       HttpResponse{204, absl::Cord()}},
+  };
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+  auto context = DefaultTestContext();
+
+  constexpr size_t kPartSize = 5 * 1024 * 1024;
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "s3"},
+                                 {"bucket", "my-bucket"},
+                                 {"endpoint", "https://localhost:1234/base"},
+                                 {"path", "tmp:1/"},
+                                 {"multipart_threshold", kPartSize},
+                                 {"multipart_part_size", kPartSize}},
+                                context)
+                      .result());
+
+  EXPECT_THAT(kvstore::Write(store, "key_write",
+                             absl::Cord(std::string(2 * kPartSize, 'x')))
+                  .result(),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  std::vector<std::string> urls;
+  for (const auto& request : mock_transport->requests()) {
+    if (absl::StartsWith(request.url, base_url)) {
+      urls.push_back(absl::StrCat(request.method, " ",
+                                  request.url.substr(base_url.size())));
+    }
+  }
+  EXPECT_THAT(urls, ::testing::Contains("DELETE ?uploadId=abc"));
+  EXPECT_THAT(urls,
+              ::testing::Not(::testing::Contains("POST ?uploadId=abc")));
+}
+
+TEST(S3KeyValueStoreTest, SimpleMock_CopyRange) {
+  constexpr size_t kPartSize = 5 * 1024 * 1024;
+  const auto kListResult = absl::StrCat(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"                            //
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"  //
+      "<Name>bucket</Name>"                                                   //
+      "<Prefix>x/</Prefix>"                                                   //
+      "<KeyCount>2</KeyCount>"                                                //
+      "<MaxKeys>1000</MaxKeys>"                                               //
+      "<IsTruncated>false</IsTruncated>"                                      //
+      "<Contents><Key>x/a</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>2</Size><StorageClass>STANDARD</StorageClass></Contents>"        //
+      "<Contents><Key>x/b</Key>"                                              //
+      "<LastModified>2023-09-06T17:53:28.000Z</LastModified>"                 //
+      "<ETag>&quot;d41d8cd98f00b204e9800998ecf8427e&quot;</ETag>"             //
+      "<Size>",
+      2 * kPartSize + 1,
+      "</Size><StorageClass>STANDARD</StorageClass></Contents>"  //
+      "</ListBucketResult>");
+
+  const std::string base_url = "https://my-bucket.s3.us-east-1.amazonaws.com";
+  absl::flat_hash_map<std::string, HttpResponse> url_to_response{
+      // initial HEAD request responds with an x-amz-bucket-region header.
+      {"HEAD https://my-bucket.s3.amazonaws.com",
+       HttpResponse{200, absl::Cord(), {{"x-amz-bucket-region", "us-east-1"}}}},
+      {absl::StrCat("GET ", base_url, "/?list-type=2&prefix=x%2F"),
+       HttpResponse{200, absl::Cord(kListResult), {}}},
+      // "x/a" is copied by a single CopyObject request.
+      {absl::StrCat("PUT ", base_url, "/y/a"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<CopyObjectResult>
+  <ETag>"d41d8cd98f00b204e9800998ecf8427e"</ETag>
+</CopyObjectResult>
+)")}},
+      // "x/b" is copied by a multipart upload of UploadPartCopy requests.
+      {absl::StrCat("POST ", base_url, "/y/b?uploads"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<InitiateMultipartUploadResult>
+  <UploadId>abc</UploadId>
+</InitiateMultipartUploadResult>
+)")}},
+      {absl::StrCat("POST ", base_url, "/y/b?uploadId=abc"),
+       HttpResponse{200, absl::Cord(R"(<?xml version="1.0" encoding="UTF-8"?>
+<CompleteMultipartUploadResult>
+  <ETag>"900150983cd24fb0d6963f7d28e17f72-3"</ETag>
+</CompleteMultipartUploadResult>
+)")}},
+  };
+  for (int i = 1; i <= 3; ++i) {
+    url_to_response[absl::StrCat("PUT ", base_url, "/y/b?partNumber=", i,
+                                 "&uploadId=abc")] =
+        HttpResponse{200, absl::Cord(absl::StrCat(
+                              "<CopyPartResult><ETag>\"", i,
+                              "\"</ETag></CopyPartResult>"))};
+  }
+
+  auto mock_transport =
+      std::make_shared<DefaultMockHttpTransport>(url_to_response);
+  DefaultHttpTransportSetter mock_transport_setter{mock_transport};
+  auto context = DefaultTestContext();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, kvstore::Open({{"driver", "s3"},
+                                 {"bucket", "my-bucket"},
+                                 {"multipart_threshold", kPartSize},
+                                 {"multipart_part_size", kPartSize}},
+                                context)
+                      .result());
+
+  TENSORSTORE_EXPECT_OK(kvstore::ExperimentalCopyRange(
+      store.WithPathSuffix("x/"), store.WithPathSuffix("y/")));
+
+  std::vector<std::string> requests;
+  for (const auto& request : mock_transport->requests()) {
+    std::string copy_source;
+    for (const auto& header : request.headers) {
+      if (absl::StartsWith(header, "x-amz-copy-source")) {
+        absl::StrAppend(&copy_source, " ", header);
+      }
+    }
+    requests.push_back(
+        absl::StrCat(request.method, " ", request.url, copy_source));
+  }
+  EXPECT_THAT(
+      requests,
+      ::testing::IsSupersetOf({
+          absl::StrCat("PUT ", base_url,
+                       "/y/a x-amz-copy-source: my-bucket/x/a"),
+          absl::StrCat("PUT ", base_url,
+                       "/y/b?partNumber=1&uploadId=abc "
+                       "x-amz-copy-source: my-bucket/x/b "
+                       "x-amz-copy-source-range: bytes=0-5242879"),
+          absl::StrCat("PUT ", base_url,
+                       "/y/b?partNumber=3&uploadId=abc "
+                       "x-amz-copy-source: my-bucket/x/b "
+                       "x-amz-copy-source-range: bytes=10485760-10485760"),
+          absl::StrCat("POST ", base_url, "/y/b?uploadId=abc"),
+      }));
+  // No data is read by the client.
+  EXPECT_THAT(requests, ::testing::Not(::testing::Contains(
+                            ::testing::StartsWith("GET " + base_url + "/x"))));
+}
+
+TEST(S3KeyValueStoreTest, InvalidMultipartPartSize) {
+  auto context = DefaultTestContext();
+  EXPECT_THAT(kvstore::Open({{"driver", "s3"},
+                             {"bucket", "my-bucket"},
+                             {"endpoint", "https://localhost:1234/base"},
+                             {"multipart_part_size", 1024}},
+                            context)
+                  .result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 // TODO: Add mocking to satisfy kvstore testing methods, such as:
 // tensorstore::internal::TestKeyValueStoreReadOps
 // tensorstore::internal::TestKeyValueReadWriteOps
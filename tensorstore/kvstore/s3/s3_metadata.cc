@@ -92,7 +92,7 @@ std::string UnescapeXml(std::string_view data) {
     } else if (symbol == kQuot) {
       result[res_pos++] = '"';
     } else if (symbol == kApos) {
-      result[res_pos++] = '`';
+      result[res_pos++] = '\'';
     } else if (symbol == kAmp) {
       result[res_pos++] = '&';
     } else {
@@ -207,6 +207,34 @@ std::string GetNodeText(tinyxml2::XMLNode* node) {
   return UnescapeXml(printer.CStr());
 }
 
+std::string EscapeXml(std::string_view data) {
+  std::string result;
+  result.reserve(data.size());
+  for (char c : data) {
+    switch (c) {
+      case '<':
+        result += kLt;
+        break;
+      case '>':
+        result += kGt;
+        break;
+      case '"':
+        result += kQuot;
+        break;
+      case '\'':
+        result += kApos;
+        break;
+      case '&':
+        result += kAmp;
+        break;
+      default:
+        result += c;
+        break;
+    }
+  }
+  return result;
+}
+
 Result<StorageGeneration> StorageGenerationFromHeaders(
     const absl::btree_multimap<std::string, std::string>& headers) {
   if (auto it = headers.find(kEtag); it != headers.end()) {
@@ -24,6 +24,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "absl/container/btree_map.h"
 #include "absl/status/status.h"
@@ -48,6 +49,10 @@ std::string GetNodeText(tinyxml2::XMLNode* node);
 std::optional<int64_t> GetNodeInt(tinyxml2::XMLNode* node);
 std::optional<absl::Time> GetNodeTimestamp(tinyxml2::XMLNode* node);
 
+/// Escapes the 5 special XML characters, for example in an object key which is
+/// included in the body of a request.
+std::string EscapeXml(std::string_view data);
+
 /// Creates a storage generation from the etag header in the
 /// HTTP response `headers`.
 ///
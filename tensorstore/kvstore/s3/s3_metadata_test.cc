@@ -14,6 +14,8 @@
 
 #include "tensorstore/kvstore/s3/s3_metadata.h"
 
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
@@ -28,6 +30,7 @@ namespace {
 using ::tensorstore::StatusIs;
 using ::tensorstore::internal_http::HttpResponse;
 using ::tensorstore::internal_kvstore_s3::AwsHttpResponseToStatus;
+using ::tensorstore::internal_kvstore_s3::EscapeXml;
 using ::tensorstore::internal_kvstore_s3::GetNodeInt;
 using ::tensorstore::internal_kvstore_s3::GetNodeText;
 using ::tensorstore::internal_kvstore_s3::GetNodeTimestamp;
@@ -89,6 +92,17 @@ TEST(XmlSearchTest, GetNodeValues) {
       ::testing::Optional(::testing::Eq(absl::FromUnixSeconds(1688830015))));
 }
 
+TEST(XmlSearchTest, EscapeXml) {
+  EXPECT_EQ("tensorstore/test/abc", EscapeXml("tensorstore/test/abc"));
+  EXPECT_EQ("a&lt;b&gt;&amp;&quot;c&apos;", EscapeXml("a<b>&\"c'"));
+
+  // Escaped text round trips through the XML parser.
+  tinyxml2::XMLDocument xmlDocument;
+  std::string xml = "<Key>" + EscapeXml("x&<y>'z") + "</Key>";
+  ASSERT_EQ(xmlDocument.Parse(xml.c_str()), tinyxml2::XML_SUCCESS);
+  EXPECT_EQ("x&<y>'z", GetNodeText(xmlDocument.FirstChildElement("Key")));
+}
+
 TEST(S3MetadataTest, AwsHttpResponseToStatus) {
   HttpResponse response;
   // No header, no payload.
@@ -51,7 +51,11 @@ namespace internal_kvstore_s3 {
 ///      https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html
 ///   3. If the AWS credentials are empty, the Authorization header is omitted,
 ///      representing anonymous access.
-///   4. The request url and query parameters are encoded using S3 specific URI
+///   4. Requests with S3 Express One Zone session credentials are signed for
+///      the *s3express* service, and the session token is sent in the
+///      *x-amz-s3session-token* header.
+///      https://docs.aws.amazon.com/AmazonS3/latest/API/API_CreateSession.html
+///   5. The request url and query parameters are encoded using S3 specific URI
 ///      encoding logic described here:
 ///      https://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html#create-signature-presign-entire-payload
 ///
@@ -74,6 +78,15 @@ class S3RequestBuilder {
     return *this;
   }
 
+  /// Sets the service name used in the signature, which is `s3` by default.
+  ///
+  /// `CreateSession` requests for directory buckets are signed for the
+  /// `s3express` service.
+  S3RequestBuilder& SetSigningService(std::string service) {
+    signing_service_ = std::move(service);
+    return *this;
+  }
+
   /// Enables sending Accept-Encoding header and transparently decoding the
   /// response.
   S3RequestBuilder& EnableAcceptEncoding() {
@@ -131,6 +144,7 @@ class S3RequestBuilder {
   std::string canonical_request_;
   std::string signing_string_;
   std::string signature_;
+  std::string signing_service_ = "s3";
   std::vector<std::pair<std::string, std::string>> query_params_;
   internal_http::HttpRequestBuilder builder_;
 };
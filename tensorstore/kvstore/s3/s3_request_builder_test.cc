@@ -324,6 +324,42 @@ TEST(S3RequestBuilderTest, AwsSessionTokenHeaderAdded) {
                                    "x-amz-security-token: ", token)));
 }
 
+TEST(S3RequestBuilderTest, S3ExpressSessionTokenHeaderAdded) {
+  /// Session credentials of directory buckets are sent in
+  /// x-amz-s3session-token and signed for the s3express service.
+  auto token = "abcdef1234567890";
+  auto session_credentials =
+      AwsCredentials{credentials.access_key, credentials.secret_key, token};
+  session_credentials.s3_express_session = true;
+  auto builder =
+      S3RequestBuilder("GET", absl::StrFormat("https://%s/test.txt", bucket));
+  auto request = builder.BuildRequest(
+      absl::StrFormat("%s.s3.amazonaws.com", bucket), session_credentials,
+      aws_region,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+      absl::FromCivil(absl::CivilSecond(2013, 5, 24, 0, 0, 0), utc));
+
+  EXPECT_THAT(request.headers, ::testing::Contains(absl::StrCat(
+                                   "x-amz-s3session-token: ", token)));
+  EXPECT_THAT(request.headers,
+              ::testing::Not(::testing::Contains(
+                  ::testing::HasSubstr("x-amz-security-token"))));
+  EXPECT_THAT(builder.GetSigningString(),
+              ::testing::HasSubstr("/us-east-1/s3express/aws4_request"));
+}
+
+TEST(S3RequestBuilderTest, SigningService) {
+  auto builder =
+      S3RequestBuilder("GET", absl::StrFormat("https://%s/", bucket));
+  builder.AddQueryParameter("session", "").SetSigningService("s3express");
+  builder.BuildRequest(
+      absl::StrFormat("%s.s3.amazonaws.com", bucket), credentials, aws_region,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+      absl::FromCivil(absl::CivilSecond(2013, 5, 24, 0, 0, 0), utc));
+  EXPECT_THAT(builder.GetSigningString(),
+              ::testing::HasSubstr("/us-east-1/s3express/aws4_request"));
+}
+
 TEST(S3RequestBuilderTest, AwsRequesterPaysHeaderAdded) {
   /// Test that x-amz-requester-payer: requester is added if true
   auto request =
@@ -354,4 +390,19 @@ TEST(S3RequestBuilderTest, AwsRequesterPaysHeaderAdded) {
               ::testing::Contains("x-amz-requester-payer: requester"));
 }
 
+TEST(S3RequestBuilderTest, QueryParameterWithoutValue) {
+  // Parameters without a value, such as the `uploads` parameter of
+  // CreateMultipartUpload, are signed with an empty value.
+  auto url = absl::StrFormat("https://%s.s3.amazonaws.com/test.txt", bucket);
+  auto builder = S3RequestBuilder("POST", url).AddQueryParameter("uploads", "");
+  auto request = builder.BuildRequest(
+      absl::StrFormat("%s.s3.amazonaws.com", bucket), credentials, aws_region,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+      absl::FromCivil(absl::CivilSecond(2013, 5, 24, 0, 0, 0), utc));
+
+  EXPECT_EQ(request.url, absl::StrCat(url, "?uploads"));
+  EXPECT_THAT(builder.GetCanonicalRequest(),
+              ::testing::StartsWith("POST\n/test.txt\nuploads=\n"));
+}
+
 }  // namespace
@@ -15,9 +15,14 @@
 #include "tensorstore/kvstore/s3/s3_resource.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "absl/base/attributes.h"
 #include "absl/base/call_once.h"
@@ -28,7 +33,10 @@
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/env.h"
 #include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/internal/metrics/gauge.h"
+#include "tensorstore/internal/metrics/metadata.h"
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/rate_limiter/scaling_rate_limiter.h"
 #include "tensorstore/util/result.h"
@@ -53,12 +61,15 @@ ABSL_FLAG(std::optional<absl::Duration>,
           "Overrides TENSORSTORE_S3_RATE_LIMITER_DOUBLING_TIME");
 
 using ::tensorstore::internal::AdmissionQueue;
+using ::tensorstore::internal::AimdAdmissionQueue;
+using ::tensorstore::internal::AimdAdmissionQueueMap;
 using ::tensorstore::internal::AnyContextResourceJsonBinder;
 using ::tensorstore::internal::ConstantRateLimiter;
 using ::tensorstore::internal::ContextResourceCreationContext;
 using ::tensorstore::internal::DoublingRateLimiter;
 using ::tensorstore::internal::GetFlagOrEnvValue;
 using ::tensorstore::internal::NoRateLimiter;
+using ::tensorstore::internal_metrics::MetricMetadata;
 
 namespace tensorstore {
 namespace internal_kvstore_s3 {
@@ -67,6 +78,9 @@ namespace {
 const internal::ContextResourceRegistration<S3RequestRetries>
     s3_request_retries_registration;
 
+const internal::ContextResourceRegistration<S3RequestHedging>
+    s3_request_hedging_registration;
+
 const internal::ContextResourceRegistration<S3ConcurrencyResource>
     s3_concurrency_registration;
 
@@ -77,6 +91,15 @@ ABSL_CONST_INIT internal_log::VerboseFlag s3_logging("s3");
 
 constexpr size_t kDefaultRequestConcurrency = 32;
 
+// Upper bound on the limit of an adaptive admission queue.
+constexpr size_t kMaxAdaptiveRequestConcurrency = 1024;
+
+auto& s3_adaptive_request_concurrency =
+    internal_metrics::Gauge<int64_t, std::string>::New(
+        "/tensorstore/kvstore/s3/adaptive_request_concurrency", "bucket",
+        MetricMetadata("Current limit on concurrent S3 requests to a bucket "
+                       "using an adaptive s3_request_concurrency"));
+
 size_t GetEnvS3RequestConcurrency() {
   return GetFlagOrEnvValue(FLAGS_tensorstore_s3_request_concurrency,
                            "TENSORSTORE_S3_REQUEST_CONCURRENCY")
@@ -99,6 +122,19 @@ S3ConcurrencyResource::S3ConcurrencyResource()
 
 Result<S3ConcurrencyResource::Resource> S3ConcurrencyResource::Create(
     const Spec& spec, ContextResourceCreationContext context) const {
+  if (spec.adaptive) {
+    Resource value;
+    value.spec = spec;
+    AimdAdmissionQueue::Options options;
+    options.initial_limit = spec.limit.value_or(shared_limit_);
+    options.max_limit =
+        std::max(options.initial_limit, kMaxAdaptiveRequestConcurrency);
+    value.adaptive_queues = std::make_shared<AimdAdmissionQueueMap>(
+        std::move(options), [](std::string_view bucket, size_t limit) {
+          s3_adaptive_request_concurrency.Set(limit, std::string(bucket));
+        });
+    return value;
+  }
   if (spec.limit) {
     Resource value;
     value.spec = spec;
@@ -25,8 +25,10 @@
 #include "tensorstore/context.h"
 #include "tensorstore/context_resource_provider.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/hedging_context_resource.h"
 #include "tensorstore/internal/json_binding/std_optional.h"
 #include "tensorstore/internal/rate_limiter/admission_queue.h"
+#include "tensorstore/internal/rate_limiter/aimd_admission_queue.h"
 #include "tensorstore/internal/rate_limiter/rate_limiter.h"
 #include "tensorstore/internal/retries_context_resource.h"
 #include "tensorstore/util/result.h"
@@ -44,14 +46,24 @@ struct S3RequestRetries : public internal::RetriesResource<S3RequestRetries> {
   static constexpr bool config_only = true;
 };
 
+/// Specifies when slow requests are hedged.
+struct S3RequestHedging : public internal::HedgingResource<S3RequestHedging> {
+  static constexpr char id[] = "s3_request_hedging";
+};
+
 /// Specifies an admission queue as a context object.
 ///
 /// This provides a way to limit the concurrency across multiple tensorstores
 /// rather than each tensorstore always having independent limits.
+///
+/// When `adaptive` is set, a separate limit is maintained for each bucket,
+/// starting at `limit`, which is increased additively as requests succeed and
+/// decreased multiplicatively when requests are throttled.
 struct S3ConcurrencyResource
     : public internal::ContextResourceTraits<S3ConcurrencyResource> {
  public:
   static constexpr char id[] = "s3_request_concurrency";
+  constexpr static bool shared_when_decoded = true;
 
   S3ConcurrencyResource(size_t shared_limit);
   S3ConcurrencyResource();
@@ -59,24 +71,33 @@ struct S3ConcurrencyResource
   struct Spec {
     // If equal to `nullopt`, indicates that the shared executor is used.
     std::optional<size_t> limit;
+    // Indicates that the limit of each bucket is adjusted in response to
+    // throttling.
+    bool adaptive = false;
 
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.limit);
+      return f(x.limit, x.adaptive);
     };
   };
   struct Resource {
     Spec spec;
     std::shared_ptr<internal::AdmissionQueue> queue;
+    // If non-null, used instead of `queue`.
+    std::shared_ptr<internal::AimdAdmissionQueueMap> adaptive_queues;
   };
 
-  static Spec Default() { return Spec{std::nullopt}; }
+  static Spec Default() { return Spec{std::nullopt, false}; }
 
   static constexpr auto JsonBinder() {
     namespace jb = tensorstore::internal_json_binding;
-    return jb::Object(jb::Member(
-        "limit",
-        jb::Projection<&Spec::limit>(jb::DefaultInitializedValue(
-            jb::Optional(jb::Integer<size_t>(1), [] { return "shared"; })))));
+    return jb::Object(
+        jb::Member("limit",
+                   jb::Projection<&Spec::limit>(jb::DefaultInitializedValue(
+                       jb::Optional(jb::Integer<size_t>(1),
+                                    [] { return "shared"; })))),
+        jb::Member("adaptive",
+                   jb::Projection<&Spec::adaptive>(
+                       jb::DefaultValue([](auto* v) { *v = false; }))));
   }
 
   Result<Resource> Create(
@@ -106,6 +127,7 @@ struct S3RateLimiterResource
     : public internal::ContextResourceTraits<S3RateLimiterResource> {
  public:
   static constexpr char id[] = "experimental_s3_rate_limiter";
+  constexpr static bool shared_when_decoded = true;
 
   struct Spec {
     // If equal to `nullopt`, indicates that no rate-limiter is used.
@@ -0,0 +1,146 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/s3/s3express_session.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/functional/function_ref.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/http_request.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/log/verbose_flag.h"
+#include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
+#include "tensorstore/kvstore/s3/s3_metadata.h"
+#include "tensorstore/kvstore/s3/s3_request_builder.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tinyxml2.h"
+
+namespace tensorstore {
+namespace internal_kvstore_s3 {
+namespace {
+
+ABSL_CONST_INIT internal_log::VerboseFlag s3_logging("s3");
+
+static constexpr char kEmptySha256[] =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+}  // namespace
+
+S3ExpressSessionProvider::S3ExpressSessionProvider(
+    Options options, absl::FunctionRef<absl::Time()> clock)
+    : options_(std::move(options)), clock_(clock) {}
+
+Result<AwsCredentials> S3ExpressSessionProvider::GetCredentials() {
+  {
+    absl::MutexLock lock(&mutex_);
+    while (true) {
+      const absl::Time now = clock_();
+      if (credentials_.expires_at > now &&
+          (refresh_in_progress_ ||
+           credentials_.expires_at - kEarlyRefreshWindow > now)) {
+        return credentials_;
+      }
+      if (!refresh_in_progress_) break;
+      // Wait for the concurrent refresh rather than issuing another.
+      mutex_.Await(absl::Condition(
+          +[](bool* refresh_in_progress) { return !*refresh_in_progress; },
+          &refresh_in_progress_));
+    }
+    refresh_in_progress_ = true;
+  }
+
+  auto result = CreateSession();
+
+  absl::MutexLock lock(&mutex_);
+  refresh_in_progress_ = false;
+  if (!result.ok()) {
+    // An early refresh may fail transiently; continue to use the current
+    // session until it expires.
+    if (credentials_.expires_at > clock_()) {
+      ABSL_LOG_IF(INFO, s3_logging)
+          << "CreateSession failed: " << result.status();
+      return credentials_;
+    }
+    return result;
+  }
+  credentials_ = *std::move(result);
+  return credentials_;
+}
+
+Result<AwsCredentials> S3ExpressSessionProvider::CreateSession() {
+  TENSORSTORE_ASSIGN_OR_RETURN(auto base_credentials,
+                               options_.base_credentials());
+  if (!base_credentials || base_credentials->IsAnonymous()) {
+    return AwsCredentials::Anonymous();
+  }
+
+  auto request =
+      S3RequestBuilder("GET", absl::StrCat(options_.endpoint, "/"))
+          .AddQueryParameter("session", "")
+          .SetSigningService("s3express")
+          .BuildRequest(options_.host_header, *base_credentials,
+                        options_.aws_region, kEmptySha256, clock_());
+
+  ABSL_LOG_IF(INFO, s3_logging) << "CreateSession: " << request;
+
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto response, options_.transport->IssueRequest(request, {}).result());
+  bool is_retryable = false;
+  TENSORSTORE_RETURN_IF_ERROR(AwsHttpResponseToStatus(response, is_retryable));
+  return ParseCreateSessionResponse(response.payload.Flatten());
+}
+
+Result<AwsCredentials> ParseCreateSessionResponse(std::string_view payload) {
+  tinyxml2::XMLDocument xmlDocument;
+  if (int xmlcode = xmlDocument.Parse(payload.data(), payload.size());
+      xmlcode != tinyxml2::XML_SUCCESS) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Malformed CreateSession response: ", xmlcode));
+  }
+  auto* root = xmlDocument.FirstChildElement("CreateSessionResult");
+  auto* node =
+      root == nullptr ? nullptr : root->FirstChildElement("Credentials");
+  if (node == nullptr) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateSession response: missing <Credentials>");
+  }
+  AwsCredentials credentials;
+  credentials.access_key = GetNodeText(node->FirstChildElement("AccessKeyId"));
+  credentials.secret_key =
+      GetNodeText(node->FirstChildElement("SecretAccessKey"));
+  credentials.session_token =
+      GetNodeText(node->FirstChildElement("SessionToken"));
+  auto expiration = GetNodeTimestamp(node->FirstChildElement("Expiration"));
+  if (credentials.access_key.empty() || credentials.secret_key.empty() ||
+      credentials.session_token.empty() || !expiration) {
+    return absl::InvalidArgumentError(
+        "Malformed CreateSession response: incomplete <Credentials>");
+  }
+  credentials.expires_at = *expiration;
+  credentials.s3_express_session = true;
+  return credentials;
+}
+
+}  // namespace internal_kvstore_s3
+}  // namespace tensorstore
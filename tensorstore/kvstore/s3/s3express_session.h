@@ -0,0 +1,93 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_KVSTORE_S3_S3EXPRESS_SESSION_H_
+#define TENSORSTORE_KVSTORE_S3_S3EXPRESS_SESSION_H_
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/http_transport.h"
+#include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore_s3 {
+
+/// Provides session credentials for an S3 Express One Zone directory bucket.
+///
+/// Requests to directory buckets are authorized by short-lived session
+/// credentials obtained from a `CreateSession` request, which is itself signed
+/// with the ordinary AWS credentials:
+/// https://docs.aws.amazon.com/AmazonS3/latest/API/API_CreateSession.html
+///
+/// The session credentials are cached until they expire.  Once they are
+/// within `kEarlyRefreshWindow` of expiring, a single caller issues a new
+/// `CreateSession` request while concurrent callers continue to use the
+/// current credentials; callers only block when the credentials have actually
+/// expired.
+class S3ExpressSessionProvider : public AwsCredentialProvider {
+ public:
+  /// Duration before expiration during which the session is refreshed without
+  /// blocking other callers.  Sessions are valid for 5 minutes.
+  static constexpr absl::Duration kEarlyRefreshWindow = absl::Minutes(1);
+
+  /// Returns the credentials used to sign `CreateSession` requests, or
+  /// `std::nullopt` for anonymous access.
+  using BaseCredentialsFunction =
+      std::function<Result<std::optional<AwsCredentials>>()>;
+
+  struct Options {
+    /// Zonal endpoint of the directory bucket.
+    std::string endpoint;
+    std::string host_header;
+    std::string aws_region;
+    BaseCredentialsFunction base_credentials;
+    std::shared_ptr<internal_http::HttpTransport> transport;
+  };
+
+  explicit S3ExpressSessionProvider(
+      Options options, absl::FunctionRef<absl::Time()> clock = absl::Now);
+
+  /// Returns the session credentials, or anonymous credentials if the base
+  /// credentials are anonymous.
+  Result<AwsCredentials> GetCredentials()
+      ABSL_LOCKS_EXCLUDED(mutex_) override;
+
+ private:
+  Result<AwsCredentials> CreateSession();
+
+  Options options_;
+  absl::FunctionRef<absl::Time()> clock_;
+  absl::Mutex mutex_;
+  AwsCredentials credentials_ ABSL_GUARDED_BY(mutex_);
+  bool refresh_in_progress_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+/// Parses the XML body of a successful `CreateSession` response.
+Result<AwsCredentials> ParseCreateSessionResponse(std::string_view payload);
+
+}  // namespace internal_kvstore_s3
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_S3_S3EXPRESS_SESSION_H_
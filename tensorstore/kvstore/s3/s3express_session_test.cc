@@ -0,0 +1,182 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/kvstore/s3/s3express_session.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+#include "tensorstore/internal/http/http_response.h"
+#include "tensorstore/internal/http/mock_http_transport.h"
+#include "tensorstore/kvstore/s3/credentials/aws_credentials.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::IsOk;
+using ::tensorstore::Result;
+using ::tensorstore::StatusIs;
+using ::tensorstore::internal_http::DefaultMockHttpTransport;
+using ::tensorstore::internal_http::HttpResponse;
+using ::tensorstore::internal_kvstore_s3::AwsCredentials;
+using ::tensorstore::internal_kvstore_s3::ParseCreateSessionResponse;
+using ::tensorstore::internal_kvstore_s3::S3ExpressSessionProvider;
+
+static constexpr char kEndpoint[] =
+    "https://bucket--usw2-az1--x-s3.s3express-usw2-az1.us-west-2.amazonaws.com";
+
+std::string CreateSessionResponse(std::string_view token,
+                                  std::string_view expiration) {
+  return absl::StrCat(
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+      "<CreateSessionResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Credentials>"
+      "<SessionToken>",
+      token,
+      "</SessionToken>"
+      "<SecretAccessKey>session-secret</SecretAccessKey>"
+      "<AccessKeyId>session-key</AccessKeyId>"
+      "<Expiration>",
+      expiration,
+      "</Expiration>"
+      "</Credentials>"
+      "</CreateSessionResult>");
+}
+
+TEST(ParseCreateSessionResponseTest, Basic) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto credentials, ParseCreateSessionResponse(CreateSessionResponse(
+                            "token", "2024-03-12T19:53:36Z")));
+  EXPECT_EQ("session-key", credentials.access_key);
+  EXPECT_EQ("session-secret", credentials.secret_key);
+  EXPECT_EQ("token", credentials.session_token);
+  EXPECT_EQ(absl::FromCivil(absl::CivilSecond(2024, 3, 12, 19, 53, 36),
+                            absl::UTCTimeZone()),
+            credentials.expires_at);
+  EXPECT_TRUE(credentials.s3_express_session);
+}
+
+TEST(ParseCreateSessionResponseTest, Malformed) {
+  EXPECT_THAT(ParseCreateSessionResponse("<"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseCreateSessionResponse("<CreateSessionResult/>"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      ParseCreateSessionResponse(CreateSessionResponse("token", "invalid")),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+class S3ExpressSessionProviderTest : public ::testing::Test {
+ protected:
+  S3ExpressSessionProvider::Options MakeOptions() {
+    return {kEndpoint, "", "us-west-2",
+            []() -> Result<std::optional<AwsCredentials>> {
+              return AwsCredentials{"access-key", "secret-key", ""};
+            },
+            transport};
+  }
+
+  void SetResponse(std::string_view token, absl::Time expiration) {
+    transport->Reset(absl::flat_hash_map<std::string, HttpResponse>{
+        {absl::StrCat("GET ", kEndpoint, "/?session"),
+         HttpResponse{200, absl::Cord(CreateSessionResponse(
+                               token, absl::FormatTime(absl::RFC3339_full,
+                                                       expiration,
+                                                       absl::UTCTimeZone())))}},
+    });
+  }
+
+  absl::Time now = absl::FromUnixSeconds(1700000000);
+  std::shared_ptr<DefaultMockHttpTransport> transport =
+      std::make_shared<DefaultMockHttpTransport>(
+          absl::flat_hash_map<std::string, HttpResponse>{});
+};
+
+TEST_F(S3ExpressSessionProviderTest, CachesAndRefreshesSession) {
+  auto clock = [this] { return now; };
+  S3ExpressSessionProvider provider(MakeOptions(), clock);
+
+  SetResponse("token1", now + absl::Minutes(5));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto credentials, provider.GetCredentials());
+  EXPECT_EQ("token1", credentials.session_token);
+  EXPECT_TRUE(credentials.s3_express_session);
+  ASSERT_EQ(1, transport->requests().size());
+  EXPECT_THAT(transport->requests()[0].headers,
+              ::testing::Contains(::testing::HasSubstr(
+                  "/us-west-2/s3express/aws4_request")));
+  EXPECT_THAT(transport->requests()[0].headers,
+              ::testing::Not(::testing::Contains(
+                  ::testing::HasSubstr("x-amz-s3session-token"))));
+
+  // The session is cached.
+  SetResponse("token2", now + absl::Minutes(10));
+  now += absl::Minutes(2);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider.GetCredentials());
+  EXPECT_EQ("token1", credentials.session_token);
+  EXPECT_EQ(0, transport->requests().size());
+
+  // The session is refreshed before it expires.
+  now += absl::Minutes(2) + absl::Seconds(30);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(credentials, provider.GetCredentials());
+  EXPECT_EQ("token2", credentials.session_token);
+  EXPECT_EQ(1, transport->requests().size());
+}
+
+TEST_F(S3ExpressSessionProviderTest, FailedEarlyRefresh) {
+  auto clock = [this] { return now; };
+  S3ExpressSessionProvider provider(MakeOptions(), clock);
+
+  SetResponse("token1", now + absl::Minutes(5));
+  EXPECT_THAT(provider.GetCredentials(), IsOk());
+
+  // The current session continues to be used if an early refresh fails.
+  transport->Reset(absl::flat_hash_map<std::string, HttpResponse>{
+      {absl::StrCat("GET ", kEndpoint, "/?session"),
+       HttpResponse{403, absl::Cord()}},
+  });
+  now += absl::Minutes(4) + absl::Seconds(30);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto credentials, provider.GetCredentials());
+  EXPECT_EQ("token1", credentials.session_token);
+
+  // Once expired, the error is returned.
+  now += absl::Minutes(1);
+  EXPECT_THAT(provider.GetCredentials(),
+              StatusIs(absl::StatusCode::kPermissionDenied));
+}
+
+TEST_F(S3ExpressSessionProviderTest, Anonymous) {
+  auto options = MakeOptions();
+  options.base_credentials = []() -> Result<std::optional<AwsCredentials>> {
+    return std::nullopt;
+  };
+  S3ExpressSessionProvider provider(std::move(options));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto credentials, provider.GetCredentials());
+  EXPECT_TRUE(credentials.IsAnonymous());
+  EXPECT_EQ(0, transport->requests().size());
+}
+
+}  // namespace
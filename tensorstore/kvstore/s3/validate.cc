@@ -17,6 +17,7 @@
 #include <string_view>
 
 #include "absl/strings/match.h"
+#include "absl/strings/strip.h"
 #include "re2/re2.h"
 #include "tensorstore/internal/utf8.h"
 #include "tensorstore/kvstore/generation.h"
@@ -41,6 +42,15 @@ BucketNameType ClassifyBucketName(std::string_view bucket) {
     return BucketNameType::kInvalid;
   }
 
+  // Names ending in "--x-s3" are reserved for directory buckets.
+  static LazyRE2 kDirectoryStyle = {
+      "^[a-z0-9]([a-z0-9-]*[a-z0-9])?--[a-z0-9]+(-[a-z0-9]+)*--x-s3$"};
+  if (absl::EndsWith(bucket, "--x-s3")) {
+    return bucket.size() <= 63 && RE2::FullMatch(bucket, *kDirectoryStyle)
+               ? BucketNameType::kDirectory
+               : BucketNameType::kInvalid;
+  }
+
   static LazyRE2 kIpAddress = {"^\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}$"};
 
   // No IP Address style names.
@@ -67,6 +77,13 @@ BucketNameType ClassifyBucketName(std::string_view bucket) {
                                                   : BucketNameType::kInvalid;
 }
 
+std::string_view DirectoryBucketZoneId(std::string_view bucket) {
+  if (!absl::ConsumeSuffix(&bucket, "--x-s3")) return {};
+  auto pos = bucket.rfind("--");
+  if (pos == std::string_view::npos) return {};
+  return bucket.substr(pos + 2);
+}
+
 // Returns whether the object name is a valid S3 object name.
 // https://docs.aws.amazon.com/AmazonS3/latest/userguide/object-keys.html
 // NOTE: Amazon recommends that object names do not include the following:
@@ -28,12 +28,25 @@ enum class BucketNameType {
   kInvalid = 0,
   kStandard,
   kOldUSEast1,
+  /// S3 Express One Zone directory bucket, named
+  /// `<base-name>--<zone-id>--x-s3`.
+  kDirectory,
 };
 
-/// Distinguish between Invalid, Standard and Old us-east-1 buckets.
+/// Distinguish between Invalid, Standard, Old us-east-1 and directory buckets.
 /// https://docs.aws.amazon.com/AmazonS3/latest/userguide/bucketnamingrules.html
+/// https://docs.aws.amazon.com/AmazonS3/latest/userguide/directory-bucket-naming-rules.html
 BucketNameType ClassifyBucketName(std::string_view bucket);
 
+/// Returns whether the bucket is an S3 Express One Zone directory bucket.
+inline bool IsDirectoryBucket(std::string_view bucket) {
+  return ClassifyBucketName(bucket) == BucketNameType::kDirectory;
+}
+
+/// Returns the availability zone id of a directory bucket, such as
+/// `usw2-az1` for `bucket--usw2-az1--x-s3`.
+std::string_view DirectoryBucketZoneId(std::string_view bucket);
+
 /// Returns whether the bucket name is valid.
 inline bool IsValidBucketName(std::string_view bucket) {
   return ClassifyBucketName(bucket) != BucketNameType::kInvalid;
@@ -20,6 +20,7 @@ namespace {
 
 using ::tensorstore::internal_kvstore_s3::BucketNameType;
 using ::tensorstore::internal_kvstore_s3::ClassifyBucketName;
+using ::tensorstore::internal_kvstore_s3::DirectoryBucketZoneId;
 using ::tensorstore::internal_kvstore_s3::IsValidBucketName;
 using ::tensorstore::internal_kvstore_s3::IsValidObjectName;
 
@@ -59,6 +60,23 @@ TEST(ValidateTest, ClassifyBucketName) {
                                "1234567890abcdefghij"
                                "1_34"),
             BucketNameType::kOldUSEast1);
+
+  // Directory buckets are named <base-name>--<zone-id>--x-s3.
+  EXPECT_EQ(ClassifyBucketName("bucket--usw2-az1--x-s3"),
+            BucketNameType::kDirectory);
+  EXPECT_EQ(ClassifyBucketName("my-bucket--use1-az4--x-s3"),
+            BucketNameType::kDirectory);
+  EXPECT_EQ(ClassifyBucketName("bucket--x-s3"), BucketNameType::kInvalid);
+  EXPECT_EQ(ClassifyBucketName("Bucket--usw2-az1--x-s3"),
+            BucketNameType::kInvalid);
+  EXPECT_EQ(ClassifyBucketName("a.b--usw2-az1--x-s3"),
+            BucketNameType::kInvalid);
+}
+
+TEST(ValidateTest, DirectoryBucketZoneId) {
+  EXPECT_EQ("usw2-az1", DirectoryBucketZoneId("bucket--usw2-az1--x-s3"));
+  EXPECT_EQ("use1-az4", DirectoryBucketZoneId("a--b--use1-az4--x-s3"));
+  EXPECT_EQ("", DirectoryBucketZoneId("bucket"));
 }
 
 TEST(ValidateTest, IsValidBucketName) {
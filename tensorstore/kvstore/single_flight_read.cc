@@ -0,0 +1,150 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/single_flight_read.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+namespace {
+
+/// Identifies reads that may be merged.
+struct RequestKey {
+  kvstore::Key key;
+  int64_t inclusive_min;
+  int64_t exclusive_max;
+  StorageGeneration if_equal;
+  StorageGeneration if_not_equal;
+
+  friend bool operator==(const RequestKey& a, const RequestKey& b) {
+    return a.key == b.key && a.inclusive_min == b.inclusive_min &&
+           a.exclusive_max == b.exclusive_max && a.if_equal == b.if_equal &&
+           a.if_not_equal == b.if_not_equal;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const RequestKey& x) {
+    return H::combine(std::move(h), x.key, x.inclusive_min, x.exclusive_max,
+                      x.if_equal, x.if_not_equal);
+  }
+};
+
+struct InFlightRead {
+  uint64_t id;
+  absl::Time start_time;
+  // Promise of the shared read, from which a future is obtained for each
+  // merged read while the shared read is still needed.
+  Promise<kvstore::ReadResult> promise;
+};
+
+}  // namespace
+
+struct SingleFlightReads::State {
+  // Removes the in-flight read for `key` if it is the read identified by `id`.
+  void Remove(const RequestKey& key, uint64_t id) {
+    std::optional<InFlightRead> removed;
+    absl::MutexLock lock(&mutex);
+    auto it = reads.find(key);
+    if (it == reads.end() || it->second.id != id) return;
+    // Destroy the promise after releasing the lock.
+    removed.emplace(std::move(it->second));
+    reads.erase(it);
+  }
+
+  mutable absl::Mutex mutex;
+  uint64_t next_id ABSL_GUARDED_BY(mutex) = 0;
+  absl::flat_hash_map<RequestKey, InFlightRead> reads ABSL_GUARDED_BY(mutex);
+};
+
+SingleFlightReads::SingleFlightReads() : state_(std::make_shared<State>()) {}
+
+SingleFlightReads::~SingleFlightReads() = default;
+
+Future<kvstore::ReadResult> SingleFlightReads::Read(
+    kvstore::Key key, kvstore::ReadOptions options, ReadFunction read) {
+  RequestKey request_key{key, options.byte_range.inclusive_min,
+                         options.byte_range.exclusive_max,
+                         options.generation_conditions.if_equal,
+                         options.generation_conditions.if_not_equal};
+  Future<kvstore::ReadResult> shared_future;
+  {
+    absl::MutexLock lock(&state_->mutex);
+    auto it = state_->reads.find(request_key);
+    if (it != state_->reads.end() &&
+        it->second.start_time >= options.staleness_bound) {
+      // Null if the shared read is no longer needed.
+      shared_future = it->second.promise.future();
+    }
+  }
+  if (shared_future.null()) {
+    const absl::Time start_time = absl::Now();
+    auto read_future = read(std::move(key), std::move(options));
+    auto [promise, future] = PromiseFuturePair<kvstore::ReadResult>::Make();
+    uint64_t id;
+    {
+      absl::MutexLock lock(&state_->mutex);
+      id = state_->next_id++;
+      // Replaces any read that is no longer needed, or is too stale for this
+      // read, since this read satisfies any staleness bound the existing read
+      // would have satisfied.
+      state_->reads.insert_or_assign(request_key,
+                                     InFlightRead{id, start_time, promise});
+    }
+    promise.ExecuteWhenNotNeeded([state = state_, request_key, id] {
+      state->Remove(request_key, id);
+    });
+    Link(
+        [state = state_, request_key, id](
+            Promise<kvstore::ReadResult> promise,
+            ReadyFuture<kvstore::ReadResult> future) {
+          state->Remove(request_key, id);
+          promise.SetResult(std::move(future.result()));
+        },
+        std::move(promise), std::move(read_future));
+    shared_future = std::move(future);
+  }
+  // Each read receives its own copy of the result, since callers may move
+  // from it.
+  return PromiseFuturePair<kvstore::ReadResult>::Link(
+             [](Promise<kvstore::ReadResult> promise,
+                ReadyFuture<kvstore::ReadResult> future) {
+               promise.SetResult(std::as_const(future.result()));
+             },
+             std::move(shared_future))
+      .future;
+}
+
+size_t SingleFlightReads::num_in_flight() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->reads.size();
+}
+
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
@@ -0,0 +1,81 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_SINGLE_FLIGHT_READ_H_
+#define TENSORSTORE_KVSTORE_SINGLE_FLIGHT_READ_H_
+
+/// \file
+///
+/// Deduplication of identical concurrent reads.
+///
+/// When many readers concurrently miss in their caches for the same key, as
+/// happens for shard indices shortly after a sharded array is opened, each
+/// miss would otherwise issue its own request to the underlying storage.  A
+/// `SingleFlightReads` object merges reads of the same key, byte range, and
+/// generation conditions while one is in flight, such that only a single
+/// request is issued.
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "absl/functional/function_ref.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+namespace internal_kvstore_batch {
+
+/// Merges identical in-flight reads.
+///
+/// A read joins an in-flight read if the key, byte range, and generation
+/// conditions are equal, and the in-flight read was issued no earlier than the
+/// `staleness_bound` of the new read.  Reads with the default staleness bound
+/// of `absl::InfiniteFuture()` must be current as of the time they are made,
+/// and therefore never join an in-flight read.
+///
+/// Each read receives its own copy of the result, and the shared request is
+/// cancelled only once all of the merged reads are no longer needed.
+///
+/// \threadsafety Thread safe.
+class SingleFlightReads {
+ public:
+  using ReadFunction = absl::FunctionRef<Future<kvstore::ReadResult>(
+      kvstore::Key key, kvstore::ReadOptions options)>;
+
+  SingleFlightReads();
+  ~SingleFlightReads();
+
+  SingleFlightReads(const SingleFlightReads&) = delete;
+  SingleFlightReads& operator=(const SingleFlightReads&) = delete;
+
+  /// Returns the result of an in-flight read matching `key` and `options`, or
+  /// otherwise issues a new read by calling `read(key, options)`.
+  Future<kvstore::ReadResult> Read(kvstore::Key key,
+                                   kvstore::ReadOptions options,
+                                   ReadFunction read);
+
+  /// Returns the number of distinct reads in flight.
+  size_t num_in_flight() const;
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace internal_kvstore_batch
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_SINGLE_FLIGHT_READ_H_
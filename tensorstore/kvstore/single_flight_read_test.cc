@@ -0,0 +1,197 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/single_flight_read.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/kvstore/read_result.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Future;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::OptionalByteRangeRequest;
+using ::tensorstore::Promise;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::StorageGeneration;
+using ::tensorstore::internal_kvstore_batch::SingleFlightReads;
+using ::tensorstore::kvstore::ReadOptions;
+using ::tensorstore::kvstore::ReadResult;
+
+// Records the reads issued to the underlying store.
+struct MockReads {
+  struct Request {
+    std::string key;
+    ReadOptions options;
+    Promise<ReadResult> promise;
+  };
+
+  Future<ReadResult> Read(std::string key, ReadOptions options) {
+    auto [promise, future] = PromiseFuturePair<ReadResult>::Make();
+    requests.push_back(
+        {std::move(key), std::move(options), std::move(promise)});
+    return std::move(future);
+  }
+
+  auto read_function() {
+    return [this](std::string key, ReadOptions options) {
+      return Read(std::move(key), std::move(options));
+    };
+  }
+
+  std::vector<Request> requests;
+};
+
+ReadOptions OptionsWithStaleness(absl::Time staleness_bound) {
+  ReadOptions options;
+  options.staleness_bound = staleness_bound;
+  return options;
+}
+
+ReadResult ValueResult(std::string value) {
+  return ReadResult::Value(absl::Cord(std::move(value)),
+                           {StorageGeneration::FromString("g"), absl::Now()});
+}
+
+TEST(SingleFlightReadsTest, MergesIdenticalReads) {
+  SingleFlightReads reads;
+  MockReads mock;
+  const absl::Time staleness_bound = absl::Now();
+  auto future1 = reads.Read("a", OptionsWithStaleness(staleness_bound),
+                            mock.read_function());
+  auto future2 = reads.Read("a", OptionsWithStaleness(staleness_bound),
+                            mock.read_function());
+  ASSERT_EQ(1, mock.requests.size());
+  EXPECT_EQ(1, reads.num_in_flight());
+  EXPECT_FALSE(future1.ready());
+  EXPECT_FALSE(future2.ready());
+  mock.requests[0].promise.SetResult(ValueResult("abc"));
+  EXPECT_EQ(0, reads.num_in_flight());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result1, future1.result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result2, future2.result());
+  EXPECT_EQ("abc", result1.value);
+  EXPECT_EQ("abc", result2.value);
+
+  // Subsequent reads are issued separately.
+  auto future3 = reads.Read("a", OptionsWithStaleness(staleness_bound),
+                            mock.read_function());
+  EXPECT_EQ(2, mock.requests.size());
+}
+
+TEST(SingleFlightReadsTest, DistinctReads) {
+  SingleFlightReads reads;
+  MockReads mock;
+  const absl::Time staleness_bound = absl::Now();
+  auto options = [&] { return OptionsWithStaleness(staleness_bound); };
+  auto future1 = reads.Read("a", options(), mock.read_function());
+  auto future2 = reads.Read("b", options(), mock.read_function());
+  auto byte_range_options = options();
+  byte_range_options.byte_range = OptionalByteRangeRequest::Range(0, 10);
+  auto future3 =
+      reads.Read("a", std::move(byte_range_options), mock.read_function());
+  auto generation_options = options();
+  generation_options.generation_conditions.if_not_equal =
+      StorageGeneration::FromString("g");
+  auto future4 =
+      reads.Read("a", std::move(generation_options), mock.read_function());
+  EXPECT_EQ(4, mock.requests.size());
+  EXPECT_EQ(4, reads.num_in_flight());
+  EXPECT_EQ(10, mock.requests[2].options.byte_range.exclusive_max);
+}
+
+TEST(SingleFlightReadsTest, StalenessBound) {
+  SingleFlightReads reads;
+  MockReads mock;
+  auto future1 = reads.Read("a", OptionsWithStaleness(absl::Now()),
+                            mock.read_function());
+  // Reads that must be more recent than the in-flight read are not merged.
+  auto future2 = reads.Read("a", OptionsWithStaleness(absl::InfiniteFuture()),
+                            mock.read_function());
+  ASSERT_EQ(2, mock.requests.size());
+  // The most recent read replaces the earlier read.
+  auto future3 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  EXPECT_EQ(2, mock.requests.size());
+  mock.requests[1].promise.SetResult(ValueResult("new"));
+  EXPECT_TRUE(future3.ready());
+  EXPECT_FALSE(future1.ready());
+  mock.requests[0].promise.SetResult(ValueResult("old"));
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result1, future1.result());
+  EXPECT_EQ("old", result1.value);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result3, future3.result());
+  EXPECT_EQ("new", result3.value);
+}
+
+TEST(SingleFlightReadsTest, IndependentResults) {
+  SingleFlightReads reads;
+  MockReads mock;
+  auto future1 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  auto future2 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  mock.requests[0].promise.SetResult(ValueResult("abc"));
+  // Moving from one result does not affect the other.
+  ReadResult moved = std::move(future1.value());
+  EXPECT_EQ("abc", moved.value);
+  EXPECT_EQ("abc", future2.value().value);
+}
+
+TEST(SingleFlightReadsTest, Error) {
+  SingleFlightReads reads;
+  MockReads mock;
+  auto future1 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  auto future2 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  mock.requests[0].promise.SetResult(absl::UnavailableError("failed"));
+  EXPECT_THAT(future1.result(), MatchesStatus(absl::StatusCode::kUnavailable));
+  EXPECT_THAT(future2.result(), MatchesStatus(absl::StatusCode::kUnavailable));
+  EXPECT_EQ(0, reads.num_in_flight());
+}
+
+TEST(SingleFlightReadsTest, CancelledOnceNotNeeded) {
+  SingleFlightReads reads;
+  MockReads mock;
+  auto future1 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  auto future2 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  ASSERT_EQ(1, mock.requests.size());
+  future1 = {};
+  EXPECT_TRUE(mock.requests[0].promise.result_needed());
+  future2 = {};
+  EXPECT_FALSE(mock.requests[0].promise.result_needed());
+  EXPECT_EQ(0, reads.num_in_flight());
+
+  // A new read is issued once the previous read is no longer needed.
+  auto future3 = reads.Read("a", OptionsWithStaleness(absl::InfinitePast()),
+                            mock.read_function());
+  EXPECT_EQ(2, mock.requests.size());
+}
+
+}  // namespace
@@ -32,6 +32,16 @@ enum class SupportedFeatures : uint64_t {
   /// i.e. `WriteOptions::if_equal` is handled race-free.  This implies
   /// `kSingleKeyAtomicReadModifyWrite`.
   kSingleKeyAtomicReadModifyWrite = 8,
+
+  /// Indicates if `WriteOptions::unchanged_prefix_length` is used to update an
+  /// existing value in place by writing only the changed suffix.  Such writes
+  /// are not atomic: a concurrent reader may observe a partially-written
+  /// value, and a failure partway through may leave the value corrupted.
+  kAppendInPlace = 16,
+
+  /// Indicates if `List` reports `ListEntry::generation` for each key, as of
+  /// the time at which the `List` operation was started.
+  kListGenerations = 32,
 };
 
 constexpr inline SupportedFeatures operator&(SupportedFeatures a,
@@ -0,0 +1,92 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_KVSTORE_TENANT_RESOURCE_H_
+#define TENSORSTORE_KVSTORE_TENANT_RESOURCE_H_
+
+/// \file
+///
+/// Context resource that identifies the tenant of key-value store operations.
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "tensorstore/context.h"
+#include "tensorstore/context_resource_provider.h"
+#include "tensorstore/internal/json_binding/bindable.h"
+#include "tensorstore/internal/json_binding/json_binding.h"
+#include "tensorstore/internal/rate_limiter/rate_limiter.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_kvstore {
+
+/// Context resource that specifies the tenant on whose behalf requests are
+/// issued.
+///
+/// Requests of named tenants that wait for the same request concurrency
+/// limit are started in weighted round-robin order of the tenants, so that
+/// the requests of one tenant do not delay those of other tenants
+/// indefinitely.  Requests without a named tenant share the default tenant.
+struct TenantResource : public internal::ContextResourceTraits<TenantResource> {
+  static constexpr char id[] = "kvstore_tenant";
+  constexpr static bool shared_when_decoded = true;
+
+  struct Spec {
+    std::string name;
+    uint32_t weight = 1;
+    constexpr static auto ApplyMembers = [](auto&& x, auto f) {
+      return f(x.name, x.weight);
+    };
+  };
+
+  struct Resource {
+    Spec spec;
+    /// Null for the default tenant.
+    std::shared_ptr<const internal::RateLimiterTenant> tenant;
+  };
+
+  static Spec Default() { return {}; }
+  static constexpr auto JsonBinder() {
+    namespace jb = ::tensorstore::internal_json_binding;
+    return jb::Object(
+        jb::Member("name", jb::Projection(&Spec::name,
+                                          jb::DefaultInitializedValue())),
+        jb::Member(
+            "weight",
+            jb::Projection(&Spec::weight,
+                           jb::DefaultValue([](auto* v) { *v = 1; },
+                                            jb::Integer<uint32_t>(1, 1000)))));
+  }
+  static Result<Resource> Create(
+      const Spec& spec, internal::ContextResourceCreationContext context) {
+    Resource resource{spec};
+    if (!spec.name.empty()) {
+      resource.tenant = std::make_shared<internal::RateLimiterTenant>(
+          internal::RateLimiterTenant{spec.name, spec.weight});
+    }
+    return resource;
+  }
+  static Spec GetSpec(const Resource& resource,
+                      const internal::ContextSpecBuilder& builder) {
+    return resource.spec;
+  }
+};
+
+}  // namespace internal_kvstore
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_KVSTORE_TENANT_RESOURCE_H_
@@ -0,0 +1,56 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/kvstore/tenant_resource.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/context.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Context;
+using ::tensorstore::IsOkAndHolds;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::internal_kvstore::TenantResource;
+
+TEST(TenantResourceTest, Default) {
+  auto resource_spec = Context::Resource<TenantResource>::DefaultSpec();
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  EXPECT_EQ(nullptr, resource->tenant);
+  EXPECT_THAT(resource_spec.ToJson(),
+              IsOkAndHolds(::nlohmann::json(::nlohmann::json::object_t{})));
+}
+
+TEST(TenantResourceTest, Named) {
+  ::nlohmann::json json{{"name", "alice"}, {"weight", 4}};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto resource_spec, Context::Resource<TenantResource>::FromJson(json));
+  EXPECT_THAT(resource_spec.ToJson(), IsOkAndHolds(json));
+  auto resource = Context::Default().GetResource(resource_spec).value();
+  ASSERT_NE(nullptr, resource->tenant);
+  EXPECT_EQ("alice", resource->tenant->name);
+  EXPECT_EQ(4, resource->tenant->weight);
+}
+
+TEST(TenantResourceTest, InvalidWeight) {
+  EXPECT_THAT(Context::Resource<TenantResource>::FromJson(
+                  {{"name", "alice"}, {"weight", 0}}),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
@@ -70,7 +70,8 @@ void ReportWritebackError(Controller controller, std::string_view action,
 
 template <typename Controller>
 void PerformWriteback(Driver* driver, Controller controller,
-                      ReadResult read_result) {
+                      ReadResult read_result,
+                      uint64_t unchanged_prefix_length = 0) {
   if (!StorageGeneration::IsDirty(read_result.stamp.generation)) {
     // The read is not dirty.
     if (!StorageGeneration::IsConditional(read_result.stamp.generation) ||
@@ -112,6 +113,9 @@ void PerformWriteback(Driver* driver, Controller controller,
   assert(!read_result.aborted());
   write_options.generation_conditions.if_equal =
       StorageGeneration::Clean(std::move(read_result.stamp.generation));
+  if (read_result.has_value()) {
+    write_options.unchanged_prefix_length = unchanged_prefix_length;
+  }
   auto future = driver->Write(controller.GetKey(),
                               std::move(read_result).optional_value(),
                               std::move(write_options));
@@ -968,6 +972,13 @@ void MultiPhaseMutation::CommitNextPhase() {
   }
 
   auto& single_phase_mutation = GetCommittingPhase();
+  if (GetTransactionNode().ConcurrentPhaseFailed()) {
+    // An error has already occurred, and the writes of this phase may depend
+    // on writes of earlier phases that were not committed.
+    WritebackError(single_phase_mutation);
+    AllEntriesDone(single_phase_mutation);
+    return;
+  }
   WritebackPhase(single_phase_mutation, absl::InfinitePast(),
                  [](ReadModifyWriteEntry& entry) { return true; });
 }
@@ -1255,9 +1266,11 @@ void ReadDirectly(Driver* driver, ReadModifyWriteEntry& entry,
 }
 
 void WritebackDirectly(Driver* driver, ReadModifyWriteEntry& entry,
-                       ReadResult&& read_result) {
+                       ReadResult&& read_result,
+                       uint64_t unchanged_prefix_length) {
   assert(read_result.stamp.time != absl::InfinitePast());
-  PerformWriteback(driver, Controller{&entry}, std::move(read_result));
+  PerformWriteback(driver, Controller{&entry}, std::move(read_result),
+                   unchanged_prefix_length);
 }
 
 void WritebackDirectly(Driver* driver, DeleteRangeEntry& entry) {
@@ -576,7 +576,8 @@ void ReadDirectly(Driver* driver, ReadModifyWriteEntry& entry,
                   ReadModifyWriteTarget::ReadReceiver&& receiver);
 
 void WritebackDirectly(Driver* driver, ReadModifyWriteEntry& entry,
-                       ReadResult&& read_result);
+                       ReadResult&& read_result,
+                       uint64_t unchanged_prefix_length = 0);
 
 void WritebackDirectly(Driver* driver, DeleteRangeEntry& entry);
 
@@ -642,8 +643,9 @@ class NonAtomicTransactionNode
   void Writeback(ReadModifyWriteEntry& entry,
                  ReadModifyWriteEntry& source_entry,
                  ReadResult&& read_result) override {
-    internal_kvstore::WritebackDirectly(this->driver(), entry,
-                                        std::move(read_result));
+    internal_kvstore::WritebackDirectly(
+        this->driver(), entry, std::move(read_result),
+        source_entry.source_->KvsWritebackUnchangedPrefixLength());
   }
 
   void WritebackDelete(DeleteRangeEntry& entry) override {
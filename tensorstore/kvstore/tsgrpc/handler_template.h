@@ -104,6 +104,28 @@ class StreamHandler : public HandlerBase,
   const Request* request_;
 };
 
+// Handler base class for a bidirectional stream request.
+template <typename RequestProto, typename ResponseProto>
+class BidiStreamHandler
+    : public HandlerBase,
+      public grpc::ServerBidiReactor<RequestProto, ResponseProto> {
+ public:
+  using Request = RequestProto;
+  using Response = ResponseProto;
+  using Reactor = typename grpc::ServerBidiReactor<RequestProto, ResponseProto>;
+
+  BidiStreamHandler(::grpc::CallbackServerContext* grpc_context)
+      : HandlerBase(grpc_context) {}
+
+  using Reactor::Finish;
+  void Finish(absl::Status status) {
+    Finish(tensorstore::internal::AbslStatusToGrpcStatus(status));
+  }
+
+ protected:
+  void OnDone() final { auto adopted = Adopt(); }
+};
+
 }  // namespace tensorstore_grpc
 
 #endif  // TENSORSTORE_KVSTORE_TSGRPC_HANDLER_TEMPLATE_H_
@@ -16,22 +16,27 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "grpcpp/server.h"  // third_party
 #include "grpcpp/server_builder.h"  // third_party
 #include "grpcpp/server_context.h"  // third_party
@@ -39,8 +44,13 @@
 #include "grpcpp/support/status.h"  // third_party
 #include <nlohmann/json.hpp>
 #include "tensorstore/context.h"
+#include "tensorstore/internal/cache/async_cache.h"
+#include "tensorstore/internal/cache/cache.h"
+#include "tensorstore/internal/cache/cache_pool_resource.h"
+#include "tensorstore/internal/cache/kvs_backed_cache.h"
 #include "tensorstore/internal/grpc/server_credentials.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/absl_time.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/json_binding/std_array.h"
@@ -63,6 +73,7 @@
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/str_cat.h"
 
 // grpc/proto
 #include "tensorstore/kvstore/tsgrpc/kvstore.grpc.pb.h"
@@ -72,9 +83,14 @@
 using ::grpc::CallbackServerContext;
 using ::tensorstore::internal_metrics::MetricMetadata;
 using ::tensorstore::kvstore::ListEntry;
+using ::tensorstore_grpc::BidiStreamHandler;
 using ::tensorstore_grpc::EncodeGenerationAndTimestamp;
 using ::tensorstore_grpc::Handler;
 using ::tensorstore_grpc::StreamHandler;
+using ::tensorstore_grpc::kvstore::BatchReadRequest;
+using ::tensorstore_grpc::kvstore::BatchReadResponse;
+using ::tensorstore_grpc::kvstore::BatchWriteRequest;
+using ::tensorstore_grpc::kvstore::BatchWriteResponse;
 using ::tensorstore_grpc::kvstore::DeleteRequest;
 using ::tensorstore_grpc::kvstore::DeleteResponse;
 using ::tensorstore_grpc::kvstore::ListRequest;
@@ -106,40 +122,155 @@ auto& list_metric = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/grpc_server/list",
     MetricMetadata("KvStoreService::List calls"));
 
+auto& batch_read_metric = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/grpc_server/batch_read",
+    MetricMetadata("KvStoreService::BatchRead calls"));
+
+auto& batch_write_metric = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/grpc_server/batch_write",
+    MetricMetadata("KvStoreService::BatchWrite calls"));
+
 ABSL_CONST_INIT internal_log::VerboseFlag verbose_logging("tsgrpc_kvstore");
 
+/// Decodes the options of a `ReadRequest`.
+absl::Status DecodeReadOptions(const ReadRequest& request,
+                               kvstore::ReadOptions& options) {
+  options.generation_conditions.if_equal.value = request.generation_if_equal();
+  options.generation_conditions.if_not_equal.value =
+      request.generation_if_not_equal();
+
+  if (request.has_byte_range()) {
+    options.byte_range.inclusive_min = request.byte_range().inclusive_min();
+    options.byte_range.exclusive_max = request.byte_range().exclusive_max();
+    if (!options.byte_range.SatisfiesInvariants()) {
+      return absl::InvalidArgumentError("Invalid byte range");
+    }
+  }
+  if (request.has_staleness_bound()) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        options.staleness_bound,
+        internal::ProtoToAbslTime(request.staleness_bound()));
+  }
+  return absl::OkStatus();
+}
+
+/// Encodes a successful `kvstore::ReadResult` into a `ReadResponse`.
+void EncodeReadResult(const kvstore::ReadResult& r, ReadResponse* response) {
+  response->set_state(static_cast<ReadResponse::State>(r.state));
+  EncodeGenerationAndTimestamp(r.stamp, response);
+  if (r.has_value()) {
+    response->set_value(r.value);
+  }
+}
+
+/// Cache of complete values read from the server kvstore, used when
+/// `KvStoreServer::Spec::read_cache` is enabled.
+///
+/// Each entry corresponds to a key of the base kvstore driver.  `AsyncCache`
+/// ensures that at most one read of an entry is in progress, and revalidates
+/// the cached value with an `if_not_equal` condition on its generation.
+class ReadCache
+    : public internal::KvsBackedCache<ReadCache, internal::AsyncCache> {
+  using Base = internal::KvsBackedCache<ReadCache, internal::AsyncCache>;
+
+ public:
+  using ReadData = absl::Cord;
+
+  class Entry : public Base::Entry {
+   public:
+    using OwningCache = ReadCache;
+
+    size_t ComputeReadDataSizeInBytes(const void* read_data) override {
+      return read_data ? static_cast<const ReadData*>(read_data)->size() : 0;
+    }
+
+    void DoDecode(std::optional<absl::Cord> value,
+                  DecodeReceiver receiver) override {
+      std::shared_ptr<ReadData> read_data;
+      if (value) read_data = std::make_shared<ReadData>(*std::move(value));
+      execution::set_value(receiver, std::move(read_data));
+    }
+  };
+
+  Entry* DoAllocateEntry() final { return new Entry; }
+  size_t DoGetSizeofEntry() final { return sizeof(Entry); }
+  TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
+    ABSL_UNREACHABLE();
+  }
+
+  ReadCache(kvstore::DriverPtr driver, absl::Duration coalescing_window)
+      : Base(std::move(driver)), coalescing_window_(coalescing_window) {}
+
+  /// Reads the complete value of `key`, which must include the kvstore path.
+  Future<kvstore::ReadResult> Read(std::string_view key,
+                                   kvstore::ReadOptions options) {
+    auto entry = internal::GetCacheEntry(this, key);
+    // `absl::InfiniteFuture()` requires a value current as of the request.
+    absl::Time staleness_bound =
+        std::min(options.staleness_bound, absl::Now()) - coalescing_window_;
+    auto read_future = entry->Read({staleness_bound});
+    return PromiseFuturePair<kvstore::ReadResult>::LinkValue(
+               [entry = std::move(entry),
+                conditions = std::move(options.generation_conditions)](
+                   Promise<kvstore::ReadResult> promise,
+                   ReadyFuture<const void> future) {
+                 TimestampedStorageGeneration stamp;
+                 std::shared_ptr<const absl::Cord> value;
+                 {
+                   internal::AsyncCache::ReadLock<absl::Cord> lock(*entry);
+                   stamp = lock.stamp();
+                   value = lock.shared_data();
+                 }
+                 if (!value) {
+                   promise.SetResult(
+                       kvstore::ReadResult::Missing(std::move(stamp)));
+                 } else if (!conditions.Matches(stamp.generation)) {
+                   promise.SetResult(
+                       kvstore::ReadResult::Unspecified(std::move(stamp)));
+                 } else {
+                   promise.SetResult(
+                       kvstore::ReadResult::Value(*value, std::move(stamp)));
+                 }
+               },
+               std::move(read_future))
+        .future;
+  }
+
+ private:
+  absl::Duration coalescing_window_;
+};
+
+/// Reads `key` from `kvstore`, through `cache` if specified.
+///
+/// Byte range reads are not cached, since caching them would require reading
+/// the complete value.
+Future<kvstore::ReadResult> ServerRead(const KvStore& kvstore,
+                                       ReadCache* cache, std::string_view key,
+                                       kvstore::ReadOptions options) {
+  if (!cache || !options.byte_range.IsFull()) {
+    return kvstore::Read(kvstore, key, std::move(options));
+  }
+  return cache->Read(tensorstore::StrCat(kvstore.path, key),
+                     std::move(options));
+}
+
 class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
   using Base = Handler<ReadRequest, ReadResponse>;
 
  public:
   ReadHandler(CallbackServerContext* grpc_context, const Request* request,
-              Response* response, KvStore kvstore)
-      : Base(grpc_context, request, response), kvstore_(std::move(kvstore)) {}
+              Response* response, KvStore kvstore,
+              internal::CachePtr<ReadCache> cache)
+      : Base(grpc_context, request, response),
+        kvstore_(std::move(kvstore)),
+        cache_(std::move(cache)) {}
 
   void Run() {
     ABSL_LOG_IF(INFO, verbose_logging)
         << "ReadHandler " << ConciseDebugString(*request());
     kvstore::ReadOptions options{};
-    options.generation_conditions.if_equal.value =
-        request()->generation_if_equal();
-    options.generation_conditions.if_not_equal.value =
-        request()->generation_if_not_equal();
-
-    if (request()->has_byte_range()) {
-      options.byte_range.inclusive_min =
-          request()->byte_range().inclusive_min();
-      options.byte_range.exclusive_max =
-          request()->byte_range().exclusive_max();
-      if (!options.byte_range.SatisfiesInvariants()) {
-        Finish(absl::InvalidArgumentError("Invalid byte range"));
-        return;
-      }
-    }
-    if (request()->has_staleness_bound()) {
-      TENSORSTORE_ASSIGN_OR_RETURN(
-          options.staleness_bound,
-          internal::ProtoToAbslTime(request()->staleness_bound()), Finish(_));
-    }
+    TENSORSTORE_RETURN_IF_ERROR(DecodeReadOptions(*request(), options),
+                                Finish(_));
 
     internal::IntrusivePtr<ReadHandler> self{this};
     future_ =
@@ -149,7 +280,8 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
               if (!promise.result_needed()) return;
               promise.SetResult(self->HandleResult(read_result.result()));
             },
-            tensorstore::kvstore::Read(kvstore_, request()->key(), options))
+            ServerRead(kvstore_, cache_.get(), request()->key(),
+                       std::move(options)))
             .future;
   }
 
@@ -162,12 +294,7 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
   absl::Status HandleResult(const Result<kvstore::ReadResult>& result) {
     auto status = result.status();
     if (status.ok()) {
-      auto& r = result.value();
-      response()->set_state(static_cast<ReadResponse::State>(r.state));
-      EncodeGenerationAndTimestamp(r.stamp, response());
-      if (r.has_value()) {
-        response()->set_value(r.value);
-      }
+      EncodeReadResult(result.value(), response());
     }
     Finish(status);
     return status;
@@ -175,6 +302,7 @@ class ReadHandler final : public Handler<ReadRequest, ReadResponse> {
 
  private:
   KvStore kvstore_;
+  internal::CachePtr<ReadCache> cache_;
   Future<void> future_;
 };
 
@@ -436,6 +564,233 @@ void ListHandler::Run() {
       tensorstore::kvstore::List(self->kvstore_, options), self);
 }
 
+/// Common implementation of the `BatchRead` and `BatchWrite` streams.
+///
+/// Every entry of a request message is issued against the kvstore as soon as
+/// the message is received.  Completed entries are appended to the pending
+/// response message, which is sent as soon as no other message is in flight,
+/// so responses accumulated while a write is in progress are coalesced.
+///
+/// At most `kMaxOutstanding` operations are in progress at once; the next
+/// request message is not read until the count drops below that limit, which
+/// lets the grpc flow control push back on the client.
+template <typename Derived, typename RequestProto, typename ResponseProto>
+class BatchHandler : public BidiStreamHandler<RequestProto, ResponseProto> {
+  using Base = BidiStreamHandler<RequestProto, ResponseProto>;
+
+ public:
+  using ResponseEntry = typename ResponseProto::Entry;
+
+  constexpr static size_t kMaxOutstanding = 256;
+
+  BatchHandler(CallbackServerContext* grpc_context, KvStore kvstore)
+      : Base(grpc_context),
+        kvstore_(std::move(kvstore)),
+        current_(std::make_unique<ResponseProto>()) {}
+
+  void Run() {
+    absl::MutexLock l(&mu_);
+    reading_ = true;
+    this->StartRead(&request_);
+  }
+
+  void OnReadDone(bool ok) final {
+    if (!ok) {
+      absl::MutexLock l(&mu_);
+      reading_ = false;
+      reads_done_ = true;
+      MaybeWrite();
+      return;
+    }
+    ABSL_LOG_IF(INFO, verbose_logging)
+        << "BatchHandler " << ConciseDebugString(request_);
+    {
+      absl::MutexLock l(&mu_);
+      // Counted before issuing, since operations may complete inline.
+      outstanding_ += request_.entry_size();
+    }
+    // `reading_` remains set until the entries have been issued, which
+    // prevents `request_` from being reused by a concurrent `MaybeRead`.
+    for (const auto& entry : request_.entry()) {
+      static_cast<Derived*>(this)->Issue(entry);
+    }
+    request_.Clear();
+    absl::MutexLock l(&mu_);
+    reading_ = false;
+    MaybeRead();
+  }
+
+  void OnWriteDone(bool ok) final {
+    absl::MutexLock l(&mu_);
+    in_flight_msg_ = nullptr;
+    if (!ok) cancelled_ = true;
+    MaybeWrite();
+  }
+
+  void OnCancel() final {
+    absl::MutexLock l(&mu_);
+    cancelled_ = true;
+    MaybeWrite();
+  }
+
+ protected:
+  /// Records the response for the entry `id`; `fill` is invoked with the
+  /// response proto unless the stream has already finished.
+  template <typename Fill>
+  void AddResponse(uint64_t id, Fill fill) {
+    absl::MutexLock l(&mu_);
+    --outstanding_;
+    if (!finished_) {
+      auto* entry = current_->add_entry();
+      entry->set_id(id);
+      fill(entry->mutable_response());
+    }
+    MaybeWrite();
+    MaybeRead();
+  }
+
+  /// Records the result of `future`, the operation issued for the entry `id`,
+  /// using `encode` on success.
+  template <typename T, typename Encode>
+  void LinkResponse(uint64_t id, Future<T> future, Encode encode) {
+    future.ExecuteWhenReady(
+        [self = internal::IntrusivePtr<Derived>(static_cast<Derived*>(this)),
+         id, encode = std::move(encode)](ReadyFuture<T> f) {
+          self->AddResponse(id, [&](auto* response) {
+            auto& result = f.result();
+            if (!result.ok()) {
+              tensorstore_grpc::EncodeMessageStatus(result.status(), response);
+            } else if constexpr (std::is_void_v<T>) {
+              encode(response);
+            } else {
+              encode(*result, response);
+            }
+          });
+        });
+  }
+
+  KvStore kvstore_;
+
+ private:
+  void MaybeRead() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (reading_ || reads_done_ || finished_ || cancelled_) return;
+    if (outstanding_ >= kMaxOutstanding) return;
+    reading_ = true;
+    this->StartRead(&request_);
+  }
+
+  /// Sends the pending response message, if there is one and no other message
+  /// is in flight, or finishes the stream once all operations are complete.
+  void MaybeWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (in_flight_msg_ != nullptr || finished_) return;
+    if (cancelled_) {
+      finished_ = true;
+      this->Finish(::grpc::Status(::grpc::StatusCode::CANCELLED, ""));
+      return;
+    }
+    if (current_->entry().empty()) {
+      if (reads_done_ && !reading_ && outstanding_ == 0) {
+        finished_ = true;
+        this->Finish(::grpc::Status::OK);
+      }
+      return;
+    }
+    in_flight_msg_ = std::move(current_);
+    current_ = std::make_unique<ResponseProto>();
+    this->StartWrite(in_flight_msg_.get());
+  }
+
+  RequestProto request_;
+
+  absl::Mutex mu_;
+  std::unique_ptr<ResponseProto> current_ ABSL_GUARDED_BY(mu_);
+  std::unique_ptr<ResponseProto> in_flight_msg_ ABSL_GUARDED_BY(mu_);
+  size_t outstanding_ ABSL_GUARDED_BY(mu_) = 0;
+  bool reading_ ABSL_GUARDED_BY(mu_) = false;
+  bool reads_done_ ABSL_GUARDED_BY(mu_) = false;
+  bool cancelled_ ABSL_GUARDED_BY(mu_) = false;
+  bool finished_ ABSL_GUARDED_BY(mu_) = false;
+};
+
+class BatchReadHandler final
+    : public BatchHandler<BatchReadHandler, BatchReadRequest,
+                          BatchReadResponse> {
+  using Base =
+      BatchHandler<BatchReadHandler, BatchReadRequest, BatchReadResponse>;
+
+ public:
+  BatchReadHandler(CallbackServerContext* grpc_context, KvStore kvstore,
+                   internal::CachePtr<ReadCache> cache)
+      : Base(grpc_context, std::move(kvstore)), cache_(std::move(cache)) {}
+
+  void Issue(const BatchReadRequest::Entry& entry) {
+    kvstore::ReadOptions options{};
+    if (auto status = DecodeReadOptions(entry.request(), options);
+        !status.ok()) {
+      AddResponse(entry.id(), [&](ReadResponse* response) {
+        tensorstore_grpc::EncodeMessageStatus(status, response);
+      });
+      return;
+    }
+    LinkResponse(entry.id(),
+                 ServerRead(kvstore_, cache_.get(), entry.request().key(),
+                            std::move(options)),
+                 [](const kvstore::ReadResult& r, ReadResponse* response) {
+                   EncodeReadResult(r, response);
+                 });
+  }
+
+ private:
+  internal::CachePtr<ReadCache> cache_;
+};
+
+class BatchWriteHandler final
+    : public BatchHandler<BatchWriteHandler, BatchWriteRequest,
+                          BatchWriteResponse> {
+  using Base =
+      BatchHandler<BatchWriteHandler, BatchWriteRequest, BatchWriteResponse>;
+
+ public:
+  using Base::Base;
+
+  void Issue(const BatchWriteRequest::Entry& entry) {
+    constexpr auto encode_stamp = [](const TimestampedStorageGeneration& stamp,
+                                     WriteResponse* response) {
+      EncodeGenerationAndTimestamp(stamp, response);
+    };
+    if (entry.has_write()) {
+      const auto& request = entry.write();
+      kvstore::WriteOptions options{};
+      options.generation_conditions.if_equal.value =
+          request.generation_if_equal();
+      LinkResponse(entry.id(),
+                   kvstore::Write(kvstore_, request.key(),
+                                  absl::Cord(request.value()), options),
+                   encode_stamp);
+    } else if (entry.has_remove() && entry.remove().has_range()) {
+      const auto& range = entry.remove().range();
+      LinkResponse(
+          entry.id(),
+          kvstore::DeleteRange(
+              kvstore_, KeyRange(range.inclusive_min(), range.exclusive_max())),
+          [](WriteResponse* response) {});
+    } else if (entry.has_remove() && !entry.remove().key().empty()) {
+      const auto& request = entry.remove();
+      kvstore::WriteOptions options{};
+      options.generation_conditions.if_equal.value =
+          request.generation_if_equal();
+      LinkResponse(entry.id(),
+                   kvstore::Delete(kvstore_, request.key(), options),
+                   encode_stamp);
+    } else {
+      AddResponse(entry.id(), [](WriteResponse* response) {
+        tensorstore_grpc::EncodeMessageStatus(
+            absl::InvalidArgumentError("Invalid request"), response);
+      });
+    }
+  }
+};
+
 // ---------------------------------------
 
 }  // namespace
@@ -450,19 +805,29 @@ TENSORSTORE_DEFINE_JSON_DEFAULT_BINDER(
                }),
                jb::Member("bind_addresses",
                           jb::Projection<&KvStoreServer::Spec::bind_addresses>(
-                              jb::DefaultInitializedValue()))));
+                              jb::DefaultInitializedValue())),
+               jb::Member("read_cache",
+                          jb::Projection<&KvStoreServer::Spec::read_cache>(
+                              jb::DefaultInitializedValue())),
+               jb::Member(
+                   "read_coalescing_window",
+                   jb::Projection<&KvStoreServer::Spec::read_coalescing_window>(
+                       jb::DefaultValue<jb::kNeverIncludeDefaults>([](auto* x) {
+                         *x = absl::ZeroDuration();
+                       })))));
 
 /// Default forwarding implementation of tensorstore_grpc::KvStoreService.
 class KvStoreServer::Impl final : public KvStoreService::CallbackService {
  public:
-  Impl(KvStore kvstore) : kvstore_(std::move(kvstore)) {}
+  Impl(KvStore kvstore, internal::CachePtr<ReadCache> read_cache)
+      : kvstore_(std::move(kvstore)), read_cache_(std::move(read_cache)) {}
 
   ::grpc::ServerUnaryReactor* Read(::grpc::CallbackServerContext* context,
                                    const ReadRequest* request,
                                    ReadResponse* response) override {
     read_metric.Increment();
     internal::IntrusivePtr<ReadHandler> handler(
-        new ReadHandler(context, request, response, kvstore_));
+        new ReadHandler(context, request, response, kvstore_, read_cache_));
     assert(handler->use_count() == 2);
     handler->Run();
     assert(handler->use_count() > 0);
@@ -508,12 +873,33 @@ class KvStoreServer::Impl final : public KvStoreService::CallbackService {
     return handler.get();
   }
 
+  ::grpc::ServerBidiReactor<BatchReadRequest, BatchReadResponse>* BatchRead(
+      ::grpc::CallbackServerContext* context) override {
+    batch_read_metric.Increment();
+    internal::IntrusivePtr<BatchReadHandler> handler(
+        new BatchReadHandler(context, kvstore_, read_cache_));
+    assert(handler->use_count() == 2);
+    handler->Run();
+    return handler.get();
+  }
+
+  ::grpc::ServerBidiReactor<BatchWriteRequest, BatchWriteResponse>* BatchWrite(
+      ::grpc::CallbackServerContext* context) override {
+    batch_write_metric.Increment();
+    internal::IntrusivePtr<BatchWriteHandler> handler(
+        new BatchWriteHandler(context, kvstore_));
+    assert(handler->use_count() == 2);
+    handler->Run();
+    return handler.get();
+  }
+
   // Accessor
   const KvStore& kvstore() const { return kvstore_; }
 
  private:
   friend class KvStoreServer;
   KvStore kvstore_;
+  internal::CachePtr<ReadCache> read_cache_;
   std::vector<int> listening_ports_;
   std::unique_ptr<grpc::Server> server_;
 };
@@ -537,7 +923,19 @@ tensorstore::Result<KvStoreServer> KvStoreServer::Start(Spec spec,
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto kv, tensorstore::kvstore::Open(spec.base, context).result());
 
-  auto impl = std::make_unique<KvStoreServer::Impl>(std::move(kv));
+  internal::CachePtr<ReadCache> read_cache;
+  if (spec.read_cache) {
+    TENSORSTORE_ASSIGN_OR_RETURN(
+        auto cache_pool, context.GetResource<internal::CachePoolResource>());
+    // The cache is specific to this server, so it is not shared.
+    read_cache = internal::GetCache<ReadCache>(cache_pool->get(), "", [&] {
+      return std::make_unique<ReadCache>(kv.driver,
+                                         spec.read_coalescing_window);
+    });
+  }
+
+  auto impl = std::make_unique<KvStoreServer::Impl>(std::move(kv),
+                                                    std::move(read_cache));
 
   /// FIXME: Use a bound spec for credentials.
   auto creds = context.GetResource<tensorstore::GrpcServerCredentials>()
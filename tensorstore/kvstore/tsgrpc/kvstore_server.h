@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/time/time.h"
 #include "tensorstore/internal/json_binding/bindable.h"
 #include "tensorstore/json_serialization_options.h"
 #include "tensorstore/kvstore/spec.h"
@@ -61,6 +62,19 @@ class KvStoreServer {
 
     /// Underlying kvstore used by the server.
     kvstore::Spec base;
+
+    /// Serve reads of complete values through a cache in the ``cache_pool``
+    /// context resource.
+    ///
+    /// Concurrent reads of the same key share a single read of `base`, and
+    /// cached values are revalidated against `base` using their generation
+    /// rather than read again.
+    bool read_cache = false;
+
+    /// With `read_cache`, allows a read to be satisfied by a cached value, or
+    /// a read of `base` in progress, that is up to this much older than the
+    /// staleness bound of the read.
+    absl::Duration read_coalescing_window = absl::ZeroDuration();
   };
 
   /// Starts the kvstore server server.
@@ -14,7 +14,10 @@
 
 #include "tensorstore/kvstore/tsgrpc/kvstore_server.h"
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
 #include <type_traits>
 #include <vector>
 
@@ -23,10 +26,17 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/notification.h"
+#include "grpcpp/client_context.h"  // third_party
+#include "grpcpp/create_channel.h"  // third_party
+#include "grpcpp/security/credentials.h"  // third_party
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
+#include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
 #include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/mock_kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/spec.h"
@@ -38,12 +48,21 @@
 #include "tensorstore/util/result.h"
 #include "tensorstore/util/status_testutil.h"
 
+// protos
+#include "tensorstore/kvstore/tsgrpc/kvstore.grpc.pb.h"
+#include "tensorstore/kvstore/tsgrpc/kvstore.pb.h"
+
 namespace {
 
 namespace kvstore = ::tensorstore::kvstore;
 using ::tensorstore::KeyRange;
+using ::tensorstore::TimestampedStorageGeneration;
 using ::tensorstore::grpc_kvstore::KvStoreServer;
 using ::tensorstore::internal::MatchesKvsReadResultNotFound;
+using ::tensorstore_grpc::kvstore::BatchWriteRequest;
+using ::tensorstore_grpc::kvstore::BatchWriteResponse;
+using ::tensorstore_grpc::kvstore::WriteResponse;
+using ::tensorstore_grpc::kvstore::grpc_gen::KvStoreService;
 
 class KvStoreSingleton {
  public:
@@ -122,6 +141,98 @@ TEST_F(KvStoreTest, DeleteRange) {
               MatchesKvsReadResultNotFound());
 }
 
+TEST_F(KvStoreTest, BatchRead) {
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::kvstore::Open({{"driver", "tsgrpc_kvstore"},
+                                              {"address", address()},
+                                              {"path", "batch_read/"}},
+                                             context)
+                      .result());
+
+  TENSORSTORE_EXPECT_OK(kvstore::Write(store, "a", absl::Cord("abc")));
+  TENSORSTORE_EXPECT_OK(kvstore::Write(store, "b", absl::Cord("def")));
+
+  // More reads than fit in a single request message.
+  std::vector<tensorstore::Future<kvstore::ReadResult>> futures;
+  auto batch = tensorstore::Batch::New();
+  kvstore::ReadOptions options;
+  options.batch = batch;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(kvstore::Read(store, "a", options));
+  }
+  options.byte_range = tensorstore::OptionalByteRangeRequest{1, 2};
+  auto future_b = kvstore::Read(store, "b", options);
+  auto future_c = kvstore::Read(store, "c", options);
+  batch.Release();
+
+  for (auto& future : futures) {
+    EXPECT_EQ("abc", future.value().value);
+  }
+  EXPECT_EQ("e", future_b.value().value);
+  EXPECT_THAT(future_c.result(), MatchesKvsReadResultNotFound());
+}
+
+TEST_F(KvStoreTest, BatchWrite) {
+  auto channel =
+      grpc::CreateChannel(address(), grpc::InsecureChannelCredentials());
+  auto stub = KvStoreService::NewStub(channel);
+
+  BatchWriteRequest request;
+  {
+    auto* entry = request.add_entry();
+    entry->set_id(1);
+    entry->mutable_write()->set_key("batch_write/a");
+    entry->mutable_write()->set_value("abc");
+  }
+  {
+    auto* entry = request.add_entry();
+    entry->set_id(2);
+    entry->mutable_write()->set_key("batch_write/b");
+    entry->mutable_write()->set_value("def");
+    // Fails, since the key does not exist.
+    entry->mutable_write()->set_generation_if_equal(
+        tensorstore::StorageGeneration::FromString("x").value);
+  }
+  {
+    auto* entry = request.add_entry();
+    entry->set_id(3);
+    entry->mutable_remove();
+  }
+
+  grpc::ClientContext client_context;
+  auto stream = stub->BatchWrite(&client_context);
+  ASSERT_TRUE(stream->Write(request));
+  ASSERT_TRUE(stream->WritesDone());
+
+  std::map<uint64_t, WriteResponse> responses;
+  BatchWriteResponse response;
+  while (stream->Read(&response)) {
+    for (const auto& entry : response.entry()) {
+      responses[entry.id()] = entry.response();
+    }
+  }
+  ASSERT_TRUE(stream->Finish().ok());
+  ASSERT_EQ(3, responses.size());
+  EXPECT_FALSE(responses[1].has_status());
+  EXPECT_FALSE(responses[1].generation_and_timestamp().generation().empty());
+  EXPECT_FALSE(responses[2].has_status());
+  EXPECT_TRUE(responses[2].generation_and_timestamp().generation().empty());
+  EXPECT_EQ(static_cast<int>(absl::StatusCode::kInvalidArgument),
+            responses[3].status().code());
+
+  auto context = tensorstore::Context::Default();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store, tensorstore::kvstore::Open({{"driver", "tsgrpc_kvstore"},
+                                              {"address", address()},
+                                              {"path", "batch_write/"}},
+                                             context)
+                      .result());
+  EXPECT_EQ("abc", kvstore::Read(store, "a").value().value);
+  EXPECT_THAT(kvstore::Read(store, "b").result(),
+              MatchesKvsReadResultNotFound());
+}
+
 TEST_F(KvStoreTest, List) {
   auto context = tensorstore::Context::Default();
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(
@@ -217,4 +328,114 @@ TEST_F(KvStoreTest, List) {
   }
 }
 
+// Starts a server with the read cache enabled, backed by the mock kvstore of
+// the returned context.
+std::pair<KvStoreServer, tensorstore::Context> StartReadCacheServer(
+    ::nlohmann::json read_coalescing_window) {
+  auto context = tensorstore::Context(
+      tensorstore::Context::Spec::FromJson(
+          {{"cache_pool", {{"total_bytes_limit", 1000000}}}})
+          .value());
+  auto server =
+      KvStoreServer::Start(
+          KvStoreServer::Spec::FromJson(
+              {
+                  {"bind_addresses", {"localhost:0"}},
+                  {"base", {{"driver", "mock_key_value_store"}}},
+                  {"read_cache", true},
+                  {"read_coalescing_window", read_coalescing_window},
+              })
+              .value(),
+          context)
+          .value();
+  return {std::move(server), std::move(context)};
+}
+
+tensorstore::KvStore OpenClient(const KvStoreServer& server) {
+  return kvstore::Open({{"driver", "tsgrpc_kvstore"},
+                        {"address", absl::StrFormat("localhost:%d",
+                                                    server.port())}})
+      .value();
+}
+
+TEST(ReadCacheTest, Revalidate) {
+  auto [server, context] = StartReadCacheServer("0s");
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto* mock = mock_resource->get();
+  auto store = OpenClient(server);
+
+  auto stamp = TimestampedStorageGeneration(
+      tensorstore::StorageGeneration::FromString("g1"), absl::Now());
+  auto read1 = kvstore::Read(store, "a");
+  {
+    auto req = mock->read_requests.pop();
+    EXPECT_EQ("a", req.key);
+    EXPECT_TRUE(tensorstore::StorageGeneration::IsUnknown(
+        req.options.generation_conditions.if_not_equal));
+    req.promise.SetResult(kvstore::ReadResult::Value(absl::Cord("abc"), stamp));
+  }
+  EXPECT_EQ("abc", read1.value().value);
+
+  // The cached value is revalidated rather than read again.
+  auto read2 = kvstore::Read(store, "a");
+  {
+    auto req = mock->read_requests.pop();
+    EXPECT_EQ(stamp.generation, req.options.generation_conditions.if_not_equal);
+    stamp.time = absl::Now();
+    req.promise.SetResult(kvstore::ReadResult::Unspecified(stamp));
+  }
+  EXPECT_EQ("abc", read2.value().value);
+
+  // Conditions of the client read are applied to the cached value.
+  kvstore::ReadOptions options;
+  options.generation_conditions.if_not_equal = stamp.generation;
+  auto read3 = kvstore::Read(store, "a", options);
+  {
+    auto req = mock->read_requests.pop();
+    stamp.time = absl::Now();
+    req.promise.SetResult(kvstore::ReadResult::Unspecified(stamp));
+  }
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result3, read3.result());
+  EXPECT_TRUE(result3.aborted());
+}
+
+TEST(ReadCacheTest, CoalescingWindow) {
+  auto [server, context] = StartReadCacheServer("60s");
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto mock_resource,
+      context.GetResource<tensorstore::internal::MockKeyValueStoreResource>());
+  auto* mock = mock_resource->get();
+  auto store = OpenClient(server);
+
+  auto read1 = kvstore::Read(store, "a");
+  {
+    auto req = mock->read_requests.pop();
+    req.promise.SetResult(kvstore::ReadResult::Value(
+        absl::Cord("abc"),
+        TimestampedStorageGeneration(
+            tensorstore::StorageGeneration::FromString("g1"), absl::Now())));
+  }
+  EXPECT_EQ("abc", read1.value().value);
+
+  // Satisfied by the cached value without reading the base kvstore.
+  EXPECT_EQ("abc", kvstore::Read(store, "a").value().value);
+  EXPECT_TRUE(mock->read_requests.empty());
+
+  // Byte range reads bypass the cache.
+  kvstore::ReadOptions options;
+  options.byte_range = tensorstore::OptionalByteRangeRequest{1, 2};
+  auto read3 = kvstore::Read(store, "a", options);
+  {
+    auto req = mock->read_requests.pop();
+    EXPECT_EQ(options.byte_range, req.options.byte_range);
+    req.promise.SetResult(kvstore::ReadResult::Value(
+        absl::Cord("b"), TimestampedStorageGeneration(
+                             tensorstore::StorageGeneration::FromString("g1"),
+                             absl::Now())));
+  }
+  EXPECT_EQ("b", read3.value().value);
+}
+
 }  // namespace
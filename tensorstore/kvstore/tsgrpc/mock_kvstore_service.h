@@ -43,6 +43,12 @@ class MockKvStoreService : public kvstore::grpc_gen::KvStoreService::Service {
   TENSORSTORE_GRPC_SERVER_STREAMING_MOCK(
       List, ::tensorstore_grpc::kvstore::ListRequest,
       ::tensorstore_grpc::kvstore::ListResponse);
+  TENSORSTORE_GRPC_BIDI_STREAMING_MOCK(
+      BatchRead, ::tensorstore_grpc::kvstore::BatchReadRequest,
+      ::tensorstore_grpc::kvstore::BatchReadResponse);
+  TENSORSTORE_GRPC_BIDI_STREAMING_MOCK(
+      BatchWrite, ::tensorstore_grpc::kvstore::BatchWriteRequest,
+      ::tensorstore_grpc::kvstore::BatchWriteResponse);
 };
 
 }  // namespace tensorstore_grpc
@@ -22,6 +22,7 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/log/absl_log.h"
@@ -32,8 +33,10 @@
 #include "grpcpp/channel.h"  // third_party
 #include "grpcpp/client_context.h"  // third_party
 #include "grpcpp/create_channel.h"  // third_party
+#include "grpcpp/support/client_callback.h"  // third_party
 #include "grpcpp/support/status.h"  // third_party
 #include "grpcpp/support/sync_stream.h"  // third_party
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/concurrency_resource.h"
 #include "tensorstore/internal/context_binding.h"
@@ -46,7 +49,9 @@
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/internal/metrics/counter.h"
 #include "tensorstore/internal/metrics/metadata.h"
+#include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -84,6 +89,8 @@ using ::tensorstore::kvstore::ListEntry;
 using ::tensorstore::kvstore::ListReceiver;
 using ::tensorstore_grpc::DecodeGenerationAndTimestamp;
 using ::tensorstore_grpc::GetMessageStatus;
+using ::tensorstore_grpc::kvstore::BatchReadRequest;
+using ::tensorstore_grpc::kvstore::BatchReadResponse;
 using ::tensorstore_grpc::kvstore::DeleteRequest;
 using ::tensorstore_grpc::kvstore::DeleteResponse;
 using ::tensorstore_grpc::kvstore::ListRequest;
@@ -101,6 +108,10 @@ auto& grpc_read = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/tsgrpc/read",
     MetricMetadata("grpc driver kvstore::Read calls"));
 
+auto& grpc_batch_read = internal_metrics::Counter<int64_t>::New(
+    "/tensorstore/kvstore/tsgrpc/batch_read",
+    MetricMetadata("grpc driver BatchRead streams"));
+
 auto& grpc_write = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/tsgrpc/write",
     MetricMetadata("grpc driver kvstore::Write calls"));
@@ -117,6 +128,8 @@ auto& grpc_list = internal_metrics::Counter<int64_t>::New(
     "/tensorstore/kvstore/tsgrpc/list",
     MetricMetadata("grpc driver kvstore::List calls"));
 
+auto tsgrpc_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(tsgrpc);
+
 ABSL_CONST_INIT internal_log::VerboseFlag verbose_logging("tsgrpc_kvstore");
 
 namespace jb = tensorstore::internal_json_binding;
@@ -196,6 +209,35 @@ class TsGrpcKeyValueStore
 
 ////////////////////////////////////////////////////
 
+/// Encodes the parameters of a read into a `ReadRequest`.
+void EncodeReadRequest(kvstore::Key key,
+                       const kvstore::ReadGenerationConditions& conditions,
+                       const OptionalByteRangeRequest& byte_range,
+                       absl::Time staleness_bound, ReadRequest& request) {
+  request.set_key(std::move(key));
+  request.set_generation_if_equal(conditions.if_equal.value);
+  request.set_generation_if_not_equal(conditions.if_not_equal.value);
+  if (!byte_range.IsFull()) {
+    request.mutable_byte_range()->set_inclusive_min(byte_range.inclusive_min);
+    request.mutable_byte_range()->set_exclusive_max(byte_range.exclusive_max);
+  }
+  if (staleness_bound != absl::InfiniteFuture()) {
+    AbslTimeToProto(staleness_bound, request.mutable_staleness_bound());
+  }
+}
+
+/// Decodes a `ReadResponse` into a `kvstore::ReadResult`.
+Result<kvstore::ReadResult> DecodeReadResponse(const ReadResponse& response) {
+  TENSORSTORE_RETURN_IF_ERROR(GetMessageStatus(response));
+  TENSORSTORE_ASSIGN_OR_RETURN(auto stamp,
+                               DecodeGenerationAndTimestamp(response));
+  return kvstore::ReadResult{
+      static_cast<kvstore::ReadResult::State>(response.state()),
+      absl::Cord(response.value()),
+      std::move(stamp),
+  };
+}
+
 /// Implements `TsGrpcKeyValueStore::Read`.
 struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
   internal::IntrusivePtr<TsGrpcKeyValueStore> driver;
@@ -205,21 +247,8 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
 
   Future<kvstore::ReadResult> Start(kvstore::Key key,
                                     const kvstore::ReadOptions& options) {
-    request.set_key(std::move(key));
-    request.set_generation_if_equal(
-        options.generation_conditions.if_equal.value);
-    request.set_generation_if_not_equal(
-        options.generation_conditions.if_not_equal.value);
-    if (!options.byte_range.IsFull()) {
-      request.mutable_byte_range()->set_inclusive_min(
-          options.byte_range.inclusive_min);
-      request.mutable_byte_range()->set_exclusive_max(
-          options.byte_range.exclusive_max);
-    }
-    if (options.staleness_bound != absl::InfiniteFuture()) {
-      AbslTimeToProto(options.staleness_bound,
-                      request.mutable_staleness_bound());
-    }
+    EncodeReadRequest(std::move(key), options.generation_conditions,
+                      options.byte_range, options.staleness_bound, request);
 
     driver->MaybeSetDeadline(context);
 
@@ -244,15 +273,122 @@ struct ReadTask : public internal::AtomicReferenceCount<ReadTask> {
         << "ReadTask::Ready " << ConciseDebugString(response) << " " << status;
 
     TENSORSTORE_RETURN_IF_ERROR(status);
-    TENSORSTORE_RETURN_IF_ERROR(GetMessageStatus(response));
-    TENSORSTORE_ASSIGN_OR_RETURN(auto stamp,
-                                 DecodeGenerationAndTimestamp(response));
-    return kvstore::ReadResult{
-        static_cast<kvstore::ReadResult::State>(response.state()),
-        absl::Cord(response.value()),
-        std::move(stamp),
-    };
+    return DecodeReadResponse(response);
+  }
+};
+
+class BatchReadTask;
+using BatchReadTaskBase = internal_kvstore_batch::BatchReadEntry<
+    TsGrpcKeyValueStore,
+    internal_kvstore_batch::ReadRequest<kvstore::Key,
+                                        kvstore::ReadGenerationConditions>>;
+
+/// Implements batched `TsGrpcKeyValueStore::Read` calls.
+///
+/// All reads in a batch are multiplexed over a single `BatchRead` stream; each
+/// read is identified by its index in `request_batch.requests`.  Request
+/// messages are written one at a time, which together with the server-side
+/// limit on outstanding reads provides flow control.
+class BatchReadTask final
+    : public BatchReadTaskBase,
+      public grpc::ClientBidiReactor<BatchReadRequest, BatchReadResponse> {
+ public:
+  constexpr static size_t kMaxEntriesPerMessage = 64;
+
+  explicit BatchReadTask(BatchEntryKey&& batch_entry_key_)
+      : BatchReadTaskBase(std::move(batch_entry_key_)) {}
+
+  // Ownership of `this` is transferred to the stream, and released by
+  // `OnDone`.
+  void Submit(Batch::View batch) final {
+    grpc_batch_read.Increment();
+    auto& requests = request_batch.requests;
+    messages_.resize((requests.size() + kMaxEntriesPerMessage - 1) /
+                     kMaxEntriesPerMessage);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      auto& request = requests[i];
+      auto* entry = messages_[i / kMaxEntriesPerMessage].add_entry();
+      entry->set_id(i);
+      EncodeReadRequest(
+          std::move(std::get<kvstore::Key>(request)),
+          std::get<kvstore::ReadGenerationConditions>(request),
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(request)
+              .byte_range,
+          request_batch.staleness_bound, *entry->mutable_request());
+    }
+
+    driver().MaybeSetDeadline(context_);
+    driver().stub()->async()->BatchRead(&context_, this);
+    StartNextWrite();
+    StartRead(&response_);
+    StartCall();
+  }
+
+  void OnWriteDone(bool ok) final {
+    // On failure, the stream is broken and the status is reported to
+    // `OnDone`.
+    if (ok) StartNextWrite();
+  }
+
+  void OnReadDone(bool ok) final {
+    if (!ok) return;
+    ABSL_LOG_IF(INFO, verbose_logging)
+        << "BatchReadTask::OnReadDone " << ConciseDebugString(response_);
+    auto& requests = request_batch.requests;
+    std::vector<std::pair<Promise<kvstore::ReadResult>,
+                          Result<kvstore::ReadResult>>>
+        results;
+    results.reserve(response_.entry_size());
+    for (const auto& entry : response_.entry()) {
+      if (entry.id() >= requests.size()) continue;
+      auto& promise =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(
+              requests[entry.id()])
+              .promise;
+      if (promise.null()) continue;
+      results.emplace_back(std::move(promise),
+                           DecodeReadResponse(entry.response()));
+    }
+    response_.Clear();
+    StartRead(&response_);
+    if (results.empty()) return;
+    // Resolve the promises off of the grpc completion thread.
+    driver().executor()([results = std::move(results)]() mutable {
+      for (auto& [promise, result] : results) {
+        if (promise.result_needed()) promise.SetResult(std::move(result));
+      }
+    });
   }
+
+  void OnDone(const ::grpc::Status& s) final {
+    absl::Status status = GrpcStatusToAbslStatus(s);
+    if (status.ok()) {
+      status = absl::DataLossError("Missing BatchRead response");
+    }
+    for (auto& request : request_batch.requests) {
+      auto& promise =
+          std::get<internal_kvstore_batch::ByteRangeReadRequest>(request)
+              .promise;
+      if (!promise.null()) promise.SetResult(status);
+    }
+    delete this;
+  }
+
+ private:
+  void StartNextWrite() {
+    if (next_message_ == messages_.size()) return;
+    auto& message = messages_[next_message_++];
+    if (next_message_ == messages_.size()) {
+      StartWriteLast(&message, grpc::WriteOptions());
+    } else {
+      StartWrite(&message);
+    }
+  }
+
+  grpc::ClientContext context_;
+  std::vector<BatchReadRequest> messages_;
+  size_t next_message_ = 0;
+  BatchReadResponse response_;
 };
 
 /// Implements `TsGrpcKeyValueStore::Write`.
@@ -410,24 +546,39 @@ struct ListTask {
 Future<kvstore::ReadResult> TsGrpcKeyValueStore::Read(Key key,
                                                       ReadOptions options) {
   grpc_read.Increment();
+  if (options.batch) {
+    auto [promise, future] =
+        PromiseFuturePair<kvstore::ReadResult>::Make();
+    BatchReadTask::MakeRequest<BatchReadTask>(
+        *this, options.batch, options.staleness_bound,
+        {{std::move(promise), options.byte_range},
+         std::move(key),
+         std::move(options.generation_conditions)});
+    return internal_kvstore::RecordReadMetrics(tsgrpc_metrics,
+                                               std::move(future));
+  }
   auto task = internal::MakeIntrusivePtr<ReadTask>();
   task->driver = internal::IntrusivePtr<TsGrpcKeyValueStore>(this);
-  return task->Start(std::move(key), options);
+  return internal_kvstore::RecordReadMetrics(
+      tsgrpc_metrics, task->Start(std::move(key), options));
 }
 
 Future<TimestampedStorageGeneration> TsGrpcKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
   if (value) {
     grpc_write.Increment();
+    tsgrpc_metrics.bytes_written.IncrementBy(value->size());
     auto task = internal::MakeIntrusivePtr<WriteTask>();
     task->driver = internal::IntrusivePtr<TsGrpcKeyValueStore>(this);
-    return task->Start(std::move(key), value.value(), options);
+    return internal_kvstore::RecordWriteMetrics(
+        tsgrpc_metrics, task->Start(std::move(key), value.value(), options));
   } else {
     // empty value is delete.
     grpc_delete.Increment();
     auto task = internal::MakeIntrusivePtr<DeleteTask>();
     task->driver = internal::IntrusivePtr<TsGrpcKeyValueStore>(this);
-    return task->Start(std::move(key), options);
+    return internal_kvstore::RecordWriteMetrics(
+        tsgrpc_metrics, task->Start(std::move(key), options));
   }
 }
 
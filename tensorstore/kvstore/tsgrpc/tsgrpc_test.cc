@@ -24,6 +24,7 @@
 #include "grpcpp/grpcpp.h"  // third_party
 #include "grpcpp/support/status.h"  // third_party
 #include "grpcpp/support/sync_stream.h"  // third_party
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/grpc/grpc_mock.h"
 #include "tensorstore/kvstore/byte_range.h"
 #include "tensorstore/kvstore/generation.h"
@@ -48,6 +49,7 @@ namespace kvstore = ::tensorstore::kvstore;
 
 using ::protobuf_matchers::EqualsProto;
 using ::tensorstore::KeyRange;
+using ::tensorstore::MatchesStatus;
 using ::tensorstore::OptionalByteRangeRequest;
 using ::tensorstore::ParseTextProtoOrDie;
 using ::tensorstore::StorageGeneration;
@@ -57,6 +59,8 @@ using ::testing::Return;
 using ::testing::SetArgPointee;
 
 using ::tensorstore_grpc::MockKvStoreService;
+using ::tensorstore_grpc::kvstore::BatchReadRequest;
+using ::tensorstore_grpc::kvstore::BatchReadResponse;
 using ::tensorstore_grpc::kvstore::DeleteRequest;
 using ::tensorstore_grpc::kvstore::DeleteResponse;
 using ::tensorstore_grpc::kvstore::ListRequest;
@@ -75,6 +79,8 @@ class TsGrpcMockTest : public testing::Test {
     ON_CALL(mock(), Write).WillByDefault(Return(grpc::Status::CANCELLED));
     ON_CALL(mock(), Delete).WillByDefault(Return(grpc::Status::CANCELLED));
     ON_CALL(mock(), List).WillByDefault(Return(grpc::Status::CANCELLED));
+    ON_CALL(mock(), BatchRead).WillByDefault(Return(grpc::Status::CANCELLED));
+    ON_CALL(mock(), BatchWrite).WillByDefault(Return(grpc::Status::CANCELLED));
   }
 
   tensorstore::KvStore OpenStore() {
@@ -150,6 +156,78 @@ TEST_F(TsGrpcMockTest, ReadWithOptions) {
   EXPECT_EQ(result.stamp.generation, StorageGeneration::Unknown());
 }
 
+TEST_F(TsGrpcMockTest, BatchRead) {
+  BatchReadRequest expected_request = ParseTextProtoOrDie(R"pb(
+    entry { id: 0 request { key: 'a' } }
+    entry {
+      id: 1
+      request {
+        key: 'b'
+        byte_range { inclusive_min: 1 exclusive_max: 3 }
+      }
+    }
+  )pb");
+
+  // Responses may be returned in any order.
+  BatchReadResponse response = ParseTextProtoOrDie(R"pb(
+    entry {
+      id: 1
+      response {
+        state: 2
+        value: '23'
+        generation_and_timestamp {
+          generation: '1\001'
+          timestamp { seconds: 1634327736 }
+        }
+      }
+    }
+    entry { id: 0 response { state: 1 } }
+  )pb");
+
+  EXPECT_CALL(mock(), BatchRead(_, _))
+      .WillOnce(testing::Invoke(
+          [=](auto*,
+              grpc::ServerReaderWriter<BatchReadResponse, BatchReadRequest>*
+                  stream) -> ::grpc::Status {
+            BatchReadRequest request;
+            EXPECT_TRUE(stream->Read(&request));
+            EXPECT_THAT(request, EqualsProto(expected_request));
+            EXPECT_FALSE(stream->Read(&request));
+            stream->Write(response);
+            return grpc::Status::OK;
+          }));
+
+  auto store = OpenStore();
+  auto batch = tensorstore::Batch::New();
+  kvstore::ReadOptions options;
+  options.batch = batch;
+  auto future_a = kvstore::Read(store, "a", options);
+  options.byte_range = OptionalByteRangeRequest{1, 3};
+  auto future_b = kvstore::Read(store, "b", options);
+  batch.Release();
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result_a, future_a.result());
+  EXPECT_TRUE(result_a.not_found());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result_b, future_b.result());
+  EXPECT_EQ(result_b.value, "23");
+  EXPECT_EQ(result_b.stamp.generation, StorageGeneration::FromString("1"));
+}
+
+TEST_F(TsGrpcMockTest, BatchReadMissingResponse) {
+  EXPECT_CALL(mock(), BatchRead(_, _))
+      .WillOnce(Return(grpc::Status::OK));
+
+  auto store = OpenStore();
+  auto batch = tensorstore::Batch::New();
+  kvstore::ReadOptions options;
+  options.batch = batch;
+  auto future = kvstore::Read(store, "a", options);
+  batch.Release();
+
+  EXPECT_THAT(future.result(),
+              MatchesStatus(absl::StatusCode::kDataLoss, ".*BatchRead.*"));
+}
+
 TEST_F(TsGrpcMockTest, Write) {
   WriteRequest expected_request = ParseTextProtoOrDie(R"pb(
     key: 'abc'
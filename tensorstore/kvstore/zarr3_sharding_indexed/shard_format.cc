@@ -215,6 +215,7 @@ Result<ShardEntries> DecodeShard(
   const int64_t num_entries = shard_index_parameters.num_entries;
   ShardEntries entries;
   entries.entries.resize(num_entries);
+  entries.stored_locations.resize(num_entries);
   TENSORSTORE_ASSIGN_OR_RETURN(
       auto shard_index,
       DecodeShardIndexFromFullShard(shard_data, shard_index_parameters));
@@ -224,7 +225,9 @@ Result<ShardEntries> DecodeShard(
     TENSORSTORE_RETURN_IF_ERROR(entry_index.Validate(i, shard_data.size()));
     entries.entries[i] =
         internal::GetSubCord(shard_data, entry_index.AsByteRange());
+    entries.stored_locations[i] = entry_index;
   }
+  entries.stored_shard = shard_data;
   return entries;
 }
 
@@ -233,8 +236,11 @@ Result<std::optional<absl::Cord>> EncodeShard(
     const ShardIndexParameters& shard_index_parameters) {
   int64_t shard_index_size =
       shard_index_parameters.index_codec_state->encoded_size();
+  // The entries are appended directly rather than through a `riegeli::Writer`
+  // in order to share, rather than copy, their buffers.  The peak memory usage
+  // is thereby limited to a single copy of the encoded entries, which is
+  // required anyway to buffer them until writeback.
   absl::Cord shard_data;
-  riegeli::CordWriter writer{&shard_data};
   auto shard_index_array = AllocateArray<uint64_t>(
       shard_index_parameters.index_shape, c_order, default_init);
   bool has_entry = false;
@@ -251,7 +257,7 @@ Result<std::optional<absl::Cord>> EncodeShard(
       length = entry->size();
       entry_offset = offset;
       offset += length;
-      ABSL_CHECK(writer.Write(*entry));
+      shard_data.Append(*entry);
     } else {
       entry_offset = std::numeric_limits<uint64_t>::max();
       length = std::numeric_limits<uint64_t>::max();
@@ -260,27 +266,89 @@ Result<std::optional<absl::Cord>> EncodeShard(
     shard_index_array.data()[i * 2 + 1] = length;
   }
   if (!has_entry) return std::nullopt;
+  absl::Cord encoded_shard_index;
+  {
+    riegeli::CordWriter index_writer{&encoded_shard_index};
+    TENSORSTORE_RETURN_IF_ERROR(
+        EncodeShardIndex(index_writer, ShardIndex{std::move(shard_index_array)},
+                         shard_index_parameters));
+    ABSL_CHECK(index_writer.Close());
+  }
   switch (shard_index_parameters.index_location) {
-    case ShardIndexLocation::kStart: {
-      ABSL_CHECK(writer.Close());
-      absl::Cord encoded_shard_index;
-      riegeli::CordWriter index_writer{&encoded_shard_index};
-      TENSORSTORE_RETURN_IF_ERROR(EncodeShardIndex(
-          index_writer, ShardIndex{std::move(shard_index_array)},
-          shard_index_parameters));
-      ABSL_CHECK(index_writer.Close());
-      encoded_shard_index.Append(std::move(shard_data));
-      shard_data = std::move(encoded_shard_index);
+    case ShardIndexLocation::kStart:
+      shard_data.Prepend(encoded_shard_index);
       break;
-    }
-    case ShardIndexLocation::kEnd: {
-      TENSORSTORE_RETURN_IF_ERROR(
-          EncodeShardIndex(writer, ShardIndex{std::move(shard_index_array)},
-                           shard_index_parameters));
-      ABSL_CHECK(writer.Close());
+    case ShardIndexLocation::kEnd:
+      shard_data.Append(std::move(encoded_shard_index));
       break;
+  }
+  return shard_data;
+}
+
+namespace {
+// Returns `true` if entry `i` of `entries` is retained at its location within
+// `entries.stored_shard`.
+bool IsStoredEntry(const ShardEntries& entries, size_t i) {
+  return !entries.stored_locations.empty() &&
+         !entries.stored_locations[i].IsMissing();
+}
+}  // namespace
+
+uint64_t GetAppendedShardSize(
+    const ShardEntries& entries,
+    const ShardIndexParameters& shard_index_parameters, uint64_t& live_size) {
+  const uint64_t shard_index_size =
+      shard_index_parameters.index_codec_state->encoded_size();
+  uint64_t total_size = entries.stored_shard.size() + shard_index_size;
+  live_size = shard_index_size;
+  for (size_t i = 0; i < entries.entries.size(); ++i) {
+    const auto& entry = entries.entries[i];
+    if (!entry) continue;
+    live_size += entry->size();
+    if (!IsStoredEntry(entries, i)) total_size += entry->size();
+  }
+  return total_size;
+}
+
+Result<std::optional<absl::Cord>> EncodeShardByAppending(
+    const ShardEntries& entries,
+    const ShardIndexParameters& shard_index_parameters) {
+  assert(shard_index_parameters.index_location == ShardIndexLocation::kEnd);
+  absl::Cord shard_data = entries.stored_shard;
+  auto shard_index_array = AllocateArray<uint64_t>(
+      shard_index_parameters.index_shape, c_order, default_init);
+  bool has_entry = false;
+  uint64_t offset = entries.stored_shard.size();
+  for (size_t i = 0; i < entries.entries.size(); ++i) {
+    const auto& entry = entries.entries[i];
+    uint64_t entry_offset;
+    uint64_t length;
+    if (!entry) {
+      entry_offset = std::numeric_limits<uint64_t>::max();
+      length = std::numeric_limits<uint64_t>::max();
+    } else if (IsStoredEntry(entries, i)) {
+      has_entry = true;
+      const auto& location = entries.stored_locations[i];
+      assert(location.length == entry->size());
+      entry_offset = location.offset;
+      length = location.length;
+    } else {
+      has_entry = true;
+      length = entry->size();
+      entry_offset = offset;
+      offset += length;
+      shard_data.Append(*entry);
     }
+    shard_index_array.data()[i * 2] = entry_offset;
+    shard_index_array.data()[i * 2 + 1] = length;
   }
+  if (!has_entry) return std::nullopt;
+  riegeli::CordWriter writer{
+      &shard_data, riegeli::CordWriterBase::Options().set_append(true)};
+  TENSORSTORE_RETURN_IF_ERROR(
+      EncodeShardIndex(writer, ShardIndex{std::move(shard_index_array)},
+                       shard_index_parameters));
+  ABSL_CHECK(writer.Close());
   return shard_data;
 }
 
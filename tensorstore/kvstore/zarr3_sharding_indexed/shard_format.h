@@ -161,23 +161,64 @@ struct ShardEntries {
   // Size must always match product of shard grid shape.
   std::vector<ShardEntry> entries;
 
+  // Encoded shard from which `entries` was decoded, or empty if not
+  // applicable.  Used by `EncodeShardByAppending`.
+  absl::Cord stored_shard;
+
+  // Byte range within `stored_shard` of each entry, or
+  // `ShardIndexEntry::Missing()` if the entry is missing or has been modified
+  // since it was decoded.  Either empty or of the same size as `entries`.
+  std::vector<ShardIndexEntry> stored_locations;
+
+  // The entries are sub-cords of `stored_shard`, which is therefore not
+  // included in the memory usage estimate.
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
     return f(x.entries);
   };
 };
 
 /// Decodes a complete shard (entries followed by shard index).
+///
+/// Also sets `ShardEntries::stored_shard` and
+/// `ShardEntries::stored_locations`.
 Result<ShardEntries> DecodeShard(
     const absl::Cord& shard_data,
     const ShardIndexParameters& shard_index_parameters);
 
 /// Encodes a complete shard (entries followed by shard index).
 ///
+/// The returned cord shares the buffers of the entries rather than copying
+/// them.
+///
 /// Returns `std::nullopt` if all entries are missing.
 Result<std::optional<absl::Cord>> EncodeShard(
     const ShardEntries& entries,
     const ShardIndexParameters& shard_index_parameters);
 
+/// Returns the size of the shard that would be encoded by
+/// `EncodeShardByAppending`, and sets `live_size` to the number of bytes
+/// within it that are referenced by the new shard index (including the index
+/// itself).  The remaining bytes are dead space left by modified entries and
+/// prior shard indices.
+uint64_t GetAppendedShardSize(
+    const ShardEntries& entries,
+    const ShardIndexParameters& shard_index_parameters, uint64_t& live_size);
+
+/// Encodes a shard by appending to `entries.stored_shard`.
+///
+/// Entries with a non-missing `stored_locations` entry retain their existing
+/// byte range.  All other present entries are appended after the full
+/// `stored_shard`, followed by a new shard index, such that `stored_shard` is
+/// a prefix of the result.
+///
+/// Requires that `shard_index_parameters.index_location` is
+/// `ShardIndexLocation::kEnd`.
+///
+/// Returns `std::nullopt` if all entries are missing.
+Result<std::optional<absl::Cord>> EncodeShardByAppending(
+    const ShardEntries& entries,
+    const ShardIndexParameters& shard_index_parameters);
+
 }  // namespace zarr3_sharding_indexed
 namespace internal_json_binding {
 template <>
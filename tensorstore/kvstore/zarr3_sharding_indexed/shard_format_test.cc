@@ -14,7 +14,10 @@
 
 #include "tensorstore/kvstore/zarr3_sharding_indexed/shard_format.h"
 
+#include <stdint.h>
+
 #include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -39,7 +42,10 @@ using ::tensorstore::internal_zarr3::GetDefaultBytesCodecJson;
 using ::tensorstore::internal_zarr3::ZarrCodecChainSpec;
 using ::tensorstore::zarr3_sharding_indexed::DecodeShard;
 using ::tensorstore::zarr3_sharding_indexed::EncodeShard;
+using ::tensorstore::zarr3_sharding_indexed::EncodeShardByAppending;
+using ::tensorstore::zarr3_sharding_indexed::GetAppendedShardSize;
 using ::tensorstore::zarr3_sharding_indexed::ShardEntries;
+using ::tensorstore::zarr3_sharding_indexed::ShardIndexEntry;
 using ::tensorstore::zarr3_sharding_indexed::ShardIndexLocation;
 using ::tensorstore::zarr3_sharding_indexed::ShardIndexParameters;
 
@@ -110,6 +116,76 @@ TEST(EncodeShardTest, RoundTripEmpty) {
   }
 }
 
+TEST(EncodeShardTest, SharesEntryBuffers) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto p,
+                                   GetParams(ShardIndexLocation::kEnd, {2}));
+  absl::Cord entry(std::string(100000, 'x'));
+  auto flat = entry.TryFlat();
+  ASSERT_TRUE(flat.has_value());
+  ShardEntries entries;
+  entries.entries = {entry, std::nullopt};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeShard(entries, p));
+  ASSERT_TRUE(encoded.has_value());
+  EXPECT_EQ(flat->data(), encoded->chunk_begin()->data());
+}
+
+TEST(EncodeShardByAppendingTest, RoundTrip) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto p,
+                                   GetParams(ShardIndexLocation::kEnd, {2, 3}));
+  const int64_t index_size = p.index_codec_state->encoded_size();
+
+  ShardEntries entries;
+  entries.entries = {
+      absl::Cord("(0, 0)"), absl::Cord("(0, 1)"), std::nullopt,  //
+      std::nullopt,         absl::Cord("(1, 1)"), std::nullopt   //
+  };
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeShard(entries, p));
+  ASSERT_TRUE(encoded.has_value());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, DecodeShard(*encoded, p));
+  EXPECT_EQ(*encoded, decoded.stored_shard);
+  EXPECT_EQ(6, decoded.stored_locations[1].offset);
+  EXPECT_TRUE(decoded.stored_locations[2].IsMissing());
+
+  // Replace one entry, delete one entry, and add one entry.
+  decoded.entries[1] = absl::Cord("(0, 1) new");
+  decoded.stored_locations[1] = ShardIndexEntry::Missing();
+  decoded.entries[4] = std::nullopt;
+  decoded.stored_locations[4] = ShardIndexEntry::Missing();
+  decoded.entries[5] = absl::Cord("(1, 2)");
+  uint64_t live_size;
+  EXPECT_EQ(encoded->size() + 16 + index_size,
+            GetAppendedShardSize(decoded, p, live_size));
+  EXPECT_EQ(22 + index_size, live_size);
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto appended,
+                                   EncodeShardByAppending(decoded, p));
+  ASSERT_TRUE(appended.has_value());
+  EXPECT_EQ(encoded->size() + 16 + index_size, appended->size());
+  EXPECT_EQ(*encoded, appended->Subcord(0, encoded->size()));
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded_appended,
+                                   DecodeShard(*appended, p));
+  EXPECT_THAT(decoded_appended.entries,
+              ::testing::ElementsAreArray(decoded.entries));
+  EXPECT_EQ(0, decoded_appended.stored_locations[0].offset);
+  EXPECT_EQ(encoded->size(), decoded_appended.stored_locations[1].offset);
+}
+
+TEST(EncodeShardByAppendingTest, AllMissing) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto p,
+                                   GetParams(ShardIndexLocation::kEnd, {2}));
+  ShardEntries entries;
+  entries.entries = {absl::Cord("a"), std::nullopt};
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto encoded, EncodeShard(entries, p));
+  ASSERT_TRUE(encoded.has_value());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto decoded, DecodeShard(*encoded, p));
+  decoded.entries[0] = std::nullopt;
+  decoded.stored_locations[0] = ShardIndexEntry::Missing();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto appended,
+                                   EncodeShardByAppending(decoded, p));
+  EXPECT_FALSE(appended.has_value());
+}
+
 TEST(DecodeShardTest, TooShort) {
   absl::Cord encoded(std::string{1, 2, 3});
   TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto p,
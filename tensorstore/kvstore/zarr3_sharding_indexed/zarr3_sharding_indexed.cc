@@ -34,6 +34,7 @@
 #include "absl/time/time.h"
 #include <nlohmann/json.hpp>
 #include "tensorstore/batch.h"
+#include "tensorstore/batch_impl.h"
 #include "tensorstore/context.h"
 #include "tensorstore/driver/zarr3/codec/codec_chain_spec.h"
 #include "tensorstore/index.h"
@@ -52,6 +53,7 @@
 #include "tensorstore/json_serialization_options_base.h"
 #include "tensorstore/kvstore/batch_util.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -96,6 +98,9 @@ using ::tensorstore::internal_kvstore::kReadModifyWrite;
 using ::tensorstore::kvstore::ListEntry;
 using ::tensorstore::kvstore::ListReceiver;
 
+auto zarr3_sharding_indexed_metrics =
+    TENSORSTORE_KVSTORE_COMMON_METRICS(zarr3_sharding_indexed);
+
 // Read-only KvStore adapter that maps read requests to suffix-length byte range
 // requests in order to retrieve just the shard index.
 //
@@ -240,6 +245,14 @@ class ShardIndexCache
 /// update existing non-empty shards, it does read the full contents of the
 /// existing shard and store it within the cache entry.  This data is discarded
 /// once writeback completes.
+///
+/// If the base kvstore supports `kvstore::SupportedFeatures::kAppendInPlace`
+/// and the shard index is at the end, an existing shard is updated by
+/// appending just the modified entries followed by a new shard index (see
+/// `EncodeShardByAppending`), which allows the base kvstore to write only the
+/// appended bytes.  The dead space left by superseded entries and indices is
+/// reclaimed by re-encoding the full shard once it would exceed
+/// `kMaxAppendedShardDeadFraction` of the shard size.
 class ShardedKeyValueStoreWriteCache
     : public internal::KvsBackedCache<ShardedKeyValueStoreWriteCache,
                                       internal::AsyncCache> {
@@ -249,10 +262,21 @@ class ShardedKeyValueStoreWriteCache
  public:
   using ReadData = ShardEntries;
 
+  /// Maximum fraction of an updated shard that may consist of dead space when
+  /// appending in place, beyond which the full shard is re-encoded instead.
+  constexpr static double kMaxAppendedShardDeadFraction = 0.5;
+
   explicit ShardedKeyValueStoreWriteCache(
       internal::CachePtr<ShardIndexCache> shard_index_cache)
       : Base(kvstore::DriverPtr(shard_index_cache->base_kvstore_driver())),
-        shard_index_cache_(std::move(shard_index_cache)) {}
+        shard_index_cache_(std::move(shard_index_cache)) {
+    append_in_place_ =
+        shard_index_params().index_location == ShardIndexLocation::kEnd &&
+        (kvstore_driver()->GetSupportedFeatures(
+             KeyRange::Singleton(base_kvstore_path())) &
+         kvstore::SupportedFeatures::kAppendInPlace) !=
+            kvstore::SupportedFeatures::kNone;
+  }
 
   class Entry : public Base::Entry {
    public:
@@ -274,6 +298,11 @@ class ShardedKeyValueStoreWriteCache
               TENSORSTORE_ASSIGN_OR_RETURN(
                   entries, DecodeShard(*value, shard_index_params),
                   static_cast<void>(execution::set_error(receiver, _)));
+              if (!GetOwningCache(*this).append_in_place()) {
+                // Avoid retaining the index and any dead space.
+                entries.stored_shard = absl::Cord();
+                entries.stored_locations.clear();
+              }
             } else {
               // Initialize empty shard.
               entries.entries.resize(shard_index_params.num_entries);
@@ -287,9 +316,16 @@ class ShardedKeyValueStoreWriteCache
                   EncodeReceiver receiver) override {
       // Can call `EncodeShard` synchronously without using our executor since
       // `DoEncode` is already guaranteed to be called from our executor.
+      //
+      // `MergeForWriteback` retains `stored_shard` only if the shard is to be
+      // updated by appending.
+      const auto& shard_index_params =
+          GetOwningCache(*this).shard_index_params();
       TENSORSTORE_ASSIGN_OR_RETURN(
           auto encoded_shard,
-          EncodeShard(*data, GetOwningCache(*this).shard_index_params()),
+          data->stored_shard.empty()
+              ? EncodeShard(*data, shard_index_params)
+              : EncodeShardByAppending(*data, shard_index_params),
           static_cast<void>(execution::set_error(receiver, _)));
       execution::set_value(receiver, std::move(encoded_shard));
     }
@@ -404,6 +440,10 @@ class ShardedKeyValueStoreWriteCache
     void WritebackSuccess(ReadState&& read_state) override;
     void WritebackError() override;
 
+    uint64_t KvsWritebackUnchangedPrefixLength() override {
+      return unchanged_prefix_length_;
+    }
+
     void InvalidateReadState() override;
 
     bool MultiPhaseReadsCommitted() override { return this->reads_committed_; }
@@ -480,6 +520,11 @@ class ShardedKeyValueStoreWriteCache
 
     // Error status for the current pending call to `DoApply`.
     absl::Status apply_status_;
+
+    // Length of the existing shard retained as a prefix of the most recent
+    // writeback value computed by `MergeForWriteback`, or `0` if the shard is
+    // re-encoded in full.
+    uint64_t unchanged_prefix_length_ = 0;
   };
 
   Entry* DoAllocateEntry() final { return new Entry; }
@@ -505,7 +550,12 @@ class ShardedKeyValueStoreWriteCache
     return shard_index_cache_->base_kvstore_path();
   }
 
+  bool append_in_place() const { return append_in_place_; }
+
   internal::CachePtr<ShardIndexCache> shard_index_cache_;
+
+  // Indicates that existing shards are updated by appending.
+  bool append_in_place_;
 };
 
 void ShardedKeyValueStoreWriteCache::TransactionNode::InvalidateReadState() {
@@ -629,6 +679,7 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::MergeForWriteback(
   auto& cache = GetOwningCache(*this);
   const int64_t num_entries_per_shard = cache.num_entries_per_shard();
   const bool has_existing_entries = !new_entries.entries.empty();
+  const bool has_stored_locations = !new_entries.stored_locations.empty();
   new_entries.entries.resize(num_entries_per_shard);
   // Indicates that inconsistent conditional mutations were observed.
   bool mismatch = false;
@@ -645,6 +696,11 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::MergeForWriteback(
           new_entries.entries[id] = std::nullopt;
         }
       }
+      if (has_stored_locations) {
+        for (EntryId id = begin_id; id < end_id; ++id) {
+          new_entries.stored_locations[id] = ShardIndexEntry::Missing();
+        }
+      }
       changed = true;
       continue;
     }
@@ -678,6 +734,9 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::MergeForWriteback(
     } else if (!conditional) {
       changed = true;
     }
+    if (has_stored_locations) {
+      new_entries.stored_locations[entry_id] = ShardIndexEntry::Missing();
+    }
   }
   if (mismatch) {
     // We can't proceed, because the existing entries (if applicable) and the
@@ -694,6 +753,25 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::MergeForWriteback(
     this->StartApply();
     return;
   }
+  // Determine whether to update the existing shard by appending.  The existing
+  // shard is a valid prefix only if it was read from the base kvstore, rather
+  // than produced by a prior uncommitted modification.
+  unchanged_prefix_length_ = 0;
+  if (changed && cache.append_in_place() &&
+      !new_entries.stored_shard.empty() &&
+      !StorageGeneration::IsDirty(stamp.generation)) {
+    uint64_t live_size;
+    const uint64_t appended_size = GetAppendedShardSize(
+        new_entries, cache.shard_index_params(), live_size);
+    if (appended_size - live_size <=
+        appended_size * kMaxAppendedShardDeadFraction) {
+      unchanged_prefix_length_ = new_entries.stored_shard.size();
+    }
+  }
+  if (unchanged_prefix_length_ == 0) {
+    new_entries.stored_shard = absl::Cord();
+    new_entries.stored_locations.clear();
+  }
   internal::AsyncCache::ReadState update;
   update.stamp = std::move(stamp);
   if (changed) {
@@ -715,6 +793,15 @@ void ShardedKeyValueStoreWriteCache::TransactionNode::WritebackSuccess(
     }
   }
   internal_kvstore::DestroyPhaseEntries(phases_);
+  if (GetOwningCache(*this).append_in_place() &&
+      !StorageGeneration::IsUnknown(read_state.stamp.generation)) {
+    // The written entries do not record their locations within the new shard,
+    // which are required to append to it.  Instead of caching them, mark the
+    // existing read state as stale so that the new shard is read and decoded
+    // by the next update.
+    read_state.data = nullptr;
+    read_state.stamp.generation = StorageGeneration::Unknown();
+  }
   Base::TransactionNode::WritebackSuccess(std::move(read_state));
 }
 
@@ -866,6 +953,58 @@ ShardedKeyValueStore::ShardedKeyValueStore(
                       std::move(params.index_params));
                 }));
       });
+  // Set here rather than when opening from a spec, since nested sharded
+  // kvstores created by the zarr3 driver also rely on the nesting depth to
+  // order their batch entries.
+  SetBatchNestingDepth(
+      base_kvstore_driver()->BatchNestingDepth() +
+      1 +  // for queuing entry requests
+      1    // for AsyncCache queuing the index request when needed
+  );
+}
+
+// Batch entry that holds the successor batch shared by all
+// `ReadOperationState` objects of a given batch nesting depth that were
+// submitted in the same batch.
+//
+// Sharing the successor batch allows the entry reads for separate shards, and
+// in particular for sibling inner shards of nested sharding, to reach the base
+// kvstore in a single batch, where they can be coalesced into a small number of
+// byte range requests.  Successor batches are only shared within a single
+// nesting depth, since a `ReadOperationState` waits on reads issued to shards
+// at lower nesting depths.
+class SharedSuccessorBatchEntry : public Batch::Impl::Entry {
+ public:
+  using KeyParam = size_t;
+
+  // Nesting depth of 0 ensures the successor batch is retained until all
+  // `ReadOperationState` objects in the batch have acquired it.
+  explicit SharedSuccessorBatchEntry(size_t nesting_depth)
+      : Batch::Impl::Entry(/*nesting_depth=*/0),
+        nesting_depth_(nesting_depth),
+        successor_batch(Batch::New()) {}
+
+  KeyParam key() const { return nesting_depth_; }
+
+  void Submit(Batch::View batch) override { delete this; }
+
+  size_t nesting_depth_;
+  Batch successor_batch;
+};
+
+// Returns the successor batch shared by reads of sharded kvstores with the
+// specified `nesting_depth` in `batch`.
+//
+// Must be called before `batch` has been submitted, or from the `Submit`
+// method of a batch entry with a non-zero nesting depth.
+Batch GetSharedSuccessorBatch(Batch::View batch, size_t nesting_depth) {
+  return Batch::Impl::From(batch)
+      ->GetEntry<SharedSuccessorBatchEntry>(
+          nesting_depth,
+          [&] {
+            return std::make_unique<SharedSuccessorBatchEntry>(nesting_depth);
+          })
+      .successor_batch;
 }
 
 /// Asynchronous state and associated methods for `ShardedKeyValueStore::Read`.
@@ -911,8 +1050,10 @@ class ReadOperationState
     if (batch) {
       if (!shard_index_read_future.ready()) {
         // Shard index will be read using this batch.  The actual entries will
-        // be read using the successor batch.
-        successor_batch_ = Batch::New();
+        // be read using the successor batch, which is shared with other shards
+        // of the same nesting depth read using this batch.
+        successor_batch_ =
+            GetSharedSuccessorBatch(batch, driver().BatchNestingDepth());
       } else {
         successor_batch_ = std::move(batch);
       }
@@ -1159,7 +1300,8 @@ Future<kvstore::ReadResult> ShardedKeyValueStore::Read(Key key,
       ReadOperationState::Request{{std::move(promise), options.byte_range},
                                   {entry_id},
                                   std::move(options.generation_conditions)});
-  return std::move(future);
+  return internal_kvstore::RecordReadMetrics(zarr3_sharding_indexed_metrics,
+                                             std::move(future));
 }
 
 // Asynchronous operation state for `ShardedKeyValueStore::ListImpl`.
@@ -1229,8 +1371,13 @@ void ShardedKeyValueStore::ListImpl(ListOptions options,
 
 Future<TimestampedStorageGeneration> ShardedKeyValueStore::Write(
     Key key, std::optional<Value> value, WriteOptions options) {
-  return internal_kvstore::WriteViaTransaction(
-      this, std::move(key), std::move(value), std::move(options));
+  if (value) {
+    zarr3_sharding_indexed_metrics.bytes_written.IncrementBy(value->size());
+  }
+  return internal_kvstore::RecordWriteMetrics(
+      zarr3_sharding_indexed_metrics,
+      internal_kvstore::WriteViaTransaction(
+          this, std::move(key), std::move(value), std::move(options)));
 }
 
 absl::Status ShardedKeyValueStore::ReadModifyWrite(
@@ -1356,11 +1503,6 @@ Future<kvstore::DriverPtr> ShardedKeyValueStoreSpec::DoOpen() const {
             spec->data_.data_copy_concurrency,
             spec->data_.index_codecs,
         });
-        driver->SetBatchNestingDepth(
-            driver->base_kvstore_driver()->BatchNestingDepth() +
-            1 +  // for queuing entry requests
-            1    // for AsyncCache queuing the index request when needed
-        );
         return driver;
       },
       kvstore::Open(data_.base));
@@ -1371,6 +1513,22 @@ kvstore::DriverPtr GetShardedKeyValueStore(
   return kvstore::DriverPtr(new ShardedKeyValueStore(std::move(parameters)));
 }
 
+Future<const void> PrefetchShardIndex(kvstore::Driver& driver,
+                                      absl::Time staleness_bound,
+                                      Batch batch) {
+  auto* store = dynamic_cast<ShardedKeyValueStore*>(&driver);
+  if (!store) {
+    return absl::InvalidArgumentError(
+        "Shard index prefetch requires a zarr3_sharding_indexed kvstore");
+  }
+  auto entry = GetCacheEntry(store->shard_index_cache(), std::string_view{});
+  auto future = entry->Read({staleness_bound, std::move(batch)});
+  // Keep the entry pinned until the read completes.
+  future.ExecuteWhenReady(
+      [entry = std::move(entry)](ReadyFuture<const void> future) {});
+  return future;
+}
+
 }  // namespace zarr3_sharding_indexed
 }  // namespace tensorstore
 
@@ -45,20 +45,37 @@
 /// To read an entry, the shard index must first be read and decoded, and then
 /// the byte range indicated by the shard index is read.  Depending on the cache
 /// pool configuration, the shard index may be cached to reduce overhead for
-/// repeated read requests to the same shard.
+/// repeated read requests to the same shard.  `PrefetchShardIndex` may be used
+/// to load the shard index into the cache ahead of time; when many shards are
+/// accessed together, their shard indices are read concurrently by specifying a
+/// common `Batch`.
+///
+/// Entry reads for all shards read using a common `Batch` are likewise issued to
+/// the base kvstore using a single successor batch.  With nested sharding, where
+/// the base kvstore is itself a sharded kvstore, this allows reads from sibling
+/// inner shards to be coalesced into a small number of byte range requests to
+/// the outermost shard.
 ///
 /// To write an entry or otherwise make any changes to a shard, the entire shard
-/// is re-written.
+/// is re-written, except if the base kvstore supports
+/// `kvstore::SupportedFeatures::kAppendInPlace` and the shard index is at the
+/// end.  In that case only the modified entries and a new shard index are
+/// appended to the existing shard, and the full shard is re-written only once
+/// the dead space left by superseded entries and shard indices would exceed
+/// half of the shard.
 
 #include <stdint.h>
 
 #include <string>
 #include <string_view>
 
+#include "absl/time/time.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/zarr3_sharding_indexed/shard_format.h"  // IWYU pragma: export
 #include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
 #include "tensorstore/util/result.h"
 
 namespace tensorstore {
@@ -75,6 +92,26 @@ struct ShardedKeyValueStoreParameters {
 kvstore::DriverPtr GetShardedKeyValueStore(
     ShardedKeyValueStoreParameters&& parameters);
 
+/// Reads the shard index of a sharded kvstore into the shard index cache,
+/// without reading any entries.
+///
+/// Subsequent reads from `driver` with a staleness bound not newer than
+/// `staleness_bound` are served from the cached shard index, provided that it
+/// has not been evicted from the cache pool.
+///
+/// \param driver Sharded kvstore returned by `GetShardedKeyValueStore` or
+///     opened from a ``zarr3_sharding_indexed`` spec.
+/// \param staleness_bound Cached shard index data older than this is
+///     revalidated.
+/// \param batch Optional batch with which to issue the read of the shard
+///     index.  Specifying the same batch for multiple shards allows the shard
+///     indices to be read concurrently once the batch is submitted.
+/// \error `absl::StatusCode::kInvalidArgument` if `driver` is not a sharded
+///     kvstore.
+Future<const void> PrefetchShardIndex(kvstore::Driver& driver,
+                                      absl::Time staleness_bound,
+                                      Batch batch = no_batch);
+
 }  // namespace zarr3_sharding_indexed
 }  // namespace tensorstore
 
@@ -99,6 +99,7 @@ using ::tensorstore::kvstore::ReadResult;
 using ::tensorstore::zarr3_sharding_indexed::EntryId;
 using ::tensorstore::zarr3_sharding_indexed::EntryIdToKey;
 using ::tensorstore::zarr3_sharding_indexed::GetShardedKeyValueStore;
+using ::tensorstore::zarr3_sharding_indexed::PrefetchShardIndex;
 using ::tensorstore::zarr3_sharding_indexed::ShardedKeyValueStoreParameters;
 using ::tensorstore::zarr3_sharding_indexed::ShardIndexLocation;
 
@@ -211,6 +212,55 @@ TEST(ShardedKeyValueStoreTest, DescribeKey) {
   }
 }
 
+TEST(ShardedKeyValueStoreTest, AppendInPlace) {
+  tensorstore::internal_testing::ScopedTemporaryDirectory tempdir;
+  CachePool::StrongPtr cache_pool = CachePool::Make(kSmallCacheLimits);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto base_store, kvstore::Open({{"driver", "file"},
+                                      {"path", tempdir.path() + "/"},
+                                      {"append_in_place", true}})
+                           .result());
+  std::vector<Index> grid_shape{4};
+  kvstore::DriverPtr store =
+      GetDefaultStore(base_store.driver, "shard_path",
+                      tensorstore::InlineExecutor{}, cache_pool, grid_shape);
+  // 4 entries of 16 bytes each, followed by the crc32c checksum.
+  const size_t index_size = 4 * 16 + 4;
+  auto get_shard_size = [&] {
+    auto read_result = kvstore::Read(base_store, "shard_path").value();
+    return read_result.value.size();
+  };
+
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(0, grid_shape), absl::Cord("aaaa")).result());
+  EXPECT_EQ(4 + index_size, get_shard_size());
+
+  // The new entry and index are appended to the existing shard.
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(1, grid_shape), absl::Cord("bb")).result());
+  EXPECT_EQ(4 + index_size + 2 + index_size, get_shard_size());
+  EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("aaaa")));
+  EXPECT_THAT(store->Read(EntryIdToKey(1, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("bb")));
+
+  // Appending would leave more than half of the shard as dead space, so the
+  // shard is re-written.
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(0, grid_shape), absl::Cord("cccc")).result());
+  EXPECT_EQ(4 + 2 + index_size, get_shard_size());
+  EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("cccc")));
+  EXPECT_THAT(store->Read(EntryIdToKey(1, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("bb")));
+
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(2, grid_shape), absl::Cord("d")).result());
+  EXPECT_EQ(4 + 2 + index_size + 1 + index_size, get_shard_size());
+  EXPECT_THAT(store->Read(EntryIdToKey(2, grid_shape)).result(),
+              MatchesKvsReadResult(absl::Cord("d")));
+}
+
 class RawEncodingTest : public ::testing::Test {
  protected:
   CachePool::StrongPtr cache_pool = CachePool::Make(kSmallCacheLimits);
@@ -1292,6 +1342,108 @@ TEST_F(UnderlyingKeyValueStoreTest, BatchRead) {
   }
 }
 
+// Tests that entry reads from sibling inner shards of nested sharding are
+// coalesced into a single batch request to the base kvstore.
+TEST_F(UnderlyingKeyValueStoreTest, NestedBatchRead) {
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  mock_store->handle_batch_requests = true;
+  const std::vector<Index> outer_grid_shape{2};
+  const std::vector<Index> inner_grid_shape{3};
+  const auto get_inner_stores = [&] {
+    auto outer_store =
+        GetDefaultStore(mock_store, "shard_path", tensorstore::InlineExecutor{},
+                        cache_pool, outer_grid_shape);
+    std::vector<kvstore::DriverPtr> inner_stores;
+    for (EntryId i = 0; i < 2; ++i) {
+      inner_stores.push_back(GetDefaultStore(
+          outer_store, EntryIdToKey(i, outer_grid_shape),
+          tensorstore::InlineExecutor{}, cache_pool, inner_grid_shape));
+    }
+    return inner_stores;
+  };
+
+  {
+    auto inner_stores = get_inner_stores();
+    for (auto& inner_store : inner_stores) {
+      for (EntryId i = 0; i < 2; ++i) {
+        TENSORSTORE_ASSERT_OK(
+            inner_store
+                ->Write(EntryIdToKey(i, inner_grid_shape),
+                        absl::Cord(tensorstore::StrCat("value", i)))
+                .result());
+      }
+    }
+  }
+
+  // Read with an empty cache.
+  cache_pool = CachePool::Make(kSmallCacheLimits);
+  auto inner_stores = get_inner_stores();
+  mock_store->request_log.pop_all();
+
+  std::vector<Future<kvstore::ReadResult>> futures;
+  {
+    kvstore::ReadOptions options;
+    options.batch = Batch::New();
+    for (auto& inner_store : inner_stores) {
+      for (EntryId i = 0; i < 2; ++i) {
+        futures.push_back(
+            inner_store->Read(EntryIdToKey(i, inner_grid_shape), options));
+      }
+    }
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    EXPECT_THAT(futures[i].result(),
+                MatchesKvsReadResult(
+                    absl::Cord(tensorstore::StrCat("value", i % 2))));
+  }
+  // Expected to result in a request for the outer shard index, a single batch
+  // request for both inner shard indices, and a single batch request for all
+  // four entries.
+  auto request_log = mock_store->request_log.pop_all();
+  ASSERT_THAT(request_log, ::testing::SizeIs(3));
+  EXPECT_THAT(request_log[1]["requests"], ::testing::SizeIs(2));
+  EXPECT_THAT(request_log[2]["requests"], ::testing::SizeIs(4));
+}
+
+TEST_F(UnderlyingKeyValueStoreTest, PrefetchShardIndex) {
+  auto memory_store = tensorstore::GetMemoryKeyValueStore();
+  mock_store->forward_to = memory_store;
+  mock_store->log_requests = true;
+  mock_store->handle_batch_requests = true;
+  grid_shape = {3};
+  store = GetStore(grid_shape);
+  TENSORSTORE_ASSERT_OK(
+      store->Write(EntryIdToKey(0, grid_shape), absl::Cord("abc")).result());
+  mock_store->request_log.pop_all();
+
+  // Prefetching reads only the shard index.
+  {
+    Future<const void> future;
+    {
+      Batch batch = Batch::New();
+      future = PrefetchShardIndex(*store, absl::Now(), batch);
+      // Not issued until the batch is submitted.
+      EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(0));
+    }
+    TENSORSTORE_ASSERT_OK(future.result());
+    EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+  }
+
+  // Subsequent read uses the cached shard index.
+  {
+    kvstore::ReadOptions options;
+    options.staleness_bound = absl::InfinitePast();
+    EXPECT_THAT(store->Read(EntryIdToKey(0, grid_shape), options).result(),
+                MatchesKvsReadResult(absl::Cord("abc")));
+    EXPECT_THAT(mock_store->request_log.pop_all(), ::testing::SizeIs(1));
+  }
+
+  EXPECT_THAT(PrefetchShardIndex(*memory_store, absl::Now()).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests of ReadModifyWrite operations, using `KvsBackedTestCache` ->
 // `ShardedKeyValueStore` -> `MockKeyValueStore`.
 class ReadModifyWriteTest : public ::testing::Test {
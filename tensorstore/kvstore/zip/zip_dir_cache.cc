@@ -33,6 +33,7 @@
 #include "absl/time/time.h"
 #include "riegeli/bytes/cord_reader.h"
 #include "riegeli/bytes/cord_writer.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/compression/zip_details.h"
@@ -72,6 +73,9 @@ struct ReadDirectoryOp
 
     auto future =
         cache.kvstore_driver_->Read(std::string(entry_->key()), options_);
+    // Only the initial read joins the batch; holding it for subsequent reads
+    // would prevent it from being submitted.
+    options_.batch = no_batch;
 
     future.Force();
     future.ExecuteWhenReady(
@@ -106,7 +110,11 @@ struct ReadDirectoryOp
       return;
     }
     if (read_result.not_found()) {
-      entry_->ReadError(absl::NotFoundError(""));
+      // A missing archive is equivalent to an empty archive, which allows
+      // a new archive to be created by writing to it.
+      entry_->ReadSuccess(ZipDirectoryCache::ReadState{
+          std::make_shared<const Directory>(Directory{}),
+          std::move(read_result.stamp)});
       return;
     }
 
@@ -212,23 +220,29 @@ struct ReadDirectoryOp
       // Only add validated entries to the zip directory.
       if (ValidateEntryIsSupported(entry).ok()) {
         ABSL_LOG_IF(INFO, zip_logging) << "Adding " << entry;
-        dir.entries.push_back(
-            Directory::Entry{entry.filename, entry.crc, entry.compressed_size,
-                             entry.uncompressed_size, entry.local_header_offset,
-                             entry.estimated_read_size});
+        dir.entries.push_back(Directory::Entry{
+            dir.filenames.size(),
+            static_cast<uint16_t>(entry.filename.size()), entry.crc,
+            entry.compressed_size, entry.uncompressed_size,
+            entry.local_header_offset, entry.estimated_read_size});
+        dir.filenames.append(entry.filename);
       } else {
         ABSL_LOG_IF(INFO, zip_logging) << "Skipping " << entry;
       }
     }
+    dir.filenames.shrink_to_fit();
+    dir.entries.shrink_to_fit();
 
     // Sort by local header offset first, then by name, to determine
     // the estimated read size for each entry. Typically a ZIP file will
     // already be ordered like this. Subsequently, the gap between the
     // headers is used to determine how many bytes to read.
     std::sort(dir.entries.begin(), dir.entries.end(),
-              [](const auto& a, const auto& b) {
-                return std::tie(a.local_header_offset, a.filename) <
-                       std::tie(b.local_header_offset, b.filename);
+              [&](const auto& a, const auto& b) {
+                if (a.local_header_offset != b.local_header_offset) {
+                  return a.local_header_offset < b.local_header_offset;
+                }
+                return dir.filename(a) < dir.filename(b);
               });
     auto last_header_offset = eocd_.cd_offset;
     for (auto it = dir.entries.rbegin(); it != dir.entries.rend(); ++it) {
@@ -238,9 +252,9 @@ struct ReadDirectoryOp
 
     // Sort directory by filename.
     std::sort(dir.entries.begin(), dir.entries.end(),
-              [](const auto& a, const auto& b) {
-                return std::tie(a.filename, a.local_header_offset) <
-                       std::tie(b.filename, a.local_header_offset);
+              [&](const auto& a, const auto& b) {
+                return std::tuple(dir.filename(a), a.local_header_offset) <
+                       std::tuple(dir.filename(b), b.local_header_offset);
               });
 
     ABSL_LOG_IF(INFO, zip_logging) << dir;
@@ -270,6 +284,7 @@ void ZipDirectoryCache::Entry::DoRead(AsyncCacheReadRequest request) {
 
   // Setup options.
   state->options_.staleness_bound = request.staleness_bound;
+  state->options_.batch = request.batch;
   if (state->existing_read_data_ && state->existing_read_data_->full_read) {
     state->options_.byte_range = OptionalByteRangeRequest{};
   } else {
@@ -16,8 +16,11 @@
 #define TENSORSTORE_KVSTORE_ZIP_ZIP_DIR_CACHE_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -32,10 +35,16 @@
 namespace tensorstore {
 namespace internal_zip_kvstore {
 
+/// In-memory index of a ZIP central directory.
+///
+/// Archives may contain millions of members, so entries are stored compactly:
+/// filenames are concatenated into a single buffer rather than being allocated
+/// per entry, and `entries` is sorted by filename to allow binary search.
 struct Directory {
   struct Entry {
-    // Filename within the zip file.
-    std::string filename;
+    // Location of the filename within `Directory::filenames`.
+    uint64_t filename_offset;
+    uint16_t filename_size;
 
     // Zip central directory parameters.
     uint32_t crc;
@@ -45,36 +54,56 @@ struct Directory {
     uint64_t estimated_size;
 
     constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-      return f(x.filename, x.crc, x.compressed_size, x.uncompressed_size,
-               x.local_header_offset, x.estimated_size);
+      return f(x.filename_offset, x.filename_size, x.crc, x.compressed_size,
+               x.uncompressed_size, x.local_header_offset, x.estimated_size);
     };
-
-    template <typename Sink>
-    friend void AbslStringify(Sink& sink, const Entry& entry) {
-      absl::Format(
-          &sink,
-          "Entry{filename=%s, crc=%d, compressed_size=%d, "
-          "uncompressed_size=%d, local_header_offset=%d, estimated_size=%d}",
-          entry.filename, entry.crc, entry.compressed_size,
-          entry.uncompressed_size, entry.local_header_offset,
-          entry.estimated_size);
-    }
   };
 
+  // Filenames of all entries, concatenated.
+  std::string filenames;
+
+  // Entries, sorted by filename.
+  std::vector<Entry> entries;
+
   // Indicates whether the ZIP kvstore should issue reads for the entire file;
   // this is done when the initial read returns a range error.
-  std::vector<Entry> entries;
   bool full_read;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.entries, x.full_read);
+    return f(x.filenames, x.entries, x.full_read);
   };
 
+  std::string_view filename(const Entry& entry) const {
+    return std::string_view(filenames).substr(entry.filename_offset,
+                                              entry.filename_size);
+  }
+
+  // Returns the first entry whose filename is not less than `key`.
+  std::vector<Entry>::const_iterator LowerBound(std::string_view key) const {
+    return std::lower_bound(entries.begin(), entries.end(), key,
+                            [&](const Entry& e, std::string_view k) {
+                              return filename(e) < k;
+                            });
+  }
+
+  // Returns the entry with filename `key`, or `nullptr` if there is none.
+  const Entry* Find(std::string_view key) const {
+    auto it = LowerBound(key);
+    if (it == entries.end() || filename(*it) != key) return nullptr;
+    return &*it;
+  }
+
   template <typename Sink>
-  friend void AbslStringify(Sink& sink, const Directory& entry) {
+  friend void AbslStringify(Sink& sink, const Directory& dir) {
     absl::Format(&sink, "Directory{\n");
-    for (const auto& entry : entry.entries) {
-      absl::Format(&sink, "%v\n", entry);
+    for (const auto& entry : dir.entries) {
+      absl::Format(
+          &sink,
+          "Entry{filename=%s, crc=%d, compressed_size=%d, "
+          "uncompressed_size=%d, local_header_offset=%d, estimated_size=%d}\n",
+          dir.filename(entry), entry.crc, entry.compressed_size,
+          entry.uncompressed_size, entry.local_header_offset,
+          entry.estimated_size);
     }
     absl::Format(&sink, "}");
   }
@@ -103,6 +132,7 @@ class ZipDirectoryCache : public internal::AsyncCache {
 
   Entry* DoAllocateEntry() final;
   size_t DoGetSizeofEntry() final;
+  std::string_view DoGetCacheTypeName() final { return "zip_directory"; }
 
   TransactionNode* DoAllocateTransactionNode(AsyncCache::Entry& entry) final {
     ABSL_UNREACHABLE();
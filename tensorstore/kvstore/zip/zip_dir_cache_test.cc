@@ -31,6 +31,7 @@
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/cache.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
 #include "tensorstore/kvstore/operations.h"
 #include "tensorstore/kvstore/spec.h"
@@ -40,6 +41,7 @@
 
 using ::tensorstore::Context;
 using ::tensorstore::InlineExecutor;
+using ::tensorstore::StorageGeneration;
 using ::tensorstore::internal::CachePool;
 using ::tensorstore::internal::GetCache;
 using ::tensorstore::internal_zip_kvstore::Directory;
@@ -88,9 +90,9 @@ TEST(ZipDirectoryKvsTest, Basic) {
 
   ASSERT_THAT(dir->entries, ::testing::SizeIs(3));
 
-  EXPECT_THAT(dir->entries[0].filename, "data/a.png");
-  EXPECT_THAT(dir->entries[1].filename, "data/bb.png");
-  EXPECT_THAT(dir->entries[2].filename, "data/c.png");
+  EXPECT_THAT(dir->filename(dir->entries[0]), "data/a.png");
+  EXPECT_THAT(dir->filename(dir->entries[1]), "data/bb.png");
+  EXPECT_THAT(dir->filename(dir->entries[2]), "data/c.png");
 }
 
 TEST(ZipDirectoryKvsTest, MissingEntry) {
@@ -106,9 +108,14 @@ TEST(ZipDirectoryKvsTest, MissingEntry) {
     return std::make_unique<ZipDirectoryCache>(memory.driver, InlineExecutor{});
   });
 
+  // A missing archive is treated as empty.
   auto entry = GetCacheEntry(cache, "data.zip");
-  auto status = entry->Read({absl::InfinitePast()}).status();
-  EXPECT_THAT(status, ::tensorstore::StatusIs(absl::StatusCode::kNotFound));
+  TENSORSTORE_ASSERT_OK(entry->Read({absl::InfinitePast()}).result());
+
+  ZipDirectoryCache::ReadLock<ZipDirectoryCache::ReadData> lock(*entry);
+  ASSERT_THAT(lock.data(), ::testing::NotNull());
+  EXPECT_THAT(lock.data()->entries, ::testing::IsEmpty());
+  EXPECT_TRUE(StorageGeneration::IsNoValue(lock.stamp().generation));
 }
 
 // clang-format off
@@ -191,8 +198,14 @@ TEST(ZipDirectoryKvsTest, MinimalZip) {
 
   ASSERT_THAT(dir->entries, ::testing::SizeIs(2));
 
-  EXPECT_THAT(dir->entries[0].filename, "test");
-  EXPECT_THAT(dir->entries[1].filename, "testdir/test2");
+  EXPECT_THAT(dir->filename(dir->entries[0]), "test");
+  EXPECT_THAT(dir->filename(dir->entries[1]), "testdir/test2");
+
+  auto* found = dir->Find("testdir/test2");
+  ASSERT_THAT(found, ::testing::NotNull());
+  EXPECT_EQ(5, found->uncompressed_size);
+  EXPECT_THAT(dir->Find("testdir"), ::testing::IsNull());
+  EXPECT_THAT(dir->Find("testdir/test3"), ::testing::IsNull());
 }
 
 }  // namespace
@@ -17,15 +17,20 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/internal/cache/async_cache.h"
 #include "tensorstore/internal/cache/cache.h"
@@ -35,9 +40,11 @@
 #include "tensorstore/internal/data_copy_concurrency_resource.h"
 #include "tensorstore/internal/estimate_heap_usage/estimate_heap_usage.h"
 #include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/internal/json_binding/enum.h"
 #include "tensorstore/internal/json_binding/json_binding.h"
 #include "tensorstore/internal/log/verbose_flag.h"
 #include "tensorstore/kvstore/byte_range.h"
+#include "tensorstore/kvstore/common_metrics.h"
 #include "tensorstore/kvstore/driver.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/key_range.h"
@@ -47,6 +54,7 @@
 #include "tensorstore/kvstore/registry.h"
 #include "tensorstore/kvstore/spec.h"
 #include "tensorstore/kvstore/supported_features.h"
+#include "tensorstore/kvstore/transaction.h"
 #include "tensorstore/kvstore/zip/zip_dir_cache.h"
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
@@ -66,6 +74,8 @@
 #include "tensorstore/serialization/std_vector.h"  // IWYU pragma: keep
 #include "tensorstore/util/garbage_collection/std_vector.h"  // IWYU pragma: keep
 
+using ::tensorstore::internal_kvstore::DeleteRangeEntry;
+using ::tensorstore::internal_kvstore::kReadModifyWrite;
 using ::tensorstore::internal_zip_kvstore::Directory;
 using ::tensorstore::internal_zip_kvstore::ZipDirectoryCache;
 using ::tensorstore::kvstore::ListEntry;
@@ -78,6 +88,8 @@ namespace jb = tensorstore::internal_json_binding;
 
 ABSL_CONST_INIT internal_log::VerboseFlag zip_logging("zip");
 
+auto zip_metrics = TENSORSTORE_KVSTORE_COMMON_METRICS(zip);
+
 // -----------------------------------------------------------------------------
 
 struct ZipKvStoreSpecData {
@@ -85,9 +97,11 @@ struct ZipKvStoreSpecData {
   Context::Resource<internal::CachePoolResource> cache_pool;
   Context::Resource<internal::DataCopyConcurrencyResource>
       data_copy_concurrency;
+  internal_zip::ZipCompression compression =
+      internal_zip::ZipCompression::kDeflate;
 
   constexpr static auto ApplyMembers = [](auto&& x, auto f) {
-    return f(x.base, x.cache_pool, x.data_copy_concurrency);
+    return f(x.base, x.cache_pool, x.data_copy_concurrency, x.compression);
   };
 
   constexpr static auto default_json_binder = jb::Object(
@@ -96,7 +110,15 @@ struct ZipKvStoreSpecData {
                  jb::Projection<&ZipKvStoreSpecData::cache_pool>()),
       jb::Member(
           internal::DataCopyConcurrencyResource::id,
-          jb::Projection<&ZipKvStoreSpecData::data_copy_concurrency>()) /**/
+          jb::Projection<&ZipKvStoreSpecData::data_copy_concurrency>()),
+      jb::Member(
+          "compression",
+          jb::Projection<&ZipKvStoreSpecData::compression>(jb::DefaultValue(
+              [](auto* v) { *v = internal_zip::ZipCompression::kDeflate; },
+              jb::Enum<internal_zip::ZipCompression, std::string_view>({
+                  {internal_zip::ZipCompression::kStore, "store"},
+                  {internal_zip::ZipCompression::kDeflate, "deflate"},
+              })))) /**/
   );
 };
 
@@ -118,11 +140,40 @@ class ZipKvStoreSpec
 };
 
 /// Defines the "zip" key value store.
+///
+/// Modifications are only supported within a transaction (non-transactional
+/// writes use an implicit transaction), and are committed by writing a new
+/// version of the archive to the base kvstore, as described by
+/// `ZipKvStore::TransactionNode`.  Since every member present in the archive
+/// shares its generation, transactions are atomic.
 class ZipKvStore
     : public internal_kvstore::RegisteredDriver<ZipKvStore, ZipKvStoreSpec> {
  public:
   Future<ReadResult> Read(Key key, ReadOptions options) override;
 
+  Future<TimestampedStorageGeneration> Write(Key key,
+                                             std::optional<Value> value,
+                                             WriteOptions options) override {
+    return internal_kvstore::WriteViaTransaction(
+        this, std::move(key), std::move(value), std::move(options));
+  }
+
+  absl::Status ReadModifyWrite(internal::OpenTransactionPtr& transaction,
+                               size_t& phase, Key key,
+                               ReadModifyWriteSource& source) override {
+    return internal_kvstore::AddReadModifyWrite<TransactionNode>(
+        this, transaction, phase, std::move(key), source);
+  }
+
+  absl::Status TransactionalDeleteRange(
+      const internal::OpenTransactionPtr& transaction,
+      KeyRange range) override {
+    return internal_kvstore::AddDeleteRange<TransactionNode>(this, transaction,
+                                                             std::move(range));
+  }
+
+  class TransactionNode;
+
   std::string DescribeKey(std::string_view key) override {
     return tensorstore::StrCat(QuoteString(key), " in ",
                                base_.driver->DescribeKey(base_.path));
@@ -189,12 +240,17 @@ struct ReadState : public internal::AtomicReferenceCount<ReadState> {
   kvstore::ReadOptions options_;
 
   // The cache read has completed, so the zip directory entries are available.
-  void OnDirectoryReady(Promise<kvstore::ReadResult> promise) {
+  //
+  // `batch` is used for the member read; members read with the same batch may
+  // then be fetched together by the base kvstore, and are inflated in parallel
+  // on the executor.
+  void OnDirectoryReady(Promise<kvstore::ReadResult> promise, Batch batch) {
     TimestampedStorageGeneration stamp;
 
     // Set options for the entry request.
     kvstore::ReadOptions options;
     options.staleness_bound = options_.staleness_bound;
+    options.batch = std::move(batch);
     options.byte_range = OptionalByteRangeRequest{};
     size_t seek_pos = 0;
 
@@ -208,13 +264,10 @@ struct ReadState : public internal::AtomicReferenceCount<ReadState> {
       const ZipDirectoryCache::ReadData& dir = *lock.data();
       ABSL_LOG_IF(INFO, zip_logging) << dir;
 
-      auto it = std::lower_bound(
-          dir.entries.begin(), dir.entries.end(), key_,
-          [](const auto& e, const std::string& k) { return e.filename < k; });
-
-      if (it == dir.entries.end() || it->filename != key_) {
+      const Directory::Entry* it = dir.Find(key_);
+      if (it == nullptr) {
         // Missing value.
-        promise.SetResult(kvstore::ReadResult::Missing(std::move(stamp)));
+        promise.SetResult(kvstore::ReadResult::Missing(stamp.time));
         return;
       }
 
@@ -304,21 +357,36 @@ struct ReadState : public internal::AtomicReferenceCount<ReadState> {
 };
 
 Future<kvstore::ReadResult> ZipKvStore::Read(Key key, ReadOptions options) {
+  auto directory_future =
+      cache_entry_->Read({options.staleness_bound, options.batch});
+
+  // The member read may join the caller's batch only if the directory is
+  // already available; otherwise the batch would be retained until the
+  // directory read, which may itself be part of that batch, completes.
+  Batch batch{no_batch};
+  if (options.batch && directory_future.ready()) {
+    batch = std::move(options.batch);
+  }
+  options.batch = no_batch;
+
   auto state = internal::MakeIntrusivePtr<ReadState>();
   state->owner_ = internal::IntrusivePtr<ZipKvStore>(this);
   state->key_ = std::move(key);
-  state->options_ = options;
-
-  return PromiseFuturePair<kvstore::ReadResult>::LinkValue(
-             WithExecutor(
-                 executor(),
-                 [state = std::move(state)](Promise<ReadResult> promise,
-                                            ReadyFuture<const void>) {
-                   if (!promise.result_needed()) return;
-                   state->OnDirectoryReady(std::move(promise));
-                 }),
-             cache_entry_->Read({options.staleness_bound}))
-      .future;
+  state->options_ = std::move(options);
+
+  return internal_kvstore::RecordReadMetrics(
+      zip_metrics,
+      PromiseFuturePair<kvstore::ReadResult>::LinkValue(
+          WithExecutor(executor(),
+                       [state = std::move(state), batch = std::move(batch)](
+                           Promise<ReadResult> promise,
+                           ReadyFuture<const void>) mutable {
+                         if (!promise.result_needed()) return;
+                         state->OnDirectoryReady(std::move(promise),
+                                                 std::move(batch));
+                       }),
+          std::move(directory_future))
+          .future);
 }
 
 // Implements ZipKvStore::List
@@ -360,18 +428,18 @@ struct ListState : public internal::AtomicReferenceCount<ListState> {
                    .shared_data();
     assert(dir);
 
-    auto it = std::lower_bound(
-        dir->entries.begin(), dir->entries.end(), options_.range.inclusive_min,
-        [](const auto& e, const std::string& k) { return e.filename < k; });
-    for (; it != dir->entries.end(); ++it) {
+    for (auto it = dir->LowerBound(options_.range.inclusive_min);
+         it != dir->entries.end(); ++it) {
+      std::string_view filename = dir->filename(*it);
       if (KeyRange::CompareKeyAndExclusiveMax(
-              it->filename, options_.range.exclusive_max) >= 0) {
+              filename, options_.range.exclusive_max) >= 0) {
         break;
       }
-      if (it->filename.size() >= options_.strip_prefix_length) {
+      if (filename.size() >= options_.strip_prefix_length) {
         execution::set_value(
             receiver_,
-            ListEntry{it->filename.substr(options_.strip_prefix_length),
+            ListEntry{std::string(
+                          filename.substr(options_.strip_prefix_length)),
                       ListEntry::checked_size(it->uncompressed_size)});
       }
     }
@@ -392,6 +460,339 @@ void ZipKvStore::ListImpl(ListOptions options, ListReceiver receiver) {
             cache_entry_->Read({state_ptr->options_.staleness_bound}));
 }
 
+// Implements ZipKvStore writes.
+using BufferedReadModifyWriteEntry =
+    internal_kvstore::AtomicMultiPhaseMutation::BufferedReadModifyWriteEntry;
+
+/// Commits a transaction by writing a new version of the archive.
+///
+/// The existing archive is read in full, and the conditions specified in the
+/// transaction are validated against its generation, which is also the
+/// generation of every member present in it.  New members are encoded
+/// sequentially after the existing members, followed by a new central
+/// directory.  If the base kvstore supports
+/// `kvstore::SupportedFeatures::kAppendInPlace`, the existing data up to the
+/// old central directory is retained as a prefix, such that only the new
+/// members and directory are written.  Members which are replaced or deleted
+/// are then left as dead space, which is reclaimed by rewriting the archive
+/// (copying the retained members without recompressing them) once it would
+/// exceed `kMaxDeadFraction` of the archive size.
+class ZipKvStore::TransactionNode
+    : public internal_kvstore::AtomicTransactionNode {
+  using Base = internal_kvstore::AtomicTransactionNode;
+
+ public:
+  using Base::Base;
+
+  /// Maximum fraction of an archive updated by appending that may consist of
+  /// dead space, beyond which the archive is rewritten instead.
+  constexpr static double kMaxDeadFraction = 0.5;
+
+  void AllEntriesDone(
+      internal_kvstore::SinglePhaseMutation& single_phase_mutation) override {
+    if (single_phase_mutation.remaining_entries_.HasError()) {
+      internal_kvstore::WritebackError(single_phase_mutation);
+      MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+      return;
+    }
+    kvstore::ReadOptions options;
+    options.staleness_bound = absl::Now();
+    auto future = kvstore::Read(zip_driver().base_, {}, std::move(options));
+    future.Force();
+    future.ExecuteWhenReady([this](ReadyFuture<kvstore::ReadResult> ready) {
+      zip_driver().executor()([this, ready = std::move(ready)]() mutable {
+        OnArchiveRead(std::move(ready));
+      });
+    });
+  }
+
+ private:
+  struct ExistingArchive {
+    internal_zip::ZipEOCD eocd{};
+
+    // Central directory entries, ordered by local header offset.
+    std::vector<internal_zip::ZipEntry> members;
+
+    // Member filenames, sorted.
+    std::vector<std::string_view> filenames;
+  };
+
+  struct EncodedArchive {
+    absl::Cord value;
+    uint64_t unchanged_prefix_length = 0;
+  };
+
+  ZipKvStore& zip_driver() { return static_cast<ZipKvStore&>(*driver()); }
+
+  void OnArchiveRead(ReadyFuture<kvstore::ReadResult> ready) {
+    auto& single_phase_mutation = GetCommittingPhase();
+    auto& r = ready.result();
+    if (!r.ok()) {
+      Fail(r.status());
+      return;
+    }
+    auto& existing = *r;
+    ExistingArchive archive;
+    if (auto status = ReadExistingArchive(existing, archive); !status.ok()) {
+      Fail(internal::ConvertInvalidArgumentToFailedPrecondition(status));
+      return;
+    }
+    if (!ValidateEntryConditions(single_phase_mutation,
+                                 existing.stamp.generation, archive)) {
+      RetryAtomicWriteback(existing.stamp.time);
+      return;
+    }
+
+    const bool append_in_place =
+        (zip_driver().base_.driver->GetSupportedFeatures(
+             KeyRange::Singleton(zip_driver().base_.path)) &
+         kvstore::SupportedFeatures::kAppendInPlace) !=
+        kvstore::SupportedFeatures::kNone;
+    auto encoded = EncodeArchive(single_phase_mutation, existing, archive,
+                                 append_in_place, existing.stamp.time);
+    if (!encoded.ok()) {
+      Fail(internal::ConvertInvalidArgumentToFailedPrecondition(
+          encoded.status()));
+      return;
+    }
+    if (!*encoded) {
+      // No modifications.
+      CommitSuccessful(existing.stamp);
+      return;
+    }
+
+    kvstore::WriteOptions options;
+    options.generation_conditions.if_equal = existing.stamp.generation;
+    options.unchanged_prefix_length = (*encoded)->unchanged_prefix_length;
+    auto future = kvstore::Write(zip_driver().base_, {},
+                                 std::move((*encoded)->value), options);
+    future.Force();
+    future.ExecuteWhenReady(
+        [this](ReadyFuture<TimestampedStorageGeneration> ready) {
+          auto& r = ready.result();
+          if (!r.ok()) {
+            Fail(r.status());
+            return;
+          }
+          if (StorageGeneration::IsUnknown(r->generation)) {
+            // The archive was modified concurrently.
+            RetryAtomicWriteback(r->time);
+            return;
+          }
+          CommitSuccessful(*r);
+        });
+  }
+
+  /// Reads the central directory of `existing`, which may be missing.
+  static absl::Status ReadExistingArchive(const kvstore::ReadResult& existing,
+                                          ExistingArchive& archive) {
+    if (!existing.has_value()) return absl::OkStatus();
+    auto& eocd = archive.eocd;
+    riegeli::CordReader reader(&existing.value);
+    auto read_eocd_variant = TryReadFullEOCD(reader, eocd, 0);
+    if (auto* status = std::get_if<absl::Status>(&read_eocd_variant)) {
+      TENSORSTORE_RETURN_IF_ERROR(*status);
+    } else {
+      return absl::InvalidArgumentError("Failed to read ZIP EOCD");
+    }
+    if (static_cast<uint64_t>(eocd.cd_offset) > existing.value.size() ||
+        !reader.Seek(eocd.cd_offset)) {
+      return absl::InvalidArgumentError("Failed to read ZIP directory");
+    }
+    archive.members.reserve(eocd.num_entries);
+    for (size_t i = 0; i < eocd.num_entries; ++i) {
+      internal_zip::ZipEntry entry{};
+      TENSORSTORE_RETURN_IF_ERROR(ReadCentralDirectoryEntry(reader, entry));
+      if (entry.local_header_offset > static_cast<uint64_t>(eocd.cd_offset)) {
+        return absl::InvalidArgumentError(
+            "ZIP entry local header offset is out of range");
+      }
+      archive.members.push_back(std::move(entry));
+    }
+    std::stable_sort(archive.members.begin(), archive.members.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.local_header_offset < b.local_header_offset;
+                     });
+    archive.filenames.reserve(archive.members.size());
+    for (const auto& entry : archive.members) {
+      archive.filenames.push_back(entry.filename);
+    }
+    std::sort(archive.filenames.begin(), archive.filenames.end());
+    return absl::OkStatus();
+  }
+
+  /// Validates that the existing `archive`, with the specified `generation`,
+  /// matches the generation constraints specified in the transaction.
+  ///
+  /// A member is conditioned either on the generation of the archive, or on
+  /// being absent, in which case the archive generation is irrelevant.
+  static bool ValidateEntryConditions(
+      internal_kvstore::SinglePhaseMutation& single_phase_mutation,
+      const StorageGeneration& generation, const ExistingArchive& archive) {
+    auto validate = [&](internal_kvstore::MutationEntry& entry) {
+      auto& stamp = static_cast<BufferedReadModifyWriteEntry&>(entry).stamp();
+      auto if_equal = StorageGeneration::Clean(stamp.generation);
+      if (StorageGeneration::IsNoValue(if_equal)) {
+        return !std::binary_search(archive.filenames.begin(),
+                                   archive.filenames.end(),
+                                   std::string_view(entry.key_));
+      }
+      return StorageGeneration::EqualOrUnspecified(generation, if_equal);
+    };
+    for (auto& entry : single_phase_mutation.entries_) {
+      if (entry.entry_type() == kReadModifyWrite) {
+        if (!validate(entry)) return false;
+        continue;
+      }
+      // `DeleteRangeEntry` imposes no constraints itself, but the superseded
+      // `ReadModifyWriteEntry` nodes may have constraints.
+      for (auto& deleted_entry :
+           static_cast<DeleteRangeEntry&>(entry).superseded_) {
+        if (!validate(deleted_entry)) return false;
+      }
+    }
+    return true;
+  }
+
+  /// Encodes the archive resulting from applying `single_phase_mutation` to
+  /// `existing`.
+  ///
+  /// \returns `std::nullopt` if there are no modifications.
+  Result<std::optional<EncodedArchive>> EncodeArchive(
+      internal_kvstore::SinglePhaseMutation& single_phase_mutation,
+      const kvstore::ReadResult& existing, ExistingArchive& archive,
+      bool append_in_place, absl::Time mtime) {
+    // Ranges of keys which are deleted or overwritten, in order, and the
+    // entries which specify new values.
+    std::vector<KeyRange> removed;
+    std::vector<BufferedReadModifyWriteEntry*> added;
+    for (auto& entry : single_phase_mutation.entries_) {
+      if (entry.entry_type() != kReadModifyWrite) {
+        auto& dr_entry = static_cast<DeleteRangeEntry&>(entry);
+        removed.push_back(KeyRange(dr_entry.key_, dr_entry.exclusive_max_));
+        continue;
+      }
+      auto& rmw_entry = static_cast<BufferedReadModifyWriteEntry&>(entry);
+      if (!StorageGeneration::IsDirty(rmw_entry.stamp().generation)) continue;
+      removed.push_back(KeyRange::Singleton(rmw_entry.key_));
+      if (rmw_entry.value_state_ == kvstore::ReadResult::kValue) {
+        added.push_back(&rmw_entry);
+      }
+    }
+    if (removed.empty()) return std::nullopt;
+    auto is_removed = [&](std::string_view key) {
+      auto it = std::upper_bound(
+          removed.begin(), removed.end(), key,
+          [](std::string_view k, const KeyRange& r) {
+            return k < r.inclusive_min;
+          });
+      return it != removed.begin() && Contains(*std::prev(it), key);
+    };
+
+    auto& eocd = archive.eocd;
+    auto& members = archive.members;
+    const uint64_t leading_size =
+        members.empty() ? 0 : members.front().local_header_offset;
+
+    // Determine the retained members, along with the extent of their data,
+    // which ends at the next local header.
+    std::vector<std::pair<internal_zip::ZipEntry, uint64_t>> kept;
+    uint64_t live_size = leading_size;
+    for (size_t i = 0; i < members.size(); ++i) {
+      if (is_removed(members[i].filename)) continue;
+      uint64_t end = (i + 1 < members.size())
+                         ? members[i + 1].local_header_offset
+                         : static_cast<uint64_t>(eocd.cd_offset);
+      live_size += end - members[i].local_header_offset;
+      kept.emplace_back(std::move(members[i]), end);
+    }
+
+    // Encode the new members, with offsets relative to the start of
+    // `appended`.
+    absl::Cord appended;
+    std::vector<internal_zip::ZipEntry> directory;
+    {
+      riegeli::CordWriter writer(&appended);
+      for (auto* rmw_entry : added) {
+        internal_zip::ZipEntry entry{};
+        entry.filename = rmw_entry->key_;
+        entry.compression_method = zip_driver().spec_data_.compression;
+        entry.mtime = mtime;
+        TENSORSTORE_RETURN_IF_ERROR(
+            WriteEntry(writer, rmw_entry->value_, entry));
+        directory.push_back(std::move(entry));
+      }
+      if (!writer.Close()) return writer.status();
+    }
+
+    EncodedArchive encoded;
+    const uint64_t existing_size = eocd.cd_offset;
+    if (append_in_place && existing.has_value() &&
+        existing_size - live_size <=
+            (existing_size + appended.size()) * kMaxDeadFraction) {
+      encoded.value = existing.value.Subcord(0, existing_size);
+      encoded.unchanged_prefix_length = existing_size;
+      for (auto& [entry, end] : kept) {
+        directory.push_back(std::move(entry));
+      }
+    } else {
+      encoded.value = existing.value.Subcord(0, leading_size);
+      for (auto& [entry, end] : kept) {
+        const uint64_t start = entry.local_header_offset;
+        entry.local_header_offset = encoded.value.size();
+        encoded.value.Append(existing.value.Subcord(start, end - start));
+        directory.push_back(std::move(entry));
+      }
+    }
+    const uint64_t appended_offset = encoded.value.size();
+    for (size_t i = 0; i < added.size(); ++i) {
+      directory[i].local_header_offset += appended_offset;
+    }
+    encoded.value.Append(std::move(appended));
+
+    // Write the central directory.
+    riegeli::CordWriter writer(
+        &encoded.value, riegeli::CordWriterBase::Options().set_append(true));
+    internal_zip::ZipEOCD new_eocd{};
+    new_eocd.num_entries = directory.size();
+    new_eocd.cd_offset = writer.pos();
+    new_eocd.comment = std::move(eocd.comment);
+    for (const auto& entry : directory) {
+      TENSORSTORE_RETURN_IF_ERROR(WriteCentralDirectoryEntry(writer, entry));
+    }
+    new_eocd.cd_size = writer.pos() - new_eocd.cd_offset;
+    TENSORSTORE_RETURN_IF_ERROR(WriteEOCD(writer, new_eocd));
+    if (!writer.Close()) return writer.status();
+    return encoded;
+  }
+
+  /// Completes the commit once the archive with the specified `stamp`, which
+  /// reflects all of the modifications, has been written.
+  void CommitSuccessful(const TimestampedStorageGeneration& stamp) {
+    auto& single_phase_mutation = GetCommittingPhase();
+    for (auto& entry : single_phase_mutation.entries_) {
+      if (entry.entry_type() != kReadModifyWrite) continue;
+      auto& rmw_entry = static_cast<BufferedReadModifyWriteEntry&>(entry);
+      if (rmw_entry.value_state_ == kvstore::ReadResult::kMissing) {
+        rmw_entry.stamp() = {StorageGeneration::NoValue(), stamp.time};
+      } else {
+        rmw_entry.stamp() = stamp;
+      }
+    }
+    AtomicCommitWritebackSuccess();
+    MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+  }
+
+  // Fails the commit operation.
+  void Fail(const absl::Status& error) {
+    ABSL_LOG_IF(INFO, zip_logging) << "Commit failed: " << error;
+    SetError(error);
+    auto& single_phase_mutation = GetCommittingPhase();
+    internal_kvstore::WritebackError(single_phase_mutation);
+    MultiPhaseMutation::AllEntriesDone(single_phase_mutation);
+  }
+};
+
 }  // namespace
 }  // namespace tensorstore
 
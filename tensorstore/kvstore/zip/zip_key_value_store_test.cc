@@ -22,10 +22,12 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/match.h"
 #include "absl/synchronization/notification.h"
 #include <nlohmann/json.hpp>
 #include "riegeli/bytes/fd_reader.h"
 #include "riegeli/bytes/read_all.h"
+#include "tensorstore/batch.h"
 #include "tensorstore/context.h"
 #include "tensorstore/kvstore/generation.h"
 #include "tensorstore/kvstore/kvstore.h"
@@ -33,6 +35,7 @@
 #include "tensorstore/kvstore/read_result.h"
 #include "tensorstore/kvstore/test_matchers.h"
 #include "tensorstore/kvstore/test_util.h"
+#include "tensorstore/transaction.h"
 #include "tensorstore/util/execution/execution.h"
 #include "tensorstore/util/execution/sender_testutil.h"
 #include "tensorstore/util/status.h"
@@ -182,6 +185,115 @@ TEST_F(ZipKeyValueStoreTest, ReadOps) {
       store, "key", absl::Cord("abcdefghijklmnop"), "missing_key");
 }
 
+TEST_F(ZipKeyValueStoreTest, BatchRead) {
+  PrepareMemoryKvstore(GetTestZipFileData());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base", {{"driver", "memory"}, {"path", "data.zip"}}}},
+                    context_)
+          .result());
+
+  const std::vector<std::string> keys{"data/a.png", "data/bb.png",
+                                      "data/c.png", "data/zz.png"};
+
+  // The first batch also reads the directory; the second finds it cached.
+  for (int i = 0; i < 2; ++i) {
+    std::vector<tensorstore::Future<kvstore::ReadResult>> futures;
+    {
+      auto batch = tensorstore::Batch::New();
+      for (const auto& key : keys) {
+        kvstore::ReadOptions options;
+        options.batch = batch;
+        futures.push_back(kvstore::Read(store, key, std::move(options)));
+      }
+    }
+    for (size_t j = 0; j < keys.size(); ++j) {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto expected,
+                                       kvstore::Read(store, keys[j]).result());
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto read_result, futures[j].result());
+      EXPECT_EQ(expected.state, read_result.state) << keys[j];
+      EXPECT_EQ(expected.value, read_result.value) << keys[j];
+    }
+  }
+}
+
+TEST_F(ZipKeyValueStoreTest, ReadWriteOps) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base", {{"driver", "memory"}, {"path", "data.zip"}}}},
+                    context_)
+          .result());
+  ::tensorstore::internal::TestKeyValueReadWriteOps(store);
+}
+
+TEST_F(ZipKeyValueStoreTest, TransactionalWrite) {
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto memory,
+      kvstore::Open({{"driver", "memory"}}, context_).result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base", {{"driver", "memory"}, {"path", "data.zip"}}},
+                     {"compression", "store"}},
+                    context_)
+          .result());
+
+  // A missing archive is empty.
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResultNotFound());
+
+  auto transaction = tensorstore::Transaction(tensorstore::atomic_isolated);
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto txn_store, store | transaction);
+  auto write_a = kvstore::Write(txn_store, "a", absl::Cord("stored value"));
+  auto write_b = kvstore::Write(txn_store, "dir/b", absl::Cord("value b"));
+  TENSORSTORE_ASSERT_OK(transaction.CommitAsync());
+  TENSORSTORE_ASSERT_OK(write_a);
+  TENSORSTORE_ASSERT_OK(write_b);
+
+  EXPECT_THAT(kvstore::Read(store, "a").result(),
+              MatchesKvsReadResult(absl::Cord("stored value")));
+  EXPECT_THAT(kvstore::Read(store, "dir/b").result(),
+              MatchesKvsReadResult(absl::Cord("value b")));
+
+  // Members are stored uncompressed.
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto archive,
+                                   kvstore::Read(memory, "data.zip").result());
+  EXPECT_TRUE(absl::StrContains(archive.value.Flatten(), "stored value"));
+}
+
+TEST_F(ZipKeyValueStoreTest, WriteExistingArchive) {
+  PrepareMemoryKvstore(GetTestZipFileData());
+
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto store,
+      kvstore::Open({{"driver", "zip"},
+                     {"base", {{"driver", "memory"}, {"path", "data.zip"}}}},
+                    context_)
+          .result());
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto original, kvstore::Read(store, "data/bb.png").result());
+
+  const absl::Cord value(std::string(10000, 'x'));
+  TENSORSTORE_ASSERT_OK(kvstore::Write(store, "data/new", value));
+  TENSORSTORE_ASSERT_OK(kvstore::Delete(store, "data/a.png"));
+
+  // Existing members are retained.
+  EXPECT_THAT(kvstore::Read(store, "data/bb.png").result(),
+              MatchesKvsReadResult(original.value));
+  EXPECT_THAT(kvstore::Read(store, "data/new").result(),
+              MatchesKvsReadResult(value));
+  EXPECT_THAT(kvstore::Read(store, "data/a.png").result(),
+              MatchesKvsReadResultNotFound());
+  EXPECT_THAT(tensorstore::internal::GetMap(store),
+              ::testing::Optional(::testing::UnorderedElementsAre(
+                  ::testing::Pair("data/bb.png", original.value),
+                  ::testing::Pair("data/c.png", ::testing::_),
+                  ::testing::Pair("data/new", value))));
+}
+
 TEST_F(ZipKeyValueStoreTest, InvalidSpec) {
   auto context = tensorstore::Context::Default();
 
@@ -17,8 +17,11 @@
 
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
 #include <nlohmann/json.hpp>
+#include "tensorstore/batch.h"
 #include "tensorstore/driver/driver.h"
 #include "tensorstore/index.h"
 #include "tensorstore/open_mode.h"
@@ -29,6 +32,7 @@
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/option.h"
 #include "tensorstore/util/result.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 
@@ -136,6 +140,63 @@ Open(J json_spec, TransactionalOpenOptions&& options) {
                                                 std::move(options));
 }
 
+/// Opens multiple TensorStores concurrently.
+///
+/// Equivalent to calling `Open` for each of the `specs` with the same
+/// options, except that if no `Batch` is specified, all of the opens share a
+/// single new batch that is submitted once all of the opens have been
+/// started.  This allows the metadata reads of many small arrays stored in
+/// the same key-value store to be issued together, and coalesced by the
+/// key-value store where supported, rather than each requiring a separate
+/// round trip.  Metadata is decoded concurrently using the
+/// `Context.data_copy_concurrency` executor.
+///
+/// Example usage::
+///
+///     std::vector<tensorstore::Spec> specs = ...;
+///     auto futures = tensorstore::OpenAll(specs, context,
+///                                         tensorstore::OpenMode::open);
+///     for (auto& future : futures) {
+///       TENSORSTORE_ASSIGN_OR_RETURN(auto store, future.result());
+///       // ...
+///     }
+///
+/// \param specs The specs to open.
+/// \param option Any option compatible with `TransactionalOpenOptions`.
+/// \returns The futures for each of the `specs`, in the same order.
+/// \relates TensorStore
+template <typename Element = void, DimensionIndex Rank = dynamic_rank,
+          ReadWriteMode Mode = ReadWriteMode::dynamic>
+std::vector<Future<TensorStore<Element, Rank, Mode>>> OpenAll(
+    span<const Spec> specs, TransactionalOpenOptions&& options) {
+  Batch batch = options.batch ? options.batch : Batch::New();
+  options.batch = no_batch;
+  std::vector<Future<TensorStore<Element, Rank, Mode>>> futures;
+  futures.reserve(specs.size());
+  for (const auto& spec : specs) {
+    TransactionalOpenOptions spec_options = options;
+    spec_options.batch = batch;
+    futures.push_back(
+        tensorstore::Open<Element, Rank, Mode>(spec, std::move(spec_options)));
+  }
+  return futures;
+}
+template <typename Element = void, DimensionIndex Rank = dynamic_rank,
+          ReadWriteMode Mode = ReadWriteMode::dynamic, typename... Option>
+std::enable_if_t<
+    IsCompatibleOptionSequence<TransactionalOpenOptions, Option...>,
+    std::vector<Future<TensorStore<Element, Rank, Mode>>>>
+OpenAll(span<const Spec> specs, Option&&... option) {
+  TransactionalOpenOptions options;
+  if (absl::Status status;
+      !((status = options.Set(std::forward<Option>(option))).ok() && ...)) {
+    return std::vector<Future<TensorStore<Element, Rank, Mode>>>(
+        specs.size(), MakeReadyFuture<TensorStore<Element, Rank, Mode>>(
+                          std::move(status)));
+  }
+  return tensorstore::OpenAll<Element, Rank, Mode>(specs, std::move(options));
+}
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_OPEN_H_
@@ -15,6 +15,8 @@
 #ifndef TENSORSTORE_READ_WRITE_OPTIONS_H_
 #define TENSORSTORE_READ_WRITE_OPTIONS_H_
 
+#include <stddef.h>
+
 #include <type_traits>
 #include <utility>
 
@@ -22,6 +24,7 @@
 #include "tensorstore/batch.h"
 #include "tensorstore/contiguous_layout.h"
 #include "tensorstore/index_space/alignment.h"
+#include "tensorstore/io_stats.h"
 #include "tensorstore/progress.h"
 
 namespace tensorstore {
@@ -48,6 +51,8 @@ struct ReadOptions {
 
   void Set(Batch value) { this->batch = std::move(value); }
 
+  void Set(IoStats value) { this->io_stats = std::move(value); }
+
   /// Constrains how the source TensorStore may be aligned to the target array.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
 
@@ -56,6 +61,9 @@ struct ReadOptions {
 
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Optional collector of the storage cost of the read.
+  IoStats io_stats;
 };
 
 template <>
@@ -70,6 +78,9 @@ constexpr inline bool ReadOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadOptions::IsOption<IoStats> = true;
+
 /// Options for `tensorstore::Read` into new array.
 ///
 /// \relates Read[TensorStore]
@@ -92,6 +103,8 @@ struct ReadIntoNewArrayOptions {
 
   void Set(Batch value) { this->batch = std::move(value); }
 
+  void Set(IoStats value) { this->io_stats = std::move(value); }
+
   /// Specifies the layout order of the newly-allocated array.  Defaults to
   /// `c_order`.
   ContiguousLayoutOrder layout_order = c_order;
@@ -101,6 +114,9 @@ struct ReadIntoNewArrayOptions {
 
   /// Optional batch.
   Batch batch{no_batch};
+
+  /// Optional collector of the storage cost of the read.
+  IoStats io_stats;
 };
 
 template <>
@@ -117,6 +133,87 @@ constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool ReadIntoNewArrayOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool ReadIntoNewArrayOptions::IsOption<IoStats> = true;
+
+/// Options for `tensorstore::Prefetch`.
+///
+/// \relates TensorStore
+struct PrefetchOptions {
+  template <typename T>
+  constexpr static inline bool IsOption = false;
+
+  /// Combines any number of supported options.
+  template <typename... T, typename = std::enable_if_t<
+                               (IsOption<absl::remove_cvref_t<T>> && ...)>>
+  PrefetchOptions(T&&... option) {
+    (Set(std::forward<T>(option)), ...);
+  }
+
+  void Set(Batch value) { this->batch = std::move(value); }
+
+  /// Optional batch.
+  Batch batch{no_batch};
+};
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch> = true;
+
+template <>
+constexpr inline bool PrefetchOptions::IsOption<Batch::View> = true;
+
+/// Options for `tensorstore::Pin`.
+///
+/// \relates TensorStore
+struct PinOptions {
+  template <typename T>
+  constexpr static inline bool IsOption = false;
+
+  /// Combines any number of supported options.
+  template <typename... T, typename = std::enable_if_t<
+                               (IsOption<absl::remove_cvref_t<T>> && ...)>>
+  PinOptions(T&&... option) {
+    (Set(std::forward<T>(option)), ...);
+  }
+
+  void Set(Batch value) { this->batch = std::move(value); }
+
+  /// Optional batch.
+  Batch batch{no_batch};
+};
+
+template <>
+constexpr inline bool PinOptions::IsOption<Batch> = true;
+
+template <>
+constexpr inline bool PinOptions::IsOption<Batch::View> = true;
+
+/// Options for `tensorstore::ReadChunks`.
+///
+/// \relates TensorStore
+struct ReadChunksOptions {
+  template <typename T>
+  constexpr static inline bool IsOption = false;
+
+  /// Combines any number of supported options.
+  template <typename... T, typename = std::enable_if_t<
+                               (IsOption<absl::remove_cvref_t<T>> && ...)>>
+  ReadChunksOptions(T&&... option) {
+    (Set(std::forward<T>(option)), ...);
+  }
+
+  void Set(Batch value) { this->batch = std::move(value); }
+
+  /// Optional batch.
+  Batch batch{no_batch};
+};
+
+template <>
+constexpr inline bool ReadChunksOptions::IsOption<Batch> = true;
+
+template <>
+constexpr inline bool ReadChunksOptions::IsOption<Batch::View> = true;
+
 /// Specifies restrictions on how references to the source array/source
 /// TensorStore may be used by write operations.
 enum SourceDataReferenceRestriction {
@@ -137,6 +234,17 @@ enum SourceDataReferenceRestriction {
   /// write is committed.  The source data must not be modified until all
   /// references are released.
   can_reference_source_data_indefinitely = 2,
+
+  /// Ownership of the source data is transferred to the write operation, which
+  /// may retain and modify it in place.  The caller must neither access nor
+  /// retain any other reference to the source data once the write is issued.
+  /// For large, C-contiguous writes that are aligned to chunk boundaries, this
+  /// allows the chunk cache to adopt sub-regions of the source buffer as its
+  /// chunk data without any copy, avoiding the staging copy that otherwise
+  /// doubles peak memory usage.  Source data in which multiple positions
+  /// refer to the same element, such as a broadcast array, is never modified
+  /// in place.
+  can_take_ownership_of_source_data = 3,
 };
 
 /// Options for `tensorstore::Write`.
@@ -163,6 +271,8 @@ struct WriteOptions {
     this->source_data_reference_restriction = value;
   }
 
+  void Set(IoStats value) { this->io_stats = std::move(value); }
+
   /// Constrains how the source array may be aligned to the target TensorStore.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
 
@@ -173,6 +283,10 @@ struct WriteOptions {
   /// opposed to copied).
   SourceDataReferenceRestriction source_data_reference_restriction =
       cannot_reference_source_data;
+
+  /// Optional collector of the storage cost of the write, including the
+  /// writeback of the modified chunks.
+  IoStats io_stats;
 };
 
 template <>
@@ -185,6 +299,26 @@ template <>
 constexpr inline bool WriteOptions::IsOption<SourceDataReferenceRestriction> =
     true;
 
+template <>
+constexpr inline bool WriteOptions::IsOption<IoStats> = true;
+
+/// Bounds the memory used by `tensorstore::Copy`.
+///
+/// When a non-zero limit is specified, the copy is performed one target write
+/// chunk (e.g. one shard of a sharded array) at a time, in the order of the
+/// target chunk grid, such that each target chunk is written exactly once.  A
+/// target chunk is started only while the total size of the decoded source and
+/// target data for the chunks in flight remains within `total_bytes_limit`; a
+/// single chunk that exceeds the limit is still copied, though never
+/// concurrently with any other chunk.
+///
+/// \relates Copy[TensorStore, TensorStore]
+struct CopyMemoryLimit {
+  /// Maximum number of bytes of decoded data held by the chunks in flight.  A
+  /// value of `0` indicates no limit.
+  size_t total_bytes_limit = 0;
+};
+
 /// Options for `tensorstore::Copy`.
 ///
 /// \relates Copy[TensorStore, TensorStore]
@@ -211,6 +345,8 @@ struct CopyOptions {
 
   void Set(Batch value) { this->batch = std::move(value); }
 
+  void Set(CopyMemoryLimit value) { this->memory_limit = value; }
+
   /// Constrains how the source TensorStore may be aligned to the target
   /// TensorStore.
   DomainAlignmentOptions alignment_options = DomainAlignmentOptions::all;
@@ -224,7 +360,13 @@ struct CopyOptions {
       cannot_reference_source_data;
 
   /// Optional batch for reading.
+  ///
+  /// Ignored when `memory_limit` is specified, since the source is then read
+  /// incrementally.
   Batch batch{no_batch};
+
+  /// Optional bound on the memory used by the copy.
+  CopyMemoryLimit memory_limit;
 };
 
 template <>
@@ -243,6 +385,9 @@ constexpr inline bool CopyOptions::IsOption<Batch> = true;
 template <>
 constexpr inline bool CopyOptions::IsOption<Batch::View> = true;
 
+template <>
+constexpr inline bool CopyOptions::IsOption<CopyMemoryLimit> = true;
+
 }  // namespace tensorstore
 
 #endif  // TENSORSTORE_READ_WRITE_OPTIONS_H_
@@ -0,0 +1,96 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/reduce.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "tensorstore/index.h"
+
+namespace tensorstore {
+
+void QuantileSketch::Add(double value) {
+  if (std::isnan(value)) return;
+  ++count_;
+  if (levels_.empty()) levels_.emplace_back();
+  levels_[0].push_back(value);
+  if (levels_[0].size() >= capacity_) Compact(0);
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  count_ += other.count_;
+  if (levels_.size() < other.levels_.size()) {
+    levels_.resize(other.levels_.size());
+  }
+  for (size_t level = 0; level < other.levels_.size(); ++level) {
+    levels_[level].insert(levels_[level].end(), other.levels_[level].begin(),
+                          other.levels_[level].end());
+  }
+  for (size_t level = 0; level < levels_.size(); ++level) {
+    if (levels_[level].size() >= capacity_) Compact(level);
+  }
+}
+
+void QuantileSketch::Compact(size_t level) {
+  auto& values = levels_[level];
+  std::sort(values.begin(), values.end());
+  // Promote alternately the even and odd positions, so that the error of
+  // successive compactions cancels on average.
+  std::vector<double> promoted;
+  promoted.reserve(values.size() / 2 + 1);
+  const size_t num_pairs = values.size() / 2;
+  for (size_t i = 0; i < num_pairs; ++i) {
+    promoted.push_back(values[2 * i + (compaction_parity_ ? 1 : 0)]);
+  }
+  compaction_parity_ = !compaction_parity_;
+  // An unpaired (largest) value remains at this level.
+  if (values.size() % 2) {
+    values.erase(values.begin(), values.end() - 1);
+  } else {
+    values.clear();
+  }
+  if (levels_.size() == level + 1) levels_.emplace_back();
+  auto& next = levels_[level + 1];
+  next.insert(next.end(), promoted.begin(), promoted.end());
+  if (next.size() >= capacity_) Compact(level + 1);
+}
+
+double QuantileSketch::Quantile(double q) const {
+  std::vector<std::pair<double, Index>> weighted;
+  Index total_weight = 0;
+  for (size_t level = 0; level < levels_.size(); ++level) {
+    const Index weight = Index(1) << level;
+    for (double value : levels_[level]) {
+      weighted.emplace_back(value, weight);
+      total_weight += weight;
+    }
+  }
+  if (weighted.empty()) return std::numeric_limits<double>::quiet_NaN();
+  std::sort(weighted.begin(), weighted.end());
+  const double target = std::clamp(q, 0.0, 1.0) * total_weight;
+  Index cumulative_weight = 0;
+  for (const auto& [value, weight] : weighted) {
+    cumulative_weight += weight;
+    if (cumulative_weight >= target) return value;
+  }
+  return weighted.back().first;
+}
+
+}  // namespace tensorstore
@@ -0,0 +1,319 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_REDUCE_H_
+#define TENSORSTORE_REDUCE_H_
+
+/// \file
+/// Parallel reductions over the elements of a TensorStore.
+///
+/// A reduction is a type that defines:
+///
+///   using Element = ...;  // Element type of the TensorStore.
+///   using State = ...;    // Partial result.
+///   State Initial() const;
+///   void Accumulate(State& state, const Element& value) const;
+///   void Merge(State& state, State&& other) const;
+///
+/// The elements of each chunk are accumulated into a separate `State`,
+/// concurrently with other chunks, and the partial results are then merged in
+/// an unspecified order.  Therefore, `Merge` must be associative and
+/// commutative.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/data_type.h"
+#include "tensorstore/driver/driver_handle.h"
+#include "tensorstore/driver/read.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/transformed_array.h"
+#include "tensorstore/internal/type_traits.h"
+#include "tensorstore/static_cast.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+
+/// Options for `Reduce`.
+///
+/// \relates TensorStore
+struct ReduceOptions {
+  /// Maximum estimated size in bytes of the decoded chunk data being read and
+  /// reduced concurrently.  Regions of the domain beyond those being reduced
+  /// are read ahead while the limit permits.  If `0`, the entire domain is
+  /// read at once.
+  size_t total_bytes_limit = 256 * 1024 * 1024;
+};
+
+/// Sum of the elements, accumulated as `double` for floating-point types and
+/// as a 64-bit integer for integer types.
+///
+/// \relates TensorStore
+template <typename T>
+struct SumReduction {
+  using Element = T;
+  using State = std::conditional_t<
+      std::is_integral_v<T>,
+      std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, double>;
+  State Initial() const { return 0; }
+  void Accumulate(State& state, const T& value) const {
+    state += static_cast<State>(value);
+  }
+  void Merge(State& state, State&& other) const { state += other; }
+};
+
+/// Minimum, maximum and number of the elements.  Values that do not compare
+/// equal to themselves, i.e. NaN, are ignored.
+///
+/// \relates TensorStore
+template <typename T>
+struct MinMaxReduction {
+  using Element = T;
+  struct State {
+    T min{};
+    T max{};
+    /// Number of elements accumulated.  If `0`, `min` and `max` are not
+    /// meaningful.
+    Index count = 0;
+  };
+  State Initial() const { return {}; }
+  void Accumulate(State& state, const T& value) const {
+    if (!(value == value)) return;
+    if (state.count++ == 0) {
+      state.min = state.max = value;
+    } else if (value < state.min) {
+      state.min = value;
+    } else if (state.max < value) {
+      state.max = value;
+    }
+  }
+  void Merge(State& state, State&& other) const {
+    if (other.count == 0) return;
+    if (state.count == 0) {
+      state = std::move(other);
+      return;
+    }
+    if (other.min < state.min) state.min = other.min;
+    if (state.max < other.max) state.max = other.max;
+    state.count += other.count;
+  }
+};
+
+/// Histogram of the elements over `num_bins` equal-width bins spanning
+/// `[lower, upper)`.
+///
+/// \relates TensorStore
+template <typename T>
+struct HistogramReduction {
+  using Element = T;
+  struct State {
+    std::vector<Index> counts;
+    /// Number of elements less than `lower`.
+    Index underflow = 0;
+    /// Number of elements not less than `upper`, or NaN.
+    Index overflow = 0;
+  };
+
+  HistogramReduction(double lower, double upper, size_t num_bins)
+      : lower(lower), upper(upper), num_bins(num_bins) {}
+
+  State Initial() const {
+    State state;
+    state.counts.resize(num_bins);
+    return state;
+  }
+  void Accumulate(State& state, const T& value) const {
+    const double x = static_cast<double>(value);
+    if (x < lower) {
+      ++state.underflow;
+      return;
+    }
+    const double bin = std::floor((x - lower) / (upper - lower) * num_bins);
+    if (!(bin < num_bins)) {
+      ++state.overflow;
+      return;
+    }
+    ++state.counts[static_cast<size_t>(bin)];
+  }
+  void Merge(State& state, State&& other) const {
+    for (size_t i = 0; i < num_bins; ++i) state.counts[i] += other.counts[i];
+    state.underflow += other.underflow;
+    state.overflow += other.overflow;
+  }
+
+  double lower;
+  double upper;
+  size_t num_bins;
+};
+
+/// Mergeable sketch of a distribution of values that supports approximate
+/// quantile queries, using memory logarithmic in the number of values.
+///
+/// Values are stored in levels, where a value at level ``i`` represents
+/// ``2**i`` of the original values.  When a level reaches `capacity` values,
+/// it is compacted by sorting it and promoting every other value to the next
+/// level.
+///
+/// \relates TensorStore
+class QuantileSketch {
+ public:
+  explicit QuantileSketch(size_t capacity = 256)
+      : capacity_(std::max(capacity, size_t(2))) {}
+
+  /// Adds a single value.  NaN values are ignored.
+  void Add(double value);
+
+  /// Adds all values of `other`.
+  void Merge(const QuantileSketch& other);
+
+  /// Returns the number of values added.
+  Index count() const { return count_; }
+
+  /// Returns the approximate value at the specified quantile.
+  ///
+  /// \param q Quantile in ``[0, 1]``.
+  /// \returns The approximate value, or NaN if `count() == 0`.
+  double Quantile(double q) const;
+
+ private:
+  void Compact(size_t level);
+
+  size_t capacity_;
+  Index count_ = 0;
+  std::vector<std::vector<double>> levels_;
+  bool compaction_parity_ = false;
+};
+
+/// Approximate quantiles of the elements, computed using a `QuantileSketch`.
+///
+/// \relates TensorStore
+template <typename T>
+struct QuantileReduction {
+  using Element = T;
+  using State = QuantileSketch;
+
+  explicit QuantileReduction(size_t capacity = 256) : capacity(capacity) {}
+
+  State Initial() const { return State(capacity); }
+  void Accumulate(State& state, const T& value) const {
+    state.Add(static_cast<double>(value));
+  }
+  void Merge(State& state, State&& other) const { state.Merge(other); }
+
+  size_t capacity;
+};
+
+namespace internal_reduce {
+
+template <typename Reduction>
+Future<typename Reduction::State> Reduce(internal::DriverHandle source,
+                                         Reduction reduction,
+                                         ReduceOptions options) {
+  using Element = typename Reduction::Element;
+  using State = typename Reduction::State;
+  if (source.driver->dtype() != dtype_v<Element>) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Cannot reduce TensorStore with data type ", source.driver->dtype(),
+        " using reduction with element type ", dtype_v<Element>));
+  }
+  struct SharedState {
+    explicit SharedState(Reduction reduction)
+        : reduction(std::move(reduction)), state(this->reduction.Initial()) {}
+    Reduction reduction;
+    absl::Mutex mutex;
+    State state;
+  };
+  auto shared = std::make_shared<SharedState>(std::move(reduction));
+  auto future = internal::DriverForEachChunk(
+      std::move(source),
+      [shared](ReadChunkView chunk) -> absl::Status {
+        TENSORSTORE_ASSIGN_OR_RETURN(auto array, chunk.array());
+        const Reduction& reduction = shared->reduction;
+        State state = reduction.Initial();
+        TENSORSTORE_RETURN_IF_ERROR(
+            IterateOverTransformedArrays(
+                [&](const Element* value) {
+                  reduction.Accumulate(state, *value);
+                },
+                /*constraints=*/{},
+                StaticDataTypeCast<const Element, unchecked>(array))
+                .status());
+        absl::MutexLock lock(&shared->mutex);
+        reduction.Merge(shared->state, std::move(state));
+        return absl::OkStatus();
+      },
+      {options.total_bytes_limit});
+  return PromiseFuturePair<State>::LinkValue(
+             [shared](Promise<State> promise, ReadyFuture<const void> future) {
+               promise.SetResult(std::move(shared->state));
+             },
+             std::move(future))
+      .future;
+}
+
+}  // namespace internal_reduce
+
+/// Reduces the elements of a `source` `TensorStore` in parallel.
+///
+/// The chunks of `source` are streamed using `ReadChunks`, with the amount
+/// of data read concurrently bounded by `options.total_bytes_limit`, and each
+/// chunk is reduced directly from the cache where possible.
+///
+/// Example::
+///
+///     TensorReader<float, 3> store = ...;
+///     auto quantiles = Reduce(store, QuantileReduction<float>()).value();
+///     double median = quantiles.Quantile(0.5);
+///
+/// \param source Source TensorStore object that supports reading.  May be
+///     `Result`-wrapped.
+/// \param reduction The reduction, as described above.
+/// \param options Specifies options.
+/// \returns A future that becomes ready with the merged `State` once all
+///     chunks have been reduced.
+/// \error `absl::StatusCode::kInvalidArgument` if the data type of `source`
+///     does not match ``Reduction::Element``.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename Reduction, typename Source>
+std::enable_if_t<internal::IsTensorStore<
+                     UnwrapResultType<internal::remove_cvref_t<Source>>>,
+                 Future<typename Reduction::State>>
+Reduce(Source&& source, Reduction reduction, ReduceOptions options = {}) {
+  return MapResult(
+      [&](UnwrapQualifiedResultType<Source&&> unwrapped_source) {
+        return internal_reduce::Reduce(
+            internal::TensorStoreAccess::handle(
+                std::forward<decltype(unwrapped_source)>(unwrapped_source)),
+            std::move(reduction), options);
+      },
+      std::forward<Source>(source));
+}
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_REDUCE_H_
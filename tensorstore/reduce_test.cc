@@ -0,0 +1,138 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/reduce.h"
+
+#include <stdint.h>
+
+#include <cmath>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+
+tensorstore::TensorStore<int32_t, 2> OpenTestStore() {
+  // 20 x 30 array with chunks of shape 4 x 7, containing `i * 30 + j`.
+  auto store = tensorstore::Open<int32_t, 2>(
+                   {{"driver", "zarr"},
+                    {"kvstore", {{"driver", "memory"}}},
+                    {"metadata",
+                     {{"dtype", "<i4"},
+                      {"shape", {20, 30}},
+                      {"chunks", {4, 7}}}}},
+                   tensorstore::Context::Default(),
+                   tensorstore::OpenMode::create)
+                   .value();
+  auto array = tensorstore::AllocateArray<int32_t>({20, 30});
+  for (Index i = 0; i < 20; ++i) {
+    for (Index j = 0; j < 30; ++j) {
+      array(i, j) = i * 30 + j;
+    }
+  }
+  TENSORSTORE_CHECK_OK(tensorstore::Write(array, store).status());
+  return store;
+}
+
+TEST(ReduceTest, Sum) {
+  auto store = OpenTestStore();
+  // A limit smaller than a single chunk causes the chunks to be read one at
+  // a time.
+  for (size_t total_bytes_limit : {0, 1, 1000}) {
+    SCOPED_TRACE(total_bytes_limit);
+    EXPECT_THAT(tensorstore::Reduce(store, tensorstore::SumReduction<int32_t>(),
+                                    {total_bytes_limit})
+                    .result(),
+                ::testing::Optional(599 * 600 / 2));
+  }
+}
+
+TEST(ReduceTest, MinMaxOfRegion) {
+  auto store = OpenTestStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      tensorstore::Reduce(
+          store | tensorstore::Dims(0, 1).SizedInterval({3, 5}, {10, 12}),
+          tensorstore::MinMaxReduction<int32_t>())
+          .result());
+  EXPECT_EQ(3 * 30 + 5, result.min);
+  EXPECT_EQ(12 * 30 + 16, result.max);
+  EXPECT_EQ(120, result.count);
+}
+
+TEST(ReduceTest, Histogram) {
+  auto store = OpenTestStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      tensorstore::Reduce(store,
+                          tensorstore::HistogramReduction<int32_t>(100, 500, 4))
+          .result());
+  EXPECT_THAT(result.counts, ::testing::ElementsAre(100, 100, 100, 100));
+  EXPECT_EQ(100, result.underflow);
+  EXPECT_EQ(100, result.overflow);
+}
+
+TEST(ReduceTest, Quantiles) {
+  auto store = OpenTestStore();
+  TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+      auto sketch,
+      tensorstore::Reduce(store, tensorstore::QuantileReduction<int32_t>(16))
+          .result());
+  EXPECT_EQ(600, sketch.count());
+  EXPECT_NEAR(300, sketch.Quantile(0.5), 60);
+  EXPECT_NEAR(60, sketch.Quantile(0.1), 60);
+  EXPECT_NEAR(540, sketch.Quantile(0.9), 60);
+}
+
+TEST(ReduceTest, DataTypeMismatch) {
+  auto store = OpenTestStore();
+  EXPECT_THAT(
+      tensorstore::Reduce(store, tensorstore::SumReduction<float>()).result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Cannot reduce TensorStore with data type int32 using "
+                    "reduction with element type float32"));
+}
+
+TEST(QuantileSketchTest, Merge) {
+  tensorstore::QuantileSketch a(32), b(32);
+  for (int i = 0; i < 1000; ++i) a.Add(i);
+  for (int i = 1000; i < 2000; ++i) b.Add(i);
+  b.Add(NAN);
+  a.Merge(b);
+  EXPECT_EQ(2000, a.count());
+  EXPECT_NEAR(1000, a.Quantile(0.5), 100);
+  EXPECT_NEAR(0, a.Quantile(0), 100);
+  EXPECT_NEAR(2000, a.Quantile(1), 100);
+}
+
+TEST(QuantileSketchTest, Empty) {
+  tensorstore::QuantileSketch sketch;
+  EXPECT_TRUE(std::isnan(sketch.Quantile(0.5)));
+}
+
+}  // namespace
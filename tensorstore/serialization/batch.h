@@ -34,6 +34,9 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "riegeli/bytes/cord_reader.h"
+#include "riegeli/bytes/cord_writer.h"
 #include "riegeli/bytes/string_reader.h"
 #include "riegeli/bytes/string_writer.h"
 #include "riegeli/bytes/writer.h"
@@ -122,6 +125,38 @@ absl::Status DecodeBatch(std::string_view encoded, T&& value,
   return source.Done();
 }
 
+/// Encodes a single object to a `absl::Cord`.
+///
+/// Unlike `EncodeBatch`, large arrays of const elements are referenced by the
+/// returned cord rather than copied.
+template <typename T, typename ElementSerializer = Serializer<T>>
+Result<absl::Cord> EncodeBatchToCord(const T& value,
+                                     const ElementSerializer& serializer = {}) {
+  absl::Cord buffer;
+  riegeli::CordWriter writer(&buffer);
+  BatchEncodeSink sink(writer);
+  if (!serializer.Encode(sink, value) || !sink.Close()) {
+    return sink.status();
+  }
+  return buffer;
+}
+
+/// Decodes a single object from a `absl::Cord`.
+///
+/// Unlike `DecodeBatch`, large arrays of const elements may reference the
+/// data of `encoded` rather than a copy.
+template <typename T,
+          typename ElementSerializer = Serializer<internal::remove_cvref_t<T>>>
+absl::Status DecodeBatchFromCord(const absl::Cord& encoded, T& value,
+                                 const ElementSerializer& serializer = {}) {
+  riegeli::CordReader reader(&encoded);
+  BatchDecodeSource source(reader);
+  if (!serializer.Decode(source, value)) {
+    internal_serialization::FailEof(source);
+  }
+  return source.Done();
+}
+
 template <typename T>
 class MaybeDecode {
  public:
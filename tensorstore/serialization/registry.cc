@@ -14,7 +14,17 @@
 
 #include "tensorstore/serialization/registry.h"
 
+#include <stddef.h>
+
+#include <atomic>
+#include <string_view>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
 #include "absl/log/absl_log.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/util/str_cat.h"
 
 namespace tensorstore {
@@ -24,38 +34,77 @@ Registry::Registry() = default;
 Registry::~Registry() = default;
 
 void Registry::Add(const Entry& entry) {
-  if (!by_id_.insert(&entry).second) {
-    ABSL_LOG(FATAL) << "Duplicate serializable id registration: " << entry.id;
-  }
-  if (!by_type_.insert(&entry).second) {
+  if (std::exchange(entry.added, true)) {
+    // The same entry must not be added to the pending list twice.
     ABSL_LOG(FATAL) << "Duplicate serializable type registration: "
                     << entry.type.name();
   }
+  entry.next_pending = pending_.load(std::memory_order_relaxed);
+  while (!pending_.compare_exchange_weak(entry.next_pending, &entry,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+void Registry::IndexPendingEntries() {
+  if (!pending_.load(std::memory_order_acquire)) return;
+  absl::WriterMutexLock lock(&mutex_);
+  std::vector<const Entry*> entries;
+  for (const Entry* entry =
+           pending_.exchange(nullptr, std::memory_order_acquire);
+       entry; entry = entry->next_pending) {
+    entries.push_back(entry);
+  }
+  by_id_.reserve(by_id_.size() + entries.size());
+  by_type_.reserve(by_type_.size() + entries.size());
+  for (size_t i = entries.size(); i--;) {
+    const Entry& entry = *entries[i];
+    if (!by_id_.insert(&entry).second) {
+      ABSL_LOG(FATAL) << "Duplicate serializable id registration: "
+                      << entry.id;
+    }
+    if (!by_type_.insert(&entry).second) {
+      ABSL_LOG(FATAL) << "Duplicate serializable type registration: "
+                      << entry.type.name();
+    }
+  }
 }
 
 bool Registry::Encode(EncodeSink& sink, const void* value,
                       const std::type_info& type) {
-  auto it = by_type_.find(std::type_index(type));
-  if (it == by_type_.end()) {
+  IndexPendingEntries();
+  const Entry* entry = nullptr;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = by_type_.find(std::type_index(type)); it != by_type_.end()) {
+      entry = *it;
+    }
+  }
+  if (!entry) {
     sink.Fail(absl::InternalError(tensorstore::StrCat(
         "Dynamic type not registered for serialization: ", type.name())));
     return false;
   }
-  auto& entry = **it;
-  return serialization::Encode(sink, entry.id) && entry.encode(sink, value);
+  return serialization::Encode(sink, entry->id) && entry->encode(sink, value);
 }
 
 bool Registry::Decode(DecodeSource& source, void* value) {
   std::string_view id;
   if (!serialization::Decode(source, id)) return false;
-  auto it = by_id_.find(id);
-  if (it == by_id_.end()) {
+  IndexPendingEntries();
+  const Entry* entry = nullptr;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = by_id_.find(id); it != by_id_.end()) {
+      entry = *it;
+    }
+  }
+  if (!entry) {
     source.Fail(absl::DataLossError(tensorstore::StrCat(
         "Dynamic id not registered for serialization: ", id)));
     return false;
   }
-  auto& entry = **it;
-  return entry.decode(source, value);
+  return entry->decode(source, value);
 }
 
 }  // namespace serialization
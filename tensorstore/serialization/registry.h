@@ -32,6 +32,7 @@
 /// This is used to implement serialization for TensorStore drivers and KvStore
 /// drivers.
 
+#include <atomic>
 #include <memory>
 #include <string_view>
 #include <type_traits>
@@ -39,6 +40,8 @@
 #include <typeinfo>
 
 #include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorstore/internal/container/heterogeneous_container.h"
 #include "tensorstore/serialization/fwd.h"
 #include "tensorstore/serialization/serialization.h"
@@ -68,6 +71,12 @@ class Registry {
     Decode decode;
 
     std::type_index type_index() const { return type; }
+
+    /// Next entry in the list of entries that have not yet been indexed.
+    mutable const Entry* next_pending = nullptr;
+
+    /// Set when added to a registry.
+    mutable bool added = false;
   };
 
   Registry();
@@ -76,6 +85,11 @@ class Registry {
   /// Adds a derived type to this registry.
   ///
   /// It is a fatal error if `entry.id` or `entry.type` is already registered.
+  ///
+  /// Since most entries are added during static initialization, this just adds
+  /// `entry` to a lock-free list of pending entries, which are indexed upon the
+  /// first call to `Encode` or `Decode`; duplicate registrations are also
+  /// detected at that point.
   void Add(const Entry& entry);
 
   /// Encodes a value using the registry.
@@ -98,11 +112,18 @@ class Registry {
   [[nodiscard]] bool Decode(DecodeSource& source, void* value);
 
  private:
+  /// Adds any pending entries to `by_id_` and `by_type_`.
+  void IndexPendingEntries();
+
+  /// Added entries not yet indexed, in reverse order of addition.
+  std::atomic<const Entry*> pending_{nullptr};
+
+  absl::Mutex mutex_;
   internal::HeterogeneousHashSet<const Entry*, std::string_view, &Entry::id>
-      by_id_;
+      by_id_ ABSL_GUARDED_BY(mutex_);
   internal::HeterogeneousHashSet<const Entry*, std::type_index,
                                  &Entry::type_index>
-      by_type_;
+      by_type_ ABSL_GUARDED_BY(mutex_);
 };
 
 /// Returns the global registry for a given smart pointer type `Ptr`.
@@ -18,6 +18,8 @@
 #include <string_view>
 
 #include "absl/status/status.h"
+#include "riegeli/varint/varint_reading.h"
+#include "riegeli/varint/varint_writing.h"
 #include "tensorstore/util/span.h"
 #include "tensorstore/util/str_cat.h"
 
@@ -31,6 +33,18 @@ void FailNonNull(DecodeSource& source) {
 void FailEof(DecodeSource& source) {
   source.Fail(serialization::DecodeError("Unexpected end of input"));
 }
+
+bool WriteVarint(EncodeSink& sink, uint64_t value) {
+  return riegeli::WriteVarint64(value, sink.writer());
+}
+
+bool ReadVarint(DecodeSource& source, uint64_t& value) {
+  return riegeli::ReadVarint64(source.reader(), value);
+}
+
+void FailVarintOutOfRange(DecodeSource& source) {
+  source.Fail(serialization::DecodeError("Varint value out of range"));
+}
 }  // namespace internal_serialization
 
 void EncodeSink::Fail(absl::Status status) {
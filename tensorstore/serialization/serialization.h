@@ -477,6 +477,53 @@ struct Serializer<bool> {
   }
 };
 
+namespace internal_serialization {
+[[nodiscard]] bool WriteVarint(EncodeSink& sink, uint64_t value);
+[[nodiscard]] bool ReadVarint(DecodeSource& source, uint64_t& value);
+void FailVarintOutOfRange(DecodeSource& source);
+}  // namespace internal_serialization
+
+/// Serializer for integer types that uses a variable-length encoding, with
+/// zig-zag encoding for signed types, such that values of small magnitude are
+/// encoded as few bytes.
+///
+/// This is more compact than `MemcpySerializer` for values like dimension
+/// bounds, strides, and indices that are typically small, and is independent
+/// of the platform endianness.
+template <typename T>
+struct VarintSerializer {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+  [[nodiscard]] static bool Encode(EncodeSink& sink, T value) {
+    uint64_t v = static_cast<uint64_t>(value);
+    if constexpr (std::is_signed_v<T>) {
+      v = (v << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+    }
+    return internal_serialization::WriteVarint(sink, v);
+  }
+
+  [[nodiscard]] static bool Decode(DecodeSource& source, T& value) {
+    uint64_t v;
+    if (!internal_serialization::ReadVarint(source, v)) return false;
+    if constexpr (std::is_signed_v<T>) {
+      const int64_t decoded = static_cast<int64_t>(v >> 1) ^
+                              -static_cast<int64_t>(v & 1);
+      value = static_cast<T>(decoded);
+      if (static_cast<int64_t>(value) != decoded) {
+        internal_serialization::FailVarintOutOfRange(source);
+        return false;
+      }
+    } else {
+      value = static_cast<T>(v);
+      if (static_cast<uint64_t>(value) != v) {
+        internal_serialization::FailVarintOutOfRange(source);
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
 /// Convenient interface for encoding an object with its default serializer.
 template <typename T, typename ElementSerializer = Serializer<T>>
 [[nodiscard]] bool Encode(EncodeSink& sink, const T& value,
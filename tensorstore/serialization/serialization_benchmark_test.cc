@@ -0,0 +1,187 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_space/index_transform.h"
+#include "tensorstore/index_space/index_transform_builder.h"
+#include "tensorstore/serialization/batch.h"
+#include "tensorstore/serialization/serialization.h"
+#include "tensorstore/spec.h"
+#include "tensorstore/util/iterate.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::IndexTransform;
+using ::tensorstore::SharedArray;
+using ::tensorstore::serialization::DecodeBatch;
+using ::tensorstore::serialization::DecodeBatchFromCord;
+using ::tensorstore::serialization::EncodeBatch;
+using ::tensorstore::serialization::EncodeBatchToCord;
+
+template <typename T>
+void BenchmarkEncode(benchmark::State& state, const T& value) {
+  size_t bytes = 0;
+  for (auto s : state) {
+    auto encoded = EncodeBatch(value);
+    ABSL_CHECK(encoded.ok());
+    bytes += encoded->size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+template <typename T>
+void BenchmarkDecode(benchmark::State& state, const T& value) {
+  auto encoded = EncodeBatch(value);
+  ABSL_CHECK(encoded.ok());
+  for (auto s : state) {
+    T decoded;
+    ABSL_CHECK(DecodeBatch(*encoded, decoded).ok());
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+// Rank `state.range(0)` identity transform with labels and implicit bounds,
+// as for the transform of a typical `Spec`.
+IndexTransform<> MakeBasicTransform(benchmark::State& state) {
+  const auto rank = state.range(0);
+  tensorstore::IndexTransformBuilder<> builder(rank, rank);
+  for (Index i = 0; i < rank; ++i) {
+    builder.input_shape()[i] = 1000 + i;
+    builder.input_labels()[i] = std::string(1, 'a' + static_cast<char>(i));
+    builder.implicit_upper_bounds()[i] = true;
+  }
+  auto transform = builder.output_identity_transform().Finalize();
+  ABSL_CHECK(transform.ok());
+  return *std::move(transform);
+}
+
+// Rank-2 transform with an index array of shape `state.range(0)` x 64.
+IndexTransform<> MakeIndexArrayTransform(benchmark::State& state) {
+  const Index size = state.range(0);
+  auto index_array = tensorstore::AllocateArray<Index>({size, 64});
+  Index value = 0;
+  tensorstore::IterateOverArrays([&](Index* x) { *x = (value++ * 7) % 1000; },
+                                 tensorstore::c_order, index_array);
+  auto transform = tensorstore::IndexTransformBuilder<>(2, 2)
+                       .input_shape({size, 64})
+                       .output_index_array(0, 0, 1, index_array)
+                       .output_single_input_dimension(1, 1)
+                       .Finalize();
+  ABSL_CHECK(transform.ok());
+  return *std::move(transform);
+}
+
+// Array of `state.range(0)` `uint16_t` elements.
+SharedArray<const uint16_t> MakeArray(benchmark::State& state) {
+  auto array = tensorstore::AllocateArray<uint16_t>({state.range(0)});
+  for (Index i = 0; i < state.range(0); ++i) array(i) = i;
+  return array;
+}
+
+tensorstore::Spec MakeSpec() {
+  auto spec = tensorstore::Spec::FromJson({
+      {"driver", "array"},
+      {"array", {{1, 2, 3}, {4, 5, 6}}},
+      {"dtype", "int32"},
+      {"transform",
+       {{"input_labels", {"x", "y"}}, {"input_exclusive_max", {{2}, {3}}}}},
+  });
+  ABSL_CHECK(spec.ok());
+  return *std::move(spec);
+}
+
+void BM_EncodeTransform(benchmark::State& state) {
+  BenchmarkEncode(state, MakeBasicTransform(state));
+}
+
+void BM_DecodeTransform(benchmark::State& state) {
+  BenchmarkDecode(state, MakeBasicTransform(state));
+}
+
+void BM_EncodeIndexArrayTransform(benchmark::State& state) {
+  BenchmarkEncode(state, MakeIndexArrayTransform(state));
+}
+
+void BM_DecodeIndexArrayTransform(benchmark::State& state) {
+  BenchmarkDecode(state, MakeIndexArrayTransform(state));
+}
+
+void BM_EncodeArray(benchmark::State& state) {
+  BenchmarkEncode(state, MakeArray(state));
+}
+
+void BM_DecodeArray(benchmark::State& state) {
+  BenchmarkDecode(state, MakeArray(state));
+}
+
+// Same as `BM_EncodeArray`, but encodes to a `absl::Cord`, which references
+// large arrays rather than copying them.
+void BM_EncodeArrayToCord(benchmark::State& state) {
+  auto array = MakeArray(state);
+  for (auto s : state) {
+    auto encoded = EncodeBatchToCord(array);
+    ABSL_CHECK(encoded.ok());
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * array.num_elements() *
+                          sizeof(uint16_t));
+}
+
+void BM_DecodeArrayFromCord(benchmark::State& state) {
+  auto array = MakeArray(state);
+  auto encoded = EncodeBatchToCord(array);
+  ABSL_CHECK(encoded.ok());
+  for (auto s : state) {
+    SharedArray<const uint16_t> decoded;
+    ABSL_CHECK(DecodeBatchFromCord(*encoded, decoded).ok());
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+void BM_EncodeSpec(benchmark::State& state) {
+  BenchmarkEncode(state, MakeSpec());
+}
+
+void BM_DecodeSpec(benchmark::State& state) {
+  BenchmarkDecode(state, MakeSpec());
+}
+
+BENCHMARK(BM_EncodeTransform)->Arg(1)->Arg(3)->Arg(6);
+BENCHMARK(BM_DecodeTransform)->Arg(1)->Arg(3)->Arg(6);
+BENCHMARK(BM_EncodeIndexArrayTransform)->Arg(1)->Arg(64);
+BENCHMARK(BM_DecodeIndexArrayTransform)->Arg(1)->Arg(64);
+BENCHMARK(BM_EncodeArray)->Arg(16)->Arg(1 << 20);
+BENCHMARK(BM_DecodeArray)->Arg(16)->Arg(1 << 20);
+BENCHMARK(BM_EncodeArrayToCord)->Arg(16)->Arg(1 << 20);
+BENCHMARK(BM_DecodeArrayFromCord)->Arg(16)->Arg(1 << 20);
+BENCHMARK(BM_EncodeSpec);
+BENCHMARK(BM_DecodeSpec);
+
+}  // namespace
@@ -303,10 +303,12 @@ TEST(SpecTest, SetContextAndKvstore) {
                {"driver", "file"},
                {"path", "/tmp/"},
                {"file_io_concurrency", {"file_io_concurrency#a"}},
+               {"file_io_engine", {"file_io_engine"}},
                {"file_io_sync", {"file_io_sync"}},
            }},
           {"dtype", "uint8"},
           {"cache_pool", {"cache_pool"}},
+          {"codec_accelerator", {"codec_accelerator"}},
           {"schema",
            {{"domain", {{"inclusive_min", {0}}, {"exclusive_max", {10}}}}}},
           {"transform",
@@ -316,7 +318,9 @@ TEST(SpecTest, SetContextAndKvstore) {
            {
                {"data_copy_concurrency", ::nlohmann::json::object_t()},
                {"cache_pool", ::nlohmann::json::object_t()},
+               {"codec_accelerator", ::nlohmann::json::object_t()},
                {"file_io_concurrency#a", {{"limit", 5}}},
+               {"file_io_engine", "blocking"},
                {"file_io_sync", true},
            }},
       })));
@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "tensorstore/array.h"
+#include "tensorstore/cache_pin.h"
 #include "tensorstore/chunk_layout.h"
 #include "tensorstore/codec_spec.h"
 #include "tensorstore/data_type.h"
@@ -47,6 +48,8 @@
 #include "tensorstore/strided_layout.h"
 #include "tensorstore/tensorstore_impl.h"  // IWYU pragma: export
 #include "tensorstore/transaction.h"
+#include "tensorstore/util/execution/sender.h"
+#include "tensorstore/util/execution/sender_util.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/future.h"
 #include "tensorstore/util/garbage_collection/fwd.h"
@@ -728,6 +731,173 @@ Read(Source&& source, Option&&... options) {
       ReadIntoNewArrayOptions(std::forward<Option>(options)...));
 }
 
+/// Loads the data of a `source` `TensorStore` into the cache, without copying
+/// it to an array.
+///
+/// This is more efficient than reading into a temporary array that is then
+/// discarded, and is useful to warm the cache for a region that will be read
+/// later.  Data is only retained if `source` uses a
+/// `~Context.cache_pool` with a non-zero total bytes limit.
+///
+/// Options compatible with `PrefetchOptions` are specified in any order after
+/// `store`.  The meaning of each option is determined by its type.
+///
+/// Supported option types are:
+///
+/// - `Batch`
+///
+/// Example::
+///
+///     TensorReader<std::int32_t, 3> store = ...;
+///     auto future = Prefetch(
+///         store | AllDims().SizedInterval({100, 200}, {25, 30}));
+///
+/// \param source Source TensorStore object that supports reading.  May be
+///     `Result`-wrapped.
+/// \param options Any option compatible with `PrefetchOptions`.
+/// \returns A future that becomes ready when the data has been loaded or an
+///     error occurs.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename Source>
+std::enable_if_t<internal::IsTensorStore<
+                     UnwrapResultType<internal::remove_cvref_t<Source>>>,
+                 Future<void>>
+Prefetch(Source&& source, PrefetchOptions options) {
+  return MapResult(
+      [&](UnwrapQualifiedResultType<Source&&> unwrapped_source) {
+        return internal::DriverPrefetch(
+            internal::TensorStoreAccess::handle(
+                std::forward<decltype(unwrapped_source)>(unwrapped_source)),
+            std::move(options));
+      },
+      std::forward<Source>(source));
+}
+template <typename Source, typename... Option>
+std::enable_if_t<(internal::IsTensorStore<
+                      UnwrapResultType<internal::remove_cvref_t<Source>>> &&
+                  IsCompatibleOptionSequence<PrefetchOptions, Option...>),
+                 Future<void>>
+Prefetch(Source&& source, Option&&... options) {
+  return tensorstore::Prefetch(
+      std::forward<Source>(source),
+      PrefetchOptions(std::forward<Option>(options)...));
+}
+
+/// Loads the data of a `source` `TensorStore` into the cache, and pins it
+/// there until the returned `CachePin` is released.
+///
+/// Pinned chunks are not evicted, and are accounted against
+/// `Context.cache_pool.pinned_bytes_limit` instead of
+/// `Context.cache_pool.total_bytes_limit`.  This is intended for small,
+/// latency-critical regions that must not be displaced by other reads sharing
+/// the cache pool.  Only chunks held in a chunk cache are pinned; data of
+/// drivers that do not cache chunks is loaded but not retained.
+///
+/// Options compatible with `PinOptions` are specified in any order after
+/// `store`.  The meaning of each option is determined by its type.
+///
+/// Supported option types are:
+///
+/// - `Batch`
+///
+/// Example::
+///
+///     TensorReader<std::int32_t, 3> store = ...;
+///     TENSORSTORE_ASSIGN_OR_RETURN(
+///         auto pin,
+///         Pin(store | AllDims().SizedInterval({100, 200}, {25, 30}))
+///             .result());
+///
+/// \param source Source TensorStore object that supports reading.  May be
+///     `Result`-wrapped.  Must not be bound to a transaction.
+/// \param options Any option compatible with `PinOptions`.
+/// \returns A future that becomes ready with the pin once the data has been
+///     loaded and pinned.
+/// \error `absl::StatusCode::kResourceExhausted` if the pinned bytes limit of
+///     the cache pool would be exceeded.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename Source>
+std::enable_if_t<internal::IsTensorStore<
+                     UnwrapResultType<internal::remove_cvref_t<Source>>>,
+                 Future<CachePin>>
+Pin(Source&& source, PinOptions options) {
+  return MapResult(
+      [&](UnwrapQualifiedResultType<Source&&> unwrapped_source) {
+        return internal::DriverPin(
+            internal::TensorStoreAccess::handle(
+                std::forward<decltype(unwrapped_source)>(unwrapped_source)),
+            std::move(options));
+      },
+      std::forward<Source>(source));
+}
+template <typename Source, typename... Option>
+std::enable_if_t<(internal::IsTensorStore<
+                      UnwrapResultType<internal::remove_cvref_t<Source>>> &&
+                  IsCompatibleOptionSequence<PinOptions, Option...>),
+                 Future<CachePin>>
+Pin(Source&& source, Option&&... options) {
+  return tensorstore::Pin(std::forward<Source>(source),
+                          PinOptions(std::forward<Option>(options)...));
+}
+
+/// Returns a flow sender of read-only views of the chunks of a `source`
+/// `TensorStore`.
+///
+/// Unlike `Read`, the data is not copied to an array.  Instead, each chunk is
+/// delivered as a `ReadChunkView` that references the decoded chunk data
+/// (e.g. in the cache) directly, where possible, which allows streaming
+/// consumers, such as reductions, to process the data in place.  The
+/// reference to each chunk is released when its `ReadChunkView` is destroyed.
+///
+/// Options compatible with `ReadChunksOptions` are specified in any order
+/// after `store`.  The meaning of each option is determined by its type.
+///
+/// Supported option types are:
+///
+/// - `Batch`
+///
+/// Example::
+///
+///     TensorReader<std::int32_t, 3> store = ...;
+///     auto chunks = tensorstore::CollectFlowSenderIntoFuture<
+///         std::vector<ReadChunkView>>(ReadChunks(store));
+///
+/// \param source Source TensorStore object that supports reading.  May be
+///     `Result`-wrapped.
+/// \param options Any option compatible with `ReadChunksOptions`.
+/// \returns A flow sender that, when submitted, resolves the bounds of
+///     `source` and then delivers each chunk in turn.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename Source>
+std::enable_if_t<internal::IsTensorStore<
+                     UnwrapResultType<internal::remove_cvref_t<Source>>>,
+                 ReadChunksSender>
+ReadChunks(Source&& source, ReadChunksOptions options) {
+  auto sender = MapResult(
+      [&](UnwrapQualifiedResultType<Source&&> unwrapped_source) {
+        return internal::DriverReadChunks(
+            internal::TensorStoreAccess::handle(
+                std::forward<decltype(unwrapped_source)>(unwrapped_source)),
+            std::move(options));
+      },
+      std::forward<Source>(source));
+  if (!sender.ok()) return FlowSingleSender{ErrorSender{sender.status()}};
+  return *std::move(sender);
+}
+template <typename Source, typename... Option>
+std::enable_if_t<(internal::IsTensorStore<
+                      UnwrapResultType<internal::remove_cvref_t<Source>>> &&
+                  IsCompatibleOptionSequence<ReadChunksOptions, Option...>),
+                 ReadChunksSender>
+ReadChunks(Source&& source, Option&&... options) {
+  return tensorstore::ReadChunks(
+      std::forward<Source>(source),
+      ReadChunksOptions(std::forward<Option>(options)...));
+}
+
 /// Copies from a `source` array to `target` TensorStore.
 ///
 /// The domain of `target` is resolved via `ResolveBounds` and then the domain
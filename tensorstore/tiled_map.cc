@@ -0,0 +1,290 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/tiled_map.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorstore/array.h"
+#include "tensorstore/box.h"
+#include "tensorstore/contiguous_layout.h"
+#include "tensorstore/index.h"
+#include "tensorstore/index_interval.h"
+#include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/internal/intrusive_ptr.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/division.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status.h"
+#include "tensorstore/util/str_cat.h"
+
+namespace tensorstore {
+namespace internal_tiled_map {
+namespace {
+
+using ::tensorstore::internal::IntrusivePtr;
+
+/// State of a `TiledMap` operation.
+struct TiledMapState : public internal::AtomicReferenceCount<TiledMapState> {
+  Executor executor;
+  TensorStore<> input;
+  TensorStore<> output;
+  TiledMapKernel kernel;
+  std::vector<Index> halo;
+  size_t total_bytes_limit;
+  Promise<void> promise;
+  Box<> domain;
+  std::vector<Index> grid_origin;
+  std::vector<Index> tile_shape;
+  /// Range of grid cells that intersect `domain`.
+  Box<> cells;
+
+  absl::Mutex mutex;
+  size_t in_flight_bytes ABSL_GUARDED_BY(mutex) = 0;
+  Index next_tile ABSL_GUARDED_BY(mutex) = 0;
+  bool done ABSL_GUARDED_BY(mutex) = false;
+
+  void SetError(absl::Status error) {
+    {
+      absl::MutexLock lock(&mutex);
+      done = true;
+    }
+    SetDeferredResult(promise, std::move(error));
+  }
+
+  /// Returns the portion of `domain` within the grid cell with the specified
+  /// linear index.
+  Box<> GetTile(Index tile_index) const {
+    Box<> tile(domain.rank());
+    for (DimensionIndex dim = domain.rank(); dim--;) {
+      const Index num_cells = cells.shape()[dim];
+      const Index cell = cells.origin()[dim] + tile_index % num_cells;
+      tile_index /= num_cells;
+      const Index size = tile_shape[dim];
+      tile[dim] = Intersect(
+          IndexInterval::UncheckedSized(grid_origin[dim] + cell * size, size),
+          domain[dim]);
+    }
+    return tile;
+  }
+
+  /// Returns `tile` expanded by `halo` and clipped to the input domain.
+  Box<> GetInputBox(BoxView<> tile) const {
+    Box<> input_box(tile.rank());
+    const BoxView<> input_domain = input.domain().box();
+    for (DimensionIndex dim = 0; dim < tile.rank(); ++dim) {
+      input_box[dim] = Intersect(
+          IndexInterval::UncheckedHalfOpen(
+              tile[dim].inclusive_min() - halo[dim],
+              tile[dim].exclusive_max() + halo[dim]),
+          input_domain[dim]);
+    }
+    return input_box;
+  }
+};
+
+void StartTiles(IntrusivePtr<TiledMapState> state);
+
+/// Holds a reference to a single tile of a `TiledMap` operation from the time
+/// its input is read until its output has been written.
+struct TiledMapTile : public internal::AtomicReferenceCount<TiledMapTile> {
+  IntrusivePtr<TiledMapState> state;
+  Box<> output_box;
+  Box<> input_box;
+  size_t bytes;
+  ~TiledMapTile() {
+    {
+      absl::MutexLock lock(&state->mutex);
+      state->in_flight_bytes -= bytes;
+    }
+    StartTiles(std::move(state));
+  }
+};
+
+/// Invokes the kernel on the input of `tile` once it has been read, and
+/// writes the output.
+void ProcessTile(IntrusivePtr<TiledMapTile> tile,
+                 ReadyFuture<SharedOffsetArray<void>> input_future) {
+  auto& state = *tile->state;
+  if (!state.promise.result_needed()) return;
+  auto& input = input_future.result();
+  if (!input.ok()) {
+    state.SetError(input.status());
+    return;
+  }
+  auto output = AllocateArray(tile->output_box, c_order, default_init,
+                              state.output.dtype());
+  auto status = state.kernel(*input, output);
+  if (!status.ok()) {
+    state.SetError(std::move(status));
+    return;
+  }
+  auto write_futures = tensorstore::Write(
+      std::move(output), state.output | AllDims().BoxSlice(tile->output_box));
+  std::move(write_futures.commit_future)
+      .ExecuteWhenReady([tile = std::move(tile)](ReadyFuture<void> future) {
+        if (!future.status().ok()) tile->state->SetError(future.status());
+      });
+}
+
+/// Starts as many further tiles as `total_bytes_limit` permits.  At least one
+/// tile is always in flight until all tiles have been started.
+void StartTiles(IntrusivePtr<TiledMapState> state) {
+  std::vector<IntrusivePtr<TiledMapTile>> tiles;
+  {
+    absl::MutexLock lock(&state->mutex);
+    const Index num_tiles = state->cells.num_elements();
+    while (!state->done) {
+      if (!state->promise.result_needed() || state->next_tile == num_tiles) {
+        state->done = true;
+        break;
+      }
+      Box<> output_box = state->GetTile(state->next_tile);
+      Box<> input_box = state->GetInputBox(output_box);
+      const size_t bytes =
+          output_box.num_elements() * state->output.dtype()->size +
+          input_box.num_elements() * state->input.dtype()->size;
+      if (state->in_flight_bytes != 0 &&
+          state->in_flight_bytes + bytes > state->total_bytes_limit) {
+        break;
+      }
+      state->in_flight_bytes += bytes;
+      ++state->next_tile;
+      IntrusivePtr<TiledMapTile> tile(new TiledMapTile);
+      tile->state = state;
+      tile->output_box = std::move(output_box);
+      tile->input_box = std::move(input_box);
+      tile->bytes = bytes;
+      tiles.push_back(std::move(tile));
+    }
+  }
+  for (auto& tile : tiles) {
+    // Overlapping halo regions of neighboring tiles are served from the chunk
+    // cache of `input`, if it is large enough.
+    auto input_future = tensorstore::Read<offset_origin>(
+        state->input | AllDims().BoxSlice(tile->input_box));
+    std::move(input_future)
+        .ExecuteWhenReady(WithExecutor(
+            state->executor,
+            [tile = std::move(tile)](
+                ReadyFuture<SharedOffsetArray<void>> future) mutable {
+              ProcessTile(std::move(tile), std::move(future));
+            }));
+  }
+}
+
+/// Callback used by `TiledMap` to partition the output domain once the bounds
+/// have been resolved.
+struct TiledMapInitiateOp {
+  IntrusivePtr<TiledMapState> state;
+  void operator()(Promise<void> promise,
+                  ReadyFuture<TensorStore<>> input_future,
+                  ReadyFuture<TensorStore<>> output_future) {
+    state->promise = std::move(promise);
+    state->input = std::move(input_future.value());
+    state->output = std::move(output_future.value());
+    BoxView<> domain = state->output.domain().box();
+    if (!IsFinite(domain)) {
+      state->SetError(absl::InvalidArgumentError(tensorstore::StrCat(
+          "Tiled map requires an output with a finite domain, got ",
+          state->output.domain())));
+      return;
+    }
+    const DimensionIndex rank = domain.rank();
+    state->domain = domain;
+    state->grid_origin.resize(rank);
+    state->tile_shape.resize(rank);
+    state->cells.set_rank(rank);
+    // Dimensions for which the output does not specify a write chunk size are
+    // not partitioned.
+    auto layout = state->output.chunk_layout();
+    for (DimensionIndex dim = 0; dim < rank; ++dim) {
+      const IndexInterval interval = domain[dim];
+      Index origin = kImplicit;
+      Index size = 0;
+      if (layout.ok() && layout->rank() == rank) {
+        if (!layout->grid_origin().empty()) {
+          origin = layout->grid_origin()[dim];
+        }
+        if (!layout->write_chunk_shape().empty()) {
+          size = layout->write_chunk_shape()[dim];
+        }
+      }
+      if (size <= 0) {
+        origin = interval.inclusive_min();
+        size = std::max(Index(1), interval.size());
+      } else if (origin == kImplicit) {
+        origin = 0;
+      }
+      state->grid_origin[dim] = origin;
+      state->tile_shape[dim] = size;
+      state->cells[dim] = IndexInterval::UncheckedClosed(
+          FloorOfRatio(interval.inclusive_min() - origin, size),
+          FloorOfRatio(interval.inclusive_max() - origin, size));
+    }
+    if (domain.is_empty()) return;
+    StartTiles(std::move(state));
+  }
+};
+
+}  // namespace
+
+Future<void> TiledMap(TensorStore<> input, TensorStore<> output,
+                      TiledMapKernel kernel, TiledMapOptions options) {
+  const DimensionIndex rank = output.rank();
+  if (input.rank() != rank) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Input rank (", input.rank(), ") does not match output rank (", rank,
+        ")"));
+  }
+  if (options.halo.empty()) {
+    options.halo.resize(rank);
+  } else if (static_cast<DimensionIndex>(options.halo.size()) != rank) {
+    return absl::InvalidArgumentError(tensorstore::StrCat(
+        "Halo of length ", options.halo.size(), " does not match rank ",
+        rank));
+  }
+  for (Index width : options.halo) {
+    if (width < 0 || width > kMaxFiniteIndex) {
+      return absl::InvalidArgumentError(
+          tensorstore::StrCat("Invalid halo width: ", width));
+    }
+  }
+  IntrusivePtr<TiledMapState> state(new TiledMapState);
+  state->executor =
+      internal::TensorStoreAccess::handle(input).driver->data_copy_executor();
+  state->kernel = std::move(kernel);
+  state->halo = std::move(options.halo);
+  state->total_bytes_limit = options.total_bytes_limit;
+  auto executor = state->executor;
+  auto pair = PromiseFuturePair<void>::Make(MakeResult());
+  LinkValue(WithExecutor(std::move(executor),
+                         TiledMapInitiateOp{std::move(state)}),
+            std::move(pair.promise),
+            tensorstore::ResolveBounds(std::move(input)),
+            tensorstore::ResolveBounds(std::move(output)));
+  return std::move(pair.future);
+}
+
+}  // namespace internal_tiled_map
+}  // namespace tensorstore
@@ -0,0 +1,137 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TENSORSTORE_TILED_MAP_H_
+#define TENSORSTORE_TILED_MAP_H_
+
+/// \file
+/// Tiled stencil computations from one TensorStore to another.
+
+#include <stddef.h>
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorstore/array.h"
+#include "tensorstore/index.h"
+#include "tensorstore/rank.h"
+#include "tensorstore/static_cast.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/future.h"
+
+namespace tensorstore {
+
+/// Options for `TiledMap`.
+///
+/// \relates TensorStore
+struct TiledMapOptions {
+  /// Number of additional input elements on each side of an output tile that
+  /// are required to compute it, for each dimension.  If empty, no halo is
+  /// used.
+  std::vector<Index> halo;
+
+  /// Maximum estimated size in bytes of the input and output data of the
+  /// tiles being processed concurrently.  At least one tile is always being
+  /// processed.
+  size_t total_bytes_limit = 256 * 1024 * 1024;
+};
+
+namespace internal_tiled_map {
+
+using TiledMapKernel = std::function<absl::Status(
+    SharedOffsetArray<const void> input, SharedOffsetArray<void> output)>;
+
+Future<void> TiledMap(TensorStore<> input, TensorStore<> output,
+                      TiledMapKernel kernel, TiledMapOptions options);
+
+}  // namespace internal_tiled_map
+
+/// Computes `output` tile by tile from `input` using a stencil `kernel`.
+///
+/// The domain of `output` is partitioned into tiles according to its write
+/// chunk grid.  For each tile, the region of `input` consisting of the tile
+/// expanded by `options.halo` and clipped to the domain of `input` is read,
+/// the kernel is invoked to compute the tile, and the tile is written back to
+/// `output`.  Tiles are processed concurrently, and their input reads,
+/// computation and output writes are pipelined, with the amount of data in
+/// flight bounded by `options.total_bytes_limit`.  Since neighboring tiles
+/// read overlapping halo regions, `input` should generally use a cache pool
+/// large enough to retain the chunks shared by adjacent tiles.
+///
+/// The kernel is invoked as::
+///
+///     absl::Status kernel(SharedOffsetArray<const InputElement, Rank> input,
+///                         SharedOffsetArray<OutputElement, Rank> output);
+///
+/// where `input` and `output` are indexed by the same coordinates as the
+/// domains of the `input` and `output` TensorStores, and `output` is
+/// default-initialized.  The kernel may be invoked concurrently from multiple
+/// threads for different tiles.
+///
+/// Example::
+///
+///     TensorStore<float, 2> input = ..., output = ...;
+///     TENSORSTORE_RETURN_IF_ERROR(TiledMap(
+///         input, output,
+///         [](SharedOffsetArray<const float, 2> in,
+///            SharedOffsetArray<float, 2> out) {
+///           // Compute `out` from `in`, e.g. a 3x3 mean filter.
+///           return absl::OkStatus();
+///         },
+///         {/*halo=*/{1, 1}}).result());
+///
+/// \param input Source TensorStore object that supports reading.
+/// \param output Target TensorStore object that supports writing, with the
+///     same rank as `input`.  Must have a finite domain.
+/// \param kernel Function computing an output tile from an input tile.
+/// \param options Specifies options.
+/// \returns A future that becomes ready once all tiles have been written, or
+///     with the first error returned by `kernel`, reading or writing.
+/// \error `absl::StatusCode::kInvalidArgument` if the ranks of `input` and
+///     `output` differ, or if `options.halo` is invalid.
+/// \relates TensorStore
+/// \membergroup I/O
+template <typename InputElement, DimensionIndex InputRank,
+          ReadWriteMode InputMode, typename OutputElement,
+          DimensionIndex OutputRank, ReadWriteMode OutputMode,
+          typename Kernel>
+Future<void> TiledMap(TensorStore<InputElement, InputRank, InputMode> input,
+                      TensorStore<OutputElement, OutputRank, OutputMode> output,
+                      Kernel kernel, TiledMapOptions options = {}) {
+  static_assert(RankConstraint::EqualOrUnspecified(InputRank, OutputRank),
+                "Input and output ranks must be compatible.");
+  static_assert(InputMode != ReadWriteMode::write,
+                "Input must support reading.");
+  static_assert(OutputMode != ReadWriteMode::read,
+                "Output must support writing.");
+  constexpr DimensionIndex kRank = RankConstraint::And(InputRank, OutputRank);
+  return internal_tiled_map::TiledMap(
+      std::move(input), std::move(output),
+      [kernel = std::move(kernel)](SharedOffsetArray<const void> input,
+                                   SharedOffsetArray<void> output) {
+        return kernel(
+            StaticDataTypeCast<const InputElement, unchecked>(
+                StaticRankCast<kRank, unchecked>(std::move(input))),
+            StaticDataTypeCast<OutputElement, unchecked>(
+                StaticRankCast<kRank, unchecked>(std::move(output))));
+      },
+      std::move(options));
+}
+
+}  // namespace tensorstore
+
+#endif  // TENSORSTORE_TILED_MAP_H_
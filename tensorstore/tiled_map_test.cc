@@ -0,0 +1,136 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tensorstore/tiled_map.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include <nlohmann/json.hpp>
+#include "tensorstore/array.h"
+#include "tensorstore/context.h"
+#include "tensorstore/index.h"
+#include "tensorstore/open.h"
+#include "tensorstore/open_mode.h"
+#include "tensorstore/tensorstore.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+using ::tensorstore::Index;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::SharedOffsetArray;
+
+tensorstore::TensorStore<int32_t, 2> OpenStore(std::vector<Index> chunks) {
+  return tensorstore::Open<int32_t, 2>(
+             {{"driver", "zarr"},
+              {"kvstore", {{"driver", "memory"}}},
+              {"metadata",
+               {{"dtype", "<i4"}, {"shape", {20, 30}}, {"chunks", chunks}}}},
+             tensorstore::Context::Default(), tensorstore::OpenMode::create)
+      .value();
+}
+
+int32_t InputValue(Index i, Index j) { return i * 30 + j; }
+
+// Sum over the 3x3 neighborhood of `(i, j)` clipped to the 20x30 domain.
+int32_t ExpectedSum(Index i, Index j) {
+  int32_t sum = 0;
+  for (Index a = std::max(Index(0), i - 1); a <= std::min(Index(19), i + 1);
+       ++a) {
+    for (Index b = std::max(Index(0), j - 1); b <= std::min(Index(29), j + 1);
+         ++b) {
+      sum += InputValue(a, b);
+    }
+  }
+  return sum;
+}
+
+absl::Status SumKernel(SharedOffsetArray<const int32_t, 2> input,
+                       SharedOffsetArray<int32_t, 2> output) {
+  for (Index i = output.origin()[0]; i < output.origin()[0] + output.shape()[0];
+       ++i) {
+    for (Index j = output.origin()[1];
+         j < output.origin()[1] + output.shape()[1]; ++j) {
+      int32_t sum = 0;
+      for (Index a = std::max(input.origin()[0], i - 1);
+           a < std::min(input.origin()[0] + input.shape()[0], i + 2); ++a) {
+        for (Index b = std::max(input.origin()[1], j - 1);
+             b < std::min(input.origin()[1] + input.shape()[1], j + 2); ++b) {
+          sum += input(a, b);
+        }
+      }
+      output(i, j) = sum;
+    }
+  }
+  return absl::OkStatus();
+}
+
+TEST(TiledMapTest, BoxSum) {
+  auto input = OpenStore({4, 7});
+  auto array = tensorstore::AllocateArray<int32_t>({20, 30});
+  for (Index i = 0; i < 20; ++i) {
+    for (Index j = 0; j < 30; ++j) array(i, j) = InputValue(i, j);
+  }
+  TENSORSTORE_ASSERT_OK(tensorstore::Write(array, input).status());
+  // A limit smaller than a single tile causes the tiles to be processed one
+  // at a time.
+  for (size_t total_bytes_limit : {0, 1000, 1000000}) {
+    SCOPED_TRACE(total_bytes_limit);
+    auto output = OpenStore({6, 8});
+    TENSORSTORE_ASSERT_OK(tensorstore::TiledMap(input, output, &SumKernel,
+                                                {{1, 1}, total_bytes_limit})
+                              .result());
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto result,
+                                     tensorstore::Read(output).result());
+    for (Index i = 0; i < 20; ++i) {
+      for (Index j = 0; j < 30; ++j) {
+        ASSERT_EQ(ExpectedSum(i, j), result(i, j)) << i << ", " << j;
+      }
+    }
+  }
+}
+
+TEST(TiledMapTest, KernelError) {
+  auto input = OpenStore({4, 7});
+  auto output = OpenStore({6, 8});
+  EXPECT_THAT(
+      tensorstore::TiledMap(input, output,
+                            [](SharedOffsetArray<const int32_t, 2> input,
+                               SharedOffsetArray<int32_t, 2> output) {
+                              return absl::UnknownError("kernel failed");
+                            })
+          .result(),
+      MatchesStatus(absl::StatusCode::kUnknown, "kernel failed"));
+}
+
+TEST(TiledMapTest, InvalidHalo) {
+  auto input = OpenStore({4, 7});
+  auto output = OpenStore({6, 8});
+  EXPECT_THAT(tensorstore::TiledMap(input, output, &SumKernel, {{1}}).result(),
+              MatchesStatus(absl::StatusCode::kInvalidArgument,
+                            "Halo of length 1 does not match rank 2"));
+  EXPECT_THAT(
+      tensorstore::TiledMap(input, output, &SumKernel, {{1, -1}}).result(),
+      MatchesStatus(absl::StatusCode::kInvalidArgument,
+                    "Invalid halo width: -1"));
+}
+
+}  // namespace
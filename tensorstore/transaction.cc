@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
@@ -23,6 +24,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
 #include "absl/functional/function_ref.h"
@@ -113,7 +115,8 @@ TransactionState::OpenPtr TransactionState::AcquireImplicitOpenPtr() {
 }
 
 TransactionState::TransactionState(TransactionMode mode,
-                                   bool implicit_transaction)
+                                   bool implicit_transaction, size_t max_bytes,
+                                   size_t max_concurrent_phases)
     : mode_(mode),
       commit_reference_count_{kFutureReferenceIncrement +
                               kCommitReferenceIncrement},
@@ -122,6 +125,8 @@ TransactionState::TransactionState(TransactionMode mode,
       // attached to `future_`, and one for the initial `Transaction` object.
       weak_reference_count_{2},
       total_bytes_{0},
+      max_bytes_(max_bytes),
+      max_concurrent_phases_(std::max(size_t(1), max_concurrent_phases)),
       commit_state_{kOpen},
       implicit_transaction_(implicit_transaction) {
   if (IsAtomic(mode)) {
@@ -154,6 +159,17 @@ TransactionState::OpenPtr TransactionState::AcquireOpenPtr() {
   return TransactionState::OpenPtr(this);
 }
 
+absl::Status TransactionState::CheckMaxBytes() {
+  if (max_bytes_ == 0) return absl::OkStatus();
+  const size_t total_bytes = this->total_bytes();
+  if (total_bytes <= max_bytes_) return absl::OkStatus();
+  auto error = absl::ResourceExhaustedError(tensorstore::StrCat(
+      "Transaction size of ", total_bytes, " bytes exceeds limit of ",
+      max_bytes_, " bytes"));
+  if (atomic()) RequestAbort(error);
+  return error;
+}
+
 void TransactionState::RequestCommit() {
   {
     absl::MutexLock lock(&mutex_);
@@ -215,14 +231,14 @@ void TransactionState::ExecuteAbort() {
   // additional weak reference to `this` while calling `node->Abort()`, because
   // the caller of `ExecuteAbort` must be holding a weak reference to `this`.
   nodes_pending_abort_.store(0, std::memory_order_relaxed);
-  size_t count = 0;
-  for (Node *next, *node = nodes_.ExtremeNode(Tree::kLeft); node; node = next) {
-    // Save `next` node before removing the current node.
-    next = Tree::Traverse(*node, Tree::kRight);
-    nodes_.Remove(*node);
+  multi_phase_nodes_.clear();
+  std::vector<Node*> nodes = std::move(nodes_);
+  nodes_.clear();
+  SortNodes(nodes);
+  const size_t count = nodes.size();
+  for (Node* node : nodes) {
     assert(node->node_commit_state_.fetch_or(Node::kAbort) == Node::kRegister);
     node->Abort();
-    ++count;
   }
   // Increment counter just once for the entire loop.  If some or all nodes call
   // `AbortDone` before the loop ends, the counter will just be "negative"
@@ -247,6 +263,8 @@ void TransactionState::ExecuteCommit() {
   assert(commit_state_ == kCommitStarted);
   // Release the promise callback to break the reference cycle.
   promise_callback_.Unregister();
+  // No more nodes may be created once commit starts.
+  multi_phase_nodes_.clear();
   ExecuteCommitPhase();
 }
 
@@ -261,6 +279,20 @@ void TransactionState::ExecuteCommitPhase() {
   // the current phase.
   commit_start_time_ = absl::Now();
 
+  // Move the nodes of the earliest not-yet-committed phase, and of up to
+  // `max_concurrent_phases_ - 1` subsequent phases, to `phase_nodes_`.  Nodes
+  // from already-committed phases are destroyed once commit completes.
+  SortNodes(nodes_);
+  const size_t current_phase = nodes_.front()->phase();
+  commit_phases_end_ =
+      current_phase +
+      std::min(max_concurrent_phases_, kInvalidPhase - current_phase);
+  auto phase_end = std::find_if(
+      nodes_.begin(), nodes_.end(),
+      [&](Node* node) { return node->phase() >= commit_phases_end_; });
+  phase_nodes_.assign(nodes_.begin(), phase_end);
+  nodes_.erase(nodes_.begin(), phase_end);
+
   // Initialize the `nodes_pending_commit_` count to 1.  It will be incremented
   // for each node in the phase before calling `PrepareForCommit`.  The initial
   // count of 1 serves to indicate that `PrepaerForCommit` has not yet been
@@ -268,21 +300,27 @@ void TransactionState::ExecuteCommitPhase() {
   // the counter is decremented to account for that.
   nodes_pending_commit_.store(1, std::memory_order_relaxed);
 
-  // Start at the left-most node in the tree, which is necessarily associated
-  // with the earliest not-yet-committed phase.  (Nodes from already-committed
-  // phases are destroyed once commit completes.)
-  auto* node = nodes_.ExtremeNode(Tree::kLeft);
-  ContinuePrepareForCommit(node, node->phase());
+  ContinuePrepareForCommit(0);
+}
+
+void TransactionState::SortNodes(std::vector<Node*>& nodes) {
+  std::stable_sort(nodes.begin(), nodes.end(), [](Node* a, Node* b) {
+    return NodeTreeCompare(a->phase_, a->associated_data_, b->phase_,
+                           b->associated_data_) < 0;
+  });
 }
 
-void TransactionState::ContinuePrepareForCommit(Node* node,
-                                                size_t current_phase) {
+void TransactionState::ContinuePrepareForCommit(size_t index) {
   while (true) {
-    if (!node || node->phase() != current_phase) {
+    if (index == phase_nodes_.size()) {
       // End of phase.
       DecrementNodesPendingReadyForCommit();
       break;
     }
+    Node* node = phase_nodes_[index++];
+    // Only accessed by `PrepareDone`, which is not called until
+    // `PrepareForCommit` is called below.
+    next_prepare_index_ = index;
     waiting_for_prepare_done_.store(true, std::memory_order_relaxed);
     nodes_pending_commit_.fetch_add(1, std::memory_order_relaxed);
     assert(node->node_commit_state_.fetch_or(Node::kPrepareForCommit) ==
@@ -293,7 +331,6 @@ void TransactionState::ContinuePrepareForCommit(Node* node,
       // continue the commit process when called.
       return;
     }
-    node = Tree::Traverse(*node, Tree::kRight);
   }
 }
 
@@ -309,8 +346,6 @@ void TransactionState::DecrementNodesPendingReadyForCommit() {
   // call to `node->Commit()` below may cause `node` to be freed, which might
   // otherwise hold the last reference to `this`.
   WeakPtrTraits::increment(this);
-  Node* node = nodes_.ExtremeNode(Tree::kLeft);
-  const size_t current_phase = node->phase();
   // Reuse the `nodes_pending_commit_` counter (which is guaranteed to be 0) to
   // count the number of nodes that still need to call `CommitDone`.  As in
   // `ExecuteAbort`, we increment the counter just once after all the calls to
@@ -318,26 +353,32 @@ void TransactionState::DecrementNodesPendingReadyForCommit() {
   // before the loop ends and our call to `DecrementNodesPendingCommit`, the
   // counter will just wrap around, but is still guaranteed not to equal 0 until
   // the call to `DecrementNodesPendingCommit` below.
-  size_t count = 0;
-  while (true) {
-    // Save next node before removing `node`.
-    Node* next = Tree::Traverse(*node, Tree::kRight);
-    // Nodes destroy themselves when they finish committing; remove them before
-    // commit starts since that avoids the need for locks.
-    nodes_.Remove(*node);
-    ++count;
+  //
+  // Nodes destroy themselves when they finish committing, but `phase_nodes_`
+  // is not modified until the phase completes, which cannot happen before the
+  // call to `DecrementNodesPendingCommit` below.
+  const size_t count = phase_nodes_.size();
+  for (size_t i = 0; i < count; ++i) {
+    Node* node = phase_nodes_[i];
     assert((node->node_commit_state_.fetch_or(Node::kCommit) &
             ~Node::kCommitDone) ==
            (Node::kRegister | Node::kPrepareForCommit | Node::kPrepareDone |
             Node::kReadyForCommit));
     node->Commit();
-    if (!next || next->phase() != current_phase) break;
-    node = next;
   }
   DecrementNodesPendingCommit(-count);
   WeakPtrTraits::decrement(this);
 }
 
+void TransactionState::RecommitNode(Node& node) {
+  node.recommit_ = true;
+  assert(node.node_commit_state_.fetch_or(Node::kPrepareForCommit) ==
+         Node::kRegister);
+  // `PrepareDone` and `ReadyForCommit` do not affect the other nodes being
+  // committed, and `ReadyForCommit` invokes `Commit`.
+  node.PrepareForCommit();
+}
+
 void TransactionState::DecrementNodesPendingCommit(size_t count) {
   if (nodes_pending_commit_.fetch_sub(count, std::memory_order_acq_rel) !=
       count) {
@@ -347,6 +388,7 @@ void TransactionState::DecrementNodesPendingCommit(size_t count) {
     return;
   }
   // Current phase completed.
+  phase_nodes_.clear();
   if (!nodes_.empty()) {
     if (promise_.raw_result().ok()) {
       // Commit next phase.
@@ -431,15 +473,7 @@ absl::Status TransactionState::Node::Register() {
     phase_ = transaction->atomic() ? 0 : transaction->phase_;
   }
   assert(phase_ <= (transaction->atomic() ? 0 : transaction->phase_));
-  transaction->nodes_.FindOrInsert(
-      [associated_data = associated_data_, phase = phase_](Node& node) {
-        // Never return 0, because we allow duplicates.
-        return NodeTreeCompare(phase, associated_data, node.phase_,
-                               node.associated_data_) < 0
-                   ? absl::weak_ordering::less
-                   : absl::weak_ordering::greater;
-      },
-      [&] { return this; });
+  transaction->nodes_.push_back(this);
   intrusive_ptr_increment(this);
   assert(node_commit_state_.fetch_or(kRegister) == 0);
   return absl::OkStatus();
@@ -458,22 +492,17 @@ TransactionState::GetOrCreateMultiPhaseNode(
     default:
       ABSL_UNREACHABLE();  // COV_NF_LINE
   }
-  return OpenTransactionNodePtr<Node>(
-      nodes_
-          .FindOrInsert(
-              [associated_data](Node& node) {
-                return NodeTreeCompare(0, associated_data, node.phase_,
-                                       node.associated_data_);
-              },
-              [&] {
-                Node* node = make_node();
-                node->SetTransaction(*this);
-                node->phase_ = 0;
-                intrusive_ptr_increment(node);
-                assert(node->node_commit_state_.fetch_or(Node::kRegister) == 0);
-                return node;
-              })
-          .first);
+  auto [it, inserted] = multi_phase_nodes_.try_emplace(associated_data);
+  if (inserted) {
+    Node* node = make_node();
+    node->SetTransaction(*this);
+    node->phase_ = 0;
+    intrusive_ptr_increment(node);
+    assert(node->node_commit_state_.fetch_or(Node::kRegister) == 0);
+    nodes_.push_back(node);
+    it->second = node;
+  }
+  return OpenTransactionNodePtr<Node>(it->second);
 }
 
 void TransactionState::NoMoreWeakReferences() { delete this; }
@@ -506,30 +535,40 @@ void TransactionState::NoMoreOpenReferences() {
   }
 }
 
-TransactionState::~TransactionState() = default;
+TransactionState::~TransactionState() {
+  internal::UpdateMemoryUsage(internal::MemoryCategory::kTransaction,
+                              -static_cast<int64_t>(total_bytes()));
+}
 
 void TransactionState::Node::PrepareDone() {
   assert((node_commit_state_.fetch_or(kPrepareDone) & ~kReadyForCommit) ==
          (Node::kRegister | kPrepareForCommit));
+  if (recommit_) return;
   auto& transaction = *this->transaction();
   if (transaction.waiting_for_prepare_done_.exchange(
           false, std::memory_order_acq_rel)) {
     // Caller of `PrepareForCommit` will continue the commit.
     return;
   }
-  transaction.ContinuePrepareForCommit(Tree::Traverse(*this, Tree::kRight),
-                                       this->phase());
+  transaction.ContinuePrepareForCommit(transaction.next_prepare_index_);
 }
 
 void TransactionState::Node::ReadyForCommit() {
   assert((node_commit_state_.fetch_or(kReadyForCommit) & ~kPrepareDone) ==
          (kRegister | kPrepareForCommit));
+  if (recommit_) {
+    assert((node_commit_state_.fetch_or(kCommit) & ~kCommitDone) ==
+           (kRegister | kPrepareForCommit | kPrepareDone | kReadyForCommit));
+    this->Commit();
+    return;
+  }
   this->transaction()->DecrementNodesPendingReadyForCommit();
 }
 
 void TransactionState::Node::CommitDone(size_t next_phase) {
   assert((node_commit_state_.fetch_or(kCommitDone) & ~kCommit) ==
          (kRegister | kPrepareForCommit | kPrepareDone | kReadyForCommit));
+  recommit_ = false;
   if (next_phase) {
 #ifndef NDEBUG
     node_commit_state_.store(kRegister);
@@ -538,14 +577,20 @@ void TransactionState::Node::CommitDone(size_t next_phase) {
     assert(!transaction.atomic());
     assert(next_phase > this->phase_);
     phase_ = next_phase;
-    // Node was previously removed from the `transaction.nodes_` tree by
-    // `PrepareDone`.
-    transaction.nodes_.FindOrInsert(
-        [next_phase, associated_data = associated_data_](Node& node) {
-          return NodeTreeCompare(next_phase, associated_data, node.phase_,
-                                 node.associated_data_);
-        },
-        [&] { return this; });
+    bool recommit;
+    {
+      // Node was previously moved from `transaction.nodes_` to
+      // `transaction.phase_nodes_` when the commit of the current phase
+      // started.  Other nodes of the phase may call `CommitDone` concurrently.
+      absl::MutexLock lock(&transaction.mutex_);
+      recommit = next_phase < transaction.commit_phases_end_;
+      if (!recommit) transaction.nodes_.push_back(this);
+    }
+    if (recommit) {
+      // The next phase is already being committed.
+      transaction.RecommitNode(*this);
+      return;
+    }
   }
   this->transaction()->DecrementNodesPendingCommit(1);
   if (!next_phase) {
@@ -561,8 +606,14 @@ void TransactionState::Node::AbortDone() {
   intrusive_ptr_decrement(this);
 }
 
+bool TransactionState::Node::ConcurrentPhaseFailed() const {
+  return recommit_ &&
+         transaction_->commit_error_.load(std::memory_order_acquire);
+}
+
 void TransactionState::Node::SetError(const absl::Status& error) {
   assert(!error.ok());
+  transaction()->commit_error_.store(true, std::memory_order_release);
   auto& promise = transaction()->promise_;
   if (promise.null()) return;
   SetDeferredResult(promise, error);
@@ -611,11 +662,13 @@ void Transaction::Barrier() const {
   state->Barrier();
 }
 
-Transaction::Transaction(TransactionMode mode) {
+Transaction::Transaction(TransactionMode mode, size_t max_bytes,
+                         size_t max_concurrent_phases) {
   if (mode == TransactionMode::no_transaction_mode) return;
-  state_.reset(new internal::TransactionState(mode,
-                                              /*implicit_transaction=*/false),
-               internal::adopt_object_ref);
+  state_.reset(
+      new internal::TransactionState(mode, /*implicit_transaction=*/false,
+                                     max_bytes, max_concurrent_phases),
+      internal::adopt_object_ref);
 }
 
 std::ostream& operator<<(std::ostream& os, TransactionMode mode) {
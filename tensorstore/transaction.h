@@ -162,8 +162,28 @@ class Transaction {
 
   /// Creates a new transaction with the specified mode.
   ///
+  /// If `max_bytes` is non-zero, it specifies a memory budget: once
+  /// `total_bytes()` exceeds `max_bytes`, subsequent write operations using the
+  /// transaction fail with an error of `absl::StatusCode::kResourceExhausted`
+  /// rather than adding to the memory held until commit.  A non-atomic
+  /// transaction remains open and may still be committed, after which the
+  /// remaining writes may be performed in a new transaction.  An atomic
+  /// transaction cannot be committed in parts, and is therefore aborted.
+  ///
+  /// By default, the phases of a non-atomic transaction separated by calls to
+  /// `Barrier` are committed one at a time.  If `max_concurrent_phases` is
+  /// greater than 1, up to `max_concurrent_phases` consecutive phases are
+  /// committed concurrently.  The writes to each key-value store are still
+  /// committed in phase order, and are not committed if the commit of a prior
+  /// phase to the same store fails, but a barrier no longer orders the writes
+  /// to independent key-value stores.  For a transaction that writes to many
+  /// arrays, each of which uses a barrier internally (e.g. when opened with
+  /// `OpenMode::delete_existing`), this reduces the commit latency to roughly
+  /// that of the slowest store.
+  ///
   /// \id mode
-  explicit Transaction(TransactionMode mode);
+  explicit Transaction(TransactionMode mode, size_t max_bytes = 0,
+                       size_t max_concurrent_phases = 1);
 
   /// Returns the transaction mode.
   TransactionMode mode() const {
@@ -227,6 +247,9 @@ class Transaction {
   /// If `atomic()`, this has no effect since all writes are committed
   /// atomically.
   ///
+  /// If `max_concurrent_phases() > 1`, only writes to the same key-value store
+  /// are ordered by the barrier.
+  ///
   /// For example::
   ///
   ///     auto transaction = tensorstore::Transaction(tensorstore::isolated);
@@ -257,6 +280,20 @@ class Transaction {
     return 0;
   }
 
+  /// Returns the memory budget specified when the transaction was created, or
+  /// `0` if there is no limit.
+  size_t max_bytes() const {
+    if (state_) return state_->max_bytes();
+    return 0;
+  }
+
+  /// Returns the maximum number of phases committed concurrently, as
+  /// specified when the transaction was created.
+  size_t max_concurrent_phases() const {
+    if (state_) return state_->max_concurrent_phases();
+    return 1;
+  }
+
   /// Checks if `a` and `b` refer to the same transaction state, or are both
   /// null.
   friend bool operator==(const Transaction& a, const Transaction& b) {
@@ -315,6 +352,19 @@ inline Result<OpenTransactionPtr> AcquireOpenTransactionPtrOrError(
   return OpenTransactionPtr{};
 }
 
+/// Same as `AcquireOpenTransactionPtrOrError`, but for an operation that adds
+/// to the memory held by the transaction, such as a write.  Fails if the
+/// transaction exceeds its memory budget, as checked by
+/// `TransactionState::CheckMaxBytes`.
+inline Result<OpenTransactionPtr> AcquireOpenTransactionPtrForWriteOrError(
+    const Transaction& t) {
+  if (auto* state = TransactionState::get(t)) {
+    if (auto status = state->CheckMaxBytes(); !status.ok()) return status;
+    return state->AcquireOpenPtrOrError();
+  }
+  return OpenTransactionPtr{};
+}
+
 inline Transaction TransactionState::ToTransaction(OpenPtr transaction) {
   if (transaction) {
     BlockCommitPtrTraits::decrement(transaction.get());
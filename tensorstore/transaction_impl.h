@@ -30,14 +30,16 @@
 #include <functional>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/compare.h"
 #include "tensorstore/internal/compare.h"
-#include "tensorstore/internal/container/intrusive_red_black_tree.h"
+#include "tensorstore/internal/estimate_heap_usage/memory_accounting.h"
 #include "tensorstore/internal/intrusive_ptr.h"
 #include "tensorstore/internal/mutex.h"
 #include "tensorstore/util/future.h"
@@ -381,8 +383,7 @@ class TransactionState {
 
   /// Smart pointer that prevents the transaction from being committed.
   ///
-  class Node : public AtomicReferenceCount<Node>,
-               public intrusive_red_black_tree::NodeBase<Node> {
+  class Node : public AtomicReferenceCount<Node> {
    public:
     Node(void* associated_data);
 
@@ -434,6 +435,16 @@ class TransactionState {
     /// invoked again when that phase is committed.
     void CommitDone(size_t next_phase = 0);
 
+    /// Returns `true` if `Commit` was invoked for a subsequent phase of a
+    /// multi-phase node that is committed concurrently with earlier phases
+    /// (see `TransactionState::max_concurrent_phases`), and an error has
+    /// already occurred during the commit.
+    ///
+    /// In that case, the node must not perform the writes of the phase, since
+    /// they may depend on writes of its earlier phases that failed; it should
+    /// instead fail the writes and call `CommitDone`.
+    bool ConcurrentPhaseFailed() const;
+
    private:
     /// Called when the transaction is aborted (once all `OpenTransactionPtr`
     /// and `OpenTransactionNodePtr` references have been released).  The
@@ -452,6 +463,8 @@ class TransactionState {
     void UpdateSizeInBytes(size_t new_minus_old) {
       transaction_->total_bytes_.fetch_add(new_minus_old,
                                            std::memory_order_relaxed);
+      internal::UpdateMemoryUsage(internal::MemoryCategory::kTransaction,
+                                  static_cast<int64_t>(new_minus_old));
     }
 
     /// Returns a string description of the node,
@@ -533,6 +546,10 @@ class TransactionState {
     /// `transaction_->atomic()`, will be set to 0.
     size_t phase_ = kInvalidPhase;
 
+    /// Set to `true` by `TransactionState::RecommitNode` while a subsequent
+    /// phase of the node is committed concurrently with earlier phases.
+    bool recommit_ = false;
+
     /// The associated data of this node.  In the case of
     /// `AsyncCache::TransactionNode`, this is a pointer to the
     /// `AsyncCache::Entry`.
@@ -540,7 +557,14 @@ class TransactionState {
   };
 
   /// Constructs a new transaction state.
-  explicit TransactionState(TransactionMode mode, bool implicit_transaction);
+  ///
+  /// \param max_bytes Memory budget enforced by `CheckMaxBytes`, or `0` for no
+  ///     limit.
+  /// \param max_concurrent_phases Maximum number of phases committed
+  ///     concurrently.
+  explicit TransactionState(TransactionMode mode, bool implicit_transaction,
+                            size_t max_bytes = 0,
+                            size_t max_concurrent_phases = 1);
 
   /// Returns the future associated with this transaction.
   ///
@@ -594,6 +618,33 @@ class TransactionState {
     return total_bytes_.load(std::memory_order_relaxed);
   }
 
+  /// Returns the memory budget of the transaction, or `0` if there is no
+  /// limit.
+  size_t max_bytes() const { return max_bytes_; }
+
+  /// Returns the maximum number of phases committed concurrently.
+  ///
+  /// If greater than 1, the nodes of up to `max_concurrent_phases()`
+  /// consecutive phases are committed together, rather than one phase at a
+  /// time.  Multi-phase nodes, such as the node for a given `kvstore::Driver`,
+  /// still commit their own phases in order: `Commit` is invoked again, via
+  /// `RecommitNode`, as soon as the node finishes its prior phase.  Therefore,
+  /// a `Barrier` still orders the writes to each `kvstore::Driver`, but writes
+  /// to independent drivers after the barrier may be committed before writes
+  /// to other drivers before the barrier.
+  size_t max_concurrent_phases() const { return max_concurrent_phases_; }
+
+  /// Checks that `total_bytes()` does not exceed `max_bytes()`.
+  ///
+  /// This is called before starting an operation that may add to the memory
+  /// occupied by the transaction.  Since the nodes of an atomic transaction
+  /// cannot be committed separately, an atomic transaction that exceeds its
+  /// budget is also aborted with the returned error.  A non-atomic transaction
+  /// remains open, and may still be committed.
+  ///
+  /// \error `absl::StatusCode::kResourceExhausted` if the budget is exceeded.
+  absl::Status CheckMaxBytes();
+
   /// Requests that the transaction be committed.  Has no effect if commit or
   /// abort has already been requested.
   void RequestCommit();
@@ -683,25 +734,29 @@ class TransactionState {
   /// \pre `commit_state_ == kCommitStarted`
   void ExecuteCommit();
 
-  /// Begins the commit of the next not-yet-committed phase.
+  /// Begins the commit of the next not-yet-committed phase, along with up to
+  /// `max_concurrent_phases_ - 1` subsequent phases.
   ///
   /// This is called initially by `ExecuteCommit` and is then called again after
   /// each phase commits successfully if there are still remaining phases.
   ///
-  /// This invokes `PrepareForCommit` on each node in the phase, sequentially.
+  /// This invokes `PrepareForCommit` on each node in the phases, sequentially.
   void ExecuteCommitPhase();
 
   /// Asynchronously continues the sequential invocation of `PrepareForCommit`
   /// on each node in the phase started by `ExecuteCommitPhase`.
   ///
-  /// If `node` is `nullptr` or `node->phase() != current_phase`, then all nodes
-  /// in the phase have already been handled, and the commit process will
-  /// continue only once all nodes in the phase have called `ReadyForCommit`.
+  /// If `index == phase_nodes_.size()`, then all nodes in the phase have
+  /// already been handled, and the commit process will continue only once all
+  /// nodes in the phase have called `ReadyForCommit`.
   ///
-  /// \param node The next node for which `PrepareForCommit` has not yet been
-  ///     called.
-  /// \param current_phase The current phase being committed.
-  void ContinuePrepareForCommit(Node* node, size_t current_phase);
+  /// \param index The index in `phase_nodes_` of the next node for which
+  ///     `PrepareForCommit` has not yet been called.
+  void ContinuePrepareForCommit(size_t index);
+
+  /// Sorts `nodes` by `phase` and then `associated_data_`.  Nodes that compare
+  /// equal retain their registration order.
+  static void SortNodes(std::vector<Node*>& nodes);
 
   /// Called when `ContinuePrepareForCommit` reaches the end of the phase, and
   /// also by `Node::ReadyForCommit`.  Decrements the `nodes_pending_commit_`
@@ -711,6 +766,14 @@ class TransactionState {
   /// the phase.
   void DecrementNodesPendingReadyForCommit();
 
+  /// Invokes `PrepareForCommit` and then `Commit` on a multi-phase `node` for a
+  /// subsequent phase that is committed concurrently with its prior phase,
+  /// i.e. when `node.CommitDone(next_phase)` is called with `next_phase <
+  /// commit_phases_end_`.
+  ///
+  /// The node remains counted in `nodes_pending_commit_`.
+  void RecommitNode(Node& node);
+
   /// Called when `DecrementNodesPendingReadyForCommit` finishes calling
   /// `Commit` on every node in the phase, and also by `Node::CommitDone`.
   /// Decrements the `nodes_pending_commit_` counter.
@@ -766,15 +829,41 @@ class TransactionState {
   absl::Mutex mutex_;
   TransactionMode mode_;
 
-  /// Red-black tree of nodes in the transaction.
+  /// Nodes in the transaction that have not yet been committed or aborted, in
+  /// registration order.
   ///
-  /// Nodes are ordered by `phase` and then `associated_data_`.  This provides a
+  /// Registration just appends to this vector, which keeps the cost of
+  /// registering a node constant even for transactions with millions of nodes.
+  /// The nodes are sorted by `SortNodes`, by `phase` and then
+  /// `associated_data_`, when the commit of a phase starts.  This provides a
   /// canonical order in which locks are acquired, in order to avoid deadlock.
   /// For example, `AsyncCache` only permits writeback of a single transaction
   /// at a time for a given `AsyncCache::Entry`, and using inconsistent orders
   /// could result in deadlock.
-  using Tree = intrusive_red_black_tree::Tree<Node, Node>;
-  Tree nodes_;
+  ///
+  /// Protected by `mutex_` until commit starts.  After commit starts, nodes
+  /// are only added by `Node::CommitDone`, while holding `mutex_`.
+  std::vector<Node*> nodes_;
+
+  /// Nodes of the phases currently being committed, in sorted order.  Only
+  /// valid when `commit_started() == true`.
+  std::vector<Node*> phase_nodes_;
+
+  /// Phases less than this are currently being committed.  Set by
+  /// `ExecuteCommitPhase`, and read by `Node::CommitDone` while holding
+  /// `mutex_`.
+  size_t commit_phases_end_ = 0;
+
+  /// Set to `true` once an error is recorded by `Node::SetError`.
+  std::atomic<bool> commit_error_{false};
+
+  /// Index in `phase_nodes_` of the node after the one on which
+  /// `PrepareForCommit` was most recently called.
+  size_t next_prepare_index_ = 0;
+
+  /// Nodes created by `GetOrCreateMultiPhaseNode`, indexed by associated data.
+  /// Protected by `mutex_`, and cleared when commit starts.
+  absl::flat_hash_map<void*, Node*> multi_phase_nodes_;
 
 #ifndef TENSORSTORE_INTERNAL_TRANSACTION_DEBUG_UNIONS
   union {
@@ -863,6 +952,12 @@ class TransactionState {
   /// Estimated bytes of memory occupied by transaction.
   std::atomic<size_t> total_bytes_;
 
+  /// Limit on `total_bytes_` enforced by `CheckMaxBytes`, or `0` for no limit.
+  size_t max_bytes_;
+
+  /// Maximum number of phases committed concurrently, at least 1.
+  size_t max_concurrent_phases_;
+
   /// Commit state values, indicating the current state of the transaction.
   enum CommitState {
     /// Additional reads or writes may be performed using the transaction.  No
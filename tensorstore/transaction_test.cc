@@ -25,6 +25,7 @@ using ::tensorstore::MatchesStatus;
 using ::tensorstore::no_transaction;
 using ::tensorstore::Transaction;
 using ::tensorstore::TransactionMode;
+using ::tensorstore::internal::AcquireOpenTransactionPtrForWriteOrError;
 using ::tensorstore::internal::AcquireOpenTransactionPtrOrError;
 using ::tensorstore::internal::OpenTransactionNodePtr;
 using ::tensorstore::internal::TransactionState;
@@ -217,6 +218,68 @@ TEST(TransactionTest, SingleNodeCommit) {
   TENSORSTORE_EXPECT_OK(future);
 }
 
+TEST(TransactionTest, MaxBytesIsolated) {
+  NodeLog log;
+  auto txn = Transaction(tensorstore::isolated, /*max_bytes=*/100);
+  EXPECT_EQ(100, txn.max_bytes());
+  auto future = txn.future();
+  WeakTransactionNodePtr<TestNode> node(new TestNode(&log, 1));
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto open_ptr, AcquireOpenTransactionPtrForWriteOrError(txn));
+    node->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node->Register());
+    node->UpdateSizeInBytes(100);
+  }
+  TENSORSTORE_EXPECT_OK(AcquireOpenTransactionPtrForWriteOrError(txn));
+  node->UpdateSizeInBytes(1);
+  EXPECT_THAT(AcquireOpenTransactionPtrForWriteOrError(txn),
+              MatchesStatus(absl::StatusCode::kResourceExhausted,
+                            "Transaction size of 101 bytes exceeds limit of "
+                            "100 bytes"));
+  // Operations that do not add to the transaction are still permitted, and
+  // the transaction can still be committed.
+  TENSORSTORE_EXPECT_OK(AcquireOpenTransactionPtrOrError(txn));
+  EXPECT_FALSE(txn.aborted());
+  txn.CommitAsync().IgnoreFuture();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:1"));
+  node->PrepareDone();
+  node->ReadyForCommit();
+  node->CommitDone();
+  ASSERT_TRUE(future.ready());
+  TENSORSTORE_EXPECT_OK(future);
+}
+
+TEST(TransactionTest, MaxBytesAtomic) {
+  NodeLog log;
+  auto txn = Transaction(tensorstore::atomic_isolated, /*max_bytes=*/100);
+  auto future = txn.future();
+  WeakTransactionNodePtr<TestNode> node(new TestNode(&log, 1));
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+        auto open_ptr, AcquireOpenTransactionPtrForWriteOrError(txn));
+    node->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node->Register());
+    node->UpdateSizeInBytes(101);
+  }
+  EXPECT_THAT(AcquireOpenTransactionPtrForWriteOrError(txn),
+              MatchesStatus(absl::StatusCode::kResourceExhausted));
+  // An atomic transaction cannot be committed in parts, and is aborted.
+  EXPECT_TRUE(txn.aborted());
+  EXPECT_THAT(log, ::testing::ElementsAre("abort:1"));
+  node->AbortDone();
+  ASSERT_TRUE(future.ready());
+  EXPECT_THAT(future.result(),
+              MatchesStatus(absl::StatusCode::kResourceExhausted));
+}
+
+TEST(TransactionTest, NoMaxBytes) {
+  auto txn = Transaction(tensorstore::atomic_isolated);
+  EXPECT_EQ(0, txn.max_bytes());
+  TENSORSTORE_EXPECT_OK(AcquireOpenTransactionPtrForWriteOrError(txn));
+  EXPECT_EQ(0, Transaction(no_transaction).max_bytes());
+}
+
 TEST(TransactionTest, CommitViaForcingFuture) {
   NodeLog log;
   tensorstore::Future<const void> future;
@@ -625,6 +688,132 @@ TEST(TransactionTest, MultiPhaseNode) {
   TENSORSTORE_EXPECT_OK(txn.future());
 }
 
+TEST(TransactionTest, ConcurrentPhases) {
+  NodeLog log;
+  auto txn = Transaction(tensorstore::isolated, /*max_bytes=*/0,
+                         /*max_concurrent_phases=*/3);
+  EXPECT_EQ(3, txn.max_concurrent_phases());
+  WeakTransactionNodePtr<TestNode> node1(new TestNode(&log, 1));
+  WeakTransactionNodePtr<TestNode> node2(new TestNode(&log, 2));
+  WeakTransactionNodePtr<TestNode> node3(new TestNode(&log, 3));
+  WeakTransactionNodePtr<TestNode> node4(new TestNode(&log, 4));
+  WeakTransactionNodePtr<TestNode> node5;
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto open_ptr,
+                                     AcquireOpenTransactionPtrOrError(txn));
+    {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto open_node, open_ptr->GetOrCreateMultiPhaseNode(
+                              /*associated_data=*/reinterpret_cast<void*>(5),
+                              [&] { return new TestNode(&log, 5); }));
+      node5.reset(static_cast<TestNode*>(open_node.get()));
+    }
+    node1->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node1->Register());
+    open_ptr->Barrier();
+    node2->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node2->Register());
+    open_ptr->Barrier();
+    node3->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node3->Register());
+    open_ptr->Barrier();
+    node4->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node4->Register());
+  }
+  txn.CommitAsync().IgnoreFuture();
+  // Phases 0, 1, and 2 are committed together.
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:1"));
+  node1->PrepareDone();
+  node1->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:1", "prepare:5"));
+  node5->PrepareDone();
+  node5->ReadyForCommit();
+  EXPECT_THAT(log,
+              ::testing::ElementsAre("prepare:1", "prepare:5", "prepare:2"));
+  node2->PrepareDone();
+  node2->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:1", "prepare:5", "prepare:2",
+                                          "prepare:3"));
+  log.clear();
+  node3->PrepareDone();
+  node3->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("commit:1", "commit:5", "commit:2",
+                                          "commit:3"));
+  log.clear();
+  node2->CommitDone();
+  node3->CommitDone();
+  EXPECT_THAT(log, ::testing::ElementsAre());
+  // The next phase of the multi-phase node is committed immediately, since
+  // it is among the phases already being committed.
+  node5->CommitDone(1);
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:5"));
+  node5->PrepareDone();
+  node5->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:5", "commit:5"));
+  EXPECT_FALSE(node5->ConcurrentPhaseFailed());
+  log.clear();
+  node5->CommitDone(3);
+  EXPECT_THAT(log, ::testing::ElementsAre());
+  node1->CommitDone();
+  // Phase 3 is committed once phases 0, 1, and 2 have been committed.
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:4"));
+  node4->PrepareDone();
+  node4->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:4", "prepare:5"));
+  log.clear();
+  node5->PrepareDone();
+  node5->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("commit:4", "commit:5"));
+  EXPECT_FALSE(node5->ConcurrentPhaseFailed());
+  node4->CommitDone();
+  node5->CommitDone();
+  ASSERT_TRUE(txn.future().ready());
+  TENSORSTORE_EXPECT_OK(txn.future());
+}
+
+TEST(TransactionTest, ConcurrentPhasesError) {
+  NodeLog log;
+  auto txn = Transaction(tensorstore::isolated, /*max_bytes=*/0,
+                         /*max_concurrent_phases=*/2);
+  WeakTransactionNodePtr<TestNode> node1(new TestNode(&log, 1));
+  WeakTransactionNodePtr<TestNode> node5;
+  {
+    TENSORSTORE_ASSERT_OK_AND_ASSIGN(auto open_ptr,
+                                     AcquireOpenTransactionPtrOrError(txn));
+    {
+      TENSORSTORE_ASSERT_OK_AND_ASSIGN(
+          auto open_node, open_ptr->GetOrCreateMultiPhaseNode(
+                              /*associated_data=*/reinterpret_cast<void*>(5),
+                              [&] { return new TestNode(&log, 5); }));
+      node5.reset(static_cast<TestNode*>(open_node.get()));
+    }
+    open_ptr->Barrier();
+    node1->SetTransaction(*open_ptr);
+    TENSORSTORE_EXPECT_OK(node1->Register());
+  }
+  txn.CommitAsync().IgnoreFuture();
+  node5->PrepareDone();
+  node5->ReadyForCommit();
+  node1->PrepareDone();
+  node1->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:5", "prepare:1", "commit:5",
+                                          "commit:1"));
+  log.clear();
+  node5->SetError(absl::UnknownError("failed"));
+  node5->CommitDone(1);
+  node5->PrepareDone();
+  node5->ReadyForCommit();
+  EXPECT_THAT(log, ::testing::ElementsAre("prepare:5", "commit:5"));
+  // The node must not perform the writes of phase 1.
+  EXPECT_TRUE(node5->ConcurrentPhaseFailed());
+  node5->CommitDone();
+  EXPECT_FALSE(txn.future().ready());
+  node1->CommitDone();
+  ASSERT_TRUE(txn.future().ready());
+  EXPECT_THAT(txn.future().result(),
+              MatchesStatus(absl::StatusCode::kUnknown, "failed"));
+}
+
 struct SynchronousTestNode : public TestNode {
   using TestNode::TestNode;
   void Commit() override {
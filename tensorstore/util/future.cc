@@ -19,10 +19,12 @@
 
 #include <atomic>
 #include <cassert>
+#include <new>
 #include <thread>  // NOLINT
 #include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/base/config.h"
 #include "absl/base/const_init.h"
 #include "absl/base/no_destructor.h"
 #include "absl/base/optimization.h"
@@ -72,6 +74,93 @@ absl::Mutex* GetMutex(FutureStateBase* ptr) {
   return &mutexes[absl::HashOf(ptr) % kNumMutexes].mutex;
 }
 
+namespace {
+
+#if defined(ABSL_HAVE_ADDRESS_SANITIZER) || \
+    defined(ABSL_HAVE_MEMORY_SANITIZER) || defined(ABSL_HAVE_THREAD_SANITIZER)
+// Pooling would hide use-after-free errors and races from the sanitizers.
+constexpr bool kPoolingEnabled = false;
+#else
+constexpr bool kPoolingEnabled = true;
+#endif
+
+// Pooled size classes are the multiples of `kPoolGranularity` up to
+// `kMaxPooledSize`, which covers `FutureState` objects for typical value types
+// as well as callbacks and links with small function objects.
+constexpr size_t kPoolGranularity = 16;
+constexpr size_t kMaxPooledSize = 512;
+constexpr size_t kNumSizeClasses = kMaxPooledSize / kPoolGranularity;
+
+// Maximum number of free blocks retained by each thread per size class.
+// Blocks beyond this limit are returned to the general-purpose allocator,
+// which bounds the memory held by threads that free many more objects than
+// they allocate, as is common for executor threads running callbacks.
+constexpr size_t kMaxFreeBlocksPerSizeClass = 128;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct ThreadCache {
+  struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t size = 0;
+  };
+
+  ~ThreadCache() {
+    // Objects freed by subsequent thread-local destructors bypass the cache.
+    destroyed = true;
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      for (FreeBlock* block = free_lists[i].head; block;) {
+        FreeBlock* next = block->next;
+        ::operator delete(block, (i + 1) * kPoolGranularity);
+        block = next;
+      }
+      free_lists[i] = {};
+    }
+  }
+
+  FreeList free_lists[kNumSizeClasses];
+  bool destroyed = false;
+};
+
+thread_local ThreadCache thread_cache;
+
+}  // namespace
+
+void* AllocatePooled(size_t size) {
+  if (!kPoolingEnabled || size == 0 || size > kMaxPooledSize) {
+    return ::operator new(size);
+  }
+  const size_t size_class = (size - 1) / kPoolGranularity;
+  auto& cache = thread_cache;
+  auto& free_list = cache.free_lists[size_class];
+  if (FreeBlock* block = free_list.head) {
+    free_list.head = block->next;
+    --free_list.size;
+    return block;
+  }
+  return ::operator new((size_class + 1) * kPoolGranularity);
+}
+
+void FreePooled(void* ptr, size_t size) noexcept {
+  if (!kPoolingEnabled || size == 0 || size > kMaxPooledSize) {
+    ::operator delete(ptr, size);
+    return;
+  }
+  const size_t size_class = (size - 1) / kPoolGranularity;
+  auto& cache = thread_cache;
+  auto& free_list = cache.free_lists[size_class];
+  if (cache.destroyed || free_list.size == kMaxFreeBlocksPerSizeClass) {
+    ::operator delete(ptr, (size_class + 1) * kPoolGranularity);
+    return;
+  }
+  auto* block = static_cast<FreeBlock*>(ptr);
+  block->next = free_list.head;
+  free_list.head = block;
+  ++free_list.size;
+}
+
 using CallbackListAccessor =
     internal::intrusive_linked_list::MemberAccessor<CallbackListNode>;
 namespace {
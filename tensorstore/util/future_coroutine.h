@@ -0,0 +1,168 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
+#define TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
+
+/// \file
+///
+/// C++20 coroutine support for `Future`.
+///
+/// When compiled with coroutine support, a function returning `Future<T>` may
+/// be written as a coroutine, and may use `co_await` on another `Future<U>` to
+/// obtain its `Result<U>`:
+///
+///     Future<int> AddOne(Future<int> x) {
+///       Result<int> value = co_await x;
+///       if (!value.ok()) co_return value.status();
+///       co_return *value + 1;
+///     }
+///
+/// Note that `TENSORSTORE_RETURN_IF_ERROR` and `TENSORSTORE_ASSIGN_OR_RETURN`
+/// cannot be used within a coroutine, since they use `return` rather than
+/// `co_return`.
+///
+/// The coroutine starts executing immediately when called, and the returned
+/// future becomes ready when it completes with `co_return`.  The value of
+/// `co_return` may be anything convertible to `Result<T>`; for a
+/// `Future<void>`, use `co_return absl::OkStatus()`.
+///
+/// Awaiting a future that is already ready does not suspend the coroutine.
+/// Otherwise, the coroutine is resumed in the thread that makes the awaited
+/// future ready, exactly like a callback registered with
+/// `Future::ExecuteWhenReady`.  To continue on a particular executor instead,
+/// use `co_await ResumeOn(executor)`.
+///
+/// Each coroutine call allocates the coroutine frame and the shared
+/// promise/future state, and each suspending `co_await` allocates only the
+/// ready callback, rather than the additional promise/future state allocated
+/// for each continuation of a `MapFuture` chain.
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && \
+    __has_include(<coroutine>)
+
+#define TENSORSTORE_HAVE_FUTURE_COROUTINES 1
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+
+namespace tensorstore {
+namespace internal_future {
+
+/// Awaiter returned by `operator co_await(Future<T>)`.
+template <typename T>
+class FutureAwaiter {
+ public:
+  explicit FutureAwaiter(Future<T> future) : future_(std::move(future)) {}
+
+  bool await_ready() const { return future_.ready(); }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // The callback may run, and resume the coroutine, before
+    // `ExecuteWhenReady` returns, so `future_` must not be accessed by
+    // `ExecuteWhenReady` itself.
+    Future<T> future = std::move(future_);
+    std::move(future).ExecuteWhenReady(
+        [this, handle](ReadyFuture<T> ready) {
+          future_ = std::move(ready);
+          handle.resume();
+        });
+  }
+
+  typename Future<T>::result_type await_resume() { return future_.result(); }
+
+ private:
+  Future<T> future_;
+};
+
+/// Awaiter returned by `ResumeOn`.
+class ResumeOnAwaiter {
+ public:
+  explicit ResumeOnAwaiter(Executor executor)
+      : executor_(std::move(executor)) {}
+
+  bool await_ready() const { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    executor_([handle] { handle.resume(); });
+  }
+
+  void await_resume() {}
+
+ private:
+  Executor executor_;
+};
+
+/// Coroutine promise type for coroutines returning `Future<T>`.
+template <typename T>
+class FutureCoroutinePromise {
+ public:
+  FutureCoroutinePromise() {
+    auto pair = PromiseFuturePair<std::remove_const_t<T>>::Make();
+    promise_ = std::move(pair.promise);
+    future_ = std::move(pair.future);
+  }
+
+  Future<T> get_return_object() { return std::move(future_); }
+
+  std::suspend_never initial_suspend() noexcept { return {}; }
+  std::suspend_never final_suspend() noexcept { return {}; }
+
+  template <typename U>
+  void return_value(U&& value) {
+    promise_.SetResult(std::forward<U>(value));
+  }
+
+  // Exceptions are not used by TensorStore.
+  void unhandled_exception() { std::terminate(); }
+
+ private:
+  Promise<std::remove_const_t<T>> promise_;
+  Future<T> future_;
+};
+
+}  // namespace internal_future
+
+/// Awaits `future`, returning a copy of its result.
+///
+/// \relates Future
+template <typename T>
+internal_future::FutureAwaiter<T> operator co_await(Future<T> future) {
+  return internal_future::FutureAwaiter<T>(std::move(future));
+}
+
+/// Returns an awaitable that resumes the awaiting coroutine using `executor`.
+///
+/// \relates Future
+inline internal_future::ResumeOnAwaiter ResumeOn(Executor executor) {
+  return internal_future::ResumeOnAwaiter(std::move(executor));
+}
+
+}  // namespace tensorstore
+
+template <typename T, typename... Arg>
+struct std::coroutine_traits<tensorstore::Future<T>, Arg...> {
+  using promise_type = tensorstore::internal_future::FutureCoroutinePromise<T>;
+};
+
+#endif  // defined(__cpp_impl_coroutine) ...
+
+#endif  // TENSORSTORE_UTIL_FUTURE_COROUTINE_H_
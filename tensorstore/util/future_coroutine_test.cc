@@ -0,0 +1,177 @@
+// Copyright 2024 The TensorStore Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tensorstore/util/future_coroutine.h"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
+#include "tensorstore/util/result.h"
+#include "tensorstore/util/status_testutil.h"
+
+namespace {
+
+#ifdef TENSORSTORE_HAVE_FUTURE_COROUTINES
+
+using ::tensorstore::Executor;
+using ::tensorstore::Future;
+using ::tensorstore::InlineExecutor;
+using ::tensorstore::MakeReadyFuture;
+using ::tensorstore::MatchesStatus;
+using ::tensorstore::PromiseFuturePair;
+using ::tensorstore::Result;
+using ::tensorstore::ResumeOn;
+
+Future<int> AddOne(Future<int> x) {
+  Result<int> value = co_await x;
+  if (!value.ok()) co_return value.status();
+  co_return *value + 1;
+}
+
+Future<int> Sum(std::vector<Future<int>> futures) {
+  int sum = 0;
+  for (auto& future : futures) {
+    Result<int> value = co_await future;
+    if (!value.ok()) co_return value.status();
+    sum += *value;
+  }
+  co_return sum;
+}
+
+Future<const void> RunOn(Executor executor, bool& ran) {
+  co_await ResumeOn(std::move(executor));
+  ran = true;
+  co_return absl::OkStatus();
+}
+
+TEST(FutureCoroutineTest, ReadyFuture) {
+  auto future = AddOne(MakeReadyFuture<int>(1));
+  ASSERT_TRUE(future.ready());
+  EXPECT_THAT(future.result(), ::testing::Optional(2));
+}
+
+TEST(FutureCoroutineTest, PendingFuture) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = AddOne(pair.future);
+  EXPECT_FALSE(future.ready());
+  pair.promise.SetResult(5);
+  ASSERT_TRUE(future.ready());
+  EXPECT_THAT(future.result(), ::testing::Optional(6));
+}
+
+TEST(FutureCoroutineTest, Error) {
+  auto pair = PromiseFuturePair<int>::Make();
+  auto future = AddOne(pair.future);
+  pair.promise.SetResult(absl::UnknownError("failed"));
+  EXPECT_THAT(future.result(),
+              MatchesStatus(absl::StatusCode::kUnknown, "failed"));
+}
+
+TEST(FutureCoroutineTest, MultipleAwaits) {
+  std::vector<PromiseFuturePair<int>> pairs(3);
+  std::vector<Future<int>> futures;
+  for (auto& pair : pairs) {
+    pair = PromiseFuturePair<int>::Make();
+    futures.push_back(pair.future);
+  }
+  auto future = Sum(futures);
+  pairs[1].promise.SetResult(2);
+  pairs[0].promise.SetResult(1);
+  EXPECT_FALSE(future.ready());
+  pairs[2].promise.SetResult(3);
+  EXPECT_THAT(future.result(), ::testing::Optional(6));
+}
+
+TEST(FutureCoroutineTest, ResumeOn) {
+  std::vector<tensorstore::ExecutorTask> tasks;
+  bool ran = false;
+  auto future = RunOn(
+      [&](tensorstore::ExecutorTask task) { tasks.push_back(std::move(task)); },
+      ran);
+  EXPECT_FALSE(ran);
+  ASSERT_EQ(1, tasks.size());
+  std::move(tasks[0])();
+  EXPECT_TRUE(ran);
+  TENSORSTORE_EXPECT_OK(future.result());
+}
+
+// Compares the overhead of awaiting `n` futures in a coroutine to that of
+// registering a callback for each, and of a chain of `n` continuations.
+
+void BM_Coroutine_Await(benchmark::State& state) {
+  const int n = state.range(0);
+  for (auto _ : state) {
+    std::vector<PromiseFuturePair<int>> pairs(n);
+    std::vector<Future<int>> futures;
+    futures.reserve(n);
+    for (auto& pair : pairs) {
+      pair = PromiseFuturePair<int>::Make();
+      futures.push_back(pair.future);
+    }
+    auto future = Sum(std::move(futures));
+    for (auto& pair : pairs) pair.promise.SetResult(1);
+    benchmark::DoNotOptimize(future.value());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Coroutine_Await)->Range(1, 256);
+
+void BM_Coroutine_ExecuteWhenReady(benchmark::State& state) {
+  const int n = state.range(0);
+  for (auto _ : state) {
+    std::vector<PromiseFuturePair<int>> pairs(n);
+    int sum = 0;
+    for (auto& pair : pairs) {
+      pair = PromiseFuturePair<int>::Make();
+      pair.future.ExecuteWhenReady(
+          [&sum](tensorstore::ReadyFuture<int> f) { sum += f.value(); });
+    }
+    for (auto& pair : pairs) pair.promise.SetResult(1);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Coroutine_ExecuteWhenReady)->Range(1, 256);
+
+void BM_Coroutine_MapFutureValueChain(benchmark::State& state) {
+  const int n = state.range(0);
+  for (auto _ : state) {
+    auto pair = PromiseFuturePair<int>::Make();
+    Future<int> future = pair.future;
+    for (int i = 0; i < n; ++i) {
+      future = tensorstore::MapFutureValue(
+          InlineExecutor{}, [](int x) { return x + 1; }, std::move(future));
+    }
+    pair.promise.SetResult(0);
+    benchmark::DoNotOptimize(future.value());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Coroutine_MapFutureValueChain)->Range(1, 256);
+
+#else  // TENSORSTORE_HAVE_FUTURE_COROUTINES
+
+TEST(FutureCoroutineTest, Unsupported) {
+  GTEST_SKIP() << "Compiler does not support C++20 coroutines";
+}
+
+#endif  // TENSORSTORE_HAVE_FUTURE_COROUTINES
+
+}  // namespace
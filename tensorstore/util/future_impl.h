@@ -23,6 +23,7 @@
 #include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <new>
 #include <thread>  // NOLINT
 #include <type_traits>
 #include <utility>
@@ -136,6 +137,36 @@ using ReadyFutureType =
 /// CallbackBase may outlast the FutureStateBase.
 absl::Mutex* GetMutex(FutureStateBase* ptr);
 
+/// Allocates memory for a `FutureStateBase` or `CallbackBase` object of the
+/// specified `size`.
+///
+/// Small objects are allocated from per-thread free lists of size classes,
+/// which avoids the cost of the general-purpose allocator for the many
+/// short-lived shared states and callbacks created by asynchronous operations.
+void* AllocatePooled(size_t size);
+
+/// Frees memory allocated by `AllocatePooled(size)`.
+///
+/// The memory may be freed by a thread other than the one that allocated it.
+void FreePooled(void* ptr, size_t size) noexcept;
+
+/// Defines class-specific allocation functions that use `AllocatePooled`.
+///
+/// Over-aligned types are not pooled.
+#define TENSORSTORE_INTERNAL_FUTURE_POOLED_ALLOCATION()                       \
+  static void* operator new(size_t size) { return AllocatePooled(size); }     \
+  static void* operator new(size_t size, std::align_val_t alignment) {        \
+    return ::operator new(size, alignment);                                   \
+  }                                                                           \
+  static void operator delete(void* ptr, size_t size) noexcept {              \
+    FreePooled(ptr, size);                                                    \
+  }                                                                           \
+  static void operator delete(void* ptr, size_t size,                         \
+                              std::align_val_t alignment) noexcept {          \
+    ::operator delete(ptr, size, alignment);                                  \
+  }                                                                           \
+  /**/
+
 /// Base class representing an element of a doubly-linked list of callbacks.
 ///
 /// In addition to representing an element of a callback list, this type is also
@@ -180,6 +211,8 @@ class FutureStateBase {
   FutureStateBase();
   virtual ~FutureStateBase();
 
+  TENSORSTORE_INTERNAL_FUTURE_POOLED_ALLOCATION()
+
   virtual bool has_value() = 0;
   virtual const absl::Status& status() const& noexcept = 0;
 
@@ -534,6 +567,8 @@ class CallbackBase : public CallbackListNode {
 
   virtual ~CallbackBase();
 
+  TENSORSTORE_INTERNAL_FUTURE_POOLED_ALLOCATION()
+
   /// Called at most once when the callback is unregistered.
   ///
   /// It is always called when `Unregister` is called while the callback is
@@ -1503,6 +1538,10 @@ class LinkedFutureState
                                     PromiseValue, Futures...>;
 
  public:
+  // Both base classes define the same allocation functions.
+  using FutureStateType::operator new;
+  using FutureStateType::operator delete;
+
   /// Constructs the LinkedFutureState with the callback initialized from
   /// `callback_init` and the result initialized from `result_init...`.
   template <typename CallbackInit, typename... ResultInit>
@@ -1606,4 +1645,6 @@ constexpr inline bool value_conversion<const void, U> = false;
 }  // namespace internal_future
 }  // namespace tensorstore
 
+#undef TENSORSTORE_INTERNAL_FUTURE_POOLED_ALLOCATION
+
 #endif  // TENSORSTORE_UTIL_FUTURE_IMPL_H_
@@ -25,6 +25,7 @@
 #include <thread>  // NOLINT
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
@@ -1881,6 +1882,38 @@ TEST(FutureTest, Live) {
              registry.Collect("/tensorstore/futures/live")->values[0].value));
 }
 
+// Futures and callbacks may be freed by a thread other than the one that
+// allocated them, and objects of all sizes must be handled by the pooled
+// allocator.
+TEST(FutureTest, PooledAllocationAcrossThreads) {
+  struct Large {
+    char data[4096];
+  };
+  for (int iteration = 0; iteration < 10; ++iteration) {
+    std::vector<Promise<int>> promises;
+    std::vector<Future<int>> futures;
+    std::vector<Future<Large>> large_futures;
+    std::atomic<int> count{0};
+    for (int i = 0; i < 1000; ++i) {
+      auto pair = PromiseFuturePair<int>::Make();
+      pair.future.ExecuteWhenReady([&count](ReadyFuture<int> f) {
+        count.fetch_add(f.value(), std::memory_order_relaxed);
+      });
+      promises.push_back(std::move(pair.promise));
+      futures.push_back(std::move(pair.future));
+      large_futures.push_back(PromiseFuturePair<Large>::Make().future);
+    }
+    std::thread thread([&] {
+      for (auto& promise : promises) promise.SetResult(1);
+      promises.clear();
+      futures.clear();
+      large_futures.clear();
+    });
+    thread.join();
+    EXPECT_EQ(1000, count.load());
+  }
+}
+
 static void BM_Future_ExecuteWhenReady(benchmark::State& state) {
   int num_callbacks = state.range(0);
   for (auto _ : state) {
@@ -1895,4 +1928,54 @@ static void BM_Future_ExecuteWhenReady(benchmark::State& state) {
 }
 BENCHMARK(BM_Future_ExecuteWhenReady)->Range(0, 256);
 
+// Allocation and destruction of a promise/future pair.
+static void BM_Future_MakeReady(benchmark::State& state) {
+  for (auto _ : state) {
+    auto pair = PromiseFuturePair<int>::Make();
+    pair.promise.SetResult(1);
+    benchmark::DoNotOptimize(pair.future.value());
+  }
+}
+BENCHMARK(BM_Future_MakeReady)->ThreadRange(1, 8);
+
+// Allocation of a linked future state, which combines the shared state and the
+// link in a single allocation.
+static void BM_Future_MapFuture(benchmark::State& state) {
+  for (auto _ : state) {
+    auto pair = PromiseFuturePair<int>::Make();
+    auto mapped = tensorstore::MapFutureValue(
+        InlineExecutor{}, [](int x) { return x + 1; }, pair.future);
+    pair.promise.SetResult(1);
+    benchmark::DoNotOptimize(mapped.value());
+  }
+}
+BENCHMARK(BM_Future_MapFuture)->ThreadRange(1, 8);
+
+// Promise/future pairs with callbacks that are allocated on one thread and
+// completed and freed on another, as is typical for I/O completions.
+static void BM_Future_CrossThreadCompletion(benchmark::State& state) {
+  constexpr int kBatchSize = 1024;
+  std::vector<Promise<int>> promises;
+  std::vector<Future<int>> futures;
+  promises.reserve(kBatchSize);
+  futures.reserve(kBatchSize);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatchSize; ++i) {
+      auto pair = PromiseFuturePair<int>::Make();
+      pair.future.ExecuteWhenReady(
+          [](ReadyFuture<int> a) { benchmark::DoNotOptimize(a.value()); });
+      promises.push_back(std::move(pair.promise));
+      futures.push_back(std::move(pair.future));
+    }
+    std::thread thread([&] {
+      for (auto& promise : promises) promise.SetResult(1);
+      promises.clear();
+      futures.clear();
+    });
+    thread.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+BENCHMARK(BM_Future_CrossThreadCompletion);
+
 }  // namespace
@@ -140,6 +140,13 @@
 ///   return a `TimestampedStorageGeneration` with an appropriate `time` but
 ///   `generation` left unspecified.
 ///
+/// Normally, each call to `VirtualChunked` creates a separate cache, such that
+/// cached chunks are not shared between TensorStores, even those obtained by
+/// deserializing the same TensorStore.  To share cached chunks, specify the
+/// same `virtual_chunked::CacheKey` to each call.  Concurrent reads of the
+/// same chunk through any of the TensorStores then result in a single call
+/// to the `read_function`.
+///
 /// Concurrency
 /// -----------
 ///
@@ -242,9 +249,46 @@
 /// Specifying a transaction directly when creating the virtual chunked view is
 /// no different than binding the transaction to an existing virtual chunked
 /// view.
+///
+/// Batched read and write functions
+/// --------------------------------
+///
+/// For views backed by a database or remote service, where each call has a
+/// significant fixed cost, `VirtualChunkedBatched` and
+/// `VirtualChunkedBatchedWriteOnly` accept instead a `batch_read_function`
+/// and/or `batch_write_function` that are invoked with multiple chunks at once:
+///
+///     (span<const tensorstore::virtual_chunked::ReadChunk> chunks)
+///     -> Future<std::vector<TimestampedStorageGeneration>>
+///
+///     (span<const tensorstore::virtual_chunked::WriteChunk> chunks)
+///     -> Future<std::vector<TimestampedStorageGeneration>>
+///
+/// Each `ReadChunk` and `WriteChunk` specifies the array and parameters that
+/// would otherwise be passed to a separate call to the `read_function` or
+/// `write_function`, and has the same semantics.  The returned vector must
+/// contain one generation for each chunk, in the same order; an error applies
+/// to all of the chunks.  The `chunks` and the array data they reference
+/// remain valid until the returned `Future` becomes ready.
+///
+/// - The `batch_read_function` is called once for all chunks that are read by
+///   a single `tensorstore::Read` operation, or more generally by operations
+///   that use the same `tensorstore::Batch`.
+///
+/// - The `batch_write_function` is called once for all chunks that are
+///   committed together in the same phase of a transaction.  Non-transactional
+///   writes are committed separately for each chunk; to obtain a single call
+///   for a multi-chunk write, use a non-atomic transaction.  Chunks for which
+///   a generation of `StorageGeneration::Unknown()` is returned, indicating
+///   that `if_equal` did not match, are retried together in a subsequent call.
+///
+/// As for non-batched views, a write to more than one chunk in an atomic
+/// transaction is not supported.
 
 #include <functional>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "tensorstore/array.h"
@@ -257,6 +301,7 @@
 #include "tensorstore/transaction.h"
 #include "tensorstore/util/executor.h"
 #include "tensorstore/util/option.h"
+#include "tensorstore/util/span.h"
 
 namespace tensorstore {
 namespace virtual_chunked {
@@ -329,6 +374,68 @@ constexpr inline bool IsWriteFunction =
         Future<TimestampedStorageGeneration>, Func,
         Array<const Element, Rank, offset_origin>, WriteParameters>;
 
+/// Chunk to be read by a `BatchReadFunction`.
+struct ReadChunk {
+  /// Array to be filled with the content of the chunk, equivalent to the
+  /// `output` parameter of a `ReadFunction`.
+  Array<void, dynamic_rank, offset_origin> output;
+
+  /// Parameters of the read of this chunk.
+  ReadParameters read_params;
+};
+
+/// Chunk to be stored by a `BatchWriteFunction`.
+struct WriteChunk {
+  /// Content to be stored for the chunk, equivalent to the `input` parameter of
+  /// a `WriteFunction`.
+  Array<const void, dynamic_rank, offset_origin> input;
+
+  /// Parameters of the write of this chunk.
+  WriteParameters write_params;
+};
+
+/// Type-erased function called to read a batch of chunks.
+///
+/// Returns a generation for each chunk, in the same order as `chunks`.
+using BatchReadFunction = serialization::SerializableFunction<
+    Future<std::vector<TimestampedStorageGeneration>>(
+        span<const ReadChunk> chunks)>;
+
+/// Type-erased function called to write a batch of chunks.
+///
+/// Returns a generation for each chunk, in the same order as `chunks`.
+using BatchWriteFunction = serialization::SerializableFunction<
+    Future<std::vector<TimestampedStorageGeneration>>(
+        span<const WriteChunk> chunks)>;
+
+/// Metafunction that evaluates to `true` if `Func` may be used as a "batch
+/// read function".
+template <typename Func>
+constexpr inline bool IsBatchReadFunction =
+    serialization::IsSerializableFunctionLike<
+        Future<std::vector<TimestampedStorageGeneration>>, Func,
+        span<const ReadChunk>>;
+
+/// Metafunction that evaluates to `true` if `Func` may be used as a "batch
+/// write function".
+template <typename Func>
+constexpr inline bool IsBatchWriteFunction =
+    serialization::IsSerializableFunctionLike<
+        Future<std::vector<TimestampedStorageGeneration>>, Func,
+        span<const WriteChunk>>;
+
+/// Identifies the content computed by the `read_function` of a
+/// `virtual_chunked` TensorStore, in order to share cached chunks between
+/// TensorStores with the same cache key, data type, domain, and chunk layout
+/// that use the same `cache_pool`.
+///
+/// The `read_function` and `write_function` of each such TensorStore must be
+/// interchangeable; the functions of the first TensorStore opened are used
+/// for all of them.  An empty key, the default, disables sharing.
+struct CacheKey {
+  std::string value;
+};
+
 /// Options to the `tensorstore::VirtualChunked` function for creating an
 /// `virtual_chunked` TensorStore.
 ///
@@ -362,10 +469,13 @@ constexpr inline bool IsWriteFunction =
 /// - `RecheckCachedData`: May be specified in conjunction with a `Context` with
 ///   non-zero `total_bytes_limit` specified for the `cache_pool` to avoid
 ///   re-invoking the `read_function` to validate cached data.
+///
+/// - `CacheKey`: Allows cached chunks to be shared with other TensorStores.
 struct OpenOptions : public Schema {
   Context context;
   Transaction transaction{no_transaction};
   RecheckCachedData recheck_cached_data;
+  std::string cache_key;
 
   template <typename T>
   static inline constexpr bool IsOption = Schema::IsOption<T>;
@@ -388,6 +498,11 @@ struct OpenOptions : public Schema {
     }
     return absl::OkStatus();
   }
+
+  absl::Status Set(CacheKey value) {
+    cache_key = std::move(value.value);
+    return absl::OkStatus();
+  }
 };
 
 template <>
@@ -399,11 +514,53 @@ constexpr inline bool OpenOptions::IsOption<Transaction> = true;
 template <>
 constexpr inline bool OpenOptions::IsOption<RecheckCachedData> = true;
 
+template <>
+constexpr inline bool OpenOptions::IsOption<CacheKey> = true;
+
 namespace internal_virtual_chunked {
 Result<internal::Driver::Handle> MakeDriver(
     virtual_chunked::ReadFunction read_function,
     virtual_chunked::WriteFunction write_function, OpenOptions&& options);
 
+Result<internal::Driver::Handle> MakeBatchedDriver(
+    virtual_chunked::BatchReadFunction batch_read_function,
+    virtual_chunked::BatchWriteFunction batch_write_function,
+    OpenOptions&& options);
+
+/// Common implementation of `VirtualChunkedBatched` and
+/// `VirtualChunkedBatchedWriteOnly`.
+template <typename Element, DimensionIndex Rank, ReadWriteMode Mode>
+Result<TensorStore<Element, Rank, Mode>> MakeBatchedTensorStore(
+    BatchReadFunction batch_read_function,
+    BatchWriteFunction batch_write_function, OpenOptions&& options) {
+  static_assert(std::is_same_v<Element, internal::remove_cvref_t<Element>>,
+                "Element type must be unqualified");
+  static_assert(Rank >= dynamic_rank,
+                "Rank must equal dynamic_rank (-1) or be non-negative.");
+  if constexpr (Rank != dynamic_rank) {
+    TENSORSTORE_RETURN_IF_ERROR(options.Set(RankConstraint{Rank}));
+  }
+  if constexpr (!std::is_void_v<Element>) {
+    TENSORSTORE_RETURN_IF_ERROR(options.Set(dtype_v<Element>));
+  }
+  if ((Mode & ReadWriteMode::read) == ReadWriteMode::read &&
+      !batch_read_function) {
+    return absl::InvalidArgumentError(
+        "Invalid batch_read_function specified");
+  }
+  if ((Mode & ReadWriteMode::write) == ReadWriteMode::write &&
+      !batch_write_function) {
+    return absl::InvalidArgumentError(
+        "Invalid batch_write_function specified");
+  }
+  TENSORSTORE_ASSIGN_OR_RETURN(
+      auto handle,
+      MakeBatchedDriver(std::move(batch_read_function),
+                        std::move(batch_write_function), std::move(options)));
+  return internal::TensorStoreAccess::Construct<
+      TensorStore<Element, Rank, Mode>>(std::move(handle));
+}
+
 /// Converts a ReadFunction or WriteFunction for a known `Element` type and
 /// `Rank` into a type-erased `ReadFunction` or `WriteFunction`.
 template <typename ErasedElement, typename Element, DimensionIndex Rank,
@@ -661,10 +818,96 @@ VirtualChunkedWriteOnly(WriteFunc write_function, Option&&... option) {
                                                 std::move(options));
 }
 
+/// Creates a read-only TensorStore where the content is read in batches of
+/// chunks by the specified user-defined function.
+///
+/// \param batch_read_function Function called to read each batch of chunks.
+///     Must be callable with `(span<const ReadChunk>)` and have a return value
+///     convertible to `Future<std::vector<TimestampedStorageGeneration>>`.  By
+///     default must be serializable.  To specify a non-serializable function,
+///     wrap it in `NonSerializable`.
+/// \param option Option compatible with `OpenOptions`, which may be specified
+///     in any order.  If `Rank == dynamic_rank`, the rank must always be
+///     specified.  If `Element` is `void`, the data type must also be
+///     specified.
+template <typename Element = void, DimensionIndex Rank = dynamic_rank,
+          typename BatchReadFunc, typename... Option>
+std::enable_if_t<(IsBatchReadFunction<BatchReadFunc> &&
+                  IsCompatibleOptionSequence<OpenOptions, Option...>),
+                 Result<TensorStore<Element, Rank, ReadWriteMode::read>>>
+VirtualChunkedBatched(BatchReadFunc batch_read_function, Option&&... option) {
+  TENSORSTORE_INTERNAL_ASSIGN_OPTIONS_OR_RETURN(OpenOptions, options, option);
+  return internal_virtual_chunked::MakeBatchedTensorStore<
+      Element, Rank, ReadWriteMode::read>(std::move(batch_read_function), {},
+                                          std::move(options));
+}
+
+/// Creates a read-write TensorStore where the content is read and written in
+/// batches of chunks by the specified user-defined functions.
+///
+/// \param batch_read_function Function called to read each batch of chunks.
+///     Must be callable with `(span<const ReadChunk>)` and have a return value
+///     convertible to `Future<std::vector<TimestampedStorageGeneration>>`.  By
+///     default must be serializable.  To specify a non-serializable function,
+///     wrap it in `NonSerializable`.
+/// \param batch_write_function Function called to store each batch of chunks.
+///     Must be callable with `(span<const WriteChunk>)` and have a return
+///     value convertible to
+///     `Future<std::vector<TimestampedStorageGeneration>>`.  By default must
+///     be serializable.  To specify a non-serializable function, wrap it in
+///     `NonSerializable`.
+/// \param option Option compatible with `OpenOptions`, which may be specified
+///     in any order.  If `Rank == dynamic_rank`, the rank must always be
+///     specified.  If `Element` is `void`, the data type must also be
+///     specified.
+template <typename Element = void, DimensionIndex Rank = dynamic_rank,
+          typename BatchReadFunc, typename BatchWriteFunc, typename... Option>
+std::enable_if_t<(IsBatchReadFunction<BatchReadFunc> &&
+                  IsBatchWriteFunction<BatchWriteFunc> &&
+                  IsCompatibleOptionSequence<OpenOptions, Option...>),
+                 Result<TensorStore<Element, Rank, ReadWriteMode::read_write>>>
+VirtualChunkedBatched(BatchReadFunc batch_read_function,
+                      BatchWriteFunc batch_write_function,
+                      Option&&... option) {
+  TENSORSTORE_INTERNAL_ASSIGN_OPTIONS_OR_RETURN(OpenOptions, options, option);
+  return internal_virtual_chunked::MakeBatchedTensorStore<
+      Element, Rank, ReadWriteMode::read_write>(
+      std::move(batch_read_function), std::move(batch_write_function),
+      std::move(options));
+}
+
+/// Creates a write-only TensorStore where the content is written in batches of
+/// chunks by the specified user-defined function.
+///
+/// \param batch_write_function Function called to store each batch of chunks.
+///     Must be callable with `(span<const WriteChunk>)` and have a return
+///     value convertible to
+///     `Future<std::vector<TimestampedStorageGeneration>>`.  By default must
+///     be serializable.  To specify a non-serializable function, wrap it in
+///     `NonSerializable`.
+/// \param option Option compatible with `OpenOptions`, which may be specified
+///     in any order.  If `Rank == dynamic_rank`, the rank must always be
+///     specified.  If `Element` is `void`, the data type must also be
+///     specified.
+template <typename Element = void, DimensionIndex Rank = dynamic_rank,
+          typename BatchWriteFunc, typename... Option>
+std::enable_if_t<(IsBatchWriteFunction<BatchWriteFunc> &&
+                  IsCompatibleOptionSequence<OpenOptions, Option...>),
+                 Result<TensorStore<Element, Rank, ReadWriteMode::write>>>
+VirtualChunkedBatchedWriteOnly(BatchWriteFunc batch_write_function,
+                               Option&&... option) {
+  TENSORSTORE_INTERNAL_ASSIGN_OPTIONS_OR_RETURN(OpenOptions, options, option);
+  return internal_virtual_chunked::MakeBatchedTensorStore<
+      Element, Rank, ReadWriteMode::write>(
+      {}, std::move(batch_write_function), std::move(options));
+}
+
 }  // namespace virtual_chunked
 
-using virtual_chunked::VirtualChunked;           // NOLINT
-using virtual_chunked::VirtualChunkedWriteOnly;  // NOLINT
+using virtual_chunked::VirtualChunked;                  // NOLINT
+using virtual_chunked::VirtualChunkedBatched;           // NOLINT
+using virtual_chunked::VirtualChunkedBatchedWriteOnly;  // NOLINT
+using virtual_chunked::VirtualChunkedWriteOnly;         // NOLINT
 
 }  // namespace tensorstore
 